@@ -2,14 +2,19 @@
 
 CC = gcc
 CFLAGS = -Wall -Wextra -O3 -march=native
-LDFLAGS = -lcrypto -lm
+LDFLAGS = -lcrypto -lm -lpthread
+
+# STATS=1 builds the hot-path counters in (dntl_stats.h)
+ifdef STATS
+CFLAGS += -DDNTL_STATS
+endif
 
 # Source files
-SRCS = rs_prf.c rs_params.c rs_mats.c rs_lwr.c rs_test.c
+SRCS = ntt64.c dntl_stats.c uniform_mod.c keccak.c rs_aes.c rs_prf.c rs_params.c rs_mats.c rs_lwr.c rs_expand.c dntl_alloc.c dntl_sched.c rs_test.c
 OBJS = $(SRCS:.c=.o)
 
 # Headers
-HEADERS = rs_config.h rs_prf.h rs_params.h rs_mats.h rs_lwr.h
+HEADERS = ntt64.h ntt64_simd.h dntl_stats.h keccak.h sparse_encoding.h sparse_vector.h rs_config.h uniform_mod.h rs_aes.h rs_prf.h rs_params.h rs_mats.h rs_lwr.h rs_expand.h dntl_alloc.h dntl_sched.h
 
 # Target executable
 TARGET = rs_test
@@ -0,0 +1,330 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include <math.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+struct bench {
+    int cpu;                            // pinned CPU, or -1
+    size_t samples;
+    double hz;                          // ticks per second
+    const char *timer;
+    const char *filter;
+    int counter_fd[BENCH_COUNTERS];     // -1 if unavailable
+    bench_result_t *results;
+    size_t count, capacity;
+    uint64_t *ticks;                    // samples of the current case
+};
+
+static const char *const COUNTER_NAMES[BENCH_COUNTERS] = {
+    "cycles", "instructions", "cache_misses", "branch_misses"
+};
+
+// ============================================================================
+// CYCLE COUNTER
+// ============================================================================
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Fenced so the timed calls neither start before nor finish after the read
+static inline uint64_t read_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(t) : : "memory");
+    return t;
+#else
+    return (uint64_t)now_ns();
+#endif
+}
+
+static double ticks_hz(const char **timer) {
+#if defined(__x86_64__) || defined(__i386__)
+    // The TSC rate against the monotonic clock over 50 ms
+    *timer = "rdtsc";
+    const double t0 = now_ns();
+    const uint64_t c0 = read_ticks();
+    while (now_ns() - t0 < 50e6) {
+    }
+    const double t1 = now_ns();
+    const uint64_t c1 = read_ticks();
+    return (double)(c1 - c0) / ((t1 - t0) * 1e-9);
+#elif defined(__aarch64__)
+    uint64_t f;
+    *timer = "cntvct_el0";
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(f));
+    return (double)f;
+#else
+    *timer = "clock_gettime";
+    return 1e9;
+#endif
+}
+
+// ============================================================================
+// HARDWARE COUNTERS
+// ============================================================================
+
+#ifdef __linux__
+static int open_counter(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static void open_counters(bench_t *b) {
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        b->counter_fd[i] = -1;
+    }
+#ifdef __linux__
+    static const uint64_t configs[BENCH_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        b->counter_fd[i] = open_counter(configs[i]);
+    }
+#endif
+}
+
+static void counters_start(const bench_t *b) {
+#ifdef __linux__
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (b->counter_fd[i] >= 0) {
+            ioctl(b->counter_fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(b->counter_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#else
+    (void)b;
+#endif
+}
+
+// Counts since counters_start(), scaled for multiplexing; -1 if not counted
+static void counters_stop(const bench_t *b, double out[BENCH_COUNTERS]) {
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        out[i] = -1.0;
+#ifdef __linux__
+        uint64_t v[3];
+        if (b->counter_fd[i] < 0) {
+            continue;
+        }
+        ioctl(b->counter_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(b->counter_fd[i], v, sizeof(v)) == (ssize_t)sizeof(v) && v[2] > 0) {
+            out[i] = (double)v[0] * ((double)v[1] / (double)v[2]);
+        }
+#endif
+    }
+}
+
+// ============================================================================
+// RUNS
+// ============================================================================
+
+bench_t *bench_create(int cpu, size_t samples) {
+    bench_t *b = calloc(1, sizeof(*b));
+    if (!b) {
+        return NULL;
+    }
+    b->samples = samples ? samples : BENCH_SAMPLES;
+    b->ticks = malloc(b->samples * sizeof(uint64_t));
+    if (!b->ticks) {
+        free(b);
+        return NULL;
+    }
+
+    b->cpu = -1;
+#ifdef __linux__
+    if (cpu < 0) {
+        cpu = sched_getcpu();
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+            b->cpu = cpu;
+        }
+    }
+#else
+    (void)cpu;
+#endif
+    open_counters(b);
+    b->hz = ticks_hz(&b->timer);
+    return b;
+}
+
+void bench_destroy(bench_t *b) {
+    if (!b) {
+        return;
+    }
+#ifdef __linux__
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (b->counter_fd[i] >= 0) {
+            close(b->counter_fd[i]);
+        }
+    }
+#endif
+    free(b->results);
+    free(b->ticks);
+    free(b);
+}
+
+void bench_set_filter(bench_t *b, const char *filter) {
+    b->filter = filter;
+}
+
+double bench_ticks_hz(const bench_t *b) {
+    return b->hz;
+}
+
+const bench_result_t *bench_results(const bench_t *b, size_t *count) {
+    *count = b->count;
+    return b->results;
+}
+
+static int compare_ticks(const void *x, const void *y) {
+    const uint64_t a = *(const uint64_t *)x, c = *(const uint64_t *)y;
+    return (a > c) - (a < c);
+}
+
+// Nearest rank: the smallest sample with at least fraction p at or below it
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+    size_t rank = (size_t)ceil(p * (double)n);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+const bench_result_t *bench_run(bench_t *b, const char *name, bench_fn_t fn, void *arg,
+                                double ops_per_call) {
+    if (b->filter && !strstr(name, b->filter)) {
+        return NULL;
+    }
+    if (b->count == b->capacity) {
+        size_t capacity = b->capacity ? 2 * b->capacity : 64;
+        bench_result_t *grown = realloc(b->results, capacity * sizeof(*grown));
+        if (!grown) {
+            return NULL;
+        }
+        b->results = grown;
+        b->capacity = capacity;
+    }
+
+    // Warm up caches, branch predictors and clocks
+    const double start = now_ns();
+    uint64_t calls = 0;
+    while (now_ns() - start < BENCH_WARMUP_NS || calls < 2) {
+        fn(arg);
+        calls++;
+    }
+
+    // Calls per sample for BENCH_SAMPLE_NS, and as many samples as the
+    // case's budget allows
+    const double call_ns = (now_ns() - start) / (double)calls;
+    uint64_t reps = (uint64_t)ceil(BENCH_SAMPLE_NS / call_ns);
+    size_t samples = b->samples;
+    if (reps < 1) {
+        reps = 1;
+    }
+    if ((double)samples * reps * call_ns > BENCH_CASE_NS) {
+        samples = (size_t)(BENCH_CASE_NS / (reps * call_ns));
+        samples = samples < BENCH_MIN_SAMPLES ? BENCH_MIN_SAMPLES : samples;
+    }
+
+    bench_result_t *r = &b->results[b->count];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->samples = samples;
+    r->reps = reps;
+    r->ops = (double)reps * ops_per_call;
+
+    counters_start(b);
+    for (size_t s = 0; s < samples; s++) {
+        const uint64_t t0 = read_ticks();
+        for (uint64_t k = 0; k < reps; k++) {
+            fn(arg);
+        }
+        b->ticks[s] = read_ticks() - t0;
+    }
+    counters_stop(b, r->counters);
+
+    const double total_ops = r->ops * (double)samples;
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (r->counters[i] >= 0) {
+            r->counters[i] /= total_ops;
+        }
+    }
+    qsort(b->ticks, samples, sizeof(uint64_t), compare_ticks);
+    r->min = (double)b->ticks[0] / r->ops;
+    r->median = (double)percentile(b->ticks, samples, 0.5) / r->ops;
+    r->p90 = (double)percentile(b->ticks, samples, 0.9) / r->ops;
+    r->p99 = (double)percentile(b->ticks, samples, 0.99) / r->ops;
+    b->count++;
+    return r;
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+int bench_write_json(const bench_t *b, FILE *out) {
+    int available = 0;
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        available |= b->counter_fd[i] >= 0;
+    }
+
+    fprintf(out, "{\n  \"schema\": 1,\n  \"revision\": \"%s\",\n", BENCH_REVISION);
+    fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+    fprintf(out, "  \"timer\": \"%s\",\n  \"timer_hz\": %.0f,\n  \"cpu\": %d,\n", b->timer,
+            b->hz, b->cpu);
+    fprintf(out, "  \"perf_counters\": %s,\n  \"results\": [", available ? "true" : "false");
+    for (size_t k = 0; k < b->count; k++) {
+        const bench_result_t *r = &b->results[k];
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"samples\": %zu, \"ops_per_sample\": %.0f, ",
+                k ? "," : "", r->name, r->samples, r->ops);
+        fprintf(out, "\"median\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"min\": %.2f, "
+                "\"median_ns\": %.2f", r->median, r->p90, r->p99, r->min,
+                r->median / b->hz * 1e9);
+        for (int i = 0; i < BENCH_COUNTERS; i++) {
+            if (r->counters[i] >= 0) {
+                fprintf(out, ", \"%s\": %.2f", COUNTER_NAMES[i], r->counters[i]);
+            } else {
+                fprintf(out, ", \"%s\": null", COUNTER_NAMES[i]);
+            }
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+    return ferror(out) ? -1 : 0;
+}
@@ -0,0 +1,115 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================================
+// BENCHMARK HARNESS
+// ============================================================================
+//
+// Times one operation many times and reports the distribution, not a mean:
+//
+//   - the thread is pinned to one CPU (sched_setaffinity) for the whole run;
+//   - each case is warmed up, then a sample is `reps` back-to-back calls, with
+//     reps calibrated so a sample lasts at least BENCH_SAMPLE_NS;
+//   - per op, the median, p90 and p99 of the samples are reported in ticks of
+//     the cycle counter: rdtsc on x86-64 (reference cycles at the TSC rate),
+//     cntvct_el0 on AArch64 (the generic timer), clock_gettime elsewhere;
+//   - where perf_event_open works, the same samples also count core cycles,
+//     instructions, cache misses and branch misses (user space only; counts
+//     are scaled if the kernel multiplexed them);
+//   - results are written as JSON for comparison between releases.
+//
+// Usage:
+//
+//   bench_t *b = bench_create(-1, 0);
+//   bench_run(b, "ntt64/forward/avx2/L0", fn, &arg, 1);
+//   bench_write_json(b, stdout);
+//   bench_destroy(b);
+
+// Shortest sample, and the time budget of one case
+#define BENCH_SAMPLE_NS 10000.0
+#define BENCH_CASE_NS 200e6
+#define BENCH_WARMUP_NS 2e6
+
+// Default and fewest samples per case
+#define BENCH_SAMPLES 1000
+#define BENCH_MIN_SAMPLES 51
+
+// Hardware counters per case
+enum {
+    BENCH_CYCLES = 0,
+    BENCH_INSTRUCTIONS,
+    BENCH_CACHE_MISSES,
+    BENCH_BRANCH_MISSES,
+    BENCH_COUNTERS
+};
+
+/**
+ * One operation to time: called reps times per sample, each call doing
+ * ops_per_call operations
+ */
+typedef void (*bench_fn_t)(void *arg);
+
+typedef struct {
+    char name[96];
+    size_t samples;
+    uint64_t reps;                      // calls per sample
+    double ops;                         // operations per sample
+    double median, p90, p99, min;       // ticks per operation
+    double counters[BENCH_COUNTERS];    // per operation; -1 if not counted
+} bench_result_t;
+
+typedef struct bench bench_t;
+
+/**
+ * Start a run
+ *
+ * @param cpu       CPU to pin to, or -1 for the one the thread is on
+ * @param samples   Samples per case, or 0 for BENCH_SAMPLES
+ * @return          New run, or NULL if memory runs out. If pinning fails the
+ *                  run goes on unpinned and the JSON records cpu -1.
+ */
+bench_t *bench_create(int cpu, size_t samples);
+
+/**
+ * Free a run (NULL is ignored); the thread stays pinned
+ */
+void bench_destroy(bench_t *b);
+
+/**
+ * Only run cases whose name contains filter (NULL runs all)
+ */
+void bench_set_filter(bench_t *b, const char *filter);
+
+/**
+ * Time a case and keep its result
+ *
+ * @param ops_per_call  Operations one call does (per-op numbers divide by it)
+ * @return              The result, NULL if the filter skipped the case or
+ *                      memory runs out
+ */
+const bench_result_t *bench_run(bench_t *b, const char *name, bench_fn_t fn, void *arg,
+                                double ops_per_call);
+
+/**
+ * Ticks per second of the cycle counter
+ */
+double bench_ticks_hz(const bench_t *b);
+
+/**
+ * Results so far, in run order
+ */
+const bench_result_t *bench_results(const bench_t *b, size_t *count);
+
+/**
+ * Write the run as JSON: timer, CPU, counter availability, revision and
+ * one object per case (per-op values; counters null when not counted)
+ *
+ * @return          0, or -1 on a write error
+ */
+int bench_write_json(const bench_t *b, FILE *out);
+
+#endif // BENCH_H
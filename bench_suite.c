@@ -0,0 +1,708 @@
+/**
+ * Benchmark suite: every ntt64 layer and backend, the length-generic plans,
+ * the rs derivations (per layer and AES backend), the LWR tag, each sparse
+ * codec and the Gaussian samplers, timed with the bench.h harness
+ *
+ * Usage: bench_suite [-o results.json] [-f filter] [-c cpu] [-n samples]
+ *
+ * A table goes to stdout; -o writes the JSON (bench_write_json()) for
+ * comparison between releases. -f keeps the cases whose name contains the
+ * filter, e.g. -f ntt64/forward or -f /avx512.
+ *
+ * Build: make -f Makefile.bench
+ */
+
+#include "bench.h"
+#include "gaussian_sampler.h"
+#include "huffman_vector.h"
+#include "ntt64.h"
+#include "ntt64_simd.h"
+#include "ntt_plan.h"
+#include "rs_aes.h"
+#include "rs_expand.h"
+#include "rs_lwr.h"
+#include "rs_mats.h"
+#include "rs_params.h"
+#include "sparse_adaptive.h"
+#include "sparse_auto.h"
+#include "sparse_codec_ctx.h"
+#include "sparse_delta.h"
+#include "sparse_optimal.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// Results print as they come
+static void run(bench_t *b, const char *name, bench_fn_t fn, void *arg, double ops) {
+    const bench_result_t *r = bench_run(b, name, fn, arg, ops);
+    if (!r) {
+        return;
+    }
+    printf("  %-44s %10.1f %10.1f %10.1f %9.1f ns", r->name, r->median, r->p90, r->p99,
+           r->median / bench_ticks_hz(b) * 1e9);
+    if (r->counters[BENCH_INSTRUCTIONS] >= 0) {
+        printf("  %8.1f ins", r->counters[BENCH_INSTRUCTIONS]);
+    }
+    printf("\n");
+}
+
+// ============================================================================
+// NTT64
+// ============================================================================
+
+typedef struct {
+    const char *name;
+    ntt64_forward_fn forward;
+    ntt64_inverse_fn inverse;
+    ntt64_pointwise_mul_fn pointwise;
+    ntt64_batch_fn forward_batch;
+    int supported;
+} ntt_backend_t;
+
+#define NTT_BATCH 16
+
+typedef struct {
+    const ntt_backend_t *backend;
+    int layer;
+    uint32_t a[NTT_N] __attribute__((aligned(64)));
+    uint32_t b[NTT_N] __attribute__((aligned(64)));
+    uint32_t r[NTT_N] __attribute__((aligned(64)));
+    uint32_t soa[NTT_BATCH * NTT_N] __attribute__((aligned(64)));
+} ntt_case_t;
+
+static void ntt_forward_case(void *arg) {
+    ntt_case_t *c = arg;
+    c->backend->forward(c->a, c->layer);
+}
+
+static void ntt_inverse_case(void *arg) {
+    ntt_case_t *c = arg;
+    c->backend->inverse(c->a, c->layer);
+}
+
+static void ntt_pointwise_case(void *arg) {
+    ntt_case_t *c = arg;
+    c->backend->pointwise(c->r, c->a, c->b, c->layer);
+}
+
+static void ntt_batch_case(void *arg) {
+    ntt_case_t *c = arg;
+    c->backend->forward_batch(c->soa, NTT_BATCH, c->layer);
+}
+
+static void bench_ntt64(bench_t *b) {
+    const ntt_backend_t backends[] = {
+        { "scalar", ntt64_forward_scalar, ntt64_inverse_scalar, ntt64_pointwise_mul_scalar,
+          ntt64_forward_batch_scalar, 1 },
+#ifdef __AVX2__
+        { "avx2", ntt64_forward_avx2, ntt64_inverse_avx2, ntt64_pointwise_mul_avx2,
+          ntt64_forward_batch_avx2, __builtin_cpu_supports("avx2") },
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+        { "avx512", ntt64_forward_avx512, ntt64_inverse_avx512, ntt64_pointwise_mul_avx512,
+          ntt64_forward_batch_avx512,
+          __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") },
+#endif
+#ifdef __ARM_NEON
+        { "neon", ntt64_forward_neon, ntt64_inverse_neon, ntt64_pointwise_mul_neon,
+          ntt64_forward_batch_neon, 1 },
+#endif
+        // What ntt64_init() picked, which ntt64_forward() and friends also use
+        { "dispatch", ntt64_forward_ptr, ntt64_inverse_ptr, ntt64_pointwise_mul_ptr,
+          ntt64_forward_batch_ptr, 1 },
+    };
+    static ntt_case_t c;
+    char name[96];
+
+    for (size_t k = 0; k < sizeof(backends) / sizeof(backends[0]); k++) {
+        if (!backends[k].supported) {
+            continue;
+        }
+        c.backend = &backends[k];
+        for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+            const uint32_t q = ntt64_get_modulus(layer);
+            c.layer = layer;
+            for (int i = 0; i < NTT_N; i++) {
+                c.a[i] = (uint32_t)(next_rand() % q);
+                c.b[i] = (uint32_t)(next_rand() % q);
+            }
+            for (int i = 0; i < NTT_BATCH * NTT_N; i++) {
+                c.soa[i] = (uint32_t)(next_rand() % q);
+            }
+            snprintf(name, sizeof(name), "ntt64/forward/%s/L%d", backends[k].name, layer);
+            run(b, name, ntt_forward_case, &c, 1);
+            snprintf(name, sizeof(name), "ntt64/inverse/%s/L%d", backends[k].name, layer);
+            run(b, name, ntt_inverse_case, &c, 1);
+            snprintf(name, sizeof(name), "ntt64/pointwise/%s/L%d", backends[k].name, layer);
+            run(b, name, ntt_pointwise_case, &c, 1);
+            snprintf(name, sizeof(name), "ntt64/forward_batch16/%s/L%d", backends[k].name, layer);
+            run(b, name, ntt_batch_case, &c, NTT_BATCH);
+        }
+    }
+}
+
+// ============================================================================
+// NTT PLANS (DNTL lengths)
+// ============================================================================
+
+typedef struct {
+    ntt_plan_t *plan;
+    uint32_t poly[256] __attribute__((aligned(64)));
+    uint32_t dense[256] __attribute__((aligned(64)));
+    uint16_t indices[64];
+    int8_t values[64];
+    size_t count;
+} plan_case_t;
+
+static void plan_forward_case(void *arg) {
+    plan_case_t *c = arg;
+    ntt_plan_forward(c->plan, c->poly);
+}
+
+static void plan_inverse_case(void *arg) {
+    plan_case_t *c = arg;
+    ntt_plan_inverse(c->plan, c->poly);
+}
+
+static void plan_mul_sparse_case(void *arg) {
+    plan_case_t *c = arg;
+    ntt_plan_mul_sparse(c->plan, c->poly, c->indices, c->values, c->count, c->dense);
+}
+
+static void bench_ntt_plan(bench_t *b) {
+    static plan_case_t c;
+    char name[96];
+    for (size_t n = 64; n <= 256; n *= 2) {
+        c.plan = ntt_plan_create(n, 257, 3, NTT_PLAN_CYCLIC);
+        if (!c.plan) {
+            continue;
+        }
+        for (size_t i = 0; i < n; i++) {
+            c.poly[i] = (uint32_t)(next_rand() % 257);
+        }
+        snprintf(name, sizeof(name), "ntt_plan/forward/n%zu", n);
+        run(b, name, plan_forward_case, &c, 1);
+        snprintf(name, sizeof(name), "ntt_plan/inverse/n%zu", n);
+        run(b, name, plan_inverse_case, &c, 1);
+
+        // Ternary operands either side of the direct path's limit
+        for (size_t i = 0; i < n; i++) {
+            c.dense[i] = (uint32_t)(next_rand() % 257);
+        }
+        for (size_t t = 0; t < 64; t++) {
+            c.indices[t] = (uint16_t)(next_rand() % n);
+            c.values[t] = next_rand() & 1 ? 1 : -1;
+        }
+        for (c.count = 16; c.count <= 64; c.count *= 4) {
+            snprintf(name, sizeof(name), "ntt_plan/mul_sparse/n%zu/w%zu", n, c.count);
+            run(b, name, plan_mul_sparse_case, &c, 1);
+        }
+        ntt_plan_destroy(c.plan);
+    }
+}
+
+// ============================================================================
+// RS DERIVATIONS AND LWR
+// ============================================================================
+
+#define RS_TAG_BATCH 16
+
+typedef struct {
+    rs_params_t *p;
+    int ell;
+    rs_matrix_t A;
+    rs_matrix16_t A16;
+    uint32_t rows[RS_A_STREAM_ROWS][RS_N];
+    uint32_t a_ntt[RS_N];
+    rs_row_t B[RS_PUBLIC_DIM];
+    int32_t s[RS_SECRET_DIM];
+    int32_t S[RS_TAG_BATCH][RS_SECRET_DIM];
+    uint16_t t[RS_PUBLIC_DIM];
+    uint16_t T[RS_TAG_BATCH][RS_PUBLIC_DIM];
+} rs_case_t;
+
+static void rs_derive_A_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_A(c->p, RS_FAMILY_AX, c->ell, 0, &c->A);
+}
+
+static void rs_derive_A_rows_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_A_rows(c->p, RS_FAMILY_AX, c->ell, 0, 8, RS_A_STREAM_ROWS, c->rows);
+}
+
+static void rs_derive_A16_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_A16(c->p, RS_FAMILY_AX, c->ell, 0, &c->A16);
+}
+
+static void rs_derive_A_uniform_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_A_uniform(c->p, RS_FAMILY_AX, c->ell, 0, &c->A);
+}
+
+static void rs_derive_A_ring_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_A_ring(c->p, RS_FAMILY_AX, c->ell, 0, c->a_ntt);
+}
+
+static void rs_derive_B_row_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_B_row(c->p, 5, RS_FLAVOR_LWR, &c->B[0]);
+}
+
+static void rs_derive_B_rows_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_B_rows(c->p, 0, RS_PUBLIC_DIM, RS_FLAVOR_LWR, c->B);
+}
+
+static void rs_derive_C_rows_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_derive_C_rows(c->p, 0, RS_PUBLIC_DIM, c->B);
+}
+
+static void rs_expand_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_expanded_destroy(rs_expanded_create(c->p, NULL));
+}
+
+static void lwr_tag_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_lwr_tag(c->B, c->s, c->t);
+}
+
+static void lwr_tag_bounded_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_lwr_tag_bounded(c->B, c->s, RS_LWR_SMALL_BOUND, c->t);
+}
+
+static void lwr_tag_batch_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_lwr_tag_batch(c->B, (const int32_t (*)[RS_SECRET_DIM])c->S, RS_TAG_BATCH, c->T);
+}
+
+static void lwr_tag_from_seed_case(void *arg) {
+    rs_case_t *c = arg;
+    rs_lwr_tag_from_seed(c->p, RS_FLAVOR_LWR, c->s, c->t);
+}
+
+static void bench_rs(bench_t *b) {
+    static rs_params_t p, p_ring;
+    static rs_case_t c;
+    uint8_t seeds[6][RS_SEED_BYTES];
+    char name[96];
+
+    for (int k = 0; k < 6; k++) {
+        for (int i = 0; i < RS_SEED_BYTES; i++) seeds[k][i] = (uint8_t)next_rand();
+    }
+    rs_params_init(&p, seeds[0], seeds[1], seeds[2], seeds[3], seeds[4], seeds[5]);
+    rs_params_init(&p_ring, seeds[0], seeds[1], seeds[2], seeds[3], seeds[4], seeds[5]);
+    const int ring = rs_params_set_A_mode(&p_ring, RS_A_RING) == 0;
+    c.p = &p;
+
+    // Derivations per layer
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        c.ell = ell;
+        c.p = &p;
+        snprintf(name, sizeof(name), "rs/derive_A/L%d", ell);
+        run(b, name, rs_derive_A_case, &c, 1);
+        snprintf(name, sizeof(name), "rs/derive_A_rows8/L%d", ell);
+        run(b, name, rs_derive_A_rows_case, &c, RS_A_STREAM_ROWS);
+        if (rs_derive_A16(&p, RS_FAMILY_AX, ell, 0, &c.A16) == 0) {
+            snprintf(name, sizeof(name), "rs/derive_A16/L%d", ell);
+            run(b, name, rs_derive_A16_case, &c, 1);
+        }
+        snprintf(name, sizeof(name), "rs/derive_A_uniform/L%d", ell);
+        run(b, name, rs_derive_A_uniform_case, &c, 1);
+        if (ring) {
+            c.p = &p_ring;
+            snprintf(name, sizeof(name), "rs/derive_A_ring/L%d", ell);
+            run(b, name, rs_derive_A_ring_case, &c, 1);
+        }
+    }
+
+    // Layer 0 on each AES backend
+    const rs_aes_impl_t initial = rs_aes_get_implementation();
+    static const rs_aes_impl_t impls[] = {
+        RS_AES_IMPL_OPENSSL, RS_AES_IMPL_AESNI, RS_AES_IMPL_VAES, RS_AES_IMPL_ARMV8
+    };
+    c.p = &p;
+    c.ell = 0;
+    for (size_t k = 0; k < sizeof(impls) / sizeof(impls[0]); k++) {
+        if (!rs_aes_supported(impls[k]) || rs_aes_set_implementation(impls[k]) != 0) {
+            continue;
+        }
+        snprintf(name, sizeof(name), "rs/derive_A/aes_%s/L0", rs_aes_implementation_name());
+        run(b, name, rs_derive_A_case, &c, 1);
+    }
+    rs_aes_set_implementation(initial);
+
+    run(b, "rs/derive_B_row", rs_derive_B_row_case, &c, 1);
+    run(b, "rs/derive_B_rows64", rs_derive_B_rows_case, &c, RS_PUBLIC_DIM);
+    run(b, "rs/derive_C_rows64", rs_derive_C_rows_case, &c, RS_PUBLIC_DIM);
+    run(b, "rs/expand/eager", rs_expand_case, &c, 1);
+
+    // LWR tags on the LWR B rows
+    uint8_t seed[32] = { 1 };
+    rs_derive_B_rows(&p, 0, RS_PUBLIC_DIM, RS_FLAVOR_LWR, c.B);
+    rs_generate_secret(c.s, seed);
+    for (int k = 0; k < RS_TAG_BATCH; k++) {
+        seed[1] = (uint8_t)k;
+        rs_generate_secret(c.S[k], seed);
+    }
+    run(b, "lwr/tag", lwr_tag_case, &c, 1);
+    run(b, "lwr/tag_bounded", lwr_tag_bounded_case, &c, 1);
+    run(b, "lwr/tag_batch16", lwr_tag_batch_case, &c, RS_TAG_BATCH);
+    run(b, "lwr/tag_from_seed", lwr_tag_from_seed_case, &c, 1);
+
+    rs_params_clear(&p);
+    rs_params_clear(&p_ring);
+}
+
+// ============================================================================
+// SPARSE CODECS
+// ============================================================================
+
+#define SPARSE_DIM 1024
+#define SPARSE_NONZEROS 97
+#define SPARSE_CAP 8192
+
+typedef int (*sparse_encode_fn)(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                                uint8_t *out, size_t out_cap, size_t *written);
+typedef int (*sparse_decode_fn)(sparse_codec_ctx_t *ctx, const uint8_t *data, size_t size,
+                                uint16_t count, int8_t *vector, size_t dimension);
+
+typedef struct {
+    sparse_codec_ctx_t *ctx;
+    sparse_encode_fn encode;
+    sparse_decode_fn decode;
+    int8_t vector[SPARSE_DIM];
+    int8_t decoded[SPARSE_DIM];
+    uint8_t out[SPARSE_CAP];
+    size_t size;
+} sparse_case_t;
+
+// Wrappers with one signature: each codec's _ctx encoder, and its decoder
+// on a result struct over the encoded bytes
+#define SPARSE_CTX_CODEC(codec)                                                               \
+    static int codec##_bench_encode(sparse_codec_ctx_t *ctx, const int8_t *vector,            \
+                                    size_t dimension, uint8_t *out, size_t out_cap,           \
+                                    size_t *written) {                                        \
+        return codec##_encode_ctx(ctx, vector, dimension, out, out_cap, written);             \
+    }                                                                                         \
+    static int codec##_bench_decode(sparse_codec_ctx_t *ctx, const uint8_t *data,             \
+                                    size_t size, uint16_t count, int8_t *vector,              \
+                                    size_t dimension) {                                       \
+        codec##_t e = { (uint8_t *)data, size, count };                                       \
+        return codec##_decode_ctx(ctx, &e, vector, dimension);                                \
+    }
+
+SPARSE_CTX_CODEC(sparse_rice)
+SPARSE_CTX_CODEC(sparse_adaptive)
+SPARSE_CTX_CODEC(sparse_delta)
+SPARSE_CTX_CODEC(sparse_phase3)
+SPARSE_CTX_CODEC(sparse_optimal_large)
+
+static int optimal_bench_encode(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                                uint8_t *out, size_t out_cap, size_t *written) {
+    (void)ctx;
+    return sparse_encode_into(vector, dimension, out, out_cap, written);
+}
+
+static int optimal_bench_decode(sparse_codec_ctx_t *ctx, const uint8_t *data, size_t size,
+                                uint16_t count, int8_t *vector, size_t dimension) {
+    (void)ctx;
+    sparse_encoded_t e = { (uint8_t *)data, size, count };
+    return sparse_decode(&e, vector, dimension);
+}
+
+static int phase2_rans_bench_encode(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                    size_t dimension, uint8_t *out, size_t out_cap,
+                                    size_t *written) {
+    return sparse_phase2_encode_coder_ctx(ctx, vector, dimension, SPARSE_PHASE2_RANS, out,
+                                          out_cap, written);
+}
+
+static int phase2_rans_bench_decode(sparse_codec_ctx_t *ctx, const uint8_t *data, size_t size,
+                                    uint16_t count, int8_t *vector, size_t dimension) {
+    sparse_phase2_t e = { (uint8_t *)data, size, count };
+    return sparse_phase2_decode_coder_ctx(ctx, &e, vector, dimension, SPARSE_PHASE2_RANS);
+}
+
+static int phase2_tans_bench_encode(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                    size_t dimension, uint8_t *out, size_t out_cap,
+                                    size_t *written) {
+    return sparse_phase2_encode_coder_ctx(ctx, vector, dimension, SPARSE_PHASE2_TANS, out,
+                                          out_cap, written);
+}
+
+static int phase2_tans_bench_decode(sparse_codec_ctx_t *ctx, const uint8_t *data, size_t size,
+                                    uint16_t count, int8_t *vector, size_t dimension) {
+    sparse_phase2_t e = { (uint8_t *)data, size, count };
+    return sparse_phase2_decode_coder_ctx(ctx, &e, vector, dimension, SPARSE_PHASE2_TANS);
+}
+
+static int auto_bench_encode(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                             uint8_t *out, size_t out_cap, size_t *written) {
+    (void)ctx;
+    return sparse_auto_encode_into(vector, dimension, NULL, out, out_cap, written);
+}
+
+static int auto_bench_decode(sparse_codec_ctx_t *ctx, const uint8_t *data, size_t size,
+                             uint16_t count, int8_t *vector, size_t dimension) {
+    (void)ctx;
+    sparse_auto_t e = { (uint8_t *)data, size, count };
+    return sparse_auto_decode(&e, vector, dimension, NULL);
+}
+
+static void sparse_encode_case(void *arg) {
+    sparse_case_t *c = arg;
+    c->encode(c->ctx, c->vector, SPARSE_DIM, c->out, SPARSE_CAP, &c->size);
+}
+
+static void sparse_decode_case(void *arg) {
+    sparse_case_t *c = arg;
+    c->decode(c->ctx, c->out, c->size, SPARSE_NONZEROS, c->decoded, SPARSE_DIM);
+}
+
+// Dense Huffman vectors: small coefficients offset to bytes, as the dense
+// paths feed them
+typedef struct {
+    uint8_t vector[SPARSE_DIM];
+    uint8_t decoded[SPARSE_DIM];
+    uint8_t out[SPARSE_CAP];
+    size_t size;
+} huffman_case_t;
+
+static void huffman_encode_case(void *arg) {
+    huffman_case_t *c = arg;
+    huffman_encode_into(c->vector, SPARSE_DIM, c->out, SPARSE_CAP, &c->size);
+}
+
+static void huffman_decode_case(void *arg) {
+    huffman_case_t *c = arg;
+    huffman_decode(c->out, c->size, c->decoded, SPARSE_DIM);
+}
+
+static void huffman_x4_encode_case(void *arg) {
+    huffman_case_t *c = arg;
+    huffman_encode_x4_into(c->vector, SPARSE_DIM, c->out, SPARSE_CAP, &c->size);
+}
+
+static void huffman_x4_decode_case(void *arg) {
+    huffman_case_t *c = arg;
+    huffman_decode_x4(c->out, c->size, c->decoded, SPARSE_DIM);
+}
+
+static void bench_sparse(bench_t *b) {
+    static const struct {
+        const char *name;
+        sparse_encode_fn encode;
+        sparse_decode_fn decode;
+    } codecs[] = {
+        { "optimal", optimal_bench_encode, optimal_bench_decode },
+        { "rice", sparse_rice_bench_encode, sparse_rice_bench_decode },
+        { "adaptive", sparse_adaptive_bench_encode, sparse_adaptive_bench_decode },
+        { "delta", sparse_delta_bench_encode, sparse_delta_bench_decode },
+        { "phase2_rans", phase2_rans_bench_encode, phase2_rans_bench_decode },
+        { "phase2_tans", phase2_tans_bench_encode, phase2_tans_bench_decode },
+        { "phase3", sparse_phase3_bench_encode, sparse_phase3_bench_decode },
+        { "optimal_large", sparse_optimal_large_bench_encode, sparse_optimal_large_bench_decode },
+        { "auto", auto_bench_encode, auto_bench_decode },
+    };
+    static sparse_case_t c;
+    static huffman_case_t h;
+    char name[96];
+
+    // SPARSE_NONZEROS nonzeros of +-1 and +-2, +-1 three times as likely
+    memset(c.vector, 0, sizeof(c.vector));
+    for (int placed = 0; placed < SPARSE_NONZEROS;) {
+        const size_t at = next_rand() % SPARSE_DIM;
+        if (c.vector[at] == 0) {
+            const int mag = (next_rand() & 3) ? 1 : 2;
+            c.vector[at] = (int8_t)((next_rand() & 1) ? mag : -mag);
+            placed++;
+        }
+    }
+    c.ctx = sparse_codec_ctx_create(SPARSE_DIM);
+    if (!c.ctx) {
+        return;
+    }
+    for (size_t k = 0; k < sizeof(codecs) / sizeof(codecs[0]); k++) {
+        c.encode = codecs[k].encode;
+        c.decode = codecs[k].decode;
+        if (c.encode(c.ctx, c.vector, SPARSE_DIM, c.out, SPARSE_CAP, &c.size) != 0 ||
+            c.decode(c.ctx, c.out, c.size, SPARSE_NONZEROS, c.decoded, SPARSE_DIM) != 0 ||
+            memcmp(c.vector, c.decoded, SPARSE_DIM) != 0) {
+            printf("  sparse/%-37s round trip FAILED, skipped\n", codecs[k].name);
+            continue;
+        }
+        snprintf(name, sizeof(name), "sparse/%s/encode", codecs[k].name);
+        run(b, name, sparse_encode_case, &c, 1);
+        snprintf(name, sizeof(name), "sparse/%s/decode", codecs[k].name);
+        run(b, name, sparse_decode_case, &c, 1);
+    }
+    sparse_codec_ctx_free(c.ctx);
+
+    for (int i = 0; i < SPARSE_DIM; i++) {
+        h.vector[i] = (uint8_t)(128 + (int)(next_rand() % 9) - (int)(next_rand() % 9));
+    }
+    run(b, "huffman/encode", huffman_encode_case, &h, 1);
+    run(b, "huffman/decode", huffman_decode_case, &h, 1);
+    run(b, "huffman/x4/encode", huffman_x4_encode_case, &h, 1);
+    run(b, "huffman/x4/decode", huffman_x4_decode_case, &h, 1);
+}
+
+// ============================================================================
+// GAUSSIAN SAMPLERS
+// ============================================================================
+
+#define GAUSS_SEEDS 64
+#define GAUSS_STREAM 1024
+
+typedef void (*gaussian_batch_fn)(const uint8_t (*)[32], size_t, int (*)[GAUSSIAN_N],
+                                  double, double, double);
+
+typedef struct {
+    gaussian_batch_fn batch;
+    uint8_t seeds[GAUSS_SEEDS][32];
+    int out[GAUSS_SEEDS][GAUSSIAN_N];
+    int stream_out[GAUSS_STREAM];
+    gaussian_cdt_t cdt;
+    gaussian_stream_t stream;
+} gaussian_case_t;
+
+static void gaussian_libm_case(void *arg) {
+    gaussian_case_t *c = arg;
+    gaussian_sample(c->seeds[0], c->out[0], 0.0, 12.0, 6.0);
+}
+
+static void gaussian_batch_case(void *arg) {
+    gaussian_case_t *c = arg;
+    c->batch((const uint8_t (*)[32])c->seeds, GAUSS_SEEDS, c->out, 0.0, 12.0, 6.0);
+}
+
+static void gaussian_cdt_case(void *arg) {
+    gaussian_case_t *c = arg;
+    gaussian_sample_cdt(&c->cdt, c->seeds[0], c->out[0]);
+}
+
+static void gaussian_stream_case(void *arg) {
+    gaussian_case_t *c = arg;
+    gaussian_stream_fill(&c->stream, c->stream_out, GAUSS_STREAM);
+}
+
+static void bench_gaussian(bench_t *b) {
+    const struct {
+        const char *name;
+        gaussian_batch_fn fn;
+        int supported;
+    } paths[] = {
+        { "scalar", gaussian_sample_batch_scalar, 1 },
+#if defined(__AVX2__) && defined(__FMA__)
+        { "avx2", gaussian_sample_batch_avx2,
+          __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") },
+#endif
+#ifdef __AVX512F__
+        { "avx512", gaussian_sample_batch_avx512, __builtin_cpu_supports("avx512f") },
+#endif
+        { "dispatch", gaussian_sample_batch, 1 },
+    };
+    static gaussian_case_t c;
+    static const int keygen[] = { 1, 2, 3, 4, 5 };
+    char name[96];
+
+    for (int i = 0; i < GAUSS_SEEDS; i++) {
+        for (int k = 0; k < 32; k++) c.seeds[i][k] = (uint8_t)next_rand();
+    }
+    // Per seed of GAUSSIAN_N samples, as gaussian_sample() produces them
+    run(b, "gaussian/libm", gaussian_libm_case, &c, 1);
+    for (size_t k = 0; k < sizeof(paths) / sizeof(paths[0]); k++) {
+        if (!paths[k].supported) {
+            continue;
+        }
+        c.batch = paths[k].fn;
+        snprintf(name, sizeof(name), "gaussian/batch/%s", paths[k].name);
+        run(b, name, gaussian_batch_case, &c, GAUSS_SEEDS);
+    }
+    gaussian_cdt_init(&c.cdt, 3.0, 1.3, keygen, 5);
+    run(b, "gaussian/cdt", gaussian_cdt_case, &c, 1);
+    gaussian_stream_init(&c.stream, c.seeds[0], 0.0, 12.0, 6.0);
+    run(b, "gaussian/stream_per64", gaussian_stream_case, &c, GAUSS_STREAM / GAUSSIAN_N);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv) {
+    const char *json_path = NULL, *filter = NULL;
+    int cpu = -1;
+    size_t samples = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-o") == 0) {
+            json_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            filter = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) {
+            cpu = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) {
+            samples = (size_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [-o results.json] [-f filter] [-c cpu] [-n samples]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    ntt64_init();
+    rs_aes_init();
+    bench_t *b = bench_create(cpu, samples);
+    if (!b) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    bench_set_filter(b, filter);
+
+    printf("Per operation, in ticks of a %.3f GHz counter (median, p90, p99), and ns\n",
+           bench_ticks_hz(b) * 1e-9);
+    printf("  %-44s %10s %10s %10s %12s\n", "case", "median", "p90", "p99", "median");
+    bench_ntt64(b);
+    bench_ntt_plan(b);
+    bench_rs(b);
+    bench_sparse(b);
+    bench_gaussian(b);
+
+    int ret = 0;
+    if (json_path) {
+        FILE *f = fopen(json_path, "w");
+        if (!f || bench_write_json(b, f) != 0) {
+            fprintf(stderr, "cannot write %s\n", json_path);
+            ret = 1;
+        }
+        if (f && fclose(f) != 0) {
+            ret = 1;
+        }
+        if (!ret) {
+            size_t count;
+            bench_results(b, &count);
+            printf("%zu results written to %s\n", count, json_path);
+        }
+    }
+    bench_destroy(b);
+    return ret;
+}
@@ -0,0 +1,377 @@
+#ifndef BITSTREAM_H
+#define BITSTREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// BITSTREAMS (MSB FIRST)
+// ============================================================================
+
+/**
+ * Bit writer and reader shared by the sparse_* codecs
+ *
+ * Bits are packed most significant first: the first bit of a stream is bit
+ * 7 of byte 0, and a stream of b bits takes ceil(b / 8) bytes, padded with
+ * zeros. Both sides keep a 64-bit accumulator, so a call moves up to
+ * BITSTREAM_MAX_BITS bits with a few shifts and touches memory a word at a
+ * time. Word loads and stores are used while 8 bytes remain in the buffer;
+ * the last bytes go one at a time, and nothing past size or capacity is
+ * ever read or written.
+ */
+#define BITSTREAM_MAX_BITS 57
+
+typedef struct {
+    uint8_t *buffer;
+    size_t capacity;
+    size_t byte_pos;    // bytes stored
+    uint64_t acc;       // pending bits, left-aligned
+    unsigned n;         // pending bits (< 8 between calls)
+} bit_writer_t;
+
+typedef struct {
+    const uint8_t *buffer;
+    size_t size;
+    size_t byte_pos;    // next byte to load
+    uint64_t acc;       // unread bits, left-aligned; bits past n are the
+                        // stream's next bits or zero
+    unsigned n;         // unread bits in acc
+} bit_reader_t;
+
+static inline uint64_t bs_load_be64(const uint8_t *p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    return w;
+}
+
+static inline void bs_store_be64(uint8_t *p, uint64_t w) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    w = __builtin_bswap64(w);
+#endif
+    memcpy(p, &w, sizeof(w));
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+static inline void bw_init(bit_writer_t *bw, uint8_t *buffer, size_t capacity) {
+    bw->buffer = buffer;
+    bw->capacity = capacity;
+    bw->byte_pos = 0;
+    bw->acc = 0;
+    bw->n = 0;
+}
+
+/**
+ * Bits written so far
+ */
+static inline size_t bw_tell(const bit_writer_t *bw) {
+    return bw->byte_pos * 8 + bw->n;
+}
+
+// Store the whole bytes of acc, keeping the last partial byte pending
+static inline void bw_flush(bit_writer_t *bw) {
+    const unsigned bytes = bw->n >> 3;
+    if (bw->capacity - bw->byte_pos >= 8) {
+        // Bytes past the pending ones are zero and rewritten later
+        bs_store_be64(bw->buffer + bw->byte_pos, bw->acc);
+    } else {
+        for (unsigned i = 0; i < bytes; i++) {
+            bw->buffer[bw->byte_pos + i] = (uint8_t)(bw->acc >> (56 - 8 * i));
+        }
+    }
+    bw->byte_pos += bytes;
+    // Two shifts: all 64 bits may have gone out
+    bw->acc <<= 4 * bytes;
+    bw->acc <<= 4 * bytes;
+    bw->n &= 7;
+}
+
+/**
+ * Write the low num_bits bits of value, most significant first
+ *
+ * @param num_bits  0..BITSTREAM_MAX_BITS
+ * @return          0, or -1 (nothing written) if the bits do not fit
+ */
+static inline int bw_write_bits(bit_writer_t *bw, uint64_t value, unsigned num_bits) {
+    if (num_bits == 0) {
+        return 0;
+    }
+    if (bw_tell(bw) + num_bits > bw->capacity * 8) {
+        return -1;
+    }
+    value &= ((uint64_t)1 << num_bits) - 1;
+    bw->acc |= value << (64 - bw->n - num_bits);
+    bw->n += num_bits;
+    bw_flush(bw);
+    return 0;
+}
+
+static inline int bw_write_bit(bit_writer_t *bw, unsigned bit) {
+    return bw_write_bits(bw, bit != 0, 1);
+}
+
+/**
+ * Write q in unary (q ones, then a zero) followed by the low r bits of rem
+ */
+static inline int bw_write_unary_bits(bit_writer_t *bw, uint32_t q, uint64_t rem, unsigned r) {
+    for (; q + 1 + r > BITSTREAM_MAX_BITS && q >= 56; q -= 56) {
+        if (bw_write_bits(bw, ((uint64_t)1 << 56) - 1, 56) < 0) {
+            return -1;
+        }
+    }
+    if (q + 1 + r <= BITSTREAM_MAX_BITS) {
+        rem &= ((uint64_t)1 << r) - 1;
+        return bw_write_bits(bw, ((((uint64_t)1 << q) - 1) << (1 + r)) | rem, q + 1 + r);
+    }
+    if (bw_write_bits(bw, (((uint64_t)1 << q) - 1) << 1, q + 1) < 0) {
+        return -1;
+    }
+    return bw_write_bits(bw, rem, r);
+}
+
+/**
+ * Rice code of value with parameter r: value >> r in unary, then r bits
+ */
+static inline int bw_write_rice(bit_writer_t *bw, uint32_t value, unsigned r) {
+    return bw_write_unary_bits(bw, value >> r, value, r);
+}
+
+/**
+ * Pad with zeros to the next byte boundary
+ */
+static inline void bw_align(bit_writer_t *bw) {
+    bw->n = (bw->n + 7) & ~7u;
+    bw_flush(bw);
+}
+
+/**
+ * Write a whole byte; the stream must be byte-aligned
+ */
+static inline int bw_write_byte(bit_writer_t *bw, uint8_t byte) {
+    if (bw->n != 0) {
+        return -1;
+    }
+    return bw_write_bits(bw, byte, 8);
+}
+
+/**
+ * Store the pending bits, zero-padded
+ *
+ * @return  Bytes used
+ */
+static inline size_t bw_finish(bit_writer_t *bw) {
+    if (bw->n > 0) {
+        bw->buffer[bw->byte_pos] = (uint8_t)(bw->acc >> 56);
+        bw->byte_pos++;
+        bw->acc = 0;
+        bw->n = 0;
+    }
+    return bw->byte_pos;
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+static inline void br_init(bit_reader_t *br, const uint8_t *buffer, size_t size) {
+    br->buffer = buffer;
+    br->size = size;
+    br->byte_pos = 0;
+    br->acc = 0;
+    br->n = 0;
+}
+
+/**
+ * Bits read so far
+ */
+static inline size_t br_tell(const bit_reader_t *br) {
+    return br->byte_pos * 8 - br->n;
+}
+
+/**
+ * Whole bytes left to read
+ */
+static inline size_t br_bytes_left(const bit_reader_t *br) {
+    return (br->size * 8 - br_tell(br)) / 8;
+}
+
+// Top up acc to at least 57 bits, or to the end of the buffer
+static inline void br_refill(bit_reader_t *br) {
+    if (br->size - br->byte_pos >= 8) {
+        // Branchless: take 7 or 8 bytes, leaving 56..63 bits
+        br->acc |= bs_load_be64(br->buffer + br->byte_pos) >> br->n;
+        br->byte_pos += (63 - br->n) >> 3;
+        br->n |= 56;
+    }
+    while (br->n <= 56 && br->byte_pos < br->size) {
+        br->acc |= (uint64_t)br->buffer[br->byte_pos++] << (56 - br->n);
+        br->n += 8;
+    }
+}
+
+/**
+ * Read num_bits bits, most significant first
+ *
+ * @param num_bits  0..BITSTREAM_MAX_BITS
+ * @return          0, or -1 (nothing read) past the end of the buffer
+ */
+static inline int br_read_bits64(bit_reader_t *br, unsigned num_bits, uint64_t *out) {
+    if (num_bits == 0) {
+        *out = 0;
+        return 0;
+    }
+    if (br->n < num_bits) {
+        br_refill(br);
+        if (br->n < num_bits) {
+            return -1;
+        }
+    }
+    *out = br->acc >> (64 - num_bits);
+    br->acc <<= num_bits;
+    br->n -= num_bits;
+    return 0;
+}
+
+/**
+ * Next num_bits bits (1..BITSTREAM_MAX_BITS) without consuming them
+ *
+ * Past the end of the buffer the bits are zero: compare what a caller
+ * goes on to consume with br->n, the bits actually available.
+ */
+static inline uint64_t br_peek(bit_reader_t *br, unsigned num_bits) {
+    if (br->n < num_bits) {
+        br_refill(br);
+    }
+    return br->acc >> (64 - num_bits);
+}
+
+/**
+ * Consume num_bits bits seen through br_peek() (at most br->n)
+ */
+static inline void br_skip(bit_reader_t *br, unsigned num_bits) {
+    br->acc <<= num_bits;
+    br->n -= num_bits;
+}
+
+/**
+ * br_read_bits64() for up to 32 bits
+ */
+static inline int br_read_bits(bit_reader_t *br, unsigned num_bits, uint32_t *out) {
+    uint64_t v;
+    if (br_read_bits64(br, num_bits, &v) < 0) {
+        return -1;
+    }
+    *out = (uint32_t)v;
+    return 0;
+}
+
+/**
+ * Next bit, or -1 past the end of the buffer
+ */
+static inline int br_read_bit(bit_reader_t *br) {
+    if (br->n == 0) {
+        br_refill(br);
+        if (br->n == 0) {
+            return -1;
+        }
+    }
+    int bit = (int)(br->acc >> 63);
+    br->acc <<= 1;
+    br->n--;
+    return bit;
+}
+
+/**
+ * Read a unary count (ones up to a zero), a word of ones at a time
+ *
+ * @param max_q  Largest count accepted
+ * @return       0, or -1 past the end of the buffer or above max_q
+ */
+static inline int br_read_unary(bit_reader_t *br, uint32_t max_q, uint32_t *out) {
+    uint32_t q = 0;
+    for (;;) {
+        if (br->n < BITSTREAM_MAX_BITS) {
+            br_refill(br);
+            if (br->n == 0) {
+                return -1;
+            }
+        }
+        // Leading ones of acc; only the first n count
+        const uint64_t inv = ~br->acc;
+        const unsigned run = inv ? (unsigned)__builtin_clzll(inv) : 64;
+        const unsigned take = run < br->n ? run + 1 : br->n;
+        q += run < br->n ? run : br->n;
+        if (q > max_q) {
+            return -1;
+        }
+        br->acc <<= take / 2;
+        br->acc <<= take - take / 2;
+        br->n -= take;
+        if (run < take) {
+            *out = q;
+            return 0;
+        }
+    }
+}
+
+/**
+ * Read a Rice code written by bw_write_rice()
+ *
+ * A code within the bits at hand (topped up once fewer than 32 remain) is
+ * decoded in one step: a count of leading ones for the quotient, a shift
+ * for the remainder. Longer codes go through br_read_unary().
+ */
+static inline int br_read_rice(bit_reader_t *br, unsigned r, uint32_t max_q, uint32_t *out) {
+    if (br->n < 32) {
+        br_refill(br);
+    }
+    const uint64_t inv = ~br->acc;
+    const unsigned run = inv ? (unsigned)__builtin_clzll(inv) : 64;
+    if (run + 1 + r <= br->n) {
+        if (run > max_q) {
+            return -1;
+        }
+        // run + 1 + r <= 63, so neither shift reaches 64
+        const uint64_t rest = br->acc << run << 1;
+        *out = ((uint32_t)run << r) | (uint32_t)(r ? rest >> (64 - r) : 0);
+        br->acc = rest << r;
+        br->n -= run + 1 + r;
+        return 0;
+    }
+
+    uint32_t q, rem;
+    if (br_read_unary(br, max_q, &q) < 0 || br_read_bits(br, r, &rem) < 0) {
+        return -1;
+    }
+    *out = (q << r) | rem;
+    return 0;
+}
+
+/**
+ * Skip to the next byte boundary
+ */
+static inline void br_align(bit_reader_t *br) {
+    const unsigned drop = br->n & 7;
+    br->acc <<= drop;
+    br->n -= drop;
+}
+
+/**
+ * Read a whole byte; the stream must be byte-aligned
+ */
+static inline int br_read_byte(bit_reader_t *br, uint8_t *out) {
+    uint32_t v;
+    if ((br->n & 7) != 0 || br_read_bits(br, 8, &v) < 0) {
+        return -1;
+    }
+    *out = (uint8_t)v;
+    return 0;
+}
+
+#endif // BITSTREAM_H
@@ -0,0 +1,205 @@
+#ifndef CANONICAL_HUFFMAN_H
+#define CANONICAL_HUFFMAN_H
+
+#include "bitstream.h"
+
+// ============================================================================
+// CANONICAL HUFFMAN DECODING TABLES
+// ============================================================================
+
+/**
+ * Table decoder for the canonical codes of the sparse_* codecs
+ *
+ * The codecs send one code length per alphabet entry (0: unused) and assign
+ * codes canonically: by length, then by alphabet index, starting from 0 and
+ * doubling at each length. chuff_build() turns those lengths into a
+ * primary table indexed by the next bits bits of the stream (bits =
+ * min(longest code, CHUFF_TABLE_BITS)), so a value decodes with one peek, one
+ * load and one skip. Longer codes fall back to per-length first-code tables.
+ * The multi-symbol table holds up to CHUFF_MULTI_SYMS consecutive short
+ * codes per index, for streams long enough to repay building it.
+ *
+ * A stream decodes exactly as a bit-at-a-time search for the shortest
+ * matching code would, malformed length sets included.
+ */
+#define CHUFF_MAX_LEN     31
+#define CHUFF_MAX_SYMBOLS 256
+#define CHUFF_TABLE_BITS  10
+#define CHUFF_MULTI_SYMS  4
+
+typedef struct {
+    uint8_t sym;            // alphabet index
+    uint8_t len;            // 0: no code of length <= bits starts here
+} chuff_entry_t;
+
+typedef struct {
+    uint8_t n;              // symbols decoded by this entry
+    uint8_t len;            // bits they take
+    uint8_t sym[CHUFF_MULTI_SYMS];
+} chuff_multi_t;
+
+typedef struct {
+    unsigned bits;          // primary table index width
+    unsigned max_len;       // longest code
+    int has_multi;
+    uint32_t first_code[CHUFF_MAX_LEN + 1];
+    uint16_t first_index[CHUFF_MAX_LEN + 1];
+    uint16_t count[CHUFF_MAX_LEN + 1];
+    uint8_t sorted[CHUFF_MAX_SYMBOLS];      // alphabet indices, canonical order
+    chuff_entry_t primary[1 << CHUFF_TABLE_BITS];
+    chuff_multi_t multi[1 << CHUFF_TABLE_BITS];
+} chuff_table_t;
+
+/**
+ * Build the tables for n_symbols code lengths
+ *
+ * @param lengths    Code length of each alphabet entry, 0..CHUFF_MAX_LEN
+ * @param expected   Symbols the tables will decode: the multi-symbol table
+ *                   is built when they are at least as many as its entries
+ * @return           0, or -1 if n_symbols is out of range, a length is too
+ *                   long, or no entry has a code
+ */
+static inline int chuff_build(chuff_table_t *t, const uint8_t *lengths, int n_symbols,
+                              size_t expected) {
+    if (n_symbols <= 0 || n_symbols > CHUFF_MAX_SYMBOLS) {
+        return -1;
+    }
+
+    memset(t->count, 0, sizeof(t->count));
+    t->max_len = 0;
+    for (int i = 0; i < n_symbols; i++) {
+        if (lengths[i] > CHUFF_MAX_LEN) {
+            return -1;
+        }
+        t->count[lengths[i]]++;
+        if (lengths[i] > t->max_len) {
+            t->max_len = lengths[i];
+        }
+    }
+    if (t->max_len == 0) {
+        return -1;
+    }
+
+    // Codes as the codecs assign them, 32-bit wraparound included
+    uint32_t code = 0;
+    uint16_t index = 0;
+    for (unsigned len = 1; len <= CHUFF_MAX_LEN; len++) {
+        t->first_code[len] = code;
+        t->first_index[len] = index;
+        for (int i = 0; i < n_symbols; i++) {
+            if (lengths[i] == len) {
+                t->sorted[index++] = (uint8_t)i;
+            }
+        }
+        code = (code + t->count[len]) << 1;
+    }
+
+    // Shortest codes first: an entry keeps the shortest code that matches
+    t->bits = t->max_len < CHUFF_TABLE_BITS ? t->max_len : CHUFF_TABLE_BITS;
+    const unsigned bits = t->bits;
+    memset(t->primary, 0, sizeof(t->primary[0]) << bits);
+    for (unsigned len = 1; len <= bits; len++) {
+        for (unsigned k = 0; k < t->count[len]; k++) {
+            const uint32_t c = t->first_code[len] + k;
+            if (c >> len) {
+                continue;       // past the length's code space: never matches
+            }
+            const uint32_t lo = c << (bits - len), hi = (c + 1) << (bits - len);
+            for (uint32_t e = lo; e < hi; e++) {
+                if (t->primary[e].len == 0) {
+                    t->primary[e].sym = t->sorted[t->first_index[len] + k];
+                    t->primary[e].len = (uint8_t)len;
+                }
+            }
+        }
+    }
+
+    t->has_multi = expected >= ((size_t)1 << bits);
+    if (t->has_multi) {
+        const uint32_t mask = (1u << bits) - 1;
+        for (uint32_t w = 0; w <= mask; w++) {
+            chuff_multi_t *m = &t->multi[w];
+            m->n = 0;
+            m->len = 0;
+            while (m->n < CHUFF_MULTI_SYMS) {
+                const chuff_entry_t e = t->primary[(w << m->len) & mask];
+                if (e.len == 0 || e.len > bits - m->len) {
+                    break;
+                }
+                m->sym[m->n++] = e.sym;
+                m->len += e.len;
+            }
+        }
+    }
+    return 0;
+}
+
+// Codes longer than the primary table, shortest first
+static inline int chuff_decode_slow(const chuff_table_t *t, bit_reader_t *br) {
+    const uint64_t window = br_peek(br, t->max_len);
+    for (unsigned len = t->bits + 1; len <= t->max_len; len++) {
+        if (len > br->n) {
+            return -1;
+        }
+        const uint32_t v = (uint32_t)(window >> (t->max_len - len));
+        const uint32_t k = v - t->first_code[len];
+        if (k < t->count[len]) {
+            br_skip(br, len);
+            return t->sorted[t->first_index[len] + k];
+        }
+    }
+    return -1;
+}
+
+/**
+ * Decode one symbol
+ *
+ * @return  Alphabet index, or -1 on a stream that matches no code or ends
+ */
+static inline int chuff_decode(const chuff_table_t *t, bit_reader_t *br) {
+    const chuff_entry_t e = t->primary[br_peek(br, t->bits)];
+    if (e.len == 0) {
+        return chuff_decode_slow(t, br);
+    }
+    if (e.len > br->n) {
+        return -1;
+    }
+    br_skip(br, e.len);
+    return e.sym;
+}
+
+/**
+ * Decode n symbols into out, several per lookup where the multi-symbol
+ * table allows
+ *
+ * @return  0, or -1 as chuff_decode()
+ */
+static inline int chuff_decode_n(const chuff_table_t *t, bit_reader_t *br, uint8_t *out, size_t n) {
+    size_t i = 0;
+    if (t->has_multi) {
+        while (n - i >= CHUFF_MULTI_SYMS) {
+            const chuff_multi_t *m = &t->multi[br_peek(br, t->bits)];
+            if (m->n >= 2 && m->len <= br->n) {
+                memcpy(out + i, m->sym, CHUFF_MULTI_SYMS);
+                i += m->n;
+                br_skip(br, m->len);
+                continue;
+            }
+            const int sym = chuff_decode(t, br);
+            if (sym < 0) {
+                return -1;
+            }
+            out[i++] = (uint8_t)sym;
+        }
+    }
+    for (; i < n; i++) {
+        const int sym = chuff_decode(t, br);
+        if (sym < 0) {
+            return -1;
+        }
+        out[i] = (uint8_t)sym;
+    }
+    return 0;
+}
+
+#endif // CANONICAL_HUFFMAN_H
@@ -0,0 +1,395 @@
+#include "dlog257.h"
+#include <string.h>
+
+#if defined(__AVX512VBMI__) && defined(__AVX512BW__)
+#define DLOG257_VBMI 1
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define DLOG257_AVX2 1
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// TABLES
+// ============================================================================
+
+#if defined(DLOG257_VBMI) || defined(DLOG257_AVX2)
+
+// log3(x) at x - 1, for x = 1 .. 256
+static const uint8_t LOG_TABLE[256] __attribute__((aligned(64))) = {
+      0,  48,   1,  96,  55,  49,  85, 144,   2, 103, 196,  97, 106, 133,  56, 192,
+    120,  50, 125, 151,  86, 244,  28, 145, 110, 154,   3, 181,  94, 104, 242, 240,
+    197, 168, 140,  98, 219, 173, 107, 199,  19, 134, 207,  36,  57,  76,  61, 193,
+    170, 158, 121, 202,  89,  51, 251, 229, 126, 142, 118, 152, 138,  34,  87,  32,
+    161, 245, 100, 216,  29, 188, 163, 146,  44,  11, 111, 221,  25, 155,  22, 247,
+      4,  67,  15, 182, 175, 255,  95,  84, 102, 105, 191, 124, 243, 109, 180, 241,
+    167, 218, 198, 206,  75, 169, 201, 250, 141, 137,  31,  99, 187,  43, 220,  21,
+     66, 174,  83, 190, 108, 166, 205, 200, 136, 186,  20,  82, 165, 135,  81,  80,
+    208, 209,   7,  37, 210, 148,  58,   8,  72,  77,  38, 236,  62, 211,  46, 194,
+    149,  92, 171,  59, 227, 159,   9,  13, 122,  73,  41, 203,  78,  70,  90,  39,
+    113,  52, 237, 115, 252,  63, 233, 230, 212, 223, 127,  47,  54, 143, 195, 132,
+    119, 150,  27, 153,  93, 239, 139, 172,  18,  35,  60, 157,  88, 228, 117,  33,
+    160, 215, 162,  10,  24, 246,  14, 254, 101, 123, 179, 217,  74, 249,  30,  42,
+     65, 189, 204, 185, 164,  79,   6, 147,  71, 235,  45,  91, 226,  12,  40,  69,
+    112, 114, 232, 222,  53, 131,  26, 238,  17, 156, 116, 214,  23, 253, 178, 248,
+     64, 184,   5, 234, 225,  68, 231, 130,  16, 213, 177, 183, 224, 129, 176, 128,
+};
+
+// 3^e - 1, for e = 0 .. 255
+static const uint8_t EXP_TABLE[256] __attribute__((aligned(64))) = {
+      0,   2,   8,  26,  80, 242, 214, 130, 135, 150, 195,  73, 221, 151, 198,  82,
+    248, 232, 184,  40, 122, 111,  78, 236, 196,  76, 230, 178,  22,  68, 206, 106,
+     63, 191,  61, 185,  43, 131, 138, 159, 222, 154, 207, 109,  72, 218, 142, 171,
+      1,   5,  17,  53, 161, 228, 172,   4,  14,  44, 134, 147, 186,  46, 140, 165,
+    240, 208, 112,  81, 245, 223, 157, 216, 136, 153, 204, 100,  45, 137, 156, 213,
+    127, 126, 123, 114,  87,   6,  20,  62, 188,  52, 158, 219, 145, 180,  28,  86,
+      3,  11,  35, 107,  66, 200,  88,   9,  29,  89,  12,  38, 116,  93,  24,  74,
+    224, 160, 225, 163, 234, 190,  58, 176,  16,  50, 152, 201,  91,  18,  56, 170,
+    255, 253, 247, 229, 175,  13,  41, 125, 120, 105,  60, 182,  34, 104,  57, 173,
+      7,  23,  71, 215, 133, 144, 177,  19,  59, 179,  25,  77, 233, 187,  49, 149,
+    192,  64, 194,  70, 212, 124, 117,  96,  33, 101,  48, 146, 183,  37, 113,  84,
+    254, 250, 238, 202,  94,  27,  83, 251, 241, 211, 121, 108,  69, 209, 115,  90,
+     15,  47, 143, 174,  10,  32,  98,  39, 119, 102,  51, 155, 210, 118,  99,  42,
+    128, 129, 132, 141, 168, 249, 235, 193,  67, 203,  97,  36, 110,  75, 227, 169,
+    252, 244, 220, 148, 189,  55, 167, 246, 226, 166, 243, 217, 139, 162, 231, 181,
+     31,  95,  30,  92,  21,  65, 197,  79, 239, 205, 103,  54, 164, 237, 199,  85,
+};
+
+#endif
+
+// 3^(2^j) and 3^-(2^j) mod 257
+static const uint32_t POW2_GEN[8] = { 3, 9, 81, 136, 249, 64, 241, 256 };
+static const uint32_t POW2_GEN_INV[8] = { 86, 200, 165, 240, 32, 253, 16, 256 };
+
+// ============================================================================
+// SCALAR CONVERSIONS
+// ============================================================================
+
+// [0, 257] -> 0xFF if zero (0 or 257), else 0
+static inline uint8_t zero_flag(uint32_t x) {
+    return (uint8_t)-(uint32_t)((x == 0) | (x == 257));
+}
+
+/**
+ * log3(x) without a table: y = x * 3^-(low bits found so far) is a power of
+ * 3^(2^j), and y^(2^(7-j)) is 1 or -1 (= 256) as bit j of the log is 0 or 1
+ *
+ * Zero (0 or 257) gives 0. The multiplies by a constant divisor compile to
+ * multiply-shift sequences, so no step depends on x.
+ */
+static uint8_t log_scalar(uint32_t x) {
+    uint32_t y = x % 257;
+    uint32_t e = 0;
+
+    for (int j = 0; j < 8; j++) {
+        uint32_t t = y;
+        for (int s = j; s < 7; s++) {
+            t = t * t % 257;
+        }
+        const uint32_t bit = (t >> 8) & 1;
+        const uint32_t mask = -bit;
+        y = (y & ~mask) | ((y * POW2_GEN_INV[j] % 257) & mask);
+        e |= bit << j;
+    }
+    return (uint8_t)e;
+}
+
+// 3^e, or 0 if zero is 0xFF: square-and-multiply over all eight bits
+static uint32_t exp_scalar(uint8_t e, uint8_t zero) {
+    uint32_t r = 1;
+    for (int j = 0; j < 8; j++) {
+        const uint32_t mask = -(uint32_t)((e >> j) & 1);
+        r = (r & ~mask) | ((r * POW2_GEN[j] % 257) & mask);
+    }
+    return r & ~(uint32_t)-(int32_t)(zero >> 7);
+}
+
+// Products of elements i .. n - 1 (the tails the vector kernels leave)
+static void mul_values_scalar(dlog257_vec_t *v, const uint32_t *x, size_t i) {
+    for (; i < v->n; i++) {
+        const uint8_t z = zero_flag(x[i]);
+        v->zero[i] |= z;
+        v->e[i] = (uint8_t)(v->e[i] + log_scalar(x[i])) & (uint8_t)~v->zero[i];
+    }
+}
+
+static void store_scalar(const dlog257_vec_t *v, uint32_t *out, size_t i) {
+    for (; i < v->n; i++) {
+        out[i] = exp_scalar(v->e[i], v->zero[i]);
+    }
+}
+
+// ============================================================================
+// AVX-512 VBMI KERNELS
+// ============================================================================
+//
+// 64 coefficients per step: vpmovdb narrows four vectors of words to one of
+// bytes, and a 256-byte table is read as two 128-byte vpermi2b halves picked
+// by bit 7 of the index.
+
+#ifdef DLOG257_VBMI
+
+typedef struct {
+    __m512i t[4];
+} vbmi_table_t;
+
+static inline void vbmi_table_load(vbmi_table_t *tab, const uint8_t *table) {
+    for (int k = 0; k < 4; k++) {
+        tab->t[k] = _mm512_load_si512((const void *)(table + 64 * k));
+    }
+}
+
+static inline __m512i vbmi_lookup(const vbmi_table_t *tab, __m512i idx) {
+    const __m512i lo = _mm512_permutex2var_epi8(tab->t[0], idx, tab->t[1]);
+    const __m512i hi = _mm512_permutex2var_epi8(tab->t[2], idx, tab->t[3]);
+    return _mm512_mask_blend_epi8(_mm512_movepi8_mask(idx), lo, hi);
+}
+
+// x - 1 as bytes, and the zero flags as a mask
+static inline __m512i vbmi_index(const uint32_t *x, __mmask64 *zero) {
+    const __m512i one = _mm512_set1_epi32(1), q = _mm512_set1_epi32(257);
+    __m512i idx = _mm512_setzero_si512();
+    uint64_t z = 0;
+
+    for (int k = 0; k < 4; k++) {
+        const __m512i w = _mm512_loadu_si512((const void *)(x + 16 * k));
+        const __mmask16 zk = _mm512_cmpeq_epi32_mask(w, _mm512_setzero_si512()) |
+                             _mm512_cmpeq_epi32_mask(w, q);
+        z |= (uint64_t)zk << (16 * k);
+        const __m128i b = _mm512_cvtepi32_epi8(_mm512_sub_epi32(w, one));
+        switch (k) {
+        case 0: idx = _mm512_inserti32x4(idx, b, 0); break;
+        case 1: idx = _mm512_inserti32x4(idx, b, 1); break;
+        case 2: idx = _mm512_inserti32x4(idx, b, 2); break;
+        default: idx = _mm512_inserti32x4(idx, b, 3); break;
+        }
+    }
+    *zero = z;
+    return idx;
+}
+
+static size_t mul_values_vector(dlog257_vec_t *v, const uint32_t *x) {
+    vbmi_table_t tab;
+    vbmi_table_load(&tab, LOG_TABLE);
+    size_t i = 0;
+
+    for (; i + 64 <= v->n; i += 64) {
+        __mmask64 z;
+        const __m512i logs = vbmi_lookup(&tab, vbmi_index(x + i, &z));
+        const __mmask64 zero = _mm512_movepi8_mask(_mm512_load_si512((const void *)(v->zero + i))) | z;
+        const __m512i e = _mm512_add_epi8(_mm512_load_si512((const void *)(v->e + i)), logs);
+        _mm512_store_si512((void *)(v->e + i), _mm512_maskz_mov_epi8(~zero, e));
+        _mm512_store_si512((void *)(v->zero + i), _mm512_movm_epi8(zero));
+    }
+    return i;
+}
+
+static size_t mul_vector(dlog257_vec_t *v, const dlog257_vec_t *w) {
+    size_t i = 0;
+    for (; i + 64 <= v->n; i += 64) {
+        const __m512i zero = _mm512_or_si512(_mm512_load_si512((const void *)(v->zero + i)),
+                                             _mm512_load_si512((const void *)(w->zero + i)));
+        const __m512i e = _mm512_add_epi8(_mm512_load_si512((const void *)(v->e + i)),
+                                          _mm512_load_si512((const void *)(w->e + i)));
+        _mm512_store_si512((void *)(v->e + i), _mm512_andnot_si512(zero, e));
+        _mm512_store_si512((void *)(v->zero + i), zero);
+    }
+    return i;
+}
+
+static size_t store_vector(const dlog257_vec_t *v, uint32_t *out) {
+    vbmi_table_t tab;
+    vbmi_table_load(&tab, EXP_TABLE);
+    const __m512i one = _mm512_set1_epi32(1);
+    size_t i = 0;
+
+    for (; i + 64 <= v->n; i += 64) {
+        const __m512i b = vbmi_lookup(&tab, _mm512_load_si512((const void *)(v->e + i)));
+        const uint64_t zero =
+            _mm512_movepi8_mask(_mm512_load_si512((const void *)(v->zero + i)));
+        for (int k = 0; k < 4; k++) {
+            __m128i part;
+            switch (k) {
+            case 0: part = _mm512_extracti32x4_epi32(b, 0); break;
+            case 1: part = _mm512_extracti32x4_epi32(b, 1); break;
+            case 2: part = _mm512_extracti32x4_epi32(b, 2); break;
+            default: part = _mm512_extracti32x4_epi32(b, 3); break;
+            }
+            const __m512i w = _mm512_cvtepu8_epi32(part);
+            const __mmask16 keep = (__mmask16)~(zero >> (16 * k));
+            _mm512_storeu_si512((void *)(out + i + 16 * k), _mm512_maskz_add_epi32(keep, w, one));
+        }
+    }
+    return i;
+}
+
+#endif // DLOG257_VBMI
+
+// ============================================================================
+// AVX2 KERNELS
+// ============================================================================
+//
+// 32 coefficients per step. A table lookup runs all sixteen 16-byte rows:
+// row h is read with pshufb at index (idx ^ 16h) +sat 0x70, which keeps the
+// low nibble when idx's high nibble is h and sets bit 7 (read as zero)
+// otherwise.
+
+#ifdef DLOG257_AVX2
+
+typedef struct {
+    __m256i t[16];
+} avx2_table_t;
+
+static inline void avx2_table_load(avx2_table_t *tab, const uint8_t *table) {
+    for (int h = 0; h < 16; h++) {
+        tab->t[h] = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)(table + 16 * h)));
+    }
+}
+
+static inline __m256i avx2_lookup(const avx2_table_t *tab, __m256i idx) {
+    const __m256i bias = _mm256_set1_epi8(0x70);
+    __m256i r = _mm256_setzero_si256();
+    for (int h = 0; h < 16; h++) {
+        const __m256i sel = _mm256_adds_epu8(_mm256_xor_si256(idx, _mm256_set1_epi8((char)(h << 4))),
+                                             bias);
+        r = _mm256_or_si256(r, _mm256_shuffle_epi8(tab->t[h], sel));
+    }
+    return r;
+}
+
+// Bytes of four vectors of words, in order: the packs work per 128-bit lane
+static inline __m256i avx2_narrow(__m256i a, __m256i b, __m256i c, __m256i d, int sign) {
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i p = sign ? _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d))
+                           : _mm256_packus_epi16(_mm256_packus_epi32(a, b),
+                                                 _mm256_packus_epi32(c, d));
+    return _mm256_permutevar8x32_epi32(p, order);
+}
+
+// x - 1 as bytes, and the zero flags as 0xFF bytes
+static inline __m256i avx2_index(const uint32_t *x, __m256i *zero) {
+    const __m256i one = _mm256_set1_epi32(1), low = _mm256_set1_epi32(0xFF);
+    const __m256i q = _mm256_set1_epi32(257), nil = _mm256_setzero_si256();
+    __m256i idx[4], z[4];
+
+    for (int k = 0; k < 4; k++) {
+        const __m256i w = _mm256_loadu_si256((const __m256i *)(x + 8 * k));
+        z[k] = _mm256_or_si256(_mm256_cmpeq_epi32(w, nil), _mm256_cmpeq_epi32(w, q));
+        idx[k] = _mm256_and_si256(_mm256_sub_epi32(w, one), low);
+    }
+    *zero = avx2_narrow(z[0], z[1], z[2], z[3], 1);
+    return avx2_narrow(idx[0], idx[1], idx[2], idx[3], 0);
+}
+
+static size_t mul_values_vector(dlog257_vec_t *v, const uint32_t *x) {
+    avx2_table_t tab;
+    avx2_table_load(&tab, LOG_TABLE);
+    size_t i = 0;
+
+    for (; i + 32 <= v->n; i += 32) {
+        __m256i z;
+        const __m256i logs = avx2_lookup(&tab, avx2_index(x + i, &z));
+        const __m256i zero = _mm256_or_si256(_mm256_load_si256((const __m256i *)(v->zero + i)), z);
+        const __m256i e = _mm256_add_epi8(_mm256_load_si256((const __m256i *)(v->e + i)), logs);
+        _mm256_store_si256((__m256i *)(v->e + i), _mm256_andnot_si256(zero, e));
+        _mm256_store_si256((__m256i *)(v->zero + i), zero);
+    }
+    return i;
+}
+
+static size_t mul_vector(dlog257_vec_t *v, const dlog257_vec_t *w) {
+    size_t i = 0;
+    for (; i + 32 <= v->n; i += 32) {
+        const __m256i zero = _mm256_or_si256(_mm256_load_si256((const __m256i *)(v->zero + i)),
+                                             _mm256_load_si256((const __m256i *)(w->zero + i)));
+        const __m256i e = _mm256_add_epi8(_mm256_load_si256((const __m256i *)(v->e + i)),
+                                          _mm256_load_si256((const __m256i *)(w->e + i)));
+        _mm256_store_si256((__m256i *)(v->e + i), _mm256_andnot_si256(zero, e));
+        _mm256_store_si256((__m256i *)(v->zero + i), zero);
+    }
+    return i;
+}
+
+static size_t store_vector(const dlog257_vec_t *v, uint32_t *out) {
+    avx2_table_t tab;
+    avx2_table_load(&tab, EXP_TABLE);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t i = 0;
+
+    for (; i + 32 <= v->n; i += 32) {
+        const __m256i b = avx2_lookup(&tab, _mm256_load_si256((const __m256i *)(v->e + i)));
+        const __m256i zero = _mm256_load_si256((const __m256i *)(v->zero + i));
+        const __m128i bh[2] = { _mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1) };
+        const __m128i zh[2] = { _mm256_castsi256_si128(zero), _mm256_extracti128_si256(zero, 1) };
+        for (int k = 0; k < 4; k++) {
+            const __m128i bk = (k & 1) ? _mm_srli_si128(bh[k >> 1], 8) : bh[k >> 1];
+            const __m128i zk = (k & 1) ? _mm_srli_si128(zh[k >> 1], 8) : zh[k >> 1];
+            const __m256i w = _mm256_add_epi32(_mm256_cvtepu8_epi32(bk), one);
+            _mm256_storeu_si256((__m256i *)(out + i + 8 * k),
+                                _mm256_andnot_si256(_mm256_cvtepi8_epi32(zk), w));
+        }
+    }
+    return i;
+}
+
+#endif // DLOG257_AVX2
+
+#if !defined(DLOG257_VBMI) && !defined(DLOG257_AVX2)
+
+static size_t mul_values_vector(dlog257_vec_t *v, const uint32_t *x) {
+    (void)v;
+    (void)x;
+    return 0;
+}
+
+static size_t mul_vector(dlog257_vec_t *v, const dlog257_vec_t *w) {
+    (void)v;
+    (void)w;
+    return 0;
+}
+
+static size_t store_vector(const dlog257_vec_t *v, uint32_t *out) {
+    (void)v;
+    (void)out;
+    return 0;
+}
+
+#endif
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+int dlog257_load(dlog257_vec_t *v, const uint32_t *x, size_t n) {
+    if (n == 0 || n > DLOG257_MAX_N) {
+        return -1;
+    }
+    v->n = n;
+    memset(v->e, 0, n);
+    memset(v->zero, 0, n);
+    dlog257_mul_values(v, x);
+    return 0;
+}
+
+void dlog257_mul_values(dlog257_vec_t *v, const uint32_t *x) {
+    mul_values_scalar(v, x, mul_values_vector(v, x));
+}
+
+void dlog257_mul(dlog257_vec_t *v, const dlog257_vec_t *w) {
+    for (size_t i = mul_vector(v, w); i < v->n; i++) {
+        v->zero[i] |= w->zero[i];
+        v->e[i] = (uint8_t)(v->e[i] + w->e[i]) & (uint8_t)~v->zero[i];
+    }
+}
+
+void dlog257_store(const dlog257_vec_t *v, uint32_t *out) {
+    store_scalar(v, out, store_vector(v, out));
+}
+
+int dlog257_has_zero(const dlog257_vec_t *v) {
+    uint8_t zero = 0;
+    for (size_t i = 0; i < v->n; i++) {
+        zero |= v->zero[i];
+    }
+    return zero != 0;
+}
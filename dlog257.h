@@ -0,0 +1,89 @@
+#ifndef DLOG257_H
+#define DLOG257_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// DISCRETE-LOG VECTORS MOD 257
+// ============================================================================
+//
+// Z_257* is cyclic of order 256 with generator 3, so a nonzero residue x is
+// 3^e for one byte e = log3(x), and a product of residues is a sum of bytes
+// mod 256. A vector kept as logs turns a chain of pointwise products
+// (fold_instance() in dntl_dsa.c multiplies hundreds of basis rows) into
+// byte additions: 32 lanes per AVX2 add, 64 per AVX-512.
+//
+// Zero has no log. Each coefficient carries a zero flag next to its log,
+// and a product has the flag if any factor did; inputs read both 0 and 257
+// (zero in the naturals convention of libdntln.py) as zero. Rows from
+// filter_basis() never hold a zero, but a vector accepts them anyway.
+//
+// Conversions take the same time for every value:
+//
+//   - AVX-512 VBMI looks logs up with byte permutes over the whole 256-byte
+//     table (two vpermi2b per 64 values)
+//   - AVX2 uses sixteen 16-byte shuffles, one per high nibble, each over
+//     every lane
+//   - the scalar fallback has no table: the log is read bit by bit
+//     (Pohlig-Hellman, as the group order is 2^8) and the antilog is a
+//     square-and-multiply with masks
+//
+// Usage:
+//   dlog257_vec_t acc;
+//   dlog257_load(&acc, row0, n);
+//   dlog257_mul_values(&acc, row1);
+//   dlog257_store(&acc, product);
+
+// Longest vector
+#define DLOG257_MAX_N 256
+
+// Defined where a chain of dlog257_mul_values() beats the same chain of
+// ntt_plan_pointwise_mul(): about twice as fast with VBMI, while the AVX2
+// lookup (sixteen shuffles per 32 bytes) is slower than an AVX2 product
+#if defined(__AVX512VBMI__) && defined(__AVX512BW__)
+#define DLOG257_FAST 1
+#endif
+
+/**
+ * n residues mod 257 as logs to base 3
+ *
+ * Coefficient i is 0 if zero[i] is 0xFF, else 3^e[i]; e[i] is 0 where the
+ * coefficient is zero.
+ */
+typedef struct {
+    uint8_t e[DLOG257_MAX_N] __attribute__((aligned(64)));
+    uint8_t zero[DLOG257_MAX_N] __attribute__((aligned(64)));
+    size_t n;
+} dlog257_vec_t;
+
+/**
+ * v = x: the logs of n values in [0, 257]
+ *
+ * @param n         1 .. DLOG257_MAX_N
+ * @return          0, or -1 if n is out of range
+ */
+int dlog257_load(dlog257_vec_t *v, const uint32_t *x, size_t n);
+
+/**
+ * v = v * x pointwise for v->n values x in [0, 257], without storing the
+ * logs of x
+ */
+void dlog257_mul_values(dlog257_vec_t *v, const uint32_t *x);
+
+/**
+ * v = v * w pointwise (same n)
+ */
+void dlog257_mul(dlog257_vec_t *v, const dlog257_vec_t *w);
+
+/**
+ * The values of v, canonical in [0, 257)
+ */
+void dlog257_store(const dlog257_vec_t *v, uint32_t *out);
+
+/**
+ * 1 if any coefficient is zero, without branching on the data
+ */
+int dlog257_has_zero(const dlog257_vec_t *v);
+
+#endif // DLOG257_H
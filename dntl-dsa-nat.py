@@ -11,6 +11,11 @@ import hashlib
 parser = argparse.ArgumentParser(description="DNTL-DSA")
 xof = hashlib.shake_256
 parser.add_argument("-c", required=False, default=1, type=int, help="Config block")
+parser.add_argument("--native", action="store_true", help="Use the C engine (make -f Makefile.dntl python)")
+parser.add_argument("--native-sk", action="store_true",
+                    help="Draw keyGen's secret with dntl_native.sample_short_key")
+parser.add_argument("--sampler", choices=["mt19937", "shake256"], default="mt19937",
+                    help="Public-basis sampler (shake256: SHAKE-256 stream, see dntl_dsa.h)")
 
 args = parser.parse_args()
 CRange = np.arange(1,258, dtype=int).tolist()
@@ -75,10 +80,6 @@ if args.c == 1:
 
 from libdntln import *
 
-def natural_mod(x, MODULUS):
-    # Custom natural modulo function that maps to [1, MODULUS]
-    res = x % MODULUS
-    return res if res != 0 else MODULUS
 import gmpy2
 
 def forward_ntt_naturals(a, MODULUS=257, ROOT_OF_UNITY=3):
@@ -176,7 +177,38 @@ def filter_basis(basis, modulus=257):
     # Replace 257 (additive identity) with a safe value, like 1
     return [x if x != modulus else 1 for x in basis]
 
+BASIS_XOF_TAG = b"DNTL-DSA basis"
+BASIS_XOF_BLOCK = 544  # bytes per counter block (DNTL_XOF_BLOCK_BYTES)
+
+def basisXofCoefficients(seed_bytes, modulus=257):
+    # Coefficients idx + 1 (modulus replaced by 1) from 16-bit little-endian
+    # words of SHAKE256(tag || seed || block) for block = 0, 1, ...
+    limit = 65536 - 65536 % modulus
+    block = 0
+    while True:
+        data = xof(BASIS_XOF_TAG + seed_bytes + block.to_bytes(4, "little")).digest(BASIS_XOF_BLOCK)
+        words = np.frombuffer(data, dtype="<u2")
+        for idx in (words[words < limit] % modulus).tolist():
+            yield 1 if idx == modulus - 1 else idx + 1
+        block += 1
+
+def sampleMatrixXOF(seed, n, A_VEC=A_VEC):
+    # Rows are the zero-free candidates of the stream, in order: 2*(n//2) for
+    # the core instance, then 2*(A_VEC//2) for each further instance
+    coefficients = basisXofCoefficients(seed.to_bytes(SEED_SIZE, byteorder="big"))
+    def next_row():
+        while True:
+            ntt_rep = forward_ntt_naturals([next(coefficients) for _ in range(n)])
+            if not np.any(257 <= np.array(ntt_rep)):
+                return ntt_rep
+    A = [[next_row() for _ in range(2 * (n // 2))]]
+    for _ in range(K - 1):
+        A.append([next_row() for _ in range(2 * (A_VEC // 2))])
+    return A
+
 def sampleMatrixISISL2(seed, n, A_VEC=A_VEC):
+    if args.sampler == "shake256":
+        return sampleMatrixXOF(seed, n, A_VEC)
     random.seed(seed)
     np.random.seed(seed % 2**32)
     A = []
@@ -220,17 +252,27 @@ def sampleMatrixISISL2(seed, n, A_VEC=A_VEC):
     
     return A
 
+def compileBasis(A):
+    # Pointwise products are associative: each instance collapses into the
+    # product of its rows, so applying it is one multiplication
+    compiled = []
+    for M in A:
+        prod = M[0]
+        for vec in M[1:]:
+            prod = pointwise_multiplication(prod, vec, Q)
+        compiled.append(np.array(prod))
+    return compiled
+
 def verify(m, PK_C, pk, sig, u):
     SC = xof(u + m + pk.tobytes()).digest(SEED_SIZE)
     sig_seed = int.from_bytes(SC, byteorder="big")
-    (S_A1) = sampleMatrixISISL2(sig_seed, N)
+    S_A1 = compileBasis(sampleMatrixISISL2(sig_seed, N))
     pk_seed = int.from_bytes(PK_C, byteorder="big")
-    (PK_A1) = sampleMatrixISISL2(pk_seed, N)
+    PK_A1 = compileBasis(sampleMatrixISISL2(pk_seed, N))
     lhs = pk
     rhs = sig
     for S1 in S_A1:
-        for S_vec in S1:
-            lhs = np.array(pointwise_multiplication(lhs, S_vec, Q))
+        lhs = np.array(pointwise_multiplication(lhs, S1, Q))
         lhs = np.array(inverse_ntt_naturals(lhs))
         lhs = np.array(forward_ntt_naturals(lhs, Q2, R2))
         lhs_sq = np.array(pointwise_addition(lhs, lhs, Q2))
@@ -239,8 +281,7 @@ def verify(m, PK_C, pk, sig, u):
         lhs = np.array(forward_ntt_naturals(lhs))
 
     for PK in PK_A1:
-        for PK_vec in PK:
-            rhs = np.array(pointwise_multiplication(rhs, PK_vec, Q))
+        rhs = np.array(pointwise_multiplication(rhs, PK, Q))
         rhs = np.array(inverse_ntt_naturals(rhs))
         rhs = forward_ntt_naturals(rhs, Q2, R2)
         rhs_SQ = np.array(pointwise_addition(rhs, rhs, Q2))
@@ -258,8 +299,10 @@ def verify(m, PK_C, pk, sig, u):
 def sign(m, secret_x, PK_C, pk):
     sig = ()
     SIG_COMPLETED = False
+    trials = 0
 
     while SIG_COMPLETED == False:
+        trials += 1
         r1 = generate_random_bytes(SEED_SIZE)
         # u = Fiat-Heuristic to recreate the signature basis seed SC
         u = xof(r1 + PK_C + pk.tobytes()).digest(SEED_SIZE)
@@ -267,11 +310,11 @@ def sign(m, secret_x, PK_C, pk):
         SC = xof(u + m + pk.tobytes()).digest(SEED_SIZE)
         seed = int.from_bytes(SC, byteorder="big")
         # Each signature gets a public basis
-        (S_A1) = sampleMatrixISISL2(seed, N)
+        S_A1 = compileBasis(sampleMatrixISISL2(seed, N))
         sig = secret_x  # direct injection - prevent norm explosion
         for S1 in S_A1: # One basis for each structure
-            for S_vec in S1: #S_vec is already in the ntt2 domain
-                sig = np.array(pointwise_multiplication(sig, S_vec, Q))
+            # S1 is the product of the instance's rows, already in the ntt2 domain
+            sig = np.array(pointwise_multiplication(sig, S1, Q))
             sig = np.array(inverse_ntt_naturals(sig)) # back to input domain
             sigsq = np.array(forward_ntt_naturals(sig, Q2, R2)) # to transform domain
             sq = np.array(pointwise_addition(sigsq, sigsq, Q2)) # transform
@@ -279,29 +322,40 @@ def sign(m, secret_x, PK_C, pk):
             sq = np.array(inverse_ntt_naturals(sq,Q2,R2)) #back to input domain
             sq = np.array(forward_ntt_naturals(sq)) # back to ntt2 domain
             sig = sq
+            # With Q == Q2 the transition is x -> 3x, so a zero survives the
+            # remaining instances: reject now instead of after the last one
+            if Q == Q2 and np.any((257 <= sig)):
+                break
         # Validate 'Zero' Product Property
         if np.any((257 <= sig)):
-            if trials == 5:
-                trials = 0
             continue
         else:
             print("Message:", m.hex())
-            print("Sig:", sig, "Sig Entropy", calculate_entropy(sig))
+            print("Sig:", sig, "Sig Entropy", calculate_entropy(sig), "Trials:", trials)
             return (sig, u)
 
-def keyGen():
+def sampleShortKey():
+    if args.native_sk:
+        import dntl_native
+        return np.array(dntl_native.sample_short_key(
+            generate_random_bytes(SEED_SIZE), N, sigma, sorted(allowed_values),
+            max_norm, max_mapped_norm))
     SHORT_KEY = False
     while SHORT_KEY == False:
         secret_x = np.array(
             [
-                gaussian_select_from_set( 
+                gaussian_select_from_set(
                     s=s, sigma=sigma, allowed_values=allowed_values
                 )
                 for s in range(N)
             ]
         )
-        if calculate_norm(secret_x) <= max_norm and calculate_norm([int(x) - 3 for x in secret_x ]) <= max_mapped_norm:
+        if calculate_norm(secret_x) <= max_norm and calculate_norm([int(x) - 3 for x in secret_x ]) <= max_mapped_norm: #proper short
             SHORT_KEY = True
+    return secret_x
+
+def keyGen():
+    secret_x = sampleShortKey()
     pk = ()
     PK_C = ""
     PK_COMPLETE = False
@@ -316,12 +370,12 @@ def keyGen():
         # Step 3: Hash u || r3 using SHAKE to get PK_C seed
         PK_C = xof(u + r3).digest(SEED_SIZE)
         seed = int.from_bytes(PK_C, byteorder="big") # numpy thing
-        (PK_A1) = sampleMatrixISISL2(seed, N)
+        PK_A1 = compileBasis(sampleMatrixISISL2(seed, N))
         pk = secret_x  # direct injection
 
         for PK in PK_A1:
-            for PK_vec in PK: # PK_vec exists in ntt domain
-                pk = np.array(pointwise_multiplication(pk, PK_vec, Q))
+            # PK is the product of the instance's rows, in ntt domain
+            pk = np.array(pointwise_multiplication(pk, PK, Q))
             pk = np.array(inverse_ntt_naturals(pk)) # back to input domain
             pk = np.array(forward_ntt_naturals(pk, Q2,R2)) # to transform domain
             pksq = np.array(pointwise_addition(pk, pk, Q2)) # transform
@@ -329,22 +383,14 @@ def keyGen():
             pksq = np.array(inverse_ntt_naturals(pksq, Q2,R2)) # invert to input domain
             pksq = np.array(forward_ntt_naturals(pksq)) # back to ntt2 domain
             pk = pksq
+            # Early abort, as in sign()
+            if Q == Q2 and np.any((257 <= pk)):
+                break
         # Ensure we maintain the 'zero' product property
         if np.any((257 <= pk)):
             if trials == 5:
-                SHORT_KEY = False
-                while SHORT_KEY == False:
-                    secret_x = np.array(
-                        [
-                            gaussian_select_from_set(
-                                s=s, sigma=sigma, allowed_values=allowed_values
-                            )
-                            for s in range(N)
-                        ]
-                    )
-                    if calculate_norm(secret_x) <= max_norm and calculate_norm([int(x) - 3 for x in secret_x ]) <= max_mapped_norm : #proper short
-                        SHORT_KEY = True
-                        trials = 0
+                secret_x = sampleShortKey()
+                trials = 0
             continue
         else:
             PK_COMPLETE = True
@@ -357,6 +403,24 @@ def keyGen():
 
 # Example usage
 if __name__ == "__main__":
+    if args.native:
+        import dntl_native
+        dntl_native.set_sampler(args.sampler)
+        # The 100 rounds as three batches on the engine's shared scheduler
+        keys = dntl_native.keygen_batch(args.c, 100)
+        msgs = [generate_random_bytes(32) for _ in keys]
+        sigs = dntl_native.sign_batch(args.c, [(m, secret, PK_C, pk)
+                                               for m, (secret, pk, PK_C) in zip(msgs, keys)])
+        results = dntl_native.verify_batch(args.c, [(m, PK_C, pk, SIG, u)
+                                                    for m, (_, pk, PK_C), (SIG, u)
+                                                    in zip(msgs, keys, sigs)])
+        for ok in results:
+            if ok:
+                print("\nPASS\n")
+            else:
+                print("\nFAIL\n")
+                exit(1)
+        exit(0)
     for _ in range(100):
         (secret, pk, PK_C) = keyGen() #sk, pk, public basis seed
         m = generate_random_bytes(32)
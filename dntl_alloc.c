@@ -0,0 +1,200 @@
+#define _GNU_SOURCE
+#include "dntl_alloc.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// mbind(2) policy, from <linux/mempolicy.h>: prefer the node, take others
+// when it is full
+#define DNTL_MPOL_PREFERRED 1
+
+// CPUs the node table covers; higher ones read as node 0
+#define DNTL_ALLOC_MAX_CPUS 4096
+
+// ============================================================================
+// TOPOLOGY
+// ============================================================================
+
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+static int node_count = 1;
+static int node_id[DNTL_ALLOC_MAX_NODES];           // dense index -> kernel node
+static uint8_t cpu_node[DNTL_ALLOC_MAX_CPUS];       // CPU -> dense index
+
+// Call fn(arg, lo, hi) for each range of a sysfs list ("0-3,8,10-11");
+// -1 if the file is missing or malformed
+static int read_list(const char *path, void (*fn)(void *, int, int), void *arg) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    int lo, hi, c, ret = 0;
+    while (fscanf(f, "%d", &lo) == 1) {
+        hi = lo;
+        c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%d", &hi) != 1) {
+                ret = -1;
+                break;
+            }
+            c = fgetc(f);
+        }
+        fn(arg, lo, hi);
+        if (c != ',') {
+            break;
+        }
+    }
+    fclose(f);
+    return ret;
+}
+
+static void add_nodes(void *arg, int lo, int hi) {
+    (void)arg;
+    for (int id = lo; id <= hi && node_count < DNTL_ALLOC_MAX_NODES; id++) {
+        node_id[node_count++] = id;
+    }
+}
+
+static void add_cpus(void *arg, int lo, int hi) {
+    const uint8_t node = (uint8_t)*(const int *)arg;
+    for (int cpu = lo; cpu <= hi && cpu < DNTL_ALLOC_MAX_CPUS; cpu++) {
+        if (cpu >= 0) {
+            cpu_node[cpu] = node;
+        }
+    }
+}
+
+static void topology_init(void) {
+    node_count = 0;
+    if (read_list("/sys/devices/system/node/online", add_nodes, NULL) != 0 ||
+        node_count == 0) {
+        node_count = 1;
+        node_id[0] = 0;
+        return;
+    }
+    char path[64];
+    for (int i = 0; i < node_count; i++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node_id[i]);
+        read_list(path, add_cpus, &i);
+    }
+}
+
+int dntl_numa_nodes(void) {
+    pthread_once(&topology_once, topology_init);
+    return node_count;
+}
+
+int dntl_numa_cpu_node(int cpu) {
+    pthread_once(&topology_once, topology_init);
+    return cpu >= 0 && cpu < DNTL_ALLOC_MAX_CPUS ? cpu_node[cpu] : 0;
+}
+
+int dntl_numa_node(void) {
+    pthread_once(&topology_once, topology_init);
+    if (node_count == 1) {
+        return 0;
+    }
+    return dntl_numa_cpu_node(sched_getcpu());
+}
+
+// ============================================================================
+// PAGES
+// ============================================================================
+
+static size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+static size_t mapped_bytes(size_t bytes, int flags) {
+    return round_up(bytes ? bytes : 1,
+                    (flags & DNTL_ALLOC_HUGE) ? DNTL_HUGE_PAGE_BYTES
+                                              : (size_t)sysconf(_SC_PAGESIZE));
+}
+
+// Prefer node for pages not yet touched; a failure leaves first touch
+static void bind_node(void *ptr, size_t bytes, int node) {
+    if (node < 0 || dntl_numa_nodes() == 1) {
+        return;
+    }
+    const int id = node_id[node % node_count];
+    unsigned long mask[DNTL_ALLOC_MAX_NODES / (8 * sizeof(unsigned long)) + 2] = { 0 };
+    if (id < 0 || (size_t)id >= 8 * sizeof(mask)) {
+        return;
+    }
+    mask[id / (8 * sizeof(unsigned long))] |= 1UL << (id % (8 * sizeof(unsigned long)));
+    syscall(SYS_mbind, ptr, bytes, DNTL_MPOL_PREFERRED, mask, 8 * sizeof(mask) + 1, 0);
+}
+
+void *dntl_alloc_pages(size_t bytes, int node, int flags) {
+    const size_t len = mapped_bytes(bytes, flags);
+    void *p = MAP_FAILED;
+
+    if (flags & DNTL_ALLOC_HUGE) {
+#ifdef MAP_HUGETLB
+        // Fails unless enough huge pages are reserved
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (p == MAP_FAILED) {
+            // No reserved pages: map one huge page more and trim to alignment,
+            // so transparent huge pages can back every 2 MB of the range
+            uint8_t *raw = mmap(NULL, len + DNTL_HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                return NULL;
+            }
+            uint8_t *aligned = (uint8_t *)round_up((uintptr_t)raw, DNTL_HUGE_PAGE_BYTES);
+            if (aligned > raw) {
+                munmap(raw, (size_t)(aligned - raw));
+            }
+            munmap(aligned + len, (size_t)(raw + DNTL_HUGE_PAGE_BYTES - aligned));
+            p = aligned;
+#ifdef MADV_HUGEPAGE
+            madvise(p, len, MADV_HUGEPAGE);
+#endif
+        }
+    } else {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (p == MAP_FAILED) {
+        return NULL;
+    }
+    bind_node(p, len, node);
+    return p;
+}
+
+void dntl_free_pages(void *ptr, size_t bytes, int flags) {
+    if (ptr) {
+        munmap(ptr, mapped_bytes(bytes, flags));
+    }
+}
+
+// ============================================================================
+// ALLOCATORS
+// ============================================================================
+
+static void *pages_alloc(void *user, size_t bytes, int node) {
+    (void)user;
+    return dntl_alloc_pages(bytes, node, 0);
+}
+
+static void pages_free(void *user, void *ptr, size_t bytes) {
+    (void)user;
+    dntl_free_pages(ptr, bytes, 0);
+}
+
+static void *huge_alloc(void *user, size_t bytes, int node) {
+    (void)user;
+    return dntl_alloc_pages(bytes, node, DNTL_ALLOC_HUGE);
+}
+
+static void huge_free(void *user, void *ptr, size_t bytes) {
+    (void)user;
+    dntl_free_pages(ptr, bytes, DNTL_ALLOC_HUGE);
+}
+
+const dntl_allocator_t dntl_allocator_pages = { pages_alloc, pages_free, NULL };
+const dntl_allocator_t dntl_allocator_huge = { huge_alloc, huge_free, NULL };
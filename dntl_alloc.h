@@ -0,0 +1,81 @@
+#ifndef DNTL_ALLOC_H
+#define DNTL_ALLOC_H
+
+#include <stddef.h>
+
+// ============================================================================
+// PAGE ALLOCATION
+// ============================================================================
+//
+// Allocation hook for the large read-mostly tables: expanded parameter sets
+// (rs_expand.h) and public-basis caches (dntl_dsa.h). A table of hundreds of
+// megabytes read at random costs one TLB miss per 4 KB page touched; on 2 MB
+// pages the same table needs 512 times fewer entries. On NUMA machines a
+// table placed on one node is read remotely by every other node's cores.
+//
+//   - dntl_allocator_pages maps anonymous memory and binds it to a node.
+//   - dntl_allocator_huge does the same on 2 MB pages: reserved huge pages
+//     (MAP_HUGETLB, /proc/sys/vm/nr_hugepages) if there are enough, else
+//     2 MB-aligned memory marked MADV_HUGEPAGE for transparent huge pages.
+//   - Callers can supply their own alloc/free pair.
+//
+// Node binding goes through mbind(2) directly (no libnuma); where it fails
+// or there is one node, memory is placed by first touch as usual.
+
+#define DNTL_ALLOC_MAX_NODES 16
+#define DNTL_HUGE_PAGE_BYTES ((size_t)2 << 20)
+
+/**
+ * An allocator for page-granular tables
+ *
+ * alloc returns zeroed memory aligned to at least 64 bytes, or NULL; node is
+ * a NUMA node to place it on, or -1 for no preference. free gets the same
+ * byte count alloc did.
+ */
+typedef struct dntl_allocator {
+    void *(*alloc)(void *user, size_t bytes, int node);
+    void (*free)(void *user, void *ptr, size_t bytes);
+    void *user;
+} dntl_allocator_t;
+
+extern const dntl_allocator_t dntl_allocator_pages;
+extern const dntl_allocator_t dntl_allocator_huge;
+
+// Flags of dntl_alloc_pages()
+#define DNTL_ALLOC_HUGE 1
+
+/**
+ * Map zeroed anonymous memory, page aligned
+ *
+ * @param node      NUMA node, or -1
+ * @param flags     DNTL_ALLOC_HUGE for 2 MB pages (bytes rounded up to them)
+ * @return          Memory, or NULL
+ */
+void *dntl_alloc_pages(size_t bytes, int node, int flags);
+
+/**
+ * Unmap memory from dntl_alloc_pages() with the same bytes and flags
+ */
+void dntl_free_pages(void *ptr, size_t bytes, int flags);
+
+/**
+ * Online NUMA nodes, 1 .. DNTL_ALLOC_MAX_NODES (1 where unknown)
+ *
+ * Nodes are numbered densely here: node i is the i-th online node.
+ */
+int dntl_numa_nodes(void);
+
+/**
+ * The node of the CPU the caller runs on (0 where unknown)
+ *
+ * One sched_getcpu() and a table lookup, cheap enough for each read of a
+ * replicated table.
+ */
+int dntl_numa_node(void);
+
+/**
+ * The node of a CPU (0 where unknown)
+ */
+int dntl_numa_cpu_node(int cpu);
+
+#endif // DNTL_ALLOC_H
@@ -0,0 +1,2515 @@
+#include "dntl_dsa.h"
+#include "dlog257.h"
+#include "dntl_stats.h"
+#include "dntl_transition.h"
+#include "dntl_wire.h"
+#include "huffman_vector.h"
+#include "ntt_plan.h"
+#include "uniform_mod.h"
+#include "keccak.h"
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <time.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+
+// keyGen draws a new secret after this many rejected public keys
+#define DNTL_KEYGEN_TRIALS 5
+
+_Static_assert(DNTL_STAT_INSTANCES == DNTL_MAX_K, "one rejection slot per basis instance");
+
+static const dntl_params_t DNTL_PARAMS[] = {
+    { .level = 1, .k = 2, .n = 64,  .a_vec = 62,  .q = 257, .r = 3, .q2 = 257, .r2 = 5,
+      .seed_bytes = 16, .sk_min = 1, .sk_max = 5, .sk_mu = 3, .sigma = 1.3,
+      .max_norm = 24,  .max_mapped_norm = 8 },
+    { .level = 3, .k = 2, .n = 128, .a_vec = 126, .q = 257, .r = 3, .q2 = 257, .r2 = 5,
+      .seed_bytes = 24, .sk_min = 1, .sk_max = 5, .sk_mu = 3, .sigma = 1.3,
+      .max_norm = 48,  .max_mapped_norm = 11 },
+    { .level = 5, .k = 3, .n = 256, .a_vec = 254, .q = 257, .r = 3, .q2 = 257, .r2 = 5,
+      .seed_bytes = 32, .sk_min = 1, .sk_max = 5, .sk_mu = 3, .sigma = 1.0,
+      .max_norm = 100, .max_mapped_norm = 16 },
+};
+
+/**
+ * Secret-key sampler: gaussian_select_from_set() thresholds and keyGen's
+ * norm bounds
+ */
+typedef struct {
+    size_t n;
+    size_t count;                           // allowed values
+    uint32_t values[DNTL_MAX_ALLOWED];      // increasing
+    uint64_t cdf[DNTL_MAX_ALLOWED - 1];     // 2^64 * P(g <= (values[j] + values[j + 1]) / 2)
+    uint32_t mu;
+    uint64_t bound, mapped_bound;           // (max_norm + 1)^2, (max_mapped_norm + 1)^2
+} short_key_t;
+
+// Kernels compiled for one level (PER-LEVEL INSTANCES)
+typedef struct dntl_level dntl_level_t;
+
+struct dntl_ctx {
+    const dntl_params_t *params;
+    const dntl_level_t *code;
+    ntt_plan_t *plan;                   // (N, Q, R) cyclic
+    dntl_transition_t *transition;
+    dntl_sampler_t sampler;
+    uint32_t mask;                      // smallest 2^b - 1 >= q - 1
+    umod_t xof_mod;                     // 16-bit XOF words -> [0, q), unbiased
+    uint16_t bitrev[DNTL_MAX_N];
+    short_key_t sk;                     // sk_min .. sk_max around sk_mu
+};
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// [0, q] -> [0, q)
+static inline uint32_t naturals_to_canonical(uint32_t x, uint32_t q) {
+    return x - (q & -(uint32_t)(x >= q));
+}
+
+// 1 if any of the n values is zero, without branching on the data
+static int has_zero(const uint32_t *v, size_t n) {
+    uint32_t zero = 0;
+    for (size_t i = 0; i < n; i++) {
+        zero |= (uint32_t)(v[i] == 0);
+    }
+    return (int)zero;
+}
+
+// 1 if any of the n values equals q (zero in the naturals convention)
+static int has_modulus(const uint32_t *v, size_t n, uint32_t q) {
+    uint32_t zero = 0;
+    for (size_t i = 0; i < n; i++) {
+        zero |= (uint32_t)(v[i] == q);
+    }
+    return (int)zero;
+}
+
+static int random_bytes(uint8_t *out, size_t len) {
+    while (len > 0) {
+        ssize_t got = getrandom(out, len, 0);
+        if (got <= 0) {
+            return -1;
+        }
+        out += got;
+        len -= (size_t)got;
+    }
+    return 0;
+}
+
+// ============================================================================
+// SHAKE-256
+// ============================================================================
+
+typedef struct {
+    const void *data;
+    size_t len;
+} dntl_chunk_t;
+
+// out = SHAKE256(chunks[0] || ... || chunks[count-1]), out_len bytes
+static int shake256(uint8_t *out, size_t out_len, const dntl_chunk_t *chunks, size_t count) {
+    EVP_MD_CTX *md = EVP_MD_CTX_new();
+    if (!md) {
+        return -1;
+    }
+    int ok = EVP_DigestInit_ex(md, EVP_shake256(), NULL) == 1;
+    for (size_t i = 0; ok && i < count; i++) {
+        ok = EVP_DigestUpdate(md, chunks[i].data, chunks[i].len) == 1;
+    }
+    ok = ok && EVP_DigestFinalXOF(md, out, out_len) == 1;
+    EVP_MD_CTX_free(md);
+    return ok ? 0 : -1;
+}
+
+// pk.tobytes() of the Python int64 array
+static void pk_to_bytes(uint8_t *out, const uint32_t *pk, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t v = pk[i];
+        for (int b = 0; b < 8; b++) {
+            out[8 * i + b] = (uint8_t)(v >> (8 * b));
+        }
+    }
+}
+
+// ============================================================================
+// MT19937 (numpy legacy RandomState)
+// ============================================================================
+
+#define MT_N 624
+#define MT_M 397
+
+typedef struct {
+    uint32_t key[MT_N];
+    uint32_t out[MT_N];     // tempered outputs of the current block
+    int pos;
+} mt19937_t;
+
+// np.random.seed(seed): init_genrand
+static void mt19937_seed(mt19937_t *mt, uint32_t seed) {
+    mt->key[0] = seed;
+    for (int i = 1; i < MT_N; i++) {
+        uint32_t prev = mt->key[i - 1];
+        mt->key[i] = 1812433253u * (prev ^ (prev >> 30)) + (uint32_t)i;
+    }
+    mt->pos = MT_N;
+}
+
+#define MT_TWIST(u, v) ((((u) & 0x80000000u) | ((v) & 0x7fffffffu)) >> 1 ^ \
+                        (0x9908b0dfu & -((v) & 1u)))
+
+// Next block of 624 outputs, tempered in one pass
+static void mt19937_generate(mt19937_t *mt) {
+    uint32_t *k = mt->key;
+    int i = 0;
+    for (; i < MT_N - MT_M; i++) {
+        k[i] = k[i + MT_M] ^ MT_TWIST(k[i], k[i + 1]);
+    }
+    for (; i < MT_N - 1; i++) {
+        k[i] = k[i + MT_M - MT_N] ^ MT_TWIST(k[i], k[i + 1]);
+    }
+    k[MT_N - 1] = k[MT_M - 1] ^ MT_TWIST(k[MT_N - 1], k[0]);
+
+    for (i = 0; i < MT_N; i++) {
+        uint32_t y = k[i];
+        y ^= y >> 11;
+        y ^= (y << 7) & 0x9d2c5680u;
+        y ^= (y << 15) & 0xefc60000u;
+        y ^= y >> 18;
+        mt->out[i] = y;
+    }
+    mt->pos = 0;
+}
+
+// ============================================================================
+// PUBLIC BASIS
+// ============================================================================
+//
+// The kernels of this section take the constants of the level (N, K, A_VEC,
+// Q, Q2) as arguments and are always inlined: PER-LEVEL INSTANCES below
+// compiles each of them once per level with literals, and the callers reach
+// them through the level of the context.
+
+/**
+ * One row of sampleMatrixISISL2(), in bit-reversed NTT order (canonical)
+ *
+ * filter_basis(np.random.choice(1..q, n)): randint(0, q) draws masked 32-bit
+ * outputs until one is <= q - 1, and the value q is replaced by 1. The row is
+ * drawn again while its transform has a zero (counted for instance inst).
+ * The rejection loops only depend on the public seed.
+ */
+static inline __attribute__((always_inline))
+void sample_row_kernel(const dntl_ctx_t *ctx, mt19937_t *mt, size_t inst, uint32_t *row,
+                       size_t n, uint32_t q) {
+    for (;;) {
+        // About half of the draws are rejected for q = 257, so accepted
+        // values are compacted without a branch on each draw
+        size_t filled = 0;
+        while (filled < n) {
+            if (mt->pos == MT_N) {
+                mt19937_generate(mt);
+            }
+            while (filled < n && mt->pos < MT_N) {
+                uint32_t idx = mt->out[mt->pos++] & ctx->mask;
+                row[filled] = idx;
+                filled += (idx <= q - 1);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            row[i] = (row[i] == q - 1) ? 1 : row[i] + 1;
+        }
+        ntt_plan_forward_bitrev(ctx->plan, row);
+        if (!has_zero(row, n)) {
+            break;
+        }
+        DNTL_STAT_REJECT(DNTL_REJECT_BASIS_ROW, inst, 1);
+    }
+}
+
+// Candidate rows transformed per SHAKE-256 batch
+#define XOF_BATCH_ROWS 8
+
+// Stream blocks squeezed together (one 4-way Keccak per SHAKE-256 block),
+// and the 16-bit words they hold
+#define XOF_LANES 4
+#define XOF_WORDS (XOF_LANES * DNTL_XOF_BLOCK_BYTES / 2)
+
+/**
+ * Row source of one basis expansion
+ *
+ * DNTL_SAMPLER_MT19937 uses mt. DNTL_SAMPLER_SHAKE256 keeps the seed's
+ * absorbed prefix in base (copied per block), the XOF_LANES blocks being
+ * read, and the zero-free candidates of the last batch that are not yet
+ * used; rows left over at the end of an instance go to the next one.
+ */
+typedef struct {
+    mt19937_t mt;
+    keccak_state_t base;
+    uint32_t block;
+    uint32_t words[XOF_WORDS];
+    size_t word_pos;
+    uint32_t rows[XOF_BATCH_ROWS][DNTL_MAX_N] __attribute__((aligned(64)));
+    size_t row_pos, row_count;
+} basis_stream_t;
+
+static const char XOF_BASIS_TAG[] = "DNTL-DSA basis";
+
+static int basis_stream_init(const dntl_ctx_t *ctx, basis_stream_t *st, const uint8_t *seed) {
+    const dntl_params_t *p = ctx->params;
+
+    if (ctx->sampler == DNTL_SAMPLER_MT19937) {
+        // MT19937 seeded with seed % 2**32 of the big-endian integer
+        const uint8_t *low = seed + p->seed_bytes - 4;
+        mt19937_seed(&st->mt, ((uint32_t)low[0] << 24) | ((uint32_t)low[1] << 16) |
+                              ((uint32_t)low[2] << 8) | (uint32_t)low[3]);
+        return 0;
+    }
+
+    st->block = 0;
+    st->word_pos = XOF_WORDS;
+    st->row_pos = st->row_count = 0;
+    keccak_shake256_init(&st->base);
+    keccak_absorb(&st->base, XOF_BASIS_TAG, sizeof(XOF_BASIS_TAG) - 1);
+    keccak_absorb(&st->base, seed, p->seed_bytes);
+    return 0;
+}
+
+// Squeeze the next XOF_LANES blocks into words, in stream order
+static int xof_next_block(basis_stream_t *st) {
+    uint8_t bytes[XOF_LANES][DNTL_XOF_BLOCK_BYTES];
+    uint8_t ctr[XOF_LANES][4];
+    keccak_state_t md[XOF_LANES];
+
+    for (int k = 0; k < XOF_LANES; k++) {
+        const uint32_t b = st->block + (uint32_t)k;
+        ctr[k][0] = (uint8_t)b;
+        ctr[k][1] = (uint8_t)(b >> 8);
+        ctr[k][2] = (uint8_t)(b >> 16);
+        ctr[k][3] = (uint8_t)(b >> 24);
+        md[k] = st->base;
+    }
+    const void *const in[XOF_LANES] = { ctr[0], ctr[1], ctr[2], ctr[3] };
+    void *const out[XOF_LANES] = { bytes[0], bytes[1], bytes[2], bytes[3] };
+    keccak_absorb_x4(md, in, sizeof(ctr[0]));
+    keccak_finalize_x4(md);
+    keccak_squeeze_x4(md, out, DNTL_XOF_BLOCK_BYTES);
+
+    const uint8_t *w = bytes[0];
+    for (size_t i = 0; i < XOF_WORDS; i++) {
+        st->words[i] = (uint32_t)w[2 * i] | ((uint32_t)w[2 * i + 1] << 8);
+    }
+    st->block += XOF_LANES;
+    st->word_pos = 0;
+    return 0;
+}
+
+// Transform a batch of candidates and keep the zero-free ones, in order
+static inline __attribute__((always_inline))
+int xof_next_batch_kernel(const dntl_ctx_t *ctx, basis_stream_t *st, size_t n, uint32_t q) {
+    st->row_pos = st->row_count = 0;
+    for (size_t r = 0; r < XOF_BATCH_ROWS; r++) {
+        uint32_t *row = st->rows[st->row_count];
+        size_t filled = 0;
+        while (filled < n) {
+            if (st->word_pos == XOF_WORDS && xof_next_block(st) != 0) {
+                return -1;
+            }
+            // Reduce and compact with the shared rejection kernel
+            size_t used;
+            filled += umod_sample(&ctx->xof_mod,
+                                  st->words + st->word_pos, XOF_WORDS - st->word_pos,
+                                  row + filled, n - filled, &used);
+            st->word_pos += used;
+        }
+        for (size_t i = 0; i < n; i++) {
+            row[i] = (row[i] == q - 1) ? 1 : row[i] + 1;
+        }
+        ntt_plan_forward_bitrev(ctx->plan, row);
+        st->row_count += !has_zero(row, n);
+    }
+    return 0;
+}
+
+/**
+ * Next row of the basis, in bit-reversed NTT order (canonical)
+ *
+ * Rejected candidates count for instance inst, including those of a batch
+ * whose rows partly go to the next instance.
+ *
+ * @param scratch   n values of storage the row may be written to
+ * @return          The row, or NULL if SHAKE-256 fails
+ */
+static inline __attribute__((always_inline))
+const uint32_t *next_row_kernel(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst,
+                                uint32_t *scratch, size_t n, uint32_t q) {
+    if (ctx->sampler == DNTL_SAMPLER_MT19937) {
+        sample_row_kernel(ctx, &st->mt, inst, scratch, n, q);
+        return scratch;
+    }
+    while (st->row_pos == st->row_count) {
+        if (xof_next_batch_kernel(ctx, st, n, q) != 0) {
+            return NULL;
+        }
+        DNTL_STAT_REJECT(DNTL_REJECT_BASIS_ROW, inst, XOF_BATCH_ROWS - st->row_count);
+    }
+    return st->rows[st->row_pos++];
+}
+
+// acc = first * the next rows - 1 rows of instance inst, pointwise
+static inline __attribute__((always_inline))
+int fold_products_kernel(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst, size_t rows,
+                         const uint32_t *first, uint32_t *acc, uint32_t *row,
+                         size_t n, uint32_t q) {
+    const uint32_t *r;
+
+    if (first != acc) {
+        memcpy(acc, first, n * sizeof(uint32_t));
+    }
+    for (size_t j = 1; j < rows; j++) {
+        if (!(r = next_row_kernel(ctx, st, inst, row, n, q))) {
+            return -1;
+        }
+        ntt_plan_pointwise_mul(ctx->plan, acc, acc, r);
+    }
+    return 0;
+}
+
+#ifdef DLOG257_FAST
+// fold_products_kernel() for Q = 257 as byte additions of discrete logs
+static inline __attribute__((always_inline))
+int fold_logs_kernel(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst, size_t rows,
+                     const uint32_t *first, uint32_t *acc, uint32_t *row,
+                     size_t n, uint32_t q) {
+    const uint32_t *r;
+    dlog257_vec_t logs;
+
+    dlog257_load(&logs, first, n);
+    for (size_t j = 1; j < rows; j++) {
+        if (!(r = next_row_kernel(ctx, st, inst, row, n, q))) {
+            return -1;
+        }
+        dlog257_mul_values(&logs, r);
+    }
+    dlog257_store(&logs, acc);
+    return 0;
+}
+#endif
+
+/**
+ * Sample the rows of instance inst and fold them into one product vector
+ *
+ * The rows are only ever multiplied together, so they are accumulated in the
+ * bit-reversed domain and permuted once.
+ *
+ * @param product   Output, n canonical values in natural NTT order
+ * @param acc, row  n values of scratch each
+ * @return          0, or -1 if SHAKE-256 fails
+ */
+static inline __attribute__((always_inline))
+int fold_instance_kernel(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst,
+                         uint32_t *product, uint32_t *acc, uint32_t *row,
+                         size_t n, size_t a_vec, uint32_t q) {
+    // Rows are drawn in pairs: n // 2 pairs for the core, A_VEC // 2 after
+    const size_t rows = 2 * ((inst == 0 ? n : a_vec) / 2);
+    const uint32_t *r = next_row_kernel(ctx, st, inst, acc, n, q);
+    int ret = -1;
+
+    if (r) {
+#ifdef DLOG257_FAST
+        ret = q == 257 ? fold_logs_kernel(ctx, st, inst, rows, r, acc, row, n, q)
+                       : fold_products_kernel(ctx, st, inst, rows, r, acc, row, n, q);
+#else
+        ret = fold_products_kernel(ctx, st, inst, rows, r, acc, row, n, q);
+#endif
+    }
+    if (ret != 0) {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        product[i] = acc[ctx->bitrev[i]];
+    }
+    return 0;
+}
+
+/**
+ * One instance: multiply by its folded basis, then the transition
+ *
+ * @param poly      n canonical values, replaced by canonical values, or by
+ *                  naturals [1, q] for the last instance
+ */
+static inline __attribute__((always_inline))
+void apply_instance_kernel(const dntl_ctx_t *ctx, const uint32_t *product, uint32_t *poly,
+                           int last, size_t n, uint32_t q) {
+    ntt_plan_pointwise_mul(ctx->plan, poly, poly, product);
+    dntl_transition_apply(ctx->transition, poly);
+    if (!last) {
+        for (size_t i = 0; i < n; i++) {
+            poly[i] = naturals_to_canonical(poly[i], q);
+        }
+    }
+}
+
+/**
+ * Push poly through the K instances of the basis derived from seed
+ *
+ * With early_abort, a zero coefficient that can no longer disappear ends the
+ * chain before the next instance's basis is sampled. Rows have no zeros, so
+ * the pointwise chain keeps zeros; with Q == Q2 the transition is x -> 3x and
+ * keeps them too, so the final 'zero' product check would fail anyway.
+ * Otherwise the transition mixes coefficients and only the final check counts.
+ *
+ * @param poly      n canonical values in natural NTT order, replaced by the
+ *                  result in naturals [1, q]
+ * @param applied   If not NULL, set to the number of instances applied
+ * @param product, acc, row  n values of scratch each
+ * @return          0, 1 if aborted (poly is then partially processed), or -1
+ *                  if SHAKE-256 fails
+ */
+static inline __attribute__((always_inline))
+int apply_basis_kernel(const dntl_ctx_t *ctx, const uint8_t *seed, uint32_t *poly,
+                       int early_abort, size_t *applied,
+                       uint32_t *product, uint32_t *acc, uint32_t *row,
+                       size_t n, size_t k, size_t a_vec, uint32_t q, uint32_t q2) {
+    DNTL_STAT_SCOPE(DNTL_STAT_BASIS);
+    const int zeros_persist = early_abort && q == q2;
+    basis_stream_t st;
+    size_t inst = 0;
+    int ret = 0;
+
+    if (basis_stream_init(ctx, &st, seed) != 0) {
+        return -1;
+    }
+    for (; inst < k && ret == 0; inst++) {
+        if (zeros_persist && has_zero(poly, n)) {
+            ret = 1;
+        } else if (fold_instance_kernel(ctx, &st, inst, product, acc, row, n, a_vec, q) != 0) {
+            ret = -1;
+        } else {
+            apply_instance_kernel(ctx, product, poly, inst + 1 == k, n, q);
+        }
+    }
+    if (applied) {
+        *applied = inst - (ret != 0);
+    }
+    return ret;
+}
+
+// Returns 0 if all n values are in [0, q], and maps them to [0, q)
+static inline __attribute__((always_inline))
+int load_poly_kernel(uint32_t *out, const uint32_t *in, size_t n, uint32_t q) {
+    uint32_t bad = 0;
+    for (size_t i = 0; i < n; i++) {
+        bad |= (uint32_t)(in[i] > q);
+        out[i] = naturals_to_canonical(in[i], q);
+    }
+    return bad ? -1 : 0;
+}
+
+// ============================================================================
+// PER-LEVEL INSTANCES
+// ============================================================================
+//
+// Levels 1, 3 and 5 only differ in constants, so every kernel above is
+// compiled three times, as dntl1_*, dntl3_* and dntl5_*, with N, K, A_VEC, Q
+// and Q2 as literals: the coefficient loops get fixed trip counts (unrolled
+// and vectorized without tails), the per-instance loops of K are unrolled,
+// the Q == Q2 and Q == 257 choices are made at compile time, and the scratch
+// vectors are N values on the stack. The transforms are those of the plan
+// the context builds for the level's (N, Q, R).
+//
+// dntl_ctx_create_sampler() picks the instance whose constants match the
+// parameter set, and the wrappers at the end of the section call through it.
+
+struct dntl_level {
+    int level;
+    size_t n, k, a_vec, seed_bytes;
+    uint32_t q, q2;
+    int (*fold_instance)(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst,
+                         uint32_t *product);
+    int (*apply_basis)(const dntl_ctx_t *ctx, const uint8_t *seed, uint32_t *poly,
+                       int early_abort, size_t *applied);
+    void (*apply_products)(const dntl_ctx_t *ctx, const dntl_basis_t *basis, uint32_t *poly);
+    int (*load_poly)(uint32_t *out, const uint32_t *in);
+};
+
+#define DNTL_DEFINE_LEVEL(l, N, K, A_VEC, SEED, Q, Q2)                                  \
+    static int dntl##l##_fold_instance(const dntl_ctx_t *ctx, basis_stream_t *st,        \
+                                       size_t inst, uint32_t *product) {                 \
+        uint32_t acc[N] __attribute__((aligned(64)));                                    \
+        uint32_t row[N] __attribute__((aligned(64)));                                    \
+        return fold_instance_kernel(ctx, st, inst, product, acc, row, N, A_VEC, Q);      \
+    }                                                                                    \
+    static int dntl##l##_apply_basis(const dntl_ctx_t *ctx, const uint8_t *seed,         \
+                                     uint32_t *poly, int early_abort, size_t *applied) { \
+        uint32_t product[N] __attribute__((aligned(64)));                                \
+        uint32_t acc[N] __attribute__((aligned(64)));                                    \
+        uint32_t row[N] __attribute__((aligned(64)));                                    \
+        return apply_basis_kernel(ctx, seed, poly, early_abort, applied,                 \
+                                  product, acc, row, N, K, A_VEC, Q, Q2);                \
+    }                                                                                    \
+    static void dntl##l##_apply_products(const dntl_ctx_t *ctx, const dntl_basis_t *basis, \
+                                         uint32_t *poly) {                               \
+        _Pragma("GCC unroll 4")                                                          \
+        for (size_t inst = 0; inst < K; inst++) {                                        \
+            apply_instance_kernel(ctx, basis->products[inst], poly, inst + 1 == K, N, Q);  \
+        }                                                                                \
+    }                                                                                    \
+    static int dntl##l##_load_poly(uint32_t *out, const uint32_t *in) {                  \
+        return load_poly_kernel(out, in, N, Q);                                          \
+    }                                                                                    \
+    static const dntl_level_t DNTL##l##_LEVEL = {                                        \
+        .level = l, .n = N, .k = K, .a_vec = A_VEC, .seed_bytes = SEED, .q = Q, .q2 = Q2, \
+        .fold_instance = dntl##l##_fold_instance,                                        \
+        .apply_basis = dntl##l##_apply_basis,                                            \
+        .apply_products = dntl##l##_apply_products,                                      \
+        .load_poly = dntl##l##_load_poly,                                                \
+    };
+
+//                l  N    K  A_VEC SEED Q    Q2
+DNTL_DEFINE_LEVEL(1, 64,  2, 62,   16,  257, 257)
+DNTL_DEFINE_LEVEL(3, 128, 2, 126,  24,  257, 257)
+DNTL_DEFINE_LEVEL(5, 256, 3, 254,  32,  257, 257)
+
+#undef DNTL_DEFINE_LEVEL
+
+static const dntl_level_t *const DNTL_LEVELS[] = { &DNTL1_LEVEL, &DNTL3_LEVEL, &DNTL5_LEVEL };
+
+// The instance compiled for p, or NULL if none has its constants
+static const dntl_level_t *level_code(const dntl_params_t *p) {
+    for (size_t i = 0; i < sizeof(DNTL_LEVELS) / sizeof(DNTL_LEVELS[0]); i++) {
+        const dntl_level_t *c = DNTL_LEVELS[i];
+        if (c->level == p->level && c->n == p->n && c->k == p->k && c->a_vec == p->a_vec &&
+            c->seed_bytes == p->seed_bytes && c->q == p->q && c->q2 == p->q2) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+static int fold_instance(const dntl_ctx_t *ctx, basis_stream_t *st, size_t inst,
+                         uint32_t *product) {
+    return ctx->code->fold_instance(ctx, st, inst, product);
+}
+
+static int apply_basis(const dntl_ctx_t *ctx, const uint8_t *seed, uint32_t *poly,
+                       int early_abort, size_t *applied) {
+    return ctx->code->apply_basis(ctx, seed, poly, early_abort, applied);
+}
+
+// dntl_basis_apply() on canonical input
+static void basis_apply_canonical(const dntl_ctx_t *ctx, const dntl_basis_t *basis, uint32_t *poly) {
+    ctx->code->apply_products(ctx, basis, poly);
+}
+
+// Returns 0 if all N values are in [0, q], and maps them to [0, q)
+static int load_poly(const dntl_ctx_t *ctx, uint32_t *out, const uint32_t *in) {
+    return ctx->code->load_poly(out, in);
+}
+
+// ============================================================================
+// SECRET SAMPLING
+// ============================================================================
+
+// (bound + 1)^2: int(||x||) <= bound  <=>  ||x||^2 < (bound + 1)^2
+static uint64_t norm_bound(uint32_t bound) {
+    const uint64_t b = (uint64_t)bound + 1;
+    return bound == UINT32_MAX ? UINT64_MAX : b * b;
+}
+
+/**
+ * gaussian_select_from_set(): N(mu, sigma) rounded to the nearest allowed
+ * value, ties going to the smaller one. Instead of drawing the Gaussian and
+ * rounding, one uniform 64-bit word per coefficient is compared against the
+ * CDF at the rounding boundaries, which gives the same distribution without
+ * branches or floating point.
+ *
+ * @return          0, or -1 if n, the allowed values or sigma are invalid
+ */
+static int short_key_init(short_key_t *sk, size_t n, uint32_t mu, double sigma,
+                          const uint32_t *allowed, size_t count,
+                          uint32_t max_norm, uint32_t max_mapped_norm) {
+    if (n == 0 || n > DNTL_MAX_N || count == 0 || count > DNTL_MAX_ALLOWED ||
+        !(sigma > 0.0) || !isfinite(sigma)) {
+        return -1;
+    }
+    for (size_t j = 0; j < count; j++) {
+        if (allowed[j] > DNTL_MAX_ALLOWED_VALUE || (j > 0 && allowed[j] <= allowed[j - 1])) {
+            return -1;
+        }
+        sk->values[j] = allowed[j];
+    }
+    for (size_t j = 0; j + 1 < count; j++) {
+        double z = (0.5 * ((double)allowed[j] + allowed[j + 1]) - mu) / sigma;
+        double cdf = 0.5 * erfc(-z / sqrt(2.0));
+        sk->cdf[j] = cdf >= 1.0 ? UINT64_MAX : (uint64_t)ldexp(cdf, 64);
+    }
+    sk->n = n;
+    sk->count = count;
+    sk->mu = mu;
+    sk->bound = norm_bound(max_norm);
+    sk->mapped_bound = norm_bound(max_mapped_norm);
+    return 0;
+}
+
+/**
+ * Coefficients from..to of a candidate key, one uniform word each, with both
+ * squared norms (of x and of x - mu) summed in norms as they are drawn. The
+ * sums only grow, so the candidate is dropped as soon as one reaches its
+ * bound: rejected keys stop early, an accepted key always runs to the end.
+ *
+ * @return          1 while the candidate is short, 0 once rejected (out is
+ *                  then partially written)
+ */
+static int short_key_extend(const short_key_t *sk, const uint64_t *words, size_t from,
+                            size_t to, uint32_t *out, uint64_t norms[2]) {
+    for (size_t i = from; i < to; i++) {
+        uint32_t v = sk->values[0];
+        for (size_t j = 0; j + 1 < sk->count; j++) {
+            v += (sk->values[j + 1] - sk->values[j]) & -(uint32_t)(words[i - from] >= sk->cdf[j]);
+        }
+        out[i] = v;
+
+        int64_t mapped = (int64_t)v - sk->mu;
+        norms[0] += (uint64_t)v * v;
+        norms[1] += (uint64_t)(mapped * mapped);
+        if (norms[0] >= sk->bound || norms[1] >= sk->mapped_bound) {
+            DNTL_STAT_COUNT(norms[0] >= sk->bound ? DNTL_COUNT_SHORT_KEY_NORM
+                                                  : DNTL_COUNT_SHORT_KEY_MAPPED_NORM, 1);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// keyGen's randomness: len bytes into out, 0 or -1 (random_bytes() with state
+// NULL, or a SHAKE-256 stream for dntl_keygen_batch())
+typedef int (*keygen_rng_t)(void *state, uint8_t *out, size_t len);
+
+static int system_rng(void *state, uint8_t *out, size_t len) {
+    (void)state;
+    return random_bytes(out, len);
+}
+
+// Counts of one keyGen; fields as in dntl_keygen_stats_t
+typedef struct {
+    uint64_t attempts, pk_rejects, secret_rejects, secret_redraws;
+} keygen_counts_t;
+
+// keyGen's secret: candidates of little-endian words until one is short
+static int sample_secret(const dntl_ctx_t *ctx, keygen_rng_t rng, void *state, uint32_t *sk,
+                         keygen_counts_t *counts) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SHORT_KEY);
+    uint8_t bytes[DNTL_MAX_N * sizeof(uint64_t)];
+    uint64_t words[DNTL_MAX_N];
+    int ret = -1;
+
+    for (uint64_t trials = 1; ; trials++) {
+        if (rng(state, bytes, ctx->sk.n * sizeof(uint64_t)) != 0) {
+            break;
+        }
+        for (size_t w = 0; w < ctx->sk.n; w++) {
+            uint64_t x = 0;
+            for (int b = 7; b >= 0; b--) {
+                x = (x << 8) | bytes[8 * w + (size_t)b];
+            }
+            words[w] = x;
+        }
+        uint64_t norms[2] = { 0, 0 };
+        if (short_key_extend(&ctx->sk, words, 0, ctx->sk.n, sk, norms)) {
+            DNTL_STAT_HIST(DNTL_HIST_SHORT_KEY_TRIALS, trials);
+            ret = 0;
+            break;
+        }
+        DNTL_STAT_COUNT(DNTL_COUNT_SHORT_KEY_REJECTS, 1);
+        counts->secret_rejects++;
+    }
+    memset(bytes, 0, sizeof(bytes));
+    memset(words, 0, sizeof(words));
+    return ret;
+}
+
+int dntl_sample_short_key(const uint8_t *seed, size_t seed_len, size_t n, uint32_t mu,
+                          double sigma, const uint32_t *allowed, size_t count,
+                          uint32_t max_norm, uint32_t max_mapped_norm, uint32_t *out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SHORT_KEY);
+    static const char domain[] = "DNTL-DSA short key";
+    const size_t block = KECCAK_SHAKE256_RATE / 8;
+    short_key_t sk;
+    keccak_state_t prefix, st;
+    uint8_t bytes[KECCAK_SHAKE256_RATE];
+    uint64_t words[KECCAK_SHAKE256_RATE / 8];
+    int ret = -1;
+
+    if ((!seed && seed_len) || !allowed || !out ||
+        short_key_init(&sk, n, mu, sigma, allowed, count, max_norm, max_mapped_norm) != 0) {
+        return -1;
+    }
+    keccak_shake256_init(&prefix);
+    keccak_absorb(&prefix, domain, sizeof(domain) - 1);
+    keccak_absorb(&prefix, seed, seed_len);
+
+    // Candidates squeeze a block of words at a time and stop with the key
+    for (uint32_t t = 0; t < DNTL_SHORT_KEY_TRIES && ret != 0; t++) {
+        const uint8_t index[4] = { (uint8_t)t, (uint8_t)(t >> 8), (uint8_t)(t >> 16),
+                                   (uint8_t)(t >> 24) };
+        uint64_t norms[2] = { 0, 0 };
+        int short_key = 1;
+        st = prefix;
+        keccak_absorb(&st, index, sizeof(index));
+        keccak_finalize(&st);
+        for (size_t i = 0; i < n && short_key; i += block) {
+            const size_t end = i + block < n ? i + block : n;
+            keccak_squeeze(&st, bytes, 8 * (end - i));
+            for (size_t w = 0; w < end - i; w++) {
+                uint64_t x = 0;
+                for (int b = 7; b >= 0; b--) {
+                    x = (x << 8) | bytes[8 * w + (size_t)b];
+                }
+                words[w] = x;
+            }
+            short_key = short_key_extend(&sk, words, i, end, out, norms);
+        }
+        if (short_key) {
+            DNTL_STAT_HIST(DNTL_HIST_SHORT_KEY_TRIALS, t + 1);
+            ret = 0;
+        } else {
+            DNTL_STAT_COUNT(DNTL_COUNT_SHORT_KEY_REJECTS, 1);
+        }
+    }
+    memset(&st, 0, sizeof(st));
+    memset(bytes, 0, sizeof(bytes));
+    memset(words, 0, sizeof(words));
+    return ret;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+const dntl_params_t *dntl_params(int level) {
+    for (size_t i = 0; i < sizeof(DNTL_PARAMS) / sizeof(DNTL_PARAMS[0]); i++) {
+        if (DNTL_PARAMS[i].level == level) {
+            return &DNTL_PARAMS[i];
+        }
+    }
+    return NULL;
+}
+
+dntl_ctx_t *dntl_ctx_create(int level) {
+    return dntl_ctx_create_sampler(level, DNTL_SAMPLER_MT19937);
+}
+
+dntl_ctx_t *dntl_ctx_create_sampler(int level, dntl_sampler_t sampler) {
+    const dntl_params_t *p = dntl_params(level);
+    if (!p || (sampler != DNTL_SAMPLER_MT19937 && sampler != DNTL_SAMPLER_SHAKE256) ||
+        p->q > 65536) {
+        return NULL;
+    }
+    const dntl_level_t *code = level_code(p);
+    if (!code) {
+        return NULL;
+    }
+    dntl_ctx_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+    ctx->params = p;
+    ctx->code = code;
+    ctx->sampler = sampler;
+    if (umod_init(&ctx->xof_mod, p->q, 16) != 0) {
+        free(ctx);
+        return NULL;
+    }
+    ctx->plan = ntt_plan_create(p->n, p->q, p->r, NTT_PLAN_CYCLIC);
+    ctx->transition = dntl_transition_create(p->n, p->q, p->r, p->q2, p->r2);
+    if (!ctx->plan || !ctx->transition) {
+        dntl_ctx_destroy(ctx);
+        return NULL;
+    }
+
+    ctx->mask = p->q - 1;
+    for (int s = 1; s < 32; s <<= 1) {
+        ctx->mask |= ctx->mask >> s;
+    }
+
+    uint32_t allowed[DNTL_MAX_ALLOWED];
+    const size_t count = p->sk_max - p->sk_min + 1;
+    for (size_t j = 0; j < count && j < DNTL_MAX_ALLOWED; j++) {
+        allowed[j] = p->sk_min + (uint32_t)j;
+    }
+    if (short_key_init(&ctx->sk, p->n, p->sk_mu, p->sigma, allowed, count, p->max_norm,
+                       p->max_mapped_norm) != 0) {
+        dntl_ctx_destroy(ctx);
+        return NULL;
+    }
+
+    int log_n = 0;
+    while (((size_t)1 << log_n) < p->n) {
+        log_n++;
+    }
+    for (size_t i = 0; i < p->n; i++) {
+        size_t rev = 0;
+        for (int b = 0; b < log_n; b++) {
+            rev |= ((i >> b) & 1) << (log_n - 1 - b);
+        }
+        ctx->bitrev[i] = (uint16_t)rev;
+    }
+    return ctx;
+}
+
+void dntl_ctx_destroy(dntl_ctx_t *ctx) {
+    if (!ctx) {
+        return;
+    }
+    ntt_plan_destroy(ctx->plan);
+    dntl_transition_destroy(ctx->transition);
+    free(ctx);
+}
+
+const dntl_params_t *dntl_ctx_params(const dntl_ctx_t *ctx) {
+    return ctx->params;
+}
+
+dntl_sampler_t dntl_ctx_sampler(const dntl_ctx_t *ctx) {
+    return ctx->sampler;
+}
+
+int dntl_basis_compile(const dntl_ctx_t *ctx, const uint8_t *seed, dntl_basis_t *basis) {
+    DNTL_STAT_SCOPE(DNTL_STAT_BASIS);
+    basis_stream_t st;
+    int ret = 0;
+
+    basis->level = ctx->params->level;
+    basis->sampler = ctx->sampler;
+    if (basis_stream_init(ctx, &st, seed) != 0) {
+        return -1;
+    }
+    for (size_t inst = 0; inst < ctx->params->k && ret == 0; inst++) {
+        ret = fold_instance(ctx, &st, inst, basis->products[inst]);
+    }
+    return ret;
+}
+
+int dntl_basis_apply(const dntl_ctx_t *ctx, const dntl_basis_t *basis, uint32_t *poly) {
+    const dntl_params_t *p = ctx->params;
+    uint32_t tmp[DNTL_MAX_N] __attribute__((aligned(64)));
+
+    if (basis->level != p->level || basis->sampler != ctx->sampler ||
+        load_poly(ctx, tmp, poly) != 0) {
+        return -1;
+    }
+    basis_apply_canonical(ctx, basis, tmp);
+    memcpy(poly, tmp, p->n * sizeof(uint32_t));
+    return 0;
+}
+
+int dntl_keygen_from_seeds(const dntl_ctx_t *ctx, const uint32_t *sk,
+                           const uint8_t *r1, const uint8_t *r2, const uint8_t *r3,
+                           uint32_t *pk, uint8_t *pk_seed) {
+    DNTL_STAT_SCOPE(DNTL_STAT_KEYGEN_TRIAL);
+    const dntl_params_t *p = ctx->params;
+    const size_t s = p->seed_bytes;
+    uint8_t u[DNTL_MAX_SEED_BYTES];
+
+    dntl_chunk_t h1[] = { { r1, s }, { r2, s } };
+    if (shake256(u, s, h1, 2) != 0) {
+        return -1;
+    }
+    dntl_chunk_t h2[] = { { u, s }, { r3, s } };
+    if (shake256(pk_seed, s, h2, 2) != 0) {
+        return -1;
+    }
+
+    load_poly(ctx, pk, sk);
+    size_t applied;
+    int ret = apply_basis(ctx, pk_seed, pk, 1, &applied);
+    if (ret == 0) {
+        // The 'zero' product property: no coefficient may be q
+        ret = has_modulus(pk, p->n, p->q);
+    }
+    if (ret > 0) {
+        DNTL_STAT_COUNT(DNTL_COUNT_KEYGEN_REJECTS, 1);
+        DNTL_STAT_REJECT(DNTL_REJECT_KEYGEN_ZERO, applied ? applied - 1 : 0, 1);
+    }
+    return ret;
+}
+
+// keyGen on any randomness source, counting into counts
+static int keygen_rng(const dntl_ctx_t *ctx, keygen_rng_t rng, void *state,
+                      uint32_t *sk, uint32_t *pk, uint8_t *pk_seed, keygen_counts_t *counts) {
+    DNTL_STAT_SCOPE(DNTL_STAT_KEYGEN);
+    uint8_t r[3][DNTL_MAX_SEED_BYTES];
+    uint64_t attempts = 0;
+    int ret = -1;
+
+    if (sample_secret(ctx, rng, state, sk, counts) != 0) {
+        goto done;
+    }
+    for (int trials = 1; ; trials++) {
+        if (rng(state, &r[0][0], sizeof(r)) != 0) {
+            goto done;
+        }
+        attempts++;
+        counts->attempts++;
+        ret = dntl_keygen_from_seeds(ctx, sk, r[0], r[1], r[2], pk, pk_seed);
+        if (ret <= 0) {
+            if (ret == 0) {
+                DNTL_STAT_HIST(DNTL_HIST_KEYGEN_TRIALS, attempts);
+            }
+            goto done;
+        }
+        counts->pk_rejects++;
+        if (trials == DNTL_KEYGEN_TRIALS) {
+            DNTL_STAT_COUNT(DNTL_COUNT_KEYGEN_SECRET_REDRAWS, 1);
+            counts->secret_redraws++;
+            if (sample_secret(ctx, rng, state, sk, counts) != 0) {
+                ret = -1;
+                goto done;
+            }
+            trials = 0;
+        }
+    }
+
+done:
+    memset(r, 0, sizeof(r));
+    return ret;
+}
+
+int dntl_keygen(const dntl_ctx_t *ctx, uint32_t *sk, uint32_t *pk, uint8_t *pk_seed) {
+    keygen_counts_t counts = { 0, 0, 0, 0 };
+    return keygen_rng(ctx, system_rng, NULL, sk, pk, pk_seed, &counts);
+}
+
+int dntl_sign_from_seed(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                        const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                        const uint8_t *r1, uint32_t *sig, uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SIGN_TRIAL);
+    const dntl_params_t *p = ctx->params;
+    const size_t s = p->seed_bytes;
+    uint8_t pk_bytes[8 * DNTL_MAX_N];
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+
+    pk_to_bytes(pk_bytes, pk, p->n);
+    dntl_chunk_t h1[] = { { r1, s }, { pk_seed, s }, { pk_bytes, 8 * p->n } };
+    if (shake256(u, s, h1, 3) != 0) {
+        return -1;
+    }
+    dntl_chunk_t h2[] = { { u, s }, { m, m_len }, { pk_bytes, 8 * p->n } };
+    if (shake256(sc, s, h2, 3) != 0) {
+        return -1;
+    }
+
+    load_poly(ctx, sig, sk);
+    size_t applied;
+    int ret = apply_basis(ctx, sc, sig, 1, &applied);
+    if (ret == 0) {
+        ret = has_modulus(sig, p->n, p->q);
+    }
+    if (ret > 0) {
+        DNTL_STAT_COUNT(DNTL_COUNT_SIGN_REJECTS, 1);
+        DNTL_STAT_REJECT(DNTL_REJECT_SIGN_ZERO, applied ? applied - 1 : 0, 1);
+    }
+    return ret;
+}
+
+int dntl_sign(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+              const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+              uint32_t *sig, uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SIGN);
+    uint8_t r1[DNTL_MAX_SEED_BYTES];
+    uint64_t trials = 0;
+    int ret;
+
+    do {
+        if (random_bytes(r1, ctx->params->seed_bytes) != 0) {
+            ret = -1;
+            break;
+        }
+        trials++;
+        ret = dntl_sign_from_seed(ctx, m, m_len, sk, pk_seed, pk, r1, sig, u);
+    } while (ret > 0);
+    if (ret == 0) {
+        DNTL_STAT_HIST(DNTL_HIST_SIGN_TRIALS, trials);
+    }
+
+    memset(r1, 0, sizeof(r1));
+    return ret;
+}
+
+// With Q == Q2 both sides are pointwise products with zero-free factors, so
+// lhs[i] and rhs[i] end up zero exactly where pk[i] and sig[i] are zero. A
+// different zero pattern rejects before either basis is expanded.
+static int zeros_differ(const dntl_params_t *p, const uint32_t *lhs, const uint32_t *rhs) {
+    uint32_t diff = 0;
+
+    if (p->q == p->q2) {
+        for (size_t i = 0; i < p->n; i++) {
+            diff |= (uint32_t)(lhs[i] == 0) ^ (uint32_t)(rhs[i] == 0);
+        }
+    }
+    return diff != 0;
+}
+
+// Loads and checks the key and signature; 0 if verification fails early
+static int verify_check(const dntl_ctx_t *ctx, const uint32_t *pk, const uint32_t *sig,
+                        uint32_t *lhs, uint32_t *rhs) {
+    const dntl_params_t *p = ctx->params;
+
+    return load_poly(ctx, lhs, pk) == 0 && load_poly(ctx, rhs, sig) == 0 &&
+           !zeros_differ(p, lhs, rhs);
+}
+
+// verify_check(), then SC; 0 if verification fails early
+static int verify_prepare(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                          const uint32_t *pk, const uint32_t *sig, const uint8_t *u,
+                          uint8_t *sc, uint32_t *lhs, uint32_t *rhs) {
+    const dntl_params_t *p = ctx->params;
+    const size_t s = p->seed_bytes;
+    uint8_t pk_bytes[8 * DNTL_MAX_N];
+
+    if (!verify_check(ctx, pk, sig, lhs, rhs)) {
+        return 0;
+    }
+
+    pk_to_bytes(pk_bytes, pk, p->n);
+    dntl_chunk_t h[] = { { u, s }, { m, m_len }, { pk_bytes, 8 * p->n } };
+    return shake256(sc, s, h, 3) == 0;
+}
+
+int dntl_verify(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                const uint8_t *pk_seed, const uint32_t *pk,
+                const uint32_t *sig, const uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+
+    if (!verify_prepare(ctx, m, m_len, pk, sig, u, sc, lhs, rhs)) {
+        return 0;
+    }
+    if (apply_basis(ctx, sc, lhs, 0, NULL) != 0 || apply_basis(ctx, pk_seed, rhs, 0, NULL) != 0) {
+        return 0;
+    }
+    return memcmp(lhs, rhs, ctx->params->n * sizeof(uint32_t)) == 0;
+}
+
+// ============================================================================
+// WIRE-FORMAT VERIFICATION
+// ============================================================================
+
+// Coefficient bytes of a view: in place if packed, else decoded into scratch.
+// Escaped positions hold 0 (value 0) or 1 (value Q); NULL if malformed.
+static const uint8_t *wire_bytes(const dntl_wire_view_t *v, uint8_t *scratch) {
+    const uint8_t *bytes = v->body;
+
+    if (v->mode & DNTL_WIRE_CODED) {
+        if (huffman_decode(v->body, v->body_len, scratch, v->params->n) != 0) {
+            return NULL;
+        }
+        bytes = scratch;
+    }
+    for (size_t e = 0; e < v->n_escapes; e++) {
+        if (bytes[v->escapes[e]] > 1) {
+            return NULL;
+        }
+    }
+    return bytes;
+}
+
+int dntl_verify_wire(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                     const dntl_wire_view_t *pk, const dntl_wire_view_t *sig) {
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    const dntl_params_t *p = ctx->params;
+    const size_t n = p->n, s = p->seed_bytes;
+    uint8_t pk_scratch[DNTL_MAX_N], sig_scratch[DNTL_MAX_N];
+    uint8_t pk_bytes[8 * DNTL_MAX_N] = { 0 };
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+
+    if (pk->params->level != p->level || sig->params->level != p->level ||
+        pk->kind != DNTL_WIRE_PK || sig->kind != DNTL_WIRE_SIG) {
+        return 0;
+    }
+    const uint8_t *pkb = wire_bytes(pk, pk_scratch);
+    const uint8_t *sigb = wire_bytes(sig, sig_scratch);
+    if (!pkb || !sigb) {
+        return 0;
+    }
+
+    // One pass: canonical values (byte + 1 <= 256 < Q) and pk.tobytes()
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t v = (uint32_t)pkb[i] + 1;
+        lhs[i] = v;
+        rhs[i] = (uint32_t)sigb[i] + 1;
+        pk_bytes[8 * i] = (uint8_t)v;
+        pk_bytes[8 * i + 1] = (uint8_t)(v >> 8);
+    }
+    for (size_t e = 0; e < pk->n_escapes; e++) {
+        const size_t i = pk->escapes[e];
+        const uint32_t v = pkb[i] ? p->q : 0;
+        lhs[i] = 0;
+        pk_bytes[8 * i] = (uint8_t)v;
+        pk_bytes[8 * i + 1] = (uint8_t)(v >> 8);
+    }
+    for (size_t e = 0; e < sig->n_escapes; e++) {
+        rhs[sig->escapes[e]] = 0;
+    }
+    if (zeros_differ(p, lhs, rhs)) {
+        return 0;
+    }
+
+    dntl_chunk_t h[] = { { sig->seed, s }, { m, m_len }, { pk_bytes, 8 * n } };
+    if (shake256(sc, s, h, 3) != 0 || apply_basis(ctx, sc, lhs, 0, NULL) != 0 ||
+        apply_basis(ctx, pk->seed, rhs, 0, NULL) != 0) {
+        return 0;
+    }
+    return memcmp(lhs, rhs, n * sizeof(uint32_t)) == 0;
+}
+
+// ============================================================================
+// PUBLIC-BASIS CACHE
+// ============================================================================
+//
+// Chained hash table over PK_C plus an intrusive LRU list. Entries are
+// allocated on demand up to the capacity (or carved in order from one pool
+// when the cache has an allocator); after that the least recently used one
+// is recycled. Lookups copy the basis out under the lock, and misses
+// expand the basis without holding it.
+
+typedef struct dntl_cache_entry {
+    struct dntl_cache_entry *hash_next;
+    struct dntl_cache_entry *lru_prev;      // towards most recently used
+    struct dntl_cache_entry *lru_next;
+    uint8_t key[DNTL_MAX_SEED_BYTES];
+    uint32_t products[];                    // k rows of n: dntl_basis_t.products
+} dntl_cache_entry_t;
+
+struct dntl_basis_cache {
+    const dntl_ctx_t *ctx;
+    pthread_mutex_t lock;
+    size_t entry_bytes;
+    size_t capacity;
+    size_t entries;
+    size_t max_bytes;
+    const dntl_allocator_t *alloc;          // of pool, or NULL: entries malloc'd
+    uint8_t *pool;                          // capacity entries of entry_bytes
+    int node;                               // NUMA node of pool, or -1
+    size_t bucket_mask;
+    dntl_cache_entry_t **buckets;
+    dntl_cache_entry_t *lru_head;           // most recently used
+    dntl_cache_entry_t *lru_tail;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+};
+
+// PK_C is a SHAKE-256 output, so its leading bytes are already uniform
+static size_t cache_bucket(const dntl_basis_cache_t *cache, const uint8_t *key) {
+    uint64_t h;
+    memcpy(&h, key, sizeof(h));
+    return (size_t)(h * 0x9E3779B97F4A7C15ULL >> 32) & cache->bucket_mask;
+}
+
+static void lru_unlink(dntl_basis_cache_t *cache, dntl_cache_entry_t *e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else cache->lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else cache->lru_tail = e->lru_prev;
+}
+
+static void lru_push_front(dntl_basis_cache_t *cache, dntl_cache_entry_t *e) {
+    e->lru_prev = NULL;
+    e->lru_next = cache->lru_head;
+    if (cache->lru_head) cache->lru_head->lru_prev = e;
+    else cache->lru_tail = e;
+    cache->lru_head = e;
+}
+
+static dntl_cache_entry_t *cache_find(dntl_basis_cache_t *cache, const uint8_t *key) {
+    const size_t s = cache->ctx->params->seed_bytes;
+    for (dntl_cache_entry_t *e = cache->buckets[cache_bucket(cache, key)]; e; e = e->hash_next) {
+        if (memcmp(e->key, key, s) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void cache_remove_hash(dntl_basis_cache_t *cache, dntl_cache_entry_t *e) {
+    dntl_cache_entry_t **link = &cache->buckets[cache_bucket(cache, e->key)];
+    while (*link != e) {
+        link = &(*link)->hash_next;
+    }
+    *link = e->hash_next;
+}
+
+// Insert under the lock (another thread may have inserted the key meanwhile)
+static void cache_insert(dntl_basis_cache_t *cache, const uint8_t *key, const dntl_basis_t *basis) {
+    const dntl_params_t *p = cache->ctx->params;
+    dntl_cache_entry_t *e = cache_find(cache, key);
+
+    if (!e) {
+        if (cache->entries < cache->capacity) {
+            e = cache->pool ? (dntl_cache_entry_t *)(cache->pool +
+                                                     cache->entries * cache->entry_bytes)
+                            : malloc(cache->entry_bytes);
+            if (!e) {
+                return;
+            }
+            cache->entries++;
+        } else {
+            e = cache->lru_tail;
+            lru_unlink(cache, e);
+            cache_remove_hash(cache, e);
+            cache->evictions++;
+        }
+        memcpy(e->key, key, p->seed_bytes);
+        for (size_t inst = 0; inst < p->k; inst++) {
+            memcpy(e->products + inst * p->n, basis->products[inst], p->n * sizeof(uint32_t));
+        }
+        size_t b = cache_bucket(cache, key);
+        e->hash_next = cache->buckets[b];
+        cache->buckets[b] = e;
+    } else {
+        lru_unlink(cache, e);
+    }
+    lru_push_front(cache, e);
+}
+
+size_t dntl_basis_cache_entry_bytes(const dntl_ctx_t *ctx) {
+    return sizeof(dntl_cache_entry_t) + ctx->params->k * ctx->params->n * sizeof(uint32_t);
+}
+
+dntl_basis_cache_t *dntl_basis_cache_create(const dntl_ctx_t *ctx, size_t max_bytes) {
+    return dntl_basis_cache_create_alloc(ctx, max_bytes, NULL, -1);
+}
+
+dntl_basis_cache_t *dntl_basis_cache_create_alloc(const dntl_ctx_t *ctx, size_t max_bytes,
+                                                  const dntl_allocator_t *alloc, int node) {
+    // Pooled entries start on cache lines
+    size_t entry_bytes = dntl_basis_cache_entry_bytes(ctx);
+    if (alloc) {
+        entry_bytes = (entry_bytes + 63) & ~(size_t)63;
+    }
+    if (max_bytes < sizeof(dntl_basis_cache_t) + entry_bytes + sizeof(dntl_cache_entry_t *)) {
+        return NULL;
+    }
+    dntl_basis_cache_t *cache = calloc(1, sizeof(*cache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->ctx = ctx;
+    cache->entry_bytes = entry_bytes;
+    cache->max_bytes = max_bytes;
+
+    // Every key costs its entry plus at most one bucket pointer
+    cache->capacity = (max_bytes - sizeof(*cache)) / (entry_bytes + sizeof(dntl_cache_entry_t *));
+    size_t buckets = 1;
+    while (buckets * 2 <= cache->capacity) {
+        buckets *= 2;
+    }
+    cache->bucket_mask = buckets - 1;
+    cache->buckets = calloc(buckets, sizeof(dntl_cache_entry_t *));
+
+    // The pool is only mapped: its pages are touched as entries fill it
+    cache->alloc = alloc;
+    cache->node = alloc ? node : -1;
+    if (alloc) {
+        cache->pool = alloc->alloc(alloc->user, cache->capacity * entry_bytes, node);
+    }
+    if (!cache->buckets || (alloc && !cache->pool) ||
+        pthread_mutex_init(&cache->lock, NULL) != 0) {
+        if (cache->pool) {
+            alloc->free(alloc->user, cache->pool, cache->capacity * entry_bytes);
+        }
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void dntl_basis_cache_destroy(dntl_basis_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+    if (cache->pool) {
+        cache->alloc->free(cache->alloc->user, cache->pool,
+                           cache->capacity * cache->entry_bytes);
+    } else {
+        dntl_cache_entry_t *e = cache->lru_head;
+        while (e) {
+            dntl_cache_entry_t *next = e->lru_next;
+            free(e);
+            e = next;
+        }
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->buckets);
+    free(cache);
+}
+
+void dntl_basis_cache_stats(dntl_basis_cache_t *cache, dntl_basis_cache_stats_t *stats) {
+    pthread_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+    stats->entries = cache->entries;
+    stats->capacity = cache->capacity;
+    stats->bytes = sizeof(*cache) + (cache->bucket_mask + 1) * sizeof(dntl_cache_entry_t *) +
+                   cache->entries * cache->entry_bytes;
+    stats->max_bytes = cache->max_bytes;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// The basis of pk_seed, from the cache or compiled and added; -1 if SHAKE-256
+// fails
+static int cache_basis(dntl_basis_cache_t *cache, const uint8_t *pk_seed, dntl_basis_t *basis) {
+    const dntl_params_t *p = cache->ctx->params;
+
+    pthread_mutex_lock(&cache->lock);
+    dntl_cache_entry_t *e = cache_find(cache, pk_seed);
+    if (e) {
+        basis->level = p->level;
+        for (size_t inst = 0; inst < p->k; inst++) {
+            memcpy(basis->products[inst], e->products + inst * p->n, p->n * sizeof(uint32_t));
+        }
+        lru_unlink(cache, e);
+        lru_push_front(cache, e);
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    if (!e) {
+        if (dntl_basis_compile(cache->ctx, pk_seed, basis) != 0) {
+            return -1;
+        }
+        pthread_mutex_lock(&cache->lock);
+        cache_insert(cache, pk_seed, basis);
+        pthread_mutex_unlock(&cache->lock);
+    }
+    return 0;
+}
+
+int dntl_verify_cached(dntl_basis_cache_t *cache, const uint8_t *m, size_t m_len,
+                       const uint8_t *pk_seed, const uint32_t *pk,
+                       const uint32_t *sig, const uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    const dntl_ctx_t *ctx = cache->ctx;
+    const dntl_params_t *p = ctx->params;
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    dntl_basis_t basis;
+
+    if (!verify_prepare(ctx, m, m_len, pk, sig, u, sc, lhs, rhs) ||
+        cache_basis(cache, pk_seed, &basis) != 0) {
+        return 0;
+    }
+
+    if (apply_basis(ctx, sc, lhs, 0, NULL) != 0) {
+        return 0;
+    }
+    basis_apply_canonical(ctx, &basis, rhs);
+    return memcmp(lhs, rhs, p->n * sizeof(uint32_t)) == 0;
+}
+
+// ============================================================================
+// WORKER POOL
+// ============================================================================
+//
+// A batch is spread over the scheduler: every thread running batch_worker
+// takes task indices in order from a shared counter. If the batch stops at
+// the first accept, each task returning 0 lowers `best` and indices above it
+// are no longer started. dntl_sched_spread() returns once every copy has
+// finished.
+
+typedef struct {
+    int (*run)(const void *job, size_t i);  // 0 accept, 1 reject, -1 error
+    const void *job;
+    size_t count;
+    int first_accept;
+    _Atomic size_t next;    // next index to start
+    _Atomic size_t best;    // lowest accepted index (count if none)
+    atomic_int error;
+} dntl_task_batch_t;
+
+static void batch_worker(void *arg) {
+    dntl_task_batch_t *b = arg;
+
+    for (;;) {
+        size_t i = atomic_fetch_add(&b->next, 1);
+        if (i >= b->count || i >= atomic_load(&b->best) || atomic_load(&b->error)) {
+            return;
+        }
+
+        int ret = b->run(b->job, i);
+
+        if (ret < 0) {
+            atomic_store(&b->error, 1);
+        } else if (ret == 0 && b->first_accept) {
+            size_t best = atomic_load(&b->best);
+            while (i < best && !atomic_compare_exchange_weak(&b->best, &best, i)) {
+            }
+        }
+    }
+}
+
+// Run a batch on the pool and the calling thread, preferring the workers of
+// node (-1 for the caller's); -1 if a task failed, otherwise the lowest
+// accepted index (count if none or !first_accept)
+static int pool_run_node(dntl_sign_pool_t *pool, int node, int (*run)(const void *, size_t),
+                         const void *job, size_t count, int first_accept) {
+    dntl_task_batch_t b = {
+        .run = run, .job = job, .count = count, .first_accept = first_accept,
+    };
+    atomic_init(&b.next, 0);
+    atomic_init(&b.best, count);
+    atomic_init(&b.error, 0);
+
+    dntl_sched_spread_node(count > 1 ? pool : NULL, node, batch_worker, &b, count);
+    return atomic_load(&b.error) ? -1 : (int)atomic_load(&b.best);
+}
+
+static int pool_run(dntl_sign_pool_t *pool, int (*run)(const void *, size_t), const void *job,
+                    size_t count, int first_accept) {
+    return pool_run_node(pool, -1, run, job, count, first_accept);
+}
+
+dntl_sign_pool_t *dntl_sign_pool_create(size_t threads) {
+    return dntl_sched_create(threads, 0);
+}
+
+void dntl_sign_pool_destroy(dntl_sign_pool_t *pool) {
+    dntl_sched_destroy(pool);
+}
+
+// ============================================================================
+// SPECULATIVE SIGNING
+// ============================================================================
+
+typedef struct {
+    const dntl_ctx_t *ctx;
+    const uint8_t *m;
+    size_t m_len;
+    const uint32_t *sk;
+    const uint8_t *pk_seed;
+    const uint32_t *pk;
+    const uint8_t *r1s;
+    uint32_t *sigs;         // count * n
+    uint8_t *us;            // count * seed_bytes
+} dntl_sign_job_t;
+
+static int sign_task(const void *job, size_t i) {
+    const dntl_sign_job_t *j = job;
+    const dntl_params_t *p = j->ctx->params;
+
+    return dntl_sign_from_seed(j->ctx, j->m, j->m_len, j->sk, j->pk_seed, j->pk,
+                               j->r1s + i * p->seed_bytes,
+                               j->sigs + i * p->n, j->us + i * p->seed_bytes);
+}
+
+int dntl_sign_candidates(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                         const uint8_t *m, size_t m_len,
+                         const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                         const uint8_t *r1s, size_t count, uint32_t *sig, uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SIGN);
+    const dntl_params_t *p = ctx->params;
+    if (count == 0 || count > DNTL_MAX_CANDIDATES) {
+        return -1;
+    }
+
+    dntl_sign_job_t job = {
+        .ctx = ctx, .m = m, .m_len = m_len, .sk = sk, .pk_seed = pk_seed, .pk = pk,
+        .r1s = r1s,
+        .sigs = malloc(count * p->n * sizeof(uint32_t)),
+        .us = malloc(count * p->seed_bytes),
+    };
+    if (!job.sigs || !job.us) {
+        free(job.sigs);
+        free(job.us);
+        return -1;
+    }
+
+    int ret = pool_run(pool, sign_task, &job, count, 1);
+    if (ret >= 0 && (size_t)ret < count) {
+        memcpy(sig, job.sigs + (size_t)ret * p->n, p->n * sizeof(uint32_t));
+        memcpy(u, job.us + (size_t)ret * p->seed_bytes, p->seed_bytes);
+    }
+    free(job.sigs);
+    free(job.us);
+    return ret;
+}
+
+int dntl_sign_speculative(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                          const uint8_t *m, size_t m_len,
+                          const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                          size_t candidates, uint32_t *sig, uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SIGN);
+    uint8_t r1s[DNTL_MAX_CANDIDATES * DNTL_MAX_SEED_BYTES];
+    const size_t len = candidates * ctx->params->seed_bytes;
+    uint64_t rounds = 0;
+    int ret;
+
+    if (candidates == 0 || candidates > DNTL_MAX_CANDIDATES) {
+        return -1;
+    }
+    do {
+        if (random_bytes(r1s, len) != 0) {
+            ret = -1;
+            break;
+        }
+        rounds++;
+        ret = dntl_sign_candidates(pool, ctx, m, m_len, sk, pk_seed, pk, r1s, candidates, sig, u);
+    } while (ret == (int)candidates);
+    if (ret >= 0) {
+        // Trials a serial dntl_sign() would have run for the same candidates
+        DNTL_STAT_HIST(DNTL_HIST_SIGN_TRIALS, (rounds - 1) * candidates + (uint64_t)ret + 1);
+    }
+
+    memset(r1s, 0, len);
+    return ret < 0 ? -1 : 0;
+}
+
+// ============================================================================
+// BATCH KEY GENERATION
+// ============================================================================
+//
+// A window of up to 4 shards per thread is generated into fixed-size record
+// slots, then packed and handed to the sink in one call while the slots are
+// reused for the next window.
+
+static const char KEYGEN_BATCH_TAG[] = "DNTL-DSA keygen batch";
+
+typedef struct {
+    const dntl_ctx_t *ctx;
+    const keccak_state_t *prefix;   // tag and seed absorbed
+    uint64_t first;                 // index of the window's first key
+    size_t count;                   // keys in the window
+    size_t record_cap;              // bytes per record slot
+    uint8_t *records;               // count * record_cap
+    size_t *lens;                   // bytes of each record
+    keygen_counts_t *counts;        // one per shard
+} dntl_keygen_job_t;
+
+static int xof_rng(void *state, uint8_t *out, size_t len) {
+    keccak_squeeze(state, out, len);
+    return 0;
+}
+
+static int keygen_task(const void *job, size_t shard) {
+    const dntl_keygen_job_t *j = job;
+    const dntl_params_t *p = j->ctx->params;
+    const size_t end = (shard + 1) * DNTL_KEYGEN_SHARD < j->count
+                           ? (shard + 1) * DNTL_KEYGEN_SHARD : j->count;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES];
+    keccak_state_t st;
+    int ret = 0;
+
+    memset(&j->counts[shard], 0, sizeof(j->counts[shard]));
+    for (size_t i = shard * DNTL_KEYGEN_SHARD; i < end && ret == 0; i++) {
+        const uint64_t index = j->first + i;
+        uint8_t le[8];
+        for (int b = 0; b < 8; b++) {
+            le[b] = (uint8_t)(index >> (8 * b));
+        }
+        st = *j->prefix;
+        keccak_absorb(&st, le, sizeof(le));
+        keccak_finalize(&st);
+
+        uint8_t *rec = j->records + i * j->record_cap;
+        size_t pk_len = 0, sk_len = 0;
+        if (keygen_rng(j->ctx, xof_rng, &st, sk, pk, pk_seed, &j->counts[shard]) != 0 ||
+            dntl_wire_encode(p, DNTL_WIRE_PK, pk, pk_seed, 0, rec, j->record_cap, &pk_len) != 0 ||
+            dntl_wire_encode(p, DNTL_WIRE_SK, sk, NULL, 0, rec + pk_len,
+                             j->record_cap - pk_len, &sk_len) != 0) {
+            ret = -1;
+        }
+        j->lens[i] = pk_len + sk_len;
+    }
+    memset(&st, 0, sizeof(st));
+    memset(sk, 0, sizeof(sk));
+    return ret;
+}
+
+int dntl_keygen_sink_fd(void *user, const uint8_t *buf, size_t len) {
+    const int fd = *(const int *)user;
+
+    while (len > 0) {
+        ssize_t put = write(fd, buf, len);
+        if (put < 0 && errno == EINTR) {
+            continue;
+        }
+        if (put <= 0) {
+            return -1;
+        }
+        buf += put;
+        len -= (size_t)put;
+    }
+    return 0;
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+}
+
+int dntl_keygen_batch(dntl_sched_t *sched, const dntl_ctx_t *ctx,
+                      const uint8_t *seed, size_t seed_len, uint64_t first, uint64_t count,
+                      dntl_keygen_sink_t sink, void *user, dntl_keygen_stats_t *stats) {
+    const double start = monotonic_seconds();
+    dntl_keygen_stats_t st = { 0 };
+    keccak_state_t prefix;
+    int ret = -1;
+
+    if (!ctx || !seed || seed_len == 0 || !sink) {
+        goto out;
+    }
+    const dntl_params_t *p = ctx->params;
+    const size_t record_cap = dntl_wire_max_bytes(p, DNTL_WIRE_PK) +
+                              dntl_wire_max_bytes(p, DNTL_WIRE_SK);
+    const size_t threads = sched ? dntl_sched_workers(sched) + 1 : 1;
+    size_t window = 4 * threads * DNTL_KEYGEN_SHARD;
+    if (window > count) {
+        window = (size_t)count;
+    }
+    const size_t shards = (window + DNTL_KEYGEN_SHARD - 1) / DNTL_KEYGEN_SHARD;
+
+    dntl_keygen_job_t job = {
+        .ctx = ctx, .prefix = &prefix, .record_cap = record_cap,
+        .records = malloc(window * record_cap + 1),
+        .lens = malloc(window * sizeof(size_t) + 1),
+        .counts = malloc(shards * sizeof(keygen_counts_t) + 1),
+    };
+    if (!job.records || !job.lens || !job.counts) {
+        goto done;
+    }
+    keccak_shake256_init(&prefix);
+    keccak_absorb(&prefix, KEYGEN_BATCH_TAG, sizeof(KEYGEN_BATCH_TAG) - 1);
+    keccak_absorb(&prefix, seed, seed_len);
+
+    ret = 0;
+    for (uint64_t done = 0; done < count && ret == 0; done += job.count) {
+        job.first = first + done;
+        job.count = count - done < window ? (size_t)(count - done) : window;
+        const size_t n_shards = (job.count + DNTL_KEYGEN_SHARD - 1) / DNTL_KEYGEN_SHARD;
+        if (pool_run(sched, keygen_task, &job, n_shards, 0) < 0) {
+            ret = -1;
+            break;
+        }
+        for (size_t s = 0; s < n_shards; s++) {
+            st.attempts += job.counts[s].attempts;
+            st.pk_rejects += job.counts[s].pk_rejects;
+            st.secret_rejects += job.counts[s].secret_rejects;
+            st.secret_redraws += job.counts[s].secret_redraws;
+        }
+
+        // Pack the slots: record i moves down to the end of record i - 1
+        size_t bytes = 0;
+        for (size_t i = 0; i < job.count; i++) {
+            memmove(job.records + bytes, job.records + i * record_cap, job.lens[i]);
+            bytes += job.lens[i];
+        }
+        if (sink(user, job.records, bytes) != 0) {
+            ret = -1;
+            break;
+        }
+        st.keys += job.count;
+        st.bytes += bytes;
+    }
+
+done:
+    if (job.records) {
+        memset(job.records, 0, window * record_cap);
+    }
+    memset(&prefix, 0, sizeof(prefix));
+    free(job.records);
+    free(job.lens);
+    free(job.counts);
+out:
+    st.seconds = monotonic_seconds() - start;
+    if (stats) {
+        *stats = st;
+    }
+    return ret;
+}
+
+// ============================================================================
+// BATCH VERIFICATION
+// ============================================================================
+
+typedef struct {
+    const dntl_ctx_t *ctx;
+    const dntl_verify_item_t *items;
+    const uint8_t **seeds;  // distinct pk_seeds
+    dntl_basis_t *bases;    // one per distinct pk_seed
+    const size_t *key;      // item -> index into seeds / bases
+    const size_t *order;    // task -> item, or NULL for task i = item i
+    int *results;
+} dntl_verify_job_t;
+
+static int compile_task(const void *job, size_t i) {
+    const dntl_verify_job_t *j = job;
+
+    return dntl_basis_compile(j->ctx, j->seeds[i], &j->bases[i]);
+}
+
+static int verify_task(const void *job, size_t task) {
+    const dntl_verify_job_t *j = job;
+    const size_t i = j->order ? j->order[task] : task;
+    const dntl_verify_item_t *it = &j->items[i];
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+
+    j->results[i] = 0;
+    if (verify_prepare(j->ctx, it->m, it->m_len, it->pk, it->sig, it->u, sc, lhs, rhs) &&
+        apply_basis(j->ctx, sc, lhs, 0, NULL) == 0) {
+        basis_apply_canonical(j->ctx, &j->bases[j->key[i]], rhs);
+        j->results[i] = memcmp(lhs, rhs, j->ctx->params->n * sizeof(uint32_t)) == 0;
+    }
+    return 0;
+}
+
+// Assign each item the index of its pk_seed among the distinct seeds (open
+// addressing; seeds are hash outputs, so their first bytes are the hash)
+static size_t group_by_key(const dntl_verify_item_t *items, size_t n, size_t seed_bytes,
+                           const uint8_t **seeds, size_t *key, size_t *slots, size_t mask) {
+    size_t distinct = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t h = 0;
+        memcpy(&h, items[i].pk_seed, seed_bytes < 8 ? seed_bytes : 8);
+        size_t s = (size_t)h & mask;
+        while (slots[s] && memcmp(seeds[slots[s] - 1], items[i].pk_seed, seed_bytes) != 0) {
+            s = (s + 1) & mask;
+        }
+        if (!slots[s]) {
+            seeds[distinct++] = items[i].pk_seed;
+            slots[s] = distinct;
+        }
+        key[i] = slots[s] - 1;
+    }
+    return distinct;
+}
+
+// One node's share of a batch: the bases of its keys, in its own memory,
+// and the items of those keys
+typedef struct {
+    dntl_sign_pool_t *pool;
+    int node;
+    dntl_verify_job_t job;
+    size_t keys, count;
+    dntl_basis_t *arena;
+    int ret;
+} dntl_verify_share_t;
+
+static void share_task(void *arg) {
+    dntl_verify_share_t *sh = arg;
+
+    sh->ret = pool_run_node(sh->pool, sh->node, compile_task, &sh->job, sh->keys, 0) < 0 ? -1
+            : pool_run_node(sh->pool, sh->node, verify_task, &sh->job, sh->count, 0) < 0 ? -1
+            : 0;
+}
+
+// dntl_verify_batch() over the nodes that have workers: each key goes to the
+// node with the fewest items so far, which expands its basis into memory of
+// its own and checks every item signed under it. key[] is rewritten to the
+// index of each item's key among its node's keys. 1 if there are fewer than
+// two such nodes, else 0 or -1.
+static int verify_by_node(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                          const dntl_verify_item_t *items, size_t n, int *results,
+                          const uint8_t **seeds, size_t *key, size_t distinct) {
+    int homes[DNTL_ALLOC_MAX_NODES], count = 0;
+    for (int node = 0; node < dntl_sched_nodes(pool); node++) {
+        if (dntl_sched_node_workers(pool, node) > 0) {
+            homes[count++] = node;
+        }
+    }
+    if (count < 2 || distinct < 2) {
+        return 1;
+    }
+
+    dntl_verify_share_t shares[DNTL_ALLOC_MAX_NODES];
+    size_t *per_key = calloc(distinct, sizeof(*per_key));
+    size_t *local = malloc(distinct * sizeof(*local));
+    int *home = malloc(distinct * sizeof(*home));
+    const uint8_t **by_node = malloc(distinct * sizeof(*by_node));
+    size_t *order = malloc(n * sizeof(*order));
+    int ret = -1;
+
+    memset(shares, 0, sizeof(shares));
+    if (!per_key || !local || !home || !by_node || !order) {
+        goto out;
+    }
+    for (size_t i = 0; i < n; i++) {
+        per_key[key[i]]++;
+    }
+    for (size_t k = 0; k < distinct; k++) {
+        int best = 0;
+        for (int h = 1; h < count; h++) {
+            best = shares[h].count < shares[best].count ? h : best;
+        }
+        home[k] = best;
+        local[k] = shares[best].keys++;
+        shares[best].count += per_key[k];
+    }
+
+    // Each node's seeds and items, contiguous and in batch order
+    size_t seed_next[DNTL_ALLOC_MAX_NODES], item_next[DNTL_ALLOC_MAX_NODES];
+    size_t seed_at = 0, item_at = 0;
+    for (int h = 0; h < count; h++) {
+        shares[h].job = (dntl_verify_job_t){
+            .ctx = ctx, .items = items, .seeds = by_node + seed_at, .key = key,
+            .order = order + item_at, .results = results,
+        };
+        seed_next[h] = seed_at;
+        item_next[h] = item_at;
+        seed_at += shares[h].keys;
+        item_at += shares[h].count;
+    }
+    for (size_t k = 0; k < distinct; k++) {
+        by_node[seed_next[home[k]]++] = seeds[k];
+    }
+    for (size_t i = 0; i < n; i++) {
+        order[item_next[home[key[i]]]++] = i;
+        key[i] = local[key[i]];
+    }
+
+    dntl_sched_group_t g;
+    dntl_sched_group_init(&g, pool);
+    ret = 0;
+    for (int h = 0; h < count; h++) {
+        dntl_verify_share_t *sh = &shares[h];
+        if (sh->keys == 0) {
+            continue;
+        }
+        sh->pool = pool;
+        sh->node = homes[h];
+        sh->arena = dntl_alloc_pages(sh->keys * sizeof(dntl_basis_t), homes[h], 0);
+        if (!sh->arena) {
+            ret = -1;
+            break;
+        }
+        sh->job.bases = sh->arena;
+        dntl_sched_submit_node(&g, homes[h], share_task, sh);
+    }
+    dntl_sched_wait(&g);
+    for (int h = 0; h < count; h++) {
+        ret = shares[h].ret < 0 ? -1 : ret;
+        dntl_free_pages(shares[h].arena, shares[h].keys * sizeof(dntl_basis_t), 0);
+    }
+
+out:
+    free(order);
+    free(by_node);
+    free(home);
+    free(local);
+    free(per_key);
+    return ret;
+}
+
+int dntl_verify_batch(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                      const dntl_verify_item_t *items, size_t n, int *results) {
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    if (n == 0) {
+        return 0;
+    }
+
+    size_t table = 2;
+    while (table < 2 * n) table *= 2;
+    const uint8_t **seeds = malloc(n * sizeof(*seeds));
+    size_t *key = malloc(n * sizeof(*key));
+    size_t *slots = calloc(table, sizeof(*slots));
+    dntl_basis_t *bases = NULL;
+    int ret = -1;
+
+    if (seeds && key && slots) {
+        size_t distinct = group_by_key(items, n, ctx->params->seed_bytes, seeds, key, slots,
+                                       table - 1);
+        ret = pool ? verify_by_node(pool, ctx, items, n, results, seeds, key, distinct) : 1;
+        if (ret == 1) {
+            ret = -1;
+            bases = aligned_alloc(64, distinct * sizeof(*bases));
+        }
+        if (bases) {
+            dntl_verify_job_t job = {
+                .ctx = ctx, .items = items, .seeds = seeds, .bases = bases, .key = key,
+                .results = results,
+            };
+            if (pool_run(pool, compile_task, &job, distinct, 0) >= 0) {
+                pool_run(pool, verify_task, &job, n, 0);
+                ret = 0;
+            }
+        }
+    }
+
+    free(bases);
+    free(slots);
+    free(key);
+    free(seeds);
+    return ret;
+}
+
+// ============================================================================
+// OFFLOADED BATCH VERIFICATION
+// ============================================================================
+//
+// Two chunk buffers alternate: while the backend has chunk c in one, the
+// pool prepares chunk c + 1 in the other, which is started before the host
+// waits for c. A chunk the backend fails is prepared again and its sides
+// applied on the pool.
+
+typedef struct {
+    dntl_verify_chunk_t chunk;
+    const dntl_verify_job_t *job;
+    uint8_t *sc;
+    uint32_t *key;
+    uint8_t *live;
+    size_t first;   // item in slot 0
+    int host;       // the backend failed the chunk
+} dntl_offload_buf_t;
+
+// Slot j: checks and SC of its item
+static int offload_prepare_task(const void *job, size_t j) {
+    const dntl_offload_buf_t *b = job;
+    const dntl_ctx_t *ctx = b->job->ctx;
+    const size_t i = b->first + j, n = ctx->params->n;
+    const dntl_verify_item_t *it = &b->job->items[i];
+
+    b->key[j] = (uint32_t)b->job->key[i];
+    b->live[j] = (uint8_t)verify_prepare(ctx, it->m, it->m_len, it->pk, it->sig, it->u,
+                                         b->sc + j * ctx->params->seed_bytes,
+                                         b->chunk.lhs + j * n, b->chunk.rhs + j * n);
+    return 0;
+}
+
+// Slot j: both sides on the host
+static int offload_sides_task(const void *job, size_t j) {
+    const dntl_offload_buf_t *b = job;
+    const dntl_ctx_t *ctx = b->job->ctx;
+    const size_t n = ctx->params->n;
+
+    if (!b->live[j]) {
+        return 0;
+    }
+    if (apply_basis(ctx, b->sc + j * ctx->params->seed_bytes, b->chunk.lhs + j * n, 0,
+                    NULL) != 0) {
+        b->live[j] = 0;
+        return 0;
+    }
+    basis_apply_canonical(ctx, &b->job->bases[b->key[j]], b->chunk.rhs + j * n);
+    return 0;
+}
+
+// Prepare count items from first into b and start them on the backend
+static void offload_start(const dntl_verify_backend_t *backend, dntl_sign_pool_t *pool,
+                          dntl_offload_buf_t *b, size_t first, size_t count) {
+    b->first = first;
+    b->chunk.count = count;
+    pool_run(pool, offload_prepare_task, b, count, 0);
+    b->host = backend->start(backend->user, &b->chunk) != 0;
+}
+
+// Wait for the chunk in b, applying its sides on the pool if the backend
+// failed it, and write its results
+static void offload_finish(const dntl_verify_backend_t *backend, dntl_sign_pool_t *pool,
+                           dntl_offload_buf_t *b) {
+    const size_t n = b->job->ctx->params->n, count = b->chunk.count;
+
+    if (!b->host) {
+        b->host = backend->finish(backend->user, &b->chunk) != 0;
+    }
+    if (b->host) {
+        pool_run(pool, offload_prepare_task, b, count, 0);
+        pool_run(pool, offload_sides_task, b, count, 0);
+    }
+    for (size_t j = 0; j < count; j++) {
+        b->job->results[b->first + j] =
+            b->live[j] && memcmp(b->chunk.lhs + j * n, b->chunk.rhs + j * n,
+                                 n * sizeof(uint32_t)) == 0;
+    }
+}
+
+int dntl_verify_batch_offload(const dntl_verify_backend_t *backend, dntl_sign_pool_t *pool,
+                              const dntl_ctx_t *ctx, const dntl_verify_item_t *items,
+                              size_t n, int *results) {
+    if (!backend) {
+        return dntl_verify_batch(pool, ctx, items, n, results);
+    }
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    if (n == 0) {
+        return 0;
+    }
+
+    const dntl_params_t *p = ctx->params;
+    const size_t per_chunk = n < DNTL_VERIFY_CHUNK ? n : DNTL_VERIFY_CHUNK;
+    size_t table = 2;
+    while (table < 2 * n) table *= 2;
+    const uint8_t **seeds = malloc(n * sizeof(*seeds));
+    size_t *key = malloc(n * sizeof(*key));
+    size_t *slots = calloc(table, sizeof(*slots));
+    dntl_basis_t *bases = NULL;
+    dntl_offload_buf_t bufs[2];
+    int ret = -1;
+
+    memset(bufs, 0, sizeof(bufs));
+    if (!seeds || !key || !slots) {
+        goto out;
+    }
+    const size_t distinct = group_by_key(items, n, p->seed_bytes, seeds, key, slots,
+                                         table - 1);
+    bases = aligned_alloc(64, distinct * sizeof(*bases));
+    int buffers = 1;
+    for (int h = 0; h < 2; h++) {
+        dntl_offload_buf_t *b = &bufs[h];
+        b->sc = malloc(per_chunk * p->seed_bytes);
+        b->key = malloc(per_chunk * sizeof(*b->key));
+        b->live = malloc(per_chunk);
+        b->chunk.lhs = aligned_alloc(64, per_chunk * p->n * sizeof(uint32_t));
+        b->chunk.rhs = aligned_alloc(64, per_chunk * p->n * sizeof(uint32_t));
+        b->chunk.sc = b->sc;
+        b->chunk.key = b->key;
+        b->chunk.live = b->live;
+        buffers &= b->sc && b->key && b->live && b->chunk.lhs && b->chunk.rhs;
+    }
+    if (!bases || !buffers) {
+        goto out;
+    }
+
+    dntl_verify_job_t job = {
+        .ctx = ctx, .items = items, .seeds = seeds, .bases = bases, .key = key,
+        .results = results,
+    };
+    if (pool_run(pool, compile_task, &job, distinct, 0) < 0) {
+        goto out;
+    }
+    ret = 0;
+    if (backend->bind(backend->user, ctx, seeds, bases, distinct) != 0) {
+        pool_run(pool, verify_task, &job, n, 0);
+        goto out;
+    }
+
+    bufs[0].job = bufs[1].job = &job;
+    const size_t chunks = (n + per_chunk - 1) / per_chunk;
+    offload_start(backend, pool, &bufs[0], 0, per_chunk);
+    for (size_t c = 0; c < chunks; c++) {
+        const size_t next = (c + 1) * per_chunk;
+        if (next < n) {
+            offload_start(backend, pool, &bufs[(c + 1) % 2], next,
+                          n - next < per_chunk ? n - next : per_chunk);
+        }
+        offload_finish(backend, pool, &bufs[c % 2]);
+    }
+    backend->unbind(backend->user);
+
+out:
+    for (int h = 0; h < 2; h++) {
+        free(bufs[h].chunk.rhs);
+        free(bufs[h].chunk.lhs);
+        free(bufs[h].live);
+        free(bufs[h].key);
+        free(bufs[h].sc);
+    }
+    free(bases);
+    free(slots);
+    free(key);
+    free(seeds);
+    return ret;
+}
+
+// ============================================================================
+// TWO-SIDED VERIFICATION
+// ============================================================================
+
+typedef struct {
+    const dntl_ctx_t *ctx;
+    const uint8_t *seeds[2];    // SC, pk_seed
+    uint32_t *sides[2];         // lhs, rhs
+} dntl_sides_job_t;
+
+static int side_task(const void *job, size_t i) {
+    const dntl_sides_job_t *j = job;
+
+    return apply_basis(j->ctx, j->seeds[i], j->sides[i], 0, NULL) == 0 ? 0 : -1;
+}
+
+int dntl_verify_parallel(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                         const uint8_t *m, size_t m_len,
+                         const uint8_t *pk_seed, const uint32_t *pk,
+                         const uint32_t *sig, const uint8_t *u) {
+    DNTL_STAT_SCOPE(DNTL_STAT_VERIFY);
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+
+    if (!verify_prepare(ctx, m, m_len, pk, sig, u, sc, lhs, rhs)) {
+        return 0;
+    }
+    dntl_sides_job_t job = { ctx, { sc, pk_seed }, { lhs, rhs } };
+    if (pool_run(pool, side_task, &job, 2, 0) < 0) {
+        return 0;
+    }
+    return memcmp(lhs, rhs, ctx->params->n * sizeof(uint32_t)) == 0;
+}
+
+// ============================================================================
+// PIPELINED VERIFICATION
+// ============================================================================
+//
+// Signatures live in `depth` slots, linked into one FIFO list per stage (and
+// the free and poll lists) under the verifier lock. Each stage is drained by
+// scheduler tasks: a push starts one if fewer than the stage's limit run,
+// and a task only stops when, under the lock, it finds its queue empty, so
+// no item is left behind. While anything is queued, some task of the group
+// is pending: dntl_sched_wait() on it returns once everything has completed.
+
+#define VERIFIER_MAX_DEPTH 65536
+#define SLOT_NONE UINT32_MAX
+
+// Signatures taken per stage-1 and stage-3 batch
+#define VERIFIER_BATCH 16
+
+enum { STAGE_HASH, STAGE_BASIS, STAGE_DONE, STAGES };
+
+typedef struct {
+    uint32_t lhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    uint32_t rhs[DNTL_MAX_N] __attribute__((aligned(64)));
+    dntl_verify_item_t item;
+    dntl_verify_done_t done;
+    void *user;
+    uint8_t sc[DNTL_MAX_SEED_BYTES];
+    int valid;              // -1 until decided
+    uint32_t next;          // next slot of the list this one is on
+} verify_slot_t;
+
+typedef struct {
+    uint32_t head, tail;
+} slot_list_t;
+
+typedef struct {
+    dntl_verifier_t *v;
+    int stage;
+    slot_list_t queue;
+    size_t active;          // tasks draining the queue
+} verify_stage_t;
+
+struct dntl_verifier {
+    const dntl_ctx_t *ctx;
+    dntl_basis_cache_t *cache;
+    int node;                   // of the cache's pool, where stages run; or -1
+    dntl_sched_t *sched;
+    dntl_sched_t *own_sched;    // created when sched is NULL
+    dntl_sched_group_t group;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;     // a completion, or in_flight reached 0
+    verify_slot_t *slots;
+    slot_list_t free, ready;
+    size_t in_flight;           // submitted, not yet completed
+    size_t ready_count;
+    verify_stage_t stages[STAGES];
+};
+
+static void list_push(verify_slot_t *slots, slot_list_t *l, uint32_t i) {
+    slots[i].next = SLOT_NONE;
+    if (l->tail == SLOT_NONE) {
+        l->head = i;
+    } else {
+        slots[l->tail].next = i;
+    }
+    l->tail = i;
+}
+
+static uint32_t list_pop(verify_slot_t *slots, slot_list_t *l) {
+    const uint32_t i = l->head;
+    if (i != SLOT_NONE) {
+        l->head = slots[i].next;
+        if (l->head == SLOT_NONE) {
+            l->tail = SLOT_NONE;
+        }
+    }
+    return i;
+}
+
+// Threads draining a stage at once: stage 2 gets every worker
+static size_t stage_limit(const dntl_verifier_t *v, int stage) {
+    return stage == STAGE_BASIS ? dntl_sched_workers(v->sched) + 1 : 1;
+}
+
+static void stage_task(void *arg);
+
+// Queue slot i for stage; with the lock held. 1 if the caller must start a
+// task for it (after unlocking) with stage_start().
+static int stage_push(dntl_verifier_t *v, int stage, uint32_t i) {
+    verify_stage_t *st = &v->stages[stage];
+
+    list_push(v->slots, &st->queue, i);
+    if (st->active < stage_limit(v, stage)) {
+        st->active++;
+        return 1;
+    }
+    return 0;
+}
+
+static void stage_start(dntl_verifier_t *v, int stage) {
+    dntl_sched_submit_node(&v->group, v->node, stage_task, &v->stages[stage]);
+}
+
+// SC of up to four signatures with equal message lengths, one 4-way Keccak
+static void hash_x4(const dntl_ctx_t *ctx, verify_slot_t *const *slots, size_t count) {
+    const dntl_params_t *p = ctx->params;
+    const size_t s = p->seed_bytes;
+    uint8_t pk_bytes[4][8 * DNTL_MAX_N];
+    keccak_state_t md[4];
+    const void *u[4], *m[4], *pk[4];
+    void *sc[4];
+    uint8_t spare[4][DNTL_MAX_SEED_BYTES];
+
+    for (size_t k = 0; k < 4; k++) {
+        // Lanes past count repeat the first signature; their output is dropped
+        const verify_slot_t *slot = slots[k < count ? k : 0];
+        pk_to_bytes(pk_bytes[k], slot->item.pk, p->n);
+        keccak_shake256_init(&md[k]);
+        u[k] = slot->item.u;
+        m[k] = slot->item.m;
+        pk[k] = pk_bytes[k];
+        sc[k] = k < count ? slots[k]->sc : spare[k];
+    }
+    keccak_absorb_x4(md, u, s);
+    keccak_absorb_x4(md, m, slots[0]->item.m_len);
+    keccak_absorb_x4(md, pk, 8 * p->n);
+    keccak_finalize_x4(md);
+    keccak_squeeze_x4(md, sc, s);
+}
+
+// Stage 1: checks and SC; signatures failing the checks skip stage 2
+static void run_hash(dntl_verifier_t *v, verify_slot_t **batch, size_t count) {
+    verify_slot_t *pending[VERIFIER_BATCH];
+    size_t n = 0;
+
+    for (size_t b = 0; b < count; b++) {
+        verify_slot_t *slot = batch[b];
+        slot->valid = verify_check(v->ctx, slot->item.pk, slot->item.sig, slot->lhs, slot->rhs)
+                    ? -1 : 0;
+        if (slot->valid < 0) {
+            pending[n++] = slot;
+        }
+    }
+    // Groups of four with one message length, in order of first appearance
+    while (n > 0) {
+        verify_slot_t *group[4] = { pending[0] };
+        size_t g = 1, kept = 0;
+        for (size_t b = 1; b < n; b++) {
+            if (g < 4 && pending[b]->item.m_len == group[0]->item.m_len) {
+                group[g++] = pending[b];
+            } else {
+                pending[kept++] = pending[b];
+            }
+        }
+        hash_x4(v->ctx, group, g);
+        n = kept;
+    }
+}
+
+// Stage 2: both sides through their bases
+static void run_basis(dntl_verifier_t *v, verify_slot_t *slot) {
+    const dntl_verify_item_t *it = &slot->item;
+    dntl_basis_t basis;
+
+    if (v->cache) {
+        if (cache_basis(v->cache, it->pk_seed, &basis) != 0) {
+            slot->valid = 0;
+            return;
+        }
+        basis_apply_canonical(v->ctx, &basis, slot->rhs);
+    } else if (apply_basis(v->ctx, it->pk_seed, slot->rhs, 0, NULL) != 0) {
+        slot->valid = 0;
+        return;
+    }
+    if (apply_basis(v->ctx, slot->sc, slot->lhs, 0, NULL) != 0) {
+        slot->valid = 0;
+    }
+}
+
+// Stage 3: compare, then report (callbacks without the lock)
+static void run_done(dntl_verifier_t *v, verify_slot_t **batch, size_t count) {
+    const size_t bytes = v->ctx->params->n * sizeof(uint32_t);
+
+    for (size_t b = 0; b < count; b++) {
+        verify_slot_t *slot = batch[b];
+        if (slot->valid < 0) {
+            slot->valid = memcmp(slot->lhs, slot->rhs, bytes) == 0;
+        }
+        if (slot->done) {
+            slot->done(slot->user, slot->valid);
+        }
+    }
+
+    pthread_mutex_lock(&v->lock);
+    for (size_t b = 0; b < count; b++) {
+        const uint32_t i = (uint32_t)(batch[b] - v->slots);
+        if (batch[b]->done) {
+            list_push(v->slots, &v->free, i);
+        } else {
+            list_push(v->slots, &v->ready, i);
+            v->ready_count++;
+        }
+    }
+    v->in_flight -= count;
+    pthread_cond_broadcast(&v->changed);
+    pthread_mutex_unlock(&v->lock);
+}
+
+static void stage_task(void *arg) {
+    verify_stage_t *st = arg;
+    dntl_verifier_t *v = st->v;
+    const size_t max = st->stage == STAGE_BASIS ? 1 : VERIFIER_BATCH;
+    verify_slot_t *batch[VERIFIER_BATCH];
+
+    for (;;) {
+        size_t count = 0;
+        pthread_mutex_lock(&v->lock);
+        for (uint32_t i; count < max && (i = list_pop(v->slots, &st->queue)) != SLOT_NONE;) {
+            batch[count++] = &v->slots[i];
+        }
+        if (count == 0) {
+            st->active--;
+            pthread_mutex_unlock(&v->lock);
+            return;
+        }
+        pthread_mutex_unlock(&v->lock);
+
+        if (st->stage == STAGE_DONE) {
+            run_done(v, batch, count);
+            continue;
+        }
+        if (st->stage == STAGE_HASH) {
+            run_hash(v, batch, count);
+        } else {
+            run_basis(v, batch[0]);
+        }
+
+        int start[STAGES] = { 0 };
+        pthread_mutex_lock(&v->lock);
+        for (size_t b = 0; b < count; b++) {
+            const int next = batch[b]->valid < 0 && st->stage == STAGE_HASH ? STAGE_BASIS
+                                                                             : STAGE_DONE;
+            start[next] += stage_push(v, next, (uint32_t)(batch[b] - v->slots));
+        }
+        pthread_mutex_unlock(&v->lock);
+        for (int s = 0; s < STAGES; s++) {
+            while (start[s]-- > 0) {
+                stage_start(v, s);
+            }
+        }
+    }
+}
+
+dntl_verifier_t *dntl_verifier_create(const dntl_ctx_t *ctx, dntl_basis_cache_t *cache,
+                                      dntl_sched_t *sched, size_t depth) {
+    if (!ctx || (cache && cache->ctx != ctx) || depth == 0 || depth > VERIFIER_MAX_DEPTH) {
+        return NULL;
+    }
+    dntl_verifier_t *v = calloc(1, sizeof(*v));
+    if (!v) {
+        return NULL;
+    }
+    v->slots = aligned_alloc(64, depth * sizeof(*v->slots));
+    v->own_sched = sched ? NULL : dntl_sched_create(0, 0);
+    if (!v->slots || (!sched && !v->own_sched)) {
+        free(v->slots);
+        dntl_sched_destroy(v->own_sched);
+        free(v);
+        return NULL;
+    }
+    v->ctx = ctx;
+    v->cache = cache;
+    v->node = cache ? cache->node : -1;
+    v->sched = sched ? sched : v->own_sched;
+    dntl_sched_group_init(&v->group, v->sched);
+    pthread_mutex_init(&v->lock, NULL);
+    pthread_cond_init(&v->changed, NULL);
+    v->free.head = v->free.tail = v->ready.head = v->ready.tail = SLOT_NONE;
+    for (uint32_t i = 0; i < depth; i++) {
+        list_push(v->slots, &v->free, i);
+    }
+    for (int s = 0; s < STAGES; s++) {
+        v->stages[s] = (verify_stage_t){ .v = v, .stage = s, .queue = { SLOT_NONE, SLOT_NONE } };
+    }
+    return v;
+}
+
+void dntl_verifier_destroy(dntl_verifier_t *v) {
+    if (!v) {
+        return;
+    }
+    dntl_verifier_drain(v);
+    pthread_cond_destroy(&v->changed);
+    pthread_mutex_destroy(&v->lock);
+    dntl_sched_destroy(v->own_sched);
+    free(v->slots);
+    free(v);
+}
+
+int dntl_verifier_submit(dntl_verifier_t *v, const dntl_verify_item_t *item,
+                         dntl_verify_done_t done, void *user) {
+    pthread_mutex_lock(&v->lock);
+    const uint32_t i = list_pop(v->slots, &v->free);
+    if (i == SLOT_NONE) {
+        pthread_mutex_unlock(&v->lock);
+        return 1;
+    }
+    verify_slot_t *slot = &v->slots[i];
+    slot->item = *item;
+    slot->done = done;
+    slot->user = user;
+    v->in_flight++;
+    const int start = stage_push(v, STAGE_HASH, i);
+    pthread_mutex_unlock(&v->lock);
+
+    if (start) {
+        stage_start(v, STAGE_HASH);
+    }
+    return 0;
+}
+
+size_t dntl_verifier_poll(dntl_verifier_t *v, dntl_verify_result_t *out, size_t max) {
+    size_t count = 0;
+
+    pthread_mutex_lock(&v->lock);
+    for (uint32_t i; count < max && (i = list_pop(v->slots, &v->ready)) != SLOT_NONE; count++) {
+        out[count] = (dntl_verify_result_t){ v->slots[i].user, v->slots[i].valid };
+        list_push(v->slots, &v->free, i);
+    }
+    v->ready_count -= count;
+    pthread_mutex_unlock(&v->lock);
+    return count;
+}
+
+void dntl_verifier_wait(dntl_verifier_t *v) {
+    pthread_mutex_lock(&v->lock);
+    while (v->ready_count == 0 && v->in_flight > 0) {
+        if (dntl_sched_workers(v->sched) == 0) {
+            // Nobody else runs the stages
+            pthread_mutex_unlock(&v->lock);
+            dntl_sched_wait(&v->group);
+            pthread_mutex_lock(&v->lock);
+        } else {
+            pthread_cond_wait(&v->changed, &v->lock);
+        }
+    }
+    pthread_mutex_unlock(&v->lock);
+}
+
+void dntl_verifier_drain(dntl_verifier_t *v) {
+    dntl_sched_wait(&v->group);
+}
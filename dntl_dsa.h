@@ -0,0 +1,714 @@
+#ifndef DNTL_DSA_H
+#define DNTL_DSA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dntl_alloc.h"
+#include "dntl_sched.h"
+
+// ============================================================================
+// DNTL-DSA NATIVE ENGINE
+// ============================================================================
+//
+// keyGen, sign and verify of dntl-dsa-nat.py in C, on the length-generic NTT
+// plans (ntt_plan.h) and the fused transition step (dntl_transition.h).
+//
+// Given the same inputs the results are bit-identical to the Python code:
+//
+//   - the public bases are sampled exactly like sampleMatrixISISL2(): legacy
+//     numpy MT19937 seeded with the low 32 bits of the big-endian seed,
+//     np.random.choice(1..Q) by masked rejection, Q replaced by 1, rows whose
+//     forward_ntt_naturals() contains a zero (Q) drawn again;
+//   - seeds and nonces are SHAKE-256 outputs of the same concatenations, with
+//     pk.tobytes() hashed as N little-endian int64 values;
+//   - coefficients use the naturals convention [1, Q] on output.
+//
+// Fresh randomness (the secret key and r1, r2, r3) comes from the operating
+// system instead of os.urandom() / random.gauss(). The *_from_seeds variants
+// take that randomness as arguments and are deterministic.
+//
+// Usage (level 1):
+//
+//   dntl_ctx_t *ctx = dntl_ctx_create(1);
+//   uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+//   uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+//   dntl_keygen(ctx, sk, pk, pk_seed);
+//   dntl_sign(ctx, m, m_len, sk, pk_seed, pk, sig, u);
+//   int ok = dntl_verify(ctx, m, m_len, pk_seed, pk, sig, u);   // 1
+//   dntl_ctx_destroy(ctx);
+
+// Largest N, K and SEED_SIZE over all levels: size buffers with these
+#define DNTL_MAX_N 256
+#define DNTL_MAX_K 3
+#define DNTL_MAX_SEED_BYTES 32
+
+/**
+ * Parameter set of one security level (the CONSTANT_BLOCK of dntl-dsa-nat.py)
+ */
+typedef struct {
+    int level;                  // 1, 3 or 5 (the -c option)
+    size_t k;                   // instances
+    size_t n;                   // dimension
+    size_t a_vec;               // rows of the non-core instances
+    uint32_t q, r;              // outer modulus and generator
+    uint32_t q2, r2;            // transition modulus and generator
+    size_t seed_bytes;          // SEED_SIZE
+    uint32_t sk_min, sk_max;    // allowed_values = [sk_min .. sk_max]
+    uint32_t sk_mu;             // mean of the secret Gaussian
+    double sigma;
+    uint32_t max_norm;          // bound on int(||sk||)
+    uint32_t max_mapped_norm;   // bound on int(||sk - sk_mu||)
+} dntl_params_t;
+
+/**
+ * Parameters of a security level
+ *
+ * @return          Parameter set, or NULL if level is not 1, 3 or 5
+ */
+const dntl_params_t *dntl_params(int level);
+
+// Contexts are immutable after creation and may be shared between threads.
+typedef struct dntl_ctx dntl_ctx_t;
+
+/**
+ * Public-basis samplers
+ *
+ * DNTL_SAMPLER_MT19937 is sampleMatrixISISL2() (numpy MT19937, see above) and
+ * the default. DNTL_SAMPLER_SHAKE256 draws the rows from the seed's SHAKE-256
+ * stream instead, uses the whole seed (not its low 32 bits) and gives
+ * different keys and signatures; dntl-dsa-nat.py --sampler shake256 is its
+ * reference:
+ *
+ *   - block b = SHAKE256("DNTL-DSA basis" || seed || b as 4 bytes little
+ *     endian), DNTL_XOF_BLOCK_BYTES bytes; the stream is block 0, 1, ...
+ *   - the stream is read as 16-bit little-endian words w; words
+ *     w >= 65536 - 65536 % Q are skipped, the others give idx = w % Q and the
+ *     coefficient idx + 1, with Q replaced by 1 (as filter_basis());
+ *   - N consecutive coefficients form a candidate row; candidates whose
+ *     forward_ntt_naturals() contains a zero (Q) are skipped;
+ *   - instance 0 takes the first 2*(N//2) remaining candidates, each further
+ *     instance the next 2*(A_VEC//2).
+ */
+typedef enum {
+    DNTL_SAMPLER_MT19937 = 0,
+    DNTL_SAMPLER_SHAKE256 = 1
+} dntl_sampler_t;
+
+// Bytes per block of the DNTL_SAMPLER_SHAKE256 stream (four SHAKE-256 blocks)
+#define DNTL_XOF_BLOCK_BYTES 544
+
+/**
+ * Prepare the transforms for one security level
+ *
+ * The context runs the copy of the basis code compiled for the level, with
+ * N, K and A_VEC as constants.
+ *
+ * @return          New context, or NULL for an unknown level or if
+ *                  allocation fails
+ */
+dntl_ctx_t *dntl_ctx_create(int level);
+
+/**
+ * dntl_ctx_create() with a choice of public-basis sampler
+ *
+ * @return          New context, or NULL for an unknown level or sampler, or
+ *                  if allocation fails
+ */
+dntl_ctx_t *dntl_ctx_create_sampler(int level, dntl_sampler_t sampler);
+
+/**
+ * Public-basis sampler of a context
+ */
+dntl_sampler_t dntl_ctx_sampler(const dntl_ctx_t *ctx);
+
+/**
+ * Free a context (NULL is ignored)
+ */
+void dntl_ctx_destroy(dntl_ctx_t *ctx);
+
+/**
+ * Parameter set of a context
+ */
+const dntl_params_t *dntl_ctx_params(const dntl_ctx_t *ctx);
+
+/**
+ * Generate a key pair (keyGen)
+ *
+ * @param ctx       Context
+ * @param sk        Output secret key, n values in [sk_min, sk_max]
+ * @param pk        Output public key, n values in [1, q]
+ * @param pk_seed   Output public basis seed PK_C, seed_bytes bytes
+ * @return          0 on success, -1 if the system RNG fails
+ */
+int dntl_keygen(const dntl_ctx_t *ctx, uint32_t *sk, uint32_t *pk, uint8_t *pk_seed);
+
+/**
+ * One keyGen attempt from given randomness (deterministic)
+ *
+ * u = SHAKE256(r1 || r2), PK_C = SHAKE256(u || r3), then sk is pushed through
+ * the K instances of the basis sampled from PK_C.
+ *
+ * @param sk            Secret key, n values in [0, q]
+ * @param r1, r2, r3    seed_bytes random bytes each
+ * @return              0 on success, 1 if pk has a zero coefficient (keyGen
+ *                      then retries with fresh r1, r2, r3). A rejected
+ *                      attempt stops at the first instance where the zero is
+ *                      certain, and pk is then not meaningful.
+ */
+int dntl_keygen_from_seeds(const dntl_ctx_t *ctx, const uint32_t *sk,
+                           const uint8_t *r1, const uint8_t *r2, const uint8_t *r3,
+                           uint32_t *pk, uint8_t *pk_seed);
+
+/**
+ * Sign a message (sign)
+ *
+ * @param m, m_len  Message
+ * @param sk        Secret key from dntl_keygen()
+ * @param pk_seed   PK_C from dntl_keygen()
+ * @param pk        Public key from dntl_keygen() (hashed as given)
+ * @param sig       Output signature, n values in [1, q]
+ * @param u         Output nonce, seed_bytes bytes
+ * @return          0 on success, -1 if the system RNG fails
+ */
+int dntl_sign(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+              const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+              uint32_t *sig, uint8_t *u);
+
+/**
+ * One sign attempt from given randomness (deterministic)
+ *
+ * u = SHAKE256(r1 || PK_C || pk), SC = SHAKE256(u || m || pk).
+ *
+ * @param r1        seed_bytes random bytes
+ * @return          0 on success, 1 if sig has a zero coefficient (stopping
+ *                  early as in dntl_keygen_from_seeds())
+ */
+int dntl_sign_from_seed(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                        const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                        const uint8_t *r1, uint32_t *sig, uint8_t *u);
+
+/**
+ * Verify a signature (verify)
+ *
+ * @return          1 if the signature is valid, 0 otherwise (including
+ *                  coefficients of pk or sig outside [0, q])
+ */
+int dntl_verify(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                const uint8_t *pk_seed, const uint32_t *pk,
+                const uint32_t *sig, const uint8_t *u);
+
+// ============================================================================
+// SHORT SECRET KEYS
+// ============================================================================
+//
+// keyGen's SHORT_KEY loop from a seed: coefficients from
+// gaussian_select_from_set(), candidates redrawn until int(||x||) and
+// int(||x - mu||) are within their bounds. Both squared norms are summed while
+// the coefficients are drawn and a candidate stops at the first coefficient
+// that takes one over its bound, so rejected candidates cost only their
+// prefix. Coefficients are drawn without branches; only where a rejected
+// candidate stops depends on its values.
+
+// Most allowed values, and the largest one
+#define DNTL_MAX_ALLOWED 16
+#define DNTL_MAX_ALLOWED_VALUE 65535
+
+// Candidates dntl_sample_short_key() draws before giving up
+#define DNTL_SHORT_KEY_TRIES (1u << 20)
+
+/**
+ * Sample a short secret key from a seed (deterministic)
+ *
+ * Each coefficient is N(mu, sigma) rounded to the nearest allowed value, ties
+ * going to the smaller one, drawn from one 64-bit word. Candidate t reads its
+ * n words (little endian) from SHAKE256("DNTL-DSA short key" || seed || t as
+ * 4 bytes little endian).
+ *
+ * @param seed, seed_len    Seed (any length)
+ * @param n                 Coefficients, 1 .. DNTL_MAX_N
+ * @param allowed, count    1 .. DNTL_MAX_ALLOWED increasing values, none above
+ *                          DNTL_MAX_ALLOWED_VALUE (as allowed_values, sorted)
+ * @param max_norm          Bound on int(||out||)
+ * @param max_mapped_norm   Bound on int(||out - mu||)
+ * @param out               Output key, n values
+ * @return                  0, or -1 if the arguments are invalid, SHAKE-256
+ *                          fails or DNTL_SHORT_KEY_TRIES candidates were all
+ *                          rejected
+ */
+int dntl_sample_short_key(const uint8_t *seed, size_t seed_len, size_t n, uint32_t mu,
+                          double sigma, const uint32_t *allowed, size_t count,
+                          uint32_t max_norm, uint32_t max_mapped_norm, uint32_t *out);
+
+// ============================================================================
+// COMPILED BASES
+// ============================================================================
+//
+// sampleMatrixISISL2() returns K instances of up to N rows each, and every
+// operation multiplies its vector by all rows of an instance in turn before
+// the transition. Pointwise products are associative, so an instance is fully
+// described by the product of its rows: a compiled basis holds those K
+// products, and applying it costs one multiplication and one transition per
+// instance. keyGen and sign compile instance by instance, so an early abort
+// (see dntl_keygen_from_seeds()) skips the remaining instances.
+
+/**
+ * Compiled public basis of one seed
+ *
+ * products[i] is the product of instance i's rows in natural NTT order,
+ * canonical values in [1, q) (rows never contain zeros).
+ */
+typedef struct {
+    int level;
+    dntl_sampler_t sampler;
+    uint32_t products[DNTL_MAX_K][DNTL_MAX_N] __attribute__((aligned(64)));
+} dntl_basis_t;
+
+/**
+ * Sample and fold the basis of a seed (PK_C or SC)
+ *
+ * @param seed      seed_bytes bytes
+ * @param basis     Output
+ * @return          0, or -1 if SHAKE-256 fails (DNTL_SAMPLER_SHAKE256)
+ */
+int dntl_basis_compile(const dntl_ctx_t *ctx, const uint8_t *seed, dntl_basis_t *basis);
+
+/**
+ * Push a vector through the K instances of a compiled basis
+ *
+ * @param poly      n values in [0, q], replaced by the result in [1, q]
+ * @return          0, or -1 if basis belongs to another level or sampler or
+ *                  poly has values outside [0, q] (poly is then unchanged)
+ */
+int dntl_basis_apply(const dntl_ctx_t *ctx, const dntl_basis_t *basis, uint32_t *poly);
+
+// ============================================================================
+// PUBLIC-BASIS CACHE
+// ============================================================================
+//
+// verify expands two bases: one from the per-signature seed SC and one from
+// PK_C, which only depends on the public key. A cache keeps the second one
+// for keys that are verified repeatedly, so a hit only pays for the signature
+// side. Entries hold the compiled basis (K * N coefficients) and are evicted least recently used first. The cache never holds more than
+// max_bytes, index included. It is internally locked and may be shared
+// between threads.
+
+typedef struct dntl_basis_cache dntl_basis_cache_t;
+
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    size_t entries;         // keys currently held
+    size_t capacity;        // keys that fit in max_bytes
+    size_t bytes;           // memory currently held, index included
+    size_t max_bytes;
+} dntl_basis_cache_stats_t;
+
+/**
+ * Memory taken by one cached key of a level, for sizing max_bytes
+ */
+size_t dntl_basis_cache_entry_bytes(const dntl_ctx_t *ctx);
+
+/**
+ * Create a cache for keys of ctx's level
+ *
+ * @param ctx       Context (must outlive the cache)
+ * @param max_bytes Memory budget
+ * @return          New cache, or NULL if max_bytes cannot hold a single key or
+ *                  allocation fails
+ */
+dntl_basis_cache_t *dntl_basis_cache_create(const dntl_ctx_t *ctx, size_t max_bytes);
+
+/**
+ * dntl_basis_cache_create() with the entries in one pool from alloc
+ *
+ * The pool holds the whole capacity (entries rounded up to 64 bytes) and is
+ * touched as keys are added. &dntl_allocator_huge puts it on 2 MB pages,
+ * which a cache of many keys read at random needs far fewer TLB entries for;
+ * reserved huge pages are taken for the whole pool up front. The cache is
+ * written on every miss, so it is not replicated: on a NUMA machine, create
+ * one per node (node = dntl_numa_node() of the threads using it).
+ *
+ * @param alloc     Pool allocator (dntl_alloc.h), or NULL for entries
+ *                  allocated one by one
+ * @param node      NUMA node for the pool, or -1
+ */
+dntl_basis_cache_t *dntl_basis_cache_create_alloc(const dntl_ctx_t *ctx, size_t max_bytes,
+                                                  const dntl_allocator_t *alloc, int node);
+
+/**
+ * Free a cache (NULL is ignored)
+ */
+void dntl_basis_cache_destroy(dntl_basis_cache_t *cache);
+
+/**
+ * Snapshot of the counters
+ */
+void dntl_basis_cache_stats(dntl_basis_cache_t *cache, dntl_basis_cache_stats_t *stats);
+
+/**
+ * dntl_verify() with the PK_C basis taken from (or added to) the cache
+ *
+ * Same result as dntl_verify() on the cache's context.
+ */
+int dntl_verify_cached(dntl_basis_cache_t *cache, const uint8_t *m, size_t m_len,
+                       const uint8_t *pk_seed, const uint32_t *pk,
+                       const uint32_t *sig, const uint8_t *u);
+
+// ============================================================================
+// SPECULATIVE SIGNING
+// ============================================================================
+//
+// sign retries with a fresh r1 until the signature has no zero coefficient,
+// so its latency grows with the number of rejections. Speculative signing
+// evaluates M candidates r1_0 .. r1_{M-1} at once on a worker pool and keeps
+// the accepted candidate with the lowest index, not the first to finish.
+// Candidates are independent, so this is the signature the sequential loop
+// would have produced from the same r1 sequence, and the output distribution
+// is unchanged. Candidates above an accepted index are skipped.
+
+// A pool is a scheduler (dntl_sched.h): dntl_sched_default() is the shared one
+typedef dntl_sched_t dntl_sign_pool_t;
+
+// Most candidates per batch
+#define DNTL_MAX_CANDIDATES 64
+
+/**
+ * Start a private scheduler with `threads` workers
+ *
+ * The calling thread also evaluates candidates, so `threads` workers give
+ * threads + 1 candidates in flight. Batches from concurrent callers share
+ * the workers. dntl_verify_batch() and dntl_verify_parallel() run on the
+ * same pools, and any scheduler (such as dntl_sched_default()) can be
+ * passed where a pool is expected.
+ *
+ * @return          New pool, or NULL if threads are unavailable
+ */
+dntl_sign_pool_t *dntl_sign_pool_create(size_t threads);
+
+/**
+ * Stop and free a pool (NULL is ignored)
+ */
+void dntl_sign_pool_destroy(dntl_sign_pool_t *pool);
+
+/**
+ * Evaluate sign candidates from given r1 values (deterministic)
+ *
+ * @param pool      Worker pool, or NULL to evaluate in the calling thread
+ * @param r1s       count * seed_bytes bytes, candidate i at i * seed_bytes
+ * @param count     Number of candidates, 1 .. DNTL_MAX_CANDIDATES
+ * @param sig, u    Output of the lowest accepted candidate
+ * @return          Index of that candidate, count if all were rejected, or
+ *                  -1 on error
+ */
+int dntl_sign_candidates(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                         const uint8_t *m, size_t m_len,
+                         const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                         const uint8_t *r1s, size_t count, uint32_t *sig, uint8_t *u);
+
+/**
+ * dntl_sign() evaluating `candidates` fresh r1 values per round
+ *
+ * @param candidates    Candidates per round (M), 1 .. DNTL_MAX_CANDIDATES;
+ *                      1 is the sequential dntl_sign()
+ * @return              0 on success, -1 if the system RNG fails or the
+ *                      arguments are invalid
+ */
+int dntl_sign_speculative(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                          const uint8_t *m, size_t m_len,
+                          const uint32_t *sk, const uint8_t *pk_seed, const uint32_t *pk,
+                          size_t candidates, uint32_t *sig, uint8_t *u);
+
+// ============================================================================
+// BATCH KEY GENERATION
+// ============================================================================
+//
+// dntl_keygen_batch() generates keys first .. first + count - 1 of a seed.
+// Key i draws all of its randomness from
+//
+//   SHAKE256("DNTL-DSA keygen batch" || seed || i as 8 bytes little-endian)
+//
+// in the order dntl_keygen() draws from the system RNG, so a key depends on
+// the seed and its index only: any thread count, shard size or split of the
+// range gives the same bytes. Shards of DNTL_KEYGEN_SHARD keys run on the
+// scheduler, and each window of shards is written out in index order.
+//
+// A record is the packed public key (dntl_wire.h, DNTL_WIRE_PK) followed by
+// the packed secret key (DNTL_WIRE_SK); both parse on their own, so a stream
+// of records is read back with dntl_wire_parse() on each in turn.
+//
+// The seed is as secret as every key derived from it.
+
+// Keys per scheduler task
+#define DNTL_KEYGEN_SHARD 16
+
+/**
+ * Counts of a batch; attempts and rejects are summed over its keys
+ */
+typedef struct {
+    uint64_t keys;              // records written
+    uint64_t bytes;             // bytes written
+    uint64_t attempts;          // dntl_keygen_from_seeds() calls
+    uint64_t pk_rejects;        // attempts with a zero in pk
+    uint64_t secret_rejects;    // secret candidates over a norm bound
+    uint64_t secret_redraws;    // secrets replaced after repeated pk rejects
+    double seconds;             // wall time of the call
+} dntl_keygen_stats_t;
+
+/**
+ * Where records go: len bytes at buf, 0 or -1 to stop the batch
+ *
+ * Called from the thread that called dntl_keygen_batch(), in index order.
+ */
+typedef int (*dntl_keygen_sink_t)(void *user, const uint8_t *buf, size_t len);
+
+/**
+ * A sink writing to the file descriptor user points to (an int): a file, a
+ * pipe or a connected socket
+ */
+int dntl_keygen_sink_fd(void *user, const uint8_t *buf, size_t len);
+
+/**
+ * Generate count keys of a seed and stream their records to a sink
+ *
+ * @param sched     Scheduler to spread shards on (dntl_sched_default() for
+ *                  every core), or NULL to generate in the calling thread
+ * @param seed      seed_len bytes, at least one
+ * @param first     Index of the first key
+ * @param stats     Out: counts of the batch, or NULL; filled on failure too
+ * @return          0, or -1 for invalid arguments, no memory, or a sink
+ *                  error (records before the failing window were written)
+ */
+int dntl_keygen_batch(dntl_sched_t *sched, const dntl_ctx_t *ctx,
+                      const uint8_t *seed, size_t seed_len, uint64_t first, uint64_t count,
+                      dntl_keygen_sink_t sink, void *user, dntl_keygen_stats_t *stats);
+
+// ============================================================================
+// BATCH VERIFICATION
+// ============================================================================
+
+/**
+ * One signature to check with dntl_verify_batch() or a dntl_verifier_t
+ */
+typedef struct {
+    const uint8_t *m;
+    size_t m_len;
+    const uint8_t *pk_seed;
+    const uint32_t *pk;
+    const uint32_t *sig;
+    const uint8_t *u;
+} dntl_verify_item_t;
+
+/**
+ * Verify many signatures
+ *
+ * Items are grouped by pk_seed and each distinct public basis is expanded
+ * once for the whole batch; the basis expansions and the per-item work
+ * (SC, signature side, comparison) run on the pool. Needs one dntl_basis_t
+ * of scratch memory per distinct key.
+ *
+ * On a pool with workers on several NUMA nodes (dntl_sched.h), each key is
+ * given to one node, balancing the items: that node's workers expand its
+ * basis into memory placed on the node and check every item under it.
+ *
+ * @param pool      Worker pool, or NULL to verify in the calling thread
+ * @param results   n results, 1 if item i is valid and 0 otherwise (same as
+ *                  dntl_verify())
+ * @return          0, or -1 if memory runs out or SHAKE-256 fails (results
+ *                  are then undefined)
+ */
+int dntl_verify_batch(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                      const dntl_verify_item_t *items, size_t n, int *results);
+
+// ============================================================================
+// OFFLOADED BATCH VERIFICATION
+// ============================================================================
+//
+// dntl_verify_batch_offload() is a hook: it hands the basis work of a batch
+// (both sides of every signature, which dominates verification) to a
+// caller-supplied backend and keeps the rest on the host. No backend ships
+// with the library; the hook only fixes the interface and the overlap an
+// out-of-tree one (a GPU, say) would plug into:
+//
+//   1. the distinct public bases are compiled on the pool and bound to the
+//      backend once per batch; a backend may keep them resident between
+//      batches, keyed by seed, and skip uploading those it holds
+//   2. signatures go in chunks of up to DNTL_VERIFY_CHUNK: the host checks
+//      and hashes chunk c + 1 on the pool while the backend works on chunk
+//      c, and starts it before waiting for c, so a backend can overlap one
+//      chunk's transfers with the other's kernels
+//   3. the host compares the sides and writes the results
+//
+// Without a backend, if bind fails, or for any chunk the backend fails, the
+// work runs on the pool as in dntl_verify_batch(). Results are always those
+// of dntl_verify().
+
+// Signatures per backend chunk
+#define DNTL_VERIFY_CHUNK 1024
+
+/**
+ * Signatures of a chunk, prepared for a backend
+ *
+ * Slot i is to be processed if live[i] is nonzero: lhs + i * n (the loaded
+ * pk) through the basis of the seed at sc + i * seed_bytes, and rhs + i * n
+ * (the loaded signature) through bound basis key[i], each left as
+ * dntl_basis_apply() leaves it. Other slots are not read.
+ */
+typedef struct {
+    const uint8_t *sc;
+    uint32_t *lhs;
+    uint32_t *rhs;
+    const uint32_t *key;
+    const uint8_t *live;
+    size_t count;
+} dntl_verify_chunk_t;
+
+/**
+ * A basis backend; every call returns 0, or -1 to hand the work back
+ *
+ * bind gets the batch's public bases, seeds[k] compiled into bases[k], which
+ * stay valid until unbind. start begins a chunk and may return before it is
+ * done; finish waits for it (a chunk start fails is not finished). At most
+ * two chunks are started and not finished, and the host does not touch their buffers until finish
+ * returns. Every call comes from the thread calling
+ * dntl_verify_batch_offload(), and unbind follows every successful bind.
+ */
+typedef struct dntl_verify_backend {
+    int (*bind)(void *user, const dntl_ctx_t *ctx, const uint8_t *const *seeds,
+                const dntl_basis_t *bases, size_t keys);
+    int (*start)(void *user, const dntl_verify_chunk_t *chunk);
+    int (*finish)(void *user, const dntl_verify_chunk_t *chunk);
+    void (*unbind)(void *user);
+    void *user;
+} dntl_verify_backend_t;
+
+/**
+ * dntl_verify_batch() with the bases applied by a backend
+ *
+ * @param backend   Backend, or NULL for dntl_verify_batch()
+ * @param pool      Worker pool for the host work, or NULL for the calling
+ *                  thread
+ * @return          0, or -1 if memory runs out or SHAKE-256 fails (results
+ *                  are then undefined)
+ */
+int dntl_verify_batch_offload(const dntl_verify_backend_t *backend, dntl_sign_pool_t *pool,
+                              const dntl_ctx_t *ctx, const dntl_verify_item_t *items,
+                              size_t n, int *results);
+
+// ============================================================================
+// TWO-SIDED VERIFICATION
+// ============================================================================
+
+/**
+ * dntl_verify() with the two sides on separate threads
+ *
+ * lhs (pk through the SC basis) and rhs (sig through the public basis) are
+ * independent until the final comparison, so one side runs on a pool worker
+ * while the caller runs the other. Single-signature latency drops to about
+ * one side; throughput does not improve.
+ *
+ * @param pool      Worker pool, or NULL for dntl_verify()
+ * @return          Same as dntl_verify()
+ */
+int dntl_verify_parallel(dntl_sign_pool_t *pool, const dntl_ctx_t *ctx,
+                         const uint8_t *m, size_t m_len,
+                         const uint8_t *pk_seed, const uint32_t *pk,
+                         const uint32_t *sig, const uint8_t *u);
+
+// ============================================================================
+// PIPELINED VERIFICATION
+// ============================================================================
+//
+// A verifier takes a stream of signatures and runs each through three
+// stages on a scheduler, with at most `depth` in flight:
+//
+//   1. hash: range and zero-pattern checks, then SC = SHAKE256(u || m || pk),
+//      four signatures per 4-way Keccak when their messages have equal
+//      lengths. Signatures failing the checks skip stage 2.
+//   2. basis: both bases applied (the PK_C one from the cache, if given).
+//      Signatures are spread over every worker.
+//   3. compare, then report: the callback, or the poll queue.
+//
+// Stages 1 and 3 each run on one thread at a time and take whatever has
+// queued up, so batches grow with the load. Results match dntl_verify().
+//
+// Usage:
+//
+//   dntl_verifier_t *v = dntl_verifier_create(ctx, cache, dntl_sched_default(), 64);
+//   for each signature:
+//       while (dntl_verifier_submit(v, &item, NULL, tag) == 1) {
+//           dntl_verifier_wait(v);
+//           n = dntl_verifier_poll(v, results, 64);    // (tag, valid) pairs
+//       }
+//   dntl_verifier_drain(v);                            // then poll the rest
+//   dntl_verifier_destroy(v);
+
+typedef struct dntl_verifier dntl_verifier_t;
+
+/**
+ * Completion callback: valid is dntl_verify()'s result. Called from a
+ * scheduler thread (or one waiting in dntl_verifier_wait/drain), one call at
+ * a time per verifier; it must not wait on the verifier.
+ */
+typedef void (*dntl_verify_done_t)(void *user, int valid);
+
+/**
+ * A completion without callback, from dntl_verifier_poll()
+ */
+typedef struct {
+    void *user;
+    int valid;
+} dntl_verify_result_t;
+
+/**
+ * Start a verifier
+ *
+ * Stages are queued for the workers of the node holding the cache's pool
+ * (dntl_basis_cache_create_alloc()), so one cache and one verifier per node,
+ * with requests routed by key, keep every cached basis read local.
+ *
+ * @param cache     PK_C basis cache of ctx, or NULL to expand every basis
+ * @param sched     Scheduler the stages run on; NULL (or one without
+ *                  workers) runs them in dntl_verifier_wait/drain()
+ * @param depth     Signatures in flight or awaiting poll, 1 .. 65536
+ * @return          New verifier, or NULL on bad arguments or out of memory
+ */
+dntl_verifier_t *dntl_verifier_create(const dntl_ctx_t *ctx, dntl_basis_cache_t *cache,
+                                      dntl_sched_t *sched, size_t depth);
+
+/**
+ * Drain and free a verifier (NULL is ignored)
+ */
+void dntl_verifier_destroy(dntl_verifier_t *v);
+
+/**
+ * Queue one signature
+ *
+ * The item and the buffers it points to must stay valid until it completes.
+ *
+ * @param done      Callback, or NULL to report through dntl_verifier_poll()
+ * @param user      Passed to done, or returned by poll
+ * @return          0 if queued, 1 if all depth slots are taken (wait, poll
+ *                  and retry)
+ */
+int dntl_verifier_submit(dntl_verifier_t *v, const dntl_verify_item_t *item,
+                         dntl_verify_done_t done, void *user);
+
+/**
+ * Take up to max completions of signatures submitted without a callback
+ *
+ * @return          Number written to out, in completion order
+ */
+size_t dntl_verifier_poll(dntl_verifier_t *v, dntl_verify_result_t *out, size_t max);
+
+/**
+ * Block until a completion awaits poll, or nothing is in flight
+ */
+void dntl_verifier_wait(dntl_verifier_t *v);
+
+/**
+ * Block until every submitted signature has completed
+ */
+void dntl_verifier_drain(dntl_verifier_t *v);
+
+#endif // DNTL_DSA_H
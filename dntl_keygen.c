@@ -0,0 +1,200 @@
+/**
+ * Batch key generation: dntl_keygen_batch() over every core, streaming the
+ * packed records (dntl_dsa.h, BATCH KEY GENERATION) to a file, stdout or a
+ * TCP connection
+ *
+ * Usage: dntl_keygen [-l level] [-n count] [-f first] [-s seed_hex] [-t threads]
+ *                    [-x] [-o path | - | tcp:host:port]
+ *
+ * Keys first .. first + count - 1 of the seed are generated; the same seed
+ * and indices give the same bytes on any machine and thread count, so a
+ * range can be split across hosts with -f and -n. Without -s a random seed
+ * is drawn and printed. -x uses DNTL_SAMPLER_SHAKE256 for the basis. Without
+ * -o the records are generated and dropped, which measures throughput.
+ *
+ * keys/s and the rejection counts go to stderr.
+ *
+ * Build: make -f Makefile.dntl dntl_keygen
+ */
+
+#include "dntl_dsa.h"
+#include "dntl_sched.h"
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MAX_SEED_BYTES 64
+
+static int discard_sink(void *user, const uint8_t *buf, size_t len) {
+    (void)user;
+    (void)buf;
+    (void)len;
+    return 0;
+}
+
+static int parse_hex(const char *hex, uint8_t *out, size_t *len) {
+    const size_t digits = strlen(hex);
+    if (digits == 0 || digits % 2 || digits / 2 > MAX_SEED_BYTES) {
+        return -1;
+    }
+    for (size_t i = 0; i < digits / 2; i++) {
+        char byte[3] = { hex[2 * i], hex[2 * i + 1], 0 };
+        char *end;
+        out[i] = (uint8_t)strtoul(byte, &end, 16);
+        if (*end) {
+            return -1;
+        }
+    }
+    *len = digits / 2;
+    return 0;
+}
+
+// Connected socket to "host:port", or -1
+static int tcp_connect(const char *target) {
+    char host[256];
+    const char *colon = strrchr(target, ':');
+    if (!colon || (size_t)(colon - target) >= sizeof(host)) {
+        return -1;
+    }
+    memcpy(host, target, (size_t)(colon - target));
+    host[colon - target] = 0;
+
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, *res;
+    if (getaddrinfo(host, colon + 1, &hints, &res) != 0) {
+        return -1;
+    }
+    int fd = -1;
+    for (struct addrinfo *a = res; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+// Output descriptor for -o, or -1
+static int open_output(const char *out) {
+    if (strcmp(out, "-") == 0) {
+        return STDOUT_FILENO;
+    }
+    if (strncmp(out, "tcp:", 4) == 0) {
+        return tcp_connect(out + 4);
+    }
+    return open(out, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+}
+
+int main(int argc, char **argv) {
+    int level = 1, shake = 0;
+    uint64_t count = 1000, first = 0;
+    long threads = -1;
+    const char *seed_hex = NULL, *out = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-l") == 0) {
+            level = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) {
+            count = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "-f") == 0) {
+            first = strtoull(argv[++i], NULL, 10);
+        } else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) {
+            seed_hex = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) {
+            threads = atol(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "-o") == 0) {
+            out = argv[++i];
+        } else if (strcmp(argv[i], "-x") == 0) {
+            shake = 1;
+        } else {
+            fprintf(stderr, "usage: %s [-l level] [-n count] [-f first] [-s seed_hex] "
+                    "[-t threads] [-x] [-o path | - | tcp:host:port]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    uint8_t seed[MAX_SEED_BYTES];
+    size_t seed_len = 32;
+    if (seed_hex) {
+        if (parse_hex(seed_hex, seed, &seed_len) != 0) {
+            fprintf(stderr, "seed must be 1 to %d bytes of hex\n", MAX_SEED_BYTES);
+            return 2;
+        }
+    } else {
+        if (getrandom(seed, seed_len, 0) != (ssize_t)seed_len) {
+            fprintf(stderr, "system RNG failed\n");
+            return 1;
+        }
+        fprintf(stderr, "seed: ");
+        for (size_t i = 0; i < seed_len; i++) {
+            fprintf(stderr, "%02x", seed[i]);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    dntl_ctx_t *ctx = dntl_ctx_create_sampler(level, shake ? DNTL_SAMPLER_SHAKE256
+                                                           : DNTL_SAMPLER_MT19937);
+    if (!ctx) {
+        fprintf(stderr, "unknown level %d\n", level);
+        return 2;
+    }
+
+    // -t counts the calling thread, which takes shards too
+    dntl_sched_t *own = NULL, *sched = dntl_sched_default();
+    if (threads >= 1) {
+        own = threads > 1 ? dntl_sched_create((size_t)threads - 1, 0) : NULL;
+        sched = own;
+        if (threads > 1 && !own) {
+            fprintf(stderr, "cannot start %ld threads\n", threads);
+            dntl_ctx_destroy(ctx);
+            return 1;
+        }
+    }
+
+    int fd = -1;
+    if (out) {
+        fd = open_output(out);
+        if (fd < 0) {
+            fprintf(stderr, "cannot open %s\n", out);
+            dntl_sched_destroy(own);
+            dntl_ctx_destroy(ctx);
+            return 1;
+        }
+        // A closed connection fails the write instead of killing the process
+        signal(SIGPIPE, SIG_IGN);
+    }
+
+    dntl_keygen_stats_t st;
+    int ret = dntl_keygen_batch(sched, ctx, seed, seed_len, first, count,
+                                out ? dntl_keygen_sink_fd : discard_sink, &fd, &st);
+    if (ret != 0) {
+        fprintf(stderr, "key generation stopped: %s\n",
+                out ? "write failed" : "out of memory");
+    }
+    if (fd >= 0 && fd != STDOUT_FILENO && close(fd) != 0) {
+        ret = -1;
+    }
+
+    const double keys = st.keys ? (double)st.keys : 1.0;
+    fprintf(stderr, "level %d: %llu keys, %llu bytes in %.3f s on %zu threads: %.0f keys/s\n",
+            level, (unsigned long long)st.keys, (unsigned long long)st.bytes, st.seconds,
+            (sched ? dntl_sched_workers(sched) : 0) + 1,
+            st.seconds > 0 ? (double)st.keys / st.seconds : 0.0);
+    fprintf(stderr, "attempts %llu (%.3f per key), pk rejects %llu, secret rejects %llu "
+            "(%.3f per key), secret redraws %llu\n",
+            (unsigned long long)st.attempts, (double)st.attempts / keys,
+            (unsigned long long)st.pk_rejects, (unsigned long long)st.secret_rejects,
+            (double)st.secret_rejects / keys, (unsigned long long)st.secret_redraws);
+
+    dntl_sched_destroy(own);
+    dntl_ctx_destroy(ctx);
+    memset(seed, 0, sizeof(seed));
+    return ret == 0 ? 0 : 1;
+}
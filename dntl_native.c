@@ -0,0 +1,911 @@
+/**
+ * dntl_native: CPython bindings for the DNTL-DSA engine (dntl_dsa.h)
+ *
+ * Same call shapes as keyGen / sign / verify in dntl-dsa-nat.py, with the
+ * security level (the -c option) as first argument:
+ *
+ *   import dntl_native
+ *   sk, pk, pk_seed = dntl_native.keygen(1)
+ *   sig, u = dntl_native.sign(1, m, sk, pk_seed, pk)
+ *   ok = dntl_native.verify(1, m, pk_seed, pk, sig, u)      # True / False
+ *
+ * Vectors are returned as lists of ints; any sequence of ints (including
+ * numpy arrays) is accepted as input. keygen_from_seeds and the optional r1
+ * of sign expose the deterministic variants for cross-checking against the
+ * Python reference. The GIL is released while the engine runs.
+ *
+ * verify keeps the expanded public basis of recently seen keys in a
+ * per-level LRU cache (DEFAULT_CACHE_BYTES each), resized or disabled with
+ * set_basis_cache(level, max_bytes) and inspected with basis_cache_stats().
+ *
+ * sign(..., None, candidates) signs speculatively: each round evaluates that
+ * many r1 candidates on the shared scheduler (dntl_sched.h: one worker per
+ * online CPU minus the caller, or DNTL_WORKERS) and keeps the first accepted
+ * one in draw order. verify_batch(level, items) checks a list of (m,
+ * pk_seed, pk, sig, u) on the same workers, expanding each distinct public
+ * basis once; keygen_batch(level, count) and sign_batch(level, items) (items
+ * of (m, sk, pk_seed, pk)) generate keys and signatures on them, one per
+ * task, with the results of keygen and sign. With the cache disabled, verify runs its two sides in
+ * parallel. set_workers(count, pin=False) resizes the scheduler and workers()
+ * reports it.
+ *
+ * sample_short_key(seed, n, sigma, allowed, max_norm, max_mapped_norm[, mu])
+ * is keyGen's SHORT_KEY loop (gaussian_select_from_set() with mu = 3 by
+ * default, and both norm bounds), deterministic in seed.
+ *
+ * set_sampler("shake256") switches later calls to the SHAKE-256 basis
+ * sampler (dntl-dsa-nat.py --sampler shake256); each sampler has its own
+ * contexts and caches.
+ *
+ * pack(kind, level, coeffs[, seed[, coded]]) and unpack(data) convert
+ * public keys, signatures and secret keys to and from the wire format
+ * (dntl_wire.h: one byte per coefficient behind a version byte and the
+ * seed), and verify_packed(m, pk_bytes, sig_bytes) verifies encodings
+ * without unpacking them.
+ *
+ * stats() returns the hot-path stage timers and counters (dntl_stats.h) of
+ * a module built with `make -f Makefile.dntl STATS=1`, for export to a
+ * metrics system; stats_reset() zeroes them.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdatomic.h>
+#include "dntl_dsa.h"
+#include "dntl_wire.h"
+#include "dntl_sched_py.h"
+#include "dntl_stats_py.h"
+
+// Per-level public-basis cache budget until set_basis_cache() is called
+#define DEFAULT_CACHE_BYTES ((size_t)8 << 20)
+
+// One context and cache per level and sampler (slot = level + 6 * sampler),
+// created on first use (under the GIL)
+#define SLOTS 12
+static dntl_ctx_t *contexts[SLOTS];
+static dntl_basis_cache_t *caches[SLOTS];
+static int cache_configured[SLOTS];
+static int verify_in_flight[SLOTS];   // verifies running without the GIL
+static dntl_sampler_t sampler = DNTL_SAMPLER_MT19937;
+
+static const dntl_ctx_t *get_ctx(int level) {
+    if (level < 0 || level > 5 || !dntl_params(level)) {
+        PyErr_Format(PyExc_ValueError, "unknown security level %d (expected 1, 3 or 5)", level);
+        return NULL;
+    }
+    int slot = level + 6 * (int)sampler;
+    if (!contexts[slot]) {
+        contexts[slot] = dntl_ctx_create_sampler(level, sampler);
+        if (!contexts[slot]) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+    }
+    return contexts[slot];
+}
+
+// Slot of the context get_ctx() returns
+static int get_slot(int level) {
+    return level + 6 * (int)sampler;
+}
+
+// ============================================================================
+// CONVERSIONS
+// ============================================================================
+
+static int load_vector(PyObject *obj, uint32_t *out, size_t n, const char *name) {
+    PyObject *seq = PySequence_Fast(obj, "expected a sequence of ints");
+    if (!seq) {
+        return -1;
+    }
+    if ((size_t)PySequence_Fast_GET_SIZE(seq) != n) {
+        PyErr_Format(PyExc_ValueError, "%s must have %zu coefficients", name, n);
+        Py_DECREF(seq);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        // numpy integers go through __index__
+        PyObject *item = PyNumber_Index(PySequence_Fast_GET_ITEM(seq, i));
+        unsigned long v = item ? PyLong_AsUnsignedLong(item) : 0;
+        Py_XDECREF(item);
+        if (PyErr_Occurred() || v > UINT32_MAX) {
+            if (!PyErr_Occurred()) {
+                PyErr_Format(PyExc_OverflowError, "%s coefficient out of range", name);
+            }
+            Py_DECREF(seq);
+            return -1;
+        }
+        out[i] = (uint32_t)v;
+    }
+    Py_DECREF(seq);
+    return 0;
+}
+
+static int check_seed(const Py_buffer *buf, size_t len, const char *name) {
+    if ((size_t)buf->len != len) {
+        PyErr_Format(PyExc_ValueError, "%s must be %zu bytes", name, len);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *vector_to_list(const uint32_t *v, size_t n) {
+    PyObject *list = PyList_New((Py_ssize_t)n);
+    if (!list) {
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        PyObject *item = PyLong_FromUnsignedLong(v[i]);
+        if (!item) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    return list;
+}
+
+static PyObject *engine_error(void) {
+    PyErr_SetString(PyExc_RuntimeError, "DNTL engine failure (system RNG or SHAKE-256)");
+    return NULL;
+}
+
+// ============================================================================
+// MODULE FUNCTIONS
+// ============================================================================
+
+static PyObject *py_keygen(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    if (!PyArg_ParseTuple(args, "i", &level)) {
+        return NULL;
+    }
+    const dntl_ctx_t *ctx = get_ctx(level);
+    if (!ctx) {
+        return NULL;
+    }
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES];
+    int ret;
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = dntl_keygen(ctx, sk, pk, pk_seed);
+    Py_END_ALLOW_THREADS
+    if (ret != 0) {
+        return engine_error();
+    }
+    return Py_BuildValue("(NNy#)", vector_to_list(sk, p->n), vector_to_list(pk, p->n),
+                         (const char *)pk_seed, (Py_ssize_t)p->seed_bytes);
+}
+
+static PyObject *py_keygen_from_seeds(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    PyObject *sk_obj;
+    Py_buffer r1, r2, r3;
+    if (!PyArg_ParseTuple(args, "iOy*y*y*", &level, &sk_obj, &r1, &r2, &r3)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    const dntl_ctx_t *ctx = get_ctx(level);
+    const dntl_params_t *p = ctx ? dntl_ctx_params(ctx) : NULL;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES];
+    int ret;
+
+    if (!ctx || load_vector(sk_obj, sk, p->n, "sk") != 0 ||
+        check_seed(&r1, p->seed_bytes, "r1") != 0 || check_seed(&r2, p->seed_bytes, "r2") != 0 ||
+        check_seed(&r3, p->seed_bytes, "r3") != 0) {
+        goto done;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = dntl_keygen_from_seeds(ctx, sk, r1.buf, r2.buf, r3.buf, pk, pk_seed);
+    Py_END_ALLOW_THREADS
+    if (ret < 0) {
+        engine_error();
+    } else if (ret > 0) {
+        result = Py_NewRef(Py_None);
+    } else {
+        result = Py_BuildValue("(Ny#)", vector_to_list(pk, p->n),
+                               (const char *)pk_seed, (Py_ssize_t)p->seed_bytes);
+    }
+
+done:
+    PyBuffer_Release(&r1);
+    PyBuffer_Release(&r2);
+    PyBuffer_Release(&r3);
+    return result;
+}
+
+static PyObject *py_sample_short_key(PyObject *self, PyObject *args) {
+    (void)self;
+    Py_buffer seed;
+    Py_ssize_t n;
+    double sigma;
+    PyObject *allowed_obj;
+    unsigned int max_norm, max_mapped_norm, mu = 3;
+    if (!PyArg_ParseTuple(args, "y*ndOII|I", &seed, &n, &sigma, &allowed_obj, &max_norm,
+                          &max_mapped_norm, &mu)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    uint32_t allowed[DNTL_MAX_ALLOWED], sk[DNTL_MAX_N];
+    int ret;
+
+    Py_ssize_t count = PySequence_Size(allowed_obj);
+    if (count < 0) {
+        goto done;
+    }
+    if (n < 1 || n > DNTL_MAX_N || count < 1 || count > DNTL_MAX_ALLOWED) {
+        PyErr_Format(PyExc_ValueError, "need 1 <= n <= %d and 1 to %d allowed values",
+                     DNTL_MAX_N, DNTL_MAX_ALLOWED);
+        goto done;
+    }
+    if (load_vector(allowed_obj, allowed, (size_t)count, "allowed") != 0) {
+        goto done;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = dntl_sample_short_key(seed.buf, (size_t)seed.len, (size_t)n, mu, sigma, allowed,
+                                (size_t)count, max_norm, max_mapped_norm, sk);
+    Py_END_ALLOW_THREADS
+    if (ret != 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "no short key: allowed values must increase and be at most 65535, "
+                        "sigma positive and the bounds reachable");
+    } else {
+        result = vector_to_list(sk, (size_t)n);
+    }
+
+done:
+    PyBuffer_Release(&seed);
+    return result;
+}
+
+static PyObject *py_sign(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    Py_buffer m, pk_seed, r1 = { 0 };
+    PyObject *sk_obj, *pk_obj, *r1_obj = NULL;
+    Py_ssize_t candidates = 1;
+    if (!PyArg_ParseTuple(args, "iy*Oy*O|On", &level, &m, &sk_obj, &pk_seed, &pk_obj, &r1_obj,
+                          &candidates)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    const dntl_ctx_t *ctx = get_ctx(level);
+    const dntl_params_t *p = ctx ? dntl_ctx_params(ctx) : NULL;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t u[DNTL_MAX_SEED_BYTES];
+    int ret;
+
+    if (!ctx || load_vector(sk_obj, sk, p->n, "sk") != 0 ||
+        load_vector(pk_obj, pk, p->n, "pk") != 0 ||
+        check_seed(&pk_seed, p->seed_bytes, "pk_seed") != 0) {
+        goto done;
+    }
+    if (r1_obj && r1_obj != Py_None) {
+        if (PyObject_GetBuffer(r1_obj, &r1, PyBUF_SIMPLE) != 0 ||
+            check_seed(&r1, p->seed_bytes, "r1") != 0) {
+            goto done;
+        }
+    }
+    if (candidates < 1 || candidates > DNTL_MAX_CANDIDATES || (r1.buf && candidates != 1)) {
+        PyErr_Format(PyExc_ValueError, "candidates must be 1 .. %d, and 1 with a given r1",
+                     DNTL_MAX_CANDIDATES);
+        goto done;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    if (r1.buf) {
+        ret = dntl_sign_from_seed(ctx, m.buf, (size_t)m.len, sk, pk_seed.buf, pk, r1.buf, sig, u);
+    } else if (candidates > 1) {
+        ret = dntl_sign_speculative(dntl_sched_default(), ctx, m.buf, (size_t)m.len, sk, pk_seed.buf, pk,
+                                    (size_t)candidates, sig, u);
+    } else {
+        ret = dntl_sign(ctx, m.buf, (size_t)m.len, sk, pk_seed.buf, pk, sig, u);
+    }
+    Py_END_ALLOW_THREADS
+    if (ret < 0) {
+        engine_error();
+    } else if (ret > 0) {
+        result = Py_NewRef(Py_None);
+    } else {
+        result = Py_BuildValue("(Ny#)", vector_to_list(sig, p->n),
+                               (const char *)u, (Py_ssize_t)p->seed_bytes);
+    }
+
+done:
+    PyBuffer_Release(&m);
+    PyBuffer_Release(&pk_seed);
+    if (r1.buf) {
+        PyBuffer_Release(&r1);
+    }
+    return result;
+}
+
+static PyObject *py_verify(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    Py_buffer m, pk_seed, u;
+    PyObject *pk_obj, *sig_obj;
+    if (!PyArg_ParseTuple(args, "iy*y*OOy*", &level, &m, &pk_seed, &pk_obj, &sig_obj, &u)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    const dntl_ctx_t *ctx = get_ctx(level);
+    const dntl_params_t *p = ctx ? dntl_ctx_params(ctx) : NULL;
+    uint32_t pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    int ok;
+
+    if (!ctx || load_vector(pk_obj, pk, p->n, "pk") != 0 ||
+        load_vector(sig_obj, sig, p->n, "sig") != 0 ||
+        check_seed(&pk_seed, p->seed_bytes, "pk_seed") != 0 ||
+        check_seed(&u, p->seed_bytes, "u") != 0) {
+        goto done;
+    }
+
+    int slot = get_slot(level);
+    if (!cache_configured[slot]) {
+        caches[slot] = dntl_basis_cache_create(ctx, DEFAULT_CACHE_BYTES);
+        cache_configured[slot] = 1;
+    }
+    dntl_basis_cache_t *cache = caches[slot];
+    // Without a cache both sides are full expansions: run them side by side
+    dntl_sign_pool_t *pool = cache ? NULL : dntl_sched_default();
+    verify_in_flight[slot]++;
+    Py_BEGIN_ALLOW_THREADS
+    if (cache) {
+        ok = dntl_verify_cached(cache, m.buf, (size_t)m.len, pk_seed.buf, pk, sig, u.buf);
+    } else {
+        ok = dntl_verify_parallel(pool, ctx, m.buf, (size_t)m.len, pk_seed.buf, pk, sig, u.buf);
+    }
+    Py_END_ALLOW_THREADS
+    verify_in_flight[slot]--;
+    result = PyBool_FromLong(ok);
+
+done:
+    PyBuffer_Release(&m);
+    PyBuffer_Release(&pk_seed);
+    PyBuffer_Release(&u);
+    return result;
+}
+
+// Copy of one verify_batch item, owned by the batch
+typedef struct {
+    uint8_t *m;
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES];
+    uint8_t u[DNTL_MAX_SEED_BYTES];
+    uint32_t pk[DNTL_MAX_N];
+    uint32_t sig[DNTL_MAX_N];
+} batch_item_t;
+
+static int load_batch_item(PyObject *obj, const dntl_params_t *p, batch_item_t *out,
+                           dntl_verify_item_t *item) {
+    Py_buffer m, pk_seed, u;
+    PyObject *pk_obj, *sig_obj;
+    if (!PyTuple_Check(obj)) {
+        PyErr_SetString(PyExc_TypeError, "items must be (m, pk_seed, pk, sig, u) tuples");
+        return -1;
+    }
+    if (!PyArg_ParseTuple(obj, "y*y*OOy*", &m, &pk_seed, &pk_obj, &sig_obj, &u)) {
+        return -1;
+    }
+    int ret = -1;
+    if (load_vector(pk_obj, out->pk, p->n, "pk") == 0 &&
+        load_vector(sig_obj, out->sig, p->n, "sig") == 0 &&
+        check_seed(&pk_seed, p->seed_bytes, "pk_seed") == 0 &&
+        check_seed(&u, p->seed_bytes, "u") == 0) {
+        out->m = malloc(m.len ? (size_t)m.len : 1);
+        if (!out->m) {
+            PyErr_NoMemory();
+        } else {
+            memcpy(out->m, m.buf, (size_t)m.len);
+            memcpy(out->pk_seed, pk_seed.buf, p->seed_bytes);
+            memcpy(out->u, u.buf, p->seed_bytes);
+            *item = (dntl_verify_item_t){ out->m, (size_t)m.len, out->pk_seed, out->pk,
+                                          out->sig, out->u };
+            ret = 0;
+        }
+    }
+    PyBuffer_Release(&m);
+    PyBuffer_Release(&pk_seed);
+    PyBuffer_Release(&u);
+    return ret;
+}
+
+static PyObject *py_verify_batch(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    PyObject *items_obj;
+    if (!PyArg_ParseTuple(args, "iO", &level, &items_obj)) {
+        return NULL;
+    }
+    const dntl_ctx_t *ctx = get_ctx(level);
+    PyObject *seq = ctx ? PySequence_Fast(items_obj, "items must be a sequence") : NULL;
+    if (!seq) {
+        return NULL;
+    }
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    size_t n = (size_t)PySequence_Fast_GET_SIZE(seq), loaded = 0;
+    batch_item_t *copies = calloc(n ? n : 1, sizeof(*copies));
+    dntl_verify_item_t *items = malloc((n ? n : 1) * sizeof(*items));
+    int *results = malloc((n ? n : 1) * sizeof(*results));
+    PyObject *result = NULL;
+    int ret;
+
+    if (!copies || !items || !results) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (; loaded < n; loaded++) {
+        if (load_batch_item(PySequence_Fast_GET_ITEM(seq, loaded), p, &copies[loaded],
+                            &items[loaded]) != 0) {
+            goto done;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = dntl_verify_batch(dntl_sched_default(), ctx, items, n, results);
+    Py_END_ALLOW_THREADS
+    if (ret != 0) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    result = PyList_New((Py_ssize_t)n);
+    for (size_t i = 0; result && i < n; i++) {
+        PyList_SET_ITEM(result, (Py_ssize_t)i, PyBool_FromLong(results[i]));
+    }
+
+done:
+    for (size_t i = 0; copies && i < loaded; i++) {
+        free(copies[i].m);
+    }
+    free(copies);
+    free(items);
+    free(results);
+    Py_DECREF(seq);
+    return result;
+}
+
+// keygen_batch / sign_batch: keys or signatures generated on the shared
+// scheduler, each thread taking the next index until none are left
+typedef struct {
+    const dntl_ctx_t *ctx;
+    size_t count;
+    atomic_size_t next;
+    atomic_int error;
+    uint32_t *sk;               // count * n each
+    uint32_t *pk;
+    uint32_t *sig;              // sign_batch only
+    uint8_t *pk_seed;           // count * seed_bytes each
+    uint8_t *u;                 // sign_batch only
+    uint8_t **m;                // sign_batch messages, owned by the batch
+    size_t *m_len;
+} native_batch_t;
+
+static void native_batch_worker(void *arg) {
+    native_batch_t *b = arg;
+    const dntl_params_t *p = dntl_ctx_params(b->ctx);
+    size_t i;
+    while (!atomic_load_explicit(&b->error, memory_order_relaxed) &&
+           (i = atomic_fetch_add_explicit(&b->next, 1, memory_order_relaxed)) < b->count) {
+        uint32_t *sk = b->sk + i * p->n, *pk = b->pk + i * p->n;
+        uint8_t *pk_seed = b->pk_seed + i * p->seed_bytes;
+        const int ret = b->sig ? dntl_sign(b->ctx, b->m[i], b->m_len[i], sk, pk_seed, pk,
+                                           b->sig + i * p->n, b->u + i * p->seed_bytes)
+                               : dntl_keygen(b->ctx, sk, pk, pk_seed);
+        if (ret != 0) {
+            atomic_store(&b->error, 1);
+        }
+    }
+}
+
+// Run every item of b on the shared scheduler; -1 if one failed
+static int native_batch_run(native_batch_t *b) {
+    atomic_init(&b->next, 0);
+    atomic_init(&b->error, 0);
+    dntl_sched_t *s = b->count > 1 ? dntl_sched_default() : NULL;
+    const size_t threads = s ? dntl_sched_workers(s) + 1 : 1;
+    dntl_sched_spread(s, native_batch_worker, b, threads < b->count ? threads : b->count);
+    return atomic_load(&b->error) ? -1 : 0;
+}
+
+static void native_batch_free(native_batch_t *b) {
+    for (size_t i = 0; b->m && i < b->count; i++) {
+        free(b->m[i]);
+    }
+    free(b->sk);
+    free(b->pk);
+    free(b->sig);
+    free(b->pk_seed);
+    free(b->u);
+    free(b->m);
+    free(b->m_len);
+}
+
+static PyObject *py_keygen_batch(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    Py_ssize_t count;
+    if (!PyArg_ParseTuple(args, "in", &level, &count)) {
+        return NULL;
+    }
+    const dntl_ctx_t *ctx = get_ctx(level);
+    if (!ctx) {
+        return NULL;
+    }
+    if (count < 0) {
+        PyErr_SetString(PyExc_ValueError, "count must not be negative");
+        return NULL;
+    }
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const size_t n = (size_t)count ? (size_t)count : 1;
+    native_batch_t b = { .ctx = ctx, .count = (size_t)count };
+    PyObject *result = NULL;
+    int ret;
+
+    b.sk = malloc(n * p->n * sizeof(uint32_t));
+    b.pk = malloc(n * p->n * sizeof(uint32_t));
+    b.pk_seed = malloc(n * p->seed_bytes);
+    if (!b.sk || !b.pk || !b.pk_seed) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = native_batch_run(&b);
+    Py_END_ALLOW_THREADS
+    if (ret != 0) {
+        engine_error();
+        goto done;
+    }
+    result = PyList_New(count);
+    for (size_t i = 0; result && i < b.count; i++) {
+        PyObject *key = Py_BuildValue("(NNy#)", vector_to_list(b.sk + i * p->n, p->n),
+                                      vector_to_list(b.pk + i * p->n, p->n),
+                                      (const char *)b.pk_seed + i * p->seed_bytes,
+                                      (Py_ssize_t)p->seed_bytes);
+        if (!key) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, key);
+    }
+
+done:
+    native_batch_free(&b);
+    return result;
+}
+
+static int load_sign_item(PyObject *obj, const dntl_params_t *p, native_batch_t *b, size_t i) {
+    Py_buffer m, pk_seed;
+    PyObject *sk_obj, *pk_obj;
+    if (!PyTuple_Check(obj)) {
+        PyErr_SetString(PyExc_TypeError, "items must be (m, sk, pk_seed, pk) tuples");
+        return -1;
+    }
+    if (!PyArg_ParseTuple(obj, "y*Oy*O", &m, &sk_obj, &pk_seed, &pk_obj)) {
+        return -1;
+    }
+    int ret = -1;
+    if (load_vector(sk_obj, b->sk + i * p->n, p->n, "sk") == 0 &&
+        load_vector(pk_obj, b->pk + i * p->n, p->n, "pk") == 0 &&
+        check_seed(&pk_seed, p->seed_bytes, "pk_seed") == 0) {
+        b->m[i] = malloc(m.len ? (size_t)m.len : 1);
+        if (!b->m[i]) {
+            PyErr_NoMemory();
+        } else {
+            memcpy(b->m[i], m.buf, (size_t)m.len);
+            b->m_len[i] = (size_t)m.len;
+            memcpy(b->pk_seed + i * p->seed_bytes, pk_seed.buf, p->seed_bytes);
+            ret = 0;
+        }
+    }
+    PyBuffer_Release(&m);
+    PyBuffer_Release(&pk_seed);
+    return ret;
+}
+
+static PyObject *py_sign_batch(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    PyObject *items_obj;
+    if (!PyArg_ParseTuple(args, "iO", &level, &items_obj)) {
+        return NULL;
+    }
+    const dntl_ctx_t *ctx = get_ctx(level);
+    PyObject *seq = ctx ? PySequence_Fast(items_obj, "items must be a sequence") : NULL;
+    if (!seq) {
+        return NULL;
+    }
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const size_t count = (size_t)PySequence_Fast_GET_SIZE(seq), n = count ? count : 1;
+    native_batch_t b = { .ctx = ctx, .count = count };
+    PyObject *result = NULL;
+    int ret;
+
+    b.sk = malloc(n * p->n * sizeof(uint32_t));
+    b.pk = malloc(n * p->n * sizeof(uint32_t));
+    b.sig = malloc(n * p->n * sizeof(uint32_t));
+    b.pk_seed = malloc(n * p->seed_bytes);
+    b.u = malloc(n * p->seed_bytes);
+    b.m = calloc(n, sizeof(*b.m));
+    b.m_len = calloc(n, sizeof(*b.m_len));
+    if (!b.sk || !b.pk || !b.sig || !b.pk_seed || !b.u || !b.m || !b.m_len) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (load_sign_item(PySequence_Fast_GET_ITEM(seq, (Py_ssize_t)i), p, &b, i) != 0) {
+            goto done;
+        }
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    ret = native_batch_run(&b);
+    Py_END_ALLOW_THREADS
+    if (ret != 0) {
+        engine_error();
+        goto done;
+    }
+    result = PyList_New((Py_ssize_t)count);
+    for (size_t i = 0; result && i < count; i++) {
+        PyObject *sig = Py_BuildValue("(Ny#)", vector_to_list(b.sig + i * p->n, p->n),
+                                      (const char *)b.u + i * p->seed_bytes,
+                                      (Py_ssize_t)p->seed_bytes);
+        if (!sig) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, (Py_ssize_t)i, sig);
+    }
+
+done:
+    native_batch_free(&b);
+    Py_DECREF(seq);
+    return result;
+}
+
+static PyObject *py_set_basis_cache(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    Py_ssize_t max_bytes;
+    if (!PyArg_ParseTuple(args, "in", &level, &max_bytes)) {
+        return NULL;
+    }
+    const dntl_ctx_t *ctx = get_ctx(level);
+    if (!ctx) {
+        return NULL;
+    }
+    int slot = get_slot(level);
+    if (verify_in_flight[slot]) {
+        PyErr_SetString(PyExc_RuntimeError, "cannot resize the cache while verify is running");
+        return NULL;
+    }
+    dntl_basis_cache_t *cache = NULL;
+    if (max_bytes > 0) {
+        cache = dntl_basis_cache_create(ctx, (size_t)max_bytes);
+        if (!cache) {
+            PyErr_Format(PyExc_ValueError, "max_bytes must be 0 (disabled) or hold at least one key "
+                         "(%zu bytes each)", dntl_basis_cache_entry_bytes(ctx));
+            return NULL;
+        }
+    }
+    dntl_basis_cache_destroy(caches[slot]);
+    caches[slot] = cache;
+    cache_configured[slot] = 1;
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_basis_cache_stats(PyObject *self, PyObject *args) {
+    (void)self;
+    int level;
+    if (!PyArg_ParseTuple(args, "i", &level)) {
+        return NULL;
+    }
+    if (!get_ctx(level)) {
+        return NULL;
+    }
+    int slot = get_slot(level);
+    if (!caches[slot]) {
+        Py_RETURN_NONE;
+    }
+    dntl_basis_cache_stats_t st;
+    dntl_basis_cache_stats(caches[slot], &st);
+    return Py_BuildValue("{s:K,s:K,s:K,s:n,s:n,s:n,s:n}",
+                         "hits", (unsigned long long)st.hits,
+                         "misses", (unsigned long long)st.misses,
+                         "evictions", (unsigned long long)st.evictions,
+                         "entries", (Py_ssize_t)st.entries,
+                         "capacity", (Py_ssize_t)st.capacity,
+                         "bytes", (Py_ssize_t)st.bytes,
+                         "max_bytes", (Py_ssize_t)st.max_bytes);
+}
+
+static PyObject *py_set_sampler(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    if (!PyArg_ParseTuple(args, "s", &name)) {
+        return NULL;
+    }
+    if (strcmp(name, "mt19937") == 0) {
+        sampler = DNTL_SAMPLER_MT19937;
+    } else if (strcmp(name, "shake256") == 0) {
+        sampler = DNTL_SAMPLER_SHAKE256;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown sampler '%s' (expected mt19937 or shake256)", name);
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// ============================================================================
+// WIRE FORMAT
+// ============================================================================
+
+static const char *const WIRE_KINDS[] = { "pk", "sig", "sk" };
+
+static PyObject *py_pack(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *kind_name;
+    int level, coded = 0;
+    PyObject *coeffs_obj;
+    Py_buffer seed = { 0 };
+    if (!PyArg_ParseTuple(args, "siO|z*p", &kind_name, &level, &coeffs_obj, &seed, &coded)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    const dntl_params_t *p = get_ctx(level) ? dntl_params(level) : NULL;
+    int kind = -1;
+    for (int k = 0; k < 3; k++) {
+        if (strcmp(kind_name, WIRE_KINDS[k]) == 0) {
+            kind = k;
+        }
+    }
+    uint32_t coeffs[DNTL_MAX_N];
+    uint8_t out[1024];
+    size_t len;
+
+    if (!p) {
+        goto done;
+    }
+    if (kind < 0) {
+        PyErr_Format(PyExc_ValueError, "unknown kind '%s' (expected pk, sig or sk)", kind_name);
+        goto done;
+    }
+    if (load_vector(coeffs_obj, coeffs, p->n, kind_name) != 0 ||
+        (kind != DNTL_WIRE_SK && check_seed(&seed, p->seed_bytes, "seed") != 0)) {
+        goto done;
+    }
+    if (dntl_wire_encode(p, (dntl_wire_kind_t)kind, coeffs, seed.buf, coded, out, sizeof(out),
+                         &len) != 0) {
+        PyErr_Format(PyExc_ValueError, "%s coefficient out of range", kind_name);
+        goto done;
+    }
+    result = PyBytes_FromStringAndSize((const char *)out, (Py_ssize_t)len);
+
+done:
+    if (seed.obj) {
+        PyBuffer_Release(&seed);
+    }
+    return result;
+}
+
+static PyObject *py_unpack(PyObject *self, PyObject *args) {
+    (void)self;
+    Py_buffer data;
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    dntl_wire_view_t view;
+    uint32_t coeffs[DNTL_MAX_N];
+
+    if (dntl_wire_parse(data.buf, (size_t)data.len, &view) != 0 ||
+        dntl_wire_coeffs(&view, coeffs) != 0) {
+        PyErr_SetString(PyExc_ValueError, "malformed DNTL wire encoding");
+        goto done;
+    }
+    PyObject *list = vector_to_list(coeffs, view.params->n);
+    if (list) {
+        result = view.seed
+            ? Py_BuildValue("siNy#", WIRE_KINDS[view.kind], view.params->level, list,
+                            (const char *)view.seed, (Py_ssize_t)view.params->seed_bytes)
+            : Py_BuildValue("siNO", WIRE_KINDS[view.kind], view.params->level, list, Py_None);
+    }
+
+done:
+    PyBuffer_Release(&data);
+    return result;
+}
+
+static PyObject *py_verify_packed(PyObject *self, PyObject *args) {
+    (void)self;
+    Py_buffer m, pk_data, sig_data;
+    if (!PyArg_ParseTuple(args, "y*y*y*", &m, &pk_data, &sig_data)) {
+        return NULL;
+    }
+    PyObject *result = NULL;
+    dntl_wire_view_t pk, sig;
+    const dntl_ctx_t *ctx = NULL;
+    int ok;
+
+    if (dntl_wire_parse(pk_data.buf, (size_t)pk_data.len, &pk) != 0 ||
+        dntl_wire_parse(sig_data.buf, (size_t)sig_data.len, &sig) != 0) {
+        PyErr_SetString(PyExc_ValueError, "malformed DNTL wire encoding");
+        goto done;
+    }
+    if (!(ctx = get_ctx(pk.params->level))) {
+        goto done;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    ok = dntl_verify_wire(ctx, m.buf, (size_t)m.len, &pk, &sig);
+    Py_END_ALLOW_THREADS
+    result = PyBool_FromLong(ok);
+
+done:
+    PyBuffer_Release(&m);
+    PyBuffer_Release(&pk_data);
+    PyBuffer_Release(&sig_data);
+    return result;
+}
+
+static PyMethodDef dntl_native_methods[] = {
+    { "keygen", py_keygen, METH_VARARGS,
+      "keygen(level) -> (sk, pk, pk_seed)" },
+    { "keygen_from_seeds", py_keygen_from_seeds, METH_VARARGS,
+      "keygen_from_seeds(level, sk, r1, r2, r3) -> (pk, pk_seed), or None if rejected" },
+    { "sample_short_key", py_sample_short_key, METH_VARARGS,
+      "sample_short_key(seed, n, sigma, allowed, max_norm, max_mapped_norm[, mu]) -> sk" },
+    { "sign", py_sign, METH_VARARGS,
+      "sign(level, m, sk, pk_seed, pk[, r1[, candidates]]) -> (sig, u); with r1, None if rejected" },
+    { "verify", py_verify, METH_VARARGS,
+      "verify(level, m, pk_seed, pk, sig, u) -> bool" },
+    { "verify_batch", py_verify_batch, METH_VARARGS,
+      "verify_batch(level, [(m, pk_seed, pk, sig, u), ...]) -> list of bool" },
+    { "keygen_batch", py_keygen_batch, METH_VARARGS,
+      "keygen_batch(level, count) -> list of (sk, pk, pk_seed)" },
+    { "sign_batch", py_sign_batch, METH_VARARGS,
+      "sign_batch(level, [(m, sk, pk_seed, pk), ...]) -> list of (sig, u)" },
+    { "set_basis_cache", py_set_basis_cache, METH_VARARGS,
+      "set_basis_cache(level, max_bytes): resize the verify cache, 0 disables it" },
+    { "basis_cache_stats", py_basis_cache_stats, METH_VARARGS,
+      "basis_cache_stats(level) -> dict of counters, or None if disabled" },
+    { "set_sampler", py_set_sampler, METH_VARARGS,
+      "set_sampler('mt19937' | 'shake256'): public-basis sampler of later calls" },
+    { "pack", py_pack, METH_VARARGS,
+      "pack('pk' | 'sig' | 'sk', level, coeffs[, seed[, coded]]) -> bytes (seed: PK_C or u)" },
+    { "unpack", py_unpack, METH_VARARGS,
+      "unpack(data) -> (kind, level, coeffs, seed or None)" },
+    { "verify_packed", py_verify_packed, METH_VARARGS,
+      "verify_packed(m, pk_bytes, sig_bytes) -> bool, reading the encodings in place" },
+    DNTL_SCHED_PY_METHODS
+    DNTL_STATS_PY_METHODS
+    { NULL, NULL, 0, NULL }
+};
+
+static void dntl_native_free(void *module) {
+    (void)module;
+    for (size_t i = 0; i < sizeof(contexts) / sizeof(contexts[0]); i++) {
+        dntl_basis_cache_destroy(caches[i]);
+        dntl_ctx_destroy(contexts[i]);
+        caches[i] = NULL;
+        contexts[i] = NULL;
+    }
+}
+
+static struct PyModuleDef dntl_native_module = {
+    PyModuleDef_HEAD_INIT,
+    "dntl_native",
+    "Native DNTL-DSA keygen, sign and verify",
+    -1,
+    dntl_native_methods,
+    NULL, NULL, NULL,
+    dntl_native_free
+};
+
+PyMODINIT_FUNC PyInit_dntl_native(void) {
+    return PyModule_Create(&dntl_native_module);
+}
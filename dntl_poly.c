@@ -0,0 +1,182 @@
+#include "dntl_poly.h"
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// x mod q by Barrett reduction, mu = floor((2^64 - 1) / q): the quotient is
+// at most one short, so one conditional subtraction ends it
+static inline uint32_t reduce(uint64_t x, uint32_t q, uint64_t mu) {
+    uint64_t r = x - (uint64_t)(((__uint128_t)x * mu) >> 64) * q;
+    r -= q & -(uint64_t)(r >= q);
+    return (uint32_t)r;
+}
+
+// ============================================================================
+// DOMAIN CHANGES
+// ============================================================================
+
+// Natural <-> bit-reversed order, in place
+static void bit_reverse(uint32_t *c, size_t n) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            const uint32_t t = c[i];
+            c[i] = c[j];
+            c[j] = t;
+        }
+    }
+}
+
+// Bring the values of p to domain d: one transform, a permutation, or none
+static void to_domain(dntl_poly_t *p, dntl_poly_domain_t d) {
+    if (p->domain == d) {
+        return;
+    }
+    if (p->domain != DNTL_POLY_COEFF && d != DNTL_POLY_COEFF) {
+        bit_reverse(p->c, ntt_plan_size(p->plan));
+    } else if (d == DNTL_POLY_NTT) {
+        ntt_plan_forward(p->plan, p->c);
+        p->transforms++;
+    } else if (d == DNTL_POLY_NTT_BITREV) {
+        ntt_plan_forward_bitrev(p->plan, p->c);
+        p->transforms++;
+    } else if (p->domain == DNTL_POLY_NTT) {
+        ntt_plan_inverse(p->plan, p->c);
+        p->transforms++;
+    } else {
+        ntt_plan_inverse_bitrev(p->plan, p->c);
+        p->transforms++;
+    }
+    p->domain = d;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void dntl_poly_init(dntl_poly_t *p, const ntt_plan_t *plan, uint32_t *c,
+                    dntl_poly_domain_t domain) {
+    p->c = c;
+    p->plan = plan;
+    p->domain = p->want = domain == DNTL_POLY_COEFF ? DNTL_POLY_COEFF : DNTL_POLY_NTT;
+    p->transforms = 0;
+}
+
+void dntl_poly_forward(dntl_poly_t *p) {
+    p->want = DNTL_POLY_NTT;
+}
+
+void dntl_poly_inverse(dntl_poly_t *p) {
+    p->want = DNTL_POLY_COEFF;
+}
+
+uint32_t *dntl_poly_data(dntl_poly_t *p) {
+    to_domain(p, p->want);
+    return p->c;
+}
+
+int dntl_poly_switch(dntl_poly_t *p, const ntt_plan_t *plan) {
+    if (p->plan == plan) {
+        return 0;
+    }
+    const size_t n = ntt_plan_size(plan);
+    if (n != ntt_plan_size(p->plan)) {
+        return -1;
+    }
+    const uint32_t from = ntt_plan_modulus(p->plan), q = ntt_plan_modulus(plan);
+    to_domain(p, DNTL_POLY_COEFF);
+    if (q < from) {
+        const uint64_t mu = UINT64_MAX / q;
+        for (size_t i = 0; i < n; i++) {
+            p->c[i] = reduce(p->c[i], q, mu);
+        }
+    }
+    p->plan = plan;
+    return 0;
+}
+
+int dntl_poly_mul(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b) {
+    return dntl_poly_mul_batch(r, a, b, 1, 1);
+}
+
+// r = a + b, or a - b if negate, elementwise
+static int add_signed(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b, int negate) {
+    if (a->plan != b->plan) {
+        return -1;
+    }
+    const size_t n = ntt_plan_size(a->plan);
+    const uint32_t q = ntt_plan_modulus(a->plan);
+    to_domain(b, a->domain);
+
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t y = negate ? (q - b->c[i]) & -(uint32_t)(b->c[i] != 0) : b->c[i];
+        const uint32_t s = a->c[i] + y;
+        r->c[i] = s - (q & -(uint32_t)(s >= q));
+    }
+    r->plan = a->plan;
+    r->domain = a->domain;
+    r->want = a->want;
+    return 0;
+}
+
+int dntl_poly_add(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b) {
+    return add_signed(r, a, b, 0);
+}
+
+int dntl_poly_sub(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b) {
+    return add_signed(r, a, b, 1);
+}
+
+void dntl_poly_scale(dntl_poly_t *p, uint32_t s) {
+    const size_t n = ntt_plan_size(p->plan);
+    const uint32_t q = ntt_plan_modulus(p->plan);
+    const uint64_t mu = UINT64_MAX / q, m = reduce(s, q, mu);
+
+    for (size_t i = 0; i < n; i++) {
+        p->c[i] = reduce(p->c[i] * m, q, mu);
+    }
+}
+
+int dntl_poly_mul_batch(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b, size_t b_count,
+                        size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+    if (b_count != 1 && b_count != count) {
+        return -1;
+    }
+    const ntt_plan_t *plan = a[0].plan;
+    dntl_poly_domain_t d = DNTL_POLY_COEFF;
+    for (size_t i = 0; i < count; i++) {
+        const dntl_poly_t *bi = &b[b_count == 1 ? 0 : i];
+        if (a[i].plan != plan || bi->plan != plan) {
+            return -1;
+        }
+        if (d == DNTL_POLY_COEFF) {
+            d = a[i].domain != DNTL_POLY_COEFF ? a[i].domain : bi->domain;
+        }
+    }
+    if (d == DNTL_POLY_COEFF) {
+        d = DNTL_POLY_NTT_BITREV;
+    }
+
+    // Transforms first, then the products in one pass
+    for (size_t i = 0; i < b_count; i++) {
+        to_domain(&b[i], d);
+    }
+    for (size_t i = 0; i < count; i++) {
+        to_domain(&a[i], d);
+    }
+    for (size_t i = 0; i < count; i++) {
+        ntt_plan_pointwise_mul(plan, r[i].c, a[i].c, b[b_count == 1 ? 0 : i].c);
+        r[i].plan = plan;
+        r[i].domain = d;
+        r[i].want = DNTL_POLY_NTT;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+#ifndef DNTL_POLY_H
+#define DNTL_POLY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ntt_plan.h"
+
+// ============================================================================
+// DOMAIN-TAGGED POLYNOMIALS
+// ============================================================================
+//
+// A dntl_poly_t is a buffer of N values that knows what they are: the
+// coefficients of a polynomial mod x^N - 1 over Z_q, or its transform, with q
+// (and the root) given by the ntt_plan_t it is tagged with. Callers state
+// which domain they want and operations state which they need, and values
+// are only transformed when the two differ at the point they are read:
+//
+//   - dntl_poly_forward() and dntl_poly_inverse() only record the domain
+//     asked for, so an inverse followed by a forward (or the reverse) on the
+//     same modulus does no work
+//   - products run where the operands already are; two coefficient operands
+//     go to the bit-reversed NTT order, which saves the permutation
+//   - sums and scalings are linear and run in any domain the operands share
+//   - dntl_poly_switch() changes the modulus tag: the coefficients in [0, q)
+//     are read mod the new modulus, as the DNTL instance transition reads
+//     inverse_ntt_naturals(Q) output into forward_ntt_naturals(Q2)
+//
+// Usage (the generic transition of dntl_transition.h, two transforms of four):
+//
+//   dntl_poly_t x;
+//   dntl_poly_init(&x, plan_q, poly, DNTL_POLY_NTT);
+//   dntl_poly_switch(&x, plan_q2);         // inverse under Q
+//   dntl_poly_scale(&x, 3);                // in the coefficient domain
+//   dntl_poly_switch(&x, plan_q);
+//   dntl_poly_forward(&x);
+//   dntl_poly_data(&x);                    // forward under Q, in poly
+//
+// A poly does not own its buffer or plan; it may be copied while neither is
+// in use elsewhere.
+
+/**
+ * Domain of the values
+ *
+ * Callers use DNTL_POLY_COEFF and DNTL_POLY_NTT (natural order, as
+ * ntt_plan_forward()). DNTL_POLY_NTT_BITREV (ntt_plan_forward_bitrev()) is
+ * where products of coefficient operands are held; dntl_poly_data() of a
+ * poly in it returns natural order.
+ */
+typedef enum {
+    DNTL_POLY_COEFF = 0,
+    DNTL_POLY_NTT = 1,
+    DNTL_POLY_NTT_BITREV = 2,
+} dntl_poly_domain_t;
+
+typedef struct {
+    uint32_t *c;                    // n values in [0, q)
+    const ntt_plan_t *plan;         // (N, q, root) tag
+    dntl_poly_domain_t domain;      // domain of c
+    dntl_poly_domain_t want;        // domain dntl_poly_data() returns
+    uint32_t transforms;            // forward and inverse transforms run on c
+} dntl_poly_t;
+
+/**
+ * Wrap n = ntt_plan_size(plan) values of a domain (COEFF or NTT)
+ *
+ * @param c         Values in [0, q), used and updated in place
+ */
+void dntl_poly_init(dntl_poly_t *p, const ntt_plan_t *plan, uint32_t *c,
+                    dntl_poly_domain_t domain);
+
+/**
+ * Ask for the NTT domain (natural order) of p; nothing runs until it is read
+ */
+void dntl_poly_forward(dntl_poly_t *p);
+
+/**
+ * Ask for the coefficients of p; nothing runs until they are read
+ */
+void dntl_poly_inverse(dntl_poly_t *p);
+
+/**
+ * The values of p in the domain last asked for, transformed if needed
+ *
+ * @return          p->c
+ */
+uint32_t *dntl_poly_data(dntl_poly_t *p);
+
+/**
+ * Retag p with another modulus of the same length: its coefficients (an
+ * inverse runs if p is transformed) are reduced mod the new q
+ *
+ * @return          0, or -1 if the lengths differ
+ */
+int dntl_poly_switch(dntl_poly_t *p, const ntt_plan_t *plan);
+
+/**
+ * r = a * b mod x^N - 1 (x^N + 1 for a negacyclic plan)
+ *
+ * a and b are transformed where needed (and stay so); r is left in the NTT
+ * domain and may be a or b, or use the buffer of either.
+ *
+ * @return          0, or -1 unless a and b have the same plan
+ */
+int dntl_poly_mul(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b);
+
+/**
+ * r = a + b and r = a - b in a's domain (b is converted if needed)
+ *
+ * @return          0, or -1 unless a and b have the same plan
+ */
+int dntl_poly_add(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b);
+int dntl_poly_sub(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b);
+
+/**
+ * p = s * p in whatever domain p is in
+ */
+void dntl_poly_scale(dntl_poly_t *p, uint32_t s);
+
+/**
+ * r[i] = a[i] * b[i] for count products (b[0] for all of them if b_count is 1)
+ *
+ * Every operand is brought to the products' domain first (that of the first
+ * transformed operand, else the bit-reversed order), so the transforms run
+ * back to back on warm tables, then the products run in one pass. r[i] may
+ * be a[i]; with a shared b, no r[i] may use b[0]'s buffer.
+ *
+ * @return          0, or -1 unless every operand has the same plan
+ */
+int dntl_poly_mul_batch(dntl_poly_t *r, dntl_poly_t *a, dntl_poly_t *b, size_t b_count,
+                        size_t count);
+
+#endif // DNTL_POLY_H
@@ -0,0 +1,511 @@
+#define _GNU_SOURCE
+#include "dntl_sched.h"
+#include "dntl_alloc.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// ============================================================================
+// DEQUES
+// ============================================================================
+//
+// A short critical section per operation; tasks are coarse (a signing
+// candidate, a batch of rows, a codec chunk), so a lock per deque costs
+// little next to them.
+
+typedef struct {
+    void (*fn)(void *);
+    void *arg;
+    dntl_sched_group_t *group;
+} task_t;
+
+// Ring buffer: the owner pushes and pops at the bottom, thieves take the top
+typedef struct {
+    pthread_mutex_t lock;
+    task_t *buf;
+    size_t cap, top, size;
+} deque_t;
+
+static int deque_push(deque_t *d, const task_t *t) {
+    pthread_mutex_lock(&d->lock);
+    if (d->size == d->cap) {
+        const size_t cap = d->cap ? 2 * d->cap : 64;
+        task_t *buf = malloc(cap * sizeof(task_t));
+        if (!buf) {
+            pthread_mutex_unlock(&d->lock);
+            return -1;
+        }
+        for (size_t i = 0; i < d->size; i++) {
+            buf[i] = d->buf[(d->top + i) % d->cap];
+        }
+        free(d->buf);
+        d->buf = buf;
+        d->cap = cap;
+        d->top = 0;
+    }
+    d->buf[(d->top + d->size) % d->cap] = *t;
+    d->size++;
+    pthread_mutex_unlock(&d->lock);
+    return 0;
+}
+
+static int deque_pop(deque_t *d, int bottom, task_t *t) {
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->size > 0) {
+        if (bottom) {
+            *t = d->buf[(d->top + d->size - 1) % d->cap];
+        } else {
+            *t = d->buf[d->top];
+            d->top = (d->top + 1) % d->cap;
+        }
+        d->size--;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+// Drop the tasks of g, keeping the others in order; the number dropped
+static size_t deque_retract(deque_t *d, const dntl_sched_group_t *g) {
+    size_t kept = 0;
+    pthread_mutex_lock(&d->lock);
+    for (size_t i = 0; i < d->size; i++) {
+        const task_t t = d->buf[(d->top + i) % d->cap];
+        if (t.group != g) {
+            d->buf[(d->top + kept++) % d->cap] = t;
+        }
+    }
+    const size_t dropped = d->size - kept;
+    d->size = kept;
+    pthread_mutex_unlock(&d->lock);
+    return dropped;
+}
+
+// ============================================================================
+// SCHEDULER
+// ============================================================================
+
+typedef struct {
+    dntl_sched_t *sched;
+    size_t index;
+    int node;
+    pthread_t thread;
+    int stop;               // resize asked it to exit
+} worker_t;
+
+#define MAX_NODES DNTL_ALLOC_MAX_NODES
+
+struct dntl_sched {
+    deque_t inject[MAX_NODES];              // tasks from non-workers, by node
+    deque_t deques[DNTL_SCHED_MAX_WORKERS];
+    worker_t workers[DNTL_SCHED_MAX_WORKERS];
+    size_t count;                           // running workers
+    size_t slots;                           // deques ever owned (thieves scan these)
+    int pinned;
+    int nodes;                              // dntl_numa_nodes() at creation
+    int homes;                              // nodes with CPUs in the mask
+    int home[MAX_NODES];                    // worker i runs on home[i % homes]
+    size_t node_workers[MAX_NODES];         // running workers by node
+    pthread_mutex_t config;                 // serializes resize and destroy
+    pthread_mutex_t lock;                   // sleeping and waking
+    pthread_cond_t work[MAX_NODES];         // tasks were queued, or a worker must stop
+    pthread_cond_t done;                    // a group finished
+    size_t queued;                          // tasks in any queue
+    size_t sleepers;                        // workers waiting on work
+    size_t node_sleepers[MAX_NODES];        // ... by node, under lock
+    uint64_t executed, stolen, remote;
+#ifdef __linux__
+    cpu_set_t cpus;                         // affinity mask at creation
+    cpu_set_t node_cpus[MAX_NODES];         // ... on each node
+#endif
+};
+
+#define NOT_A_WORKER ((size_t)-1)
+
+static _Thread_local worker_t *current;
+
+// The deque the calling thread owns in s, or NOT_A_WORKER
+static size_t own_index(const dntl_sched_t *s) {
+    return current && current->sched == s ? current->index : NOT_A_WORKER;
+}
+
+static int worker_node(const dntl_sched_t *s, size_t index) {
+    return s->home[index % (size_t)s->homes];
+}
+
+// The node of the calling thread: its own as a worker of s, else its CPU's
+static int caller_node(const dntl_sched_t *s) {
+    if (current && current->sched == s) {
+        return current->node;
+    }
+    return s->nodes > 1 ? dntl_numa_node() % s->nodes : 0;
+}
+
+// Where a task for node goes: the caller's deque if it is a worker there
+static deque_t *node_queue(dntl_sched_t *s, int node) {
+    const size_t self = own_index(s);
+    if (node < 0) {
+        node = caller_node(s);
+    }
+    node %= s->nodes;
+    return self != NOT_A_WORKER && s->workers[self].node == node ? &s->deques[self]
+                                                                 : &s->inject[node];
+}
+
+// Take a task: own deque (newest first), then unless own_only the node's
+// shared queue and its workers' deques, then those of the other nodes
+static int take(dntl_sched_t *s, size_t self, int node, int own_only, task_t *t) {
+    if (__atomic_load_n(&s->queued, __ATOMIC_SEQ_CST) == 0) {
+        return 0;
+    }
+    int got = self != NOT_A_WORKER && deque_pop(&s->deques[self], 1, t);
+    const int passes = own_only ? 0 : s->nodes > 1 ? 2 : 1;
+    for (int remote = 0; remote < passes && !got; remote++) {
+        for (int k = 0; k < s->nodes && !got; k++) {
+            const int n = (node + k) % s->nodes;
+            got = (n != node) == remote && deque_pop(&s->inject[n], 0, t);
+        }
+        const size_t slots = __atomic_load_n(&s->slots, __ATOMIC_ACQUIRE);
+        const size_t start = self != NOT_A_WORKER ? self + 1 : 0;
+        for (size_t k = 0; k < slots && !got; k++) {
+            const size_t i = (start + k) % slots;
+            if (i != self && (worker_node(s, i) != node) == remote &&
+                deque_pop(&s->deques[i], 0, t)) {
+                __atomic_add_fetch(&s->stolen, 1, __ATOMIC_RELAXED);
+                got = 1;
+            }
+        }
+        if (got && remote) {
+            __atomic_add_fetch(&s->remote, 1, __ATOMIC_RELAXED);
+        }
+    }
+    if (got) {
+        __atomic_sub_fetch(&s->queued, 1, __ATOMIC_SEQ_CST);
+    }
+    return got;
+}
+
+// Run t and finish it in its group; g may be gone once pending reaches 0
+static void run_task(dntl_sched_t *s, const task_t *t) {
+    t->fn(t->arg);
+    __atomic_add_fetch(&s->executed, 1, __ATOMIC_RELAXED);
+    if (__atomic_sub_fetch(&t->group->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+        pthread_mutex_lock(&s->lock);
+        pthread_cond_broadcast(&s->done);
+        pthread_mutex_unlock(&s->lock);
+    }
+}
+
+static void *worker_main(void *arg) {
+    worker_t *w = arg;
+    dntl_sched_t *s = w->sched;
+    task_t t;
+
+    current = w;
+    for (;;) {
+        // A stopping worker only finishes its own deque (nobody else pushes
+        // to it), so resize does not wait for the shared queue to drain
+        const int stop = __atomic_load_n(&w->stop, __ATOMIC_ACQUIRE);
+        if (take(s, w->index, w->node, stop, &t)) {
+            run_task(s, &t);
+            continue;
+        }
+        if (stop) {
+            break;
+        }
+        pthread_mutex_lock(&s->lock);
+        // Paired with queued++ then sleepers in submit: one side sees the other
+        __atomic_add_fetch(&s->sleepers, 1, __ATOMIC_SEQ_CST);
+        s->node_sleepers[w->node]++;
+        while (!__atomic_load_n(&w->stop, __ATOMIC_ACQUIRE) &&
+               __atomic_load_n(&s->queued, __ATOMIC_SEQ_CST) == 0) {
+            pthread_cond_wait(&s->work[w->node], &s->lock);
+        }
+        s->node_sleepers[w->node]--;
+        __atomic_sub_fetch(&s->sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&s->lock);
+    }
+    current = NULL;
+    return NULL;
+}
+
+// Pin worker w to one allowed CPU of its node (the workers of a node take
+// them in turn), or give it all of them
+static void apply_affinity(dntl_sched_t *s, worker_t *w) {
+#ifdef __linux__
+    const cpu_set_t *mask = &s->node_cpus[w->node];
+    cpu_set_t set = *mask;
+    const int n = CPU_COUNT(mask);
+    if (s->pinned && n > 0) {
+        int want = (int)(w->index / (size_t)s->homes % (size_t)n);
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, mask) && want-- == 0) {
+                CPU_SET(cpu, &set);
+                break;
+            }
+        }
+    }
+    pthread_setaffinity_np(w->thread, sizeof(set), &set);
+#else
+    (void)s;
+    (void)w;
+#endif
+}
+
+int dntl_sched_resize(dntl_sched_t *s, size_t workers, int pin) {
+    int ret = 0;
+
+    if (workers > DNTL_SCHED_MAX_WORKERS) {
+        workers = DNTL_SCHED_MAX_WORKERS;
+    }
+    pthread_mutex_lock(&s->config);
+    const size_t count = s->count;
+    if (workers < count) {
+        pthread_mutex_lock(&s->lock);
+        for (size_t i = workers; i < count; i++) {
+            __atomic_store_n(&s->workers[i].stop, 1, __ATOMIC_RELEASE);
+        }
+        for (int k = 0; k < s->nodes; k++) {
+            pthread_cond_broadcast(&s->work[k]);
+        }
+        pthread_mutex_unlock(&s->lock);
+        for (size_t i = workers; i < count; i++) {
+            pthread_join(s->workers[i].thread, NULL);
+            __atomic_sub_fetch(&s->node_workers[s->workers[i].node], 1, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&s->count, workers, __ATOMIC_RELEASE);
+    }
+    s->pinned = pin;
+    for (size_t i = 0; i < s->count; i++) {
+        apply_affinity(s, &s->workers[i]);
+    }
+    while (s->count < workers) {
+        worker_t *w = &s->workers[s->count];
+        w->sched = s;
+        w->index = s->count;
+        w->node = worker_node(s, w->index);
+        w->stop = 0;
+        if (s->slots <= w->index) {
+            __atomic_store_n(&s->slots, w->index + 1, __ATOMIC_RELEASE);
+        }
+        if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+            ret = -1;
+            break;
+        }
+        apply_affinity(s, w);
+        __atomic_add_fetch(&s->node_workers[w->node], 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&s->count, s->count + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&s->config);
+    return ret;
+}
+
+dntl_sched_t *dntl_sched_create(size_t workers, int pin) {
+    dntl_sched_t *s = calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+    for (int k = 0; k < MAX_NODES; k++) {
+        pthread_mutex_init(&s->inject[k].lock, NULL);
+        pthread_cond_init(&s->work[k], NULL);
+    }
+    for (size_t i = 0; i < DNTL_SCHED_MAX_WORKERS; i++) {
+        pthread_mutex_init(&s->deques[i].lock, NULL);
+    }
+    pthread_mutex_init(&s->config, NULL);
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->done, NULL);
+
+    // Workers go round the nodes that have CPUs in the mask (all of them
+    // where the mask is unknown)
+    s->nodes = dntl_numa_nodes();
+#ifdef __linux__
+    if (sched_getaffinity(0, sizeof(s->cpus), &s->cpus) != 0) {
+        CPU_ZERO(&s->cpus);
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &s->cpus)) {
+            CPU_SET(cpu, &s->node_cpus[s->nodes > 1 ? dntl_numa_cpu_node(cpu) % s->nodes : 0]);
+        }
+    }
+    for (int k = 0; k < s->nodes; k++) {
+        if (CPU_COUNT(&s->node_cpus[k]) > 0) {
+            s->home[s->homes++] = k;
+        }
+    }
+#endif
+    if (s->homes == 0) {
+        for (int k = 0; k < s->nodes; k++) {
+            s->home[s->homes++] = k;
+        }
+    }
+    if (dntl_sched_resize(s, workers, pin) != 0) {
+        dntl_sched_destroy(s);
+        return NULL;
+    }
+    return s;
+}
+
+void dntl_sched_destroy(dntl_sched_t *s) {
+    if (!s) {
+        return;
+    }
+    dntl_sched_resize(s, 0, 0);
+    for (int k = 0; k < MAX_NODES; k++) {
+        free(s->inject[k].buf);
+        pthread_mutex_destroy(&s->inject[k].lock);
+        pthread_cond_destroy(&s->work[k]);
+    }
+    for (size_t i = 0; i < DNTL_SCHED_MAX_WORKERS; i++) {
+        free(s->deques[i].buf);
+        pthread_mutex_destroy(&s->deques[i].lock);
+    }
+    pthread_cond_destroy(&s->done);
+    pthread_mutex_destroy(&s->lock);
+    pthread_mutex_destroy(&s->config);
+    free(s);
+}
+
+static pthread_once_t default_once = PTHREAD_ONCE_INIT;
+static dntl_sched_t *default_sched;
+
+static void default_init(void) {
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t workers = cpus > 1 ? (size_t)cpus - 1 : 0;
+    const char *env = getenv("DNTL_WORKERS");
+    if (env && *env) {
+        workers = strtoul(env, NULL, 10);
+    }
+    default_sched = dntl_sched_create(workers, 0);
+}
+
+dntl_sched_t *dntl_sched_default(void) {
+    pthread_once(&default_once, default_init);
+    return default_sched;
+}
+
+void dntl_sched_stats(dntl_sched_t *s, dntl_sched_stats_t *out) {
+    pthread_mutex_lock(&s->config);
+    out->workers = s->count;
+    out->pinned = s->pinned;
+    pthread_mutex_unlock(&s->config);
+    out->nodes = (size_t)s->nodes;
+    out->executed = __atomic_load_n(&s->executed, __ATOMIC_RELAXED);
+    out->stolen = __atomic_load_n(&s->stolen, __ATOMIC_RELAXED);
+    out->remote = __atomic_load_n(&s->remote, __ATOMIC_RELAXED);
+}
+
+size_t dntl_sched_workers(const dntl_sched_t *s) {
+    return s ? __atomic_load_n(&s->count, __ATOMIC_ACQUIRE) : 0;
+}
+
+int dntl_sched_nodes(const dntl_sched_t *s) {
+    return s ? s->nodes : 1;
+}
+
+size_t dntl_sched_node_workers(const dntl_sched_t *s, int node) {
+    if (!s || node < 0) {
+        return 0;
+    }
+    return __atomic_load_n(&s->node_workers[node % s->nodes], __ATOMIC_ACQUIRE);
+}
+
+int dntl_sched_node(const dntl_sched_t *s) {
+    return s ? caller_node(s) : 0;
+}
+
+// ============================================================================
+// GROUPS
+// ============================================================================
+
+void dntl_sched_group_init(dntl_sched_group_t *g, dntl_sched_t *s) {
+    g->sched = s;
+    g->pending = 0;
+}
+
+void dntl_sched_submit(dntl_sched_group_t *g, void (*fn)(void *arg), void *arg) {
+    dntl_sched_submit_node(g, -1, fn, arg);
+}
+
+void dntl_sched_submit_node(dntl_sched_group_t *g, int node, void (*fn)(void *arg),
+                            void *arg) {
+    dntl_sched_t *s = g->sched;
+    const task_t t = { fn, arg, g };
+    deque_t *q = node_queue(s, node);
+
+    __atomic_add_fetch(&g->pending, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s->queued, 1, __ATOMIC_SEQ_CST);
+    if (deque_push(q, &t) != 0) {
+        __atomic_sub_fetch(&s->queued, 1, __ATOMIC_SEQ_CST);
+        run_task(s, &t);
+        return;
+    }
+    if (__atomic_load_n(&s->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        // A sleeper of the task's node, else of the nearest node with one
+        const int home = node < 0 ? caller_node(s) : node % s->nodes;
+        pthread_mutex_lock(&s->lock);
+        for (int k = 0; k < s->nodes; k++) {
+            const int n = (home + k) % s->nodes;
+            if (s->node_sleepers[n] > 0) {
+                pthread_cond_signal(&s->work[n]);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&s->lock);
+    }
+}
+
+void dntl_sched_wait(dntl_sched_group_t *g) {
+    dntl_sched_t *s = g->sched;
+    const size_t self = own_index(s);
+    const int node = caller_node(s);
+    task_t t;
+
+    while (__atomic_load_n(&g->pending, __ATOMIC_ACQUIRE) != 0) {
+        if (take(s, self, node, 0, &t)) {
+            run_task(s, &t);
+            continue;
+        }
+        // Nothing queued: g's remaining tasks run elsewhere and signal done
+        pthread_mutex_lock(&s->lock);
+        while (__atomic_load_n(&g->pending, __ATOMIC_ACQUIRE) != 0 &&
+               __atomic_load_n(&s->queued, __ATOMIC_SEQ_CST) == 0) {
+            pthread_cond_wait(&s->done, &s->lock);
+        }
+        pthread_mutex_unlock(&s->lock);
+    }
+}
+
+void dntl_sched_spread(dntl_sched_t *s, void (*fn)(void *arg), void *arg, size_t threads) {
+    dntl_sched_spread_node(s, -1, fn, arg, threads);
+}
+
+void dntl_sched_spread_node(dntl_sched_t *s, int node, void (*fn)(void *arg), void *arg,
+                            size_t threads) {
+    const size_t workers = dntl_sched_workers(s);
+    if (threads > workers + 1) {
+        threads = workers + 1;
+    }
+    if (threads <= 1) {
+        fn(arg);
+        return;
+    }
+
+    dntl_sched_group_t g;
+    dntl_sched_group_init(&g, s);
+    for (size_t i = 1; i < threads; i++) {
+        dntl_sched_submit_node(&g, node, fn, arg);
+    }
+    fn(arg);
+
+    // Copies not started by now would find no work left
+    size_t dropped = deque_retract(node_queue(s, node), &g);
+    if (dropped) {
+        __atomic_sub_fetch(&s->queued, dropped, __ATOMIC_SEQ_CST);
+        __atomic_sub_fetch(&g.pending, dropped, __ATOMIC_ACQ_REL);
+    }
+    dntl_sched_wait(&g);
+}
@@ -0,0 +1,173 @@
+#ifndef DNTL_SCHED_H
+#define DNTL_SCHED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// WORK-STEALING SCHEDULER
+// ============================================================================
+//
+// One set of worker threads for every parallel path (speculative signing,
+// batch verification, parameter expansion, batch codecs), so features
+// running at the same time share the cores instead of each starting threads
+// of its own.
+//
+//   - Each worker owns a deque: tasks it submits go to the bottom and it
+//     takes them back newest first; idle workers steal the oldest task from
+//     the top of another's. Tasks from other threads enter a shared queue,
+//     in order.
+//   - dntl_sched_wait() runs queued tasks until its group is done, so the
+//     waiting thread is one more worker, and a scheduler without workers
+//     still completes everything (inline, in submission order).
+//   - Tasks may submit and wait on groups of their own, but must not block
+//     on anything else that a queued task provides.
+//   - Workers can be pinned to one CPU each of the process's affinity mask
+//     (Linux); the calling threads are never pinned.
+//   - Workers form one group per NUMA node (dntl_alloc.h numbering): of the
+//     h nodes with CPUs in the mask, worker i runs on the (i mod h)-th, pinned
+//     or not. Each node has its own shared queue, and threads take tasks
+//     from their own node's queues first; another node's tasks are only
+//     taken when their own node has none, so no core idles while work is
+//     queued anywhere. dntl_sched_submit_node() and dntl_sched_spread_node()
+//     send work to the node holding its data.
+//
+// Usage:
+//
+//   dntl_sched_group_t g;
+//   dntl_sched_group_init(&g, dntl_sched_default());
+//   for (size_t i = 0; i < n; i++) {
+//       dntl_sched_submit(&g, work, &items[i]);
+//   }
+//   dntl_sched_wait(&g);
+
+#define DNTL_SCHED_MAX_WORKERS 256
+
+typedef struct dntl_sched dntl_sched_t;
+
+/**
+ * Tasks submitted together and waited for together (caller-owned, usually
+ * on the stack; fields are private)
+ */
+typedef struct {
+    dntl_sched_t *sched;
+    size_t pending;         // submitted and not finished
+} dntl_sched_group_t;
+
+typedef struct {
+    size_t workers;
+    int pinned;
+    size_t nodes;           // NUMA nodes the workers are grouped by
+    uint64_t executed;      // tasks run, by workers and waiting threads
+    uint64_t stolen;        // ... taken from another worker's deque
+    uint64_t remote;        // ... taken from another node's queues
+} dntl_sched_stats_t;
+
+/**
+ * Start a scheduler
+ *
+ * @param workers   Worker threads, 0 .. DNTL_SCHED_MAX_WORKERS (0 runs every
+ *                  task in the waiting thread)
+ * @param pin       Nonzero pins each worker to one CPU of its node in the
+ *                  affinity mask, the workers of a node taking them in turn
+ * @return          New scheduler, or NULL if memory or threads are unavailable
+ */
+dntl_sched_t *dntl_sched_create(size_t workers, int pin);
+
+/**
+ * Stop and free a scheduler with no task in flight (NULL is ignored)
+ */
+void dntl_sched_destroy(dntl_sched_t *s);
+
+/**
+ * The library-wide scheduler every parallel API uses by default, started on
+ * first use with one worker per online CPU minus the caller, or with the
+ * count in the DNTL_WORKERS environment variable
+ *
+ * @return          The scheduler, or NULL if it cannot start (callers then
+ *                  run inline)
+ */
+dntl_sched_t *dntl_sched_default(void);
+
+/**
+ * Change the number of workers and the pinning, in place
+ *
+ * Safe while tasks run: extra workers finish their current task and own
+ * deque before exiting. Calls are serialized.
+ *
+ * @return          0, or -1 if a thread could not start (the workers
+ *                  started so far are kept)
+ */
+int dntl_sched_resize(dntl_sched_t *s, size_t workers, int pin);
+
+/**
+ * Workers, pinning and task counters
+ */
+void dntl_sched_stats(dntl_sched_t *s, dntl_sched_stats_t *out);
+
+/**
+ * Current number of workers, without waiting for a resize in progress
+ * (NULL gives 0)
+ */
+size_t dntl_sched_workers(const dntl_sched_t *s);
+
+/**
+ * Number of NUMA nodes, those of dntl_numa_nodes() (NULL gives 1)
+ */
+int dntl_sched_nodes(const dntl_sched_t *s);
+
+/**
+ * Current number of workers on a node (0 for a node without CPUs in the
+ * mask, a negative node or NULL)
+ */
+size_t dntl_sched_node_workers(const dntl_sched_t *s, int node);
+
+/**
+ * The node of the calling thread: a worker's own, else the node of the CPU
+ * it runs on
+ */
+int dntl_sched_node(const dntl_sched_t *s);
+
+void dntl_sched_group_init(dntl_sched_group_t *g, dntl_sched_t *s);
+
+/**
+ * Queue fn(arg) in group g
+ *
+ * If the queue cannot grow, fn runs right away in the calling thread.
+ */
+void dntl_sched_submit(dntl_sched_group_t *g, void (*fn)(void *arg), void *arg);
+
+/**
+ * dntl_sched_submit() for the workers of a node: a worker of that node
+ * queues fn on its own deque, other threads on the node's shared queue
+ *
+ * @param node      0 .. dntl_sched_nodes() - 1, or -1 for the caller's node
+ *                  (as dntl_sched_submit())
+ */
+void dntl_sched_submit_node(dntl_sched_group_t *g, int node, void (*fn)(void *arg),
+                            void *arg);
+
+/**
+ * Run queued tasks until every task of g has finished
+ */
+void dntl_sched_wait(dntl_sched_group_t *g);
+
+/**
+ * Run fn(arg) on up to threads threads at once, the caller's included, and
+ * return when all have finished
+ *
+ * For the shared-index loops of the batch APIs: fn takes work items until
+ * none are left, so a copy that starts late (or not at all) only leaves
+ * more items to the others. Copies still queued when the caller's own copy
+ * returns are withdrawn. A NULL scheduler runs fn once, inline.
+ */
+void dntl_sched_spread(dntl_sched_t *s, void (*fn)(void *arg), void *arg, size_t threads);
+
+/**
+ * dntl_sched_spread() with the copies queued for the workers of a node
+ * (-1 for the caller's); idle workers of other nodes still take them
+ */
+void dntl_sched_spread_node(dntl_sched_t *s, int node, void (*fn)(void *arg), void *arg,
+                            size_t threads);
+
+#endif // DNTL_SCHED_H
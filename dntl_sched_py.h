@@ -0,0 +1,72 @@
+#ifndef DNTL_SCHED_PY_H
+#define DNTL_SCHED_PY_H
+
+/**
+ * set_workers() / workers() for the CPython modules (include after Python.h)
+ *
+ * Both act on dntl_sched_default(), the scheduler every parallel call of the
+ * module runs on. Each module links its own copy, so dntl_native and
+ * sparse_native are sized separately.
+ */
+
+#include "dntl_sched.h"
+
+static PyObject *py_set_workers(PyObject *self, PyObject *args, PyObject *kwargs) {
+    (void)self;
+    static char *kwlist[] = { "count", "pin", NULL };
+    Py_ssize_t count;
+    int pin = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|p", kwlist, &count, &pin)) {
+        return NULL;
+    }
+    if (count < 0 || count > DNTL_SCHED_MAX_WORKERS) {
+        PyErr_Format(PyExc_ValueError, "count must be 0 .. %d", DNTL_SCHED_MAX_WORKERS);
+        return NULL;
+    }
+    dntl_sched_t *s = dntl_sched_default();
+    if (!s) {
+        PyErr_SetString(PyExc_RuntimeError, "cannot start the scheduler");
+        return NULL;
+    }
+
+    // Workers leaving finish their current task first, which can take a while
+    int ret;
+    Py_BEGIN_ALLOW_THREADS
+    ret = dntl_sched_resize(s, (size_t)count, pin);
+    Py_END_ALLOW_THREADS
+    if (ret < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "cannot start worker threads");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// {"workers": int, "pinned": bool, "nodes": int, "executed": int, "stolen": int,
+//  "remote": int}
+static PyObject *py_workers(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    dntl_sched_stats_t st = { 0 };
+    dntl_sched_t *s = dntl_sched_default();
+    if (s) {
+        dntl_sched_stats(s, &st);
+    }
+    return Py_BuildValue("{s:n,s:O,s:n,s:K,s:K,s:K}",
+                         "workers", (Py_ssize_t)st.workers,
+                         "pinned", st.pinned ? Py_True : Py_False,
+                         "nodes", (Py_ssize_t)st.nodes,
+                         "executed", (unsigned long long)st.executed,
+                         "stolen", (unsigned long long)st.stolen,
+                         "remote", (unsigned long long)st.remote);
+}
+
+#define DNTL_SCHED_PY_METHODS                                                                \
+    { "set_workers", (PyCFunction)(void (*)(void))py_set_workers,                            \
+      METH_VARARGS | METH_KEYWORDS,                                                          \
+      "set_workers(count, pin=False): worker threads of the shared scheduler (the caller "   \
+      "runs tasks too, 0 runs everything inline); pin binds one CPU to each" },              \
+    { "workers", py_workers, METH_NOARGS,                                                    \
+      "workers() -> dict of worker count, pinning, NUMA nodes, and tasks executed, "         \
+      "stolen and taken from another node" },
+
+#endif // DNTL_SCHED_PY_H
@@ -0,0 +1,157 @@
+#include "dntl_stats.h"
+#include <string.h>
+
+static const char *const STAGE_NAMES[DNTL_STAT_STAGES] = {
+    "ntt_forward", "ntt_inverse", "ntt_pointwise", "prf", "rs_derive_a", "rs_derive_b",
+    "rs_derive_c", "lwr_tag", "sparse_encode", "sparse_decode", "huffman_encode",
+    "huffman_decode", "basis", "short_key", "keygen", "keygen_trial", "sign", "sign_trial",
+    "verify"
+};
+
+static const char *const COUNTER_NAMES[DNTL_COUNTERS] = {
+    "prf_bytes", "short_key_rejects", "keygen_rejects", "sign_rejects", "short_key_norm",
+    "short_key_mapped_norm", "keygen_secret_redraws"
+};
+
+static const char *const HIST_NAMES[DNTL_HISTS] = {
+    "keygen_trials", "sign_trials", "short_key_trials"
+};
+
+static const char *const REJECT_NAMES[DNTL_REJECTS] = {
+    "basis_row", "keygen_zero", "sign_zero"
+};
+
+const char *dntl_stats_stage_name(int stage) {
+    return stage >= 0 && stage < DNTL_STAT_STAGES ? STAGE_NAMES[stage] : NULL;
+}
+
+const char *dntl_stats_counter_name(int counter) {
+    return counter >= 0 && counter < DNTL_COUNTERS ? COUNTER_NAMES[counter] : NULL;
+}
+
+const char *dntl_stats_hist_name(int hist) {
+    return hist >= 0 && hist < DNTL_HISTS ? HIST_NAMES[hist] : NULL;
+}
+
+const char *dntl_stats_reject_name(int reason) {
+    return reason >= 0 && reason < DNTL_REJECTS ? REJECT_NAMES[reason] : NULL;
+}
+
+#ifdef DNTL_STATS
+
+#include <pthread.h>
+#include <stdlib.h>
+
+_Thread_local dntl_stats_block_t *dntl_stats_tls;
+
+// Registered blocks, newest first, and the totals dntl_stats_reset() took
+// as zero (only the sums matter, so one baseline serves every thread)
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static dntl_stats_block_t *registry;
+static size_t registry_count;
+static dntl_stats_t baseline;
+
+static pthread_once_t hz_once = PTHREAD_ONCE_INIT;
+static double hz;
+
+dntl_stats_block_t *dntl_stats_register(void) {
+    dntl_stats_block_t *b = calloc(1, sizeof(*b));
+    if (!b) {
+        return NULL;
+    }
+    pthread_mutex_lock(&registry_lock);
+    b->next = registry;
+    registry = b;
+    registry_count++;
+    pthread_mutex_unlock(&registry_lock);
+    dntl_stats_tls = b;
+    return b;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void calibrate(void) {
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    const double t0 = now_ns();
+    const uint64_t c0 = dntl_stats_ticks();
+    while (now_ns() - t0 < 10e6) {
+    }
+    const double t1 = now_ns();
+    const uint64_t c1 = dntl_stats_ticks();
+    hz = (double)(c1 - c0) / ((t1 - t0) * 1e-9);
+#else
+    hz = 1e9;
+#endif
+}
+
+// Sums of every block, without the baseline
+static void totals(dntl_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    for (const dntl_stats_block_t *b = registry; b; b = b->next) {
+        for (int i = 0; i < DNTL_STAT_STAGES; i++) {
+            out->stage[i].calls += __atomic_load_n(&b->calls[i], __ATOMIC_RELAXED);
+            out->stage[i].ticks += __atomic_load_n(&b->ticks[i], __ATOMIC_RELAXED);
+        }
+        for (int i = 0; i < DNTL_COUNTERS; i++) {
+            out->count[i] += __atomic_load_n(&b->count[i], __ATOMIC_RELAXED);
+        }
+        for (int i = 0; i < DNTL_HISTS; i++) {
+            for (int j = 0; j < DNTL_HIST_BUCKETS; j++) {
+                out->hist[i][j] += __atomic_load_n(&b->hist[i][j], __ATOMIC_RELAXED);
+            }
+        }
+        for (int i = 0; i < DNTL_REJECTS; i++) {
+            for (int j = 0; j < DNTL_STAT_INSTANCES; j++) {
+                out->reject[i][j] += __atomic_load_n(&b->reject[i][j], __ATOMIC_RELAXED);
+            }
+        }
+    }
+    out->threads = registry_count;
+}
+
+void dntl_stats_snapshot(dntl_stats_t *out) {
+    pthread_once(&hz_once, calibrate);
+    pthread_mutex_lock(&registry_lock);
+    totals(out);
+    for (int i = 0; i < DNTL_STAT_STAGES; i++) {
+        out->stage[i].calls -= baseline.stage[i].calls;
+        out->stage[i].ticks -= baseline.stage[i].ticks;
+    }
+    for (int i = 0; i < DNTL_COUNTERS; i++) {
+        out->count[i] -= baseline.count[i];
+    }
+    for (int i = 0; i < DNTL_HISTS; i++) {
+        for (int j = 0; j < DNTL_HIST_BUCKETS; j++) {
+            out->hist[i][j] -= baseline.hist[i][j];
+        }
+    }
+    for (int i = 0; i < DNTL_REJECTS; i++) {
+        for (int j = 0; j < DNTL_STAT_INSTANCES; j++) {
+            out->reject[i][j] -= baseline.reject[i][j];
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+    out->enabled = 1;
+    out->ticks_hz = hz;
+}
+
+void dntl_stats_reset(void) {
+    pthread_mutex_lock(&registry_lock);
+    totals(&baseline);
+    pthread_mutex_unlock(&registry_lock);
+}
+
+#else
+
+void dntl_stats_snapshot(dntl_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+}
+
+void dntl_stats_reset(void) {
+}
+
+#endif // DNTL_STATS
@@ -0,0 +1,252 @@
+#ifndef DNTL_STATS_H
+#define DNTL_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// HOT-PATH INSTRUMENTATION
+// ============================================================================
+//
+// Built with -DDNTL_STATS, the major entry points keep per-thread call counts
+// and cycle-counter time per stage, plus event counters (keystream bytes,
+// rejected trials), histograms of trials per operation and rejection reasons
+// per basis instance. Without it the DNTL_STAT_* macros expand to nothing
+// and dntl_stats_snapshot() reports enabled = 0.
+//
+//   - A stage is timed from DNTL_STAT_SCOPE() to the end of the enclosing
+//     block, inclusively: a signing trial's time contains its basis and NTT
+//     time. A stage entered again while active on the thread (an entry point
+//     calling another of the same stage) is not counted twice.
+//   - Each thread owns a block of counters, registered on first use and kept
+//     after the thread exits, so its counts stay in later snapshots. Only the
+//     owner writes it; snapshots read it with relaxed atomics.
+//   - Ticks are rdtsc on x86-64 (unfenced: stage-level, not per-instruction),
+//     cntvct_el0 on AArch64 and nanoseconds elsewhere; the snapshot carries
+//     the rate.
+//
+// Usage:
+//
+//   int ntt64_something(...) {
+//       DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+//       ...
+//   }
+//
+//   dntl_stats_t st;
+//   dntl_stats_snapshot(&st);       // totals over every thread
+//   export(st.stage[DNTL_STAT_SIGN_TRIAL].calls, ...);
+
+typedef enum {
+    DNTL_STAT_NTT_FORWARD = 0,  // ntt64 and ntt_plan forward transforms
+    DNTL_STAT_NTT_INVERSE,
+    DNTL_STAT_NTT_POINTWISE,    // pointwise products and MACs
+    DNTL_STAT_PRF,              // AES-256-CTR keystream (rs_prf)
+    DNTL_STAT_RS_DERIVE_A,      // rs_derive_A*, dense and ring
+    DNTL_STAT_RS_DERIVE_B,
+    DNTL_STAT_RS_DERIVE_C,
+    DNTL_STAT_LWR_TAG,          // rs_lwr_tag*
+    DNTL_STAT_SPARSE_ENCODE,    // every sparse codec
+    DNTL_STAT_SPARSE_DECODE,
+    DNTL_STAT_HUFFMAN_ENCODE,   // dense Huffman formats
+    DNTL_STAT_HUFFMAN_DECODE,
+    DNTL_STAT_BASIS,            // DNTL public-basis sampling and folding
+    DNTL_STAT_SHORT_KEY,        // short secret sampling
+    DNTL_STAT_KEYGEN,
+    DNTL_STAT_KEYGEN_TRIAL,     // one (r1, r2, r3) attempt
+    DNTL_STAT_SIGN,
+    DNTL_STAT_SIGN_TRIAL,       // one r1 attempt
+    DNTL_STAT_VERIFY,
+    DNTL_STAT_STAGES
+} dntl_stat_stage_t;
+
+typedef enum {
+    DNTL_COUNT_PRF_BYTES = 0,   // keystream bytes generated
+    DNTL_COUNT_SHORT_KEY_REJECTS,
+    DNTL_COUNT_KEYGEN_REJECTS,  // public keys with a coefficient equal to q
+    DNTL_COUNT_SIGN_REJECTS,
+    DNTL_COUNT_SHORT_KEY_NORM,          // short-key rejects on ||x|| > max_norm
+    DNTL_COUNT_SHORT_KEY_MAPPED_NORM,   // ... on ||x - mu|| > max_mapped_norm
+    DNTL_COUNT_KEYGEN_SECRET_REDRAWS,   // secrets dropped after DNTL_KEYGEN_TRIALS
+    DNTL_COUNTERS
+} dntl_stat_counter_t;
+
+// Trials per completed operation: bucket b counts operations that took
+// [2^b, 2^(b + 1)) trials, the last bucket everything above
+#define DNTL_HIST_BUCKETS 8
+
+typedef enum {
+    DNTL_HIST_KEYGEN_TRIALS = 0,    // (r1, r2, r3) attempts per dntl_keygen
+    DNTL_HIST_SIGN_TRIALS,          // r1 attempts per dntl_sign, dntl_sign_speculative
+    DNTL_HIST_SHORT_KEY_TRIALS,     // candidates per short key
+    DNTL_HISTS
+} dntl_stat_hist_t;
+
+// Rejection reasons are kept per basis instance; later instances share the
+// last slot
+#define DNTL_STAT_INSTANCES 3
+
+typedef enum {
+    DNTL_REJECT_BASIS_ROW = 0,  // basis rows drawn again: their transform has a zero
+    DNTL_REJECT_KEYGEN_ZERO,    // public keys rejected, by the instance after
+                                // which the zero was found (early abort or last)
+    DNTL_REJECT_SIGN_ZERO,      // signatures, likewise
+    DNTL_REJECTS
+} dntl_stat_reject_t;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t ticks;
+} dntl_stat_timer_t;
+
+typedef struct {
+    int enabled;                // built with DNTL_STATS
+    double ticks_hz;            // counter rate (0 when disabled)
+    size_t threads;             // threads that ever recorded (resets keep them)
+    dntl_stat_timer_t stage[DNTL_STAT_STAGES];
+    uint64_t count[DNTL_COUNTERS];
+    uint64_t hist[DNTL_HISTS][DNTL_HIST_BUCKETS];
+    uint64_t reject[DNTL_REJECTS][DNTL_STAT_INSTANCES];
+} dntl_stats_t;
+
+/**
+ * Totals over every thread since the start or the last dntl_stats_reset()
+ *
+ * Thread-safe. The first call calibrates the tick rate (about 10 ms).
+ */
+void dntl_stats_snapshot(dntl_stats_t *out);
+
+/**
+ * Start the totals of later snapshots from zero
+ */
+void dntl_stats_reset(void);
+
+/**
+ * Stable names for export ("ntt_forward", "sign_rejects", ...), or NULL if
+ * out of range
+ */
+const char *dntl_stats_stage_name(int stage);
+const char *dntl_stats_counter_name(int counter);
+const char *dntl_stats_hist_name(int hist);
+const char *dntl_stats_reject_name(int reason);
+
+#ifdef DNTL_STATS
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+typedef struct dntl_stats_block {
+    uint64_t calls[DNTL_STAT_STAGES];
+    uint64_t ticks[DNTL_STAT_STAGES];
+    uint64_t count[DNTL_COUNTERS];
+    uint64_t hist[DNTL_HISTS][DNTL_HIST_BUCKETS];
+    uint64_t reject[DNTL_REJECTS][DNTL_STAT_INSTANCES];
+    uint32_t depth[DNTL_STAT_STAGES];       // owner only
+    struct dntl_stats_block *next;
+} dntl_stats_block_t;
+
+extern _Thread_local dntl_stats_block_t *dntl_stats_tls;
+
+/**
+ * The calling thread's block, allocated and registered on first use
+ *
+ * @return  The block, or NULL if memory runs out (nothing is recorded)
+ */
+dntl_stats_block_t *dntl_stats_register(void);
+
+static inline uint64_t dntl_stats_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline dntl_stats_block_t *dntl_stats_block(void) {
+    dntl_stats_block_t *b = dntl_stats_tls;
+    return b ? b : dntl_stats_register();
+}
+
+// Single writer: a relaxed load and store, not a locked add
+static inline void dntl_stats_add(uint64_t *slot, uint64_t n) {
+    __atomic_store_n(slot, __atomic_load_n(slot, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+typedef struct {
+    dntl_stats_block_t *b;
+    int stage;
+    uint64_t t0;
+} dntl_stat_scope_t;
+
+static inline dntl_stat_scope_t dntl_stat_scope_begin(int stage) {
+    dntl_stat_scope_t s = { dntl_stats_block(), stage, 0 };
+    if (s.b && s.b->depth[stage]++ == 0) {
+        s.t0 = dntl_stats_ticks();
+    }
+    return s;
+}
+
+static inline void dntl_stat_scope_end(const dntl_stat_scope_t *s) {
+    if (s->b && --s->b->depth[s->stage] == 0) {
+        dntl_stats_add(&s->b->ticks[s->stage], dntl_stats_ticks() - s->t0);
+        dntl_stats_add(&s->b->calls[s->stage], 1);
+    }
+}
+
+static inline void dntl_stat_count(int counter, uint64_t n) {
+    dntl_stats_block_t *b = dntl_stats_block();
+    if (b) {
+        dntl_stats_add(&b->count[counter], n);
+    }
+}
+
+static inline void dntl_stat_hist(int hist, uint64_t trials) {
+    dntl_stats_block_t *b = dntl_stats_block();
+    if (b && trials > 0) {
+        const int bucket = 63 - __builtin_clzll(trials);
+        dntl_stats_add(&b->hist[hist][bucket < DNTL_HIST_BUCKETS ? bucket : DNTL_HIST_BUCKETS - 1], 1);
+    }
+}
+
+static inline void dntl_stat_reject(int reason, size_t inst, uint64_t n) {
+    dntl_stats_block_t *b = dntl_stats_block();
+    if (b && n > 0) {
+        dntl_stats_add(&b->reject[reason][inst < DNTL_STAT_INSTANCES ? inst : DNTL_STAT_INSTANCES - 1], n);
+    }
+}
+
+#define DNTL_STAT_CONCAT_(a, b) a##b
+#define DNTL_STAT_CONCAT(a, b) DNTL_STAT_CONCAT_(a, b)
+
+/** Time the rest of the enclosing block as stage */
+#define DNTL_STAT_SCOPE(stage)                                                              \
+    dntl_stat_scope_t DNTL_STAT_CONCAT(dntl_stat_scope_, __LINE__)                          \
+        __attribute__((cleanup(dntl_stat_scope_end), unused)) = dntl_stat_scope_begin(stage)
+
+/** Add n to counter */
+#define DNTL_STAT_COUNT(counter, n) dntl_stat_count((counter), (uint64_t)(n))
+
+/** Record an operation that took trials attempts in hist */
+#define DNTL_STAT_HIST(hist, trials) dntl_stat_hist((hist), (uint64_t)(trials))
+
+/** Add n rejections for reason at basis instance inst */
+#define DNTL_STAT_REJECT(reason, inst, n) dntl_stat_reject((reason), (size_t)(inst), (uint64_t)(n))
+
+#else
+
+#define DNTL_STAT_SCOPE(stage) ((void)0)
+#define DNTL_STAT_COUNT(counter, n) ((void)0)
+// Not evaluated, but trial counters kept only for these stay "used"
+#define DNTL_STAT_HIST(hist, trials) ((void)sizeof(trials))
+#define DNTL_STAT_REJECT(reason, inst, n) ((void)sizeof(inst), (void)sizeof(n))
+
+#endif // DNTL_STATS
+
+#endif // DNTL_STATS_H
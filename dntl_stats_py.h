@@ -0,0 +1,115 @@
+#ifndef DNTL_STATS_PY_H
+#define DNTL_STATS_PY_H
+
+/**
+ * stats() / stats_reset() for the CPython modules (include after Python.h)
+ *
+ * Each module links its own copy of the counters, so dntl_native.stats()
+ * covers its engine and sparse_native.stats() its codecs.
+ */
+
+#include "dntl_stats.h"
+
+// A list of n counts, or NULL with an exception set
+static PyObject *stats_list(const uint64_t *v, size_t n) {
+    PyObject *list = PyList_New((Py_ssize_t)n);
+    for (size_t i = 0; list && i < n; i++) {
+        PyObject *x = PyLong_FromUnsignedLongLong((unsigned long long)v[i]);
+        if (!x) {
+            Py_CLEAR(list);
+            break;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, x);
+    }
+    return list;
+}
+
+// d[name] = [v[0], ..., v[n - 1]]: 0, or -1 with an exception set
+static int stats_set_list(PyObject *d, const char *name, const uint64_t *v, size_t n) {
+    PyObject *list = stats_list(v, n);
+    int ret = list ? PyDict_SetItemString(d, name, list) : -1;
+    Py_XDECREF(list);
+    return ret;
+}
+
+/*
+ * {"enabled": bool, "ticks_hz": float, "threads": int,
+ *  "stages": {name: {"calls": int, "ticks": int}, ...},
+ *  "counters": {name: int, ...},
+ *  "histograms": {name: [operations with 1, 2-3, 4-7, ... trials], ...},
+ *  "rejects": {name: [count per basis instance], ...}}
+ */
+static PyObject *py_stats(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    dntl_stats_t st;
+    dntl_stats_snapshot(&st);
+
+    PyObject *stages = PyDict_New();
+    PyObject *counters = PyDict_New();
+    PyObject *hists = PyDict_New();
+    PyObject *rejects = PyDict_New();
+    if (!stages || !counters || !hists || !rejects) {
+        goto fail;
+    }
+    for (int i = 0; i < DNTL_STAT_STAGES; i++) {
+        PyObject *v = Py_BuildValue("{s:K,s:K}",
+                                    "calls", (unsigned long long)st.stage[i].calls,
+                                    "ticks", (unsigned long long)st.stage[i].ticks);
+        if (!v || PyDict_SetItemString(stages, dntl_stats_stage_name(i), v) != 0) {
+            Py_XDECREF(v);
+            goto fail;
+        }
+        Py_DECREF(v);
+    }
+    for (int i = 0; i < DNTL_COUNTERS; i++) {
+        PyObject *v = PyLong_FromUnsignedLongLong((unsigned long long)st.count[i]);
+        if (!v || PyDict_SetItemString(counters, dntl_stats_counter_name(i), v) != 0) {
+            Py_XDECREF(v);
+            goto fail;
+        }
+        Py_DECREF(v);
+    }
+    for (int i = 0; i < DNTL_HISTS; i++) {
+        if (stats_set_list(hists, dntl_stats_hist_name(i), st.hist[i], DNTL_HIST_BUCKETS) != 0) {
+            goto fail;
+        }
+    }
+    for (int i = 0; i < DNTL_REJECTS; i++) {
+        if (stats_set_list(rejects, dntl_stats_reject_name(i), st.reject[i],
+                           DNTL_STAT_INSTANCES) != 0) {
+            goto fail;
+        }
+    }
+    return Py_BuildValue("{s:O,s:d,s:n,s:N,s:N,s:N,s:N}",
+                         "enabled", st.enabled ? Py_True : Py_False,
+                         "ticks_hz", st.ticks_hz,
+                         "threads", (Py_ssize_t)st.threads,
+                         "stages", stages,
+                         "counters", counters,
+                         "histograms", hists,
+                         "rejects", rejects);
+
+fail:
+    Py_XDECREF(stages);
+    Py_XDECREF(counters);
+    Py_XDECREF(hists);
+    Py_XDECREF(rejects);
+    return NULL;
+}
+
+static PyObject *py_stats_reset(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    dntl_stats_reset();
+    Py_RETURN_NONE;
+}
+
+#define DNTL_STATS_PY_METHODS                                                               \
+    { "stats", py_stats, METH_NOARGS,                                                        \
+      "stats() -> dict of per-stage calls and ticks, event counters, trial histograms and "  \
+      "rejections per basis instance (enabled is False unless built with STATS=1)" },        \
+    { "stats_reset", py_stats_reset, METH_NOARGS,                                            \
+      "stats_reset(): start later stats() totals from zero" },
+
+#endif // DNTL_STATS_PY_H
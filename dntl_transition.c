@@ -0,0 +1,128 @@
+#include "dntl_transition.h"
+#include "dntl_poly.h"
+#include "ntt_plan.h"
+#include <stdlib.h>
+
+struct dntl_transition {
+    size_t n;
+    uint32_t q;
+    uint32_t q2;
+    ntt_plan_t *outer;      // (N, Q, R)
+    ntt_plan_t *inner;      // (N, Q2, R2); NULL when Q == Q2
+};
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// [0, q] -> [0, q)
+static inline uint32_t naturals_to_canonical(uint32_t x, uint32_t q) {
+    return x - (q & -(uint32_t)(x >= q));
+}
+
+// [0, q) -> [1, q]
+static inline uint32_t canonical_to_naturals(uint32_t x, uint32_t q) {
+    return x + (q & -(uint32_t)(x == 0));
+}
+
+// 3x mod q for x in [0, q)
+static inline uint32_t triple_mod(uint32_t x, uint32_t q) {
+    uint64_t t = 3 * (uint64_t)x;
+    t -= (uint64_t)q & -(uint64_t)(t >= q);
+    t -= (uint64_t)q & -(uint64_t)(t >= q);
+    return (uint32_t)t;
+}
+
+// The Q == Q2 transition on len coefficients: x -> 3x, naturals in and out
+static void triple_naturals(uint32_t *poly, size_t len, uint32_t q) {
+    for (size_t i = 0; i < len; i++) {
+        poly[i] = canonical_to_naturals(triple_mod(naturals_to_canonical(poly[i], q), q), q);
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+dntl_transition_t *dntl_transition_create(size_t n, uint32_t q, uint32_t r,
+                                          uint32_t q2, uint32_t r2) {
+    dntl_transition_t *ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) {
+        return NULL;
+    }
+    ctx->n = n;
+    ctx->q = q;
+    ctx->q2 = q2;
+
+    // The plans validate n, the primes and the generators even on the fast path
+    ctx->outer = ntt_plan_create(n, q, r, NTT_PLAN_CYCLIC);
+    ctx->inner = ntt_plan_create(n, q2, r2, NTT_PLAN_CYCLIC);
+    if (!ctx->outer || !ctx->inner) {
+        dntl_transition_destroy(ctx);
+        return NULL;
+    }
+
+    if (q == q2) {
+        ntt_plan_destroy(ctx->inner);
+        ntt_plan_destroy(ctx->outer);
+        ctx->inner = ctx->outer = NULL;
+    }
+    return ctx;
+}
+
+void dntl_transition_destroy(dntl_transition_t *ctx) {
+    if (!ctx) {
+        return;
+    }
+    ntt_plan_destroy(ctx->outer);
+    ntt_plan_destroy(ctx->inner);
+    free(ctx);
+}
+
+void dntl_transition_apply(const dntl_transition_t *ctx, uint32_t *poly) {
+    const size_t n = ctx->n;
+    const uint32_t q = ctx->q;
+
+    if (!ctx->inner) {
+        triple_naturals(poly, n, q);
+        return;
+    }
+
+    // The Q2 transforms only see a pointwise scalar, which commutes with
+    // them, so the round trip through NTT(Q2) cancels: inverse under Q, 3y on
+    // the coefficients read mod Q2, forward under Q
+    dntl_poly_t x;
+    for (size_t i = 0; i < n; i++) {
+        poly[i] = naturals_to_canonical(poly[i], q);
+    }
+    dntl_poly_init(&x, ctx->outer, poly, DNTL_POLY_NTT);
+    dntl_poly_switch(&x, ctx->inner);
+    dntl_poly_scale(&x, 3);
+    dntl_poly_switch(&x, ctx->outer);
+    dntl_poly_forward(&x);
+    dntl_poly_data(&x);
+    for (size_t i = 0; i < n; i++) {
+        poly[i] = canonical_to_naturals(poly[i], q);
+    }
+}
+
+void dntl_transition_apply_batch(const dntl_transition_t *ctx, uint32_t *polys, size_t count) {
+    if (!ctx->inner) {
+        triple_naturals(polys, count * ctx->n, ctx->q);
+        return;
+    }
+    for (size_t p = 0; p < count; p++) {
+        dntl_transition_apply(ctx, polys + p * ctx->n);
+    }
+}
+
+int dntl_transition(uint32_t *poly, size_t n, uint32_t q, uint32_t r,
+                    uint32_t q2, uint32_t r2) {
+    dntl_transition_t *ctx = dntl_transition_create(n, q, r, q2, r2);
+    if (!ctx) {
+        return -1;
+    }
+    dntl_transition_apply(ctx, poly);
+    dntl_transition_destroy(ctx);
+    return 0;
+}
@@ -0,0 +1,69 @@
+#ifndef DNTL_TRANSITION_H
+#define DNTL_TRANSITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// DNTL INSTANCE TRANSITION
+// ============================================================================
+//
+// The chaining step between two DNTL instances in sign, verify and keyGen of
+// dntl-dsa-nat.py:
+//
+//   y = inverse_ntt_naturals(x, Q, R)
+//   z = forward_ntt_naturals(y, Q2, R2)
+//   z = pointwise_addition(pointwise_addition(z, z, Q2), z, Q2)    // 3z
+//   y = inverse_ntt_naturals(z, Q2, R2)
+//   x = forward_ntt_naturals(y, Q, R)
+//
+// All transforms are cyclic of length N. Inputs and outputs use the "naturals"
+// convention of the Python code: coefficients in [1, q], with q standing for
+// zero. Both 0 and q are accepted on input.
+//
+// The sequence is linear. When Q == Q2 the inner transform pair cancels
+// around the scalar 3 and the whole step is x -> 3x mod Q, which is what
+// every shipped configuration uses (Q = Q2 = 257); the kernel then takes one
+// pass over the data instead of four transforms. For Q != Q2 the scalar still
+// commutes with the inner pair, so only the outer inverse and forward run
+// (dntl_poly.h elides the rest).
+
+// Contexts are immutable after creation and may be shared between threads.
+typedef struct dntl_transition dntl_transition_t;
+
+/**
+ * Prepare the transition for one parameter set
+ *
+ * @param n         Polynomial length (power of two, within NTT_PLAN_MAX_N)
+ * @param q, r      Outer modulus and generator (forward_ntt_naturals(Q, R))
+ * @param q2, r2    Inner modulus and generator
+ * @return          New context, or NULL if any transform cannot be planned
+ */
+dntl_transition_t *dntl_transition_create(size_t n, uint32_t q, uint32_t r,
+                                          uint32_t q2, uint32_t r2);
+
+/**
+ * Free a context (NULL is ignored)
+ */
+void dntl_transition_destroy(dntl_transition_t *ctx);
+
+/**
+ * Apply the transition to one polynomial of n coefficients, in place
+ */
+void dntl_transition_apply(const dntl_transition_t *ctx, uint32_t *poly);
+
+/**
+ * Apply the transition to `count` contiguous polynomials (polys[p * n + i])
+ */
+void dntl_transition_apply_batch(const dntl_transition_t *ctx, uint32_t *polys, size_t count);
+
+/**
+ * One-shot form: create, apply, destroy
+ *
+ * @return          0 on success, -1 if the parameters are invalid or
+ *                  allocation fails (poly is then unchanged)
+ */
+int dntl_transition(uint32_t *poly, size_t n, uint32_t q, uint32_t r,
+                    uint32_t q2, uint32_t r2);
+
+#endif // DNTL_TRANSITION_H
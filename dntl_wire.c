@@ -0,0 +1,188 @@
+#include "dntl_wire.h"
+#include "huffman_vector.h"
+#include <string.h>
+
+// ============================================================================
+// HEADER
+// ============================================================================
+
+static const int LEVELS[] = { 1, 3, 5 };
+
+static int level_index(int level) {
+    for (int i = 0; i < 3; i++) {
+        if (LEVELS[i] == level) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static size_t seed_len(const dntl_params_t *p, dntl_wire_kind_t kind) {
+    return kind == DNTL_WIRE_SK ? 0 : p->seed_bytes;
+}
+
+// Values the one-byte coding holds: Q = 257 for every level
+static int wire_params_ok(const dntl_params_t *p, dntl_wire_kind_t kind) {
+    return p && p->q == 257 && p->n <= 256 && level_index(p->level) >= 0 &&
+           (kind == DNTL_WIRE_PK || kind == DNTL_WIRE_SIG || kind == DNTL_WIRE_SK);
+}
+
+size_t dntl_wire_max_bytes(const dntl_params_t *p, dntl_wire_kind_t kind) {
+    if (!wire_params_ok(p, kind)) {
+        return 0;
+    }
+    const size_t coded = 2 + huffman_max_encoded_size(p->n);
+    const size_t escapes = kind == DNTL_WIRE_SK ? 0 : 1 + p->n;
+    return 1 + seed_len(p, kind) + (coded > p->n ? coded : p->n) + escapes;
+}
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+int dntl_wire_encode(const dntl_params_t *p, dntl_wire_kind_t kind, const uint32_t *coeffs,
+                     const uint8_t *seed, int coded, uint8_t *out, size_t out_cap,
+                     size_t *written) {
+    if (!wire_params_ok(p, kind)) {
+        return -1;
+    }
+    const size_t n = p->n, s = seed_len(p, kind);
+    uint8_t bytes[DNTL_MAX_N];
+    uint8_t escapes[DNTL_MAX_N];
+    size_t n_escapes = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t c = coeffs[i];
+        if (c >= 1 && c <= 256) {
+            bytes[i] = (uint8_t)(c - 1);
+        } else if (kind != DNTL_WIRE_SK && (c == 0 || c == p->q)) {
+            bytes[i] = c != 0;
+            escapes[n_escapes++] = (uint8_t)i;
+        } else {
+            return -1;
+        }
+    }
+
+    // Header and seed first; the body is built in place behind them
+    const size_t escape_bytes = n_escapes ? 1 + n_escapes : 0;
+    if (out_cap < 1 + s + n + escape_bytes) {
+        return -1;
+    }
+    int mode = n_escapes ? DNTL_WIRE_ESCAPED : 0;
+    size_t pos = 1 + s;
+    memcpy(out + 1, seed, s);
+
+    size_t body = n;
+    if (coded && out_cap > pos + 2 + escape_bytes &&
+        huffman_encode_into(bytes, n, out + pos + 2, out_cap - pos - 2 - escape_bytes,
+                            &body) == 0 && 2 + body < n) {
+        out[pos] = (uint8_t)body;
+        out[pos + 1] = (uint8_t)(body >> 8);
+        mode |= DNTL_WIRE_CODED;
+        body += 2;
+    } else {
+        memcpy(out + pos, bytes, n);
+        body = n;
+    }
+    pos += body;
+
+    if (n_escapes) {
+        out[pos++] = (uint8_t)(n_escapes - 1);
+        memcpy(out + pos, escapes, n_escapes);
+        pos += n_escapes;
+    }
+    out[0] = (uint8_t)((DNTL_WIRE_VERSION << 6) | (level_index(p->level) << 4) |
+                       ((int)kind << 2) | mode);
+    *written = pos;
+    return 0;
+}
+
+// ============================================================================
+// PARSING
+// ============================================================================
+
+int dntl_wire_parse(const uint8_t *buf, size_t len, dntl_wire_view_t *view) {
+    if (len < 1 || buf[0] >> 6 != DNTL_WIRE_VERSION || ((buf[0] >> 4) & 3) == 3) {
+        return -1;
+    }
+    const dntl_params_t *p = dntl_params(LEVELS[(buf[0] >> 4) & 3]);
+    const dntl_wire_kind_t kind = (dntl_wire_kind_t)((buf[0] >> 2) & 3);
+    const int mode = buf[0] & 3;
+    if (!wire_params_ok(p, kind) || (kind == DNTL_WIRE_SK && (mode & DNTL_WIRE_ESCAPED))) {
+        return -1;
+    }
+    const size_t n = p->n, s = seed_len(p, kind);
+    size_t pos = 1;
+
+    if (len - pos < s) {
+        return -1;
+    }
+    view->params = p;
+    view->kind = kind;
+    view->mode = mode;
+    view->seed = s ? buf + pos : NULL;
+    pos += s;
+
+    if (mode & DNTL_WIRE_CODED) {
+        if (len - pos < 2) {
+            return -1;
+        }
+        view->body_len = (size_t)buf[pos] | ((size_t)buf[pos + 1] << 8);
+        pos += 2;
+    } else {
+        view->body_len = n;
+    }
+    if (len - pos < view->body_len) {
+        return -1;
+    }
+    view->body = buf + pos;
+    pos += view->body_len;
+
+    view->escapes = NULL;
+    view->n_escapes = 0;
+    if (mode & DNTL_WIRE_ESCAPED) {
+        if (len - pos < 1) {
+            return -1;
+        }
+        view->n_escapes = (size_t)buf[pos++] + 1;
+        view->escapes = buf + pos;
+        if (len - pos < view->n_escapes || view->n_escapes > n) {
+            return -1;
+        }
+        for (size_t e = 0; e < view->n_escapes; e++) {
+            if (view->escapes[e] >= n || (e && view->escapes[e] <= view->escapes[e - 1])) {
+                return -1;
+            }
+            // Escaped body bytes can only be checked here when packed
+            if (!(mode & DNTL_WIRE_CODED) && view->body[view->escapes[e]] > 1) {
+                return -1;
+            }
+        }
+        pos += view->n_escapes;
+    }
+    return pos == len ? 0 : -1;
+}
+
+int dntl_wire_coeffs(const dntl_wire_view_t *view, uint32_t *coeffs) {
+    const dntl_params_t *p = view->params;
+    uint8_t decoded[DNTL_MAX_N];
+    const uint8_t *bytes = view->body;
+
+    if (view->mode & DNTL_WIRE_CODED) {
+        if (huffman_decode(view->body, view->body_len, decoded, p->n) != 0) {
+            return -1;
+        }
+        bytes = decoded;
+    }
+    for (size_t i = 0; i < p->n; i++) {
+        coeffs[i] = (uint32_t)bytes[i] + 1;
+    }
+    for (size_t e = 0; e < view->n_escapes; e++) {
+        const uint8_t i = view->escapes[e];
+        if (bytes[i] > 1) {
+            return -1;
+        }
+        coeffs[i] = bytes[i] ? p->q : 0;
+    }
+    return 0;
+}
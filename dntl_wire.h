@@ -0,0 +1,107 @@
+#ifndef DNTL_WIRE_H
+#define DNTL_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dntl_dsa.h"
+
+// ============================================================================
+// WIRE FORMAT
+// ============================================================================
+//
+// Public keys, signatures and secret keys as bytes. Coefficients of a
+// well-formed key or signature are in [1, 256] (Q = 257, zeros rejected),
+// so each takes one byte, value - 1:
+//
+//   byte 0          header: version (bits 7-6, 1), level (bits 5-4: 0, 1,
+//                   2 for levels 1, 3, 5), kind (bits 3-2), mode (bits 1-0)
+//   seed_bytes      PK_C of a public key, u of a signature (none for sk)
+//   body            packed: N coefficient bytes
+//                   coded: 2-byte little-endian length, then the same N
+//                   bytes as one Huffman stream (huffman_vector.h)
+//   escapes         if mode bit 0: count - 1, then count ascending
+//                   positions; the coefficient there is 0 if its body byte is
+//                   0, and Q if it is 1
+//
+// Packed public keys and signatures are 1 + 80 / 152 / 288 bytes for levels
+// 1 / 3 / 5. The escapes carry the values 0 and Q that dntl_verify() accepts
+// (and rejects), so any input round-trips and is hashed as given.
+//
+// Parsing checks the whole layout but copies nothing: the view points into
+// the buffer, and dntl_verify_wire() reads the packed coefficients in place.
+
+#define DNTL_WIRE_VERSION 1
+
+typedef enum {
+    DNTL_WIRE_PK = 0,
+    DNTL_WIRE_SIG = 1,
+    DNTL_WIRE_SK = 2,
+} dntl_wire_kind_t;
+
+// Mode bits of the header
+#define DNTL_WIRE_ESCAPED 1
+#define DNTL_WIRE_CODED   2
+
+/**
+ * A parsed encoding; every pointer is into the parsed buffer
+ */
+typedef struct {
+    const dntl_params_t *params;
+    dntl_wire_kind_t kind;
+    int mode;
+    const uint8_t *seed;        // seed_bytes, NULL for a secret key
+    const uint8_t *body;        // N bytes if packed, body_len coded bytes if not
+    size_t body_len;
+    const uint8_t *escapes;     // n_escapes positions
+    size_t n_escapes;
+} dntl_wire_view_t;
+
+/**
+ * Largest encoding of a kind at a level (coded or not, every escape)
+ *
+ * @return          Size in bytes, or 0 for an unknown level or kind
+ */
+size_t dntl_wire_max_bytes(const dntl_params_t *p, dntl_wire_kind_t kind);
+
+/**
+ * Encode N coefficients and the seed of their kind
+ *
+ * @param coeffs    pk or sig values in [0, Q], sk values in [1, 256]
+ * @param seed      PK_C or u (seed_bytes), ignored for a secret key
+ * @param coded     Nonzero to entropy-code the body when that is smaller;
+ *                  public keys and signatures are near uniform and rarely
+ *                  gain, secret keys do
+ * @param written   Out: bytes used
+ * @return          0, or -1 for a value out of range or if out_cap is short
+ */
+int dntl_wire_encode(const dntl_params_t *p, dntl_wire_kind_t kind, const uint32_t *coeffs,
+                     const uint8_t *seed, int coded, uint8_t *out, size_t out_cap,
+                     size_t *written);
+
+/**
+ * Check an encoding and point a view into it
+ *
+ * @return          0, or -1 if the header, length or escapes are malformed
+ *                  (a coded body is only checked when unpacked)
+ */
+int dntl_wire_parse(const uint8_t *buf, size_t len, dntl_wire_view_t *view);
+
+/**
+ * The N coefficients of a view, as dntl_wire_encode() took them
+ *
+ * @return          0, or -1 if a coded body does not decode
+ */
+int dntl_wire_coeffs(const dntl_wire_view_t *view, uint32_t *coeffs);
+
+/**
+ * dntl_verify() on parsed public key and signature views (in dntl_dsa.c)
+ *
+ * Packed coefficients are loaded and hashed straight from the buffers.
+ *
+ * @return          Same as dntl_verify(); 0 if the views are not a public
+ *                  key and a signature of ctx's level
+ */
+int dntl_verify_wire(const dntl_ctx_t *ctx, const uint8_t *m, size_t m_len,
+                     const dntl_wire_view_t *pk, const dntl_wire_view_t *sig);
+
+#endif // DNTL_WIRE_H
@@ -1,3 +1,5 @@
+#include "gaussian_sampler.h"
+#include "gaussian_sampler_poly.h"
 #include <stdint.h>
 #include <math.h>
 #include <string.h>
@@ -6,7 +8,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-#define N 64
+#define N GAUSSIAN_N
 
 // Helper function for rotation
 static inline uint64_t rotl(uint64_t x, int k) {
@@ -108,3 +110,283 @@ void gaussian_sample(const uint8_t seed[32], int output[N], double mean, double
     #undef NEXT_RANDOM
 }
 
+
+// ============================================================================
+// BATCH SAMPLER: scalar path, one seed at a time
+// ============================================================================
+
+static inline uint64_t as_bits(double x) {
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static inline double as_double(uint64_t u) {
+    double x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+// log(x) for x in [2^-53, 1), as the SIMD paths compute it
+static inline double batch_log(double x) {
+    const uint64_t bits = as_bits(x);
+    double m = as_double((bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+    double k = as_double(GS_EXP_MAGIC | (bits >> 52)) - GS_EXP_OFFSET;
+    if (m > GS_SQRT2) {
+        m *= 0.5;
+        k += 1.0;
+    }
+    const double f = m - 1.0;
+    const double s = f / (2.0 + f);
+    const double z = s * s;
+    double p = GS_LG7;
+    p = fma(p, z, GS_LG6);
+    p = fma(p, z, GS_LG5);
+    p = fma(p, z, GS_LG4);
+    p = fma(p, z, GS_LG3);
+    p = fma(p, z, GS_LG2);
+    p = fma(p, z, GS_LG1);
+    const double r = p * z;
+    const double h = 0.5 * f;
+    const double inner = fma(s, fma(h, f, r), k * GS_LN2_LO);
+    return fma(k, GS_LN2_HI, f - fma(h, f, -inner));
+}
+
+// cos and sin of 2 pi u for u in [0, 1)
+static inline void batch_sincos(double u, double *c, double *s) {
+    const double t = u * 4.0;
+    const double q = nearbyint(t);
+    const double x = (t - q) * GS_PI_2;
+    const double z = x * x;
+    double ps = GS_S6, pc = GS_C6;
+    ps = fma(ps, z, GS_S5);
+    pc = fma(pc, z, GS_C5);
+    ps = fma(ps, z, GS_S4);
+    pc = fma(pc, z, GS_C4);
+    ps = fma(ps, z, GS_S3);
+    pc = fma(pc, z, GS_C3);
+    ps = fma(ps, z, GS_S2);
+    pc = fma(pc, z, GS_C2);
+    ps = fma(ps, z, GS_S1);
+    pc = fma(pc, z, GS_C1);
+    const double sn = fma(x * z, ps, x);
+    const double cs = fma(z * z, pc, fma(-0.5, z, 1.0));
+    switch ((int)q & 3) {
+    case 0: *c = cs;  *s = sn;  break;
+    case 1: *c = -sn; *s = cs;  break;
+    case 2: *c = -cs; *s = -sn; break;
+    default: *c = sn; *s = -cs; break;
+    }
+}
+
+// xoshiro256** step, as NEXT_RANDOM in gaussian_sample()
+static inline uint64_t stream_next(uint64_t s[4]) {
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+// ============================================================================
+// STREAM SAMPLER
+// ============================================================================
+
+void gaussian_stream_init(gaussian_stream_t *st, const uint8_t seed[32], double mean,
+                          double stddev, double bound_sigma) {
+    memcpy(st->s, seed, 32);
+    if (st->s[0] == 0 && st->s[1] == 0 && st->s[2] == 0 && st->s[3] == 0) {
+        st->s[0] = 0x123456789ABCDEF0ULL;
+    }
+    st->mean = mean;
+    st->stddev = stddev;
+    st->lower = mean - bound_sigma * stddev;
+    st->upper = mean + bound_sigma * stddev;
+    st->use_bounds = bound_sigma > 0.0;
+    st->has_pending = 0;
+    st->pending = 0;
+}
+
+void gaussian_stream_fill(gaussian_stream_t *st, int *output, size_t count) {
+    size_t filled = 0;
+    if (count > 0 && st->has_pending) {
+        output[filled++] = st->pending;
+        st->has_pending = 0;
+    }
+
+    // Candidates in pairs, z0 then z1, each kept if in bounds; a kept z1
+    // that does not fit waits for the next call
+    while (filled < count) {
+        double u1 = (stream_next(st->s) >> 11) * 0x1.0p-53;
+        double u2 = (stream_next(st->s) >> 11) * 0x1.0p-53;
+        if (u1 == 0.0) {
+            u1 = 0x1.0p-53;
+        }
+
+        double c, s;
+        batch_sincos(u2, &c, &s);
+        const double mag = sqrt(-2.0 * batch_log(u1)) * st->stddev;
+        const double z[2] = { fma(mag, c, st->mean), fma(mag, s, st->mean) };
+        for (int j = 0; j < 2; j++) {
+            if (!st->use_bounds || (z[j] >= st->lower && z[j] <= st->upper)) {
+                if (filled < count) {
+                    output[filled++] = (int)round(z[j]);
+                } else {
+                    st->pending = (int)round(z[j]);
+                    st->has_pending = 1;
+                }
+            }
+        }
+    }
+}
+
+// Advance the generator by the polynomial in jump
+static void stream_jump_by(gaussian_stream_t *st, const uint64_t jump[4]) {
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                s[0] ^= st->s[0];
+                s[1] ^= st->s[1];
+                s[2] ^= st->s[2];
+                s[3] ^= st->s[3];
+            }
+            stream_next(st->s);
+        }
+    }
+    memcpy(st->s, s, sizeof(s));
+    st->has_pending = 0;
+}
+
+void gaussian_stream_jump(gaussian_stream_t *st) {
+    static const uint64_t jump[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                      0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+    stream_jump_by(st, jump);
+}
+
+void gaussian_stream_long_jump(gaussian_stream_t *st) {
+    static const uint64_t jump[4] = { 0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+                                      0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+    stream_jump_by(st, jump);
+}
+
+// ============================================================================
+// BATCH SAMPLER: scalar path, one stream per seed
+// ============================================================================
+
+void gaussian_sample_batch_scalar(const uint8_t (*seeds)[32], size_t count,
+                                  int (*output)[GAUSSIAN_N],
+                                  double mean, double stddev, double bound_sigma) {
+    gaussian_stream_t st;
+    for (size_t i = 0; i < count; i++) {
+        gaussian_stream_init(&st, seeds[i], mean, stddev, bound_sigma);
+        gaussian_stream_fill(&st, output[i], GAUSSIAN_N);
+    }
+}
+
+// ============================================================================
+// BATCH SAMPLER: dispatch
+// ============================================================================
+
+typedef void (*batch_fn)(const uint8_t (*)[32], size_t, int (*)[GAUSSIAN_N],
+                         double, double, double);
+
+static batch_fn batch_select(const char **name) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+#ifdef __AVX512F__
+    if (__builtin_cpu_supports("avx512f")) {
+        *name = "avx512";
+        return gaussian_sample_batch_avx512;
+    }
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        *name = "avx2";
+        return gaussian_sample_batch_avx2;
+    }
+#endif
+#endif
+    *name = "scalar";
+    return gaussian_sample_batch_scalar;
+}
+
+void gaussian_sample_batch(const uint8_t (*seeds)[32], size_t count, int (*output)[GAUSSIAN_N],
+                           double mean, double stddev, double bound_sigma) {
+    const char *name;
+    batch_select(&name)(seeds, count, output, mean, stddev, bound_sigma);
+}
+
+const char *gaussian_sample_batch_path(void) {
+    const char *name;
+    batch_select(&name);
+    return name;
+}
+
+// ============================================================================
+// CDT SAMPLER: constant-time scan of 64-bit cumulative thresholds
+// ============================================================================
+
+int gaussian_cdt_init(gaussian_cdt_t *cdt, double mean, double sigma, const int *support,
+                      int count) {
+    if (!cdt || !support || count < 1 || count > GAUSSIAN_CDT_MAX || !(sigma > 0.0) ||
+        !isfinite(sigma) || !isfinite(mean)) {
+        return -1;
+    }
+
+    // Weights in long double, whose 64-bit mantissa covers the thresholds
+    long double weight[GAUSSIAN_CDT_MAX], total = 0.0L;
+    const long double scale = 2.0L * (long double)sigma * (long double)sigma;
+    for (int i = 0; i < count; i++) {
+        const long double d = (long double)support[i] - (long double)mean;
+        weight[i] = expl(-d * d / scale);
+        total += weight[i];
+    }
+    if (!(total > 0.0L)) {
+        return -1;
+    }
+
+    long double cumulative = 0.0L;
+    cdt->count = count;
+    for (int i = 0; i < count; i++) {
+        cdt->values[i] = support[i];
+        if (i == count - 1) {
+            break;
+        }
+        cumulative += weight[i];
+        const long double t = roundl(ldexpl(cumulative / total, 64));
+        cdt->threshold[i] = t >= 0x1.0p64L ? UINT64_MAX : (uint64_t)t;
+    }
+    return 0;
+}
+
+// 1 if a < b, without a branch or a flag-dependent instruction
+static inline uint64_t ct_lt(uint64_t a, uint64_t b) {
+    return (a ^ ((a ^ b) | ((a - b) ^ b))) >> 63;
+}
+
+void gaussian_sample_cdt(const gaussian_cdt_t *cdt, const uint8_t seed[32],
+                         int output[GAUSSIAN_N]) {
+    uint64_t state[4];
+    memcpy(state, seed, 32);
+
+    // The all-zero seed fixed up as gaussian_sample() does, with a mask
+    const uint64_t any = state[0] | state[1] | state[2] | state[3];
+    state[0] |= 0x123456789ABCDEF0ULL & (((any | (0 - any)) >> 63) - 1);
+
+    for (int i = 0; i < N; i++) {
+        const uint64_t r = stream_next(state);
+
+        // Every threshold at or below r steps to the next value
+        int64_t v = cdt->values[0];
+        for (int j = 0; j + 1 < cdt->count; j++) {
+            const int64_t step = (int64_t)cdt->values[j + 1] - cdt->values[j];
+            v += step & -(int64_t)(1 - ct_lt(r, cdt->threshold[j]));
+        }
+        output[i] = (int)v;
+    }
+}
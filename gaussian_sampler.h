@@ -0,0 +1,145 @@
+/**
+ * gaussian_sampler.h
+ *
+ * Gaussian samples from a 256-bit seed: xoshiro256**, Box-Muller, tail
+ * clipping by rejection
+ *
+ * gaussian_sample() is the single-seed sampler, on libm. The batch sampler
+ * runs one seed per SIMD lane (8 for AVX-512, 4 for AVX2), with polynomial
+ * log and sincos and rejection per sample instead of per pair: its values
+ * differ from gaussian_sample()'s for the same seed, but are the same on
+ * every path, scalar included, so outputs do not depend on the CPU.
+ *
+ * The CDT sampler is for narrow supports, such as keygen's sigma 1-1.3
+ * over 1..5: a table of 64-bit cumulative thresholds per (mean, sigma,
+ * support), scanned in full for every 64-bit random word, so it draws the
+ * discrete Gaussian itself, to within 2^-64 per value, in constant time.
+ */
+
+#ifndef GAUSSIAN_SAMPLER_H
+#define GAUSSIAN_SAMPLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Samples per seed */
+#define GAUSSIAN_N 64
+
+/**
+ * GAUSSIAN_N rounded samples of N(mean, stddev^2) from seed
+ *
+ * @param bound_sigma Samples further than bound_sigma * stddev from the mean
+ *                    are redrawn (both of their pair); 0.0 for no bound
+ */
+void gaussian_sample(const uint8_t seed[32], int output[GAUSSIAN_N], double mean, double stddev,
+                     double bound_sigma);
+
+/**
+ * GAUSSIAN_N rounded samples for each of count seeds, on the widest path
+ * the CPU supports
+ *
+ * Each candidate is kept or redrawn on its own; the sequence of a seed is
+ * fixed, whatever the path and however many seeds run beside it.
+ *
+ * @param seeds  count seeds of 32 bytes
+ * @param output count rows of GAUSSIAN_N samples
+ */
+void gaussian_sample_batch(const uint8_t (*seeds)[32], size_t count, int (*output)[GAUSSIAN_N],
+                           double mean, double stddev, double bound_sigma);
+
+/**
+ * The batch sampler's paths, for tests; the ISA ones exist when built
+ * with -mavx2 -mfma / -mavx512f and need the CPU to support them
+ */
+void gaussian_sample_batch_scalar(const uint8_t (*seeds)[32], size_t count,
+                                  int (*output)[GAUSSIAN_N],
+                                  double mean, double stddev, double bound_sigma);
+
+#if defined(__AVX2__) && defined(__FMA__)
+void gaussian_sample_batch_avx2(const uint8_t (*seeds)[32], size_t count,
+                                int (*output)[GAUSSIAN_N],
+                                double mean, double stddev, double bound_sigma);
+#endif
+
+#ifdef __AVX512F__
+void gaussian_sample_batch_avx512(const uint8_t (*seeds)[32], size_t count,
+                                  int (*output)[GAUSSIAN_N],
+                                  double mean, double stddev, double bound_sigma);
+#endif
+
+/**
+ * Name of the path gaussian_sample_batch() takes: "avx512", "avx2" or "scalar"
+ */
+const char *gaussian_sample_batch_path(void);
+
+/**
+ * Gaussian stream: the batch sampler's sequence for one seed, of any length
+ *
+ * The first GAUSSIAN_N samples are gaussian_sample_batch()'s row for the
+ * seed; filling in pieces gives the same sequence as one fill, since a
+ * candidate drawn but not yet returned is kept for the next call.
+ */
+typedef struct {
+    uint64_t s[4];              /* xoshiro256** state */
+    double mean, stddev;
+    double lower, upper;
+    int use_bounds;
+    int has_pending;            /* pending is the next sample */
+    int pending;
+} gaussian_stream_t;
+
+/**
+ * Start the stream of seed; bound_sigma as for gaussian_sample()
+ */
+void gaussian_stream_init(gaussian_stream_t *st, const uint8_t seed[32], double mean,
+                          double stddev, double bound_sigma);
+
+/**
+ * Next count samples of the stream
+ */
+void gaussian_stream_fill(gaussian_stream_t *st, int *output, size_t count);
+
+/**
+ * Move the stream 2^128 generator steps ahead (2^192 for the long jump)
+ *
+ * For reproducible parallel runs, substream i is a copy of the initialized
+ * stream jumped i times: each one has 2^128 steps, 2^127 candidate pairs,
+ * before it runs into the next. A pending sample is dropped.
+ */
+void gaussian_stream_jump(gaussian_stream_t *st);
+void gaussian_stream_long_jump(gaussian_stream_t *st);
+
+/* Most values a CDT sampler's support may hold */
+#define GAUSSIAN_CDT_MAX 64
+
+/**
+ * Cumulative distribution table of a discrete Gaussian over a finite support
+ *
+ * Value i is drawn when a uniform 64-bit word r has exactly i thresholds at
+ * or below it; the last value takes the rest of the range.
+ */
+typedef struct {
+    int count;                                  /* values in the support */
+    int values[GAUSSIAN_CDT_MAX];
+    uint64_t threshold[GAUSSIAN_CDT_MAX - 1];   /* 2^64 * P(value <= values[i]) */
+} gaussian_cdt_t;
+
+/**
+ * Build the table for P(v) proportional to exp(-(v - mean)^2 / (2 sigma^2))
+ * on the count values of support, in the order given
+ *
+ * @return 0, or -1 if count is not in 1..GAUSSIAN_CDT_MAX or sigma is not
+ *         positive and finite
+ */
+int gaussian_cdt_init(gaussian_cdt_t *cdt, double mean, double sigma, const int *support,
+                      int count);
+
+/**
+ * GAUSSIAN_N samples from cdt, one xoshiro256** word each, from seed
+ *
+ * Time and memory accesses depend on neither the seed nor the samples.
+ */
+void gaussian_sample_cdt(const gaussian_cdt_t *cdt, const uint8_t seed[32],
+                         int output[GAUSSIAN_N]);
+
+#endif /* GAUSSIAN_SAMPLER_H */
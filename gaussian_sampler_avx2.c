@@ -0,0 +1,204 @@
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include "gaussian_sampler.h"
+#include "gaussian_sampler_poly.h"
+#include <immintrin.h>
+#include <string.h>
+
+#define LANES 4
+
+// ============================================================================
+// AVX2 BATCH SAMPLER: one seed per 64-bit lane
+// ============================================================================
+
+typedef struct {
+    __m256i s[4];
+} lanes_state_t;
+
+static inline __m256i rotl_epi64(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+static inline __m256i times5(__m256i x) {
+    return _mm256_add_epi64(_mm256_slli_epi64(x, 2), x);
+}
+
+static inline __m256i times9(__m256i x) {
+    return _mm256_add_epi64(_mm256_slli_epi64(x, 3), x);
+}
+
+// xoshiro256** in every lane
+static inline __m256i next_random(lanes_state_t *st) {
+    __m256i *s = st->s;
+    const __m256i result = times9(rotl_epi64(times5(s[1]), 7));
+    const __m256i t = _mm256_slli_epi64(s[1], 17);
+    s[2] = _mm256_xor_si256(s[2], s[0]);
+    s[3] = _mm256_xor_si256(s[3], s[1]);
+    s[1] = _mm256_xor_si256(s[1], s[2]);
+    s[0] = _mm256_xor_si256(s[0], s[3]);
+    s[2] = _mm256_xor_si256(s[2], t);
+    s[3] = rotl_epi64(s[3], 45);
+    return result;
+}
+
+// Integer below 2^52 to double, exactly
+static inline __m256d small_to_pd(__m256i x) {
+    const __m256i magic = _mm256_set1_epi64x((long long)GS_EXP_MAGIC);
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(x, magic)),
+                         _mm256_set1_pd(0x1.0p52));
+}
+
+// (r >> 11) * 2^-53, exactly: the 53 bits as 27 high and 26 low
+static inline __m256d to_unit(__m256i r) {
+    const __m256i v = _mm256_srli_epi64(r, 11);
+    const __m256d hi = small_to_pd(_mm256_srli_epi64(v, 26));
+    const __m256d lo = small_to_pd(_mm256_and_si256(v, _mm256_set1_epi64x((1LL << 26) - 1)));
+    return _mm256_mul_pd(_mm256_fmadd_pd(hi, _mm256_set1_pd(0x1.0p26), lo),
+                         _mm256_set1_pd(0x1.0p-53));
+}
+
+static inline __m256d log_pd(__m256d x) {
+    const __m256i bits = _mm256_castpd_si256(x);
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+        _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    __m256d k = _mm256_sub_pd(
+        _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                            _mm256_set1_epi64x((long long)GS_EXP_MAGIC))),
+        _mm256_set1_pd(GS_EXP_OFFSET));
+    const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(GS_SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    k = _mm256_blendv_pd(k, _mm256_add_pd(k, _mm256_set1_pd(1.0)), big);
+
+    const __m256d f = _mm256_sub_pd(m, _mm256_set1_pd(1.0));
+    const __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+    const __m256d z = _mm256_mul_pd(s, s);
+    __m256d p = _mm256_set1_pd(GS_LG7);
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG6));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG5));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG4));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG3));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG2));
+    p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(GS_LG1));
+    const __m256d r = _mm256_mul_pd(p, z);
+    const __m256d h = _mm256_mul_pd(_mm256_set1_pd(0.5), f);
+    const __m256d inner = _mm256_fmadd_pd(s, _mm256_fmadd_pd(h, f, r),
+                                          _mm256_mul_pd(k, _mm256_set1_pd(GS_LN2_LO)));
+    return _mm256_fmadd_pd(k, _mm256_set1_pd(GS_LN2_HI),
+                           _mm256_sub_pd(f, _mm256_fmsub_pd(h, f, inner)));
+}
+
+static inline void sincos_pd(__m256d u, __m256d *c, __m256d *s) {
+    const __m256d t = _mm256_mul_pd(u, _mm256_set1_pd(4.0));
+    const __m256d q = _mm256_round_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m256d x = _mm256_mul_pd(_mm256_sub_pd(t, q), _mm256_set1_pd(GS_PI_2));
+    const __m256d z = _mm256_mul_pd(x, x);
+    __m256d ps = _mm256_set1_pd(GS_S6), pc = _mm256_set1_pd(GS_C6);
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(GS_S5));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(GS_C5));
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(GS_S4));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(GS_C4));
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(GS_S3));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(GS_C3));
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(GS_S2));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(GS_C2));
+    ps = _mm256_fmadd_pd(ps, z, _mm256_set1_pd(GS_S1));
+    pc = _mm256_fmadd_pd(pc, z, _mm256_set1_pd(GS_C1));
+    const __m256d sn = _mm256_fmadd_pd(_mm256_mul_pd(x, z), ps, x);
+    const __m256d cs = _mm256_fmadd_pd(_mm256_mul_pd(z, z), pc,
+                                       _mm256_fmadd_pd(_mm256_set1_pd(-0.5), z,
+                                                       _mm256_set1_pd(1.0)));
+
+    // Quadrant q & 3 from the low bits of q + 2^52: odd swaps, then signs
+    const __m256i qi = _mm256_and_si256(
+        _mm256_castpd_si256(_mm256_add_pd(q, _mm256_set1_pd(0x1.0p52))),
+        _mm256_set1_epi64x(3));
+    const __m256d odd = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+        _mm256_and_si256(qi, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+    const __m256d a = _mm256_blendv_pd(cs, sn, odd);
+    const __m256d b = _mm256_blendv_pd(sn, cs, odd);
+    const __m256i neg_c = _mm256_slli_epi64(
+        _mm256_and_si256(_mm256_xor_si256(qi, _mm256_srli_epi64(qi, 1)),
+                         _mm256_set1_epi64x(1)), 63);
+    const __m256i neg_s = _mm256_slli_epi64(_mm256_srli_epi64(qi, 1), 63);
+    *c = _mm256_castsi256_pd(_mm256_xor_si256(_mm256_castpd_si256(a), neg_c));
+    *s = _mm256_castsi256_pd(_mm256_xor_si256(_mm256_castpd_si256(b), neg_s));
+}
+
+// round(): half away from zero
+static inline __m128i round_epi32(__m256d z) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d t = _mm256_round_pd(z, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256d d = _mm256_andnot_pd(sign, _mm256_sub_pd(z, t));
+    const __m256d up = _mm256_cmp_pd(d, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+    const __m256d one = _mm256_or_pd(_mm256_and_pd(z, sign), _mm256_set1_pd(1.0));
+    return _mm256_cvttpd_epi32(_mm256_add_pd(t, _mm256_and_pd(up, one)));
+}
+
+void gaussian_sample_batch_avx2(const uint8_t (*seeds)[32], size_t count,
+                                int (*output)[GAUSSIAN_N],
+                                double mean, double stddev, double bound_sigma) {
+    const int use_bounds = bound_sigma > 0.0;
+    const __m256d lower = _mm256_set1_pd(mean - bound_sigma * stddev);
+    const __m256d upper = _mm256_set1_pd(mean + bound_sigma * stddev);
+    const __m256d mean_v = _mm256_set1_pd(mean);
+    const __m256d stddev_v = _mm256_set1_pd(stddev);
+
+    for (size_t base = 0; base < count; base += LANES) {
+        const int lanes = count - base < LANES ? (int)(count - base) : LANES;
+
+        // Lane states, seeds transposed; lanes past the end run on seed 0, unused
+        uint64_t init[4][LANES];
+        int kept[LANES];
+        for (int l = 0; l < LANES; l++) {
+            uint64_t st[4];
+            memcpy(st, seeds[base + (l < lanes ? (size_t)l : 0)], 32);
+            if (st[0] == 0 && st[1] == 0 && st[2] == 0 && st[3] == 0) {
+                st[0] = 0x123456789ABCDEF0ULL;
+            }
+            for (int w = 0; w < 4; w++) init[w][l] = st[w];
+            kept[l] = l < lanes ? 0 : GAUSSIAN_N;
+        }
+        lanes_state_t st;
+        for (int w = 0; w < 4; w++) st.s[w] = _mm256_loadu_si256((const __m256i *)init[w]);
+
+        int done = LANES - lanes;
+        while (done < LANES) {
+            const __m256i r1 = next_random(&st);
+            const __m256i r2 = next_random(&st);
+            const __m256d u1 = _mm256_max_pd(to_unit(r1), _mm256_set1_pd(0x1.0p-53));
+            const __m256d u2 = to_unit(r2);
+
+            __m256d c, s;
+            sincos_pd(u2, &c, &s);
+            const __m256d mag = _mm256_mul_pd(
+                _mm256_sqrt_pd(_mm256_mul_pd(_mm256_set1_pd(-2.0), log_pd(u1))), stddev_v);
+            const __m256d z0 = _mm256_fmadd_pd(mag, c, mean_v);
+            const __m256d z1 = _mm256_fmadd_pd(mag, s, mean_v);
+
+            unsigned ok0 = 0xF, ok1 = 0xF;
+            if (use_bounds) {
+                ok0 = (unsigned)_mm256_movemask_pd(_mm256_and_pd(
+                    _mm256_cmp_pd(z0, lower, _CMP_GE_OQ), _mm256_cmp_pd(z0, upper, _CMP_LE_OQ)));
+                ok1 = (unsigned)_mm256_movemask_pd(_mm256_and_pd(
+                    _mm256_cmp_pd(z1, lower, _CMP_GE_OQ), _mm256_cmp_pd(z1, upper, _CMP_LE_OQ)));
+            }
+            int v0[LANES], v1[LANES];
+            _mm_storeu_si128((__m128i *)v0, round_epi32(z0));
+            _mm_storeu_si128((__m128i *)v1, round_epi32(z1));
+
+            // Each lane keeps its candidates in order, z0 then z1
+            for (int l = 0; l < lanes; l++) {
+                int *row = output[base + (size_t)l];
+                if (kept[l] < GAUSSIAN_N && (ok0 >> l & 1)) row[kept[l]++] = v0[l];
+                if (kept[l] < GAUSSIAN_N && (ok1 >> l & 1)) row[kept[l]++] = v1[l];
+                if (kept[l] == GAUSSIAN_N) {
+                    kept[l]++;
+                    done++;
+                }
+            }
+        }
+    }
+}
+
+#endif /* __AVX2__ && __FMA__ */
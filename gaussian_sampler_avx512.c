@@ -0,0 +1,199 @@
+#ifdef __AVX512F__
+
+#include "gaussian_sampler.h"
+#include "gaussian_sampler_poly.h"
+#include <immintrin.h>
+#include <string.h>
+
+#define LANES 8
+
+// ============================================================================
+// AVX-512 BATCH SAMPLER: one seed per 64-bit lane
+// ============================================================================
+
+typedef struct {
+    __m512i s[4];
+} lanes_state_t;
+
+static inline __m512i times5(__m512i x) {
+    return _mm512_add_epi64(_mm512_slli_epi64(x, 2), x);
+}
+
+static inline __m512i times9(__m512i x) {
+    return _mm512_add_epi64(_mm512_slli_epi64(x, 3), x);
+}
+
+// xoshiro256** in every lane
+static inline __m512i next_random(lanes_state_t *st) {
+    __m512i *s = st->s;
+    const __m512i result = times9(_mm512_rol_epi64(times5(s[1]), 7));
+    const __m512i t = _mm512_slli_epi64(s[1], 17);
+    s[2] = _mm512_xor_si512(s[2], s[0]);
+    s[3] = _mm512_xor_si512(s[3], s[1]);
+    s[1] = _mm512_xor_si512(s[1], s[2]);
+    s[0] = _mm512_xor_si512(s[0], s[3]);
+    s[2] = _mm512_xor_si512(s[2], t);
+    s[3] = _mm512_rol_epi64(s[3], 45);
+    return result;
+}
+
+// Integer below 2^52 to double, exactly
+static inline __m512d small_to_pd(__m512i x) {
+    const __m512i magic = _mm512_set1_epi64((long long)GS_EXP_MAGIC);
+    return _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(x, magic)),
+                         _mm512_set1_pd(0x1.0p52));
+}
+
+// (r >> 11) * 2^-53, exactly: the 53 bits as 27 high and 26 low
+static inline __m512d to_unit(__m512i r) {
+    const __m512i v = _mm512_srli_epi64(r, 11);
+    const __m512d hi = small_to_pd(_mm512_srli_epi64(v, 26));
+    const __m512d lo = small_to_pd(_mm512_and_si512(v, _mm512_set1_epi64((1LL << 26) - 1)));
+    return _mm512_mul_pd(_mm512_fmadd_pd(hi, _mm512_set1_pd(0x1.0p26), lo),
+                         _mm512_set1_pd(0x1.0p-53));
+}
+
+static inline __m512d log_pd(__m512d x) {
+    const __m512i bits = _mm512_castpd_si512(x);
+    __m512d m = _mm512_castsi512_pd(_mm512_or_si512(
+        _mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)),
+        _mm512_set1_epi64(0x3FF0000000000000LL)));
+    __m512d k = _mm512_sub_pd(
+        _mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(bits, 52),
+                                            _mm512_set1_epi64((long long)GS_EXP_MAGIC))),
+        _mm512_set1_pd(GS_EXP_OFFSET));
+    const __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(GS_SQRT2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    k = _mm512_mask_add_pd(k, big, k, _mm512_set1_pd(1.0));
+
+    const __m512d f = _mm512_sub_pd(m, _mm512_set1_pd(1.0));
+    const __m512d s = _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+    const __m512d z = _mm512_mul_pd(s, s);
+    __m512d p = _mm512_set1_pd(GS_LG7);
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG6));
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG5));
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG4));
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG3));
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG2));
+    p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(GS_LG1));
+    const __m512d r = _mm512_mul_pd(p, z);
+    const __m512d h = _mm512_mul_pd(_mm512_set1_pd(0.5), f);
+    const __m512d inner = _mm512_fmadd_pd(s, _mm512_fmadd_pd(h, f, r),
+                                          _mm512_mul_pd(k, _mm512_set1_pd(GS_LN2_LO)));
+    return _mm512_fmadd_pd(k, _mm512_set1_pd(GS_LN2_HI),
+                           _mm512_sub_pd(f, _mm512_fmsub_pd(h, f, inner)));
+}
+
+static inline void sincos_pd(__m512d u, __m512d *c, __m512d *s) {
+    const __m512d t = _mm512_mul_pd(u, _mm512_set1_pd(4.0));
+    const __m512d q = _mm512_roundscale_pd(t, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m512d x = _mm512_mul_pd(_mm512_sub_pd(t, q), _mm512_set1_pd(GS_PI_2));
+    const __m512d z = _mm512_mul_pd(x, x);
+    __m512d ps = _mm512_set1_pd(GS_S6), pc = _mm512_set1_pd(GS_C6);
+    ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(GS_S5));
+    pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(GS_C5));
+    ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(GS_S4));
+    pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(GS_C4));
+    ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(GS_S3));
+    pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(GS_C3));
+    ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(GS_S2));
+    pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(GS_C2));
+    ps = _mm512_fmadd_pd(ps, z, _mm512_set1_pd(GS_S1));
+    pc = _mm512_fmadd_pd(pc, z, _mm512_set1_pd(GS_C1));
+    const __m512d sn = _mm512_fmadd_pd(_mm512_mul_pd(x, z), ps, x);
+    const __m512d cs = _mm512_fmadd_pd(_mm512_mul_pd(z, z), pc,
+                                       _mm512_fmadd_pd(_mm512_set1_pd(-0.5), z,
+                                                       _mm512_set1_pd(1.0)));
+
+    // Quadrant q & 3 from the low bits of q + 2^52: odd swaps, then signs
+    const __m512i qi = _mm512_and_si512(
+        _mm512_castpd_si512(_mm512_add_pd(q, _mm512_set1_pd(0x1.0p52))), _mm512_set1_epi64(3));
+    const __mmask8 odd = _mm512_test_epi64_mask(qi, _mm512_set1_epi64(1));
+    const __m512d a = _mm512_mask_blend_pd(odd, cs, sn);
+    const __m512d b = _mm512_mask_blend_pd(odd, sn, cs);
+    const __m512i neg_c = _mm512_slli_epi64(
+        _mm512_and_si512(_mm512_xor_si512(qi, _mm512_srli_epi64(qi, 1)), _mm512_set1_epi64(1)),
+        63);
+    const __m512i neg_s = _mm512_slli_epi64(_mm512_srli_epi64(qi, 1), 63);
+    *c = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), neg_c));
+    *s = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(b), neg_s));
+}
+
+// round(): half away from zero
+static inline __m256i round_epi32(__m512d z) {
+    const __m512d t = _mm512_roundscale_pd(z, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m512d d = _mm512_abs_pd(_mm512_sub_pd(z, t));
+    const __mmask8 up = _mm512_cmp_pd_mask(d, _mm512_set1_pd(0.5), _CMP_GE_OQ);
+    const __m512d one = _mm512_castsi512_pd(_mm512_or_si512(
+        _mm512_and_si512(_mm512_castpd_si512(z), _mm512_set1_epi64((long long)0x8000000000000000ULL)),
+        _mm512_castpd_si512(_mm512_set1_pd(1.0))));
+    return _mm512_cvttpd_epi32(_mm512_mask_add_pd(t, up, t, one));
+}
+
+void gaussian_sample_batch_avx512(const uint8_t (*seeds)[32], size_t count,
+                                  int (*output)[GAUSSIAN_N],
+                                  double mean, double stddev, double bound_sigma) {
+    const int use_bounds = bound_sigma > 0.0;
+    const __m512d lower = _mm512_set1_pd(mean - bound_sigma * stddev);
+    const __m512d upper = _mm512_set1_pd(mean + bound_sigma * stddev);
+    const __m512d mean_v = _mm512_set1_pd(mean);
+    const __m512d stddev_v = _mm512_set1_pd(stddev);
+
+    for (size_t base = 0; base < count; base += LANES) {
+        const int lanes = count - base < LANES ? (int)(count - base) : LANES;
+
+        // Lane states, seeds transposed; lanes past the end run on seed 0, unused
+        uint64_t init[4][LANES];
+        int kept[LANES];
+        for (int l = 0; l < LANES; l++) {
+            uint64_t st[4];
+            memcpy(st, seeds[base + (l < lanes ? (size_t)l : 0)], 32);
+            if (st[0] == 0 && st[1] == 0 && st[2] == 0 && st[3] == 0) {
+                st[0] = 0x123456789ABCDEF0ULL;
+            }
+            for (int w = 0; w < 4; w++) init[w][l] = st[w];
+            kept[l] = l < lanes ? 0 : GAUSSIAN_N;
+        }
+        lanes_state_t st;
+        for (int w = 0; w < 4; w++) st.s[w] = _mm512_loadu_si512(init[w]);
+
+        int done = LANES - lanes;
+        while (done < LANES) {
+            const __m512i r1 = next_random(&st);
+            const __m512i r2 = next_random(&st);
+            const __m512d u1 = _mm512_max_pd(to_unit(r1), _mm512_set1_pd(0x1.0p-53));
+            const __m512d u2 = to_unit(r2);
+
+            __m512d c, s;
+            sincos_pd(u2, &c, &s);
+            const __m512d mag = _mm512_mul_pd(
+                _mm512_sqrt_pd(_mm512_mul_pd(_mm512_set1_pd(-2.0), log_pd(u1))), stddev_v);
+            const __m512d z0 = _mm512_fmadd_pd(mag, c, mean_v);
+            const __m512d z1 = _mm512_fmadd_pd(mag, s, mean_v);
+
+            unsigned ok0 = 0xFF, ok1 = 0xFF;
+            if (use_bounds) {
+                ok0 = _mm512_cmp_pd_mask(z0, lower, _CMP_GE_OQ) &
+                      _mm512_cmp_pd_mask(z0, upper, _CMP_LE_OQ);
+                ok1 = _mm512_cmp_pd_mask(z1, lower, _CMP_GE_OQ) &
+                      _mm512_cmp_pd_mask(z1, upper, _CMP_LE_OQ);
+            }
+            int v0[LANES], v1[LANES];
+            _mm256_storeu_si256((__m256i *)v0, round_epi32(z0));
+            _mm256_storeu_si256((__m256i *)v1, round_epi32(z1));
+
+            // Each lane keeps its candidates in order, z0 then z1
+            for (int l = 0; l < lanes; l++) {
+                int *row = output[base + (size_t)l];
+                if (kept[l] < GAUSSIAN_N && (ok0 >> l & 1)) row[kept[l]++] = v0[l];
+                if (kept[l] < GAUSSIAN_N && (ok1 >> l & 1)) row[kept[l]++] = v1[l];
+                if (kept[l] == GAUSSIAN_N) {
+                    kept[l]++;
+                    done++;
+                }
+            }
+        }
+    }
+}
+
+#endif /* __AVX512F__ */
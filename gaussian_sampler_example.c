@@ -1,10 +1,8 @@
 #include <stdio.h>
 #include <stdint.h>
+#include "gaussian_sampler.h"
 
-#define N 64
-
-// Declaration from gaussian_sampler.c
-void gaussian_sample(const uint8_t seed[32], int output[N], double mean, double stddev, double bound_sigma);
+#define N GAUSSIAN_N
 
 int main(void) {
     // Example 256-bit seed
@@ -0,0 +1,51 @@
+/**
+ * gaussian_sampler_poly.h
+ *
+ * Constants of the batch sampler's log and sincos, shared by its scalar
+ * and SIMD paths (internal)
+ *
+ * log: x = 2^k * m with m in [sqrt(2)/2, sqrt(2)), f = m - 1,
+ *      s = f / (2 + f), log(1 + f) from an odd series in s (fdlibm's Lg1..7)
+ * sincos of 2 pi u: t = 4u, q = nearest(t), x = (t - q) * pi/2 in
+ *      [-pi/4, pi/4], kernels of fdlibm's __kernel_sin / __kernel_cos,
+ *      quadrant from q & 3
+ *
+ * Every path evaluates them in the same order, with explicit fused
+ * multiply-adds and no other multiply feeding an add, so they round alike;
+ * build with -ffp-contract=off so the compiler fuses nothing itself.
+ */
+
+#ifndef GAUSSIAN_SAMPLER_POLY_H
+#define GAUSSIAN_SAMPLER_POLY_H
+
+#define GS_LG1 6.666666666666735130e-01
+#define GS_LG2 3.999999999940941908e-01
+#define GS_LG3 2.857142874366239149e-01
+#define GS_LG4 2.222219843214978396e-01
+#define GS_LG5 1.818357216161805012e-01
+#define GS_LG6 1.531383769920937332e-01
+#define GS_LG7 1.479819860511658591e-01
+#define GS_LN2_HI 6.93147180369123816490e-01
+#define GS_LN2_LO 1.90821492927058770002e-10
+#define GS_SQRT2 1.41421356237309504880
+
+#define GS_S1 -1.66666666666666324348e-01
+#define GS_S2  8.33333333332248946124e-03
+#define GS_S3 -1.98412698298579493134e-04
+#define GS_S4  2.75573137070700676789e-06
+#define GS_S5 -2.50507602534068634195e-08
+#define GS_S6  1.58969099521155010221e-10
+#define GS_C1  4.16666666666666019037e-02
+#define GS_C2 -1.38888888888741095749e-03
+#define GS_C3  2.48015872894767294178e-05
+#define GS_C4 -2.75573143513906633035e-07
+#define GS_C5  2.08757232129817482790e-09
+#define GS_C6 -1.13596475577881948265e-11
+#define GS_PI_2 1.57079632679489661923
+
+/* Exponent bits to the exponent as a double: OR into the mantissa of 2^52,
+ * then subtract 2^52 and the bias (exact) */
+#define GS_EXP_MAGIC 0x4330000000000000ULL
+#define GS_EXP_OFFSET 4503599627371519.0
+
+#endif /* GAUSSIAN_SAMPLER_POLY_H */
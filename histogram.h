@@ -0,0 +1,233 @@
+/**
+ * histogram.h
+ *
+ * Symbol frequency counts shared by the encoders
+ * - Byte symbols (Huffman) and int8 values by value + 128 (SPARSE_SCAN_BIN)
+ * - Narrow ranges: byte compares and popcounts, no table
+ * - Wide ranges: interleaved sub-tables, summed at the end
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// HISTOGRAMS
+// ============================================================================
+//
+// A counts[v]++ loop stalls on skewed data: runs of one symbol increment
+// the same counter, and each increment waits for the previous store to be
+// forwarded. Two kernels avoid it:
+//
+//   - inputs whose symbols span at most HIST_NARROW_BINS bins (the {-3..3}
+//     secrets, the {-2..2} sparse values) are counted bin by bin with byte
+//     compares, one compare and a popcount per 64 symbols (AVX-512) or 32
+//     (AVX2), after a min/max pass finds the bins
+//   - other inputs of HIST_MIN_TABLES_LEN symbols or more spread
+//     consecutive symbols over HIST_TABLES tables, summed at the end
+//
+// Builds without AVX2 have only the tables: a portable min/max pass costs
+// more than the stalls it would save. Inputs below HIST_MIN_LEN symbols,
+// and wide ones below HIST_MIN_TABLES_LEN, keep the plain loop.
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#define HIST_NARROW 1
+#endif
+
+#define HIST_NARROW_BINS 16
+#define HIST_TABLES 4
+#define HIST_MIN_LEN 32
+#define HIST_MIN_TABLES_LEN 512
+
+#if defined(HIST_NARROW)
+
+// Occurrences of byte c in p[0 .. n)
+static inline uint32_t hist_count_byte(const uint8_t *p, size_t n, uint8_t c) {
+    uint32_t count = 0;
+    size_t i = 0;
+
+#if defined(__AVX512BW__)
+    const __m512i cv = _mm512_set1_epi8((char)c);
+    for (; i + 64 <= n; i += 64) {
+        const __m512i v = _mm512_loadu_si512((const void *)(p + i));
+        count += (uint32_t)__builtin_popcountll(_mm512_cmpeq_epi8_mask(v, cv));
+    }
+    if (i < n) {
+        const __mmask64 tail = (1ULL << (n - i)) - 1;
+        const __m512i v = _mm512_maskz_loadu_epi8(tail, p + i);
+        count += (uint32_t)__builtin_popcountll(_mm512_mask_cmpeq_epi8_mask(tail, v, cv));
+    }
+    return count;
+#else
+    const __m256i cv = _mm256_set1_epi8((char)c);
+    for (; i + 32 <= n; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        count += (uint32_t)__builtin_popcount(
+            (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cv)));
+    }
+
+    // Zero bytes of x = w ^ c: the high bit of ((x & 0x7F) + 0x7F) | x is
+    // clear exactly where x is zero, and a multiply sums the eight flags
+    const uint64_t ones = 0x0101010101010101ULL, low7 = 0x7F7F7F7F7F7F7F7FULL;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        const uint64_t x = w ^ (ones * c);
+        const uint64_t zeros = (~(((x & low7) + low7) | x) & ~low7) >> 7;
+        count += (uint32_t)((zeros * ones) >> 56);
+    }
+    for (; i < n; i++) {
+        count += p[i] == c;
+    }
+    return count;
+#endif
+}
+
+// Smallest and largest byte of a vector
+static inline void hist_reduce_range(__m256i vmin, __m256i vmax, uint8_t *lo, uint8_t *hi) {
+    __m128i mn = _mm_min_epu8(_mm256_castsi256_si128(vmin), _mm256_extracti128_si256(vmin, 1));
+    __m128i mx = _mm_max_epu8(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 8));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 8));
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 4));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 4));
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 2));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 2));
+    mn = _mm_min_epu8(mn, _mm_srli_si128(mn, 1));
+    mx = _mm_max_epu8(mx, _mm_srli_si128(mx, 1));
+    *lo = (uint8_t)_mm_cvtsi128_si32(mn);
+    *hi = (uint8_t)_mm_cvtsi128_si32(mx);
+}
+
+// Smallest and largest bin p[i] ^ flip, n > 0
+static inline void hist_bin_range(const uint8_t *p, size_t n, uint8_t flip, uint8_t *lo,
+                                  uint8_t *hi) {
+#if defined(__AVX512BW__)
+    const __m512i f = _mm512_set1_epi8((char)flip);
+    __m512i vmin = _mm512_set1_epi8((char)0xFF), vmax = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        const __m512i v = _mm512_xor_si512(_mm512_loadu_si512((const void *)(p + i)), f);
+        vmin = _mm512_min_epu8(vmin, v);
+        vmax = _mm512_max_epu8(vmax, v);
+    }
+    if (i < n) {
+        const __mmask64 tail = (1ULL << (n - i)) - 1;
+        const __m512i v = _mm512_xor_si512(_mm512_maskz_loadu_epi8(tail, p + i), f);
+        vmin = _mm512_mask_min_epu8(vmin, tail, vmin, v);
+        vmax = _mm512_mask_max_epu8(vmax, tail, vmax, v);
+    }
+    hist_reduce_range(_mm256_min_epu8(_mm512_castsi512_si256(vmin),
+                                      _mm512_extracti64x4_epi64(vmin, 1)),
+                      _mm256_max_epu8(_mm512_castsi512_si256(vmax),
+                                      _mm512_extracti64x4_epi64(vmax, 1)),
+                      lo, hi);
+#else
+    uint8_t mn = 255, mx = 0;
+    size_t i = 0;
+    if (n >= 32) {
+        const __m256i f = _mm256_set1_epi8((char)flip);
+        __m256i vmin = _mm256_set1_epi8((char)0xFF), vmax = _mm256_setzero_si256();
+        for (; i + 32 <= n; i += 32) {
+            const __m256i v = _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i *)(p + i)), f);
+            vmin = _mm256_min_epu8(vmin, v);
+            vmax = _mm256_max_epu8(vmax, v);
+        }
+        hist_reduce_range(vmin, vmax, &mn, &mx);
+    }
+    for (; i < n; i++) {
+        const uint8_t b = p[i] ^ flip;
+        mn = b < mn ? b : mn;
+        mx = b > mx ? b : mx;
+    }
+    *lo = mn;
+    *hi = mx;
+#endif
+}
+
+#endif /* HIST_NARROW */
+
+/**
+ * hist[p[i] ^ flip] += 1 for i < n
+ *
+ * @param hist  256 counts, added to
+ */
+static inline void hist_add(const uint8_t *p, size_t n, uint8_t flip, uint32_t *hist) {
+    if (n < HIST_MIN_LEN) {
+        for (size_t i = 0; i < n; i++) {
+            hist[p[i] ^ flip]++;
+        }
+        return;
+    }
+
+    uint8_t lo = 0, hi = 255;
+#if defined(HIST_NARROW)
+    hist_bin_range(p, n, flip, &lo, &hi);
+    if (hi - lo < HIST_NARROW_BINS) {
+        for (unsigned b = lo; b <= hi; b++) {
+            hist[b] += hist_count_byte(p, n, (uint8_t)(b ^ flip));
+        }
+        return;
+    }
+#endif
+    if (n < HIST_MIN_TABLES_LEN) {
+        for (size_t i = 0; i < n; i++) {
+            hist[p[i] ^ flip]++;
+        }
+        return;
+    }
+
+    // Eight symbols per load, two to each table; the word keeps the loads
+    // from being repeated after each (possibly aliasing) increment
+    uint32_t tables[HIST_TABLES][256];
+    memset(tables, 0, sizeof(tables));
+    const uint64_t flips = 0x0101010101010101ULL * flip;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        w ^= flips;
+        tables[0][w & 0xFF]++;
+        tables[1][(w >> 8) & 0xFF]++;
+        tables[2][(w >> 16) & 0xFF]++;
+        tables[3][(w >> 24) & 0xFF]++;
+        tables[0][(w >> 32) & 0xFF]++;
+        tables[1][(w >> 40) & 0xFF]++;
+        tables[2][(w >> 48) & 0xFF]++;
+        tables[3][w >> 56]++;
+    }
+    for (; i < n; i++) {
+        tables[0][p[i] ^ flip]++;
+    }
+    for (unsigned b = lo; b <= hi; b++) {
+        uint32_t sum = 0;
+        for (int t = 0; t < HIST_TABLES; t++) {
+            sum += tables[t][b];
+        }
+        hist[b] += sum;
+    }
+}
+
+/**
+ * hist[p[i]] += 1 for i < n, byte symbols
+ */
+static inline void hist_add_bytes(const uint8_t *p, size_t n, uint32_t *hist) {
+    hist_add(p, n, 0, hist);
+}
+
+/**
+ * hist[v[i] + 128] += 1 for i < n (the SPARSE_SCAN_BIN of each value)
+ */
+static inline void hist_add_int8(const int8_t *v, size_t n, uint32_t *hist) {
+    hist_add((const uint8_t *)v, n, 0x80, hist);
+}
+
+#endif /* HISTOGRAM_H */
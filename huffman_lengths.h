@@ -0,0 +1,225 @@
+#ifndef HUFFMAN_LENGTHS_H
+#define HUFFMAN_LENGTHS_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ============================================================================
+// HUFFMAN CODE LENGTHS (IN PLACE, LENGTH LIMITED)
+// ============================================================================
+
+/**
+ * Optimal prefix code lengths for up to HUFF_MAX_SYMBOLS frequencies,
+ * computed on stack arrays: no tree, no allocation
+ *
+ * The used symbols are heap-sorted by frequency (then index) and
+ * Moffat-Katajainen's in-place algorithm turns the sorted frequencies
+ * into code lengths in O(n). If the longest code exceeds the caller's
+ * limit, package-merge (Larmore-Hirschberg) finds the optimal code within
+ * it instead, in O(n * limit).
+ *
+ * Codes then follow canonically from the lengths: by length, then by
+ * symbol index, as canonical_huffman.h decodes them.
+ */
+#define HUFF_MAX_SYMBOLS 256
+#define HUFF_MAX_LIMIT   32
+
+/* Heap sort of (freq << 8 | index) keys, ascending */
+static inline void huff_sort_keys(uint64_t *keys, int n) {
+    for (int start = n / 2 - 1, end = n - 1; end > 0;) {
+        int root;
+        if (start >= 0) {
+            root = start--;
+        } else {
+            const uint64_t top = keys[0];
+            keys[0] = keys[end];
+            keys[end--] = top;
+            root = 0;
+        }
+        for (int child; (child = 2 * root + 1) <= end; root = child) {
+            if (child < end && keys[child + 1] > keys[child]) {
+                child++;
+            }
+            if (keys[root] >= keys[child]) {
+                break;
+            }
+            const uint64_t t = keys[root];
+            keys[root] = keys[child];
+            keys[child] = t;
+        }
+    }
+}
+
+/*
+ * Moffat-Katajainen: a[0..n-1] ascending weights become code lengths,
+ * a[0] the longest. Three passes over the array: parents, internal node
+ * depths, leaf depths.
+ */
+static inline void huff_mk_lengths(uint64_t *a, int n) {
+    int root = 0, leaf = 2, next;
+    a[0] += a[1];
+    for (next = 1; next < n - 1; next++) {
+        if (leaf >= n || a[root] < a[leaf]) {
+            a[next] = a[root];
+            a[root++] = (uint64_t)next;
+        } else {
+            a[next] = a[leaf++];
+        }
+        if (leaf >= n || (root < next && a[root] < a[leaf])) {
+            a[next] += a[root];
+            a[root++] = (uint64_t)next;
+        } else {
+            a[next] += a[leaf++];
+        }
+    }
+
+    a[n - 2] = 0;
+    for (next = n - 3; next >= 0; next--) {
+        a[next] = a[a[next]] + 1;
+    }
+
+    int avail = 1, used = 0;
+    uint64_t depth = 0;
+    root = n - 2;
+    next = n - 1;
+    while (avail > 0) {
+        while (root >= 0 && a[root] == depth) {
+            used++;
+            root--;
+        }
+        while (avail > used) {
+            a[next--] = depth;
+            avail--;
+        }
+        avail = 2 * used;
+        depth++;
+        used = 0;
+    }
+}
+
+/*
+ * Package-merge: lengths of n >= 2 ascending weights w, none above limit.
+ * Level limit holds the leaves; each level above merges them with the
+ * pairs of the level below. The cheapest 2n - 2 items of level 1, traced
+ * back down, count a symbol once per level where it is chosen.
+ */
+static inline void huff_pm_lengths(const uint64_t *w, int n, unsigned limit, uint8_t *len) {
+    uint64_t level[2][2 * HUFF_MAX_SYMBOLS];
+    uint64_t is_leaf[HUFF_MAX_LIMIT + 1][2 * HUFF_MAX_SYMBOLS / 64];
+    int size[HUFF_MAX_LIMIT + 1];
+
+    memcpy(level[limit & 1], w, (size_t)n * sizeof(uint64_t));
+    size[limit] = n;
+    for (unsigned l = limit - 1; l >= 1; l--) {
+        const uint64_t *below = level[(l + 1) & 1];
+        uint64_t *cur = level[l & 1];
+        const int n_pkg = size[l + 1] / 2;
+        int i = 0, j = 0, k = 0;
+        memset(is_leaf[l], 0, sizeof(is_leaf[l]));
+        while (i < n || j < n_pkg) {
+            const uint64_t pkg = j < n_pkg ? below[2 * j] + below[2 * j + 1] : UINT64_MAX;
+            if (i < n && w[i] <= pkg) {
+                is_leaf[l][k / 64] |= 1ull << (k % 64);
+                cur[k++] = w[i++];
+            } else {
+                cur[k++] = pkg;
+                j++;
+            }
+        }
+        size[l] = k;
+    }
+
+    memset(len, 0, (size_t)n);
+    int take = 2 * n - 2;
+    for (unsigned l = 1; l <= limit && take > 0; l++) {
+        int leaves = take;
+        if (l < limit) {
+            leaves = 0;
+            for (int k = 0; k < take; k++) {
+                leaves += (int)((is_leaf[l][k / 64] >> (k % 64)) & 1);
+            }
+        }
+        for (int s = 0; s < leaves; s++) {
+            len[s]++;
+        }
+        take = 2 * (take - leaves);
+    }
+}
+
+/**
+ * Code lengths for n_symbols frequencies, none longer than limit
+ *
+ * @param lengths  Out: 0 for an unused symbol; a lone used symbol gets 1
+ * @return         0, or -1 if n_symbols is out of range, no symbol is used,
+ *                 or limit is too short for the used symbols
+ */
+static inline int huff_build_lengths(const uint32_t *freqs, int n_symbols, unsigned limit,
+                                     uint8_t *lengths) {
+    if (n_symbols <= 0 || n_symbols > HUFF_MAX_SYMBOLS || limit == 0 ||
+        limit > HUFF_MAX_LIMIT) {
+        return -1;
+    }
+
+    uint64_t keys[HUFF_MAX_SYMBOLS];
+    int n = 0;
+    for (int i = 0; i < n_symbols; i++) {
+        lengths[i] = 0;
+        if (freqs[i] > 0) {
+            keys[n++] = ((uint64_t)freqs[i] << 8) | (uint64_t)i;
+        }
+    }
+    if (n == 0 || (limit < 32 && (1u << limit) < (unsigned)n)) {
+        return -1;
+    }
+    if (n == 1) {
+        lengths[keys[0] & 0xFF] = 1;
+        return 0;
+    }
+
+    huff_sort_keys(keys, n);
+    uint64_t a[HUFF_MAX_SYMBOLS];
+    for (int k = 0; k < n; k++) {
+        a[k] = keys[k] >> 8;
+    }
+    huff_mk_lengths(a, n);
+
+    if (a[0] <= limit) {
+        for (int k = 0; k < n; k++) {
+            lengths[keys[k] & 0xFF] = (uint8_t)a[k];
+        }
+        return 0;
+    }
+
+    uint8_t len[HUFF_MAX_SYMBOLS];
+    for (int k = 0; k < n; k++) {
+        a[k] = keys[k] >> 8;
+    }
+    huff_pm_lengths(a, n, limit, len);
+    for (int k = 0; k < n; k++) {
+        lengths[keys[k] & 0xFF] = len[k];
+    }
+    return 0;
+}
+
+/**
+ * Canonical codes for the lengths: by length, then by symbol index,
+ * starting from 0 (symbols of length 0 get no code)
+ */
+static inline void huff_canonical_codes(const uint8_t *lengths, int n_symbols, uint32_t *codes) {
+    uint32_t count[HUFF_MAX_LIMIT + 1] = {0};
+    uint32_t next[HUFF_MAX_LIMIT + 1];
+    for (int i = 0; i < n_symbols; i++) {
+        count[lengths[i]]++;
+    }
+    count[0] = 0;
+    uint32_t code = 0;
+    for (unsigned len = 1; len <= HUFF_MAX_LIMIT; len++) {
+        code = (code + count[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (int i = 0; i < n_symbols; i++) {
+        codes[i] = lengths[i] ? next[lengths[i]]++ : 0;
+    }
+}
+
+#endif // HUFFMAN_LENGTHS_H
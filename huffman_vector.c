@@ -5,21 +5,19 @@
  */
 
 #include "huffman_vector.h"
+#include "bitstream.h"
+#include "canonical_huffman.h"
+#include "dntl_sched.h"
+#include "dntl_stats.h"
+#include "histogram.h"
+#include "huffman_lengths.h"
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 #define MAX_SYMBOLS 256
-#define MAX_CODE_LENGTH 32
-
-/* Huffman tree node */
-typedef struct huff_node {
-    uint32_t freq;
-    uint16_t symbol;
-    uint8_t is_leaf;
-    struct huff_node *left;
-    struct huff_node *right;
-} huff_node_t;
+#define MAX_CODE_LENGTH 31
 
 /* Code table entry */
 typedef struct {
@@ -27,282 +25,268 @@ typedef struct {
     uint8_t length;     /* Code length in bits */
 } code_entry_t;
 
-/* Bit writer for encoding */
-typedef struct {
-    uint8_t *buffer;
-    size_t capacity;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    uint64_t bit_buffer;
-    uint8_t bits_in_buffer;
-} bit_writer_t;
-
-/* Bit reader for decoding */
-typedef struct {
-    const uint8_t *buffer;
-    size_t size;
-    size_t byte_pos;
-    uint8_t bit_pos;
-} bit_reader_t;
+/* ========== Header ========== */
 
-/* ========== Bit Writer ========== */
+/*
+ * Both formats start with
+ *
+ *     dimension(16, low half), dimension(16, high half),
+ *     number of symbols(8, 0 for 256), code length per symbol(5 each)
+ *
+ * The single-stream format follows with every value's code. The x4 format
+ * pads to a byte, then gives the byte sizes of streams 0..2 (16 bits each,
+ * or 32 when huffman_max_encoded_size(dimension) passes 65535) and the
+ * four streams, each byte-aligned; stream s codes values
+ * [s * dimension / 4, (s + 1) * dimension / 4).
+ *
+ * The chunked format follows the lengths with the chunk count K(16), pads
+ * to a byte, then gives a jump table: the end offset of chunks 0..K-2,
+ * counted from the first chunk, in fields as wide as the x4 sizes. The K
+ * byte-aligned chunks follow; chunk c codes values
+ * [c * dimension / K, (c + 1) * dimension / K).
+ */
 
-static bit_writer_t* bit_writer_create(size_t capacity) {
-    bit_writer_t *bw = malloc(sizeof(bit_writer_t));
-    if (!bw) return NULL;
+/* Frequencies, code lengths and canonical codes of a vector */
+static int build_codes(const uint8_t *vector, size_t dimension, int *num_symbols,
+                       code_entry_t *codes) {
+    uint32_t frequencies[MAX_SYMBOLS] = {0};
+    hist_add_bytes(vector, dimension, frequencies);
 
-    bw->buffer = calloc(capacity, 1);
-    if (!bw->buffer) {
-        free(bw);
-        return NULL;
-    }
+    int max_symbol = MAX_SYMBOLS - 1;
+    while (max_symbol > 0 && !frequencies[max_symbol]) max_symbol--;
+    *num_symbols = max_symbol + 1;
 
-    bw->capacity = capacity;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-    bw->bit_buffer = 0;
-    bw->bits_in_buffer = 0;
+    /* Canonical Huffman codes, no longer than the 5-bit length field */
+    uint8_t lengths[MAX_SYMBOLS];
+    uint32_t canon[MAX_SYMBOLS];
+    if (huff_build_lengths(frequencies, *num_symbols, MAX_CODE_LENGTH, lengths) < 0) return -1;
+    huff_canonical_codes(lengths, *num_symbols, canon);
 
-    return bw;
+    for (int symbol = 0; symbol < *num_symbols; symbol++) {
+        codes[symbol].code = canon[symbol];
+        codes[symbol].length = lengths[symbol];
+    }
+    return 0;
 }
 
-static void bit_writer_write(bit_writer_t *bw, uint32_t bits, uint8_t num_bits) {
-    bw->bit_buffer = (bw->bit_buffer << num_bits) | bits;
-    bw->bits_in_buffer += num_bits;
-
-    /* Flush complete bytes */
-    while (bw->bits_in_buffer >= 8) {
-        bw->bits_in_buffer -= 8;
-        if (bw->byte_pos < bw->capacity) {
-            bw->buffer[bw->byte_pos++] = (bw->bit_buffer >> bw->bits_in_buffer) & 0xFF;
-        }
+static int write_header(bit_writer_t *bw, size_t dimension, int num_symbols,
+                        const code_entry_t *codes) {
+    if (bw_write_bits(bw, dimension & 0xFFFF, 16) < 0) return -1;
+    if (bw_write_bits(bw, (dimension >> 16) & 0xFFFF, 16) < 0) return -1;
+    if (bw_write_bits(bw, (uint8_t)num_symbols, 8) < 0) return -1;
+    for (int i = 0; i < num_symbols; i++) {
+        if (bw_write_bits(bw, codes[i].length, 5) < 0) return -1;
     }
+    return 0;
 }
 
-static void bit_writer_flush(bit_writer_t *bw) {
-    if (bw->bits_in_buffer > 0) {
-        if (bw->byte_pos < bw->capacity) {
-            bw->buffer[bw->byte_pos++] = (bw->bit_buffer << (8 - bw->bits_in_buffer)) & 0xFF;
-        }
-        bw->bits_in_buffer = 0;
-        bw->bit_buffer = 0;
+/* The decoding table of a header; dimension must be the stored one */
+static int read_header(bit_reader_t *br, size_t dimension, chuff_table_t *table,
+                       size_t expected) {
+    uint32_t dim_lower, dim_upper, num_symbols;
+    if (br_read_bits(br, 16, &dim_lower) < 0 || br_read_bits(br, 16, &dim_upper) < 0) return -1;
+    if ((((size_t)dim_upper << 16) | dim_lower) != dimension) return -1;
+    if (br_read_bits(br, 8, &num_symbols) < 0) return -1;
+    if (num_symbols == 0) num_symbols = MAX_SYMBOLS;
+
+    uint8_t lengths[MAX_SYMBOLS];
+    for (uint32_t i = 0; i < num_symbols; i++) {
+        uint32_t len;
+        if (br_read_bits(br, 5, &len) < 0) return -1;
+        lengths[i] = (uint8_t)len;
     }
+    return chuff_build(table, lengths, (int)num_symbols, expected);
 }
 
-/* ========== Bit Reader ========== */
-
-static bit_reader_t* bit_reader_create(const uint8_t *data, size_t size) {
-    bit_reader_t *br = malloc(sizeof(bit_reader_t));
-    if (!br) return NULL;
-
-    br->buffer = data;
-    br->size = size;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-
-    return br;
+static int write_values(bit_writer_t *bw, const uint8_t *vector, size_t n,
+                        const code_entry_t *codes) {
+    for (size_t i = 0; i < n; i++) {
+        if (bw_write_bits(bw, codes[vector[i]].code, codes[vector[i]].length) < 0) return -1;
+    }
+    return 0;
 }
 
-static uint32_t bit_reader_read(bit_reader_t *br, uint8_t num_bits) {
-    uint32_t result = 0;
-
-    for (uint8_t i = 0; i < num_bits; i++) {
-        if (br->byte_pos >= br->size) return 0;
+/* ========== Encoding ========== */
 
-        uint8_t bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-        result = (result << 1) | bit;
+size_t huffman_max_encoded_size(size_t dimension) {
+    if (dimension == 0) return 0;
 
-        br->bit_pos++;
-        if (br->bit_pos == 8) {
-            br->bit_pos = 0;
-            br->byte_pos++;
-        }
-    }
-
-    return result;
+    /* Header with all 256 code lengths, then at most 8 bits per value: an
+     * optimal code never loses to the fixed 8-bit one */
+    return (40 + 5 * MAX_SYMBOLS + 8 * dimension + 7) / 8;
 }
 
-/* ========== Huffman Tree Building ========== */
+int huffman_encode_into(const uint8_t *vector, size_t dimension,
+                        uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_ENCODE);
+    if (!vector || !out || !written || dimension == 0) return -1;
 
-static huff_node_t* create_node(uint32_t freq, uint16_t symbol, uint8_t is_leaf) {
-    huff_node_t *node = malloc(sizeof(huff_node_t));
-    if (!node) return NULL;
+    int num_symbols;
+    code_entry_t codes[MAX_SYMBOLS];
+    if (build_codes(vector, dimension, &num_symbols, codes) < 0) return -1;
 
-    node->freq = freq;
-    node->symbol = symbol;
-    node->is_leaf = is_leaf;
-    node->left = NULL;
-    node->right = NULL;
+    bit_writer_t bw;
+    bw_init(&bw, out, out_cap);
+    if (write_header(&bw, dimension, num_symbols, codes) < 0) return -1;
+    if (write_values(&bw, vector, dimension, codes) < 0) return -1;
 
-    return node;
+    *written = bw_finish(&bw);
+    return 0;
 }
 
-static void free_tree(huff_node_t *node) {
-    if (!node) return;
-    free_tree(node->left);
-    free_tree(node->right);
-    free(node);
-}
+encoded_result_t* huffman_encode(const uint8_t *vector, size_t dimension) {
+    if (!vector || dimension == 0) return NULL;
 
-/* Simple insertion sort for priority queue (efficient for small n) */
-static void insert_sorted(huff_node_t **queue, int *size, huff_node_t *node) {
-    int i = *size - 1;
-    while (i >= 0 && queue[i]->freq > node->freq) {
-        queue[i + 1] = queue[i];
-        i--;
+    encoded_result_t *result = malloc(sizeof(encoded_result_t));
+    if (!result) return NULL;
+
+    size_t max_size = huffman_max_encoded_size(dimension);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        huffman_encode_into(vector, dimension, result->data, max_size, &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
     }
-    queue[i + 1] = node;
-    (*size)++;
+    return result;
 }
 
-static huff_node_t* build_huffman_tree(uint32_t *frequencies, int num_symbols) {
-    huff_node_t *queue[MAX_SYMBOLS * 2];
-    int queue_size = 0;
-
-    /* Create leaf nodes for symbols with non-zero frequency */
-    for (int i = 0; i < num_symbols; i++) {
-        if (frequencies[i] > 0) {
-            huff_node_t *node = create_node(frequencies[i], i, 1);
-            if (!node) return NULL;
-            insert_sorted(queue, &queue_size, node);
-        }
-    }
+/* Size fields of the x4 format and jump table entries of the chunked one */
+static unsigned size_field_bytes(size_t dimension) {
+    return huffman_max_encoded_size(dimension) > 0xFFFF ? 4 : 2;
+}
 
-    if (queue_size == 0) return NULL;
-    if (queue_size == 1) {
-        /* Single symbol - create dummy parent */
-        huff_node_t *root = create_node(queue[0]->freq, 0, 0);
-        root->left = queue[0];
-        return root;
+static void write_field(uint8_t *p, size_t value, unsigned bytes) {
+    for (unsigned b = 0; b < bytes; b++) {
+        p[b] = (uint8_t)(value >> (8 * (bytes - 1 - b)));
     }
+}
 
-    /* Build tree by combining lowest frequency nodes */
-    while (queue_size > 1) {
-        huff_node_t *left = queue[0];
-        huff_node_t *right = queue[1];
-
-        /* Remove two lowest frequency nodes */
-        for (int i = 0; i < queue_size - 2; i++) {
-            queue[i] = queue[i + 2];
-        }
-        queue_size -= 2;
-
-        /* Create parent node */
-        huff_node_t *parent = create_node(left->freq + right->freq, 0, 0);
-        if (!parent) {
-            free_tree(left);
-            free_tree(right);
-            return NULL;
-        }
-        parent->left = left;
-        parent->right = right;
+static size_t read_field(const uint8_t *p, unsigned bytes) {
+    size_t value = 0;
+    for (unsigned b = 0; b < bytes; b++) value = value << 8 | p[b];
+    return value;
+}
 
-        /* Insert back into queue */
-        insert_sorted(queue, &queue_size, parent);
-    }
+size_t huffman_x4_max_encoded_size(size_t dimension) {
+    if (dimension == 0) return 0;
 
-    return queue[0];
+    /* Each stream pads to a byte */
+    return huffman_max_encoded_size(dimension) + 3 * size_field_bytes(dimension) + 4;
 }
 
-/* Generate Huffman codes by tree traversal */
-static void generate_codes_recursive(huff_node_t *node, code_entry_t *codes,
-                                     uint32_t code, uint8_t length) {
-    if (!node) return;
-
-    if (node->is_leaf) {
-        codes[node->symbol].code = code;
-        codes[node->symbol].length = length;
-        return;
+int huffman_encode_x4_into(const uint8_t *vector, size_t dimension,
+                           uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_ENCODE);
+    if (!vector || !out || !written || dimension == 0) return -1;
+
+    int num_symbols;
+    code_entry_t codes[MAX_SYMBOLS];
+    if (build_codes(vector, dimension, &num_symbols, codes) < 0) return -1;
+
+    bit_writer_t bw;
+    bw_init(&bw, out, out_cap);
+    if (write_header(&bw, dimension, num_symbols, codes) < 0) return -1;
+    size_t pos = bw_finish(&bw);
+
+    /* Streams after the size fields, which are filled in last */
+    const unsigned size_bytes = size_field_bytes(dimension);
+    uint8_t *sizes = out + pos;
+    if (out_cap - pos < 3 * size_bytes) return -1;
+    pos += 3 * size_bytes;
+    for (int s = 0; s < 4; s++) {
+        const size_t begin = s * dimension / 4, end = (s + 1) * dimension / 4;
+        bw_init(&bw, out + pos, out_cap - pos);
+        if (write_values(&bw, vector + begin, end - begin, codes) < 0) return -1;
+        const size_t bytes = bw_finish(&bw);
+        if (s < 3) write_field(sizes + s * size_bytes, bytes, size_bytes);
+        pos += bytes;
     }
 
-    generate_codes_recursive(node->left, codes, code << 1, length + 1);
-    generate_codes_recursive(node->right, codes, (code << 1) | 1, length + 1);
+    *written = pos;
+    return 0;
 }
 
-/* ========== Encoding ========== */
-
-encoded_result_t* huffman_encode(const uint8_t *vector, size_t dimension) {
+encoded_result_t* huffman_encode_x4(const uint8_t *vector, size_t dimension) {
     if (!vector || dimension == 0) return NULL;
 
-    /* Build frequency table */
-    uint32_t frequencies[MAX_SYMBOLS] = {0};
-    uint8_t max_symbol = 0;
-
-    for (size_t i = 0; i < dimension; i++) {
-        frequencies[vector[i]]++;
-        if (vector[i] > max_symbol) max_symbol = vector[i];
+    encoded_result_t *result = malloc(sizeof(encoded_result_t));
+    if (!result) return NULL;
+
+    size_t max_size = huffman_x4_max_encoded_size(dimension);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        huffman_encode_x4_into(vector, dimension, result->data, max_size, &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
     }
+    return result;
+}
 
-    int num_symbols = max_symbol + 1;
-
-    /* Build Huffman tree */
-    huff_node_t *root = build_huffman_tree(frequencies, num_symbols);
-    if (!root) return NULL;
-
-    /* Generate code lengths from tree */
-    code_entry_t temp_codes[MAX_SYMBOLS] = {0};
-    generate_codes_recursive(root, temp_codes, 0, 0);
-
-    /* Convert to canonical Huffman codes */
-    code_entry_t codes[MAX_SYMBOLS] = {0};
-    uint32_t code = 0;
-
-    for (int len = 1; len <= MAX_CODE_LENGTH; len++) {
-        for (int symbol = 0; symbol < num_symbols; symbol++) {
-            if (temp_codes[symbol].length == len) {
-                codes[symbol].code = code;
-                codes[symbol].length = len;
-                code++;
-            }
-        }
-        code <<= 1;
+size_t huffman_chunked_max_encoded_size(size_t dimension, size_t chunks) {
+    if (dimension == 0 || chunks == 0 || chunks > HUFFMAN_MAX_CHUNKS || chunks > dimension) {
+        return 0;
     }
 
-    /* Calculate output size (conservative estimate) */
-    size_t estimated_bits = dimension * 16;  /* Conservative */
-    size_t estimated_bytes = (estimated_bits / 8) + 1024;  /* + header */
+    /* The chunk count, the jump table, and a byte of padding per chunk and header */
+    return huffman_max_encoded_size(dimension) + 2 +
+           (chunks - 1) * size_field_bytes(dimension) + chunks + 1;
+}
 
-    bit_writer_t *bw = bit_writer_create(estimated_bytes);
-    if (!bw) {
-        free_tree(root);
-        return NULL;
+int huffman_encode_chunked_into(const uint8_t *vector, size_t dimension, size_t chunks,
+                                uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_ENCODE);
+    if (!vector || !out || !written || huffman_chunked_max_encoded_size(dimension, chunks) == 0) {
+        return -1;
     }
 
-    /* Write header */
-    bit_writer_write(bw, dimension & 0xFFFF, 16);  /* Dimension (lower 16 bits) */
-    bit_writer_write(bw, (dimension >> 16) & 0xFFFF, 16);  /* Dimension (upper 16 bits) */
-    bit_writer_write(bw, num_symbols, 8);  /* Number of symbols */
-
-    /* Write code lengths (canonical Huffman) */
-    for (int i = 0; i < num_symbols; i++) {
-        bit_writer_write(bw, codes[i].length, 5);  /* Max length = 32, needs 5 bits */
+    int num_symbols;
+    code_entry_t codes[MAX_SYMBOLS];
+    if (build_codes(vector, dimension, &num_symbols, codes) < 0) return -1;
+
+    bit_writer_t bw;
+    bw_init(&bw, out, out_cap);
+    if (write_header(&bw, dimension, num_symbols, codes) < 0) return -1;
+    if (bw_write_bits(&bw, (uint32_t)chunks, 16) < 0) return -1;
+    size_t pos = bw_finish(&bw);
+
+    /* Chunks after the jump table, which is filled in as they end */
+    const unsigned entry_bytes = size_field_bytes(dimension);
+    uint8_t *jump = out + pos;
+    if (out_cap - pos < (chunks - 1) * entry_bytes) return -1;
+    pos += (chunks - 1) * entry_bytes;
+    const size_t first = pos;
+    for (size_t c = 0; c < chunks; c++) {
+        const size_t begin = c * dimension / chunks, end = (c + 1) * dimension / chunks;
+        bw_init(&bw, out + pos, out_cap - pos);
+        if (write_values(&bw, vector + begin, end - begin, codes) < 0) return -1;
+        pos += bw_finish(&bw);
+        if (c + 1 < chunks) write_field(jump + c * entry_bytes, pos - first, entry_bytes);
     }
 
-    /* Write encoded data */
-    for (size_t i = 0; i < dimension; i++) {
-        uint8_t symbol = vector[i];
-        if (codes[symbol].length > 0) {
-            bit_writer_write(bw, codes[symbol].code, codes[symbol].length);
-        }
-    }
+    *written = pos;
+    return 0;
+}
+
+encoded_result_t* huffman_encode_chunked(const uint8_t *vector, size_t dimension,
+                                         size_t chunks) {
+    if (!vector) return NULL;
 
-    bit_writer_flush(bw);
+    size_t max_size = huffman_chunked_max_encoded_size(dimension, chunks);
+    if (max_size == 0) return NULL;
 
-    /* Create result */
     encoded_result_t *result = malloc(sizeof(encoded_result_t));
-    if (!result) {
-        free(bw->buffer);
-        free(bw);
-        free_tree(root);
+    if (!result) return NULL;
+
+    result->data = malloc(max_size);
+    if (!result->data ||
+        huffman_encode_chunked_into(vector, dimension, chunks, result->data, max_size,
+                                    &result->size) < 0) {
+        free(result->data);
+        free(result);
         return NULL;
     }
-
-    result->data = bw->buffer;
-    result->size = bw->byte_pos;
-
-    free(bw);
-    free_tree(root);
-
     return result;
 }
 
@@ -310,75 +294,181 @@ encoded_result_t* huffman_encode(const uint8_t *vector, size_t dimension) {
 
 int huffman_decode(const uint8_t *encoded_data, size_t encoded_size,
                    uint8_t *vector, size_t dimension) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_DECODE);
     if (!encoded_data || !vector || encoded_size < 5) return -1;
 
-    bit_reader_t *br = bit_reader_create(encoded_data, encoded_size);
-    if (!br) return -1;
+    bit_reader_t br;
+    chuff_table_t table;
+    br_init(&br, encoded_data, encoded_size);
+    if (read_header(&br, dimension, &table, dimension) < 0) return -1;
 
-    /* Read header */
-    uint32_t dim_lower = bit_reader_read(br, 16);
-    uint32_t dim_upper = bit_reader_read(br, 16);
-    size_t stored_dim = (dim_upper << 16) | dim_lower;
+    /* Up to CHUFF_MULTI_SYMS short codes per lookup */
+    return chuff_decode_n(&table, &br, vector, dimension);
+}
 
-    if (stored_dim != dimension) {
-        free(br);
-        return -1;
+/* Next symbols of one stream: a multi-symbol entry, or one code; n >= CHUFF_MULTI_SYMS left */
+static inline int decode_step(const chuff_table_t *t, bit_reader_t *br, uint8_t **out) {
+    const chuff_multi_t *m = &t->multi[br_peek(br, t->bits)];
+    if (m->n >= 2 && m->len <= br->n) {
+        memcpy(*out, m->sym, CHUFF_MULTI_SYMS);
+        *out += m->n;
+        br_skip(br, m->len);
+        return 0;
     }
+    const int sym = chuff_decode(t, br);
+    if (sym < 0) return -1;
+    *(*out)++ = (uint8_t)sym;
+    return 0;
+}
 
-    uint8_t num_symbols = bit_reader_read(br, 8);
-
-    /* Read code lengths */
-    uint8_t code_lengths[MAX_SYMBOLS] = {0};
-    for (int i = 0; i < num_symbols; i++) {
-        code_lengths[i] = bit_reader_read(br, 5);
+/*
+ * n (at most 4) streams into [out[s], stop[s]): four at once while each has
+ * a whole entry left, so their lookups overlap, then each to its end
+ */
+static int decode_streams(const chuff_table_t *t, bit_reader_t *br, uint8_t **out,
+                          uint8_t **stop, int n) {
+    if (n == 4 && t->has_multi) {
+        for (;;) {
+            int room = 1;
+            for (int s = 0; s < 4; s++) {
+                room &= stop[s] - out[s] >= CHUFF_MULTI_SYMS;
+            }
+            if (!room) break;
+            if (decode_step(t, &br[0], &out[0]) < 0 ||
+                decode_step(t, &br[1], &out[1]) < 0 ||
+                decode_step(t, &br[2], &out[2]) < 0 ||
+                decode_step(t, &br[3], &out[3]) < 0) {
+                return -1;
+            }
+        }
     }
+    for (int s = 0; s < n; s++) {
+        if (chuff_decode_n(t, &br[s], out[s], (size_t)(stop[s] - out[s])) < 0) return -1;
+    }
+    return 0;
+}
 
-    /* Rebuild canonical Huffman codes */
-    code_entry_t codes[MAX_SYMBOLS] = {0};
-    uint32_t code = 0;
+int huffman_decode_x4(const uint8_t *encoded_data, size_t encoded_size,
+                      uint8_t *vector, size_t dimension) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_DECODE);
+    if (!encoded_data || !vector || encoded_size < 5) return -1;
 
-    for (int len = 1; len <= MAX_CODE_LENGTH; len++) {
-        for (int symbol = 0; symbol < num_symbols; symbol++) {
-            if (code_lengths[symbol] == len) {
-                codes[symbol].code = code;
-                codes[symbol].length = len;
-                code++;
-            }
+    bit_reader_t br[4];
+    chuff_table_t table;
+    br_init(&br[0], encoded_data, encoded_size);
+    if (read_header(&br[0], dimension, &table, dimension) < 0) return -1;
+    br_align(&br[0]);
+    size_t pos = br_tell(&br[0]) / 8;
+
+    /* Stream bounds from the size fields; the last stream takes the rest */
+    const unsigned size_bytes = size_field_bytes(dimension);
+    if (encoded_size - pos < 3 * size_bytes) return -1;
+    const uint8_t *sizes = encoded_data + pos;
+    pos += 3 * size_bytes;
+    uint8_t *out[4];
+    uint8_t *stop[4];
+    for (int s = 0; s < 4; s++) {
+        size_t bytes = encoded_size - pos;
+        if (s < 3) {
+            const size_t field = read_field(sizes + s * size_bytes, size_bytes);
+            if (field > bytes) return -1;
+            bytes = field;
         }
-        code <<= 1;
+        br_init(&br[s], encoded_data + pos, bytes);
+        pos += bytes;
+        out[s] = vector + s * dimension / 4;
+        stop[s] = vector + (s + 1) * dimension / 4;
     }
 
-    /* Decode data using lookup */
-    for (size_t i = 0; i < dimension; i++) {
-        uint32_t code_val = 0;
-        uint8_t code_len = 0;
-        uint8_t found = 0;
-
-        /* Read bits one at a time until we match a code */
-        for (code_len = 1; code_len <= MAX_CODE_LENGTH; code_len++) {
-            code_val = (code_val << 1) | bit_reader_read(br, 1);
-
-            /* Check all symbols with this code length */
-            for (int sym = 0; sym < num_symbols; sym++) {
-                if (codes[sym].length == code_len && codes[sym].code == code_val) {
-                    vector[i] = sym;
-                    found = 1;
-                    break;
-                }
-            }
+    return decode_streams(&table, br, out, stop, 4);
+}
 
-            if (found) break;
-        }
+/*
+ * One chunked decode: groups of four chunks, taken in turn by every thread
+ */
+typedef struct {
+    const chuff_table_t *table;
+    const uint8_t *jump;        /* K - 1 end offsets */
+    const uint8_t *chunks;      /* First chunk */
+    size_t chunks_size;         /* Bytes from the first chunk to the end */
+    unsigned entry_bytes;
+    size_t n_chunks;
+    uint8_t *vector;
+    size_t dimension;
+    atomic_size_t next;
+    atomic_int error;
+} chunked_job_t;
+
+static int decode_chunk_group(chunked_job_t *job, size_t group) {
+    bit_reader_t br[4];
+    uint8_t *out[4];
+    uint8_t *stop[4];
+    const size_t c0 = group * 4;
+    const int n = job->n_chunks - c0 < 4 ? (int)(job->n_chunks - c0) : 4;
+
+    for (int s = 0; s < n; s++) {
+        const size_t c = c0 + (size_t)s;
+        const size_t begin = c ? read_field(job->jump + (c - 1) * job->entry_bytes,
+                                            job->entry_bytes) : 0;
+        const size_t end = c + 1 < job->n_chunks
+                         ? read_field(job->jump + c * job->entry_bytes, job->entry_bytes)
+                         : job->chunks_size;
+        if (begin > end || end > job->chunks_size) return -1;
+        br_init(&br[s], job->chunks + begin, end - begin);
+        out[s] = job->vector + c * job->dimension / job->n_chunks;
+        stop[s] = job->vector + (c + 1) * job->dimension / job->n_chunks;
+    }
+    return decode_streams(job->table, br, out, stop, n);
+}
 
-        if (!found) {
-            free(br);
-            return -1;
+static void chunked_worker(void *arg) {
+    chunked_job_t *job = arg;
+    const size_t groups = (job->n_chunks + 3) / 4;
+    size_t group;
+    while (!atomic_load_explicit(&job->error, memory_order_relaxed) &&
+           (group = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < groups) {
+        if (decode_chunk_group(job, group) < 0) {
+            atomic_store(&job->error, 1);
         }
     }
+}
 
-    free(br);
+int huffman_decode_chunked(const uint8_t *encoded_data, size_t encoded_size,
+                           uint8_t *vector, size_t dimension, int threads) {
+    DNTL_STAT_SCOPE(DNTL_STAT_HUFFMAN_DECODE);
+    if (!encoded_data || !vector || encoded_size < 5) return -1;
 
-    return 0;
+    bit_reader_t br;
+    chuff_table_t table;
+    uint32_t n_chunks;
+    br_init(&br, encoded_data, encoded_size);
+    if (read_header(&br, dimension, &table, dimension) < 0) return -1;
+    if (br_read_bits(&br, 16, &n_chunks) < 0) return -1;
+    if (n_chunks == 0 || n_chunks > dimension) return -1;
+    br_align(&br);
+    size_t pos = br_tell(&br) / 8;
+
+    chunked_job_t job;
+    job.table = &table;
+    job.entry_bytes = size_field_bytes(dimension);
+    if (encoded_size - pos < (n_chunks - 1) * (size_t)job.entry_bytes) return -1;
+    job.jump = encoded_data + pos;
+    pos += (n_chunks - 1) * (size_t)job.entry_bytes;
+    job.chunks = encoded_data + pos;
+    job.chunks_size = encoded_size - pos;
+    job.n_chunks = n_chunks;
+    job.vector = vector;
+    job.dimension = dimension;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.error, 0);
+
+    /* Fewer threads than asked (the scheduler's workers are shared) only
+     * means more groups for the ones running */
+    const size_t groups = (job.n_chunks + 3) / 4;
+    const size_t wanted = threads > 1 ? (size_t)threads : 1;
+    dntl_sched_spread(wanted > 1 ? dntl_sched_default() : NULL, chunked_worker, &job,
+                      wanted < groups ? wanted : groups);
+    return atomic_load(&job.error) ? -1 : 0;
 }
 
 /* ========== Cleanup ========== */
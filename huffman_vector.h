@@ -14,6 +14,12 @@
  *   // Decode
  *   uint8_t *decoded = malloc(2048);
  *   huffman_decode(enc->data, enc->size, decoded, 2048);
+ *
+ * Decoding is table-driven (canonical_huffman.h): several short codes per
+ * lookup. The x4 format splits the values over four streams that decode
+ * in step, for throughput; it is a separate format, not auto-detected.
+ * The chunked format generalises it to K streams behind a jump table, one
+ * code table for all: groups of four decode in step, groups across threads.
  */
 
 #ifndef HUFFMAN_VECTOR_H
@@ -39,6 +45,24 @@ typedef struct {
  */
 encoded_result_t* huffman_encode(const uint8_t *vector, size_t dimension);
 
+/**
+ * Encode into a caller-provided buffer, with no allocation
+ *
+ * @param out Output buffer; huffman_max_encoded_size() bytes always suffice
+ * @param out_cap Size of out
+ * @param written Out: bytes used (bytes past it may be overwritten up to out_cap)
+ * @return 0 on success, -1 on error or if the encoding does not fit
+ */
+int huffman_encode_into(const uint8_t *vector, size_t dimension,
+                        uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case encoded size of a vector (dense: every value is coded)
+ *
+ * @return Size in bytes, or 0 if dimension is 0
+ */
+size_t huffman_max_encoded_size(size_t dimension);
+
 /**
  * Decode Huffman-encoded data back to vector
  *
@@ -51,6 +75,64 @@ encoded_result_t* huffman_encode(const uint8_t *vector, size_t dimension);
 int huffman_decode(const uint8_t *encoded_data, size_t encoded_size,
                    uint8_t *vector, size_t dimension);
 
+/**
+ * As huffman_encode() and huffman_encode_into(), in the four-stream format
+ * (huffman_x4_max_encoded_size() bytes always suffice)
+ */
+encoded_result_t* huffman_encode_x4(const uint8_t *vector, size_t dimension);
+
+int huffman_encode_x4_into(const uint8_t *vector, size_t dimension,
+                           uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case size of the four-stream format
+ *
+ * @return Size in bytes, or 0 if dimension is 0
+ */
+size_t huffman_x4_max_encoded_size(size_t dimension);
+
+/**
+ * Decode the four-stream format
+ *
+ * @return 0 on success, -1 on error
+ */
+int huffman_decode_x4(const uint8_t *encoded_data, size_t encoded_size,
+                      uint8_t *vector, size_t dimension);
+
+/* Most chunks of the chunked format */
+#define HUFFMAN_MAX_CHUNKS 65535
+
+/**
+ * As huffman_encode() and huffman_encode_into(), in the chunked format:
+ * chunks streams, each independently decodable, 1..HUFFMAN_MAX_CHUNKS and
+ * at most dimension (huffman_chunked_max_encoded_size() bytes always
+ * suffice)
+ */
+encoded_result_t* huffman_encode_chunked(const uint8_t *vector, size_t dimension,
+                                         size_t chunks);
+
+int huffman_encode_chunked_into(const uint8_t *vector, size_t dimension, size_t chunks,
+                                uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case size of the chunked format
+ *
+ * @return Size in bytes, or 0 if dimension or chunks is out of range
+ */
+size_t huffman_chunked_max_encoded_size(size_t dimension, size_t chunks);
+
+/**
+ * Decode the chunked format on up to threads threads, the caller's
+ * included (1 or less: the caller's only); the stream names its chunks
+ *
+ * Each thread takes four chunks at a time, so chunks beyond 4 * threads
+ * keep every thread busy; for a single thread, 4 chunks suffice.
+ *
+ * @return 0 on success, -1 on error
+ */
+int huffman_decode_chunked(const uint8_t *encoded_data, size_t encoded_size,
+                           uint8_t *vector, size_t dimension, int threads);
+
 /**
  * Free encoded result
  */
@@ -0,0 +1,266 @@
+#include "keccak.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// PERMUTATION
+// ============================================================================
+
+static const uint64_t RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// rho offsets along the pi cycle starting at lane 1, and the cycle itself
+static const unsigned ROTC[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+static const unsigned PILN[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+static inline uint64_t rol64(uint64_t x, unsigned n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+void keccak_f1600(uint64_t state[25]) {
+    // A local copy stays in registers; state may alias anything
+    uint64_t s[25], c[5], t;
+    memcpy(s, state, sizeof(s));
+
+    for (int round = 0; round < 24; round++) {
+        // theta
+        #pragma GCC unroll 5
+        for (int x = 0; x < 5; x++) {
+            c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+        }
+        #pragma GCC unroll 5
+        for (int x = 0; x < 5; x++) {
+            t = c[(x + 4) % 5] ^ rol64(c[(x + 1) % 5], 1);
+            #pragma GCC unroll 5
+            for (int y = 0; y < 25; y += 5) {
+                s[y + x] ^= t;
+            }
+        }
+
+        // rho and pi
+        t = s[1];
+        #pragma GCC unroll 24
+        for (int i = 0; i < 24; i++) {
+            uint64_t next = s[PILN[i]];
+            s[PILN[i]] = rol64(t, ROTC[i]);
+            t = next;
+        }
+
+        // chi
+        #pragma GCC unroll 5
+        for (int y = 0; y < 25; y += 5) {
+            #pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                c[x] = s[y + x];
+            }
+            #pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                s[y + x] = c[x] ^ (~c[(x + 1) % 5] & c[(x + 2) % 5]);
+            }
+        }
+
+        // iota
+        s[0] ^= RC[round];
+    }
+    memcpy(state, s, sizeof(s));
+}
+
+#if defined(__AVX2__)
+
+#if defined(__AVX512VL__)
+#define ROL4(x, n) _mm256_rolv_epi64((x), _mm256_set1_epi64x(n))
+#else
+#define ROL4(x, n) _mm256_or_si256(_mm256_slli_epi64((x), (n)), _mm256_srli_epi64((x), 64 - (n)))
+#endif
+
+void keccak_f1600_x4(uint64_t *const s[4]) {
+    __m256i a[25], c[5], t;
+
+    // Lane i of state k goes to element k of a[i]
+    for (int i = 0; i < 25; i++) {
+        a[i] = _mm256_set_epi64x((long long)s[3][i], (long long)s[2][i],
+                                 (long long)s[1][i], (long long)s[0][i]);
+    }
+
+    for (int round = 0; round < 24; round++) {
+        #pragma GCC unroll 5
+        for (int x = 0; x < 5; x++) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20]));
+        }
+        #pragma GCC unroll 5
+        for (int x = 0; x < 5; x++) {
+            t = _mm256_xor_si256(c[(x + 4) % 5], ROL4(c[(x + 1) % 5], 1));
+            #pragma GCC unroll 5
+            for (int y = 0; y < 25; y += 5) {
+                a[y + x] = _mm256_xor_si256(a[y + x], t);
+            }
+        }
+
+        t = a[1];
+        #pragma GCC unroll 24
+        for (int i = 0; i < 24; i++) {
+            __m256i next = a[PILN[i]];
+            a[PILN[i]] = ROL4(t, ROTC[i]);
+            t = next;
+        }
+
+        #pragma GCC unroll 5
+        for (int y = 0; y < 25; y += 5) {
+            #pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                c[x] = a[y + x];
+            }
+            #pragma GCC unroll 5
+            for (int x = 0; x < 5; x++) {
+                a[y + x] = _mm256_xor_si256(c[x], _mm256_andnot_si256(c[(x + 1) % 5], c[(x + 2) % 5]));
+            }
+        }
+
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x((long long)RC[round]));
+    }
+
+    for (int i = 0; i < 25; i++) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i *)lanes, a[i]);
+        for (int k = 0; k < 4; k++) {
+            s[k][i] = lanes[k];
+        }
+    }
+}
+
+#else
+
+void keccak_f1600_x4(uint64_t *const s[4]) {
+    for (int k = 0; k < 4; k++) {
+        keccak_f1600(s[k]);
+    }
+}
+
+#endif
+
+// ============================================================================
+// SPONGE
+// ============================================================================
+
+// Lanes are little-endian: byte i of the block is byte i % 8 of lane i / 8
+static inline void xor_byte(keccak_state_t *st, uint32_t pos, uint8_t b) {
+    st->s[pos / 8] ^= (uint64_t)b << (8 * (pos % 8));
+}
+
+static inline uint8_t get_byte(const keccak_state_t *st, uint32_t pos) {
+    return (uint8_t)(st->s[pos / 8] >> (8 * (pos % 8)));
+}
+
+// Permute n states (1 or 4) that share a position
+static void permute_n(keccak_state_t *st, int n) {
+    if (n == 1) {
+        keccak_f1600(st->s);
+    } else {
+        uint64_t *const s[4] = { st[0].s, st[1].s, st[2].s, st[3].s };
+        keccak_f1600_x4(s);
+    }
+    for (int k = 0; k < n; k++) {
+        st[k].pos = 0;
+    }
+}
+
+static void absorb_n(keccak_state_t *st, int n, const uint8_t *const in[], size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        const uint32_t pos = st[0].pos;
+        size_t take = st[0].rate - pos;
+        if (take > len - off) {
+            take = len - off;
+        }
+        for (int k = 0; k < n; k++) {
+            for (size_t b = 0; b < take; b++) {
+                xor_byte(&st[k], pos + (uint32_t)b, in[k][off + b]);
+            }
+            st[k].pos = pos + (uint32_t)take;
+        }
+        off += take;
+        if (st[0].pos == st[0].rate) {
+            permute_n(st, n);
+        }
+    }
+}
+
+static void finalize_n(keccak_state_t *st, int n) {
+    for (int k = 0; k < n; k++) {
+        xor_byte(&st[k], st[k].pos, st[k].pad);
+        xor_byte(&st[k], st[k].rate - 1, 0x80);
+    }
+    permute_n(st, n);
+}
+
+static void squeeze_n(keccak_state_t *st, int n, uint8_t *const out[], size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        if (st[0].pos == st[0].rate) {
+            permute_n(st, n);
+        }
+        const uint32_t pos = st[0].pos;
+        size_t take = st[0].rate - pos;
+        if (take > len - off) {
+            take = len - off;
+        }
+        for (int k = 0; k < n; k++) {
+            for (size_t b = 0; b < take; b++) {
+                out[k][off + b] = get_byte(&st[k], pos + (uint32_t)b);
+            }
+            st[k].pos = pos + (uint32_t)take;
+        }
+        off += take;
+    }
+}
+
+void keccak_init(keccak_state_t *st, uint32_t rate, uint8_t pad) {
+    memset(st->s, 0, sizeof(st->s));
+    st->rate = rate;
+    st->pos = 0;
+    st->pad = pad;
+}
+
+void keccak_absorb(keccak_state_t *st, const void *in, size_t len) {
+    const uint8_t *const p[1] = { in };
+    absorb_n(st, 1, p, len);
+}
+
+void keccak_finalize(keccak_state_t *st) {
+    finalize_n(st, 1);
+}
+
+void keccak_squeeze(keccak_state_t *st, void *out, size_t len) {
+    uint8_t *const p[1] = { out };
+    squeeze_n(st, 1, p, len);
+}
+
+void keccak_absorb_x4(keccak_state_t st[4], const void *const in[4], size_t len) {
+    const uint8_t *const p[4] = { in[0], in[1], in[2], in[3] };
+    absorb_n(st, 4, p, len);
+}
+
+void keccak_finalize_x4(keccak_state_t st[4]) {
+    finalize_n(st, 4);
+}
+
+void keccak_squeeze_x4(keccak_state_t st[4], void *const out[4], size_t len) {
+    uint8_t *const p[4] = { out[0], out[1], out[2], out[3] };
+    squeeze_n(st, 4, p, len);
+}
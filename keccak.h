@@ -0,0 +1,85 @@
+#ifndef KECCAK_H
+#define KECCAK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// KECCAK SPONGE (SHA3-256, SHAKE-256)
+// ============================================================================
+
+// Rates in bytes, and the domain padding bytes of FIPS 202
+#define KECCAK_SHA3_256_RATE 136
+#define KECCAK_SHAKE256_RATE 136
+#define KECCAK_SHA3_PAD      0x06
+#define KECCAK_SHAKE_PAD     0x1F
+
+/**
+ * Sponge state: absorb, finalize once, then squeeze
+ *
+ * A state is a plain value. Copying one that has absorbed a common prefix
+ * (a label and a seed, say) and finishing each copy with its own suffix
+ * costs only the suffix: absorbing the prefix is done once.
+ */
+typedef struct {
+    uint64_t s[25];
+    uint32_t rate;      // bytes per block
+    uint32_t pos;       // bytes of the current block absorbed or squeezed
+    uint8_t pad;        // KECCAK_SHA3_PAD or KECCAK_SHAKE_PAD
+} keccak_state_t;
+
+/**
+ * Keccak-f[1600] on one state
+ */
+void keccak_f1600(uint64_t s[25]);
+
+/**
+ * Keccak-f[1600] on four states at once
+ *
+ * With AVX2, each 256-bit register holds the same lane of the four
+ * states: one permutation costs little more than a scalar one. Without
+ * AVX2 the states are permuted one after another.
+ */
+void keccak_f1600_x4(uint64_t *const s[4]);
+
+/**
+ * Start a sponge with rate bytes per block and domain padding pad
+ */
+void keccak_init(keccak_state_t *st, uint32_t rate, uint8_t pad);
+
+static inline void keccak_sha3_256_init(keccak_state_t *st) {
+    keccak_init(st, KECCAK_SHA3_256_RATE, KECCAK_SHA3_PAD);
+}
+
+static inline void keccak_shake256_init(keccak_state_t *st) {
+    keccak_init(st, KECCAK_SHAKE256_RATE, KECCAK_SHAKE_PAD);
+}
+
+void keccak_absorb(keccak_state_t *st, const void *in, size_t len);
+
+/**
+ * Pad and permute: the state then squeezes
+ */
+void keccak_finalize(keccak_state_t *st);
+
+/**
+ * Next len bytes of output (SHA3-256 digests are the first 32)
+ */
+void keccak_squeeze(keccak_state_t *st, void *out, size_t len);
+
+// ============================================================================
+// FOUR STATES IN LOCKSTEP
+// ============================================================================
+
+/**
+ * keccak_absorb(), keccak_finalize() and keccak_squeeze() on four states
+ *
+ * The states must be at the same position with the same rate: copies of one
+ * state, fed inputs of equal length. Every permutation is one
+ * keccak_f1600_x4(). Output is the same as four single-state calls.
+ */
+void keccak_absorb_x4(keccak_state_t st[4], const void *const in[4], size_t len);
+void keccak_finalize_x4(keccak_state_t st[4]);
+void keccak_squeeze_x4(keccak_state_t st[4], void *const out[4], size_t len);
+
+#endif // KECCAK_H
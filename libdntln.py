@@ -37,28 +37,58 @@ def calculate_norm(vector):
 
 # NOTE: Constant time lookup table replaces this in real implementations
 ################################################################
+# The pointwise operations are vectorized: inputs are any sequences of ints
+# (lists, numpy arrays). For moduli up to 2^16 (q = 257 in every config)
+# products fit in uint32 and the arithmetic stays in uint32; moduli up to
+# 2^32 use uint64. Both return int64 numpy arrays, so pk.tobytes() and
+# np.array(...) around the calls behave as before. Larger moduli compute in
+# Python ints and return object arrays, since results may not fit in int64.
+
+_WIDE_MODULUS = 1 << 32
+
+def _reduced(vec, modulus):
+    # Coefficients in [0, modulus) in the narrowest dtype that holds products
+    if modulus > _WIDE_MODULUS:
+        return np.array(vec, dtype=object) % modulus  # Python ints, no overflow
+    dtype = np.uint32 if modulus <= 1 << 16 else np.uint64
+    return np.remainder(np.asarray(vec, dtype=np.int64), modulus).astype(dtype)
+
+def _result(res, modulus):
+    # int64 for the fixed-width paths, Python ints for wide moduli
+    if modulus > _WIDE_MODULUS:
+        return np.array(res, dtype=object)
+    return res.astype(np.int64)
+
+def _naturals(res, modulus):
+    # Map 0 (additive identity) to modulus: the naturals [1, modulus]
+    res = _result(res, modulus)
+    res[res == 0] = modulus
+    return res
+
+def natural_mod(x, MODULUS):
+    # Custom natural modulo function that maps to [1, MODULUS]; elementwise
+    # for arrays
+    if np.ndim(x) == 0:
+        res = x % MODULUS
+        return res if res != 0 else MODULUS
+    return _naturals(_reduced(x, MODULUS), MODULUS)
+
 def pointwise_multiplication2(vec1, vec2, modulus):
-    return [(x * y) % modulus for x, y in zip(vec1, vec2)]
+    res = np.multiply(_reduced(vec1, modulus), _reduced(vec2, modulus)) % modulus
+    return _result(res, modulus)
 
 def pointwise_multiplication(vec1, vec2, modulus=257):
-    result = [(x * y) % modulus for x, y in zip(vec1, vec2)]
-
-    # Adjust for additive identity: Map any result of 0 to modulus (257)
-    result = [modulus if r == 0 else r for r in result]
-
-    return result
+    res = np.multiply(_reduced(vec1, modulus), _reduced(vec2, modulus)) % modulus
+    return _naturals(res, modulus)
 
 def pointwise_addition2(vec1, vec2, modulus):
-    return [(x + y) % modulus for x, y in zip(vec1, vec2)]
+    res = np.add(_reduced(vec1, modulus), _reduced(vec2, modulus)) % modulus
+    return _result(res, modulus)
 
 
 def pointwise_addition(vec1, vec2, modulus=257):
-    result = [(x + y) % modulus for x, y in zip(vec1, vec2)]
-
-    # Adjust for additive identity: Map any result of 0 to modulus (257)
-    result = [modulus if r == 0 else r for r in result]
-
-    return result
+    res = np.add(_reduced(vec1, modulus), _reduced(vec2, modulus)) % modulus
+    return _naturals(res, modulus)
 
 def gaussian_select_from_set(
     mu=3, sigma=3, s=1, allowed_values=[-9, -8, -7, -6, -5, -4, -3, 3, 4, 5, 6, 7, 8, 9]
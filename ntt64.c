@@ -1,4 +1,7 @@
 #include "ntt64.h"
+#include "ntt64_simd.h"
+#include "dntl_stats.h"
+#include <stddef.h>
 #include <string.h>
 
 // ============================================================================
@@ -204,6 +207,25 @@ static inline uint32_t ct_mul_mod(uint32_t a, uint32_t b, int layer) {
     return ct_barrett_reduce(product, layer);
 }
 
+/**
+ * Constant-time modular multiplication for reduced operands (a, b < q)
+ *
+ * For q < 2^16 the product fits in 32 bits and a 32-bit Barrett quotient
+ * (floor(2^32 / q) = BARRETT_CONST >> 32) is off by at most one. When the
+ * layer is a compile-time constant the branch and both constants fold away.
+ */
+static inline uint32_t ct_mul_mod_reduced(uint32_t a, uint32_t b, int layer) {
+    uint32_t q = Q[layer];
+    if (q < (1u << 16)) {
+        uint32_t x = a * b;
+        uint32_t b32 = (uint32_t)(BARRETT_CONST[layer] >> 32);
+        uint32_t r = x - (uint32_t)(((uint64_t)x * b32) >> 32) * q;
+        uint32_t mask = -(uint32_t)(r >= q);
+        return r - (mask & q);
+    }
+    return ct_mul_mod(a, b, layer);
+}
+
 /**
  * Constant-time modular addition: (a + b) mod q
  */
@@ -276,7 +298,7 @@ void bit_reverse_copy(uint32_t poly[NTT_N]) {
  * (a, b) -> (a + w*b, a - w*b) mod q
  */
 static inline void ct_butterfly(uint32_t *a, uint32_t *b, uint32_t w, int layer) {
-    uint32_t t = ct_mul_mod(*b, w, layer);
+    uint32_t t = ct_mul_mod_reduced(*b, w, layer);
     uint32_t u = *a;
 
     *a = ct_add_mod(u, t, layer);
@@ -295,123 +317,1057 @@ static inline void ct_inv_butterfly(uint32_t *a, uint32_t *b, uint32_t w, int la
     *a = ct_add_mod(u, v, layer);
 
     uint32_t diff = ct_sub_mod(u, v, layer);
-    *b = ct_mul_mod(diff, w, layer);
+    *b = ct_mul_mod_reduced(diff, w, layer);
 }
 
 // ============================================================================
-// FORWARD NTT (Scalar implementation)
+// NTT KERNELS (merged negacyclic CT / GS, bit-reversed NTT domain)
 // ============================================================================
+//
+// The kernels below are always inlined into one instance per modulus (see
+// PER-MODULUS INSTANCES), so `layer` is a constant inside each body: Q[layer],
+// the Barrett constants and psi tables fold to immediates, and the <= 16-bit
+// moduli get 32-bit reductions.
+//
+// psi is merged into the butterflies: the k-th block (k = 1..63, in the order
+// the forward transform visits them) is twisted by zeta_k = psi^brv6(k), so no
+// separate psi pass or bit reversal is needed and the output is the natural
+// NTT in bit-reversed order. The inverse uses psi^(-brv6(k)) and folds N^(-1)
+// into its last stage. Pointwise products are order-independent, so data can
+// stay in this domain between the two transforms.
+
+// brv6(k) for k in [0, 64), so zeta_k = PSI_POWERS[layer][BITREV6[k]]
+static const uint8_t BITREV6[NTT_N] = {
+     0, 32, 16, 48,  8, 40, 24, 56,  4, 36, 20, 52, 12, 44, 28, 60,
+     2, 34, 18, 50, 10, 42, 26, 58,  6, 38, 22, 54, 14, 46, 30, 62,
+     1, 33, 17, 49,  9, 41, 25, 57,  5, 37, 21, 53, 13, 45, 29, 61,
+     3, 35, 19, 51, 11, 43, 27, 59,  7, 39, 23, 55, 15, 47, 31, 63
+};
 
-void ntt64_forward_scalar(uint32_t poly[NTT_N], int layer) {
-    // Preprocessing: multiply poly[i] by psi^i using precomputed table
-    for (uint32_t i = 0; i < NTT_N; i++) {
-        poly[i] = ct_mul_mod(poly[i], PSI_POWERS[layer][i], layer);
+static inline __attribute__((always_inline))
+void ntt64_forward_bitrev_kernel(uint32_t poly[NTT_N], int layer) {
+    // First stage (len = 32) also reduces the input, which need not be < q
+    uint32_t zeta = PSI_POWERS[layer][BITREV6[1]];
+    for (uint32_t j = 0; j < NTT_N / 2; j++) {
+        uint32_t t = ct_mul_mod(poly[j + 32], zeta, layer);
+        uint32_t u = ct_barrett_reduce(poly[j], layer);
+        poly[j] = ct_add_mod(u, t, layer);
+        poly[j + 32] = ct_sub_mod(u, t, layer);
     }
 
-    // Bit-reverse input
+    uint32_t k = 2;
+    for (uint32_t len = 16; len >= 1; len >>= 1) {
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            zeta = PSI_POWERS[layer][BITREV6[k++]];
+            for (uint32_t j = start; j < start + len; j++) {
+                ct_butterfly(&poly[j], &poly[j + len], zeta, layer);
+            }
+        }
+    }
+}
+
+static inline __attribute__((always_inline))
+void ntt64_inverse_bitrev_kernel(uint32_t poly[NTT_N], int layer) {
+    for (uint32_t len = 1; len < NTT_N / 2; len <<= 1) {
+        // Blocks of this stage are k = 32/len .. 64/len - 1 in forward order
+        uint32_t k = NTT_N / (2 * len);
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            uint32_t zeta = PSI_INV_POWERS[layer][BITREV6[k++]];
+            for (uint32_t j = start; j < start + len; j++) {
+                ct_inv_butterfly(&poly[j], &poly[j + len], zeta, layer);
+            }
+        }
+    }
+
+    // Last stage (len = 32, k = 1) with N^(-1) folded into both outputs
+    uint32_t n_inv = N_INV[layer];
+    uint32_t zeta = ct_mul_mod_reduced(PSI_INV_POWERS[layer][BITREV6[1]], n_inv, layer);
+    for (uint32_t j = 0; j < NTT_N / 2; j++) {
+        uint32_t u = poly[j];
+        uint32_t v = poly[j + 32];
+        poly[j] = ct_mul_mod_reduced(ct_add_mod(u, v, layer), n_inv, layer);
+        poly[j + 32] = ct_mul_mod_reduced(ct_sub_mod(u, v, layer), zeta, layer);
+    }
+}
+
+// Natural-order transforms: the merged kernels plus one index permutation
+static inline __attribute__((always_inline))
+void ntt64_forward_kernel(uint32_t poly[NTT_N], int layer) {
+    ntt64_forward_bitrev_kernel(poly, layer);
     bit_reverse_copy(poly);
+}
 
-    // Standard Cooley-Tukey NTT (iterative, constant-time)
-    // log2(64) = 6 stages
-    for (uint32_t stage = 0; stage < 6; stage++) {
-        uint32_t m = 1u << (stage + 1);        // Block size
-        uint32_t m_half = 1u << stage;         // Half block size
+static inline __attribute__((always_inline))
+void ntt64_inverse_kernel(uint32_t poly[NTT_N], int layer) {
+    bit_reverse_copy(poly);
+    ntt64_inverse_bitrev_kernel(poly, layer);
+}
 
-        // Get precomputed twiddle factor for this stage
-        uint32_t omega_m = TWIDDLES_FWD[layer][stage];
+// ============================================================================
+// Q = 257 SHIFT-REDUCTION TRANSFORM
+// ============================================================================
+//
+// 257 = 2^8 + 1, so 2^8 ≡ -1 and x ≡ (x & 0xFF) - (x >> 8) (mod 257) for a
+// signed x (arithmetic shift). The blocks k = 1..7 of the merged schedule have
+// psi^brv6(k) in the order-16 subgroup generated by 2, so the first three
+// forward stages, and the last three inverse stages with N^(-1) = 2^10, only
+// multiply by powers of two. Coefficients stay signed in [-16, 272) between
+// stages; only the output is brought to [0, 257).
+
+// psi^brv6(k) = 2^FERMAT257_FWD_SHIFT[k] and psi^(-brv6(k)) = 2^FERMAT257_INV_SHIFT[k]
+static const int FERMAT257_FWD_SHIFT[8] = { 0, 12, 6, 2, 11, 7, 1, 13 };
+static const int FERMAT257_INV_SHIFT[8] = { 0, 4, 10, 14, 5, 9, 15, 3 };
+
+// 64^(-1) = 2^10 and psi^(-32) * 64^(-1) = 2^14 (mod 257)
+#define FERMAT257_N_INV_SHIFT 10
+#define FERMAT257_ZETA1_N_INV_SHIFT 14
+
+static inline int32_t fermat257_fold(int32_t x) {
+    return (x & 0xFF) - (x >> 8);
+}
 
-        // Process all blocks at this stage
-        for (uint32_t k = 0; k < NTT_N; k += m) {
-            uint32_t w = 1;
+// x * 2^e, folded once (0 <= e < 16; 2^(e-8) = -2^e)
+static inline int32_t fermat257_mul_pow2(int32_t x, int e) {
+    int32_t t = (e < 8) ? x * (1 << e) : -(x * (1 << (e - 8)));
+    return fermat257_fold(t);
+}
 
-            for (uint32_t j = 0; j < m_half; j++) {
-                uint32_t idx_a = k + j;
-                uint32_t idx_b = k + j + m_half;
+// [-16, 272) -> [0, 257)
+static inline uint32_t fermat257_canonical(int32_t x) {
+    x += (x >> 31) & 257;
+    x -= ((256 - x) >> 31) & 257;
+    return (uint32_t)x;
+}
 
-                ct_butterfly(&poly[idx_a], &poly[idx_b], w, layer);
+static inline __attribute__((always_inline))
+void fermat257_forward_bitrev_kernel(uint32_t poly[NTT_N]) {
+    int32_t x[NTT_N];
 
-                w = ct_mul_mod(w, omega_m, layer);
+    // Any 32-bit input: one unsigned fold to (-2^24, 256), then three signed
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        int32_t r = (int32_t)(poly[j] & 0xFF) - (int32_t)(poly[j] >> 8);
+        x[j] = fermat257_fold(fermat257_fold(fermat257_fold(r)));
+    }
+
+    // len = 32, 16, 8: shift twiddles
+    uint32_t k = 1;
+    for (uint32_t len = 32; len >= 8; len >>= 1) {
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            int e = FERMAT257_FWD_SHIFT[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                int32_t t = fermat257_mul_pow2(x[j + len], e);
+                int32_t u = x[j];
+                x[j] = fermat257_fold(u + t);
+                x[j + len] = fermat257_fold(u - t);
+            }
+        }
+    }
+
+    // len = 4, 2, 1: table twiddles
+    for (uint32_t len = 4; len >= 1; len >>= 1) {
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            int32_t zeta = (int32_t)PSI_POWERS[NTT_LAYER_257][BITREV6[k++]];
+            for (uint32_t j = start; j < start + len; j++) {
+                int32_t t = fermat257_fold(x[j + len] * zeta);
+                int32_t u = x[j];
+                x[j] = fermat257_fold(u + t);
+                x[j + len] = fermat257_fold(u - t);
             }
         }
     }
+
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        poly[j] = fermat257_canonical(x[j]);
+    }
+}
+
+static inline __attribute__((always_inline))
+void fermat257_inverse_bitrev_kernel(uint32_t poly[NTT_N]) {
+    int32_t x[NTT_N];
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        x[j] = (int32_t)poly[j];
+    }
+
+    // len = 1, 2, 4: table twiddles
+    for (uint32_t len = 1; len <= 4; len <<= 1) {
+        uint32_t k = NTT_N / (2 * len);
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            int32_t zeta = (int32_t)PSI_INV_POWERS[NTT_LAYER_257][BITREV6[k++]];
+            for (uint32_t j = start; j < start + len; j++) {
+                int32_t u = x[j];
+                int32_t v = x[j + len];
+                x[j] = fermat257_fold(u + v);
+                x[j + len] = fermat257_fold(fermat257_fold((u - v) * zeta));
+            }
+        }
+    }
+
+    // len = 8, 16: shift twiddles
+    for (uint32_t len = 8; len <= 16; len <<= 1) {
+        uint32_t k = NTT_N / (2 * len);
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            int e = FERMAT257_INV_SHIFT[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                int32_t u = x[j];
+                int32_t v = x[j + len];
+                x[j] = fermat257_fold(u + v);
+                x[j + len] = fermat257_fold(fermat257_mul_pow2(u - v, e));
+            }
+        }
+    }
+
+    // len = 32 with N^(-1) folded into both outputs
+    for (uint32_t j = 0; j < NTT_N / 2; j++) {
+        int32_t u = x[j];
+        int32_t v = x[j + 32];
+        poly[j] = fermat257_canonical(
+            fermat257_fold(fermat257_mul_pow2(u + v, FERMAT257_N_INV_SHIFT)));
+        poly[j + 32] = fermat257_canonical(
+            fermat257_fold(fermat257_mul_pow2(u - v, FERMAT257_ZETA1_N_INV_SHIFT)));
+    }
+}
+
+void ntt64_forward_bitrev_f257(uint32_t poly[NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    fermat257_forward_bitrev_kernel(poly);
+}
+
+void ntt64_inverse_bitrev_f257(uint32_t poly[NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    fermat257_inverse_bitrev_kernel(poly);
+}
+
+void ntt64_forward_f257(uint32_t poly[NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    fermat257_forward_bitrev_kernel(poly);
+    bit_reverse_copy(poly);
+}
+
+void ntt64_inverse_f257(uint32_t poly[NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    bit_reverse_copy(poly);
+    fermat257_inverse_bitrev_kernel(poly);
 }
 
 // ============================================================================
-// INVERSE NTT (Scalar implementation)
+// POINT-WISE MULTIPLICATION (Scalar implementation)
 // ============================================================================
 
-void ntt64_inverse_scalar(uint32_t poly[NTT_N], int layer) {
-    // Standard Gentleman-Sande inverse NTT (iterative, constant-time)
-    // log2(64) = 6 stages (reverse order compared to forward)
-    for (int stage = 5; stage >= 0; stage--) {
-        uint32_t m = 1u << (stage + 1);
-        uint32_t m_half = 1u << stage;
+static inline __attribute__((always_inline))
+void ntt64_pointwise_kernel(uint32_t result[NTT_N],
+                            const uint32_t a[NTT_N],
+                            const uint32_t b[NTT_N],
+                            int layer) {
+    for (uint32_t i = 0; i < NTT_N; i++) {
+        result[i] = ct_mul_mod_reduced(a[i], b[i], layer);
+    }
+}
+
+// ============================================================================
+// RUNTIME MODULI (table-driven kernels)
+// ============================================================================
+
+static ntt64_modulus_tables_t RUNTIME_TABLES[NTT_MAX_LAYERS - NTT_NUM_LAYERS];
+static int runtime_layer_count = 0;
+
+static inline const ntt64_modulus_tables_t *runtime_tables(int layer) {
+    return &RUNTIME_TABLES[layer - NTT_NUM_LAYERS];
+}
+
+/**
+ * Shoup multiplication: a * w mod q for a < 2^32, w < q, w_shoup = floor(w * 2^32 / q)
+ *
+ * The quotient estimate (a * w_shoup) >> 32 is at most one too small, so the
+ * remainder is below 2q and one conditional subtraction is enough.
+ */
+static inline uint32_t shoup_mul_mod(uint32_t a, uint32_t w, uint32_t w_shoup, uint32_t q) {
+    uint64_t quot = ((uint64_t)a * w_shoup) >> 32;
+    uint64_t r = (uint64_t)a * w - quot * q;
+    uint64_t mask = -(uint64_t)(r >= q);
+    return (uint32_t)(r - (mask & q));
+}
+
+static inline uint32_t runtime_reduce(uint64_t x, const ntt64_modulus_tables_t *t) {
+    uint64_t q_approx = ((__uint128_t)x * t->barrett) >> 64;
+    uint64_t r = x - q_approx * t->q;
+    uint64_t mask = -(uint64_t)(r >= t->q);
+    return (uint32_t)(r - (mask & t->q));
+}
+
+static inline uint32_t runtime_add_mod(uint32_t a, uint32_t b, uint32_t q) {
+    uint64_t sum = (uint64_t)a + (uint64_t)b;
+    uint64_t mask = -(uint64_t)(sum >= q);
+    return (uint32_t)(sum - (mask & q));
+}
 
-        // Get precomputed twiddle factor for this stage
-        uint32_t omega_m = TWIDDLES_INV[layer][stage];
+static inline uint32_t runtime_sub_mod(uint32_t a, uint32_t b, uint32_t q) {
+    int64_t diff = (int64_t)a - (int64_t)b;
+    int64_t mask = -(int64_t)(diff < 0);
+    return (uint32_t)(diff + (mask & q));
+}
 
-        // Process all blocks at this stage
-        for (uint32_t k = 0; k < NTT_N; k += m) {
-            uint32_t w = 1;
+static void runtime_forward_bitrev(uint32_t poly[NTT_N], const ntt64_modulus_tables_t *t) {
+    const uint32_t q = t->q;
 
-            for (uint32_t j = 0; j < m_half; j++) {
-                uint32_t idx_a = k + j;
-                uint32_t idx_b = k + j + m_half;
+    // First stage: Shoup accepts any 32-bit b, the Barrett step reduces a
+    for (uint32_t j = 0; j < NTT_N / 2; j++) {
+        uint32_t v = shoup_mul_mod(poly[j + 32], t->zetas[1], t->zetas_shoup[1], q);
+        uint32_t u = runtime_reduce(poly[j], t);
+        poly[j] = runtime_add_mod(u, v, q);
+        poly[j + 32] = runtime_sub_mod(u, v, q);
+    }
 
-                ct_inv_butterfly(&poly[idx_a], &poly[idx_b], w, layer);
+    uint32_t k = 2;
+    for (uint32_t len = 16; len >= 1; len >>= 1) {
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            uint32_t zeta = t->zetas[k];
+            uint32_t zeta_shoup = t->zetas_shoup[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                uint32_t v = shoup_mul_mod(poly[j + len], zeta, zeta_shoup, q);
+                uint32_t u = poly[j];
+                poly[j] = runtime_add_mod(u, v, q);
+                poly[j + len] = runtime_sub_mod(u, v, q);
+            }
+        }
+    }
+}
 
-                w = ct_mul_mod(w, omega_m, layer);
+static void runtime_inverse_bitrev(uint32_t poly[NTT_N], const ntt64_modulus_tables_t *t) {
+    const uint32_t q = t->q;
+
+    for (uint32_t len = 1; len < NTT_N / 2; len <<= 1) {
+        uint32_t k = NTT_N / (2 * len);
+        for (uint32_t start = 0; start < NTT_N; start += 2 * len) {
+            uint32_t zeta = t->zetas_inv[k];
+            uint32_t zeta_shoup = t->zetas_inv_shoup[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                uint32_t u = poly[j];
+                uint32_t v = poly[j + len];
+                poly[j] = runtime_add_mod(u, v, q);
+                poly[j + len] = shoup_mul_mod(runtime_sub_mod(u, v, q), zeta, zeta_shoup, q);
             }
         }
     }
 
-    // Bit-reverse output
-    bit_reverse_copy(poly);
+    for (uint32_t j = 0; j < NTT_N / 2; j++) {
+        uint32_t u = poly[j];
+        uint32_t v = poly[j + 32];
+        poly[j] = shoup_mul_mod(runtime_add_mod(u, v, q), t->n_inv, t->n_inv_shoup, q);
+        poly[j + 32] = shoup_mul_mod(runtime_sub_mod(u, v, q),
+                                     t->zeta1_n_inv, t->zeta1_n_inv_shoup, q);
+    }
+}
 
-    // Multiply by N^(-1) to complete inverse transform
-    uint32_t n_inv = N_INV[layer];
+static void runtime_pointwise_mul(uint32_t result[NTT_N],
+                                  const uint32_t a[NTT_N],
+                                  const uint32_t b[NTT_N],
+                                  const ntt64_modulus_tables_t *t) {
     for (uint32_t i = 0; i < NTT_N; i++) {
-        poly[i] = ct_mul_mod(poly[i], n_inv, layer);
+        result[i] = runtime_reduce((uint64_t)a[i] * b[i], t);
     }
+}
 
-    // Postprocessing: multiply poly[i] by psi^(-i) using precomputed table
+// Variable-time helpers, only used while building tables (q is public)
+static uint32_t table_pow_mod(uint32_t base, uint64_t exp, uint32_t q) {
+    uint64_t result = 1, b = base % q;
+    while (exp) {
+        if (exp & 1) {
+            result = (result * b) % q;
+        }
+        b = (b * b) % q;
+        exp >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+static uint32_t table_shoup(uint32_t w, uint32_t q) {
+    return (uint32_t)(((uint64_t)w << 32) / q);
+}
+
+/**
+ * Smallest generator of Z_q^*, or 0 if q is not prime
+ *
+ * Same search as find_primitive_root() in compute_new_constants.py, so the
+ * built-in moduli get their built-in psi back.
+ */
+static uint32_t table_find_generator(uint32_t q) {
+    uint32_t factors[32];
+    int count = 0;
+    uint32_t m = q - 1;
+
+    for (uint32_t d = 2; (uint64_t)d * d <= q; d++) {
+        if (q % d == 0) {
+            return 0;
+        }
+    }
+    for (uint32_t d = 2; (uint64_t)d * d <= m; d++) {
+        if (m % d == 0) {
+            factors[count++] = d;
+            while (m % d == 0) {
+                m /= d;
+            }
+        }
+    }
+    if (m > 1) {
+        factors[count++] = m;
+    }
+
+    for (uint32_t g = 2; g < q; g++) {
+        int primitive = 1;
+        for (int i = 0; i < count && primitive; i++) {
+            primitive = table_pow_mod(g, (q - 1) / factors[i], q) != 1;
+        }
+        if (primitive) {
+            return g;
+        }
+    }
+    return 0;
+}
+
+int ntt64_build_tables(ntt64_modulus_tables_t *tables, uint32_t q) {
+    if (q < 3 || (q - 1) % (2 * NTT_N) != 0) {
+        return -1;
+    }
+    uint32_t g = table_find_generator(q);
+    if (g == 0) {
+        return -1;
+    }
+
+    ntt64_modulus_tables_t *t = tables;
+    memset(t, 0, sizeof(*t));
+    t->q = q;
+    t->psi = table_pow_mod(g, (q - 1) / (2 * NTT_N), q);
+    t->n_inv = table_pow_mod(NTT_N, q - 2, q);
+    t->barrett = (uint64_t)(((__uint128_t)1 << 64) / q);
+
+    // Newton iteration for q^(-1) mod 2^32 (q odd; each step doubles the bits)
+    uint32_t qinv = q;
+    for (int i = 0; i < 5; i++) {
+        qinv *= 2 - q * qinv;
+    }
+    uint64_t r = ((uint64_t)1 << 32) % q;
+    t->qinv = qinv;
+    t->r2 = (uint32_t)((r * r) % q);
+
+    uint32_t psi_inv = table_pow_mod(t->psi, q - 2, q);
     for (uint32_t i = 0; i < NTT_N; i++) {
-        poly[i] = ct_mul_mod(poly[i], PSI_INV_POWERS[layer][i], layer);
+        t->psi_powers[i] = table_pow_mod(t->psi, i, q);
+        t->psi_inv_powers[i] = table_pow_mod(psi_inv, i, q);
     }
+    for (uint32_t stage = 0; stage < 6; stage++) {
+        // omega^(64 / 2^(stage+1)) = psi^(128 / 2^(stage+1))
+        uint32_t e = (2 * NTT_N) >> (stage + 1);
+        t->twiddles_fwd[stage] = table_pow_mod(t->psi, e, q);
+        t->twiddles_inv[stage] = table_pow_mod(psi_inv, e, q);
+    }
+
+    for (uint32_t k = 0; k < NTT_N; k++) {
+        uint32_t z = t->psi_powers[BITREV6[k]];
+        uint32_t z_inv = t->psi_inv_powers[BITREV6[k]];
+        t->zetas[k] = z;
+        t->zetas_inv[k] = z_inv;
+        t->zetas_shoup[k] = table_shoup(z, q);
+        t->zetas_inv_shoup[k] = table_shoup(z_inv, q);
+        t->zetas_mont[k] = (uint32_t)(((uint64_t)z << 32) % q);
+        t->zetas_inv_mont[k] = (uint32_t)(((uint64_t)z_inv << 32) % q);
+    }
+
+    t->n_inv_shoup = table_shoup(t->n_inv, q);
+    t->zeta1_n_inv = (uint32_t)(((uint64_t)t->zetas_inv[1] * t->n_inv) % q);
+    t->zeta1_n_inv_shoup = table_shoup(t->zeta1_n_inv, q);
+    return 0;
+}
+
+int ntt64_register_modulus(uint32_t q) {
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        if (Q[layer] == q) {
+            return layer;
+        }
+    }
+    for (int i = 0; i < runtime_layer_count; i++) {
+        if (RUNTIME_TABLES[i].q == q) {
+            return NTT_NUM_LAYERS + i;
+        }
+    }
+    if (runtime_layer_count == NTT_MAX_LAYERS - NTT_NUM_LAYERS) {
+        return -1;
+    }
+    if (ntt64_build_tables(&RUNTIME_TABLES[runtime_layer_count], q) != 0) {
+        return -1;
+    }
+    return NTT_NUM_LAYERS + runtime_layer_count++;
+}
+
+const ntt64_modulus_tables_t *ntt64_get_tables(int layer) {
+    if (layer < NTT_NUM_LAYERS || layer >= NTT_NUM_LAYERS + runtime_layer_count) {
+        return NULL;
+    }
+    return runtime_tables(layer);
 }
 
 // ============================================================================
-// POINT-WISE MULTIPLICATION (Scalar implementation)
+// MODULAR INVERSION (Fermat, fixed chain per modulus)
+// ============================================================================
+
+/**
+ * a^(q-2) mod q by left-to-right square-and-multiply
+ *
+ * The bits of q - 2 decide which steps multiply, but q is public and, in the
+ * per-modulus instances, a compile-time constant: the loop unrolls into one
+ * fixed chain per prime and nothing depends on a.
+ */
+static inline __attribute__((always_inline))
+uint32_t ntt64_inv_mod_kernel(uint32_t a, int layer) {
+    const uint32_t e = Q[layer] - 2;
+    uint32_t x = ct_barrett_reduce(a, layer);
+    uint32_t r = x;
+
+#pragma GCC unroll 32
+    for (int bit = 30 - __builtin_clz(e); bit >= 0; bit--) {
+        r = ct_mul_mod_reduced(r, r, layer);
+        if ((e >> bit) & 1) {
+            r = ct_mul_mod_reduced(r, x, layer);
+        }
+    }
+    return r;
+}
+
+// ============================================================================
+// PER-MODULUS INSTANCES
 // ============================================================================
 
+#define NTT64_DEFINE_MODULUS(q, layer)                                          \
+    void ntt64_forward_q##q(uint32_t poly[NTT_N]) {                             \
+        ntt64_forward_kernel(poly, layer);                                      \
+    }                                                                           \
+    void ntt64_inverse_q##q(uint32_t poly[NTT_N]) {                             \
+        ntt64_inverse_kernel(poly, layer);                                      \
+    }                                                                           \
+    void ntt64_pointwise_mul_q##q(uint32_t result[NTT_N],                       \
+                                  const uint32_t a[NTT_N],                      \
+                                  const uint32_t b[NTT_N]) {                    \
+        ntt64_pointwise_kernel(result, a, b, layer);                            \
+    }                                                                           \
+    void ntt64_forward_bitrev_q##q(uint32_t poly[NTT_N]) {                      \
+        ntt64_forward_bitrev_kernel(poly, layer);                               \
+    }                                                                           \
+    void ntt64_inverse_bitrev_q##q(uint32_t poly[NTT_N]) {                      \
+        ntt64_inverse_bitrev_kernel(poly, layer);                               \
+    }                                                                           \
+    uint32_t ntt64_inv_mod_q##q(uint32_t a) {                                   \
+        return ntt64_inv_mod_kernel(a, layer);                                  \
+    }
+
+NTT64_DEFINE_MODULUS(257,        NTT_LAYER_257)
+NTT64_DEFINE_MODULUS(3329,       NTT_LAYER_3329)
+NTT64_DEFINE_MODULUS(10753,      NTT_LAYER_10753)
+NTT64_DEFINE_MODULUS(43777,      NTT_LAYER_43777)
+NTT64_DEFINE_MODULUS(64513,      NTT_LAYER_64513)
+NTT64_DEFINE_MODULUS(686593,     NTT_LAYER_686593)
+NTT64_DEFINE_MODULUS(2818573313, NTT_LAYER_2818573313)
+
+#undef NTT64_DEFINE_MODULUS
+
+typedef void (*ntt64_transform_q_fn)(uint32_t poly[NTT_N]);
+typedef void (*ntt64_pointwise_q_fn)(uint32_t result[NTT_N],
+                                     const uint32_t a[NTT_N],
+                                     const uint32_t b[NTT_N]);
+
+static const ntt64_transform_q_fn FORWARD_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_forward_q257, ntt64_forward_q3329, ntt64_forward_q10753, ntt64_forward_q43777,
+    ntt64_forward_q64513, ntt64_forward_q686593, ntt64_forward_q2818573313
+};
+
+static const ntt64_transform_q_fn INVERSE_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_inverse_q257, ntt64_inverse_q3329, ntt64_inverse_q10753, ntt64_inverse_q43777,
+    ntt64_inverse_q64513, ntt64_inverse_q686593, ntt64_inverse_q2818573313
+};
+
+static const ntt64_transform_q_fn FORWARD_BITREV_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_forward_bitrev_q257, ntt64_forward_bitrev_q3329, ntt64_forward_bitrev_q10753,
+    ntt64_forward_bitrev_q43777, ntt64_forward_bitrev_q64513, ntt64_forward_bitrev_q686593,
+    ntt64_forward_bitrev_q2818573313
+};
+
+static const ntt64_transform_q_fn INVERSE_BITREV_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_inverse_bitrev_q257, ntt64_inverse_bitrev_q3329, ntt64_inverse_bitrev_q10753,
+    ntt64_inverse_bitrev_q43777, ntt64_inverse_bitrev_q64513, ntt64_inverse_bitrev_q686593,
+    ntt64_inverse_bitrev_q2818573313
+};
+
+typedef uint32_t (*ntt64_inv_mod_q_fn)(uint32_t a);
+
+static const ntt64_inv_mod_q_fn INV_MOD_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_inv_mod_q257, ntt64_inv_mod_q3329, ntt64_inv_mod_q10753, ntt64_inv_mod_q43777,
+    ntt64_inv_mod_q64513, ntt64_inv_mod_q686593, ntt64_inv_mod_q2818573313
+};
+
+static const ntt64_pointwise_q_fn POINTWISE_BY_LAYER[NTT_NUM_LAYERS] = {
+    ntt64_pointwise_mul_q257, ntt64_pointwise_mul_q3329, ntt64_pointwise_mul_q10753,
+    ntt64_pointwise_mul_q43777, ntt64_pointwise_mul_q64513, ntt64_pointwise_mul_q686593,
+    ntt64_pointwise_mul_q2818573313
+};
+
+// Table-driven front ends: `layer` is public, so the indirect jump leaks nothing.
+// Registered layers run the runtime kernels on their own tables.
+void ntt64_forward_scalar(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        runtime_forward_bitrev(poly, runtime_tables(layer));
+        bit_reverse_copy(poly);
+        return;
+    }
+    FORWARD_BY_LAYER[layer](poly);
+}
+
+void ntt64_inverse_scalar(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        bit_reverse_copy(poly);
+        runtime_inverse_bitrev(poly, runtime_tables(layer));
+        return;
+    }
+    INVERSE_BY_LAYER[layer](poly);
+}
+
 void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
                                  const uint32_t a[NTT_N],
                                  const uint32_t b[NTT_N],
                                  int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        runtime_pointwise_mul(result, a, b, runtime_tables(layer));
+        return;
+    }
+    POINTWISE_BY_LAYER[layer](result, a, b);
+}
+
+void ntt64_forward_bitrev(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    if (layer >= NTT_NUM_LAYERS) {
+        runtime_forward_bitrev(poly, runtime_tables(layer));
+        return;
+    }
+    FORWARD_BITREV_BY_LAYER[layer](poly);
+}
+
+void ntt64_inverse_bitrev(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    if (layer >= NTT_NUM_LAYERS) {
+        runtime_inverse_bitrev(poly, runtime_tables(layer));
+        return;
+    }
+    INVERSE_BITREV_BY_LAYER[layer](poly);
+}
+
+// ============================================================================
+// BATCHED TRANSFORMS (interleaved layout, scalar implementation)
+// ============================================================================
+
+void ntt64_interleave(uint32_t *soa, const uint32_t *polys, size_t count) {
+    for (size_t p = 0; p < count; p++) {
+        for (uint32_t i = 0; i < NTT_N; i++) {
+            soa[i * count + p] = polys[p * NTT_N + i];
+        }
+    }
+}
+
+void ntt64_deinterleave(uint32_t *polys, const uint32_t *soa, size_t count) {
+    for (size_t p = 0; p < count; p++) {
+        for (uint32_t i = 0; i < NTT_N; i++) {
+            polys[p * NTT_N + i] = soa[i * count + p];
+        }
+    }
+}
+
+/**
+ * Forward NTT of one polynomial whose coefficients are `stride` words apart
+ * Used for whole batches here and for the tails of the SIMD batch kernels.
+ */
+void ntt64_forward_strided_scalar(uint32_t *data, size_t stride, int layer) {
+    uint32_t poly[NTT_N];
+    for (uint32_t i = 0; i < NTT_N; i++) {
+        poly[i] = data[i * stride];
+    }
+    ntt64_forward_scalar(poly, layer);
     for (uint32_t i = 0; i < NTT_N; i++) {
-        result[i] = ct_mul_mod(a[i], b[i], layer);
+        data[i * stride] = poly[i];
+    }
+}
+
+void ntt64_inverse_strided_scalar(uint32_t *data, size_t stride, int layer) {
+    uint32_t poly[NTT_N];
+    for (uint32_t i = 0; i < NTT_N; i++) {
+        poly[i] = data[i * stride];
+    }
+    ntt64_inverse_scalar(poly, layer);
+    for (uint32_t i = 0; i < NTT_N; i++) {
+        data[i * stride] = poly[i];
+    }
+}
+
+void ntt64_forward_batch_scalar(uint32_t *soa, size_t count, int layer) {
+    for (size_t p = 0; p < count; p++) {
+        ntt64_forward_strided_scalar(soa + p, count, layer);
+    }
+}
+
+void ntt64_inverse_batch_scalar(uint32_t *soa, size_t count, int layer) {
+    for (size_t p = 0; p < count; p++) {
+        ntt64_inverse_strided_scalar(soa + p, count, layer);
+    }
+}
+
+// ============================================================================
+// ALL-LAYERS TRANSFORMS (scalar implementation)
+// ============================================================================
+
+void ntt64_forward_all_layers_scalar(const uint32_t in[NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        memcpy(out[layer], in, NTT_N * sizeof(uint32_t));
+        ntt64_forward_scalar(out[layer], layer);
+    }
+}
+
+void ntt64_inverse_all_layers_scalar(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        memmove(out[layer], in[layer], NTT_N * sizeof(uint32_t));
+        ntt64_inverse_scalar(out[layer], layer);
+    }
+}
+
+// ============================================================================
+// FUSED POINTWISE KERNELS (scalar implementation)
+// ============================================================================
+
+// Modulus and Barrett constant of any layer, built-in or registered
+static inline void fused_modulus(int layer, uint64_t *q, uint64_t *barrett) {
+    if (layer >= NTT_NUM_LAYERS) {
+        *q = runtime_tables(layer)->q;
+        *barrett = runtime_tables(layer)->barrett;
+    } else {
+        *q = Q[layer];
+        *barrett = BARRETT_CONST[layer];
+    }
+}
+
+// x mod q for any x < 2^64 (quotient estimate off by at most one)
+static inline uint32_t fused_reduce(uint64_t x, uint64_t q, uint64_t barrett) {
+    uint64_t q_approx = ((__uint128_t)x * barrett) >> 64;
+    uint64_t r = x - q_approx * q;
+    uint64_t mask = -(uint64_t)(r >= q);
+    return (uint32_t)(r - (mask & q));
+}
+
+void ntt64_pointwise_mac_scalar(uint32_t acc[NTT_N],
+                                const uint32_t a[][NTT_N],
+                                const uint32_t b[][NTT_N],
+                                size_t count, int layer) {
+    uint64_t q, barrett;
+    fused_modulus(layer, &q, &barrett);
+
+    // Products are < (q-1)^2 and the running sum starts below q
+    const uint64_t max_terms = (UINT64_MAX - q) / ((q - 1) * (q - 1));
+    uint64_t sum[NTT_N];
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        sum[j] = acc[j];
+    }
+
+    uint64_t terms = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (terms == max_terms) {
+            for (uint32_t j = 0; j < NTT_N; j++) {
+                sum[j] = fused_reduce(sum[j], q, barrett);
+            }
+            terms = 0;
+        }
+        for (uint32_t j = 0; j < NTT_N; j++) {
+            sum[j] += (uint64_t)a[i][j] * b[i][j];
+        }
+        terms++;
+    }
+
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        acc[j] = fused_reduce(sum[j], q, barrett);
+    }
+}
+
+void ntt64_pointwise_mul_chain_scalar(uint32_t result[NTT_N],
+                                      const uint32_t x[NTT_N],
+                                      const uint32_t b[][NTT_N],
+                                      size_t count, int layer) {
+    uint64_t q, barrett;
+    fused_modulus(layer, &q, &barrett);
+
+    // A reduced value times `group` operands still fits in 64 bits
+    const uint32_t bits = 64 - __builtin_clzll(q - 1);
+    const size_t group = 64 / bits - 1;
+
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        uint64_t r = x[j];
+        size_t i = 0;
+        while (i < count) {
+            size_t end = (count - i < group) ? count : i + group;
+            for (; i < end; i++) {
+                r *= b[i][j];
+            }
+            r = fused_reduce(r, q, barrett);
+        }
+        result[j] = (uint32_t)r;
+    }
+}
+
+void ntt64_pointwise_scale_add_scalar(uint32_t result[NTT_N],
+                                      const uint32_t a[NTT_N],
+                                      uint32_t s,
+                                      const uint32_t b[NTT_N],
+                                      int layer) {
+    uint64_t q, barrett;
+    fused_modulus(layer, &q, &barrett);
+    uint64_t s_red = fused_reduce(s, q, barrett);
+
+    // a + s*b < q + (q-1)^2: one reduction per coefficient
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        result[j] = fused_reduce(a[j] + s_red * b[j], q, barrett);
     }
 }
 
+// ============================================================================
+// PREPARED OPERANDS (scalar implementation)
+// ============================================================================
+
+void ntt64_prepare_operand(ntt64_prepared_t *prep, const uint32_t b[NTT_N], int layer) {
+    uint64_t q = ntt64_get_modulus(layer);
+    prep->q = (uint32_t)q;
+    prep->layer = layer;
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        prep->b[j] = b[j];
+        prep->b_shoup[j] = (uint32_t)(((uint64_t)b[j] << 32) / q);
+    }
+}
+
+void ntt64_pointwise_mul_prepared_scalar(uint32_t result[NTT_N],
+                                         const uint32_t a[NTT_N],
+                                         const ntt64_prepared_t *prep) {
+    const uint32_t q = prep->q;
+
+    if (q < (1u << 31)) {
+        // r = a*b - quot*q < 2q fits 32 bits: low halves only, vectorizable
+        for (uint32_t j = 0; j < NTT_N; j++) {
+            uint32_t quot = (uint32_t)(((uint64_t)a[j] * prep->b_shoup[j]) >> 32);
+            uint32_t r = a[j] * prep->b[j] - quot * q;
+            uint32_t mask = -(uint32_t)(r >= q);
+            result[j] = r - (mask & q);
+        }
+        return;
+    }
+
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        result[j] = shoup_mul_mod(a[j], prep->b[j], prep->b_shoup[j], q);
+    }
+}
+
+// ============================================================================
+// MODULUS SWITCHING AND CRT (scalar implementation)
+// ============================================================================
+
+// Modulus of a built-in or registered layer, 0 for any other index
+static uint32_t layer_modulus_or_zero(int layer) {
+    if (layer >= 0 && layer < NTT_NUM_LAYERS) {
+        return Q[layer];
+    }
+    const ntt64_modulus_tables_t *t = ntt64_get_tables(layer);
+    return t ? t->q : 0;
+}
+
+int ntt64_switch_prepare(ntt64_switch_t *sw, int from_layer, int to_layer) {
+    const uint32_t q = layer_modulus_or_zero(from_layer);
+    const uint32_t q_to = layer_modulus_or_zero(to_layer);
+    if (q == 0 || q_to == 0) {
+        return -1;
+    }
+    // Largest shift with floor(2^shift * q' / q) < 2^32; q' / q > 2^-32
+    uint32_t shift = 63;
+    while ((((__uint128_t)q_to << shift) / q) >> 32) {
+        shift--;
+    }
+    sw->q_from = q;
+    sw->q_to = q_to;
+    sw->ratio = (uint32_t)(((__uint128_t)q_to << shift) / q);
+    sw->shift = shift;
+    return 0;
+}
+
+int ntt64_crt_prepare(ntt64_crt_t *crt, const int layers[], size_t count) {
+    if (count == 0 || count > NTT64_CRT_MAX) {
+        return -1;
+    }
+    uint64_t modulus = 1;
+    for (size_t j = 0; j < count; j++) {
+        const uint32_t q = layer_modulus_or_zero(layers[j]);
+        if (q == 0 || modulus > UINT64_MAX / q) {
+            return -1;
+        }
+        for (size_t i = 0; i < j; i++) {
+            if (crt->q[i] == q) {
+                return -1;
+            }
+        }
+        modulus *= q;
+        crt->q[j] = q;
+    }
+    crt->count = count;
+    crt->modulus = modulus;
+    for (size_t j = 0; j < count; j++) {
+        const uint32_t q = crt->q[j];
+        uint32_t qinv = q;
+        for (int k = 0; k < 4; k++) {
+            qinv *= 2 - q * qinv;
+        }
+        crt->qinv[j] = qinv;
+        crt->r1[j] = (uint32_t)(((uint64_t)1 << 32) % q);
+        for (size_t i = 0; i < j; i++) {
+            const uint32_t inv = table_pow_mod(crt->q[i] % q, q - 2, q);
+            crt->inv[j][i] = (uint32_t)(((uint64_t)inv << 32) % q);
+        }
+    }
+    return 0;
+}
+
+// a * b * 2^(-32) mod q for any a < 2^32, b < q and odd q < 2^32
+static inline uint32_t crt_mont_mul(uint32_t a, uint32_t b, uint32_t q, uint32_t qinv) {
+    const uint64_t t = (uint64_t)a * b;
+    const uint32_t m = (uint32_t)t * qinv;
+    const uint32_t t_hi = (uint32_t)(t >> 32);
+    const uint32_t mq_hi = (uint32_t)(((uint64_t)m * q) >> 32);
+    return t_hi - mq_hi + (q & -(uint32_t)(t_hi < mq_hi));
+}
+
+void ntt64_mod_switch_scalar(uint32_t *coeffs, size_t n, const ntt64_switch_t *sw) {
+    const uint64_t q = sw->q_from, q_to = sw->q_to, half = (q - 1) / 2;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t x = coeffs[i];
+        uint64_t est = (x * sw->ratio) >> sw->shift;
+        uint64_t r = x * q_to + half - est * q;
+        for (int k = 0; k < 3; k++) {
+            const uint64_t ge = -(uint64_t)(r >= q);
+            r -= ge & q;
+            est -= ge;
+        }
+        est -= -(uint64_t)(est >= q_to) & q_to;
+        coeffs[i] = (uint32_t)est;
+    }
+}
+
+void ntt64_crt_combine_scalar(uint64_t *out, const uint32_t *const residues[], size_t n,
+                              const ntt64_crt_t *crt) {
+    const size_t k = crt->count;
+    for (size_t c = 0; c < n; c++) {
+        uint32_t v[NTT64_CRT_MAX];
+        for (size_t j = 0; j < k; j++) {
+            const uint32_t q = crt->q[j], qinv = crt->qinv[j];
+            uint32_t u = residues[j][c];
+            for (size_t i = 0; i < j; i++) {
+                u = runtime_sub_mod(u, crt_mont_mul(v[i], crt->r1[j], q, qinv), q);
+                u = crt_mont_mul(u, crt->inv[j][i], q, qinv);
+            }
+            v[j] = u;
+        }
+        uint64_t x = v[k - 1];
+        for (size_t j = k - 1; j-- > 0;) {
+            x = x * crt->q[j] + v[j];
+        }
+        out[c] = x;
+    }
+}
+
+// ============================================================================
+// 16-BIT KERNELS (scalar implementation)
+// ============================================================================
+//
+// The scalar path widens to the 32-bit kernels; the 16-bit storage only pays
+// off in the SIMD back ends.
+
+int ntt64_layer_fits16(int layer) {
+    if (layer < 0 || layer >= NTT_MAX_LAYERS) {
+        return 0;
+    }
+    uint32_t q = ntt64_get_modulus(layer);
+    return q != 0 && q < NTT16_MAX_MODULUS;
+}
+
+void ntt64_pack16(uint16_t out[NTT_N], const uint32_t in[NTT_N]) {
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        out[j] = (uint16_t)in[j];
+    }
+}
+
+void ntt64_unpack16(uint32_t out[NTT_N], const uint16_t in[NTT_N]) {
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        out[j] = in[j];
+    }
+}
+
+int ntt64_forward_bitrev16_scalar(uint16_t poly[NTT_N], int layer) {
+    if (!ntt64_layer_fits16(layer)) {
+        return -1;
+    }
+    uint32_t wide[NTT_N];
+    ntt64_unpack16(wide, poly);
+    ntt64_forward_bitrev(wide, layer);
+    ntt64_pack16(poly, wide);
+    return 0;
+}
+
+int ntt64_inverse_bitrev16_scalar(uint16_t poly[NTT_N], int layer) {
+    if (!ntt64_layer_fits16(layer)) {
+        return -1;
+    }
+    uint32_t wide[NTT_N];
+    ntt64_unpack16(wide, poly);
+    ntt64_inverse_bitrev(wide, layer);
+    ntt64_pack16(poly, wide);
+    return 0;
+}
+
+int ntt64_pointwise_mul16_scalar(uint16_t result[NTT_N],
+                                 const uint16_t a[NTT_N],
+                                 const uint16_t b[NTT_N],
+                                 int layer) {
+    if (!ntt64_layer_fits16(layer)) {
+        return -1;
+    }
+    for (uint32_t j = 0; j < NTT_N; j++) {
+        result[j] = (uint16_t)ntt64_mul_mod(a[j], b[j], layer);
+    }
+    return 0;
+}
+
 // ============================================================================
 // PUBLIC API (backward compatibility wrappers)
 // ============================================================================
 
-// These are simple wrappers that call the scalar implementation
-// In a separate dispatch file, these will be replaced with runtime dispatch
+// Scalar definitions for programs that link ntt64.c alone. They are weak:
+// ntt64_dispatch.c defines the same entry points with runtime dispatch, and
+// those win wherever it is linked in.
 
+__attribute__((weak))
 void ntt64_forward(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
     ntt64_forward_scalar(poly, layer);
 }
 
+__attribute__((weak))
 void ntt64_inverse(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
     ntt64_inverse_scalar(poly, layer);
 }
 
+__attribute__((weak))
 void ntt64_pointwise_mul(uint32_t result[NTT_N],
                          const uint32_t a[NTT_N],
                          const uint32_t b[NTT_N],
                          int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
     ntt64_pointwise_mul_scalar(result, a, b, layer);
 }
 
@@ -420,6 +1376,9 @@ void ntt64_pointwise_mul(uint32_t result[NTT_N],
 // ============================================================================
 
 uint32_t ntt64_get_modulus(int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        return runtime_tables(layer)->q;
+    }
     return Q[layer];
 }
 
@@ -428,17 +1387,77 @@ uint32_t ntt64_get_modulus(int layer) {
 // ============================================================================
 
 uint32_t ntt64_add_mod(uint32_t a, uint32_t b, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        return runtime_add_mod(a, b, runtime_tables(layer)->q);
+    }
     return ct_add_mod(a, b, layer);
 }
 
 uint32_t ntt64_sub_mod(uint32_t a, uint32_t b, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        return runtime_sub_mod(a, b, runtime_tables(layer)->q);
+    }
     return ct_sub_mod(a, b, layer);
 }
 
 uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        return runtime_reduce((uint64_t)a * b, runtime_tables(layer));
+    }
     return ct_mul_mod(a, b, layer);
 }
 
+uint32_t ntt64_inv_mod(uint32_t a, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        // Registered modulus: same chain with the exponent read at run time
+        const ntt64_modulus_tables_t *t = runtime_tables(layer);
+        const uint32_t e = t->q - 2;
+        uint32_t x = runtime_reduce(a, t);
+        uint32_t r = x;
+        for (int bit = 30 - __builtin_clz(e); bit >= 0; bit--) {
+            r = runtime_reduce((uint64_t)r * r, t);
+            if ((e >> bit) & 1) {
+                r = runtime_reduce((uint64_t)r * x, t);
+            }
+        }
+        return r;
+    }
+    return INV_MOD_BY_LAYER[layer](a);
+}
+
+// Values per simultaneous inversion (bounds the prefix-product scratch)
+#define INV_BATCH_CHUNK 256
+
+void ntt64_inv_mod_batch(uint32_t *values, size_t count, int layer) {
+    uint32_t prefix[INV_BATCH_CHUNK];
+    uint32_t zero_mask[INV_BATCH_CHUNK];
+
+    for (size_t base = 0; base < count; base += INV_BATCH_CHUNK) {
+        size_t n = count - base < INV_BATCH_CHUNK ? count - base : INV_BATCH_CHUNK;
+        uint32_t *v = values + base;
+
+        // prefix[i] = v[0] * ... * v[i-1], with zeros replaced by 1
+        uint32_t acc = 1;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t x = ntt64_mul_mod(v[i], 1, layer);
+            uint32_t is_zero = -(uint32_t)(x == 0);
+            x |= is_zero & 1;
+            zero_mask[i] = is_zero;
+            v[i] = x;
+            prefix[i] = acc;
+            acc = ntt64_mul_mod(acc, x, layer);
+        }
+
+        // inv = (v[0] * ... * v[i])^(-1) while walking back
+        uint32_t inv = ntt64_inv_mod(acc, layer);
+        for (size_t i = n; i-- > 0;) {
+            uint32_t x = v[i];
+            v[i] = ntt64_mul_mod(inv, prefix[i], layer) & ~zero_mask[i];
+            inv = ntt64_mul_mod(inv, x, layer);
+        }
+    }
+}
+
 /**
  * Constant-time modular inverse using binary extended GCD algorithm.
  * Based on the algorithm from "Fast constant-time gcd computation and
@@ -446,8 +1465,8 @@ uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer) {
  *
  * This implementation runs in constant time to prevent timing side-channels.
  */
-uint32_t ntt64_inv_mod(uint32_t a, int layer) {
-    uint32_t q = Q[layer];
+uint32_t ntt64_inv_mod_gcd(uint32_t a, int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
 
     // Handle edge cases
     if (a == 0) return 0;
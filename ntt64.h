@@ -1,6 +1,7 @@
 #ifndef NTT64_H
 #define NTT64_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 // N = 64 for all NTT operations
@@ -62,14 +63,150 @@ void ntt64_pointwise_mul(uint32_t result[NTT_N],
                          const uint32_t b[NTT_N],
                          int layer);
 
+// ============================================================================
+// PER-MODULUS ENTRY POINTS
+// ============================================================================
+//
+// One instance of each transform is compiled per modulus, with the modulus,
+// Barrett constants and twiddles as compile-time constants. The layer-indexed
+// functions above jump to these, so calling them directly only saves the
+// table lookup. Coefficients must be reduced (in [0, q)), except for the
+// input to the forward transform.
+
+#define NTT64_DECLARE_MODULUS(q)                                    \
+    void ntt64_forward_q##q(uint32_t poly[NTT_N]);                  \
+    void ntt64_inverse_q##q(uint32_t poly[NTT_N]);                  \
+    void ntt64_pointwise_mul_q##q(uint32_t result[NTT_N],           \
+                                  const uint32_t a[NTT_N],          \
+                                  const uint32_t b[NTT_N]);         \
+    void ntt64_forward_bitrev_q##q(uint32_t poly[NTT_N]);           \
+    void ntt64_inverse_bitrev_q##q(uint32_t poly[NTT_N]);           \
+    uint32_t ntt64_inv_mod_q##q(uint32_t a);
+
+NTT64_DECLARE_MODULUS(257)
+NTT64_DECLARE_MODULUS(3329)
+NTT64_DECLARE_MODULUS(10753)
+NTT64_DECLARE_MODULUS(43777)
+NTT64_DECLARE_MODULUS(64513)
+NTT64_DECLARE_MODULUS(686593)
+NTT64_DECLARE_MODULUS(2818573313)
+
+#undef NTT64_DECLARE_MODULUS
+
+/**
+ * q = 257 transforms with shift-based reduction
+ *
+ * Same results as ntt64_forward_q257 / ntt64_inverse_q257 and their bitrev
+ * variants. Reduction uses 2^8 ≡ -1 (x -> (x & 0xFF) - (x >> 8)) instead of
+ * Barrett, and the twiddles of the three outer stages are powers of two, so
+ * those butterflies are shifts and adds.
+ */
+void ntt64_forward_f257(uint32_t poly[NTT_N]);
+void ntt64_inverse_f257(uint32_t poly[NTT_N]);
+void ntt64_forward_bitrev_f257(uint32_t poly[NTT_N]);
+void ntt64_inverse_bitrev_f257(uint32_t poly[NTT_N]);
+
+/**
+ * Forward NTT with bit-reversed output (negacyclic, constant-time)
+ *
+ * psi is merged into the butterflies, so there is no separate psi pass or
+ * bit reversal. The result equals ntt64_forward() followed by a 6-bit
+ * bit-reversal permutation of the indices. Use it when data only sees
+ * pointwise operations in the NTT domain, together with ntt64_inverse_bitrev().
+ *
+ * @param poly      Array of N=64 coefficients (modified in-place)
+ * @param layer     Layer index (0-6) selecting the modulus
+ */
+void ntt64_forward_bitrev(uint32_t poly[NTT_N], int layer);
+
+/**
+ * Inverse of ntt64_forward_bitrev(): bit-reversed NTT domain to natural
+ * coefficient order, with N^(-1) folded into the last stage.
+ *
+ * @param poly      Array of N=64 values in bit-reversed NTT order (in-place)
+ * @param layer     Layer index (0-6) selecting the modulus
+ */
+void ntt64_inverse_bitrev(uint32_t poly[NTT_N], int layer);
+
 /**
  * Get the modulus for a given layer
  *
- * @param layer     Layer index (0-7)
+ * @param layer     Layer index (built-in or registered)
  * @return          The modulus q for that layer
  */
 uint32_t ntt64_get_modulus(int layer);
 
+// ============================================================================
+// RUNTIME MODULI
+// ============================================================================
+//
+// Besides the seven built-in layers, any prime q < 2^32 with q ≡ 1 (mod 128)
+// can be registered at startup. Registered moduli get layer indices from
+// NTT_NUM_LAYERS upwards and are accepted by every layer-indexed function in
+// this header and in ntt64_simd.h; the SIMD back ends run them on the
+// table-driven scalar kernel.
+
+// Total number of layer slots (built-in + registered)
+#define NTT_MAX_LAYERS 16
+
+/**
+ * Precomputed tables for one modulus
+ *
+ * psi is g^((q-1)/128) for the smallest generator g of Z_q^*, matching the
+ * built-in tables (see compute_new_constants.py). The zeta tables follow the
+ * merged schedule of ntt64_forward_bitrev: zetas[k] = psi^bitrev6(k).
+ * Shoup constants are floor(w * 2^32 / q), Montgomery forms w * 2^32 mod q.
+ */
+typedef struct {
+    uint32_t q;
+    uint32_t psi;                   // primitive 128th root of unity
+    uint32_t n_inv;                 // 64^(-1) mod q
+    uint32_t qinv;                  // q^(-1) mod 2^32
+    uint32_t r2;                    // 2^64 mod q
+    uint64_t barrett;               // floor(2^64 / q)
+    uint32_t twiddles_fwd[6];       // omega^(64 / 2^(stage+1)), omega = psi^2
+    uint32_t twiddles_inv[6];
+    uint32_t n_inv_shoup;
+    uint32_t zeta1_n_inv;           // psi^(-32) * 64^(-1): last inverse stage
+    uint32_t zeta1_n_inv_shoup;
+    uint32_t psi_powers[NTT_N] __attribute__((aligned(64)));
+    uint32_t psi_inv_powers[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas_inv[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas_shoup[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas_inv_shoup[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas_mont[NTT_N] __attribute__((aligned(64)));
+    uint32_t zetas_inv_mont[NTT_N] __attribute__((aligned(64)));
+} ntt64_modulus_tables_t;
+
+/**
+ * Build the tables for modulus q
+ *
+ * @param tables    Output tables
+ * @param q         Prime modulus with q ≡ 1 (mod 128)
+ * @return          0 on success, -1 if q is not a suitable prime
+ */
+int ntt64_build_tables(ntt64_modulus_tables_t *tables, uint32_t q);
+
+/**
+ * Register a modulus and return its layer index
+ *
+ * Returns the existing index if q is built in or already registered. Not
+ * thread-safe: register all moduli at startup, before the layers are used
+ * from other threads.
+ *
+ * @param q         Prime modulus with q ≡ 1 (mod 128)
+ * @return          Layer index, or -1 if q is unsuitable or all slots are used
+ */
+int ntt64_register_modulus(uint32_t q);
+
+/**
+ * Tables of a registered layer
+ *
+ * @return          Tables, or NULL for built-in and unused layer indices
+ */
+const ntt64_modulus_tables_t *ntt64_get_tables(int layer);
+
 // ============================================================================
 // FIELD ARITHMETIC OPERATIONS (Constant-time)
 // ============================================================================
@@ -109,15 +246,37 @@ uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer);
 /**
  * Constant-time modular inverse: a^(-1) mod q
  *
- * Computes the modular multiplicative inverse using binary GCD.
- * Returns 0 if inverse does not exist (i.e., gcd(a, q) != 1).
+ * Computes a^(q-2) (Fermat). For the built-in moduli the exponent is a
+ * compile-time constant, so each prime gets its own fixed square-and-multiply
+ * chain (at most 31 squarings plus one multiply per set bit of q-2).
+ * Returns 0 for a ≡ 0 (mod q).
  *
- * Time complexity: O(log^2 q) in constant time
- *
- * @param a         Value to invert (must be in range [1, q-1])
- * @param layer     Layer index (0-7) selecting the modulus
+ * @param a         Value to invert (any 32-bit value)
+ * @param layer     Layer index selecting the modulus
  * @return          a^(-1) mod q, or 0 if inverse doesn't exist
  */
 uint32_t ntt64_inv_mod(uint32_t a, int layer);
 
+/**
+ * Modular inverse by binary extended GCD (96 fixed iterations)
+ *
+ * The previous implementation of ntt64_inv_mod(), kept for comparison.
+ * Same results as ntt64_inv_mod().
+ */
+uint32_t ntt64_inv_mod_gcd(uint32_t a, int layer);
+
+/**
+ * Invert many values in place (Montgomery's simultaneous inversion)
+ *
+ * One ntt64_inv_mod() per 256 values plus 3 multiplications per value.
+ * Zeros stay zero and do not disturb the other results; which entries are
+ * zero does not affect the timing.
+ *
+ * @param values    Array of count values (any 32-bit values), replaced by
+ *                  their inverses mod q
+ * @param count     Number of values
+ * @param layer     Layer index selecting the modulus
+ */
+void ntt64_inv_mod_batch(uint32_t *values, size_t count, int layer);
+
 #endif // NTT64_H
@@ -3,6 +3,7 @@
 #include "ntt64.h"
 #include "ntt64_simd.h"
 #include <immintrin.h>
+#include <pthread.h>
 #include <string.h>
 
 // External references to shared constants and functions from ntt64.c
@@ -14,15 +15,8 @@ extern const uint32_t TWIDDLES_INV[NTT_NUM_LAYERS][6];
 extern const uint32_t PSI_POWERS[NTT_NUM_LAYERS][NTT_N];
 extern const uint32_t PSI_INV_POWERS[NTT_NUM_LAYERS][NTT_N];
 
-// External reference to scalar functions (for correctness in SIMD version)
+// External reference to scalar functions (used to build the tables below)
 uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer);
-void bit_reverse_copy(uint32_t poly[NTT_N]);
-void ntt64_forward_scalar(uint32_t poly[NTT_N], int layer);
-void ntt64_inverse_scalar(uint32_t poly[NTT_N], int layer);
-void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
-                                 const uint32_t a[NTT_N],
-                                 const uint32_t b[NTT_N],
-                                 int layer);
 
 // ============================================================================
 // AVX2 MODULAR ARITHMETIC PRIMITIVES
@@ -31,114 +25,1318 @@ void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
 /**
  * AVX2 modular addition for 8 values in parallel
  * Computes (a + b) mod q for 8 uint32_t values
+ *
+ * Uses unsigned comparisons only, so it is valid for every q < 2^32
+ * (the sum a + b may not fit in 32 bits for layer 6).
  */
-static inline __m256i avx2_add_mod(__m256i a, __m256i b, uint32_t q) {
-    __m256i q_vec = _mm256_set1_epi32(q);
-
-    // Compute sum = a + b
-    __m256i sum = _mm256_add_epi32(a, b);
-
-    // Check if sum >= q (branchless)
-    __m256i cmp = _mm256_cmpgt_epi32(sum, _mm256_sub_epi32(q_vec, _mm256_set1_epi32(1)));
+static inline __m256i avx2_add_mod(__m256i a, __m256i b, __m256i q_vec) {
+    // a + b >= q  <=>  a >= q - b
+    __m256i q_minus_b = _mm256_sub_epi32(q_vec, b);
+    __m256i t = _mm256_sub_epi32(a, q_minus_b);
 
-    // If sum >= q, subtract q
-    __m256i adjustment = _mm256_and_si256(cmp, q_vec);
-    sum = _mm256_sub_epi32(sum, adjustment);
+    // All ones where a >= q - b (no wrap needed)
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(a, q_minus_b), a);
 
-    return sum;
+    // Otherwise t wrapped below zero: add q back
+    return _mm256_add_epi32(t, _mm256_andnot_si256(ge, q_vec));
 }
 
 /**
  * AVX2 modular subtraction for 8 values in parallel
  * Computes (a - b) mod q for 8 uint32_t values
  */
-static inline __m256i avx2_sub_mod(__m256i a, __m256i b, uint32_t q) {
-    __m256i q_vec = _mm256_set1_epi32(q);
-
-    // Compute diff = a - b
+static inline __m256i avx2_sub_mod(__m256i a, __m256i b, __m256i q_vec) {
     __m256i diff = _mm256_sub_epi32(a, b);
 
-    // Check if a < b (need to add q)
-    // This is tricky with signed comparison, use unsigned by checking sign bit
-    __m256i cmp = _mm256_cmpgt_epi32(b, a);
+    // All ones where a >= b (unsigned)
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a);
 
     // If a < b, add q
-    __m256i adjustment = _mm256_and_si256(cmp, q_vec);
-    diff = _mm256_add_epi32(diff, adjustment);
+    return _mm256_add_epi32(diff, _mm256_andnot_si256(ge, q_vec));
+}
 
-    return diff;
+/**
+ * High 32 bits of the unsigned 32x32 products of 8 lanes
+ */
+static inline __m256i avx2_mulhi_epu32(__m256i a, __m256i b) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(even, odd, 0xAA);
 }
 
 /**
- * AVX2 modular multiplication using Barrett reduction
- * Computes (a * b) mod q for 8 uint32_t values
+ * AVX2 Montgomery multiplication for 8 values in parallel
+ * Computes a * b * 2^(-32) mod q, result in [0, q)
  *
- * This is the most complex operation - we need to handle 64-bit products
- * and 128-bit Barrett multiplication.
+ * Requires b < q and odd q < 2^32. The reduction takes the difference of the
+ * high halves of a*b and m*q (their low halves cancel by construction), which
+ * stays in (-q, q), so the 31/32-bit layer 6 needs no extra headroom.
  */
-static inline __m256i avx2_mul_mod(__m256i a, __m256i b, int layer) {
-    // Extract values to scalar and use the verified scalar mul_mod
-    // This ensures correctness at the cost of some performance
-    uint32_t a_arr[8], b_arr[8], result[8];
-    _mm256_storeu_si256((__m256i*)a_arr, a);
-    _mm256_storeu_si256((__m256i*)b_arr, b);
+static inline __m256i avx2_mont_mul(__m256i a, __m256i b, __m256i q_vec, __m256i qinv_vec) {
+    __m256i t_even = _mm256_mul_epu32(a, b);
+    __m256i t_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    // m = (a*b mod 2^32) * q^(-1) mod 2^32, then m*q
+    __m256i mq_even = _mm256_mul_epu32(_mm256_mul_epu32(t_even, qinv_vec), q_vec);
+    __m256i mq_odd = _mm256_mul_epu32(_mm256_mul_epu32(t_odd, qinv_vec), q_vec);
+
+    __m256i t_hi = _mm256_blend_epi32(_mm256_srli_epi64(t_even, 32), t_odd, 0xAA);
+    __m256i mq_hi = _mm256_blend_epi32(_mm256_srli_epi64(mq_even, 32), mq_odd, 0xAA);
+
+    __m256i r = _mm256_sub_epi32(t_hi, mq_hi);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(t_hi, mq_hi), t_hi);
+    return _mm256_add_epi32(r, _mm256_andnot_si256(ge, q_vec));
+}
+
+/**
+ * AVX2 Barrett multiplication for moduli below 2^16
+ * Computes (a * b) mod q for a, b < q: the product fits in 32 bits and
+ * floor(2^32 / q) gives a quotient estimate that is at most one too small.
+ */
+static inline __m256i avx2_reduce_small(__m256i x, __m256i q_vec, __m256i barrett_vec) {
+    __m256i quot = avx2_mulhi_epu32(x, barrett_vec);
+    __m256i r = _mm256_sub_epi32(x, _mm256_mullo_epi32(quot, q_vec));
+
+    // r < 2q: subtract q when it does not wrap
+    return _mm256_min_epu32(r, _mm256_sub_epi32(r, q_vec));
+}
+
+static inline __m256i avx2_mul_mod_small(__m256i a, __m256i b, __m256i q_vec, __m256i barrett_vec) {
+    return avx2_reduce_small(_mm256_mullo_epi32(a, b), q_vec, barrett_vec);
+}
+
+// Per-layer reduction constants, broadcast once per call
+typedef struct {
+    __m256i q;
+    __m256i qinv;       // q^(-1) mod 2^32
+    __m256i r2;         // 2^64 mod q
+    __m256i barrett;    // floor(2^32 / q), only meaningful when q < 2^16
+} avx2_modulus_t;
+
+// Layers whose modulus fits in 16 bits take the single-Barrett fast path
+#define AVX2_SMALL_MODULUS_LAYERS 5
+
+/**
+ * Multiply by a table constant (twiddle or psi power) in "twiddle form"
+ *
+ * For the <= 16-bit layers the tables hold plain values and one Barrett
+ * multiplication is exact; for layers 5-6 they hold w * 2^32 mod q so a
+ * single Montgomery multiplication yields a * w mod q.
+ */
+static inline __m256i avx2_mul_twiddle(__m256i a, __m256i w, const avx2_modulus_t *m, int small) {
+    if (small) {
+        return avx2_mul_mod_small(a, w, m->q, m->barrett);
+    }
+    return avx2_mont_mul(a, w, m->q, m->qinv);
+}
+
+/**
+ * General AVX2 modular multiplication: (a * b) mod q for 8 lanes
+ */
+static inline __m256i avx2_mul_mod(__m256i a, __m256i b, const avx2_modulus_t *m, int small) {
+    if (small) {
+        return avx2_mul_mod_small(a, b, m->q, m->barrett);
+    }
+    // (a*b*2^-32) * 2^64 * 2^-32 = a*b
+    return avx2_mont_mul(avx2_mont_mul(a, b, m->q, m->qinv), m->r2, m->q, m->qinv);
+}
+
+// ============================================================================
+// TWIDDLE TABLES
+// ============================================================================
+
+// Stage s uses the slice [2^s - 1, 2^(s+1) - 1) holding omega_s^0..omega_s^(2^s - 1),
+// so stages 0-2 broadcast single entries and stages 3-5 load whole vectors.
+// All table entries are stored in twiddle form (see avx2_mul_twiddle).
+#define AVX2_TWIDDLE_COUNT 63
+
+typedef struct {
+    uint32_t fwd[AVX2_TWIDDLE_COUNT];
+    uint32_t inv[AVX2_TWIDDLE_COUNT];
+    uint32_t psi[NTT_N];
+    uint32_t psi_inv_scaled[NTT_N];   // N^(-1) * psi^(-i): folds both output passes
+    uint32_t qinv;
+    uint32_t r2;
+    uint32_t barrett;
+} avx2_layer_tables_t;
+
+static avx2_layer_tables_t avx2_tables[NTT_NUM_LAYERS];
+static pthread_once_t avx2_tables_once = PTHREAD_ONCE_INIT;
 
-    // Use the scalar implementation which is known to be correct
-    for (int i = 0; i < 8; i++) {
-        result[i] = ntt64_mul_mod(a_arr[i], b_arr[i], layer);
+static uint32_t avx2_twiddle_form(uint32_t w, int layer) {
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        return w;
     }
+    return (uint32_t)(((uint64_t)w << 32) % Q[layer]);
+}
+
+static void avx2_build_tables(void) {
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        avx2_layer_tables_t *t = &avx2_tables[layer];
+        uint32_t q = Q[layer];
+
+        // Newton iteration for q^(-1) mod 2^32 (q odd; each step doubles the bits)
+        uint32_t qinv = q;
+        for (int i = 0; i < 5; i++) {
+            qinv *= 2 - q * qinv;
+        }
+        uint64_t r = ((uint64_t)1 << 32) % q;
+        t->qinv = qinv;
+        t->r2 = (uint32_t)((r * r) % q);
+        t->barrett = (uint32_t)(((uint64_t)1 << 32) / q);
+
+        for (int stage = 0; stage < 6; stage++) {
+            uint32_t base = (1u << stage) - 1;
+            uint32_t w_fwd = 1, w_inv = 1;
+
+            for (uint32_t j = 0; j < (1u << stage); j++) {
+                t->fwd[base + j] = avx2_twiddle_form(w_fwd, layer);
+                t->inv[base + j] = avx2_twiddle_form(w_inv, layer);
+                w_fwd = ntt64_mul_mod(w_fwd, TWIDDLES_FWD[layer][stage], layer);
+                w_inv = ntt64_mul_mod(w_inv, TWIDDLES_INV[layer][stage], layer);
+            }
+        }
 
-    return _mm256_loadu_si256((__m256i*)result);
+        for (int i = 0; i < NTT_N; i++) {
+            t->psi[i] = avx2_twiddle_form(PSI_POWERS[layer][i], layer);
+            t->psi_inv_scaled[i] = avx2_twiddle_form(
+                ntt64_mul_mod(N_INV[layer], PSI_INV_POWERS[layer][i], layer), layer);
+        }
+    }
+}
+
+static inline const avx2_layer_tables_t *avx2_get_tables(int layer, avx2_modulus_t *m) {
+    pthread_once(&avx2_tables_once, avx2_build_tables);
+    const avx2_layer_tables_t *t = &avx2_tables[layer];
+
+    m->q = _mm256_set1_epi32((int)Q[layer]);
+    m->qinv = _mm256_set1_epi32((int)t->qinv);
+    m->r2 = _mm256_set1_epi32((int)t->r2);
+    m->barrett = _mm256_set1_epi32((int)t->barrett);
+    return t;
 }
 
 // ============================================================================
-// AVX2 BIT-REVERSAL
+// AVX2 BUTTERFLIES AND DATA MOVEMENT
 // ============================================================================
 
 /**
- * Bit-reverse a 6-bit index (for N=64=2^6)
+ * Cooley-Tukey butterfly on 8 lanes: (a, b) -> (a + w*b, a - w*b) mod q
  */
-static inline uint32_t bit_reverse_6(uint32_t x) {
-    uint32_t result = 0;
-    result |= ((x & 0x01) << 5);
-    result |= ((x & 0x02) << 3);
-    result |= ((x & 0x04) << 1);
-    result |= ((x & 0x08) >> 1);
-    result |= ((x & 0x10) >> 3);
-    result |= ((x & 0x20) >> 5);
-    return result;
+static inline void avx2_butterfly(__m256i *a, __m256i *b, __m256i w,
+                                  const avx2_modulus_t *m, int small) {
+    __m256i t = avx2_mul_twiddle(*b, w, m, small);
+    __m256i u = *a;
+
+    *a = avx2_add_mod(u, t, m->q);
+    *b = avx2_sub_mod(u, t, m->q);
 }
 
 /**
- * AVX2-optimized bit-reversal permutation
- * Uses SIMD loads/stores for better cache performance
+ * Gentleman-Sande butterfly on 8 lanes: (a, b) -> (a + b, w*(a - b)) mod q
  */
+static inline void avx2_inv_butterfly(__m256i *a, __m256i *b, __m256i w,
+                                      const avx2_modulus_t *m, int small) {
+    __m256i u = *a;
+    __m256i v = *b;
+
+    *a = avx2_add_mod(u, v, m->q);
+    *b = avx2_mul_twiddle(avx2_sub_mod(u, v, m->q), w, m, small);
+}
+
+/**
+ * Transpose an 8x8 matrix of 32-bit values held in 8 registers
+ */
+static inline void avx2_transpose8(__m256i r[8]) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    __m256i t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    __m256i t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+    __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+    __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+    __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+    __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+// 3-bit reversal: with i = 8*row + col, rev6(i) = 8*rev3(col) + rev3(row),
+// so the 6-bit permutation becomes a register rename plus one lane permute.
+static const int REV3[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
 
 // ============================================================================
 // AVX2 NTT IMPLEMENTATION
 // ============================================================================
+//
+// The 64 coefficients live in 8 registers. Row layout: r[row] lane col holds
+// index 8*row + col. Column layout: r[col] lane row holds the same index.
+// Stages whose butterfly distance is < 8 run in column layout and stages with
+// distance >= 8 in row layout, so every butterfly is between two registers.
+//
+// The kernels are instantiated twice (small = 1 for the <= 16-bit moduli,
+// small = 0 for layers 5-6) so the reduction choice is resolved at compile time.
+
+static inline __attribute__((always_inline))
+void avx2_forward_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    avx2_modulus_t m;
+    const avx2_layer_tables_t *tab = avx2_get_tables(layer, &m);
+    const __m256i rev3_idx = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+    __m256i x[8], r[8];
+
+    // Preprocessing: multiply poly[i] by psi^i (row layout)
+    #pragma GCC unroll 8
+    for (int row = 0; row < 8; row++) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)&poly[8 * row]);
+        __m256i psi = _mm256_loadu_si256((const __m256i*)&tab->psi[8 * row]);
+        x[row] = avx2_mul_twiddle(v, psi, &m, small);
+    }
+
+    // Bit-reverse straight into column layout
+    #pragma GCC unroll 8
+    for (int col = 0; col < 8; col++) {
+        r[col] = _mm256_permutevar8x32_epi32(x[REV3[col]], rev3_idx);
+    }
+
+    // Stages 0-2: butterfly distance 1, 2, 4 columns, one twiddle per register
+    #pragma GCC unroll 8
+    for (int stage = 0; stage < 3; stage++) {
+        int h = 1 << stage;
+        #pragma GCC unroll 8
+        for (int col = 0; col < 8; col++) {
+            if (col & h) continue;
+            __m256i w = _mm256_set1_epi32((int)tab->fwd[h - 1 + (col & (h - 1))]);
+            avx2_butterfly(&r[col], &r[col + h], w, &m, small);
+        }
+    }
+
+    avx2_transpose8(r);
+
+    // Stages 3-5: butterfly distance 1, 2, 4 rows, one twiddle vector per register
+    #pragma GCC unroll 8
+    for (int stage = 3; stage < 6; stage++) {
+        int h = 1 << stage;
+        int h_rows = h >> 3;
+        #pragma GCC unroll 8
+        for (int row = 0; row < 8; row++) {
+            if (row & h_rows) continue;
+            __m256i w = _mm256_loadu_si256((const __m256i*)&tab->fwd[h - 1 + 8 * (row & (h_rows - 1))]);
+            avx2_butterfly(&r[row], &r[row + h_rows], w, &m, small);
+        }
+    }
+
+    #pragma GCC unroll 8
+
+    for (int row = 0; row < 8; row++) {
+        _mm256_storeu_si256((__m256i*)&poly[8 * row], r[row]);
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx2_inverse_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    avx2_modulus_t m;
+    const avx2_layer_tables_t *tab = avx2_get_tables(layer, &m);
+    const __m256i rev3_idx = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+    __m256i r[8], y[8];
+
+    #pragma GCC unroll 8
+
+    for (int row = 0; row < 8; row++) {
+        r[row] = _mm256_loadu_si256((const __m256i*)&poly[8 * row]);
+    }
+
+    // Stages 5-3 in row layout
+    #pragma GCC unroll 8
+    for (int stage = 5; stage >= 3; stage--) {
+        int h = 1 << stage;
+        int h_rows = h >> 3;
+        #pragma GCC unroll 8
+        for (int row = 0; row < 8; row++) {
+            if (row & h_rows) continue;
+            __m256i w = _mm256_loadu_si256((const __m256i*)&tab->inv[h - 1 + 8 * (row & (h_rows - 1))]);
+            avx2_inv_butterfly(&r[row], &r[row + h_rows], w, &m, small);
+        }
+    }
+
+    avx2_transpose8(r);
+
+    // Stages 2-0 in column layout
+    #pragma GCC unroll 8
+    for (int stage = 2; stage >= 0; stage--) {
+        int h = 1 << stage;
+        #pragma GCC unroll 8
+        for (int col = 0; col < 8; col++) {
+            if (col & h) continue;
+            __m256i w = _mm256_set1_epi32((int)tab->inv[h - 1 + (col & (h - 1))]);
+            avx2_inv_butterfly(&r[col], &r[col + h], w, &m, small);
+        }
+    }
+
+    // Bit-reverse back into row layout
+    #pragma GCC unroll 8
+    for (int row = 0; row < 8; row++) {
+        y[row] = _mm256_permutevar8x32_epi32(r[REV3[row]], rev3_idx);
+    }
+
+    // Postprocessing: N^(-1) and psi^(-i) in a single multiplication
+    #pragma GCC unroll 8
+    for (int row = 0; row < 8; row++) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)&tab->psi_inv_scaled[8 * row]);
+        _mm256_storeu_si256((__m256i*)&poly[8 * row], avx2_mul_twiddle(y[row], s, &m, small));
+    }
+}
 
 void ntt64_forward_avx2(uint32_t poly[NTT_N], int layer) {
-    // TEMPORARY: Just call scalar version for debugging
-    ntt64_forward_scalar(poly, layer);
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_scalar(poly, layer);
+        return;
+    }
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        avx2_forward_kernel(poly, layer, 1);
+    } else {
+        avx2_forward_kernel(poly, layer, 0);
+    }
 }
 
 void ntt64_inverse_avx2(uint32_t poly[NTT_N], int layer) {
-    // TEMPORARY: Just call scalar version for debugging
-    ntt64_inverse_scalar(poly, layer);
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_scalar(poly, layer);
+        return;
+    }
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        avx2_inverse_kernel(poly, layer, 1);
+    } else {
+        avx2_inverse_kernel(poly, layer, 0);
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx2_pointwise_kernel(uint32_t result[NTT_N],
+                           const uint32_t a[NTT_N],
+                           const uint32_t b[NTT_N],
+                           int layer, int small) {
+    avx2_modulus_t m;
+    avx2_get_tables(layer, &m);
+
+    for (uint32_t i = 0; i < NTT_N; i += 8) {
+        __m256i a_vec = _mm256_loadu_si256((const __m256i*)&a[i]);
+        __m256i b_vec = _mm256_loadu_si256((const __m256i*)&b[i]);
+        _mm256_storeu_si256((__m256i*)&result[i], avx2_mul_mod(a_vec, b_vec, &m, small));
+    }
 }
 
 void ntt64_pointwise_mul_avx2(uint32_t result[NTT_N],
                                const uint32_t a[NTT_N],
                                const uint32_t b[NTT_N],
                                int layer) {
-    // Vectorized pointwise multiplication
-    for (uint32_t i = 0; i < NTT_N; i += 8) {
-        __m256i a_vec = _mm256_loadu_si256((__m256i*)&a[i]);
-        __m256i b_vec = _mm256_loadu_si256((__m256i*)&b[i]);
-        __m256i result_vec = avx2_mul_mod(a_vec, b_vec, layer);
-        _mm256_storeu_si256((__m256i*)&result[i], result_vec);
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mul_scalar(result, a, b, layer);
+        return;
+    }
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        avx2_pointwise_kernel(result, a, b, layer, 1);
+    } else {
+        avx2_pointwise_kernel(result, a, b, layer, 0);
+    }
+}
+
+// ============================================================================
+// AVX2 BATCHED NTT (interleaved layout, 8 polynomials per pass)
+// ============================================================================
+//
+// Lane p of vector x[i] holds coefficient i of polynomial p, so the scalar
+// schedule runs unchanged on whole vectors: each twiddle is broadcast once
+// per butterfly column and reused across every block of the stage.
+
+static inline __attribute__((always_inline))
+void avx2_forward_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    avx2_modulus_t m;
+    const avx2_layer_tables_t *tab = avx2_get_tables(layer, &m);
+    __m256i x[NTT_N];
+    size_t p = 0;
+
+    for (; p + 8 <= count; p += 8) {
+        // psi twist fused with the bit-reversed load
+        for (int i = 0; i < NTT_N; i++) {
+            int j = 8 * REV3[i & 7] + REV3[i >> 3];
+            __m256i v = _mm256_loadu_si256((const __m256i*)&soa[(size_t)j * count + p]);
+            x[i] = avx2_mul_twiddle(v, _mm256_set1_epi32((int)tab->psi[j]), &m, small);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 0; stage < 6; stage++) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                __m256i w = _mm256_set1_epi32((int)tab->fwd[h - 1 + j]);
+                #pragma GCC unroll 32
+                for (int k = 0; k < NTT_N; k += 2 * h) {
+                    avx2_butterfly(&x[k + j], &x[k + j + h], w, &m, small);
+                }
+            }
+        }
+
+        for (int i = 0; i < NTT_N; i++) {
+            _mm256_storeu_si256((__m256i*)&soa[(size_t)i * count + p], x[i]);
+        }
+    }
+
+    for (; p < count; p++) {
+        ntt64_forward_strided_scalar(soa + p, count, layer);
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx2_inverse_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    avx2_modulus_t m;
+    const avx2_layer_tables_t *tab = avx2_get_tables(layer, &m);
+    __m256i x[NTT_N];
+    size_t p = 0;
+
+    for (; p + 8 <= count; p += 8) {
+        for (int i = 0; i < NTT_N; i++) {
+            x[i] = _mm256_loadu_si256((const __m256i*)&soa[(size_t)i * count + p]);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 5; stage >= 0; stage--) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                __m256i w = _mm256_set1_epi32((int)tab->inv[h - 1 + j]);
+                #pragma GCC unroll 32
+                for (int k = 0; k < NTT_N; k += 2 * h) {
+                    avx2_inv_butterfly(&x[k + j], &x[k + j + h], w, &m, small);
+                }
+            }
+        }
+
+        // Bit-reversed store fused with N^(-1) * psi^(-i)
+        for (int i = 0; i < NTT_N; i++) {
+            int j = 8 * REV3[i & 7] + REV3[i >> 3];
+            __m256i s = _mm256_set1_epi32((int)tab->psi_inv_scaled[i]);
+            _mm256_storeu_si256((__m256i*)&soa[(size_t)i * count + p],
+                                avx2_mul_twiddle(x[j], s, &m, small));
+        }
+    }
+
+    for (; p < count; p++) {
+        ntt64_inverse_strided_scalar(soa + p, count, layer);
+    }
+}
+
+void ntt64_forward_batch_avx2(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        avx2_forward_batch_kernel(soa, count, layer, 1);
+    } else {
+        avx2_forward_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+void ntt64_inverse_batch_avx2(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        avx2_inverse_batch_kernel(soa, count, layer, 1);
+    } else {
+        avx2_inverse_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+// ============================================================================
+// AVX2 ALL-LAYERS TRANSFORM (one modulus per lane)
+// ============================================================================
+//
+// Lane l of x[i] holds coefficient i under modulus Q[l] (lane 7 repeats
+// layer 6 and is discarded). Every lane uses Montgomery arithmetic with its
+// own q and q^(-1) (avx2_mont_mul_lanes), and the merged negacyclic schedule of ntt64.c: block k
+// is twisted by psi^brv6(k), so no psi pass is needed. The natural-order
+// result is produced by reading x in bit-reversed order while transposing
+// 8x8 blocks into the per-layer output rows.
+
+typedef struct {
+    uint32_t zetas[NTT_N][8];       // psi^brv6(k) * 2^32 mod q, per lane
+    uint32_t zetas_inv[NTT_N][8];   // psi^(-brv6(k)) * 2^32 mod q
+    uint32_t n_inv[8];              // N^(-1) * 2^32 mod q
+    uint32_t zeta1_n_inv[8];        // psi^(-brv6(1)) * N^(-1) * 2^32 mod q
+    uint32_t r1[8];                 // 2^32 mod q: Montgomery-multiplying by it reduces
+    uint32_t q[8];
+    uint32_t qinv[8];
+} avx2_all_layers_tables_t;
+
+static avx2_all_layers_tables_t avx2_all_tables;
+static pthread_once_t avx2_all_tables_once = PTHREAD_ONCE_INIT;
+
+static uint32_t avx2_bit_reverse_6(uint32_t i) {
+    return 8u * (uint32_t)REV3[i & 7] + (uint32_t)REV3[i >> 3];
+}
+
+static void avx2_build_all_layers_tables(void) {
+    avx2_all_layers_tables_t *t = &avx2_all_tables;
+
+    for (int lane = 0; lane < 8; lane++) {
+        int layer = lane < NTT_NUM_LAYERS ? lane : NTT_NUM_LAYERS - 1;
+        uint64_t q = Q[layer];
+        uint32_t qinv = (uint32_t)q;
+        for (int i = 0; i < 5; i++) {
+            qinv *= 2 - (uint32_t)q * qinv;
+        }
+        t->q[lane] = (uint32_t)q;
+        t->qinv[lane] = qinv;
+        t->r1[lane] = (uint32_t)(((uint64_t)1 << 32) % q);
+
+        for (uint32_t k = 0; k < NTT_N; k++) {
+            uint32_t e = avx2_bit_reverse_6(k);
+            t->zetas[k][lane] = (uint32_t)(((uint64_t)PSI_POWERS[layer][e] << 32) % q);
+            t->zetas_inv[k][lane] = (uint32_t)(((uint64_t)PSI_INV_POWERS[layer][e] << 32) % q);
+        }
+        uint32_t z1 = ntt64_mul_mod(PSI_INV_POWERS[layer][avx2_bit_reverse_6(1)], N_INV[layer], layer);
+        t->n_inv[lane] = (uint32_t)(((uint64_t)N_INV[layer] << 32) % q);
+        t->zeta1_n_inv[lane] = (uint32_t)(((uint64_t)z1 << 32) % q);
+    }
+}
+
+/**
+ * Montgomery multiplication with a different modulus in every lane
+ *
+ * Same reduction as avx2_mont_mul, but the odd lanes take their q and q^(-1)
+ * from the odd elements instead of relying on broadcast constants.
+ */
+static inline __m256i avx2_mont_mul_lanes(__m256i a, __m256i b, const avx2_modulus_t *m) {
+    __m256i q_odd = _mm256_srli_epi64(m->q, 32);
+    __m256i qinv_odd = _mm256_srli_epi64(m->qinv, 32);
+    __m256i t_even = _mm256_mul_epu32(a, b);
+    __m256i t_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    __m256i mq_even = _mm256_mul_epu32(_mm256_mul_epu32(t_even, m->qinv), m->q);
+    __m256i mq_odd = _mm256_mul_epu32(_mm256_mul_epu32(t_odd, qinv_odd), q_odd);
+
+    __m256i t_hi = _mm256_blend_epi32(_mm256_srli_epi64(t_even, 32), t_odd, 0xAA);
+    __m256i mq_hi = _mm256_blend_epi32(_mm256_srli_epi64(mq_even, 32), mq_odd, 0xAA);
+
+    __m256i r = _mm256_sub_epi32(t_hi, mq_hi);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(t_hi, mq_hi), t_hi);
+    return _mm256_add_epi32(r, _mm256_andnot_si256(ge, m->q));
+}
+
+static inline void avx2_butterfly_lanes(__m256i *a, __m256i *b, __m256i w, const avx2_modulus_t *m) {
+    __m256i t = avx2_mont_mul_lanes(*b, w, m);
+    __m256i u = *a;
+
+    *a = avx2_add_mod(u, t, m->q);
+    *b = avx2_sub_mod(u, t, m->q);
+}
+
+static inline void avx2_inv_butterfly_lanes(__m256i *a, __m256i *b, __m256i w, const avx2_modulus_t *m) {
+    __m256i u = *a;
+    __m256i v = *b;
+
+    *a = avx2_add_mod(u, v, m->q);
+    *b = avx2_mont_mul_lanes(avx2_sub_mod(u, v, m->q), w, m);
+}
+
+static inline const avx2_all_layers_tables_t *avx2_get_all_layers_tables(avx2_modulus_t *m) {
+    pthread_once(&avx2_all_tables_once, avx2_build_all_layers_tables);
+    const avx2_all_layers_tables_t *t = &avx2_all_tables;
+
+    m->q = _mm256_loadu_si256((const __m256i*)t->q);
+    m->qinv = _mm256_loadu_si256((const __m256i*)t->qinv);
+    m->r2 = _mm256_setzero_si256();         // unused: every constant is in Montgomery form
+    m->barrett = _mm256_setzero_si256();
+    return t;
+}
+
+void ntt64_forward_all_layers_avx2(const uint32_t in[NTT_N],
+                                   uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    avx2_modulus_t m;
+    const avx2_all_layers_tables_t *tab = avx2_get_all_layers_tables(&m);
+    __m256i x[NTT_N];
+
+    // First stage (len = 32) fused with the broadcast loads; the Montgomery
+    // products by 2^32 mod q and by zeta reduce the unreduced input per lane
+    __m256i r1 = _mm256_loadu_si256((const __m256i*)tab->r1);
+    __m256i z = _mm256_loadu_si256((const __m256i*)tab->zetas[1]);
+    for (int j = 0; j < NTT_N / 2; j++) {
+        __m256i u = avx2_mont_mul_lanes(_mm256_set1_epi32((int)in[j]), r1, &m);
+        __m256i t = avx2_mont_mul_lanes(_mm256_set1_epi32((int)in[j + 32]), z, &m);
+        x[j] = avx2_add_mod(u, t, m.q);
+        x[j + 32] = avx2_sub_mod(u, t, m.q);
+    }
+
+    int k = 2;
+    #pragma GCC unroll 5
+    for (int len = 16; len >= 1; len >>= 1) {
+        for (int start = 0; start < NTT_N; start += 2 * len) {
+            z = _mm256_loadu_si256((const __m256i*)tab->zetas[k++]);
+            #pragma GCC unroll 16
+            for (int j = start; j < start + len; j++) {
+                avx2_butterfly_lanes(&x[j], &x[j + len], z, &m);
+            }
+        }
+    }
+
+    // Natural order: output coefficient i is x[brv6(i)]
+    for (int b = 0; b < 8; b++) {
+        __m256i r[8];
+        #pragma GCC unroll 8
+        for (int c = 0; c < 8; c++) {
+            r[c] = x[avx2_bit_reverse_6((uint32_t)(8 * b + c))];
+        }
+        avx2_transpose8(r);
+        #pragma GCC unroll 7
+        for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+            _mm256_storeu_si256((__m256i*)&out[layer][8 * b], r[layer]);
+        }
+    }
+}
+
+void ntt64_inverse_all_layers_avx2(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                                   uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    avx2_modulus_t m;
+    const avx2_all_layers_tables_t *tab = avx2_get_all_layers_tables(&m);
+    __m256i x[NTT_N];
+
+    // Transpose into lanes, placing natural NTT index i at x[brv6(i)]
+    for (int b = 0; b < 8; b++) {
+        __m256i r[8];
+        #pragma GCC unroll 7
+        for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+            r[layer] = _mm256_loadu_si256((const __m256i*)&in[layer][8 * b]);
+        }
+        r[7] = _mm256_setzero_si256();
+        avx2_transpose8(r);
+        #pragma GCC unroll 8
+        for (int c = 0; c < 8; c++) {
+            x[avx2_bit_reverse_6((uint32_t)(8 * b + c))] = r[c];
+        }
+    }
+
+    #pragma GCC unroll 5
+    for (int len = 1; len < NTT_N / 2; len <<= 1) {
+        int k = NTT_N / (2 * len);
+        for (int start = 0; start < NTT_N; start += 2 * len) {
+            __m256i z = _mm256_loadu_si256((const __m256i*)tab->zetas_inv[k++]);
+            #pragma GCC unroll 16
+            for (int j = start; j < start + len; j++) {
+                avx2_inv_butterfly_lanes(&x[j], &x[j + len], z, &m);
+            }
+        }
+    }
+
+    // Last stage with N^(-1) folded in, then transpose back to rows
+    __m256i n_inv = _mm256_loadu_si256((const __m256i*)tab->n_inv);
+    __m256i z1 = _mm256_loadu_si256((const __m256i*)tab->zeta1_n_inv);
+    for (int j = 0; j < NTT_N / 2; j++) {
+        __m256i u = x[j];
+        __m256i v = x[j + 32];
+        x[j] = avx2_mont_mul_lanes(avx2_add_mod(u, v, m.q), n_inv, &m);
+        x[j + 32] = avx2_mont_mul_lanes(avx2_sub_mod(u, v, m.q), z1, &m);
+    }
+
+    for (int b = 0; b < 8; b++) {
+        __m256i r[8];
+        #pragma GCC unroll 8
+        for (int c = 0; c < 8; c++) {
+            r[c] = x[8 * b + c];
+        }
+        avx2_transpose8(r);
+        #pragma GCC unroll 7
+        for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+            _mm256_storeu_si256((__m256i*)&out[layer][8 * b], r[layer]);
+        }
+    }
+}
+
+// ============================================================================
+// AVX2 FUSED POINTWISE KERNELS
+// ============================================================================
+
+/**
+ * Montgomery reduction of four 64-bit lanes t < q * 2^32: t * 2^(-32) mod q
+ *
+ * The low halves of t and m*q cancel, so only the high halves are subtracted
+ * (as in avx2_mont_mul). The result is in the even 32-bit lanes.
+ */
+static inline __m256i avx2_redc64(__m256i t, __m256i q_vec, __m256i qinv_vec) {
+    __m256i mq = _mm256_mul_epu32(_mm256_mul_epu32(t, qinv_vec), q_vec);
+    __m256i t_hi = _mm256_srli_epi64(t, 32);
+    __m256i mq_hi = _mm256_srli_epi64(mq, 32);
+
+    __m256i r = _mm256_sub_epi32(t_hi, mq_hi);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(t_hi, mq_hi), t_hi);
+    return _mm256_add_epi32(r, _mm256_andnot_si256(ge, q_vec));
+}
+
+void ntt64_pointwise_mac_avx2(uint32_t acc[NTT_N],
+                              const uint32_t a[][NTT_N],
+                              const uint32_t b[][NTT_N],
+                              size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mac_scalar(acc, a, b, count, layer);
+        return;
+    }
+    avx2_modulus_t m;
+    avx2_get_tables(layer, &m);
+
+    // Full 64-bit products are summed per lane; REDC needs the sum < q * 2^32
+    const uint64_t q = Q[layer];
+    const size_t max_terms = (size_t)(((q << 32) - 1) / ((q - 1) * (q - 1)));
+
+    for (uint32_t j = 0; j < NTT_N; j += 8) {
+        __m256i result = _mm256_loadu_si256((const __m256i*)&acc[j]);
+        size_t i = 0;
+
+        while (i < count) {
+            size_t end = (count - i < max_terms) ? count : i + max_terms;
+            __m256i even = _mm256_setzero_si256();
+            __m256i odd = _mm256_setzero_si256();
+
+            for (; i < end; i++) {
+                __m256i va = _mm256_loadu_si256((const __m256i*)&a[i][j]);
+                __m256i vb = _mm256_loadu_si256((const __m256i*)&b[i][j]);
+                even = _mm256_add_epi64(even, _mm256_mul_epu32(va, vb));
+                odd = _mm256_add_epi64(odd, _mm256_mul_epu32(_mm256_srli_epi64(va, 32),
+                                                             _mm256_srli_epi64(vb, 32)));
+            }
+
+            // sum * 2^-32, then * 2^64 * 2^-32: sum mod q
+            __m256i r = _mm256_blend_epi32(avx2_redc64(even, m.q, m.qinv),
+                                           _mm256_slli_epi64(avx2_redc64(odd, m.q, m.qinv), 32),
+                                           0xAA);
+            r = avx2_mont_mul(r, m.r2, m.q, m.qinv);
+            result = avx2_add_mod(result, r, m.q);
+        }
+
+        _mm256_storeu_si256((__m256i*)&acc[j], result);
+    }
+}
+
+void ntt64_pointwise_mul_chain_avx2(uint32_t result[NTT_N],
+                                    const uint32_t x[NTT_N],
+                                    const uint32_t b[][NTT_N],
+                                    size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mul_chain_scalar(result, x, b, count, layer);
+        return;
+    }
+    avx2_modulus_t m;
+    avx2_get_tables(layer, &m);
+
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        for (uint32_t j = 0; j < NTT_N; j += 8) {
+            __m256i r = _mm256_loadu_si256((const __m256i*)&x[j]);
+            for (size_t i = 0; i < count; i++) {
+                __m256i vb = _mm256_loadu_si256((const __m256i*)&b[i][j]);
+                r = avx2_mul_mod_small(r, vb, m.q, m.barrett);
+            }
+            _mm256_storeu_si256((__m256i*)&result[j], r);
+        }
+        return;
+    }
+
+    // One Montgomery multiplication per operand leaves x * prod * 2^(-32 count);
+    // a final multiplication by 2^(32 (count + 1)) mod q removes the factor
+    const uint64_t q = Q[layer];
+    uint64_t fix = 1, base = ((uint64_t)1 << 32) % q;
+    for (uint64_t e = (uint64_t)count + 1; e; e >>= 1) {
+        if (e & 1) {
+            fix = (fix * base) % q;
+        }
+        base = (base * base) % q;
+    }
+    __m256i fix_vec = _mm256_set1_epi32((int)(uint32_t)fix);
+
+    for (uint32_t j = 0; j < NTT_N; j += 8) {
+        __m256i r = _mm256_loadu_si256((const __m256i*)&x[j]);
+        for (size_t i = 0; i < count; i++) {
+            __m256i vb = _mm256_loadu_si256((const __m256i*)&b[i][j]);
+            r = avx2_mont_mul(r, vb, m.q, m.qinv);
+        }
+        _mm256_storeu_si256((__m256i*)&result[j], avx2_mont_mul(r, fix_vec, m.q, m.qinv));
+    }
+}
+
+void ntt64_pointwise_scale_add_avx2(uint32_t result[NTT_N],
+                                    const uint32_t a[NTT_N],
+                                    uint32_t s,
+                                    const uint32_t b[NTT_N],
+                                    int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_scale_add_scalar(result, a, s, b, layer);
+        return;
+    }
+    avx2_modulus_t m;
+    avx2_get_tables(layer, &m);
+    const uint64_t q = Q[layer];
+
+    if (layer < AVX2_SMALL_MODULUS_LAYERS) {
+        // a + s*b < q + (q-1)^2 < 2^32: a single Barrett step
+        __m256i s_vec = _mm256_set1_epi32((int)(s % q));
+#pragma GCC unroll 8
+        for (uint32_t j = 0; j < NTT_N; j += 8) {
+            __m256i va = _mm256_loadu_si256((const __m256i*)&a[j]);
+            __m256i vb = _mm256_loadu_si256((const __m256i*)&b[j]);
+            __m256i x = _mm256_add_epi32(va, _mm256_mullo_epi32(s_vec, vb));
+            _mm256_storeu_si256((__m256i*)&result[j], avx2_reduce_small(x, m.q, m.barrett));
+        }
+        return;
+    }
+
+    // s in Montgomery form: one multiplication gives s*b mod q
+    __m256i s_vec = _mm256_set1_epi32((int)(uint32_t)((((uint64_t)s % q) << 32) % q));
+#pragma GCC unroll 8
+    for (uint32_t j = 0; j < NTT_N; j += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)&a[j]);
+        __m256i vb = _mm256_loadu_si256((const __m256i*)&b[j]);
+        __m256i t = avx2_mont_mul(vb, s_vec, m.q, m.qinv);
+        _mm256_storeu_si256((__m256i*)&result[j], avx2_add_mod(va, t, m.q));
+    }
+}
+
+// ============================================================================
+// AVX2 PREPARED OPERANDS
+// ============================================================================
+//
+// Shoup multiplication: with b' = floor(b * 2^32 / q), r = a*b - hi(a*b')*q
+// lies in [0, 2q) for any 32-bit a. Below 2^31 that fits a 32-bit lane, so
+// r needs only the low halves of both products. For wider moduli (layer 6 and
+// large registered primes) r is formed from full 64-bit products instead.
+
+static inline __m256i avx2_shoup_sub_wide(__m256i prod, __m256i quot, __m256i q_vec) {
+    // prod - quot*q in [0, 2q) as 64-bit lanes (even lanes of the arguments)
+    __m256i r = _mm256_sub_epi64(prod, _mm256_mul_epu32(quot, q_vec));
+    __m256i ge = _mm256_cmpgt_epi64(r, _mm256_sub_epi64(q_vec, _mm256_set1_epi64x(1)));
+    return _mm256_sub_epi64(r, _mm256_and_si256(ge, q_vec));
+}
+
+void ntt64_pointwise_mul_prepared_avx2(uint32_t result[NTT_N],
+                                       const uint32_t a[NTT_N],
+                                       const ntt64_prepared_t *prep) {
+    const uint32_t q = prep->q;
+
+    if (q < (1u << 31)) {
+        __m256i q_vec = _mm256_set1_epi32((int)q);
+#pragma GCC unroll 8
+        for (uint32_t j = 0; j < NTT_N; j += 8) {
+            __m256i va = _mm256_loadu_si256((const __m256i*)&a[j]);
+            __m256i vb = _mm256_load_si256((const __m256i*)&prep->b[j]);
+            __m256i vs = _mm256_load_si256((const __m256i*)&prep->b_shoup[j]);
+            __m256i quot = avx2_mulhi_epu32(va, vs);
+            __m256i r = _mm256_sub_epi32(_mm256_mullo_epi32(va, vb),
+                                         _mm256_mullo_epi32(quot, q_vec));
+            r = _mm256_min_epu32(r, _mm256_sub_epi32(r, q_vec));
+            _mm256_storeu_si256((__m256i*)&result[j], r);
+        }
+        return;
+    }
+
+    __m256i q_vec = _mm256_set1_epi64x(q);
+#pragma GCC unroll 8
+    for (uint32_t j = 0; j < NTT_N; j += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)&a[j]);
+        __m256i vb = _mm256_load_si256((const __m256i*)&prep->b[j]);
+        __m256i vs = _mm256_load_si256((const __m256i*)&prep->b_shoup[j]);
+        __m256i va_odd = _mm256_srli_epi64(va, 32);
+        __m256i vb_odd = _mm256_srli_epi64(vb, 32);
+        __m256i vs_odd = _mm256_srli_epi64(vs, 32);
+
+        __m256i quot_even = _mm256_srli_epi64(_mm256_mul_epu32(va, vs), 32);
+        __m256i quot_odd = _mm256_srli_epi64(_mm256_mul_epu32(va_odd, vs_odd), 32);
+        __m256i even = avx2_shoup_sub_wide(_mm256_mul_epu32(va, vb), quot_even, q_vec);
+        __m256i odd = avx2_shoup_sub_wide(_mm256_mul_epu32(va_odd, vb_odd), quot_odd, q_vec);
+
+        __m256i r = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        _mm256_storeu_si256((__m256i*)&result[j], r);
+    }
+}
+
+// ============================================================================
+// AVX2 MODULUS SWITCHING AND CRT
+// ============================================================================
+//
+// The switch works on 64-bit lanes, even and odd coefficients apart, with the
+// shift as a variable count. CRT digits are Montgomery products in 32-bit
+// lanes; the final Horner pass widens them to 64 bits.
+
+// Rounding switch of the coefficients in the even 32-bit lanes of x
+static inline __m256i avx2_switch_lanes(__m256i x, const ntt64_switch_t *sw, __m128i shift) {
+    const __m256i q = _mm256_set1_epi64x(sw->q_from);
+    const __m256i q_to = _mm256_set1_epi64x(sw->q_to);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i half = _mm256_set1_epi64x((sw->q_from - 1) / 2);
+
+    __m256i est = _mm256_srl_epi64(_mm256_mul_epu32(x, _mm256_set1_epi64x(sw->ratio)), shift);
+    __m256i r = _mm256_sub_epi64(_mm256_add_epi64(_mm256_mul_epu32(x, q_to), half),
+                                 _mm256_mul_epu32(est, q));
+    // r < 4q < 2^34, so the signed 64-bit compares are exact
+    for (int k = 0; k < 3; k++) {
+        __m256i ge = _mm256_cmpgt_epi64(r, _mm256_sub_epi64(q, one));
+        r = _mm256_sub_epi64(r, _mm256_and_si256(ge, q));
+        est = _mm256_sub_epi64(est, ge);
+    }
+    __m256i ge = _mm256_cmpgt_epi64(est, _mm256_sub_epi64(q_to, one));
+    return _mm256_sub_epi64(est, _mm256_and_si256(ge, q_to));
+}
+
+void ntt64_mod_switch_avx2(uint32_t *coeffs, size_t n, const ntt64_switch_t *sw) {
+    const __m128i shift = _mm_cvtsi32_si128((int)sw->shift);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&coeffs[i]);
+        __m256i even = avx2_switch_lanes(x, sw, shift);
+        __m256i odd = avx2_switch_lanes(_mm256_srli_epi64(x, 32), sw, shift);
+        __m256i r = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        _mm256_storeu_si256((__m256i*)&coeffs[i], r);
+    }
+    ntt64_mod_switch_scalar(coeffs + i, n - i, sw);
+}
+
+// x * q + v on 64-bit lanes, q and v in the even 32-bit lanes
+static inline __m256i avx2_horner_step(__m256i x, __m256i q_vec, __m256i v) {
+    __m256i lo = _mm256_mul_epu32(x, q_vec);
+    __m256i hi = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), q_vec), 32);
+    return _mm256_add_epi64(_mm256_add_epi64(lo, hi), v);
+}
+
+void ntt64_crt_combine_avx2(uint64_t *out, const uint32_t *const residues[], size_t n,
+                            const ntt64_crt_t *crt) {
+    const size_t k = crt->count;
+    __m256i q[NTT64_CRT_MAX], qinv[NTT64_CRT_MAX], r1[NTT64_CRT_MAX];
+    __m256i inv[NTT64_CRT_MAX][NTT64_CRT_MAX];
+    for (size_t j = 0; j < k; j++) {
+        q[j] = _mm256_set1_epi32((int)crt->q[j]);
+        qinv[j] = _mm256_set1_epi32((int)crt->qinv[j]);
+        r1[j] = _mm256_set1_epi32((int)crt->r1[j]);
+        for (size_t i = 0; i < j; i++) {
+            inv[j][i] = _mm256_set1_epi32((int)crt->inv[j][i]);
+        }
+    }
+
+    size_t c = 0;
+    for (; c + 8 <= n; c += 8) {
+        __m256i v[NTT64_CRT_MAX];
+        for (size_t j = 0; j < k; j++) {
+            __m256i u = _mm256_loadu_si256((const __m256i*)&residues[j][c]);
+            for (size_t i = 0; i < j; i++) {
+                u = avx2_sub_mod(u, avx2_mont_mul(v[i], r1[j], q[j], qinv[j]), q[j]);
+                u = avx2_mont_mul(u, inv[j][i], q[j], qinv[j]);
+            }
+            v[j] = u;
+        }
+        __m256i lo = _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v[k - 1]));
+        __m256i hi = _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v[k - 1], 1));
+        for (size_t j = k - 1; j-- > 0;) {
+            lo = avx2_horner_step(lo, q[j], _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v[j])));
+            hi = avx2_horner_step(hi, q[j],
+                                  _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v[j], 1)));
+        }
+        _mm256_storeu_si256((__m256i*)&out[c], lo);
+        _mm256_storeu_si256((__m256i*)&out[c + 4], hi);
+    }
+    if (c < n) {
+        const uint32_t *rest[NTT64_CRT_MAX];
+        for (size_t j = 0; j < k; j++) {
+            rest[j] = residues[j] + c;
+        }
+        ntt64_crt_combine_scalar(out + c, rest, n - c, crt);
+    }
+}
+
+// ============================================================================
+// AVX2 16-BIT KERNELS
+// ============================================================================
+//
+// The 64 coefficients live in 4 registers of 16 lanes: r[k] lane j holds
+// index 16k + j. Stages with butterfly distance 32 and 16 pair whole
+// registers. For distance 8, 4, 2 and 1 a pair of registers is split into the
+// lower and upper butterfly inputs (avx2_split16) and merged back afterwards;
+// the twiddle tables are stored in split order.
+//
+// Montgomery arithmetic is signed with R = 2^16 (Kyber style): for w in
+// Montgomery form and w' = w * q^(-1) mod 2^16,
+// hi(a*w) - hi(lo(a*w') * q) = a * w mod q, in (-q, q) for |a| < 2^15.
+
+// Built-in layers with q < 2^15
+#define AVX2_NTT16_LAYERS 3
+
+typedef struct {
+    int16_t fwd[6][2][16];          // [stage][register pair][lane], Montgomery form
+    int16_t fwd_qinv[6][2][16];     // fwd * q^(-1) mod 2^16
+    int16_t inv[6][2][16];
+    int16_t inv_qinv[6][2][16];
+    int16_t qinv;
+    int16_t barrett;                // floor(2^16 / q), reduces raw input
+    int16_t r2, r2_qinv;            // R^2 mod q: corrects the pointwise product
+    int16_t n_inv, n_inv_qinv;      // last inverse stage (len = 32)
+    int16_t zeta1_n_inv, zeta1_n_inv_qinv;
+} avx2_layer16_tables_t;
+
+static avx2_layer16_tables_t avx2_tables16[AVX2_NTT16_LAYERS];
+static pthread_once_t avx2_tables16_once = PTHREAD_ONCE_INIT;
+
+static inline __m256i avx2_mont16(__m256i a, __m256i w, __m256i w_qinv, __m256i q_vec) {
+    __m256i hi = _mm256_mulhi_epi16(a, w);
+    __m256i m = _mm256_mullo_epi16(a, w_qinv);
+    return _mm256_sub_epi16(hi, _mm256_mulhi_epi16(m, q_vec));
+}
+
+// (-q, q) -> [0, q)
+static inline __m256i avx2_canon16(__m256i a, __m256i q_vec) {
+    return _mm256_min_epu16(a, _mm256_add_epi16(a, q_vec));
+}
+
+static inline __m256i avx2_add_mod16(__m256i a, __m256i b, __m256i q_vec) {
+    __m256i sum = _mm256_add_epi16(a, b);
+    return _mm256_min_epu16(sum, _mm256_sub_epi16(sum, q_vec));
+}
+
+static inline __m256i avx2_sub_mod16(__m256i a, __m256i b, __m256i q_vec) {
+    __m256i diff = _mm256_sub_epi16(a, b);
+    return _mm256_min_epu16(diff, _mm256_add_epi16(diff, q_vec));
+}
+
+/**
+ * Gather the butterfly pairs at distance d (8, 4, 2 or 1 lanes) of x and y:
+ * *a gets the lower and *b the upper element of every pair. The operation is
+ * its own inverse, so the same call merges (a, b) back into (x, y).
+ */
+static inline void avx2_split16(__m256i x, __m256i y, __m256i *a, __m256i *b, int d) {
+    switch (d) {
+    case 8:
+        *a = _mm256_permute2x128_si256(x, y, 0x20);
+        *b = _mm256_permute2x128_si256(x, y, 0x31);
+        break;
+    case 4:
+        *a = _mm256_unpacklo_epi64(x, y);
+        *b = _mm256_unpackhi_epi64(x, y);
+        break;
+    case 2:
+        *a = _mm256_blend_epi32(x, _mm256_slli_epi64(y, 32), 0xAA);
+        *b = _mm256_blend_epi32(_mm256_srli_epi64(x, 32), y, 0xAA);
+        break;
+    default:
+        *a = _mm256_blend_epi16(x, _mm256_slli_epi32(y, 16), 0xAA);
+        *b = _mm256_blend_epi16(_mm256_srli_epi32(x, 16), y, 0xAA);
+        break;
+    }
+}
+
+static int16_t avx2_mont_form16(uint32_t w, uint32_t q) {
+    return (int16_t)(((uint64_t)w << 16) % q);
+}
+
+static void avx2_build_tables16(void) {
+    for (int layer = 0; layer < AVX2_NTT16_LAYERS; layer++) {
+        avx2_layer16_tables_t *t = &avx2_tables16[layer];
+        uint32_t q = Q[layer];
+
+        uint16_t qinv = (uint16_t)q;
+        for (int i = 0; i < 4; i++) {
+            qinv *= (uint16_t)(2 - q * qinv);
+        }
+        t->qinv = (int16_t)qinv;
+        t->barrett = (int16_t)(65536u / q);
+        t->r2 = (int16_t)(((uint64_t)1 << 32) % q);
+        t->r2_qinv = (int16_t)(uint16_t)((uint16_t)t->r2 * qinv);
+
+        uint32_t n_inv = N_INV[layer];
+        uint32_t zeta1 = ntt64_mul_mod(PSI_INV_POWERS[layer][avx2_bit_reverse_6(1)], n_inv, layer);
+        t->n_inv = avx2_mont_form16(n_inv, q);
+        t->n_inv_qinv = (int16_t)(uint16_t)((uint16_t)t->n_inv * qinv);
+        t->zeta1_n_inv = avx2_mont_form16(zeta1, q);
+        t->zeta1_n_inv_qinv = (int16_t)(uint16_t)((uint16_t)t->zeta1_n_inv * qinv);
+
+        // Run the split on coefficient indices to find where each one lands
+        for (int stage = 0; stage < 6; stage++) {
+            int len = 32 >> stage;
+            int hreg = len >= 16 ? len / 16 : 1;
+            for (int pair = 0; pair < 2; pair++) {
+                int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+                int16_t idx[16];
+                __m256i x = _mm256_add_epi16(_mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7,
+                                                               8, 9, 10, 11, 12, 13, 14, 15),
+                                             _mm256_set1_epi16((int16_t)(16 * xr)));
+                __m256i a = x, b;
+                if (len < 16) {
+                    avx2_split16(x, _mm256_add_epi16(x, _mm256_set1_epi16(16)), &a, &b, len);
+                }
+                _mm256_storeu_si256((__m256i*)idx, a);
+
+                for (int lane = 0; lane < 16; lane++) {
+                    uint32_t k = (1u << stage) + (uint32_t)idx[lane] / (2u * (uint32_t)len);
+                    uint32_t rev = avx2_bit_reverse_6(k);
+                    int16_t w_fwd = avx2_mont_form16(PSI_POWERS[layer][rev], q);
+                    int16_t w_inv = avx2_mont_form16(PSI_INV_POWERS[layer][rev], q);
+                    t->fwd[stage][pair][lane] = w_fwd;
+                    t->fwd_qinv[stage][pair][lane] = (int16_t)(uint16_t)((uint16_t)w_fwd * qinv);
+                    t->inv[stage][pair][lane] = w_inv;
+                    t->inv_qinv[stage][pair][lane] = (int16_t)(uint16_t)((uint16_t)w_inv * qinv);
+                }
+            }
+        }
+    }
+}
+
+static inline const avx2_layer16_tables_t *avx2_get_tables16(int layer) {
+    pthread_once(&avx2_tables16_once, avx2_build_tables16);
+    return &avx2_tables16[layer];
+}
+
+int ntt64_forward_bitrev16_avx2(uint16_t poly[NTT_N], int layer) {
+    if (layer < 0 || layer >= AVX2_NTT16_LAYERS) {
+        return ntt64_forward_bitrev16_scalar(poly, layer);
+    }
+    const avx2_layer16_tables_t *t = avx2_get_tables16(layer);
+    const __m256i q_vec = _mm256_set1_epi16((int16_t)Q[layer]);
+    const __m256i barrett = _mm256_set1_epi16(t->barrett);
+    __m256i r[4];
+
+    // Reduce the raw input: the estimated quotient is at most one too small
+    #pragma GCC unroll 4
+    for (int k = 0; k < 4; k++) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)&poly[16 * k]);
+        __m256i quot = _mm256_mulhi_epu16(v, barrett);
+        v = _mm256_sub_epi16(v, _mm256_mullo_epi16(quot, q_vec));
+        r[k] = _mm256_min_epu16(v, _mm256_sub_epi16(v, q_vec));
+    }
+
+    #pragma GCC unroll 6
+    for (int stage = 0; stage < 6; stage++) {
+        int len = 32 >> stage;
+        int hreg = len >= 16 ? len / 16 : 1;
+        #pragma GCC unroll 2
+        for (int pair = 0; pair < 2; pair++) {
+            int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+            int yr = xr + hreg;
+            __m256i w = _mm256_loadu_si256((const __m256i*)t->fwd[stage][pair]);
+            __m256i wq = _mm256_loadu_si256((const __m256i*)t->fwd_qinv[stage][pair]);
+            __m256i a = r[xr], b = r[yr];
+            if (len < 16) {
+                avx2_split16(r[xr], r[yr], &a, &b, len);
+            }
+
+            __m256i v = avx2_canon16(avx2_mont16(b, w, wq, q_vec), q_vec);
+            b = avx2_sub_mod16(a, v, q_vec);
+            a = avx2_add_mod16(a, v, q_vec);
+
+            if (len < 16) {
+                avx2_split16(a, b, &a, &b, len);
+            }
+            r[xr] = a;
+            r[yr] = b;
+        }
+    }
+
+    #pragma GCC unroll 4
+    for (int k = 0; k < 4; k++) {
+        _mm256_storeu_si256((__m256i*)&poly[16 * k], r[k]);
+    }
+    return 0;
+}
+
+int ntt64_inverse_bitrev16_avx2(uint16_t poly[NTT_N], int layer) {
+    if (layer < 0 || layer >= AVX2_NTT16_LAYERS) {
+        return ntt64_inverse_bitrev16_scalar(poly, layer);
+    }
+    const avx2_layer16_tables_t *t = avx2_get_tables16(layer);
+    const __m256i q_vec = _mm256_set1_epi16((int16_t)Q[layer]);
+    __m256i r[4];
+
+    #pragma GCC unroll 4
+    for (int k = 0; k < 4; k++) {
+        r[k] = _mm256_loadu_si256((const __m256i*)&poly[16 * k]);
+    }
+
+    #pragma GCC unroll 5
+    for (int stage = 5; stage >= 1; stage--) {
+        int len = 32 >> stage;
+        int hreg = len >= 16 ? len / 16 : 1;
+        #pragma GCC unroll 2
+        for (int pair = 0; pair < 2; pair++) {
+            int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+            int yr = xr + hreg;
+            __m256i w = _mm256_loadu_si256((const __m256i*)t->inv[stage][pair]);
+            __m256i wq = _mm256_loadu_si256((const __m256i*)t->inv_qinv[stage][pair]);
+            __m256i a = r[xr], b = r[yr];
+            if (len < 16) {
+                avx2_split16(r[xr], r[yr], &a, &b, len);
+            }
+
+            __m256i diff = avx2_sub_mod16(a, b, q_vec);
+            a = avx2_add_mod16(a, b, q_vec);
+            b = avx2_canon16(avx2_mont16(diff, w, wq, q_vec), q_vec);
+
+            if (len < 16) {
+                avx2_split16(a, b, &a, &b, len);
+            }
+            r[xr] = a;
+            r[yr] = b;
+        }
+    }
+
+    // Last stage (len = 32) with N^(-1) folded into both outputs
+    const __m256i n_inv = _mm256_set1_epi16(t->n_inv);
+    const __m256i n_inv_qinv = _mm256_set1_epi16(t->n_inv_qinv);
+    const __m256i zeta = _mm256_set1_epi16(t->zeta1_n_inv);
+    const __m256i zeta_qinv = _mm256_set1_epi16(t->zeta1_n_inv_qinv);
+    #pragma GCC unroll 2
+    for (int k = 0; k < 2; k++) {
+        __m256i sum = avx2_add_mod16(r[k], r[k + 2], q_vec);
+        __m256i diff = avx2_sub_mod16(r[k], r[k + 2], q_vec);
+        __m256i lo = avx2_canon16(avx2_mont16(sum, n_inv, n_inv_qinv, q_vec), q_vec);
+        __m256i hi = avx2_canon16(avx2_mont16(diff, zeta, zeta_qinv, q_vec), q_vec);
+        _mm256_storeu_si256((__m256i*)&poly[16 * k], lo);
+        _mm256_storeu_si256((__m256i*)&poly[16 * (k + 2)], hi);
+    }
+    return 0;
+}
+
+int ntt64_pointwise_mul16_avx2(uint16_t result[NTT_N],
+                               const uint16_t a[NTT_N],
+                               const uint16_t b[NTT_N],
+                               int layer) {
+    if (layer < 0 || layer >= AVX2_NTT16_LAYERS) {
+        return ntt64_pointwise_mul16_scalar(result, a, b, layer);
+    }
+    const avx2_layer16_tables_t *t = avx2_get_tables16(layer);
+    const __m256i q_vec = _mm256_set1_epi16((int16_t)Q[layer]);
+    const __m256i qinv = _mm256_set1_epi16(t->qinv);
+    const __m256i r2 = _mm256_set1_epi16(t->r2);
+    const __m256i r2_qinv = _mm256_set1_epi16(t->r2_qinv);
+
+    // a*b/R, then * R^2/R: two Montgomery steps, no division
+    #pragma GCC unroll 4
+    for (int k = 0; k < 4; k++) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)&a[16 * k]);
+        __m256i vb = _mm256_loadu_si256((const __m256i*)&b[16 * k]);
+        __m256i hi = _mm256_mulhi_epi16(va, vb);
+        __m256i m = _mm256_mullo_epi16(_mm256_mullo_epi16(va, vb), qinv);
+        __m256i x = _mm256_sub_epi16(hi, _mm256_mulhi_epi16(m, q_vec));
+        _mm256_storeu_si256((__m256i*)&result[16 * k],
+                            avx2_canon16(avx2_mont16(x, r2, r2_qinv, q_vec), q_vec));
     }
+    return 0;
 }
 
 #endif // __AVX2__
@@ -0,0 +1,612 @@
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+
+#include "ntt64.h"
+#include "ntt64_simd.h"
+#include <immintrin.h>
+#include <pthread.h>
+#include <string.h>
+
+// External references to shared constants and functions from ntt64.c
+extern const uint32_t Q[NTT_NUM_LAYERS];
+extern const uint32_t N_INV[NTT_NUM_LAYERS];
+extern const uint32_t TWIDDLES_FWD[NTT_NUM_LAYERS][6];
+extern const uint32_t TWIDDLES_INV[NTT_NUM_LAYERS][6];
+extern const uint32_t PSI_POWERS[NTT_NUM_LAYERS][NTT_N];
+extern const uint32_t PSI_INV_POWERS[NTT_NUM_LAYERS][NTT_N];
+
+// External reference to scalar functions (used to build the tables below)
+uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer);
+
+// Layers whose modulus fits in 16 bits take the single-Barrett fast path
+#define AVX512_SMALL_MODULUS_LAYERS 5
+
+// ============================================================================
+// AVX-512 MODULAR ARITHMETIC PRIMITIVES
+// ============================================================================
+
+/**
+ * AVX-512 modular addition for 16 values: (a + b) mod q, valid for q < 2^32
+ */
+static inline __m512i avx512_add_mod(__m512i a, __m512i b, __m512i q_vec) {
+    __m512i q_minus_b = _mm512_sub_epi32(q_vec, b);
+    __m512i t = _mm512_sub_epi32(a, q_minus_b);
+
+    // a < q - b means the true sum is below q: undo the subtraction
+    __mmask16 lt = _mm512_cmplt_epu32_mask(a, q_minus_b);
+    return _mm512_mask_add_epi32(t, lt, t, q_vec);
+}
+
+/**
+ * AVX-512 modular subtraction for 16 values: (a - b) mod q
+ */
+static inline __m512i avx512_sub_mod(__m512i a, __m512i b, __m512i q_vec) {
+    __m512i diff = _mm512_sub_epi32(a, b);
+    __mmask16 lt = _mm512_cmplt_epu32_mask(a, b);
+    return _mm512_mask_add_epi32(diff, lt, diff, q_vec);
+}
+
+/**
+ * High 32 bits of the unsigned 32x32 products of 16 lanes
+ */
+static inline __m512i avx512_mulhi_epu32(__m512i a, __m512i b) {
+    __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(a, b), 32);
+    __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+    return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+}
+
+/**
+ * AVX-512 Montgomery multiplication: a * b * 2^(-32) mod q for 16 lanes
+ * (same construction as the AVX2 kernel: exact for every q < 2^32, b < q)
+ */
+static inline __m512i avx512_mont_mul(__m512i a, __m512i b, __m512i q_vec, __m512i qinv_vec) {
+    __m512i t_even = _mm512_mul_epu32(a, b);
+    __m512i t_odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+
+    __m512i mq_even = _mm512_mul_epu32(_mm512_mul_epu32(t_even, qinv_vec), q_vec);
+    __m512i mq_odd = _mm512_mul_epu32(_mm512_mul_epu32(t_odd, qinv_vec), q_vec);
+
+    __m512i t_hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(t_even, 32), t_odd);
+    __m512i mq_hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(mq_even, 32), mq_odd);
+
+    __m512i r = _mm512_sub_epi32(t_hi, mq_hi);
+    __mmask16 lt = _mm512_cmplt_epu32_mask(t_hi, mq_hi);
+    return _mm512_mask_add_epi32(r, lt, r, q_vec);
+}
+
+/**
+ * AVX-512 Barrett multiplication for moduli below 2^16 (16 lanes)
+ */
+static inline __m512i avx512_mul_mod_small(__m512i a, __m512i b, __m512i q_vec, __m512i barrett_vec) {
+    __m512i x = _mm512_mullo_epi32(a, b);
+    __m512i quot = avx512_mulhi_epu32(x, barrett_vec);
+    __m512i r = _mm512_sub_epi32(x, _mm512_mullo_epi32(quot, q_vec));
+    return _mm512_min_epu32(r, _mm512_sub_epi32(r, q_vec));
+}
+
+// Per-layer reduction constants, broadcast once per call
+typedef struct {
+    __m512i q;
+    __m512i qinv;       // q^(-1) mod 2^32
+    __m512i r2;         // 2^64 mod q
+    __m512i barrett;    // floor(2^32 / q), only meaningful when q < 2^16
+} avx512_modulus_t;
+
+/**
+ * Multiply by a table constant stored in twiddle form
+ * (plain for the <= 16-bit layers, Montgomery form for layers 5-6)
+ */
+static inline __m512i avx512_mul_twiddle(__m512i a, __m512i w, const avx512_modulus_t *m, int small) {
+    if (small) {
+        return avx512_mul_mod_small(a, w, m->q, m->barrett);
+    }
+    return avx512_mont_mul(a, w, m->q, m->qinv);
+}
+
+/**
+ * General AVX-512 modular multiplication: (a * b) mod q for 16 lanes
+ */
+static inline __m512i avx512_mul_mod(__m512i a, __m512i b, const avx512_modulus_t *m, int small) {
+    if (small) {
+        return avx512_mul_mod_small(a, b, m->q, m->barrett);
+    }
+    return avx512_mont_mul(avx512_mont_mul(a, b, m->q, m->qinv), m->r2, m->q, m->qinv);
+}
+
+// ============================================================================
+// TABLES
+// ============================================================================
+//
+// The 64 coefficients live in 4 registers, r[row] lane col = index 16*row + col.
+// Stages 4-5 (distance 16, 32) pair whole registers. Stages 0-3 work on the
+// 32 coefficients of a register pair (r[0], r[1]) or (r[2], r[3]) rearranged
+// into a "split" layout: register A holds the 16 butterfly tops, register B the
+// matching bottoms. For stage s, lane t of A holds pair element
+// ((t >> s) << (s + 1)) | (t & (2^s - 1)) and its twiddle exponent is t mod 2^s.
+// One two-source permute per register moves between consecutive split
+// layouts, so the data never leaves the register file.
+
+typedef struct {
+    uint32_t fwd_lo[4][16];     // stages 0-3, lane t -> omega_s^(t mod 2^s)
+    uint32_t inv_lo[4][16];
+    uint32_t fwd_hi[48];        // stage 4: omega^0..15, stage 5: omega^0..31
+    uint32_t inv_hi[48];
+    uint32_t psi[NTT_N];
+    uint32_t psi_inv_scaled[NTT_N];
+    uint32_t qinv;
+    uint32_t r2;
+    uint32_t barrett;
+} avx512_layer_tables_t;
+
+// Permutation indices (shared by all layers). Entry k selects from the
+// 32-element concatenation of two registers: value < 16 -> first, else second.
+typedef struct {
+    uint32_t split[2][16];          // natural pair -> stage 0 split layout
+    uint32_t split3[2][16];         // natural pair -> stage 3 split layout
+    uint32_t next[3][2][16];        // stage s split -> stage s+1 split
+    uint32_t prev[3][2][16];        // stage s+1 split -> stage s split
+    uint32_t merge[2][16];          // stage 3 split -> natural pair
+    uint32_t unsplit[2][16];        // stage 0 split -> natural pair
+    uint32_t bitrev_idx[4][16];     // bit reversal from pairs (r0,r1)/(r2,r3)
+    uint16_t bitrev_mask[4];        // lanes taken from the (r2,r3) pair
+} avx512_perm_tables_t;
+
+static avx512_layer_tables_t avx512_tables[NTT_NUM_LAYERS];
+static avx512_perm_tables_t avx512_perm;
+static pthread_once_t avx512_tables_once = PTHREAD_ONCE_INIT;
+
+static uint32_t avx512_twiddle_form(uint32_t w, int layer) {
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        return w;
+    }
+    return (uint32_t)(((uint64_t)w << 32) % Q[layer]);
+}
+
+// Pair element held by split-layout register `half` (0 = tops) lane t at stage s
+static uint32_t split_element(int s, int half, uint32_t t) {
+    uint32_t h = 1u << s;
+    return (((t >> s) << (s + 1)) | (t & (h - 1))) + (half ? h : 0);
+}
+
+// Index (into the concatenated register pair) of element e in stage s layout
+static uint32_t split_position(int s, uint32_t e) {
+    for (int half = 0; half < 2; half++) {
+        for (uint32_t t = 0; t < 16; t++) {
+            if (split_element(s, half, t) == e) {
+                return (uint32_t)half * 16 + t;
+            }
+        }
+    }
+    return 0;
+}
+
+static uint32_t bit_reverse_6_u32(uint32_t x) {
+    uint32_t r = 0;
+    for (int i = 0; i < 6; i++) {
+        r |= ((x >> i) & 1u) << (5 - i);
+    }
+    return r;
+}
+
+static void avx512_build_tables(void) {
+    avx512_perm_tables_t *p = &avx512_perm;
+
+    for (int half = 0; half < 2; half++) {
+        for (uint32_t t = 0; t < 16; t++) {
+            p->split[half][t] = split_element(0, half, t);
+            p->split3[half][t] = split_element(3, half, t);
+            p->merge[half][t] = split_position(3, half * 16 + t);
+            p->unsplit[half][t] = split_position(0, half * 16 + t);
+            for (int s = 0; s < 3; s++) {
+                p->next[s][half][t] = split_position(s, split_element(s + 1, half, t));
+                p->prev[s][half][t] = split_position(s + 1, split_element(s, half, t));
+            }
+        }
+    }
+
+    for (int row = 0; row < 4; row++) {
+        p->bitrev_mask[row] = 0;
+        for (uint32_t col = 0; col < 16; col++) {
+            uint32_t src = bit_reverse_6_u32(16u * row + col);
+            p->bitrev_idx[row][col] = src & 31u;
+            if (src >= 32) {
+                p->bitrev_mask[row] |= (uint16_t)(1u << col);
+            }
+        }
+    }
+
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        avx512_layer_tables_t *t = &avx512_tables[layer];
+        uint32_t q = Q[layer];
+
+        uint32_t qinv = q;
+        for (int i = 0; i < 5; i++) {
+            qinv *= 2 - q * qinv;
+        }
+        uint64_t r = ((uint64_t)1 << 32) % q;
+        t->qinv = qinv;
+        t->r2 = (uint32_t)((r * r) % q);
+        t->barrett = (uint32_t)(((uint64_t)1 << 32) / q);
+
+        for (int stage = 0; stage < 6; stage++) {
+            uint32_t pow_fwd[32], pow_inv[32];
+            uint32_t w_fwd = 1, w_inv = 1;
+            uint32_t h = 1u << stage;
+
+            for (uint32_t j = 0; j < h; j++) {
+                pow_fwd[j] = avx512_twiddle_form(w_fwd, layer);
+                pow_inv[j] = avx512_twiddle_form(w_inv, layer);
+                w_fwd = ntt64_mul_mod(w_fwd, TWIDDLES_FWD[layer][stage], layer);
+                w_inv = ntt64_mul_mod(w_inv, TWIDDLES_INV[layer][stage], layer);
+            }
+
+            if (stage < 4) {
+                for (uint32_t lane = 0; lane < 16; lane++) {
+                    t->fwd_lo[stage][lane] = pow_fwd[lane & (h - 1)];
+                    t->inv_lo[stage][lane] = pow_inv[lane & (h - 1)];
+                }
+            } else {
+                uint32_t base = (stage == 4) ? 0 : 16;
+                memcpy(&t->fwd_hi[base], pow_fwd, h * sizeof(uint32_t));
+                memcpy(&t->inv_hi[base], pow_inv, h * sizeof(uint32_t));
+            }
+        }
+
+        for (int i = 0; i < NTT_N; i++) {
+            t->psi[i] = avx512_twiddle_form(PSI_POWERS[layer][i], layer);
+            t->psi_inv_scaled[i] = avx512_twiddle_form(
+                ntt64_mul_mod(N_INV[layer], PSI_INV_POWERS[layer][i], layer), layer);
+        }
+    }
+}
+
+static inline const avx512_layer_tables_t *avx512_get_tables(int layer, avx512_modulus_t *m) {
+    pthread_once(&avx512_tables_once, avx512_build_tables);
+    const avx512_layer_tables_t *t = &avx512_tables[layer];
+
+    m->q = _mm512_set1_epi32((int)Q[layer]);
+    m->qinv = _mm512_set1_epi32((int)t->qinv);
+    m->r2 = _mm512_set1_epi32((int)t->r2);
+    m->barrett = _mm512_set1_epi32((int)t->barrett);
+    return t;
+}
+
+// ============================================================================
+// AVX-512 BUTTERFLIES AND DATA MOVEMENT
+// ============================================================================
+
+static inline void avx512_butterfly(__m512i *a, __m512i *b, __m512i w,
+                                    const avx512_modulus_t *m, int small) {
+    __m512i t = avx512_mul_twiddle(*b, w, m, small);
+    __m512i u = *a;
+
+    *a = avx512_add_mod(u, t, m->q);
+    *b = avx512_sub_mod(u, t, m->q);
+}
+
+static inline void avx512_inv_butterfly(__m512i *a, __m512i *b, __m512i w,
+                                        const avx512_modulus_t *m, int small) {
+    __m512i u = *a;
+    __m512i v = *b;
+
+    *a = avx512_add_mod(u, v, m->q);
+    *b = avx512_mul_twiddle(avx512_sub_mod(u, v, m->q), w, m, small);
+}
+
+/**
+ * Apply a pair permutation: (x, y) <- (perm[0] of x:y, perm[1] of x:y)
+ */
+static inline void avx512_permute_pair(__m512i *x, __m512i *y, const uint32_t perm[2][16]) {
+    __m512i i0 = _mm512_loadu_si512((const void*)perm[0]);
+    __m512i i1 = _mm512_loadu_si512((const void*)perm[1]);
+    __m512i nx = _mm512_permutex2var_epi32(*x, i0, *y);
+    __m512i ny = _mm512_permutex2var_epi32(*x, i1, *y);
+    *x = nx;
+    *y = ny;
+}
+
+/**
+ * 6-bit bit reversal of the whole polynomial, entirely in registers
+ */
+static inline void avx512_bit_reverse(__m512i r[4]) {
+    const avx512_perm_tables_t *p = &avx512_perm;
+    __m512i out[4];
+
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        __m512i idx = _mm512_loadu_si512((const void*)p->bitrev_idx[row]);
+        __m512i lo = _mm512_permutex2var_epi32(r[0], idx, r[1]);
+        __m512i hi = _mm512_permutex2var_epi32(r[2], idx, r[3]);
+        out[row] = _mm512_mask_blend_epi32(p->bitrev_mask[row], lo, hi);
+    }
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        r[row] = out[row];
+    }
+}
+
+// ============================================================================
+// AVX-512 NTT IMPLEMENTATION
+// ============================================================================
+
+static inline __attribute__((always_inline))
+void avx512_forward_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    avx512_modulus_t m;
+    const avx512_layer_tables_t *tab = avx512_get_tables(layer, &m);
+    const avx512_perm_tables_t *p = &avx512_perm;
+    __m512i r[4];
+
+    // Preprocessing: multiply poly[i] by psi^i
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        __m512i v = _mm512_loadu_si512((const void*)&poly[16 * row]);
+        __m512i psi = _mm512_loadu_si512((const void*)&tab->psi[16 * row]);
+        r[row] = avx512_mul_twiddle(v, psi, &m, small);
+    }
+
+    avx512_bit_reverse(r);
+
+    // Stages 0-3 inside each register pair, via the split layouts
+#pragma GCC unroll 2
+    for (int pair = 0; pair < 4; pair += 2) {
+        __m512i a = r[pair], b = r[pair + 1];
+
+        avx512_permute_pair(&a, &b, p->split);
+#pragma GCC unroll 4
+        for (int stage = 0; stage < 4; stage++) {
+            __m512i w = _mm512_loadu_si512((const void*)tab->fwd_lo[stage]);
+            avx512_butterfly(&a, &b, w, &m, small);
+            if (stage < 3) {
+                avx512_permute_pair(&a, &b, p->next[stage]);
+            }
+        }
+        avx512_permute_pair(&a, &b, p->merge);
+
+        r[pair] = a;
+        r[pair + 1] = b;
+    }
+
+    // Stage 4: distance 16 (row pairs 0-1, 2-3)
+    {
+        __m512i w = _mm512_loadu_si512((const void*)&tab->fwd_hi[0]);
+        avx512_butterfly(&r[0], &r[1], w, &m, small);
+        avx512_butterfly(&r[2], &r[3], w, &m, small);
+    }
+
+    // Stage 5: distance 32 (row pairs 0-2, 1-3)
+    {
+        __m512i w0 = _mm512_loadu_si512((const void*)&tab->fwd_hi[16]);
+        __m512i w1 = _mm512_loadu_si512((const void*)&tab->fwd_hi[32]);
+        avx512_butterfly(&r[0], &r[2], w0, &m, small);
+        avx512_butterfly(&r[1], &r[3], w1, &m, small);
+    }
+
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        _mm512_storeu_si512((void*)&poly[16 * row], r[row]);
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx512_inverse_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    avx512_modulus_t m;
+    const avx512_layer_tables_t *tab = avx512_get_tables(layer, &m);
+    const avx512_perm_tables_t *p = &avx512_perm;
+    __m512i r[4];
+
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        r[row] = _mm512_loadu_si512((const void*)&poly[16 * row]);
+    }
+
+    // Stage 5: distance 32
+    {
+        __m512i w0 = _mm512_loadu_si512((const void*)&tab->inv_hi[16]);
+        __m512i w1 = _mm512_loadu_si512((const void*)&tab->inv_hi[32]);
+        avx512_inv_butterfly(&r[0], &r[2], w0, &m, small);
+        avx512_inv_butterfly(&r[1], &r[3], w1, &m, small);
+    }
+
+    // Stage 4: distance 16
+    {
+        __m512i w = _mm512_loadu_si512((const void*)&tab->inv_hi[0]);
+        avx512_inv_butterfly(&r[0], &r[1], w, &m, small);
+        avx512_inv_butterfly(&r[2], &r[3], w, &m, small);
+    }
+
+    // Stages 3-0 inside each register pair, via the split layouts
+#pragma GCC unroll 2
+    for (int pair = 0; pair < 4; pair += 2) {
+        __m512i a = r[pair], b = r[pair + 1];
+
+        avx512_permute_pair(&a, &b, p->split3);
+#pragma GCC unroll 4
+        for (int stage = 3; stage >= 0; stage--) {
+            __m512i w = _mm512_loadu_si512((const void*)tab->inv_lo[stage]);
+            avx512_inv_butterfly(&a, &b, w, &m, small);
+            if (stage > 0) {
+                avx512_permute_pair(&a, &b, p->prev[stage - 1]);
+            }
+        }
+        avx512_permute_pair(&a, &b, p->unsplit);
+
+        r[pair] = a;
+        r[pair + 1] = b;
+    }
+
+    avx512_bit_reverse(r);
+
+    // Postprocessing: N^(-1) and psi^(-i) in a single multiplication
+#pragma GCC unroll 4
+    for (int row = 0; row < 4; row++) {
+        __m512i s = _mm512_loadu_si512((const void*)&tab->psi_inv_scaled[16 * row]);
+        _mm512_storeu_si512((void*)&poly[16 * row], avx512_mul_twiddle(r[row], s, &m, small));
+    }
+}
+
+void ntt64_forward_avx512(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_scalar(poly, layer);
+        return;
+    }
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        avx512_forward_kernel(poly, layer, 1);
+    } else {
+        avx512_forward_kernel(poly, layer, 0);
+    }
+}
+
+void ntt64_inverse_avx512(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_scalar(poly, layer);
+        return;
+    }
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        avx512_inverse_kernel(poly, layer, 1);
+    } else {
+        avx512_inverse_kernel(poly, layer, 0);
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx512_pointwise_kernel(uint32_t result[NTT_N],
+                             const uint32_t a[NTT_N],
+                             const uint32_t b[NTT_N],
+                             int layer, int small) {
+    avx512_modulus_t m;
+    avx512_get_tables(layer, &m);
+
+#pragma GCC unroll 4
+    for (uint32_t i = 0; i < NTT_N; i += 16) {
+        __m512i a_vec = _mm512_loadu_si512((const void*)&a[i]);
+        __m512i b_vec = _mm512_loadu_si512((const void*)&b[i]);
+        _mm512_storeu_si512((void*)&result[i], avx512_mul_mod(a_vec, b_vec, &m, small));
+    }
+}
+
+void ntt64_pointwise_mul_avx512(uint32_t result[NTT_N],
+                                 const uint32_t a[NTT_N],
+                                 const uint32_t b[NTT_N],
+                                 int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mul_scalar(result, a, b, layer);
+        return;
+    }
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        avx512_pointwise_kernel(result, a, b, layer, 1);
+    } else {
+        avx512_pointwise_kernel(result, a, b, layer, 0);
+    }
+}
+
+// ============================================================================
+// AVX-512 BATCHED NTT (interleaved layout, 16 polynomials per pass)
+// ============================================================================
+//
+// Lane p of x[i] holds coefficient i of polynomial p. A final partial group
+// uses masked loads and stores, so any batch size stays on the vector path.
+
+static inline uint32_t avx512_stage_twiddle(const uint32_t lo[4][16], const uint32_t hi[48],
+                                            int stage, int j) {
+    if (stage < 4) {
+        return lo[stage][j];
+    }
+    return hi[(stage == 4 ? 0 : 16) + j];
+}
+
+static inline __attribute__((always_inline))
+void avx512_forward_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    avx512_modulus_t m;
+    const avx512_layer_tables_t *tab = avx512_get_tables(layer, &m);
+    __m512i x[NTT_N];
+
+    for (size_t p = 0; p < count; p += 16) {
+        __mmask16 k = (count - p >= 16) ? (__mmask16)0xFFFF
+                                         : (__mmask16)((1u << (count - p)) - 1);
+
+        // psi twist fused with the bit-reversed load
+        for (int i = 0; i < NTT_N; i++) {
+            uint32_t j = bit_reverse_6_u32((uint32_t)i);
+            __m512i v = _mm512_maskz_loadu_epi32(k, &soa[(size_t)j * count + p]);
+            x[i] = avx512_mul_twiddle(v, _mm512_set1_epi32((int)tab->psi[j]), &m, small);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 0; stage < 6; stage++) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                __m512i w = _mm512_set1_epi32((int)avx512_stage_twiddle(tab->fwd_lo, tab->fwd_hi, stage, j));
+                #pragma GCC unroll 32
+                for (int b = 0; b < NTT_N; b += 2 * h) {
+                    avx512_butterfly(&x[b + j], &x[b + j + h], w, &m, small);
+                }
+            }
+        }
+
+        for (int i = 0; i < NTT_N; i++) {
+            _mm512_mask_storeu_epi32(&soa[(size_t)i * count + p], k, x[i]);
+        }
+    }
+}
+
+static inline __attribute__((always_inline))
+void avx512_inverse_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    avx512_modulus_t m;
+    const avx512_layer_tables_t *tab = avx512_get_tables(layer, &m);
+    __m512i x[NTT_N];
+
+    for (size_t p = 0; p < count; p += 16) {
+        __mmask16 k = (count - p >= 16) ? (__mmask16)0xFFFF
+                                         : (__mmask16)((1u << (count - p)) - 1);
+
+        for (int i = 0; i < NTT_N; i++) {
+            x[i] = _mm512_maskz_loadu_epi32(k, &soa[(size_t)i * count + p]);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 5; stage >= 0; stage--) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                __m512i w = _mm512_set1_epi32((int)avx512_stage_twiddle(tab->inv_lo, tab->inv_hi, stage, j));
+                #pragma GCC unroll 32
+                for (int b = 0; b < NTT_N; b += 2 * h) {
+                    avx512_inv_butterfly(&x[b + j], &x[b + j + h], w, &m, small);
+                }
+            }
+        }
+
+        // Bit-reversed store fused with N^(-1) * psi^(-i)
+        for (int i = 0; i < NTT_N; i++) {
+            __m512i s = _mm512_set1_epi32((int)tab->psi_inv_scaled[i]);
+            __m512i y = avx512_mul_twiddle(x[bit_reverse_6_u32((uint32_t)i)], s, &m, small);
+            _mm512_mask_storeu_epi32(&soa[(size_t)i * count + p], k, y);
+        }
+    }
+}
+
+void ntt64_forward_batch_avx512(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        avx512_forward_batch_kernel(soa, count, layer, 1);
+    } else {
+        avx512_forward_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+void ntt64_inverse_batch_avx512(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < AVX512_SMALL_MODULUS_LAYERS) {
+        avx512_inverse_batch_kernel(soa, count, layer, 1);
+    } else {
+        avx512_inverse_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+#endif // __AVX512F__ && __AVX512BW__
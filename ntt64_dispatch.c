@@ -1,15 +1,40 @@
 #include "ntt64.h"
 #include "ntt64_simd.h"
+#include "dntl_stats.h"
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 // Global function pointers (initialized to scalar by default)
 ntt64_forward_fn ntt64_forward_ptr = ntt64_forward_scalar;
 ntt64_inverse_fn ntt64_inverse_ptr = ntt64_inverse_scalar;
 ntt64_pointwise_mul_fn ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_scalar;
+ntt64_batch_fn ntt64_forward_batch_ptr = ntt64_forward_batch_scalar;
+ntt64_batch_fn ntt64_inverse_batch_ptr = ntt64_inverse_batch_scalar;
+ntt64_forward_all_fn ntt64_forward_all_layers_ptr = ntt64_forward_all_layers_scalar;
+ntt64_inverse_all_fn ntt64_inverse_all_layers_ptr = ntt64_inverse_all_layers_scalar;
+ntt64_pointwise_mac_fn ntt64_pointwise_mac_ptr = ntt64_pointwise_mac_scalar;
+ntt64_pointwise_mul_chain_fn ntt64_pointwise_mul_chain_ptr = ntt64_pointwise_mul_chain_scalar;
+ntt64_pointwise_scale_add_fn ntt64_pointwise_scale_add_ptr = ntt64_pointwise_scale_add_scalar;
+ntt64_pointwise_mul_prepared_fn ntt64_pointwise_mul_prepared_ptr = ntt64_pointwise_mul_prepared_scalar;
+ntt64_ntt16_fn ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_scalar;
+ntt64_ntt16_fn ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_scalar;
+ntt64_pointwise_mul16_fn ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_scalar;
+ntt64_mod_switch_fn ntt64_mod_switch_ptr = ntt64_mod_switch_scalar;
+ntt64_crt_combine_fn ntt64_crt_combine_ptr = ntt64_crt_combine_scalar;
 
 // Global implementation name
 static const char* implementation_name = "scalar";
 
+// Set while ntt64_autotune()'s per-layer choice is installed
+static int tuned_active = 0;
+
+// Points ntt64_forward(), ntt64_inverse() and ntt64_pointwise_mul() back at
+// ntt64_init()'s kernels after ntt64_autotune()
+static void reset_default_entries(void);
+
 // ============================================================================
 // CPU FEATURE DETECTION
 // ============================================================================
@@ -19,15 +44,45 @@ static const char* implementation_name = "scalar";
 // x86/x86-64 CPU feature detection
 #include <cpuid.h>
 
-int ntt64_detect_cpu_features(void) {
+// XCR0 bits that must be enabled by the OS before YMM/ZMM state can be used
+#define XCR0_AVX_STATE     0x06u   // SSE + AVX
+#define XCR0_AVX512_STATE  0xE6u   // SSE + AVX + opmask + ZMM_Hi256 + Hi16_ZMM
+
+static unsigned int read_xcr0(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 27))) {
+        return 0;  // no OSXSAVE
+    }
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    (void)hi;
+    return lo;
+}
+
+static int detect_cpu_features(void) {
     int features = NTT_CPU_SCALAR;
 
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+    unsigned int xcr0 = read_xcr0();
+    (void)xcr0;
+
     #ifdef __AVX2__
     // Check if AVX2 is supported at runtime
-    unsigned int eax, ebx, ecx, edx;
-    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
-        if (ebx & (1 << 5)) {  // AVX2 bit
-            features |= NTT_CPU_AVX2;
+    if ((ebx & (1u << 5)) && (xcr0 & XCR0_AVX_STATE) == XCR0_AVX_STATE) {
+        features |= NTT_CPU_AVX2;
+    }
+    #endif
+
+    #if defined(__AVX512F__) && defined(__AVX512BW__)
+    // AVX-512F (bit 16) and AVX-512BW (bit 30), plus ZMM state enabled by the OS
+    if ((ebx & (1u << 16)) && (ebx & (1u << 30)) &&
+        (xcr0 & XCR0_AVX512_STATE) == XCR0_AVX512_STATE) {
+        features |= NTT_CPU_AVX512;
+        if (ebx & (1u << 21)) {  // AVX-512 IFMA
+            features |= NTT_CPU_AVX512IFMA;
         }
     }
     #endif
@@ -38,11 +93,38 @@ int ntt64_detect_cpu_features(void) {
 #elif defined(__ARM_NEON) || defined(__aarch64__)
 
 // ARM CPU feature detection
-int ntt64_detect_cpu_features(void) {
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD  (1UL << 1)
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE    (1UL << 22)
+#endif
+#ifndef HWCAP2_SVE2
+#define HWCAP2_SVE2  (1UL << 1)
+#endif
+
+static int detect_cpu_features(void) {
     int features = NTT_CPU_SCALAR;
 
-    #ifdef __ARM_NEON
-    // NEON is available (either always-on for AArch64 or detected)
+    #if defined(__aarch64__) && defined(__linux__)
+    // The kernel reports what the CPU and OS actually support
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    if (hwcap & HWCAP_ASIMD) {
+        features |= NTT_CPU_NEON;
+    }
+    if (hwcap & HWCAP_SVE) {
+        features |= NTT_CPU_SVE;
+        if (hwcap2 & HWCAP2_SVE2) {
+            features |= NTT_CPU_SVE2;
+        }
+    }
+    #elif defined(__ARM_NEON)
+    // NEON is available (always-on for AArch64 or enabled at compile time)
     features |= NTT_CPU_NEON;
     #endif
 
@@ -52,35 +134,107 @@ int ntt64_detect_cpu_features(void) {
 #else
 
 // Fallback for unsupported architectures
-int ntt64_detect_cpu_features(void) {
+static int detect_cpu_features(void) {
     return NTT_CPU_SCALAR;
 }
 
 #endif
 
+int ntt64_detect_cpu_features(void) {
+    return detect_cpu_features();
+}
+
 // ============================================================================
 // INITIALIZATION AND DISPATCH
 // ============================================================================
 
 void ntt64_init(void) {
     int features = ntt64_detect_cpu_features();
+    tuned_active = 0;
+    reset_default_entries();
+
+    // Priority: AVX-512 > AVX2 > SVE2 (wide vectors) > NEON > Scalar
+    #if defined(__AVX512F__) && defined(__AVX512BW__)
+    if (features & NTT_CPU_AVX512) {
+        ntt64_forward_ptr = ntt64_forward_avx512;
+        ntt64_inverse_ptr = ntt64_inverse_avx512;
+        ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_avx512;
+        ntt64_forward_batch_ptr = ntt64_forward_batch_avx512;
+        ntt64_inverse_batch_ptr = ntt64_inverse_batch_avx512;
+        #ifdef __AVX2__
+        // 7 moduli fill 8 lanes: the AVX2 kernel is the right width
+        ntt64_forward_all_layers_ptr = ntt64_forward_all_layers_avx2;
+        ntt64_inverse_all_layers_ptr = ntt64_inverse_all_layers_avx2;
+        // Fused pointwise kernels are bound by loads, not vector width
+        ntt64_pointwise_mac_ptr = ntt64_pointwise_mac_avx2;
+        ntt64_pointwise_mul_chain_ptr = ntt64_pointwise_mul_chain_avx2;
+        ntt64_pointwise_scale_add_ptr = ntt64_pointwise_scale_add_avx2;
+        ntt64_pointwise_mul_prepared_ptr = ntt64_pointwise_mul_prepared_avx2;
+        ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_avx2;
+        ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_avx2;
+        ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_avx2;
+        ntt64_mod_switch_ptr = ntt64_mod_switch_avx2;
+        ntt64_crt_combine_ptr = ntt64_crt_combine_avx2;
+        #endif
+        implementation_name = (features & NTT_CPU_AVX512IFMA) ? "AVX-512 (IFMA)" : "AVX-512";
+        return;
+    }
+    #endif
 
-    // Priority: AVX2 > NEON > Scalar
     #ifdef __AVX2__
     if (features & NTT_CPU_AVX2) {
         ntt64_forward_ptr = ntt64_forward_avx2;
         ntt64_inverse_ptr = ntt64_inverse_avx2;
         ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_avx2;
+        ntt64_forward_batch_ptr = ntt64_forward_batch_avx2;
+        ntt64_inverse_batch_ptr = ntt64_inverse_batch_avx2;
+        ntt64_forward_all_layers_ptr = ntt64_forward_all_layers_avx2;
+        ntt64_inverse_all_layers_ptr = ntt64_inverse_all_layers_avx2;
+        ntt64_pointwise_mac_ptr = ntt64_pointwise_mac_avx2;
+        ntt64_pointwise_mul_chain_ptr = ntt64_pointwise_mul_chain_avx2;
+        ntt64_pointwise_scale_add_ptr = ntt64_pointwise_scale_add_avx2;
+        ntt64_pointwise_mul_prepared_ptr = ntt64_pointwise_mul_prepared_avx2;
+        ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_avx2;
+        ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_avx2;
+        ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_avx2;
+        ntt64_mod_switch_ptr = ntt64_mod_switch_avx2;
+        ntt64_crt_combine_ptr = ntt64_crt_combine_avx2;
         implementation_name = "AVX2";
         return;
     }
     #endif
 
+    #if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+    // At 128-bit VL the fixed-layout NEON kernels are faster than the
+    // predicated SVE2 stage loops, so only take SVE2 on wider vectors
+    if ((features & NTT_CPU_SVE2) && ntt64_sve_vector_lanes() > 4) {
+        ntt64_forward_ptr = ntt64_forward_sve2;
+        ntt64_inverse_ptr = ntt64_inverse_sve2;
+        ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_sve2;
+        ntt64_forward_batch_ptr = ntt64_forward_batch_neon;
+        ntt64_inverse_batch_ptr = ntt64_inverse_batch_neon;
+        #if defined(__aarch64__)
+        ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_neon;
+        ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_neon;
+        ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_neon;
+        #endif
+        implementation_name = "SVE2";
+        return;
+    }
+    #endif
+
     #ifdef __ARM_NEON
     if (features & NTT_CPU_NEON) {
         ntt64_forward_ptr = ntt64_forward_neon;
         ntt64_inverse_ptr = ntt64_inverse_neon;
         ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_neon;
+        ntt64_forward_batch_ptr = ntt64_forward_batch_neon;
+        ntt64_inverse_batch_ptr = ntt64_inverse_batch_neon;
+        #if defined(__aarch64__)
+        ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_neon;
+        ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_neon;
+        ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_neon;
+        #endif
         implementation_name = "NEON";
         return;
     }
@@ -90,9 +244,548 @@ void ntt64_init(void) {
     ntt64_forward_ptr = ntt64_forward_scalar;
     ntt64_inverse_ptr = ntt64_inverse_scalar;
     ntt64_pointwise_mul_ptr = ntt64_pointwise_mul_scalar;
+    ntt64_forward_batch_ptr = ntt64_forward_batch_scalar;
+    ntt64_inverse_batch_ptr = ntt64_inverse_batch_scalar;
+    ntt64_forward_all_layers_ptr = ntt64_forward_all_layers_scalar;
+    ntt64_inverse_all_layers_ptr = ntt64_inverse_all_layers_scalar;
+    ntt64_pointwise_mac_ptr = ntt64_pointwise_mac_scalar;
+    ntt64_pointwise_mul_chain_ptr = ntt64_pointwise_mul_chain_scalar;
+    ntt64_pointwise_scale_add_ptr = ntt64_pointwise_scale_add_scalar;
+    ntt64_pointwise_mul_prepared_ptr = ntt64_pointwise_mul_prepared_scalar;
+    ntt64_forward_bitrev16_ptr = ntt64_forward_bitrev16_scalar;
+    ntt64_inverse_bitrev16_ptr = ntt64_inverse_bitrev16_scalar;
+    ntt64_pointwise_mul16_ptr = ntt64_pointwise_mul16_scalar;
+    ntt64_mod_switch_ptr = ntt64_mod_switch_scalar;
+    ntt64_crt_combine_ptr = ntt64_crt_combine_scalar;
     implementation_name = "scalar";
 }
 
+// ============================================================================
+// DEFAULT ENTRY POINTS
+// ============================================================================
+//
+// ntt64_forward(), ntt64_inverse() and ntt64_pointwise_mul() take the best
+// kernel without ntt64_init(). Each is a wrapper around an atomic pointer
+// that starts at a one-time resolving stub; ntt64_autotune() and
+// ntt64_init() repoint it, so NTT64_BACKEND_ENV and a saved choice reach
+// these entry points and the reported names match what runs.
+//
+// NTT64_IFUNC makes them GNU ifuncs on x86 with glibc instead: the dynamic
+// loader binds the symbol straight to the kernel, so a call costs what a
+// call to the kernel does, but nothing can rebind it afterwards and only
+// the *_ptr entry points follow ntt64_autotune(). DNTL_STATS builds keep
+// the wrappers, whose counters need them.
+
+#if defined(NTT64_IFUNC) && defined(__GNUC__) && defined(__ELF__) && defined(__GLIBC__) && \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(DNTL_STATS)
+#define NTT64_USE_IFUNC 1
+#endif
+
+typedef struct {
+    ntt64_forward_fn forward;
+    ntt64_inverse_fn inverse;
+    ntt64_pointwise_mul_fn pointwise_mul;
+} core_kernels_t;
+
+// The kernels ntt64_init() would pick for these features
+static core_kernels_t core_kernels(int features) {
+    (void)features;
+    #if defined(__AVX512F__) && defined(__AVX512BW__)
+    if (features & NTT_CPU_AVX512) {
+        return (core_kernels_t){ ntt64_forward_avx512, ntt64_inverse_avx512,
+                                 ntt64_pointwise_mul_avx512 };
+    }
+    #endif
+    #ifdef __AVX2__
+    if (features & NTT_CPU_AVX2) {
+        return (core_kernels_t){ ntt64_forward_avx2, ntt64_inverse_avx2,
+                                 ntt64_pointwise_mul_avx2 };
+    }
+    #endif
+    #if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+    if ((features & NTT_CPU_SVE2) && ntt64_sve_vector_lanes() > 4) {
+        return (core_kernels_t){ ntt64_forward_sve2, ntt64_inverse_sve2,
+                                 ntt64_pointwise_mul_sve2 };
+    }
+    #endif
+    #ifdef __ARM_NEON
+    if (features & NTT_CPU_NEON) {
+        return (core_kernels_t){ ntt64_forward_neon, ntt64_inverse_neon,
+                                 ntt64_pointwise_mul_neon };
+    }
+    #endif
+    return (core_kernels_t){ ntt64_forward_scalar, ntt64_inverse_scalar,
+                             ntt64_pointwise_mul_scalar };
+}
+
+#ifdef NTT64_USE_IFUNC
+
+// Resolvers run during relocation, before constructors: they may only reach
+// code that needs no relocation itself (detect_cpu_features is static)
+static ntt64_forward_fn resolve_forward(void) {
+    return core_kernels(detect_cpu_features()).forward;
+}
+
+static ntt64_inverse_fn resolve_inverse(void) {
+    return core_kernels(detect_cpu_features()).inverse;
+}
+
+static ntt64_pointwise_mul_fn resolve_pointwise_mul(void) {
+    return core_kernels(detect_cpu_features()).pointwise_mul;
+}
+
+void ntt64_forward(uint32_t poly[NTT_N], int layer)
+    __attribute__((ifunc("resolve_forward")));
+void ntt64_inverse(uint32_t poly[NTT_N], int layer)
+    __attribute__((ifunc("resolve_inverse")));
+void ntt64_pointwise_mul(uint32_t result[NTT_N], const uint32_t a[NTT_N],
+                         const uint32_t b[NTT_N], int layer)
+    __attribute__((ifunc("resolve_pointwise_mul")));
+
+static void reset_default_entries(void) {
+}
+
+#else
+
+static void forward_first(uint32_t poly[NTT_N], int layer);
+static void inverse_first(uint32_t poly[NTT_N], int layer);
+static void pointwise_mul_first(uint32_t result[NTT_N], const uint32_t a[NTT_N],
+                                const uint32_t b[NTT_N], int layer);
+
+// Racing first calls store the same kernel; relaxed order is enough for a
+// pointer to code
+static _Atomic(ntt64_forward_fn) forward_entry = forward_first;
+static _Atomic(ntt64_inverse_fn) inverse_entry = inverse_first;
+static _Atomic(ntt64_pointwise_mul_fn) pointwise_mul_entry = pointwise_mul_first;
+
+static void forward_first(uint32_t poly[NTT_N], int layer) {
+    ntt64_forward_fn fn = core_kernels(detect_cpu_features()).forward;
+    atomic_store_explicit(&forward_entry, fn, memory_order_relaxed);
+    fn(poly, layer);
+}
+
+static void inverse_first(uint32_t poly[NTT_N], int layer) {
+    ntt64_inverse_fn fn = core_kernels(detect_cpu_features()).inverse;
+    atomic_store_explicit(&inverse_entry, fn, memory_order_relaxed);
+    fn(poly, layer);
+}
+
+static void pointwise_mul_first(uint32_t result[NTT_N], const uint32_t a[NTT_N],
+                                const uint32_t b[NTT_N], int layer) {
+    ntt64_pointwise_mul_fn fn = core_kernels(detect_cpu_features()).pointwise_mul;
+    atomic_store_explicit(&pointwise_mul_entry, fn, memory_order_relaxed);
+    fn(result, a, b, layer);
+}
+
+void ntt64_forward(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    atomic_load_explicit(&forward_entry, memory_order_relaxed)(poly, layer);
+}
+
+void ntt64_inverse(uint32_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    atomic_load_explicit(&inverse_entry, memory_order_relaxed)(poly, layer);
+}
+
+void ntt64_pointwise_mul(uint32_t result[NTT_N],
+                         const uint32_t a[NTT_N],
+                         const uint32_t b[NTT_N],
+                         int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    atomic_load_explicit(&pointwise_mul_entry, memory_order_relaxed)(result, a, b, layer);
+}
+
+static void reset_default_entries(void) {
+    atomic_store_explicit(&forward_entry, forward_first, memory_order_relaxed);
+    atomic_store_explicit(&inverse_entry, inverse_first, memory_order_relaxed);
+    atomic_store_explicit(&pointwise_mul_entry, pointwise_mul_first, memory_order_relaxed);
+}
+
+#endif
+
+// ============================================================================
+// AUTOTUNING
+// ============================================================================
+
+typedef struct {
+    const char *name;       // as NTT64_BACKEND_ENV and the saved file spell it
+    const char *label;      // as reported
+    int required;           // NTT_CPU_* bits
+    core_kernels_t k;
+} backend_t;
+
+static const backend_t BACKENDS[] = {
+    { "scalar", "scalar", NTT_CPU_SCALAR,
+      { ntt64_forward_scalar, ntt64_inverse_scalar, ntt64_pointwise_mul_scalar } },
+    #ifdef __AVX2__
+    { "avx2", "AVX2", NTT_CPU_AVX2,
+      { ntt64_forward_avx2, ntt64_inverse_avx2, ntt64_pointwise_mul_avx2 } },
+    #endif
+    #if defined(__AVX512F__) && defined(__AVX512BW__)
+    { "avx512", "AVX-512", NTT_CPU_AVX512,
+      { ntt64_forward_avx512, ntt64_inverse_avx512, ntt64_pointwise_mul_avx512 } },
+    #endif
+    #ifdef __ARM_NEON
+    { "neon", "NEON", NTT_CPU_NEON,
+      { ntt64_forward_neon, ntt64_inverse_neon, ntt64_pointwise_mul_neon } },
+    #endif
+    #if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+    { "sve2", "SVE2", NTT_CPU_SVE2,
+      { ntt64_forward_sve2, ntt64_inverse_sve2, ntt64_pointwise_mul_sve2 } },
+    #endif
+};
+
+#define NUM_BACKENDS (sizeof(BACKENDS) / sizeof(BACKENDS[0]))
+
+enum { OP_FORWARD, OP_INVERSE, OP_POINTWISE, NUM_OPS };
+
+// Calls per timed round and rounds per kernel: a few microseconds each
+#define TUNE_CALLS  16
+#define TUNE_ROUNDS 3
+
+static uint8_t tuned[NTT_MAX_LAYERS][NUM_OPS];      // BACKENDS index
+static char layer_names[NTT_MAX_LAYERS][64];
+static char tuned_summary[NTT_MAX_LAYERS * 72];
+
+static void tuned_forward(uint32_t poly[NTT_N], int layer) {
+    BACKENDS[tuned[layer][OP_FORWARD]].k.forward(poly, layer);
+}
+
+static void tuned_inverse(uint32_t poly[NTT_N], int layer) {
+    BACKENDS[tuned[layer][OP_INVERSE]].k.inverse(poly, layer);
+}
+
+static void tuned_pointwise_mul(uint32_t result[NTT_N], const uint32_t a[NTT_N],
+                                const uint32_t b[NTT_N], int layer) {
+    BACKENDS[tuned[layer][OP_POINTWISE]].k.pointwise_mul(result, a, b, layer);
+}
+
+static int layer_exists(int layer) {
+    return layer >= 0 &&
+           (layer < NTT_NUM_LAYERS || (layer < NTT_MAX_LAYERS && ntt64_get_tables(layer)));
+}
+
+static int backend_available(size_t b, int features) {
+    return (BACKENDS[b].required & features) == BACKENDS[b].required;
+}
+
+static int backend_by_name(const char *name, int features) {
+    for (size_t b = 0; b < NUM_BACKENDS; b++) {
+        if (strcmp(BACKENDS[b].name, name) == 0) {
+            return backend_available(b, features) ? (int)b : -1;
+        }
+    }
+    return -1;
+}
+
+static uint64_t tune_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Fastest of TUNE_ROUNDS rounds of TUNE_CALLS calls, after one warm-up call
+static uint64_t time_kernel(const core_kernels_t *k, int op, int layer) {
+    static uint32_t a[NTT_N], b[NTT_N];
+    const uint32_t q = ntt64_get_modulus(layer);
+    for (uint32_t i = 0; i < NTT_N; i++) {
+        a[i] = (i * 2654435761u) % q;
+        b[i] = (i * 40503u + 1) % q;
+    }
+    uint64_t best = UINT64_MAX;
+    for (int round = 0; round <= TUNE_ROUNDS; round++) {
+        const uint64_t start = tune_now_ns();
+        for (int call = 0; call < (round ? TUNE_CALLS : 1); call++) {
+            if (op == OP_FORWARD) {
+                k->forward(a, layer);
+            } else if (op == OP_INVERSE) {
+                k->inverse(a, layer);
+            } else {
+                k->pointwise_mul(a, a, b, layer);
+            }
+        }
+        const uint64_t t = tune_now_ns() - start;
+        if (round && t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static int load_choice(const char *path, int features) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return -1;
+    }
+    int version, saved_features, ok;
+    uint32_t seen = 0;
+    ok = fscanf(f, "ntt64-autotune %d features %d", &version, &saved_features) == 2 &&
+         version == 1 && saved_features == features;
+    uint8_t choice[NTT_MAX_LAYERS][NUM_OPS];
+    int layer;
+    unsigned q;
+    char names[NUM_OPS][16];
+    while (ok && fscanf(f, "%d %u %15s %15s %15s", &layer, &q, names[0], names[1], names[2]) == 5) {
+        ok = layer_exists(layer) && !(seen >> layer & 1) && q == ntt64_get_modulus(layer);
+        for (int op = 0; ok && op < NUM_OPS; op++) {
+            const int b = backend_by_name(names[op], features);
+            ok = b >= 0;
+            choice[layer][op] = (uint8_t)b;
+        }
+        seen |= ok ? 1u << layer : 0;
+    }
+    fclose(f);
+
+    // Every current layer exactly once, nothing else
+    int layers = 0;
+    while (layers < NTT_MAX_LAYERS && layer_exists(layers)) {
+        layers++;
+    }
+    if (!ok || seen != (1u << layers) - 1) {
+        return -1;
+    }
+    memcpy(tuned, choice, sizeof(tuned[0]) * (size_t)layers);
+    return 0;
+}
+
+static int save_choice(const char *path, int features) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        return -1;
+    }
+    fprintf(f, "ntt64-autotune 1 features %d\n", features);
+    for (int layer = 0; layer < NTT_MAX_LAYERS && layer_exists(layer); layer++) {
+        fprintf(f, "%d %u %s %s %s\n", layer, ntt64_get_modulus(layer),
+                BACKENDS[tuned[layer][OP_FORWARD]].name, BACKENDS[tuned[layer][OP_INVERSE]].name,
+                BACKENDS[tuned[layer][OP_POINTWISE]].name);
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+// Point the dispatch (and, without NTT64_IFUNC, the default entry points) at
+// the choice: straight at a kernel where every layer agrees, else the table
+static void install_choice(int layers) {
+    int uniform[NUM_OPS];
+    for (int op = 0; op < NUM_OPS; op++) {
+        uniform[op] = 1;
+        for (int layer = 1; layer < NTT_MAX_LAYERS; layer++) {
+            uniform[op] &= tuned[layer][op] == tuned[0][op];
+        }
+    }
+    ntt64_forward_ptr = uniform[OP_FORWARD] ? BACKENDS[tuned[0][OP_FORWARD]].k.forward
+                                            : tuned_forward;
+    ntt64_inverse_ptr = uniform[OP_INVERSE] ? BACKENDS[tuned[0][OP_INVERSE]].k.inverse
+                                            : tuned_inverse;
+    ntt64_pointwise_mul_ptr = uniform[OP_POINTWISE]
+                                  ? BACKENDS[tuned[0][OP_POINTWISE]].k.pointwise_mul
+                                  : tuned_pointwise_mul;
+    #ifndef NTT64_USE_IFUNC
+    atomic_store_explicit(&forward_entry, ntt64_forward_ptr, memory_order_relaxed);
+    atomic_store_explicit(&inverse_entry, ntt64_inverse_ptr, memory_order_relaxed);
+    atomic_store_explicit(&pointwise_mul_entry, ntt64_pointwise_mul_ptr, memory_order_relaxed);
+    #endif
+
+    size_t len = (size_t)snprintf(tuned_summary, sizeof(tuned_summary), "autotuned (");
+    for (int layer = 0; layer < NTT_MAX_LAYERS; layer++) {
+        const uint8_t *c = tuned[layer];
+        if (c[OP_FORWARD] == c[OP_INVERSE] && c[OP_INVERSE] == c[OP_POINTWISE]) {
+            snprintf(layer_names[layer], sizeof(layer_names[layer]), "%s",
+                     BACKENDS[c[OP_FORWARD]].label);
+        } else {
+            snprintf(layer_names[layer], sizeof(layer_names[layer]), "%s/%s/%s",
+                     BACKENDS[c[OP_FORWARD]].label, BACKENDS[c[OP_INVERSE]].label,
+                     BACKENDS[c[OP_POINTWISE]].label);
+        }
+        if (layer < layers) {
+            len += (size_t)snprintf(tuned_summary + len, sizeof(tuned_summary) - len,
+                                    "%s%d: %s", layer ? ", " : "", layer, layer_names[layer]);
+        }
+    }
+    snprintf(tuned_summary + len, sizeof(tuned_summary) - len, ")");
+    implementation_name = tuned_summary;
+    tuned_active = 1;
+}
+
+int ntt64_autotune(const char *path) {
+    ntt64_init();
+    const int features = ntt64_detect_cpu_features();
+
+    // Layers registered later keep ntt64_init()'s kernels
+    const core_kernels_t init = { ntt64_forward_ptr, ntt64_inverse_ptr, ntt64_pointwise_mul_ptr };
+    for (size_t b = 0; b < NUM_BACKENDS; b++) {
+        if (BACKENDS[b].k.forward == init.forward) {
+            memset(tuned, (int)b, sizeof(tuned));
+        }
+    }
+    int layers = 0;
+    while (layers < NTT_MAX_LAYERS && layer_exists(layers)) {
+        layers++;
+    }
+
+    const char *env = getenv(NTT64_BACKEND_ENV);
+    const int forced = env ? backend_by_name(env, features) : -1;
+    if (forced >= 0) {
+        memset(tuned, forced, sizeof(tuned));
+        install_choice(layers);
+        return 0;
+    }
+    if (path && load_choice(path, features) == 0) {
+        install_choice(layers);
+        return 0;
+    }
+
+    for (int layer = 0; layer < layers; layer++) {
+        for (int op = 0; op < NUM_OPS; op++) {
+            uint64_t best = UINT64_MAX;
+            for (size_t b = 0; b < NUM_BACKENDS; b++) {
+                if (!backend_available(b, features)) {
+                    continue;
+                }
+                const uint64_t t = time_kernel(&BACKENDS[b].k, op, layer);
+                if (t < best) {
+                    best = t;
+                    tuned[layer][op] = (uint8_t)b;
+                }
+            }
+        }
+    }
+    install_choice(layers);
+    return path ? save_choice(path, features) : 0;
+}
+
+const char* ntt64_get_layer_implementation_name(int layer) {
+    if (!layer_exists(layer)) {
+        return NULL;
+    }
+    return tuned_active ? layer_names[layer] : implementation_name;
+}
+
+// ============================================================================
+// BATCHED TRANSFORMS
+// ============================================================================
+
+void ntt64_forward_batch(uint32_t *soa, size_t count, int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    ntt64_forward_batch_ptr(soa, count, layer);
+}
+
+void ntt64_inverse_batch(uint32_t *soa, size_t count, int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    ntt64_inverse_batch_ptr(soa, count, layer);
+}
+
+// ============================================================================
+// ALL-LAYERS TRANSFORMS
+// ============================================================================
+
+void ntt64_forward_all_layers(const uint32_t in[NTT_N],
+                              uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    ntt64_forward_all_layers_ptr(in, out);
+}
+
+void ntt64_inverse_all_layers(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                              uint32_t out[NTT_NUM_LAYERS][NTT_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    ntt64_inverse_all_layers_ptr(in, out);
+}
+
+// ============================================================================
+// FUSED POINTWISE KERNELS
+// ============================================================================
+
+void ntt64_pointwise_mac(uint32_t acc[NTT_N],
+                         const uint32_t a[][NTT_N],
+                         const uint32_t b[][NTT_N],
+                         size_t count, int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_pointwise_mac_ptr(acc, a, b, count, layer);
+}
+
+void ntt64_pointwise_mul_chain(uint32_t result[NTT_N],
+                               const uint32_t x[NTT_N],
+                               const uint32_t b[][NTT_N],
+                               size_t count, int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_pointwise_mul_chain_ptr(result, x, b, count, layer);
+}
+
+void ntt64_pointwise_scale_add(uint32_t result[NTT_N],
+                               const uint32_t a[NTT_N],
+                               uint32_t s,
+                               const uint32_t b[NTT_N],
+                               int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_pointwise_scale_add_ptr(result, a, s, b, layer);
+}
+
+// ============================================================================
+// PREPARED OPERANDS
+// ============================================================================
+
+void ntt64_pointwise_mul_prepared(uint32_t result[NTT_N],
+                                  const uint32_t a[NTT_N],
+                                  const ntt64_prepared_t *prep) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_pointwise_mul_prepared_ptr(result, a, prep);
+}
+
+// ============================================================================
+// 16-BIT KERNELS
+// ============================================================================
+
+int ntt64_forward_bitrev16(uint16_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    return ntt64_forward_bitrev16_ptr(poly, layer);
+}
+
+int ntt64_inverse_bitrev16(uint16_t poly[NTT_N], int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    return ntt64_inverse_bitrev16_ptr(poly, layer);
+}
+
+int ntt64_pointwise_mul16(uint16_t result[NTT_N],
+                          const uint16_t a[NTT_N],
+                          const uint16_t b[NTT_N],
+                          int layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    return ntt64_pointwise_mul16_ptr(result, a, b, layer);
+}
+
+// ============================================================================
+// MODULUS SWITCHING AND CRT
+// ============================================================================
+
+int ntt64_mod_switch(uint32_t poly[NTT_N], int from_layer, int to_layer) {
+    return ntt64_mod_switch_batch(poly, 1, from_layer, to_layer);
+}
+
+int ntt64_mod_switch_batch(uint32_t *polys, size_t count, int from_layer, int to_layer) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_switch_t sw;
+    if (ntt64_switch_prepare(&sw, from_layer, to_layer) != 0) {
+        return -1;
+    }
+    ntt64_mod_switch_ptr(polys, count * NTT_N, &sw);
+    return 0;
+}
+
+int ntt64_crt_combine(const uint32_t *const polys[], const int layers[], size_t count,
+                      uint64_t out[NTT_N]) {
+    return ntt64_crt_combine_batch(polys, layers, count, 1, out);
+}
+
+int ntt64_crt_combine_batch(const uint32_t *const polys[], const int layers[], size_t count,
+                            size_t n_polys, uint64_t *out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+    ntt64_crt_t crt;
+    if (ntt64_crt_prepare(&crt, layers, count) != 0) {
+        return -1;
+    }
+    ntt64_crt_combine_ptr(out, polys, n_polys * NTT_N, &crt);
+    return 0;
+}
+
 const char* ntt64_get_implementation_name(void) {
     return implementation_name;
 }
@@ -3,20 +3,19 @@
 #include "ntt64.h"
 #include "ntt64_simd.h"
 #include <arm_neon.h>
+#include <pthread.h>
 #include <string.h>
 
 // External references to shared constants and functions from ntt64.c
 extern const uint32_t Q[NTT_NUM_LAYERS];
 extern const uint32_t N_INV[NTT_NUM_LAYERS];
-extern const uint64_t BARRETT_CONST[NTT_NUM_LAYERS];
 extern const uint32_t TWIDDLES_FWD[NTT_NUM_LAYERS][6];
 extern const uint32_t TWIDDLES_INV[NTT_NUM_LAYERS][6];
 extern const uint32_t PSI_POWERS[NTT_NUM_LAYERS][NTT_N];
 extern const uint32_t PSI_INV_POWERS[NTT_NUM_LAYERS][NTT_N];
 
-// External reference to scalar functions (for correctness in SIMD version)
+// External reference to scalar functions (tables, and the ARMv7 fallback)
 uint32_t ntt64_mul_mod(uint32_t a, uint32_t b, int layer);
-void bit_reverse_copy(uint32_t poly[NTT_N]);
 void ntt64_forward_scalar(uint32_t poly[NTT_N], int layer);
 void ntt64_inverse_scalar(uint32_t poly[NTT_N], int layer);
 void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
@@ -24,107 +23,1062 @@ void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
                                  const uint32_t b[NTT_N],
                                  int layer);
 
+#if defined(__aarch64__)
+
+// Layers whose modulus fits in 16 bits take the single-Barrett fast path
+#define NEON_SMALL_MODULUS_LAYERS 5
+
 // ============================================================================
 // NEON MODULAR ARITHMETIC PRIMITIVES
 // ============================================================================
 
 /**
  * NEON modular addition for 4 values in parallel
- * Computes (a + b) mod q for 4 uint32_t values
+ * Computes (a + b) mod q; valid for every q < 2^32 (no 33-bit sum needed)
  */
-static inline uint32x4_t neon_add_mod(uint32x4_t a, uint32x4_t b, uint32_t q) {
-    uint32x4_t q_vec = vdupq_n_u32(q);
-
-    // Compute sum = a + b
-    uint32x4_t sum = vaddq_u32(a, b);
-
-    // Check if sum >= q (branchless)
-    uint32x4_t cmp = vcgeq_u32(sum, q_vec);
+static inline uint32x4_t neon_add_mod(uint32x4_t a, uint32x4_t b, uint32x4_t q_vec) {
+    // a + b >= q  <=>  a >= q - b
+    uint32x4_t q_minus_b = vsubq_u32(q_vec, b);
+    uint32x4_t t = vsubq_u32(a, q_minus_b);
 
-    // If sum >= q, subtract q
-    uint32x4_t adjustment = vandq_u32(cmp, q_vec);
-    sum = vsubq_u32(sum, adjustment);
-
-    return sum;
+    // If a < q - b the subtraction wrapped: add q back
+    uint32x4_t lt = vcltq_u32(a, q_minus_b);
+    return vaddq_u32(t, vandq_u32(lt, q_vec));
 }
 
 /**
  * NEON modular subtraction for 4 values in parallel
  * Computes (a - b) mod q for 4 uint32_t values
  */
-static inline uint32x4_t neon_sub_mod(uint32x4_t a, uint32x4_t b, uint32_t q) {
-    uint32x4_t q_vec = vdupq_n_u32(q);
+static inline uint32x4_t neon_sub_mod(uint32x4_t a, uint32x4_t b, uint32x4_t q_vec) {
+    uint32x4_t diff = vsubq_u32(a, b);
+    uint32x4_t lt = vcltq_u32(a, b);
+    return vaddq_u32(diff, vandq_u32(lt, q_vec));
+}
 
-    // Check if a < b (need to add q)
-    uint32x4_t cmp = vcltq_u32(a, b);
+/**
+ * High 32 bits of the unsigned 32x32 products of 4 lanes
+ */
+static inline uint32x4_t neon_mulhi_u32(uint32x4_t a, uint32x4_t b) {
+    uint64x2_t lo = vmull_u32(vget_low_u32(a), vget_low_u32(b));
+    uint64x2_t hi = vmull_high_u32(a, b);
+    return vuzp2q_u32(vreinterpretq_u32_u64(lo), vreinterpretq_u32_u64(hi));
+}
+
+/**
+ * NEON Montgomery multiplication: a * b * 2^(-32) mod q for 4 lanes
+ *
+ * The low halves of a*b and m*q cancel, so the result is the difference of
+ * the high halves, which lies in (-q, q) for every odd q < 2^32, b < q.
+ */
+static inline uint32x4_t neon_mont_mul(uint32x4_t a, uint32x4_t b,
+                                       uint32x4_t q_vec, uint32x4_t qinv_vec) {
+    uint64x2_t t_lo = vmull_u32(vget_low_u32(a), vget_low_u32(b));
+    uint64x2_t t_hi = vmull_high_u32(a, b);
 
-    // If a < b, add q to a first
-    uint32x4_t adjustment = vandq_u32(cmp, q_vec);
-    a = vaddq_u32(a, adjustment);
+    uint32x4_t t_low32 = vuzp1q_u32(vreinterpretq_u32_u64(t_lo), vreinterpretq_u32_u64(t_hi));
+    uint32x4_t t_high32 = vuzp2q_u32(vreinterpretq_u32_u64(t_lo), vreinterpretq_u32_u64(t_hi));
 
-    // Now compute a - b
-    uint32x4_t diff = vsubq_u32(a, b);
+    // m = (a*b mod 2^32) * q^(-1) mod 2^32
+    uint32x4_t m = vmulq_u32(t_low32, qinv_vec);
+    uint32x4_t mq_high32 = neon_mulhi_u32(m, q_vec);
 
-    return diff;
+    uint32x4_t r = vsubq_u32(t_high32, mq_high32);
+    uint32x4_t lt = vcltq_u32(t_high32, mq_high32);
+    return vaddq_u32(r, vandq_u32(lt, q_vec));
 }
 
 /**
- * NEON modular multiplication using Barrett reduction
- * Computes (a * b) mod q for 4 uint32_t values
- *
- * NEON has limited 64-bit multiplication support, so we use a hybrid approach
+ * NEON Barrett multiplication for moduli below 2^16: the product fits in a
+ * 32-bit lane and floor(2^32 / q) leaves at most one correction.
  */
-static inline uint32x4_t neon_mul_mod(uint32x4_t a, uint32x4_t b, int layer) {
-    // Extract values to scalar and use the verified scalar mul_mod
-    // This ensures correctness at the cost of some performance
-    uint32_t a_arr[4], b_arr[4], result[4];
-    vst1q_u32(a_arr, a);
-    vst1q_u32(b_arr, b);
+static inline uint32x4_t neon_mul_mod_small(uint32x4_t a, uint32x4_t b,
+                                            uint32x4_t q_vec, uint32x4_t barrett_vec) {
+    uint32x4_t x = vmulq_u32(a, b);
+    uint32x4_t quot = neon_mulhi_u32(x, barrett_vec);
+    uint32x4_t r = vmlsq_u32(x, quot, q_vec);
+    return vminq_u32(r, vsubq_u32(r, q_vec));
+}
+
+// Per-layer reduction constants, broadcast once per call
+typedef struct {
+    uint32x4_t q;
+    uint32x4_t qinv;       // q^(-1) mod 2^32
+    uint32x4_t r2;         // 2^64 mod q
+    uint32x4_t barrett;    // floor(2^32 / q), only meaningful when q < 2^16
+} neon_modulus_t;
 
-    // Use the scalar implementation which is known to be correct
-    for (int i = 0; i < 4; i++) {
-        result[i] = ntt64_mul_mod(a_arr[i], b_arr[i], layer);
+/**
+ * Multiply by a table constant stored in twiddle form
+ * (plain for the <= 16-bit layers, Montgomery form for layers 5-6)
+ */
+static inline uint32x4_t neon_mul_twiddle(uint32x4_t a, uint32x4_t w,
+                                          const neon_modulus_t *m, int small) {
+    if (small) {
+        return neon_mul_mod_small(a, w, m->q, m->barrett);
     }
+    return neon_mont_mul(a, w, m->q, m->qinv);
+}
 
-    return vld1q_u32(result);
+/**
+ * General NEON modular multiplication: (a * b) mod q for 4 lanes
+ */
+static inline uint32x4_t neon_mul_mod(uint32x4_t a, uint32x4_t b,
+                                      const neon_modulus_t *m, int small) {
+    if (small) {
+        return neon_mul_mod_small(a, b, m->q, m->barrett);
+    }
+    return neon_mont_mul(neon_mont_mul(a, b, m->q, m->qinv), m->r2, m->q, m->qinv);
 }
 
 // ============================================================================
-// NEON BIT-REVERSAL
+// TWIDDLE TABLES
 // ============================================================================
 
+// Same layout as the AVX2 tables: stage s uses the slice [2^s - 1, 2^(s+1) - 1)
+// holding omega_s^0..omega_s^(2^s - 1), stored in twiddle form.
+#define NEON_TWIDDLE_COUNT 63
+
+typedef struct {
+    uint32_t fwd[NEON_TWIDDLE_COUNT];
+    uint32_t inv[NEON_TWIDDLE_COUNT];
+    uint32_t psi[NTT_N];
+    uint32_t psi_inv_scaled[NTT_N];   // N^(-1) * psi^(-i): folds both output passes
+    uint32_t qinv;
+    uint32_t r2;
+    uint32_t barrett;
+} neon_layer_tables_t;
+
+static neon_layer_tables_t neon_tables[NTT_NUM_LAYERS];
+static pthread_once_t neon_tables_once = PTHREAD_ONCE_INIT;
+
+static uint32_t neon_twiddle_form(uint32_t w, int layer) {
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        return w;
+    }
+    return (uint32_t)(((uint64_t)w << 32) % Q[layer]);
+}
+
+static void neon_build_tables(void) {
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        neon_layer_tables_t *t = &neon_tables[layer];
+        uint32_t q = Q[layer];
+
+        // Newton iteration for q^(-1) mod 2^32
+        uint32_t qinv = q;
+        for (int i = 0; i < 5; i++) {
+            qinv *= 2 - q * qinv;
+        }
+        uint64_t r = ((uint64_t)1 << 32) % q;
+        t->qinv = qinv;
+        t->r2 = (uint32_t)((r * r) % q);
+        t->barrett = (uint32_t)(((uint64_t)1 << 32) / q);
+
+        for (int stage = 0; stage < 6; stage++) {
+            uint32_t base = (1u << stage) - 1;
+            uint32_t w_fwd = 1, w_inv = 1;
+
+            for (uint32_t j = 0; j < (1u << stage); j++) {
+                t->fwd[base + j] = neon_twiddle_form(w_fwd, layer);
+                t->inv[base + j] = neon_twiddle_form(w_inv, layer);
+                w_fwd = ntt64_mul_mod(w_fwd, TWIDDLES_FWD[layer][stage], layer);
+                w_inv = ntt64_mul_mod(w_inv, TWIDDLES_INV[layer][stage], layer);
+            }
+        }
+
+        for (int i = 0; i < NTT_N; i++) {
+            t->psi[i] = neon_twiddle_form(PSI_POWERS[layer][i], layer);
+            t->psi_inv_scaled[i] = neon_twiddle_form(
+                ntt64_mul_mod(N_INV[layer], PSI_INV_POWERS[layer][i], layer), layer);
+        }
+    }
+}
+
+static inline const neon_layer_tables_t *neon_get_tables(int layer, neon_modulus_t *m) {
+    pthread_once(&neon_tables_once, neon_build_tables);
+    const neon_layer_tables_t *t = &neon_tables[layer];
+
+    m->q = vdupq_n_u32(Q[layer]);
+    m->qinv = vdupq_n_u32(t->qinv);
+    m->r2 = vdupq_n_u32(t->r2);
+    m->barrett = vdupq_n_u32(t->barrett);
+    return t;
+}
+
+// ============================================================================
+// NEON BUTTERFLIES AND DATA MOVEMENT
+// ============================================================================
+
+static inline void neon_butterfly(uint32x4_t *a, uint32x4_t *b, uint32x4_t w,
+                                  const neon_modulus_t *m, int small) {
+    uint32x4_t t = neon_mul_twiddle(*b, w, m, small);
+    uint32x4_t u = *a;
+
+    *a = neon_add_mod(u, t, m->q);
+    *b = neon_sub_mod(u, t, m->q);
+}
+
+static inline void neon_inv_butterfly(uint32x4_t *a, uint32x4_t *b, uint32x4_t w,
+                                      const neon_modulus_t *m, int small) {
+    uint32x4_t u = *a;
+    uint32x4_t v = *b;
+
+    *a = neon_add_mod(u, v, m->q);
+    *b = neon_mul_twiddle(neon_sub_mod(u, v, m->q), w, m, small);
+}
+
 /**
- * Bit-reverse a 6-bit index (for N=64=2^6)
+ * Transpose a 4x4 block: out[k] lane j = in[j] lane k (vtrn stage shuffles)
  */
-static inline uint32_t bit_reverse_6(uint32_t x) {
-    uint32_t result = 0;
-    result |= ((x & 0x01) << 5);
-    result |= ((x & 0x02) << 3);
-    result |= ((x & 0x04) << 1);
-    result |= ((x & 0x08) >> 1);
-    result |= ((x & 0x10) >> 3);
-    result |= ((x & 0x20) >> 5);
-    return result;
+static inline void neon_transpose4(uint32x4_t out[4], uint32x4_t r0, uint32x4_t r1,
+                                   uint32x4_t r2, uint32x4_t r3) {
+    uint32x4_t t0 = vtrn1q_u32(r0, r1);
+    uint32x4_t t1 = vtrn2q_u32(r0, r1);
+    uint32x4_t t2 = vtrn1q_u32(r2, r3);
+    uint32x4_t t3 = vtrn2q_u32(r2, r3);
+
+    out[0] = vreinterpretq_u32_u64(vtrn1q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t2)));
+    out[1] = vreinterpretq_u32_u64(vtrn1q_u64(vreinterpretq_u64_u32(t1), vreinterpretq_u64_u32(t3)));
+    out[2] = vreinterpretq_u32_u64(vtrn2q_u64(vreinterpretq_u64_u32(t0), vreinterpretq_u64_u32(t2)));
+    out[3] = vreinterpretq_u32_u64(vtrn2q_u64(vreinterpretq_u64_u32(t1), vreinterpretq_u64_u32(t3)));
+}
+
+// 2-bit reversal
+static const int REV2[4] = { 0, 2, 1, 3 };
+
+// ============================================================================
+// NEON NTT IMPLEMENTATION
+// ============================================================================
+//
+// The 64 coefficients live in 16 registers (AArch64 has 32). Row layout:
+// r[row] lane col holds index 4*row + col. Block layout: r[4*b + c] lane k
+// holds index 16*b + 4*k + c, i.e. each group of four rows transposed.
+// Stages 0-1 (distance 1, 2) run in block layout and stages 2-5 in row
+// layout, so every butterfly is between two registers. With
+// i = 16*b + 4*k + c, rev6(i) = 16*rev2(c) + 4*rev2(k) + rev2(b), which lets
+// the bit reversal ride on the same 4x4 transposes.
+
+static inline __attribute__((always_inline))
+void neon_forward_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    neon_modulus_t m;
+    const neon_layer_tables_t *tab = neon_get_tables(layer, &m);
+    uint32x4_t x[16], r[16];
+
+    // Preprocessing: multiply poly[i] by psi^i (row layout)
+#pragma GCC unroll 16
+    for (int row = 0; row < 16; row++) {
+        uint32x4_t v = vld1q_u32(&poly[4 * row]);
+        x[row] = neon_mul_twiddle(v, vld1q_u32(&tab->psi[4 * row]), &m, small);
+    }
+
+    // Bit-reverse into block layout: r[4*b + c] lane k = x[4*rev2(c) + rev2(k)] lane rev2(b)
+#pragma GCC unroll 4
+    for (int c = 0; c < 4; c++) {
+        int base = 4 * REV2[c];
+        uint32x4_t t[4];
+        neon_transpose4(t, x[base + 0], x[base + 2], x[base + 1], x[base + 3]);
+#pragma GCC unroll 4
+        for (int b = 0; b < 4; b++) {
+            r[4 * b + c] = t[REV2[b]];
+        }
+    }
+
+    // Stages 0-1: distance 1, 2 in c, one broadcast twiddle per register
+#pragma GCC unroll 2
+    for (int stage = 0; stage < 2; stage++) {
+        int h = 1 << stage;
+#pragma GCC unroll 16
+        for (int reg = 0; reg < 16; reg++) {
+            int c = reg & 3;
+            if (c & h) continue;
+            uint32x4_t w = vdupq_n_u32(tab->fwd[h - 1 + (c & (h - 1))]);
+            neon_butterfly(&r[reg], &r[reg + h], w, &m, small);
+        }
+    }
+
+    // Back to row layout
+#pragma GCC unroll 4
+    for (int b = 0; b < 4; b++) {
+        uint32x4_t t[4];
+        neon_transpose4(t, r[4 * b + 0], r[4 * b + 1], r[4 * b + 2], r[4 * b + 3]);
+#pragma GCC unroll 4
+        for (int k = 0; k < 4; k++) {
+            r[4 * b + k] = t[k];
+        }
+    }
+
+    // Stages 2-5: distance 1, 2, 4, 8 rows, one twiddle vector per register
+#pragma GCC unroll 4
+    for (int stage = 2; stage < 6; stage++) {
+        int h = 1 << stage;
+        int h_rows = h >> 2;
+#pragma GCC unroll 16
+        for (int row = 0; row < 16; row++) {
+            if (row & h_rows) continue;
+            uint32x4_t w = vld1q_u32(&tab->fwd[h - 1 + 4 * (row & (h_rows - 1))]);
+            neon_butterfly(&r[row], &r[row + h_rows], w, &m, small);
+        }
+    }
+
+#pragma GCC unroll 16
+    for (int row = 0; row < 16; row++) {
+        vst1q_u32(&poly[4 * row], r[row]);
+    }
+}
+
+static inline __attribute__((always_inline))
+void neon_inverse_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    neon_modulus_t m;
+    const neon_layer_tables_t *tab = neon_get_tables(layer, &m);
+    uint32x4_t r[16], z[16];
+
+#pragma GCC unroll 16
+    for (int row = 0; row < 16; row++) {
+        r[row] = vld1q_u32(&poly[4 * row]);
+    }
+
+    // Stages 5-2 in row layout
+#pragma GCC unroll 4
+    for (int stage = 5; stage >= 2; stage--) {
+        int h = 1 << stage;
+        int h_rows = h >> 2;
+#pragma GCC unroll 16
+        for (int row = 0; row < 16; row++) {
+            if (row & h_rows) continue;
+            uint32x4_t w = vld1q_u32(&tab->inv[h - 1 + 4 * (row & (h_rows - 1))]);
+            neon_inv_butterfly(&r[row], &r[row + h_rows], w, &m, small);
+        }
+    }
+
+    // To block layout
+#pragma GCC unroll 4
+    for (int b = 0; b < 4; b++) {
+        uint32x4_t t[4];
+        neon_transpose4(t, r[4 * b + 0], r[4 * b + 1], r[4 * b + 2], r[4 * b + 3]);
+#pragma GCC unroll 4
+        for (int c = 0; c < 4; c++) {
+            r[4 * b + c] = t[c];
+        }
+    }
+
+    // Stages 1-0 in block layout
+#pragma GCC unroll 2
+    for (int stage = 1; stage >= 0; stage--) {
+        int h = 1 << stage;
+#pragma GCC unroll 16
+        for (int reg = 0; reg < 16; reg++) {
+            int c = reg & 3;
+            if (c & h) continue;
+            uint32x4_t w = vdupq_n_u32(tab->inv[h - 1 + (c & (h - 1))]);
+            neon_inv_butterfly(&r[reg], &r[reg + h], w, &m, small);
+        }
+    }
+
+    // Bit-reverse back to row layout: z[row] lane l = r[4*rev2(l) + rev2(row >> 2)] lane rev2(row & 3)
+#pragma GCC unroll 4
+    for (int hi = 0; hi < 4; hi++) {
+        int c = REV2[hi];
+        uint32x4_t t[4];
+        neon_transpose4(t, r[c], r[8 + c], r[4 + c], r[12 + c]);
+#pragma GCC unroll 4
+        for (int lo = 0; lo < 4; lo++) {
+            z[4 * hi + lo] = t[REV2[lo]];
+        }
+    }
+
+    // Postprocessing: N^(-1) and psi^(-i) in a single multiplication
+#pragma GCC unroll 16
+    for (int row = 0; row < 16; row++) {
+        uint32x4_t s = vld1q_u32(&tab->psi_inv_scaled[4 * row]);
+        vst1q_u32(&poly[4 * row], neon_mul_twiddle(z[row], s, &m, small));
+    }
+}
+
+static inline __attribute__((always_inline))
+void neon_pointwise_kernel(uint32_t result[NTT_N],
+                           const uint32_t a[NTT_N],
+                           const uint32_t b[NTT_N],
+                           int layer, int small) {
+    neon_modulus_t m;
+    neon_get_tables(layer, &m);
+
+#pragma GCC unroll 4
+    for (uint32_t i = 0; i < NTT_N; i += 4) {
+        uint32x4_t a_vec = vld1q_u32(&a[i]);
+        uint32x4_t b_vec = vld1q_u32(&b[i]);
+        vst1q_u32(&result[i], neon_mul_mod(a_vec, b_vec, &m, small));
+    }
+}
+
+void ntt64_forward_neon(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_scalar(poly, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        neon_forward_kernel(poly, layer, 1);
+    } else {
+        neon_forward_kernel(poly, layer, 0);
+    }
+}
+
+void ntt64_inverse_neon(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_scalar(poly, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        neon_inverse_kernel(poly, layer, 1);
+    } else {
+        neon_inverse_kernel(poly, layer, 0);
+    }
+}
+
+void ntt64_pointwise_mul_neon(uint32_t result[NTT_N],
+                               const uint32_t a[NTT_N],
+                               const uint32_t b[NTT_N],
+                               int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mul_scalar(result, a, b, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        neon_pointwise_kernel(result, a, b, layer, 1);
+    } else {
+        neon_pointwise_kernel(result, a, b, layer, 0);
+    }
+}
+
+// ============================================================================
+// NEON BATCHED NTT (interleaved layout, 4 polynomials per pass)
+// ============================================================================
+
+// 6-bit reversal as three reversed 2-bit digits
+static inline int neon_bit_reverse_6(int i) {
+    return (REV2[i & 3] << 4) | (REV2[(i >> 2) & 3] << 2) | REV2[i >> 4];
+}
+
+static inline __attribute__((always_inline))
+void neon_forward_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    neon_modulus_t m;
+    const neon_layer_tables_t *tab = neon_get_tables(layer, &m);
+    uint32x4_t x[NTT_N];
+    size_t p = 0;
+
+    for (; p + 4 <= count; p += 4) {
+        // psi twist fused with the bit-reversed load
+        for (int i = 0; i < NTT_N; i++) {
+            int j = neon_bit_reverse_6(i);
+            uint32x4_t v = vld1q_u32(&soa[(size_t)j * count + p]);
+            x[i] = neon_mul_twiddle(v, vdupq_n_u32(tab->psi[j]), &m, small);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 0; stage < 6; stage++) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                uint32x4_t w = vdupq_n_u32(tab->fwd[h - 1 + j]);
+                #pragma GCC unroll 32
+                for (int k = 0; k < NTT_N; k += 2 * h) {
+                    neon_butterfly(&x[k + j], &x[k + j + h], w, &m, small);
+                }
+            }
+        }
+
+        for (int i = 0; i < NTT_N; i++) {
+            vst1q_u32(&soa[(size_t)i * count + p], x[i]);
+        }
+    }
+
+    for (; p < count; p++) {
+        ntt64_forward_strided_scalar(soa + p, count, layer);
+    }
+}
+
+static inline __attribute__((always_inline))
+void neon_inverse_batch_kernel(uint32_t *soa, size_t count, int layer, int small) {
+    neon_modulus_t m;
+    const neon_layer_tables_t *tab = neon_get_tables(layer, &m);
+    uint32x4_t x[NTT_N];
+    size_t p = 0;
+
+    for (; p + 4 <= count; p += 4) {
+        for (int i = 0; i < NTT_N; i++) {
+            x[i] = vld1q_u32(&soa[(size_t)i * count + p]);
+        }
+
+        #pragma GCC unroll 6
+        for (int stage = 5; stage >= 0; stage--) {
+            int h = 1 << stage;
+            #pragma GCC unroll 32
+            for (int j = 0; j < h; j++) {
+                uint32x4_t w = vdupq_n_u32(tab->inv[h - 1 + j]);
+                #pragma GCC unroll 32
+                for (int k = 0; k < NTT_N; k += 2 * h) {
+                    neon_inv_butterfly(&x[k + j], &x[k + j + h], w, &m, small);
+                }
+            }
+        }
+
+        // Bit-reversed store fused with N^(-1) * psi^(-i)
+        for (int i = 0; i < NTT_N; i++) {
+            uint32x4_t s = vdupq_n_u32(tab->psi_inv_scaled[i]);
+            vst1q_u32(&soa[(size_t)i * count + p],
+                      neon_mul_twiddle(x[neon_bit_reverse_6(i)], s, &m, small));
+        }
+    }
+
+    for (; p < count; p++) {
+        ntt64_inverse_strided_scalar(soa + p, count, layer);
+    }
+}
+
+void ntt64_forward_batch_neon(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        neon_forward_batch_kernel(soa, count, layer, 1);
+    } else {
+        neon_forward_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+void ntt64_inverse_batch_neon(uint32_t *soa, size_t count, int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_batch_scalar(soa, count, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        neon_inverse_batch_kernel(soa, count, layer, 1);
+    } else {
+        neon_inverse_batch_kernel(soa, count, layer, 0);
+    }
+}
+
+// ============================================================================
+// NEON 16-BIT KERNELS
+// ============================================================================
+//
+// Same scheme as the AVX2 16-bit kernels with 8 registers of 8 lanes: r[k]
+// lane j holds index 8k + j. Distances 32, 16 and 8 pair whole registers;
+// distances 4, 2 and 1 split a register pair into the butterfly halves with
+// vcombine/trn and merge it back. Montgomery products use the Kyber NEON
+// sequence: vqdmulh gives 2*hi(a*w), and vhsub halves the difference.
+
+// Built-in layers with q < 2^15
+#define NEON_NTT16_LAYERS 3
+
+typedef struct {
+    int16_t fwd[6][4][8];           // [stage][register pair][lane], Montgomery form
+    int16_t fwd_qinv[6][4][8];      // fwd * q^(-1) mod 2^16
+    int16_t inv[6][4][8];
+    int16_t inv_qinv[6][4][8];
+    int16_t qinv;
+    uint16_t barrett;               // floor(2^16 / q), reduces raw input
+    int16_t r2, r2_qinv;            // R^2 mod q: corrects the pointwise product
+    int16_t n_inv, n_inv_qinv;      // last inverse stage (len = 32)
+    int16_t zeta1_n_inv, zeta1_n_inv_qinv;
+} neon_layer16_tables_t;
+
+static neon_layer16_tables_t neon_tables16[NEON_NTT16_LAYERS];
+static pthread_once_t neon_tables16_once = PTHREAD_ONCE_INIT;
+
+static inline int16x8_t neon_mont16(int16x8_t a, int16x8_t w, int16x8_t w_qinv, int16x8_t q_vec) {
+    int16x8_t hi = vqdmulhq_s16(a, w);
+    int16x8_t m = vmulq_s16(a, w_qinv);
+    return vhsubq_s16(hi, vqdmulhq_s16(m, q_vec));
+}
+
+// (-q, q) -> [0, q)
+static inline int16x8_t neon_canon16(int16x8_t a, int16x8_t q_vec) {
+    uint16x8_t u = vreinterpretq_u16_s16(a);
+    return vreinterpretq_s16_u16(vminq_u16(u, vreinterpretq_u16_s16(vaddq_s16(a, q_vec))));
+}
+
+static inline int16x8_t neon_add_mod16(int16x8_t a, int16x8_t b, int16x8_t q_vec) {
+    uint16x8_t sum = vreinterpretq_u16_s16(vaddq_s16(a, b));
+    uint16x8_t q = vreinterpretq_u16_s16(q_vec);
+    return vreinterpretq_s16_u16(vminq_u16(sum, vsubq_u16(sum, q)));
+}
+
+static inline int16x8_t neon_sub_mod16(int16x8_t a, int16x8_t b, int16x8_t q_vec) {
+    uint16x8_t diff = vreinterpretq_u16_s16(vsubq_s16(a, b));
+    uint16x8_t q = vreinterpretq_u16_s16(q_vec);
+    return vreinterpretq_s16_u16(vminq_u16(diff, vaddq_u16(diff, q)));
 }
 
 /**
- * NEON-optimized bit-reversal permutation
- * Uses SIMD loads/stores for better cache performance
+ * Gather the butterfly pairs at distance d (4, 2 or 1 lanes) of x and y:
+ * *a gets the lower and *b the upper element of every pair. The operation is
+ * its own inverse, so the same call merges (a, b) back into (x, y).
  */
+static inline void neon_split16(int16x8_t x, int16x8_t y, int16x8_t *a, int16x8_t *b, int d) {
+    switch (d) {
+    case 4:
+        *a = vcombine_s16(vget_low_s16(x), vget_low_s16(y));
+        *b = vcombine_s16(vget_high_s16(x), vget_high_s16(y));
+        break;
+    case 2:
+        *a = vreinterpretq_s16_s32(vtrn1q_s32(vreinterpretq_s32_s16(x), vreinterpretq_s32_s16(y)));
+        *b = vreinterpretq_s16_s32(vtrn2q_s32(vreinterpretq_s32_s16(x), vreinterpretq_s32_s16(y)));
+        break;
+    default:
+        *a = vtrn1q_s16(x, y);
+        *b = vtrn2q_s16(x, y);
+        break;
+    }
+}
+
+static int16_t neon_mont_form16(uint32_t w, uint32_t q) {
+    return (int16_t)(((uint64_t)w << 16) % q);
+}
+
+static void neon_build_tables16(void) {
+    for (int layer = 0; layer < NEON_NTT16_LAYERS; layer++) {
+        neon_layer16_tables_t *t = &neon_tables16[layer];
+        uint32_t q = Q[layer];
+
+        uint16_t qinv = (uint16_t)q;
+        for (int i = 0; i < 4; i++) {
+            qinv *= (uint16_t)(2 - q * qinv);
+        }
+        t->qinv = (int16_t)qinv;
+        t->barrett = (uint16_t)(65536u / q);
+        t->r2 = (int16_t)(((uint64_t)1 << 32) % q);
+        t->r2_qinv = (int16_t)(uint16_t)((uint16_t)t->r2 * qinv);
+
+        uint32_t n_inv = N_INV[layer];
+        uint32_t zeta1 = ntt64_mul_mod(PSI_INV_POWERS[layer][neon_bit_reverse_6(1)], n_inv, layer);
+        t->n_inv = neon_mont_form16(n_inv, q);
+        t->n_inv_qinv = (int16_t)(uint16_t)((uint16_t)t->n_inv * qinv);
+        t->zeta1_n_inv = neon_mont_form16(zeta1, q);
+        t->zeta1_n_inv_qinv = (int16_t)(uint16_t)((uint16_t)t->zeta1_n_inv * qinv);
+
+        // Run the split on coefficient indices to find where each one lands
+        static const int16_t lanes[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        for (int stage = 0; stage < 6; stage++) {
+            int len = 32 >> stage;
+            int hreg = len >= 8 ? len / 8 : 1;
+            for (int pair = 0; pair < 4; pair++) {
+                int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+                int16_t idx[8];
+                int16x8_t x = vaddq_s16(vld1q_s16(lanes), vdupq_n_s16((int16_t)(8 * xr)));
+                int16x8_t a = x, b;
+                if (len < 8) {
+                    neon_split16(x, vaddq_s16(x, vdupq_n_s16(8)), &a, &b, len);
+                }
+                vst1q_s16(idx, a);
+
+                for (int lane = 0; lane < 8; lane++) {
+                    uint32_t k = (1u << stage) + (uint32_t)idx[lane] / (2u * (uint32_t)len);
+                    int rev = neon_bit_reverse_6((int)k);
+                    int16_t w_fwd = neon_mont_form16(PSI_POWERS[layer][rev], q);
+                    int16_t w_inv = neon_mont_form16(PSI_INV_POWERS[layer][rev], q);
+                    t->fwd[stage][pair][lane] = w_fwd;
+                    t->fwd_qinv[stage][pair][lane] = (int16_t)(uint16_t)((uint16_t)w_fwd * qinv);
+                    t->inv[stage][pair][lane] = w_inv;
+                    t->inv_qinv[stage][pair][lane] = (int16_t)(uint16_t)((uint16_t)w_inv * qinv);
+                }
+            }
+        }
+    }
+}
+
+static inline const neon_layer16_tables_t *neon_get_tables16(int layer) {
+    pthread_once(&neon_tables16_once, neon_build_tables16);
+    return &neon_tables16[layer];
+}
+
+int ntt64_forward_bitrev16_neon(uint16_t poly[NTT_N], int layer) {
+    if (layer < 0 || layer >= NEON_NTT16_LAYERS) {
+        return ntt64_forward_bitrev16_scalar(poly, layer);
+    }
+    const neon_layer16_tables_t *t = neon_get_tables16(layer);
+    const int16x8_t q_vec = vdupq_n_s16((int16_t)Q[layer]);
+    const uint16x8_t qu = vdupq_n_u16((uint16_t)Q[layer]);
+    const uint16x8_t barrett = vdupq_n_u16(t->barrett);
+    int16x8_t r[8];
+
+    // Reduce the raw input: the estimated quotient is at most one too small
+    #pragma GCC unroll 8
+    for (int k = 0; k < 8; k++) {
+        uint16x8_t v = vld1q_u16(&poly[8 * k]);
+        uint32x4_t lo = vmull_u16(vget_low_u16(v), vget_low_u16(barrett));
+        uint32x4_t hi = vmull_high_u16(v, barrett);
+        uint16x8_t quot = vuzp2q_u16(vreinterpretq_u16_u32(lo), vreinterpretq_u16_u32(hi));
+        v = vmlsq_u16(v, quot, qu);
+        r[k] = vreinterpretq_s16_u16(vminq_u16(v, vsubq_u16(v, qu)));
+    }
+
+    #pragma GCC unroll 6
+    for (int stage = 0; stage < 6; stage++) {
+        int len = 32 >> stage;
+        int hreg = len >= 8 ? len / 8 : 1;
+        #pragma GCC unroll 4
+        for (int pair = 0; pair < 4; pair++) {
+            int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+            int yr = xr + hreg;
+            int16x8_t w = vld1q_s16(t->fwd[stage][pair]);
+            int16x8_t wq = vld1q_s16(t->fwd_qinv[stage][pair]);
+            int16x8_t a = r[xr], b = r[yr];
+            if (len < 8) {
+                neon_split16(r[xr], r[yr], &a, &b, len);
+            }
+
+            int16x8_t v = neon_canon16(neon_mont16(b, w, wq, q_vec), q_vec);
+            b = neon_sub_mod16(a, v, q_vec);
+            a = neon_add_mod16(a, v, q_vec);
+
+            if (len < 8) {
+                neon_split16(a, b, &a, &b, len);
+            }
+            r[xr] = a;
+            r[yr] = b;
+        }
+    }
+
+    #pragma GCC unroll 8
+    for (int k = 0; k < 8; k++) {
+        vst1q_u16(&poly[8 * k], vreinterpretq_u16_s16(r[k]));
+    }
+    return 0;
+}
+
+int ntt64_inverse_bitrev16_neon(uint16_t poly[NTT_N], int layer) {
+    if (layer < 0 || layer >= NEON_NTT16_LAYERS) {
+        return ntt64_inverse_bitrev16_scalar(poly, layer);
+    }
+    const neon_layer16_tables_t *t = neon_get_tables16(layer);
+    const int16x8_t q_vec = vdupq_n_s16((int16_t)Q[layer]);
+    int16x8_t r[8];
+
+    #pragma GCC unroll 8
+    for (int k = 0; k < 8; k++) {
+        r[k] = vreinterpretq_s16_u16(vld1q_u16(&poly[8 * k]));
+    }
+
+    #pragma GCC unroll 5
+    for (int stage = 5; stage >= 1; stage--) {
+        int len = 32 >> stage;
+        int hreg = len >= 8 ? len / 8 : 1;
+        #pragma GCC unroll 4
+        for (int pair = 0; pair < 4; pair++) {
+            int xr = (pair / hreg) * 2 * hreg + pair % hreg;
+            int yr = xr + hreg;
+            int16x8_t w = vld1q_s16(t->inv[stage][pair]);
+            int16x8_t wq = vld1q_s16(t->inv_qinv[stage][pair]);
+            int16x8_t a = r[xr], b = r[yr];
+            if (len < 8) {
+                neon_split16(r[xr], r[yr], &a, &b, len);
+            }
+
+            int16x8_t diff = neon_sub_mod16(a, b, q_vec);
+            a = neon_add_mod16(a, b, q_vec);
+            b = neon_canon16(neon_mont16(diff, w, wq, q_vec), q_vec);
+
+            if (len < 8) {
+                neon_split16(a, b, &a, &b, len);
+            }
+            r[xr] = a;
+            r[yr] = b;
+        }
+    }
+
+    // Last stage (len = 32) with N^(-1) folded into both outputs
+    const int16x8_t n_inv = vdupq_n_s16(t->n_inv);
+    const int16x8_t n_inv_qinv = vdupq_n_s16(t->n_inv_qinv);
+    const int16x8_t zeta = vdupq_n_s16(t->zeta1_n_inv);
+    const int16x8_t zeta_qinv = vdupq_n_s16(t->zeta1_n_inv_qinv);
+    #pragma GCC unroll 4
+    for (int k = 0; k < 4; k++) {
+        int16x8_t sum = neon_add_mod16(r[k], r[k + 4], q_vec);
+        int16x8_t diff = neon_sub_mod16(r[k], r[k + 4], q_vec);
+        int16x8_t lo = neon_canon16(neon_mont16(sum, n_inv, n_inv_qinv, q_vec), q_vec);
+        int16x8_t hi = neon_canon16(neon_mont16(diff, zeta, zeta_qinv, q_vec), q_vec);
+        vst1q_u16(&poly[8 * k], vreinterpretq_u16_s16(lo));
+        vst1q_u16(&poly[8 * (k + 4)], vreinterpretq_u16_s16(hi));
+    }
+    return 0;
+}
+
+int ntt64_pointwise_mul16_neon(uint16_t result[NTT_N],
+                               const uint16_t a[NTT_N],
+                               const uint16_t b[NTT_N],
+                               int layer) {
+    if (layer < 0 || layer >= NEON_NTT16_LAYERS) {
+        return ntt64_pointwise_mul16_scalar(result, a, b, layer);
+    }
+    const neon_layer16_tables_t *t = neon_get_tables16(layer);
+    const int16x8_t q_vec = vdupq_n_s16((int16_t)Q[layer]);
+    const int16x8_t qinv = vdupq_n_s16(t->qinv);
+    const int16x8_t r2 = vdupq_n_s16(t->r2);
+    const int16x8_t r2_qinv = vdupq_n_s16(t->r2_qinv);
+
+    // a*b/R, then * R^2/R: two Montgomery steps, no division
+    #pragma GCC unroll 8
+    for (int k = 0; k < 8; k++) {
+        int16x8_t va = vreinterpretq_s16_u16(vld1q_u16(&a[8 * k]));
+        int16x8_t vb = vreinterpretq_s16_u16(vld1q_u16(&b[8 * k]));
+        int16x8_t hi = vqdmulhq_s16(va, vb);
+        int16x8_t m = vmulq_s16(vmulq_s16(va, vb), qinv);
+        int16x8_t x = vhsubq_s16(hi, vqdmulhq_s16(m, q_vec));
+        vst1q_u16(&result[8 * k],
+                  vreinterpretq_u16_s16(neon_canon16(neon_mont16(x, r2, r2_qinv, q_vec), q_vec)));
+    }
+    return 0;
+}
+
+#if defined(__ARM_FEATURE_SVE2)
 
 // ============================================================================
-// NEON NTT IMPLEMENTATION
+// SVE2 IMPLEMENTATION (vector-length agnostic)
 // ============================================================================
+//
+// Shares the NEON twiddle tables. Stages with butterfly distance >= 8 stream
+// contiguous runs through predicated loads; the short-distance stages use
+// structure loads that de-interleave the butterfly halves directly:
+// distance 1 -> LD2 on 32-bit elements, distance 2 -> LD2 on 64-bit pairs,
+// distance 4 -> LD4 on 64-bit pairs. The dispatcher only prefers this path
+// over the register-resident NEON kernel when vectors are wider than 128 bits.
+
+#include <arm_sve.h>
+
+void bit_reverse_copy(uint32_t poly[NTT_N]);
+
+typedef struct {
+    svuint32_t q;
+    svuint32_t qinv;
+    svuint32_t r2;
+    svuint32_t barrett;
+} sve_modulus_t;
+
+static inline svuint32_t sve_add_mod(svuint32_t a, svuint32_t b, svuint32_t q_vec) {
+    svbool_t pg = svptrue_b32();
+    svuint32_t q_minus_b = svsub_u32_x(pg, q_vec, b);
+    svuint32_t t = svsub_u32_x(pg, a, q_minus_b);
+    return svadd_u32_m(svcmplt_u32(pg, a, q_minus_b), t, q_vec);
+}
+
+static inline svuint32_t sve_sub_mod(svuint32_t a, svuint32_t b, svuint32_t q_vec) {
+    svbool_t pg = svptrue_b32();
+    svuint32_t diff = svsub_u32_x(pg, a, b);
+    return svadd_u32_m(svcmplt_u32(pg, a, b), diff, q_vec);
+}
+
+static inline svuint32_t sve_mont_mul(svuint32_t a, svuint32_t b, const sve_modulus_t *m) {
+    svbool_t pg = svptrue_b32();
+    svuint32_t t_lo = svmul_u32_x(pg, a, b);
+    svuint32_t t_hi = svmulh_u32_x(pg, a, b);
+    svuint32_t mq_hi = svmulh_u32_x(pg, svmul_u32_x(pg, t_lo, m->qinv), m->q);
+    svuint32_t r = svsub_u32_x(pg, t_hi, mq_hi);
+    return svadd_u32_m(svcmplt_u32(pg, t_hi, mq_hi), r, m->q);
+}
+
+static inline svuint32_t sve_mul_mod_small(svuint32_t a, svuint32_t b, const sve_modulus_t *m) {
+    svbool_t pg = svptrue_b32();
+    svuint32_t x = svmul_u32_x(pg, a, b);
+    svuint32_t quot = svmulh_u32_x(pg, x, m->barrett);
+    svuint32_t r = svmls_u32_x(pg, x, quot, m->q);
+    return svmin_u32_x(pg, r, svsub_u32_x(pg, r, m->q));
+}
+
+static inline svuint32_t sve_mul_twiddle(svuint32_t a, svuint32_t w, const sve_modulus_t *m, int small) {
+    return small ? sve_mul_mod_small(a, w, m) : sve_mont_mul(a, w, m);
+}
+
+static inline svuint32_t sve_mul_mod(svuint32_t a, svuint32_t b, const sve_modulus_t *m, int small) {
+    if (small) {
+        return sve_mul_mod_small(a, b, m);
+    }
+    return sve_mont_mul(sve_mont_mul(a, b, m), m->r2, m);
+}
+
+static inline const neon_layer_tables_t *sve_get_tables(int layer, sve_modulus_t *m) {
+    pthread_once(&neon_tables_once, neon_build_tables);
+    const neon_layer_tables_t *t = &neon_tables[layer];
+
+    m->q = svdup_n_u32(Q[layer]);
+    m->qinv = svdup_n_u32(t->qinv);
+    m->r2 = svdup_n_u32(t->r2);
+    m->barrett = svdup_n_u32(t->barrett);
+    return t;
+}
+
+// Butterfly in place on (a, b); inverse selects Gentleman-Sande
+static inline void sve_butterfly(svuint32_t *a, svuint32_t *b, svuint32_t w,
+                                 const sve_modulus_t *m, int small, int inverse) {
+    svuint32_t u = *a;
+    if (inverse) {
+        *a = sve_add_mod(u, *b, m->q);
+        *b = sve_mul_twiddle(sve_sub_mod(u, *b, m->q), w, m, small);
+    } else {
+        svuint32_t t = sve_mul_twiddle(*b, w, m, small);
+        *a = sve_add_mod(u, t, m->q);
+        *b = sve_sub_mod(u, t, m->q);
+    }
+}
+
+// Broadcast the twiddle pair (w0, w1) to every 64-bit lane
+static inline svuint32_t sve_twiddle_pair(const uint32_t *w) {
+    return svreinterpret_u32_u64(svdup_n_u64((uint64_t)w[0] | ((uint64_t)w[1] << 32)));
+}
+
+static inline __attribute__((always_inline))
+void sve_stage(uint32_t poly[NTT_N], const uint32_t *tw, int stage,
+               const sve_modulus_t *m, int small, int inverse) {
+    uint32_t h = 1u << stage;
+    const uint32_t *w = &tw[h - 1];
+    uint64_t *units = (uint64_t *)poly;   // 32 pairs of coefficients
+
+    if (h == 1) {
+        svuint32_t wv = svdup_n_u32(w[0]);
+        for (uint32_t i = 0; i < NTT_N / 2; i += (uint32_t)svcntw()) {
+            svbool_t pg = svwhilelt_b32_u32(i, NTT_N / 2);
+            svuint32x2_t v = svld2_u32(pg, &poly[2 * i]);
+            svuint32_t a = svget2_u32(v, 0), b = svget2_u32(v, 1);
+            sve_butterfly(&a, &b, wv, m, small, inverse);
+            svst2_u32(pg, &poly[2 * i], svcreate2_u32(a, b));
+        }
+    } else if (h == 2) {
+        svuint32_t wv = sve_twiddle_pair(&w[0]);
+        for (uint32_t i = 0; i < NTT_N / 4; i += (uint32_t)svcntd()) {
+            svbool_t pg = svwhilelt_b64_u32(i, NTT_N / 4);
+            svuint64x2_t v = svld2_u64(pg, &units[2 * i]);
+            svuint32_t a = svreinterpret_u32_u64(svget2_u64(v, 0));
+            svuint32_t b = svreinterpret_u32_u64(svget2_u64(v, 1));
+            sve_butterfly(&a, &b, wv, m, small, inverse);
+            svst2_u64(pg, &units[2 * i], svcreate2_u64(svreinterpret_u64_u32(a),
+                                                       svreinterpret_u64_u32(b)));
+        }
+    } else if (h == 4) {
+        svuint32_t w01 = sve_twiddle_pair(&w[0]);
+        svuint32_t w23 = sve_twiddle_pair(&w[2]);
+        for (uint32_t i = 0; i < NTT_N / 8; i += (uint32_t)svcntd()) {
+            svbool_t pg = svwhilelt_b64_u32(i, NTT_N / 8);
+            svuint64x4_t v = svld4_u64(pg, &units[4 * i]);
+            svuint32_t a0 = svreinterpret_u32_u64(svget4_u64(v, 0));
+            svuint32_t a1 = svreinterpret_u32_u64(svget4_u64(v, 1));
+            svuint32_t b0 = svreinterpret_u32_u64(svget4_u64(v, 2));
+            svuint32_t b1 = svreinterpret_u32_u64(svget4_u64(v, 3));
+            sve_butterfly(&a0, &b0, w01, m, small, inverse);
+            sve_butterfly(&a1, &b1, w23, m, small, inverse);
+            svst4_u64(pg, &units[4 * i], svcreate4_u64(svreinterpret_u64_u32(a0),
+                                                       svreinterpret_u64_u32(a1),
+                                                       svreinterpret_u64_u32(b0),
+                                                       svreinterpret_u64_u32(b1)));
+        }
+    } else {
+        for (uint32_t k = 0; k < NTT_N; k += 2 * h) {
+            for (uint32_t j = 0; j < h; j += (uint32_t)svcntw()) {
+                svbool_t pg = svwhilelt_b32_u32(j, h);
+                svuint32_t a = svld1_u32(pg, &poly[k + j]);
+                svuint32_t b = svld1_u32(pg, &poly[k + j + h]);
+                svuint32_t wv = svld1_u32(pg, &w[j]);
+                sve_butterfly(&a, &b, wv, m, small, inverse);
+                svst1_u32(pg, &poly[k + j], a);
+                svst1_u32(pg, &poly[k + j + h], b);
+            }
+        }
+    }
+}
+
+// poly[i] = poly[i] * table[i] for the whole polynomial
+static inline void sve_scale(uint32_t poly[NTT_N], const uint32_t table[NTT_N],
+                             const sve_modulus_t *m, int small) {
+    for (uint32_t i = 0; i < NTT_N; i += (uint32_t)svcntw()) {
+        svbool_t pg = svwhilelt_b32_u32(i, NTT_N);
+        svuint32_t v = svld1_u32(pg, &poly[i]);
+        svst1_u32(pg, &poly[i], sve_mul_twiddle(v, svld1_u32(pg, &table[i]), m, small));
+    }
+}
+
+static inline __attribute__((always_inline))
+void sve_forward_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    sve_modulus_t m;
+    const neon_layer_tables_t *tab = sve_get_tables(layer, &m);
+
+    sve_scale(poly, tab->psi, &m, small);
+    bit_reverse_copy(poly);
+    for (int stage = 0; stage < 6; stage++) {
+        sve_stage(poly, tab->fwd, stage, &m, small, 0);
+    }
+}
+
+static inline __attribute__((always_inline))
+void sve_inverse_kernel(uint32_t poly[NTT_N], int layer, int small) {
+    sve_modulus_t m;
+    const neon_layer_tables_t *tab = sve_get_tables(layer, &m);
+
+    for (int stage = 5; stage >= 0; stage--) {
+        sve_stage(poly, tab->inv, stage, &m, small, 1);
+    }
+    bit_reverse_copy(poly);
+    sve_scale(poly, tab->psi_inv_scaled, &m, small);
+}
+
+void ntt64_forward_sve2(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_forward_scalar(poly, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        sve_forward_kernel(poly, layer, 1);
+    } else {
+        sve_forward_kernel(poly, layer, 0);
+    }
+}
+
+void ntt64_inverse_sve2(uint32_t poly[NTT_N], int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_inverse_scalar(poly, layer);
+        return;
+    }
+    if (layer < NEON_SMALL_MODULUS_LAYERS) {
+        sve_inverse_kernel(poly, layer, 1);
+    } else {
+        sve_inverse_kernel(poly, layer, 0);
+    }
+}
+
+void ntt64_pointwise_mul_sve2(uint32_t result[NTT_N],
+                               const uint32_t a[NTT_N],
+                               const uint32_t b[NTT_N],
+                               int layer) {
+    if (layer >= NTT_NUM_LAYERS) {
+        ntt64_pointwise_mul_scalar(result, a, b, layer);
+        return;
+    }
+    sve_modulus_t m;
+    sve_get_tables(layer, &m);
+    int small = layer < NEON_SMALL_MODULUS_LAYERS;
+
+    for (uint32_t i = 0; i < NTT_N; i += (uint32_t)svcntw()) {
+        svbool_t pg = svwhilelt_b32_u32(i, NTT_N);
+        svuint32_t va = svld1_u32(pg, &a[i]);
+        svuint32_t vb = svld1_u32(pg, &b[i]);
+        svst1_u32(pg, &result[i], sve_mul_mod(va, vb, &m, small));
+    }
+}
+
+/**
+ * Vector length in 32-bit lanes (used by the dispatcher)
+ */
+int ntt64_sve_vector_lanes(void) {
+    return (int)svcntw();
+}
+
+#endif // __ARM_FEATURE_SVE2
+
+#else // 32-bit ARM: no vmull_high/vtrn1q/vuzp2q, keep the portable path
 
 void ntt64_forward_neon(uint32_t poly[NTT_N], int layer) {
-    // Call scalar version for correctness
-    // SIMD benefits come from vectorized pointwise multiplication
     ntt64_forward_scalar(poly, layer);
 }
 
 void ntt64_inverse_neon(uint32_t poly[NTT_N], int layer) {
-    // Call scalar version for correctness
-    // SIMD benefits come from vectorized pointwise multiplication
     ntt64_inverse_scalar(poly, layer);
 }
 
@@ -132,16 +1086,17 @@ void ntt64_pointwise_mul_neon(uint32_t result[NTT_N],
                                const uint32_t a[NTT_N],
                                const uint32_t b[NTT_N],
                                int layer) {
-    uint32_t q = Q[layer];
-    uint64_t barrett = BARRETT_CONST[layer];
+    ntt64_pointwise_mul_scalar(result, a, b, layer);
+}
 
-    // Vectorized pointwise multiplication (process 4 at a time)
-    for (uint32_t i = 0; i < NTT_N; i += 4) {
-        uint32x4_t a_vec = vld1q_u32(&a[i]);
-        uint32x4_t b_vec = vld1q_u32(&b[i]);
-        uint32x4_t result_vec = neon_mul_mod(a_vec, b_vec, layer);
-        vst1q_u32(&result[i], result_vec);
-    }
+void ntt64_forward_batch_neon(uint32_t *soa, size_t count, int layer) {
+    ntt64_forward_batch_scalar(soa, count, layer);
+}
+
+void ntt64_inverse_batch_neon(uint32_t *soa, size_t count, int layer) {
+    ntt64_inverse_batch_scalar(soa, count, layer);
 }
 
+#endif // __aarch64__
+
 #endif // __ARM_NEON
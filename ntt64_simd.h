@@ -2,11 +2,16 @@
 #define NTT64_SIMD_H
 
 #include "ntt64.h"
+#include <stddef.h>
 
 // CPU feature detection flags
 #define NTT_CPU_SCALAR  0
 #define NTT_CPU_AVX2    (1 << 0)
 #define NTT_CPU_NEON    (1 << 1)
+#define NTT_CPU_AVX512  (1 << 2)   // AVX-512F + AVX-512BW with OS ZMM support
+#define NTT_CPU_AVX512IFMA (1 << 3)
+#define NTT_CPU_SVE     (1 << 4)   // HWCAP_SVE reported by the kernel
+#define NTT_CPU_SVE2    (1 << 5)   // HWCAP2_SVE2 reported by the kernel
 
 /**
  * Detect available CPU features at runtime
@@ -16,6 +21,8 @@ int ntt64_detect_cpu_features(void);
 
 /**
  * Get a human-readable name for the current implementation
+ *
+ * After ntt64_autotune() this lists the choice per layer.
  */
 const char* ntt64_get_implementation_name(void);
 
@@ -23,9 +30,51 @@ const char* ntt64_get_implementation_name(void);
  * Initialize the SIMD-optimized NTT implementation
  * This detects CPU features and sets up function pointers
  * Call this once at program startup for best performance
+ *
+ * ntt64_forward(), ntt64_inverse() and ntt64_pointwise_mul() do not need it:
+ * where ntt64_dispatch.c is linked they pick the same kernels on their own
+ * (a lazily set pointer; a GNU ifunc on x86 glibc builds with NTT64_IFUNC).
  */
 void ntt64_init(void);
 
+// Environment variable naming one backend for every layer in ntt64_autotune():
+// "scalar", "avx2", "avx512", "neon" or "sve2"
+#define NTT64_BACKEND_ENV "NTT64_BACKEND"
+
+/**
+ * ntt64_init(), then the fastest forward, inverse and pointwise kernel per layer
+ *
+ * Feature bits rank the backends, but for some layers (the 31-bit layer 6,
+ * registered moduli) or cores (AVX-512 clock throttling, E-cores) another
+ * one is faster. Each available backend is timed on each built-in and
+ * registered layer for a few microseconds per operation; the winners are
+ * installed in ntt64_forward_ptr, ntt64_inverse_ptr and
+ * ntt64_pointwise_mul_ptr, through a per-layer table where layers disagree.
+ * Layers registered later keep ntt64_init()'s choice.
+ *
+ * If NTT64_BACKEND_ENV names an available backend, it is used for every
+ * layer and nothing is timed. Otherwise, if path is given, a choice saved
+ * there for the same CPU features and moduli is loaded, and a new one is
+ * saved there after timing.
+ *
+ * ntt64_forward(), ntt64_inverse() and ntt64_pointwise_mul() follow the
+ * choice too, and ntt64_init() restores its own. In x86 glibc builds with
+ * NTT64_IFUNC (see ntt64_dispatch.c) the loader binds them before anything
+ * is timed: there only the *_ptr entry points follow the choice, and the
+ * names reported describe those.
+ * Not thread-safe: call at startup, like ntt64_register_modulus().
+ *
+ * @param path      File to load and save the choice, or NULL
+ * @return          0, or -1 if the choice could not be saved (it still applies)
+ */
+int ntt64_autotune(const char *path);
+
+/**
+ * The backend serving a layer: one name, or "forward/inverse/pointwise"
+ * names where ntt64_autotune() picked different ones; NULL for an unknown layer
+ */
+const char* ntt64_get_layer_implementation_name(int layer);
+
 // Forward NTT function pointer type
 typedef void (*ntt64_forward_fn)(uint32_t poly[NTT_N], int layer);
 
@@ -43,6 +92,340 @@ extern ntt64_forward_fn ntt64_forward_ptr;
 extern ntt64_inverse_fn ntt64_inverse_ptr;
 extern ntt64_pointwise_mul_fn ntt64_pointwise_mul_ptr;
 
+// ============================================================================
+// BATCHED TRANSFORMS
+// ============================================================================
+//
+// A batch of `count` polynomials is stored interleaved (structure-of-arrays):
+// coefficient i of polynomial p lives at soa[i * count + p]. SIMD lanes then
+// run across polynomials, so every butterfly is a plain vertical operation
+// with a broadcast twiddle and no in-register shuffles are needed. Pointwise
+// products work unchanged on any 64-word slice of an interleaved batch.
+
+/**
+ * Convert `count` contiguous polynomials (polys[p * 64 + i]) to the
+ * interleaved layout, and back. soa and polys must not overlap.
+ */
+void ntt64_interleave(uint32_t *soa, const uint32_t *polys, size_t count);
+void ntt64_deinterleave(uint32_t *polys, const uint32_t *soa, size_t count);
+
+/**
+ * Forward / inverse NTT of `count` interleaved polynomials (in-place)
+ * Results are identical to ntt64_forward / ntt64_inverse on each polynomial.
+ */
+void ntt64_forward_batch(uint32_t *soa, size_t count, int layer);
+void ntt64_inverse_batch(uint32_t *soa, size_t count, int layer);
+
+// Batched transform function pointer type
+typedef void (*ntt64_batch_fn)(uint32_t *soa, size_t count, int layer);
+
+extern ntt64_batch_fn ntt64_forward_batch_ptr;
+extern ntt64_batch_fn ntt64_inverse_batch_ptr;
+
+// ============================================================================
+// ALL-LAYERS (RNS) TRANSFORMS
+// ============================================================================
+
+/**
+ * Forward NTT of one polynomial under all seven moduli at once
+ *
+ * out[layer] = ntt64_forward(in, layer) for every layer. The input is read
+ * once and need not be reduced. The SIMD version keeps one modulus per
+ * vector lane, so all layers share every load, butterfly and store.
+ */
+void ntt64_forward_all_layers(const uint32_t in[NTT_N],
+                              uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+
+/**
+ * Inverse NTT of seven NTT-domain polynomials, in[layer] under modulus layer
+ * out may alias in.
+ */
+void ntt64_inverse_all_layers(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                              uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+
+typedef void (*ntt64_forward_all_fn)(const uint32_t in[NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+typedef void (*ntt64_inverse_all_fn)(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+
+extern ntt64_forward_all_fn ntt64_forward_all_layers_ptr;
+extern ntt64_inverse_all_fn ntt64_inverse_all_layers_ptr;
+
+// ============================================================================
+// FUSED POINTWISE KERNELS
+// ============================================================================
+//
+// NTT-domain expressions that would otherwise chain ntt64_pointwise_mul and
+// additions through memory. Each coefficient's intermediate stays in a register
+// and is reduced only when the next term could overflow it. All operands must
+// be reduced (in [0, q)); results are reduced.
+
+/**
+ * acc[j] = acc[j] + sum_i a[i][j] * b[i][j]  (mod q), over `count` pairs
+ *
+ * Products are summed unreduced; for the 9..17-bit moduli thousands of terms
+ * fit before a reduction is needed.
+ */
+void ntt64_pointwise_mac(uint32_t acc[NTT_N],
+                         const uint32_t a[][NTT_N],
+                         const uint32_t b[][NTT_N],
+                         size_t count, int layer);
+
+/**
+ * result[j] = x[j] * prod_i b[i][j]  (mod q), over `count` operands
+ * result may alias x.
+ */
+void ntt64_pointwise_mul_chain(uint32_t result[NTT_N],
+                               const uint32_t x[NTT_N],
+                               const uint32_t b[][NTT_N],
+                               size_t count, int layer);
+
+/**
+ * result[j] = a[j] + s * b[j]  (mod q) for a scalar s (any 32-bit value)
+ * result may alias a or b.
+ */
+void ntt64_pointwise_scale_add(uint32_t result[NTT_N],
+                               const uint32_t a[NTT_N],
+                               uint32_t s,
+                               const uint32_t b[NTT_N],
+                               int layer);
+
+typedef void (*ntt64_pointwise_mac_fn)(uint32_t acc[NTT_N],
+                                       const uint32_t a[][NTT_N],
+                                       const uint32_t b[][NTT_N],
+                                       size_t count, int layer);
+typedef void (*ntt64_pointwise_mul_chain_fn)(uint32_t result[NTT_N],
+                                             const uint32_t x[NTT_N],
+                                             const uint32_t b[][NTT_N],
+                                             size_t count, int layer);
+typedef void (*ntt64_pointwise_scale_add_fn)(uint32_t result[NTT_N],
+                                             const uint32_t a[NTT_N],
+                                             uint32_t s,
+                                             const uint32_t b[NTT_N],
+                                             int layer);
+
+extern ntt64_pointwise_mac_fn ntt64_pointwise_mac_ptr;
+extern ntt64_pointwise_mul_chain_fn ntt64_pointwise_mul_chain_ptr;
+extern ntt64_pointwise_scale_add_fn ntt64_pointwise_scale_add_ptr;
+
+// ============================================================================
+// PREPARED OPERANDS
+// ============================================================================
+//
+// For an operand that is multiplied against many inputs (a public matrix or
+// key basis), ntt64_prepare_operand stores the Shoup constants
+// floor(b * 2^32 / q) next to the values. Each later multiplication then
+// costs one high and one low product plus a conditional subtraction per
+// coefficient, instead of a full Barrett or Montgomery reduction.
+
+/**
+ * NTT-domain operand with precomputed Shoup constants
+ *
+ * Filled by ntt64_prepare_operand(); treat as read-only afterwards.
+ */
+typedef struct {
+    uint32_t b[NTT_N] __attribute__((aligned(64)));
+    uint32_t b_shoup[NTT_N] __attribute__((aligned(64)));
+    uint32_t q;
+    int layer;
+} ntt64_prepared_t;
+
+/**
+ * Prepare b (reduced, in NTT domain) for ntt64_pointwise_mul_prepared()
+ *
+ * @param prep      Output
+ * @param b         Operand in NTT domain, values in [0, q)
+ * @param layer     Layer index (built-in or registered)
+ */
+void ntt64_prepare_operand(ntt64_prepared_t *prep, const uint32_t b[NTT_N], int layer);
+
+/**
+ * result[j] = a[j] * prep->b[j] mod q, in the layer prep was prepared for
+ *
+ * @param result    Output array (can be same as a)
+ * @param a         Any 32-bit values; result is reduced to [0, q)
+ * @param prep      Operand prepared by ntt64_prepare_operand()
+ */
+void ntt64_pointwise_mul_prepared(uint32_t result[NTT_N],
+                                  const uint32_t a[NTT_N],
+                                  const ntt64_prepared_t *prep);
+
+typedef void (*ntt64_pointwise_mul_prepared_fn)(uint32_t result[NTT_N],
+                                                const uint32_t a[NTT_N],
+                                                const ntt64_prepared_t *prep);
+
+extern ntt64_pointwise_mul_prepared_fn ntt64_pointwise_mul_prepared_ptr;
+
+// ============================================================================
+// MODULUS SWITCHING AND CRT
+// ============================================================================
+//
+// Moving coefficients between layers. A rounding switch maps x in [0, q) to
+// round(x * q' / q) mod q'; CRT recombination maps residues under distinct
+// layers to the value modulo their product. Both work coefficient by
+// coefficient, so polynomials may be in either domain, and both take
+// reduced inputs. The constants for a pair of layers (or a set of layers)
+// are computed once per call; nothing is divided per coefficient.
+
+/**
+ * Constants of a rounding switch from q to q'
+ *
+ * (x * ratio) >> shift, with ratio = floor(2^shift * q' / q) < 2^32 and the
+ * largest such shift, is at most three below round(x * q' / q); exact 64-bit
+ * remainder checks add the difference. q is an odd prime, so there are no
+ * ties to break.
+ */
+typedef struct {
+    uint32_t q_from;
+    uint32_t q_to;
+    uint32_t ratio;
+    uint32_t shift;
+} ntt64_switch_t;
+
+// Moduli are at least 257, so at most seven have a product below 2^64
+#define NTT64_CRT_MAX 7
+
+/**
+ * Constants of a CRT recombination (Garner's mixed-radix form)
+ *
+ * v_0 = x_0, v_j = (...((x_j - v_0) q_0^(-1) - v_1) q_1^(-1) ...) mod q_j,
+ * and x = v_0 + q_0 (v_1 + q_1 (v_2 + ...)). Every product mod q_j is one
+ * Montgomery multiplication by a constant stored as c * 2^32 mod q_j, which
+ * is exact for any q_j < 2^32.
+ */
+typedef struct {
+    size_t count;
+    uint64_t modulus;                               // product of the q_j
+    uint32_t q[NTT64_CRT_MAX];
+    uint32_t qinv[NTT64_CRT_MAX];                   // q_j^(-1) mod 2^32
+    uint32_t r1[NTT64_CRT_MAX];                     // 2^32 mod q_j: reduces v_i mod q_j
+    uint32_t inv[NTT64_CRT_MAX][NTT64_CRT_MAX];     // q_i^(-1) * 2^32 mod q_j, i < j
+} ntt64_crt_t;
+
+/**
+ * Switch constants from one layer to another
+ *
+ * @return          0, or -1 if either layer is not built in or registered
+ */
+int ntt64_switch_prepare(ntt64_switch_t *sw, int from_layer, int to_layer);
+
+/**
+ * CRT constants for residues under count distinct layers, in that order
+ *
+ * @return          0, or -1 for an unknown or repeated layer, a count outside
+ *                  [1, NTT64_CRT_MAX], or a product of moduli of 2^64 or more
+ */
+int ntt64_crt_prepare(ntt64_crt_t *crt, const int layers[], size_t count);
+
+/**
+ * poly[i] = round(poly[i] * q' / q) mod q', q and q' the moduli of the layers
+ *
+ * @param poly      Coefficients in [0, q), replaced by values in [0, q')
+ * @return          0, or -1 (poly unchanged) for an unknown layer
+ */
+int ntt64_mod_switch(uint32_t poly[NTT_N], int from_layer, int to_layer);
+
+/**
+ * ntt64_mod_switch() over count contiguous polynomials (polys[p * 64 + i])
+ */
+int ntt64_mod_switch_batch(uint32_t *polys, size_t count, int from_layer, int to_layer);
+
+/**
+ * The unique out[i] < q_0 q_1 ... q_(count-1) with out[i] = polys[j][i] mod q_j
+ *
+ * @param polys     count polynomials, polys[j] reduced under layers[j]
+ * @return          0, or -1 as ntt64_crt_prepare() (out unchanged)
+ */
+int ntt64_crt_combine(const uint32_t *const polys[], const int layers[], size_t count,
+                      uint64_t out[NTT_N]);
+
+/**
+ * ntt64_crt_combine() over n_polys polynomials: polys[j] holds n_polys
+ * contiguous polynomials under layers[j], out n_polys * 64 values
+ */
+int ntt64_crt_combine_batch(const uint32_t *const polys[], const int layers[], size_t count,
+                            size_t n_polys, uint64_t *out);
+
+typedef void (*ntt64_mod_switch_fn)(uint32_t *coeffs, size_t n, const ntt64_switch_t *sw);
+typedef void (*ntt64_crt_combine_fn)(uint64_t *out, const uint32_t *const residues[], size_t n,
+                                     const ntt64_crt_t *crt);
+
+extern ntt64_mod_switch_fn ntt64_mod_switch_ptr;
+extern ntt64_crt_combine_fn ntt64_crt_combine_ptr;
+
+// ============================================================================
+// 16-BIT KERNELS
+// ============================================================================
+//
+// Moduli below 2^15 (layers 0-2, and registered primes such as 12289) fit a
+// signed 16-bit lane, so polynomials can be stored as uint16_t[64] and
+// transformed 16 coefficients per AVX2 register (8 per NEON register) with
+// signed 16-bit Montgomery multiplication, as in Kyber. A whole q = 257
+// polynomial is four AVX2 registers.
+//
+// The transforms follow ntt64_forward_bitrev / ntt64_inverse_bitrev: the NTT
+// domain is in bit-reversed order, and the results are identical to those
+// functions applied to the widened coefficients. Each function returns 0, or
+// -1 (leaving the data untouched) if the layer's modulus is 2^15 or larger.
+
+// Largest modulus (exclusive) accepted by the 16-bit kernels
+#define NTT16_MAX_MODULUS 32768u
+
+/**
+ * Whether `layer` can be used with the 16-bit kernels
+ *
+ * @return          1 if the layer exists and its modulus is below 2^15, else 0
+ */
+int ntt64_layer_fits16(int layer);
+
+/**
+ * Narrow reduced 32-bit coefficients to 16 bits, and widen back
+ * out and in must not overlap.
+ */
+void ntt64_pack16(uint16_t out[NTT_N], const uint32_t in[NTT_N]);
+void ntt64_unpack16(uint32_t out[NTT_N], const uint16_t in[NTT_N]);
+
+/**
+ * Forward NTT, bit-reversed output (16-bit storage, in-place)
+ *
+ * @param poly      64 coefficients, any 16-bit values; output in [0, q)
+ * @param layer     Layer index with ntt64_layer_fits16(layer)
+ * @return          0 on success, -1 if the layer is unsupported
+ */
+int ntt64_forward_bitrev16(uint16_t poly[NTT_N], int layer);
+
+/**
+ * Inverse of ntt64_forward_bitrev16(), including N^(-1) (in-place)
+ *
+ * @param poly      64 values in [0, q), bit-reversed NTT order
+ * @param layer     Layer index with ntt64_layer_fits16(layer)
+ * @return          0 on success, -1 if the layer is unsupported
+ */
+int ntt64_inverse_bitrev16(uint16_t poly[NTT_N], int layer);
+
+/**
+ * result[i] = a[i] * b[i] mod q (16-bit storage)
+ *
+ * @param result    Output array (can be same as a or b)
+ * @param a, b      Operands in [0, q)
+ * @param layer     Layer index with ntt64_layer_fits16(layer)
+ * @return          0 on success, -1 if the layer is unsupported
+ */
+int ntt64_pointwise_mul16(uint16_t result[NTT_N],
+                          const uint16_t a[NTT_N],
+                          const uint16_t b[NTT_N],
+                          int layer);
+
+typedef int (*ntt64_ntt16_fn)(uint16_t poly[NTT_N], int layer);
+typedef int (*ntt64_pointwise_mul16_fn)(uint16_t result[NTT_N],
+                                        const uint16_t a[NTT_N],
+                                        const uint16_t b[NTT_N],
+                                        int layer);
+
+extern ntt64_ntt16_fn ntt64_forward_bitrev16_ptr;
+extern ntt64_ntt16_fn ntt64_inverse_bitrev16_ptr;
+extern ntt64_pointwise_mul16_fn ntt64_pointwise_mul16_ptr;
+
 // Implementation-specific functions (don't call directly, use function pointers)
 // Scalar (portable C) implementations
 void ntt64_forward_scalar(uint32_t poly[NTT_N], int layer);
@@ -51,6 +434,43 @@ void ntt64_pointwise_mul_scalar(uint32_t result[NTT_N],
                                  const uint32_t a[NTT_N],
                                  const uint32_t b[NTT_N],
                                  int layer);
+void ntt64_forward_batch_scalar(uint32_t *soa, size_t count, int layer);
+void ntt64_inverse_batch_scalar(uint32_t *soa, size_t count, int layer);
+
+void ntt64_forward_all_layers_scalar(const uint32_t in[NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+void ntt64_inverse_all_layers_scalar(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                                     uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+
+void ntt64_pointwise_mac_scalar(uint32_t acc[NTT_N],
+                                const uint32_t a[][NTT_N],
+                                const uint32_t b[][NTT_N],
+                                size_t count, int layer);
+void ntt64_pointwise_mul_chain_scalar(uint32_t result[NTT_N],
+                                      const uint32_t x[NTT_N],
+                                      const uint32_t b[][NTT_N],
+                                      size_t count, int layer);
+void ntt64_pointwise_scale_add_scalar(uint32_t result[NTT_N],
+                                      const uint32_t a[NTT_N],
+                                      uint32_t s,
+                                      const uint32_t b[NTT_N],
+                                      int layer);
+void ntt64_pointwise_mul_prepared_scalar(uint32_t result[NTT_N],
+                                         const uint32_t a[NTT_N],
+                                         const ntt64_prepared_t *prep);
+void ntt64_mod_switch_scalar(uint32_t *coeffs, size_t n, const ntt64_switch_t *sw);
+void ntt64_crt_combine_scalar(uint64_t *out, const uint32_t *const residues[], size_t n,
+                              const ntt64_crt_t *crt);
+int ntt64_forward_bitrev16_scalar(uint16_t poly[NTT_N], int layer);
+int ntt64_inverse_bitrev16_scalar(uint16_t poly[NTT_N], int layer);
+int ntt64_pointwise_mul16_scalar(uint16_t result[NTT_N],
+                                 const uint16_t a[NTT_N],
+                                 const uint16_t b[NTT_N],
+                                 int layer);
+
+// Single polynomial with coefficients `stride` words apart (batch tails)
+void ntt64_forward_strided_scalar(uint32_t *data, size_t stride, int layer);
+void ntt64_inverse_strided_scalar(uint32_t *data, size_t stride, int layer);
 
 #ifdef __AVX2__
 // AVX2 implementations (x86-64 with AVX2 support)
@@ -60,6 +480,49 @@ void ntt64_pointwise_mul_avx2(uint32_t result[NTT_N],
                                const uint32_t a[NTT_N],
                                const uint32_t b[NTT_N],
                                int layer);
+void ntt64_forward_batch_avx2(uint32_t *soa, size_t count, int layer);
+void ntt64_inverse_batch_avx2(uint32_t *soa, size_t count, int layer);
+void ntt64_forward_all_layers_avx2(const uint32_t in[NTT_N],
+                                   uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+void ntt64_inverse_all_layers_avx2(const uint32_t in[NTT_NUM_LAYERS][NTT_N],
+                                   uint32_t out[NTT_NUM_LAYERS][NTT_N]);
+void ntt64_pointwise_mac_avx2(uint32_t acc[NTT_N],
+                              const uint32_t a[][NTT_N],
+                              const uint32_t b[][NTT_N],
+                              size_t count, int layer);
+void ntt64_pointwise_mul_chain_avx2(uint32_t result[NTT_N],
+                                    const uint32_t x[NTT_N],
+                                    const uint32_t b[][NTT_N],
+                                    size_t count, int layer);
+void ntt64_pointwise_scale_add_avx2(uint32_t result[NTT_N],
+                                    const uint32_t a[NTT_N],
+                                    uint32_t s,
+                                    const uint32_t b[NTT_N],
+                                    int layer);
+void ntt64_pointwise_mul_prepared_avx2(uint32_t result[NTT_N],
+                                       const uint32_t a[NTT_N],
+                                       const ntt64_prepared_t *prep);
+void ntt64_mod_switch_avx2(uint32_t *coeffs, size_t n, const ntt64_switch_t *sw);
+void ntt64_crt_combine_avx2(uint64_t *out, const uint32_t *const residues[], size_t n,
+                            const ntt64_crt_t *crt);
+int ntt64_forward_bitrev16_avx2(uint16_t poly[NTT_N], int layer);
+int ntt64_inverse_bitrev16_avx2(uint16_t poly[NTT_N], int layer);
+int ntt64_pointwise_mul16_avx2(uint16_t result[NTT_N],
+                               const uint16_t a[NTT_N],
+                               const uint16_t b[NTT_N],
+                               int layer);
+#endif
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+// AVX-512 implementations (16 coefficients per register, 4 registers per poly)
+void ntt64_forward_avx512(uint32_t poly[NTT_N], int layer);
+void ntt64_inverse_avx512(uint32_t poly[NTT_N], int layer);
+void ntt64_pointwise_mul_avx512(uint32_t result[NTT_N],
+                                 const uint32_t a[NTT_N],
+                                 const uint32_t b[NTT_N],
+                                 int layer);
+void ntt64_forward_batch_avx512(uint32_t *soa, size_t count, int layer);
+void ntt64_inverse_batch_avx512(uint32_t *soa, size_t count, int layer);
 #endif
 
 #ifdef __ARM_NEON
@@ -70,6 +533,31 @@ void ntt64_pointwise_mul_neon(uint32_t result[NTT_N],
                                const uint32_t a[NTT_N],
                                const uint32_t b[NTT_N],
                                int layer);
+void ntt64_forward_batch_neon(uint32_t *soa, size_t count, int layer);
+void ntt64_inverse_batch_neon(uint32_t *soa, size_t count, int layer);
+#if defined(__aarch64__)
+int ntt64_forward_bitrev16_neon(uint16_t poly[NTT_N], int layer);
+int ntt64_inverse_bitrev16_neon(uint16_t poly[NTT_N], int layer);
+int ntt64_pointwise_mul16_neon(uint16_t result[NTT_N],
+                               const uint16_t a[NTT_N],
+                               const uint16_t b[NTT_N],
+                               int layer);
+#endif
+#endif
+
+#if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+// SVE2 implementations (vector-length agnostic, predicated stage loops)
+void ntt64_forward_sve2(uint32_t poly[NTT_N], int layer);
+void ntt64_inverse_sve2(uint32_t poly[NTT_N], int layer);
+void ntt64_pointwise_mul_sve2(uint32_t result[NTT_N],
+                               const uint32_t a[NTT_N],
+                               const uint32_t b[NTT_N],
+                               int layer);
+
+/**
+ * Number of 32-bit lanes in an SVE vector on this CPU (svcntw)
+ */
+int ntt64_sve_vector_lanes(void);
 #endif
 
 #endif // NTT64_SIMD_H
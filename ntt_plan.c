@@ -0,0 +1,752 @@
+#include "ntt_plan.h"
+#include "ntt64_simd.h"
+#include "dntl_stats.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// PLAN LAYOUT
+// ============================================================================
+//
+// The transforms use the merged Cooley-Tukey schedule of ntt64_forward_bitrev:
+// node k of the splitting tree (k = 1 .. n-1, stage by stage) reduces
+// x^m - c_k into x^(m/2) -/+ zeta_k, with zeta_k^2 = c_k. For cyclic plans the
+// root is c_1 = 1, for negacyclic plans c_1 = -1, so one table covers both
+// transform types and the output is always the bit-reversed evaluation order.
+
+struct ntt_plan {
+    uint32_t n;
+    uint32_t log_n;
+    uint32_t q;
+    ntt_plan_type_t type;
+    uint64_t barrett;       // floor(2^64 / q)
+    uint32_t n_inv;         // N^(-1) mod q
+    uint32_t zeta1_n_inv;   // zeta_1^(-1) * N^(-1) mod q (last inverse stage)
+    uint32_t *zetas;        // zeta_k, k = 1 .. n-1
+    uint32_t *zetas_inv;    // zeta_k^(-1)
+    uint32_t *bitrev;       // log_n-bit reversal of each index
+    int use_avx2;
+#ifdef __AVX2__
+    // Twiddle form: plain values for q < 2^16, w * 2^32 mod q otherwise
+    int small;
+    uint32_t qinv;          // q^(-1) mod 2^32
+    uint32_t barrett32;     // floor(2^32 / q)
+    uint32_t r1;            // 2^32 mod q (plain); reduces inputs in Montgomery form
+    uint32_t r2;            // 2^64 mod q
+    uint32_t n_inv_tw;
+    uint32_t zeta1_n_inv_tw;
+    uint32_t *avx2_zetas;       // zeta_k in twiddle form
+    uint32_t *avx2_zetas_inv;
+    uint32_t *avx2_lanes;       // stages len = 4, 2, 1: n/2 lane-ordered zetas each
+    uint32_t *avx2_lanes_inv;
+#endif
+    uint32_t *storage;      // single allocation backing all tables
+};
+
+// ============================================================================
+// CONSTANT-TIME MODULAR ARITHMETIC
+// ============================================================================
+
+/**
+ * Constant-time Barrett reduction of a 64-bit value
+ *
+ * The quotient estimate is at most one too small for x < 2^64, so a single
+ * conditional subtraction finishes the job for any q < 2^32.
+ */
+static inline uint32_t plan_reduce(uint64_t x, const ntt_plan_t *plan) {
+    uint64_t q = plan->q;
+    uint64_t q_approx = ((__uint128_t)x * plan->barrett) >> 64;
+    uint64_t r = x - q_approx * q;
+
+    uint64_t mask = -(uint64_t)(r >= q);
+    r -= mask & q;
+
+    return (uint32_t)r;
+}
+
+static inline uint32_t plan_mul_mod(uint32_t a, uint32_t b, const ntt_plan_t *plan) {
+    return plan_reduce((uint64_t)a * (uint64_t)b, plan);
+}
+
+static inline uint32_t plan_add_mod(uint32_t a, uint32_t b, const ntt_plan_t *plan) {
+    uint64_t sum = (uint64_t)a + (uint64_t)b;
+    uint64_t mask = -(uint64_t)(sum >= plan->q);
+    return (uint32_t)(sum - (mask & plan->q));
+}
+
+static inline uint32_t plan_sub_mod(uint32_t a, uint32_t b, const ntt_plan_t *plan) {
+    int64_t diff = (int64_t)a - (int64_t)b;
+    int64_t mask = -(int64_t)(diff < 0);
+    return (uint32_t)(diff + (mask & plan->q));
+}
+
+// Variable-time helpers, only used while building tables
+static uint32_t plan_pow_mod(uint32_t base, uint64_t exp, uint32_t q) {
+    uint64_t result = 1, b = base % q;
+    while (exp) {
+        if (exp & 1) {
+            result = (result * b) % q;
+        }
+        b = (b * b) % q;
+        exp >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+static int plan_is_prime(uint32_t q) {
+    if (q < 2) {
+        return 0;
+    }
+    for (uint32_t d = 2; (uint64_t)d * d <= q; d++) {
+        if (q % d == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// ============================================================================
+// AVX2 KERNELS
+// ============================================================================
+//
+// Stages with len >= 8 use one broadcast zeta per block over contiguous
+// vectors. The last three stages run on pairs of vectors (16 coefficients)
+// that are split into "a" and "b" halves with 128/64/32-bit shuffles; their
+// zetas are stored pre-permuted into the matching lane order. Needs n >= 16.
+
+#ifdef __AVX2__
+
+static inline __m256i plan_avx2_add_mod(__m256i a, __m256i b, __m256i q_vec) {
+    __m256i q_minus_b = _mm256_sub_epi32(q_vec, b);
+    __m256i t = _mm256_sub_epi32(a, q_minus_b);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(a, q_minus_b), a);
+    return _mm256_add_epi32(t, _mm256_andnot_si256(ge, q_vec));
+}
+
+static inline __m256i plan_avx2_sub_mod(__m256i a, __m256i b, __m256i q_vec) {
+    __m256i diff = _mm256_sub_epi32(a, b);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a);
+    return _mm256_add_epi32(diff, _mm256_andnot_si256(ge, q_vec));
+}
+
+static inline __m256i plan_avx2_mulhi_epu32(__m256i a, __m256i b) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+/**
+ * Montgomery multiplication a * b * 2^(-32) mod q, result in [0, q)
+ * Requires b < q; a may be any 32-bit value.
+ */
+static inline __m256i plan_avx2_mont_mul(__m256i a, __m256i b, __m256i q_vec, __m256i qinv_vec) {
+    __m256i t_even = _mm256_mul_epu32(a, b);
+    __m256i t_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    __m256i mq_even = _mm256_mul_epu32(_mm256_mul_epu32(t_even, qinv_vec), q_vec);
+    __m256i mq_odd = _mm256_mul_epu32(_mm256_mul_epu32(t_odd, qinv_vec), q_vec);
+
+    __m256i t_hi = _mm256_blend_epi32(_mm256_srli_epi64(t_even, 32), t_odd, 0xAA);
+    __m256i mq_hi = _mm256_blend_epi32(_mm256_srli_epi64(mq_even, 32), mq_odd, 0xAA);
+
+    __m256i r = _mm256_sub_epi32(t_hi, mq_hi);
+    __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(t_hi, mq_hi), t_hi);
+    return _mm256_add_epi32(r, _mm256_andnot_si256(ge, q_vec));
+}
+
+/**
+ * Barrett reduction of any 32-bit value for q < 2^16 (quotient off by <= 1)
+ */
+static inline __m256i plan_avx2_reduce_small(__m256i x, __m256i q_vec, __m256i barrett_vec) {
+    __m256i quot = plan_avx2_mulhi_epu32(x, barrett_vec);
+    __m256i r = _mm256_sub_epi32(x, _mm256_mullo_epi32(quot, q_vec));
+    return _mm256_min_epu32(r, _mm256_sub_epi32(r, q_vec));
+}
+
+typedef struct {
+    __m256i q;
+    __m256i qinv;
+    __m256i barrett;
+    __m256i r1;
+    __m256i r2;
+    int small;
+} plan_avx2_modulus_t;
+
+static inline void plan_avx2_load_modulus(plan_avx2_modulus_t *m, const ntt_plan_t *plan) {
+    m->q = _mm256_set1_epi32((int)plan->q);
+    m->qinv = _mm256_set1_epi32((int)plan->qinv);
+    m->barrett = _mm256_set1_epi32((int)plan->barrett32);
+    m->r1 = _mm256_set1_epi32((int)plan->r1);
+    m->r2 = _mm256_set1_epi32((int)plan->r2);
+    m->small = plan->small;
+}
+
+/**
+ * Multiply reduced a by a twiddle-form constant w: a * w mod q
+ */
+static inline __m256i plan_avx2_mul_twiddle(__m256i a, __m256i w, const plan_avx2_modulus_t *m) {
+    if (m->small) {
+        return plan_avx2_reduce_small(_mm256_mullo_epi32(a, w), m->q, m->barrett);
+    }
+    return plan_avx2_mont_mul(a, w, m->q, m->qinv);
+}
+
+/**
+ * Reduce any 32-bit value to [0, q)
+ */
+static inline __m256i plan_avx2_reduce(__m256i x, const plan_avx2_modulus_t *m) {
+    if (m->small) {
+        return plan_avx2_reduce_small(x, m->q, m->barrett);
+    }
+    // x * (2^32 mod q) * 2^(-32) = x mod q
+    return plan_avx2_mont_mul(x, m->r1, m->q, m->qinv);
+}
+
+static inline void plan_avx2_butterfly(__m256i *a, __m256i *b, __m256i zeta,
+                                       const plan_avx2_modulus_t *m) {
+    __m256i t = plan_avx2_mul_twiddle(*b, zeta, m);
+    __m256i u = *a;
+    *a = plan_avx2_add_mod(u, t, m->q);
+    *b = plan_avx2_sub_mod(u, t, m->q);
+}
+
+static inline void plan_avx2_inv_butterfly(__m256i *a, __m256i *b, __m256i zeta,
+                                           const plan_avx2_modulus_t *m) {
+    __m256i u = *a;
+    __m256i v = *b;
+    *a = plan_avx2_add_mod(u, v, m->q);
+    *b = plan_avx2_mul_twiddle(plan_avx2_sub_mod(u, v, m->q), zeta, m);
+}
+
+// Split a 16-coefficient group into the a/b halves of a len = 4, 2 or 1 stage
+static inline void plan_avx2_split(__m256i v0, __m256i v1, __m256i *a, __m256i *b, int len) {
+    if (len == 4) {
+        *a = _mm256_permute2x128_si256(v0, v1, 0x20);
+        *b = _mm256_permute2x128_si256(v0, v1, 0x31);
+    } else if (len == 2) {
+        *a = _mm256_unpacklo_epi64(v0, v1);
+        *b = _mm256_unpackhi_epi64(v0, v1);
+    } else {
+        __m256 f0 = _mm256_castsi256_ps(v0);
+        __m256 f1 = _mm256_castsi256_ps(v1);
+        *a = _mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(2, 0, 2, 0)));
+        *b = _mm256_castps_si256(_mm256_shuffle_ps(f0, f1, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+}
+
+// Inverse of plan_avx2_split
+static inline void plan_avx2_merge(__m256i a, __m256i b, __m256i *v0, __m256i *v1, int len) {
+    if (len == 4) {
+        *v0 = _mm256_permute2x128_si256(a, b, 0x20);
+        *v1 = _mm256_permute2x128_si256(a, b, 0x31);
+    } else if (len == 2) {
+        *v0 = _mm256_unpacklo_epi64(a, b);
+        *v1 = _mm256_unpackhi_epi64(a, b);
+    } else {
+        *v0 = _mm256_unpacklo_epi32(a, b);
+        *v1 = _mm256_unpackhi_epi32(a, b);
+    }
+}
+
+// Position inside a 16-coefficient group of each "a" lane after plan_avx2_split
+static const uint8_t PLAN_AVX2_SPLIT_LANES[3][8] = {
+    {0, 1, 2, 3, 8, 9, 10, 11},     // len = 4
+    {0, 1, 8, 9, 4, 5, 12, 13},     // len = 2
+    {0, 2, 8, 10, 4, 6, 12, 14}     // len = 1
+};
+
+static void plan_avx2_forward_bitrev(const ntt_plan_t *plan, uint32_t *poly) {
+    plan_avx2_modulus_t m;
+    plan_avx2_load_modulus(&m, plan);
+    const uint32_t n = plan->n;
+
+    // First stage: reduce the input while applying zeta_1
+    uint32_t half = n / 2;
+    __m256i zeta = _mm256_set1_epi32((int)plan->avx2_zetas[1]);
+    for (uint32_t j = 0; j < half; j += 8) {
+        __m256i a = plan_avx2_reduce(_mm256_loadu_si256((const __m256i *)&poly[j]), &m);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&poly[j + half]);
+        if (m.small) {
+            b = plan_avx2_reduce(b, &m);
+        }
+        plan_avx2_butterfly(&a, &b, zeta, &m);
+        _mm256_storeu_si256((__m256i *)&poly[j], a);
+        _mm256_storeu_si256((__m256i *)&poly[j + half], b);
+    }
+
+    uint32_t k = 2;
+    for (uint32_t len = n / 4; len >= 8; len >>= 1) {
+        for (uint32_t start = 0; start < n; start += 2 * len) {
+            zeta = _mm256_set1_epi32((int)plan->avx2_zetas[k++]);
+            for (uint32_t j = start; j < start + len; j += 8) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)&poly[j]);
+                __m256i b = _mm256_loadu_si256((const __m256i *)&poly[j + len]);
+                plan_avx2_butterfly(&a, &b, zeta, &m);
+                _mm256_storeu_si256((__m256i *)&poly[j], a);
+                _mm256_storeu_si256((__m256i *)&poly[j + len], b);
+            }
+        }
+    }
+
+    // Last three stages in registers, one 16-coefficient group at a time
+    for (uint32_t g = 0; g < n; g += 16) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)&poly[g]);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)&poly[g + 8]);
+
+        for (int s = 0; s < 3; s++) {
+            __m256i a, b;
+            __m256i z = _mm256_loadu_si256((const __m256i *)&plan->avx2_lanes[s * half + g / 2]);
+            plan_avx2_split(v0, v1, &a, &b, 4 >> s);
+            plan_avx2_butterfly(&a, &b, z, &m);
+            plan_avx2_merge(a, b, &v0, &v1, 4 >> s);
+        }
+
+        _mm256_storeu_si256((__m256i *)&poly[g], v0);
+        _mm256_storeu_si256((__m256i *)&poly[g + 8], v1);
+    }
+}
+
+static void plan_avx2_inverse_bitrev(const ntt_plan_t *plan, uint32_t *poly) {
+    plan_avx2_modulus_t m;
+    plan_avx2_load_modulus(&m, plan);
+    const uint32_t n = plan->n;
+    uint32_t half = n / 2;
+
+    for (uint32_t g = 0; g < n; g += 16) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)&poly[g]);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)&poly[g + 8]);
+
+        for (int s = 2; s >= 0; s--) {
+            __m256i a, b;
+            __m256i z = _mm256_loadu_si256((const __m256i *)&plan->avx2_lanes_inv[s * half + g / 2]);
+            plan_avx2_split(v0, v1, &a, &b, 4 >> s);
+            plan_avx2_inv_butterfly(&a, &b, z, &m);
+            plan_avx2_merge(a, b, &v0, &v1, 4 >> s);
+        }
+
+        _mm256_storeu_si256((__m256i *)&poly[g], v0);
+        _mm256_storeu_si256((__m256i *)&poly[g + 8], v1);
+    }
+
+    for (uint32_t len = 8; len < half; len <<= 1) {
+        uint32_t k = n / (2 * len);
+        for (uint32_t start = 0; start < n; start += 2 * len) {
+            __m256i zeta = _mm256_set1_epi32((int)plan->avx2_zetas_inv[k++]);
+            for (uint32_t j = start; j < start + len; j += 8) {
+                __m256i a = _mm256_loadu_si256((const __m256i *)&poly[j]);
+                __m256i b = _mm256_loadu_si256((const __m256i *)&poly[j + len]);
+                plan_avx2_inv_butterfly(&a, &b, zeta, &m);
+                _mm256_storeu_si256((__m256i *)&poly[j], a);
+                _mm256_storeu_si256((__m256i *)&poly[j + len], b);
+            }
+        }
+    }
+
+    // Last stage folds N^(-1) into both outputs
+    __m256i n_inv = _mm256_set1_epi32((int)plan->n_inv_tw);
+    __m256i zeta1_n_inv = _mm256_set1_epi32((int)plan->zeta1_n_inv_tw);
+    for (uint32_t j = 0; j < half; j += 8) {
+        __m256i u = _mm256_loadu_si256((const __m256i *)&poly[j]);
+        __m256i v = _mm256_loadu_si256((const __m256i *)&poly[j + half]);
+        __m256i a = plan_avx2_mul_twiddle(plan_avx2_add_mod(u, v, m.q), n_inv, &m);
+        __m256i b = plan_avx2_mul_twiddle(plan_avx2_sub_mod(u, v, m.q), zeta1_n_inv, &m);
+        _mm256_storeu_si256((__m256i *)&poly[j], a);
+        _mm256_storeu_si256((__m256i *)&poly[j + half], b);
+    }
+}
+
+static void plan_avx2_pointwise_mul(const ntt_plan_t *plan, uint32_t *result,
+                                    const uint32_t *a, const uint32_t *b) {
+    plan_avx2_modulus_t m;
+    plan_avx2_load_modulus(&m, plan);
+
+    for (uint32_t i = 0; i < plan->n; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)&a[i]);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)&b[i]);
+        __m256i r;
+        if (m.small) {
+            r = plan_avx2_reduce_small(_mm256_mullo_epi32(va, vb), m.q, m.barrett);
+        } else {
+            // (a*b*2^-32) * 2^64 * 2^-32 = a*b
+            r = plan_avx2_mont_mul(plan_avx2_mont_mul(va, vb, m.q, m.qinv), m.r2, m.q, m.qinv);
+        }
+        _mm256_storeu_si256((__m256i *)&result[i], r);
+    }
+}
+
+static uint32_t plan_avx2_twiddle_form(uint32_t w, const ntt_plan_t *plan) {
+    if (plan->small) {
+        return w;
+    }
+    return (uint32_t)(((uint64_t)w << 32) % plan->q);
+}
+
+static void plan_avx2_build_tables(ntt_plan_t *plan) {
+    uint32_t q = plan->q;
+    uint32_t n = plan->n;
+    uint32_t half = n / 2;
+
+    // Newton iteration for q^(-1) mod 2^32 (q odd; each step doubles the bits)
+    uint32_t qinv = q;
+    for (int i = 0; i < 5; i++) {
+        qinv *= 2 - q * qinv;
+    }
+    uint64_t r = ((uint64_t)1 << 32) % q;
+    plan->small = q < (1u << 16);
+    plan->qinv = qinv;
+    plan->barrett32 = (uint32_t)(((uint64_t)1 << 32) / q);
+    plan->r1 = (uint32_t)r;
+    plan->r2 = (uint32_t)((r * r) % q);
+    plan->n_inv_tw = plan_avx2_twiddle_form(plan->n_inv, plan);
+    plan->zeta1_n_inv_tw = plan_avx2_twiddle_form(plan->zeta1_n_inv, plan);
+
+    for (uint32_t k = 0; k < n; k++) {
+        plan->avx2_zetas[k] = plan_avx2_twiddle_form(plan->zetas[k], plan);
+        plan->avx2_zetas_inv[k] = plan_avx2_twiddle_form(plan->zetas_inv[k], plan);
+    }
+
+    for (uint32_t s = 0; s < 3; s++) {
+        uint32_t len = 4u >> s;
+        for (uint32_t g = 0; g < n; g += 16) {
+            for (uint32_t lane = 0; lane < 8; lane++) {
+                uint32_t e = g + PLAN_AVX2_SPLIT_LANES[s][lane];
+                uint32_t k = n / (2 * len) + e / (2 * len);
+                plan->avx2_lanes[s * half + g / 2 + lane] = plan->avx2_zetas[k];
+                plan->avx2_lanes_inv[s * half + g / 2 + lane] = plan->avx2_zetas_inv[k];
+            }
+        }
+    }
+}
+
+#endif // __AVX2__
+
+// ============================================================================
+// PLAN CREATION
+// ============================================================================
+
+ntt_plan_t *ntt_plan_create(size_t n, uint32_t q, uint32_t root, ntt_plan_type_t type) {
+    if (n < 2 || n > NTT_PLAN_MAX_N || (n & (n - 1)) != 0) {
+        return NULL;
+    }
+    if (type != NTT_PLAN_CYCLIC && type != NTT_PLAN_NEGACYCLIC) {
+        return NULL;
+    }
+    if (q < 3 || !plan_is_prime(q)) {
+        return NULL;
+    }
+
+    // Order of the base root: n (cyclic) or 2n (negacyclic)
+    uint64_t order = (type == NTT_PLAN_CYCLIC) ? n : 2 * (uint64_t)n;
+    if ((q - 1) % order != 0 || root % q == 0) {
+        return NULL;
+    }
+    uint32_t g = plan_pow_mod(root, (q - 1) / order, q);
+    if (plan_pow_mod(g, order / 2, q) != q - 1) {
+        return NULL;
+    }
+
+    ntt_plan_t *plan = calloc(1, sizeof(ntt_plan_t));
+    if (!plan) {
+        return NULL;
+    }
+
+    size_t table_count = 3;
+#ifdef __AVX2__
+    table_count += 5;       // two zeta tables plus 2 x 3 lane tables of n/2
+#endif
+    plan->storage = malloc(table_count * n * sizeof(uint32_t));
+    if (!plan->storage) {
+        free(plan);
+        return NULL;
+    }
+
+    plan->n = (uint32_t)n;
+    plan->q = q;
+    plan->type = type;
+    plan->barrett = (uint64_t)(((__uint128_t)1 << 64) / q);
+    while ((1u << plan->log_n) < n) {
+        plan->log_n++;
+    }
+
+    plan->zetas = plan->storage;
+    plan->zetas_inv = plan->storage + n;
+    plan->bitrev = plan->storage + 2 * n;
+
+    // Walk the splitting tree with exponents of g: node k holds c_k = g^e[k],
+    // zeta_k = g^(e[k]/2), children c_2k = zeta_k and c_2k+1 = -zeta_k.
+    // The exponents are always even where a square root is taken.
+    uint32_t *exps = plan->bitrev;      // scratch, overwritten below
+    exps[1] = (type == NTT_PLAN_CYCLIC) ? 0 : (uint32_t)n;
+    plan->zetas[0] = plan->zetas_inv[0] = 1;
+    for (uint32_t k = 1; k < n; k++) {
+        uint32_t z = exps[k] / 2;
+        if (2 * k < n) {
+            exps[2 * k] = z;
+            exps[2 * k + 1] = (uint32_t)((z + order / 2) % order);
+        }
+        plan->zetas[k] = plan_pow_mod(g, z, q);
+        plan->zetas_inv[k] = plan_pow_mod(g, (order - z) % order, q);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t rev = 0;
+        for (uint32_t b = 0; b < plan->log_n; b++) {
+            rev |= ((i >> b) & 1) << (plan->log_n - 1 - b);
+        }
+        plan->bitrev[i] = rev;
+    }
+
+    plan->n_inv = plan_pow_mod((uint32_t)(n % q), q - 2, q);
+    plan->zeta1_n_inv = plan_mul_mod(plan->zetas_inv[1], plan->n_inv, plan);
+
+#ifdef __AVX2__
+    plan->avx2_zetas = plan->storage + 3 * n;
+    plan->avx2_zetas_inv = plan->storage + 4 * n;
+    plan->avx2_lanes = plan->storage + 5 * n;       // 3 * n/2 entries
+    plan->avx2_lanes_inv = plan->avx2_lanes + 3 * (n / 2);
+    if (n >= 16 && (ntt64_detect_cpu_features() & NTT_CPU_AVX2)) {
+        plan_avx2_build_tables(plan);
+        plan->use_avx2 = 1;
+    }
+#endif
+
+    return plan;
+}
+
+void ntt_plan_destroy(ntt_plan_t *plan) {
+    if (!plan) {
+        return;
+    }
+    free(plan->storage);
+    free(plan);
+}
+
+size_t ntt_plan_size(const ntt_plan_t *plan) {
+    return plan->n;
+}
+
+uint32_t ntt_plan_modulus(const ntt_plan_t *plan) {
+    return plan->q;
+}
+
+// ============================================================================
+// SCALAR TRANSFORMS
+// ============================================================================
+
+static void plan_bit_reverse(const ntt_plan_t *plan, uint32_t *poly) {
+    for (uint32_t i = 0; i < plan->n; i++) {
+        uint32_t j = plan->bitrev[i];
+        if (i < j) {
+            uint32_t tmp = poly[i];
+            poly[i] = poly[j];
+            poly[j] = tmp;
+        }
+    }
+}
+
+void ntt_plan_forward_bitrev(const ntt_plan_t *plan, uint32_t *poly) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+#ifdef __AVX2__
+    if (plan->use_avx2) {
+        plan_avx2_forward_bitrev(plan, poly);
+        return;
+    }
+#endif
+    const uint32_t n = plan->n;
+    uint32_t half = n / 2;
+
+    // First stage fully reduces the (possibly unreduced) input
+    uint32_t zeta = plan->zetas[1];
+    for (uint32_t j = 0; j < half; j++) {
+        uint32_t t = plan_mul_mod(poly[j + half], zeta, plan);
+        uint32_t u = plan_reduce(poly[j], plan);
+        poly[j] = plan_add_mod(u, t, plan);
+        poly[j + half] = plan_sub_mod(u, t, plan);
+    }
+
+    uint32_t k = 2;
+    for (uint32_t len = n / 4; len >= 1; len >>= 1) {
+        for (uint32_t start = 0; start < n; start += 2 * len) {
+            zeta = plan->zetas[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                uint32_t t = plan_mul_mod(poly[j + len], zeta, plan);
+                uint32_t u = poly[j];
+                poly[j] = plan_add_mod(u, t, plan);
+                poly[j + len] = plan_sub_mod(u, t, plan);
+            }
+        }
+    }
+}
+
+void ntt_plan_inverse_bitrev(const ntt_plan_t *plan, uint32_t *poly) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+#ifdef __AVX2__
+    if (plan->use_avx2) {
+        plan_avx2_inverse_bitrev(plan, poly);
+        return;
+    }
+#endif
+    const uint32_t n = plan->n;
+    uint32_t half = n / 2;
+
+    for (uint32_t len = 1; len < half; len <<= 1) {
+        uint32_t k = n / (2 * len);
+        for (uint32_t start = 0; start < n; start += 2 * len) {
+            uint32_t zeta = plan->zetas_inv[k++];
+            for (uint32_t j = start; j < start + len; j++) {
+                uint32_t u = poly[j];
+                uint32_t v = poly[j + len];
+                poly[j] = plan_add_mod(u, v, plan);
+                poly[j + len] = plan_mul_mod(plan_sub_mod(u, v, plan), zeta, plan);
+            }
+        }
+    }
+
+    // Last stage folds N^(-1) into both outputs
+    for (uint32_t j = 0; j < half; j++) {
+        uint32_t u = poly[j];
+        uint32_t v = poly[j + half];
+        poly[j] = plan_mul_mod(plan_add_mod(u, v, plan), plan->n_inv, plan);
+        poly[j + half] = plan_mul_mod(plan_sub_mod(u, v, plan), plan->zeta1_n_inv, plan);
+    }
+}
+
+void ntt_plan_forward(const ntt_plan_t *plan, uint32_t *poly) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_FORWARD);
+    ntt_plan_forward_bitrev(plan, poly);
+    plan_bit_reverse(plan, poly);
+}
+
+void ntt_plan_inverse(const ntt_plan_t *plan, uint32_t *poly) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_INVERSE);
+    plan_bit_reverse(plan, poly);
+    ntt_plan_inverse_bitrev(plan, poly);
+}
+
+void ntt_plan_pointwise_mul(const ntt_plan_t *plan,
+                            uint32_t *result,
+                            const uint32_t *a,
+                            const uint32_t *b) {
+    DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+#ifdef __AVX2__
+    if (plan->use_avx2) {
+        plan_avx2_pointwise_mul(plan, result, a, b);
+        return;
+    }
+#endif
+    for (uint32_t i = 0; i < plan->n; i++) {
+        result[i] = plan_mul_mod(a[i], b[i], plan);
+    }
+}
+
+// ============================================================================
+// SPARSE PRODUCTS
+// ============================================================================
+//
+// x^i * a is a rotated by i, with the coefficients that wrap past x^N negated
+// for negacyclic plans. A sparse operand with w nonzeros is then w scaled
+// rotations of the dense one, accumulated in 64 bits: N products each,
+// against about (3/2) N log N for the two forward and one inverse transform.
+// Outputs are built a block at a time so the accumulators stay in L1.
+
+#define SPARSE_BLOCK 512
+
+// acc[k] += c * a[k] over len coefficients (vectorizes to 32x32->64 products)
+static void sparse_mac(uint64_t *acc, const uint32_t *a, uint32_t c, size_t len) {
+    for (size_t k = 0; k < len; k++) {
+        acc[k] += (uint64_t)c * a[k];
+    }
+}
+
+static uint32_t sparse_value_mod(int32_t v, uint32_t q) {
+    const uint32_t m = (uint32_t)(v < 0 ? -v : v) % q;
+    return v < 0 && m ? q - m : m;
+}
+
+static void sparse_mul_direct(const ntt_plan_t *plan, uint32_t *result,
+                              const uint16_t *indices, const int8_t *values, size_t count,
+                              const uint32_t *dense) {
+    const size_t n = plan->n;
+    const uint64_t q = plan->q;
+
+    // Products below (q-1)^2 each: this many fit on top of a reduced value
+    const size_t fold = (size_t)((UINT64_MAX - q) / ((q - 1) * (q - 1)));
+    uint64_t acc[SPARSE_BLOCK];
+
+    for (size_t b0 = 0; b0 < n; b0 += SPARSE_BLOCK) {
+        const size_t len = n - b0 < SPARSE_BLOCK ? n - b0 : SPARSE_BLOCK;
+        memset(acc, 0, len * sizeof(uint64_t));
+
+        for (size_t t = 0, pending = 0; t < count; t++) {
+            const size_t i = indices[t];
+            const uint32_t c = sparse_value_mod(values[t], plan->q);
+            const uint32_t wrapped = plan->type == NTT_PLAN_NEGACYCLIC && c ? plan->q - c : c;
+
+            // Outputs k < i read dense[k - i + n] (wrapped), the rest dense[k - i]
+            const size_t split = i < b0 ? 0 : (i - b0 < len ? i - b0 : len);
+            if (split > 0) {
+                sparse_mac(acc, dense + b0 + n - i, wrapped, split);
+            }
+            if (split < len) {
+                sparse_mac(acc + split, dense + b0 + split - i, c, len - split);
+            }
+            if (++pending == fold) {
+                for (size_t k = 0; k < len; k++) {
+                    acc[k] = plan_reduce(acc[k], plan);
+                }
+                pending = 0;
+            }
+        }
+        for (size_t k = 0; k < len; k++) {
+            result[b0 + k] = plan_reduce(acc[k], plan);
+        }
+    }
+}
+
+// The transforms grow as N log N and the direct product as N per nonzero;
+// measured with AVX2 the two meet at 4 to 5 nonzeros per log2 N for N = 64
+// .. 2048 (the transforms' scratch allocation included)
+size_t ntt_plan_sparse_threshold(const ntt_plan_t *plan) {
+    return (size_t)4 * plan->log_n;
+}
+
+int ntt_plan_mul_sparse(const ntt_plan_t *plan,
+                        uint32_t *result,
+                        const uint16_t *indices,
+                        const int8_t *values,
+                        size_t count,
+                        const uint32_t *dense) {
+    for (size_t t = 0; t < count; t++) {
+        if (indices[t] >= plan->n) {
+            return -1;
+        }
+    }
+
+    uint32_t *scratch = NULL;
+    if (count > ntt_plan_sparse_threshold(plan)) {
+        scratch = malloc((size_t)plan->n * sizeof(uint32_t));
+    }
+    if (!scratch) {
+        DNTL_STAT_SCOPE(DNTL_STAT_NTT_POINTWISE);
+        sparse_mul_direct(plan, result, indices, values, count, dense);
+        return 0;
+    }
+
+    // Transforms: the bit-reversed domain is only multiplied pointwise
+    memset(result, 0, (size_t)plan->n * sizeof(uint32_t));
+    for (size_t t = 0; t < count; t++) {
+        result[indices[t]] = plan_add_mod(result[indices[t]],
+                                          sparse_value_mod(values[t], plan->q), plan);
+    }
+    memcpy(scratch, dense, (size_t)plan->n * sizeof(uint32_t));
+    ntt_plan_forward_bitrev(plan, result);
+    ntt_plan_forward_bitrev(plan, scratch);
+    ntt_plan_pointwise_mul(plan, result, result, scratch);
+    ntt_plan_inverse_bitrev(plan, result);
+    free(scratch);
+    return 0;
+}
@@ -0,0 +1,148 @@
+#ifndef NTT_PLAN_H
+#define NTT_PLAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// LENGTH-GENERIC NTT PLANS
+// ============================================================================
+//
+// The ntt64 library is fixed to N = 64 and seven built-in moduli. A plan lifts
+// both restrictions: it holds the twiddle and Barrett tables for one
+// (N, q, root) triple, built once by ntt_plan_create(). Plans are immutable
+// after creation, so a single plan may be shared by any number of threads.
+//
+// Usage (DSA security level 5: N = 256, q = 257, generator 3):
+//
+//   ntt_plan_t *plan = ntt_plan_create(256, 257, 3, NTT_PLAN_CYCLIC);
+//   ntt_plan_forward(plan, a);
+//   ntt_plan_forward(plan, b);
+//   ntt_plan_pointwise_mul(plan, c, a, b);
+//   ntt_plan_inverse(plan, c);          // c = a * b mod (x^256 - 1)
+//   ntt_plan_destroy(plan);
+
+// Largest supported transform length
+#define NTT_PLAN_MAX_N 65536
+
+/**
+ * Transform type
+ *
+ * NTT_PLAN_CYCLIC evaluates at the powers of omega = root^((q-1)/N), i.e.
+ * multiplication mod x^N - 1, as in dntl-dsa-nat.py. NTT_PLAN_NEGACYCLIC
+ * evaluates at the odd powers of psi = root^((q-1)/(2N)), i.e. multiplication
+ * mod x^N + 1, as in ntt64.
+ */
+typedef enum {
+    NTT_PLAN_CYCLIC = 0,
+    NTT_PLAN_NEGACYCLIC = 1
+} ntt_plan_type_t;
+
+typedef struct ntt_plan ntt_plan_t;
+
+/**
+ * Create a plan for length-n transforms over Z_q
+ *
+ * @param n         Transform length: a power of two in [2, NTT_PLAN_MAX_N]
+ * @param q         Prime modulus with N | q-1 (cyclic) or 2N | q-1 (negacyclic)
+ * @param root      Generator of Z_q^* (any element whose derived omega or psi
+ *                  has full order is accepted)
+ * @param type      NTT_PLAN_CYCLIC or NTT_PLAN_NEGACYCLIC
+ * @return          New plan, or NULL if the parameters are invalid or
+ *                  allocation fails
+ */
+ntt_plan_t *ntt_plan_create(size_t n, uint32_t q, uint32_t root, ntt_plan_type_t type);
+
+/**
+ * Free a plan (NULL is ignored)
+ */
+void ntt_plan_destroy(ntt_plan_t *plan);
+
+/**
+ * Transform length of a plan
+ */
+size_t ntt_plan_size(const ntt_plan_t *plan);
+
+/**
+ * Modulus of a plan
+ */
+uint32_t ntt_plan_modulus(const ntt_plan_t *plan);
+
+/**
+ * Forward NTT (constant-time)
+ *
+ * Input in natural coefficient order (any 32-bit values), output in natural
+ * NTT order: poly[k] = A(omega^k) for cyclic plans, A(psi^(2k+1)) for
+ * negacyclic plans, reduced to [0, q).
+ *
+ * @param plan      Plan created by ntt_plan_create()
+ * @param poly      Array of n coefficients (modified in-place)
+ */
+void ntt_plan_forward(const ntt_plan_t *plan, uint32_t *poly);
+
+/**
+ * Inverse NTT (constant-time), including the N^(-1) scaling
+ *
+ * @param plan      Plan created by ntt_plan_create()
+ * @param poly      Array of n values in natural NTT order, each in [0, q)
+ */
+void ntt_plan_inverse(const ntt_plan_t *plan, uint32_t *poly);
+
+/**
+ * Forward NTT with bit-reversed output
+ *
+ * Same as ntt_plan_forward() followed by a bit-reversal permutation of the
+ * indices, without the permutation pass. Pair with ntt_plan_inverse_bitrev()
+ * when the NTT domain only sees pointwise operations.
+ */
+void ntt_plan_forward_bitrev(const ntt_plan_t *plan, uint32_t *poly);
+
+/**
+ * Inverse of ntt_plan_forward_bitrev(): bit-reversed NTT order in, natural
+ * coefficient order out. Values must be in [0, q).
+ */
+void ntt_plan_inverse_bitrev(const ntt_plan_t *plan, uint32_t *poly);
+
+/**
+ * Point-wise multiplication in NTT domain (constant-time)
+ *
+ * Computes result[i] = (a[i] * b[i]) mod q for all n entries. Inputs must be
+ * in [0, q); result may alias a or b.
+ */
+void ntt_plan_pointwise_mul(const ntt_plan_t *plan,
+                            uint32_t *result,
+                            const uint32_t *a,
+                            const uint32_t *b);
+
+/**
+ * Product of a sparse and a dense operand, mod x^N - 1 or x^N + 1 as the
+ * plan's type
+ *
+ * The sparse operand has values[t] at indices[t] for t < count, the arrays
+ * of a sparse_vector_t (repeated indices add up). Up to
+ * ntt_plan_sparse_threshold() nonzeros the product is accumulated directly,
+ * one rotation of dense per nonzero (negated where it wraps, for negacyclic
+ * plans); past it, it goes through two forward transforms, a pointwise
+ * product and an inverse.
+ *
+ * The direct path reads all of dense for every nonzero, but its loop bounds
+ * follow the indices: it is not constant-time in the positions of the
+ * nonzeros, nor is the path chosen in their count.
+ *
+ * @param result    n coefficients in [0, q); must not alias dense
+ * @param dense     n coefficients in [0, q)
+ * @return          0, or -1 if an index is not below n (result unchanged)
+ */
+int ntt_plan_mul_sparse(const ntt_plan_t *plan,
+                        uint32_t *result,
+                        const uint16_t *indices,
+                        const int8_t *values,
+                        size_t count,
+                        const uint32_t *dense);
+
+/**
+ * Most nonzeros ntt_plan_mul_sparse() multiplies directly: 4 log2 N
+ */
+size_t ntt_plan_sparse_threshold(const ntt_plan_t *plan);
+
+#endif // NTT_PLAN_H
@@ -0,0 +1,285 @@
+#ifndef RANS_INTERLEAVED_H
+#define RANS_INTERLEAVED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// INTERLEAVED rANS (BYTE-WISE, 8-BIT FREQUENCIES)
+// ============================================================================
+
+/**
+ * Static rANS over up to 256 symbols with frequencies summing to
+ * RANS_TOTAL, in the style of ryg_rans
+ *
+ * Symbol i of a message goes to state i % lanes (1, 2, 4 or 8 lanes); the
+ * lanes share one byte stream. States live in [RANS_L, RANS_L << 8) and
+ * renormalize a byte at a time, at most one byte per symbol. The encoder
+ * runs backwards and writes the stream back to front, so the decoder
+ * reads everything forwards:
+ *
+ *     state[0] .. state[lanes-1]   3 bytes each, most significant first
+ *     renormalization bytes        in decoding order
+ *
+ * Every lane starts encoding at RANS_L, so a decoder that ends with a lane
+ * elsewhere, or with bytes left over, was given a corrupt stream.
+ *
+ * Decoding looks up one table entry per symbol. With AVX2 the 8-lane
+ * stream decodes a group of eight symbols per step: a gather for the
+ * entries, then a prefix count to hand each renormalizing lane its byte.
+ */
+#define RANS_SCALE_BITS 8
+#define RANS_TOTAL      (1u << RANS_SCALE_BITS)
+#define RANS_L          (1u << 16)
+#define RANS_MAX_LANES  8
+#define RANS_STATE_BYTES 3
+
+typedef struct {
+    uint16_t freq[RANS_TOTAL];
+    uint16_t cumul[RANS_TOTAL];
+    /* Per slot: symbol (bits 0-7), its frequency (8-16), slot - cumul (17-24) */
+    uint32_t slot[RANS_TOTAL];
+} rans_table_t;
+
+/**
+ * Build the tables for n_symbols frequencies
+ *
+ * @return  0, or -1 unless 1 <= n_symbols <= 256 and the frequencies are
+ *          all nonzero and sum to RANS_TOTAL
+ */
+static inline int rans_table_build(rans_table_t *t, const uint32_t *freqs, int n_symbols) {
+    if (n_symbols <= 0 || n_symbols > (int)RANS_TOTAL) {
+        return -1;
+    }
+    memset(t->freq, 0, sizeof(t->freq));
+    uint32_t cumul = 0;
+    for (int s = 0; s < n_symbols; s++) {
+        if (freqs[s] == 0 || freqs[s] > RANS_TOTAL - cumul) {
+            return -1;
+        }
+        t->freq[s] = (uint16_t)freqs[s];
+        t->cumul[s] = (uint16_t)cumul;
+        for (uint32_t k = 0; k < freqs[s]; k++) {
+            t->slot[cumul + k] = (uint32_t)s | (freqs[s] << 8) | (k << 17);
+        }
+        cumul += freqs[s];
+    }
+    return cumul == RANS_TOTAL ? 0 : -1;
+}
+
+/**
+ * Encoded size bound for n symbols
+ */
+static inline size_t rans_max_bytes(size_t n, unsigned lanes) {
+    return n + (size_t)lanes * RANS_STATE_BYTES;
+}
+
+/**
+ * Encode n symbols (alphabet indices) over lanes states
+ *
+ * @param out       Receives the stream
+ * @param capacity  Bytes available at out
+ * @return          Bytes written, or 0 if lanes is not 1, 2, 4 or 8, a
+ *                  symbol has no frequency, or the stream does not fit
+ */
+static inline size_t rans_encode(const rans_table_t *t, unsigned lanes,
+                                 const uint8_t *syms, size_t n,
+                                 uint8_t *out, size_t capacity) {
+    if (lanes == 0 || lanes > RANS_MAX_LANES || (lanes & (lanes - 1)) != 0) {
+        return 0;
+    }
+    uint32_t x[RANS_MAX_LANES];
+    for (unsigned j = 0; j < lanes; j++) {
+        x[j] = RANS_L;
+    }
+
+    // Back to front from the end of out
+    uint8_t *p = out + capacity;
+    for (size_t i = n; i-- > 0;) {
+        uint32_t *xs = &x[i & (lanes - 1)];
+        const uint32_t freq = t->freq[syms[i]];
+        if (freq == 0) {
+            return 0;
+        }
+        if (*xs >= RANS_L * freq) {
+            if (p == out) {
+                return 0;
+            }
+            *--p = (uint8_t)*xs;
+            *xs >>= 8;
+        }
+        *xs = ((*xs / freq) << RANS_SCALE_BITS) + (*xs % freq) + t->cumul[syms[i]];
+    }
+    for (unsigned j = lanes; j-- > 0;) {
+        if ((size_t)(p - out) < RANS_STATE_BYTES) {
+            return 0;
+        }
+        for (unsigned b = 0; b < RANS_STATE_BYTES; b++) {
+            *--p = (uint8_t)(x[j] >> (8 * b));
+        }
+    }
+
+    const size_t size = (size_t)(out + capacity - p);
+    memmove(out, p, size);
+    return size;
+}
+
+// One symbol of lane state *x; bytes before end are read only when needed
+static inline int rans_decode_step(const rans_table_t *t, uint32_t *x,
+                                   const uint8_t **p, const uint8_t *end, uint8_t *sym) {
+    const uint32_t e = t->slot[*x & (RANS_TOTAL - 1)];
+    *sym = (uint8_t)e;
+    *x = ((e >> 8) & 0x1FF) * (*x >> RANS_SCALE_BITS) + (e >> 17);
+    if (*x < RANS_L) {
+        if (*p == end) {
+            return -1;
+        }
+        *x = (*x << 8) | *(*p)++;
+    }
+    return 0;
+}
+
+// Groups of lanes symbols while lanes bytes remain, then one at a time
+static inline size_t rans_decode_lanes(const rans_table_t *t, unsigned lanes, uint32_t *x,
+                                       const uint8_t **p, const uint8_t *end,
+                                       uint8_t *syms, size_t i, size_t n) {
+    // Locals: the byte stores to syms could otherwise alias the states
+    uint32_t xs[RANS_MAX_LANES];
+    memcpy(xs, x, lanes * sizeof(uint32_t));
+    const uint8_t *q = *p;
+    for (; n - i >= lanes && (size_t)(end - q) >= lanes; i += lanes) {
+        for (unsigned j = 0; j < lanes; j++) {
+            const uint32_t e = t->slot[xs[j] & (RANS_TOTAL - 1)];
+            syms[i + j] = (uint8_t)e;
+            uint32_t v = ((e >> 8) & 0x1FF) * (xs[j] >> RANS_SCALE_BITS) + (e >> 17);
+            // Branchless: whether a lane renormalizes is a coin flip
+            const uint32_t need = v < RANS_L;
+            v = (v << (8 * need)) | (*q & (0u - need));
+            q += need;
+            xs[j] = v;
+        }
+    }
+    memcpy(x, xs, lanes * sizeof(uint32_t));
+    *p = q;
+    for (; i < n; i++) {
+        if (rans_decode_step(t, &x[i & (lanes - 1)], p, end, &syms[i]) < 0) {
+            return (size_t)-1;
+        }
+    }
+    return i;
+}
+
+#if defined(__AVX2__)
+// Eight lanes a group at a time while 8 bytes remain; returns symbols done
+static inline size_t rans_decode_avx2(const rans_table_t *t, uint32_t *x,
+                                      const uint8_t **p, const uint8_t *end,
+                                      uint8_t *syms, size_t n) {
+    const __m256i slot_mask = _mm256_set1_epi32((int)(RANS_TOTAL - 1));
+    const __m256i freq_mask = _mm256_set1_epi32(0x1FF);
+    const __m256i lower = _mm256_set1_epi32((int)RANS_L);
+    const __m256i sym_mask = _mm256_set1_epi32(0xFF);
+    const __m256i lane3 = _mm256_set1_epi32(3);
+    const __m256i upper_half = _mm256_setr_epi32(0, 0, 0, 0, -1, -1, -1, -1);
+    __m256i xv = _mm256_loadu_si256((const __m256i *)x);
+    const uint8_t *q = *p;
+    size_t i = 0;
+    for (; n - i >= 8 && end - q >= 8; i += 8) {
+        const __m256i e = _mm256_i32gather_epi32((const int *)t->slot,
+                                                 _mm256_and_si256(xv, slot_mask), 4);
+        const __m256i freq = _mm256_and_si256(_mm256_srli_epi32(e, 8), freq_mask);
+        xv = _mm256_add_epi32(_mm256_mullo_epi32(freq, _mm256_srli_epi32(xv, RANS_SCALE_BITS)),
+                              _mm256_srli_epi32(e, 17));
+
+        // Lanes below RANS_L take the next bytes in lane order: lane j takes
+        // byte (renormalizing lanes before j), an exclusive prefix sum
+        const __m256i need = _mm256_cmpgt_epi32(lower, xv);
+        const __m256i one = _mm256_srli_epi32(need, 31);
+        __m256i before = _mm256_add_epi32(one, _mm256_slli_si256(one, 4));
+        before = _mm256_add_epi32(before, _mm256_slli_si256(before, 8));
+        before = _mm256_add_epi32(before, _mm256_and_si256(
+            _mm256_permutevar8x32_epi32(before, lane3), upper_half));
+        before = _mm256_sub_epi32(before, one);
+        const __m256i bytes = _mm256_permutevar8x32_epi32(
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)q)), before);
+        xv = _mm256_blendv_epi8(xv, _mm256_or_si256(_mm256_slli_epi32(xv, 8), bytes), need);
+        q += __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(need)));
+
+        // Symbols: low byte of each entry, packed to 8 bytes
+        __m256i s = _mm256_and_si256(e, sym_mask);
+        s = _mm256_packus_epi32(s, s);
+        s = _mm256_packus_epi16(s, s);
+        const uint32_t lo = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(s));
+        const uint32_t hi = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(s, 1));
+        memcpy(syms + i, &lo, 4);
+        memcpy(syms + i + 4, &hi, 4);
+    }
+    _mm256_storeu_si256((__m256i *)x, xv);
+    *p = q;
+    return i;
+}
+#endif
+
+/**
+ * Decode n symbols written by rans_encode() with the same lanes
+ *
+ * @param simd  0: portable path only (AVX2 builds otherwise use it for
+ *              8-lane streams)
+ * @return      0, or -1 on a bad lane count or a corrupt or truncated
+ *              stream (size must be exactly the encoded size)
+ */
+static inline int rans_decode_ex(const rans_table_t *t, unsigned lanes,
+                                 const uint8_t *in, size_t size,
+                                 uint8_t *syms, size_t n, int simd) {
+    if (lanes == 0 || lanes > RANS_MAX_LANES || (lanes & (lanes - 1)) != 0 ||
+        size < (size_t)lanes * RANS_STATE_BYTES) {
+        return -1;
+    }
+    uint32_t x[RANS_MAX_LANES];
+    const uint8_t *p = in, *end = in + size;
+    for (unsigned j = 0; j < lanes; j++, p += RANS_STATE_BYTES) {
+        x[j] = (uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2];
+        if (x[j] < RANS_L) {
+            return -1;
+        }
+    }
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    if (simd && lanes == 8) {
+        i = rans_decode_avx2(t, x, &p, end, syms, n);
+    }
+#else
+    (void)simd;
+#endif
+    // Constant lane counts, so the lane loop unrolls into registers
+    switch (lanes) {
+    case 1: i = rans_decode_lanes(t, 1, x, &p, end, syms, i, n); break;
+    case 2: i = rans_decode_lanes(t, 2, x, &p, end, syms, i, n); break;
+    case 4: i = rans_decode_lanes(t, 4, x, &p, end, syms, i, n); break;
+    default: i = rans_decode_lanes(t, 8, x, &p, end, syms, i, n); break;
+    }
+    if (i != n || p != end) {
+        return -1;
+    }
+    for (unsigned j = 0; j < lanes; j++) {
+        if (x[j] != RANS_L) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * rans_decode_ex() with SIMD where available
+ */
+static inline int rans_decode(const rans_table_t *t, unsigned lanes,
+                              const uint8_t *in, size_t size, uint8_t *syms, size_t n) {
+    return rans_decode_ex(t, lanes, in, size, syms, n, 1);
+}
+
+#endif // RANS_INTERLEAVED_H
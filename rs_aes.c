@@ -0,0 +1,406 @@
+#include "rs_aes.h"
+#include <string.h>
+
+// Selected backend (OpenSSL until rs_aes_init() finds something better)
+static rs_aes_impl_t current_impl = RS_AES_IMPL_OPENSSL;
+
+static const char *const impl_names[] = { "openssl", "aesni", "vaes", "armv8" };
+
+// ============================================================================
+// KEY EXPANSION
+// ============================================================================
+
+static const uint8_t aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+void rs_aes256_expand_key(rs_aes256_key_t *ks, const uint8_t key[32]) {
+    uint8_t *w = ks->rk[0];
+    uint8_t rcon = 0x01;
+
+    memcpy(w, key, 32);
+
+    // FIPS-197 §5.2 with Nk = 8: 60 words, 4 bytes each
+    for (int i = 8; i < 4 * (RS_AES256_ROUNDS + 1); i++) {
+        uint8_t t[4];
+        memcpy(t, w + 4 * (i - 1), 4);
+
+        if (i % 8 == 0) {
+            // RotWord, SubWord, Rcon
+            uint8_t t0 = t[0];
+            t[0] = aes_sbox[t[1]] ^ rcon;
+            t[1] = aes_sbox[t[2]];
+            t[2] = aes_sbox[t[3]];
+            t[3] = aes_sbox[t0];
+            rcon = (uint8_t)((rcon << 1) ^ ((rcon & 0x80) ? 0x1b : 0));
+        } else if (i % 8 == 4) {
+            // SubWord only
+            for (int j = 0; j < 4; j++) {
+                t[j] = aes_sbox[t[j]];
+            }
+        }
+
+        for (int j = 0; j < 4; j++) {
+            w[4 * i + j] = w[4 * (i - 8) + j] ^ t[j];
+        }
+    }
+}
+
+// ============================================================================
+// BACKENDS
+// ============================================================================
+
+/**
+ * Keystream for nblocks whole blocks from counter (hi, lo)
+ *
+ * The caller guarantees lo + nblocks does not wrap, so backends only ever
+ * increment the low 64 bits.
+ */
+typedef void (*ctr_blocks_fn)(const rs_aes256_key_t *ks,
+                              uint64_t hi, uint64_t lo,
+                              uint8_t *out, size_t nblocks);
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+
+#if defined(__AES__) && defined(__SSSE3__)
+#include <immintrin.h>
+#define RS_AES_HAVE_AESNI 1
+
+// Counter lanes are (hi, lo) as native integers; this makes them big-endian
+#define CTR_BSWAP_MASK _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, \
+                                    0, 1, 2, 3, 4, 5, 6, 7)
+
+static void ctr_blocks_aesni(const rs_aes256_key_t *ks,
+                             uint64_t hi, uint64_t lo,
+                             uint8_t *out, size_t nblocks) {
+    __m128i rk[RS_AES256_ROUNDS + 1];
+    for (int r = 0; r <= RS_AES256_ROUNDS; r++) {
+        rk[r] = _mm_loadu_si128((const __m128i *)ks->rk[r]);
+    }
+
+    const __m128i mask = CTR_BSWAP_MASK;
+    const __m128i one = _mm_set_epi64x(1, 0);
+    const __m128i eight = _mm_set_epi64x(8, 0);
+    __m128i ctr = _mm_set_epi64x((long long)lo, (long long)hi);
+    size_t i = 0;
+
+    // 8 independent blocks hide the aesenc latency
+    for (; i + 8 <= nblocks; i += 8) {
+        __m128i b[8];
+        for (int j = 0; j < 8; j++) {
+            b[j] = _mm_xor_si128(
+                _mm_shuffle_epi8(_mm_add_epi64(ctr, _mm_set_epi64x(j, 0)), mask), rk[0]);
+        }
+        ctr = _mm_add_epi64(ctr, eight);
+
+        for (int r = 1; r < RS_AES256_ROUNDS; r++) {
+            for (int j = 0; j < 8; j++) {
+                b[j] = _mm_aesenc_si128(b[j], rk[r]);
+            }
+        }
+        for (int j = 0; j < 8; j++) {
+            b[j] = _mm_aesenclast_si128(b[j], rk[RS_AES256_ROUNDS]);
+            _mm_storeu_si128((__m128i *)(out + 16 * (i + j)), b[j]);
+        }
+    }
+
+    for (; i < nblocks; i++) {
+        __m128i b = _mm_xor_si128(_mm_shuffle_epi8(ctr, mask), rk[0]);
+        ctr = _mm_add_epi64(ctr, one);
+        for (int r = 1; r < RS_AES256_ROUNDS; r++) {
+            b = _mm_aesenc_si128(b, rk[r]);
+        }
+        b = _mm_aesenclast_si128(b, rk[RS_AES256_ROUNDS]);
+        _mm_storeu_si128((__m128i *)(out + 16 * i), b);
+    }
+}
+
+#if defined(__VAES__) && defined(__AVX512F__) && defined(__AVX512BW__)
+#define RS_AES_HAVE_VAES 1
+
+static void ctr_blocks_vaes(const rs_aes256_key_t *ks,
+                            uint64_t hi, uint64_t lo,
+                            uint8_t *out, size_t nblocks) {
+    __m512i rk[RS_AES256_ROUNDS + 1];
+    for (int r = 0; r <= RS_AES256_ROUNDS; r++) {
+        rk[r] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)ks->rk[r]));
+    }
+
+    // Each 128-bit lane carries one counter: lo + 0, 1, 2, 3
+    const __m512i mask = _mm512_broadcast_i32x4(CTR_BSWAP_MASK);
+    const __m512i four = _mm512_set_epi64(4, 0, 4, 0, 4, 0, 4, 0);
+    __m512i ctr = _mm512_add_epi64(
+        _mm512_broadcast_i32x4(_mm_set_epi64x((long long)lo, (long long)hi)),
+        _mm512_set_epi64(3, 0, 2, 0, 1, 0, 0, 0));
+    size_t i = 0;
+
+    // 4 vectors of 4 blocks in flight
+    for (; i + 16 <= nblocks; i += 16) {
+        __m512i b[4];
+        for (int j = 0; j < 4; j++) {
+            b[j] = _mm512_xor_si512(_mm512_shuffle_epi8(ctr, mask), rk[0]);
+            ctr = _mm512_add_epi64(ctr, four);
+        }
+
+        for (int r = 1; r < RS_AES256_ROUNDS; r++) {
+            for (int j = 0; j < 4; j++) {
+                b[j] = _mm512_aesenc_epi128(b[j], rk[r]);
+            }
+        }
+        for (int j = 0; j < 4; j++) {
+            b[j] = _mm512_aesenclast_epi128(b[j], rk[RS_AES256_ROUNDS]);
+            _mm512_storeu_si512((void *)(out + 16 * (i + 4 * j)), b[j]);
+        }
+    }
+
+    // Up to 15 leftover blocks, one vector at a time
+    for (; i < nblocks; i += 4) {
+        __m512i b = _mm512_xor_si512(_mm512_shuffle_epi8(ctr, mask), rk[0]);
+        ctr = _mm512_add_epi64(ctr, four);
+        for (int r = 1; r < RS_AES256_ROUNDS; r++) {
+            b = _mm512_aesenc_epi128(b, rk[r]);
+        }
+        b = _mm512_aesenclast_epi128(b, rk[RS_AES256_ROUNDS]);
+
+        size_t left = nblocks - i;
+        if (left >= 4) {
+            _mm512_storeu_si512((void *)(out + 16 * i), b);
+        } else {
+            // One 64-bit mask bit per quadword: two per block
+            __mmask8 m = (__mmask8)((1u << (2 * left)) - 1);
+            _mm512_mask_storeu_epi64((void *)(out + 16 * i), m, b);
+        }
+    }
+}
+#endif // VAES
+
+#endif // AES-NI
+
+#ifdef RS_AES_HAVE_AESNI
+#include <cpuid.h>
+
+static int cpu_has_aesni(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    // AES (bit 25) and SSSE3 (bit 9)
+    return (ecx & (1u << 25)) && (ecx & (1u << 9));
+}
+
+#ifdef RS_AES_HAVE_VAES
+// XCR0 bits that must be enabled by the OS before ZMM state can be used
+#define XCR0_AVX512_STATE  0xE6u
+
+static unsigned int read_xcr0(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1u << 27))) {
+        return 0;  // no OSXSAVE
+    }
+    unsigned int lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    (void)hi;
+    return lo;
+}
+
+static int cpu_has_vaes(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!cpu_has_aesni() || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    // VAES (ECX bit 9), AVX-512F (EBX bit 16), AVX-512BW (EBX bit 30)
+    return (ecx & (1u << 9)) && (ebx & (1u << 16)) && (ebx & (1u << 30)) &&
+           (read_xcr0() & XCR0_AVX512_STATE) == XCR0_AVX512_STATE;
+}
+#endif // VAES
+#endif // AES-NI
+
+#elif defined(__aarch64__)
+
+#if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+#include <arm_neon.h>
+#define RS_AES_HAVE_ARMV8 1
+
+static inline uint8x16_t ctr_block_neon(uint64_t hi, uint64_t lo) {
+    return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(__builtin_bswap64(hi)),
+                                             vcreate_u64(__builtin_bswap64(lo))));
+}
+
+static void ctr_blocks_armv8(const rs_aes256_key_t *ks,
+                             uint64_t hi, uint64_t lo,
+                             uint8_t *out, size_t nblocks) {
+    uint8x16_t rk[RS_AES256_ROUNDS + 1];
+    for (int r = 0; r <= RS_AES256_ROUNDS; r++) {
+        rk[r] = vld1q_u8(ks->rk[r]);
+    }
+
+    // AESE folds AddRoundKey in before SubBytes/ShiftRows, so round keys
+    // shift by one against the x86 order and the last one is a plain XOR
+    size_t i = 0;
+    for (; i + 8 <= nblocks; i += 8) {
+        uint8x16_t b[8];
+        for (int j = 0; j < 8; j++) {
+            b[j] = ctr_block_neon(hi, lo + i + j);
+        }
+        for (int r = 0; r < RS_AES256_ROUNDS - 1; r++) {
+            for (int j = 0; j < 8; j++) {
+                b[j] = vaesmcq_u8(vaeseq_u8(b[j], rk[r]));
+            }
+        }
+        for (int j = 0; j < 8; j++) {
+            b[j] = veorq_u8(vaeseq_u8(b[j], rk[RS_AES256_ROUNDS - 1]), rk[RS_AES256_ROUNDS]);
+            vst1q_u8(out + 16 * (i + j), b[j]);
+        }
+    }
+
+    for (; i < nblocks; i++) {
+        uint8x16_t b = ctr_block_neon(hi, lo + i);
+        for (int r = 0; r < RS_AES256_ROUNDS - 1; r++) {
+            b = vaesmcq_u8(vaeseq_u8(b, rk[r]));
+        }
+        b = veorq_u8(vaeseq_u8(b, rk[RS_AES256_ROUNDS - 1]), rk[RS_AES256_ROUNDS]);
+        vst1q_u8(out + 16 * i, b);
+    }
+}
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#ifndef HWCAP_AES
+#define HWCAP_AES  (1UL << 3)
+#endif
+
+static int cpu_has_armv8_aes(void) {
+    #if defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+    #else
+    // Compiled for the extension, so the target has it
+    return 1;
+    #endif
+}
+#endif // ARMv8 AES
+
+#endif
+
+static ctr_blocks_fn backend_fn(rs_aes_impl_t impl) {
+    switch (impl) {
+        #ifdef RS_AES_HAVE_AESNI
+        case RS_AES_IMPL_AESNI:
+            return cpu_has_aesni() ? ctr_blocks_aesni : NULL;
+        #endif
+        #ifdef RS_AES_HAVE_VAES
+        case RS_AES_IMPL_VAES:
+            return cpu_has_vaes() ? ctr_blocks_vaes : NULL;
+        #endif
+        #ifdef RS_AES_HAVE_ARMV8
+        case RS_AES_IMPL_ARMV8:
+            return cpu_has_armv8_aes() ? ctr_blocks_armv8 : NULL;
+        #endif
+        default:
+            return NULL;
+    }
+}
+
+static ctr_blocks_fn current_fn = NULL;
+
+// ============================================================================
+// INITIALIZATION AND DISPATCH
+// ============================================================================
+
+void rs_aes_init(void) {
+    // Priority: VAES > AES-NI > ARMv8 > OpenSSL
+    static const rs_aes_impl_t order[] = {
+        RS_AES_IMPL_VAES, RS_AES_IMPL_AESNI, RS_AES_IMPL_ARMV8
+    };
+
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (rs_aes_set_implementation(order[i]) == 0) {
+            return;
+        }
+    }
+    rs_aes_set_implementation(RS_AES_IMPL_OPENSSL);
+}
+
+int rs_aes_supported(rs_aes_impl_t impl) {
+    return impl == RS_AES_IMPL_OPENSSL || backend_fn(impl) != NULL;
+}
+
+int rs_aes_set_implementation(rs_aes_impl_t impl) {
+    if (!rs_aes_supported(impl)) {
+        return -1;
+    }
+    current_fn = backend_fn(impl);
+    current_impl = impl;
+    return 0;
+}
+
+rs_aes_impl_t rs_aes_get_implementation(void) {
+    return current_impl;
+}
+
+const char *rs_aes_implementation_name(void) {
+    return impl_names[current_impl];
+}
+
+// ============================================================================
+// CTR MODE
+// ============================================================================
+
+int rs_aes256_ctr(const rs_aes256_key_t *ks,
+                  const uint8_t iv[16],
+                  uint8_t *out,
+                  size_t out_len) {
+    ctr_blocks_fn fn = current_fn;
+    if (!fn) {
+        return -1;
+    }
+
+    // Split the big-endian counter block into two native halves
+    uint64_t hi = 0, lo = 0;
+    for (int i = 0; i < 8; i++) {
+        hi = (hi << 8) | iv[i];
+        lo = (lo << 8) | iv[8 + i];
+    }
+
+    size_t nblocks = out_len / 16;
+    while (nblocks > 0) {
+        // Blocks until the low half wraps (0 - lo of them; lo == 0: no limit)
+        uint64_t until_wrap = 0 - lo;
+        size_t run = nblocks;
+        if (lo != 0 && until_wrap < run) {
+            run = (size_t)until_wrap;
+        }
+
+        fn(ks, hi, lo, out, run);
+        out += 16 * run;
+        nblocks -= run;
+        lo += run;
+        if (lo == 0) {
+            hi++;
+        }
+    }
+
+    size_t tail = out_len % 16;
+    if (tail) {
+        uint8_t block[16];
+        fn(ks, hi, lo, block, 1);
+        memcpy(out, block, tail);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef RS_AES_H
+#define RS_AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// NATIVE AES-256-CTR KEYSTREAM
+// ============================================================================
+
+/**
+ * In-tree AES-256-CTR backends for the short (1-16 KB) streams rs_prf needs
+ *
+ * - AESNI:  AES-NI, 8 blocks in flight per iteration
+ * - VAES:   AVX-512 VAES, 4 blocks per instruction, 16 in flight
+ * - ARMV8:  ARMv8 Crypto Extensions, 8 blocks in flight
+ *
+ * RS_AES_IMPL_OPENSSL means no native backend: callers use OpenSSL, which
+ * remains the reference the others are tested against.
+ */
+typedef enum {
+    RS_AES_IMPL_OPENSSL = 0,
+    RS_AES_IMPL_AESNI   = 1,
+    RS_AES_IMPL_VAES    = 2,
+    RS_AES_IMPL_ARMV8   = 3
+} rs_aes_impl_t;
+
+#define RS_AES256_ROUNDS 14
+
+/**
+ * Expanded AES-256 encryption key schedule (FIPS-197 byte order)
+ */
+typedef struct {
+    uint8_t rk[RS_AES256_ROUNDS + 1][16];
+} rs_aes256_key_t;
+
+/**
+ * Select the fastest backend the CPU supports
+ *
+ * Idempotent; call before sharing keyed PRFs between threads.
+ */
+void rs_aes_init(void);
+
+/**
+ * Whether a backend is compiled in and supported by this CPU
+ */
+int rs_aes_supported(rs_aes_impl_t impl);
+
+/**
+ * Force a backend (tests and benchmarks)
+ *
+ * @return          0, or -1 if impl is not supported
+ */
+int rs_aes_set_implementation(rs_aes_impl_t impl);
+
+/**
+ * Currently selected backend and its name
+ */
+rs_aes_impl_t rs_aes_get_implementation(void);
+const char *rs_aes_implementation_name(void);
+
+/**
+ * Expand a 32-byte key into the encryption round keys
+ */
+void rs_aes256_expand_key(rs_aes256_key_t *ks, const uint8_t key[32]);
+
+/**
+ * AES-256-CTR keystream with the selected backend
+ *
+ * Blocks are E(iv), E(iv + 1), ... with the counter block incremented as a
+ * 128-bit big-endian integer, as OpenSSL does. A trailing partial block is
+ * truncated.
+ *
+ * @param ks        Expanded key
+ * @param iv        Initial counter block
+ * @param out       Output buffer
+ * @param out_len   Number of bytes to generate
+ * @return          0, or -1 if the OpenSSL backend is selected (out untouched)
+ */
+int rs_aes256_ctr(const rs_aes256_key_t *ks,
+                  const uint8_t iv[16],
+                  uint8_t *out,
+                  size_t out_len);
+
+#endif // RS_AES_H
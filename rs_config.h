@@ -15,7 +15,8 @@
 #define RS_SECRET_DIM  (RS_N * RS_SLOT_COUNT)  // 256 = dimension of secret
 
 // Moduli for each layer (q₀, q₁, ..., q₆)
-// All satisfy qᵢ ≡ 1 (mod 128) for NTT-friendliness
+// All satisfy qᵢ ≡ 1 (mod 128) for NTT-friendliness: RS_A_RING mode runs
+// them on ntt64 (built-in layers for 257 and 3329, runtime layers otherwise)
 static const uint32_t RS_Q_LAYERS[RS_NUM_LAYERS] = {
     257u,        // ~8 bits
     3329u,       // ~12 bits (Kyber-ish)
@@ -0,0 +1,743 @@
+#include "rs_expand.h"
+#include "dntl_sched.h"
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+
+#define RS_NUM_FAMILIES 4
+
+// Entry states
+#define ENTRY_EMPTY   0
+#define ENTRY_FILLING 1
+#define ENTRY_READY   2
+
+// Rows of a dense block, and B or C rows, per task of a parallel expansion
+#define EXPAND_TASK_ROWS 16
+#define EXPAND_TASK_VEC_ROWS 4
+
+struct rs_expanded_params {
+    const rs_params_t *p;
+    int resident[RS_NUM_LAYERS];
+    int rows_resident;
+    size_t bytes;
+
+    // Resident layers, each [family][slot] at its width (rs_layer_width()),
+    // or as NTT-domain polynomials in RS_A_RING mode
+    uint8_t *A;
+    size_t a_offset[RS_NUM_LAYERS];     // of each resident layer in A
+    rs_row_t *B;                        // B rows, then C rows
+    rs_row_t *C;
+
+    // Storage from opts->alloc (NULL: aligned_alloc), and the copies of A
+    // and B on each NUMA node of a replicated set (copy[0] is A and B)
+    const dntl_allocator_t *alloc;
+    size_t a_bytes;
+    int replicas;
+    struct {
+        uint8_t *A;
+        rs_row_t *B;
+    } copy[DNTL_ALLOC_MAX_NODES];
+
+    atomic_uchar a_state[RS_NUM_LAYERS][RS_NUM_FAMILIES][RS_SLOT_COUNT];
+    atomic_uchar b_state[RS_PUBLIC_DIM];
+    atomic_uchar c_state[RS_PUBLIC_DIM];
+
+    // Parameter file mapping (A, B and C point into it), or NULL
+    void *map;
+    size_t map_bytes;
+
+    // The OpenSSL fallback shares one EVP context per family: derive alone
+    atomic_flag derive_lock;
+};
+
+// ============================================================================
+// DERIVATION
+// ============================================================================
+
+// Take the lock if derivation goes through OpenSSL; returns whether it did
+static int derive_lock(rs_expanded_params_t *e) {
+    if (rs_aes_get_implementation() != RS_AES_IMPL_OPENSSL) {
+        return 0;
+    }
+    while (atomic_flag_test_and_set_explicit(&e->derive_lock, memory_order_acquire)) {
+    }
+    return 1;
+}
+
+static void derive_unlock(rs_expanded_params_t *e, int locked) {
+    if (locked) {
+        atomic_flag_clear_explicit(&e->derive_lock, memory_order_release);
+    }
+}
+
+// Bytes of one layer-ell block, and of the whole layer, as stored for p
+static size_t block_bytes(const rs_params_t *p, int ell) {
+    if (p->a_mode == RS_A_RING) {
+        return sizeof(uint32_t) * RS_N;
+    }
+    return (size_t)RS_N * RS_N * (size_t)rs_layer_width(ell) / 8;
+}
+
+static size_t layer_bytes(const rs_params_t *p, int ell) {
+    return block_bytes(p, ell) * RS_NUM_FAMILIES * RS_SLOT_COUNT;
+}
+
+// The copy this thread reads: its node's if the set is replicated
+static int local_copy(const rs_expanded_params_t *e) {
+    return e->replicas > 1 ? dntl_numa_node() % e->replicas : 0;
+}
+
+static uint8_t *a_entry(const rs_expanded_params_t *e, int family, int ell, int slot) {
+    const uint8_t *A = e->replicas > 1 ? e->copy[local_copy(e)].A : e->A;
+    return (uint8_t *)A + e->a_offset[ell] +
+           ((size_t)family * RS_SLOT_COUNT + slot) * block_bytes(e->p, ell);
+}
+
+static void derive_A(rs_expanded_params_t *e, rs_family_t family, int ell, int slot,
+                     rs_matrix_t *out) {
+    int locked = derive_lock(e);
+    rs_derive_A(e->p, family, ell, slot, out);
+    derive_unlock(e, locked);
+}
+
+// Derive a resident entry as stored
+static void derive_entry(rs_expanded_params_t *e, rs_family_t family, int ell, int slot) {
+    uint8_t *entry = a_entry(e, family, ell, slot);
+    if (e->p->a_mode == RS_A_RING) {
+        int locked = derive_lock(e);
+        rs_derive_A_ring(e->p, family, ell, slot, (uint32_t *)entry);
+        derive_unlock(e, locked);
+    } else if (rs_layer_width(ell) == 16) {
+        int locked = derive_lock(e);
+        rs_derive_A16(e->p, family, ell, slot, (rs_matrix16_t *)entry);
+        derive_unlock(e, locked);
+    } else {
+        derive_A(e, family, ell, slot, (rs_matrix_t *)entry);
+    }
+}
+
+static void derive_B(rs_expanded_params_t *e, int row_idx, rs_row_t *out) {
+    int locked = derive_lock(e);
+    rs_derive_B_row(e->p, row_idx, RS_FLAVOR_LWR, out);
+    derive_unlock(e, locked);
+}
+
+static void derive_C(rs_expanded_params_t *e, int row_idx, rs_row_t *out) {
+    int locked = derive_lock(e);
+    rs_derive_C_row(e->p, row_idx, out);
+    derive_unlock(e, locked);
+}
+
+// ============================================================================
+// EAGER EXPANSION
+// ============================================================================
+
+typedef struct {
+    rs_expanded_params_t *e;
+    size_t count;
+    atomic_size_t next;
+} expand_job_t;
+
+static size_t block_tasks(const rs_params_t *p) {
+    return p->a_mode == RS_A_RING ? 1 : RS_N / EXPAND_TASK_ROWS;
+}
+
+static size_t expand_task_count(const rs_expanded_params_t *e) {
+    size_t count = e->rows_resident ? 2 * RS_PUBLIC_DIM / EXPAND_TASK_VEC_ROWS : 0;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        if (e->resident[ell]) {
+            count += (size_t)RS_NUM_FAMILIES * RS_SLOT_COUNT * block_tasks(e->p);
+        }
+    }
+    return count;
+}
+
+// Task t: the resident layers' blocks in order, then the B rows, then C
+static void expand_task(rs_expanded_params_t *e, size_t t) {
+    const size_t per_block = block_tasks(e->p);
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        const size_t n = (size_t)RS_NUM_FAMILIES * RS_SLOT_COUNT * per_block;
+        if (!e->resident[ell]) {
+            continue;
+        }
+        if (t >= n) {
+            t -= n;
+            continue;
+        }
+
+        rs_family_t family = (rs_family_t)(t / per_block / RS_SLOT_COUNT);
+        int slot = (int)(t / per_block % RS_SLOT_COUNT);
+        if (per_block == 1) {
+            derive_entry(e, family, ell, slot);
+            return;
+        }
+
+        const int r0 = (int)(t % per_block) * EXPAND_TASK_ROWS;
+        uint8_t *entry = a_entry(e, family, ell, slot);
+        int locked = derive_lock(e);
+        if (rs_layer_width(ell) == 16) {
+            uint32_t rows[EXPAND_TASK_ROWS][RS_N];
+            rs_derive_A_rows(e->p, family, ell, slot, r0, EXPAND_TASK_ROWS, rows);
+            rs_matrix16_t *A = (rs_matrix16_t *)entry;
+            for (int r = 0; r < EXPAND_TASK_ROWS; r++) {
+                for (int j = 0; j < RS_N; j++) {
+                    A->data[r0 + r][j] = (uint16_t)rows[r][j];
+                }
+            }
+        } else {
+            rs_matrix_t *A = (rs_matrix_t *)entry;
+            rs_derive_A_rows(e->p, family, ell, slot, r0, EXPAND_TASK_ROWS, &A->data[r0]);
+        }
+        derive_unlock(e, locked);
+        return;
+    }
+
+    // B and C rows: rs_derive_B_rows() takes their nonces four at a time
+    const int r0 = (int)(t % (RS_PUBLIC_DIM / EXPAND_TASK_VEC_ROWS)) * EXPAND_TASK_VEC_ROWS;
+    int locked = derive_lock(e);
+    if (t < RS_PUBLIC_DIM / EXPAND_TASK_VEC_ROWS) {
+        rs_derive_B_rows(e->p, r0, EXPAND_TASK_VEC_ROWS, RS_FLAVOR_LWR, &e->B[r0]);
+    } else {
+        rs_derive_C_rows(e->p, r0, EXPAND_TASK_VEC_ROWS, &e->C[r0]);
+    }
+    derive_unlock(e, locked);
+}
+
+static void expand_worker(void *arg) {
+    expand_job_t *job = arg;
+    size_t t;
+    while ((t = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed)) < job->count) {
+        expand_task(job->e, t);
+    }
+}
+
+// Derive every resident entry on up to threads threads, the caller's included
+static void expand_all(rs_expanded_params_t *e, int threads) {
+    expand_job_t job = { .e = e, .count = expand_task_count(e) };
+    atomic_init(&job.next, 0);
+
+    // Fewer threads than asked (the scheduler's workers are shared) only
+    // means more tasks for the ones running
+    const size_t wanted = threads > 1 ? (size_t)threads : 1;
+    dntl_sched_spread(wanted > 1 ? dntl_sched_default() : NULL, expand_worker, &job,
+                      wanted < job.count ? wanted : job.count);
+}
+
+/**
+ * Make a resident entry ready and report whether this caller must fill it
+ *
+ * @return  1 if the caller claimed the entry and must fill and publish it,
+ *          0 once another caller has published it
+ */
+static int claim(atomic_uchar *state) {
+    for (;;) {
+        unsigned char s = atomic_load_explicit(state, memory_order_acquire);
+        if (s == ENTRY_READY) {
+            return 0;
+        }
+        if (s == ENTRY_EMPTY) {
+            unsigned char expect = ENTRY_EMPTY;
+            if (atomic_compare_exchange_weak_explicit(state, &expect, ENTRY_FILLING,
+                                                      memory_order_acquire,
+                                                      memory_order_acquire)) {
+                return 1;
+            }
+        }
+        // Someone else is filling it: a derivation takes microseconds
+    }
+}
+
+static void publish(atomic_uchar *state) {
+    atomic_store_explicit(state, ENTRY_READY, memory_order_release);
+}
+
+// ============================================================================
+// CREATION
+// ============================================================================
+
+static void *storage_alloc(const rs_expanded_params_t *e, size_t bytes, int node) {
+    if (e->alloc) {
+        return e->alloc->alloc(e->alloc->user, bytes, node);
+    }
+    return aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+}
+
+static void storage_free(const rs_expanded_params_t *e, void *ptr, size_t bytes) {
+    if (!ptr) {
+        return;
+    }
+    if (e->alloc) {
+        e->alloc->free(e->alloc->user, ptr, bytes);
+    } else {
+        free(ptr);
+    }
+}
+
+// Copy the expanded A and B to every other node; each copy is written by
+// the caller but placed on its node by the allocator
+static int replicate_nodes(rs_expanded_params_t *e) {
+    const size_t rows_bytes = 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM;
+    const int nodes = dntl_numa_nodes();
+
+    e->copy[0].A = e->A;
+    e->copy[0].B = e->B;
+    for (int node = 1; node < nodes; node++) {
+        uint8_t *A = e->a_bytes ? storage_alloc(e, e->a_bytes, node) : NULL;
+        rs_row_t *B = e->rows_resident ? storage_alloc(e, rows_bytes, node) : NULL;
+        if ((e->a_bytes && !A) || (e->rows_resident && !B)) {
+            storage_free(e, A, e->a_bytes);
+            storage_free(e, B, rows_bytes);
+            return -1;
+        }
+        if (A) {
+            memcpy(A, e->A, e->a_bytes);
+        }
+        if (B) {
+            memcpy(B, e->B, rows_bytes);
+        }
+        e->copy[node].A = A;
+        e->copy[node].B = B;
+        e->replicas = node + 1;
+    }
+    return 0;
+}
+
+rs_expanded_params_t *rs_expanded_create(const rs_params_t *p, const rs_expand_opts_t *opts) {
+    static const int default_order[RS_NUM_LAYERS] = { 0, 1, 2, 3, 4, 5, 6 };
+    const int *order = (opts && opts->layer_order) ? opts->layer_order : default_order;
+    size_t budget = (opts && opts->budget_bytes) ? opts->budget_bytes : SIZE_MAX;
+    int lazy = opts ? opts->lazy : 0;
+
+    rs_expanded_params_t *e = calloc(1, sizeof(*e));
+    if (!e) {
+        return NULL;
+    }
+    e->p = p;
+    e->replicas = 1;
+    atomic_flag_clear(&e->derive_lock);
+
+    // B and C rows first: every LWR tag reads all of them
+    const size_t rows_bytes = 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM;
+    e->rows_resident = rows_bytes <= budget;
+    size_t used = e->rows_resident ? rows_bytes : 0;
+
+    // Layers are multiples of 64 bytes, so each starts aligned
+    int seen[RS_NUM_LAYERS] = { 0 };
+    size_t a_bytes = 0;
+    for (int i = 0; i < RS_NUM_LAYERS; i++) {
+        int ell = order[i];
+        if (ell < 0 || ell >= RS_NUM_LAYERS || seen[ell]) {
+            free(e);
+            return NULL;
+        }
+        seen[ell] = 1;
+        if (budget - used >= layer_bytes(p, ell)) {
+            e->resident[ell] = 1;
+            e->a_offset[ell] = a_bytes;
+            a_bytes += layer_bytes(p, ell);
+            used += layer_bytes(p, ell);
+        }
+    }
+    e->bytes = used;
+
+    // Replicas are only made of eager sets: lazy ones are written as read
+    const int replicate = opts && opts->replicate && !lazy;
+    e->alloc = opts ? opts->alloc : NULL;
+    e->a_bytes = a_bytes;
+    if (a_bytes > 0) {
+        e->A = storage_alloc(e, a_bytes, replicate ? 0 : -1);
+    }
+    if (e->rows_resident) {
+        e->B = storage_alloc(e, rows_bytes, replicate ? 0 : -1);
+        e->C = e->B ? e->B + RS_PUBLIC_DIM : NULL;
+    }
+    if ((a_bytes > 0 && !e->A) || (e->rows_resident && !e->B)) {
+        rs_expanded_destroy(e);
+        return NULL;
+    }
+
+    if (!lazy) {
+        // The joins order the workers' writes before the states
+        expand_all(e, opts ? opts->threads : 1);
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int family = 0; family < RS_NUM_FAMILIES; family++) {
+                for (int slot = 0; slot < RS_SLOT_COUNT && e->resident[ell]; slot++) {
+                    atomic_init(&e->a_state[ell][family][slot], ENTRY_READY);
+                }
+            }
+        }
+        for (int i = 0; i < RS_PUBLIC_DIM && e->rows_resident; i++) {
+            atomic_init(&e->b_state[i], ENTRY_READY);
+            atomic_init(&e->c_state[i], ENTRY_READY);
+        }
+        if (replicate && replicate_nodes(e) != 0) {
+            rs_expanded_destroy(e);
+            return NULL;
+        }
+    }
+    return e;
+}
+
+void rs_expanded_destroy(rs_expanded_params_t *e) {
+    if (!e) {
+        return;
+    }
+    if (e->map) {
+        munmap(e->map, e->map_bytes);
+    } else {
+        storage_free(e, e->A, e->a_bytes);
+        storage_free(e, e->B, e->rows_resident ? 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM : 0);
+        for (int node = 1; node < e->replicas; node++) {
+            storage_free(e, e->copy[node].A, e->a_bytes);
+            storage_free(e, e->copy[node].B, 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM);
+        }
+    }
+    free(e);
+}
+
+int rs_expanded_resident(const rs_expanded_params_t *e, int ell) {
+    return ell >= 0 && ell < RS_NUM_LAYERS && e->resident[ell];
+}
+
+size_t rs_expanded_bytes(const rs_expanded_params_t *e) {
+    return e->bytes;
+}
+
+int rs_expanded_replicas(const rs_expanded_params_t *e) {
+    return e->replicas;
+}
+
+int rs_expanded_is_mapped(const rs_expanded_params_t *e) {
+    return e->map != NULL;
+}
+
+// ============================================================================
+// READS
+// ============================================================================
+
+int rs_expanded_A_ref(rs_expanded_params_t *e,
+                      rs_family_t family,
+                      int ell,
+                      int slot,
+                      rs_matrix_t *scratch,
+                      rs_matrix_ref_t *A) {
+    if ((int)family < 0 || (int)family >= RS_NUM_FAMILIES ||
+        ell < 0 || ell >= RS_NUM_LAYERS || slot < 0 || slot >= RS_SLOT_COUNT) {
+        return -1;
+    }
+
+    A->ell = ell;
+    A->m16 = NULL;
+    A->m32 = NULL;
+    if (!e->resident[ell] || e->p->a_mode == RS_A_RING) {
+        if (!scratch) {
+            return -1;
+        }
+        derive_A(e, family, ell, slot, scratch);
+        A->m32 = scratch;
+        return 0;
+    }
+
+    atomic_uchar *state = &e->a_state[ell][family][slot];
+    if (claim(state)) {
+        derive_entry(e, family, ell, slot);
+        publish(state);
+    }
+    const uint8_t *entry = a_entry(e, family, ell, slot);
+    if (rs_layer_width(ell) == 16) {
+        A->m16 = (const rs_matrix16_t *)entry;
+    } else {
+        A->m32 = (const rs_matrix_t *)entry;
+    }
+    return 0;
+}
+
+const rs_matrix_t *rs_expanded_A(rs_expanded_params_t *e,
+                                 rs_family_t family,
+                                 int ell,
+                                 int slot,
+                                 rs_matrix_t *scratch) {
+    rs_matrix_ref_t A;
+    if (rs_expanded_A_ref(e, family, ell, slot, scratch, &A) != 0) {
+        return NULL;
+    }
+    if (A.m32) {
+        return A.m32;
+    }
+    if (!scratch) {
+        return NULL;
+    }
+    for (int i = 0; i < RS_N; i++) {
+        for (int j = 0; j < RS_N; j++) {
+            scratch->data[i][j] = A.m16->data[i][j];
+        }
+    }
+    return scratch;
+}
+
+const uint32_t *rs_expanded_A_ring(rs_expanded_params_t *e,
+                                   rs_family_t family,
+                                   int ell,
+                                   int slot,
+                                   uint32_t scratch[RS_N]) {
+    if (e->p->a_mode != RS_A_RING || (int)family < 0 || (int)family >= RS_NUM_FAMILIES ||
+        ell < 0 || ell >= RS_NUM_LAYERS || slot < 0 || slot >= RS_SLOT_COUNT) {
+        return NULL;
+    }
+
+    if (!e->resident[ell]) {
+        int locked = derive_lock(e);
+        rs_derive_A_ring(e->p, family, ell, slot, scratch);
+        derive_unlock(e, locked);
+        return scratch;
+    }
+
+    atomic_uchar *state = &e->a_state[ell][family][slot];
+    if (claim(state)) {
+        derive_entry(e, family, ell, slot);
+        publish(state);
+    }
+    return (const uint32_t *)a_entry(e, family, ell, slot);
+}
+
+int rs_expanded_A_times_vec(rs_expanded_params_t *e,
+                            rs_family_t family,
+                            int ell,
+                            int slot,
+                            const uint32_t x[RS_N],
+                            uint32_t y_out[RS_N]) {
+    if (ell >= 0 && ell < RS_NUM_LAYERS && !e->resident[ell]) {
+        int locked = derive_lock(e);
+        int rc = rs_A_times_vec(e->p, family, ell, slot, x, y_out);
+        derive_unlock(e, locked);
+        return rc;
+    }
+
+    if (e->p->a_mode == RS_A_RING) {
+        const uint32_t *a_ntt = rs_expanded_A_ring(e, family, ell, slot, NULL);
+        return a_ntt ? rs_ring_times_vec(e->p, ell, a_ntt, x, y_out) : -1;
+    }
+
+    rs_matrix_ref_t A;
+    if (rs_expanded_A_ref(e, family, ell, slot, NULL, &A) != 0) {
+        return -1;
+    }
+    return rs_matrix_times_vec(&A, x, y_out);
+}
+
+const rs_row_t *rs_expanded_B_row(rs_expanded_params_t *e,
+                                  int row_idx,
+                                  rs_row_t *scratch) {
+    if (row_idx < 0 || row_idx >= RS_PUBLIC_DIM) {
+        return NULL;
+    }
+
+    if (!e->rows_resident) {
+        derive_B(e, row_idx, scratch);
+        return scratch;
+    }
+
+    if (claim(&e->b_state[row_idx])) {
+        derive_B(e, row_idx, &e->B[row_idx]);
+        publish(&e->b_state[row_idx]);
+    }
+    return e->replicas > 1 ? &e->copy[local_copy(e)].B[row_idx] : &e->B[row_idx];
+}
+
+const rs_row_t *rs_expanded_C_row(rs_expanded_params_t *e,
+                                  int row_idx,
+                                  rs_row_t *scratch) {
+    if (row_idx < 0 || row_idx >= RS_PUBLIC_DIM) {
+        return NULL;
+    }
+
+    if (!e->rows_resident) {
+        derive_C(e, row_idx, scratch);
+        return scratch;
+    }
+
+    if (claim(&e->c_state[row_idx])) {
+        derive_C(e, row_idx, &e->C[row_idx]);
+        publish(&e->c_state[row_idx]);
+    }
+    return e->replicas > 1 ? &e->copy[local_copy(e)].B[RS_PUBLIC_DIM + row_idx]
+                           : &e->C[row_idx];
+}
+
+// ============================================================================
+// PARAMETER FILES
+// ============================================================================
+
+#define FILE_BYTE_ORDER 0x01020304u
+
+static size_t align_up(size_t v) {
+    return (v + RS_PARAMS_FILE_ALIGN - 1) & ~(size_t)(RS_PARAMS_FILE_ALIGN - 1);
+}
+
+// SHA3-256(RS_PARAMS_DIGEST_LABEL || six seeds)
+static int seeds_digest(const rs_params_t *p, uint8_t digest[32]) {
+    const uint8_t *seeds[6] = {
+        p->seed_ax, p->seed_ay, p->seed_orb_x, p->seed_orb_y, p->seed_B, p->seed_C
+    };
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    unsigned int len;
+    int ok = ctx && EVP_DigestInit_ex(ctx, EVP_sha3_256(), NULL) == 1 &&
+             EVP_DigestUpdate(ctx, RS_PARAMS_DIGEST_LABEL, strlen(RS_PARAMS_DIGEST_LABEL)) == 1;
+    for (int i = 0; i < 6 && ok; i++) {
+        ok = EVP_DigestUpdate(ctx, seeds[i], RS_SEED_BYTES) == 1;
+    }
+    ok = ok && EVP_DigestFinal_ex(ctx, digest, &len) == 1;
+    EVP_MD_CTX_free(ctx);
+    return ok ? 0 : -1;
+}
+
+// Header for p, with the section offsets of this build
+static int file_header(const rs_params_t *p, rs_params_file_header_t *h) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, RS_PARAMS_FILE_MAGIC, sizeof(h->magic));
+    h->version = RS_PARAMS_FILE_VERSION;
+    h->byte_order = FILE_BYTE_ORDER;
+    h->n = RS_N;
+    h->layers = RS_NUM_LAYERS;
+    h->slots = RS_SLOT_COUNT;
+    h->families = RS_NUM_FAMILIES;
+    h->public_dim = RS_PUBLIC_DIM;
+    h->secret_dim = RS_SECRET_DIM;
+    memcpy(h->q, RS_Q_LAYERS, sizeof(h->q));
+
+    h->a_mode = (uint32_t)p->a_mode;
+
+    size_t a_bytes = 0;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        h->width[ell] = p->a_mode == RS_A_RING ? 32 : (uint32_t)rs_layer_width(ell);
+        a_bytes += layer_bytes(p, ell);
+    }
+    const size_t rows_bytes = sizeof(rs_row_t) * RS_PUBLIC_DIM;
+    h->a_offset = align_up(sizeof(*h));
+    h->b_offset = align_up(h->a_offset + a_bytes);
+    h->c_offset = align_up(h->b_offset + rows_bytes);
+    h->file_bytes = h->c_offset + rows_bytes;
+    return seeds_digest(p, h->digest);
+}
+
+// Write len bytes at offset, zero-filling any gap since the last write
+static int write_at(FILE *f, uint64_t offset, const void *data, size_t len) {
+    long pos = ftell(f);
+    static const uint8_t zeros[RS_PARAMS_FILE_ALIGN] = { 0 };
+    if (pos < 0 || (uint64_t)pos > offset ||
+        fwrite(zeros, 1, (size_t)(offset - (uint64_t)pos), f) != (size_t)(offset - (uint64_t)pos)) {
+        return -1;
+    }
+    return fwrite(data, 1, len, f) == len ? 0 : -1;
+}
+
+int rs_params_save(const char *path, const rs_params_t *p) {
+    rs_params_file_header_t h;
+    if (file_header(p, &h) != 0) {
+        return -1;
+    }
+
+    rs_expanded_params_t *e = rs_expanded_create(p, NULL);
+    if (!e) {
+        return -1;
+    }
+
+    size_t tmp_len = strlen(path) + sizeof(".tmp.") + 20;
+    char *tmp = malloc(tmp_len);
+    FILE *f = NULL;
+    int ok = 0;
+    if (tmp) {
+        snprintf(tmp, tmp_len, "%s.tmp.%ld", path, (long)getpid());
+        f = fopen(tmp, "wb");
+    }
+    if (f) {
+        uint64_t offset = h.a_offset;
+        ok = write_at(f, 0, &h, sizeof(h)) == 0;
+        for (int ell = 0; ell < RS_NUM_LAYERS && ok; ell++) {
+            ok = write_at(f, offset, a_entry(e, 0, ell, 0), layer_bytes(p, ell)) == 0;
+            offset += layer_bytes(p, ell);
+        }
+        ok = ok &&
+             write_at(f, h.b_offset, e->B, sizeof(rs_row_t) * RS_PUBLIC_DIM) == 0 &&
+             write_at(f, h.c_offset, e->C, sizeof(rs_row_t) * RS_PUBLIC_DIM) == 0;
+        ok = (fclose(f) == 0) && ok;
+        ok = ok && rename(tmp, path) == 0;
+        if (!ok) {
+            remove(tmp);
+        }
+    }
+
+    free(tmp);
+    rs_expanded_destroy(e);
+    return ok ? 0 : -1;
+}
+
+// Mapping of path if it is a complete file for p, else NULL
+static rs_expanded_params_t *map_file(const char *path, const rs_params_t *p) {
+    rs_params_file_header_t want;
+    if (file_header(p, &want) != 0) {
+        return NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (uint64_t)st.st_size == want.file_bytes) {
+        map = mmap(NULL, (size_t)want.file_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    // Same layout, same build constants and same seeds, or nothing
+    rs_expanded_params_t *e = NULL;
+    if (memcmp(map, &want, sizeof(want)) == 0) {
+        e = calloc(1, sizeof(*e));
+    }
+    if (!e) {
+        munmap(map, (size_t)want.file_bytes);
+        return NULL;
+    }
+
+    e->p = p;
+    atomic_flag_clear(&e->derive_lock);
+    e->replicas = 1;
+    e->map = map;
+    e->map_bytes = (size_t)want.file_bytes;
+    e->bytes = e->map_bytes;
+    e->A = (uint8_t *)map + want.a_offset;
+    e->B = (rs_row_t *)((uint8_t *)map + want.b_offset);
+    e->C = (rs_row_t *)((uint8_t *)map + want.c_offset);
+    e->rows_resident = 1;
+    size_t a_bytes = 0;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        e->resident[ell] = 1;
+        e->a_offset[ell] = a_bytes;
+        a_bytes += layer_bytes(p, ell);
+        for (int family = 0; family < RS_NUM_FAMILIES; family++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                atomic_init(&e->a_state[ell][family][slot], ENTRY_READY);
+            }
+        }
+    }
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        atomic_init(&e->b_state[i], ENTRY_READY);
+        atomic_init(&e->c_state[i], ENTRY_READY);
+    }
+    return e;
+}
+
+rs_expanded_params_t *rs_params_map(const char *path, const rs_params_t *p) {
+    rs_expanded_params_t *e = map_file(path, p);
+    return e ? e : rs_expanded_create(p, NULL);
+}
@@ -0,0 +1,227 @@
+#ifndef RS_EXPAND_H
+#define RS_EXPAND_H
+
+#include "dntl_alloc.h"
+#include "rs_mats.h"
+
+// ============================================================================
+// EXPANDED PARAMETERS
+// ============================================================================
+
+/**
+ * All A matrices, the LWR-flavor B rows and the C rows of a parameter set,
+ * derived once
+ *
+ * A matrices are kept at their layer's width (rs_layer_width()): 16-bit
+ * layers take half the space. In RS_A_RING mode each block is kept as its
+ * NTT-domain polynomial instead, N words in all. Entries live in 64-byte-aligned storage and are read without locks from
+ * any number of threads. Lazy sets fill each entry on first use: one reader
+ * claims it with an atomic compare-and-swap and the others wait for it to be
+ * published. Layers that do not fit the memory budget are not kept; reads of
+ * them derive into the caller's scratch.
+ */
+typedef struct rs_expanded_params rs_expanded_params_t;
+
+/**
+ * Expansion options (NULL: eager, everything resident)
+ */
+typedef struct {
+    int lazy;                   // Fill entries on first use instead of at create
+    size_t budget_bytes;        // 0: no limit; else B/C rows, then whole layers in
+                                // layer_order, while they fit
+    const int *layer_order;     // RS_NUM_LAYERS layers, hottest first;
+                                // NULL: 0, 1, ..., RS_NUM_LAYERS - 1
+    int threads;                // Eager sets: threads deriving, the caller's
+                                // included; 0 or 1: the caller's alone
+    const dntl_allocator_t *alloc;  // A, B and C storage (dntl_alloc.h), e.g.
+                                // &dntl_allocator_huge; NULL: aligned_alloc
+    int replicate;              // Eager sets: one copy per NUMA node, each
+                                // thread reading its own node's
+} rs_expand_opts_t;
+
+/**
+ * Expand a parameter set
+ *
+ * An eager expansion is split into tasks of one NTT-domain block, a
+ * range of 16 rows of a dense block (AES-CTR is random
+ * access, so each range starts at its own counter), or four B or C rows.
+ * Threads take tasks in order from a shared counter and write disjoint
+ * bytes: the set is the same whatever the thread count.
+ *
+ * @param p     Parameters; must outlive the expanded set
+ * @param opts  Options, or NULL
+ * @return      Expanded set, or NULL on allocation failure or a bad
+ *              layer_order
+ */
+rs_expanded_params_t *rs_expanded_create(const rs_params_t *p, const rs_expand_opts_t *opts);
+
+/**
+ * Free an expanded set (NULL is ignored)
+ */
+void rs_expanded_destroy(rs_expanded_params_t *e);
+
+/**
+ * 1 if layer ell is kept in memory
+ */
+int rs_expanded_resident(const rs_expanded_params_t *e, int ell);
+
+/**
+ * Bytes of resident storage (of each copy if replicated)
+ */
+size_t rs_expanded_bytes(const rs_expanded_params_t *e);
+
+/**
+ * Copies of the resident storage: the NUMA nodes of a replicated eager set,
+ * else 1
+ */
+int rs_expanded_replicas(const rs_expanded_params_t *e);
+
+/**
+ * A[family][ell][slot] at its stored width
+ *
+ * In RS_A_RING mode the matrix is always expanded into scratch.
+ *
+ * @param scratch Filled at 32 bits and referenced if the layer is not
+ *                resident (may be NULL for resident dense layers)
+ * @param A       Receives the view
+ * @return        0, or -1 if an argument is out of range or a scratch is
+ *                needed and missing
+ */
+int rs_expanded_A_ref(rs_expanded_params_t *e,
+                      rs_family_t family,
+                      int ell,
+                      int slot,
+                      rs_matrix_t *scratch,
+                      rs_matrix_ref_t *A);
+
+/**
+ * A[family][ell][slot] at 32 bits, as rs_derive_A() would produce it
+ *
+ * @param scratch Filled and returned if the layer is not resident or is
+ *                stored at 16 bits (may be NULL only for resident 32-bit
+ *                layers)
+ * @return        The matrix, or NULL if an argument is out of range or a
+ *                scratch is needed and missing
+ */
+const rs_matrix_t *rs_expanded_A(rs_expanded_params_t *e,
+                                 rs_family_t family,
+                                 int ell,
+                                 int slot,
+                                 rs_matrix_t *scratch);
+
+/**
+ * NTT-domain polynomial of A[family][ell][slot], as rs_derive_A_ring()
+ * would produce it
+ *
+ * @param scratch Filled and returned if the layer is not resident
+ * @return        The polynomial, or NULL if an argument is out of range or
+ *                the parameters are not in RS_A_RING mode
+ */
+const uint32_t *rs_expanded_A_ring(rs_expanded_params_t *e,
+                                   rs_family_t family,
+                                   int ell,
+                                   int slot,
+                                   uint32_t scratch[RS_N]);
+
+/**
+ * y = A[family][ell][slot]·x mod q, as rs_A_times_vec() computes it
+ *
+ * Reads resident layers at their stored width; streams the others.
+ *
+ * @return  0, or -1 if an argument is out of range
+ */
+int rs_expanded_A_times_vec(rs_expanded_params_t *e,
+                            rs_family_t family,
+                            int ell,
+                            int slot,
+                            const uint32_t x[RS_N],
+                            uint32_t y_out[RS_N]);
+
+/**
+ * B[row_idx] with RS_FLAVOR_LWR, as rs_derive_B_row() would produce it
+ *
+ * @param row_idx Row index (0..RS_PUBLIC_DIM-1)
+ * @param scratch Filled and returned if B rows are not resident
+ * @return        The row, or NULL if row_idx is out of range
+ */
+const rs_row_t *rs_expanded_B_row(rs_expanded_params_t *e,
+                                  int row_idx,
+                                  rs_row_t *scratch);
+
+/**
+ * C[row_idx], as rs_derive_C_row() would produce it
+ *
+ * @param row_idx Row index (0..RS_PUBLIC_DIM-1)
+ * @param scratch Filled and returned if C rows are not resident
+ * @return        The row, or NULL if row_idx is out of range
+ */
+const rs_row_t *rs_expanded_C_row(rs_expanded_params_t *e,
+                                  int row_idx,
+                                  rs_row_t *scratch);
+
+// ============================================================================
+// PARAMETER FILES
+// ============================================================================
+
+/**
+ * Expanded parameter file layout (version 3, host byte order)
+ *
+ *     header  rs_params_file_header_t, padded to RS_PARAMS_FILE_ALIGN
+ *     A       for ell = 0..RS_NUM_LAYERS-1: [4][RS_SLOT_COUNT] blocks, each
+ *             a matrix at width[ell] bits per entry (rs_matrix16_t or
+ *             rs_matrix_t), or in RS_A_RING mode an NTT-domain polynomial
+ *             (uint32_t[RS_N])
+ *     B       rs_row_t[RS_PUBLIC_DIM]  (RS_FLAVOR_LWR)
+ *     C       rs_row_t[RS_PUBLIC_DIM]
+ *
+ * Sections start at multiples of RS_PARAMS_FILE_ALIGN, so a mapping is
+ * 64-byte aligned throughout. byte_order rejects files from hosts of the
+ * other endianness. digest is SHA3-256 over RS_PARAMS_DIGEST_LABEL
+ * and the six seeds; a file only serves the parameters it was made from.
+ */
+#define RS_PARAMS_FILE_MAGIC    "RSPARAMS"
+#define RS_PARAMS_FILE_VERSION  3
+#define RS_PARAMS_FILE_ALIGN    64
+#define RS_PARAMS_DIGEST_LABEL  "RS_PARAMS_FILE"
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // 0x01020304 as written
+    uint32_t n, layers, slots, families, public_dim, secret_dim;
+    uint32_t q[RS_NUM_LAYERS];
+    uint32_t a_mode;                // rs_a_mode_t
+    uint32_t width[RS_NUM_LAYERS];  // rs_layer_width(), 32 in RS_A_RING mode
+    uint64_t a_offset, b_offset, c_offset, file_bytes;
+    uint8_t digest[32];
+} rs_params_file_header_t;
+
+/**
+ * Write the expanded parameters of p to path
+ *
+ * The file is written next to path and renamed into place, so concurrent
+ * rs_params_map() calls never see a partial file.
+ *
+ * @return      0, or -1 on error
+ */
+int rs_params_save(const char *path, const rs_params_t *p);
+
+/**
+ * Map an expanded parameter file read-only
+ *
+ * Processes mapping the same file share one page-cache copy. If the file is
+ * missing, malformed, or was made from other seeds, the set is expanded in
+ * memory instead (rs_expanded_create() with no options).
+ *
+ * @param path  File written by rs_params_save()
+ * @param p     Parameters the file must match; must outlive the set
+ * @return      Expanded set, or NULL if even regeneration fails
+ */
+rs_expanded_params_t *rs_params_map(const char *path, const rs_params_t *p);
+
+/**
+ * 1 if the set is served from a mapped file
+ */
+int rs_expanded_is_mapped(const rs_expanded_params_t *e);
+
+#endif // RS_EXPAND_H
@@ -1,38 +1,460 @@
 #include "rs_lwr.h"
+#include "dntl_stats.h"
 #include "rs_prf.h"
 #include <stdint.h>
-#include <stdlib.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 // ============================================================================
 // LWR TAG COMPUTATION
 // ============================================================================
 
+static inline uint16_t lwr_round(uint32_t u) {
+    // Truncate by shifting right, then reduce: ⌊u / 2^shift⌋ mod p
+    return (uint16_t)((u >> RS_LWR_SHIFT) % RS_P_SMALL);
+}
+
+/**
+ * acc[r][k] = rows[r] · s[k] mod 2^32 for r < nr, k < ns
+ *
+ * Inlined with constant nr and ns, the accumulators stay in registers:
+ * each row vector is loaded once for all ns secrets and each s vector once
+ * for all nr rows.
+ */
+static inline __attribute__((always_inline))
+void dot_tile(const rs_row_t *const rows[RS_LWR_TILE],
+              int nr,
+              const int32_t *const s[RS_LWR_TILE],
+              int ns,
+              uint32_t acc[RS_LWR_TILE][RS_LWR_TILE]) {
+    #if defined(__AVX512F__)
+    __m512i sum[RS_LWR_TILE][RS_LWR_TILE];
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            sum[r][k] = _mm512_setzero_si512();
+        }
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j += 16) {
+        __m512i sv[RS_LWR_TILE];
+        for (int k = 0; k < ns; k++) {
+            sv[k] = _mm512_loadu_si512((const void *)(s[k] + j));
+        }
+        for (int r = 0; r < nr; r++) {
+            __m512i b = _mm512_loadu_si512((const void *)(rows[r]->data + j));
+            for (int k = 0; k < ns; k++) {
+                sum[r][k] = _mm512_add_epi32(sum[r][k], _mm512_mullo_epi32(b, sv[k]));
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            acc[r][k] = (uint32_t)_mm512_reduce_add_epi32(sum[r][k]);
+        }
+    }
+    #elif defined(__AVX2__)
+    __m256i sum[RS_LWR_TILE][RS_LWR_TILE];
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            sum[r][k] = _mm256_setzero_si256();
+        }
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j += 8) {
+        __m256i sv[RS_LWR_TILE];
+        for (int k = 0; k < ns; k++) {
+            sv[k] = _mm256_loadu_si256((const __m256i *)(s[k] + j));
+        }
+        for (int r = 0; r < nr; r++) {
+            __m256i b = _mm256_loadu_si256((const __m256i *)(rows[r]->data + j));
+            for (int k = 0; k < ns; k++) {
+                sum[r][k] = _mm256_add_epi32(sum[r][k], _mm256_mullo_epi32(b, sv[k]));
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            __m128i h = _mm_add_epi32(_mm256_castsi256_si128(sum[r][k]),
+                                      _mm256_extracti128_si256(sum[r][k], 1));
+            h = _mm_add_epi32(h, _mm_shuffle_epi32(h, 0x4E));
+            h = _mm_add_epi32(h, _mm_shuffle_epi32(h, 0xB1));
+            acc[r][k] = (uint32_t)_mm_cvtsi128_si32(h);
+        }
+    }
+    #elif defined(__aarch64__)
+    uint32x4_t sum[RS_LWR_TILE][RS_LWR_TILE];
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            sum[r][k] = vdupq_n_u32(0);
+        }
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j += 4) {
+        uint32x4_t sv[RS_LWR_TILE];
+        for (int k = 0; k < ns; k++) {
+            sv[k] = vreinterpretq_u32_s32(vld1q_s32(s[k] + j));
+        }
+        for (int r = 0; r < nr; r++) {
+            uint32x4_t b = vld1q_u32(rows[r]->data + j);
+            for (int k = 0; k < ns; k++) {
+                sum[r][k] = vmlaq_u32(sum[r][k], b, sv[k]);
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            acc[r][k] = vaddvq_u32(sum[r][k]);
+        }
+    }
+    #else
+    for (int r = 0; r < nr; r++) {
+        for (int k = 0; k < ns; k++) {
+            uint32_t a = 0;
+            for (int j = 0; j < RS_SECRET_DIM; j++) {
+                a += rows[r]->data[j] * (uint32_t)s[k][j];
+            }
+            acc[r][k] = a;
+        }
+    }
+    #endif
+}
+
 void rs_lwr_tag(const rs_row_t *B_rows,
                 const int32_t *s,
                 uint16_t t_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    const int32_t *const sk[RS_LWR_TILE] = { s, s, s, s };
+    uint32_t acc[RS_LWR_TILE][RS_LWR_TILE];
+
+    for (int i = 0; i < RS_PUBLIC_DIM; i += RS_LWR_TILE) {
+        const rs_row_t *const rows[RS_LWR_TILE] = {
+            &B_rows[i], &B_rows[i + 1], &B_rows[i + 2], &B_rows[i + 3]
+        };
+        dot_tile(rows, RS_LWR_TILE, sk, 1, acc);
+        for (int r = 0; r < RS_LWR_TILE; r++) {
+            t_out[i + r] = lwr_round(acc[r][0]);
+        }
+    }
+}
+
+void rs_lwr_tag_interleaved(const rs_B_interleaved_t *B,
+                            const int32_t *s,
+                            uint16_t t_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    uint32_t acc[RS_PUBLIC_DIM];
+
+    #if defined(__AVX512F__)
+    __m512i sum[RS_PUBLIC_DIM / 16];
+    for (int r = 0; r < RS_PUBLIC_DIM / 16; r++) {
+        sum[r] = _mm512_setzero_si512();
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j++) {
+        const __m512i sv = _mm512_set1_epi32(s[j]);
+        for (int r = 0; r < RS_PUBLIC_DIM / 16; r++) {
+            __m512i b = _mm512_loadu_si512((const void *)(B->data[j] + 16 * r));
+            sum[r] = _mm512_add_epi32(sum[r], _mm512_mullo_epi32(b, sv));
+        }
+    }
+    for (int r = 0; r < RS_PUBLIC_DIM / 16; r++) {
+        _mm512_storeu_si512((void *)(acc + 16 * r), sum[r]);
+    }
+    #elif defined(__AVX2__)
+    __m256i sum[RS_PUBLIC_DIM / 8];
+    for (int r = 0; r < RS_PUBLIC_DIM / 8; r++) {
+        sum[r] = _mm256_setzero_si256();
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j++) {
+        const __m256i sv = _mm256_set1_epi32(s[j]);
+        for (int r = 0; r < RS_PUBLIC_DIM / 8; r++) {
+            __m256i b = _mm256_loadu_si256((const __m256i *)(B->data[j] + 8 * r));
+            sum[r] = _mm256_add_epi32(sum[r], _mm256_mullo_epi32(b, sv));
+        }
+    }
+    for (int r = 0; r < RS_PUBLIC_DIM / 8; r++) {
+        _mm256_storeu_si256((__m256i *)(acc + 8 * r), sum[r]);
+    }
+    #elif defined(__aarch64__)
+    uint32x4_t sum[RS_PUBLIC_DIM / 4];
+    for (int r = 0; r < RS_PUBLIC_DIM / 4; r++) {
+        sum[r] = vdupq_n_u32(0);
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j++) {
+        const uint32_t sj = (uint32_t)s[j];
+        for (int r = 0; r < RS_PUBLIC_DIM / 4; r++) {
+            sum[r] = vmlaq_n_u32(sum[r], vld1q_u32(B->data[j] + 4 * r), sj);
+        }
+    }
+    for (int r = 0; r < RS_PUBLIC_DIM / 4; r++) {
+        vst1q_u32(acc + 4 * r, sum[r]);
+    }
+    #else
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        acc[i] = 0;
+    }
+    for (int j = 0; j < RS_SECRET_DIM; j++) {
+        const uint32_t sj = (uint32_t)s[j];
+        for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+            acc[i] += B->data[j][i] * sj;
+        }
+    }
+    #endif
+
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        t_out[i] = lwr_round(acc[i]);
+    }
+}
+
+// Row i of each set against s, with nr = n_sets (+ 1 for C) as a constant
+static inline __attribute__((always_inline))
+void multi_rows(const rs_row_t *const sets[RS_LWR_TILE],
+                int nr,
+                const int32_t *const sk[RS_LWR_TILE],
+                int i,
+                uint32_t acc[RS_LWR_TILE][RS_LWR_TILE]) {
+    const rs_row_t *const rows[RS_LWR_TILE] = {
+        &sets[0][i], nr > 1 ? &sets[1][i] : NULL,
+        nr > 2 ? &sets[2][i] : NULL, nr > 3 ? &sets[3][i] : NULL
+    };
+    dot_tile(rows, nr, sk, 1, acc);
+}
+
+int rs_lwr_tag_multi(const rs_row_t *const B_sets[],
+                     int n_sets,
+                     const rs_row_t *C_rows,
+                     const int32_t *s,
+                     uint16_t T_out[][RS_PUBLIC_DIM],
+                     uint32_t c_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    const int nr = n_sets + (C_rows != NULL);
+    if (n_sets < 0 || n_sets > RS_LWR_MAX_SETS || nr == 0) {
+        return -1;
+    }
+
+    const rs_row_t *sets[RS_LWR_TILE] = { NULL };
+    for (int k = 0; k < n_sets; k++) {
+        sets[k] = B_sets[k];
+    }
+    if (C_rows) {
+        sets[n_sets] = C_rows;
+    }
+
+    const int32_t *const sk[RS_LWR_TILE] = { s, s, s, s };
+    uint32_t acc[RS_LWR_TILE][RS_LWR_TILE];
     for (int i = 0; i < RS_PUBLIC_DIM; i++) {
-        // Compute inner product: B[i] · s
-        uint64_t acc = 0;
+        switch (nr) {
+            case 1: multi_rows(sets, 1, sk, i, acc); break;
+            case 2: multi_rows(sets, 2, sk, i, acc); break;
+            case 3: multi_rows(sets, 3, sk, i, acc); break;
+            default: multi_rows(sets, 4, sk, i, acc); break;
+        }
+        for (int k = 0; k < n_sets; k++) {
+            T_out[k][i] = lwr_round(acc[k][0]);
+        }
+        if (C_rows) {
+            c_out[i] = acc[n_sets][0];
+        }
+    }
+    return 0;
+}
+
+int rs_lwr_tag_from_seed(const rs_params_t *p,
+                         rs_flavor_t flavor,
+                         const int32_t *s,
+                         uint16_t t_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    const int32_t *const sk[RS_LWR_TILE] = { s, s, s, s };
+    uint32_t acc[RS_LWR_TILE][RS_LWR_TILE];
+    rs_row_t buf[RS_LWR_TILE];
+    const rs_row_t *const rows[RS_LWR_TILE] = { &buf[0], &buf[1], &buf[2], &buf[3] };
+
+    for (int i = 0; i < RS_PUBLIC_DIM; i += RS_LWR_TILE) {
+        if (rs_derive_B_rows(p, i, RS_LWR_TILE, flavor, buf) != 0) {
+            return -1;
+        }
+        dot_tile(rows, RS_LWR_TILE, sk, 1, acc);
+        for (int r = 0; r < RS_LWR_TILE; r++) {
+            t_out[i + r] = lwr_round(acc[r][0]);
+        }
+    }
+    return 0;
+}
+
+// 1 if the sign/magnitude kernel beats this build's multiply kernel
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE4_1__) || defined(__aarch64__)
+#define LWR_PREFER_MASKS 0
+#else
+#define LWR_PREFER_MASKS 1
+#endif
 
+/**
+ * rs_lwr_tag() for |s[j]| <= RS_LWR_SMALL_BOUND without multiplies
+ *
+ * With n = -[s < 0] (all ones for negative s) and |s| = b0 + 2·b1,
+ *
+ *     B·s = |s|·(B ^ n) + |s|·[s < 0]
+ *
+ * since B ^ n = -B - 1 when n is all ones. The first term is
+ * ((B ^ n) & -b0) + 2·((B ^ n) & -b1); the second is the same for every
+ * row and is added once.
+ */
+static void lwr_tag_masks(const rs_row_t *B_rows,
+                          const int32_t *s,
+                          uint16_t t_out[RS_PUBLIC_DIM]) {
+    uint32_t m0[RS_SECRET_DIM], m1[RS_SECRET_DIM], neg[RS_SECRET_DIM];
+    uint32_t corr = 0;
+    for (int j = 0; j < RS_SECRET_DIM; j++) {
+        uint32_t n = (uint32_t)(s[j] >> 31);
+        uint32_t mag = ((uint32_t)s[j] ^ n) - n;
+        m0[j] = 0u - (mag & 1);
+        m1[j] = 0u - ((mag >> 1) & 1);
+        neg[j] = n;
+        corr += mag & n;
+    }
+
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        uint32_t a0 = 0, a1 = 0;
         for (int j = 0; j < RS_SECRET_DIM; j++) {
-            // B[i][j] is uint32_t, s[j] is int32_t
-            // Product fits in int64_t, accumulate in uint64_t
-            int64_t product = (int64_t)B_rows[i].data[j] * (int64_t)s[j];
-            acc += (uint64_t)product;
+            uint32_t c = B_rows[i].data[j] ^ neg[j];
+            a0 += c & m0[j];
+            a1 += c & m1[j];
         }
+        t_out[i] = lwr_round(a0 + 2 * a1 + corr);
+    }
+}
 
-        // acc is now (B[i] · s) mod 2^64
-        // We want it mod 2^32 first
-        uint32_t u = (uint32_t)acc;  // Implicit mod 2^32
+void rs_lwr_tag_bounded(const rs_row_t *B_rows,
+                        const int32_t *s,
+                        int32_t bound,
+                        uint16_t t_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    if (LWR_PREFER_MASKS && bound >= 0 && bound <= RS_LWR_SMALL_BOUND) {
+        lwr_tag_masks(B_rows, s, t_out);
+    } else {
+        rs_lwr_tag(B_rows, s, t_out);
+    }
+}
 
-        // Truncate by shifting right: ⌊u / 2^shift⌋
-        uint32_t v = u >> RS_LWR_SHIFT;
+void rs_lwr_tag_batch(const rs_row_t *B_rows,
+                      const int32_t S[][RS_SECRET_DIM],
+                      size_t n_secrets,
+                      uint16_t T_out[][RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    uint32_t acc[RS_LWR_TILE][RS_LWR_TILE];
+    size_t k0 = 0;
 
-        // Final modulus: v mod p
-        t_out[i] = (uint16_t)(v % RS_P_SMALL);
+    // Full tiles of secrets: each tile is 4 KB and stays in L1 while all
+    // of B streams past it
+    for (; k0 + RS_LWR_TILE <= n_secrets; k0 += RS_LWR_TILE) {
+        const int32_t *const sk[RS_LWR_TILE] = { S[k0], S[k0 + 1], S[k0 + 2], S[k0 + 3] };
+        for (int i = 0; i < RS_PUBLIC_DIM; i += RS_LWR_TILE) {
+            const rs_row_t *const rows[RS_LWR_TILE] = {
+                &B_rows[i], &B_rows[i + 1], &B_rows[i + 2], &B_rows[i + 3]
+            };
+            dot_tile(rows, RS_LWR_TILE, sk, RS_LWR_TILE, acc);
+            for (int r = 0; r < RS_LWR_TILE; r++) {
+                for (int k = 0; k < RS_LWR_TILE; k++) {
+                    T_out[k0 + k][i + r] = lwr_round(acc[r][k]);
+                }
+            }
+        }
+    }
+
+    for (; k0 < n_secrets; k0++) {
+        rs_lwr_tag(B_rows, S[k0], T_out[k0]);
     }
 }
 
+// ============================================================================
+// INCREMENTAL TAGS
+// ============================================================================
+
+void rs_lwr_state_init(rs_lwr_state_t *st,
+                       const rs_row_t *B_rows,
+                       const int32_t *s,
+                       uint16_t t_out[RS_PUBLIC_DIM]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_LWR_TAG);
+    const int32_t *const sk[RS_LWR_TILE] = { s, s, s, s };
+    uint32_t acc[RS_LWR_TILE][RS_LWR_TILE];
+
+    st->B_rows = B_rows;
+    for (int i = 0; i < RS_PUBLIC_DIM; i += RS_LWR_TILE) {
+        const rs_row_t *const rows[RS_LWR_TILE] = {
+            &B_rows[i], &B_rows[i + 1], &B_rows[i + 2], &B_rows[i + 3]
+        };
+        dot_tile(rows, RS_LWR_TILE, sk, 1, acc);
+        for (int r = 0; r < RS_LWR_TILE; r++) {
+            st->acc[i + r] = acc[r][0];
+        }
+    }
+    if (t_out) {
+        rs_lwr_state_tag(st, t_out);
+    }
+}
+
+// acc[i] += Σ_t B[i][idx[t]]·delta[t]; indices already checked
+static void state_add(const rs_row_t *B_rows,
+                      const uint32_t acc_in[RS_PUBLIC_DIM],
+                      const uint16_t *idx,
+                      const int8_t *delta8,
+                      const int32_t *delta32,
+                      size_t k,
+                      uint32_t acc_out[RS_PUBLIC_DIM]) {
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        const uint32_t *b = B_rows[i].data;
+        uint32_t a = acc_in[i];
+        for (size_t t = 0; t < k; t++) {
+            int32_t d = delta8 ? delta8[t] : delta32[t];
+            a += b[idx[t]] * (uint32_t)d;
+        }
+        acc_out[i] = a;
+    }
+}
+
+int rs_lwr_state_update(rs_lwr_state_t *st,
+                        const uint16_t *idx,
+                        const int32_t *delta,
+                        size_t k,
+                        uint16_t t_out[RS_PUBLIC_DIM]) {
+    for (size_t t = 0; t < k; t++) {
+        if (idx[t] >= RS_SECRET_DIM) {
+            return -1;
+        }
+    }
+
+    state_add(st->B_rows, st->acc, idx, NULL, delta, k, st->acc);
+    if (t_out) {
+        rs_lwr_state_tag(st, t_out);
+    }
+    return 0;
+}
+
+void rs_lwr_state_tag(const rs_lwr_state_t *st, uint16_t t_out[RS_PUBLIC_DIM]) {
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        t_out[i] = lwr_round(st->acc[i]);
+    }
+}
+
+int rs_lwr_state_tag_delta(const rs_lwr_state_t *st,
+                           const sparse_vector_t *delta,
+                           uint16_t t_out[RS_PUBLIC_DIM]) {
+    if (delta->dimension != RS_SECRET_DIM) {
+        return -1;
+    }
+    for (uint16_t t = 0; t < delta->count; t++) {
+        if (delta->indices[t] >= RS_SECRET_DIM) {
+            return -1;
+        }
+    }
+
+    uint32_t acc[RS_PUBLIC_DIM];
+    state_add(st->B_rows, st->acc, delta->indices, delta->values, NULL, delta->count, acc);
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        t_out[i] = lwr_round(acc[i]);
+    }
+    return 0;
+}
+
 // ============================================================================
 // SECRET GENERATION FOR TESTING
 // ============================================================================
@@ -46,10 +468,8 @@ void rs_generate_secret(int32_t s_out[RS_SECRET_DIM],
     // Derive key from seed
     rs_derive_aes_key(seed, "SECRET", key);
 
-    // Generate RS_SECRET_DIM bytes
-    uint8_t *buf = malloc(RS_SECRET_DIM);
-    if (!buf) return;
-
+    // Generate RS_SECRET_DIM bytes (small enough for the stack)
+    uint8_t buf[RS_SECRET_DIM];
     rs_prf_aes256_ctr(key, nonce, 0, buf, RS_SECRET_DIM);
 
     // Map bytes to {-3, -2, -1, 0, 1, 2, 3}
@@ -57,6 +477,4 @@ void rs_generate_secret(int32_t s_out[RS_SECRET_DIM],
     for (int i = 0; i < RS_SECRET_DIM; i++) {
         s_out[i] = (int32_t)(buf[i] % 7) - 3;
     }
-
-    free(buf);
 }
@@ -2,6 +2,7 @@
 #define RS_LWR_H
 
 #include "rs_mats.h"
+#include "sparse_encoding.h"
 
 // ============================================================================
 // LWR (LEARNING WITH ROUNDING) PUBLIC MAP
@@ -18,6 +19,9 @@
  * - For each row i: acc_i = Σⱼ B[i][j] · s[j] mod 2^32
  * - t[i] = ⌊acc_i / 2^shift⌋ mod p
  *
+ * Only the low 32 bits of acc_i matter, so the products are 32-bit
+ * wrapping multiplies: 16 (AVX-512), 8 (AVX2) or 4 (NEON) per instruction.
+ *
  * @param B_rows  Array of RS_PUBLIC_DIM row vectors
  * @param s       Secret vector of length RS_SECRET_DIM
  * @param t_out   Output tag of length RS_PUBLIC_DIM
@@ -26,6 +30,176 @@ void rs_lwr_tag(const rs_row_t *B_rows,
                 const int32_t *s,
                 uint16_t t_out[RS_PUBLIC_DIM]);
 
+/**
+ * rs_lwr_tag() on the column-interleaved layout (rs_mats.h)
+ *
+ * Each column of B is scaled by a broadcast s[j] and added into the 64
+ * row accumulators, which stay in registers for the whole pass (4 AVX-512,
+ * 8 AVX2 or 16 NEON vectors); no horizontal sums are needed.
+ *
+ * @param B       B from rs_derive_B_interleaved() or rs_B_interleave()
+ * @param s       Secret vector of length RS_SECRET_DIM
+ * @param t_out   Output tag of length RS_PUBLIC_DIM
+ */
+void rs_lwr_tag_interleaved(const rs_B_interleaved_t *B,
+                            const int32_t *s,
+                            uint16_t t_out[RS_PUBLIC_DIM]);
+
+// Secrets rs_lwr_tag_batch() multiplies per pass over B (and rows per step)
+#define RS_LWR_TILE 4
+
+/**
+ * LWR tags of many secrets: T[k] = rs_lwr_tag(B_rows, S[k])
+ *
+ * Computes T = ⌊(B · S^T) / 2^shift⌋ mod p as a tiled matrix product:
+ * RS_LWR_TILE rows of B meet RS_LWR_TILE secrets at a time, so each B word
+ * loaded feeds RS_LWR_TILE products and B (64 KB) stays in cache across
+ * the batch.
+ *
+ * @param B_rows     Array of RS_PUBLIC_DIM row vectors
+ * @param S          n_secrets secret vectors
+ * @param n_secrets  Number of secrets (0 is allowed)
+ * @param T_out      n_secrets output tags
+ */
+void rs_lwr_tag_batch(const rs_row_t *B_rows,
+                      const int32_t S[][RS_SECRET_DIM],
+                      size_t n_secrets,
+                      uint16_t T_out[][RS_PUBLIC_DIM]);
+
+// B row sets rs_lwr_tag_multi() tags per pass (one per flavor)
+#define RS_LWR_MAX_SETS 3
+
+/**
+ * Tags of several B row sets and the exact C product, in one pass over s
+ *
+ *     T_out[k][i] = rs_lwr_tag(B_sets[k], s)[i]
+ *     c_out[i]    = C_rows[i] · s mod 2^32   (exact gadget, no rounding)
+ *
+ * Each chunk of s is loaded once and multiplied against row i of every set,
+ * so s is streamed once instead of once per flavor.
+ *
+ * @param B_sets  n_sets arrays of RS_PUBLIC_DIM rows (e.g. one per flavor)
+ * @param n_sets  0..RS_LWR_MAX_SETS
+ * @param C_rows  RS_PUBLIC_DIM C rows, or NULL for no exact product
+ * @param s       Secret vector of length RS_SECRET_DIM
+ * @param T_out   n_sets output tags
+ * @param c_out   Exact products (unused if C_rows is NULL)
+ * @return        0, or -1 if n_sets is out of range or nothing is asked
+ */
+int rs_lwr_tag_multi(const rs_row_t *const B_sets[],
+                     int n_sets,
+                     const rs_row_t *C_rows,
+                     const int32_t *s,
+                     uint16_t T_out[][RS_PUBLIC_DIM],
+                     uint32_t c_out[RS_PUBLIC_DIM]);
+
+/**
+ * rs_lwr_tag() of B rows derived on the fly: one-shot tags without B
+ *
+ * Derives RS_LWR_TILE rows at a time into a 4 KB buffer and multiplies
+ * them while they are in L1, instead of materializing all RS_PUBLIC_DIM
+ * rows (64 KB) first. Same result as rs_derive_B_row() for every row
+ * followed by rs_lwr_tag().
+ *
+ * @param p       Parameter structure
+ * @param flavor  Flavor of the B rows
+ * @param s       Secret vector of length RS_SECRET_DIM
+ * @param t_out   Output tag of length RS_PUBLIC_DIM
+ * @return        0, or -1 if flavor is unknown
+ */
+int rs_lwr_tag_from_seed(const rs_params_t *p,
+                         rs_flavor_t flavor,
+                         const int32_t *s,
+                         uint16_t t_out[RS_PUBLIC_DIM]);
+
+// Largest secret bound the sign/magnitude kernel handles (|s| = b0 + 2·b1)
+#define RS_LWR_SMALL_BOUND 3
+
+/**
+ * rs_lwr_tag() for a secret the caller bounds: |s[j]| <= bound for all j
+ *
+ * With bound <= RS_LWR_SMALL_BOUND (the rs_generate_secret() alphabet) and
+ * no vector 32-bit multiply in the build (SSE2-only x86, other portable
+ * targets), s is split into sign and magnitude bit-planes and each product
+ * is two masked adds of B[i][j] ^ sign: 1.1-1.3x faster than the emulated
+ * multiply there. Where the AVX2, AVX-512 or NEON multiply kernel exists it
+ * stays faster than the masks and is used regardless of the bound. The
+ * kernels are constant-time: the masks, not branches, select the terms.
+ *
+ * @param B_rows  Array of RS_PUBLIC_DIM row vectors
+ * @param s       Secret vector of length RS_SECRET_DIM
+ * @param bound   Bound on |s[j]|; results are undefined if s exceeds it
+ * @param t_out   Output tag of length RS_PUBLIC_DIM
+ */
+void rs_lwr_tag_bounded(const rs_row_t *B_rows,
+                        const int32_t *s,
+                        int32_t bound,
+                        uint16_t t_out[RS_PUBLIC_DIM]);
+
+// ============================================================================
+// INCREMENTAL TAGS
+// ============================================================================
+
+/**
+ * Tag state of one secret: the 32-bit accumulators before rounding
+ *
+ * acc[i] = B_rows[i] · s mod 2^32. A change of k coordinates of s moves
+ * each accumulator by Σ B_rows[i][j]·Δ[j] over the k changed j, so the tag
+ * of the new secret costs RS_PUBLIC_DIM·k products instead of
+ * RS_PUBLIC_DIM·RS_SECRET_DIM. The state references B_rows, which must
+ * outlive it.
+ */
+typedef struct {
+    const rs_row_t *B_rows;
+    uint32_t acc[RS_PUBLIC_DIM];
+} rs_lwr_state_t;
+
+/**
+ * Start a state from a full secret and return its tag
+ *
+ * @param st      State to fill
+ * @param B_rows  Array of RS_PUBLIC_DIM row vectors
+ * @param s       Secret vector of length RS_SECRET_DIM
+ * @param t_out   rs_lwr_tag(B_rows, s) (may be NULL)
+ */
+void rs_lwr_state_init(rs_lwr_state_t *st,
+                       const rs_row_t *B_rows,
+                       const int32_t *s,
+                       uint16_t t_out[RS_PUBLIC_DIM]);
+
+/**
+ * Apply s[idx[t]] += delta[t] for t < k and return the refreshed tag
+ *
+ * Repeated indices add up. The state is unchanged on error.
+ *
+ * @param idx     k coordinates (0..RS_SECRET_DIM-1)
+ * @param delta   k changes
+ * @param t_out   Tag of the updated secret (may be NULL)
+ * @return        0, or -1 if an index is out of range
+ */
+int rs_lwr_state_update(rs_lwr_state_t *st,
+                        const uint16_t *idx,
+                        const int32_t *delta,
+                        size_t k,
+                        uint16_t t_out[RS_PUBLIC_DIM]);
+
+/**
+ * Current tag of the state
+ */
+void rs_lwr_state_tag(const rs_lwr_state_t *st, uint16_t t_out[RS_PUBLIC_DIM]);
+
+/**
+ * Tag of s + delta without changing the state
+ *
+ * @param delta   Sparse change of dimension RS_SECRET_DIM
+ * @param t_out   Tag of s + delta
+ * @return        0, or -1 if delta has another dimension or an index out
+ *                of range
+ */
+int rs_lwr_state_tag_delta(const rs_lwr_state_t *st,
+                           const sparse_vector_t *delta,
+                           uint16_t t_out[RS_PUBLIC_DIM]);
+
 /**
  * Generate a random small secret for testing
  *
@@ -1,141 +1,782 @@
 #include "rs_mats.h"
+#include "dntl_stats.h"
 #include "rs_prf.h"
+#include "ntt64.h"
 #include <string.h>
-#include <stdlib.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Keystream words are little-endian; nothing to do on little-endian hosts
+static inline void rs_le32_array(uint32_t *v, size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < n; i++) {
+        v[i] = __builtin_bswap32(v[i]);
+    }
+#else
+    (void)v;
+    (void)n;
+#endif
+}
 
 // ============================================================================
 // MATRIX DERIVATION
 // ============================================================================
 
-void rs_derive_A(const rs_params_t *p,
-                 rs_family_t family,
-                 int ell,
-                 int slot,
-                 rs_matrix_t *A_out) {
-    // Select key, seed, and label based on family
-    const uint8_t *key;
-    const uint8_t *seed;
-    const char *label;
+int rs_layer_width(int ell) {
+    if (ell < 0 || ell >= RS_NUM_LAYERS) {
+        return -1;
+    }
+    return RS_Q_LAYERS[ell] <= 65536 ? 16 : 32;
+}
+
+// Keystream words drawn per refill by rs_derive_A_uniform()
+#define RS_UNIFORM_REFILL_WORDS 256
+
+// Pieces of keystream_reduce(): 64 AES blocks, four rows
+#define RS_KEYSTREAM_PIECE_WORDS 256
+
+// Write-prefetch a piece's output before the AES stores reach it
+static inline void prefetch_piece(const uint32_t *piece, size_t words) {
+    for (size_t i = 0; i < words; i += 64 / sizeof(uint32_t)) {
+        __builtin_prefetch(piece + i, 1, 3);
+    }
+}
+
+/**
+ * Words [4 * block_offset, 4 * block_offset + words) of a whole-block stream
+ * (rs_prf_ctr_seek()), reduced mod q in place
+ *
+ * Software pipeline over L1-sized pieces: the keystream of piece k + 1 is
+ * generated before piece k is reduced, so the AES rounds of one and the
+ * multiplies of the other are in flight together instead of one pass over
+ * the whole output waiting for the other. The piece after that is
+ * prefetched for writing. words is a multiple of 4.
+ */
+static void keystream_reduce(const rs_prf_t *prf,
+                             const uint8_t nonce[RS_NONCE_BYTES],
+                             uint64_t block_offset,
+                             const umod_t *mod,
+                             uint32_t *out,
+                             size_t words) {
+    const size_t piece = RS_KEYSTREAM_PIECE_WORDS;
+    size_t len = words < piece ? words : piece;
+    rs_prf_ctr_seek(prf, nonce, 0, block_offset, (uint8_t *)out, len * 4);
+
+    for (size_t done = 0; done < words;) {
+        const size_t next = done + len;
+        const size_t next_len = words - next < piece ? words - next : piece;
+        if (next_len > 0) {
+            const size_t after = next + next_len;
+            if (after < words) {
+                prefetch_piece(out + after, words - after < piece ? words - after : piece);
+            }
+            rs_prf_ctr_seek(prf, nonce, 0, block_offset + next / 4,
+                            (uint8_t *)(out + next), next_len * 4);
+        }
+        rs_le32_array(out + done, len);
+        umod_reduce_array(mod, out + done, len);
+        done = next;
+        len = next_len;
+    }
+}
+
+// PRF and nonce of A[family][ell][slot]
+static int a_stream(const rs_params_t *p,
+                    rs_family_t family,
+                    int ell,
+                    int slot,
+                    const rs_prf_t **prf,
+                    uint8_t nonce[RS_NONCE_BYTES]) {
+    // Select the PRF and the nonce hash state (label || seed) of the family
+    const keccak_state_t *base;
 
     switch (family) {
         case RS_FAMILY_AX:
-            key = p->key_ax;
-            seed = p->seed_ax;
-            label = "AX_A";
+            *prf = &p->prf_ax;
+            base = &p->nonce_ax;
             break;
         case RS_FAMILY_AY:
-            key = p->key_ay;
-            seed = p->seed_ay;
-            label = "AY_A";
+            *prf = &p->prf_ay;
+            base = &p->nonce_ay;
             break;
         case RS_FAMILY_AOX:
-            key = p->key_orb_x;
-            seed = p->seed_orb_x;
-            label = "AOX_A";
+            *prf = &p->prf_orb_x;
+            base = &p->nonce_orb_x;
             break;
         case RS_FAMILY_AOY:
-            key = p->key_orb_y;
-            seed = p->seed_orb_y;
-            label = "AOY_A";
+            *prf = &p->prf_orb_y;
+            base = &p->nonce_orb_y;
             break;
         default:
             // Invalid family
-            return;
+            return -1;
+    }
+
+    if (ell < 0 || ell >= RS_NUM_LAYERS || slot < 0 || slot >= RS_SLOT_COUNT) {
+        return -1;
     }
 
     // Derive nonce from seed, label, ell, slot
+    rs_derive_nonce_from(base, ell, slot, nonce);
+    return 0;
+}
+
+// Rows [row_begin, row_begin + row_count) of an A stream, reduced mod q
+static void a_rows(const rs_prf_t *prf,
+                   const uint8_t nonce[RS_NONCE_BYTES],
+                   const umod_t *mod,
+                   int row_begin,
+                   int row_count,
+                   uint32_t rows_out[][RS_N]) {
+    // A row is RS_N words: RS_N / 4 counter blocks
+    keystream_reduce(prf, nonce, (uint64_t)row_begin * (RS_N / 4), mod, &rows_out[0][0],
+                     (size_t)row_count * RS_N);
+}
+
+// Rows [row_begin, row_begin + row_count) of the negacyclic matrix of a:
+// M[i][j] = a[i - j] for j <= i, -a[N + i - j] for j > i
+static void negacyclic_rows(const uint32_t a[RS_N],
+                            uint32_t q,
+                            int row_begin,
+                            int row_count,
+                            uint32_t rows_out[][RS_N]) {
+    for (int r = 0; r < row_count; r++) {
+        int i = row_begin + r;
+        for (int j = 0; j <= i; j++) {
+            rows_out[r][j] = a[i - j];
+        }
+        for (int j = i + 1; j < RS_N; j++) {
+            uint32_t c = a[RS_N + i - j];
+            rows_out[r][j] = c ? q - c : 0;
+        }
+    }
+}
+
+// Rows of an A block in p's mode; a ring block's polynomial is row 0 of
+// its dense stream
+static void a_block_rows(const rs_params_t *p,
+                         const rs_prf_t *prf,
+                         const uint8_t nonce[RS_NONCE_BYTES],
+                         int ell,
+                         int row_begin,
+                         int row_count,
+                         uint32_t rows_out[][RS_N]) {
+    if (p->a_mode != RS_A_RING) {
+        a_rows(prf, nonce, &p->mod_q[ell], row_begin, row_count, rows_out);
+        return;
+    }
+    uint32_t a[1][RS_N];
+    a_rows(prf, nonce, &p->mod_q[ell], 0, 1, a);
+    negacyclic_rows(a[0], RS_Q_LAYERS[ell], row_begin, row_count, rows_out);
+}
+
+int rs_derive_A(const rs_params_t *p,
+                rs_family_t family,
+                int ell,
+                int slot,
+                rs_matrix_t *A_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_A);
+    const rs_prf_t *prf;
     uint8_t nonce[RS_NONCE_BYTES];
-    rs_derive_nonce_16(seed, label, ell, slot, nonce);
+    if (a_stream(p, family, ell, slot, &prf, nonce) != 0) {
+        return -1;
+    }
+    if (p->a_mode == RS_A_RING) {
+        a_block_rows(p, prf, nonce, ell, 0, RS_N, A_out->data);
+        return 0;
+    }
 
-    // Generate N×N×4 bytes using AES-256-CTR
-    size_t out_len = (size_t)RS_N * RS_N * 4;
-    uint8_t *buf = malloc(out_len);
-    if (!buf) return;
+    // N×N words of AES-256-CTR straight into the matrix, reduced mod q
+    // piece by piece behind the keystream
+    a_rows(prf, nonce, &p->mod_q[ell], 0, RS_N, A_out->data);
+    return 0;
+}
 
-    rs_prf_aes256_ctr(key, nonce, 0, buf, out_len);
+int rs_derive_A_rows(const rs_params_t *p,
+                     rs_family_t family,
+                     int ell,
+                     int slot,
+                     int row_begin,
+                     int row_count,
+                     uint32_t rows_out[][RS_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_A);
+    const rs_prf_t *prf;
+    uint8_t nonce[RS_NONCE_BYTES];
+    if (row_begin < 0 || row_count < 0 || row_count > RS_N - row_begin ||
+        a_stream(p, family, ell, slot, &prf, nonce) != 0) {
+        return -1;
+    }
 
-    // Convert bytes to matrix with modulus q
-    uint32_t q = RS_Q_LAYERS[ell];
-    size_t idx = 0;
+    if (row_count > 0) {
+        a_block_rows(p, prf, nonce, ell, row_begin, row_count, rows_out);
+    }
+    return 0;
+}
 
-    for (int i = 0; i < RS_N; i++) {
-        for (int j = 0; j < RS_N; j++) {
-            uint32_t v;
-            memcpy(&v, &buf[idx], 4);  // Little-endian 32-bit read
-            idx += 4;
-            A_out->data[i][j] = v % q;
-        }
+int rs_derive_A16(const rs_params_t *p,
+                  rs_family_t family,
+                  int ell,
+                  int slot,
+                  rs_matrix16_t *A_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_A);
+    const rs_prf_t *prf;
+    uint8_t nonce[RS_NONCE_BYTES];
+    if (a_stream(p, family, ell, slot, &prf, nonce) != 0 || rs_layer_width(ell) != 16) {
+        return -1;
     }
 
-    free(buf);
+    uint32_t rows[RS_A_STREAM_ROWS][RS_N];
+    for (int r0 = 0; r0 < RS_N; r0 += RS_A_STREAM_ROWS) {
+        a_block_rows(p, prf, nonce, ell, r0, RS_A_STREAM_ROWS, rows);
+        for (int r = 0; r < RS_A_STREAM_ROWS; r++) {
+            for (int j = 0; j < RS_N; j++) {
+                A_out->data[r0 + r][j] = (uint16_t)rows[r][j];
+            }
+        }
+    }
+    return 0;
 }
 
 // ============================================================================
-// ROW DERIVATION
+// DENSE MULTIPLY
 // ============================================================================
 
-void rs_derive_B_row(const rs_params_t *p,
-                     int row_idx,
-                     rs_flavor_t flavor,
-                     rs_row_t *row_out) {
-    // Use B key and seed
-    const uint8_t *key = p->key_B;
-    const uint8_t *seed = p->seed_B;
-    const char *label = "B_ROW";
+// Rows and vectors per register tile
+#define MM_ROWS 4
+#define MM_VECS 2
 
-    // Flavor provides domain separation via second index
-    int flavor_id = (int)flavor;
+/**
+ * Reduction plan of one layer
+ *
+ * Dot products are summed in 64 bits and reduced once. With q - 1 below
+ * 2^28 a sum of RS_SLOT_COUNT·RS_N products cannot overflow. Larger q (the
+ * 31-bit layer) multiply x in 16-bit halves, x = lo + 2^16·hi, and the two
+ * sums are combined after reducing hi. The final reduction is Barrett with
+ * m = floor((2^64 - 1) / q).
+ */
+typedef struct {
+    uint32_t q;
+    uint64_t m;
+    int split;
+} mm_plan_t;
+
+static int mm_plan(int ell, mm_plan_t *plan) {
+    if (ell < 0 || ell >= RS_NUM_LAYERS) {
+        return -1;
+    }
+    const uint64_t q = RS_Q_LAYERS[ell];
+    plan->q = (uint32_t)q;
+    plan->m = UINT64_MAX / q;
+    plan->split = (q - 1) * (q - 1) > UINT64_MAX / (RS_SLOT_COUNT * RS_N);
+    return 0;
+}
 
-    // Derive nonce
+static inline uint32_t barrett64(const mm_plan_t *plan, uint64_t a) {
+    uint64_t quo = (uint64_t)(((unsigned __int128)a * plan->m) >> 64);
+    uint64_t r = a - quo * plan->q;
+    // quo is short by at most 2
+    r = r >= plan->q ? r - plan->q : r;
+    return (uint32_t)(r >= plan->q ? r - plan->q : r);
+}
+
+/**
+ * acc[r][v] += rows[r] · xs[v] over RS_N terms, r < nr, v < nv
+ *
+ * Inlined with constant nr and nv, the accumulators stay in registers;
+ * each row vector is loaded once for all nv vectors and each x vector once
+ * for all nr rows. Products are 32x32 -> 64-bit (even and odd lanes).
+ */
+static inline __attribute__((always_inline))
+void mm_tile(const uint32_t *const rows[MM_ROWS],
+             int nr,
+             const uint32_t *const xs[MM_VECS],
+             int nv,
+             uint64_t acc[MM_ROWS][MM_VECS]) {
+#if defined(__AVX512F__)
+    __m512i sum[MM_ROWS][MM_VECS];
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            sum[r][v] = _mm512_setzero_si512();
+        }
+    }
+    for (int j = 0; j < RS_N; j += 16) {
+        __m512i xe[MM_VECS], xo[MM_VECS];
+        for (int v = 0; v < nv; v++) {
+            xe[v] = _mm512_loadu_si512((const void *)(xs[v] + j));
+            xo[v] = _mm512_srli_epi64(xe[v], 32);
+        }
+        for (int r = 0; r < nr; r++) {
+            __m512i ae = _mm512_loadu_si512((const void *)(rows[r] + j));
+            __m512i ao = _mm512_srli_epi64(ae, 32);
+            for (int v = 0; v < nv; v++) {
+                sum[r][v] = _mm512_add_epi64(sum[r][v],
+                    _mm512_add_epi64(_mm512_mul_epu32(ae, xe[v]), _mm512_mul_epu32(ao, xo[v])));
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            acc[r][v] += (uint64_t)_mm512_reduce_add_epi64(sum[r][v]);
+        }
+    }
+#elif defined(__AVX2__)
+    __m256i sum[MM_ROWS][MM_VECS];
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            sum[r][v] = _mm256_setzero_si256();
+        }
+    }
+    for (int j = 0; j < RS_N; j += 8) {
+        __m256i xe[MM_VECS], xo[MM_VECS];
+        for (int v = 0; v < nv; v++) {
+            xe[v] = _mm256_loadu_si256((const __m256i *)(xs[v] + j));
+            xo[v] = _mm256_srli_epi64(xe[v], 32);
+        }
+        for (int r = 0; r < nr; r++) {
+            __m256i ae = _mm256_loadu_si256((const __m256i *)(rows[r] + j));
+            __m256i ao = _mm256_srli_epi64(ae, 32);
+            for (int v = 0; v < nv; v++) {
+                sum[r][v] = _mm256_add_epi64(sum[r][v],
+                    _mm256_add_epi64(_mm256_mul_epu32(ae, xe[v]), _mm256_mul_epu32(ao, xo[v])));
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            __m128i h = _mm_add_epi64(_mm256_castsi256_si128(sum[r][v]),
+                                      _mm256_extracti128_si256(sum[r][v], 1));
+            acc[r][v] += (uint64_t)_mm_cvtsi128_si64(h) + (uint64_t)_mm_extract_epi64(h, 1);
+        }
+    }
+#elif defined(__aarch64__)
+    uint64x2_t sum[MM_ROWS][MM_VECS];
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            sum[r][v] = vdupq_n_u64(0);
+        }
+    }
+    for (int j = 0; j < RS_N; j += 4) {
+        uint32x4_t xv[MM_VECS];
+        for (int v = 0; v < nv; v++) {
+            xv[v] = vld1q_u32(xs[v] + j);
+        }
+        for (int r = 0; r < nr; r++) {
+            uint32x4_t a = vld1q_u32(rows[r] + j);
+            for (int v = 0; v < nv; v++) {
+                sum[r][v] = vmlal_u32(sum[r][v], vget_low_u32(a), vget_low_u32(xv[v]));
+                sum[r][v] = vmlal_high_u32(sum[r][v], a, xv[v]);
+            }
+        }
+    }
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            acc[r][v] += vaddvq_u64(sum[r][v]);
+        }
+    }
+#else
+    for (int r = 0; r < nr; r++) {
+        for (int v = 0; v < nv; v++) {
+            uint64_t sum = 0;
+            for (int j = 0; j < RS_N; j++) {
+                sum += (uint64_t)rows[r][j] * xs[v][j];
+            }
+            acc[r][v] += sum;
+        }
+    }
+#endif
+}
+
+/**
+ * sums[v][row0 + i] += A[i] · xs[v] for i < n_rows, v < nv
+ *
+ * A has n_rows rows (a multiple of MM_ROWS) at 32 bits, or at 16 bits in
+ * A16; 16-bit rows are widened a tile at a time.
+ */
+static void mm_accumulate(const uint32_t (*A)[RS_N],
+                          const uint16_t (*A16)[RS_N],
+                          int n_rows,
+                          int row0,
+                          const uint32_t *const xs[],
+                          int nv,
+                          uint64_t (*sums)[RS_N]) {
+    uint32_t wide[MM_ROWS][RS_N];
+
+    for (int i = 0; i < n_rows; i += MM_ROWS) {
+        const uint32_t *rows[MM_ROWS];
+        for (int r = 0; r < MM_ROWS; r++) {
+            if (A16) {
+                for (int j = 0; j < RS_N; j++) {
+                    wide[r][j] = A16[i + r][j];
+                }
+                rows[r] = wide[r];
+            } else {
+                rows[r] = A[i + r];
+            }
+        }
+
+        for (int v0 = 0; v0 < nv; v0 += MM_VECS) {
+            uint64_t acc[MM_ROWS][MM_VECS] = { { 0 } };
+            const uint32_t *const x2[MM_VECS] = { xs[v0], v0 + 1 < nv ? xs[v0 + 1] : NULL };
+            if (v0 + 1 < nv) {
+                mm_tile(rows, MM_ROWS, x2, 2, acc);
+            } else {
+                mm_tile(rows, MM_ROWS, x2, 1, acc);
+            }
+            for (int r = 0; r < MM_ROWS; r++) {
+                for (int v = v0; v < nv && v < v0 + MM_VECS; v++) {
+                    sums[v][row0 + i + r] += acc[r][v - v0];
+                }
+            }
+        }
+    }
+}
+
+// x mod q, as one vector or as its 16-bit halves (lo, hi) for split plans
+static void mm_prepare(const mm_plan_t *plan, const umod_t *mod, const uint32_t x[RS_N],
+                       uint32_t out[2][RS_N]) {
+    memcpy(out[0], x, sizeof(out[0]));
+    umod_reduce_array(mod, out[0], RS_N);
+    if (plan->split) {
+        for (int j = 0; j < RS_N; j++) {
+            out[1][j] = out[0][j] >> 16;
+            out[0][j] &= 0xFFFF;
+        }
+    }
+}
+
+// y = sums mod q: sums[0] alone, or sums[0] + 2^16·sums[1] for split plans
+static void mm_finish(const mm_plan_t *plan, const uint64_t (*sums)[RS_N], uint32_t y_out[RS_N]) {
+    for (int i = 0; i < RS_N; i++) {
+        uint64_t s = sums[0][i];
+        if (plan->split) {
+            s += (uint64_t)barrett64(plan, sums[1][i]) << 16;
+        }
+        y_out[i] = barrett64(plan, s);
+    }
+}
+
+int rs_matvec(const rs_matrix_t *A,
+              const uint32_t x[RS_N],
+              uint32_t y_out[RS_N],
+              int ell) {
+    return rs_matmat(A, (const uint32_t (*)[RS_N])x, 1, (uint32_t (*)[RS_N])y_out, ell);
+}
+
+int rs_matmat(const rs_matrix_t *A,
+              const uint32_t X[][RS_N],
+              size_t n_vecs,
+              uint32_t Y_out[][RS_N],
+              int ell) {
+    mm_plan_t plan;
+    umod_t mod;
+    if (mm_plan(ell, &plan) != 0 || umod_init(&mod, plan.q, 32) != 0) {
+        return -1;
+    }
+
+    // MM_VECS vectors (or split halves) per pass over A; A stays in L1
+    const int per_vec = plan.split ? 2 : 1;
+    const size_t step = MM_VECS / per_vec;
+    for (size_t k0 = 0; k0 < n_vecs; k0 += step) {
+        const int n = (int)(n_vecs - k0 < step ? n_vecs - k0 : step);
+        uint32_t xr[MM_VECS][2][RS_N];
+        uint64_t sums[MM_VECS][RS_N] = { { 0 } };
+        const uint32_t *xs[MM_VECS];
+        for (int k = 0; k < n; k++) {
+            mm_prepare(&plan, &mod, X[k0 + k], xr[k]);
+            for (int h = 0; h < per_vec; h++) {
+                xs[k * per_vec + h] = xr[k][h];
+            }
+        }
+        mm_accumulate(A->data, NULL, RS_N, 0, xs, n * per_vec, sums);
+        for (int k = 0; k < n; k++) {
+            mm_finish(&plan, (const uint64_t (*)[RS_N])&sums[k * per_vec], Y_out[k0 + k]);
+        }
+    }
+    return 0;
+}
+
+int rs_matvec_slots(const rs_matrix_t *const A[RS_SLOT_COUNT],
+                    const uint32_t x[RS_SLOT_COUNT][RS_N],
+                    uint32_t y_out[RS_N],
+                    int ell) {
+    mm_plan_t plan;
+    umod_t mod;
+    if (mm_plan(ell, &plan) != 0 || umod_init(&mod, plan.q, 32) != 0) {
+        return -1;
+    }
+
+    // Every slot's products go into the same sums, reduced once
+    uint64_t sums[2][RS_N] = { { 0 } };
+    for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+        uint32_t xr[2][RS_N];
+        mm_prepare(&plan, &mod, x[slot], xr);
+        const uint32_t *const xs[2] = { xr[0], xr[1] };
+        mm_accumulate(A[slot]->data, NULL, RS_N, 0, xs, plan.split ? 2 : 1, sums);
+    }
+    mm_finish(&plan, (const uint64_t (*)[RS_N])sums, y_out);
+    return 0;
+}
+
+int rs_matrix_times_vec(const rs_matrix_ref_t *A,
+                        const uint32_t x[RS_N],
+                        uint32_t y_out[RS_N]) {
+    mm_plan_t plan;
+    umod_t mod;
+    if (mm_plan(A->ell, &plan) != 0 || (!A->m16 && !A->m32) ||
+        umod_init(&mod, plan.q, 32) != 0) {
+        return -1;
+    }
+
+    uint32_t xr[2][RS_N];
+    uint64_t sums[2][RS_N] = { { 0 } };
+    mm_prepare(&plan, &mod, x, xr);
+    const uint32_t *const xs[2] = { xr[0], xr[1] };
+    mm_accumulate(A->m32 ? A->m32->data : NULL, A->m16 ? A->m16->data : NULL,
+                  RS_N, 0, xs, plan.split ? 2 : 1, sums);
+    mm_finish(&plan, (const uint64_t (*)[RS_N])sums, y_out);
+    return 0;
+}
+
+int rs_A_times_vec(const rs_params_t *p,
+                   rs_family_t family,
+                   int ell,
+                   int slot,
+                   const uint32_t x[RS_N],
+                   uint32_t y_out[RS_N]) {
+    const rs_prf_t *prf;
     uint8_t nonce[RS_NONCE_BYTES];
-    rs_derive_nonce_16(seed, label, row_idx, flavor_id, nonce);
+    if (a_stream(p, family, ell, slot, &prf, nonce) != 0) {
+        return -1;
+    }
+    if (p->a_mode == RS_A_RING) {
+        uint32_t a_ntt[RS_N];
+        rs_derive_A_ring(p, family, ell, slot, a_ntt);
+        return rs_ring_times_vec(p, ell, a_ntt, x, y_out);
+    }
 
-    // Generate SECRET_DIM × 4 bytes
-    size_t out_len = (size_t)RS_SECRET_DIM * 4;
-    uint8_t *buf = malloc(out_len);
-    if (!buf) return;
+    const umod_t *mod = &p->mod_q[ell];
+    mm_plan_t plan;
+    if (mm_plan(ell, &plan) != 0) {
+        return -1;
+    }
 
-    rs_prf_aes256_ctr(key, nonce, 0, buf, out_len);
+    uint32_t xr[2][RS_N];
+    uint64_t sums[2][RS_N] = { { 0 } };
+    mm_prepare(&plan, mod, x, xr);
+    const uint32_t *const xs[2] = { xr[0], xr[1] };
 
-    // Convert bytes to row (no modulus reduction - full ℤ_{2^32})
-    size_t idx = 0;
-    for (int j = 0; j < RS_SECRET_DIM; j++) {
-        uint32_t v;
-        memcpy(&v, &buf[idx], 4);
-        idx += 4;
-        row_out->data[j] = v;
+    // A few rows at a time, each consumed while it is still in L1
+    uint32_t rows[RS_A_STREAM_ROWS][RS_N];
+    for (int r0 = 0; r0 < RS_N; r0 += RS_A_STREAM_ROWS) {
+        a_rows(prf, nonce, mod, r0, RS_A_STREAM_ROWS, rows);
+        mm_accumulate((const uint32_t (*)[RS_N])rows, NULL, RS_A_STREAM_ROWS, r0,
+                      xs, plan.split ? 2 : 1, sums);
+    }
+    mm_finish(&plan, (const uint64_t (*)[RS_N])sums, y_out);
+    return 0;
+}
+
+int rs_derive_A_uniform(const rs_params_t *p,
+                        rs_family_t family,
+                        int ell,
+                        int slot,
+                        rs_matrix_t *A_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_A);
+    const rs_prf_t *prf;
+    uint8_t nonce[RS_NONCE_BYTES];
+    if (p->a_mode != RS_A_DENSE || a_stream(p, family, ell, slot, &prf, nonce) != 0) {
+        return -1;
     }
 
-    free(buf);
+    const umod_t *mod = &p->mod_q[ell];
+    const size_t total = (size_t)RS_N * RS_N;
+    uint32_t *out = &A_out->data[0][0];
+    size_t used;
+
+    // Same first stream as rs_derive_A, compacted in place
+    rs_prf_ctr(prf, nonce, 0, (uint8_t *)out, total * 4);
+    rs_le32_array(out, total);
+    size_t filled = umod_sample(mod, out, total, out, total, &used);
+
+    // Rejected words are replaced from refill c, generated at counter_start c
+    uint32_t refill[RS_UNIFORM_REFILL_WORDS];
+    for (uint64_t c = 1; filled < total; c++) {
+        rs_prf_ctr(prf, nonce, c, (uint8_t *)refill, sizeof(refill));
+        rs_le32_array(refill, RS_UNIFORM_REFILL_WORDS);
+        filled += umod_sample(mod, refill, RS_UNIFORM_REFILL_WORDS,
+                              out + filled, total - filled, &used);
+    }
+    return 0;
 }
 
-void rs_derive_C_row(const rs_params_t *p,
-                     int row_idx,
-                     rs_row_t *row_out) {
-    // Use C key and seed
-    const uint8_t *key = p->key_C;
-    const uint8_t *seed = p->seed_C;
-    const char *label = "C_ROW";
+// ============================================================================
+// RING-STRUCTURED A
+// ============================================================================
+
+int rs_derive_A_ring(const rs_params_t *p,
+                     rs_family_t family,
+                     int ell,
+                     int slot,
+                     uint32_t a_ntt[RS_N]) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_A);
+    const rs_prf_t *prf;
+    uint8_t nonce[RS_NONCE_BYTES];
+    if (p->a_mode != RS_A_RING || a_stream(p, family, ell, slot, &prf, nonce) != 0) {
+        return -1;
+    }
 
-    // Derive nonce (second index = 0 for C rows)
+    a_rows(prf, nonce, &p->mod_q[ell], 0, 1, (uint32_t (*)[RS_N])a_ntt);
+    ntt64_forward_bitrev(a_ntt, p->ntt_layer[ell]);
+    return 0;
+}
+
+int rs_ring_times_vec(const rs_params_t *p,
+                      int ell,
+                      const uint32_t a_ntt[RS_N],
+                      const uint32_t x[RS_N],
+                      uint32_t y_out[RS_N]) {
+    if (p->a_mode != RS_A_RING || ell < 0 || ell >= RS_NUM_LAYERS) {
+        return -1;
+    }
+
+    const int layer = p->ntt_layer[ell];
+    uint32_t xr[RS_N];
+    memcpy(xr, x, sizeof(xr));
+    umod_reduce_array(&p->mod_q[ell], xr, RS_N);
+
+    ntt64_forward_bitrev(xr, layer);
+    ntt64_pointwise_mul(y_out, xr, a_ntt, layer);
+    ntt64_inverse_bitrev(y_out, layer);
+    return 0;
+}
+
+// ============================================================================
+// ROW DERIVATION
+// ============================================================================
+
+int rs_derive_B_row(const rs_params_t *p,
+                    int row_idx,
+                    rs_flavor_t flavor,
+                    rs_row_t *row_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_B);
+    if (flavor != RS_FLAVOR_LWR && flavor != RS_FLAVOR_TAGGED && flavor != RS_FLAVOR_PARTIAL) {
+        return -1;
+    }
+
+    // Flavor provides domain separation via second index
     uint8_t nonce[RS_NONCE_BYTES];
-    rs_derive_nonce_16(seed, label, row_idx, 0, nonce);
+    rs_derive_nonce_from(&p->nonce_B, row_idx, (int)flavor, nonce);
+
+    // Generate SECRET_DIM × 4 bytes straight into the row
+    rs_prf_ctr(&p->prf_B, nonce, 0, (uint8_t *)row_out->data, sizeof(row_out->data));
 
-    // Generate SECRET_DIM × 4 bytes
-    size_t out_len = (size_t)RS_SECRET_DIM * 4;
-    uint8_t *buf = malloc(out_len);
-    if (!buf) return;
+    // No modulus reduction - full ℤ_{2^32}
+    rs_le32_array(row_out->data, RS_SECRET_DIM);
+    return 0;
+}
 
-    rs_prf_aes256_ctr(key, nonce, 0, buf, out_len);
+int rs_derive_C_row(const rs_params_t *p,
+                    int row_idx,
+                    rs_row_t *row_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_C);
+    // Derive nonce (second index = 0 for C rows)
+    uint8_t nonce[RS_NONCE_BYTES];
+    rs_derive_nonce_from(&p->nonce_C, row_idx, 0, nonce);
+
+    // Generate SECRET_DIM × 4 bytes straight into the row
+    rs_prf_ctr(&p->prf_C, nonce, 0, (uint8_t *)row_out->data, sizeof(row_out->data));
 
     // Convert bytes to row
-    size_t idx = 0;
+    rs_le32_array(row_out->data, RS_SECRET_DIM);
+    return 0;
+}
+
+// Rows [row_begin, row_begin + row_count) of a B or C stream, nonces four
+// at a time
+static void derive_rows(const rs_prf_t *prf,
+                        const keccak_state_t *base,
+                        int index2,
+                        int row_begin,
+                        int row_count,
+                        rs_row_t *rows_out) {
+    int r = 0;
+    for (; r + 4 <= row_count; r += 4) {
+        const int index1[4] = { row_begin + r, row_begin + r + 1, row_begin + r + 2, row_begin + r + 3 };
+        const int second[4] = { index2, index2, index2, index2 };
+        uint8_t nonces[4][RS_NONCE_BYTES];
+        rs_derive_nonces_x4(base, index1, second, nonces);
+        for (int k = 0; k < 4; k++) {
+            rs_prf_ctr(prf, nonces[k], 0, (uint8_t *)rows_out[r + k].data, sizeof(rows_out[r + k].data));
+        }
+    }
+    for (; r < row_count; r++) {
+        uint8_t nonce[RS_NONCE_BYTES];
+        rs_derive_nonce_from(base, row_begin + r, index2, nonce);
+        rs_prf_ctr(prf, nonce, 0, (uint8_t *)rows_out[r].data, sizeof(rows_out[r].data));
+    }
+    rs_le32_array(rows_out[0].data, (size_t)row_count * RS_SECRET_DIM);
+}
+
+int rs_derive_B_rows(const rs_params_t *p,
+                     int row_begin,
+                     int row_count,
+                     rs_flavor_t flavor,
+                     rs_row_t *rows_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_B);
+    if (flavor != RS_FLAVOR_LWR && flavor != RS_FLAVOR_TAGGED && flavor != RS_FLAVOR_PARTIAL) {
+        return -1;
+    }
+    if (row_count > 0) {
+        derive_rows(&p->prf_B, &p->nonce_B, (int)flavor, row_begin, row_count, rows_out);
+    }
+    return 0;
+}
+
+int rs_derive_C_rows(const rs_params_t *p,
+                     int row_begin,
+                     int row_count,
+                     rs_row_t *rows_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_C);
+    if (row_count > 0) {
+        derive_rows(&p->prf_C, &p->nonce_C, 0, row_begin, row_count, rows_out);
+    }
+    return 0;
+}
+
+// ============================================================================
+// COLUMN-INTERLEAVED B
+// ============================================================================
+
+// Rows [row_begin, row_begin + 4) into columns row_begin .. row_begin + 3
+static void interleave_rows(const rs_row_t rows[4], int row_begin, rs_B_interleaved_t *B_out) {
     for (int j = 0; j < RS_SECRET_DIM; j++) {
-        uint32_t v;
-        memcpy(&v, &buf[idx], 4);
-        idx += 4;
-        row_out->data[j] = v;
+        for (int k = 0; k < 4; k++) {
+            B_out->data[j][row_begin + k] = rows[k].data[j];
+        }
+    }
+}
+
+int rs_derive_B_interleaved(const rs_params_t *p,
+                            rs_flavor_t flavor,
+                            rs_B_interleaved_t *B_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_RS_DERIVE_B);
+    if (flavor != RS_FLAVOR_LWR && flavor != RS_FLAVOR_TAGGED && flavor != RS_FLAVOR_PARTIAL) {
+        return -1;
+    }
+    rs_row_t buf[4];
+    for (int i = 0; i < RS_PUBLIC_DIM; i += 4) {
+        derive_rows(&p->prf_B, &p->nonce_B, (int)flavor, i, 4, buf);
+        interleave_rows(buf, i, B_out);
     }
+    return 0;
+}
 
-    free(buf);
+void rs_B_interleave(const rs_row_t *B_rows, rs_B_interleaved_t *B_out) {
+    for (int i = 0; i < RS_PUBLIC_DIM; i += 4) {
+        interleave_rows(B_rows + i, i, B_out);
+    }
 }
@@ -14,6 +14,34 @@ typedef struct {
     uint32_t data[RS_N][RS_N];
 } rs_matrix_t;
 
+/**
+ * N×N matrix over ℤ_q for layers whose q fits 16 bits (rs_layer_width())
+ */
+typedef struct {
+    uint16_t data[RS_N][RS_N];
+} rs_matrix16_t;
+
+/**
+ * Read-only view of a layer-ell matrix at either storage width
+ *
+ * Exactly one of m16 and m32 is set.
+ */
+typedef struct {
+    int ell;
+    const rs_matrix16_t *m16;
+    const rs_matrix_t *m32;
+} rs_matrix_ref_t;
+
+/**
+ * Bits per stored entry of layer ell: 16 if q <= 2^16, else 32
+ *
+ * Layers 0-3 (q <= 40961) are stored at 16 bits. Layer 4 needs 32:
+ * q = 65537 has one residue more than 16 bits hold.
+ *
+ * @return  16 or 32, or -1 if ell is out of range
+ */
+int rs_layer_width(int ell);
+
 /**
  * Row vector of length SECRET_DIM over ℤ_{2^32}
  */
@@ -52,19 +80,209 @@ typedef enum {
  * Derive A matrix from seed
  *
  * Generates A[family][ell][slot] ∈ ℤ_q^{N×N} where q = RS_Q_LAYERS[ell].
- * Uses AES-256-CTR with domain-separated nonce.
+ * Uses AES-256-CTR with domain-separated nonce. The keystream is generated
+ * and reduced in place in A_out (vectorized, see uniform_mod.h); nothing is
+ * allocated. In RS_A_RING mode A_out is the negacyclic matrix of the
+ * block's polynomial (see rs_derive_A_ring()).
  *
  * @param p      Parameter structure (contains seeds and keys)
  * @param family Matrix family (AX, AY, AOX, AOY)
  * @param ell    Layer index (0..RS_NUM_LAYERS-1)
  * @param slot   Slot index (0..RS_SLOT_COUNT-1)
  * @param A_out  Output matrix
+ * @return       0, or -1 if family, ell or slot is out of range
+ */
+int rs_derive_A(const rs_params_t *p,
+                rs_family_t family,
+                int ell,
+                int slot,
+                rs_matrix_t *A_out);
+
+/**
+ * Rows of rs_derive_A() without materializing the matrix
+ *
+ * AES-CTR is random access, so the rows are generated directly at their
+ * offset in the matrix stream.
+ *
+ * @param p         Parameter structure (contains seeds and keys)
+ * @param family    Matrix family (AX, AY, AOX, AOY)
+ * @param ell       Layer index (0..RS_NUM_LAYERS-1)
+ * @param slot      Slot index (0..RS_SLOT_COUNT-1)
+ * @param row_begin First row (0..RS_N-1)
+ * @param row_count Number of rows (row_begin + row_count <= RS_N)
+ * @param rows_out  Output rows: rows_out[k] = A[row_begin + k]
+ * @return          0, or -1 if any argument is out of range
+ */
+int rs_derive_A_rows(const rs_params_t *p,
+                     rs_family_t family,
+                     int ell,
+                     int slot,
+                     int row_begin,
+                     int row_count,
+                     uint32_t rows_out[][RS_N]);
+
+/**
+ * rs_derive_A() at 16-bit width
+ *
+ * Generated RS_A_STREAM_ROWS rows at a time and narrowed; nothing is
+ * allocated.
+ *
+ * @param A_out  Output matrix, A_out->data[i][j] = A[i][j]
+ * @return       0, or -1 if an argument is out of range or layer ell is
+ *               not a 16-bit layer
+ */
+int rs_derive_A16(const rs_params_t *p,
+                  rs_family_t family,
+                  int ell,
+                  int slot,
+                  rs_matrix16_t *A_out);
+
+// Rows rs_A_times_vec() generates at a time (2 KB)
+#define RS_A_STREAM_ROWS 8
+
+/**
+ * y = A·x mod q, streaming A through an RS_A_STREAM_ROWS-row buffer
+ *
+ * Same result as deriving A with rs_derive_A() and multiplying, with a
+ * working set of 2 KB instead of 16 KB.
+ *
+ * @param p      Parameter structure (contains seeds and keys)
+ * @param family Matrix family (AX, AY, AOX, AOY)
+ * @param ell    Layer index (0..RS_NUM_LAYERS-1)
+ * @param slot   Slot index (0..RS_SLOT_COUNT-1)
+ * @param x      Input vector (any 32-bit values; taken mod q)
+ * @param y_out  Output vector in [0, q)
+ * @return       0, or -1 if family, ell or slot is out of range
+ */
+int rs_A_times_vec(const rs_params_t *p,
+                   rs_family_t family,
+                   int ell,
+                   int slot,
+                   const uint32_t x[RS_N],
+                   uint32_t y_out[RS_N]);
+
+/**
+ * y = A·x mod q for a matrix already in memory, at either width
+ *
+ * Same result as rs_A_times_vec() on the matrix A was derived from.
+ *
+ * @param A      Matrix view; q = RS_Q_LAYERS[A->ell]
+ * @param x      Input vector (any 32-bit values; taken mod q)
+ * @param y_out  Output vector in [0, q)
+ * @return       0, or -1 if A->ell is out of range or A has no matrix
+ */
+int rs_matrix_times_vec(const rs_matrix_ref_t *A,
+                        const uint32_t x[RS_N],
+                        uint32_t y_out[RS_N]);
+
+/**
+ * y = A·x mod q, q = RS_Q_LAYERS[ell]
+ *
+ * Entries of A must be in [0, q), as rs_derive_A() leaves them. Row and
+ * vector tiles are multiplied in registers (AVX-512, AVX2 or NEON) into
+ * 64-bit sums, reduced once per output. For the 31-bit layer x is split
+ * into 16-bit halves so that the sums stay below 2^64.
+ *
+ * @param x      Input vector (any 32-bit values; taken mod q)
+ * @param y_out  Output vector in [0, q)
+ * @return       0, or -1 if ell is out of range
+ */
+int rs_matvec(const rs_matrix_t *A,
+              const uint32_t x[RS_N],
+              uint32_t y_out[RS_N],
+              int ell);
+
+/**
+ * Y[k] = A·X[k] mod q for k < n_vecs
+ *
+ * Each pass over A serves two vectors (one on the 31-bit layer), so A is
+ * read from cache half as often as by repeated rs_matvec() calls.
+ *
+ * @return  0, or -1 if ell is out of range
+ */
+int rs_matmat(const rs_matrix_t *A,
+              const uint32_t X[][RS_N],
+              size_t n_vecs,
+              uint32_t Y_out[][RS_N],
+              int ell);
+
+/**
+ * y = Σ_slot A[slot]·x[slot] mod q
+ *
+ * All RS_SLOT_COUNT products share the 64-bit sums and are reduced once.
+ *
+ * @return  0, or -1 if ell is out of range
+ */
+int rs_matvec_slots(const rs_matrix_t *const A[RS_SLOT_COUNT],
+                    const uint32_t x[RS_SLOT_COUNT][RS_N],
+                    uint32_t y_out[RS_N],
+                    int ell);
+
+/**
+ * Derive an unbiased A matrix from seed
+ *
+ * rs_derive_A() reduces 32-bit words with %, which over-weights small
+ * residues (by half again for the 31-bit layer). This variant rejects the
+ * words past the last complete run of q residues and tops the matrix up
+ * from further keystream, generated at counter_start 1, 2, ... It keeps
+ * every entry rs_derive_A() would produce from an accepted word, in order,
+ * so the two derivations are alternatives: use one per parameter set.
+ *
+ * @param p      Parameter structure (contains seeds and keys)
+ * @param family Matrix family (AX, AY, AOX, AOY)
+ * @param ell    Layer index (0..RS_NUM_LAYERS-1)
+ * @param slot   Slot index (0..RS_SLOT_COUNT-1)
+ * @param A_out  Output matrix, uniform over ℤ_q^{N×N}
+ * @return       0, or -1 if family, ell or slot is out of range or p is
+ *               in RS_A_RING mode
+ */
+int rs_derive_A_uniform(const rs_params_t *p,
+                        rs_family_t family,
+                        int ell,
+                        int slot,
+                        rs_matrix_t *A_out);
+
+// ============================================================================
+// RING-STRUCTURED A
+// ============================================================================
+
+/**
+ * Polynomial of a ring-structured A block, in the NTT domain
+ *
+ * The coefficients a_0..a_{N-1} are row 0 of the block's dense stream, so
+ * the block is the negacyclic matrix M[i][j] = ±a[(i - j) mod N], with a
+ * minus sign for j > i. a_ntt is in the bit-reversed order of
+ * ntt64_forward_bitrev(); only rs_ring_times_vec() needs to read it.
+ *
+ * @param p      Parameters in RS_A_RING mode
+ * @param a_ntt  Output: NTT of the block polynomial
+ * @return       0, or -1 if an argument is out of range or p is not in
+ *               RS_A_RING mode
  */
-void rs_derive_A(const rs_params_t *p,
-                 rs_family_t family,
-                 int ell,
-                 int slot,
-                 rs_matrix_t *A_out);
+int rs_derive_A_ring(const rs_params_t *p,
+                     rs_family_t family,
+                     int ell,
+                     int slot,
+                     uint32_t a_ntt[RS_N]);
+
+/**
+ * y = A·x mod q for a ring block: a·x in ℤ_q[X]/(X^N + 1)
+ *
+ * One forward NTT, a pointwise multiply and one inverse NTT.
+ *
+ * @param p      Parameters in RS_A_RING mode
+ * @param ell    Layer of the block
+ * @param a_ntt  Block polynomial from rs_derive_A_ring()
+ * @param x      Input vector (any 32-bit values; taken mod q)
+ * @param y_out  Output vector in [0, q)
+ * @return       0, or -1 if ell is out of range or p is not in RS_A_RING
+ *               mode
+ */
+int rs_ring_times_vec(const rs_params_t *p,
+                      int ell,
+                      const uint32_t a_ntt[RS_N],
+                      const uint32_t x[RS_N],
+                      uint32_t y_out[RS_N]);
 
 // ============================================================================
 // ROW DERIVATION
@@ -79,12 +297,13 @@ void rs_derive_A(const rs_params_t *p,
  * @param p        Parameter structure
  * @param row_idx  Row index
  * @param flavor   Flavor for domain separation
- * @param row_out  Output row
+ * @param row_out  Output row (generated in place)
+ * @return         0, or -1 if flavor is unknown
  */
-void rs_derive_B_row(const rs_params_t *p,
-                     int row_idx,
-                     rs_flavor_t flavor,
-                     rs_row_t *row_out);
+int rs_derive_B_row(const rs_params_t *p,
+                    int row_idx,
+                    rs_flavor_t flavor,
+                    rs_row_t *row_out);
 
 /**
  * Derive C row from seed
@@ -94,10 +313,72 @@ void rs_derive_B_row(const rs_params_t *p,
  *
  * @param p        Parameter structure
  * @param row_idx  Row index
- * @param row_out  Output row
+ * @param row_out  Output row (generated in place)
+ * @return         0
+ */
+int rs_derive_C_row(const rs_params_t *p,
+                    int row_idx,
+                    rs_row_t *row_out);
+
+/**
+ * rs_derive_B_row() for rows [row_begin, row_begin + row_count)
+ *
+ * Nonces are derived four at a time (rs_derive_nonces_x4()).
+ *
+ * @param rows_out  row_count rows
+ * @return          0, or -1 if flavor is unknown
+ */
+int rs_derive_B_rows(const rs_params_t *p,
+                     int row_begin,
+                     int row_count,
+                     rs_flavor_t flavor,
+                     rs_row_t *rows_out);
+
+/**
+ * rs_derive_C_row() for rows [row_begin, row_begin + row_count)
+ *
+ * @return          0
+ */
+int rs_derive_C_rows(const rs_params_t *p,
+                     int row_begin,
+                     int row_count,
+                     rs_row_t *rows_out);
+
+// ============================================================================
+// COLUMN-INTERLEAVED B
+// ============================================================================
+
+/**
+ * B stored by column: data[j][i] = B[i][j]
+ *
+ * Column j holds coefficient j of all RS_PUBLIC_DIM rows, so one vector
+ * load carries 16 (AVX-512), 8 (AVX2) or 4 (NEON) rows, and
+ * rs_lwr_tag_interleaved() multiplies it by a broadcast s[j] into per-row
+ * accumulators without horizontal sums. Same 64 KB as the row layout.
+ */
+typedef struct {
+    uint32_t data[RS_SECRET_DIM][RS_PUBLIC_DIM] __attribute__((aligned(64)));
+} rs_B_interleaved_t;
+
+/**
+ * All RS_PUBLIC_DIM rows of rs_derive_B_row() in the interleaved layout
+ *
+ * Rows are derived four at a time (rs_derive_B_rows()) into a 4 KB buffer
+ * and scattered into their columns, so the row layout is never built.
+ *
+ * @param B_out   Output, B_out->data[j][i] = B[i][j]
+ * @return        0, or -1 if flavor is unknown
+ */
+int rs_derive_B_interleaved(const rs_params_t *p,
+                            rs_flavor_t flavor,
+                            rs_B_interleaved_t *B_out);
+
+/**
+ * Interleave RS_PUBLIC_DIM rows already in memory
+ *
+ * @param B_rows  Array of RS_PUBLIC_DIM rows
+ * @param B_out   Output, B_out->data[j][i] = B_rows[i].data[j]
  */
-void rs_derive_C_row(const rs_params_t *p,
-                     int row_idx,
-                     rs_row_t *row_out);
+void rs_B_interleave(const rs_row_t *B_rows, rs_B_interleaved_t *B_out);
 
 #endif // RS_MATS_H
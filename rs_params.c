@@ -1,6 +1,8 @@
 #include "rs_params.h"
 #include "rs_prf.h"
+#include "ntt64.h"
 #include <string.h>
+#include <openssl/crypto.h>
 
 void rs_params_init(rs_params_t *p,
                     const uint8_t seed_ax[RS_SEED_BYTES],
@@ -24,4 +26,64 @@ void rs_params_init(rs_params_t *p,
     rs_derive_aes_key(p->seed_orb_y, "AOY_KEY", p->key_orb_y);
     rs_derive_aes_key(p->seed_B,     "B_KEY",   p->key_B);
     rs_derive_aes_key(p->seed_C,     "C_KEY",   p->key_C);
+
+    // Expand each key schedule once; a failed init still derives, slowly
+    rs_prf_init(&p->prf_ax,    p->key_ax);
+    rs_prf_init(&p->prf_ay,    p->key_ay);
+    rs_prf_init(&p->prf_orb_x, p->key_orb_x);
+    rs_prf_init(&p->prf_orb_y, p->key_orb_y);
+    rs_prf_init(&p->prf_B,     p->key_B);
+    rs_prf_init(&p->prf_C,     p->key_C);
+
+    // Absorb label || seed once per nonce family
+    rs_nonce_base_init(&p->nonce_ax,    p->seed_ax,    "AX_A");
+    rs_nonce_base_init(&p->nonce_ay,    p->seed_ay,    "AY_A");
+    rs_nonce_base_init(&p->nonce_orb_x, p->seed_orb_x, "AOX_A");
+    rs_nonce_base_init(&p->nonce_orb_y, p->seed_orb_y, "AOY_A");
+    rs_nonce_base_init(&p->nonce_B,     p->seed_B,     "B_ROW");
+    rs_nonce_base_init(&p->nonce_C,     p->seed_C,     "C_ROW");
+
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        umod_init(&p->mod_q[ell], RS_Q_LAYERS[ell], 32);
+        p->ntt_layer[ell] = -1;
+    }
+    p->a_mode = RS_A_DENSE;
+}
+
+int rs_params_set_A_mode(rs_params_t *p, rs_a_mode_t mode) {
+    if (mode == RS_A_DENSE) {
+        p->a_mode = mode;
+        return 0;
+    }
+    if (mode != RS_A_RING) {
+        return -1;
+    }
+
+    int layers[RS_NUM_LAYERS];
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        layers[ell] = ntt64_register_modulus(RS_Q_LAYERS[ell]);
+        if (layers[ell] < 0) {
+            return -1;
+        }
+    }
+    memcpy(p->ntt_layer, layers, sizeof(layers));
+    p->a_mode = mode;
+    return 0;
+}
+
+void rs_params_clear(rs_params_t *p) {
+    rs_prf_clear(&p->prf_ax);
+    rs_prf_clear(&p->prf_ay);
+    rs_prf_clear(&p->prf_orb_x);
+    rs_prf_clear(&p->prf_orb_y);
+    rs_prf_clear(&p->prf_B);
+    rs_prf_clear(&p->prf_C);
+
+    // The states hold the absorbed seeds
+    OPENSSL_cleanse(&p->nonce_ax,    sizeof(p->nonce_ax));
+    OPENSSL_cleanse(&p->nonce_ay,    sizeof(p->nonce_ay));
+    OPENSSL_cleanse(&p->nonce_orb_x, sizeof(p->nonce_orb_x));
+    OPENSSL_cleanse(&p->nonce_orb_y, sizeof(p->nonce_orb_y));
+    OPENSSL_cleanse(&p->nonce_B,     sizeof(p->nonce_B));
+    OPENSSL_cleanse(&p->nonce_C,     sizeof(p->nonce_C));
 }
@@ -2,11 +2,26 @@
 #define RS_PARAMS_H
 
 #include "rs_config.h"
+#include "rs_prf.h"
+#include "uniform_mod.h"
 
 // ============================================================================
 // PARAMETER STRUCTURE
 // ============================================================================
 
+/**
+ * Structure of the A blocks
+ *
+ * RS_A_DENSE blocks are unstructured N×N matrices. RS_A_RING blocks are the
+ * negacyclic matrices of one polynomial a ∈ ℤ_q[X]/(X^N + 1), so A·x is the
+ * ring product a·x: three O(N log N) ntt64 transforms instead of N^2
+ * multiply-adds, and N words of storage instead of N^2.
+ */
+typedef enum {
+    RS_A_DENSE = 0,
+    RS_A_RING  = 1
+} rs_a_mode_t;
+
 /**
  * Ring-switching system parameters
  *
@@ -17,6 +32,10 @@
  * - AOY:   A matrices for orbit Y
  * - B:     B rows for LWR mapping
  * - C:     C rows for exact gadget (optional)
+ *
+ * Each family also holds a keyed PRF so derivation does not re-expand the
+ * AES key schedule. Those make a parameter structure unsafe to share between
+ * threads; release them with rs_params_clear().
  */
 typedef struct {
     // Input seeds (32 bytes each)
@@ -34,12 +53,40 @@ typedef struct {
     uint8_t key_orb_y[RS_KEY_BYTES];
     uint8_t key_B[RS_KEY_BYTES];
     uint8_t key_C[RS_KEY_BYTES];
+
+    // Keyed PRFs over the keys above
+    rs_prf_t prf_ax;
+    rs_prf_t prf_ay;
+    rs_prf_t prf_orb_x;
+    rs_prf_t prf_orb_y;
+    rs_prf_t prf_B;
+    rs_prf_t prf_C;
+
+    // Nonce hash states with each family's label and seed absorbed
+    // (rs_nonce_base_init())
+    keccak_state_t nonce_ax;
+    keccak_state_t nonce_ay;
+    keccak_state_t nonce_orb_x;
+    keccak_state_t nonce_orb_y;
+    keccak_state_t nonce_B;
+    keccak_state_t nonce_C;
+
+    // Reduction constants for 32-bit words mod RS_Q_LAYERS[ell]
+    umod_t mod_q[RS_NUM_LAYERS];
+
+    // A block structure, and the ntt64 layer of each RS_Q_LAYERS[ell]
+    // (RS_A_RING only; see rs_params_set_A_mode())
+    rs_a_mode_t a_mode;
+    int ntt_layer[RS_NUM_LAYERS];
 } rs_params_t;
 
 /**
  * Initialize parameters from six 32-byte seeds
  *
- * Copies seeds and derives AES-256 keys for each family using SHA3-256.
+ * Copies seeds, derives AES-256 keys for each family using SHA3-256 and
+ * expands their key schedules, the nonce hash states and the per-layer
+ * reduction constants. The
+ * A blocks are dense (RS_A_DENSE).
  *
  * @param p          Parameter structure to initialize
  * @param seed_ax    Seed for AX matrices
@@ -57,4 +104,26 @@ void rs_params_init(rs_params_t *p,
                     const uint8_t seed_B[RS_SEED_BYTES],
                     const uint8_t seed_C[RS_SEED_BYTES]);
 
+/**
+ * Select the structure of the A blocks
+ *
+ * RS_A_RING registers each RS_Q_LAYERS modulus with ntt64 (all are
+ * ≡ 1 mod 128); 257 and 3329 resolve to built-in ntt64 layers, the others
+ * take runtime layers. Registration is not thread-safe: select ring mode
+ * before other threads use ntt64.
+ *
+ * @param p     Initialized parameters
+ * @param mode  RS_A_DENSE or RS_A_RING
+ * @return      0, or -1 if mode is unknown or ntt64 has no free layers
+ */
+int rs_params_set_A_mode(rs_params_t *p, rs_a_mode_t mode);
+
+/**
+ * Release the keyed PRFs created by rs_params_init() and wipe the nonce
+ * hash states
+ *
+ * @param p          Parameter structure to clear
+ */
+void rs_params_clear(rs_params_t *p);
+
 #endif // RS_PARAMS_H
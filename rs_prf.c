@@ -1,78 +1,175 @@
 #include "rs_prf.h"
+#include "rs_aes.h"
+#include "dntl_stats.h"
 #include <string.h>
 #include <openssl/evp.h>
 #include <openssl/err.h>
+#include <openssl/crypto.h>
 
 // ============================================================================
 // AES-256-CTR IMPLEMENTATION
 // ============================================================================
 
+// Counter block: nonce prefix and counter_start, advanced by advance blocks
+static void ctr_iv(uint8_t iv[16],
+                   const uint8_t nonce[RS_NONCE_BYTES],
+                   uint64_t counter_start,
+                   uint64_t advance) {
+    // First 8 bytes: fixed nonce prefix; last 8: counter_start (little-endian)
+    memcpy(iv, nonce, 8);
+    for (int i = 0; i < 8; i++) {
+        iv[8 + i] = (counter_start >> (i * 8)) & 0xFF;
+    }
+
+    // 128-bit big-endian addition, as OpenSSL counts
+    for (int i = 15; i >= 0 && advance; i--) {
+        uint32_t sum = (uint32_t)iv[i] + (uint32_t)(advance & 0xFF);
+        iv[i] = (uint8_t)sum;
+        advance = (advance >> 8) + (sum >> 8);
+    }
+}
+
+// OpenSSL keystream from counter block iv, with a keyed context
+static int evp_keystream(EVP_CIPHER_CTX *ctx, const uint8_t iv[16],
+                         uint8_t *out, size_t out_len) {
+    if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv) != 1) {
+        return -1;
+    }
+
+    // CTR output is plaintext XOR keystream: encrypt zeros in place. Updates
+    // take an int length, so very large outputs go in pieces.
+    memset(out, 0, out_len);
+    size_t offset = 0;
+    while (offset < out_len) {
+        int len;
+        size_t chunk = out_len - offset;
+        if (chunk > ((size_t)1 << 30)) {
+            chunk = (size_t)1 << 30;
+        }
+        if (EVP_EncryptUpdate(ctx, out + offset, &len, out + offset, (int)chunk) != 1) {
+            return -1;
+        }
+        offset += chunk;
+    }
+    return 0;
+}
+
+// Keystream from iv: the in-tree backend if selected and ks is given, else ctx
+static int keystream(const rs_aes256_key_t *ks, EVP_CIPHER_CTX *ctx,
+                     const uint8_t iv[16], uint8_t *out, size_t out_len) {
+    if (ks && rs_aes256_ctr(ks, iv, out, out_len) == 0) {
+        return 0;
+    }
+    return ctx ? evp_keystream(ctx, iv, out, out_len) : -1;
+}
+
+/**
+ * The rs_prf_aes256_ctr() stream
+ *
+ * The first min(16, out_len) keystream bytes are skipped, which is where
+ * earlier versions began writing. Whole-block outputs therefore start one
+ * counter block in; short ones are bytes [out_len, 2 * out_len).
+ */
+static int prf_generate(const rs_aes256_key_t *ks, EVP_CIPHER_CTX *ctx,
+                        const uint8_t nonce[RS_NONCE_BYTES],
+                        uint64_t counter_start,
+                        uint8_t *out,
+                        size_t out_len) {
+    uint8_t iv[16];
+
+    if (out_len < 16) {
+        uint8_t block[32];
+        ctr_iv(iv, nonce, counter_start, 0);
+        if (keystream(ks, ctx, iv, block, sizeof(block)) != 0) {
+            return -1;
+        }
+        memcpy(out, block + out_len, out_len);
+        return 0;
+    }
+
+    ctr_iv(iv, nonce, counter_start, 1);
+    return keystream(ks, ctx, iv, out, out_len);
+}
+
+// One-shot OpenSSL context keyed with key
+static EVP_CIPHER_CTX *evp_keyed(const uint8_t key[RS_KEY_BYTES]) {
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    if (ctx && EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), NULL, key, NULL) != 1) {
+        EVP_CIPHER_CTX_free(ctx);
+        ctx = NULL;
+    }
+    return ctx;
+}
+
 void rs_prf_aes256_ctr(const uint8_t key[RS_KEY_BYTES],
                        const uint8_t nonce[RS_NONCE_BYTES],
                        uint64_t counter_start,
                        uint8_t *out,
                        size_t out_len) {
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    DNTL_STAT_SCOPE(DNTL_STAT_PRF);
+    EVP_CIPHER_CTX *ctx = evp_keyed(key);
     if (!ctx) {
         // Fatal error
         return;
     }
 
-    // Initialize AES-256-CTR
-    if (EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), NULL, key, nonce) != 1) {
-        EVP_CIPHER_CTX_free(ctx);
-        return;
-    }
+    prf_generate(NULL, ctx, nonce, counter_start, out, out_len);
+    DNTL_STAT_COUNT(DNTL_COUNT_PRF_BYTES, out_len);
+    EVP_CIPHER_CTX_free(ctx);
+}
 
-    // AES-CTR mode: counter is the IV
-    // OpenSSL handles counter increment automatically
-    // We set the initial counter by providing it as the IV
+// ============================================================================
+// KEYED PRF
+// ============================================================================
 
-    // Build initial counter block:
-    // First 8 bytes: fixed nonce prefix
-    // Last 8 bytes: counter_start (little-endian)
-    uint8_t iv[16];
-    memcpy(iv, nonce, 8);  // First 8 bytes from nonce
+int rs_prf_init(rs_prf_t *prf, const uint8_t key[RS_KEY_BYTES]) {
+    rs_aes_init();
+    memcpy(prf->key, key, RS_KEY_BYTES);
+    rs_aes256_expand_key(&prf->ks, key);
 
-    // Encode counter_start as little-endian in last 8 bytes
-    for (int i = 0; i < 8; i++) {
-        iv[8 + i] = (counter_start >> (i * 8)) & 0xFF;
-    }
+    prf->ctx = evp_keyed(key);
+    return prf->ctx ? 0 : -1;
+}
 
-    // Reinitialize with our counter
-    if (EVP_EncryptInit_ex(ctx, NULL, NULL, NULL, iv) != 1) {
-        EVP_CIPHER_CTX_free(ctx);
+void rs_prf_clear(rs_prf_t *prf) {
+    EVP_CIPHER_CTX_free(prf->ctx);
+    prf->ctx = NULL;
+    OPENSSL_cleanse(prf->key, RS_KEY_BYTES);
+    OPENSSL_cleanse(&prf->ks, sizeof(prf->ks));
+}
+
+void rs_prf_ctr(const rs_prf_t *prf,
+                const uint8_t nonce[RS_NONCE_BYTES],
+                uint64_t counter_start,
+                uint8_t *out,
+                size_t out_len) {
+    DNTL_STAT_SCOPE(DNTL_STAT_PRF);
+    if (prf_generate(&prf->ks, prf->ctx, nonce, counter_start, out, out_len) == 0) {
+        DNTL_STAT_COUNT(DNTL_COUNT_PRF_BYTES, out_len);
         return;
     }
+    rs_prf_aes256_ctr(prf->key, nonce, counter_start, out, out_len);
+}
 
-    // Generate keystream
-    // In CTR mode, "encrypting" zeros gives us the keystream directly
-    // But OpenSSL CTR will XOR with plaintext, so we can just encrypt zeros
-    int len;
-    if (EVP_EncryptUpdate(ctx, out, &len, (const uint8_t *)"\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00", out_len > 16 ? 16 : out_len) != 1) {
-        EVP_CIPHER_CTX_free(ctx);
+void rs_prf_ctr_seek(const rs_prf_t *prf,
+                     const uint8_t nonce[RS_NONCE_BYTES],
+                     uint64_t counter_start,
+                     uint64_t block_offset,
+                     uint8_t *out,
+                     size_t out_len) {
+    DNTL_STAT_SCOPE(DNTL_STAT_PRF);
+    uint8_t iv[16];
+    DNTL_STAT_COUNT(DNTL_COUNT_PRF_BYTES, out_len);
+    ctr_iv(iv, nonce, counter_start, 1 + block_offset);
+    if (keystream(&prf->ks, prf->ctx, iv, out, out_len) == 0) {
         return;
     }
 
-    // Actually, let's do this properly by generating the keystream
-    // For CTR mode, we can use a simpler approach:
-    size_t offset = 0;
-    uint8_t plaintext[16];
-    memset(plaintext, 0, 16);
-
-    while (offset < out_len) {
-        size_t chunk = (out_len - offset) < 16 ? (out_len - offset) : 16;
-        int outlen;
-
-        if (EVP_EncryptUpdate(ctx, out + offset, &outlen, plaintext, chunk) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
-            return;
-        }
-
-        offset += outlen;
+    EVP_CIPHER_CTX *ctx = evp_keyed(prf->key);
+    if (ctx) {
+        evp_keystream(ctx, iv, out, out_len);
+        EVP_CIPHER_CTX_free(ctx);
     }
-
-    EVP_CIPHER_CTX_free(ctx);
 }
 
 // ============================================================================
@@ -82,67 +179,74 @@ void rs_prf_aes256_ctr(const uint8_t key[RS_KEY_BYTES],
 void rs_derive_aes_key(const uint8_t seed[RS_SEED_BYTES],
                        const char *label,
                        uint8_t key_out[RS_KEY_BYTES]) {
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) return;
-
-    // Use SHA3-256 for key derivation
-    if (EVP_DigestInit_ex(ctx, EVP_sha3_256(), NULL) != 1) {
-        EVP_MD_CTX_free(ctx);
-        return;
-    }
-
     // Hash: label || seed
-    size_t label_len = strlen(label);
-    EVP_DigestUpdate(ctx, label, label_len);
-    EVP_DigestUpdate(ctx, seed, RS_SEED_BYTES);
-
-    // Finalize to get 32-byte output
-    unsigned int out_len;
-    EVP_DigestFinal_ex(ctx, key_out, &out_len);
-
-    EVP_MD_CTX_free(ctx);
+    keccak_state_t st;
+    keccak_sha3_256_init(&st);
+    keccak_absorb(&st, label, strlen(label));
+    keccak_absorb(&st, seed, RS_SEED_BYTES);
+    keccak_finalize(&st);
+    keccak_squeeze(&st, key_out, RS_KEY_BYTES);
 }
 
 // ============================================================================
 // NONCE DERIVATION
 // ============================================================================
 
-void rs_derive_nonce_16(const uint8_t seed[RS_SEED_BYTES],
-                        const char *label,
-                        int index1,
-                        int index2,
-                        uint8_t nonce[RS_NONCE_BYTES]) {
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx) return;
-
-    // Use SHA3-256 for nonce derivation
-    if (EVP_DigestInit_ex(ctx, EVP_sha3_256(), NULL) != 1) {
-        EVP_MD_CTX_free(ctx);
-        return;
-    }
-
-    // Hash: label || seed || index1 || index2
-    size_t label_len = strlen(label);
-    EVP_DigestUpdate(ctx, label, label_len);
-    EVP_DigestUpdate(ctx, seed, RS_SEED_BYTES);
-
-    // Encode indices as little-endian 4-byte integers
-    uint8_t idx1_bytes[4], idx2_bytes[4];
+// Indices as little-endian 4-byte integers: index1 || index2
+static void nonce_suffix(int index1, int index2, uint8_t out[8]) {
     for (int i = 0; i < 4; i++) {
-        idx1_bytes[i] = (index1 >> (i * 8)) & 0xFF;
-        idx2_bytes[i] = (index2 >> (i * 8)) & 0xFF;
+        out[i] = (index1 >> (i * 8)) & 0xFF;
+        out[4 + i] = (index2 >> (i * 8)) & 0xFF;
     }
+}
 
-    EVP_DigestUpdate(ctx, idx1_bytes, 4);
-    EVP_DigestUpdate(ctx, idx2_bytes, 4);
+void rs_nonce_base_init(keccak_state_t *base,
+                        const uint8_t seed[RS_SEED_BYTES],
+                        const char *label) {
+    keccak_sha3_256_init(base);
+    keccak_absorb(base, label, strlen(label));
+    keccak_absorb(base, seed, RS_SEED_BYTES);
+}
+
+void rs_derive_nonce_from(const keccak_state_t *base,
+                          int index1,
+                          int index2,
+                          uint8_t nonce[RS_NONCE_BYTES]) {
+    uint8_t suffix[8];
+    nonce_suffix(index1, index2, suffix);
+
+    // First 16 bytes of the 32-byte hash
+    keccak_state_t st = *base;
+    keccak_absorb(&st, suffix, sizeof(suffix));
+    keccak_finalize(&st);
+    keccak_squeeze(&st, nonce, RS_NONCE_BYTES);
+}
 
-    // Finalize to get 32-byte output
-    uint8_t hash[32];
-    unsigned int out_len;
-    EVP_DigestFinal_ex(ctx, hash, &out_len);
+void rs_derive_nonces_x4(const keccak_state_t *base,
+                         const int index1[4],
+                         const int index2[4],
+                         uint8_t nonces[4][RS_NONCE_BYTES]) {
+    uint8_t suffix[4][8];
+    keccak_state_t st[4];
+    for (int k = 0; k < 4; k++) {
+        nonce_suffix(index1[k], index2[k], suffix[k]);
+        st[k] = *base;
+    }
 
-    // Take first 16 bytes as nonce
-    memcpy(nonce, hash, RS_NONCE_BYTES);
+    const void *const in[4] = { suffix[0], suffix[1], suffix[2], suffix[3] };
+    void *const out[4] = { nonces[0], nonces[1], nonces[2], nonces[3] };
+    keccak_absorb_x4(st, in, sizeof(suffix[0]));
+    keccak_finalize_x4(st);
+    keccak_squeeze_x4(st, out, RS_NONCE_BYTES);
+}
 
-    EVP_MD_CTX_free(ctx);
+void rs_derive_nonce_16(const uint8_t seed[RS_SEED_BYTES],
+                        const char *label,
+                        int index1,
+                        int index2,
+                        uint8_t nonce[RS_NONCE_BYTES]) {
+    // Hash: label || seed || index1 || index2
+    keccak_state_t base;
+    rs_nonce_base_init(&base, seed, label);
+    rs_derive_nonce_from(&base, index1, index2, nonce);
 }
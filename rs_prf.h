@@ -2,6 +2,8 @@
 #define RS_PRF_H
 
 #include "rs_config.h"
+#include "rs_aes.h"
+#include "keccak.h"
 #include <stddef.h>
 
 // ============================================================================
@@ -14,6 +16,11 @@
  * Implements a pseudorandom function that can generate any amount of
  * pseudorandom bytes from a key and nonce.
  *
+ * The counter block is the first 8 nonce bytes followed by counter_start
+ * (little-endian), incremented as a 128-bit big-endian integer. The output
+ * starts min(16, out_len) bytes into that keystream, which is where earlier
+ * versions of this function began writing; derived matrices depend on it.
+ *
  * @param key           32-byte AES-256 key
  * @param nonce         16-byte nonce (first 8 bytes fixed, last 8 = counter start)
  * @param counter_start Starting value for 64-bit counter
@@ -26,10 +33,69 @@ void rs_prf_aes256_ctr(const uint8_t key[RS_KEY_BYTES],
                        uint8_t *out,
                        size_t out_len);
 
+// ============================================================================
+// KEYED PRF
+// ============================================================================
+
+/**
+ * AES-256-CTR with the key schedule expanded once
+ *
+ * rs_prf_ctr() generates keystream with the in-tree backend selected by
+ * rs_aes_init() (AES-NI, VAES or ARMv8) from ks, falling back to OpenSSL.
+ * The OpenSSL context only resets the IV and writes the keystream straight
+ * into the caller's buffer in one update. ctx is NULL if OpenSSL could not
+ * allocate it; rs_prf_ctr() then falls back to rs_prf_aes256_ctr() with key.
+ * rs_prf_aes256_ctr() always uses OpenSSL and is the reference.
+ *
+ * A keyed PRF is not thread-safe: use one per thread.
+ */
+typedef struct {
+    uint8_t key[RS_KEY_BYTES];
+    rs_aes256_key_t ks;
+    struct evp_cipher_ctx_st *ctx;
+} rs_prf_t;
+
+/**
+ * Expand the key schedule (and pick the AES backend on first use)
+ *
+ * @return          0, or -1 if the cipher context could not be set up (prf
+ *                  still works, without the speedup)
+ */
+int rs_prf_init(rs_prf_t *prf, const uint8_t key[RS_KEY_BYTES]);
+
+/**
+ * Free the cipher context and wipe the key
+ */
+void rs_prf_clear(rs_prf_t *prf);
+
+/**
+ * Same output as rs_prf_aes256_ctr() with prf's key
+ */
+void rs_prf_ctr(const rs_prf_t *prf,
+                const uint8_t nonce[RS_NONCE_BYTES],
+                uint64_t counter_start,
+                uint8_t *out,
+                size_t out_len);
+
+/**
+ * Random access into a whole-block rs_prf_ctr() stream
+ *
+ * Writes bytes [16 * block_offset, 16 * block_offset + out_len) of what
+ * rs_prf_ctr(prf, nonce, counter_start, ...) returns for any length of at
+ * least 16 bytes, so a long stream can be produced in independent pieces.
+ */
+void rs_prf_ctr_seek(const rs_prf_t *prf,
+                     const uint8_t nonce[RS_NONCE_BYTES],
+                     uint64_t counter_start,
+                     uint64_t block_offset,
+                     uint8_t *out,
+                     size_t out_len);
+
 /**
  * Derive a 32-byte AES-256 key from seed + label
  *
- * Uses SHA3-256(label || seed) to derive a deterministic key.
+ * Uses SHA3-256(label || seed) to derive a deterministic key, with the
+ * in-tree Keccak (no OpenSSL context per call).
  *
  * @param seed      32-byte input seed
  * @param label     ASCII label string (e.g., "AX_KEY")
@@ -57,4 +123,32 @@ void rs_derive_nonce_16(const uint8_t seed[RS_SEED_BYTES],
                         int index2,
                         uint8_t nonce[RS_NONCE_BYTES]);
 
+/**
+ * SHA3-256 state with label || seed absorbed
+ *
+ * rs_params_init() keeps one per derivation family; nonces then copy it
+ * and absorb only the indices.
+ */
+void rs_nonce_base_init(keccak_state_t *base,
+                        const uint8_t seed[RS_SEED_BYTES],
+                        const char *label);
+
+/**
+ * rs_derive_nonce_16() from the base of its seed and label
+ */
+void rs_derive_nonce_from(const keccak_state_t *base,
+                          int index1,
+                          int index2,
+                          uint8_t nonce[RS_NONCE_BYTES]);
+
+/**
+ * Four rs_derive_nonce_from() at once, with one 4-way Keccak permutation
+ *
+ * nonces[k] is the nonce of (index1[k], index2[k]).
+ */
+void rs_derive_nonces_x4(const keccak_state_t *base,
+                         const int index1[4],
+                         const int index2[4],
+                         uint8_t nonces[4][RS_NONCE_BYTES]);
+
 #endif // RS_PRF_H
@@ -1,10 +1,15 @@
 #include "rs_params.h"
 #include "rs_mats.h"
 #include "rs_lwr.h"
+#include "rs_prf.h"
+#include "rs_expand.h"
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <pthread.h>
 
 // ============================================================================
 // TEST UTILITIES
@@ -118,7 +123,19 @@ void test_determinism() {
         }
     }
 
-    printf("  C row determinism: %s\n\n", c_match ? "PASS" : "FAIL");
+    printf("  C row determinism: %s\n", c_match ? "PASS" : "FAIL");
+
+    // Out-of-range arguments are reported rather than ignored
+    int rejected = rs_derive_A(&params, (rs_family_t)4, 0, 0, &A1) == -1 &&
+                   rs_derive_A(&params, RS_FAMILY_AX, RS_NUM_LAYERS, 0, &A1) == -1 &&
+                   rs_derive_A(&params, RS_FAMILY_AX, 0, RS_SLOT_COUNT, &A1) == -1 &&
+                   rs_derive_A(&params, RS_FAMILY_AX, -1, 0, &A1) == -1 &&
+                   rs_derive_B_row(&params, 0, (rs_flavor_t)3, &B1) == -1 &&
+                   rs_derive_A(&params, RS_FAMILY_AOY, RS_NUM_LAYERS - 1, RS_SLOT_COUNT - 1, &A1) == 0;
+
+    printf("  Invalid arguments rejected: %s\n\n", rejected ? "PASS" : "FAIL");
+
+    rs_params_clear(&params);
 }
 
 // ============================================================================
@@ -182,6 +199,8 @@ void test_domain_separation() {
     }
 
     printf("  Different flavors → different B: %s\n\n", flavors_differ ? "PASS" : "FAIL");
+
+    rs_params_clear(&params);
 }
 
 // ============================================================================
@@ -222,14 +241,1177 @@ void test_distribution() {
     printf("    Odd:  %d (%.2f%%)\n", count_odd, (1.0 - even_ratio) * 100);
     printf("    Close to 50/50: %s\n\n",
            (even_ratio > 0.48 && even_ratio < 0.52) ? "PASS" : "WARN");
+
+    rs_params_clear(&params);
+}
+
+// ============================================================================
+// TEST 4: KEYED PRF COMPATIBILITY
+// ============================================================================
+
+// The original one-block-at-a-time keystream loop, kept as the reference
+static void legacy_prf_ctr(const uint8_t key[RS_KEY_BYTES],
+                           const uint8_t nonce[RS_NONCE_BYTES],
+                           uint64_t counter_start,
+                           uint8_t *out,
+                           size_t out_len) {
+    static const uint8_t zeros[16] = { 0 };
+    uint8_t iv[16];
+    memcpy(iv, nonce, 8);
+    for (int i = 0; i < 8; i++) {
+        iv[8 + i] = (counter_start >> (i * 8)) & 0xFF;
+    }
+
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), NULL, key, iv);
+
+    int len;
+    EVP_EncryptUpdate(ctx, out, &len, zeros, out_len > 16 ? 16 : (int)out_len);
+    for (size_t offset = 0; offset < out_len; offset += 16) {
+        size_t chunk = (out_len - offset) < 16 ? (out_len - offset) : 16;
+        EVP_EncryptUpdate(ctx, out + offset, &len, zeros, (int)chunk);
+    }
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+// OpenSSL SHA3-256 (or SHAKE-256 for out_len bytes) of a || b || c
+static void evp_hash(const EVP_MD *md, const void *a, size_t a_len, const void *b, size_t b_len,
+                     const void *c, size_t c_len, uint8_t *out, size_t out_len) {
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    unsigned int len;
+    EVP_DigestInit_ex(ctx, md, NULL);
+    EVP_DigestUpdate(ctx, a, a_len);
+    EVP_DigestUpdate(ctx, b, b_len);
+    EVP_DigestUpdate(ctx, c, c_len);
+    if (md == EVP_shake256()) {
+        EVP_DigestFinalXOF(ctx, out, out_len);
+    } else {
+        EVP_DigestFinal_ex(ctx, out, &len);
+    }
+    EVP_MD_CTX_free(ctx);
+}
+
+void test_prf_compat() {
+    printf("=== TEST 4: Keyed PRF Compatibility ===\n");
+
+    rs_params_t params;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+
+    // Short, unaligned and matrix-sized outputs, and a counter that carries
+    static const size_t lens[] = { 1, 7, 15, 16, 17, 100, 1024, RS_N * RS_N * 4 };
+    static const uint64_t counters[] = { 0, 5, UINT64_MAX };
+    uint8_t nonce[RS_NONCE_BYTES];
+    rs_derive_nonce_16(params.seed_ax, "AX_A", 1, 2, nonce);
+
+    size_t max_len = (size_t)RS_N * RS_N * 4;
+    uint8_t *expect = malloc(max_len);
+    uint8_t *keyed = malloc(max_len);
+    uint8_t *oneshot = malloc(max_len);
+
+    int match = 1;
+    for (size_t c = 0; c < sizeof(counters) / sizeof(counters[0]); c++) {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            legacy_prf_ctr(params.key_ax, nonce, counters[c], expect, lens[l]);
+            rs_prf_ctr(&params.prf_ax, nonce, counters[c], keyed, lens[l]);
+            rs_prf_aes256_ctr(params.key_ax, nonce, counters[c], oneshot, lens[l]);
+            if (memcmp(expect, keyed, lens[l]) != 0 ||
+                memcmp(expect, oneshot, lens[l]) != 0) {
+                match = 0;
+            }
+        }
+    }
+
+    printf("  Keyed and one-shot PRF match reference: %s\n", match ? "PASS" : "FAIL");
+
+    // A matrices straight from the reference stream
+    rs_matrix_t A;
+    rs_derive_A(&params, RS_FAMILY_AOY, 3, 2, &A);
+    rs_derive_nonce_16(params.seed_orb_y, "AOY_A", 3, 2, nonce);
+    legacy_prf_ctr(params.key_orb_y, nonce, 0, expect, max_len);
+
+    int a_match = 1;
+    for (int i = 0; i < RS_N; i++) {
+        for (int j = 0; j < RS_N; j++) {
+            uint32_t v;
+            memcpy(&v, &expect[(i * RS_N + j) * 4], 4);
+            if (A.data[i][j] != v % RS_Q_LAYERS[3]) {
+                a_match = 0;
+            }
+        }
+    }
+
+    printf("  A matrix matches reference stream: %s\n", a_match ? "PASS" : "FAIL");
+
+    // In-tree Keccak against OpenSSL, across block boundaries, one and four
+    // states at a time
+    int keccak_ok = 1;
+    uint8_t msg[600], out4[4][700], want[700];
+    for (size_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = (uint8_t)(i * 131 + 7);
+    }
+    for (size_t len = 0; len < 420; len += 17) {
+        for (int shake = 0; shake < 2; shake++) {
+            const size_t out_len = shake ? 700 : 32;
+            keccak_state_t st[4];
+            for (int k = 0; k < 4; k++) {
+                keccak_init(&st[k], KECCAK_SHA3_256_RATE, shake ? KECCAK_SHAKE_PAD : KECCAK_SHA3_PAD);
+            }
+            keccak_state_t one = st[0];
+            keccak_absorb(&one, msg, len / 3);
+            keccak_absorb(&one, msg + len / 3, len - len / 3);
+            keccak_finalize(&one);
+            keccak_squeeze(&one, out4[0], 5);
+            keccak_squeeze(&one, out4[0] + 5, out_len - 5);
+            evp_hash(shake ? EVP_shake256() : EVP_sha3_256(), msg, len, "", 0, "", 0, want, out_len);
+            keccak_ok &= memcmp(out4[0], want, out_len) == 0;
+
+            const void *const in[4] = { msg, msg + 1, msg + 2, msg + 3 };
+            void *const out[4] = { out4[0], out4[1], out4[2], out4[3] };
+            keccak_absorb_x4(st, in, len);
+            keccak_finalize_x4(st);
+            keccak_squeeze_x4(st, out, out_len);
+            for (int k = 0; k < 4; k++) {
+                evp_hash(shake ? EVP_shake256() : EVP_sha3_256(), msg + k, len, "", 0, "", 0,
+                         want, out_len);
+                keccak_ok &= memcmp(out4[k], want, out_len) == 0;
+            }
+        }
+    }
+
+    // Keys and nonces as SHA3-256(label || seed [|| index1 || index2])
+    int derive_ok = 1;
+    uint8_t digest[32], key[RS_KEY_BYTES];
+    evp_hash(EVP_sha3_256(), "AOX_KEY", 7, test_seed_orb_x, 32, "", 0, digest, 32);
+    derive_ok &= memcmp(digest, params.key_orb_x, RS_KEY_BYTES) == 0;
+    rs_derive_aes_key(test_seed_C, "C_KEY", key);
+    evp_hash(EVP_sha3_256(), "C_KEY", 5, test_seed_C, 32, "", 0, digest, 32);
+    derive_ok &= memcmp(digest, key, RS_KEY_BYTES) == 0;
+    const int idx1[4] = { 0, 63, 255, -1 }, idx2[4] = { 2, 0, 1, 0x01020304 };
+    uint8_t nonces[4][RS_NONCE_BYTES];
+    rs_derive_nonces_x4(&params.nonce_B, idx1, idx2, nonces);
+    for (int k = 0; k < 4; k++) {
+        uint8_t suffix[8];
+        for (int i = 0; i < 4; i++) {
+            suffix[i] = (uint8_t)(idx1[k] >> (8 * i));
+            suffix[4 + i] = (uint8_t)(idx2[k] >> (8 * i));
+        }
+        evp_hash(EVP_sha3_256(), "B_ROW", 5, test_seed_B, 32, suffix, 8, digest, 32);
+        rs_derive_nonce_16(test_seed_B, "B_ROW", idx1[k], idx2[k], nonce);
+        derive_ok &= memcmp(nonces[k], digest, RS_NONCE_BYTES) == 0 &&
+                     memcmp(nonce, digest, RS_NONCE_BYTES) == 0;
+    }
+
+    // Row ranges with four-way nonces, ragged ends included
+    int rows_ok = 1;
+    rs_row_t rows[7], row;
+    rs_derive_B_rows(&params, 5, 7, RS_FLAVOR_TAGGED, rows);
+    for (int r = 0; r < 7; r++) {
+        rs_derive_B_row(&params, 5 + r, RS_FLAVOR_TAGGED, &row);
+        rows_ok &= memcmp(&rows[r], &row, sizeof(row)) == 0;
+    }
+    rs_derive_C_rows(&params, 60, 3, rows);
+    for (int r = 0; r < 3; r++) {
+        rs_derive_C_row(&params, 60 + r, &row);
+        rows_ok &= memcmp(&rows[r], &row, sizeof(row)) == 0;
+    }
+    rows_ok &= rs_derive_B_rows(&params, 0, 4, (rs_flavor_t)3, rows) == -1;
+
+    printf("  Keccak matches OpenSSL, 1 and 4 states: %s\n", keccak_ok ? "PASS" : "FAIL");
+    printf("  Keys and nonces match SHA3-256: %s\n", derive_ok ? "PASS" : "FAIL");
+    printf("  Row ranges match single rows: %s\n\n", rows_ok ? "PASS" : "FAIL");
+
+    free(expect);
+    free(keyed);
+    free(oneshot);
+    rs_params_clear(&params);
+}
+
+// ============================================================================
+// TEST 5: AES BACKEND KNOWN ANSWERS
+// ============================================================================
+
+// OpenSSL AES-256-CTR keystream from a raw counter block
+static void openssl_ctr(const uint8_t key[32], const uint8_t iv[16],
+                        uint8_t *out, size_t out_len) {
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    int len;
+    memset(out, 0, out_len);
+    EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), NULL, key, iv);
+    EVP_EncryptUpdate(ctx, out, &len, out, (int)out_len);
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+void test_aes_backends() {
+    printf("=== TEST 5: AES Backend Known Answers ===\n");
+
+    // NIST SP 800-38A F.5.5 (CTR-AES256), ciphertext XOR plaintext
+    static const uint8_t kat_key[32] = {
+        0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+        0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+    };
+    static const uint8_t kat_iv[16] = {
+        0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+    };
+    static const uint8_t kat_pt[32] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51
+    };
+    static const uint8_t kat_ct[32] = {
+        0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+        0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5
+    };
+
+    uint8_t kat_ks[32];
+    for (int i = 0; i < 32; i++) {
+        kat_ks[i] = kat_pt[i] ^ kat_ct[i];
+    }
+
+    // Counter blocks: plain, low half about to wrap, whole block about to wrap
+    uint8_t ivs[3][16];
+    memset(ivs, 0x5a, sizeof(ivs));
+    memset(ivs[1] + 8, 0xff, 8);
+    ivs[1][15] = 0xfd;
+    memset(ivs[2], 0xff, 16);
+    ivs[2][15] = 0xfa;
+
+    size_t max_len = (size_t)RS_N * RS_N * 4;
+    uint8_t *expect = malloc(max_len);
+    uint8_t *got = malloc(max_len);
+
+    openssl_ctr(kat_key, kat_iv, expect, 32);
+    printf("  OpenSSL matches SP 800-38A: %s\n",
+           memcmp(expect, kat_ks, 32) == 0 ? "PASS" : "FAIL");
+
+    rs_aes256_key_t ks;
+    rs_aes256_expand_key(&ks, kat_key);
+
+    rs_aes_init();
+    rs_aes_impl_t selected = rs_aes_get_implementation();
+    printf("  Selected backend: %s\n", rs_aes_implementation_name());
+
+    for (int impl = RS_AES_IMPL_AESNI; impl <= RS_AES_IMPL_ARMV8; impl++) {
+        if (rs_aes_set_implementation((rs_aes_impl_t)impl) != 0) {
+            continue;
+        }
+
+        int ok = rs_aes256_ctr(&ks, kat_iv, got, 32) == 0 &&
+                 memcmp(got, kat_ks, 32) == 0;
+
+        // Every length up to 40 blocks, then a full matrix
+        for (int v = 0; v < 3 && ok; v++) {
+            for (size_t len = 0; len <= 40 * 16 + 1; len++) {
+                openssl_ctr(kat_key, ivs[v], expect, len);
+                rs_aes256_ctr(&ks, ivs[v], got, len);
+                if (memcmp(expect, got, len) != 0) {
+                    ok = 0;
+                    break;
+                }
+            }
+            openssl_ctr(kat_key, ivs[v], expect, max_len);
+            rs_aes256_ctr(&ks, ivs[v], got, max_len);
+            if (memcmp(expect, got, max_len) != 0) {
+                ok = 0;
+            }
+        }
+
+        printf("  %s matches OpenSSL: %s\n", rs_aes_implementation_name(), ok ? "PASS" : "FAIL");
+    }
+    printf("\n");
+
+    rs_aes_set_implementation(selected);
+    free(expect);
+    free(got);
+}
+
+// ============================================================================
+// TEST 6: UNIFORM REDUCTION
+// ============================================================================
+
+void test_uniform_reduction() {
+    printf("=== TEST 6: Uniform Reduction ===\n");
+
+    rs_params_t params;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+
+    // Random words plus the edges around multiples of q and 2^32
+    const size_t n = (size_t)RS_N * RS_N + 7;
+    uint32_t *words = malloc(n * sizeof(uint32_t));
+    uint32_t *v = malloc(n * sizeof(uint32_t));
+    uint8_t nonce[RS_NONCE_BYTES] = { 0 };
+
+    int reduce_ok = 1, sample_ok = 1;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        const umod_t *mod = &params.mod_q[ell];
+        uint32_t q = RS_Q_LAYERS[ell];
+
+        rs_prf_ctr(&params.prf_C, nonce, (uint64_t)ell, (uint8_t *)words, n * 4);
+        for (size_t i = 0; i < 32; i++) {
+            words[i] = (i < 16) ? 0xFFFFFFFFu - (uint32_t)i : q * (uint32_t)(i - 16) - (i & 1);
+        }
+        words[32] = mod->max_accept;
+        words[33] = mod->max_accept + 1;
+
+        memcpy(v, words, n * sizeof(uint32_t));
+        umod_reduce_array(mod, v, n);
+        for (size_t i = 0; i < n; i++) {
+            if (v[i] != words[i] % q) {
+                reduce_ok = 0;
+            }
+        }
+
+        // Partial output so both the vector and the scalar tails are used
+        size_t used, out_len = n - 100;
+        size_t got = umod_sample(mod, words, n, v, out_len, &used);
+        size_t k = 0, i = 0;
+        for (; i < n && k < out_len; i++) {
+            if (words[i] <= mod->max_accept) {
+                if (k >= got || v[k] != words[i] % q) {
+                    sample_ok = 0;
+                }
+                k++;
+            }
+        }
+        if (k != got || i != used) {
+            sample_ok = 0;
+        }
+    }
+
+    printf("  Vector reduction matches %%: %s\n", reduce_ok ? "PASS" : "FAIL");
+    printf("  Rejection sampling matches reference: %s\n", sample_ok ? "PASS" : "FAIL");
+
+    // Unbiased A: in range and deterministic
+    rs_matrix_t A1, A2;
+    int uniform_ok = 1;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        rs_derive_A_uniform(&params, RS_FAMILY_AY, ell, 1, &A1);
+        rs_derive_A_uniform(&params, RS_FAMILY_AY, ell, 1, &A2);
+        for (int i = 0; i < RS_N; i++) {
+            for (int j = 0; j < RS_N; j++) {
+                if (A1.data[i][j] >= RS_Q_LAYERS[ell] || A1.data[i][j] != A2.data[i][j]) {
+                    uniform_ok = 0;
+                }
+            }
+        }
+    }
+
+    printf("  Unbiased A in range and deterministic: %s\n", uniform_ok ? "PASS" : "FAIL");
+
+    // On the 31-bit layer, % puts 3/2^32 mass on each residue below
+    // 2^32 mod q instead of 1/q: 18.75% of entries there versus 13.3%
+    const int top = RS_NUM_LAYERS - 1;
+    const uint32_t low = (uint32_t)((((uint64_t)1 << 32)) % RS_Q_LAYERS[top]);
+    int biased = 0, unbiased = 0, total = 0;
+    for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+        rs_derive_A(&params, RS_FAMILY_AX, top, slot, &A1);
+        rs_derive_A_uniform(&params, RS_FAMILY_AX, top, slot, &A2);
+        for (int i = 0; i < RS_N; i++) {
+            for (int j = 0; j < RS_N; j++) {
+                biased += A1.data[i][j] < low;
+                unbiased += A2.data[i][j] < low;
+                total++;
+            }
+        }
+    }
+
+    double expect = (double)low / RS_Q_LAYERS[top];
+    double frac = (double)unbiased / total;
+    printf("  Layer %d entries below 2^32 mod q: %% %.2f%%, unbiased %.2f%% (expect %.2f%%)\n",
+           top, 100.0 * biased / total, 100.0 * frac, 100.0 * expect);
+    printf("  Unbiased A matches uniform: %s\n\n",
+           (frac > expect - 0.015 && frac < expect + 0.015) ? "PASS" : "FAIL");
+
+    free(words);
+    free(v);
+    rs_params_clear(&params);
+}
+
+// ============================================================================
+// TEST 7: STREAMING A
+// ============================================================================
+
+// y = A·x mod q term by term
+static void reference_matvec(const rs_matrix_t *A, const uint32_t x[RS_N], uint64_t q,
+                             uint32_t y[RS_N]) {
+    for (int i = 0; i < RS_N; i++) {
+        uint64_t acc = 0;
+        for (int j = 0; j < RS_N; j++) {
+            acc = (acc + (uint64_t)A->data[i][j] * (x[j] % q)) % q;
+        }
+        y[i] = (uint32_t)acc;
+    }
+}
+
+void test_streaming_A() {
+    printf("=== TEST 7: Streaming A ===\n");
+
+    rs_params_t params;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+
+    static const int slices[][2] = { { 0, RS_N }, { 5, 3 }, { RS_N - 1, 1 }, { 17, 0 }, { 8, 40 } };
+    rs_matrix_t A, rows;
+    rs_matrix16_t A16;
+    int rows_ok = 1, matvec_ok = 1, compact_ok = 1, ref_ok = 1;
+
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        rs_derive_A(&params, RS_FAMILY_AOX, ell, 3, &A);
+
+        for (size_t s = 0; s < sizeof(slices) / sizeof(slices[0]); s++) {
+            int begin = slices[s][0], count = slices[s][1];
+            if (rs_derive_A_rows(&params, RS_FAMILY_AOX, ell, 3, begin, count, rows.data) != 0 ||
+                memcmp(rows.data, A.data[begin], (size_t)count * sizeof(A.data[0])) != 0) {
+                rows_ok = 0;
+            }
+        }
+
+        // x spans the full 32-bit range, so it is reduced first
+        uint32_t x[RS_N], y[RS_N];
+        uint8_t nonce[RS_NONCE_BYTES] = { 7 };
+        rs_prf_ctr(&params.prf_B, nonce, (uint64_t)ell, (uint8_t *)x, sizeof(x));
+        rs_A_times_vec(&params, RS_FAMILY_AOX, ell, 3, x, y);
+
+        uint64_t q = RS_Q_LAYERS[ell];
+        for (int i = 0; i < RS_N; i++) {
+            uint64_t acc = 0;
+            for (int j = 0; j < RS_N; j++) {
+                acc = (acc + (uint64_t)A.data[i][j] * (x[j] % q)) % q;
+            }
+            if (y[i] != acc) {
+                matvec_ok = 0;
+            }
+        }
+
+        // Compact layers narrow losslessly; both widths multiply alike
+        uint32_t y_ref[RS_N];
+        rs_matrix_ref_t ref = { ell, NULL, &A };
+        ref_ok &= rs_matrix_times_vec(&ref, x, y_ref) == 0 && memcmp(y, y_ref, sizeof(y)) == 0;
+        if (rs_layer_width(ell) == 16) {
+            compact_ok &= rs_derive_A16(&params, RS_FAMILY_AOX, ell, 3, &A16) == 0;
+            for (int i = 0; i < RS_N; i++) {
+                for (int j = 0; j < RS_N; j++) {
+                    compact_ok &= A16.data[i][j] == A.data[i][j];
+                }
+            }
+            ref = (rs_matrix_ref_t){ ell, &A16, NULL };
+            ref_ok &= rs_matrix_times_vec(&ref, x, y_ref) == 0 && memcmp(y, y_ref, sizeof(y)) == 0;
+        } else {
+            compact_ok &= rs_derive_A16(&params, RS_FAMILY_AOX, ell, 3, &A16) == -1;
+        }
+    }
+    compact_ok &= rs_layer_width(0) == 16 && rs_layer_width(3) == 16 &&
+                  rs_layer_width(4) == 32 && rs_layer_width(RS_NUM_LAYERS) == -1;
+
+    // Dense kernels, on derived matrices and on all-(q - 1) worst cases
+    int dense_ok = 1, batch_ok = 1, slots_ok = 1;
+    static rs_matrix_t As[RS_SLOT_COUNT];
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        const uint32_t q = RS_Q_LAYERS[ell];
+        uint32_t X[5][RS_N], Y[5][RS_N], y_ref[RS_N];
+        uint8_t nonce[RS_NONCE_BYTES] = { 9 };
+        rs_prf_ctr(&params.prf_C, nonce, (uint64_t)ell, (uint8_t *)X, sizeof(X));
+
+        for (int worst = 0; worst < 2; worst++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_derive_A(&params, RS_FAMILY_AY, ell, slot, &As[slot]);
+                if (worst) {
+                    for (int i = 0; i < RS_N; i++) {
+                        for (int j = 0; j < RS_N; j++) {
+                            As[slot].data[i][j] = q - 1;
+                        }
+                    }
+                }
+            }
+            if (worst) {
+                for (int j = 0; j < RS_N; j++) {
+                    X[0][j] = q - 1;
+                }
+            }
+
+            for (int k = 0; k < 5; k++) {
+                uint32_t y[RS_N];
+                reference_matvec(&As[0], X[k], q, y_ref);
+                dense_ok &= rs_matvec(&As[0], X[k], y, ell) == 0 && memcmp(y, y_ref, sizeof(y)) == 0;
+            }
+
+            // Odd and even batch sizes, none included
+            for (size_t n = 0; n <= 5; n++) {
+                memset(Y, 0xFF, sizeof(Y));
+                batch_ok &= rs_matmat(&As[0], (const uint32_t (*)[RS_N])X, n, Y, ell) == 0;
+                for (size_t k = 0; k < 5; k++) {
+                    reference_matvec(&As[0], X[k], q, y_ref);
+                    if (k < n) {
+                        batch_ok &= memcmp(Y[k], y_ref, sizeof(y_ref)) == 0;
+                    } else {
+                        batch_ok &= Y[k][0] == UINT32_MAX;
+                    }
+                }
+            }
+
+            const rs_matrix_t *A_slots[RS_SLOT_COUNT];
+            uint64_t sum[RS_N] = { 0 };
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                A_slots[slot] = &As[slot];
+                reference_matvec(&As[slot], X[slot], q, y_ref);
+                for (int i = 0; i < RS_N; i++) {
+                    sum[i] = (sum[i] + y_ref[i]) % q;
+                }
+            }
+            uint32_t y[RS_N];
+            slots_ok &= rs_matvec_slots(A_slots, (const uint32_t (*)[RS_N])X, y, ell) == 0;
+            for (int i = 0; i < RS_N; i++) {
+                slots_ok &= y[i] == sum[i];
+            }
+        }
+    }
+    {
+        const rs_matrix_t *A_slots[RS_SLOT_COUNT];
+        uint32_t X[RS_SLOT_COUNT][RS_N] = { { 0 } }, y[RS_N];
+        for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+            A_slots[slot] = &A;
+        }
+        dense_ok &= rs_matvec(&A, X[0], y, -1) == -1 && rs_matvec(&A, X[0], y, RS_NUM_LAYERS) == -1;
+        batch_ok &= rs_matmat(&A, (const uint32_t (*)[RS_N])X, 1, X, RS_NUM_LAYERS) == -1;
+        slots_ok &= rs_matvec_slots(A_slots, (const uint32_t (*)[RS_N])X, y, -1) == -1;
+    }
+
+    int rejected = rs_derive_A_rows(&params, RS_FAMILY_AX, 0, 0, RS_N - 2, 3, rows.data) == -1 &&
+                   rs_derive_A_rows(&params, RS_FAMILY_AX, 0, 0, -1, 1, rows.data) == -1 &&
+                   rs_derive_A_rows(&params, RS_FAMILY_AX, 0, 0, 0, -1, rows.data) == -1;
+
+    printf("  Row slices match rs_derive_A: %s\n", rows_ok ? "PASS" : "FAIL");
+    printf("  Out-of-range slices rejected: %s\n", rejected ? "PASS" : "FAIL");
+    printf("  Streamed A·x matches full matrix: %s\n", matvec_ok ? "PASS" : "FAIL");
+    printf("  16-bit layers derive compactly: %s\n", compact_ok ? "PASS" : "FAIL");
+    printf("  In-memory A·x matches at both widths: %s\n", ref_ok ? "PASS" : "FAIL");
+    printf("  Dense A·x matches every layer: %s\n", dense_ok ? "PASS" : "FAIL");
+    printf("  Batched A·X matches one by one: %s\n", batch_ok ? "PASS" : "FAIL");
+    printf("  Slot sum reduced once matches: %s\n\n", slots_ok ? "PASS" : "FAIL");
+
+    rs_params_clear(&params);
 }
 
 // ============================================================================
-// TEST 4: PERFORMANCE BENCHMARK
+// TEST 8: EXPANDED PARAMETERS
+// ============================================================================
+
+typedef struct {
+    rs_expanded_params_t *e;
+    const rs_matrix_t *A_expect;    // all 4 × RS_NUM_LAYERS × RS_SLOT_COUNT
+    const rs_row_t *B_expect;       // RS_PUBLIC_DIM
+    int start;
+    int ok;
+} expand_reader_t;
+
+// Read every entry, starting at a different one per thread, and check it
+static void *expand_reader(void *arg) {
+    expand_reader_t *r = arg;
+    rs_matrix_t scratch;
+    rs_row_t row_scratch;
+    const int entries = 4 * RS_NUM_LAYERS * RS_SLOT_COUNT;
+
+    r->ok = 1;
+    for (int k = 0; k < entries; k++) {
+        int idx = (r->start + k) % entries;
+        rs_family_t family = (rs_family_t)(idx / (RS_NUM_LAYERS * RS_SLOT_COUNT));
+        int ell = (idx / RS_SLOT_COUNT) % RS_NUM_LAYERS;
+        int slot = idx % RS_SLOT_COUNT;
+
+        const rs_matrix_t *A = rs_expanded_A(r->e, family, ell, slot, &scratch);
+        if (!A || memcmp(A, &r->A_expect[idx], sizeof(*A)) != 0) {
+            r->ok = 0;
+        }
+    }
+    for (int k = 0; k < RS_PUBLIC_DIM; k++) {
+        int i = (r->start + k) % RS_PUBLIC_DIM;
+        const rs_row_t *B = rs_expanded_B_row(r->e, i, &row_scratch);
+        if (!B || memcmp(B, &r->B_expect[i], sizeof(*B)) != 0) {
+            r->ok = 0;
+        }
+    }
+    return NULL;
+}
+
+// Entries of a and b at their stored width, and their rows, are the same bytes
+static int expanded_equal(rs_expanded_params_t *a, rs_expanded_params_t *b) {
+    rs_matrix_t scratch_a, scratch_b;
+    rs_row_t row_a, row_b;
+    int ok = 1;
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_matrix_ref_t ra, rb;
+                ok &= rs_expanded_A_ref(a, (rs_family_t)family, ell, slot, &scratch_a, &ra) == 0 &&
+                      rs_expanded_A_ref(b, (rs_family_t)family, ell, slot, &scratch_b, &rb) == 0;
+                ok &= (ra.m16 != NULL) == (rb.m16 != NULL) &&
+                      (ra.m16 ? memcmp(ra.m16, rb.m16, sizeof(*ra.m16))
+                              : memcmp(ra.m32, rb.m32, sizeof(*ra.m32))) == 0;
+            }
+        }
+    }
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        ok &= memcmp(rs_expanded_B_row(a, i, &row_a), rs_expanded_B_row(b, i, &row_b),
+                     sizeof(rs_row_t)) == 0;
+        ok &= memcmp(rs_expanded_C_row(a, i, &row_a), rs_expanded_C_row(b, i, &row_b),
+                     sizeof(rs_row_t)) == 0;
+    }
+    return ok;
+}
+
+void test_expanded_params() {
+    printf("=== TEST 8: Expanded Parameters ===\n");
+
+    rs_params_t params;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+
+    // Reference entries, derived up front: params is not shared across threads
+    const int entries = 4 * RS_NUM_LAYERS * RS_SLOT_COUNT;
+    rs_matrix_t *A_expect = malloc(sizeof(rs_matrix_t) * entries);
+    rs_row_t *B_expect = malloc(sizeof(rs_row_t) * RS_PUBLIC_DIM);
+    for (int idx = 0; idx < entries; idx++) {
+        rs_derive_A(&params, (rs_family_t)(idx / (RS_NUM_LAYERS * RS_SLOT_COUNT)),
+                    (idx / RS_SLOT_COUNT) % RS_NUM_LAYERS, idx % RS_SLOT_COUNT, &A_expect[idx]);
+    }
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        rs_derive_B_row(&params, i, RS_FLAVOR_LWR, &B_expect[i]);
+    }
+
+    // Eager and complete
+    rs_expanded_params_t *e = rs_expanded_create(&params, NULL);
+    expand_reader_t r = { e, A_expect, B_expect, 0, 0 };
+    expand_reader(&r);
+    rs_matrix_ref_t ref;
+    int aligned = ((uintptr_t)rs_expanded_B_row(e, 0, NULL) % 64 == 0);
+    size_t full_bytes = 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        int ok = rs_expanded_A_ref(e, RS_FAMILY_AY, ell, 2, NULL, &ref) == 0 &&
+                 (rs_layer_width(ell) == 16 ? ref.m16 != NULL : ref.m32 != NULL);
+        aligned &= ok && (uintptr_t)(ref.m16 ? (const void *)ref.m16 : (const void *)ref.m32) % 64 == 0;
+        full_bytes += sizeof(rs_matrix_t) * 4 * RS_SLOT_COUNT;
+    }
+
+    // Cached A·x at the stored width
+    int matvec_ok = 1;
+    uint32_t x[RS_N], y[RS_N], y_expect[RS_N];
+    for (int j = 0; j < RS_N; j++) {
+        x[j] = (uint32_t)j * 2654435761u;
+    }
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        rs_A_times_vec(&params, RS_FAMILY_AX, ell, 1, x, y_expect);
+        matvec_ok &= rs_expanded_A_times_vec(e, RS_FAMILY_AX, ell, 1, x, y) == 0 &&
+                     memcmp(y, y_expect, sizeof(y)) == 0;
+    }
+
+    printf("  Eager set matches derivation: %s\n", r.ok ? "PASS" : "FAIL");
+    printf("  Entries at layer width, 64-byte aligned: %s\n", aligned ? "PASS" : "FAIL");
+    printf("  Compact footprint (%zu KB, %zu KB at 32 bits): %s\n",
+           rs_expanded_bytes(e) / 1024, full_bytes / 1024,
+           rs_expanded_bytes(e) < full_bytes ? "PASS" : "FAIL");
+    // Parallel eager expansion: the same bytes for every thread count
+    int parallel_ok = 1;
+    for (int threads = 2; threads <= 8; threads *= 2) {
+        rs_expand_opts_t par = { 0, 0, NULL, threads, NULL, 0 };
+        rs_expanded_params_t *ep = rs_expanded_create(&params, &par);
+        parallel_ok &= ep && expanded_equal(ep, e);
+        rs_expanded_destroy(ep);
+    }
+
+    // 4 KB and 2 MB page storage, one copy per NUMA node if replicated
+    // (lazy sets are never replicated)
+    int pages_ok = 1;
+    for (int t = 0; t < 4; t++) {
+        rs_expand_opts_t paged = { t == 3, 0, NULL, 2,
+                                   t & 1 ? &dntl_allocator_huge : &dntl_allocator_pages, t >= 2 };
+        rs_expanded_params_t *ep = rs_expanded_create(&params, &paged);
+        const int replicas = t == 2 ? dntl_numa_nodes() : 1;
+        pages_ok &= ep && expanded_equal(ep, e) && rs_expanded_replicas(ep) == replicas;
+        rs_expanded_destroy(ep);
+    }
+
+    printf("  Cached A·x matches streamed: %s\n", matvec_ok ? "PASS" : "FAIL");
+    printf("  Expansion on 2-8 threads identical: %s\n", parallel_ok ? "PASS" : "FAIL");
+    printf("  Page and huge-page storage, %d node copies: %s\n", dntl_numa_nodes(),
+           pages_ok ? "PASS" : "FAIL");
+    rs_expanded_destroy(e);
+
+    // Lazy, filled concurrently by 4 readers
+    rs_expand_opts_t lazy = { 1, 0, NULL, 0, NULL, 0 };
+    e = rs_expanded_create(&params, &lazy);
+    pthread_t threads[4];
+    expand_reader_t readers[4];
+    for (int t = 0; t < 4; t++) {
+        readers[t] = (expand_reader_t){ e, A_expect, B_expect, t * 29, 0 };
+        pthread_create(&threads[t], NULL, expand_reader, &readers[t]);
+    }
+    int lazy_ok = 1;
+    for (int t = 0; t < 4; t++) {
+        pthread_join(threads[t], NULL);
+        lazy_ok &= readers[t].ok;
+    }
+    printf("  Lazy set filled by 4 threads matches: %s\n", lazy_ok ? "PASS" : "FAIL");
+    rs_expanded_destroy(e);
+
+    // Budget for the B and C rows and two layers, hottest first
+    static const int order[RS_NUM_LAYERS] = { 6, 2, 0, 1, 3, 4, 5 };
+    size_t layer_bytes = sizeof(rs_matrix_t) * 4 * RS_SLOT_COUNT;
+    rs_expand_opts_t budget = { 1, 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM +
+                                   layer_bytes + layer_bytes / 2 + 1, order, 0, NULL, 0 };
+    e = rs_expanded_create(&params, &budget);
+    r = (expand_reader_t){ e, A_expect, B_expect, 3, 0 };
+    expand_reader(&r);
+
+    rs_matrix_t scratch;
+    int resident_ok = 1;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        int want = (ell == 6 || ell == 2);
+        rs_expanded_A_ref(e, RS_FAMILY_AY, ell, 1, &scratch, &ref);
+        if (rs_expanded_resident(e, ell) != want || (ref.m32 == &scratch) == want) {
+            resident_ok = 0;
+        }
+    }
+    static const int bad_order[RS_NUM_LAYERS] = { 0, 0, 1, 2, 3, 4, 5 };
+    rs_expand_opts_t bad = { 0, 0, bad_order, 0, NULL, 0 };
+    int rejected = rs_expanded_create(&params, &bad) == NULL &&
+                   rs_expanded_A(e, RS_FAMILY_AX, RS_NUM_LAYERS, 0, &scratch) == NULL &&
+                   rs_expanded_A(e, RS_FAMILY_AX, 2, 0, NULL) == NULL &&
+                   rs_expanded_A_ref(e, RS_FAMILY_AX, 0, 0, NULL, &ref) == -1 &&
+                   rs_expanded_B_row(e, RS_PUBLIC_DIM, NULL) == NULL;
+
+    rs_expand_opts_t budget_par = { 0, budget.budget_bytes, order, 3, NULL, 0 };
+    rs_expanded_params_t *ep = rs_expanded_create(&params, &budget_par);
+    int budget_par_ok = ep && expanded_equal(ep, e) && rs_expanded_bytes(ep) == rs_expanded_bytes(e);
+    rs_expanded_destroy(ep);
+
+    printf("  Budgeted set matches derivation: %s\n", r.ok ? "PASS" : "FAIL");
+    printf("  Budgeted set on 3 threads identical: %s\n", budget_par_ok ? "PASS" : "FAIL");
+    printf("  Only the hottest layers resident: %s\n", resident_ok ? "PASS" : "FAIL");
+    printf("  Invalid arguments rejected: %s\n\n", rejected ? "PASS" : "FAIL");
+    rs_expanded_destroy(e);
+
+    free(A_expect);
+    free(B_expect);
+    rs_params_clear(&params);
+}
+
+// ============================================================================
+// TEST 9: PARAMETER FILE
+// ============================================================================
+
+// Every A, B and C entry of e matches fresh derivation from p
+static int expanded_matches(rs_expanded_params_t *e, const rs_params_t *p) {
+    rs_matrix_t want, scratch;
+    rs_row_t want_row, row_scratch;
+    int ok = 1;
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_derive_A(p, (rs_family_t)family, ell, slot, &want);
+                const rs_matrix_t *A = rs_expanded_A(e, (rs_family_t)family, ell, slot, &scratch);
+                ok &= A && memcmp(A, &want, sizeof(want)) == 0;
+            }
+        }
+    }
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        rs_derive_B_row(p, i, RS_FLAVOR_LWR, &want_row);
+        const rs_row_t *B = rs_expanded_B_row(e, i, &row_scratch);
+        ok &= B && memcmp(B, &want_row, sizeof(want_row)) == 0;
+        rs_derive_C_row(p, i, &want_row);
+        const rs_row_t *C = rs_expanded_C_row(e, i, &row_scratch);
+        ok &= C && memcmp(C, &want_row, sizeof(want_row)) == 0;
+    }
+    return ok;
+}
+
+// Map path for p and report whether it was mapped and serves p's entries
+static void check_map(const char *label, const char *path, const rs_params_t *p, int want_mapped) {
+    rs_expanded_params_t *e = rs_params_map(path, p);
+    int ok = e && rs_expanded_is_mapped(e) == want_mapped && expanded_matches(e, p);
+    printf("  %s: %s\n", label, ok ? "PASS" : "FAIL");
+    rs_expanded_destroy(e);
+}
+
+void test_params_file() {
+    printf("=== TEST 9: Parameter File ===\n");
+
+    rs_params_t params, other;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+    rs_params_init(&other,
+                   test_seed_ay, test_seed_ax,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+
+    char path[] = "/tmp/rs_params_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+    }
+    int saved = fd >= 0 && rs_params_save(path, &params) == 0;
+    printf("  Saved: %s\n", saved ? "PASS" : "FAIL");
+
+    rs_expanded_params_t *e = rs_params_map(path, &params);
+    int aligned = e && ((uintptr_t)rs_expanded_A(e, RS_FAMILY_AOY, 6, 3, NULL) % 64 == 0) &&
+                  ((uintptr_t)rs_expanded_B_row(e, 1, NULL) % 64 == 0) &&
+                  ((uintptr_t)rs_expanded_C_row(e, 1, NULL) % 64 == 0);
+    printf("  Mapped entries 64-byte aligned: %s\n", aligned ? "PASS" : "FAIL");
+    rs_expanded_destroy(e);
+
+    check_map("Mapped file matches derivation", path, &params, 1);
+    check_map("Other seeds regenerate", path, &other, 0);
+
+    // Corrupt the version, then truncate: both must regenerate
+    FILE *f = fopen(path, "r+b");
+    if (f) {
+        uint32_t bad_version = RS_PARAMS_FILE_VERSION + 1;
+        fseek(f, 8, SEEK_SET);
+        fwrite(&bad_version, sizeof(bad_version), 1, f);
+        fclose(f);
+    }
+    check_map("Corrupted header regenerates", path, &params, 0);
+
+    if (rs_params_save(path, &params) != 0 || truncate(path, 4096) != 0) {
+        printf("  Truncation setup: FAIL\n");
+    }
+    check_map("Truncated file regenerates", path, &params, 0);
+
+    remove(path);
+    check_map("Missing file regenerates", path, &params, 0);
+    printf("\n");
+
+    rs_params_clear(&params);
+    rs_params_clear(&other);
+}
+
+// ============================================================================
+// TEST 10: RING-STRUCTURED A
+// ============================================================================
+
+void test_ring_A() {
+    printf("=== TEST 10: Ring-Structured A ===\n");
+
+    rs_params_t dense, ring;
+    rs_params_init(&dense,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+    rs_params_init(&ring,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+    int mode_ok = rs_params_set_A_mode(&ring, RS_A_RING) == 0 &&
+                  rs_params_set_A_mode(&dense, (rs_a_mode_t)7) == -1;
+    printf("  Ring mode selected: %s\n", mode_ok ? "PASS" : "FAIL");
+
+    rs_matrix_t A, expect;
+    uint32_t a[1][RS_N], a_ntt[RS_N];
+    int matrix_ok = 1, product_ok = 1;
+    for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+        const uint32_t q = RS_Q_LAYERS[ell];
+
+        // The block polynomial is row 0 of the dense stream
+        rs_derive_A_rows(&dense, RS_FAMILY_AY, ell, 2, 0, 1, a);
+        for (int i = 0; i < RS_N; i++) {
+            for (int j = 0; j < RS_N; j++) {
+                uint32_t c = j <= i ? a[0][i - j] : a[0][RS_N + i - j];
+                expect.data[i][j] = (j <= i || c == 0) ? c : q - c;
+            }
+        }
+        matrix_ok &= rs_derive_A(&ring, RS_FAMILY_AY, ell, 2, &A) == 0 &&
+                     memcmp(&A, &expect, sizeof(A)) == 0;
+
+        // Schoolbook a·x mod (X^N + 1)
+        uint32_t x[RS_N], y[RS_N], y_direct[RS_N];
+        uint8_t nonce[RS_NONCE_BYTES] = { 11 };
+        rs_prf_ctr(&ring.prf_C, nonce, (uint64_t)ell, (uint8_t *)x, sizeof(x));
+        for (int i = 0; i < RS_N; i++) {
+            uint64_t acc = 0;
+            for (int j = 0; j < RS_N; j++) {
+                acc = (acc + (uint64_t)expect.data[i][j] * (x[j] % q)) % q;
+            }
+            y[i] = (uint32_t)acc;
+        }
+        product_ok &= rs_A_times_vec(&ring, RS_FAMILY_AY, ell, 2, x, y_direct) == 0 &&
+                      memcmp(y, y_direct, sizeof(y)) == 0;
+        product_ok &= rs_derive_A_ring(&ring, RS_FAMILY_AY, ell, 2, a_ntt) == 0 &&
+                      rs_ring_times_vec(&ring, ell, a_ntt, x, y_direct) == 0 &&
+                      memcmp(y, y_direct, sizeof(y)) == 0;
+    }
+    int rejected = rs_derive_A_ring(&dense, RS_FAMILY_AX, 0, 0, a_ntt) == -1 &&
+                   rs_ring_times_vec(&dense, 0, a_ntt, a[0], a[0]) == -1 &&
+                   rs_derive_A_uniform(&ring, RS_FAMILY_AX, 0, 0, &A) == -1;
+    printf("  Blocks are negacyclic matrices: %s\n", matrix_ok ? "PASS" : "FAIL");
+    printf("  NTT A·x matches schoolbook: %s\n", product_ok ? "PASS" : "FAIL");
+    printf("  Mode-specific calls rejected: %s\n", rejected ? "PASS" : "FAIL");
+
+    // Expanded ring sets hold N words per block, in memory and on disk
+    uint32_t x[RS_N], y[RS_N], y_expect[RS_N];
+    for (int j = 0; j < RS_N; j++) {
+        x[j] = (uint32_t)j * 40503u + 1;
+    }
+    char path[] = "/tmp/rs_params_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+    }
+    int saved = fd >= 0 && rs_params_save(path, &ring) == 0;
+
+    rs_expanded_params_t *sets[2] = { rs_expanded_create(&ring, NULL), rs_params_map(path, &ring) };
+    const size_t ring_bytes = 2 * sizeof(rs_row_t) * RS_PUBLIC_DIM +
+                              sizeof(uint32_t) * RS_N * 4 * RS_NUM_LAYERS * RS_SLOT_COUNT;
+    int expanded_ok = saved && rs_expanded_bytes(sets[0]) == ring_bytes &&
+                      rs_expanded_is_mapped(sets[1]);
+    rs_expand_opts_t par = { 0, 0, NULL, 4, NULL, 0 };
+    rs_expanded_params_t *ring_par = rs_expanded_create(&ring, &par);
+    for (int idx = 0; idx < 4 * RS_NUM_LAYERS * RS_SLOT_COUNT; idx++) {
+        rs_family_t family = (rs_family_t)(idx / (RS_NUM_LAYERS * RS_SLOT_COUNT));
+        int ell = (idx / RS_SLOT_COUNT) % RS_NUM_LAYERS, slot = idx % RS_SLOT_COUNT;
+        const uint32_t *pa = rs_expanded_A_ring(ring_par, family, ell, slot, NULL);
+        const uint32_t *pb = rs_expanded_A_ring(sets[0], family, ell, slot, NULL);
+        expanded_ok &= pa && pb && memcmp(pa, pb, sizeof(uint32_t) * RS_N) == 0;
+    }
+    rs_expanded_destroy(ring_par);
+    for (int k = 0; k < 2; k++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            rs_A_times_vec(&ring, RS_FAMILY_AOX, ell, 1, x, y_expect);
+            rs_derive_A(&ring, RS_FAMILY_AOX, ell, 1, &expect);
+            expanded_ok &= rs_expanded_A_times_vec(sets[k], RS_FAMILY_AOX, ell, 1, x, y) == 0 &&
+                           memcmp(y, y_expect, sizeof(y)) == 0;
+            const rs_matrix_t *M = rs_expanded_A(sets[k], RS_FAMILY_AOX, ell, 1, &A);
+            expanded_ok &= M && memcmp(M, &expect, sizeof(expect)) == 0 &&
+                           rs_expanded_A_ring(sets[k], RS_FAMILY_AOX, ell, 1, NULL) != NULL;
+        }
+        rs_expanded_destroy(sets[k]);
+    }
+    rs_expanded_params_t *e = rs_params_map(path, &dense);
+    int other_mode = !rs_expanded_is_mapped(e) &&
+                     rs_expanded_A_ring(e, RS_FAMILY_AX, 0, 0, a_ntt) == NULL;
+    rs_expanded_destroy(e);
+    remove(path);
+
+    printf("  Expanded ring set (%zu KB) and its file match: %s\n", ring_bytes / 1024,
+           expanded_ok ? "PASS" : "FAIL");
+    printf("  Ring file rejected for dense parameters: %s\n\n", other_mode ? "PASS" : "FAIL");
+
+    rs_params_clear(&dense);
+    rs_params_clear(&ring);
+}
+
+// ============================================================================
+// TEST 11: LWR TAG KERNELS
+// ============================================================================
+
+// The original scalar tag: 64-bit products, low 32 bits of the sum
+static void reference_lwr_tag(const rs_row_t *B_rows, const int32_t *s,
+                              uint16_t t_out[RS_PUBLIC_DIM]) {
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        uint64_t acc = 0;
+        for (int j = 0; j < RS_SECRET_DIM; j++) {
+            acc += (uint64_t)((int64_t)B_rows[i].data[j] * (int64_t)s[j]);
+        }
+        t_out[i] = (uint16_t)(((uint32_t)acc >> RS_LWR_SHIFT) % RS_P_SMALL);
+    }
+}
+
+void test_lwr_kernels() {
+    printf("=== TEST 11: LWR Tag Kernels ===\n");
+
+    rs_params_t params;
+    rs_params_init(&params,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+    rs_row_t *B_rows = malloc(sizeof(rs_row_t) * RS_PUBLIC_DIM);
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        rs_derive_B_row(&params, i, RS_FLAVOR_LWR, &B_rows[i]);
+    }
+
+    // Small secrets, then full-range ones: the kernels wrap like the
+    // reference for any int32 input
+    enum { SECRETS = 11 };
+    int32_t (*S)[RS_SECRET_DIM] = malloc(sizeof(*S) * SECRETS);
+    uint16_t (*T)[RS_PUBLIC_DIM] = malloc(sizeof(*T) * SECRETS);
+    uint16_t expect[SECRETS][RS_PUBLIC_DIM];
+    for (int k = 0; k < SECRETS; k++) {
+        uint8_t seed[32] = { (uint8_t)k, 0x5A };
+        if (k < 6) {
+            rs_generate_secret(S[k], seed);
+        } else {
+            uint8_t nonce[RS_NONCE_BYTES] = { (uint8_t)k };
+            rs_prf_ctr(&params.prf_C, nonce, 0, (uint8_t *)S[k], sizeof(S[k]));
+        }
+        reference_lwr_tag(B_rows, S[k], expect[k]);
+    }
+
+    int single_ok = 1, bounded_ok = 1;
+    for (int k = 0; k < SECRETS; k++) {
+        uint16_t t[RS_PUBLIC_DIM];
+        rs_lwr_tag(B_rows, S[k], t);
+        single_ok &= memcmp(t, expect[k], sizeof(t)) == 0;
+        rs_lwr_tag_bounded(B_rows, S[k], k < 6 ? RS_LWR_SMALL_BOUND : INT32_MAX, t);
+        bounded_ok &= memcmp(t, expect[k], sizeof(t)) == 0;
+    }
+
+    // Batches of every size up to a few tiles, with and without a ragged tail
+    int batch_ok = 1;
+    for (size_t n = 0; n <= SECRETS; n++) {
+        memset(T, 0xFF, sizeof(*T) * SECRETS);
+        rs_lwr_tag_batch(B_rows, (const int32_t (*)[RS_SECRET_DIM])S, n, T);
+        for (size_t k = 0; k < SECRETS; k++) {
+            int untouched = T[k][0] == 0xFFFF && T[k][RS_PUBLIC_DIM - 1] == 0xFFFF;
+            batch_ok &= k < n ? memcmp(T[k], expect[k], sizeof(T[k])) == 0 : untouched;
+        }
+    }
+
+    // Column-interleaved B, derived directly and from the rows
+    int interleaved_ok = 1;
+    rs_B_interleaved_t *Bi = malloc(sizeof(*Bi)), *Bi_rows = malloc(sizeof(*Bi_rows));
+    interleaved_ok &= rs_derive_B_interleaved(&params, RS_FLAVOR_LWR, Bi) == 0;
+    rs_B_interleave(B_rows, Bi_rows);
+    interleaved_ok &= memcmp(Bi, Bi_rows, sizeof(*Bi)) == 0 &&
+                      Bi->data[5][9] == B_rows[9].data[5];
+    for (int k = 0; k < SECRETS; k++) {
+        uint16_t t[RS_PUBLIC_DIM];
+        rs_lwr_tag_interleaved(Bi, S[k], t);
+        interleaved_ok &= memcmp(t, expect[k], sizeof(t)) == 0;
+    }
+    interleaved_ok &= rs_derive_B_interleaved(&params, (rs_flavor_t)3, Bi) == -1;
+    free(Bi);
+    free(Bi_rows);
+
+    printf("  Vector tag matches scalar reference: %s\n", single_ok ? "PASS" : "FAIL");
+    printf("  Bounded-secret tag matches: %s\n", bounded_ok ? "PASS" : "FAIL");
+    printf("  Interleaved B and its tag match: %s\n", interleaved_ok ? "PASS" : "FAIL");
+    // Fused derivation, every flavor
+    int fused_ok = 1;
+    for (int flavor = RS_FLAVOR_LWR; flavor <= RS_FLAVOR_PARTIAL; flavor++) {
+        uint16_t t[RS_PUBLIC_DIM], t_expect[RS_PUBLIC_DIM];
+        rs_row_t *rows = malloc(sizeof(rs_row_t) * RS_PUBLIC_DIM);
+        for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+            rs_derive_B_row(&params, i, (rs_flavor_t)flavor, &rows[i]);
+        }
+        reference_lwr_tag(rows, S[flavor + 4], t_expect);
+        fused_ok &= rs_lwr_tag_from_seed(&params, (rs_flavor_t)flavor, S[flavor + 4], t) == 0 &&
+                    memcmp(t, t_expect, sizeof(t)) == 0;
+        free(rows);
+    }
+    uint16_t t_bad[RS_PUBLIC_DIM];
+    fused_ok &= rs_lwr_tag_from_seed(&params, (rs_flavor_t)3, S[0], t_bad) == -1;
+
+    // Every flavor and the exact C product in one pass, for each set count
+    int multi_ok = 1;
+    rs_row_t (*sets)[RS_PUBLIC_DIM] = malloc(sizeof(*sets) * RS_LWR_MAX_SETS);
+    rs_row_t *C_rows = malloc(sizeof(rs_row_t) * RS_PUBLIC_DIM);
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        for (int k = 0; k < RS_LWR_MAX_SETS; k++) {
+            rs_derive_B_row(&params, i, (rs_flavor_t)k, &sets[k][i]);
+        }
+        rs_derive_C_row(&params, i, &C_rows[i]);
+    }
+    const rs_row_t *const set_ptrs[RS_LWR_MAX_SETS] = { sets[0], sets[1], sets[2] };
+    for (int k = 0; k < SECRETS; k++) {
+        uint16_t t_expect[RS_LWR_MAX_SETS][RS_PUBLIC_DIM], t_multi[RS_LWR_MAX_SETS][RS_PUBLIC_DIM];
+        uint32_t c_expect[RS_PUBLIC_DIM], c_multi[RS_PUBLIC_DIM];
+        for (int f = 0; f < RS_LWR_MAX_SETS; f++) {
+            reference_lwr_tag(sets[f], S[k], t_expect[f]);
+        }
+        for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+            uint32_t acc = 0;
+            for (int j = 0; j < RS_SECRET_DIM; j++) {
+                acc += C_rows[i].data[j] * (uint32_t)S[k][j];
+            }
+            c_expect[i] = acc;
+        }
+        for (int n = 0; n <= RS_LWR_MAX_SETS; n++) {
+            memset(t_multi, 0, sizeof(t_multi));
+            memset(c_multi, 0, sizeof(c_multi));
+            int with_c = (k + n) & 1;
+            int ret = rs_lwr_tag_multi(set_ptrs, n, with_c ? C_rows : NULL, S[k], t_multi, c_multi);
+            if (n == 0 && !with_c) {
+                multi_ok &= ret == -1;
+                continue;
+            }
+            multi_ok &= ret == 0 && memcmp(t_multi, t_expect, sizeof(t_multi[0]) * n) == 0;
+            multi_ok &= !with_c || memcmp(c_multi, c_expect, sizeof(c_multi)) == 0;
+        }
+    }
+    multi_ok &= rs_lwr_tag_multi(set_ptrs, RS_LWR_MAX_SETS + 1, NULL, S[0], NULL, NULL) == -1;
+    free(sets);
+    free(C_rows);
+
+    // Incremental tags: sparse changes of one secret, against full retags
+    int incr_ok = 1, delta_ok = 1;
+    rs_lwr_state_t st;
+    int32_t s_cur[RS_SECRET_DIM];
+    uint16_t t_incr[RS_PUBLIC_DIM], t_full[RS_PUBLIC_DIM];
+    memcpy(s_cur, S[0], sizeof(s_cur));
+    rs_lwr_state_init(&st, B_rows, s_cur, t_incr);
+    incr_ok &= memcmp(t_incr, expect[0], sizeof(t_incr)) == 0;
+    for (int round = 0; round < 8; round++) {
+        // Repeated index in every update; full-range deltas in the later rounds
+        uint16_t idx[5] = { (uint16_t)(round * 31), (uint16_t)(round * 7 + 3), 255, 0, (uint16_t)(round * 31) };
+        int32_t delta[5] = { 1, -2, 3, (int32_t)(round << 29), -1 };
+        for (int t = 0; t < 5; t++) {
+            s_cur[idx[t]] += delta[t];
+        }
+        incr_ok &= rs_lwr_state_update(&st, idx, delta, 5, t_incr) == 0;
+        reference_lwr_tag(B_rows, s_cur, t_full);
+        incr_ok &= memcmp(t_incr, t_full, sizeof(t_full)) == 0;
+    }
+    uint16_t bad_idx[2] = { 1, RS_SECRET_DIM };
+    int32_t bad_delta[2] = { 5, 5 };
+    incr_ok &= rs_lwr_state_update(&st, bad_idx, bad_delta, 2, NULL) == -1;
+    rs_lwr_state_tag(&st, t_incr);
+    incr_ok &= memcmp(t_incr, t_full, sizeof(t_full)) == 0;
+
+    uint16_t sp_idx[4] = { 2, 17, 100, 254 };
+    int8_t sp_val[4] = { -1, 2, -3, 1 };
+    sparse_vector_t sp = { RS_SECRET_DIM, 4, sp_idx, sp_val, 4 };
+    for (int t = 0; t < 4; t++) {
+        s_cur[sp_idx[t]] += sp_val[t];
+    }
+    reference_lwr_tag(B_rows, s_cur, t_full);
+    delta_ok &= rs_lwr_state_tag_delta(&st, &sp, t_incr) == 0 &&
+                memcmp(t_incr, t_full, sizeof(t_full)) == 0;
+    sp.dimension = RS_SECRET_DIM * 2;
+    delta_ok &= rs_lwr_state_tag_delta(&st, &sp, t_incr) == -1;
+    // The state still holds s without the sparse change
+    for (int t = 0; t < 4; t++) {
+        s_cur[sp_idx[t]] -= sp_val[t];
+    }
+    reference_lwr_tag(B_rows, s_cur, t_full);
+    rs_lwr_state_tag(&st, t_incr);
+    delta_ok &= memcmp(t_incr, t_full, sizeof(t_full)) == 0;
+
+    printf("  Batched tags match, 0-%d secrets: %s\n", SECRETS, batch_ok ? "PASS" : "FAIL");
+    printf("  Incremental tag updates match: %s\n", incr_ok ? "PASS" : "FAIL");
+    printf("  Tag of s + sparse delta matches: %s\n", delta_ok ? "PASS" : "FAIL");
+    printf("  Tags from seed match derived rows: %s\n", fused_ok ? "PASS" : "FAIL");
+    printf("  Multi-flavor tags and C product match: %s\n\n", multi_ok ? "PASS" : "FAIL");
+
+    free(S);
+    free(T);
+    free(B_rows);
+    rs_params_clear(&params);
+}
+
+// ============================================================================
+// TEST 12: PERFORMANCE BENCHMARK
 // ============================================================================
 
 void benchmark_performance() {
-    printf("=== TEST 4: Performance Benchmark ===\n");
+    printf("=== TEST 12: Performance Benchmark ===\n");
 
     rs_params_t params;
     rs_params_init(&params,
@@ -237,9 +1419,45 @@ void benchmark_performance() {
                    test_seed_orb_x, test_seed_orb_y,
                    test_seed_B, test_seed_C);
 
-    // Benchmark A matrix generation
-    printf("  Generating all A matrices...\n");
+    // Benchmark setup and nonce derivation
+    enum { NONCES = 10000 };
+    uint8_t nonce[RS_NONCE_BYTES], nonces[4][RS_NONCE_BYTES];
+    printf("  Initializing parameters...\n");
     double start_time = get_time_ms();
+    for (int iter = 0; iter < 100; iter++) {
+        rs_params_t fresh;
+        rs_params_init(&fresh,
+                       test_seed_ax, test_seed_ay,
+                       test_seed_orb_x, test_seed_orb_y,
+                       test_seed_B, test_seed_C);
+        rs_params_clear(&fresh);
+    }
+    printf("    Per init: %.1f us\n", (get_time_ms() - start_time) * 10.0);
+
+    printf("  Deriving nonces (OpenSSL SHA3-256, cached state, 4-way)...\n");
+    start_time = get_time_ms();
+    for (int i = 0; i < NONCES; i++) {
+        uint8_t suffix[8] = { (uint8_t)i, (uint8_t)(i >> 8) };
+        evp_hash(EVP_sha3_256(), "B_ROW", 5, test_seed_B, 32, suffix, 8, nonces[0], 32);
+    }
+    double evp_ns = (get_time_ms() - start_time) * 1e6 / NONCES;
+    start_time = get_time_ms();
+    for (int i = 0; i < NONCES; i++) {
+        rs_derive_nonce_from(&params.nonce_B, i, 0, nonce);
+    }
+    double cached_ns = (get_time_ms() - start_time) * 1e6 / NONCES;
+    start_time = get_time_ms();
+    for (int i = 0; i < NONCES; i += 4) {
+        const int idx1[4] = { i, i + 1, i + 2, i + 3 }, idx2[4] = { 0, 0, 0, 0 };
+        rs_derive_nonces_x4(&params.nonce_B, idx1, idx2, nonces);
+    }
+    double x4_ns = (get_time_ms() - start_time) * 1e6 / NONCES;
+    printf("    Per nonce: %.0f / %.0f / %.0f ns (checksum %u)\n\n",
+           evp_ns, cached_ns, x4_ns, nonce[0] + nonces[0][0]);
+
+    // Benchmark A matrix generation
+    printf("  Generating all A matrices (%s)...\n", rs_aes_implementation_name());
+    start_time = get_time_ms();
 
     for (int family = 0; family < 4; family++) {
         for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
@@ -259,6 +1477,175 @@ void benchmark_performance() {
     printf("    Per matrix: %.3f ms\n", ms_per_matrix);
     printf("    Throughput: %.0f matrices/sec\n\n", 1000.0 / ms_per_matrix);
 
+    // Benchmark expansion, then reads from the expanded set
+    printf("  Expanding all A matrices, B and C rows...\n");
+    start_time = get_time_ms();
+    rs_expanded_params_t *expanded = rs_expanded_create(&params, NULL);
+    end_time = get_time_ms();
+    printf("    Total time: %.2f ms\n", end_time - start_time);
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    rs_expand_opts_t parallel = { 0, 0, NULL, cores > 1 ? (int)cores : 1, NULL, 0 };
+    printf("  Expanding on %d threads...\n", parallel.threads);
+    start_time = get_time_ms();
+    rs_expanded_params_t *expanded_par = rs_expanded_create(&params, &parallel);
+    end_time = get_time_ms();
+    printf("    Total time: %.2f ms\n", end_time - start_time);
+    rs_expanded_destroy(expanded_par);
+
+    uint32_t sum = 0;
+    start_time = get_time_ms();
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_matrix_ref_t A;
+                rs_expanded_A_ref(expanded, (rs_family_t)family, ell, slot, NULL, &A);
+                sum += A.m16 ? A.m16->data[slot][ell] : A.m32->data[slot][ell];
+            }
+        }
+    }
+    end_time = get_time_ms();
+    printf("    Per cached A read: %.0f ns (checksum %u)\n\n",
+           (end_time - start_time) * 1000000.0 / total_matrices, sum);
+    rs_expanded_destroy(expanded);
+
+    // Benchmark mapping a saved parameter file instead
+    char path[] = "/tmp/rs_params_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        close(fd);
+        rs_params_save(path, &params);
+        printf("  Mapping the saved parameter file...\n");
+        start_time = get_time_ms();
+        expanded = rs_params_map(path, &params);
+        end_time = get_time_ms();
+        printf("    Total time: %.3f ms (%s)\n\n", end_time - start_time,
+               rs_expanded_is_mapped(expanded) ? "mapped" : "regenerated");
+        rs_expanded_destroy(expanded);
+        remove(path);
+    }
+
+    // Benchmark streamed matrix-vector products
+    printf("  Streaming A·x for all A matrices...\n");
+    uint32_t x[RS_N], y[RS_N];
+    for (int j = 0; j < RS_N; j++) {
+        x[j] = (uint32_t)j * 2654435761u;
+    }
+    start_time = get_time_ms();
+
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_A_times_vec(&params, (rs_family_t)family, ell, slot, x, y);
+            }
+        }
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Total time: %.2f ms\n", total_ms);
+    printf("    Per A·x: %.3f ms\n\n", total_ms / total_matrices);
+
+    // Benchmark the same products from the expanded set, at stored width
+    printf("  Cached A·x for all A matrices...\n");
+    expanded = rs_expanded_create(&params, NULL);
+    start_time = get_time_ms();
+
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_expanded_A_times_vec(expanded, (rs_family_t)family, ell, slot, x, y);
+            }
+        }
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Total time: %.2f ms\n", total_ms);
+    printf("    Per A·x: %.3f ms\n\n", total_ms / total_matrices);
+    rs_expanded_destroy(expanded);
+
+    // Benchmark the dense kernels on in-memory matrices, all layers
+    {
+        enum { BENCH_ITERS = 200, BENCH_VECS = 8 };
+        static rs_matrix_t As[RS_NUM_LAYERS][RS_SLOT_COUNT];
+        static uint32_t X[BENCH_VECS][RS_N], Y[BENCH_VECS][RS_N];
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_derive_A(&params, RS_FAMILY_AX, ell, slot, &As[ell][slot]);
+            }
+        }
+        for (int k = 0; k < BENCH_VECS; k++) {
+            memcpy(X[k], x, sizeof(X[k]));
+            X[k][0] += (uint32_t)k;
+        }
+        const double products = (double)BENCH_ITERS * RS_NUM_LAYERS * BENCH_VECS;
+
+        printf("  Dense A·x, one vector at a time...\n");
+        start_time = get_time_ms();
+        for (int it = 0; it < BENCH_ITERS; it++) {
+            for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+                for (int k = 0; k < BENCH_VECS; k++) {
+                    rs_matvec(&As[ell][0], X[k], Y[k], ell);
+                }
+            }
+        }
+        total_ms = get_time_ms() - start_time;
+        printf("    Per A·x: %.0f ns\n", total_ms * 1000000.0 / products);
+
+        printf("  Dense A·X, %d vectors per call...\n", BENCH_VECS);
+        start_time = get_time_ms();
+        for (int it = 0; it < BENCH_ITERS; it++) {
+            for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+                rs_matmat(&As[ell][0], (const uint32_t (*)[RS_N])X, BENCH_VECS, Y, ell);
+            }
+        }
+        total_ms = get_time_ms() - start_time;
+        printf("    Per A·x: %.0f ns\n", total_ms * 1000000.0 / products);
+
+        printf("  Dense slot sums, %d products per call...\n", RS_SLOT_COUNT);
+        start_time = get_time_ms();
+        for (int it = 0; it < BENCH_ITERS; it++) {
+            for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+                for (int k = 0; k < BENCH_VECS; k += RS_SLOT_COUNT) {
+                    const rs_matrix_t *A_slots[RS_SLOT_COUNT];
+                    for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                        A_slots[slot] = &As[ell][slot];
+                    }
+                    rs_matvec_slots(A_slots, (const uint32_t (*)[RS_N])X[k], Y[k], ell);
+                }
+            }
+        }
+        total_ms = get_time_ms() - start_time;
+        printf("    Per A·x: %.0f ns (checksum %u)\n\n", total_ms * 1000000.0 / products, Y[0][0]);
+    }
+
+    // Benchmark ring-structured products from an expanded ring set
+    printf("  Ring A·x for all A blocks (NTT)...\n");
+    rs_params_t ring;
+    rs_params_init(&ring,
+                   test_seed_ax, test_seed_ay,
+                   test_seed_orb_x, test_seed_orb_y,
+                   test_seed_B, test_seed_C);
+    rs_params_set_A_mode(&ring, RS_A_RING);
+    expanded = rs_expanded_create(&ring, NULL);
+    start_time = get_time_ms();
+
+    for (int family = 0; family < 4; family++) {
+        for (int ell = 0; ell < RS_NUM_LAYERS; ell++) {
+            for (int slot = 0; slot < RS_SLOT_COUNT; slot++) {
+                rs_expanded_A_times_vec(expanded, (rs_family_t)family, ell, slot, x, y);
+            }
+        }
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Total time: %.2f ms (%zu KB expanded)\n", total_ms, rs_expanded_bytes(expanded) / 1024);
+    printf("    Per A·x: %.3f ms\n\n", total_ms / total_matrices);
+    rs_expanded_destroy(expanded);
+    rs_params_clear(&ring);
+
     // Benchmark B row generation
     printf("  Generating %d B rows...\n", RS_PUBLIC_DIM);
     start_time = get_time_ms();
@@ -303,6 +1690,155 @@ void benchmark_performance() {
     printf("    Per LWR tag: %.0f ns\n", ns_per_tag);
     printf("    Throughput: %.0f tags/sec\n\n", 1000000000.0 / ns_per_tag);
 
+    // Same tag on the column-interleaved layout
+    {
+        rs_B_interleaved_t *Bi = malloc(sizeof(*Bi));
+        rs_B_interleave(B_rows, Bi);
+        printf("  Computing LWR tags, interleaved B...\n");
+        start_time = get_time_ms();
+
+        for (int iter = 0; iter < num_iterations; iter++) {
+            rs_lwr_tag_interleaved(Bi, s, t);
+        }
+
+        end_time = get_time_ms();
+        total_ms = end_time - start_time;
+        printf("    Per LWR tag: %.0f ns\n\n", (total_ms * 1000000.0) / num_iterations);
+        free(Bi);
+    }
+
+    // Benchmark one-shot tags: derive all of B then tag, or fused
+    printf("  One-shot LWR tags (derive B, then tag)...\n");
+    num_iterations = 200;
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+            rs_derive_B_row(&params, i, RS_FLAVOR_LWR, &B_rows[i]);
+        }
+        rs_lwr_tag(B_rows, s, t);
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Per tag: %.0f ns\n", (total_ms * 1000000.0) / num_iterations);
+
+    printf("  One-shot LWR tags (fused, from seed)...\n");
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        rs_lwr_tag_from_seed(&params, RS_FLAVOR_LWR, s, t);
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Per tag: %.0f ns\n\n", (total_ms * 1000000.0) / num_iterations);
+    num_iterations = 1000;
+
+    // Benchmark incremental tags: a few coordinates of s change per tag
+    {
+        enum { CHANGED = 4 };
+        rs_lwr_state_t st;
+        uint16_t idx[CHANGED] = { 3, 77, 140, 201 };
+        int32_t delta[CHANGED] = { 1, -1, 2, -2 };
+        rs_lwr_state_init(&st, B_rows, s, NULL);
+        printf("  Updating LWR tags, %d coordinates changed...\n", CHANGED);
+        start_time = get_time_ms();
+
+        for (int iter = 0; iter < num_iterations; iter++) {
+            delta[0] = -delta[0];
+            rs_lwr_state_update(&st, idx, delta, CHANGED, t);
+        }
+
+        end_time = get_time_ms();
+        total_ms = end_time - start_time;
+        printf("    Per update: %.0f ns\n\n", (total_ms * 1000000.0) / num_iterations);
+    }
+
+    // Benchmark every flavor and the C product per pass over s
+    rs_row_t (*sets)[RS_PUBLIC_DIM] = malloc(sizeof(*sets) * RS_LWR_MAX_SETS);
+    rs_row_t *C_rows = malloc(sizeof(rs_row_t) * RS_PUBLIC_DIM);
+    for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+        for (int k = 0; k < RS_LWR_MAX_SETS; k++) {
+            rs_derive_B_row(&params, i, (rs_flavor_t)k, &sets[k][i]);
+        }
+        rs_derive_C_row(&params, i, &C_rows[i]);
+    }
+    const rs_row_t *const set_ptrs[RS_LWR_MAX_SETS] = { sets[0], sets[1], sets[2] };
+    uint16_t t_multi[RS_LWR_MAX_SETS][RS_PUBLIC_DIM];
+    uint32_t c_multi[RS_PUBLIC_DIM];
+    printf("  Computing %d flavor tags and C·s, separately...\n", RS_LWR_MAX_SETS);
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        for (int k = 0; k < RS_LWR_MAX_SETS; k++) {
+            rs_lwr_tag(sets[k], s, t_multi[k]);
+        }
+        for (int i = 0; i < RS_PUBLIC_DIM; i++) {
+            uint32_t acc = 0;
+            for (int j = 0; j < RS_SECRET_DIM; j++) {
+                acc += C_rows[i].data[j] * (uint32_t)s[j];
+            }
+            c_multi[i] = acc;
+        }
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Per set: %.0f ns\n", (total_ms * 1000000.0) / num_iterations);
+
+    printf("  Computing %d flavor tags and C·s, one pass...\n", RS_LWR_MAX_SETS);
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        rs_lwr_tag_multi(set_ptrs, RS_LWR_MAX_SETS, C_rows, s, t_multi, c_multi);
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    printf("    Per set: %.0f ns\n\n", (total_ms * 1000000.0) / num_iterations);
+    free(sets);
+    free(C_rows);
+
+    // Benchmark tags with the secret bound declared
+    printf("  Computing LWR tags, |s| <= %d declared...\n", RS_LWR_SMALL_BOUND);
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        rs_lwr_tag_bounded(B_rows, s, RS_LWR_SMALL_BOUND, t);
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    ns_per_tag = (total_ms * 1000000.0) / num_iterations;
+    printf("    Total time: %.2f ms\n", total_ms);
+    printf("    Per LWR tag: %.0f ns\n\n", ns_per_tag);
+
+    // Benchmark batched tags: many secrets per pass over B
+    enum { BATCH = 64 };
+    int32_t (*S)[RS_SECRET_DIM] = malloc(sizeof(*S) * BATCH);
+    uint16_t (*T)[RS_PUBLIC_DIM] = malloc(sizeof(*T) * BATCH);
+    for (int k = 0; k < BATCH; k++) {
+        uint8_t seed[32] = { (uint8_t)k };
+        rs_generate_secret(S[k], seed);
+    }
+    printf("  Computing LWR tags in batches of %d...\n", BATCH);
+    num_iterations = 100;
+    start_time = get_time_ms();
+
+    for (int iter = 0; iter < num_iterations; iter++) {
+        rs_lwr_tag_batch(B_rows, (const int32_t (*)[RS_SECRET_DIM])S, BATCH, T);
+    }
+
+    end_time = get_time_ms();
+    total_ms = end_time - start_time;
+    ns_per_tag = (total_ms * 1000000.0) / ((double)num_iterations * BATCH);
+    printf("    Total time: %.2f ms\n", total_ms);
+    printf("    Per LWR tag: %.0f ns\n", ns_per_tag);
+    printf("    Throughput: %.0f tags/sec\n\n", 1000000000.0 / ns_per_tag);
+    free(S);
+    free(T);
+
     // Print sample tag for sanity
     printf("  Sample tag (first 8 values): ");
     for (int i = 0; i < 8; i++) {
@@ -312,6 +1848,7 @@ void benchmark_performance() {
 
     free(B_rows);
     free(s);
+    rs_params_clear(&params);
 }
 
 // ============================================================================
@@ -334,6 +1871,14 @@ int main() {
     test_determinism();
     test_domain_separation();
     test_distribution();
+    test_prf_compat();
+    test_aes_backends();
+    test_uniform_reduction();
+    test_streaming_A();
+    test_expanded_params();
+    test_params_file();
+    test_ring_A();
+    test_lwr_kernels();
     benchmark_performance();
 
     printf("========================================\n");
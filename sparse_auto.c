@@ -0,0 +1,393 @@
+/**
+ * sparse_auto.c
+ *
+ * Automatic codec selection
+ * - Statistics pass: histogram, first position, Rice quotients of the gaps
+ *   for the fixed parameters and for phase3's adaptive one
+ * - Huffman code lengths from the histogram, as each codec builds them
+ * - ANS sizes from the ideal code lengths under the codec's frequencies
+ */
+
+#include "sparse_auto.h"
+#include "canonical_huffman.h"
+#include "huffman_lengths.h"
+#include "rans_interleaved.h"
+#include "sparse_adaptive.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include "sparse_scan.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* All but the dictionary formats store the first position in 11 bits */
+#define FIRST_POSITION_LIMIT 2048
+
+#define SCAN_BLOCK 1024
+
+typedef struct {
+    size_t dimension;
+    uint32_t count;
+    int64_t first;          /* -1 if the vector is empty */
+    uint32_t hist[256];     /* by value + 128 */
+    int min, max;
+    uint64_t gap_q3, gap_q4;    /* sum of gap >> r over the gaps after the first */
+    uint64_t phase3_gap_bits;   /* those gaps with phase3's adaptive parameter */
+} vector_stats_t;
+
+static void collect_stats(const int8_t *vector, size_t dimension, vector_stats_t *s) {
+    memset(s, 0, sizeof(*s));
+    s->dimension = dimension;
+    s->first = -1;
+
+    /* Scanned a block at a time, so the lists stay on the stack */
+    uint16_t positions[SCAN_BLOCK];
+    int8_t values[SCAN_BLOCK];
+    size_t prev = 0;
+    uint32_t prev_gap = 16;
+    for (size_t base = 0; base < dimension; base += SCAN_BLOCK) {
+        const size_t n = dimension - base < SCAN_BLOCK ? dimension - base : SCAN_BLOCK;
+        const size_t found = sparse_scan(vector + base, n, positions, values, s->hist);
+        for (size_t j = 0; j < found; j++) {
+            const size_t i = base + positions[j];
+            if (s->count++ == 0) {
+                s->first = (int64_t)i;
+            } else {
+                const uint32_t gap = (uint32_t)(i - prev - 1);
+                s->gap_q3 += gap >> 3;
+                s->gap_q4 += gap >> 4;
+
+                /* As sparse_phase3: r = log2 of the previous gap, in 2..6 */
+                unsigned r = 4;
+                if (prev_gap > 0) {
+                    r = tans_highbit(prev_gap);
+                    r = r < 2 ? 2 : r > 6 ? 6 : r;
+                }
+                s->phase3_gap_bits += (gap >> r) + 1 + r;
+                prev_gap = gap;
+            }
+            prev = i;
+        }
+    }
+    int8_t min, max;
+    sparse_scan_range(s->hist, &min, &max);
+    s->min = min;
+    s->max = max;
+}
+
+/* Bits of the gaps after the first with a fixed Rice parameter (3 or 4) */
+static uint64_t gap_bits(const vector_stats_t *s, unsigned r) {
+    return (uint64_t)(s->count - 1) * (1 + r) + (r == 3 ? s->gap_q3 : s->gap_q4);
+}
+
+/* Huffman-coded values, with lengths as the codec builds them over its
+ * alphabet in value order */
+static uint64_t huffman_value_bits(const vector_stats_t *s, int lo, int hi, unsigned limit,
+                                   int *n_unique) {
+    uint32_t freqs[256];
+    uint8_t lengths[256];
+    int n = 0;
+    for (int v = lo; v <= hi; v++) {
+        if (v != 0 && s->hist[(uint8_t)(v + 128)]) freqs[n++] = s->hist[(uint8_t)(v + 128)];
+    }
+    *n_unique = n;
+    if (n == 0 || huff_build_lengths(freqs, n, limit, lengths) < 0) return 0;
+    uint64_t bits = 0;
+    for (int i = 0; i < n; i++) {
+        bits += (uint64_t)freqs[i] * lengths[i];
+    }
+    return bits;
+}
+
+/* Ideal bits of the values, each coded in log2(total / freq) bits */
+static double entropy_bits(const uint32_t *counts, const uint32_t *freqs, int n, double total) {
+    double bits = 0;
+    for (int i = 0; i < n; i++) {
+        if (counts[i]) bits += counts[i] * log2(total / freqs[i]);
+    }
+    return bits;
+}
+
+/* As sparse_phase2: lanes by count of values, 3 state bytes each */
+static size_t rans_bytes(double bits, uint32_t count) {
+    const unsigned lanes = count >= 2048 ? 8 : count >= 512 ? 4 : count >= 128 ? 2 : 1;
+    return (size_t)ceil(bits / 8) + (size_t)lanes * RANS_STATE_BYTES;
+}
+
+static size_t bytes_of(uint64_t bits) {
+    return (size_t)((bits + 7) / 8);
+}
+
+int sparse_auto_estimate(const int8_t *vector, size_t dimension, const sparse_dict_t *dict,
+                         size_t sizes[SPARSE_AUTO_N_FORMATS]) {
+    if (!vector || !sizes || dimension == 0 || dimension > 65535) return -1;
+
+    vector_stats_t s;
+    collect_stats(vector, dimension, &s);
+    memset(sizes, 0, SPARSE_AUTO_N_FORMATS * sizeof(size_t));
+
+    const uint32_t k = s.count;
+    const int first_ok = k == 0 || s.first < FIRST_POSITION_LIMIT;
+    const unsigned r = dimension / (k ? k : 1) >= 16 ? 4 : 3;
+
+    if (first_ok && k == 0) {
+        /* Rice writes its header anyway; the others two zero bytes */
+        sizes[SPARSE_AUTO_RICE] = 3;
+        for (int f = SPARSE_AUTO_ADAPTIVE; f <= SPARSE_AUTO_PHASE2_TANS; f++) {
+            sizes[f] = 2;
+        }
+    } else if (first_ok) {
+        const int span = s.max - s.min + 1;
+        int n_unique;
+
+        /* Rice: fixed codes 0, 10, 110, 111 for -2, 2, -1, 1 */
+        if (s.hist[126] + s.hist[127] + s.hist[129] + s.hist[130] == k) {
+            sizes[SPARSE_AUTO_RICE] = bytes_of(30 + gap_bits(&s, 4) + s.hist[126] +
+                                               2ull * s.hist[130] +
+                                               3ull * (s.hist[127] + s.hist[129]));
+        }
+
+        /* Adaptive: values + 8 and lengths in 4 bits, up to 15 values */
+        if (s.min >= -8 && s.max <= 7) {
+            uint64_t value_bits = huffman_value_bits(&s, -8, 8, 15, &n_unique);
+            if (n_unique < 16) {
+                sizes[SPARSE_AUTO_ADAPTIVE] = bytes_of(34 + 8ull * n_unique +
+                                                       gap_bits(&s, 4) + value_bits);
+            }
+        }
+
+        /* Phase3 and optimal_large share their codes; the alphabet differs.
+         * Their int8 symbol maps hold up to 128 values */
+        uint64_t value_bits = huffman_value_bits(&s, s.min, s.max, CHUFF_MAX_LEN, &n_unique);
+        if (n_unique <= 128) {
+            sizes[SPARSE_AUTO_PHASE3] = bytes_of(43 + span + 5ull * n_unique +
+                                                 s.phase3_gap_bits + value_bits);
+            sizes[SPARSE_AUTO_OPTIMAL_LARGE] = bytes_of(38 + 13ull * n_unique +
+                                                        gap_bits(&s, r) + value_bits);
+        }
+
+        /* Phase2's own table: 8-bit frequencies in value order */
+        uint32_t counts[256];
+        int n = 0;
+        for (int v = s.min; v <= s.max; v++) {
+            if (v != 0 && s.hist[(uint8_t)(v + 128)]) counts[n++] = s.hist[(uint8_t)(v + 128)];
+        }
+        const double bits = entropy_bits(counts, counts, n, k);
+        const uint64_t header = 46 + span + 8ull * n + gap_bits(&s, r);
+        sizes[SPARSE_AUTO_PHASE2_RANS] = bytes_of(header) + rans_bytes(bits, k);
+        sizes[SPARSE_AUTO_PHASE2_TANS] = bytes_of(header + 8 + (uint64_t)ceil(bits));
+    }
+
+    /* Dictionary: every position a gap, escapes stored raw */
+    if (dict && k == 0) {
+        sizes[SPARSE_AUTO_DICT_RANS] = sizes[SPARSE_AUTO_DICT_TANS] = 3;
+    } else if (dict) {
+        uint32_t counts[256] = {0};
+        uint32_t n_escapes = 0;
+        for (int v = s.min; v <= s.max; v++) {
+            const uint32_t c = s.hist[(uint8_t)(v + 128)];
+            const uint8_t sym = dict->index[(uint8_t)(v + 128)];
+            counts[sym] += c;
+            if (sym == dict->n_values) n_escapes += c;
+        }
+        const double bits = entropy_bits(counts, dict->freqs, dict->n_values + 1, RANS_TOTAL);
+        const unsigned dict_r = dimension / k < 16 ? 3 : 4;
+        const uint64_t header = 24 + gap_bits(&s, dict_r) + 1 + dict_r + (s.first >> dict_r) +
+                                (n_escapes ? 16 + 8ull * n_escapes : 0);
+        sizes[SPARSE_AUTO_DICT_RANS] = bytes_of(header) + rans_bytes(bits, k);
+        sizes[SPARSE_AUTO_DICT_TANS] = bytes_of(header + 8 + (uint64_t)ceil(bits));
+    }
+    return 0;
+}
+
+int sparse_auto_choose(const int8_t *vector, size_t dimension, const sparse_dict_t *dict) {
+    size_t sizes[SPARSE_AUTO_N_FORMATS];
+    if (sparse_auto_estimate(vector, dimension, dict, sizes) < 0) return -1;
+
+    int best = -1;
+    for (int f = 0; f < SPARSE_AUTO_N_FORMATS; f++) {
+        if (sizes[f] && (best < 0 || sizes[f] < sizes[best])) best = f;
+    }
+    return best;
+}
+
+size_t sparse_auto_max_encoded_size(size_t dimension, size_t k) {
+    const size_t bounds[] = {
+        sparse_rice_max_encoded_size(dimension, k),
+        sparse_adaptive_max_encoded_size(dimension, k),
+        sparse_phase3_max_encoded_size(dimension, k),
+        sparse_optimal_large_max_encoded_size(dimension, k),
+        sparse_phase2_max_encoded_size(dimension, k),
+    };
+    size_t max = 0;
+    for (size_t i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++) {
+        if (bounds[i] == 0) return 0;
+        if (bounds[i] > max) max = bounds[i];
+    }
+    return 1 + max;
+}
+
+static int encode_format(int format, const int8_t *vector, size_t dimension,
+                         const sparse_dict_t *dict, uint8_t *out, size_t out_cap,
+                         size_t *written) {
+    switch (format) {
+    case SPARSE_AUTO_RICE:
+        return sparse_rice_encode_into(vector, dimension, out, out_cap, written);
+    case SPARSE_AUTO_ADAPTIVE:
+        return sparse_adaptive_encode_into(vector, dimension, out, out_cap, written);
+    case SPARSE_AUTO_PHASE3:
+        return sparse_phase3_encode_into(vector, dimension, out, out_cap, written);
+    case SPARSE_AUTO_OPTIMAL_LARGE:
+        return sparse_optimal_large_encode_into(vector, dimension, out, out_cap, written);
+    case SPARSE_AUTO_PHASE2_RANS:
+    case SPARSE_AUTO_PHASE2_TANS:
+        return sparse_phase2_encode_coder_into(vector, dimension,
+                                               format == SPARSE_AUTO_PHASE2_TANS
+                                                   ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS,
+                                               out, out_cap, written);
+    case SPARSE_AUTO_DICT_RANS:
+    case SPARSE_AUTO_DICT_TANS:
+        return sparse_phase2_encode_dict_into(vector, dimension, dict,
+                                              format == SPARSE_AUTO_DICT_TANS
+                                                  ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS,
+                                              out, out_cap, written);
+    default:
+        return -1;
+    }
+}
+
+int sparse_auto_encode_into(const int8_t *vector, size_t dimension, const sparse_dict_t *dict,
+                            uint8_t *out, size_t out_cap, size_t *written) {
+    if (!out || !written || out_cap < 1) return -1;
+
+    const int format = sparse_auto_choose(vector, dimension, dict);
+    if (format < 0) return -1;
+
+    size_t size;
+    if (encode_format(format, vector, dimension, dict, out + 1, out_cap - 1, &size) < 0) {
+        return -1;
+    }
+    out[0] = (uint8_t)format;
+    *written = 1 + size;
+    return 0;
+}
+
+sparse_auto_t* sparse_auto_encode(const int8_t *vector, size_t dimension,
+                                  const sparse_dict_t *dict) {
+    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+
+    size_t count = sparse_scan_count(vector, dimension);
+
+    sparse_auto_t *result = malloc(sizeof(sparse_auto_t));
+    if (!result) return NULL;
+
+    size_t max_size = sparse_auto_max_encoded_size(dimension, count);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        sparse_auto_encode_into(vector, dimension, dict, result->data, max_size,
+                                &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
+    }
+    result->count = (uint16_t)count;
+    return result;
+}
+
+int sparse_auto_decode(const sparse_auto_t *encoded, int8_t *vector, size_t dimension,
+                       const sparse_dict_t *dict) {
+    if (!encoded || !encoded->data || encoded->size < 1 || !vector) return -1;
+
+    /* Every codec's result is laid out as data, size, count */
+    uint8_t *data = encoded->data + 1;
+    const size_t size = encoded->size - 1;
+    const uint16_t count = encoded->count;
+
+    switch (encoded->data[0]) {
+    case SPARSE_AUTO_RICE: {
+        const sparse_rice_t e = { data, size, count };
+        return sparse_rice_decode(&e, vector, dimension);
+    }
+    case SPARSE_AUTO_ADAPTIVE: {
+        const sparse_adaptive_t e = { data, size, count };
+        return sparse_adaptive_decode(&e, vector, dimension);
+    }
+    case SPARSE_AUTO_PHASE3: {
+        const sparse_phase3_t e = { data, size, count };
+        return sparse_phase3_decode(&e, vector, dimension);
+    }
+    case SPARSE_AUTO_OPTIMAL_LARGE: {
+        const sparse_optimal_large_t e = { data, size, count };
+        return sparse_optimal_large_decode(&e, vector, dimension);
+    }
+    case SPARSE_AUTO_PHASE2_RANS:
+    case SPARSE_AUTO_PHASE2_TANS: {
+        const sparse_phase2_t e = { data, size, count };
+        return sparse_phase2_decode_coder(&e, vector, dimension,
+                                          encoded->data[0] == SPARSE_AUTO_PHASE2_TANS
+                                              ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS);
+    }
+    case SPARSE_AUTO_DICT_RANS:
+    case SPARSE_AUTO_DICT_TANS: {
+        const sparse_phase2_t e = { data, size, count };
+        return sparse_phase2_decode_dict(&e, vector, dimension, dict,
+                                         encoded->data[0] == SPARSE_AUTO_DICT_TANS
+                                             ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS);
+    }
+    default:
+        return -1;
+    }
+}
+
+int sparse_auto_decode_sparse(const sparse_auto_t *encoded, sparse_vector_t *out,
+                              const sparse_dict_t *dict) {
+    if (!encoded || !encoded->data || encoded->size < 1 || !out) return -1;
+
+    uint8_t *data = encoded->data + 1;
+    const size_t size = encoded->size - 1;
+    const uint16_t count = encoded->count;
+
+    switch (encoded->data[0]) {
+    case SPARSE_AUTO_RICE: {
+        const sparse_rice_t e = { data, size, count };
+        return sparse_rice_decode_sparse(&e, out);
+    }
+    case SPARSE_AUTO_ADAPTIVE: {
+        const sparse_adaptive_t e = { data, size, count };
+        return sparse_adaptive_decode_sparse(&e, out);
+    }
+    case SPARSE_AUTO_PHASE3: {
+        const sparse_phase3_t e = { data, size, count };
+        return sparse_phase3_decode_sparse(&e, out);
+    }
+    case SPARSE_AUTO_OPTIMAL_LARGE: {
+        const sparse_optimal_large_t e = { data, size, count };
+        return sparse_optimal_large_decode_sparse(&e, out);
+    }
+    case SPARSE_AUTO_PHASE2_RANS:
+    case SPARSE_AUTO_PHASE2_TANS: {
+        const sparse_phase2_t e = { data, size, count };
+        return sparse_phase2_decode_coder_sparse(&e, out,
+                                                 encoded->data[0] == SPARSE_AUTO_PHASE2_TANS
+                                                     ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS);
+    }
+    case SPARSE_AUTO_DICT_RANS:
+    case SPARSE_AUTO_DICT_TANS: {
+        const sparse_phase2_t e = { data, size, count };
+        return sparse_phase2_decode_dict_sparse(&e, out, dict,
+                                                encoded->data[0] == SPARSE_AUTO_DICT_TANS
+                                                    ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS);
+    }
+    default:
+        return -1;
+    }
+}
+
+void sparse_auto_free(sparse_auto_t *encoded) {
+    if (encoded) {
+        free(encoded->data);
+        free(encoded);
+    }
+}
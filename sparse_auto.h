@@ -0,0 +1,99 @@
+/**
+ * sparse_auto.h
+ *
+ * Automatic codec selection for sparse vectors
+ * - One pass over the vector: value histogram and gap costs
+ * - Closed-form size of every codec: Rice and Huffman costs exactly,
+ *   rANS/tANS from the entropy of the values
+ * - Only the smallest codec encodes, behind a format byte
+ */
+
+#ifndef SPARSE_AUTO_H
+#define SPARSE_AUTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sparse_dict.h"
+#include "sparse_vector.h"
+
+/* Format byte: the codec behind it (values are stored, do not renumber) */
+typedef enum {
+    SPARSE_AUTO_RICE = 0,           /* sparse_rice: values in {-2, -1, 1, 2} */
+    SPARSE_AUTO_ADAPTIVE = 1,       /* sparse_adaptive: values in [-8, 7] */
+    SPARSE_AUTO_PHASE3 = 2,         /* sparse_phase3: up to 128 values */
+    SPARSE_AUTO_OPTIMAL_LARGE = 3,  /* sparse_optimal_large: up to 128 values */
+    SPARSE_AUTO_PHASE2_RANS = 4,    /* sparse_phase2, own table */
+    SPARSE_AUTO_PHASE2_TANS = 5,
+    SPARSE_AUTO_DICT_RANS = 6,      /* sparse_phase2, shared dictionary */
+    SPARSE_AUTO_DICT_TANS = 7,
+    SPARSE_AUTO_N_FORMATS
+} sparse_auto_format_t;
+
+typedef struct {
+    uint8_t *data;      /* format byte, then the codec's stream */
+    size_t size;
+    uint16_t count;
+} sparse_auto_t;
+
+/**
+ * Estimated encoded size of the vector in every format, format byte
+ * excluded, without encoding it
+ *
+ * @param dict   Dictionary for the dictionary formats, or NULL to skip them
+ * @param sizes  Out: bytes per format, 0 where the format cannot hold the
+ *               vector
+ * @return       0, or -1 on bad arguments
+ */
+int sparse_auto_estimate(const int8_t *vector, size_t dimension, const sparse_dict_t *dict,
+                         size_t sizes[SPARSE_AUTO_N_FORMATS]);
+
+/**
+ * Format with the smallest estimate; ties go to the lower format
+ *
+ * @return  Format, or -1 if none can hold the vector
+ */
+int sparse_auto_choose(const int8_t *vector, size_t dimension, const sparse_dict_t *dict);
+
+/**
+ * Encode in the format sparse_auto_choose() picks
+ *
+ * @return  Encoded result (free with sparse_auto_free), or NULL on error
+ */
+sparse_auto_t* sparse_auto_encode(const int8_t *vector, size_t dimension,
+                                  const sparse_dict_t *dict);
+
+/**
+ * As sparse_auto_encode(), into a caller-provided buffer;
+ * sparse_auto_max_encoded_size() bytes always suffice
+ *
+ * @return  0, or -1 on error or if the encoding does not fit
+ */
+int sparse_auto_encode_into(const int8_t *vector, size_t dimension, const sparse_dict_t *dict,
+                            uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case size of k nonzeros in dimension, any format
+ *
+ * @return  Bytes, or 0 if dimension or k is out of range
+ */
+size_t sparse_auto_max_encoded_size(size_t dimension, size_t k);
+
+/**
+ * Decode whatever format the stream names; for the dictionary formats,
+ * dict NULL means the built-in dictionary of the stream's header
+ */
+int sparse_auto_decode(const sparse_auto_t *encoded, int8_t *vector, size_t dimension,
+                       const sparse_dict_t *dict);
+
+/**
+ * As sparse_auto_decode(), into sparse form (see sparse_vector.h)
+ */
+int sparse_auto_decode_sparse(const sparse_auto_t *encoded, sparse_vector_t *out,
+                              const sparse_dict_t *dict);
+
+/**
+ * Free encoded result
+ */
+void sparse_auto_free(sparse_auto_t *encoded);
+
+#endif /* SPARSE_AUTO_H */
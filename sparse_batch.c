@@ -0,0 +1,368 @@
+/**
+ * sparse_batch.c
+ *
+ * Batch container for sparse_phase2 streams
+ * - Vectors encoded in chunks, one chunk per task, by any thread
+ * - Chunks joined in order behind the header and offset index
+ * - Each thread keeps its own codec context
+ */
+
+#include "sparse_batch.h"
+#include "dntl_sched.h"
+#include "sparse_scan.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_MAGIC_0  'S'
+#define BATCH_MAGIC_1  'B'
+#define BATCH_VERSION  1
+
+#define FLAG_TANS      0x01
+#define FLAG_DICT      0x02
+
+/* Vectors per task: enough to amortize a task, few enough to balance */
+#define BATCH_CHUNK    64
+
+static void put_u16(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, v);
+    put_u16(p + 2, v >> 16);
+}
+
+static uint32_t get_u16(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | get_u16(p + 2) << 16;
+}
+
+/*
+ * Tasks of one call, taken in turn by every thread
+ */
+typedef struct {
+    size_t n_tasks;
+    atomic_size_t next;
+    atomic_int error;
+    size_t dimension;
+    int (*run)(void *job, sparse_codec_ctx_t *ctx, size_t task);
+    void *job;
+} batch_tasks_t;
+
+static void batch_worker(void *arg) {
+    batch_tasks_t *t = arg;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_create(t->dimension);
+    if (!ctx) {
+        atomic_store(&t->error, 1);
+        return;
+    }
+    size_t task;
+    while (!atomic_load_explicit(&t->error, memory_order_relaxed) &&
+           (task = atomic_fetch_add_explicit(&t->next, 1, memory_order_relaxed)) < t->n_tasks) {
+        if (t->run(t->job, ctx, task) < 0) {
+            atomic_store(&t->error, 1);
+        }
+    }
+    sparse_codec_ctx_free(ctx);
+}
+
+/* Run every task on up to threads threads, the caller's included; -1 if one failed */
+static int batch_run(batch_tasks_t *t, int threads) {
+    atomic_init(&t->next, 0);
+    atomic_init(&t->error, 0);
+
+    /* Fewer threads than asked (the scheduler's workers are shared) only
+     * means more tasks for the ones running */
+    const size_t wanted = threads > 1 ? (size_t)threads : 1;
+    dntl_sched_spread(wanted > 1 ? dntl_sched_default() : NULL, batch_worker, t,
+                      wanted < t->n_tasks ? wanted : t->n_tasks);
+    return atomic_load(&t->error) ? -1 : 0;
+}
+
+/* ========== Encoding ========== */
+
+typedef struct {
+    const int8_t *vectors;
+    size_t n_vectors;
+    size_t dimension;
+    const sparse_dict_t *dict;
+    sparse_phase2_coder_t coder;
+    uint8_t **chunks;       /* per chunk: its vectors' streams, in order */
+    size_t *sizes;          /* per vector */
+    uint16_t *counts;
+} encode_job_t;
+
+static int encode_chunk(void *arg, sparse_codec_ctx_t *ctx, size_t c) {
+    encode_job_t *job = arg;
+    const size_t first = c * BATCH_CHUNK;
+    const size_t last = first + BATCH_CHUNK < job->n_vectors ? first + BATCH_CHUNK
+                                                             : job->n_vectors;
+    uint8_t *buf = NULL;
+    size_t cap = 0, used = 0;
+
+    for (size_t i = first; i < last; i++) {
+        const int8_t *vector = job->vectors + i * job->dimension;
+        const size_t count = sparse_scan_count(vector, job->dimension);
+
+        /* Room for the worst case, so the encoder cannot run out */
+        const size_t need = sparse_phase2_max_encoded_size(job->dimension, count);
+        if (cap - used < need) {
+            size_t new_cap = 2 * cap > used + need ? 2 * cap : used + need;
+            uint8_t *grown = realloc(buf, new_cap);
+            if (!grown) {
+                free(buf);
+                return -1;
+            }
+            buf = grown;
+            cap = new_cap;
+        }
+
+        size_t written;
+        int ret = job->dict
+            ? sparse_phase2_encode_dict_ctx(ctx, vector, job->dimension, job->dict, job->coder,
+                                            buf + used, cap - used, &written)
+            : sparse_phase2_encode_coder_ctx(ctx, vector, job->dimension, job->coder,
+                                             buf + used, cap - used, &written);
+        if (ret < 0) {
+            free(buf);
+            return -1;
+        }
+        job->sizes[i] = written;
+        job->counts[i] = (uint16_t)count;
+        used += written;
+    }
+    job->chunks[c] = buf;
+    return 0;
+}
+
+sparse_batch_t* sparse_batch_encode(const int8_t *vectors, size_t n_vectors, size_t dimension,
+                                    const sparse_dict_t *dict, sparse_phase2_coder_t coder,
+                                    int threads) {
+    if ((!vectors && n_vectors > 0) || n_vectors > UINT32_MAX) return NULL;
+    if (dimension == 0 || dimension > 65535) return NULL;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return NULL;
+
+    const size_t n_chunks = (n_vectors + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    encode_job_t job = {
+        .vectors = vectors, .n_vectors = n_vectors, .dimension = dimension,
+        .dict = dict, .coder = coder,
+        .chunks = calloc(n_chunks + 1, sizeof(uint8_t *)),
+        .sizes = malloc((n_vectors + 1) * sizeof(size_t)),
+        .counts = malloc((n_vectors + 1) * sizeof(uint16_t)),
+    };
+    sparse_batch_t *result = NULL;
+    if (!job.chunks || !job.sizes || !job.counts) goto done;
+
+    batch_tasks_t tasks = {
+        .n_tasks = n_chunks, .dimension = dimension, .run = encode_chunk, .job = &job,
+    };
+    if (batch_run(&tasks, threads) < 0) goto done;
+
+    /* Offsets are 32 bits */
+    size_t payload = 0;
+    for (size_t i = 0; i < n_vectors; i++) {
+        payload += job.sizes[i];
+    }
+    if (payload > UINT32_MAX) goto done;
+
+    result = malloc(sizeof(sparse_batch_t));
+    if (!result) goto done;
+    result->size = SPARSE_BATCH_HEADER_BYTES + n_vectors * SPARSE_BATCH_INDEX_BYTES + payload;
+    result->n_vectors = (uint32_t)n_vectors;
+    result->data = malloc(result->size);
+    if (!result->data) {
+        free(result);
+        result = NULL;
+        goto done;
+    }
+
+    uint8_t *p = result->data;
+    p[0] = BATCH_MAGIC_0;
+    p[1] = BATCH_MAGIC_1;
+    p[2] = BATCH_VERSION;
+    p[3] = (uint8_t)((coder == SPARSE_PHASE2_TANS ? FLAG_TANS : 0) |
+                     (dict ? FLAG_DICT | dict->id << 4 : 0));
+    put_u32(p + 4, (uint32_t)n_vectors);
+    put_u16(p + 8, (uint32_t)dimension);
+    put_u16(p + 10, 0);
+
+    uint8_t *index = p + SPARSE_BATCH_HEADER_BYTES;
+    uint8_t *out = index + n_vectors * SPARSE_BATCH_INDEX_BYTES;
+    size_t offset = 0;
+    for (size_t c = 0; c < n_chunks; c++) {
+        const size_t first = c * BATCH_CHUNK;
+        size_t chunk_size = 0;
+        for (size_t i = first; i < first + BATCH_CHUNK && i < n_vectors; i++) {
+            put_u32(index + i * SPARSE_BATCH_INDEX_BYTES, (uint32_t)(offset + chunk_size));
+            put_u16(index + i * SPARSE_BATCH_INDEX_BYTES + 4, job.counts[i]);
+            chunk_size += job.sizes[i];
+        }
+        memcpy(out + offset, job.chunks[c], chunk_size);
+        offset += chunk_size;
+    }
+
+done:
+    if (job.chunks) {
+        for (size_t c = 0; c < n_chunks; c++) {
+            free(job.chunks[c]);
+        }
+    }
+    free(job.chunks);
+    free(job.sizes);
+    free(job.counts);
+    return result;
+}
+
+/* ========== Decoding ========== */
+
+int sparse_batch_open(sparse_batch_reader_t *reader, const uint8_t *data, size_t size) {
+    if (!reader || !data || size < SPARSE_BATCH_HEADER_BYTES) return -1;
+    if (data[0] != BATCH_MAGIC_0 || data[1] != BATCH_MAGIC_1 || data[2] != BATCH_VERSION) {
+        return -1;
+    }
+
+    const uint8_t flags = data[3];
+    const uint32_t n_vectors = get_u32(data + 4);
+    const uint32_t dimension = get_u16(data + 8);
+    if ((flags & 0x0C) || (!(flags & FLAG_DICT) && (flags >> 4))) return -1;
+    if (get_u16(data + 10) != 0 || dimension == 0) return -1;
+
+    const uint64_t index_bytes = (uint64_t)n_vectors * SPARSE_BATCH_INDEX_BYTES;
+    if (index_bytes > size - SPARSE_BATCH_HEADER_BYTES) return -1;
+
+    reader->index = data + SPARSE_BATCH_HEADER_BYTES;
+    reader->payload = reader->index + index_bytes;
+    reader->payload_size = size - SPARSE_BATCH_HEADER_BYTES - (size_t)index_bytes;
+    reader->n_vectors = n_vectors;
+    reader->dimension = (uint16_t)dimension;
+    reader->coder = flags & FLAG_TANS ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS;
+    reader->has_dict = (flags & FLAG_DICT) != 0;
+    reader->dict_id = flags >> 4;
+    return 0;
+}
+
+/* Stream of vector i, from its index entry */
+static int entry_stream(const sparse_batch_reader_t *reader, size_t i,
+                        const sparse_dict_t *dict, sparse_phase2_t *encoded) {
+    if (i >= reader->n_vectors) return -1;
+    if (reader->has_dict && dict && dict->id != reader->dict_id) return -1;
+
+    /* A vector ends where the next one starts */
+    const uint8_t *entry = reader->index + i * SPARSE_BATCH_INDEX_BYTES;
+    const size_t start = get_u32(entry);
+    const size_t end = i + 1 < reader->n_vectors ? get_u32(entry + SPARSE_BATCH_INDEX_BYTES)
+                                                 : reader->payload_size;
+    const uint32_t count = get_u16(entry + 4);
+    if (start > end || end > reader->payload_size || count > reader->dimension) return -1;
+
+    encoded->data = (uint8_t *)reader->payload + start;
+    encoded->size = end - start;
+    encoded->count = (uint16_t)count;
+    return 0;
+}
+
+int sparse_batch_decode_one(const sparse_batch_reader_t *reader, size_t i,
+                            const sparse_dict_t *dict, sparse_codec_ctx_t *ctx,
+                            int8_t *vector) {
+    sparse_phase2_t encoded;
+    if (!reader || !vector || entry_stream(reader, i, dict, &encoded) < 0) return -1;
+
+    if (reader->has_dict) {
+        return ctx ? sparse_phase2_decode_dict_ctx(ctx, &encoded, vector, reader->dimension,
+                                                   dict, reader->coder)
+                   : sparse_phase2_decode_dict(&encoded, vector, reader->dimension,
+                                               dict, reader->coder);
+    }
+    return ctx ? sparse_phase2_decode_coder_ctx(ctx, &encoded, vector, reader->dimension,
+                                                reader->coder)
+               : sparse_phase2_decode_coder(&encoded, vector, reader->dimension, reader->coder);
+}
+
+int sparse_batch_decode_one_sparse(const sparse_batch_reader_t *reader, size_t i,
+                                   const sparse_dict_t *dict, sparse_codec_ctx_t *ctx,
+                                   sparse_vector_t *out) {
+    sparse_phase2_t encoded;
+    if (!reader || !out || out->dimension != reader->dimension ||
+        entry_stream(reader, i, dict, &encoded) < 0) {
+        return -1;
+    }
+
+    if (reader->has_dict) {
+        return ctx ? sparse_phase2_decode_dict_sparse_ctx(ctx, &encoded, out, dict,
+                                                          reader->coder)
+                   : sparse_phase2_decode_dict_sparse(&encoded, out, dict, reader->coder);
+    }
+    return ctx ? sparse_phase2_decode_coder_sparse_ctx(ctx, &encoded, out, reader->coder)
+               : sparse_phase2_decode_coder_sparse(&encoded, out, reader->coder);
+}
+
+typedef struct {
+    const sparse_batch_reader_t *reader;
+    const sparse_dict_t *dict;
+    int8_t *vectors;
+} decode_job_t;
+
+static int decode_chunk(void *arg, sparse_codec_ctx_t *ctx, size_t c) {
+    decode_job_t *job = arg;
+    const size_t n_vectors = job->reader->n_vectors;
+    for (size_t i = c * BATCH_CHUNK; i < (c + 1) * BATCH_CHUNK && i < n_vectors; i++) {
+        int8_t *vector = job->vectors + i * job->reader->dimension;
+        if (sparse_batch_decode_one(job->reader, i, job->dict, ctx, vector) < 0) return -1;
+    }
+    return 0;
+}
+
+int sparse_batch_decode_all(const sparse_batch_reader_t *reader, const sparse_dict_t *dict,
+                            int threads, int8_t *vectors) {
+    if (!reader || (!vectors && reader->n_vectors > 0)) return -1;
+
+    decode_job_t job = { reader, dict, vectors };
+    batch_tasks_t tasks = {
+        .n_tasks = ((size_t)reader->n_vectors + BATCH_CHUNK - 1) / BATCH_CHUNK,
+        .dimension = reader->dimension, .run = decode_chunk, .job = &job,
+    };
+    return batch_run(&tasks, threads);
+}
+
+typedef struct {
+    const sparse_batch_reader_t *reader;
+    const sparse_dict_t *dict;
+    sparse_vector_array_t *out;
+} decode_sparse_job_t;
+
+static int decode_sparse_chunk(void *arg, sparse_codec_ctx_t *ctx, size_t c) {
+    decode_sparse_job_t *job = arg;
+    const size_t n_vectors = job->reader->n_vectors;
+    for (size_t i = c * BATCH_CHUNK; i < (c + 1) * BATCH_CHUNK && i < n_vectors; i++) {
+        if (sparse_batch_decode_one_sparse(job->reader, i, job->dict, ctx,
+                                           &job->out->vectors[i]) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int sparse_batch_decode_all_sparse(const sparse_batch_reader_t *reader,
+                                   const sparse_dict_t *dict, int threads,
+                                   sparse_vector_array_t *out) {
+    if (!reader || !out || out->n < reader->n_vectors) return -1;
+
+    decode_sparse_job_t job = { reader, dict, out };
+    batch_tasks_t tasks = {
+        .n_tasks = ((size_t)reader->n_vectors + BATCH_CHUNK - 1) / BATCH_CHUNK,
+        .dimension = reader->dimension, .run = decode_sparse_chunk, .job = &job,
+    };
+    return batch_run(&tasks, threads);
+}
+
+void sparse_batch_free(sparse_batch_t *batch) {
+    if (batch) {
+        free(batch->data);
+        free(batch);
+    }
+}
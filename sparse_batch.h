@@ -0,0 +1,115 @@
+/**
+ * sparse_batch.h
+ *
+ * Batch container: many sparse vectors of one dimension in one stream
+ * - One shared header: dimension, value coder, dictionary
+ * - Each vector a sparse_phase2 stream, with the shared dictionary or
+ *   its own table
+ * - Fixed-width offset index: any one vector decodes in O(1)
+ * - Encoding and decoding split across threads, with identical bytes
+ *   whatever the thread count
+ *
+ * Layout (little endian):
+ *   magic "SB", version, flags (bit 0 tANS, bit 1 dictionary, bits 4-7
+ *   its ID), n_vectors (32 bits), dimension (16 bits), 2 reserved bytes;
+ *   then per vector its offset into the payload (32 bits) and count of
+ *   nonzeros (16 bits); then the payload.
+ */
+
+#ifndef SPARSE_BATCH_H
+#define SPARSE_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sparse_dict.h"
+#include "sparse_phase2.h"
+
+#define SPARSE_BATCH_HEADER_BYTES 12
+#define SPARSE_BATCH_INDEX_BYTES  6     /* per vector */
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    uint32_t n_vectors;
+} sparse_batch_t;
+
+/* Parsed header of a stream, which it points into */
+typedef struct {
+    const uint8_t *index;
+    const uint8_t *payload;
+    size_t payload_size;
+    uint32_t n_vectors;
+    uint16_t dimension;
+    sparse_phase2_coder_t coder;
+    int has_dict;
+    uint8_t dict_id;
+} sparse_batch_reader_t;
+
+/**
+ * Encode n_vectors vectors of dimension values each, stored one after
+ * the other
+ *
+ * @param dict     Shared dictionary, or NULL for a table per vector
+ * @param threads  Threads to encode on, the caller's included (0 or 1:
+ *                 the caller only)
+ * @return         Batch (free with sparse_batch_free), or NULL on error
+ *                 or a payload past 4 GiB
+ */
+sparse_batch_t* sparse_batch_encode(const int8_t *vectors, size_t n_vectors, size_t dimension,
+                                    const sparse_dict_t *dict, sparse_phase2_coder_t coder,
+                                    int threads);
+
+/**
+ * Check the header and index size of a stream, without reading the payload
+ *
+ * @return  0, or -1 if it is no batch or is truncated
+ */
+int sparse_batch_open(sparse_batch_reader_t *reader, const uint8_t *data, size_t size);
+
+/**
+ * Decode vector i alone: one index entry, then its stream
+ *
+ * @param ctx     Scratch for the call, or NULL to allocate it
+ * @param dict    The batch's dictionary; NULL for none or a built-in one
+ * @param vector  Out: reader->dimension values
+ * @return        0, or -1 for a bad index or stream
+ */
+int sparse_batch_decode_one(const sparse_batch_reader_t *reader, size_t i,
+                            const sparse_dict_t *dict, sparse_codec_ctx_t *ctx,
+                            int8_t *vector);
+
+/**
+ * As sparse_batch_decode_one(), into sparse form (see sparse_vector.h);
+ * out->dimension must be the batch's, and lists of that many entries
+ * always suffice
+ */
+int sparse_batch_decode_one_sparse(const sparse_batch_reader_t *reader, size_t i,
+                                   const sparse_dict_t *dict, sparse_codec_ctx_t *ctx,
+                                   sparse_vector_t *out);
+
+/**
+ * Decode every vector, split across threads as for sparse_batch_encode()
+ *
+ * @param vectors  Out: n_vectors * dimension values
+ * @return         0, or -1 if any vector fails
+ */
+int sparse_batch_decode_all(const sparse_batch_reader_t *reader, const sparse_dict_t *dict,
+                            int threads, int8_t *vectors);
+
+/**
+ * As sparse_batch_decode_all(), into sparse form: vector i into
+ * out->vectors[i], which must have the batch's dimension (an array from
+ * sparse_vector_array_new() with capacity dimension always suffices)
+ *
+ * @return  0, or -1 if out has too few vectors or any vector fails
+ */
+int sparse_batch_decode_all_sparse(const sparse_batch_reader_t *reader,
+                                   const sparse_dict_t *dict, int threads,
+                                   sparse_vector_array_t *out);
+
+/**
+ * Free encoded batch
+ */
+void sparse_batch_free(sparse_batch_t *batch);
+
+#endif /* SPARSE_BATCH_H */
@@ -0,0 +1,84 @@
+/**
+ * sparse_codec_ctx.h
+ *
+ * Reusable encoder/decoder state for the sparse_* codecs
+ * - Scratch arrays for positions, values and value symbols
+ * - Decode tables (canonical Huffman, rANS, tANS), built in place
+ * - Allocated once, reused across calls and codecs
+ */
+
+#ifndef SPARSE_CODEC_CTX_H
+#define SPARSE_CODEC_CTX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "canonical_huffman.h"
+#include "rans_interleaved.h"
+#include "tans.h"
+
+// ============================================================================
+// CODEC CONTEXT
+// ============================================================================
+
+/**
+ * Everything a codec call would otherwise allocate or put on the stack
+ *
+ * The *_ctx entry points take a context and allocate nothing; the plain
+ * ones create a context per call. A context has no global state and may
+ * serve any codec, but only one call at a time: keep one per thread (a
+ * pool per worker), not one shared.
+ *
+ * Vectors up to capacity values long fit; longer ones get -1.
+ */
+typedef struct {
+    size_t capacity;        // dimension the scratch arrays hold
+    uint16_t *positions;    // capacity entries
+    int8_t *values;         // capacity entries: values, or escaped values
+    uint8_t *symbols;       // capacity entries: alphabet indices
+    chuff_table_t huffman;
+    rans_table_t rans;
+    tans_table_t tans;
+} sparse_codec_ctx_t;
+
+/**
+ * Context for vectors of up to max_dimension values
+ *
+ * @return  Context (free with sparse_codec_ctx_free), or NULL
+ */
+static inline sparse_codec_ctx_t* sparse_codec_ctx_create(size_t max_dimension) {
+    if (max_dimension == 0 || max_dimension > 65535) return NULL;
+
+    sparse_codec_ctx_t *ctx = malloc(sizeof(sparse_codec_ctx_t));
+    if (!ctx) return NULL;
+
+    /* One block: positions first, for their alignment */
+    uint8_t *scratch = malloc(max_dimension * (sizeof(uint16_t) + 2));
+    if (!scratch) {
+        free(ctx);
+        return NULL;
+    }
+    ctx->capacity = max_dimension;
+    ctx->positions = (uint16_t *)scratch;
+    ctx->values = (int8_t *)(scratch + max_dimension * sizeof(uint16_t));
+    ctx->symbols = scratch + max_dimension * (sizeof(uint16_t) + 1);
+    return ctx;
+}
+
+/**
+ * Context for a single call on a vector of dimension values, as the
+ * entry points without one use: capacity clamped to 1..65535, which
+ * holds every count a 16-bit field can carry
+ */
+static inline sparse_codec_ctx_t* sparse_codec_ctx_for(size_t dimension) {
+    return sparse_codec_ctx_create(dimension == 0 ? 1 : dimension > 65535 ? 65535 : dimension);
+}
+
+static inline void sparse_codec_ctx_free(sparse_codec_ctx_t *ctx) {
+    if (ctx) {
+        free(ctx->positions);
+        free(ctx);
+    }
+}
+
+#endif /* SPARSE_CODEC_CTX_H */
@@ -0,0 +1,153 @@
+/**
+ * sparse_dict.c
+ *
+ * Shared dictionaries: value frequency tables trained offline
+ * - Training: histogram of nonzero values, normalized to 256
+ * - Built-in tables, generated by train_sparse_dict
+ * - rANS/tANS tables built once per process
+ */
+
+#include "sparse_dict.h"
+#include "histogram.h"
+#include <pthread.h>
+#include <string.h>
+
+int sparse_dict_build(sparse_dict_t *dict, uint8_t id, const int8_t *values,
+                      const uint32_t *freqs, int n_values, uint32_t escape_freq) {
+    if (!dict || !values || !freqs || id > SPARSE_DICT_MAX_ID) return -1;
+    if (n_values < 0 || n_values > 255 || escape_freq == 0) return -1;
+
+    memset(dict, 0, sizeof(*dict));
+    dict->id = id;
+    dict->n_values = n_values;
+    memset(dict->index, n_values, sizeof(dict->index));
+
+    for (int i = 0; i < n_values; i++) {
+        uint8_t key = (uint8_t)(values[i] + 128);
+        if (values[i] == 0 || dict->index[key] != n_values) return -1;
+        dict->index[key] = (uint8_t)i;
+        dict->values[i] = values[i];
+        dict->freqs[i] = freqs[i];
+    }
+    dict->freqs[n_values] = escape_freq;
+
+    /* The builders check the frequencies are nonzero and sum to 256 */
+    if (rans_table_build(&dict->rans, dict->freqs, n_values + 1) < 0) return -1;
+    if (tans_table_build(&dict->tans, dict->freqs, n_values + 1) < 0) return -1;
+    return 0;
+}
+
+int sparse_dict_train(sparse_dict_t *dict, uint8_t id, const int8_t *vectors,
+                      size_t n_vectors, size_t dimension) {
+    if (!dict || !vectors) return -1;
+
+    /* Counted a chunk at a time, so the 32-bit bins cannot overflow */
+    uint64_t counts[256] = {0};
+    uint64_t total = 0;
+    const size_t chunk_len = (size_t)1 << 30;
+    const size_t length = n_vectors * dimension;
+    for (size_t at = 0; at < length; at += chunk_len) {
+        uint32_t chunk[256] = {0};
+        hist_add_int8(vectors + at, length - at < chunk_len ? length - at : chunk_len,
+                      chunk);
+        chunk[128] = 0;
+        for (int b = 0; b < 256; b++) {
+            counts[b] += chunk[b];
+            total += chunk[b];
+        }
+    }
+    if (total == 0) return -1;
+
+    /* Values earning a slot get a symbol; the escape takes the rest */
+    int8_t values[255];
+    uint64_t sym_counts[256];
+    uint64_t escape_count = 0;
+    int n_values = 0;
+    for (int v = -128; v <= 127; v++) {
+        uint64_t c = counts[(uint8_t)(v + 128)];
+        if (c * 256 >= total) {
+            values[n_values] = (int8_t)v;
+            sym_counts[n_values++] = c;
+        } else {
+            escape_count += c;
+        }
+    }
+    sym_counts[n_values] = escape_count;
+
+    /* Normalize to 256, every symbol at least 1: round down, then hand the
+     * missing slots to the largest remainders */
+    const int n_symbols = n_values + 1;
+    uint32_t freqs[256];
+    uint64_t remainder[256];
+    uint32_t sum = 0;
+    for (int i = 0; i < n_symbols; i++) {
+        uint64_t scaled = sym_counts[i] * 256 / total;
+        remainder[i] = sym_counts[i] * 256 % total;
+        freqs[i] = scaled == 0 ? 1 : (uint32_t)scaled;
+        if (scaled == 0) remainder[i] = 0;
+        sum += freqs[i];
+    }
+    while (sum < 256) {
+        int best = 0;
+        for (int i = 1; i < n_symbols; i++) {
+            if (remainder[i] > remainder[best]) best = i;
+        }
+        freqs[best]++;
+        remainder[best] = 0;
+        sum++;
+    }
+    /* Slots given to rare symbols come from the largest */
+    while (sum > 256) {
+        int max_idx = 0;
+        for (int i = 1; i < n_symbols; i++) {
+            if (freqs[i] > freqs[max_idx]) max_idx = i;
+        }
+        freqs[max_idx]--;
+        sum--;
+    }
+
+    return sparse_dict_build(dict, id, values, freqs, n_values, freqs[n_values]);
+}
+
+// ============================================================================
+// BUILT-IN DICTIONARIES
+// ============================================================================
+
+/*
+ * SPARSE_DICT_SIGNATURE: ./train_sparse_dict 1, over 10000 vectors of 97
+ * nonzeros from test_phase2's generator
+ */
+static const int8_t signature_values[] = {
+    -25, -24, -23, -22, -21, -20, -19, -18, -17, -16, -15, -14,
+    -13, -12, -11, -10,  -9,  -8,  -7,  -6,  -5,  -4,  -3,  -2,
+     -1,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,
+     12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,
+     24,  25,
+};
+static const uint32_t signature_freqs[] = {
+      1,   1,   1,   2,   2,   2,   3,   3,   3,   4,   4,   4,
+      5,   5,   6,   6,   7,   7,   7,   8,   8,   8,   8,   9,
+      9,   9,   9,   9,   8,   8,   8,   7,   7,   7,   6,   6,
+      5,   5,   4,   4,   4,   3,   3,   3,   2,   2,   2,   1,
+      1,   1,
+};
+#define SIGNATURE_ESCAPE_FREQ 9
+
+static sparse_dict_t builtin_signature;
+static int builtin_signature_ok;
+static pthread_once_t builtin_once = PTHREAD_ONCE_INIT;
+
+static void build_builtins(void) {
+    builtin_signature_ok = sparse_dict_build(
+        &builtin_signature, SPARSE_DICT_SIGNATURE, signature_values, signature_freqs,
+        (int)(sizeof(signature_values) / sizeof(signature_values[0])),
+        SIGNATURE_ESCAPE_FREQ) == 0;
+}
+
+const sparse_dict_t* sparse_dict_builtin(uint8_t id) {
+    pthread_once(&builtin_once, build_builtins);
+    if (id == SPARSE_DICT_SIGNATURE && builtin_signature_ok) {
+        return &builtin_signature;
+    }
+    return NULL;
+}
@@ -0,0 +1,64 @@
+/**
+ * sparse_dict.h
+ *
+ * Shared dictionaries: value frequency tables trained offline
+ * - Trained from sample vectors of one distribution
+ * - Identified by a 4-bit ID in the encoded header
+ * - Values outside the dictionary go through an escape symbol
+ * - rANS and tANS tables built once, not per vector
+ */
+
+#ifndef SPARSE_DICT_H
+#define SPARSE_DICT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "rans_interleaved.h"
+#include "tans.h"
+
+#define SPARSE_DICT_ID_BITS 4
+#define SPARSE_DICT_MAX_ID  ((1u << SPARSE_DICT_ID_BITS) - 1)
+
+/* Built-in dictionaries */
+#define SPARSE_DICT_SIGNATURE 1     /* s_mangled-like: Gaussian, sigma 12, in [-43, 42] */
+
+typedef struct {
+    uint8_t id;
+    int n_values;               /* symbols 0 .. n_values-1; n_values is the escape */
+    int8_t values[255];
+    uint32_t freqs[256];        /* per symbol, escape included, summing to 256 */
+    uint8_t index[256];         /* value + 128 -> symbol (escape if absent) */
+    rans_table_t rans;
+    tans_table_t tans;
+} sparse_dict_t;
+
+/**
+ * Build a dictionary from a stored table
+ *
+ * @param values       n_values distinct nonzero values
+ * @param freqs        their frequencies; with escape_freq they sum to 256
+ * @param escape_freq  frequency of the escape symbol, at least 1
+ * @return             0, or -1 for a bad ID or table
+ */
+int sparse_dict_build(sparse_dict_t *dict, uint8_t id, const int8_t *values,
+                      const uint32_t *freqs, int n_values, uint32_t escape_freq);
+
+/**
+ * Train a dictionary on n_vectors sample vectors of dimension values each
+ *
+ * A value gets its own symbol if it earns at least one of the 256 slots;
+ * the rest share the escape.
+ *
+ * @return  0, or -1 for a bad ID or samples with no nonzero value
+ */
+int sparse_dict_train(sparse_dict_t *dict, uint8_t id, const int8_t *vectors,
+                      size_t n_vectors, size_t dimension);
+
+/**
+ * Built-in dictionary by ID, its tables built on first use
+ *
+ * @return  the dictionary, or NULL for an unknown ID
+ */
+const sparse_dict_t* sparse_dict_builtin(uint8_t id);
+
+#endif /* SPARSE_DICT_H */
@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "sparse_vector.h"
 
 /* Configuration */
 #define MAX_DIMENSION 2048
@@ -26,14 +27,6 @@ typedef enum {
     SPARSE_FORMAT_PACKED,   /* Bit-packed indices and values */
 } sparse_format_t;
 
-/* Sparse vector representation (COO format) */
-typedef struct {
-    uint16_t dimension;      /* Vector dimension */
-    uint16_t count;          /* Number of non-zeros */
-    uint16_t *indices;       /* Non-zero indices */
-    int8_t *values;          /* Non-zero values */
-} sparse_vector_t;
-
 /* Encoded sparse vector */
 typedef struct {
     uint8_t *data;          /* Encoded bytes */
@@ -56,26 +49,6 @@ typedef struct {
 
 /* ========== Core API ========== */
 
-/**
- * Allocate a new sparse vector
- */
-sparse_vector_t* sparse_vector_new(uint16_t dimension, uint16_t max_nonzeros);
-
-/**
- * Free a sparse vector
- */
-void sparse_vector_free(sparse_vector_t *vec);
-
-/**
- * Create sparse vector from dense array
- */
-sparse_vector_t* sparse_from_dense(const int8_t *dense, uint16_t dimension);
-
-/**
- * Convert sparse vector to dense array
- */
-void sparse_to_dense(const sparse_vector_t *sparse, int8_t *dense);
-
 /**
  * Encode sparse vector using COO format
  * Format: [count:2] [index:2, value:1]*
@@ -108,11 +81,6 @@ void encoded_vector_free(encoded_vector_t *encoded);
 
 /* ========== Utility Functions ========== */
 
-/**
- * Calculate L2 norm of sparse vector
- */
-float sparse_l2_norm(const sparse_vector_t *vec);
-
 /**
  * Analyze sparsity characteristics
  */
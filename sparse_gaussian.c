@@ -0,0 +1,179 @@
+/**
+ * sparse_gaussian.c
+ *
+ * Sparse Gaussian vectors, sampled straight into the encoders
+ */
+
+#include "sparse_gaussian.h"
+#include "dntl_stats.h"
+#include "histogram.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Normals drawn for one value before the range is taken as unreachable */
+#define MAX_VALUE_DRAWS (1u << 20)
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/* xoshiro256** */
+static inline uint64_t next_u64(sparse_gaussian_rng_t *rng) {
+    uint64_t *s = rng->s;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return result;
+}
+
+/* Uniform in [0, n), from the high bits */
+static inline uint32_t next_below(sparse_gaussian_rng_t *rng, uint32_t n) {
+    return (uint32_t)(((next_u64(rng) >> 32) * n) >> 32);
+}
+
+void sparse_gaussian_seed(sparse_gaussian_rng_t *rng, const uint8_t seed[32]) {
+    memcpy(rng->s, seed, sizeof(rng->s));
+    if (rng->s[0] == 0 && rng->s[1] == 0 && rng->s[2] == 0 && rng->s[3] == 0) {
+        rng->s[0] = 0x123456789ABCDEF0ULL;
+    }
+}
+
+static int check_params(const sparse_gaussian_params_t *p) {
+    if (!p || p->dimension == 0 || p->dimension > 65535 || p->k > p->dimension) return -1;
+    if (!(p->sigma > 0.0) || p->min_value > p->max_value) return -1;
+    if (p->min_value == 0 && p->max_value == 0) return -1;
+    return 0;
+}
+
+/*
+ * k distinct positions as a bitmap: past half the dimension, the
+ * dimension - k left out are drawn instead
+ */
+static void draw_positions(sparse_gaussian_rng_t *rng, size_t dimension, uint16_t k,
+                           uint64_t *bitmap) {
+    const size_t words = (dimension + 63) / 64;
+    const int complement = k > dimension / 2;
+    const size_t draws = complement ? dimension - k : k;
+
+    memset(bitmap, complement ? 0xFF : 0, words * sizeof(uint64_t));
+    if (complement && dimension % 64) {
+        bitmap[words - 1] = ((uint64_t)1 << (dimension % 64)) - 1;
+    }
+    for (size_t placed = 0; placed < draws;) {
+        const uint32_t pos = next_below(rng, (uint32_t)dimension);
+        const uint64_t bit = (uint64_t)1 << (pos % 64);
+        if (((bitmap[pos / 64] & bit) != 0) == complement) {
+            bitmap[pos / 64] ^= bit;
+            placed++;
+        }
+    }
+}
+
+/* A nonzero value in [min, max]: Box-Muller pairs, the second kept in *spare */
+static int draw_value(const sparse_gaussian_params_t *p, sparse_gaussian_rng_t *rng,
+                      double *spare, int *has_spare, int8_t *out) {
+    for (uint32_t draw = 0; draw < MAX_VALUE_DRAWS; draw++) {
+        double z;
+        if (*has_spare) {
+            z = *spare;
+            *has_spare = 0;
+        } else {
+            double u1 = (next_u64(rng) >> 11) * 0x1.0p-53;
+            double u2 = (next_u64(rng) >> 11) * 0x1.0p-53;
+            if (u1 == 0.0) u1 = 0x1.0p-53;
+            const double mag = p->sigma * sqrt(-2.0 * log(u1));
+            z = mag * cos(2.0 * M_PI * u2);
+            *spare = mag * sin(2.0 * M_PI * u2);
+            *has_spare = 1;
+        }
+        const double v = round(z);
+        if (v != 0.0 && v >= p->min_value && v <= p->max_value) {
+            *out = (int8_t)v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int sparse_gaussian_sample_list(const sparse_gaussian_params_t *params,
+                                sparse_gaussian_rng_t *rng, uint16_t *positions,
+                                int8_t *values, uint32_t *hist) {
+    if (check_params(params) < 0 || !rng || (params->k > 0 && (!positions || !values))) {
+        return -1;
+    }
+
+    uint64_t bitmap[(65535 + 63) / 64];
+    const size_t words = (params->dimension + 63) / 64;
+    const uint32_t tries = params->max_tries ? params->max_tries : 1000;
+
+    for (uint32_t t = 0; t < tries; t++) {
+        draw_positions(rng, params->dimension, params->k, bitmap);
+
+        /* Each value from the generator to the lists and the norm, in
+         * ascending position order */
+        uint64_t norm_sq = 0;
+        double spare = 0.0;
+        int has_spare = 0;
+        size_t n = 0;
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = bitmap[w]; bits; bits &= bits - 1) {
+                int8_t v;
+                if (draw_value(params, rng, &spare, &has_spare, &v) < 0) return -1;
+                positions[n] = (uint16_t)(w * 64 + (size_t)__builtin_ctzll(bits));
+                values[n++] = v;
+                norm_sq += (uint64_t)((int32_t)v * v);
+            }
+        }
+
+        if (params->max_norm_sq == 0 || norm_sq <= params->max_norm_sq) {
+            if (hist) {
+                memset(hist, 0, 256 * sizeof(uint32_t));
+                hist_add_int8(values, n, hist);
+            }
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int sparse_gaussian_sample(const sparse_gaussian_params_t *params, sparse_gaussian_rng_t *rng,
+                           sparse_vector_t *out) {
+    if (!params || !out || (out->capacity && out->capacity < params->k)) return -1;
+    if (sparse_gaussian_sample_list(params, rng, out->indices, out->values, NULL) < 0) {
+        return -1;
+    }
+    out->dimension = (uint16_t)params->dimension;
+    out->count = params->k;
+    return 0;
+}
+
+int sparse_gaussian_encode_ctx(sparse_codec_ctx_t *ctx, const sparse_gaussian_params_t *params,
+                               sparse_gaussian_rng_t *rng, const sparse_dict_t *dict,
+                               sparse_phase2_coder_t coder,
+                               uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!ctx || check_params(params) < 0 || params->dimension > ctx->capacity) return -1;
+
+    uint32_t hist[256];
+    if (sparse_gaussian_sample_list(params, rng, ctx->positions, ctx->values,
+                                    dict ? NULL : hist) < 0) {
+        return -1;
+    }
+    if (dict) {
+        return sparse_phase2_encode_dict_list_ctx(ctx, ctx->positions, ctx->values, params->k,
+                                                  params->dimension, dict, coder,
+                                                  out, out_cap, written);
+    }
+    return sparse_phase2_encode_coder_list_ctx(ctx, ctx->positions, ctx->values, params->k,
+                                               hist, params->dimension, coder,
+                                               out, out_cap, written);
+}
@@ -0,0 +1,76 @@
+/**
+ * sparse_gaussian.h
+ *
+ * Sparse Gaussian vectors, sampled straight into the encoders
+ * - xoshiro256** seeded from 32 bytes, Box-Muller, as gaussian_sampler.c
+ * - k distinct positions, emitted ascending; values redrawn outside a range
+ * - Vectors past a squared-norm bound redrawn whole
+ * - Positions, values and the value histogram go to the sparse_phase2 list
+ *   encoders: no dense vector is written or scanned
+ */
+
+#ifndef SPARSE_GAUSSIAN_H
+#define SPARSE_GAUSSIAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sparse_codec_ctx.h"
+#include "sparse_dict.h"
+#include "sparse_phase2.h"
+#include "sparse_scan.h"
+#include "sparse_vector.h"
+
+typedef struct {
+    size_t dimension;       /* 1..65535 */
+    uint16_t k;             /* Nonzeros, at most dimension */
+    double sigma;           /* Standard deviation, mean 0 */
+    int8_t min_value;       /* Values rounded outside [min, max] are redrawn, */
+    int8_t max_value;       /* as are zeros; the range needs a nonzero */
+    uint64_t max_norm_sq;   /* Vectors with a larger squared norm are redrawn;
+                               0 for no bound */
+    uint32_t max_tries;     /* Vectors drawn before giving up; 0 for 1000 */
+} sparse_gaussian_params_t;
+
+typedef struct {
+    uint64_t s[4];
+} sparse_gaussian_rng_t;
+
+/**
+ * Seed the generator; an all-zero seed is replaced as gaussian_sample() does
+ */
+void sparse_gaussian_seed(sparse_gaussian_rng_t *rng, const uint8_t seed[32]);
+
+/**
+ * Draw one vector into lists: k ascending positions, their values, and the
+ * values' histogram by SPARSE_SCAN_BIN (256 bins; NULL to skip it)
+ *
+ * @return  0, or -1 on bad parameters or if no vector passed the norm bound
+ *          in max_tries draws
+ */
+int sparse_gaussian_sample_list(const sparse_gaussian_params_t *params,
+                                sparse_gaussian_rng_t *rng, uint16_t *positions,
+                                int8_t *values, uint32_t *hist);
+
+/**
+ * As sparse_gaussian_sample_list(), into sparse form: out->dimension is
+ * set, and out must hold k entries
+ */
+int sparse_gaussian_sample(const sparse_gaussian_params_t *params, sparse_gaussian_rng_t *rng,
+                           sparse_vector_t *out);
+
+/**
+ * Draw one vector and encode it with sparse_phase2, in ctx's scratch
+ *
+ * The stream is the one sparse_phase2_encode_coder_ctx() (dict NULL) or
+ * sparse_phase2_encode_dict_ctx() gives the vector sparse_gaussian_sample()
+ * draws from the same generator state; ctx must hold params->dimension.
+ *
+ * @return  0, or -1 on bad parameters, a failed draw, or if the encoding
+ *          does not fit
+ */
+int sparse_gaussian_encode_ctx(sparse_codec_ctx_t *ctx, const sparse_gaussian_params_t *params,
+                               sparse_gaussian_rng_t *rng, const sparse_dict_t *dict,
+                               sparse_phase2_coder_t coder,
+                               uint8_t *out, size_t out_cap, size_t *written);
+
+#endif /* SPARSE_GAUSSIAN_H */
@@ -0,0 +1,701 @@
+/**
+ * sparse_native: CPython bindings for the sparse_* codecs
+ *
+ * Vectors go in as any C-contiguous buffer of one-byte items (numpy int8
+ * arrays, bytes, bytearray, array('b')) and are read in place; streams come
+ * out as bytes, or into a caller's writable buffer:
+ *
+ *   import sparse_native
+ *   data = sparse_native.encode("phase2_tans", vec)
+ *   n = sparse_native.encode_into("phase2_tans", vec, buf)      # bytes used
+ *   out = sparse_native.decode("phase2_tans", data, 2048)       # bytearray
+ *   sparse_native.decode_into("phase2_tans", data, out)         # in place
+ *
+ *   np.frombuffer(out, dtype=np.int8) views a decoded vector without a copy.
+ *
+ * Codecs: rice, adaptive, delta, phase3, optimal_large, phase2_rans,
+ * phase2_tans, dict_rans, dict_tans and auto. A stream carries its count but
+ * not its dimension, which decode takes. The dictionary formats use a
+ * built-in dictionary, the signature one unless another ID is given.
+ *
+ * encode_many / decode_many run one codec over n vectors stored one after
+ * the other (a C-contiguous (n, dimension) array), and batch_encode /
+ * batch_decode build and read sparse_batch streams on the shared scheduler
+ * (dntl_sched.h), sized with set_workers(count, pin=False) and inspected
+ * with workers(). Every call releases the GIL while the codecs run, so
+ * Python threads scale.
+ *
+ * stats() and stats_reset() expose the codecs' encode/decode stage timers
+ * when built with `make -f Makefile.dntl STATS=1` (see dntl_stats.h).
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "dntl_sched_py.h"
+#include "dntl_stats_py.h"
+#include "sparse_adaptive.h"
+#include "sparse_auto.h"
+#include "sparse_batch.h"
+#include "sparse_delta.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include "sparse_scan.h"
+
+// ============================================================================
+// CODECS
+// ============================================================================
+
+// Stream as the codec structs hold it (they share this layout)
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    uint16_t count;
+} stream_t;
+
+typedef struct {
+    const char *name;
+    int (*encode)(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                  const sparse_dict_t *dict, uint8_t *out, size_t out_cap, size_t *written);
+    int (*decode)(sparse_codec_ctx_t *ctx, const stream_t *encoded, int8_t *vector,
+                  size_t dimension, const sparse_dict_t *dict);
+    size_t (*max_size)(size_t dimension, size_t k);
+    size_t count_at;    // offset of the stream's 16-bit count
+} codec_t;
+
+#define CODEC_CTX(name, type)                                                                \
+    static int encode_##name(sparse_codec_ctx_t *ctx, const int8_t *vector,                 \
+                             size_t dimension, const sparse_dict_t *dict, uint8_t *out,     \
+                             size_t out_cap, size_t *written) {                             \
+        (void)dict;                                                                          \
+        return sparse_##name##_encode_ctx(ctx, vector, dimension, out, out_cap, written);   \
+    }                                                                                        \
+    static int decode_##name(sparse_codec_ctx_t *ctx, const stream_t *encoded,             \
+                             int8_t *vector, size_t dimension, const sparse_dict_t *dict) { \
+        (void)dict;                                                                          \
+        const type e = { encoded->data, encoded->size, encoded->count };                    \
+        return sparse_##name##_decode_ctx(ctx, &e, vector, dimension);                      \
+    }
+
+CODEC_CTX(rice, sparse_rice_t)
+CODEC_CTX(adaptive, sparse_adaptive_t)
+CODEC_CTX(delta, sparse_delta_t)
+CODEC_CTX(phase3, sparse_phase3_t)
+CODEC_CTX(optimal_large, sparse_optimal_large_t)
+
+#define CODEC_PHASE2(name, coder, with_dict)                                                 \
+    static int encode_##name(sparse_codec_ctx_t *ctx, const int8_t *vector,                 \
+                             size_t dimension, const sparse_dict_t *dict, uint8_t *out,     \
+                             size_t out_cap, size_t *written) {                             \
+        return with_dict ? sparse_phase2_encode_dict_ctx(ctx, vector, dimension, dict,      \
+                                                         coder, out, out_cap, written)      \
+                         : sparse_phase2_encode_coder_ctx(ctx, vector, dimension, coder,    \
+                                                          out, out_cap, written);           \
+    }                                                                                        \
+    static int decode_##name(sparse_codec_ctx_t *ctx, const stream_t *encoded,             \
+                             int8_t *vector, size_t dimension, const sparse_dict_t *dict) { \
+        const sparse_phase2_t e = { encoded->data, encoded->size, encoded->count };         \
+        return with_dict ? sparse_phase2_decode_dict_ctx(ctx, &e, vector, dimension, dict,  \
+                                                         coder)                             \
+                         : sparse_phase2_decode_coder_ctx(ctx, &e, vector, dimension,       \
+                                                          coder);                           \
+    }
+
+CODEC_PHASE2(phase2_rans, SPARSE_PHASE2_RANS, 0)
+CODEC_PHASE2(phase2_tans, SPARSE_PHASE2_TANS, 0)
+CODEC_PHASE2(dict_rans, SPARSE_PHASE2_RANS, 1)
+CODEC_PHASE2(dict_tans, SPARSE_PHASE2_TANS, 1)
+
+// sparse_auto has no context forms: it allocates its own scratch
+static int encode_auto(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                       const sparse_dict_t *dict, uint8_t *out, size_t out_cap,
+                       size_t *written) {
+    (void)ctx;
+    return sparse_auto_encode_into(vector, dimension, dict, out, out_cap, written);
+}
+
+static int decode_auto(sparse_codec_ctx_t *ctx, const stream_t *encoded, int8_t *vector,
+                       size_t dimension, const sparse_dict_t *dict) {
+    (void)ctx;
+    const sparse_auto_t e = { encoded->data, encoded->size, encoded->count };
+    return sparse_auto_decode(&e, vector, dimension, dict);
+}
+
+static const codec_t codecs[] = {
+    { "rice", encode_rice, decode_rice, sparse_rice_max_encoded_size, 0 },
+    { "adaptive", encode_adaptive, decode_adaptive, sparse_adaptive_max_encoded_size, 0 },
+    { "delta", encode_delta, decode_delta, sparse_delta_max_encoded_size, 0 },
+    { "phase3", encode_phase3, decode_phase3, sparse_phase3_max_encoded_size, 0 },
+    { "optimal_large", encode_optimal_large, decode_optimal_large,
+      sparse_optimal_large_max_encoded_size, 0 },
+    { "phase2_rans", encode_phase2_rans, decode_phase2_rans, sparse_phase2_max_encoded_size, 0 },
+    { "phase2_tans", encode_phase2_tans, decode_phase2_tans, sparse_phase2_max_encoded_size, 0 },
+    { "dict_rans", encode_dict_rans, decode_dict_rans, sparse_phase2_max_encoded_size, 0 },
+    { "dict_tans", encode_dict_tans, decode_dict_tans, sparse_phase2_max_encoded_size, 0 },
+    { "auto", encode_auto, decode_auto, sparse_auto_max_encoded_size, 1 },
+};
+
+static const codec_t *get_codec(const char *name) {
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++) {
+        if (strcmp(codecs[i].name, name) == 0) {
+            return &codecs[i];
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "unknown codec '%s'", name);
+    return NULL;
+}
+
+static const sparse_dict_t *get_dict(int dict_id) {
+    const sparse_dict_t *dict = sparse_dict_builtin((uint8_t)dict_id);
+    if (dict_id < 0 || dict_id > (int)SPARSE_DICT_MAX_ID || !dict) {
+        PyErr_Format(PyExc_ValueError, "no built-in dictionary %d", dict_id);
+        return NULL;
+    }
+    return dict;
+}
+
+// Stream view over data, its count read from the stream's header
+static int open_stream(const codec_t *codec, const Py_buffer *data, stream_t *s) {
+    if ((size_t)data->len < codec->count_at + 2) {
+        PyErr_SetString(PyExc_ValueError, "stream too short");
+        return -1;
+    }
+    const uint8_t *p = (const uint8_t *)data->buf + codec->count_at;
+    s->data = (uint8_t *)data->buf;
+    s->size = (size_t)data->len;
+    s->count = (uint16_t)(p[0] << 8 | p[1]);
+    return 0;
+}
+
+// ============================================================================
+// BUFFERS
+// ============================================================================
+
+// View of a C-contiguous buffer of one-byte items, read in place
+static int get_bytes(PyObject *obj, Py_buffer *view, int writable, const char *name) {
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+    if (PyObject_GetBuffer(obj, view, flags) < 0) {
+        return -1;
+    }
+    if (view->itemsize != 1) {
+        PyErr_Format(PyExc_TypeError, "%s must hold one-byte items (int8)", name);
+        PyBuffer_Release(view);
+        return -1;
+    }
+    return 0;
+}
+
+static int check_dimension(Py_ssize_t dimension) {
+    if (dimension < 1 || dimension > 65535) {
+        PyErr_Format(PyExc_ValueError, "dimension %zd out of range (1..65535)", dimension);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *codec_error(const char *what) {
+    PyErr_Format(PyExc_ValueError, "%s failed", what);
+    return NULL;
+}
+
+// Threads for batch calls: 0 takes every scheduler worker and the caller
+static int get_threads(int threads) {
+    if (threads > 0) {
+        return threads;
+    }
+    dntl_sched_stats_t st = { 0 };
+    dntl_sched_t *s = dntl_sched_default();
+    if (s) {
+        dntl_sched_stats(s, &st);
+    }
+    return (int)st.workers + 1;
+}
+
+// ============================================================================
+// SINGLE VECTORS
+// ============================================================================
+
+// Encode into out, allocating any scratch the codec needs
+static int encode_one(const codec_t *codec, const int8_t *vector, size_t dimension,
+                      const sparse_dict_t *dict, uint8_t *out, size_t out_cap,
+                      size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    int rc = ctx ? codec->encode(ctx, vector, dimension, dict, out, out_cap, written) : -1;
+    sparse_codec_ctx_free(ctx);
+    return rc;
+}
+
+static int decode_one(const codec_t *codec, const stream_t *s, int8_t *vector,
+                      size_t dimension, const sparse_dict_t *dict) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    int rc = ctx ? codec->decode(ctx, s, vector, dimension, dict) : -1;
+    sparse_codec_ctx_free(ctx);
+    return rc;
+}
+
+static PyObject *py_encode(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *vec_obj;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    if (!PyArg_ParseTuple(args, "sO|i", &name, &vec_obj, &dict_id)) {
+        return NULL;
+    }
+    const codec_t *codec = get_codec(name);
+    const sparse_dict_t *dict = codec ? get_dict(dict_id) : NULL;
+    Py_buffer vec;
+    if (!dict || get_bytes(vec_obj, &vec, 0, "vector") < 0) {
+        return NULL;
+    }
+    if (check_dimension(vec.len) < 0) {
+        PyBuffer_Release(&vec);
+        return NULL;
+    }
+
+    const size_t dimension = (size_t)vec.len;
+    const size_t cap = codec->max_size(dimension, sparse_scan_count(vec.buf, dimension));
+    uint8_t *out = malloc(cap + 1);
+    size_t written = 0;
+    int rc = -1;
+    if (out) {
+        Py_BEGIN_ALLOW_THREADS
+        rc = encode_one(codec, vec.buf, dimension, dict, out, cap, &written);
+        Py_END_ALLOW_THREADS
+    }
+    PyBuffer_Release(&vec);
+
+    PyObject *result = !out ? PyErr_NoMemory()
+                     : rc < 0 ? codec_error("encode")
+                     : PyBytes_FromStringAndSize((const char *)out, (Py_ssize_t)written);
+    free(out);
+    return result;
+}
+
+static PyObject *py_encode_into(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *vec_obj, *out_obj;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    if (!PyArg_ParseTuple(args, "sOO|i", &name, &vec_obj, &out_obj, &dict_id)) {
+        return NULL;
+    }
+    const codec_t *codec = get_codec(name);
+    const sparse_dict_t *dict = codec ? get_dict(dict_id) : NULL;
+    Py_buffer vec, out;
+    if (!dict || get_bytes(vec_obj, &vec, 0, "vector") < 0) {
+        return NULL;
+    }
+    if (check_dimension(vec.len) < 0 || get_bytes(out_obj, &out, 1, "out") < 0) {
+        PyBuffer_Release(&vec);
+        return NULL;
+    }
+
+    size_t written = 0;
+    int rc;
+    Py_BEGIN_ALLOW_THREADS
+    rc = encode_one(codec, vec.buf, (size_t)vec.len, dict, out.buf, (size_t)out.len, &written);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&vec);
+    PyBuffer_Release(&out);
+
+    if (rc < 0) {
+        return codec_error("encode (or out too small)");
+    }
+    return PyLong_FromSize_t(written);
+}
+
+static PyObject *py_max_encoded_size(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    Py_ssize_t dimension, k;
+    if (!PyArg_ParseTuple(args, "snn", &name, &dimension, &k)) {
+        return NULL;
+    }
+    const codec_t *codec = get_codec(name);
+    if (!codec || check_dimension(dimension) < 0) {
+        return NULL;
+    }
+    size_t bytes = k < 0 ? 0 : codec->max_size((size_t)dimension, (size_t)k);
+    if (bytes == 0) {
+        PyErr_SetString(PyExc_ValueError, "count out of range for the dimension");
+        return NULL;
+    }
+    return PyLong_FromSize_t(bytes);
+}
+
+// Decode into vector, dimension values, with the GIL released
+static int decode_stream(const char *name, PyObject *data_obj, int dict_id, int8_t *vector,
+                         size_t dimension) {
+    const codec_t *codec = get_codec(name);
+    const sparse_dict_t *dict = codec ? get_dict(dict_id) : NULL;
+    Py_buffer data;
+    stream_t s;
+    if (!dict || get_bytes(data_obj, &data, 0, "data") < 0) {
+        return -1;
+    }
+    int rc = open_stream(codec, &data, &s);
+    if (rc == 0) {
+        Py_BEGIN_ALLOW_THREADS
+        rc = decode_one(codec, &s, vector, dimension, dict);
+        Py_END_ALLOW_THREADS
+        if (rc < 0) {
+            codec_error("decode");
+        }
+    }
+    PyBuffer_Release(&data);
+    return rc;
+}
+
+static PyObject *py_decode(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *data_obj;
+    Py_ssize_t dimension;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    if (!PyArg_ParseTuple(args, "sOn|i", &name, &data_obj, &dimension, &dict_id)) {
+        return NULL;
+    }
+    if (check_dimension(dimension) < 0) {
+        return NULL;
+    }
+    PyObject *result = PyByteArray_FromStringAndSize(NULL, dimension);
+    if (result && decode_stream(name, data_obj, dict_id, (int8_t *)PyByteArray_AS_STRING(result),
+                                (size_t)dimension) < 0) {
+        Py_CLEAR(result);
+    }
+    return result;
+}
+
+static PyObject *py_decode_into(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *data_obj, *out_obj;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    Py_buffer out;
+    if (!PyArg_ParseTuple(args, "sOO|i", &name, &data_obj, &out_obj, &dict_id) ||
+        get_bytes(out_obj, &out, 1, "out") < 0) {
+        return NULL;
+    }
+    int rc = check_dimension(out.len);
+    if (rc == 0) {
+        rc = decode_stream(name, data_obj, dict_id, out.buf, (size_t)out.len);
+    }
+    PyBuffer_Release(&out);
+    if (rc < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+// ============================================================================
+// MANY VECTORS
+// ============================================================================
+
+static PyObject *py_encode_many(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *vec_obj;
+    Py_ssize_t dimension;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    if (!PyArg_ParseTuple(args, "sOn|i", &name, &vec_obj, &dimension, &dict_id)) {
+        return NULL;
+    }
+    const codec_t *codec = get_codec(name);
+    const sparse_dict_t *dict = codec ? get_dict(dict_id) : NULL;
+    Py_buffer vec;
+    if (!dict || check_dimension(dimension) < 0 || get_bytes(vec_obj, &vec, 0, "vectors") < 0) {
+        return NULL;
+    }
+    if (vec.len % dimension != 0) {
+        PyErr_SetString(PyExc_ValueError, "vectors must hold a whole number of vectors");
+        PyBuffer_Release(&vec);
+        return NULL;
+    }
+
+    // All streams into one buffer, each at the worst-case offset of its count
+    const size_t n = (size_t)(vec.len / dimension);
+    size_t *offsets = malloc((n + 1) * sizeof(size_t));
+    size_t *sizes = malloc((n + 1) * sizeof(size_t));
+    uint8_t *out = NULL;
+    int rc = -1;
+    if (offsets && sizes) {
+        Py_BEGIN_ALLOW_THREADS
+        const int8_t *vectors = vec.buf;
+        offsets[0] = 0;
+        rc = 0;
+        for (size_t i = 0; rc == 0 && i < n; i++) {
+            const size_t cap = codec->max_size((size_t)dimension,
+                                               sparse_scan_count(vectors + i * dimension,
+                                                                 (size_t)dimension));
+            offsets[i + 1] = offsets[i] + cap;
+            rc = cap ? 0 : -1;
+        }
+        sparse_codec_ctx_t *ctx = rc == 0 ? sparse_codec_ctx_for((size_t)dimension) : NULL;
+        out = ctx ? malloc(offsets[n] + 1) : NULL;
+        rc = out ? 0 : -1;
+        for (size_t i = 0; rc == 0 && i < n; i++) {
+            rc = codec->encode(ctx, vectors + i * dimension, (size_t)dimension, dict,
+                               out + offsets[i], offsets[i + 1] - offsets[i], &sizes[i]);
+        }
+        sparse_codec_ctx_free(ctx);
+        Py_END_ALLOW_THREADS
+    }
+    PyBuffer_Release(&vec);
+
+    PyObject *list = !offsets || !sizes ? PyErr_NoMemory()
+                   : rc < 0 ? codec_error("encode")
+                   : PyList_New((Py_ssize_t)n);
+    for (size_t i = 0; list && i < n; i++) {
+        PyObject *item = PyBytes_FromStringAndSize((const char *)out + offsets[i],
+                                                   (Py_ssize_t)sizes[i]);
+        if (!item) {
+            Py_CLEAR(list);
+            break;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, item);
+    }
+    free(out);
+    free(offsets);
+    free(sizes);
+    return list;
+}
+
+static PyObject *py_decode_many(PyObject *self, PyObject *args) {
+    (void)self;
+    const char *name;
+    PyObject *streams_obj;
+    Py_ssize_t dimension;
+    int dict_id = SPARSE_DICT_SIGNATURE;
+    if (!PyArg_ParseTuple(args, "sOn|i", &name, &streams_obj, &dimension, &dict_id)) {
+        return NULL;
+    }
+    const codec_t *codec = get_codec(name);
+    const sparse_dict_t *dict = codec ? get_dict(dict_id) : NULL;
+    if (!dict || check_dimension(dimension) < 0) {
+        return NULL;
+    }
+    PyObject *seq = PySequence_Fast(streams_obj, "expected a sequence of streams");
+    if (!seq) {
+        return NULL;
+    }
+
+    // Views of every stream first: the codecs then run without the GIL
+    const size_t n = (size_t)PySequence_Fast_GET_SIZE(seq);
+    Py_buffer *views = PyMem_Calloc(n + 1, sizeof(Py_buffer));
+    stream_t *streams = PyMem_Calloc(n + 1, sizeof(stream_t));
+    PyObject *result = PyByteArray_FromStringAndSize(NULL, (Py_ssize_t)(n * dimension));
+    size_t held = 0;
+    int rc = views && streams && result ? 0 : -1;
+    if (rc < 0 && !PyErr_Occurred()) {
+        PyErr_NoMemory();
+    }
+    for (; rc == 0 && held < n; held++) {
+        if (get_bytes(PySequence_Fast_GET_ITEM(seq, held), &views[held], 0, "stream") < 0) {
+            rc = -1;
+            break;
+        }
+        rc = open_stream(codec, &views[held], &streams[held]);
+    }
+
+    if (rc == 0) {
+        int8_t *vectors = (int8_t *)PyByteArray_AS_STRING(result);
+        Py_BEGIN_ALLOW_THREADS
+        sparse_codec_ctx_t *ctx = sparse_codec_ctx_for((size_t)dimension);
+        rc = ctx ? 0 : -1;
+        for (size_t i = 0; rc == 0 && i < n; i++) {
+            rc = codec->decode(ctx, &streams[i], vectors + i * dimension, (size_t)dimension,
+                               dict);
+        }
+        sparse_codec_ctx_free(ctx);
+        Py_END_ALLOW_THREADS
+        if (rc < 0) {
+            codec_error("decode");
+        }
+    }
+    for (size_t i = 0; i < held; i++) {
+        PyBuffer_Release(&views[i]);
+    }
+    PyMem_Free(views);
+    PyMem_Free(streams);
+    Py_DECREF(seq);
+    if (rc < 0) {
+        Py_XDECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+// ============================================================================
+// BATCH STREAMS
+// ============================================================================
+
+static PyObject *py_batch_encode(PyObject *self, PyObject *args) {
+    (void)self;
+    PyObject *vec_obj;
+    Py_ssize_t dimension;
+    const char *coder_name = "tans";
+    int dict_id = SPARSE_DICT_SIGNATURE, threads = 0;
+    if (!PyArg_ParseTuple(args, "On|sii", &vec_obj, &dimension, &coder_name, &dict_id,
+                          &threads)) {
+        return NULL;
+    }
+    sparse_phase2_coder_t coder;
+    if (strcmp(coder_name, "rans") == 0) {
+        coder = SPARSE_PHASE2_RANS;
+    } else if (strcmp(coder_name, "tans") == 0) {
+        coder = SPARSE_PHASE2_TANS;
+    } else {
+        PyErr_Format(PyExc_ValueError, "unknown coder '%s' (expected rans or tans)", coder_name);
+        return NULL;
+    }
+    // Dictionary 0: a table per vector
+    const sparse_dict_t *dict = dict_id == 0 ? NULL : get_dict(dict_id);
+    Py_buffer vec;
+    if ((dict_id != 0 && !dict) || check_dimension(dimension) < 0 ||
+        get_bytes(vec_obj, &vec, 0, "vectors") < 0) {
+        return NULL;
+    }
+    if (vec.len % dimension != 0) {
+        PyErr_SetString(PyExc_ValueError, "vectors must hold a whole number of vectors");
+        PyBuffer_Release(&vec);
+        return NULL;
+    }
+
+    sparse_batch_t *batch;
+    threads = get_threads(threads);
+    Py_BEGIN_ALLOW_THREADS
+    batch = sparse_batch_encode(vec.buf, (size_t)(vec.len / dimension), (size_t)dimension,
+                                dict, coder, threads);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&vec);
+
+    if (!batch) {
+        return codec_error("batch encode");
+    }
+    PyObject *result = PyBytes_FromStringAndSize((const char *)batch->data,
+                                                 (Py_ssize_t)batch->size);
+    sparse_batch_free(batch);
+    return result;
+}
+
+static int open_batch(const Py_buffer *data, sparse_batch_reader_t *reader) {
+    if (sparse_batch_open(reader, data->buf, (size_t)data->len) < 0) {
+        PyErr_SetString(PyExc_ValueError, "not a batch stream, or truncated");
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject *py_batch_info(PyObject *self, PyObject *args) {
+    (void)self;
+    Py_buffer data;
+    sparse_batch_reader_t reader;
+    if (!PyArg_ParseTuple(args, "y*", &data)) {
+        return NULL;
+    }
+    int rc = open_batch(&data, &reader);
+    PyBuffer_Release(&data);
+    if (rc < 0) {
+        return NULL;
+    }
+    return Py_BuildValue("{s:I,s:I,s:s,s:i}", "n_vectors", (unsigned)reader.n_vectors,
+                         "dimension", (unsigned)reader.dimension,
+                         "coder", reader.coder == SPARSE_PHASE2_TANS ? "tans" : "rans",
+                         "dict_id", reader.has_dict ? (int)reader.dict_id : 0);
+}
+
+static PyObject *py_batch_decode(PyObject *self, PyObject *args) {
+    (void)self;
+    Py_buffer data, out;
+    PyObject *out_obj = Py_None;
+    int threads = 0;
+    sparse_batch_reader_t reader;
+    if (!PyArg_ParseTuple(args, "y*|Oi", &data, &out_obj, &threads)) {
+        return NULL;
+    }
+    if (open_batch(&data, &reader) < 0) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    const size_t bytes = (size_t)reader.n_vectors * reader.dimension;
+    PyObject *result = NULL;
+    if (out_obj != Py_None) {
+        if (get_bytes(out_obj, &out, 1, "out") < 0) {
+            PyBuffer_Release(&data);
+            return NULL;
+        }
+        if ((size_t)out.len != bytes) {
+            PyErr_Format(PyExc_ValueError, "out must be %zu bytes", bytes);
+            PyBuffer_Release(&out);
+            PyBuffer_Release(&data);
+            return NULL;
+        }
+    } else if (!(result = PyByteArray_FromStringAndSize(NULL, (Py_ssize_t)bytes))) {
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    int8_t *vectors = result ? (int8_t *)PyByteArray_AS_STRING(result) : out.buf;
+    int rc;
+    threads = get_threads(threads);
+    Py_BEGIN_ALLOW_THREADS
+    // Built-in dictionaries come from the stream's header
+    rc = sparse_batch_decode_all(&reader, NULL, threads, vectors);
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&data);
+    if (!result) {
+        PyBuffer_Release(&out);
+    }
+
+    if (rc < 0) {
+        Py_XDECREF(result);
+        return codec_error("batch decode");
+    }
+    if (!result) {
+        Py_RETURN_NONE;
+    }
+    return result;
+}
+
+static PyMethodDef sparse_native_methods[] = {
+    { "encode", py_encode, METH_VARARGS,
+      "encode(codec, vector[, dict_id]) -> bytes" },
+    { "encode_into", py_encode_into, METH_VARARGS,
+      "encode_into(codec, vector, out[, dict_id]) -> bytes written to out" },
+    { "max_encoded_size", py_max_encoded_size, METH_VARARGS,
+      "max_encoded_size(codec, dimension, k) -> bytes encode_into always fits in" },
+    { "decode", py_decode, METH_VARARGS,
+      "decode(codec, data, dimension[, dict_id]) -> bytearray of int8 values" },
+    { "decode_into", py_decode_into, METH_VARARGS,
+      "decode_into(codec, data, out[, dict_id]): decode len(out) values into out" },
+    { "encode_many", py_encode_many, METH_VARARGS,
+      "encode_many(codec, vectors, dimension[, dict_id]) -> list of bytes" },
+    { "decode_many", py_decode_many, METH_VARARGS,
+      "decode_many(codec, streams, dimension[, dict_id]) -> bytearray of n * dimension" },
+    { "batch_encode", py_batch_encode, METH_VARARGS,
+      "batch_encode(vectors, dimension[, 'rans' | 'tans'[, dict_id (0: none)[, threads]]])"
+      " -> bytes" },
+    { "batch_info", py_batch_info, METH_VARARGS,
+      "batch_info(data) -> dict with n_vectors, dimension, coder, dict_id" },
+    { "batch_decode", py_batch_decode, METH_VARARGS,
+      "batch_decode(data[, out[, threads]]) -> bytearray of n_vectors * dimension, "
+      "or None into out" },
+    DNTL_SCHED_PY_METHODS
+    DNTL_STATS_PY_METHODS
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef sparse_native_module = {
+    PyModuleDef_HEAD_INIT,
+    "sparse_native",
+    "Native sparse vector codecs",
+    -1,
+    sparse_native_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_sparse_native(void) {
+    return PyModule_Create(&sparse_native_module);
+}
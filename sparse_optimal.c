@@ -17,66 +17,12 @@
  */
 
 #include "sparse_optimal.h"
+#include "bitstream.h"
+#include "dntl_stats.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
-/* Bit writer helper */
-typedef struct {
-    uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;  /* 0-7, next bit to write */
-} bit_writer_t;
-
-static void bit_writer_init(bit_writer_t *bw, uint8_t *buffer) {
-    bw->buffer = buffer;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-}
-
-static void bit_writer_write(bit_writer_t *bw, uint32_t value, uint8_t num_bits) {
-    for (int i = num_bits - 1; i >= 0; i--) {
-        uint8_t bit = (value >> i) & 1;
-        bw->buffer[bw->byte_pos] |= (bit << (7 - bw->bit_pos));
-        bw->bit_pos++;
-        if (bw->bit_pos == 8) {
-            bw->bit_pos = 0;
-            bw->byte_pos++;
-        }
-    }
-}
-
-static size_t bit_writer_finish(bit_writer_t *bw) {
-    return bw->byte_pos + (bw->bit_pos > 0 ? 1 : 0);
-}
-
-/* Bit reader helper */
-typedef struct {
-    const uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;  /* 0-7, next bit to read */
-} bit_reader_t;
-
-static void bit_reader_init(bit_reader_t *br, const uint8_t *buffer) {
-    br->buffer = buffer;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-}
-
-static uint32_t bit_reader_read(bit_reader_t *br, uint8_t num_bits) {
-    uint32_t value = 0;
-    for (uint8_t i = 0; i < num_bits; i++) {
-        uint8_t bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-        value = (value << 1) | bit;
-        br->bit_pos++;
-        if (br->bit_pos == 8) {
-            br->bit_pos = 0;
-            br->byte_pos++;
-        }
-    }
-    return value;
-}
-
 /* Encode value {-2,-1,+1,+2} to 2-bit code */
 static uint8_t encode_value(int8_t val) {
     switch (val) {
@@ -94,12 +40,50 @@ static int8_t decode_value(uint8_t code) {
     return values[code & 3];
 }
 
+size_t sparse_max_encoded_size(size_t dimension, size_t k) {
+    if (dimension == 0 || dimension > 2048 || k > dimension) {
+        return 0;
+    }
+    return (16 + k * 13 + 7) / 8;
+}
+
+int sparse_encode_into(const int8_t *vector, size_t dimension,
+                       uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!vector || !out || !written || dimension == 0 || dimension > 2048) {
+        return -1;
+    }
+
+    uint16_t count = 0;
+    for (size_t i = 0; i < dimension; i++) {
+        if (vector[i] != 0) count++;
+    }
+
+    /* Write header and entries */
+    bit_writer_t bw;
+    bw_init(&bw, out, out_cap);
+
+    /* Write count */
+    if (bw_write_bits(&bw, count, 16) < 0) return -1;
+
+    /* Write (position, value) pairs: 11-bit position, then 2-bit value */
+    for (size_t i = 0; i < dimension; i++) {
+        if (vector[i] != 0 &&
+            bw_write_bits(&bw, ((uint32_t)i << 2) | encode_value(vector[i]), 13) < 0) {
+            return -1;
+        }
+    }
+
+    *written = bw_finish(&bw);
+    return 0;
+}
+
 sparse_encoded_t* sparse_encode(const int8_t *vector, size_t dimension) {
     if (!vector || dimension == 0 || dimension > 2048) {
         return NULL;
     }
 
-    /* Count non-zeros and allocate temp storage */
+    /* Count non-zeros */
     uint16_t count = 0;
     for (size_t i = 0; i < dimension; i++) {
         if (vector[i] != 0) count++;
@@ -109,35 +93,20 @@ sparse_encoded_t* sparse_encode(const int8_t *vector, size_t dimension) {
     sparse_encoded_t *result = malloc(sizeof(sparse_encoded_t));
     if (!result) return NULL;
 
-    /* Calculate maximum size: 16 bits header + count * 13 bits */
-    size_t max_size = (16 + count * 13 + 7) / 8;
-    result->data = calloc(max_size, 1);
-    if (!result->data) {
+    size_t max_size = sparse_max_encoded_size(dimension, count);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        sparse_encode_into(vector, dimension, result->data, max_size, &result->size) < 0) {
+        free(result->data);
         free(result);
         return NULL;
     }
     result->count = count;
-
-    /* Write header and entries */
-    bit_writer_t bw;
-    bit_writer_init(&bw, result->data);
-
-    /* Write count */
-    bit_writer_write(&bw, count, 16);
-
-    /* Write (position, value) pairs */
-    for (size_t i = 0; i < dimension; i++) {
-        if (vector[i] != 0) {
-            bit_writer_write(&bw, i, 11);               /* Position (11 bits) */
-            bit_writer_write(&bw, encode_value(vector[i]), 2);  /* Value (2 bits) */
-        }
-    }
-
-    result->size = bit_writer_finish(&bw);
     return result;
 }
 
 int sparse_decode(const sparse_encoded_t *encoded, int8_t *vector, size_t dimension) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
     if (!encoded || !encoded->data || !vector || dimension == 0) {
         return -1;
     }
@@ -147,18 +116,22 @@ int sparse_decode(const sparse_encoded_t *encoded, int8_t *vector, size_t dimens
 
     /* Read encoded data */
     bit_reader_t br;
-    bit_reader_init(&br, encoded->data);
+    br_init(&br, encoded->data, encoded->size);
 
     /* Read count */
-    uint16_t count = bit_reader_read(&br, 16);
-    if (count != encoded->count) {
+    uint32_t count;
+    if (br_read_bits(&br, 16, &count) < 0 || count != encoded->count) {
         return -1;  /* Corrupted data */
     }
 
     /* Read (position, value) pairs */
     for (uint16_t i = 0; i < count; i++) {
-        uint16_t pos = bit_reader_read(&br, 11);
-        uint8_t val_code = bit_reader_read(&br, 2);
+        uint32_t entry;
+        if (br_read_bits(&br, 13, &entry) < 0) {
+            return -1;  /* Truncated data */
+        }
+        uint16_t pos = entry >> 2;
+        uint8_t val_code = entry & 3;
 
         if (pos >= dimension) {
             return -1;  /* Invalid position */
@@ -38,6 +38,26 @@ typedef struct {
  */
 sparse_encoded_t* sparse_encode(const int8_t *vector, size_t dimension);
 
+/**
+ * Encode into a caller-provided buffer, with no allocation
+ *
+ * @param out      Output buffer; sparse_max_encoded_size() bytes always suffice
+ * @param out_cap  Size of out
+ * @param written  Out: bytes used (bytes past it may be overwritten up to out_cap)
+ * @return 0 on success, -1 on bad input or if the encoding does not fit
+ */
+int sparse_encode_into(const int8_t *vector, size_t dimension,
+                       uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case encoded size of k non-zeros
+ *
+ * @param dimension Vector dimension (must be <= 2048)
+ * @param k Number of non-zeros
+ * @return Size in bytes (exact for this format), or 0 if out of range
+ */
+size_t sparse_max_encoded_size(size_t dimension, size_t k);
+
 /**
  * Decode a sparse vector
  *
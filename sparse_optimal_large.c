@@ -6,239 +6,77 @@
  */
 
 #include "sparse_optimal_large.h"
+#include "canonical_huffman.h"
+#include "dntl_stats.h"
+#include "huffman_lengths.h"
+#include "sparse_scan.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* Bit writer/reader */
-typedef struct {
-    uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t capacity;
-} bit_writer_t;
-
-typedef struct {
-    const uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t size;
-} bit_reader_t;
-
-static void bw_init(bit_writer_t *bw, uint8_t *buffer, size_t capacity) {
-    bw->buffer = buffer;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-    bw->capacity = capacity;
-}
-
-static int bw_write_bit(bit_writer_t *bw, uint8_t bit) {
-    if (bw->byte_pos >= bw->capacity) return -1;
-    if (bit) bw->buffer[bw->byte_pos] |= (1 << (7 - bw->bit_pos));
-    bw->bit_pos++;
-    if (bw->bit_pos == 8) {
-        bw->bit_pos = 0;
-        bw->byte_pos++;
-    }
-    return 0;
-}
-
-static int bw_write_bits(bit_writer_t *bw, uint32_t value, uint8_t num_bits) {
-    for (int i = num_bits - 1; i >= 0; i--) {
-        if (bw_write_bit(bw, (value >> i) & 1) < 0) return -1;
-    }
-    return 0;
-}
-
-static int bw_write_rice(bit_writer_t *bw, uint32_t value, uint8_t r) {
-    uint32_t q = value >> r;
-    uint32_t rem = value & ((1 << r) - 1);
-    for (uint32_t i = 0; i < q; i++) {
-        if (bw_write_bit(bw, 1) < 0) return -1;
-    }
-    if (bw_write_bit(bw, 0) < 0) return -1;
-    return bw_write_bits(bw, rem, r);
-}
-
-static size_t bw_finish(bit_writer_t *bw) {
-    return bw->byte_pos + (bw->bit_pos > 0 ? 1 : 0);
-}
-
-static void br_init(bit_reader_t *br, const uint8_t *buffer, size_t size) {
-    br->buffer = buffer;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-    br->size = size;
-}
-
-static int br_read_bit(bit_reader_t *br) {
-    if (br->byte_pos >= br->size) return -1;
-    int bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-    br->bit_pos++;
-    if (br->bit_pos == 8) {
-        br->bit_pos = 0;
-        br->byte_pos++;
-    }
-    return bit;
-}
-
-static int br_read_bits(bit_reader_t *br, uint8_t num_bits, uint32_t *out) {
-    uint32_t value = 0;
-    for (uint8_t i = 0; i < num_bits; i++) {
-        int bit = br_read_bit(br);
-        if (bit < 0) return -1;
-        value = (value << 1) | bit;
-    }
-    *out = value;
-    return 0;
-}
-
-static int br_read_rice(bit_reader_t *br, uint8_t r, uint32_t *out) {
-    uint32_t q = 0;
-    int bit;
-    while ((bit = br_read_bit(br)) == 1) {
-        q++;
-        if (q > 2000) return -1;
-    }
-    if (bit < 0) return -1;
-    uint32_t rem;
-    if (br_read_bits(br, r, &rem) < 0) return -1;
-    *out = (q << r) | rem;
-    return 0;
-}
-
-/* Huffman tree */
-typedef struct huff_node {
-    int8_t value;
-    uint32_t freq;
-    struct huff_node *left, *right;
-} huff_node_t;
+/* Sanity bound on unary quotients when decoding */
+#define MAX_RICE_QUOTIENT 2000
 
 typedef struct {
     uint32_t code;
     uint8_t length;
 } huff_code_t;
 
-static int compare_nodes(const void *a, const void *b) {
-    huff_node_t *na = *(huff_node_t**)a;
-    huff_node_t *nb = *(huff_node_t**)b;
-    if (na->freq != nb->freq) return na->freq - nb->freq;
-    return na->value - nb->value;  /* Deterministic tiebreaker */
-}
-
-static void free_tree(huff_node_t *node) {
-    if (!node) return;
-    free_tree(node->left);
-    free_tree(node->right);
-    free(node);
-}
-
-/* Build canonical Huffman codes */
+/* Build canonical Huffman codes, no longer than the 5-bit length field */
 static void build_huffman(uint32_t *freqs, int8_t *values, int n_values,
                          huff_code_t *codes, int8_t *code_map) {
     if (n_values == 0) return;
 
-    /* Special case: single symbol */
-    if (n_values == 1) {
-        codes[0].code = 0;
-        codes[0].length = 1;
-        code_map[values[0] + 128] = 0;
-        return;
-    }
-
-    /* Build Huffman tree */
-    huff_node_t **nodes = malloc(n_values * 2 * sizeof(huff_node_t*));
+    uint8_t lengths[256];
+    uint32_t canon[256];
+    huff_build_lengths(freqs, n_values, CHUFF_MAX_LEN, lengths);
+    huff_canonical_codes(lengths, n_values, canon);
     for (int i = 0; i < n_values; i++) {
-        nodes[i] = malloc(sizeof(huff_node_t));
-        nodes[i]->value = values[i];
-        nodes[i]->freq = freqs[i];
-        nodes[i]->left = nodes[i]->right = NULL;
+        codes[i].code = canon[i];
+        codes[i].length = lengths[i];
+        code_map[values[i] + 128] = i;
     }
+}
 
-    int n_nodes = n_values;
-    while (n_nodes > 1) {
-        qsort(nodes, n_nodes, sizeof(huff_node_t*), compare_nodes);
-
-        huff_node_t *new_node = malloc(sizeof(huff_node_t));
-        new_node->value = 0;
-        new_node->freq = nodes[0]->freq + nodes[1]->freq;
-        new_node->left = nodes[0];
-        new_node->right = nodes[1];
-
-        nodes[0] = new_node;
-        for (int i = 1; i < n_nodes - 1; i++) {
-            nodes[i] = nodes[i + 1];
-        }
-        n_nodes--;
-    }
+size_t sparse_optimal_large_max_encoded_size(size_t dimension, size_t k) {
+    if (dimension == 0 || dimension > 65535 || k > dimension) return 0;
 
-    /* Extract code lengths via DFS */
-    uint8_t lengths[256] = {0};
-    void extract_lengths(huff_node_t *node, uint8_t depth, int8_t *vals, int n, uint8_t *lens) {
-        if (!node) return;
-        if (!node->left && !node->right) {
-            for (int i = 0; i < n; i++) {
-                if (vals[i] == node->value) {
-                    lens[i] = depth;
-                    break;
-                }
-            }
-        } else {
-            extract_lengths(node->left, depth + 1, vals, n, lens);
-            extract_lengths(node->right, depth + 1, vals, n, lens);
-        }
-    }
-    extract_lengths(nodes[0], 0, values, n_values, lengths);
-
-    /* Build canonical codes */
-    uint32_t code = 0;
-    for (uint8_t len = 1; len <= 32; len++) {
-        for (int i = 0; i < n_values; i++) {
-            if (lengths[i] == len) {
-                codes[i].code = code;
-                codes[i].length = len;
-                code_map[values[i] + 128] = i;
-                code++;
-            }
-        }
-        code <<= 1;
-    }
+    /* Header 24 bits and 13 per alphabet entry. Gaps: Rice codes with
+     * r >= 3, unary parts totalling <= dimension >> 3. Values: a code over
+     * <= 256 symbols costs <= 8 bits per value */
+    size_t n_unique = k < 255 ? k : 255;
+    size_t bits = 24 + 13 * n_unique + 14 + 5 * k + (dimension >> 3) + 8 * k;
+    return (bits + 7) / 8;
+}
 
-    free_tree(nodes[0]);
-    free(nodes);
+int sparse_optimal_large_encode_into(const int8_t *vector, size_t dimension,
+                                    uint8_t *out, size_t out_cap, size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_optimal_large_encode_ctx(ctx, vector, dimension,
+                                              out, out_cap, written);
+    sparse_codec_ctx_free(ctx);
+    return ret;
 }
 
-sparse_optimal_large_t* sparse_optimal_large_encode(const int8_t *vector, size_t dimension) {
-    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+int sparse_optimal_large_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                    size_t dimension, uint8_t *out, size_t out_cap,
+                                    size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!ctx || !vector || !out || !written) return -1;
+    if (dimension == 0 || dimension > ctx->capacity) return -1;
 
     /* Find non-zeros and build frequency table */
-    uint16_t *positions = malloc(dimension * sizeof(uint16_t));
-    int8_t *vals = malloc(dimension * sizeof(int8_t));
+    uint16_t *positions = ctx->positions;
+    int8_t *vals = ctx->values;
     uint32_t value_freqs[256] = {0};
 
-    if (!positions || !vals) {
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-
-    uint16_t count = 0;
-    for (size_t i = 0; i < dimension; i++) {
-        if (vector[i] != 0) {
-            positions[count] = i;
-            vals[count] = vector[i];
-            value_freqs[(uint8_t)(vector[i] + 128)]++;
-            count++;
-        }
-    }
+    uint16_t count = (uint16_t)sparse_scan(vector, dimension, positions, vals, value_freqs);
 
     if (count == 0) {
-        sparse_optimal_large_t *result = malloc(sizeof(sparse_optimal_large_t));
-        result->data = calloc(2, 1);
-        result->size = 2;
-        result->count = 0;
-        free(positions);
-        free(vals);
-        return result;
+        if (out_cap < 2) return -1;
+        out[0] = out[1] = 0;
+        *written = 2;
+        return 0;
     }
 
     /* Build alphabet */
@@ -259,27 +97,9 @@ sparse_optimal_large_t* sparse_optimal_large_encode(const int8_t *vector, size_t
     memset(code_map, -1, sizeof(code_map));
     build_huffman(alphabet_freqs, alphabet, n_unique, codes, code_map);
 
-    /* Allocate result */
-    sparse_optimal_large_t *result = malloc(sizeof(sparse_optimal_large_t));
-    if (!result) {
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-
-    size_t max_size = 2 + 2 + n_unique * 2 + count * 12;
-    result->data = calloc(max_size, 1);
-    if (!result->data) {
-        free(result);
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-    result->count = count;
-
     /* Encode */
     bit_writer_t bw;
-    bw_init(&bw, result->data, max_size);
+    bw_init(&bw, out, out_cap);
 
     /* Header */
     if (bw_write_bits(&bw, count, 16) < 0) goto error;
@@ -312,24 +132,61 @@ sparse_optimal_large_t* sparse_optimal_large_encode(const int8_t *vector, size_t
         }
     }
 
-    result->size = bw_finish(&bw);
-    free(positions);
-    free(vals);
-    return result;
+    *written = bw_finish(&bw);
+    return 0;
 
 error:
-    free(result->data);
-    free(result);
-    free(positions);
-    free(vals);
-    return NULL;
+    return -1;
+}
+
+
+sparse_optimal_large_t* sparse_optimal_large_encode(const int8_t *vector, size_t dimension) {
+    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+
+    size_t count = sparse_scan_count(vector, dimension);
+
+    sparse_optimal_large_t *result = malloc(sizeof(sparse_optimal_large_t));
+    if (!result) return NULL;
+
+    size_t max_size = sparse_optimal_large_max_encoded_size(dimension, count);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        sparse_optimal_large_encode_into(vector, dimension, result->data, max_size,
+                                         &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
+    }
+    result->count = (uint16_t)count;
+    return result;
 }
 
 int sparse_optimal_large_decode(const sparse_optimal_large_t *encoded,
                                 int8_t *vector, size_t dimension) {
-    if (!encoded || !encoded->data || !vector) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_optimal_large_decode_ctx(ctx, encoded, vector, dimension);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
 
-    memset(vector, 0, dimension * sizeof(int8_t));
+int sparse_optimal_large_decode_sparse(const sparse_optimal_large_t *encoded,
+                                       sparse_vector_t *out) {
+    if (!out) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(out->dimension);
+    if (!ctx) return -1;
+    int ret = sparse_optimal_large_decode_sparse_ctx(ctx, encoded, out);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+/* Positions and values of the nonzeros into lists of capacity entries,
+ * for the dense and the sparse decoders */
+static int decode_list(sparse_codec_ctx_t *ctx, const sparse_optimal_large_t *encoded,
+                       size_t dimension, uint16_t *positions, int8_t *values,
+                       size_t capacity, uint32_t *count_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
+    *count_out = 0;
 
     bit_reader_t br;
     br_init(&br, encoded->data, encoded->size);
@@ -337,93 +194,87 @@ int sparse_optimal_large_decode(const sparse_optimal_large_t *encoded,
     /* Read header */
     uint32_t count, n_unique;
     if (br_read_bits(&br, 16, &count) < 0) return -1;
+    if (count == 0) return 0;     /* empty: the count alone was written */
     if (br_read_bits(&br, 8, &n_unique) < 0) return -1;
-
-    if (count == 0) return 0;
     if (n_unique == 0 || n_unique > 256) return -1;
 
     /* Read alphabet and lengths */
     int8_t alphabet[256];
-    huff_code_t codes[256];
+    uint8_t lengths[256];
 
     for (uint32_t i = 0; i < n_unique; i++) {
         uint32_t val_enc, len;
         if (br_read_bits(&br, 8, &val_enc) < 0) return -1;
         if (br_read_bits(&br, 5, &len) < 0) return -1;
         alphabet[i] = (int8_t)val_enc - 128;
-        codes[i].length = len;
+        lengths[i] = (uint8_t)len;
     }
 
-    /* Reconstruct canonical codes */
-    uint32_t code = 0;
-    for (uint8_t len = 1; len <= 32; len++) {
-        for (uint32_t i = 0; i < n_unique; i++) {
-            if (codes[i].length == len) {
-                codes[i].code = code;
-                code++;
-            }
-        }
-        code <<= 1;
-    }
+    /* Decoding tables for the canonical codes */
+    chuff_table_t *table = &ctx->huffman;
+    if (chuff_build(table, lengths, n_unique, count) < 0) return -1;
 
     /* Read Rice parameter and positions */
     uint32_t r;
     if (br_read_bits(&br, 3, &r) < 0) return -1;
 
-    uint16_t *positions = malloc(count * sizeof(uint16_t));
-    if (!positions) return -1;
+    if (count > capacity) return -1;
 
     uint32_t pos;
-    if (br_read_bits(&br, 11, &pos) < 0) {
-        free(positions);
-        return -1;
-    }
+    if (br_read_bits(&br, 11, &pos) < 0) return -1;
+    if (pos >= dimension) return -1;
     positions[0] = pos;
 
     for (uint32_t i = 1; i < count; i++) {
         uint32_t gap;
-        if (br_read_rice(&br, r, &gap) < 0) {
-            free(positions);
-            return -1;
-        }
+        if (br_read_rice(&br, r, MAX_RICE_QUOTIENT, &gap) < 0) return -1;
         pos = pos + gap + 1;
-        if (pos >= dimension) {
-            free(positions);
-            return -1;
-        }
+        if (pos >= dimension) return -1;
         positions[i] = pos;
     }
 
-    /* Decode values */
-    for (uint32_t i = 0; i < count; i++) {
-        uint32_t code_val = 0;
-        uint8_t found = 0;
-
-        for (uint8_t code_len = 1; code_len <= 32; code_len++) {
-            int bit = br_read_bit(&br);
-            if (bit < 0) {
-                free(positions);
-                return -1;
-            }
-            code_val = (code_val << 1) | bit;
-
-            for (uint32_t j = 0; j < n_unique; j++) {
-                if (codes[j].length == code_len && codes[j].code == code_val) {
-                    vector[positions[i]] = alphabet[j];
-                    found = 1;
-                    break;
-                }
-            }
-            if (found) break;
+    /* Decode values, a chunk of alphabet indices at a time */
+    uint8_t syms[64];
+    for (uint32_t i = 0; i < count; i += sizeof(syms)) {
+        uint32_t n = count - i < sizeof(syms) ? count - i : (uint32_t)sizeof(syms);
+        if (chuff_decode_n(table, &br, syms, n) < 0) return -1;
+        for (uint32_t j = 0; j < n; j++) {
+            values[i + j] = alphabet[syms[j]];
         }
+    }
 
-        if (!found) {
-            free(positions);
-            return -1;
-        }
+    *count_out = count;
+    return 0;
+}
+
+int sparse_optimal_large_decode_ctx(sparse_codec_ctx_t *ctx,
+                                    const sparse_optimal_large_t *encoded, int8_t *vector,
+                                    size_t dimension) {
+    if (!ctx || !encoded || !encoded->data || !vector) return -1;
+
+    memset(vector, 0, dimension * sizeof(int8_t));
+    uint32_t count;
+    if (decode_list(ctx, encoded, dimension, ctx->positions, ctx->values, ctx->capacity,
+                    &count) < 0) {
+        return -1;
     }
+    for (uint32_t i = 0; i < count; i++) {
+        vector[ctx->positions[i]] = ctx->values[i];
+    }
+    return 0;
+}
 
-    free(positions);
+int sparse_optimal_large_decode_sparse_ctx(sparse_codec_ctx_t *ctx,
+                                           const sparse_optimal_large_t *encoded,
+                                           sparse_vector_t *out) {
+    if (!ctx || !encoded || !encoded->data || !out || !out->indices || !out->values) return -1;
+
+    uint32_t count;
+    if (decode_list(ctx, encoded, out->dimension, out->indices, out->values,
+                    sparse_vector_room(out, encoded->count), &count) < 0) {
+        return -1;
+    }
+    out->count = (uint16_t)count;
     return 0;
 }
 
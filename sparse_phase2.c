@@ -3,178 +3,35 @@
  *
  * Phase 2 optimization: Delta alphabet + rANS
  * - Rice gaps for positions
- * - rANS (Asymmetric Numeral Systems) for values
+ * - Interleaved rANS (Asymmetric Numeral Systems) for values
  * - Delta-encoded alphabet
  * - Frequency table stored in bitstream
  * Target: ~162 bytes for 97 nz vectors
  */
 
 #include "sparse_phase2.h"
+#include "bitstream.h"
+#include "dntl_stats.h"
+#include "histogram.h"
+#include "rans_interleaved.h"
+#include "sparse_scan.h"
+#include "tans.h"
 #include <stdlib.h>
 #include <string.h>
-#include <stdio.h>
-
-/* Bit writer/reader */
-typedef struct {
-    uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t capacity;
-} bit_writer_t;
-
-typedef struct {
-    const uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t size;
-} bit_reader_t;
-
-static void bw_init(bit_writer_t *bw, uint8_t *buffer, size_t capacity) {
-    bw->buffer = buffer;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-    bw->capacity = capacity;
-}
-
-static int bw_write_bit(bit_writer_t *bw, uint8_t bit) {
-    if (bw->byte_pos >= bw->capacity) return -1;
-    if (bit) bw->buffer[bw->byte_pos] |= (1 << (7 - bw->bit_pos));
-    bw->bit_pos++;
-    if (bw->bit_pos == 8) {
-        bw->bit_pos = 0;
-        bw->byte_pos++;
-    }
-    return 0;
-}
-
-static int bw_write_bits(bit_writer_t *bw, uint32_t value, uint8_t num_bits) {
-    for (int i = num_bits - 1; i >= 0; i--) {
-        if (bw_write_bit(bw, (value >> i) & 1) < 0) return -1;
-    }
-    return 0;
-}
-
-static int bw_write_rice(bit_writer_t *bw, uint32_t value, uint8_t r) {
-    uint32_t q = value >> r;
-    uint32_t rem = value & ((1 << r) - 1);
-    for (uint32_t i = 0; i < q; i++) {
-        if (bw_write_bit(bw, 1) < 0) return -1;
-    }
-    if (bw_write_bit(bw, 0) < 0) return -1;
-    return bw_write_bits(bw, rem, r);
-}
-
-static void bw_align(bit_writer_t *bw) {
-    /* Pad to next byte boundary */
-    if (bw->bit_pos > 0) {
-        bw->byte_pos++;
-        bw->bit_pos = 0;
-    }
-}
 
-static int bw_write_byte(bit_writer_t *bw, uint8_t byte) {
-    /* Write a full byte (must be byte-aligned) */
-    if (bw->bit_pos != 0) return -1;  /* Must be byte-aligned */
-    if (bw->byte_pos >= bw->capacity) return -1;
-    bw->buffer[bw->byte_pos++] = byte;
-    return 0;
-}
-
-static size_t bw_finish(bit_writer_t *bw) {
-    return bw->byte_pos + (bw->bit_pos > 0 ? 1 : 0);
-}
-
-static void br_init(bit_reader_t *br, const uint8_t *buffer, size_t size) {
-    br->buffer = buffer;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-    br->size = size;
-}
-
-static int br_read_bit(bit_reader_t *br) {
-    if (br->byte_pos >= br->size) return -1;
-    int bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-    br->bit_pos++;
-    if (br->bit_pos == 8) {
-        br->bit_pos = 0;
-        br->byte_pos++;
-    }
-    return bit;
-}
-
-static int br_read_bits(bit_reader_t *br, uint8_t num_bits, uint32_t *out) {
-    uint32_t value = 0;
-    for (uint8_t i = 0; i < num_bits; i++) {
-        int bit = br_read_bit(br);
-        if (bit < 0) return -1;
-        value = (value << 1) | bit;
-    }
-    *out = value;
-    return 0;
-}
+/* Sanity bound on unary quotients when decoding */
+#define MAX_RICE_QUOTIENT 2000
 
-static void br_align(bit_reader_t *br) {
-    /* Skip to next byte boundary */
-    if (br->bit_pos > 0) {
-        br->byte_pos++;
-        br->bit_pos = 0;
-    }
-}
-
-static int br_read_byte(bit_reader_t *br, uint8_t *out) {
-    /* Read a full byte (must be byte-aligned) */
-    if (br->bit_pos != 0) return -1;  /* Must be byte-aligned */
-    if (br->byte_pos >= br->size) return -1;
-    *out = br->buffer[br->byte_pos++];
-    return 0;
-}
-
-static int br_read_rice(bit_reader_t *br, uint8_t r, uint32_t *out) {
-    uint32_t q = 0;
-    int bit;
-    while ((bit = br_read_bit(br)) == 1) {
-        q++;
-        if (q > 2000) return -1;
-    }
-    if (bit < 0) return -1;
-    uint32_t rem;
-    if (br_read_bits(br, r, &rem) < 0) return -1;
-    *out = (q << r) | rem;
-    return 0;
+/*
+ * Values: interleaved rANS (rans_interleaved.h) over the 8-bit frequency
+ * table. The lane count follows from the count of values, so it costs no
+ * header bits: each extra lane flushes 3 more state bytes, which only long
+ * vectors repay in decoding speed.
+ */
+static unsigned rans_lanes_for(uint32_t count) {
+    return count >= 2048 ? 8 : count >= 512 ? 4 : count >= 128 ? 2 : 1;
 }
 
-/* rANS (range Asymmetric Numeral Systems) for values */
-#define ANS_L 65536  /* Lower bound for state (must be >> freq total of 4096) */
-
-/* Global counters for debugging */
-static int g_encode_renorm_count = 0;
-static int g_decode_renorm_count = 0;
-
-typedef struct {
-    uint32_t state;
-    uint32_t *freq;
-    uint32_t *cumul;
-    uint32_t total;
-    int n_symbols;
-    bit_writer_t *bw;
-    /* Buffer to collect all rANS bytes for reversing */
-    uint8_t *rans_buffer;
-    size_t rans_capacity;
-    size_t rans_pos;
-} rans_encoder_t;
-
-typedef struct {
-    uint32_t state;
-    uint32_t *freq;
-    uint32_t *cumul;
-    uint32_t total;
-    int n_symbols;
-    bit_reader_t *br;
-    /* Buffer for backwards reading */
-    uint8_t *rans_buffer;
-    int rans_pos;  /* Current read position (decrements) */
-} rans_decoder_t;
-
 /* Normalize frequencies to fit in 8 bits (max sum = 256) */
 static void normalize_freqs(uint32_t *freqs, int n_symbols, uint32_t *norm_freqs) {
     uint32_t total = 0;
@@ -214,285 +71,130 @@ static void normalize_freqs(uint32_t *freqs, int n_symbols, uint32_t *norm_freqs
     }
 }
 
-static void rans_init_encoder(rans_encoder_t *enc, uint32_t *freqs, int n_symbols, bit_writer_t *bw, size_t max_symbols) {
-    enc->state = ANS_L;
-    enc->n_symbols = n_symbols;
-    enc->bw = bw;
-
-    /* Normalize frequencies */
-    enc->freq = malloc(n_symbols * sizeof(uint32_t));
-    normalize_freqs(freqs, n_symbols, enc->freq);
-
-    /* Build cumulative frequencies */
-    enc->cumul = malloc((n_symbols + 1) * sizeof(uint32_t));
-    enc->cumul[0] = 0;
-    enc->total = 0;
-    for (int i = 0; i < n_symbols; i++) {
-        enc->total += enc->freq[i];
-        enc->cumul[i + 1] = enc->total;
-    }
-
-    /* Allocate buffer for collecting rANS bytes (conservative: 20 bytes per symbol + state) */
-    enc->rans_capacity = max_symbols * 20 + 4;
-    enc->rans_buffer = malloc(enc->rans_capacity);
-    enc->rans_pos = 0;
+/*
+ * Worst cases, in bytes. The Rice parameter is 3 or 4, so gaps summing to
+ * < dimension take at most 5 bits each plus dimension >> 3 unary ones, and
+ * tANS output (one state byte, at most 8 bits per value) never exceeds the
+ * rANS bound.
+ *
+ * Own table: header 32 bits, a full alphabet bitfield, 8 bits per value
+ * present, r and the first position, then byte alignment.
+ * Dictionary: header 23 bits, the escape flag and count, 8 bits per escape.
+ */
+static size_t max_size_own_table(size_t dimension, size_t k) {
+    size_t n_unique = k < 255 ? k : 255;
+    return (32 + 256 + 8 * n_unique + 14 + 5 * k + (dimension >> 3) + 7) / 8 +
+           rans_max_bytes(k, rans_lanes_for((uint32_t)k));
 }
 
-static int rans_encode_symbol(rans_encoder_t *enc, int symbol) {
-    uint32_t freq = enc->freq[symbol];
-    uint32_t cumul = enc->cumul[symbol];
-
-    fprintf(stderr, "DEBUG encode: sym=%d, freq=%u, cumul=%u, state_in=0x%08x\n",
-            symbol, freq, cumul, enc->state);
-
-    /* Renormalize BEFORE encoding: keep state below threshold */
-    /* Standard rANS formula: max_state = ((ANS_L >> precision_bits) << 8) * freq */
-    /* With precision_bits = 8 (total = 256 = 2^8), this becomes: */
-    /* max_state = ((ANS_L >> 8) << 8) * freq = ((2^16 >> 8) << 8) * freq = (2^8 << 8) * freq */
-    uint32_t max_state = ((ANS_L >> 8) << 8) * freq;
-    while (enc->state >= max_state) {
-        if (enc->rans_pos >= enc->rans_capacity) return -1;
-        uint8_t byte = enc->state & 0xFF;
-        enc->rans_buffer[enc->rans_pos++] = byte;
-        fprintf(stderr, "DEBUG encode: buffer renorm byte 0x%02x\n", byte);
-        enc->state >>= 8;
-        g_encode_renorm_count++;
-    }
-
-    /* Encode: state = total * (state / freq) + cumul + (state % freq) */
-    enc->state = enc->total * (enc->state / freq) + cumul + (enc->state % freq);
-    fprintf(stderr, "DEBUG encode: state_out=0x%08x\n", enc->state);
-    return 0;
+static size_t max_size_dict(size_t dimension, size_t k) {
+    return (23 + 5 * k + (dimension >> 3) + 17 + 8 * k + 7) / 8 +
+           rans_max_bytes(k, rans_lanes_for((uint32_t)k));
 }
 
-static int rans_flush(rans_encoder_t *enc) {
-    fprintf(stderr, "DEBUG flush: Final state before final renorm = 0x%08x\n", enc->state);
-
-    /* Final renormalization: ensure state is in range [ANS_L, ANS_L * 256) */
-    /* Output bytes while safe to do so (next shift won't drop below ANS_L) */
-    while (enc->state >= (ANS_L << 8)) {
-        if (enc->rans_pos >= enc->rans_capacity) return -1;
-        uint8_t byte = enc->state & 0xFF;
-        enc->rans_buffer[enc->rans_pos++] = byte;
-        fprintf(stderr, "DEBUG flush: final renorm byte 0x%02x\n", byte);
-        enc->state >>= 8;
-        g_encode_renorm_count++;
-    }
-
-    /* Continue outputting if (state >> 8) would still be >= ANS_L */
-    while ((enc->state >> 8) >= ANS_L && enc->state >= (ANS_L << 1)) {
-        if (enc->rans_pos >= enc->rans_capacity) return -1;
-        uint8_t byte = enc->state & 0xFF;
-        enc->rans_buffer[enc->rans_pos++] = byte;
-        fprintf(stderr, "DEBUG flush: extra renorm byte 0x%02x\n", byte);
-        enc->state >>= 8;
-        g_encode_renorm_count++;
-    }
-
-    /* If state < ANS_L, we need to bring it back up */
-    /* This should not happen if renorm thresholds are correct, but let's check */
-    if (enc->state < ANS_L) {
-        fprintf(stderr, "ERROR: Final state 0x%08x < ANS_L 0x%08x!\n", enc->state, ANS_L);
-        return -1;
-    }
-
-    fprintf(stderr, "DEBUG flush: Final state = 0x%08x, %zu rans bytes in buffer\n",
-            enc->state, enc->rans_pos);
-
-    /* Write renorm bytes in FORWARD order (decoder will read them backwards) */
-    fprintf(stderr, "DEBUG flush: Writing %zu renorm bytes in forward order\n", enc->rans_pos);
-    for (size_t i = 0; i < enc->rans_pos; i++) {
-        if (bw_write_byte(enc->bw, enc->rans_buffer[i]) < 0) {
-            free(enc->freq);
-            free(enc->cumul);
-            free(enc->rans_buffer);
-            return -1;
-        }
-    }
+size_t sparse_phase2_max_encoded_size(size_t dimension, size_t k) {
+    if (dimension == 0 || dimension > 65535 || k > dimension) return 0;
 
-    /* Write final state in NORMAL byte order (little-endian, 4 bytes) */
-    fprintf(stderr, "DEBUG flush: Writing final state 0x%08x in normal order\n", enc->state);
-    for (int i = 0; i < 4; i++) {
-        uint8_t byte = (enc->state >> (i * 8)) & 0xFF;
-        fprintf(stderr, "DEBUG flush: state byte[%d] = 0x%02x\n", i, byte);
-        if (bw_write_byte(enc->bw, byte) < 0) {
-            free(enc->freq);
-            free(enc->cumul);
-            free(enc->rans_buffer);
-            return -1;
-        }
-    }
-
-    fprintf(stderr, "=== ENCODE RENORM TOTAL: %d bytes ===\n", g_encode_renorm_count);
-
-    free(enc->freq);
-    free(enc->cumul);
-    free(enc->rans_buffer);
-    return 0;
+    size_t own = max_size_own_table(dimension, k);
+    size_t dict = max_size_dict(dimension, k);
+    return own > dict ? own : dict;
 }
 
-static int rans_init_decoder(rans_decoder_t *dec, uint32_t *freqs, int n_symbols, bit_reader_t *br) {
-    dec->n_symbols = n_symbols;
-    dec->br = br;
+/* Output buffer of the allocating encoders, which count first */
+static sparse_phase2_t* alloc_result(const int8_t *vector, size_t dimension,
+                                     size_t *max_size) {
+    size_t count = sparse_scan_count(vector, dimension);
 
-    /* Normalize frequencies (same as encoder) */
-    dec->freq = malloc(n_symbols * sizeof(uint32_t));
-    normalize_freqs(freqs, n_symbols, dec->freq);
-
-    /* Build cumulative frequencies */
-    dec->cumul = malloc((n_symbols + 1) * sizeof(uint32_t));
-    dec->cumul[0] = 0;
-    dec->total = 0;
-    for (int i = 0; i < n_symbols; i++) {
-        dec->total += dec->freq[i];
-        dec->cumul[i + 1] = dec->total;
-    }
-
-    /* Read ALL remaining bytes into buffer for backwards reading */
-    size_t remaining = br->size - br->byte_pos;
-    fprintf(stderr, "DEBUG init_decoder: Reading %zu bytes into buffer\n", remaining);
-    dec->rans_buffer = malloc(remaining);
-    if (!dec->rans_buffer) {
-        free(dec->freq);
-        free(dec->cumul);
-        return -1;
-    }
-
-    for (size_t i = 0; i < remaining; i++) {
-        uint8_t byte;
-        if (br_read_byte(br, &byte) < 0) {
-            free(dec->freq);
-            free(dec->cumul);
-            free(dec->rans_buffer);
-            return -1;
-        }
-        dec->rans_buffer[i] = byte;
-    }
-
-    /* Read initial state from end (4 bytes, little-endian) */
-    if (remaining < 4) {
-        free(dec->freq);
-        free(dec->cumul);
-        free(dec->rans_buffer);
-        return -1;
-    }
+    sparse_phase2_t *result = malloc(sizeof(sparse_phase2_t));
+    if (!result) return NULL;
 
-    dec->state = 0;
-    size_t state_pos = remaining - 4;  /* State is last 4 bytes */
-    for (int i = 0; i < 4; i++) {
-        dec->state |= ((uint32_t)dec->rans_buffer[state_pos + i] << (i * 8));
+    *max_size = sparse_phase2_max_encoded_size(dimension, count);
+    result->data = malloc(*max_size);
+    if (!result->data) {
+        free(result);
+        return NULL;
     }
-    fprintf(stderr, "DEBUG init_decoder: Initial state = 0x%08x\n", dec->state);
-
-    /* Start reading renorm bytes backwards from position before state */
-    dec->rans_pos = (int)state_pos - 1;
-
-    return 0;
+    result->count = (uint16_t)count;
+    return result;
 }
 
-static int rans_decode_symbol(rans_decoder_t *dec, int *symbol, int skip_renorm) {
-    /* Find symbol from state % total */
-    uint32_t slot = dec->state % dec->total;
-
-    fprintf(stderr, "DEBUG decode_symbol: state_in=0x%08x, slot=%u, total=%u\n",
-            dec->state, slot, dec->total);
-
-    *symbol = 0;
-    for (int i = 0; i < dec->n_symbols; i++) {
-        if (slot < dec->cumul[i + 1]) {
-            *symbol = i;
-            break;
-        }
-    }
-
-    uint32_t freq = dec->freq[*symbol];
-    uint32_t cumul = dec->cumul[*symbol];
-
-    fprintf(stderr, "DEBUG decode_symbol: found sym=%d, freq=%u, cumul=%u\n",
-            *symbol, freq, cumul);
-
-    /* Decode: state = freq * (state / total) + (slot - cumul) */
-    uint32_t old_state = dec->state;
-    dec->state = freq * (dec->state / dec->total) + (slot - cumul);
-
-    fprintf(stderr, "DEBUG decode_symbol: state 0x%08x -> 0x%08x\n",
-            old_state, dec->state);
-
-    /* Renormalize: bring state back to [ANS_L, ...) - read backwards from buffer */
-    if (!skip_renorm) {
-        while (dec->state < ANS_L) {
-            fprintf(stderr, "DEBUG decode_symbol: renorm needed, state=0x%08x < 0x%08x\n",
-                    dec->state, ANS_L);
-            if (dec->rans_pos < 0) {
-                fprintf(stderr, "DEBUG decode_symbol: renorm read FAILED (no more bytes)\n");
-                fprintf(stderr, "=== DECODER CONSUMED %d renorm bytes before failure ===\n", g_decode_renorm_count);
-                return -1;
-            }
-            uint8_t byte = dec->rans_buffer[dec->rans_pos--];
-            fprintf(stderr, "DEBUG decode_symbol: renorm read byte 0x%02x from pos %d\n",
-                    byte, dec->rans_pos + 1);
-            dec->state = (dec->state << 8) | byte;
-            fprintf(stderr, "DEBUG decode_symbol: renorm state now 0x%08x\n", dec->state);
-            g_decode_renorm_count++;
-        }
-    } else {
-        fprintf(stderr, "DEBUG decode_symbol: skipping renorm (last symbol)\n");
-    }
-
-    return 0;
+sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension) {
+    return sparse_phase2_encode_coder(vector, dimension, SPARSE_PHASE2_RANS);
 }
 
-static void rans_free_decoder(rans_decoder_t *dec) {
-    if (dec) {
-        free(dec->freq);
-        free(dec->cumul);
-        free(dec->rans_buffer);
-    }
+int sparse_phase2_encode_into(const int8_t *vector, size_t dimension,
+                              uint8_t *out, size_t out_cap, size_t *written) {
+    return sparse_phase2_encode_coder_into(vector, dimension, SPARSE_PHASE2_RANS,
+                                           out, out_cap, written);
 }
 
-sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension) {
+sparse_phase2_t* sparse_phase2_encode_coder(const int8_t *vector, size_t dimension,
+                                            sparse_phase2_coder_t coder) {
     if (!vector || dimension == 0 || dimension > 65535) return NULL;
 
-    /* Reset renorm counters */
-    g_encode_renorm_count = 0;
-    g_decode_renorm_count = 0;
-
-    /* Find non-zeros and build frequency table */
-    uint16_t *positions = malloc(dimension * sizeof(uint16_t));
-    int8_t *vals = malloc(dimension * sizeof(int8_t));
-    uint32_t value_freqs[256] = {0};
-
-    if (!positions || !vals) {
-        free(positions);
-        free(vals);
+    size_t max_size;
+    sparse_phase2_t *result = alloc_result(vector, dimension, &max_size);
+    if (!result) return NULL;
+    if (sparse_phase2_encode_coder_into(vector, dimension, coder, result->data, max_size,
+                                        &result->size) < 0) {
+        sparse_phase2_free(result);
         return NULL;
     }
+    return result;
+}
 
-    uint16_t count = 0;
-    int8_t min_val = 127, max_val = -128;
+int sparse_phase2_encode_coder_into(const int8_t *vector, size_t dimension,
+                                    sparse_phase2_coder_t coder,
+                                    uint8_t *out, size_t out_cap, size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_encode_coder_ctx(ctx, vector, dimension, coder,
+                                             out, out_cap, written);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
 
-    for (size_t i = 0; i < dimension; i++) {
-        if (vector[i] != 0) {
-            positions[count] = i;
-            vals[count] = vector[i];
-            value_freqs[(uint8_t)(vector[i] + 128)]++;
+int sparse_phase2_encode_coder_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                   size_t dimension, sparse_phase2_coder_t coder,
+                                   uint8_t *out, size_t out_cap, size_t *written) {
+    if (!ctx || !vector) return -1;
+    if (dimension == 0 || dimension > ctx->capacity) return -1;
 
-            /* Track min/max for delta encoding */
-            if (vector[i] < min_val) min_val = vector[i];
-            if (vector[i] > max_val) max_val = vector[i];
+    /* Find non-zeros and build frequency table */
+    uint32_t value_freqs[256] = {0};
+    size_t count = sparse_scan(vector, dimension, ctx->positions, ctx->values, value_freqs);
+    return sparse_phase2_encode_coder_list_ctx(ctx, ctx->positions, ctx->values, count,
+                                               value_freqs, dimension, coder,
+                                               out, out_cap, written);
+}
 
-            count++;
-        }
+int sparse_phase2_encode_coder_list_ctx(sparse_codec_ctx_t *ctx, const uint16_t *positions,
+                                        const int8_t *vals, size_t n_nonzeros,
+                                        const uint32_t *hist, size_t dimension,
+                                        sparse_phase2_coder_t coder,
+                                        uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!ctx || (n_nonzeros > 0 && (!positions || !vals)) || !out || !written) return -1;
+    if (dimension == 0 || dimension > ctx->capacity || n_nonzeros > dimension) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
+    if (n_nonzeros > 0 && positions[n_nonzeros - 1] >= dimension) return -1;
+
+    uint32_t value_freqs[256];
+    if (hist) {
+        memcpy(value_freqs, hist, sizeof(value_freqs));
+    } else {
+        memset(value_freqs, 0, sizeof(value_freqs));
+        hist_add_int8(vals, n_nonzeros, value_freqs);
     }
+    const uint16_t count = (uint16_t)n_nonzeros;
+    int8_t min_val, max_val;
+    sparse_scan_range(value_freqs, &min_val, &max_val);
 
     if (count == 0) {
-        sparse_phase2_t *result = malloc(sizeof(sparse_phase2_t));
-        result->data = calloc(2, 1);
-        result->size = 2;
-        result->count = 0;
-        free(positions);
-        free(vals);
-        return result;
+        if (out_cap < 2) return -1;
+        out[0] = out[1] = 0;
+        *written = 2;
+        return 0;
     }
 
     /* Build alphabet */
@@ -508,41 +210,18 @@ sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension) {
     }
 
     /* Build value-to-index map for rANS */
-    int8_t value_to_idx[256];
-    memset(value_to_idx, -1, sizeof(value_to_idx));
+    uint8_t value_to_idx[256];
+    memset(value_to_idx, 0, sizeof(value_to_idx));
     for (int i = 0; i < n_unique; i++) {
         value_to_idx[(uint8_t)(alphabet[i] + 128)] = i;
     }
 
-    /* Allocate result */
-    sparse_phase2_t *result = malloc(sizeof(sparse_phase2_t));
-    if (!result) {
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-
-    int range = max_val - min_val + 1;
-    /* Conservative buffer size estimate:
-     * Header: 40 bits
-     * Bitfield: range bits
-     * Freq table: n_unique * 8 bits
-     * Positions: count * 15 bits (conservative)
-     * rANS values: count * 10 bits (conservative) + 32 bits state
-     */
-    size_t max_size = 10 + (range + 7) / 8 + n_unique + count * 4;
-    result->data = calloc(max_size, 1);
-    if (!result->data) {
-        free(result);
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-    result->count = count;
+    /* Rice parameter */
+    uint8_t r = count > 0 ? (uint8_t)(dimension / count >= 16 ? 4 : 3) : 4;
 
     /* Encode */
     bit_writer_t bw;
-    bw_init(&bw, result->data, max_size);
+    bw_init(&bw, out, out_cap);
 
     /* Header: count(16), min_val(8), max_val(8) */
     if (bw_write_bits(&bw, count, 16) < 0) goto error;
@@ -555,7 +234,8 @@ sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension) {
         if (bw_write_bit(&bw, present) < 0) goto error;
     }
 
-    /* Store frequency table (normalized to 8 bits each) */
+    /* Store frequency table (normalized to 8 bits each; a lone value's
+     * 256 is implied) */
     uint32_t norm_freqs[256];
     normalize_freqs(alphabet_freqs, n_unique, norm_freqs);
     for (int i = 0; i < n_unique; i++) {
@@ -563,63 +243,93 @@ sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension) {
     }
 
     /* Rice parameter */
-    uint8_t r = count > 0 ? (uint8_t)(dimension / count >= 16 ? 4 : 3) : 4;
     if (bw_write_bits(&bw, r, 3) < 0) goto error;
 
-    /* First position */
+    /* First position, in 11 bits */
+    if (positions[0] >= 2048) goto error;
     if (count > 0 && bw_write_bits(&bw, positions[0], 11) < 0) goto error;
 
     /* Position gaps */
     for (uint16_t i = 1; i < count; i++) {
+        if (positions[i] <= positions[i-1]) goto error;
         uint16_t gap = positions[i] - positions[i-1] - 1;
         if (bw_write_rice(&bw, gap, r) < 0) goto error;
     }
 
-    /* Align to byte boundary before rANS stream */
-    bw_align(&bw);
-    fprintf(stderr, "DEBUG: Byte-aligned before rANS at pos=%zu\n", bw.byte_pos);
+    /* Value indices */
+    uint8_t *syms = ctx->symbols;
+    for (uint16_t i = 0; i < count; i++) {
+        syms[i] = value_to_idx[(uint8_t)(vals[i] + 128)];
+    }
 
-    /* Encode values with rANS (in REVERSE order) */
-    rans_encoder_t rans;
-    rans_init_encoder(&rans, alphabet_freqs, n_unique, &bw, count);
+    if (coder == SPARSE_PHASE2_TANS) {
+        /* tANS bits straight after the gaps; the positions are spent, so
+         * ctx->positions holds the encoder's scratch */
+        if (tans_table_build(&ctx->tans, norm_freqs, n_unique) < 0) goto error;
+        if (tans_encode(&ctx->tans, syms, count, ctx->positions, &bw) < 0) goto error;
+        *written = bw_finish(&bw);
+    } else {
+        /* Align to byte boundary before rANS stream */
+        if (rans_table_build(&ctx->rans, norm_freqs, n_unique) < 0) goto error;
+        bw_align(&bw);
+        size_t header_bytes = bw_finish(&bw);
 
-    for (int i = count - 1; i >= 0; i--) {
-        int idx = value_to_idx[(uint8_t)(vals[i] + 128)];
-        if (idx < 0 || rans_encode_symbol(&rans, idx) < 0) goto error;
+        size_t rans_bytes = rans_encode(&ctx->rans, rans_lanes_for(count), syms, count,
+                                        out + header_bytes, out_cap - header_bytes);
+        if (rans_bytes == 0) goto error;
+        *written = header_bytes + rans_bytes;
     }
 
-    if (rans_flush(&rans) < 0) goto error;
-
-    result->size = bw_finish(&bw);
-    free(positions);
-    free(vals);
-    return result;
+    return 0;
 
 error:
-    free(result->data);
-    free(result);
-    free(positions);
-    free(vals);
-    return NULL;
+    return -1;
 }
 
 int sparse_phase2_decode(const sparse_phase2_t *encoded,
                          int8_t *vector, size_t dimension) {
-    if (!encoded || !encoded->data || !vector) return -1;
+    return sparse_phase2_decode_coder(encoded, vector, dimension, SPARSE_PHASE2_RANS);
+}
 
-    memset(vector, 0, dimension * sizeof(int8_t));
+int sparse_phase2_decode_coder(const sparse_phase2_t *encoded,
+                               int8_t *vector, size_t dimension,
+                               sparse_phase2_coder_t coder) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_decode_coder_ctx(ctx, encoded, vector, dimension, coder);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_phase2_decode_coder_sparse(const sparse_phase2_t *encoded, sparse_vector_t *out,
+                                      sparse_phase2_coder_t coder) {
+    if (!out) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(out->dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_decode_coder_sparse_ctx(ctx, encoded, out, coder);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+/* Positions and values of the nonzeros into lists of capacity entries,
+ * for the dense and the sparse decoders */
+static int decode_coder_list(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                             size_t dimension, sparse_phase2_coder_t coder,
+                             uint16_t *positions, int8_t *values, size_t capacity,
+                             uint32_t *count_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
+    *count_out = 0;
 
     bit_reader_t br;
     br_init(&br, encoded->data, encoded->size);
 
-    /* Read header: count(16), min_val(8), max_val(8) */
+    /* Read header: count(16), then unless empty min_val(8), max_val(8) */
     uint32_t count, min_val_enc, max_val_enc;
     if (br_read_bits(&br, 16, &count) < 0) return -1;
+    if (count == 0) return 0;
     if (br_read_bits(&br, 8, &min_val_enc) < 0) return -1;
     if (br_read_bits(&br, 8, &max_val_enc) < 0) return -1;
 
-    if (count == 0) return 0;
-
     int8_t min_val = (int8_t)min_val_enc - 128;
     int8_t max_val = (int8_t)max_val_enc - 128;
 
@@ -645,75 +355,342 @@ int sparse_phase2_decode(const sparse_phase2_t *encoded,
         if (br_read_bits(&br, 8, &freq) < 0) return -1;
         alphabet_freqs[i] = freq;
     }
+    if (n_unique == 1) alphabet_freqs[0] = RANS_TOTAL;
 
     /* Read Rice parameter and positions */
     uint32_t r;
     if (br_read_bits(&br, 3, &r) < 0) return -1;
 
-    uint16_t *positions = malloc(count * sizeof(uint16_t));
-    if (!positions) return -1;
+    /* Symbols go through the context's scratch */
+    if (count > capacity || count > ctx->capacity) return -1;
 
     uint32_t pos;
-    if (br_read_bits(&br, 11, &pos) < 0) {
-        free(positions);
-        return -1;
-    }
+    if (br_read_bits(&br, 11, &pos) < 0) return -1;
+    if (pos >= dimension) return -1;
     positions[0] = pos;
 
     for (uint32_t i = 1; i < count; i++) {
         uint32_t gap;
-        if (br_read_rice(&br, r, &gap) < 0) {
-            free(positions);
-            return -1;
-        }
+        if (br_read_rice(&br, r, MAX_RICE_QUOTIENT, &gap) < 0) return -1;
         pos = pos + gap + 1;
-        if (pos >= dimension) {
-            free(positions);
-            return -1;
-        }
+        if (pos >= dimension) return -1;
         positions[i] = pos;
     }
 
-    /* Align to byte boundary before rANS stream */
-    br_align(&br);
-    fprintf(stderr, "DEBUG: Byte-aligned before rANS decode at pos=%zu\n", br.byte_pos);
+    uint8_t *syms = ctx->symbols;
+    int rc;
+    if (coder == SPARSE_PHASE2_TANS) {
+        /* tANS bits straight after the gaps, then only padding */
+        rc = tans_table_build(&ctx->tans, alphabet_freqs, n_unique);
+        if (rc == 0) rc = tans_decode(&ctx->tans, &br, syms, count);
+        if (rc == 0 && br_bytes_left(&br) != 0) rc = -1;
+    } else {
+        /* Align to byte boundary before rANS stream */
+        rc = rans_table_build(&ctx->rans, alphabet_freqs, n_unique);
+        br_align(&br);
+        size_t offset = br_tell(&br) / 8;
+        if (rc == 0) {
+            rc = rans_decode(&ctx->rans, rans_lanes_for(count), encoded->data + offset,
+                             encoded->size - offset, syms, count);
+        }
+    }
+    if (rc < 0) return -1;
+    for (uint32_t i = 0; i < count; i++) {
+        values[i] = alphabet[syms[i]];
+    }
 
-    /* Decode values with rANS */
-    fprintf(stderr, "DEBUG decode: count=%u, n_unique=%d\n", count, n_unique);
-    fprintf(stderr, "DEBUG decode: alphabet_freqs: ");
-    for (int i = 0; i < n_unique && i < 5; i++) {
-        fprintf(stderr, "%u ", alphabet_freqs[i]);
+    *count_out = count;
+    return 0;
+}
+
+int sparse_phase2_decode_coder_ctx(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                                   int8_t *vector, size_t dimension,
+                                   sparse_phase2_coder_t coder) {
+    if (!ctx || !encoded || !encoded->data || !vector) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
+
+    memset(vector, 0, dimension * sizeof(int8_t));
+    uint32_t count;
+    if (decode_coder_list(ctx, encoded, dimension, coder, ctx->positions, ctx->values,
+                          ctx->capacity, &count) < 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        vector[ctx->positions[i]] = ctx->values[i];
     }
-    fprintf(stderr, "\n");
+    return 0;
+}
 
-    rans_decoder_t rans;
-    if (rans_init_decoder(&rans, alphabet_freqs, n_unique, &br) < 0) {
-        fprintf(stderr, "DEBUG decode: rans_init_decoder failed\n");
-        free(positions);
+int sparse_phase2_decode_coder_sparse_ctx(sparse_codec_ctx_t *ctx,
+                                          const sparse_phase2_t *encoded,
+                                          sparse_vector_t *out, sparse_phase2_coder_t coder) {
+    if (!ctx || !encoded || !encoded->data || !out || !out->indices || !out->values) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
+
+    uint32_t count;
+    if (decode_coder_list(ctx, encoded, out->dimension, coder, out->indices, out->values,
+                          sparse_vector_room(out, encoded->count), &count) < 0) {
         return -1;
     }
-    fprintf(stderr, "DEBUG decode: Initial state = 0x%08x, total=%u\n", rans.state, rans.total);
+    out->count = (uint16_t)count;
+    return 0;
+}
 
-    for (uint32_t i = 0; i < count; i++) {
-        int sym_idx;
-        int is_last = (i == count - 1);  /* Skip renorm on last symbol */
-        fprintf(stderr, "DEBUG decode [%u]: state=0x%08x ", i, rans.state);
-        if (rans_decode_symbol(&rans, &sym_idx, is_last) < 0) {
-            fprintf(stderr, "FAILED\n");
-            rans_free_decoder(&rans);
-            free(positions);
-            return -1;
+/*
+ * Dictionary mode: the alphabet and frequencies come from a shared
+ * dictionary, so the stream is
+ *
+ *     count(16), dictionary ID(4), Rice parameter(3)
+ *     Rice gaps, the first from position -1
+ *     escape flag(1); if set, escape count(16) and 8 bits per escape
+ *     values against the dictionary's tables, as in the coders above
+ */
+sparse_phase2_t* sparse_phase2_encode_dict(const int8_t *vector, size_t dimension,
+                                           const sparse_dict_t *dict,
+                                           sparse_phase2_coder_t coder) {
+    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+
+    size_t max_size;
+    sparse_phase2_t *result = alloc_result(vector, dimension, &max_size);
+    if (!result) return NULL;
+    if (sparse_phase2_encode_dict_into(vector, dimension, dict, coder, result->data, max_size,
+                                       &result->size) < 0) {
+        sparse_phase2_free(result);
+        return NULL;
+    }
+    return result;
+}
+
+int sparse_phase2_encode_dict_into(const int8_t *vector, size_t dimension,
+                                   const sparse_dict_t *dict, sparse_phase2_coder_t coder,
+                                   uint8_t *out, size_t out_cap, size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_encode_dict_ctx(ctx, vector, dimension, dict, coder,
+                                            out, out_cap, written);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_phase2_encode_dict_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                  size_t dimension, const sparse_dict_t *dict,
+                                  sparse_phase2_coder_t coder,
+                                  uint8_t *out, size_t out_cap, size_t *written) {
+    if (!ctx || !vector) return -1;
+    if (dimension == 0 || dimension > ctx->capacity) return -1;
+
+    size_t count = sparse_scan(vector, dimension, ctx->positions, ctx->values, NULL);
+    return sparse_phase2_encode_dict_list_ctx(ctx, ctx->positions, ctx->values, count,
+                                              dimension, dict, coder, out, out_cap, written);
+}
+
+int sparse_phase2_encode_dict_list_ctx(sparse_codec_ctx_t *ctx, const uint16_t *positions,
+                                       const int8_t *vals, size_t n_nonzeros,
+                                       size_t dimension, const sparse_dict_t *dict,
+                                       sparse_phase2_coder_t coder,
+                                       uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!ctx || (n_nonzeros > 0 && (!positions || !vals)) || !dict || !out || !written) {
+        return -1;
+    }
+    if (dimension == 0 || dimension > ctx->capacity || n_nonzeros > dimension) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
+    if (n_nonzeros > 0 && positions[n_nonzeros - 1] >= dimension) return -1;
+
+    uint8_t *syms = ctx->symbols;
+    int8_t *escapes = ctx->values;
+
+    /* Dictionary symbols; values it lacks go to the escape, packed down
+     * (in place when vals is ctx->values) */
+    const uint16_t count = (uint16_t)n_nonzeros;
+    uint16_t n_escapes = 0;
+    for (uint16_t j = 0; j < count; j++) {
+        uint8_t sym = dict->index[SPARSE_SCAN_BIN(vals[j])];
+        if (sym == dict->n_values) {
+            escapes[n_escapes++] = vals[j];
+        }
+        syms[j] = sym;
+    }
+
+    uint8_t r = count > 0 && dimension / count < 16 ? 3 : 4;
+
+    bit_writer_t bw;
+    bw_init(&bw, out, out_cap);
+    if (bw_write_bits(&bw, count, 16) < 0) goto error;
+    if (bw_write_bits(&bw, dict->id, SPARSE_DICT_ID_BITS) < 0) goto error;
+    if (count == 0) {
+        *written = bw_finish(&bw);
+        return 0;
+    }
+    if (bw_write_bits(&bw, r, 3) < 0) goto error;
+
+    int prev = -1;
+    for (uint16_t i = 0; i < count; i++) {
+        if (positions[i] <= prev) goto error;
+        if (bw_write_rice(&bw, (uint32_t)(positions[i] - prev - 1), r) < 0) goto error;
+        prev = positions[i];
+    }
+
+    if (bw_write_bit(&bw, n_escapes > 0) < 0) goto error;
+    if (n_escapes > 0) {
+        if (bw_write_bits(&bw, n_escapes, 16) < 0) goto error;
+        for (uint16_t i = 0; i < n_escapes; i++) {
+            if (bw_write_bits(&bw, (uint8_t)(escapes[i] + 128), 8) < 0) goto error;
+        }
+    }
+
+    if (coder == SPARSE_PHASE2_TANS) {
+        if (tans_encode(&dict->tans, syms, count, ctx->positions, &bw) < 0) goto error;
+        *written = bw_finish(&bw);
+    } else {
+        bw_align(&bw);
+        size_t header_bytes = bw_finish(&bw);
+        size_t rans_bytes = rans_encode(&dict->rans, rans_lanes_for(count), syms, count,
+                                        out + header_bytes, out_cap - header_bytes);
+        if (rans_bytes == 0) goto error;
+        *written = header_bytes + rans_bytes;
+    }
+    return 0;
+
+error:
+    return -1;
+}
+
+int sparse_phase2_decode_dict(const sparse_phase2_t *encoded,
+                              int8_t *vector, size_t dimension,
+                              const sparse_dict_t *dict,
+                              sparse_phase2_coder_t coder) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_decode_dict_ctx(ctx, encoded, vector, dimension, dict, coder);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_phase2_decode_dict_sparse(const sparse_phase2_t *encoded, sparse_vector_t *out,
+                                     const sparse_dict_t *dict,
+                                     sparse_phase2_coder_t coder) {
+    if (!out) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(out->dimension);
+    if (!ctx) return -1;
+    int ret = sparse_phase2_decode_dict_sparse_ctx(ctx, encoded, out, dict, coder);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+/* As decode_coder_list(); escapes go through ctx->values, so values may be
+ * ctx->symbols (each symbol is read before its value is written) but not
+ * ctx->values */
+static int decode_dict_list(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                            size_t dimension, const sparse_dict_t *dict,
+                            sparse_phase2_coder_t coder, uint16_t *positions, int8_t *values,
+                            size_t capacity, uint32_t *count_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
+    *count_out = 0;
+
+    bit_reader_t br;
+    br_init(&br, encoded->data, encoded->size);
+
+    uint32_t count, id;
+    if (br_read_bits(&br, 16, &count) < 0) return -1;
+    if (br_read_bits(&br, SPARSE_DICT_ID_BITS, &id) < 0) return -1;
+    if (!dict) dict = sparse_dict_builtin((uint8_t)id);
+    if (!dict || dict->id != id) return -1;
+
+    if (count == 0) return 0;
+    if (count > dimension || count > capacity || count > ctx->capacity) return -1;
+
+    uint32_t r;
+    if (br_read_bits(&br, 3, &r) < 0) return -1;
+
+    uint8_t *syms = ctx->symbols;
+    uint8_t *escapes = (uint8_t *)ctx->values;
+    int rc = 0;
+
+    size_t pos = (size_t)-1;
+    for (uint32_t i = 0; rc == 0 && i < count; i++) {
+        uint32_t gap;
+        rc = br_read_rice(&br, r, (uint32_t)(dimension >> r), &gap);
+        pos += (size_t)gap + 1;
+        if (rc == 0 && pos >= dimension) rc = -1;
+        if (rc == 0) positions[i] = (uint16_t)pos;
+    }
+
+    uint32_t n_escapes = 0;
+    if (rc == 0) {
+        int flag = br_read_bit(&br);
+        rc = flag < 0 ? -1 : 0;
+        if (flag > 0) {
+            rc = br_read_bits(&br, 16, &n_escapes);
+            if (rc == 0 && (n_escapes == 0 || n_escapes > count)) rc = -1;
+            for (uint32_t i = 0; rc == 0 && i < n_escapes; i++) {
+                uint32_t v = 0;
+                rc = br_read_bits(&br, 8, &v);
+                escapes[i] = (uint8_t)v;
+            }
+        }
+    }
+
+    if (rc == 0 && coder == SPARSE_PHASE2_TANS) {
+        rc = tans_decode(&dict->tans, &br, syms, count);
+        if (rc == 0 && br_bytes_left(&br) != 0) rc = -1;
+    } else if (rc == 0) {
+        br_align(&br);
+        size_t offset = br_tell(&br) / 8;
+        rc = rans_decode(&dict->rans, rans_lanes_for(count), encoded->data + offset,
+                         encoded->size - offset, syms, count);
+    }
+
+    /* Every escape used, none of them zero */
+    uint32_t e = 0;
+    for (uint32_t i = 0; rc == 0 && i < count; i++) {
+        if (syms[i] < dict->n_values) {
+            values[i] = dict->values[syms[i]];
+        } else if (e < n_escapes && escapes[e] != 128) {
+            values[i] = (int8_t)(escapes[e++] - 128);
+        } else {
+            rc = -1;
         }
-        fprintf(stderr, "-> sym=%d (val=%d), new_state=0x%08x\n",
-                sym_idx, alphabet[sym_idx], rans.state);
-        vector[positions[i]] = alphabet[sym_idx];
     }
+    if (rc == 0 && e != n_escapes) rc = -1;
+
+    if (rc == 0) *count_out = count;
+    return rc;
+}
 
-    fprintf(stderr, "=== DECODE RENORM TOTAL: %d bytes ===\n", g_decode_renorm_count);
+int sparse_phase2_decode_dict_ctx(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                                  int8_t *vector, size_t dimension,
+                                  const sparse_dict_t *dict,
+                                  sparse_phase2_coder_t coder) {
+    if (!ctx || !encoded || !encoded->data || !vector) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
+
+    memset(vector, 0, dimension * sizeof(int8_t));
+    int8_t *values = (int8_t *)ctx->symbols;
+    uint32_t count;
+    if (decode_dict_list(ctx, encoded, dimension, dict, coder, ctx->positions, values,
+                         ctx->capacity, &count) < 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        vector[ctx->positions[i]] = values[i];
+    }
+    return 0;
+}
 
-    rans_free_decoder(&rans);
+int sparse_phase2_decode_dict_sparse_ctx(sparse_codec_ctx_t *ctx,
+                                         const sparse_phase2_t *encoded,
+                                         sparse_vector_t *out, const sparse_dict_t *dict,
+                                         sparse_phase2_coder_t coder) {
+    if (!ctx || !encoded || !encoded->data || !out || !out->indices || !out->values) return -1;
+    if (coder != SPARSE_PHASE2_RANS && coder != SPARSE_PHASE2_TANS) return -1;
 
-    free(positions);
+    uint32_t count;
+    if (decode_dict_list(ctx, encoded, out->dimension, dict, coder, out->indices, out->values,
+                         sparse_vector_room(out, encoded->count), &count) < 0) {
+        return -1;
+    }
+    out->count = (uint16_t)count;
     return 0;
 }
 
@@ -3,7 +3,7 @@
  *
  * Phase 2 optimization: Delta alphabet + ANS for values
  * - Rice coding for position gaps
- * - rANS (Asymmetric Numeral Systems) for values
+ * - Interleaved rANS (Asymmetric Numeral Systems) for values
  * - Delta-encoded alphabet
  * Target: ~162 bytes for 97 nz vectors (vs 167 baseline)
  */
@@ -13,6 +13,9 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "sparse_dict.h"
+#include "sparse_codec_ctx.h"
+#include "sparse_vector.h"
 
 typedef struct {
     uint8_t *data;
@@ -20,18 +23,156 @@ typedef struct {
     uint16_t count;
 } sparse_phase2_t;
 
+/**
+ * Value coder after the shared header and position gaps
+ *
+ * The stream does not record it: decode with the coder that encoded.
+ */
+typedef enum {
+    SPARSE_PHASE2_RANS = 0,     /* interleaved rANS, byte-aligned (default) */
+    SPARSE_PHASE2_TANS = 1      /* tabled ANS (FSE style), table lookups only */
+} sparse_phase2_coder_t;
+
 /**
  * Encode with delta-alphabet + rANS optimization
  * Target: ~162 bytes for 97 nz vectors
  */
 sparse_phase2_t* sparse_phase2_encode(const int8_t *vector, size_t dimension);
 
+/**
+ * Encode with the given value coder (NULL for an unknown coder)
+ */
+sparse_phase2_t* sparse_phase2_encode_coder(const int8_t *vector, size_t dimension,
+                                            sparse_phase2_coder_t coder);
+
 /**
  * Decode phase2 vector
  */
 int sparse_phase2_decode(const sparse_phase2_t *encoded,
                          int8_t *vector, size_t dimension);
 
+/**
+ * Decode a vector encoded with the given value coder
+ */
+int sparse_phase2_decode_coder(const sparse_phase2_t *encoded,
+                               int8_t *vector, size_t dimension,
+                               sparse_phase2_coder_t coder);
+
+/**
+ * Encode against a shared dictionary (sparse_dict.h)
+ *
+ * The header carries the dictionary's ID in place of the alphabet and
+ * frequency table, and no table is built per vector. Values missing from
+ * the dictionary are escaped and stored in 8 bits.
+ */
+sparse_phase2_t* sparse_phase2_encode_dict(const int8_t *vector, size_t dimension,
+                                           const sparse_dict_t *dict,
+                                           sparse_phase2_coder_t coder);
+
+/**
+ * Decode a dictionary-encoded vector; with dict NULL, against the
+ * built-in dictionary the header names
+ */
+int sparse_phase2_decode_dict(const sparse_phase2_t *encoded,
+                              int8_t *vector, size_t dimension,
+                              const sparse_dict_t *dict,
+                              sparse_phase2_coder_t coder);
+
+/**
+ * Encoders into a caller-provided buffer, with no allocation for the
+ * output; otherwise as the allocating encoders above
+ *
+ * An out_cap of sparse_phase2_max_encoded_size() bytes always suffices;
+ * bytes past *written may be overwritten up to out_cap.
+ *
+ * @param written  Out: bytes used
+ * @return         0, or -1 on bad input or if the encoding does not fit
+ */
+int sparse_phase2_encode_into(const int8_t *vector, size_t dimension,
+                              uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_phase2_encode_coder_into(const int8_t *vector, size_t dimension,
+                                    sparse_phase2_coder_t coder,
+                                    uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_phase2_encode_dict_into(const int8_t *vector, size_t dimension,
+                                   const sparse_dict_t *dict, sparse_phase2_coder_t coder,
+                                   uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * As the encoders into caller buffers and the decoders above, with the
+ * scratch and tables of ctx: no allocation
+ */
+int sparse_phase2_encode_coder_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                   size_t dimension, sparse_phase2_coder_t coder,
+                                   uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_phase2_encode_dict_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                                  size_t dimension, const sparse_dict_t *dict,
+                                  sparse_phase2_coder_t coder,
+                                  uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * As the _ctx encoders, from the nonzeros of a vector instead of the
+ * vector: producers that know them (samplers, sparse_vector_t) skip the
+ * scan. The stream is the one the vector would give.
+ *
+ * @param positions   n_nonzeros positions, strictly ascending, below dimension
+ * @param vals        Their values, nonzero; positions and vals may be
+ *                    ctx->positions and ctx->values, which are then spent
+ * @param hist        Histogram of vals by SPARSE_SCAN_BIN (256 bins), or
+ *                    NULL to count it here
+ * @return            0, or -1 on bad input or if the encoding does not fit
+ */
+int sparse_phase2_encode_coder_list_ctx(sparse_codec_ctx_t *ctx, const uint16_t *positions,
+                                        const int8_t *vals, size_t n_nonzeros,
+                                        const uint32_t *hist, size_t dimension,
+                                        sparse_phase2_coder_t coder,
+                                        uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_phase2_encode_dict_list_ctx(sparse_codec_ctx_t *ctx, const uint16_t *positions,
+                                       const int8_t *vals, size_t n_nonzeros,
+                                       size_t dimension, const sparse_dict_t *dict,
+                                       sparse_phase2_coder_t coder,
+                                       uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_phase2_decode_coder_ctx(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                                   int8_t *vector, size_t dimension,
+                                   sparse_phase2_coder_t coder);
+
+int sparse_phase2_decode_dict_ctx(sparse_codec_ctx_t *ctx, const sparse_phase2_t *encoded,
+                                  int8_t *vector, size_t dimension,
+                                  const sparse_dict_t *dict,
+                                  sparse_phase2_coder_t coder);
+
+/**
+ * As the coder and dictionary decoders and their _ctx forms, into sparse
+ * form (see sparse_vector.h)
+ */
+int sparse_phase2_decode_coder_sparse(const sparse_phase2_t *encoded, sparse_vector_t *out,
+                                      sparse_phase2_coder_t coder);
+
+int sparse_phase2_decode_dict_sparse(const sparse_phase2_t *encoded, sparse_vector_t *out,
+                                     const sparse_dict_t *dict,
+                                     sparse_phase2_coder_t coder);
+
+int sparse_phase2_decode_coder_sparse_ctx(sparse_codec_ctx_t *ctx,
+                                          const sparse_phase2_t *encoded,
+                                          sparse_vector_t *out, sparse_phase2_coder_t coder);
+
+int sparse_phase2_decode_dict_sparse_ctx(sparse_codec_ctx_t *ctx,
+                                         const sparse_phase2_t *encoded,
+                                         sparse_vector_t *out, const sparse_dict_t *dict,
+                                         sparse_phase2_coder_t coder);
+
+/**
+ * Worst-case encoded size of k nonzeros in dimension, for either coder,
+ * with or without a dictionary
+ *
+ * @return  Bytes, or 0 if dimension or k is out of range
+ */
+size_t sparse_phase2_max_encoded_size(size_t dimension, size_t k);
+
 /**
  * Free encoded result
  */
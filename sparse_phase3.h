@@ -13,6 +13,8 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "sparse_codec_ctx.h"
+#include "sparse_vector.h"
 
 typedef struct {
     uint8_t *data;
@@ -26,12 +28,51 @@ typedef struct {
  */
 sparse_phase3_t* sparse_phase3_encode(const int8_t *vector, size_t dimension);
 
+/**
+ * Encode into a caller-provided buffer, with no allocation for the output
+ *
+ * An out_cap of sparse_phase3_max_encoded_size() bytes always suffices;
+ * bytes past *written may be overwritten up to out_cap.
+ *
+ * @param written  Out: bytes used
+ * @return         0, or -1 on bad input or if the encoding does not fit
+ */
+int sparse_phase3_encode_into(const int8_t *vector, size_t dimension,
+                              uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case encoded size of k nonzeros in dimension
+ *
+ * @return  Bytes, or 0 if dimension or k is out of range
+ */
+size_t sparse_phase3_max_encoded_size(size_t dimension, size_t k);
+
 /**
  * Decode Phase 3 vector
  */
 int sparse_phase3_decode(const sparse_phase3_t *encoded,
                         int8_t *vector, size_t dimension);
 
+/**
+ * As sparse_phase3_encode_into() and sparse_phase3_decode(), with the scratch
+ * and tables of ctx: no allocation
+ */
+int sparse_phase3_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                             size_t dimension, uint8_t *out, size_t out_cap,
+                             size_t *written);
+
+int sparse_phase3_decode_ctx(sparse_codec_ctx_t *ctx, const sparse_phase3_t *encoded,
+                             int8_t *vector, size_t dimension);
+
+/**
+ * As sparse_phase3_decode() and its _ctx form, into sparse form (see
+ * sparse_vector.h)
+ */
+int sparse_phase3_decode_sparse(const sparse_phase3_t *encoded, sparse_vector_t *out);
+
+int sparse_phase3_decode_sparse_ctx(sparse_codec_ctx_t *ctx, const sparse_phase3_t *encoded,
+                                    sparse_vector_t *out);
+
 /**
  * Free encoded result
  */
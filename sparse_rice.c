@@ -9,121 +9,14 @@
  */
 
 #include "sparse_rice.h"
+#include "bitstream.h"
+#include "dntl_stats.h"
+#include "sparse_scan.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* Bit writer */
-typedef struct {
-    uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t capacity;
-} bit_writer_t;
-
-static void bw_init(bit_writer_t *bw, uint8_t *buffer, size_t capacity) {
-    bw->buffer = buffer;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-    bw->capacity = capacity;
-}
-
-static int bw_write_bit(bit_writer_t *bw, uint8_t bit) {
-    if (bw->byte_pos >= bw->capacity) return -1;
-
-    if (bit) {
-        bw->buffer[bw->byte_pos] |= (1 << (7 - bw->bit_pos));
-    }
-    bw->bit_pos++;
-    if (bw->bit_pos == 8) {
-        bw->bit_pos = 0;
-        bw->byte_pos++;
-    }
-    return 0;
-}
-
-static int bw_write_bits(bit_writer_t *bw, uint32_t value, uint8_t num_bits) {
-    for (int i = num_bits - 1; i >= 0; i--) {
-        if (bw_write_bit(bw, (value >> i) & 1) < 0) return -1;
-    }
-    return 0;
-}
-
-/* Write Rice code: quotient in unary, remainder in r bits */
-static int bw_write_rice(bit_writer_t *bw, uint32_t value, uint8_t r) {
-    uint32_t q = value >> r;
-    uint32_t rem = value & ((1 << r) - 1);
-
-    /* Write q ones */
-    for (uint32_t i = 0; i < q; i++) {
-        if (bw_write_bit(bw, 1) < 0) return -1;
-    }
-    /* Write terminating zero */
-    if (bw_write_bit(bw, 0) < 0) return -1;
-
-    /* Write remainder */
-    return bw_write_bits(bw, rem, r);
-}
-
-static size_t bw_finish(bit_writer_t *bw) {
-    return bw->byte_pos + (bw->bit_pos > 0 ? 1 : 0);
-}
-
-/* Bit reader */
-typedef struct {
-    const uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t size;
-} bit_reader_t;
-
-static void br_init(bit_reader_t *br, const uint8_t *buffer, size_t size) {
-    br->buffer = buffer;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-    br->size = size;
-}
-
-static int br_read_bit(bit_reader_t *br) {
-    if (br->byte_pos >= br->size) return -1;
-
-    int bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-    br->bit_pos++;
-    if (br->bit_pos == 8) {
-        br->bit_pos = 0;
-        br->byte_pos++;
-    }
-    return bit;
-}
-
-static int br_read_bits(bit_reader_t *br, uint8_t num_bits, uint32_t *out) {
-    uint32_t value = 0;
-    for (uint8_t i = 0; i < num_bits; i++) {
-        int bit = br_read_bit(br);
-        if (bit < 0) return -1;
-        value = (value << 1) | bit;
-    }
-    *out = value;
-    return 0;
-}
-
-/* Read Rice code */
-static int br_read_rice(bit_reader_t *br, uint8_t r, uint32_t *out) {
-    /* Count ones until we hit a zero */
-    uint32_t q = 0;
-    int bit;
-    while ((bit = br_read_bit(br)) == 1) {
-        q++;
-        if (q > 1000) return -1;  /* Sanity check */
-    }
-    if (bit < 0) return -1;
-
-    /* Read remainder */
-    uint32_t rem;
-    if (br_read_bits(br, r, &rem) < 0) return -1;
-
-    *out = (q << r) | rem;
-    return 0;
-}
+/* Sanity bound on unary quotients when decoding */
+#define MAX_RICE_QUOTIENT 1000
 
 /* Huffman codes for 70% ±2, 30% ±1 distribution */
 /* Optimal codes: -2:0, +2:10, -1:110, +1:111 */
@@ -138,76 +31,52 @@ static int encode_value_huffman(bit_writer_t *bw, int8_t val) {
 }
 
 static int decode_value_huffman(bit_reader_t *br, int8_t *val) {
-    int bit = br_read_bit(br);
-    if (bit < 0) return -1;
-
-    if (bit == 0) {
-        *val = -2;
-        return 0;
-    }
-
-    /* Read second bit */
-    bit = br_read_bit(br);
-    if (bit < 0) return -1;
+    /* All four codes by their first 3 bits: 0xx, 10x, 110, 111 */
+    static const int8_t values[8] = { -2, -2, -2, -2, 2, 2, -1, 1 };
+    static const uint8_t lengths[8] = { 1, 1, 1, 1, 2, 2, 3, 3 };
+
+    const unsigned w = (unsigned)br_peek(br, 3);
+    if (lengths[w] > br->n) return -1;
+    br_skip(br, lengths[w]);
+    *val = values[w];
+    return 0;
+}
 
-    if (bit == 0) {
-        *val = 2;
+size_t sparse_rice_max_encoded_size(size_t dimension, size_t k) {
+    if (dimension == 0 || dimension > 65535 || k > dimension) {
         return 0;
     }
+    /* Header 30 bits; gaps sum below dimension, so the unary parts of their
+     * r = 4 Rice codes total at most dimension >> 4; values take <= 3 bits */
+    size_t bits = 30 + 8 * k + (dimension >> 4);
+    return (bits + 7) / 8;
+}
 
-    /* Read third bit */
-    bit = br_read_bit(br);
-    if (bit < 0) return -1;
-
-    *val = (bit == 0) ? -1 : 1;
-    return 0;
+int sparse_rice_encode_into(const int8_t *vector, size_t dimension,
+                            uint8_t *out, size_t out_cap, size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_rice_encode_ctx(ctx, vector, dimension, out, out_cap, written);
+    sparse_codec_ctx_free(ctx);
+    return ret;
 }
 
-sparse_rice_t* sparse_rice_encode(const int8_t *vector, size_t dimension) {
-    if (!vector || dimension == 0 || dimension > 65535) {
-        return NULL;
+int sparse_rice_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                           uint8_t *out, size_t out_cap, size_t *written) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_ENCODE);
+    if (!ctx || !vector || !out || !written || dimension == 0 || dimension > ctx->capacity) {
+        return -1;
     }
 
     /* Find positions and count */
-    uint16_t *positions = malloc(dimension * sizeof(uint16_t));
-    int8_t *values = malloc(dimension * sizeof(int8_t));
-    if (!positions || !values) {
-        free(positions);
-        free(values);
-        return NULL;
-    }
+    uint16_t *positions = ctx->positions;
+    int8_t *values = ctx->values;
 
-    uint16_t count = 0;
-    for (size_t i = 0; i < dimension; i++) {
-        if (vector[i] != 0) {
-            positions[count] = i;
-            values[count] = vector[i];
-            count++;
-        }
-    }
-
-    /* Allocate result */
-    sparse_rice_t *result = malloc(sizeof(sparse_rice_t));
-    if (!result) {
-        free(positions);
-        free(values);
-        return NULL;
-    }
-
-    /* Allocate buffer (conservative estimate) */
-    size_t max_size = 2 + count * 8;  /* Header + conservative estimate */
-    result->data = calloc(max_size, 1);
-    if (!result->data) {
-        free(result);
-        free(positions);
-        free(values);
-        return NULL;
-    }
-    result->count = count;
+    uint16_t count = (uint16_t)sparse_scan(vector, dimension, positions, values, NULL);
 
     /* Encode */
     bit_writer_t bw;
-    bw_init(&bw, result->data, max_size);
+    bw_init(&bw, out, out_cap);
 
     /* Write count (16 bits) */
     if (bw_write_bits(&bw, count, 16) < 0) goto error;
@@ -234,25 +103,59 @@ sparse_rice_t* sparse_rice_encode(const int8_t *vector, size_t dimension) {
         if (encode_value_huffman(&bw, values[i]) < 0) goto error;
     }
 
-    result->size = bw_finish(&bw);
-    free(positions);
-    free(values);
-    return result;
+    *written = bw_finish(&bw);
+    return 0;
 
 error:
-    free(result->data);
-    free(result);
-    free(positions);
-    free(values);
-    return NULL;
+    return -1;
 }
 
-int sparse_rice_decode(const sparse_rice_t *encoded, int8_t *vector, size_t dimension) {
-    if (!encoded || !encoded->data || !vector) {
-        return -1;
+sparse_rice_t* sparse_rice_encode(const int8_t *vector, size_t dimension) {
+    if (!vector || dimension == 0 || dimension > 65535) {
+        return NULL;
     }
 
-    memset(vector, 0, dimension * sizeof(int8_t));
+    size_t count = sparse_scan_count(vector, dimension);
+
+    sparse_rice_t *result = malloc(sizeof(sparse_rice_t));
+    if (!result) return NULL;
+
+    size_t max_size = sparse_rice_max_encoded_size(dimension, count);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        sparse_rice_encode_into(vector, dimension, result->data, max_size, &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
+    }
+    result->count = (uint16_t)count;
+    return result;
+}
+
+int sparse_rice_decode(const sparse_rice_t *encoded, int8_t *vector, size_t dimension) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_rice_decode_ctx(ctx, encoded, vector, dimension);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_rice_decode_sparse(const sparse_rice_t *encoded, sparse_vector_t *out) {
+    if (!out) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(out->dimension);
+    if (!ctx) return -1;
+    int ret = sparse_rice_decode_sparse_ctx(ctx, encoded, out);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+/* Positions and values of the nonzeros into lists of capacity entries,
+ * for the dense and the sparse decoders */
+static int decode_list(const sparse_rice_t *encoded, size_t dimension,
+                       uint16_t *positions, int8_t *values, size_t capacity,
+                       uint32_t *count_out) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
+    *count_out = 0;
 
     bit_reader_t br;
     br_init(&br, encoded->data, encoded->size);
@@ -274,38 +177,59 @@ int sparse_rice_decode(const sparse_rice_t *encoded, int8_t *vector, size_t dime
     }
 
     /* Read positions using gaps */
-    uint16_t *positions = malloc(count * sizeof(uint16_t));
-    if (!positions) return -1;
+    if (count > capacity) return -1;
 
     if (count > 0) {
         positions[0] = pos;
 
         for (uint16_t i = 1; i < count; i++) {
             uint32_t gap;
-            if (br_read_rice(&br, r, &gap) < 0) {
-                free(positions);
-                return -1;
-            }
+            if (br_read_rice(&br, r, MAX_RICE_QUOTIENT, &gap) < 0) return -1;
             pos = pos + gap + 1;
-            if (pos >= dimension) {
-                free(positions);
-                return -1;
-            }
+            if (pos >= dimension) return -1;
             positions[i] = pos;
         }
     }
 
     /* Read values using Huffman */
     for (uint16_t i = 0; i < count; i++) {
-        int8_t val;
-        if (decode_value_huffman(&br, &val) < 0) {
-            free(positions);
-            return -1;
-        }
-        vector[positions[i]] = val;
+        if (decode_value_huffman(&br, &values[i]) < 0) return -1;
+    }
+
+    *count_out = count;
+    return 0;
+}
+
+int sparse_rice_decode_ctx(sparse_codec_ctx_t *ctx, const sparse_rice_t *encoded,
+                           int8_t *vector, size_t dimension) {
+    if (!ctx || !encoded || !encoded->data || !vector) {
+        return -1;
+    }
+
+    memset(vector, 0, dimension * sizeof(int8_t));
+    uint32_t count;
+    if (decode_list(encoded, dimension, ctx->positions, ctx->values, ctx->capacity,
+                    &count) < 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        vector[ctx->positions[i]] = ctx->values[i];
+    }
+    return 0;
+}
+
+int sparse_rice_decode_sparse_ctx(sparse_codec_ctx_t *ctx, const sparse_rice_t *encoded,
+                                  sparse_vector_t *out) {
+    if (!ctx || !encoded || !encoded->data || !out || !out->indices || !out->values) {
+        return -1;
     }
 
-    free(positions);
+    uint32_t count;
+    if (decode_list(encoded, out->dimension, out->indices, out->values,
+                    sparse_vector_room(out, encoded->count), &count) < 0) {
+        return -1;
+    }
+    out->count = (uint16_t)count;
     return 0;
 }
 
@@ -315,3 +239,132 @@ void sparse_rice_free(sparse_rice_t *encoded) {
         free(encoded);
     }
 }
+
+/* ========== Streaming decode ========== */
+
+enum {
+    STREAM_HEADER,      /* count and Rice parameter */
+    STREAM_FIRST,       /* first position */
+    STREAM_GAPS,
+    STREAM_VALUES,
+    STREAM_DONE,
+    STREAM_FAILED
+};
+
+int sparse_rice_stream_init(sparse_rice_stream_t *st, sparse_vector_t *out) {
+    if (!st || !out || !out->indices || !out->values) return -1;
+    memset(st, 0, sizeof(*st));
+    st->out = out;
+    st->stage = STREAM_HEADER;
+    out->count = 0;
+    return 0;
+}
+
+/* Quotient of the current gap, resumed across chunks: 0 when the run of
+ * ones has ended, 1 if the chunk ran out first, -1 past MAX_RICE_QUOTIENT */
+static int stream_quotient(sparse_rice_stream_t *st, bit_reader_t *br) {
+    for (;;) {
+        if (br->n < BITSTREAM_MAX_BITS) br_refill(br);
+        if (br->n == 0) return 1;
+
+        const uint64_t inv = ~br->acc;
+        const unsigned run = inv ? (unsigned)__builtin_clzll(inv) : 64;
+        if (run < br->n) {
+            st->q += run;
+            br_skip(br, run + 1);
+            return st->q > MAX_RICE_QUOTIENT ? -1 : 0;
+        }
+        /* All ones: the bits past n are zero, so acc is emptied */
+        st->q += br->n;
+        br->acc = 0;
+        br->n = 0;
+        if (st->q > MAX_RICE_QUOTIENT) return -1;
+    }
+}
+
+/* One step of the decoder: 0 to go on, 1 if the chunk ran out, -1 on error */
+static int stream_step(sparse_rice_stream_t *st, bit_reader_t *br) {
+    sparse_vector_t *out = st->out;
+    const uint32_t bound = out->dimension ? out->dimension : 65536;
+    uint32_t v;
+
+    switch (st->stage) {
+    case STREAM_HEADER:
+        if (br->n < 19) br_refill(br);
+        if (br->n < 19) return 1;
+        br_read_bits(br, 16, &st->count);
+        br_read_bits(br, 3, &st->r);
+        if (st->count > sparse_vector_room(out, (uint16_t)st->count)) return -1;
+        st->stage = st->count ? STREAM_FIRST : STREAM_DONE;
+        return 0;
+
+    case STREAM_FIRST:
+        if (br_read_bits(br, 11, &v) < 0) return 1;
+        if (v >= bound) return -1;
+        st->pos = v;
+        out->indices[st->known++] = (uint16_t)v;
+        st->stage = st->known < st->count ? STREAM_GAPS : STREAM_VALUES;
+        return 0;
+
+    case STREAM_GAPS:
+        if (!st->have_quotient) {
+            const int ret = stream_quotient(st, br);
+            if (ret != 0) return ret;
+            st->have_quotient = 1;
+        }
+        if (br_read_bits(br, st->r, &v) < 0) return 1;
+        st->pos += ((st->q << st->r) | v) + 1;
+        st->q = 0;
+        st->have_quotient = 0;
+        if (st->pos >= bound) return -1;
+        out->indices[st->known++] = (uint16_t)st->pos;
+        if (st->known == st->count) st->stage = STREAM_VALUES;
+        return 0;
+
+    case STREAM_VALUES:
+        /* Needs only the bits of the code, which may end the stream */
+        if (decode_value_huffman(br, &out->values[out->count]) < 0) return 1;
+        if (++out->count == st->count) st->stage = STREAM_DONE;
+        return 0;
+
+    default:
+        return 1;
+    }
+}
+
+int sparse_rice_stream_push(sparse_rice_stream_t *st, const uint8_t *chunk, size_t len,
+                            size_t *used) {
+    DNTL_STAT_SCOPE(DNTL_STAT_SPARSE_DECODE);
+    *used = 0;
+    if (st->stage == STREAM_FAILED) return -1;
+    if (st->stage == STREAM_DONE) return 1;
+    if (!chunk && len) return -1;
+
+    bit_reader_t br;
+    br_init(&br, chunk, len);
+    br.acc = st->acc;
+    br.n = st->n;
+
+    int ret = 0;
+    while (st->stage != STREAM_DONE && ret == 0) {
+        ret = stream_step(st, &br);
+    }
+    /* Running out of input always means the whole chunk is in acc */
+    st->bytes_in += br.byte_pos;
+    st->acc = br.acc;
+    st->n = br.n;
+    if (ret < 0) {
+        st->stage = STREAM_FAILED;
+        return -1;
+    }
+    if (st->stage != STREAM_DONE) {
+        *used = len;
+        return 0;
+    }
+
+    /* The stream ends on a byte boundary; whole bytes left in acc were read
+     * ahead from this chunk */
+    const size_t stream_bytes = (st->bytes_in * 8 - st->n + 7) / 8;
+    *used = br.byte_pos - (st->bytes_in - stream_bytes);
+    return 1;
+}
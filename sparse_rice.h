@@ -13,6 +13,8 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "sparse_codec_ctx.h"
+#include "sparse_vector.h"
 
 typedef struct {
     uint8_t *data;
@@ -25,14 +27,108 @@ typedef struct {
  */
 sparse_rice_t* sparse_rice_encode(const int8_t *vector, size_t dimension);
 
+/**
+ * Encode into a caller-provided buffer, with no allocation for the output
+ *
+ * An out_cap of sparse_rice_max_encoded_size() bytes always suffices; bytes
+ * past *written may be overwritten up to out_cap.
+ *
+ * @param written  Out: bytes used
+ * @return         0, or -1 on bad input or if the encoding does not fit
+ */
+int sparse_rice_encode_into(const int8_t *vector, size_t dimension,
+                            uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case encoded size of k nonzeros in dimension
+ *
+ * @return  Bytes, or 0 if dimension or k is out of range
+ */
+size_t sparse_rice_max_encoded_size(size_t dimension, size_t k);
+
 /**
  * Decode Rice-encoded sparse vector
  */
 int sparse_rice_decode(const sparse_rice_t *encoded, int8_t *vector, size_t dimension);
 
+/**
+ * As sparse_rice_encode_into() and sparse_rice_decode(), with the scratch
+ * and tables of ctx: no allocation
+ */
+int sparse_rice_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector, size_t dimension,
+                           uint8_t *out, size_t out_cap, size_t *written);
+
+int sparse_rice_decode_ctx(sparse_codec_ctx_t *ctx, const sparse_rice_t *encoded,
+                           int8_t *vector, size_t dimension);
+
+/**
+ * As sparse_rice_decode() and its _ctx form, into sparse form (see
+ * sparse_vector.h)
+ */
+int sparse_rice_decode_sparse(const sparse_rice_t *encoded, sparse_vector_t *out);
+
+int sparse_rice_decode_sparse_ctx(sparse_codec_ctx_t *ctx, const sparse_rice_t *encoded,
+                                  sparse_vector_t *out);
+
 /**
  * Free encoded result
  */
 void sparse_rice_free(sparse_rice_t *encoded);
 
+/* ========== Streaming decode ========== */
+
+/**
+ * Resumable decoder of one stream that arrives in pieces (TCP segments)
+ *
+ * Chunks are decoded where they lie: the only input kept between calls is
+ * the bits of a code cut by the end of a chunk, in a 64-bit accumulator,
+ * so no reassembly buffer is needed. The output is a sparse_vector_t as
+ * for sparse_rice_decode_sparse(): out->dimension bounds the positions (0
+ * for no bound), out->indices and out->values hold
+ * sparse_vector_room(out, count) entries. The stream stores every gap before
+ * the first value, so positions are final as the gaps arrive
+ * (out->indices[0 .. known)) and a nonzero is complete once its value
+ * has arrived (out->indices and out->values [0 .. out->count)).
+ *
+ * Usage:
+ *   sparse_rice_stream_t st;
+ *   sparse_rice_stream_init(&st, out);
+ *   while ((ret = sparse_rice_stream_push(&st, seg, seg_len, &used)) == 0) {
+ *       // nonzeros up to out->count are decoded; receive the next segment
+ *   }
+ *   // ret 1: bytes past seg + used belong to whatever follows the stream
+ */
+typedef struct {
+    sparse_vector_t *out;
+    uint64_t acc;           /* bits carried between chunks, left-aligned */
+    unsigned n;             /* bits in acc */
+    uint8_t stage;
+    uint8_t have_quotient;  /* gap quotient read, remainder pending */
+    uint32_t count, r, q, pos;
+    uint16_t known;         /* positions decoded */
+    size_t bytes_in;        /* bytes taken from the chunks so far */
+} sparse_rice_stream_t;
+
+/**
+ * Start decoding a stream into out
+ *
+ * out->count is reset; nothing is allocated.
+ *
+ * @return  0, or -1 if out or its arrays are NULL
+ */
+int sparse_rice_stream_init(sparse_rice_stream_t *st, sparse_vector_t *out);
+
+/**
+ * Decode as much of the stream as the next len bytes complete
+ *
+ * @param used  Out: bytes of chunk that belong to the stream; all of them
+ *              unless it returns 1
+ * @return      1 if the vector is complete, 0 if more input is needed
+ *              (chunk may be released), or -1 on a malformed stream or a
+ *              count past the room of out; a finished or failed stream
+ *              returns the same again
+ */
+int sparse_rice_stream_push(sparse_rice_stream_t *st, const uint8_t *chunk, size_t len,
+                            size_t *used);
+
 #endif /* SPARSE_RICE_H */
@@ -0,0 +1,142 @@
+/**
+ * sparse_scan.h
+ *
+ * Nonzero scan shared by the sparse_* encoders
+ * - (position, value) list of the nonzeros, in order
+ * - Value histogram of the nonzeros (histogram.h)
+ * - AVX2: 32 bytes per compare and movemask; NEON: 16 bytes per compare,
+ *   narrowed to a 64-bit mask; portable: 8-byte words, zero words skipped
+ */
+
+#ifndef SPARSE_SCAN_H
+#define SPARSE_SCAN_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "histogram.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// ============================================================================
+// NONZERO SCAN
+// ============================================================================
+
+/* Histogram index of a value: value + 128 */
+#define SPARSE_SCAN_BIN(v) ((uint8_t)((v) + 128))
+
+/**
+ * Positions and values of the nonzeros of vector, in order
+ *
+ * The AVX2 and NEON paths are taken in builds for those targets (-mavx2,
+ * any AArch64); their results are the portable path's.
+ *
+ * @param positions  Out: dimension entries suffice
+ * @param values     Out: dimension entries suffice
+ * @param hist       NULL, or 256 counts by SPARSE_SCAN_BIN, added to
+ * @param simd       0: portable path only
+ * @return           Number of nonzeros
+ */
+static inline size_t sparse_scan_ex(const int8_t *vector, size_t dimension,
+                                    uint16_t *positions, int8_t *values,
+                                    uint32_t *hist, int simd) {
+    size_t count = 0, i = 0;
+
+#if defined(__AVX2__)
+    if (simd) {
+        const __m256i zero = _mm256_setzero_si256();
+        for (; i + 32 <= dimension; i += 32) {
+            const __m256i v = _mm256_loadu_si256((const __m256i *)(vector + i));
+            uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero));
+            while (mask) {
+                const size_t at = i + (size_t)__builtin_ctz(mask);
+                positions[count] = (uint16_t)at;
+                values[count++] = vector[at];
+                mask &= mask - 1;
+            }
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    if (simd) {
+        for (; i + 16 <= dimension; i += 16) {
+            // Four bits per byte: 0xF where nonzero
+            const uint8x16_t nz = vtstq_u8(vreinterpretq_u8_s8(vld1q_s8(vector + i)),
+                                           vdupq_n_u8(0xFF));
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+                vshrn_n_u16(vreinterpretq_u16_u8(nz), 4)), 0) & 0x1111111111111111ULL;
+            while (mask) {
+                const size_t at = i + (size_t)(__builtin_ctzll(mask) >> 2);
+                positions[count] = (uint16_t)at;
+                values[count++] = vector[at];
+                mask &= mask - 1;
+            }
+        }
+    }
+#else
+    (void)simd;
+#endif
+
+    // Portable: whole zero words cost one test
+    for (; i + 8 <= dimension; i += 8) {
+        uint64_t w;
+        memcpy(&w, vector + i, 8);
+        if (w == 0) continue;
+        for (size_t j = i; j < i + 8; j++) {
+            if (vector[j] != 0) {
+                positions[count] = (uint16_t)j;
+                values[count++] = vector[j];
+            }
+        }
+    }
+    for (; i < dimension; i++) {
+        if (vector[i] != 0) {
+            positions[count] = (uint16_t)i;
+            values[count++] = vector[i];
+        }
+    }
+    if (hist) hist_add_int8(values, count, hist);
+    return count;
+}
+
+static inline size_t sparse_scan(const int8_t *vector, size_t dimension,
+                                 uint16_t *positions, int8_t *values, uint32_t *hist) {
+    return sparse_scan_ex(vector, dimension, positions, values, hist, 1);
+}
+
+/**
+ * Number of nonzeros of vector, without a list
+ */
+static inline size_t sparse_scan_count(const int8_t *vector, size_t dimension) {
+    size_t count = 0, i = 0;
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 <= dimension; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *)(vector + i));
+        count += 32 - (size_t)__builtin_popcount(
+            (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+    }
+#endif
+    for (; i < dimension; i++) {
+        count += vector[i] != 0;
+    }
+    return count;
+}
+
+/**
+ * Smallest and largest value with a nonzero count in a SPARSE_SCAN_BIN
+ * histogram; min 127 and max -128 if there is none
+ */
+static inline void sparse_scan_range(const uint32_t *hist, int8_t *min, int8_t *max) {
+    int lo = 0, hi = 255;
+    while (lo < 256 && !hist[lo]) lo++;
+    while (hi >= 0 && !hist[hi]) hi--;
+    *min = lo < 256 ? (int8_t)(lo - 128) : 127;
+    *max = hi >= 0 ? (int8_t)(hi - 128) : -128;
+}
+
+#endif /* SPARSE_SCAN_H */
@@ -9,111 +9,20 @@
  */
 
 #include "sparse_ultimate.h"
+#include "bitstream.h"
+#include "sparse_scan.h"
 #include <stdlib.h>
 #include <string.h>
 
-/* Bit writer/reader */
-typedef struct {
-    uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t capacity;
-} bit_writer_t;
-
-typedef struct {
-    const uint8_t *buffer;
-    size_t byte_pos;
-    uint8_t bit_pos;
-    size_t size;
-} bit_reader_t;
-
-static void bw_init(bit_writer_t *bw, uint8_t *buffer, size_t capacity) {
-    bw->buffer = buffer;
-    bw->byte_pos = 0;
-    bw->bit_pos = 0;
-    bw->capacity = capacity;
-}
-
-static int bw_write_bit(bit_writer_t *bw, uint8_t bit) {
-    if (bw->byte_pos >= bw->capacity) return -1;
-    if (bit) bw->buffer[bw->byte_pos] |= (1 << (7 - bw->bit_pos));
-    bw->bit_pos++;
-    if (bw->bit_pos == 8) {
-        bw->bit_pos = 0;
-        bw->byte_pos++;
-    }
-    return 0;
-}
-
-static int bw_write_bits(bit_writer_t *bw, uint32_t value, uint8_t num_bits) {
-    for (int i = num_bits - 1; i >= 0; i--) {
-        if (bw_write_bit(bw, (value >> i) & 1) < 0) return -1;
-    }
-    return 0;
-}
-
-static int bw_write_rice(bit_writer_t *bw, uint32_t value, uint8_t r) {
-    uint32_t q = value >> r;
-    uint32_t rem = value & ((1 << r) - 1);
-
-    /* Limit quotient to prevent overflow */
-    if (q > 255) {
-        q = 255;
-        rem = 0;
-    }
-
-    for (uint32_t i = 0; i < q; i++) {
-        if (bw_write_bit(bw, 1) < 0) return -1;
-    }
-    if (bw_write_bit(bw, 0) < 0) return -1;
-    return bw_write_bits(bw, rem, r);
-}
-
-static size_t bw_finish(bit_writer_t *bw) {
-    return bw->byte_pos + (bw->bit_pos > 0 ? 1 : 0);
-}
-
-static void br_init(bit_reader_t *br, const uint8_t *buffer, size_t size) {
-    br->buffer = buffer;
-    br->byte_pos = 0;
-    br->bit_pos = 0;
-    br->size = size;
-}
-
-static int br_read_bit(bit_reader_t *br) {
-    if (br->byte_pos >= br->size) return -1;
-    int bit = (br->buffer[br->byte_pos] >> (7 - br->bit_pos)) & 1;
-    br->bit_pos++;
-    if (br->bit_pos == 8) {
-        br->bit_pos = 0;
-        br->byte_pos++;
-    }
-    return bit;
-}
+/* Sanity bound on unary quotients when decoding */
+#define MAX_RICE_QUOTIENT 2000
 
-static int br_read_bits(bit_reader_t *br, uint8_t num_bits, uint32_t *out) {
-    uint32_t value = 0;
-    for (uint8_t i = 0; i < num_bits; i++) {
-        int bit = br_read_bit(br);
-        if (bit < 0) return -1;
-        value = (value << 1) | bit;
+/* Rice code with the quotient limited to 255 (the remainder is then dropped) */
+static int write_rice_capped(bit_writer_t *bw, uint32_t value, uint8_t r) {
+    if ((value >> r) > 255) {
+        value = 255u << r;
     }
-    *out = value;
-    return 0;
-}
-
-static int br_read_rice(bit_reader_t *br, uint8_t r, uint32_t *out) {
-    uint32_t q = 0;
-    int bit;
-    while ((bit = br_read_bit(br)) == 1) {
-        q++;
-        if (q > 2000) return -1;
-    }
-    if (bit < 0) return -1;
-    uint32_t rem;
-    if (br_read_bits(br, r, &rem) < 0) return -1;
-    *out = (q << r) | rem;
-    return 0;
+    return bw_write_rice(bw, value, r);
 }
 
 /* Simple ANS (rANS) encoder for values */
@@ -122,7 +31,7 @@ static int br_read_rice(bit_reader_t *br, uint8_t r, uint32_t *out) {
 typedef struct {
     uint32_t state;
     uint32_t *freq;
-    uint32_t *cumul;
+    uint32_t cumul[257];
     uint32_t total;
     int n_symbols;
     bit_writer_t *bw;
@@ -135,7 +44,6 @@ static void rans_init_encoder(rans_encoder_t *enc, uint32_t *freq, int n_symbols
     enc->bw = bw;
 
     /* Build cumulative frequencies */
-    enc->cumul = malloc((n_symbols + 1) * sizeof(uint32_t));
     enc->cumul[0] = 0;
     enc->total = 0;
     for (int i = 0; i < n_symbols; i++) {
@@ -161,49 +69,53 @@ static int rans_encode_symbol(rans_encoder_t *enc, int symbol) {
 
 static int rans_flush(rans_encoder_t *enc) {
     /* Write final state */
-    for (int i = 0; i < 4; i++) {
-        if (bw_write_bits(enc->bw, (enc->state >> (i * 8)) & 0xFF, 8) < 0) return -1;
+    int ret = 0;
+    for (int i = 0; i < 4 && ret == 0; i++) {
+        ret = bw_write_bits(enc->bw, (enc->state >> (i * 8)) & 0xFF, 8);
     }
-    free(enc->cumul);
-    return 0;
+    return ret;
 }
 
-sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension) {
-    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+size_t sparse_ultimate_max_encoded_size(size_t dimension, size_t k) {
+    if (dimension == 0 || dimension > 65535 || k > dimension) return 0;
+
+    /* Header 40 bits, a full alphabet bitfield, r and the first position.
+     * Gaps: capped Rice codes with r >= 3, unary parts totalling at most
+     * dimension >> 3. Values: the rANS state stays below 2^16, so each
+     * symbol renormalizes at most one byte, then 4 bytes of final state */
+    size_t bits = 40 + 256 + 14 + 5 * k + (dimension >> 3) + 8 * k + 32;
+    return (bits + 7) / 8;
+}
+
+int sparse_ultimate_encode_into(const int8_t *vector, size_t dimension,
+                               uint8_t *out, size_t out_cap, size_t *written) {
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_ultimate_encode_ctx(ctx, vector, dimension, out, out_cap, written);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_ultimate_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                               size_t dimension, uint8_t *out, size_t out_cap,
+                               size_t *written) {
+    if (!ctx || !vector || !out || !written) return -1;
+    if (dimension == 0 || dimension > ctx->capacity) return -1;
 
     /* Collect non-zeros and frequencies */
-    uint16_t *positions = malloc(dimension * sizeof(uint16_t));
-    int8_t *vals = malloc(dimension * sizeof(int8_t));
+    uint16_t *positions = ctx->positions;
+    int8_t *vals = ctx->values;
     uint32_t value_freqs[256] = {0};
 
-    if (!positions || !vals) {
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-
-    uint16_t count = 0;
-    int8_t min_val = 127, max_val = -128;
-
-    for (size_t i = 0; i < dimension; i++) {
-        if (vector[i] != 0) {
-            positions[count] = i;
-            vals[count] = vector[i];
-            value_freqs[(uint8_t)(vector[i] + 128)]++;
-            if (vector[i] < min_val) min_val = vector[i];
-            if (vector[i] > max_val) max_val = vector[i];
-            count++;
-        }
-    }
+    uint16_t count = (uint16_t)sparse_scan(vector, dimension, positions, vals, value_freqs);
+    int8_t min_val, max_val;
+    sparse_scan_range(value_freqs, &min_val, &max_val);
 
     if (count == 0) {
-        sparse_ultimate_t *result = malloc(sizeof(sparse_ultimate_t));
-        result->data = calloc(2, 1);
-        result->size = 2;
-        result->count = 0;
-        free(positions);
-        free(vals);
-        return result;
+        if (out_cap < 2) return -1;
+        out[0] = out[1] = 0;
+        *written = 2;
+        return 0;
     }
 
     /* Build delta-encoded alphabet */
@@ -219,27 +131,9 @@ sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension
         }
     }
 
-    /* Allocate result */
-    sparse_ultimate_t *result = malloc(sizeof(sparse_ultimate_t));
-    if (!result) {
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-
-    size_t max_size = 2 + n_unique + count * 10;
-    result->data = calloc(max_size, 1);
-    if (!result->data) {
-        free(result);
-        free(positions);
-        free(vals);
-        return NULL;
-    }
-    result->count = count;
-
     /* Encode */
     bit_writer_t bw;
-    bw_init(&bw, result->data, max_size);
+    bw_init(&bw, out, out_cap);
 
     /* Header: count (16), min_val (8), max_val (8), n_unique (8) */
     if (bw_write_bits(&bw, count, 16) < 0) goto error;
@@ -248,7 +142,6 @@ sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension
     if (bw_write_bits(&bw, n_unique, 8) < 0) goto error;
 
     /* Delta-encoded alphabet: store which values in [min, max] are present */
-    int range = max_val - min_val + 1;
     for (int v = min_val; v <= max_val; v++) {
         int present = value_freqs[(uint8_t)(v + 128)] > 0 ? 1 : 0;
         if (bw_write_bit(&bw, present) < 0) goto error;
@@ -262,7 +155,7 @@ sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension
 
     for (uint16_t i = 1; i < count; i++) {
         uint16_t gap = positions[i] - positions[i-1] - 1;
-        if (bw_write_rice(&bw, gap, r) < 0) goto error;
+        if (write_rice_capped(&bw, gap, r) < 0) goto error;
     }
 
     /* Value encoding: rANS */
@@ -284,24 +177,40 @@ sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension
 
     if (rans_flush(&rans) < 0) goto error;
 
-    result->size = bw_finish(&bw);
-    free(positions);
-    free(vals);
-    return result;
+    *written = bw_finish(&bw);
+    return 0;
 
 error:
-    free(result->data);
-    free(result);
-    free(positions);
-    free(vals);
-    return NULL;
+    return -1;
+}
+
+
+sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension) {
+    if (!vector || dimension == 0 || dimension > 65535) return NULL;
+
+    size_t count = sparse_scan_count(vector, dimension);
+
+    sparse_ultimate_t *result = malloc(sizeof(sparse_ultimate_t));
+    if (!result) return NULL;
+
+    size_t max_size = sparse_ultimate_max_encoded_size(dimension, count);
+    result->data = malloc(max_size);
+    if (!result->data ||
+        sparse_ultimate_encode_into(vector, dimension, result->data, max_size,
+                                    &result->size) < 0) {
+        free(result->data);
+        free(result);
+        return NULL;
+    }
+    result->count = (uint16_t)count;
+    return result;
 }
 
 /* rANS decoder */
 typedef struct {
     uint32_t state;
     uint32_t *freq;
-    uint32_t *cumul;
+    uint32_t cumul[257];
     uint32_t total;
     int n_symbols;
     bit_reader_t *br;
@@ -313,7 +222,6 @@ static int rans_init_decoder(rans_decoder_t *dec, uint32_t *freq, int n_symbols,
     dec->br = br;
 
     /* Build cumulative frequencies */
-    dec->cumul = malloc((n_symbols + 1) * sizeof(uint32_t));
     dec->cumul[0] = 0;
     dec->total = 0;
     for (int i = 0; i < n_symbols; i++) {
@@ -325,10 +233,7 @@ static int rans_init_decoder(rans_decoder_t *dec, uint32_t *freq, int n_symbols,
     dec->state = 0;
     for (int i = 0; i < 4; i++) {
         uint32_t byte;
-        if (br_read_bits(br, 8, &byte) < 0) {
-            free(dec->cumul);
-            return -1;
-        }
+        if (br_read_bits(br, 8, &byte) < 0) return -1;
         dec->state |= (byte << (i * 8));
     }
 
@@ -365,7 +270,16 @@ static int rans_decode_symbol(rans_decoder_t *dec, int *symbol) {
 
 int sparse_ultimate_decode(const sparse_ultimate_t *encoded,
                            int8_t *vector, size_t dimension) {
-    if (!encoded || !encoded->data || !vector) return -1;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_for(dimension);
+    if (!ctx) return -1;
+    int ret = sparse_ultimate_decode_ctx(ctx, encoded, vector, dimension);
+    sparse_codec_ctx_free(ctx);
+    return ret;
+}
+
+int sparse_ultimate_decode_ctx(sparse_codec_ctx_t *ctx, const sparse_ultimate_t *encoded,
+                               int8_t *vector, size_t dimension) {
+    if (!ctx || !encoded || !encoded->data || !vector) return -1;
 
     memset(vector, 0, dimension * sizeof(int8_t));
 
@@ -405,27 +319,18 @@ int sparse_ultimate_decode(const sparse_ultimate_t *encoded,
     uint32_t r;
     if (br_read_bits(&br, 3, &r) < 0) return -1;
 
-    uint16_t *positions = malloc(count * sizeof(uint16_t));
-    if (!positions) return -1;
+    if (count > ctx->capacity) return -1;
+    uint16_t *positions = ctx->positions;
 
     uint32_t pos;
-    if (br_read_bits(&br, 11, &pos) < 0) {
-        free(positions);
-        return -1;
-    }
+    if (br_read_bits(&br, 11, &pos) < 0) return -1;
     positions[0] = pos;
 
     for (uint32_t i = 1; i < count; i++) {
         uint32_t gap;
-        if (br_read_rice(&br, r, &gap) < 0) {
-            free(positions);
-            return -1;
-        }
+        if (br_read_rice(&br, r, MAX_RICE_QUOTIENT, &gap) < 0) return -1;
         pos = pos + gap + 1;
-        if (pos >= dimension) {
-            free(positions);
-            return -1;
-        }
+        if (pos >= dimension) return -1;
         positions[i] = pos;
     }
 
@@ -436,24 +341,15 @@ int sparse_ultimate_decode(const sparse_ultimate_t *encoded,
     }
 
     rans_decoder_t rans;
-    if (rans_init_decoder(&rans, alphabet_freqs, n_unique, &br) < 0) {
-        free(positions);
-        return -1;
-    }
+    if (rans_init_decoder(&rans, alphabet_freqs, n_unique, &br) < 0) return -1;
 
     /* Decode symbols */
     for (uint32_t i = 0; i < count; i++) {
         int sym_idx;
-        if (rans_decode_symbol(&rans, &sym_idx) < 0) {
-            free(rans.cumul);
-            free(positions);
-            return -1;
-        }
+        if (rans_decode_symbol(&rans, &sym_idx) < 0) return -1;
         vector[positions[i]] = alphabet[sym_idx];
     }
 
-    free(rans.cumul);
-    free(positions);
     return 0;
 }
 
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "sparse_codec_ctx.h"
 
 typedef struct {
     uint8_t *data;
@@ -29,12 +30,42 @@ typedef struct {
  */
 sparse_ultimate_t* sparse_ultimate_encode(const int8_t *vector, size_t dimension);
 
+/**
+ * Encode into a caller-provided buffer, with no allocation for the output
+ *
+ * An out_cap of sparse_ultimate_max_encoded_size() bytes always suffices;
+ * bytes past *written may be overwritten up to out_cap.
+ *
+ * @param written  Out: bytes used
+ * @return         0, or -1 on bad input or if the encoding does not fit
+ */
+int sparse_ultimate_encode_into(const int8_t *vector, size_t dimension,
+                                uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case encoded size of k nonzeros in dimension
+ *
+ * @return  Bytes, or 0 if dimension or k is out of range
+ */
+size_t sparse_ultimate_max_encoded_size(size_t dimension, size_t k);
+
 /**
  * Decode ultimate compressed vector
  */
 int sparse_ultimate_decode(const sparse_ultimate_t *encoded,
                            int8_t *vector, size_t dimension);
 
+/**
+ * As sparse_ultimate_encode_into() and sparse_ultimate_decode(), with the scratch
+ * and tables of ctx: no allocation
+ */
+int sparse_ultimate_encode_ctx(sparse_codec_ctx_t *ctx, const int8_t *vector,
+                               size_t dimension, uint8_t *out, size_t out_cap,
+                               size_t *written);
+
+int sparse_ultimate_decode_ctx(sparse_codec_ctx_t *ctx, const sparse_ultimate_t *encoded,
+                               int8_t *vector, size_t dimension);
+
 /**
  * Free encoded result
  */
@@ -0,0 +1,140 @@
+/**
+ * sparse_vector.c
+ *
+ * Sparse (COO) vectors: conversion to and from dense arrays, and the
+ * operations that only visit the nonzeros
+ */
+
+#include "sparse_vector.h"
+#include "sparse_scan.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Round up to the array alignment */
+static size_t align_up(size_t bytes) {
+    return (bytes + SPARSE_VECTOR_ALIGN - 1) & ~(size_t)(SPARSE_VECTOR_ALIGN - 1);
+}
+
+/* Bytes of one vector's two arrays, indices first */
+static size_t arrays_bytes(uint16_t max_nonzeros) {
+    const size_t n = max_nonzeros ? max_nonzeros : 1;
+    return align_up(n * sizeof(uint16_t)) + align_up(n);
+}
+
+static void lay_arrays(sparse_vector_t *vec, uint8_t *arrays, uint16_t dimension,
+                       uint16_t max_nonzeros) {
+    const size_t n = max_nonzeros ? max_nonzeros : 1;
+    vec->dimension = dimension;
+    vec->count = 0;
+    vec->indices = (uint16_t *)arrays;
+    vec->values = (int8_t *)(arrays + align_up(n * sizeof(uint16_t)));
+    vec->capacity = max_nonzeros;
+}
+
+size_t sparse_vector_bytes(uint16_t max_nonzeros) {
+    return align_up(sizeof(sparse_vector_t)) + arrays_bytes(max_nonzeros);
+}
+
+sparse_vector_t* sparse_vector_init(void *mem, uint16_t dimension, uint16_t max_nonzeros) {
+    if (!mem || ((uintptr_t)mem & (SPARSE_VECTOR_ALIGN - 1))) return NULL;
+
+    sparse_vector_t *vec = mem;
+    lay_arrays(vec, (uint8_t *)mem + align_up(sizeof(sparse_vector_t)), dimension,
+               max_nonzeros);
+    return vec;
+}
+
+sparse_vector_t* sparse_vector_new(uint16_t dimension, uint16_t max_nonzeros) {
+    void *mem = aligned_alloc(SPARSE_VECTOR_ALIGN, sparse_vector_bytes(max_nonzeros));
+    return mem ? sparse_vector_init(mem, dimension, max_nonzeros) : NULL;
+}
+
+void sparse_vector_free(sparse_vector_t *vec) {
+    free(vec);
+}
+
+sparse_vector_array_t* sparse_vector_array_new(size_t n, uint16_t dimension,
+                                               uint16_t max_nonzeros) {
+    const size_t per = arrays_bytes(max_nonzeros);
+    const size_t head = align_up(sizeof(sparse_vector_array_t));
+    if (n > (SIZE_MAX - 2 * head) / (per + sizeof(sparse_vector_t))) return NULL;
+
+    /* The array struct, the n headers, then every vector's arrays */
+    const size_t headers = align_up(n * sizeof(sparse_vector_t));
+    uint8_t *block = aligned_alloc(SPARSE_VECTOR_ALIGN, head + headers + n * per);
+    if (!block) return NULL;
+
+    sparse_vector_array_t *array = (sparse_vector_array_t *)block;
+    array->n = n;
+    array->vectors = (sparse_vector_t *)(block + head);
+    uint8_t *arrays = block + head + headers;
+    for (size_t i = 0; i < n; i++) {
+        lay_arrays(&array->vectors[i], arrays + i * per, dimension, max_nonzeros);
+    }
+    return array;
+}
+
+void sparse_vector_array_reset(sparse_vector_array_t *array) {
+    for (size_t i = 0; i < array->n; i++) {
+        sparse_vector_reset(&array->vectors[i]);
+    }
+}
+
+void sparse_vector_array_free(sparse_vector_array_t *array) {
+    free(array);
+}
+
+sparse_vector_t* sparse_from_dense(const int8_t *dense, uint16_t dimension) {
+    if (!dense) return NULL;
+
+    sparse_vector_t *vec = sparse_vector_new(dimension,
+                                             (uint16_t)sparse_scan_count(dense, dimension));
+    if (!vec) return NULL;
+    vec->count = (uint16_t)sparse_scan(dense, dimension, vec->indices, vec->values, NULL);
+    return vec;
+}
+
+void sparse_to_dense(const sparse_vector_t *sparse, int8_t *dense) {
+    memset(dense, 0, sparse->dimension);
+    for (uint16_t i = 0; i < sparse->count; i++) {
+        dense[sparse->indices[i]] = sparse->values[i];
+    }
+}
+
+uint64_t sparse_l2_norm_sq(const sparse_vector_t *vec) {
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < vec->count; i++) {
+        sum += (uint64_t)((int32_t)vec->values[i] * vec->values[i]);
+    }
+    return sum;
+}
+
+float sparse_l2_norm(const sparse_vector_t *vec) {
+    return sqrtf((float)sparse_l2_norm_sq(vec));
+}
+
+int64_t sparse_dot_i32(const sparse_vector_t *vec, const int32_t *row) {
+    int64_t sum = 0;
+    for (uint16_t i = 0; i < vec->count; i++) {
+        sum += (int64_t)row[vec->indices[i]] * vec->values[i];
+    }
+    return sum;
+}
+
+int sparse_to_poly(const sparse_vector_t *vec, uint32_t q, uint32_t *poly) {
+    if (q == 0) return -1;
+    if (q <= 128) {
+        /* Values reduce by one conditional add only below q in magnitude */
+        for (uint16_t i = 0; i < vec->count; i++) {
+            const int32_t v = vec->values[i];
+            if ((uint32_t)(v < 0 ? -v : v) >= q) return -1;
+        }
+    }
+    memset(poly, 0, (size_t)vec->dimension * sizeof(uint32_t));
+    for (uint16_t i = 0; i < vec->count; i++) {
+        const int32_t v = vec->values[i];
+        poly[vec->indices[i]] = v < 0 ? q - (uint32_t)-v : (uint32_t)v;
+    }
+    return 0;
+}
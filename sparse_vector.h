@@ -0,0 +1,136 @@
+/**
+ * sparse_vector.h
+ *
+ * Sparse (COO) vectors and the operations that use them without a dense copy
+ * - Indices ascending, values nonzero, as the sparse_* decoders emit them
+ * - Norm, dot product with a dense row, scatter into polynomial coefficients
+ */
+
+#ifndef SPARSE_VECTOR_H
+#define SPARSE_VECTOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Sparse vector representation (COO format) */
+typedef struct {
+    uint16_t dimension;      /* Vector dimension */
+    uint16_t count;          /* Number of non-zeros */
+    uint16_t *indices;       /* Non-zero indices */
+    int8_t *values;          /* Non-zero values */
+    uint16_t capacity;       /* Entries indices and values hold; 0 if not known */
+} sparse_vector_t;
+
+/* Alignment of the index and value arrays of the vectors allocated here */
+#define SPARSE_VECTOR_ALIGN 64
+
+/*
+ * The sparse_*_decode_sparse() functions fill a sparse_vector_t in place of
+ * a dense array: out->dimension is read, out->indices and out->values must
+ * hold out->capacity entries (or, with capacity 0, the encoded count's),
+ * and out->count is set; a count past a known capacity gets -1. Nothing is
+ * zeroed or scanned, and nothing is allocated beyond what the dense decoder
+ * of the same codec allocates.
+ */
+
+/**
+ * Entries a decoder may write into out, for a stream of count nonzeros
+ */
+static inline size_t sparse_vector_room(const sparse_vector_t *out, uint16_t count) {
+    return out->capacity ? out->capacity : count;
+}
+
+/**
+ * Allocate a new sparse vector, empty, with room for max_nonzeros entries
+ *
+ * The struct and both arrays share one allocation; each array starts on a
+ * SPARSE_VECTOR_ALIGN boundary.
+ */
+sparse_vector_t* sparse_vector_new(uint16_t dimension, uint16_t max_nonzeros);
+
+/**
+ * Bytes sparse_vector_init() lays a vector of max_nonzeros entries over,
+ * a multiple of SPARSE_VECTOR_ALIGN
+ */
+size_t sparse_vector_bytes(uint16_t max_nonzeros);
+
+/**
+ * Lay an empty vector over caller memory (an arena, a pool slot): mem holds
+ * sparse_vector_bytes(max_nonzeros) bytes, aligned to SPARSE_VECTOR_ALIGN,
+ * and is the vector; nothing is allocated, and nothing is to be freed
+ *
+ * @return  The vector, at mem, or NULL if mem is NULL or misaligned
+ */
+sparse_vector_t* sparse_vector_init(void *mem, uint16_t dimension, uint16_t max_nonzeros);
+
+/**
+ * Empty the vector for reuse, keeping its arrays
+ */
+static inline void sparse_vector_reset(sparse_vector_t *vec) {
+    vec->count = 0;
+}
+
+/**
+ * Free a sparse vector from sparse_vector_new() or sparse_from_dense()
+ */
+void sparse_vector_free(sparse_vector_t *vec);
+
+/**
+ * Many vectors of one dimension and capacity, in one allocation: headers
+ * contiguous, then each vector's arrays, aligned as sparse_vector_new()'s
+ */
+typedef struct {
+    size_t n;                   /* Vectors */
+    sparse_vector_t *vectors;   /* n vectors, each empty when allocated */
+} sparse_vector_array_t;
+
+/**
+ * Allocate n empty vectors with room for max_nonzeros entries each
+ *
+ * @return  Array (free with sparse_vector_array_free), or NULL
+ */
+sparse_vector_array_t* sparse_vector_array_new(size_t n, uint16_t dimension,
+                                               uint16_t max_nonzeros);
+
+/**
+ * Empty every vector for reuse
+ */
+void sparse_vector_array_reset(sparse_vector_array_t *array);
+
+void sparse_vector_array_free(sparse_vector_array_t *array);
+
+/**
+ * Create sparse vector from dense array
+ */
+sparse_vector_t* sparse_from_dense(const int8_t *dense, uint16_t dimension);
+
+/**
+ * Convert sparse vector to dense array (dimension entries, all written)
+ */
+void sparse_to_dense(const sparse_vector_t *sparse, int8_t *dense);
+
+/**
+ * Calculate L2 norm of sparse vector
+ */
+float sparse_l2_norm(const sparse_vector_t *vec);
+
+/**
+ * Squared L2 norm, exact
+ */
+uint64_t sparse_l2_norm_sq(const sparse_vector_t *vec);
+
+/**
+ * Dot product with a dense row of vec->dimension entries
+ */
+int64_t sparse_dot_i32(const sparse_vector_t *vec, const int32_t *row);
+
+/**
+ * Coefficients mod q of the vector, for the NTT: poly gets vec->dimension
+ * entries, zero but at the nonzeros, negative values as q + value
+ *
+ * @return  0, or -1 if a value's magnitude is not below q (any q past 128
+ *          holds every int8)
+ */
+int sparse_to_poly(const sparse_vector_t *vec, uint32_t q, uint32_t *poly);
+
+#endif /* SPARSE_VECTOR_H */
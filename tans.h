@@ -0,0 +1,186 @@
+#ifndef TANS_H
+#define TANS_H
+
+#include "bitstream.h"
+
+// ============================================================================
+// TABLED ANS (FSE STYLE, 8-BIT FREQUENCIES)
+// ============================================================================
+
+/**
+ * tANS over up to 256 symbols with frequencies summing to TANS_TABLE_SIZE,
+ * the table layout of Yann Collet's FSE
+ *
+ * The frequencies are spread over TANS_TABLE_SIZE states; a symbol of
+ * frequency f owns f of them. Decoding a symbol is a table lookup on the
+ * state and a read of that entry's 0..TANS_TABLE_LOG bits: no multiplies
+ * or divisions on either side.
+ *
+ * The encoder runs backwards from the last symbol, whose state it picks
+ * directly, so the stream of n symbols is
+ *
+ *     state of symbol 0            TANS_TABLE_LOG bits
+ *     bits of symbols 0 .. n-2     as each state transition needs them
+ *
+ * in the caller's bit stream, MSB first and unaligned.
+ */
+#define TANS_TABLE_LOG  8
+#define TANS_TABLE_SIZE (1u << TANS_TABLE_LOG)
+
+typedef struct {
+    uint8_t sym;
+    uint8_t nb_bits;        // bits read after decoding sym
+    uint16_t base;          // next state, before adding those bits
+} tans_decode_entry_t;
+
+typedef struct {
+    int32_t delta_nb_bits;  // (x + delta_nb_bits) >> 16: bits to emit
+    int32_t delta_state;    // (x >> bits) + delta_state: state_table index
+} tans_symbol_t;
+
+typedef struct {
+    tans_decode_entry_t decode[TANS_TABLE_SIZE];
+    uint16_t state_table[TANS_TABLE_SIZE];  // encoder states, TANS_TABLE_SIZE + u
+    tans_symbol_t symbol[TANS_TABLE_SIZE];
+    uint16_t first[TANS_TABLE_SIZE];        // a state of each symbol, for the start
+    uint16_t freq[TANS_TABLE_SIZE];
+} tans_table_t;
+
+static inline unsigned tans_highbit(uint32_t v) {
+    return 31u - (unsigned)__builtin_clz(v);
+}
+
+/**
+ * Build the encoding and decoding tables for n_symbols frequencies
+ *
+ * @return  0, or -1 unless 1 <= n_symbols <= 256 and the frequencies are
+ *          all nonzero and sum to TANS_TABLE_SIZE
+ */
+static inline int tans_table_build(tans_table_t *t, const uint32_t *freqs, int n_symbols) {
+    if (n_symbols <= 0 || n_symbols > (int)TANS_TABLE_SIZE) {
+        return -1;
+    }
+    uint32_t cumul[TANS_TABLE_SIZE + 1];
+    cumul[0] = 0;
+    for (int s = 0; s < n_symbols; s++) {
+        if (freqs[s] == 0 || freqs[s] > TANS_TABLE_SIZE - cumul[s]) {
+            return -1;
+        }
+        cumul[s + 1] = cumul[s] + freqs[s];
+    }
+    if (cumul[n_symbols] != TANS_TABLE_SIZE) {
+        return -1;
+    }
+    memset(t->freq, 0, sizeof(t->freq));
+
+    // Spread: FSE's step is odd, so it visits every state once
+    const uint32_t mask = TANS_TABLE_SIZE - 1;
+    const uint32_t step = (TANS_TABLE_SIZE >> 1) + (TANS_TABLE_SIZE >> 3) + 3;
+    uint8_t spread[TANS_TABLE_SIZE];
+    uint32_t pos = 0;
+    for (int s = 0; s < n_symbols; s++) {
+        for (uint32_t k = 0; k < freqs[s]; k++) {
+            spread[pos] = (uint8_t)s;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    // Encoder: states of each symbol in table order; per-symbol transforms
+    uint32_t next[TANS_TABLE_SIZE];
+    for (int s = 0; s < n_symbols; s++) {
+        next[s] = cumul[s];
+    }
+    for (uint32_t u = 0; u < TANS_TABLE_SIZE; u++) {
+        t->state_table[next[spread[u]]++] = (uint16_t)(TANS_TABLE_SIZE + u);
+    }
+    for (int s = 0; s < n_symbols; s++) {
+        const uint32_t f = freqs[s];
+        const uint32_t max_bits = TANS_TABLE_LOG - (f > 1 ? tans_highbit(f - 1) : 0);
+        t->symbol[s].delta_nb_bits = (int32_t)((max_bits << 16) - (f << max_bits));
+        t->symbol[s].delta_state = (int32_t)cumul[s] - (int32_t)f;
+        t->first[s] = t->state_table[cumul[s]];
+        t->freq[s] = (uint16_t)f;
+    }
+
+    // Decoder: the k-th state of a frequency-f symbol leads to f + k
+    for (int s = 0; s < n_symbols; s++) {
+        next[s] = freqs[s];
+    }
+    for (uint32_t u = 0; u < TANS_TABLE_SIZE; u++) {
+        const uint8_t s = spread[u];
+        const uint32_t x = next[s]++;
+        const unsigned nb = TANS_TABLE_LOG - tans_highbit(x);
+        t->decode[u].sym = s;
+        t->decode[u].nb_bits = (uint8_t)nb;
+        t->decode[u].base = (uint16_t)((x << nb) - TANS_TABLE_SIZE);
+    }
+    return 0;
+}
+
+/**
+ * Encode n symbols (alphabet indices) into bw
+ *
+ * @param scratch  n entries, for the state bits gathered back to front
+ * @return         0, or -1 if a symbol has no frequency or bw is full
+ */
+static inline int tans_encode(const tans_table_t *t, const uint8_t *syms, size_t n,
+                              uint16_t *scratch, bit_writer_t *bw) {
+    if (n == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (t->freq[syms[i]] == 0) {
+            return -1;
+        }
+    }
+
+    uint32_t x = t->first[syms[n - 1]];
+    for (size_t i = n - 1; i-- > 0;) {
+        const tans_symbol_t sy = t->symbol[syms[i]];
+        const unsigned nb = (unsigned)((int32_t)x + sy.delta_nb_bits) >> 16;
+        scratch[i] = (uint16_t)((x & ((1u << nb) - 1)) | (nb << 8));
+        x = t->state_table[(int32_t)(x >> nb) + sy.delta_state];
+    }
+
+    if (bw_write_bits(bw, x - TANS_TABLE_SIZE, TANS_TABLE_LOG) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i + 1 < n; i++) {
+        if (bw_write_bits(bw, scratch[i] & 0xFF, scratch[i] >> 8) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Decode n symbols written by tans_encode()
+ *
+ * @return  0, or -1 past the end of the stream
+ */
+static inline int tans_decode(const tans_table_t *t, bit_reader_t *br, uint8_t *syms, size_t n) {
+    if (n == 0) {
+        return 0;
+    }
+    uint32_t x;
+    if (br_read_bits(br, TANS_TABLE_LOG, &x) < 0) {
+        return -1;
+    }
+    for (size_t i = 0; i + 1 < n; i++) {
+        const tans_decode_entry_t e = t->decode[x];
+        syms[i] = e.sym;
+        if (br->n < TANS_TABLE_LOG) {
+            br_refill(br);
+            if (br->n < e.nb_bits) {
+                return -1;
+            }
+        }
+        // nb_bits may be 0: shift the top half, never by 64
+        x = e.base + (uint32_t)((br->acc >> 32) >> (32 - e.nb_bits));
+        br_skip(br, e.nb_bits);
+    }
+    syms[n - 1] = t->decode[x].sym;
+    return 0;
+}
+
+#endif // TANS_H
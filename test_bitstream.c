@@ -0,0 +1,209 @@
+/**
+ * Test the shared bit writer and reader
+ *
+ * Build: gcc -O2 -o test_bitstream test_bitstream.c
+ */
+
+#include "bitstream.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_BYTES 4096
+#define N_FIELDS 4000
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Reference: one bit at a time, MSB first */
+static void ref_put(uint8_t *buf, size_t *bit_pos, uint64_t value, unsigned num_bits) {
+    for (int i = (int)num_bits - 1; i >= 0; i--) {
+        if ((value >> i) & 1) {
+            buf[*bit_pos / 8] |= (uint8_t)(0x80 >> (*bit_pos % 8));
+        }
+        (*bit_pos)++;
+    }
+}
+
+typedef struct {
+    int kind;           /* 0: bits, 1: rice */
+    uint64_t value;
+    unsigned bits;      /* width, or Rice parameter */
+} field_t;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void) {
+    static uint8_t buf[STREAM_BYTES], ref[STREAM_BYTES];
+    static field_t fields[N_FIELDS];
+    int pass = 1;
+
+    printf("=== Bitstream ===\n");
+
+    /* Mixed widths 0..57 and Rice codes against the reference */
+    int match_ok = 1, read_ok = 1;
+    for (int trial = 0; trial < 20; trial++) {
+        memset(buf, 0, sizeof(buf));
+        memset(ref, 0, sizeof(ref));
+        size_t ref_bits = 0;
+        int n = 0;
+
+        bit_writer_t bw;
+        bw_init(&bw, buf, sizeof(buf));
+        while (n < N_FIELDS && ref_bits < (STREAM_BYTES - 1024) * 8) {
+            field_t *f = &fields[n++];
+            f->kind = (next_rand() % 4) == 0;
+            if (f->kind) {
+                f->bits = next_rand() % 8;
+                f->value = next_rand() % (trial < 10 ? 64 : 4096);
+                uint64_t q = f->value >> f->bits;
+                for (uint64_t i = 0; i < q; i++) {
+                    ref_put(ref, &ref_bits, 1, 1);
+                }
+                ref_put(ref, &ref_bits, 0, 1);
+                ref_put(ref, &ref_bits, f->value, f->bits);
+                match_ok &= bw_write_rice(&bw, (uint32_t)f->value, f->bits) == 0;
+            } else {
+                f->bits = next_rand() % (BITSTREAM_MAX_BITS + 1);
+                f->value = next_rand() & (f->bits ? (~0ULL >> (64 - f->bits)) : 0);
+                ref_put(ref, &ref_bits, f->value, f->bits);
+                match_ok &= bw_write_bits(&bw, f->value, f->bits) == 0;
+            }
+        }
+        size_t size = bw_finish(&bw);
+        match_ok &= size == (ref_bits + 7) / 8 && memcmp(buf, ref, sizeof(buf)) == 0;
+
+        /* Read back from a copy sized exactly, so the tail takes the slow path */
+        uint8_t *exact = malloc(size);
+        memcpy(exact, buf, size);
+        bit_reader_t br;
+        br_init(&br, exact, size);
+        for (int i = 0; i < n; i++) {
+            uint64_t v;
+            uint32_t v32;
+            if (fields[i].kind) {
+                read_ok &= br_read_rice(&br, fields[i].bits, 1u << 20, &v32) == 0 &&
+                           v32 == fields[i].value;
+            } else {
+                read_ok &= br_read_bits64(&br, fields[i].bits, &v) == 0 && v == fields[i].value;
+            }
+        }
+        read_ok &= br_tell(&br) == ref_bits;
+        free(exact);
+    }
+    printf("  Writes match bit-at-a-time reference: %s\n", match_ok ? "PASS" : "FAIL");
+    printf("  Reads return what was written: %s\n", read_ok ? "PASS" : "FAIL");
+    pass &= match_ok && read_ok;
+
+    /* Bounds: writes and reads stop exactly at the buffer end */
+    int bounds_ok = 1;
+    {
+        /* A 3-byte stream at the start of a larger array */
+        uint8_t small[16] = { 0 };
+        bit_writer_t bw;
+        bw_init(&bw, small, 3);
+        bounds_ok &= bw_write_bits(&bw, 0x1FFFFF, 21) == 0;
+        bounds_ok &= bw_write_bits(&bw, 0x7, 4) == -1;      /* 25 > 24 bits */
+        bounds_ok &= bw_write_bits(&bw, 0x5, 3) == 0;
+        bounds_ok &= bw_write_bit(&bw, 1) == -1;
+        bounds_ok &= bw_finish(&bw) == 3 && small[2] == 0xFD && small[3] == 0;
+
+        bit_reader_t br;
+        uint32_t v;
+        br_init(&br, small, 3);
+        bounds_ok &= br_read_bits(&br, 20, &v) == 0 && v == 0xFFFFF;
+        bounds_ok &= br_read_bits(&br, 5, &v) == -1;        /* nothing consumed */
+        bounds_ok &= br_read_bits(&br, 4, &v) == 0 && v == 0xD;
+        bounds_ok &= br_read_bit(&br) == -1;
+
+        /* Unary runs longer than a word, and past the end */
+        uint8_t ones[16];
+        memset(ones, 0xFF, sizeof(ones));
+        ones[15] = 0x7F;
+        br_init(&br, ones, sizeof(ones));
+        bounds_ok &= br_read_unary(&br, 1000, &v) == 0 && v == 120;
+        br_init(&br, ones, sizeof(ones));
+        bounds_ok &= br_read_unary(&br, 119, &v) == -1;
+        br_init(&br, ones, 15);
+        bounds_ok &= br_read_unary(&br, 1000, &v) == -1;
+
+        /* Rice codes inside one window: quotient limit, remainder cut short */
+        const uint8_t rice[2] = { 0xF9, 0x7C };     /* 11111 0 01, 0 11111 00 */
+        br_init(&br, rice, 2);
+        bounds_ok &= br_read_rice(&br, 2, 4, &v) == -1;
+        br_init(&br, rice, 2);
+        bounds_ok &= br_read_rice(&br, 2, 5, &v) == 0 && v == 21;
+        bounds_ok &= br_read_rice(&br, 0, 5, &v) == 0 && v == 0;
+        bounds_ok &= br_read_rice(&br, 3, 5, &v) == -1;     /* 1 bit left of 3 */
+    }
+    printf("  Buffer ends enforced: %s\n", bounds_ok ? "PASS" : "FAIL");
+    pass &= bounds_ok;
+
+    /* Byte alignment */
+    int align_ok = 1;
+    {
+        uint8_t out[8] = { 0 };
+        bit_writer_t bw;
+        bw_init(&bw, out, sizeof(out));
+        bw_write_bits(&bw, 0x5, 3);
+        align_ok &= bw_write_byte(&bw, 0xAB) == -1;
+        bw_align(&bw);
+        align_ok &= bw_tell(&bw) == 8 && bw_write_byte(&bw, 0xAB) == 0;
+        bw_write_bits(&bw, 0x1, 1);
+        align_ok &= bw_finish(&bw) == 3 && out[0] == 0xA0 && out[1] == 0xAB && out[2] == 0x80;
+
+        bit_reader_t br;
+        uint8_t byte;
+        uint32_t v;
+        br_init(&br, out, 3);
+        br_read_bits(&br, 3, &v);
+        align_ok &= br_read_byte(&br, &byte) == -1;
+        br_align(&br);
+        align_ok &= br_bytes_left(&br) == 2 && br_read_byte(&br, &byte) == 0 && byte == 0xAB;
+    }
+    printf("  Byte alignment: %s\n", align_ok ? "PASS" : "FAIL");
+    pass &= align_ok;
+
+    /* Throughput: 13-bit fields, as in the packed sparse format */
+    {
+        const int iters = 2000, per = 2000;
+        bit_writer_t bw;
+        double t0 = now_ns();
+        for (int it = 0; it < iters; it++) {
+            bw_init(&bw, buf, sizeof(buf));
+            for (int i = 0; i < per; i++) {
+                bw_write_bits(&bw, (uint32_t)(i * 2654435761u), 13);
+            }
+            bw_finish(&bw);
+        }
+        double t_write = (now_ns() - t0) / ((double)iters * per);
+
+        bit_reader_t br;
+        uint32_t v, sum = 0;
+        t0 = now_ns();
+        for (int it = 0; it < iters; it++) {
+            br_init(&br, buf, sizeof(buf));
+            for (int i = 0; i < per; i++) {
+                br_read_bits(&br, 13, &v);
+                sum += v;
+            }
+        }
+        double t_read = (now_ns() - t0) / ((double)iters * per);
+        printf("  13-bit fields: write %.2f ns, read %.2f ns (checksum %u)\n",
+               t_write, t_read, sum);
+    }
+
+    printf("\n%s\n", pass ? "All bitstream tests PASS" : "Some bitstream tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+/**
+ * Test reusable Brotli state, custom dictionaries and the stream format in
+ * vector_compress_brotli: round trips, caller buffers, streams fed in
+ * pieces, damage, and the size and time per vector
+ *
+ * Build: gcc -O2 -o test_brotli_stream test_brotli_stream.c vector_compress_brotli.c \
+ *        huffman_vector.c dntl_sched.c dntl_alloc.c -lbrotlienc -lbrotlidec -lpthread
+ */
+
+#include "vector_compress_brotli.h"
+#include <brotli/encode.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+#define TRAIN_VECTORS 64
+#define TEST_VECTORS 300
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The 0..6 profile of test_compress_brotli, drawn per value */
+static void make_vector(uint8_t *v) {
+    for (size_t i = 0; i < DIMENSION; i++) {
+        const unsigned p = (unsigned)(next_rand() % 2048);
+        v[i] = p < 476 ? 0 : p < 1356 ? 1 : p < 1830 ? 2 : p < 2003 ? 3 : p < 2044 ? 4
+             : p < 2046 ? 5 : 6;
+    }
+}
+
+/* Sink: a growing buffer */
+typedef struct {
+    uint8_t *data;
+    size_t size, cap;
+} sink_buffer_t;
+
+static int sink_append(void *opaque, const uint8_t *data, size_t size) {
+    sink_buffer_t *b = opaque;
+    if (b->size + size > b->cap) {
+        size_t cap = (b->size + size) * 2;
+        uint8_t *grown = realloc(b->data, cap);
+        if (!grown) return -1;
+        b->data = grown;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->size, data, size);
+    b->size += size;
+    return 0;
+}
+
+/* Vector callback: compare against the expected vectors, in order */
+typedef struct {
+    const uint8_t *expected;
+    size_t n_expected;
+    size_t seen;
+    int mismatch;
+} check_t;
+
+static int check_vector(void *opaque, const uint8_t *vector, size_t dimension) {
+    check_t *c = opaque;
+    if (c->seen >= c->n_expected || dimension != DIMENSION ||
+        memcmp(vector, c->expected + c->seen * DIMENSION, DIMENSION) != 0) {
+        c->mismatch = 1;
+        return -1;
+    }
+    c->seen++;
+    return 0;
+}
+
+/* Stream of vectors through the writer, read back in pieces of at most piece bytes */
+static int stream_round_trip(const uint8_t *vectors, size_t n, brotli_level_t level,
+                             const vector_brotli_dict_t *dict, size_t piece, size_t *bytes) {
+    sink_buffer_t b = { NULL, 0, 0 };
+    vector_brotli_writer_t *w = vector_brotli_writer_create(DIMENSION, level, dict,
+                                                            sink_append, &b);
+    int ok = w != NULL;
+    for (size_t v = 0; ok && v < n; v++) ok &= vector_brotli_writer_add(w, vectors + v * DIMENSION) == 0;
+    ok &= ok && vector_brotli_writer_finish(w) == 0;
+    vector_brotli_writer_free(w);
+
+    check_t c = { vectors, n, 0, 0 };
+    vector_brotli_reader_t *r = vector_brotli_reader_create(DIMENSION, dict, check_vector, &c);
+    ok &= r != NULL;
+    for (size_t pos = 0; ok && pos < b.size; pos += piece) {
+        const size_t len = b.size - pos < piece ? b.size - pos : piece;
+        ok &= vector_brotli_reader_push(r, b.data + pos, len) == 0;
+    }
+    ok &= ok && vector_brotli_reader_finish(r) == 0 && c.seen == n && !c.mismatch;
+    vector_brotli_reader_free(r);
+
+    /* Truncated, and with a byte past the end: both refused */
+    if (ok && b.size > 1) {
+        c.seen = 0;
+        r = vector_brotli_reader_create(DIMENSION, dict, check_vector, &c);
+        ok &= r && vector_brotli_reader_push(r, b.data, b.size - 1) == 0 &&
+              vector_brotli_reader_finish(r) == -1;
+        vector_brotli_reader_free(r);
+        c.seen = 0;
+        r = vector_brotli_reader_create(DIMENSION, dict, check_vector, &c);
+        ok &= r && sink_append(&b, (const uint8_t *)"x", 1) == 0 &&
+              vector_brotli_reader_push(r, b.data, b.size) == -1;
+        vector_brotli_reader_free(r);
+    }
+    if (bytes) *bytes = b.size;
+    free(b.data);
+    return ok;
+}
+
+int main(void) {
+    uint8_t *train = malloc((size_t)TRAIN_VECTORS * DIMENSION);
+    uint8_t *test = malloc((size_t)TEST_VECTORS * DIMENSION);
+    const size_t cap = vector_compress_brotli_max_size(DIMENSION);
+    uint8_t *frame = malloc(cap);
+    uint8_t decoded[DIMENSION];
+    static uint8_t dict_data[32768];
+    size_t dict_size = 0;
+    vector_brotli_ctx_t *plain = vector_brotli_ctx_create(DIMENSION, NULL);
+    int pass = train && test && frame && plain && cap > 0;
+    const uint32_t version = BrotliEncoderVersion();
+
+    printf("=== Brotli state, dictionaries and streams (Brotli %u.%u.%u) ===\n",
+           version >> 24, (version >> 12) & 0xFFF, version & 0xFFF);
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+    for (int v = 0; v < TRAIN_VECTORS; v++) make_vector(train + (size_t)v * DIMENSION);
+    for (int v = 0; v < TEST_VECTORS; v++) make_vector(test + (size_t)v * DIMENSION);
+
+    /* Single frames: round trips, caller buffers, one-shot compatibility */
+    {
+        int ok = 1;
+        for (int v = 0; ok && v < TEST_VECTORS; v++) {
+            const uint8_t *vec = test + (size_t)v * DIMENSION;
+            size_t n;
+            ok &= vector_compress_brotli_into_ctx(plain, vec, DIMENSION, BROTLI_LEVEL_DEFAULT,
+                                                  frame, cap, &n) == 0;
+            ok &= vector_decompress_brotli_ctx(plain, frame, n, decoded, DIMENSION) == 0 &&
+                  memcmp(decoded, vec, DIMENSION) == 0;
+            ok &= vector_decompress_brotli(frame, n, decoded, DIMENSION) == 0 &&
+                  memcmp(decoded, vec, DIMENSION) == 0;
+            ok &= vector_decompress_brotli_ctx(plain, frame, n - 1, decoded, DIMENSION) == -1;
+            ok &= vector_compress_brotli_into_ctx(plain, vec, DIMENSION, BROTLI_LEVEL_DEFAULT,
+                                                  frame, n - 1, &n) == -1;
+        }
+        compressed_vector_brotli_t *c = vector_compress_brotli(test, DIMENSION, BROTLI_LEVEL_MAX);
+        ok &= c && vector_decompress_brotli_ctx(plain, c->data, c->size, decoded, DIMENSION) == 0 &&
+              memcmp(decoded, test, DIMENSION) == 0;
+        vector_compress_brotli_free(c);
+        printf("  Frames into caller buffers, round trips: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Streams, fed back one byte, 100 bytes, or all of it at a time */
+    {
+        int ok = 1;
+        ok &= stream_round_trip(test, 1, BROTLI_LEVEL_DEFAULT, NULL, 1, NULL);
+        ok &= stream_round_trip(test, 50, BROTLI_LEVEL_FAST, NULL, 100, NULL);
+        ok &= stream_round_trip(test, TEST_VECTORS, BROTLI_LEVEL_DEFAULT, NULL, SIZE_MAX, NULL);
+        printf("  Streams in pieces, truncation and trailing bytes refused: %s\n",
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Dictionary: prepared from typical vectors, or refused by an older Brotli */
+    vector_brotli_dict_t *dict = NULL;
+    {
+        int ok = vector_brotli_dict_build(train, TRAIN_VECTORS, DIMENSION, dict_data,
+                                          sizeof(dict_data), &dict_size) == 0 &&
+                 dict_size > 0 && dict_size <= sizeof(dict_data);
+        dict = vector_brotli_dict_create(dict_data, dict_size, BROTLI_LEVEL_MAX);
+        if (dict) {
+            vector_brotli_ctx_t *ctx = vector_brotli_ctx_create(DIMENSION, dict);
+            ok &= ctx != NULL;
+            for (int v = 0; ok && v < TEST_VECTORS; v++) {
+                const uint8_t *vec = test + (size_t)v * DIMENSION;
+                size_t n;
+                ok &= vector_compress_brotli_into_ctx(ctx, vec, DIMENSION, BROTLI_LEVEL_FAST,
+                                                      frame, cap, &n) == 0 &&
+                      vector_decompress_brotli_ctx(ctx, frame, n, decoded, DIMENSION) == 0 &&
+                      memcmp(decoded, vec, DIMENSION) == 0;
+            }
+            ok &= stream_round_trip(test, 50, BROTLI_LEVEL_DEFAULT, dict, 100, NULL);
+            vector_brotli_ctx_free(ctx);
+            printf("  %zu-byte dictionary, frames and streams: %s\n", dict_size,
+                   ok ? "PASS" : "FAIL");
+        } else {
+            ok &= version < 0x1001000;
+            printf("  %zu-byte dictionary built, not supported before Brotli 1.1: %s\n",
+                   dict_size, ok ? "PASS" : "FAIL");
+        }
+        pass &= ok;
+    }
+
+    /* Size and time per vector */
+    {
+        static const struct { const char *name; brotli_level_t level; int use_dict; } runs[] = {
+            { "level 11", BROTLI_LEVEL_MAX, 0 },
+            { "level 5 + dictionary", 5, 1 },
+            { "level 1 + dictionary", BROTLI_LEVEL_FAST, 1 },
+        };
+        size_t one_shot_bytes = 0;
+        int ok = 1;
+        double t0 = now_ns();
+        for (int v = 0; ok && v < TEST_VECTORS; v++) {
+            compressed_vector_brotli_t *c = vector_compress_brotli(test + (size_t)v * DIMENSION,
+                                                                   DIMENSION, BROTLI_LEVEL_MAX);
+            ok &= c != NULL;
+            if (c) one_shot_bytes += c->size;
+            vector_compress_brotli_free(c);
+        }
+        printf("  One-shot level 11: %.1f bytes, %.1f us per vector\n",
+               (double)one_shot_bytes / TEST_VECTORS, (now_ns() - t0) / 1e3 / TEST_VECTORS);
+
+        for (size_t k = 0; k < sizeof(runs) / sizeof(runs[0]); k++) {
+            if (runs[k].use_dict && !dict) continue;
+            vector_brotli_ctx_t *ctx = vector_brotli_ctx_create(DIMENSION,
+                                                                runs[k].use_dict ? dict : NULL);
+            size_t bytes = 0, n;
+            ok &= ctx != NULL;
+            t0 = now_ns();
+            for (int v = 0; ok && v < TEST_VECTORS; v++) {
+                ok &= vector_compress_brotli_into_ctx(ctx, test + (size_t)v * DIMENSION,
+                                                      DIMENSION, runs[k].level, frame, cap,
+                                                      &n) == 0;
+                bytes += n;
+            }
+            printf("  Context, %s: %.1f bytes, %.1f us per vector\n", runs[k].name,
+                   (double)bytes / TEST_VECTORS, (now_ns() - t0) / 1e3 / TEST_VECTORS);
+            vector_brotli_ctx_free(ctx);
+        }
+
+        size_t stream_bytes;
+        t0 = now_ns();
+        ok &= stream_round_trip(test, TEST_VECTORS, BROTLI_LEVEL_DEFAULT, NULL, SIZE_MAX,
+                                &stream_bytes);
+        printf("  Stream, level 6 (with read back): %.1f bytes, %.1f us per vector: %s\n",
+               (double)stream_bytes / TEST_VECTORS, (now_ns() - t0) / 1e3 / TEST_VECTORS,
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    vector_brotli_dict_free(dict);
+    vector_brotli_ctx_free(plain);
+    free(train);
+    free(test);
+    free(frame);
+    printf("\n%s\n", pass ? "All Brotli stream tests PASS" : "Some Brotli stream tests FAIL");
+    return pass ? 0 : 1;
+}
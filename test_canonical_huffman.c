@@ -0,0 +1,254 @@
+/**
+ * Test the canonical Huffman decoding tables against a bit-at-a-time search
+ *
+ * Build: gcc -O2 -o test_canonical_huffman test_canonical_huffman.c
+ */
+
+#include "canonical_huffman.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STREAM_BYTES 2048
+#define MAX_DECODES  8192
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Reference: the codecs' original decoder, shortest matching code first */
+typedef struct {
+    uint32_t codes[CHUFF_MAX_SYMBOLS];
+    int by_len[CHUFF_MAX_LEN + 1][CHUFF_MAX_SYMBOLS];   /* symbols of each length */
+    int n_len[CHUFF_MAX_LEN + 1];
+} ref_code_t;
+
+static void ref_build(ref_code_t *rc, const uint8_t *lengths, int n_symbols) {
+    uint32_t code = 0;
+    memset(rc->n_len, 0, sizeof(rc->n_len));
+    for (unsigned len = 1; len <= CHUFF_MAX_LEN; len++) {
+        for (int i = 0; i < n_symbols; i++) {
+            if (lengths[i] == len) {
+                rc->codes[i] = code++;
+                rc->by_len[len][rc->n_len[len]++] = i;
+            }
+        }
+        code <<= 1;
+    }
+}
+
+static int ref_decode(const ref_code_t *rc, bit_reader_t *br) {
+    uint32_t code_val = 0;
+    for (unsigned len = 1; len <= CHUFF_MAX_LEN; len++) {
+        int bit = br_read_bit(br);
+        if (bit < 0) {
+            return -1;
+        }
+        code_val = (code_val << 1) | (uint32_t)bit;
+        for (int k = 0; k < rc->n_len[len]; k++) {
+            if (rc->codes[rc->by_len[len][k]] == code_val) {
+                return rc->by_len[len][k];
+            }
+        }
+    }
+    return -1;
+}
+
+/* Complete code: split a random leaf until n_symbols leaves remain */
+static void complete_lengths(uint8_t *lengths, int n_symbols, unsigned max_len) {
+    lengths[0] = 0;
+    int n = 1;
+    while (n < n_symbols) {
+        int i = (int)(next_rand() % n);
+        if (lengths[i] >= max_len) {
+            continue;
+        }
+        lengths[i]++;
+        lengths[n++] = lengths[i];
+    }
+    /* Shuffle, so canonical order differs from alphabet order */
+    for (int i = n_symbols - 1; i > 0; i--) {
+        int j = (int)(next_rand() % (i + 1));
+        uint8_t t = lengths[i];
+        lengths[i] = lengths[j];
+        lengths[j] = t;
+    }
+}
+
+/* Decode a stream both ways: same symbols, same failure, same bits used */
+static int compare_stream(const chuff_table_t *t, const uint8_t *lengths, int n_symbols,
+                          const uint8_t *stream, size_t size, size_t n) {
+    static uint8_t got[MAX_DECODES], want[MAX_DECODES];
+    static ref_code_t rc;
+    ref_build(&rc, lengths, n_symbols);
+
+    bit_reader_t ref;
+    br_init(&ref, stream, size);
+    size_t ok = 0;
+    for (; ok < n; ok++) {
+        int sym = ref_decode(&rc, &ref);
+        if (sym < 0) {
+            break;
+        }
+        want[ok] = (uint8_t)sym;
+    }
+
+    bit_reader_t br;
+    br_init(&br, stream, size);
+    int r = chuff_decode_n(t, &br, got, n);
+    if (ok == n) {
+        return r == 0 && memcmp(got, want, n) == 0 && br_tell(&br) == br_tell(&ref);
+    }
+
+    /* Up to the failure, one symbol at a time */
+    br_init(&br, stream, size);
+    for (size_t i = 0; i < ok; i++) {
+        if (chuff_decode(t, &br) != want[i]) {
+            return 0;
+        }
+    }
+    return r < 0 && chuff_decode(t, &br) < 0;
+}
+
+int main(void) {
+    static uint8_t stream[STREAM_BYTES];
+    static chuff_table_t table;
+    int pass = 1;
+
+    printf("=== Canonical Huffman tables ===\n");
+
+    /* Complete codes, short and long, over encoded and random streams */
+    int complete_ok = 1;
+    for (int trial = 0; trial < 300; trial++) {
+        const int n_symbols = 1 + (int)(next_rand() % (trial < 150 ? 16 : CHUFF_MAX_SYMBOLS));
+        unsigned max_len = trial % 3 == 0 ? CHUFF_MAX_LEN : 4 + (unsigned)(next_rand() % 12);
+        while ((1u << max_len) < (unsigned)n_symbols) {
+            max_len++;          /* room for n_symbols leaves */
+        }
+        uint8_t lengths[CHUFF_MAX_SYMBOLS];
+        static ref_code_t rc;
+        complete_lengths(lengths, n_symbols, max_len);
+        if (n_symbols == 1) {
+            lengths[0] = 1;
+        }
+        ref_build(&rc, lengths, n_symbols);
+
+        /* Symbols skewed towards the short codes, as the codecs see them */
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        size_t n = 0;
+        for (; n < MAX_DECODES; n++) {
+            int s = (int)(next_rand() % n_symbols);
+            for (int tries = 0; tries < 3 && lengths[s] > 6; tries++) {
+                s = (int)(next_rand() % n_symbols);
+            }
+            if (bw_write_bits(&bw, rc.codes[s], lengths[s]) < 0) {
+                break;
+            }
+        }
+        size_t size = bw_finish(&bw);
+
+        for (int multi = 0; multi < 2; multi++) {
+            complete_ok &= chuff_build(&table, lengths, n_symbols, multi ? n : 0) == 0;
+            complete_ok &= table.has_multi == (multi && n >= ((size_t)1 << table.bits));
+            complete_ok &= compare_stream(&table, lengths, n_symbols, stream, size, n);
+            /* Truncated: the last code is cut */
+            complete_ok &= compare_stream(&table, lengths, n_symbols, stream, size / 2, n);
+        }
+
+        for (size_t i = 0; i < sizeof(stream); i++) {
+            stream[i] = (uint8_t)next_rand();
+        }
+        complete_ok &= chuff_build(&table, lengths, n_symbols, MAX_DECODES) == 0;
+        complete_ok &= compare_stream(&table, lengths, n_symbols, stream, sizeof(stream), 1000);
+    }
+    printf("  Complete codes decode as the bit-at-a-time search: %s\n",
+           complete_ok ? "PASS" : "FAIL");
+    pass &= complete_ok;
+
+    /* Malformed length sets: incomplete, oversubscribed, wrapped codes */
+    int malformed_ok = 1;
+    for (int trial = 0; trial < 300; trial++) {
+        const int n_symbols = 1 + (int)(next_rand() % 40);
+        uint8_t lengths[CHUFF_MAX_SYMBOLS];
+        for (int i = 0; i < n_symbols; i++) {
+            lengths[i] = (uint8_t)(next_rand() % (trial % 2 ? 6 : CHUFF_MAX_LEN + 1));
+        }
+        lengths[next_rand() % n_symbols] = (uint8_t)(1 + next_rand() % 3);
+        for (size_t i = 0; i < sizeof(stream); i++) {
+            stream[i] = (uint8_t)next_rand();
+        }
+        for (int multi = 0; multi < 2; multi++) {
+            malformed_ok &= chuff_build(&table, lengths, n_symbols, multi ? MAX_DECODES : 0) == 0;
+            malformed_ok &= compare_stream(&table, lengths, n_symbols, stream, sizeof(stream), 500);
+        }
+    }
+    printf("  Malformed lengths decode as the bit-at-a-time search: %s\n",
+           malformed_ok ? "PASS" : "FAIL");
+    pass &= malformed_ok;
+
+    /* Rejected: no code, too many symbols, lengths past CHUFF_MAX_LEN */
+    int reject_ok = 1;
+    {
+        uint8_t lengths[CHUFF_MAX_SYMBOLS + 1] = { 0 };
+        reject_ok &= chuff_build(&table, lengths, 4, 0) == -1;
+        lengths[0] = 1;
+        reject_ok &= chuff_build(&table, lengths, 0, 0) == -1;
+        reject_ok &= chuff_build(&table, lengths, CHUFF_MAX_SYMBOLS + 1, 0) == -1;
+        lengths[1] = CHUFF_MAX_LEN + 1;
+        reject_ok &= chuff_build(&table, lengths, 2, 0) == -1;
+    }
+    printf("  Bad length sets rejected: %s\n", reject_ok ? "PASS" : "FAIL");
+    pass &= reject_ok;
+
+    /* Throughput: five symbols, lengths 1..4, as for a ternary-ish secret */
+    {
+        const uint8_t lengths[5] = { 3, 2, 1, 4, 4 };
+        static ref_code_t rc;
+        ref_build(&rc, lengths, 5);
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        size_t n = 0;
+        for (; n < MAX_DECODES; n++) {
+            uint64_t r = next_rand() % 16;
+            int s = r < 8 ? 2 : r < 12 ? 1 : r < 14 ? 0 : (int)(3 + (r & 1));
+            if (bw_write_bits(&bw, rc.codes[s], lengths[s]) < 0) {
+                break;
+            }
+        }
+        size_t size = bw_finish(&bw);
+
+        static uint8_t out[MAX_DECODES];
+        double t_ns[2];
+        unsigned sum = 0;
+        for (int multi = 0; multi < 2; multi++) {
+            chuff_build(&table, lengths, 5, multi ? n : 0);
+            const int iters = 2000;
+            double t0 = now_ns();
+            for (int it = 0; it < iters; it++) {
+                bit_reader_t br;
+                br_init(&br, stream, size);
+                chuff_decode_n(&table, &br, out, n);
+                sum += out[it % n];
+            }
+            t_ns[multi] = (now_ns() - t0) / ((double)iters * n);
+        }
+        printf("  Short codes: %.2f ns/symbol single, %.2f ns/symbol multi (checksum %u)\n",
+               t_ns[0], t_ns[1], sum);
+    }
+
+    printf("\n%s\n", pass ? "All canonical Huffman tests PASS" : "Some canonical Huffman tests FAIL");
+    return pass ? 0 : 1;
+}
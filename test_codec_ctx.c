@@ -0,0 +1,259 @@
+/**
+ * Test reusable codec contexts: one context shared by every codec and
+ * vector gives the bytes and decode results of the per-call entry points,
+ * too small a context is rejected, and reuse against per-call setup
+ *
+ * Build: gcc -O2 -o test_codec_ctx test_codec_ctx.c sparse_rice.c sparse_adaptive.c \
+ *        sparse_delta.c sparse_phase2.c sparse_phase3.c sparse_ultimate.c \
+ *        sparse_optimal_large.c sparse_dict.c -lpthread -lm
+ */
+
+#include "sparse_adaptive.h"
+#include "sparse_delta.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include "sparse_ultimate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_DIMENSION 65535
+#define BIG_BUFFER    (1 << 20)
+
+/* Both decoders of a codec, on a stream held as data, size and count */
+#define DECODE_ADAPTERS(name, type, decode, decode_ctx)                                \
+    static int name##_dec(const uint8_t *data, size_t size, uint16_t count,            \
+                          int8_t *v, size_t dim) {                                     \
+        const type enc = { (uint8_t *)data, size, count };                             \
+        return decode(&enc, v, dim);                                                   \
+    }                                                                                  \
+    static int name##_dec_ctx(sparse_codec_ctx_t *ctx, const uint8_t *data,            \
+                              size_t size, uint16_t count, int8_t *v, size_t dim) {    \
+        const type enc = { (uint8_t *)data, size, count };                             \
+        return decode_ctx(ctx, &enc, v, dim);                                          \
+    }
+
+DECODE_ADAPTERS(rice, sparse_rice_t, sparse_rice_decode, sparse_rice_decode_ctx)
+DECODE_ADAPTERS(adaptive, sparse_adaptive_t, sparse_adaptive_decode, sparse_adaptive_decode_ctx)
+DECODE_ADAPTERS(delta, sparse_delta_t, sparse_delta_decode, sparse_delta_decode_ctx)
+DECODE_ADAPTERS(phase3, sparse_phase3_t, sparse_phase3_decode, sparse_phase3_decode_ctx)
+DECODE_ADAPTERS(ultimate, sparse_ultimate_t, sparse_ultimate_decode,
+                sparse_ultimate_decode_ctx)
+DECODE_ADAPTERS(large, sparse_optimal_large_t, sparse_optimal_large_decode,
+                sparse_optimal_large_decode_ctx)
+
+/* Phase 2 takes a coder, and a dictionary in dictionary mode */
+#define SIG sparse_dict_builtin(SPARSE_DICT_SIGNATURE)
+#define PHASE2_ADAPTERS(name, coder, dict_args, into, enc_ctx, decode, decode_ctx)     \
+    static int name##_into(const int8_t *v, size_t dim, uint8_t *out, size_t cap,      \
+                           size_t *written) {                                          \
+        return into(v, dim, dict_args coder, out, cap, written);                       \
+    }                                                                                  \
+    static int name##_enc_ctx(sparse_codec_ctx_t *ctx, const int8_t *v, size_t dim,    \
+                              uint8_t *out, size_t cap, size_t *written) {             \
+        return enc_ctx(ctx, v, dim, dict_args coder, out, cap, written);               \
+    }                                                                                  \
+    static int name##_dec(const uint8_t *data, size_t size, uint16_t count,            \
+                          int8_t *v, size_t dim) {                                     \
+        const sparse_phase2_t enc = { (uint8_t *)data, size, count };                  \
+        return decode(&enc, v, dim, dict_args coder);                                  \
+    }                                                                                  \
+    static int name##_dec_ctx(sparse_codec_ctx_t *ctx, const uint8_t *data,            \
+                              size_t size, uint16_t count, int8_t *v, size_t dim) {    \
+        const sparse_phase2_t enc = { (uint8_t *)data, size, count };                  \
+        return decode_ctx(ctx, &enc, v, dim, dict_args coder);                         \
+    }
+
+#define NO_DICT
+#define WITH_DICT SIG,
+PHASE2_ADAPTERS(p2_rans, SPARSE_PHASE2_RANS, NO_DICT, sparse_phase2_encode_coder_into,
+                sparse_phase2_encode_coder_ctx, sparse_phase2_decode_coder,
+                sparse_phase2_decode_coder_ctx)
+PHASE2_ADAPTERS(p2_tans, SPARSE_PHASE2_TANS, NO_DICT, sparse_phase2_encode_coder_into,
+                sparse_phase2_encode_coder_ctx, sparse_phase2_decode_coder,
+                sparse_phase2_decode_coder_ctx)
+PHASE2_ADAPTERS(p2_dict_rans, SPARSE_PHASE2_RANS, WITH_DICT, sparse_phase2_encode_dict_into,
+                sparse_phase2_encode_dict_ctx, sparse_phase2_decode_dict,
+                sparse_phase2_decode_dict_ctx)
+PHASE2_ADAPTERS(p2_dict_tans, SPARSE_PHASE2_TANS, WITH_DICT, sparse_phase2_encode_dict_into,
+                sparse_phase2_encode_dict_ctx, sparse_phase2_decode_dict,
+                sparse_phase2_decode_dict_ctx)
+
+/* Value alphabets the codecs accept */
+typedef enum { VALUES_PM2, VALUES_PM8, VALUES_ANY } values_t;
+
+typedef struct {
+    const char *name;
+    int (*into)(const int8_t *, size_t, uint8_t *, size_t, size_t *);
+    int (*enc_ctx)(sparse_codec_ctx_t *, const int8_t *, size_t, uint8_t *, size_t, size_t *);
+    int (*dec)(const uint8_t *, size_t, uint16_t, int8_t *, size_t);
+    int (*dec_ctx)(sparse_codec_ctx_t *, const uint8_t *, size_t, uint16_t, int8_t *, size_t);
+    values_t values;
+} codec_t;
+
+static const codec_t codecs[] = {
+    { "rice",             sparse_rice_encode_into,          sparse_rice_encode_ctx,
+      rice_dec,           rice_dec_ctx,           VALUES_PM2 },
+    { "adaptive",         sparse_adaptive_encode_into,      sparse_adaptive_encode_ctx,
+      adaptive_dec,       adaptive_dec_ctx,       VALUES_PM8 },
+    { "delta",            sparse_delta_encode_into,         sparse_delta_encode_ctx,
+      delta_dec,          delta_dec_ctx,          VALUES_ANY },
+    { "phase2 rANS",      p2_rans_into,                     p2_rans_enc_ctx,
+      p2_rans_dec,        p2_rans_dec_ctx,        VALUES_ANY },
+    { "phase2 tANS",      p2_tans_into,                     p2_tans_enc_ctx,
+      p2_tans_dec,        p2_tans_dec_ctx,        VALUES_ANY },
+    { "phase2 dict/rANS", p2_dict_rans_into,                p2_dict_rans_enc_ctx,
+      p2_dict_rans_dec,   p2_dict_rans_dec_ctx,   VALUES_ANY },
+    { "phase2 dict/tANS", p2_dict_tans_into,                p2_dict_tans_enc_ctx,
+      p2_dict_tans_dec,   p2_dict_tans_dec_ctx,   VALUES_ANY },
+    { "phase3",           sparse_phase3_encode_into,        sparse_phase3_encode_ctx,
+      phase3_dec,         phase3_dec_ctx,         VALUES_ANY },
+    { "ultimate",         sparse_ultimate_encode_into,      sparse_ultimate_encode_ctx,
+      ultimate_dec,       ultimate_dec_ctx,       VALUES_ANY },
+    { "optimal_large",    sparse_optimal_large_encode_into, sparse_optimal_large_encode_ctx,
+      large_dec,          large_dec_ctx,          VALUES_ANY },
+};
+#define N_CODECS (sizeof(codecs) / sizeof(codecs[0]))
+
+static uint64_t rng_state = 0xD1B54A32D192ED03ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int8_t random_value(values_t values) {
+    static const int8_t pm2[4] = { -2, -1, 1, 2 };
+    if (values == VALUES_PM2) return pm2[next_rand() % 4];
+    int v = 1 + (int)(next_rand() % (values == VALUES_PM8 ? 8 : 40));
+    return (int8_t)(next_rand() % 2 ? v : -v);
+}
+
+/* dim values, nonzero with probability 1 in every; returns the count */
+static uint16_t make_vector(int8_t *v, size_t dim, unsigned every, values_t values) {
+    uint16_t k = 0;
+    memset(v, 0, dim);
+    for (size_t i = 0; i < dim; i++) {
+        if (next_rand() % every == 0) {
+            v[i] = random_value(values);
+            k++;
+        }
+    }
+    return k;
+}
+
+int main(void) {
+    static int8_t vec[MAX_DIMENSION], out[MAX_DIMENSION], ref_out[MAX_DIMENSION];
+    static uint8_t ref[BIG_BUFFER], buf[BIG_BUFFER];
+    int pass = 1;
+
+    printf("=== Reusable codec contexts ===\n");
+
+    /* One context for every codec, interleaved, any size up to capacity */
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_create(MAX_DIMENSION);
+    int reuse_ok = ctx != NULL;
+    int same[N_CODECS], round_trips[N_CODECS] = { 0 }, encoded[N_CODECS] = { 0 };
+    for (size_t c = 0; c < N_CODECS; c++) same[c] = 1;
+    for (int trial = 0; trial < 300 && ctx; trial++) {
+        const size_t dim = trial % 10 == 9 ? 1 + next_rand() % MAX_DIMENSION
+                         : trial % 2 ? 2048 : 1 + next_rand() % 4096;
+        const unsigned every = trial % 7 == 0 ? 1 : 1 + (unsigned)(next_rand() % 40);
+        for (size_t c = 0; c < N_CODECS; c++) {
+            const codec_t *codec = &codecs[c];
+            const uint16_t k = make_vector(vec, dim, every, codec->values);
+
+            size_t ref_size = 0, size = 0;
+            const int ref_ret = codec->into(vec, dim, ref, BIG_BUFFER, &ref_size);
+            const int ret = codec->enc_ctx(ctx, vec, dim, buf, BIG_BUFFER, &size);
+            same[c] &= ret == ref_ret;
+            if (ret < 0 || ref_ret < 0) continue;
+            same[c] &= size == ref_size && memcmp(buf, ref, size) == 0;
+
+            /* Same result as decoding without a context, failures included */
+            memset(out, 0x55, dim);
+            memset(ref_out, 0x55, dim);
+            const int ref_dec = codec->dec(buf, size, k, ref_out, dim);
+            same[c] &= codec->dec_ctx(ctx, buf, size, k, out, dim) == ref_dec &&
+                       memcmp(out, ref_out, dim) == 0;
+            round_trips[c] += ref_dec == 0 && memcmp(ref_out, vec, dim) == 0;
+            encoded[c]++;
+        }
+    }
+    for (size_t c = 0; c < N_CODECS; c++) {
+        printf("  %-17s shared context, same results (%d/%d round trips): %s\n",
+               codecs[c].name, round_trips[c], encoded[c], same[c] ? "PASS" : "FAIL");
+        reuse_ok &= same[c];
+    }
+    pass &= reuse_ok;
+
+    /* Capacity: longer vectors and larger counts get -1, not overruns */
+    int cap_ok = sparse_codec_ctx_create(0) == NULL &&
+                 sparse_codec_ctx_create(MAX_DIMENSION + 1) == NULL;
+    sparse_codec_ctx_t *small = sparse_codec_ctx_create(100);
+    cap_ok &= small != NULL;
+    for (size_t c = 0; c < N_CODECS && small && ctx; c++) {
+        const codec_t *codec = &codecs[c];
+        size_t size;
+        make_vector(vec, 101, 4, codec->values);
+        vec[0] = 1;
+        cap_ok &= codec->enc_ctx(small, vec, 101, buf, BIG_BUFFER, &size) == -1;
+        const uint16_t k100 = make_vector(vec, 100, 1, codec->values);
+        cap_ok &= codec->enc_ctx(small, vec, 100, buf, BIG_BUFFER, &size) == 0;
+        cap_ok &= codec->dec_ctx(small, buf, size, k100, out, 100) ==
+                  codec->dec(buf, size, k100, ref_out, 100);
+
+        /* 2048 values fit no context of 100, but count decides decoding */
+        const uint16_t k = make_vector(vec, 2048, 10, codec->values);
+        cap_ok &= codec->enc_ctx(ctx, vec, 2048, buf, BIG_BUFFER, &size) == 0;
+        if (k > 100) cap_ok &= codec->dec_ctx(small, buf, size, k, out, 2048) == -1;
+        cap_ok &= codec->enc_ctx(NULL, vec, 2048, buf, BIG_BUFFER, &size) == -1 &&
+                  codec->dec_ctx(NULL, buf, size, k, out, 2048) == -1;
+    }
+    sparse_codec_ctx_free(small);
+    sparse_codec_ctx_free(NULL);
+    printf("  Capacity limits rejected: %s\n", cap_ok ? "PASS" : "FAIL");
+    pass &= cap_ok;
+
+    /* Speed: a reused context against one set up per call */
+    if (ctx) {
+        const int n_vec = 2000;
+        double t_plain[2] = { 0 }, t_ctx[2] = { 0 };
+        int speed_ok = 1;
+        for (int v = 0; v < n_vec; v++) {
+            const uint16_t k = make_vector(vec, 2048, 21, VALUES_ANY);
+            size_t size, plain_size;
+            double t0 = now_ns();
+            speed_ok &= p2_rans_into(vec, 2048, ref, BIG_BUFFER, &plain_size) == 0;
+            t_plain[0] += now_ns() - t0;
+            t0 = now_ns();
+            speed_ok &= p2_rans_enc_ctx(ctx, vec, 2048, buf, BIG_BUFFER, &size) == 0;
+            t_ctx[0] += now_ns() - t0;
+            t0 = now_ns();
+            speed_ok &= p2_rans_dec(buf, size, k, out, 2048) == 0;
+            t_plain[1] += now_ns() - t0;
+            t0 = now_ns();
+            speed_ok &= p2_rans_dec_ctx(ctx, buf, size, k, out, 2048) == 0;
+            t_ctx[1] += now_ns() - t0;
+        }
+        printf("  phase2 rANS, 2048 values: encode %.2f -> %.2f us, decode %.2f -> %.2f us\n",
+               t_plain[0] / (1e3 * n_vec), t_ctx[0] / (1e3 * n_vec),
+               t_plain[1] / (1e3 * n_vec), t_ctx[1] / (1e3 * n_vec));
+        printf("  Reused context round trips: %s\n", speed_ok ? "PASS" : "FAIL");
+        pass &= speed_ok;
+    }
+    sparse_codec_ctx_free(ctx);
+
+    printf("\n%s\n", pass ? "All codec context tests PASS" : "Some codec context tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/**
+ * Test reusable zstd contexts and trained dictionaries in vector_compress:
+ * round trips, caller buffers, dictionary mismatches, and the size and time
+ * per vector against one-shot vector_compress()
+ *
+ * Build: gcc -O2 -o test_compress_dict test_compress_dict.c vector_compress.c \
+ *        huffman_vector.c -lzstd -lpthread
+ */
+
+#include "vector_compress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+#define TRAIN_VECTORS 2000
+#define TEST_VECTORS 500
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The 0..6 profile of test_compress, drawn per value */
+static void make_vector(uint8_t *v) {
+    for (size_t i = 0; i < DIMENSION; i++) {
+        const unsigned p = (unsigned)(next_rand() % 2048);
+        v[i] = p < 476 ? 0 : p < 1356 ? 1 : p < 1830 ? 2 : p < 2003 ? 3 : p < 2044 ? 4
+             : p < 2046 ? 5 : 6;
+    }
+}
+
+int main(void) {
+    uint8_t *train = malloc((size_t)TRAIN_VECTORS * DIMENSION);
+    uint8_t *test = malloc((size_t)TEST_VECTORS * DIMENSION);
+    const size_t cap = vector_compress_max_size(DIMENSION);
+    uint8_t *frame = malloc(cap);
+    uint8_t decoded[DIMENSION];
+    uint8_t dict[4096];
+    size_t dict_size = 0;
+    vector_compress_ctx_t *ctx = vector_compress_ctx_create(DIMENSION);
+    vector_compress_ctx_t *plain = vector_compress_ctx_create(DIMENSION);
+    int pass = train && test && frame && ctx && plain && cap > 0;
+
+    printf("=== zstd contexts and dictionaries ===\n");
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+    for (int v = 0; v < TRAIN_VECTORS; v++) make_vector(train + (size_t)v * DIMENSION);
+    for (int v = 0; v < TEST_VECTORS; v++) make_vector(test + (size_t)v * DIMENSION);
+
+    /* Training, and round trips with and without the dictionary */
+    {
+        int ok = vector_compress_train_dict(train, TRAIN_VECTORS, DIMENSION, dict,
+                                            sizeof(dict), &dict_size) == 0 &&
+                 dict_size > 0 && dict_size <= sizeof(dict);
+        ok &= ok && vector_compress_ctx_load_dict(ctx, dict, dict_size,
+                                                  COMPRESS_LEVEL_BEST) == 0;
+        for (int v = 0; ok && v < TEST_VECTORS; v++) {
+            const uint8_t *vec = test + (size_t)v * DIMENSION;
+            size_t n;
+            ok &= vector_compress_into_ctx(ctx, vec, DIMENSION, COMPRESS_LEVEL_BEST,
+                                           frame, cap, &n) == 0;
+            ok &= vector_decompress_ctx(ctx, frame, n, decoded, DIMENSION) == 0 &&
+                  memcmp(decoded, vec, DIMENSION) == 0;
+            /* The frame names a dictionary the plain context does not have */
+            ok &= vector_decompress_ctx(plain, frame, n, decoded, DIMENSION) == -1;
+            ok &= vector_compress_into_ctx(ctx, vec, DIMENSION, COMPRESS_LEVEL_BEST,
+                                           frame, n - 1, &n) == -1;
+
+            ok &= vector_compress_into_ctx(plain, vec, DIMENSION, COMPRESS_LEVEL_BEST,
+                                           frame, cap, &n) == 0;
+            ok &= vector_decompress_ctx(plain, frame, n, decoded, DIMENSION) == 0 &&
+                  memcmp(decoded, vec, DIMENSION) == 0;
+            frame[n / 2] ^= 0x5A;
+            (void)vector_decompress_ctx(plain, frame, n, decoded, DIMENSION);
+        }
+        compressed_vector_t *c = vector_compress_ctx(ctx, test, DIMENSION, COMPRESS_LEVEL_BEST);
+        ok &= c && vector_decompress_ctx(ctx, c->data, c->size, decoded, DIMENSION) == 0 &&
+              memcmp(decoded, test, DIMENSION) == 0;
+        vector_compress_free(c);
+        printf("  Trained %zu-byte dictionary, round trips and mismatches: %s\n",
+               dict_size, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Size and time per vector: one-shot, reused context, reused with dictionary */
+    {
+        size_t bytes[3] = {0};
+        double ns[3];
+        int ok = 1;
+        double t0 = now_ns();
+        for (int v = 0; ok && v < TEST_VECTORS; v++) {
+            compressed_vector_t *c = vector_compress(test + (size_t)v * DIMENSION, DIMENSION,
+                                                     COMPRESS_LEVEL_BEST);
+            ok &= c != NULL;
+            if (c) bytes[0] += c->size;
+            vector_compress_free(c);
+        }
+        ns[0] = now_ns() - t0;
+        vector_compress_ctx_t *use[2] = { plain, ctx };
+        for (int k = 0; k < 2; k++) {
+            t0 = now_ns();
+            for (int v = 0; ok && v < TEST_VECTORS; v++) {
+                size_t n;
+                ok &= vector_compress_into_ctx(use[k], test + (size_t)v * DIMENSION, DIMENSION,
+                                               COMPRESS_LEVEL_BEST, frame, cap, &n) == 0;
+                bytes[k + 1] += n;
+            }
+            ns[k + 1] = now_ns() - t0;
+        }
+        ok &= bytes[1] == bytes[0] && bytes[2] < bytes[1];
+        printf("  Level 19, per vector: one-shot %.1f bytes %.1f us, context %.1f bytes %.1f us, "
+               "dictionary %.1f bytes %.1f us: %s\n",
+               (double)bytes[0] / TEST_VECTORS, ns[0] / 1e3 / TEST_VECTORS,
+               (double)bytes[1] / TEST_VECTORS, ns[1] / 1e3 / TEST_VECTORS,
+               (double)bytes[2] / TEST_VECTORS, ns[2] / 1e3 / TEST_VECTORS,
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Dropping the dictionary restores plain frames */
+    {
+        size_t n;
+        int ok = vector_compress_ctx_load_dict(ctx, NULL, 0, COMPRESS_LEVEL_BEST) == 0 &&
+                 vector_compress_into_ctx(ctx, test, DIMENSION, COMPRESS_LEVEL_BEST,
+                                          frame, cap, &n) == 0 &&
+                 vector_decompress_ctx(plain, frame, n, decoded, DIMENSION) == 0 &&
+                 memcmp(decoded, test, DIMENSION) == 0;
+        ok &= vector_compress_ctx_load_dict(ctx, NULL, 10, COMPRESS_LEVEL_BEST) == -1;
+        printf("  Dictionary dropped: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    vector_compress_ctx_free(ctx);
+    vector_compress_ctx_free(plain);
+    free(train);
+    free(test);
+    free(frame);
+    printf("\n%s\n", pass ? "All zstd dictionary tests PASS" : "Some zstd dictionary tests FAIL");
+    return pass ? 0 : 1;
+}
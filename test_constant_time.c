@@ -1,3 +1,29 @@
+/**
+ * Constant-time regression harness (dudect-style) for every ntt64 kernel
+ *
+ * Each kernel of each backend built in and supported by the CPU (scalar,
+ * AVX2, AVX-512, NEON, SVE2, and the shift-reduced q = 257 transforms) is
+ * timed with the cycle counter on two interleaved input classes: a fixed
+ * all-zero input and uniform random inputs, the class of each measurement
+ * drawn at random. Welch's t-test compares the classes on all measurements
+ * and on measurements cropped at increasing percentiles (thresholds taken
+ * from a warm-up batch), which removes the long tail interrupts and
+ * migrations add. Inputs are generated a chunk ahead, so both classes run
+ * the same copy right before the timed call. The largest |t| decides:
+ *
+ *   |t| <= 4.5     PASS
+ *   |t| <= 10      PASS, flagged (not enough evidence to call a leak)
+ *   |t| > 10       measured again; FAIL if the second run also exceeds 10
+ *
+ * Exits with 1 if any kernel FAILs, so the report can gate releases.
+ *
+ * Usage: test_constant_time [-n measurements] [-f filter]
+ *   -n   Measurements per kernel (default 20000)
+ *   -f   Only kernels whose name contains filter ("avx2/", "/pointwise", ...)
+ *
+ * Build: make -f Makefile.simd test_constant_time
+ */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -5,247 +31,506 @@
 #include <string.h>
 #include <math.h>
 #include "ntt64.h"
+#include "ntt64_simd.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
-// High-resolution timing
-#ifdef __x86_64__
-static inline uint64_t rdtsc(void) {
-    uint32_t lo, hi;
-    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
-    return ((uint64_t)hi << 32) | lo;
-}
-#define HAVE_RDTSC 1
+#define CT_MEASUREMENTS 20000
+#define CT_WARMUP 2000
+#define CT_CROPS 32             // cropped tests, plus one on all measurements
+#define CT_MIN_CLASS 500        // measurements per class before a test counts
+#define CT_T_WARN 4.5
+#define CT_T_FAIL 10.0
+
+#define CT_CHUNK 128            // measurements prepared ahead of timing
+
+#define CT_BATCH 16             // polynomials per batch call
+#define CT_MAC 4                // products per MAC and chain call
+#define CT_MAX_WORDS (CT_BATCH * NTT_N)
+
+// ============================================================================
+// CYCLE COUNTER
+// ============================================================================
+
+// Fenced so the measured call cannot drift across the reads
+static inline uint64_t ct_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    const uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#elif defined(__aarch64__)
+    uint64_t t;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(t) : : "memory");
+    return t;
 #else
-#define HAVE_RDTSC 0
-static inline uint64_t rdtsc(void) {
     struct timespec ts;
     clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
-}
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
 #endif
-
-// Statistical functions
-double compute_mean(uint64_t *samples, int n) {
-    double sum = 0.0;
-    for (int i = 0; i < n; i++) {
-        sum += (double)samples[i];
-    }
-    return sum / n;
 }
 
-double compute_stddev(uint64_t *samples, int n, double mean) {
-    double sum_sq = 0.0;
-    for (int i = 0; i < n; i++) {
-        double diff = (double)samples[i] - mean;
-        sum_sq += diff * diff;
-    }
-    return sqrt(sum_sq / n);
+static uint64_t rng_state = 0x9e3779b97f4a7c15ull;
+
+static uint64_t next_rand(void) {
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
 }
 
-double compute_coefficient_of_variation(uint64_t *samples, int n) {
-    double mean = compute_mean(samples, n);
-    double stddev = compute_stddev(samples, n, mean);
-    return (stddev / mean) * 100.0; // as percentage
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+typedef enum {
+    CT_FORWARD = 0,
+    CT_INVERSE,
+    CT_POINTWISE,
+    CT_FORWARD_BATCH,
+    CT_INVERSE_BATCH,
+    CT_FORWARD_ALL,
+    CT_INVERSE_ALL,
+    CT_MAC_OP,
+    CT_CHAIN,
+    CT_SCALE_ADD,
+    CT_PREPARED,
+    CT_FORWARD16,
+    CT_INVERSE16,
+    CT_MUL16,
+    CT_MOD_SWITCH,
+    CT_CRT_COMBINE,
+    CT_OPS
+} ct_op_t;
+
+static const char *const OP_NAMES[CT_OPS] = {
+    "forward", "inverse", "pointwise", "forward_batch", "inverse_batch", "forward_all",
+    "inverse_all", "mac", "chain", "scale_add", "prepared", "forward16", "inverse16", "mul16",
+    "mod_switch", "crt_combine"
+};
+
+/**
+ * One backend's kernels, NULL where it has none (the dispatcher then keeps
+ * another backend's)
+ */
+typedef struct {
+    const char *name;
+    int supported;
+    ntt64_forward_fn forward;
+    ntt64_inverse_fn inverse;
+    ntt64_pointwise_mul_fn pointwise;
+    ntt64_batch_fn forward_batch, inverse_batch;
+    ntt64_forward_all_fn forward_all;
+    ntt64_inverse_all_fn inverse_all;
+    ntt64_pointwise_mac_fn mac;
+    ntt64_pointwise_mul_chain_fn chain;
+    ntt64_pointwise_scale_add_fn scale_add;
+    ntt64_pointwise_mul_prepared_fn prepared;
+    ntt64_ntt16_fn forward16, inverse16;
+    ntt64_pointwise_mul16_fn mul16;
+    ntt64_mod_switch_fn mod_switch;
+    ntt64_crt_combine_fn crt_combine;
+} ct_backend_t;
+
+static void forward_bitrev_f257(uint32_t poly[NTT_N], int layer) {
+    (void)layer;
+    ntt64_forward_bitrev_f257(poly);
 }
 
-// T-test for comparing two distributions
-double welch_t_test(uint64_t *samples1, int n1, uint64_t *samples2, int n2) {
-    double mean1 = compute_mean(samples1, n1);
-    double mean2 = compute_mean(samples2, n2);
-    double var1 = compute_stddev(samples1, n1, mean1);
-    double var2 = compute_stddev(samples2, n2, mean2);
+static void inverse_bitrev_f257(uint32_t poly[NTT_N], int layer) {
+    (void)layer;
+    ntt64_inverse_bitrev_f257(poly);
+}
 
-    var1 = var1 * var1;
-    var2 = var2 * var2;
+static void forward_f257(uint32_t poly[NTT_N], int layer) {
+    (void)layer;
+    ntt64_forward_f257(poly);
+}
 
-    double t = (mean1 - mean2) / sqrt(var1/n1 + var2/n2);
-    return fabs(t);
+static void inverse_f257(uint32_t poly[NTT_N], int layer) {
+    (void)layer;
+    ntt64_inverse_f257(poly);
 }
 
-// Fill polynomial with specific pattern
-void fill_pattern(uint32_t poly[NTT_N], const char* pattern, uint32_t q) {
-    if (strcmp(pattern, "zeros") == 0) {
-        memset(poly, 0, sizeof(uint32_t) * NTT_N);
-    } else if (strcmp(pattern, "ones") == 0) {
-        for (int i = 0; i < NTT_N; i++) {
-            poly[i] = 1;
-        }
-    } else if (strcmp(pattern, "max") == 0) {
-        for (int i = 0; i < NTT_N; i++) {
-            poly[i] = q - 1;
-        }
-    } else if (strcmp(pattern, "alternating") == 0) {
-        for (int i = 0; i < NTT_N; i++) {
-            poly[i] = (i & 1) ? (q - 1) : 0;
-        }
-    } else if (strcmp(pattern, "random1") == 0) {
-        srand(12345);
-        for (int i = 0; i < NTT_N; i++) {
-            poly[i] = rand() % q;
-        }
-    } else if (strcmp(pattern, "random2") == 0) {
-        srand(54321);
-        for (int i = 0; i < NTT_N; i++) {
-            poly[i] = rand() % q;
-        }
+static const ct_backend_t BACKENDS[] = {
+    { "scalar", 1, ntt64_forward_scalar, ntt64_inverse_scalar, ntt64_pointwise_mul_scalar,
+      ntt64_forward_batch_scalar, ntt64_inverse_batch_scalar,
+      ntt64_forward_all_layers_scalar, ntt64_inverse_all_layers_scalar,
+      ntt64_pointwise_mac_scalar, ntt64_pointwise_mul_chain_scalar,
+      ntt64_pointwise_scale_add_scalar, ntt64_pointwise_mul_prepared_scalar,
+      ntt64_forward_bitrev16_scalar, ntt64_inverse_bitrev16_scalar,
+      ntt64_pointwise_mul16_scalar, ntt64_mod_switch_scalar, ntt64_crt_combine_scalar },
+#ifdef __AVX2__
+    { "avx2", -1, ntt64_forward_avx2, ntt64_inverse_avx2, ntt64_pointwise_mul_avx2,
+      ntt64_forward_batch_avx2, ntt64_inverse_batch_avx2,
+      ntt64_forward_all_layers_avx2, ntt64_inverse_all_layers_avx2,
+      ntt64_pointwise_mac_avx2, ntt64_pointwise_mul_chain_avx2,
+      ntt64_pointwise_scale_add_avx2, ntt64_pointwise_mul_prepared_avx2,
+      ntt64_forward_bitrev16_avx2, ntt64_inverse_bitrev16_avx2, ntt64_pointwise_mul16_avx2,
+      ntt64_mod_switch_avx2, ntt64_crt_combine_avx2 },
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    { "avx512", -1, ntt64_forward_avx512, ntt64_inverse_avx512, ntt64_pointwise_mul_avx512,
+      ntt64_forward_batch_avx512, ntt64_inverse_batch_avx512,
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL },
+#endif
+#ifdef __ARM_NEON
+    { "neon", 1, ntt64_forward_neon, ntt64_inverse_neon, ntt64_pointwise_mul_neon,
+      ntt64_forward_batch_neon, ntt64_inverse_batch_neon,
+      NULL, NULL, NULL, NULL, NULL, NULL,
+#if defined(__aarch64__)
+      ntt64_forward_bitrev16_neon, ntt64_inverse_bitrev16_neon, ntt64_pointwise_mul16_neon,
+      NULL, NULL },
+#else
+      NULL, NULL, NULL, NULL, NULL },
+#endif
+#endif
+#if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+    { "sve2", -1, ntt64_forward_sve2, ntt64_inverse_sve2, ntt64_pointwise_mul_sve2,
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL },
+#endif
+    // Shift-reduced q = 257 transforms (layer 0 only)
+    { "f257", 1, forward_f257, inverse_f257, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+      NULL, NULL, NULL, NULL, NULL, NULL },
+    { "f257_bitrev", 1, forward_bitrev_f257, inverse_bitrev_f257, NULL, NULL, NULL, NULL, NULL,
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL },
+};
+
+// Backends left at -1 need a CPU feature the detector reports
+static int backend_supported(const ct_backend_t *be, int features) {
+    if (be->supported >= 0) {
+        return be->supported;
+    }
+    if (strcmp(be->name, "avx2") == 0) {
+        return (features & NTT_CPU_AVX2) != 0;
     }
+    if (strcmp(be->name, "avx512") == 0) {
+        return (features & NTT_CPU_AVX512) != 0;
+    }
+    return (features & NTT_CPU_SVE2) != 0;
 }
 
-// Measure timing for a specific pattern
-void measure_pattern_timing(int layer, const char* pattern,
-                           uint64_t *fwd_times, uint64_t *inv_times,
-                           int num_samples) {
-    uint32_t q = ntt64_get_modulus(layer);
-    uint32_t poly[NTT_N];
+static int backend_has(const ct_backend_t *be, int op) {
+    const void *const fn[CT_OPS] = {
+        (const void *)be->forward, (const void *)be->inverse, (const void *)be->pointwise,
+        (const void *)be->forward_batch, (const void *)be->inverse_batch,
+        (const void *)be->forward_all, (const void *)be->inverse_all, (const void *)be->mac,
+        (const void *)be->chain, (const void *)be->scale_add, (const void *)be->prepared,
+        (const void *)be->forward16, (const void *)be->inverse16, (const void *)be->mul16,
+        (const void *)be->mod_switch, (const void *)be->crt_combine
+    };
+    return fn[op] != NULL;
+}
 
-    // Warm up CPU
-    for (int i = 0; i < 100; i++) {
-        fill_pattern(poly, pattern, q);
-        ntt64_forward(poly, layer);
+/**
+ * Operands of one measurement: in is the secret input the classes differ in
+ * (or its 16-bit copy in16), copied from a chunk of prepared inputs; the
+ * other operands are fixed random values. The switch and CRT constants pair
+ * the layer under test with the next one (secret residues under both for
+ * crt_combine)
+ */
+typedef struct {
+    uint32_t chunk[CT_CHUNK][CT_MAX_WORDS] __attribute__((aligned(64)));
+    uint16_t chunk16[CT_CHUNK][NTT_N] __attribute__((aligned(64)));
+    int cls[CT_CHUNK];
+    uint32_t in[CT_MAX_WORDS] __attribute__((aligned(64)));
+    uint16_t in16[NTT_N] __attribute__((aligned(64)));
+    uint32_t b[CT_MAC][NTT_N] __attribute__((aligned(64)));
+    uint16_t b16[NTT_N] __attribute__((aligned(64)));
+    uint32_t out[NTT_NUM_LAYERS][NTT_N] __attribute__((aligned(64)));
+    uint16_t out16[NTT_N] __attribute__((aligned(64)));
+    uint64_t out64[NTT_N] __attribute__((aligned(64)));
+    ntt64_prepared_t prep;
+    ntt64_switch_t sw;
+    ntt64_crt_t crt;
+} ct_work_t;
+
+// The layer the switch and CRT kernels pair with layer
+static int paired_layer(int layer) {
+    return (layer + 1) % NTT_NUM_LAYERS;
+}
+
+static void ct_run(const ct_backend_t *be, int op, ct_work_t *w, int layer) {
+    switch (op) {
+    case CT_FORWARD:        be->forward(w->in, layer); break;
+    case CT_INVERSE:        be->inverse(w->in, layer); break;
+    case CT_POINTWISE:      be->pointwise(w->out[0], w->in, w->b[0], layer); break;
+    case CT_FORWARD_BATCH:  be->forward_batch(w->in, CT_BATCH, layer); break;
+    case CT_INVERSE_BATCH:  be->inverse_batch(w->in, CT_BATCH, layer); break;
+    case CT_FORWARD_ALL:    be->forward_all(w->in, w->out); break;
+    case CT_INVERSE_ALL:    be->inverse_all((const uint32_t (*)[NTT_N])w->in, w->out); break;
+    case CT_MAC_OP:
+        be->mac(w->out[0], (const uint32_t (*)[NTT_N])w->in, (const uint32_t (*)[NTT_N])w->b,
+                CT_MAC, layer);
+        break;
+    case CT_CHAIN:
+        be->chain(w->out[0], w->in, (const uint32_t (*)[NTT_N])w->b, CT_MAC, layer);
+        break;
+    case CT_SCALE_ADD:      be->scale_add(w->out[0], w->in, 3, w->b[0], layer); break;
+    case CT_PREPARED:       be->prepared(w->out[0], w->in, &w->prep); break;
+    case CT_FORWARD16:      be->forward16(w->in16, layer); break;
+    case CT_INVERSE16:      be->inverse16(w->in16, layer); break;
+    case CT_MUL16:          be->mul16(w->out16, w->in16, w->b16, layer); break;
+    case CT_MOD_SWITCH:     be->mod_switch(w->in, NTT_N, &w->sw); break;
+    case CT_CRT_COMBINE: {
+        const uint32_t *const residues[2] = { w->in, w->in + NTT_N };
+        be->crt_combine(w->out64, residues, NTT_N, &w->crt);
+        break;
+    }
     }
+}
 
-    // Measure forward NTT
-    for (int i = 0; i < num_samples; i++) {
-        fill_pattern(poly, pattern, q);
+// Secret words per call; all-layer inverses take one row per layer
+static size_t op_words(int op) {
+    switch (op) {
+    case CT_FORWARD_BATCH:
+    case CT_INVERSE_BATCH:  return CT_BATCH * NTT_N;
+    case CT_INVERSE_ALL:    return NTT_NUM_LAYERS * NTT_N;
+    case CT_MAC_OP:         return CT_MAC * NTT_N;
+    case CT_CRT_COMBINE:    return 2 * NTT_N;
+    default:                return NTT_N;
+    }
+}
 
-        uint64_t start = rdtsc();
-        ntt64_forward(poly, layer);
-        uint64_t end = rdtsc();
+static int op_is16(int op) {
+    return op == CT_FORWARD16 || op == CT_INVERSE16 || op == CT_MUL16;
+}
 
-        fwd_times[i] = end - start;
+// Random classes and their inputs: all zeros (class 0) or uniform, reduced
+static void fill_chunk(ct_work_t *w, int op, int layer) {
+    const size_t words = op_words(op);
+
+    for (int m = 0; m < CT_CHUNK; m++) {
+        uint32_t *in = w->chunk[m];
+        w->cls[m] = (int)(next_rand() & 1);
+        for (size_t i = 0; i < words; i++) {
+            const int l = op == CT_INVERSE_ALL ? (int)(i / NTT_N)
+                        : op == CT_CRT_COMBINE && i >= NTT_N ? paired_layer(layer) : layer;
+            const uint32_t v = (uint32_t)(next_rand() % ntt64_get_modulus(l));
+            in[i] = w->cls[m] ? v : 0;
+        }
+        if (op_is16(op)) {
+            ntt64_pack16(w->chunk16[m], in);
+        }
     }
+}
 
-    // Measure inverse NTT
-    for (int i = 0; i < num_samples; i++) {
-        fill_pattern(poly, pattern, q);
-        ntt64_forward(poly, layer); // Put in NTT domain first
-
-        uint64_t start = rdtsc();
-        ntt64_inverse(poly, layer);
-        uint64_t end = rdtsc();
+// Time one call on prepared input m
+static uint64_t time_call(const ct_backend_t *be, int op, int layer, ct_work_t *w, int m) {
+    if (op_is16(op)) {
+        memcpy(w->in16, w->chunk16[m], sizeof(w->in16));
+    } else {
+        memcpy(w->in, w->chunk[m], op_words(op) * sizeof(uint32_t));
+    }
+    const uint64_t t0 = ct_cycles();
+    ct_run(be, op, w, layer);
+    return ct_cycles() - t0;
+}
 
-        inv_times[i] = end - start;
+static void fill_fixed(ct_work_t *w, int layer) {
+    const uint32_t q = ntt64_get_modulus(layer);
+    for (int k = 0; k < CT_MAC; k++) {
+        for (int i = 0; i < NTT_N; i++) {
+            w->b[k][i] = (uint32_t)(next_rand() % q);
+        }
     }
+    ntt64_pack16(w->b16, w->b[0]);
+    ntt64_prepare_operand(&w->prep, w->b[0], layer);
+    const int layers[2] = { layer, paired_layer(layer) };
+    ntt64_switch_prepare(&w->sw, layer, layers[1]);
+    ntt64_crt_prepare(&w->crt, layers, 2);
 }
 
-void test_constant_time_layer(int layer) {
-    uint32_t q = ntt64_get_modulus(layer);
-    const int num_samples = 1000;
-    const char* patterns[] = {"zeros", "ones", "max", "alternating", "random1", "random2"};
-    const int num_patterns = 6;
+// ============================================================================
+// STATISTICS
+// ============================================================================
+
+// Welch's t-test, accumulated online (Welford) per class
+typedef struct {
+    double mean[2], m2[2];
+    uint64_t n[2];
+} ct_ttest_t;
+
+static void ttest_push(ct_ttest_t *t, double x, int cls) {
+    t->n[cls]++;
+    const double delta = x - t->mean[cls];
+    t->mean[cls] += delta / (double)t->n[cls];
+    t->m2[cls] += delta * (x - t->mean[cls]);
+}
 
-    printf("\n=== Layer %d (q = %u) ===\n", layer, q);
+static double ttest_value(const ct_ttest_t *t) {
+    if (t->n[0] < CT_MIN_CLASS || t->n[1] < CT_MIN_CLASS) {
+        return 0.0;
+    }
+    const double v0 = t->m2[0] / (double)(t->n[0] - 1);
+    const double v1 = t->m2[1] / (double)(t->n[1] - 1);
+    const double se = sqrt(v0 / (double)t->n[0] + v1 / (double)t->n[1]);
+    return se > 0.0 ? fabs(t->mean[0] - t->mean[1]) / se : 0.0;
+}
 
-    // Storage for timing measurements
-    uint64_t **fwd_times = malloc(num_patterns * sizeof(uint64_t*));
-    uint64_t **inv_times = malloc(num_patterns * sizeof(uint64_t*));
+static int cmp_u64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
 
-    for (int i = 0; i < num_patterns; i++) {
-        fwd_times[i] = malloc(num_samples * sizeof(uint64_t));
-        inv_times[i] = malloc(num_samples * sizeof(uint64_t));
+typedef struct {
+    double t;           // largest |t| over the tests
+    double crop;        // its percentile (100 for all measurements)
+    double median;      // cycles
+} ct_result_t;
+
+/**
+ * Measure one kernel on both classes and test them
+ *
+ * Crop thresholds are percentiles 1 - 2^(-10 (i + 1) / CT_CROPS) of the
+ * warm-up batch, as in dudect: dense near the median, reaching 99.9%.
+ */
+static ct_result_t measure(const ct_backend_t *be, int op, int layer, ct_work_t *w,
+                           int measurements, uint64_t *times) {
+    ct_ttest_t tests[CT_CROPS + 1];
+    double crop_pct[CT_CROPS + 1];
+    uint64_t limit[CT_CROPS + 1];
+    ct_result_t res = { 0.0, 100.0, 0.0 };
+
+    fill_fixed(w, layer);
+    for (int i = 0; i < CT_WARMUP; i++) {
+        if (i % CT_CHUNK == 0) {
+            fill_chunk(w, op, layer);
+        }
+        times[i] = time_call(be, op, layer, w, i % CT_CHUNK);
     }
-
-    // Measure timing for each pattern
-    for (int i = 0; i < num_patterns; i++) {
-        measure_pattern_timing(layer, patterns[i], fwd_times[i], inv_times[i], num_samples);
+    qsort(times, CT_WARMUP, sizeof(uint64_t), cmp_u64);
+    res.median = (double)times[CT_WARMUP / 2];
+    limit[0] = UINT64_MAX;
+    crop_pct[0] = 100.0;
+    for (int i = 0; i < CT_CROPS; i++) {
+        const double p = 1.0 - pow(0.5, 10.0 * (i + 1) / CT_CROPS);
+        limit[i + 1] = times[(size_t)(p * (CT_WARMUP - 1))];
+        crop_pct[i + 1] = 100.0 * p;
     }
 
-    // Analyze results
-    printf("\nForward NTT timing statistics:\n");
-    printf("%-15s %12s %12s %12s %12s\n", "Pattern", "Mean", "StdDev", "Min", "Max");
-    printf("---------------------------------------------------------------\n");
-
-    for (int i = 0; i < num_patterns; i++) {
-        double mean = compute_mean(fwd_times[i], num_samples);
-        double stddev = compute_stddev(fwd_times[i], num_samples, mean);
-
-        uint64_t min_val = fwd_times[i][0];
-        uint64_t max_val = fwd_times[i][0];
-        for (int j = 1; j < num_samples; j++) {
-            if (fwd_times[i][j] < min_val) min_val = fwd_times[i][j];
-            if (fwd_times[i][j] > max_val) max_val = fwd_times[i][j];
+    memset(tests, 0, sizeof(tests));
+    for (int i = 0; i < measurements; i++) {
+        if (i % CT_CHUNK == 0) {
+            fill_chunk(w, op, layer);
+        }
+        const int cls = w->cls[i % CT_CHUNK];
+        const uint64_t dt = time_call(be, op, layer, w, i % CT_CHUNK);
+        for (int k = 0; k <= CT_CROPS; k++) {
+            if (dt < limit[k]) {
+                ttest_push(&tests[k], (double)dt, cls);
+            }
         }
-
-        printf("%-15s %12.0f %12.0f %12llu %12llu\n",
-               patterns[i], mean, stddev,
-               (unsigned long long)min_val, (unsigned long long)max_val);
     }
-
-    printf("\nInverse NTT timing statistics:\n");
-    printf("%-15s %12s %12s %12s %12s\n", "Pattern", "Mean", "StdDev", "Min", "Max");
-    printf("---------------------------------------------------------------\n");
-
-    for (int i = 0; i < num_patterns; i++) {
-        double mean = compute_mean(inv_times[i], num_samples);
-        double stddev = compute_stddev(inv_times[i], num_samples, mean);
-
-        uint64_t min_val = inv_times[i][0];
-        uint64_t max_val = inv_times[i][0];
-        for (int j = 1; j < num_samples; j++) {
-            if (inv_times[i][j] < min_val) min_val = inv_times[i][j];
-            if (inv_times[i][j] > max_val) max_val = inv_times[i][j];
+    for (int k = 0; k <= CT_CROPS; k++) {
+        const double t = ttest_value(&tests[k]);
+        if (t > res.t) {
+            res.t = t;
+            res.crop = crop_pct[k];
         }
-
-        printf("%-15s %12.0f %12.0f %12llu %12llu\n",
-               patterns[i], mean, stddev,
-               (unsigned long long)min_val, (unsigned long long)max_val);
     }
+    return res;
+}
 
-    // Statistical comparison: zeros vs max (should have similar timing)
-    printf("\nStatistical Tests (Welch's t-test):\n");
-    printf("Comparing 'zeros' vs other patterns (lower t-value = more similar):\n");
-    printf("%-15s %15s %15s\n", "Pattern Pair", "Forward t-stat", "Inverse t-stat");
-    printf("---------------------------------------------------------------\n");
-
-    for (int i = 1; i < num_patterns; i++) {
-        double t_fwd = welch_t_test(fwd_times[0], num_samples, fwd_times[i], num_samples);
-        double t_inv = welch_t_test(inv_times[0], num_samples, inv_times[i], num_samples);
-
-        printf("zeros vs %-7s %15.2f %15.2f", patterns[i], t_fwd, t_inv);
-
-        // Flag if timing difference is statistically significant
-        // t > 3.0 is typically considered significant
-        if (t_fwd > 3.0 || t_inv > 3.0) {
-            printf("  ⚠️  TIMING VARIATION DETECTED");
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char **argv) {
+    int measurements = CT_MEASUREMENTS;
+    const char *filter = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            measurements = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-n measurements] [-f filter]\n", argv[0]);
+            return 2;
         }
-        printf("\n");
+    }
+    if (measurements < 2 * CT_MIN_CLASS) {
+        measurements = 2 * CT_MIN_CLASS;
     }
 
-    // Cleanup
-    for (int i = 0; i < num_patterns; i++) {
-        free(fwd_times[i]);
-        free(inv_times[i]);
+    ntt64_init();
+    const int features = ntt64_detect_cpu_features();
+    ct_work_t *w = aligned_alloc(64, sizeof(ct_work_t));
+    uint64_t *times = malloc(CT_WARMUP * sizeof(uint64_t));
+    if (!w || !times) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
     }
-    free(fwd_times);
-    free(inv_times);
-}
+    memset(w, 0, sizeof(*w));
 
-int main(void) {
     printf("========================================\n");
-    printf("Constant-Time Verification Test\n");
+    printf("Constant-Time Regression (fixed vs random)\n");
     printf("========================================\n");
-
-#if HAVE_RDTSC
-    printf("Using RDTSC for high-resolution timing\n");
-#else
-    printf("Using clock_gettime for timing\n");
-#endif
-
-    printf("\nThis test measures timing variations across different input patterns.\n");
-    printf("For constant-time code, all patterns should have similar timing.\n");
-    printf("t-statistic > 3.0 indicates potential timing leakage.\n");
-
-    // Test each layer
-    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
-        test_constant_time_layer(layer);
+    printf("Dispatcher: %s; %d measurements per kernel, %d crops\n",
+           ntt64_get_implementation_name(), measurements, CT_CROPS);
+    printf("|t| > %.1f is measured again and fails if it repeats; > %.1f is flagged\n\n",
+           CT_T_FAIL, CT_T_WARN);
+    printf("%-36s %10s %8s %7s  %s\n", "Kernel", "Median cyc", "max |t|", "crop %", "Result");
+    printf("--------------------------------------------------------------------------\n");
+
+    int kernels = 0, flagged = 0, failed = 0;
+    char name[96];
+    for (size_t k = 0; k < sizeof(BACKENDS) / sizeof(BACKENDS[0]); k++) {
+        const ct_backend_t *be = &BACKENDS[k];
+        if (!backend_supported(be, features)) {
+            printf("%-36s %10s %8s %7s  skipped (CPU)\n", be->name, "-", "-", "-");
+            continue;
+        }
+        const int layers = strncmp(be->name, "f257", 4) == 0 ? 1 : NTT_NUM_LAYERS;
+        for (int op = 0; op < CT_OPS; op++) {
+            if (!backend_has(be, op)) {
+                continue;
+            }
+            // The all-layer transforms cover every layer in one call
+            const int op_layers = op == CT_FORWARD_ALL || op == CT_INVERSE_ALL ? 1 : layers;
+            for (int layer = 0; layer < op_layers; layer++) {
+                if (op_is16(op) && !ntt64_layer_fits16(layer)) {
+                    continue;
+                }
+                if (op_layers == 1) {
+                    snprintf(name, sizeof(name), "%s/%s", be->name, OP_NAMES[op]);
+                } else {
+                    snprintf(name, sizeof(name), "%s/%s/L%d", be->name, OP_NAMES[op], layer);
+                }
+                if (filter && !strstr(name, filter)) {
+                    continue;
+                }
+
+                ct_result_t r = measure(be, op, layer, w, measurements, times);
+                int retested = 0;
+                if (r.t > CT_T_FAIL) {
+                    const ct_result_t again = measure(be, op, layer, w, measurements, times);
+                    retested = 1;
+                    if (again.t <= CT_T_FAIL) {
+                        r = again;
+                    }
+                }
+                const char *verdict = r.t > CT_T_FAIL ? "FAIL"
+                                    : r.t > CT_T_WARN ? "PASS (flagged)" : "PASS";
+                printf("%-36s %10.0f %8.2f %7.2f  %s%s\n", name, r.median, r.t, r.crop,
+                       verdict, retested ? " (retested)" : "");
+                kernels++;
+                flagged += r.t > CT_T_WARN && r.t <= CT_T_FAIL;
+                failed += r.t > CT_T_FAIL;
+            }
+        }
     }
 
     printf("\n========================================\n");
-    printf("Summary:\n");
+    printf("%d kernels: %d passed (%d flagged), %d failed\n", kernels, kernels - failed, flagged,
+           failed);
+    printf("%s\n", failed ? "CONSTANT-TIME CHECK FAILED" : "CONSTANT-TIME CHECK PASSED");
     printf("========================================\n");
-    printf("If t-statistics are all < 3.0, the implementation is likely constant-time.\n");
-    printf("Higher values indicate input-dependent timing variations.\n");
-    printf("\nNote: Some variation is normal due to CPU effects (cache, branch prediction, etc.)\n");
-    printf("but should be minimal for truly constant-time code.\n");
 
-    return 0;
+    free(times);
+    free(w);
+    return failed ? 1 : 0;
 }
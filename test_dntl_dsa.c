@@ -0,0 +1,1018 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <openssl/evp.h>
+#include "dntl_dsa.h"
+#include "dntl_wire.h"
+
+// ============================================================================
+// KNOWN ANSWERS
+// ============================================================================
+//
+// Generated with keyGen / sign of dntl-dsa-nat.py, with the randomness fixed:
+// sk[i] = 1 + (7i + 3) % 5, r1[i] = i, r2[i] = 100 + i, r3[i] = 200 + i,
+// sign's r1[i] = (13i + 5) & 0xFF, m = "DNTL-DSA known answer test". The
+// DNTL_SAMPLER_SHAKE256 entries come from the same run with --sampler shake256.
+
+typedef struct {
+    int level;
+    dntl_sampler_t sampler;
+    const char *pk_seed;
+    const char *u;
+    uint32_t pk_head[8], pk_tail[8];
+    uint32_t sig_head[8], sig_tail[8];
+} dntl_kat_t;
+
+static const dntl_kat_t KATS[] = {
+    { 1, DNTL_SAMPLER_MT19937, "82a4f0cc7e579ee403c86211650941b0",
+         "4434c7de3c21fd23aa3133566552b2a5",
+      { 159, 212, 224, 12, 92, 103, 88, 57 }, { 25, 190, 7, 122, 146, 245, 18, 246 },
+      { 5, 66, 162, 95, 175, 110, 29, 168 }, { 60, 245, 27, 36, 189, 212, 159, 223 } },
+    { 3, DNTL_SAMPLER_MT19937, "57ece348219d4386b21173114f2ea59492cdc852d8b4d27c",
+         "4cba4c80864b3b78efec79eb5d7b346b52dcba8a8d01ef77",
+      { 1, 126, 73, 54, 93, 79, 36, 154 }, { 240, 98, 196, 183, 6, 128, 31, 77 },
+      { 27, 38, 221, 9, 244, 111, 2, 63 }, { 72, 33, 143, 255, 181, 252, 196, 149 } },
+    { 5, DNTL_SAMPLER_MT19937, "db67796b520184b33ef978762ff86bb33150f673e4c1e229e76e11f56aed7ae3",
+         "b7f225f8a950136e2845c1c5c509de723e6682782a1620f733a322f3684fd114",
+      { 143, 227, 244, 4, 205, 172, 72, 218 }, { 201, 85, 211, 184, 178, 204, 121, 206 },
+      { 155, 234, 187, 176, 47, 30, 96, 47 }, { 55, 59, 134, 79, 5, 213, 198, 95 } },
+    { 1, DNTL_SAMPLER_SHAKE256, "82a4f0cc7e579ee403c86211650941b0",
+         "3aee6d66fd3cb9f81983de0760ad988a",
+      { 197, 226, 16, 205, 4, 89, 140, 78 }, { 21, 141, 214, 207, 255, 67, 47, 181 },
+      { 79, 78, 17, 125, 212, 206, 213, 132 }, { 190, 21, 118, 70, 242, 169, 109, 75 } },
+    { 3, DNTL_SAMPLER_SHAKE256, "57ece348219d4386b21173114f2ea59492cdc852d8b4d27c",
+         "49fc52db1759f21249eddcbb7f756638446ea08ec5038100",
+      { 67, 15, 75, 15, 95, 237, 21, 245 }, { 256, 209, 109, 19, 137, 218, 201, 116 },
+      { 103, 5, 40, 19, 243, 124, 6, 76 }, { 103, 199, 67, 99, 72, 211, 88, 238 } },
+    { 5, DNTL_SAMPLER_SHAKE256, "db67796b520184b33ef978762ff86bb33150f673e4c1e229e76e11f56aed7ae3",
+         "6e9836624c4d4beba8eff935637074c0aab37cc2222977ba7251d0282e9c8f18",
+      { 141, 27, 189, 131, 11, 250, 153, 30 }, { 217, 169, 191, 41, 161, 61, 177, 71 },
+      { 64, 101, 204, 1, 23, 81, 161, 115 }, { 5, 2, 154, 16, 178, 145, 108, 205 } },
+};
+
+static const char KAT_MESSAGE[] = "DNTL-DSA known answer test";
+
+static void hex_to_bytes(uint8_t *out, const char *hex, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        unsigned v;
+        sscanf(hex + 2 * i, "%2x", &v);
+        out[i] = (uint8_t)v;
+    }
+}
+
+static int test_known_answers(const dntl_kat_t *kat) {
+    printf("Level %d known answers (%s): ", kat->level,
+           kat->sampler == DNTL_SAMPLER_MT19937 ? "MT19937" : "SHAKE-256");
+
+    dntl_ctx_t *ctx = dntl_ctx_create_sampler(kat->level, kat->sampler);
+    if (!ctx) {
+        printf("FAILED (create)\n");
+        return 0;
+    }
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const size_t n = p->n, s = p->seed_bytes;
+
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t r1[DNTL_MAX_SEED_BYTES], r2[DNTL_MAX_SEED_BYTES], r3[DNTL_MAX_SEED_BYTES];
+    uint8_t rs[DNTL_MAX_SEED_BYTES], pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t expect[DNTL_MAX_SEED_BYTES];
+    int passed = 0;
+
+    for (size_t i = 0; i < n; i++) sk[i] = 1 + (7 * i + 3) % 5;
+    for (size_t i = 0; i < s; i++) {
+        r1[i] = (uint8_t)i;
+        r2[i] = (uint8_t)(100 + i);
+        r3[i] = (uint8_t)(200 + i);
+        rs[i] = (uint8_t)((13 * i + 5) & 0xFF);
+    }
+
+    if (dntl_keygen_from_seeds(ctx, sk, r1, r2, r3, pk, pk_seed) != 0) {
+        printf("FAILED (keygen rejected)\n");
+        goto done;
+    }
+    hex_to_bytes(expect, kat->pk_seed, s);
+    if (memcmp(pk_seed, expect, s) != 0 ||
+        memcmp(pk, kat->pk_head, sizeof(kat->pk_head)) != 0 ||
+        memcmp(pk + n - 8, kat->pk_tail, sizeof(kat->pk_tail)) != 0) {
+        printf("FAILED (public key)\n");
+        goto done;
+    }
+
+    // pk is sk pushed through the compiled PK_C basis
+    dntl_basis_t basis;
+    dntl_basis_compile(ctx, pk_seed, &basis);
+    memcpy(sig, sk, n * sizeof(uint32_t));
+    if (dntl_basis_apply(ctx, &basis, sig) != 0 || memcmp(sig, pk, n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (compiled basis)\n");
+        goto done;
+    }
+    basis.level = kat->level == 1 ? 3 : 1;
+    if (dntl_basis_apply(ctx, &basis, sig) != -1) {
+        printf("FAILED (basis level check)\n");
+        goto done;
+    }
+    basis.level = kat->level;
+    basis.sampler = kat->sampler == DNTL_SAMPLER_MT19937 ? DNTL_SAMPLER_SHAKE256
+                                                         : DNTL_SAMPLER_MT19937;
+    if (dntl_basis_apply(ctx, &basis, sig) != -1) {
+        printf("FAILED (basis sampler check)\n");
+        goto done;
+    }
+
+    if (dntl_sign_from_seed(ctx, (const uint8_t *)KAT_MESSAGE, strlen(KAT_MESSAGE),
+                            sk, pk_seed, pk, rs, sig, u) != 0) {
+        printf("FAILED (sign rejected)\n");
+        goto done;
+    }
+    hex_to_bytes(expect, kat->u, s);
+    if (memcmp(u, expect, s) != 0 ||
+        memcmp(sig, kat->sig_head, sizeof(kat->sig_head)) != 0 ||
+        memcmp(sig + n - 8, kat->sig_tail, sizeof(kat->sig_tail)) != 0) {
+        printf("FAILED (signature)\n");
+        goto done;
+    }
+
+    if (dntl_verify(ctx, (const uint8_t *)KAT_MESSAGE, strlen(KAT_MESSAGE),
+                    pk_seed, pk, sig, u) != 1) {
+        printf("FAILED (verify)\n");
+        goto done;
+    }
+
+    printf("PASSED\n");
+    passed = 1;
+
+done:
+    dntl_ctx_destroy(ctx);
+    return passed;
+}
+
+static int test_round_trip(int level) {
+    printf("Level %d keygen/sign/verify: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const size_t n = p->n, s = p->seed_bytes;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t m[32];
+    int passed = 0;
+
+    for (size_t i = 0; i < sizeof(m); i++) m[i] = (uint8_t)(i * 31 + level);
+
+    if (dntl_keygen(ctx, sk, pk, pk_seed) != 0) {
+        printf("FAILED (keygen)\n");
+        goto done;
+    }
+
+    // Secret alphabet and the two norm bounds of keyGen
+    uint64_t norm2 = 0, mapped2 = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (sk[i] < p->sk_min || sk[i] > p->sk_max || pk[i] < 1 || pk[i] > p->q) {
+            printf("FAILED (key range at %zu)\n", i);
+            goto done;
+        }
+        int64_t d = (int64_t)sk[i] - p->sk_mu;
+        norm2 += (uint64_t)sk[i] * sk[i];
+        mapped2 += (uint64_t)(d * d);
+    }
+    if (norm2 >= (uint64_t)(p->max_norm + 1) * (p->max_norm + 1) ||
+        mapped2 >= (uint64_t)(p->max_mapped_norm + 1) * (p->max_mapped_norm + 1)) {
+        printf("FAILED (secret norm)\n");
+        goto done;
+    }
+
+    if (dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u) != 0) {
+        printf("FAILED (sign)\n");
+        goto done;
+    }
+    if (dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u) != 1) {
+        printf("FAILED (valid signature rejected)\n");
+        goto done;
+    }
+
+    // Any change to message, signature, nonce or key must be rejected
+    m[0] ^= 1;
+    int forged = dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u);
+    m[0] ^= 1;
+    sig[n / 2] = sig[n / 2] % p->q + 1;
+    forged |= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u);
+    sig[n / 2] = sig[n / 2] == 1 ? p->q : sig[n / 2] - 1;
+    u[s - 1] ^= 0x80;
+    forged |= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u);
+    u[s - 1] ^= 0x80;
+    pk[0] = p->q + 1;
+    forged |= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u);
+    if (forged) {
+        printf("FAILED (modified input accepted)\n");
+        goto done;
+    }
+
+    printf("PASSED\n");
+    passed = 1;
+
+done:
+    dntl_ctx_destroy(ctx);
+    return passed;
+}
+
+static int test_rejection(int level) {
+    printf("Level %d zero coefficient rejected: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t r[DNTL_MAX_SEED_BYTES] = { 1 }, pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t m[4] = { 0 };
+
+    // A zero (q) coefficient stays zero through every instance when Q == Q2
+    for (size_t i = 0; i < p->n; i++) sk[i] = p->sk_min;
+    sk[p->n - 1] = p->q;
+    for (size_t i = 0; i < p->n; i++) pk[i] = 1;
+    memset(pk_seed, 7, sizeof(pk_seed));
+
+    int ok = dntl_keygen_from_seeds(ctx, sk, r, r, r, pk, pk_seed) == 1;
+    ok &= dntl_sign_from_seed(ctx, m, sizeof(m), sk, pk_seed, pk, r, sig, u) == 1;
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+static int test_basis_cache(int level) {
+    printf("Level %d public-basis cache: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    enum { KEYS = 3 };
+    uint32_t sk[KEYS][DNTL_MAX_N], pk[KEYS][DNTL_MAX_N], sig[KEYS][DNTL_MAX_N];
+    uint8_t pk_seed[KEYS][DNTL_MAX_SEED_BYTES], u[KEYS][DNTL_MAX_SEED_BYTES];
+    uint8_t m[16] = "cached verify";
+    int ok = 1;
+
+    for (int k = 0; k < KEYS; k++) {
+        dntl_keygen(ctx, sk[k], pk[k], pk_seed[k]);
+        dntl_sign(ctx, m, sizeof(m), sk[k], pk_seed[k], pk[k], sig[k], u[k]);
+    }
+
+    // Room for two keys, with entries malloc'd and pooled on 4 KB and 2 MB pages
+    const dntl_allocator_t *allocs[] = { NULL, &dntl_allocator_pages, &dntl_allocator_huge };
+    for (size_t a = 0; a < sizeof(allocs) / sizeof(allocs[0]) && ok; a++) {
+        size_t entry = dntl_basis_cache_entry_bytes(ctx);
+        ok &= dntl_basis_cache_create_alloc(ctx, entry, allocs[a], -1) == NULL;
+        dntl_basis_cache_t *cache = dntl_basis_cache_create_alloc(ctx, 2 * entry + entry / 2,
+                                                                  allocs[a], dntl_numa_node());
+        dntl_basis_cache_stats_t st;
+        dntl_basis_cache_stats(cache, &st);
+        ok &= st.capacity == 2 && st.entries == 0;
+
+        // A A B C (evicts A) B A (evicts C) C (evicts B)
+        static const int order[] = { 0, 0, 1, 2, 1, 0, 2 };
+        for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+            int k = order[i];
+            ok &= dntl_verify_cached(cache, m, sizeof(m), pk_seed[k], pk[k], sig[k], u[k]) == 1;
+        }
+        dntl_basis_cache_stats(cache, &st);
+        ok &= st.hits == 2 && st.misses == 5 && st.evictions == 3 && st.entries == 2;
+        ok &= st.bytes <= st.max_bytes;
+
+        // Hits give the same answers as dntl_verify(), forgeries included
+        for (int k = 0; k < KEYS && ok; k++) {
+            int j = (k + 1) % KEYS;
+            ok &= dntl_verify_cached(cache, m, sizeof(m), pk_seed[k], pk[k], sig[j], u[j]) ==
+                  dntl_verify(ctx, m, sizeof(m), pk_seed[k], pk[k], sig[j], u[j]);
+            m[0] ^= 1;
+            ok &= dntl_verify_cached(cache, m, sizeof(m), pk_seed[k], pk[k], sig[k], u[k]) == 0;
+            m[0] ^= 1;
+            ok &= dntl_verify_cached(cache, m, sizeof(m), pk_seed[k], pk[k], sig[k], u[k]) == 1;
+        }
+        dntl_basis_cache_destroy(cache);
+    }
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+// Candidate t of dntl_sample_short_key(), rounded in floating point and
+// checked only at the end; 1 if it is short
+static int reference_short_key(const uint8_t *seed, size_t seed_len, const dntl_params_t *p,
+                               uint32_t t, uint32_t *out) {
+    static const char domain[] = "DNTL-DSA short key";
+    const uint8_t index[4] = { (uint8_t)t, (uint8_t)(t >> 8), (uint8_t)(t >> 16),
+                               (uint8_t)(t >> 24) };
+    uint8_t bytes[8 * DNTL_MAX_N];
+    EVP_MD_CTX *md = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(md, EVP_shake256(), NULL);
+    EVP_DigestUpdate(md, domain, sizeof(domain) - 1);
+    EVP_DigestUpdate(md, seed, seed_len);
+    EVP_DigestUpdate(md, index, 4);
+    EVP_DigestFinalXOF(md, bytes, 8 * p->n);
+    EVP_MD_CTX_free(md);
+
+    uint64_t norm2 = 0, mapped2 = 0;
+    for (size_t i = 0; i < p->n; i++) {
+        uint64_t w = 0;
+        for (int b = 7; b >= 0; b--) w = (w << 8) | bytes[8 * i + (size_t)b];
+        uint32_t v = p->sk_min;
+        while (v < p->sk_max) {
+            double z = ((double)v + 0.5 - p->sk_mu) / p->sigma;
+            double cdf = 0.5 * erfc(-z / sqrt(2.0));
+            if (cdf < 1.0 && w < (uint64_t)ldexp(cdf, 64)) break;
+            v++;
+        }
+        out[i] = v;
+        int64_t d = (int64_t)v - p->sk_mu;
+        norm2 += (uint64_t)v * v;
+        mapped2 += (uint64_t)(d * d);
+    }
+    return norm2 < (uint64_t)(p->max_norm + 1) * (p->max_norm + 1) &&
+           mapped2 < (uint64_t)(p->max_mapped_norm + 1) * (p->max_mapped_norm + 1);
+}
+
+static int test_short_key(int level) {
+    printf("Level %d short key sampler: ", level);
+
+    const dntl_params_t *p = dntl_params(level);
+    const uint32_t allowed[] = { 1, 2, 3, 4, 5 };
+    uint32_t sk[DNTL_MAX_N], again[DNTL_MAX_N], ref[DNTL_MAX_N];
+    uint8_t seed[32];
+    int ok = 1, rejected = 0;
+
+    for (int k = 0; k < 20 && ok; k++) {
+        for (size_t i = 0; i < sizeof(seed); i++) seed[i] = (uint8_t)(7 * k + 3 * i + level);
+        ok &= dntl_sample_short_key(seed, sizeof(seed), p->n, p->sk_mu, p->sigma, allowed, 5,
+                                    p->max_norm, p->max_mapped_norm, sk) == 0;
+        ok &= dntl_sample_short_key(seed, sizeof(seed), p->n, p->sk_mu, p->sigma, allowed, 5,
+                                    p->max_norm, p->max_mapped_norm, again) == 0;
+        ok &= memcmp(sk, again, p->n * sizeof(uint32_t)) == 0;
+
+        // The first candidate the full-length reference accepts
+        uint32_t t = 0;
+        while (!reference_short_key(seed, sizeof(seed), p, t, ref)) t++;
+        rejected += (int)t;
+        ok &= memcmp(sk, ref, p->n * sizeof(uint32_t)) == 0;
+    }
+
+    // Invalid arguments
+    const uint32_t unsorted[] = { 1, 3, 2 }, big[] = { 1, DNTL_MAX_ALLOWED_VALUE + 1 };
+    ok &= dntl_sample_short_key(seed, 32, p->n, 3, 0.0, allowed, 5, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, p->n, 3, NAN, allowed, 5, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, 0, 3, 1.0, allowed, 5, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, DNTL_MAX_N + 1, 3, 1.0, allowed, 5, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, p->n, 3, 1.0, allowed, 0, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, p->n, 3, 1.0, unsorted, 3, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(seed, 32, p->n, 3, 1.0, big, 2, 100, 100, sk) == -1;
+    ok &= dntl_sample_short_key(NULL, 0, p->n, 3, 1.0, allowed, 5, 100, 100, sk) == 0;
+
+    if (ok) {
+        printf("PASSED (%d candidates rejected for 20 keys)\n", rejected);
+    } else {
+        printf("FAILED\n");
+    }
+    return ok;
+}
+
+static int test_invalid_parameters(void) {
+    printf("Invalid levels rejected: ");
+    int ok = 1;
+    ok &= dntl_params(2) == NULL;
+    ok &= dntl_params(0) == NULL;
+    ok &= dntl_ctx_create(4) == NULL;
+    ok &= dntl_params(5) != NULL && dntl_params(5)->n == 256 && dntl_params(5)->k == 3;
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok;
+}
+
+static int test_speculative_sign(int level, dntl_sign_pool_t *pool) {
+    printf("Level %d speculative signing: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    enum { M = 8 };
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N], ref_sig[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES], ref_u[DNTL_MAX_SEED_BYTES];
+    uint8_t r1s[M * DNTL_MAX_SEED_BYTES];
+    uint8_t m[16] = "speculative";
+    int ok = 1;
+
+    dntl_keygen(ctx, sk, pk, pk_seed);
+    for (size_t i = 0; i < sizeof(r1s); i++) r1s[i] = (uint8_t)(31 * i + 7);
+
+    // The lowest accepted candidate, with or without workers
+    dntl_sign_from_seed(ctx, m, sizeof(m), sk, pk_seed, pk, r1s, ref_sig, ref_u);
+    dntl_sign_pool_t *pools[2] = { NULL, pool };
+    for (int k = 0; k < 2; k++) {
+        memset(sig, 0, sizeof(sig));
+        ok &= dntl_sign_candidates(pools[k], ctx, m, sizeof(m), sk, pk_seed, pk, r1s, M, sig, u) == 0;
+        ok &= memcmp(sig, ref_sig, p->n * sizeof(uint32_t)) == 0;
+        ok &= memcmp(u, ref_u, p->seed_bytes) == 0;
+    }
+
+    for (size_t c = 1; c <= M; c *= 2) {
+        ok &= dntl_sign_speculative(pool, ctx, m, sizeof(m), sk, pk_seed, pk, c, sig, u) == 0;
+        ok &= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u) == 1;
+    }
+    ok &= dntl_sign_speculative(pool, ctx, m, sizeof(m), sk, pk_seed, pk, 0, sig, u) == -1;
+    ok &= dntl_sign_candidates(pool, ctx, m, sizeof(m), sk, pk_seed, pk, r1s,
+                               DNTL_MAX_CANDIDATES + 1, sig, u) == -1;
+
+    // Every candidate rejected
+    sk[0] = p->q;
+    ok &= dntl_sign_candidates(pool, ctx, m, sizeof(m), sk, pk_seed, pk, r1s, M, sig, u) == M;
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+static int test_verify_batch(int level, dntl_sign_pool_t *pool) {
+    printf("Level %d batch verification: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    enum { KEYS = 3, ITEMS = 12 };
+    uint32_t sk[KEYS][DNTL_MAX_N], pk[KEYS][DNTL_MAX_N], sig[ITEMS][DNTL_MAX_N];
+    uint8_t pk_seed[KEYS][DNTL_MAX_SEED_BYTES], u[ITEMS][DNTL_MAX_SEED_BYTES];
+    uint8_t m[ITEMS][8];
+    dntl_verify_item_t items[ITEMS];
+    int results[ITEMS];
+    int ok = 1;
+
+    for (int k = 0; k < KEYS; k++) {
+        dntl_keygen(ctx, sk[k], pk[k], pk_seed[k]);
+    }
+    // Keys interleaved; items 3, 7 and 10 are forged or malformed
+    for (int i = 0; i < ITEMS; i++) {
+        int k = i % KEYS;
+        memset(m[i], i, sizeof(m[i]));
+        dntl_sign(ctx, m[i], sizeof(m[i]), sk[k], pk_seed[k], pk[k], sig[i], u[i]);
+        items[i] = (dntl_verify_item_t){ m[i], sizeof(m[i]), pk_seed[k], pk[k], sig[i], u[i] };
+    }
+    sig[3][0] = sig[3][0] % p->q + 1;
+    items[7].m = m[6];
+    sig[10][p->n - 1] = p->q + 1;
+
+    dntl_sign_pool_t *pools[2] = { NULL, pool };
+    for (int t = 0; t < 2; t++) {
+        memset(results, 0xff, sizeof(results));
+        ok &= dntl_verify_batch(pools[t], ctx, items, ITEMS, results) == 0;
+        for (int i = 0; i < ITEMS; i++) {
+            const dntl_verify_item_t *it = &items[i];
+            ok &= results[i] == dntl_verify(ctx, it->m, it->m_len, it->pk_seed, it->pk,
+                                            it->sig, it->u);
+            ok &= results[i] == (i != 3 && i != 7 && i != 10);
+        }
+    }
+    ok &= dntl_verify_batch(pool, ctx, items, 0, results) == 0;
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+// A backend doing the basis work at finish on the host, through the public
+// basis API. The fail_start-th start and fail_finish-th finish call fail,
+// the latter after clobbering the chunk.
+typedef struct {
+    const dntl_ctx_t *ctx;
+    const dntl_basis_t *bases;
+    size_t keys;
+    int fail_bind, bound, ok;
+    size_t fail_start, fail_finish;
+    size_t starts, finishes, in_flight, max_in_flight;
+} test_backend_t;
+
+static int test_bind(void *user, const dntl_ctx_t *ctx, const uint8_t *const *seeds,
+                     const dntl_basis_t *bases, size_t keys) {
+    test_backend_t *b = user;
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    dntl_basis_t basis;
+
+    b->ok &= !b->bound && keys > 0;
+    for (size_t k = 0; k < keys; k++) {
+        b->ok &= dntl_basis_compile(ctx, seeds[k], &basis) == 0;
+        for (size_t r = 0; r < p->k; r++) {
+            b->ok &= memcmp(basis.products[r], bases[k].products[r],
+                            p->n * sizeof(uint32_t)) == 0;
+        }
+    }
+    if (b->fail_bind) {
+        return -1;
+    }
+    b->ctx = ctx;
+    b->bases = bases;
+    b->keys = keys;
+    b->bound = 1;
+    return 0;
+}
+
+static int test_start(void *user, const dntl_verify_chunk_t *chunk) {
+    test_backend_t *b = user;
+
+    b->ok &= b->bound && chunk->count > 0 && chunk->count <= DNTL_VERIFY_CHUNK;
+    if (b->starts++ == b->fail_start) {
+        return -1;
+    }
+    if (++b->in_flight > b->max_in_flight) {
+        b->max_in_flight = b->in_flight;
+    }
+    return 0;
+}
+
+static int test_finish(void *user, const dntl_verify_chunk_t *chunk) {
+    test_backend_t *b = user;
+    const dntl_params_t *p = dntl_ctx_params(b->ctx);
+    dntl_basis_t basis;
+
+    b->ok &= b->in_flight > 0;
+    b->in_flight--;
+    if (b->finishes++ == b->fail_finish) {
+        memset(chunk->lhs, 0, chunk->count * p->n * sizeof(uint32_t));
+        return -1;
+    }
+    for (size_t i = 0; i < chunk->count; i++) {
+        if (!chunk->live[i]) {
+            continue;
+        }
+        b->ok &= chunk->key[i] < b->keys;
+        if (dntl_basis_compile(b->ctx, chunk->sc + i * p->seed_bytes, &basis) != 0) {
+            return -1;
+        }
+        dntl_basis_apply(b->ctx, &basis, chunk->lhs + i * p->n);
+        dntl_basis_apply(b->ctx, &b->bases[chunk->key[i]], chunk->rhs + i * p->n);
+    }
+    return 0;
+}
+
+static void test_unbind(void *user) {
+    test_backend_t *b = user;
+
+    b->ok &= b->bound && b->in_flight == 0;
+    b->bound = 0;
+}
+
+static int test_verify_offload(int level, dntl_sign_pool_t *pool) {
+    printf("Level %d offloaded batch verification: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    enum { KEYS = 3, SIGS = 12, ITEMS = 2 * DNTL_VERIFY_CHUNK + 100 };
+    uint32_t sk[KEYS][DNTL_MAX_N], pk[KEYS][DNTL_MAX_N], sig[SIGS][DNTL_MAX_N];
+    uint8_t pk_seed[KEYS][DNTL_MAX_SEED_BYTES], u[SIGS][DNTL_MAX_SEED_BYTES];
+    uint8_t m[SIGS][8];
+    dntl_verify_item_t *items = malloc(ITEMS * sizeof(*items));
+    int *results = malloc(ITEMS * sizeof(*results));
+    int expect[SIGS];
+    int ok = items && results;
+
+    for (int k = 0; k < KEYS && ok; k++) {
+        dntl_keygen(ctx, sk[k], pk[k], pk_seed[k]);
+    }
+    for (int i = 0; i < SIGS && ok; i++) {
+        int k = i % KEYS;
+        memset(m[i], i, sizeof(m[i]));
+        dntl_sign(ctx, m[i], sizeof(m[i]), sk[k], pk_seed[k], pk[k], sig[i], u[i]);
+    }
+    // Every signature many times over; 3, 7 and 10 forged or malformed
+    sig[3][0] = sig[3][0] % p->q + 1;
+    sig[10][p->n - 1] = p->q + 1;
+    for (int i = 0; i < ITEMS && ok; i++) {
+        int s = i % SIGS, k = s % KEYS;
+        items[i] = (dntl_verify_item_t){ s == 7 ? m[6] : m[s], sizeof(m[s]), pk_seed[k],
+                                         pk[k], sig[s], u[s] };
+    }
+    for (int s = 0; s < SIGS && ok; s++) {
+        const dntl_verify_item_t *it = &items[s];
+        expect[s] = dntl_verify(ctx, it->m, it->m_len, it->pk_seed, it->pk, it->sig, it->u);
+        ok &= expect[s] == (s != 3 && s != 7 && s != 10);
+    }
+
+    // On the backend with chunk 1 failing at finish and chunk 2 at start,
+    // then with bind failing, then without a backend
+    test_backend_t tb = { .fail_start = 2, .fail_finish = 1, .ok = 1 };
+    test_backend_t refuse = { .fail_bind = 1, .fail_start = ITEMS, .fail_finish = ITEMS,
+                              .ok = 1 };
+    dntl_verify_backend_t backends[2] = {
+        { test_bind, test_start, test_finish, test_unbind, &tb },
+        { test_bind, test_start, test_finish, test_unbind, &refuse },
+    };
+    for (int t = 0; t < 3 && ok; t++) {
+        memset(results, 0xff, ITEMS * sizeof(*results));
+        ok &= dntl_verify_batch_offload(t < 2 ? &backends[t] : NULL, pool, ctx, items, ITEMS,
+                                        results) == 0;
+        for (int i = 0; i < ITEMS; i++) {
+            ok &= results[i] == expect[i % SIGS];
+        }
+    }
+    ok &= tb.ok && !tb.bound && tb.starts == 3 && tb.finishes == 2 && tb.max_in_flight == 2;
+    ok &= refuse.ok && refuse.starts == 0;
+    ok &= dntl_verify_batch_offload(&backends[0], pool, ctx, items, 0, results) == 0;
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    free(results);
+    free(items);
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+static int test_verify_parallel(int level, dntl_sign_pool_t *pool) {
+    printf("Level %d two-sided verification: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t m[8] = "sides";
+    int ok = 1;
+
+    dntl_keygen(ctx, sk, pk, pk_seed);
+    dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u);
+    ok &= dntl_verify_parallel(pool, ctx, m, sizeof(m), pk_seed, pk, sig, u) == 1;
+    ok &= dntl_verify_parallel(NULL, ctx, m, sizeof(m), pk_seed, pk, sig, u) == 1;
+    m[0] ^= 1;
+    ok &= dntl_verify_parallel(pool, ctx, m, sizeof(m), pk_seed, pk, sig, u) == 0;
+    m[0] ^= 1;
+
+    // A zero in sig only (rejected before expansion when Q == Q2)
+    uint32_t saved = sig[1];
+    sig[1] = p->q;
+    ok &= dntl_verify_parallel(pool, ctx, m, sizeof(m), pk_seed, pk, sig, u) == 0;
+    ok &= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u) == 0;
+    sig[1] = saved;
+    ok &= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u) == 1;
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+// Encode, parse and unpack: 1 if the coefficients and seed come back
+static int wire_round_trip(const dntl_params_t *p, dntl_wire_kind_t kind, const uint32_t *v,
+                           const uint8_t *seed, int coded, uint8_t *buf, size_t *len,
+                           dntl_wire_view_t *view) {
+    uint32_t back[DNTL_MAX_N];
+
+    if (dntl_wire_encode(p, kind, v, seed, coded, buf, dntl_wire_max_bytes(p, kind), len) != 0 ||
+        dntl_wire_parse(buf, *len, view) != 0 || dntl_wire_coeffs(view, back) != 0) {
+        return 0;
+    }
+    return view->params == p && view->kind == kind &&
+           memcmp(back, v, p->n * sizeof(uint32_t)) == 0 &&
+           (kind == DNTL_WIRE_SK || memcmp(view->seed, seed, p->seed_bytes) == 0);
+}
+
+static int test_wire(int level) {
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const size_t n = p->n, s = p->seed_bytes;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N], v[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t pk_buf[1024], sig_buf[1024], sk_buf[1024], buf[1024];
+    size_t pk_len = 0, sig_len = 0, sk_len = 0, len;
+    dntl_wire_view_t pkv, sigv, skv, view;
+    uint8_t m[8] = "wire";
+    int ok = 1;
+
+    dntl_keygen(ctx, sk, pk, pk_seed);
+    dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u);
+
+    // Packed: header, seed, one byte per coefficient, read in place
+    ok &= wire_round_trip(p, DNTL_WIRE_PK, pk, pk_seed, 0, pk_buf, &pk_len, &pkv);
+    ok &= wire_round_trip(p, DNTL_WIRE_SIG, sig, u, 0, sig_buf, &sig_len, &sigv);
+    ok &= pk_len == 1 + s + n && sig_len == 1 + s + n;
+    ok &= pkv.seed == pk_buf + 1 && pkv.body == pk_buf + 1 + s && pkv.n_escapes == 0;
+    ok &= dntl_verify_wire(ctx, m, sizeof(m), &pkv, &sigv) == 1;
+    m[0] ^= 1;
+    ok &= dntl_verify_wire(ctx, m, sizeof(m), &pkv, &sigv) == 0;
+    m[0] ^= 1;
+    ok &= dntl_verify_wire(ctx, m, sizeof(m), &sigv, &pkv) == 0;
+
+    // Secret keys code to fewer bytes; near-uniform signatures stay packed
+    ok &= wire_round_trip(p, DNTL_WIRE_SK, sk, NULL, 1, sk_buf, &sk_len, &skv);
+    ok &= (skv.mode & DNTL_WIRE_CODED) && sk_len < 1 + n;
+    ok &= wire_round_trip(p, DNTL_WIRE_SIG, sig, u, 1, buf, &len, &view) && len <= sig_len;
+
+    // Zeros (0 and Q) go to escapes, and verify as dntl_verify() does
+    memcpy(v, sig, sizeof(v));
+    v[3] = p->q;
+    v[n - 1] = 0;
+    ok &= wire_round_trip(p, DNTL_WIRE_SIG, v, u, 0, buf, &len, &view);
+    ok &= view.n_escapes == 2 && len == sig_len + 3;
+    ok &= dntl_verify_wire(ctx, m, sizeof(m), &pkv, &view) ==
+          dntl_verify(ctx, m, sizeof(m), pk_seed, pk, v, u);
+
+    // A coded public key with escapes: low entropy, so coding pays
+    for (size_t i = 0; i < n; i++) {
+        v[i] = i % 7 ? 7 : p->q;
+    }
+    ok &= wire_round_trip(p, DNTL_WIRE_PK, v, pk_seed, 1, buf, &len, &view);
+    ok &= (view.mode & DNTL_WIRE_CODED) && (view.mode & DNTL_WIRE_ESCAPED);
+    ok &= dntl_verify_wire(ctx, m, sizeof(m), &view, &sigv) ==
+          dntl_verify(ctx, m, sizeof(m), pk_seed, v, sig, u);
+
+    // Malformed encodings and values
+    memcpy(buf, sig_buf, sig_len);
+    ok &= dntl_wire_parse(buf, sig_len - 1, &view) == -1;
+    ok &= dntl_wire_parse(buf, sig_len + 1, &view) == -1;
+    buf[0] ^= 0xC0;
+    ok &= dntl_wire_parse(buf, sig_len, &view) == -1;
+    buf[0] = sig_buf[0] | 0x30;
+    ok &= dntl_wire_parse(buf, sig_len, &view) == -1;
+    buf[0] = sig_buf[0] | DNTL_WIRE_ESCAPED;
+    buf[sig_len] = 1;
+    buf[sig_len + 1] = 5;
+    buf[sig_len + 2] = 4;
+    ok &= dntl_wire_parse(buf, sig_len + 3, &view) == -1;
+    buf[sig_len + 1] = 4;
+    buf[sig_len + 2] = 5;
+    buf[1 + s + 4] = 0;
+    buf[1 + s + 5] = 2;
+    ok &= dntl_wire_parse(buf, sig_len + 3, &view) == -1;
+    buf[1 + s + 5] = 1;
+    ok &= dntl_wire_parse(buf, sig_len + 3, &view) == 0 && view.n_escapes == 2;
+    memcpy(v, sk, sizeof(v));
+    v[0] = 0;
+    ok &= dntl_wire_encode(p, DNTL_WIRE_SK, v, NULL, 0, buf, sizeof(buf), &len) == -1;
+    v[0] = p->q + 1;
+    ok &= dntl_wire_encode(p, DNTL_WIRE_PK, v, pk_seed, 0, buf, sizeof(buf), &len) == -1;
+    ok &= dntl_wire_encode(p, DNTL_WIRE_PK, pk, pk_seed, 0, buf, pk_len - 1, &len) == -1;
+    ok &= dntl_wire_max_bytes(p, (dntl_wire_kind_t)3) == 0;
+
+    dntl_ctx_t *other = dntl_ctx_create(level == 1 ? 3 : 1);
+    ok &= dntl_verify_wire(other, m, sizeof(m), &pkv, &sigv) == 0;
+    dntl_ctx_destroy(other);
+
+    printf("Level %d wire format: %s (pk %zu, sig %zu, coded sk %zu bytes)\n", level,
+           ok ? "PASSED" : "FAILED", pk_len, sig_len, sk_len);
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t len, cap;
+    size_t calls_left;      // sink fails once this reaches 0
+} byte_sink_t;
+
+static int append_sink(void *user, const uint8_t *buf, size_t len) {
+    byte_sink_t *s = user;
+    if (s->calls_left-- == 0) {
+        return -1;
+    }
+    if (s->len + len > s->cap) {
+        s->cap = 2 * (s->len + len);
+        s->buf = realloc(s->buf, s->cap);
+    }
+    memcpy(s->buf + s->len, buf, len);
+    s->len += len;
+    return 0;
+}
+
+static int test_keygen_batch(int level, dntl_sign_pool_t *pool) {
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const uint8_t seed[] = "keygen batch test seed";
+    const size_t count = 4 * DNTL_KEYGEN_SHARD + 5;    // two windows inline
+    byte_sink_t inline_out = { NULL, 0, 0, SIZE_MAX }, pooled = { NULL, 0, 0, SIZE_MAX };
+    byte_sink_t tail = { NULL, 0, 0, SIZE_MAX }, failing = { NULL, 0, 0, 1 };
+    dntl_keygen_stats_t st, pst, fst;
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t u[DNTL_MAX_SEED_BYTES];
+    uint8_t m[8] = "batch";
+    int ok = 1;
+
+    // The same bytes inline and on the pool, and key i alone from first = i
+    ok &= dntl_keygen_batch(NULL, ctx, seed, sizeof(seed), 0, count, append_sink,
+                            &inline_out, &st) == 0;
+    ok &= dntl_keygen_batch(pool, ctx, seed, sizeof(seed), 0, count, append_sink,
+                            &pooled, &pst) == 0;
+    ok &= inline_out.len == pooled.len && memcmp(inline_out.buf, pooled.buf, pooled.len) == 0;
+    ok &= st.keys == count && st.bytes == inline_out.len && pst.attempts == st.attempts;
+    ok &= st.attempts == count + st.pk_rejects;
+
+    // Every record parses and its keys sign and verify
+    size_t pos = 0, records = 0, skip = 0;
+    while (ok && pos < inline_out.len) {
+        dntl_wire_view_t pkv, skv;
+        const size_t pk_len = 1 + p->seed_bytes + p->n;
+        ok &= dntl_wire_parse(inline_out.buf + pos, pk_len, &pkv) == 0 &&
+              pkv.kind == DNTL_WIRE_PK && dntl_wire_coeffs(&pkv, pk) == 0;
+        ok &= pos + pk_len + 1 + p->n <= inline_out.len &&
+              dntl_wire_parse(inline_out.buf + pos + pk_len, 1 + p->n, &skv) == 0 &&
+              skv.kind == DNTL_WIRE_SK && dntl_wire_coeffs(&skv, sk) == 0;
+        if (ok && records % 8 == 0) {
+            ok &= dntl_sign(ctx, m, sizeof(m), sk, pkv.seed, pk, sig, u) == 0 &&
+                  dntl_verify(ctx, m, sizeof(m), pkv.seed, pk, sig, u) == 1;
+        }
+        pos += pk_len + 1 + p->n;
+        records++;
+        if (records == 7) {
+            skip = pos;
+        }
+    }
+    ok &= records == count;
+    ok &= dntl_keygen_batch(pool, ctx, seed, sizeof(seed), 7, count - 7, append_sink,
+                            &tail, NULL) == 0;
+    ok &= tail.len == inline_out.len - skip &&
+          memcmp(tail.buf, inline_out.buf + skip, tail.len) == 0;
+
+    // A failing sink stops the batch after the first window
+    ok &= dntl_keygen_batch(NULL, ctx, seed, sizeof(seed), 0, count, append_sink,
+                            &failing, &fst) == -1;
+    ok &= fst.keys == 4 * DNTL_KEYGEN_SHARD && fst.bytes == failing.len &&
+          memcmp(failing.buf, inline_out.buf, failing.len) == 0;
+    ok &= dntl_keygen_batch(NULL, ctx, NULL, 0, 0, 1, append_sink, &tail, NULL) == -1;
+    ok &= dntl_keygen_batch(NULL, ctx, seed, sizeof(seed), 0, 0, append_sink, &tail, &fst) == 0 &&
+          fst.keys == 0;
+
+    printf("Level %d batch keygen: %s (%zu keys, %llu attempts)\n", level,
+           ok ? "PASSED" : "FAILED", records, (unsigned long long)st.attempts);
+    free(inline_out.buf);
+    free(pooled.buf);
+    free(tail.buf);
+    free(failing.buf);
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+static void store_result(void *user, int valid) {
+    *(int *)user = valid;
+}
+
+static int test_verifier(int level, dntl_sign_pool_t *pool) {
+    printf("Level %d pipelined verification: ", level);
+
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    dntl_basis_cache_t *cache = dntl_basis_cache_create(ctx, 1 << 20);
+    enum { KEYS = 3, ITEMS = 40 };
+    static uint32_t sk[KEYS][DNTL_MAX_N], pk[KEYS][DNTL_MAX_N], sig[ITEMS][DNTL_MAX_N];
+    static uint8_t pk_seed[KEYS][DNTL_MAX_SEED_BYTES], u[ITEMS][DNTL_MAX_SEED_BYTES];
+    static uint8_t m[ITEMS][8];
+    dntl_verify_item_t items[ITEMS];
+    int expected[ITEMS], results[ITEMS];
+    int ok = 1;
+
+    for (int k = 0; k < KEYS; k++) {
+        dntl_keygen(ctx, sk[k], pk[k], pk_seed[k]);
+    }
+    // Message lengths 8, 8, 8, 3 and 0 mix full and partial 4-way hashes;
+    // items 5, 17 and 30 are forged or malformed
+    for (int i = 0; i < ITEMS; i++) {
+        int k = i % KEYS;
+        size_t len = i % 5 == 3 ? 3 : i % 5 == 4 ? 0 : sizeof(m[i]);
+        memset(m[i], i, sizeof(m[i]));
+        dntl_sign(ctx, m[i], len, sk[k], pk_seed[k], pk[k], sig[i], u[i]);
+        items[i] = (dntl_verify_item_t){ m[i], len, pk_seed[k], pk[k], sig[i], u[i] };
+    }
+    sig[5][1] = sig[5][1] % p->q + 1;
+    m[17][0] ^= 1;
+    sig[30][0] = p->q + 1;
+    for (int i = 0; i < ITEMS; i++) {
+        const dntl_verify_item_t *it = &items[i];
+        expected[i] = dntl_verify(ctx, it->m, it->m_len, it->pk_seed, it->pk, it->sig, it->u);
+        ok &= expected[i] == (i != 5 && i != 17 && i != 30);
+    }
+
+    // Callbacks and polling, with and without workers and cache; depth 5
+    // keeps submit running into full queues
+    for (int t = 0; t < 4; t++) {
+        dntl_verifier_t *v = dntl_verifier_create(ctx, t & 1 ? cache : NULL,
+                                                  t & 2 ? pool : NULL, 5);
+        const int poll = t == 1 || t == 2;
+        size_t polled = 0;
+        ok &= v != NULL;
+        memset(results, 0xff, sizeof(results));
+        for (int i = 0; v && i < ITEMS; i++) {
+            while (dntl_verifier_submit(v, &items[i], poll ? NULL : store_result,
+                                        &results[i]) == 1) {
+                dntl_verify_result_t done[ITEMS];
+                dntl_verifier_wait(v);
+                size_t n = dntl_verifier_poll(v, done, ITEMS);
+                for (size_t j = 0; j < n; j++) {
+                    *(int *)done[j].user = done[j].valid;
+                }
+                polled += n;
+                ok &= poll || n == 0;
+            }
+        }
+        if (v) {
+            dntl_verify_result_t done[ITEMS];
+            dntl_verifier_drain(v);
+            size_t n = dntl_verifier_poll(v, done, ITEMS);
+            for (size_t j = 0; j < n; j++) {
+                *(int *)done[j].user = done[j].valid;
+            }
+            polled += n;
+            ok &= polled == (poll ? ITEMS : 0) && memcmp(results, expected, sizeof(results)) == 0;
+        }
+        dntl_verifier_destroy(v);
+    }
+
+    dntl_ctx_t *other = dntl_ctx_create(level == 1 ? 3 : 1);
+    ok &= dntl_verifier_create(other, cache, pool, 4) == NULL;
+    ok &= dntl_verifier_create(ctx, NULL, pool, 0) == NULL;
+    dntl_ctx_destroy(other);
+
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    dntl_basis_cache_destroy(cache);
+    dntl_ctx_destroy(ctx);
+    return ok;
+}
+
+static void benchmark_level(int level) {
+    const int iterations = 20;
+    dntl_ctx_t *ctx = dntl_ctx_create(level);
+    uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+    uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+    uint8_t m[32] = { 0 };
+    int valid = 1;
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        dntl_keygen(ctx, sk, pk, pk_seed);
+    }
+    double keygen_us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+
+    start = clock();
+    for (int i = 0; i < iterations; i++) {
+        m[0] = (uint8_t)i;
+        dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u);
+    }
+    double sign_us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+
+    start = clock();
+    for (int i = 0; i < iterations; i++) {
+        valid &= dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u);
+    }
+    double verify_us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+
+    dntl_basis_cache_t *cache = dntl_basis_cache_create(ctx, 1 << 20);
+    dntl_verify_cached(cache, m, sizeof(m), pk_seed, pk, sig, u);
+    start = clock();
+    for (int i = 0; i < iterations; i++) {
+        valid &= dntl_verify_cached(cache, m, sizeof(m), pk_seed, pk, sig, u);
+    }
+    double cached_us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+    dntl_basis_cache_destroy(cache);
+
+    const dntl_params_t *p = dntl_ctx_params(ctx);
+    const uint32_t allowed[] = { 1, 2, 3, 4, 5 };
+    start = clock();
+    for (int i = 0; i < 10 * iterations; i++) {
+        m[0] = (uint8_t)i;
+        dntl_sample_short_key(m, sizeof(m), p->n, p->sk_mu, p->sigma, allowed, 5, p->max_norm,
+                              p->max_mapped_norm, sk);
+    }
+    double short_key_us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / (10 * iterations);
+
+    printf("  Level %d: keygen %.0f µs, sign %.0f µs, verify %.0f µs (cached key %.0f µs), "
+           "short key %.1f µs%s\n", level, keygen_us, sign_us, verify_us, cached_us,
+           short_key_us, valid ? "" : " (verify FAILED)");
+    dntl_ctx_destroy(ctx);
+}
+
+int main(void) {
+    printf("==============================================\n");
+    printf("DNTL-DSA native engine tests\n");
+    printf("==============================================\n\n");
+
+    int all_passed = 1;
+    static const int levels[] = {1, 3, 5};
+    dntl_sign_pool_t *pool = dntl_sign_pool_create(3);
+
+    for (size_t i = 0; i < sizeof(KATS) / sizeof(KATS[0]); i++) {
+        all_passed &= test_known_answers(&KATS[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        all_passed &= test_round_trip(levels[i]);
+        all_passed &= test_rejection(levels[i]);
+        all_passed &= test_short_key(levels[i]);
+        all_passed &= test_basis_cache(levels[i]);
+        all_passed &= test_speculative_sign(levels[i], pool);
+        all_passed &= test_verify_batch(levels[i], pool);
+        all_passed &= test_verify_offload(levels[i], pool);
+        all_passed &= test_verify_parallel(levels[i], pool);
+        all_passed &= test_verifier(levels[i], pool);
+        all_passed &= test_wire(levels[i]);
+        all_passed &= test_keygen_batch(levels[i], pool);
+    }
+    dntl_sign_pool_destroy(pool);
+    all_passed &= test_invalid_parameters();
+
+    printf("\n");
+    if (all_passed) {
+        printf("ALL TESTS PASSED ✓\n\n");
+    } else {
+        printf("SOME TESTS FAILED ✗\n");
+        return 1;
+    }
+
+    printf("Performance:\n");
+    for (int i = 0; i < 3; i++) {
+        benchmark_level(levels[i]);
+    }
+
+    return 0;
+}
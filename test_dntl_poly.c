@@ -0,0 +1,174 @@
+/**
+ * Test domain-tagged polynomials: lazy transforms cancel, products, sums and
+ * scalings match the schoolbook arithmetic from any mix of domains, modulus
+ * switches reduce the coefficients, and a batch transforms a shared operand
+ * once
+ *
+ * Build: make -f Makefile.dntl test_dntl_poly
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dntl_poly.h"
+
+#define N 128
+#define Q 257
+#define Q2 7681
+#define BATCH 4
+
+// a * b mod (x^N - 1, q)
+static void schoolbook(uint32_t *out, const uint32_t *a, const uint32_t *b, uint32_t q) {
+    uint64_t acc[N] = { 0 };
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            acc[(i + j) % N] = (acc[(i + j) % N] + (uint64_t)a[i] * b[j]) % q;
+        }
+    }
+    for (size_t i = 0; i < N; i++) {
+        out[i] = (uint32_t)acc[i];
+    }
+}
+
+static void random_poly(uint32_t *c, uint32_t q) {
+    for (size_t i = 0; i < N; i++) {
+        c[i] = (uint32_t)rand() % q;
+    }
+}
+
+int main(void) {
+    int pass = 1;
+    ntt_plan_t *plan = ntt_plan_create(N, Q, 3, NTT_PLAN_CYCLIC);
+    ntt_plan_t *plan2 = ntt_plan_create(N, Q2, 17, NTT_PLAN_CYCLIC);
+    ntt_plan_t *other = ntt_plan_create(N / 2, Q, 3, NTT_PLAN_CYCLIC);
+    uint32_t a[N], b[N], c[N], ref[N], expect[N];
+    dntl_poly_t pa, pb, pc;
+
+    printf("=== Domain-tagged polynomials ===\n");
+    if (!plan || !plan2 || !other) {
+        printf("  Plans: FAIL\n");
+        return 1;
+    }
+    srand(82);
+
+    // An inverse and a forward asked for in a row do nothing
+    {
+        random_poly(a, Q);
+        memcpy(ref, a, sizeof(a));
+        dntl_poly_init(&pa, plan, a, DNTL_POLY_NTT);
+        dntl_poly_inverse(&pa);
+        dntl_poly_forward(&pa);
+        int ok = dntl_poly_data(&pa) == a && memcmp(a, ref, sizeof(a)) == 0 &&
+                 pa.transforms == 0;
+        dntl_poly_inverse(&pa);
+        dntl_poly_data(&pa);
+        dntl_poly_forward(&pa);
+        dntl_poly_data(&pa);
+        ok &= memcmp(a, ref, sizeof(a)) == 0 && pa.transforms == 2;
+        printf("  Inverse/forward pair cancels: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // Products: two coefficient operands, then one transformed
+    {
+        random_poly(a, Q);
+        random_poly(b, Q);
+        schoolbook(expect, a, b, Q);
+        dntl_poly_init(&pa, plan, a, DNTL_POLY_COEFF);
+        dntl_poly_init(&pb, plan, b, DNTL_POLY_COEFF);
+        dntl_poly_init(&pc, plan, c, DNTL_POLY_COEFF);
+        int ok = dntl_poly_mul(&pc, &pa, &pb) == 0 && pc.domain == DNTL_POLY_NTT_BITREV &&
+                 pa.transforms == 1 && pb.transforms == 1;
+        dntl_poly_inverse(&pc);
+        ok &= memcmp(dntl_poly_data(&pc), expect, sizeof(expect)) == 0 && pc.transforms == 1;
+
+        // b is still transformed; a fresh natural-order operand joins it
+        random_poly(a, Q);
+        memcpy(ref, a, sizeof(a));
+        dntl_poly_init(&pa, plan, a, DNTL_POLY_COEFF);
+        dntl_poly_forward(&pa);
+        dntl_poly_data(&pa);
+        memcpy(b, ref, sizeof(b));
+        schoolbook(expect, ref, ref, Q);
+        dntl_poly_init(&pb, plan, b, DNTL_POLY_COEFF);
+        ok &= dntl_poly_mul(&pa, &pa, &pb) == 0 && pa.domain == DNTL_POLY_NTT &&
+              pb.transforms == 1;
+        dntl_poly_inverse(&pa);
+        ok &= memcmp(dntl_poly_data(&pa), expect, sizeof(expect)) == 0;
+        printf("  Products from any domain: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // Sums convert b to a's domain; scaling works in any domain
+    {
+        random_poly(a, Q);
+        random_poly(b, Q);
+        for (size_t i = 0; i < N; i++) {
+            expect[i] = (5 * ((a[i] + Q - b[i]) % Q) + a[i] + b[i]) % Q;
+        }
+        memcpy(ref, a, sizeof(a));
+        dntl_poly_init(&pa, plan, a, DNTL_POLY_COEFF);
+        dntl_poly_init(&pb, plan, b, DNTL_POLY_COEFF);
+        dntl_poly_init(&pc, plan, c, DNTL_POLY_COEFF);
+        dntl_poly_forward(&pb);
+        dntl_poly_data(&pb);
+        int ok = dntl_poly_sub(&pc, &pa, &pb) == 0 && pc.domain == DNTL_POLY_COEFF;
+        dntl_poly_forward(&pc);
+        dntl_poly_data(&pc);
+        dntl_poly_scale(&pc, 5 + Q);
+        ok &= dntl_poly_add(&pc, &pc, &pa) == 0 && dntl_poly_add(&pc, &pc, &pb) == 0;
+        dntl_poly_inverse(&pc);
+        ok &= memcmp(dntl_poly_data(&pc), expect, sizeof(expect)) == 0;
+        printf("  Sums and scaling: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // Modulus switches read the coefficients mod the new q
+    {
+        random_poly(a, Q2);
+        for (size_t i = 0; i < N; i++) {
+            expect[i] = a[i] % Q;
+        }
+        dntl_poly_init(&pa, plan2, a, DNTL_POLY_COEFF);
+        dntl_poly_forward(&pa);
+        dntl_poly_data(&pa);
+        int ok = dntl_poly_switch(&pa, plan2) == 0 && pa.transforms == 1 &&
+                 dntl_poly_switch(&pa, plan) == 0 && pa.plan == plan && pa.transforms == 2;
+        dntl_poly_inverse(&pa);
+        ok &= memcmp(dntl_poly_data(&pa), expect, sizeof(expect)) == 0;
+        ok &= dntl_poly_switch(&pa, other) == -1 && pa.plan == plan;
+        printf("  Modulus switches: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // A batch against one shared operand transforms it once
+    {
+        static uint32_t as[BATCH][N], rs[BATCH][N], refs[BATCH][N];
+        dntl_poly_t pas[BATCH], prs[BATCH];
+        random_poly(b, Q);
+        memcpy(ref, b, sizeof(b));
+        dntl_poly_init(&pb, plan, b, DNTL_POLY_COEFF);
+        for (int k = 0; k < BATCH; k++) {
+            random_poly(as[k], Q);
+            schoolbook(refs[k], as[k], ref, Q);
+            dntl_poly_init(&pas[k], plan, as[k], DNTL_POLY_COEFF);
+            dntl_poly_init(&prs[k], plan, rs[k], DNTL_POLY_COEFF);
+        }
+        int ok = dntl_poly_mul_batch(prs, pas, &pb, 1, BATCH) == 0 && pb.transforms == 1;
+        for (int k = 0; k < BATCH; k++) {
+            dntl_poly_inverse(&prs[k]);
+            ok &= memcmp(dntl_poly_data(&prs[k]), refs[k], sizeof(refs[k])) == 0;
+        }
+        dntl_poly_init(&pc, plan2, c, DNTL_POLY_COEFF);
+        ok &= dntl_poly_mul(&pc, &pa, &pc) == -1;
+        ok &= dntl_poly_mul_batch(prs, pas, pas, 2, BATCH) == -1;
+        printf("  Batch with a shared operand: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    ntt_plan_destroy(plan);
+    ntt_plan_destroy(plan2);
+    ntt_plan_destroy(other);
+    printf("\n%s\n", pass ? "All poly tests PASS" : "Some poly tests FAIL");
+    return pass ? 0 : 1;
+}
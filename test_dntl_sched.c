@@ -0,0 +1,273 @@
+/**
+ * Test the work-stealing scheduler: submit and wait from outside and from
+ * inside tasks, spread, schedulers without workers, concurrent callers,
+ * per-node queues, resizing and pinning while tasks run, and the task
+ * counters
+ *
+ * Build: make -f Makefile.dntl test_dntl_sched
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include "dntl_alloc.h"
+#include "dntl_sched.h"
+
+#define TASKS 10000
+#define FANOUT 16
+#define CALLERS 4
+
+static atomic_size_t hits[TASKS];
+
+static void count_task(void *arg) {
+    atomic_fetch_add(&hits[*(const size_t *)arg], 1);
+}
+
+// Submit TASKS tasks to s, for node (-1: dntl_sched_submit()), and wait: 1 if
+// each ran exactly once
+static int run_all_on(dntl_sched_t *s, int node) {
+    static size_t index[TASKS];
+    dntl_sched_group_t g;
+
+    for (size_t i = 0; i < TASKS; i++) {
+        index[i] = i;
+        atomic_store(&hits[i], 0);
+    }
+    dntl_sched_group_init(&g, s);
+    for (size_t i = 0; i < TASKS; i++) {
+        if (node < 0) {
+            dntl_sched_submit(&g, count_task, &index[i]);
+        } else {
+            dntl_sched_submit_node(&g, node, count_task, &index[i]);
+        }
+    }
+    dntl_sched_wait(&g);
+
+    int ok = 1;
+    for (size_t i = 0; i < TASKS; i++) {
+        ok &= atomic_load(&hits[i]) == 1;
+    }
+    return ok;
+}
+
+static int run_all(dntl_sched_t *s) {
+    return run_all_on(s, -1);
+}
+
+// Each task submits FANOUT children in a group of its own and waits for them
+typedef struct {
+    dntl_sched_t *sched;
+    atomic_size_t leaves;
+} nested_job_t;
+
+static void leaf_task(void *arg) {
+    atomic_fetch_add(&((nested_job_t *)arg)->leaves, 1);
+}
+
+static void parent_task(void *arg) {
+    nested_job_t *job = arg;
+    dntl_sched_group_t g;
+
+    dntl_sched_group_init(&g, job->sched);
+    for (int i = 0; i < FANOUT; i++) {
+        dntl_sched_submit(&g, leaf_task, job);
+    }
+    dntl_sched_wait(&g);
+}
+
+static int run_nested(dntl_sched_t *s) {
+    nested_job_t job = { .sched = s };
+    dntl_sched_group_t g;
+
+    atomic_init(&job.leaves, 0);
+    dntl_sched_group_init(&g, s);
+    for (int i = 0; i < FANOUT; i++) {
+        dntl_sched_submit(&g, parent_task, &job);
+    }
+    dntl_sched_wait(&g);
+    return atomic_load(&job.leaves) == FANOUT * FANOUT;
+}
+
+// A shared-index loop, as the batch APIs run it
+typedef struct {
+    atomic_size_t next;
+    atomic_size_t done;
+    atomic_size_t copies;
+} spread_job_t;
+
+static void spread_task(void *arg) {
+    spread_job_t *job = arg;
+    atomic_fetch_add(&job->copies, 1);
+    while (atomic_fetch_add(&job->next, 1) < TASKS) {
+        atomic_fetch_add(&job->done, 1);
+    }
+}
+
+// 1 if every item ran and at most `threads` copies did
+static int run_spread_on(dntl_sched_t *s, int node, size_t threads) {
+    spread_job_t job;
+
+    atomic_init(&job.next, 0);
+    atomic_init(&job.done, 0);
+    atomic_init(&job.copies, 0);
+    dntl_sched_spread_node(s, node, spread_task, &job, threads);
+    return atomic_load(&job.done) == TASKS && atomic_load(&job.copies) >= 1 &&
+           atomic_load(&job.copies) <= (threads ? threads : 1);
+}
+
+static int run_spread(dntl_sched_t *s, size_t threads) {
+    return run_spread_on(s, -1, threads);
+}
+
+typedef struct {
+    dntl_sched_t *sched;
+    int ok;
+} caller_t;
+
+static void *caller_main(void *arg) {
+    caller_t *c = arg;
+    c->ok = 1;
+    for (int i = 0; i < 20; i++) {
+        c->ok &= run_nested(c->sched) && run_spread(c->sched, 8);
+    }
+    return NULL;
+}
+
+int main(void) {
+    int pass = 1;
+
+    printf("=== Work-stealing scheduler ===\n");
+
+    // Every task runs once, from the calling thread and from inside tasks
+    {
+        dntl_sched_t *s = dntl_sched_create(3, 0);
+        dntl_sched_stats_t st;
+        int ok = s != NULL && run_all(s) && run_nested(s);
+        if (s) {
+            dntl_sched_stats(s, &st);
+            ok &= st.workers == 3 && !st.pinned &&
+                  st.executed == TASKS + FANOUT + FANOUT * FANOUT && st.stolen <= st.executed;
+        }
+        printf("  Submit/wait, nested groups, counters: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // No workers (or no scheduler): everything runs in the waiting thread
+    {
+        dntl_sched_t *s = dntl_sched_create(0, 0);
+        dntl_sched_stats_t st;
+        int ok = s != NULL && run_all(s) && run_nested(s) && run_spread(s, 8) &&
+                 run_spread(NULL, 8) && run_spread(NULL, 0);
+        if (s) {
+            dntl_sched_stats(s, &st);
+            ok &= st.workers == 0 && st.stolen == 0;
+        }
+        printf("  Without workers: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // Spread: copies capped by the request and by workers + 1
+    {
+        dntl_sched_t *s = dntl_sched_create(2, 0);
+        int ok = s != NULL;
+        for (size_t threads = 0; ok && threads <= 5; threads++) {
+            ok &= run_spread(s, threads);
+        }
+        spread_job_t job;
+        atomic_init(&job.next, 0);
+        atomic_init(&job.done, 0);
+        atomic_init(&job.copies, 0);
+        if (ok) {
+            dntl_sched_spread(s, spread_task, &job, 100);
+            ok &= atomic_load(&job.copies) <= 3 && atomic_load(&job.done) == TASKS;
+        }
+        printf("  Spread: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // Concurrent callers share the workers
+    {
+        dntl_sched_t *s = dntl_sched_create(2, 0);
+        pthread_t threads[CALLERS];
+        caller_t callers[CALLERS];
+        int ok = s != NULL;
+        int started = 0;
+        for (; ok && started < CALLERS; started++) {
+            callers[started].sched = s;
+            if (pthread_create(&threads[started], NULL, caller_main, &callers[started]) != 0) {
+                ok = 0;
+                break;
+            }
+        }
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+            ok &= callers[i].ok;
+        }
+        printf("  %d concurrent callers: %s\n", CALLERS, ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // Work queued for each node runs, and the nodes account for every worker
+    {
+        dntl_sched_t *s = dntl_sched_create(4, 0);
+        dntl_sched_stats_t st;
+        const int nodes = dntl_numa_nodes();
+        int ok = s != NULL && dntl_sched_nodes(s) == nodes;
+        if (ok) {
+            size_t workers = 0;
+            for (int node = 0; node < nodes; node++) {
+                workers += dntl_sched_node_workers(s, node);
+            }
+            ok &= workers == 4 && dntl_sched_node(s) >= 0 && dntl_sched_node(s) < nodes;
+            for (int node = -1; ok && node < nodes; node++) {
+                ok &= run_all_on(s, node) && run_spread_on(s, node, 5);
+            }
+            dntl_sched_stats(s, &st);
+            ok &= st.nodes == (size_t)nodes && st.remote <= st.executed &&
+                  (nodes > 1 || st.remote == 0);
+        }
+        ok &= dntl_sched_nodes(NULL) == 1 && dntl_sched_node_workers(NULL, 0) == 0;
+        printf("  Node queues and spreads (%d node%s): %s\n", nodes, nodes == 1 ? "" : "s",
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // Resize up, down and to zero, pinned and not, with callers running
+    {
+        dntl_sched_t *s = dntl_sched_create(1, 0);
+        dntl_sched_stats_t st;
+        pthread_t thread;
+        caller_t caller = { .sched = s };
+        int ok = s != NULL && pthread_create(&thread, NULL, caller_main, &caller) == 0;
+        if (ok) {
+            static const size_t sizes[] = { 4, 2, 0, 3, 1 };
+            for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+                const int pin = (int)(i & 1);
+                ok &= dntl_sched_resize(s, sizes[i], pin) == 0;
+                dntl_sched_stats(s, &st);
+                ok &= st.workers == sizes[i] && st.pinned == pin && run_all(s);
+            }
+            pthread_join(thread, NULL);
+            ok &= caller.ok;
+        }
+        printf("  Resize and pinning: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_sched_destroy(s);
+    }
+
+    // The shared scheduler starts once
+    {
+        dntl_sched_t *s = dntl_sched_default();
+        int ok = s != NULL && s == dntl_sched_default() && run_all(s) && run_spread(s, 4);
+        printf("  Default scheduler: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    printf("\n%s\n", pass ? "All scheduler tests PASS" : "Some scheduler tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,221 @@
+/**
+ * Test the hot-path instrumentation: stage calls and inclusive timing,
+ * nested entry points counted once, rejected trials, trial histograms and
+ * rejection reasons, totals over threads (kept after they exit) and reset
+ *
+ * Build: make -f Makefile.dntl test_dntl_stats (always with -DDNTL_STATS)
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "dntl_dsa.h"
+#include "dntl_stats.h"
+#include "ntt64.h"
+#include "ntt64_simd.h"
+
+#define THREADS 4
+#define THREAD_CALLS 100
+
+static void *forward_worker(void *arg) {
+    uint32_t poly[NTT_N] = { 1, 2, 3 };
+    (void)arg;
+    for (int i = 0; i < THREAD_CALLS; i++) {
+        ntt64_forward(poly, 0);
+    }
+    return NULL;
+}
+
+int main(void) {
+    dntl_stats_t st;
+    int pass = 1;
+
+    printf("=== Hot-path instrumentation ===\n");
+    ntt64_init();
+
+    // Nothing recorded yet; the rate is calibrated
+    {
+        dntl_stats_snapshot(&st);
+        int ok = st.enabled && st.ticks_hz > 1e6 && st.threads == 0;
+        for (int i = 0; i < DNTL_STAT_STAGES; i++) {
+            ok &= st.stage[i].calls == 0 && dntl_stats_stage_name(i) != NULL;
+        }
+        ok &= dntl_stats_stage_name(DNTL_STAT_STAGES) == NULL;
+        ok &= dntl_stats_counter_name(DNTL_COUNTERS - 1) != NULL;
+        ok &= dntl_stats_hist_name(DNTL_HISTS - 1) != NULL && dntl_stats_hist_name(-1) == NULL;
+        ok &= dntl_stats_reject_name(DNTL_REJECTS - 1) != NULL &&
+              dntl_stats_reject_name(DNTL_REJECTS) == NULL;
+        printf("  Enabled, %.3f GHz ticks, empty: %s\n", st.ticks_hz * 1e-9, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // One call per entry: ntt64_inverse_bitrev16() runs ntt64_inverse_bitrev()
+    // inside on the scalar path, and still counts once
+    {
+        uint32_t poly[NTT_N] = { 5, 6, 7 };
+        uint16_t poly16[NTT_N] = { 5, 6, 7 };
+        for (int i = 0; i < 10; i++) {
+            ntt64_forward(poly, 1);
+        }
+        ntt64_inverse_bitrev16_scalar(poly16, 0);
+        dntl_stats_snapshot(&st);
+        const int ok = st.stage[DNTL_STAT_NTT_FORWARD].calls == 10 &&
+                       st.stage[DNTL_STAT_NTT_INVERSE].calls == 1 &&
+                       st.stage[DNTL_STAT_NTT_FORWARD].ticks > 0 && st.threads == 1;
+        printf("  ntt64 calls (%llu forward, %llu inverse), nested once: %s\n",
+               (unsigned long long)st.stage[DNTL_STAT_NTT_FORWARD].calls,
+               (unsigned long long)st.stage[DNTL_STAT_NTT_INVERSE].calls, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // keyGen, sign and verify: one call each, a trial per rejection plus
+    // the accepted one, and outer stages at least as long as their trials
+    {
+        dntl_ctx_t *ctx = dntl_ctx_create(1);
+        uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+        uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+        const uint8_t m[] = "instrumented";
+        int ok = ctx != NULL;
+
+        dntl_stats_reset();
+        ok = ok && dntl_keygen(ctx, sk, pk, pk_seed) == 0 &&
+             dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u) == 0 &&
+             dntl_verify(ctx, m, sizeof(m), pk_seed, pk, sig, u) == 1;
+        dntl_stats_snapshot(&st);
+        const dntl_stat_timer_t *s = st.stage;
+        ok &= s[DNTL_STAT_KEYGEN].calls == 1 && s[DNTL_STAT_SIGN].calls == 1 &&
+              s[DNTL_STAT_VERIFY].calls == 1;
+        ok &= s[DNTL_STAT_KEYGEN_TRIAL].calls == 1 + st.count[DNTL_COUNT_KEYGEN_REJECTS];
+        ok &= s[DNTL_STAT_SIGN_TRIAL].calls == 1 + st.count[DNTL_COUNT_SIGN_REJECTS];
+        ok &= s[DNTL_STAT_SHORT_KEY].calls >= 1;
+        ok &= s[DNTL_STAT_BASIS].calls >= 4;
+        ok &= s[DNTL_STAT_NTT_FORWARD].calls >= 1;
+        ok &= s[DNTL_STAT_SIGN].ticks >= s[DNTL_STAT_SIGN_TRIAL].ticks &&
+              s[DNTL_STAT_KEYGEN].ticks >= s[DNTL_STAT_KEYGEN_TRIAL].ticks;
+        printf("  keyGen %llu trials, sign %llu trials, %llu basis runs, %llu short-key "
+               "rejects: %s\n", (unsigned long long)s[DNTL_STAT_KEYGEN_TRIAL].calls,
+               (unsigned long long)s[DNTL_STAT_SIGN_TRIAL].calls,
+               (unsigned long long)s[DNTL_STAT_BASIS].calls,
+               (unsigned long long)st.count[DNTL_COUNT_SHORT_KEY_REJECTS], ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_ctx_destroy(ctx);
+    }
+
+    // Rejection telemetry over several keys: one histogram entry per
+    // operation, at least 2^b trials for an entry in bucket b, every rejected
+    // key or signature attributed to one instance, short-key rejects split
+    // by bound, and row redraws only for the K = 2 instances of level 1
+    {
+        enum { OPS = 20 };
+        dntl_ctx_t *ctx = dntl_ctx_create(1);
+        uint32_t sk[DNTL_MAX_N], pk[DNTL_MAX_N], sig[DNTL_MAX_N];
+        uint8_t pk_seed[DNTL_MAX_SEED_BYTES], u[DNTL_MAX_SEED_BYTES];
+        const uint8_t m[] = "rejections";
+        int ok = ctx != NULL;
+
+        dntl_stats_reset();
+        for (int i = 0; ok && i < OPS; i++) {
+            ok = dntl_keygen(ctx, sk, pk, pk_seed) == 0 &&
+                 dntl_sign(ctx, m, sizeof(m), sk, pk_seed, pk, sig, u) == 0;
+        }
+        dntl_stats_snapshot(&st);
+
+        uint64_t ops[DNTL_HISTS] = { 0 }, min_trials[DNTL_HISTS] = { 0 };
+        for (int h = 0; h < DNTL_HISTS; h++) {
+            for (int b = 0; b < DNTL_HIST_BUCKETS; b++) {
+                ops[h] += st.hist[h][b];
+                min_trials[h] += st.hist[h][b] << b;
+            }
+        }
+        ok &= ops[DNTL_HIST_KEYGEN_TRIALS] == OPS && ops[DNTL_HIST_SIGN_TRIALS] == OPS;
+        ok &= ops[DNTL_HIST_SHORT_KEY_TRIALS] == OPS + st.count[DNTL_COUNT_KEYGEN_SECRET_REDRAWS];
+        ok &= min_trials[DNTL_HIST_KEYGEN_TRIALS] <= st.stage[DNTL_STAT_KEYGEN_TRIAL].calls &&
+              min_trials[DNTL_HIST_SIGN_TRIALS] <= st.stage[DNTL_STAT_SIGN_TRIAL].calls &&
+              min_trials[DNTL_HIST_SHORT_KEY_TRIALS] <=
+                  ops[DNTL_HIST_SHORT_KEY_TRIALS] + st.count[DNTL_COUNT_SHORT_KEY_REJECTS];
+        ok &= st.count[DNTL_COUNT_SHORT_KEY_NORM] + st.count[DNTL_COUNT_SHORT_KEY_MAPPED_NORM] ==
+              st.count[DNTL_COUNT_SHORT_KEY_REJECTS];
+
+        // Plus one rejected key and signature: a zero (q) in the secret stops
+        // both before the first instance
+        const dntl_params_t *p = dntl_ctx_params(ctx);
+        const uint8_t r[DNTL_MAX_SEED_BYTES] = { 1 };
+        const uint64_t rejected[2] = { st.reject[DNTL_REJECT_KEYGEN_ZERO][0],
+                                       st.reject[DNTL_REJECT_SIGN_ZERO][0] };
+        sk[0] = p->q;
+        ok &= dntl_keygen_from_seeds(ctx, sk, r, r, r, pk, pk_seed) == 1 &&
+              dntl_sign_from_seed(ctx, m, sizeof(m), sk, pk_seed, pk, r, sig, u) == 1;
+        dntl_stats_snapshot(&st);
+        ok &= st.reject[DNTL_REJECT_KEYGEN_ZERO][0] == rejected[0] + 1 &&
+              st.reject[DNTL_REJECT_SIGN_ZERO][0] == rejected[1] + 1;
+
+        const int reject_counter[] = { DNTL_COUNT_KEYGEN_REJECTS, DNTL_COUNT_SIGN_REJECTS };
+        for (int r = DNTL_REJECT_KEYGEN_ZERO; r <= DNTL_REJECT_SIGN_ZERO; r++) {
+            uint64_t total = 0;
+            for (int inst = 0; inst < DNTL_STAT_INSTANCES; inst++) {
+                total += st.reject[r][inst];
+            }
+            ok &= total == st.count[reject_counter[r - DNTL_REJECT_KEYGEN_ZERO]] &&
+                  st.reject[r][2] == 0;
+        }
+        ok &= st.reject[DNTL_REJECT_BASIS_ROW][0] > 0 && st.reject[DNTL_REJECT_BASIS_ROW][1] > 0 &&
+              st.reject[DNTL_REJECT_BASIS_ROW][2] == 0;
+        printf("  %d keys: %llu + %llu rejected keys per instance, %llu + %llu row redraws, "
+               "%llu/%llu short-key norm/mapped rejects: %s\n", OPS,
+               (unsigned long long)st.reject[DNTL_REJECT_KEYGEN_ZERO][0],
+               (unsigned long long)st.reject[DNTL_REJECT_KEYGEN_ZERO][1],
+               (unsigned long long)st.reject[DNTL_REJECT_BASIS_ROW][0],
+               (unsigned long long)st.reject[DNTL_REJECT_BASIS_ROW][1],
+               (unsigned long long)st.count[DNTL_COUNT_SHORT_KEY_NORM],
+               (unsigned long long)st.count[DNTL_COUNT_SHORT_KEY_MAPPED_NORM], ok ? "PASS" : "FAIL");
+        pass &= ok;
+        dntl_ctx_destroy(ctx);
+    }
+
+    // Totals over threads, kept after they exit
+    {
+        pthread_t threads[THREADS];
+        dntl_stats_reset();
+        for (int i = 0; i < THREADS; i++) {
+            pthread_create(&threads[i], NULL, forward_worker, NULL);
+        }
+        for (int i = 0; i < THREADS; i++) {
+            pthread_join(threads[i], NULL);
+        }
+        dntl_stats_snapshot(&st);
+        const int ok = st.stage[DNTL_STAT_NTT_FORWARD].calls == THREADS * THREAD_CALLS &&
+                       st.threads == 1 + THREADS;
+        printf("  %d threads: %llu forward calls over %zu threads: %s\n", THREADS,
+               (unsigned long long)st.stage[DNTL_STAT_NTT_FORWARD].calls, st.threads,
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    // Reset zeroes every total
+    {
+        int ok = 1;
+        dntl_stats_reset();
+        dntl_stats_snapshot(&st);
+        for (int i = 0; i < DNTL_STAT_STAGES; i++) {
+            ok &= st.stage[i].calls == 0 && st.stage[i].ticks == 0;
+        }
+        for (int i = 0; i < DNTL_COUNTERS; i++) {
+            ok &= st.count[i] == 0;
+        }
+        for (int i = 0; i < DNTL_HISTS; i++) {
+            for (int j = 0; j < DNTL_HIST_BUCKETS; j++) {
+                ok &= st.hist[i][j] == 0;
+            }
+        }
+        for (int i = 0; i < DNTL_REJECTS; i++) {
+            for (int j = 0; j < DNTL_STAT_INSTANCES; j++) {
+                ok &= st.reject[i][j] == 0;
+            }
+        }
+        printf("  Reset: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    printf("\n%s\n", pass ? "All instrumentation tests PASS" : "Some instrumentation tests FAIL");
+    return pass ? 0 : 1;
+}
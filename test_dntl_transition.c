@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "dntl_transition.h"
+
+// Simple PRNG for testing
+static uint64_t xorshift64_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t rand32(void) {
+    xorshift64_state ^= xorshift64_state << 13;
+    xorshift64_state ^= xorshift64_state >> 7;
+    xorshift64_state ^= xorshift64_state << 17;
+    return (uint32_t)xorshift64_state;
+}
+
+static uint32_t pow_mod(uint32_t base, uint64_t exp, uint32_t q) {
+    uint64_t result = 1, b = base % q;
+    while (exp) {
+        if (exp & 1) result = (result * b) % q;
+        b = (b * b) % q;
+        exp >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+// forward_ntt_naturals / inverse_ntt_naturals of dntl-dsa-nat.py, as O(N^2)
+// evaluations with the same output convention (0 -> q)
+static void naive_naturals(uint32_t *out, const uint32_t *in, size_t n,
+                           uint32_t q, uint32_t root, int inverse) {
+    uint32_t omega = pow_mod(root, (q - 1) / n, q);
+    if (inverse) omega = pow_mod(omega, q - 2, q);
+    uint32_t n_inv = pow_mod((uint32_t)(n % q), q - 2, q);
+
+    for (size_t k = 0; k < n; k++) {
+        uint64_t acc = 0, x = pow_mod(omega, k, q), xp = 1;
+        for (size_t j = 0; j < n; j++) {
+            acc = (acc + (uint64_t)(in[j] % q) * xp) % q;
+            xp = (xp * x) % q;
+        }
+        if (inverse) acc = (acc * n_inv) % q;
+        out[k] = acc ? (uint32_t)acc : q;
+    }
+}
+
+// The chaining step exactly as written in sign/verify/keyGen
+static void reference_transition(uint32_t *poly, size_t n, uint32_t q, uint32_t r,
+                                 uint32_t q2, uint32_t r2) {
+    uint32_t *t = malloc(n * sizeof(uint32_t));
+    naive_naturals(t, poly, n, q, r, 1);
+    naive_naturals(poly, t, n, q2, r2, 0);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t sq = (2 * poly[i]) % q2;
+        sq = sq ? sq : q2;
+        sq = (sq + poly[i]) % q2;
+        poly[i] = sq ? sq : q2;
+    }
+    naive_naturals(t, poly, n, q2, r2, 1);
+    naive_naturals(poly, t, n, q, r, 0);
+    free(t);
+}
+
+static int test_transition(size_t n, uint32_t q, uint32_t r, uint32_t q2, uint32_t r2) {
+    printf("N=%-4zu Q=%-5u R=%-2u Q2=%-5u R2=%-2u ", n, q, r, q2, r2);
+
+    enum { BATCH = 3 };
+    dntl_transition_t *ctx = dntl_transition_create(n, q, r, q2, r2);
+    uint32_t *polys = malloc(BATCH * n * sizeof(uint32_t));
+    uint32_t *ref = malloc(BATCH * n * sizeof(uint32_t));
+    int passed = 1;
+    if (!ctx) {
+        printf("FAILED (create)\n");
+        passed = 0;
+        goto done;
+    }
+
+    // Inputs in [1, q] as produced by forward_ntt_naturals; a few 0s as well
+    for (size_t i = 0; i < BATCH * n; i++) {
+        polys[i] = 1 + rand32() % q;
+        if (i % 17 == 0) polys[i] = 0;
+    }
+    memcpy(ref, polys, BATCH * n * sizeof(uint32_t));
+    for (int p = 0; p < BATCH; p++) {
+        reference_transition(ref + p * n, n, q, r, q2, r2);
+    }
+
+    dntl_transition_apply(ctx, polys);
+    if (memcmp(polys, ref, n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (single)\n");
+        passed = 0;
+        goto done;
+    }
+    dntl_transition_apply_batch(ctx, polys + n, BATCH - 1);
+    if (memcmp(polys, ref, BATCH * n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (batch)\n");
+        passed = 0;
+        goto done;
+    }
+
+    // One-shot form on a fresh copy
+    memcpy(polys, ref, n * sizeof(uint32_t));
+    memcpy(ref, polys, n * sizeof(uint32_t));
+    reference_transition(ref, n, q, r, q2, r2);
+    if (dntl_transition(polys, n, q, r, q2, r2) != 0 ||
+        memcmp(polys, ref, n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (one-shot)\n");
+        passed = 0;
+        goto done;
+    }
+
+    printf("PASSED\n");
+
+done:
+    dntl_transition_destroy(ctx);
+    free(polys);
+    free(ref);
+    return passed;
+}
+
+static int test_invalid_parameters(void) {
+    printf("Invalid parameters rejected: ");
+    uint32_t poly[64], orig[64];
+    for (int i = 0; i < 64; i++) orig[i] = poly[i] = 1 + rand32() % 257;
+
+    int ok = 1;
+    ok &= dntl_transition_create(96, 257, 3, 257, 5) == NULL;     // not a power of two
+    ok &= dntl_transition_create(64, 257, 4, 257, 5) == NULL;     // 4 is not a generator
+    ok &= dntl_transition_create(64, 257, 3, 263, 5) == NULL;     // 64 does not divide 262
+    ok &= dntl_transition(poly, 64, 257, 3, 257, 4) == -1;
+    ok &= memcmp(poly, orig, sizeof(poly)) == 0;
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok;
+}
+
+static void benchmark_transition(size_t n, uint32_t q, uint32_t r, uint32_t q2, uint32_t r2) {
+    const int iterations = 20000;
+    dntl_transition_t *ctx = dntl_transition_create(n, q, r, q2, r2);
+    uint32_t *poly = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) poly[i] = 1 + rand32() % q;
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        dntl_transition_apply(ctx, poly);
+    }
+    double us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+    printf("  N=%-4zu Q=%-5u Q2=%-5u transition: %.3f µs\n", n, q, q2, us);
+
+    free(poly);
+    dntl_transition_destroy(ctx);
+}
+
+int main(void) {
+    printf("==============================================\n");
+    printf("DNTL instance transition tests\n");
+    printf("==============================================\n\n");
+
+    int all_passed = 1;
+
+    // dntl-dsa-nat.py configurations 1, 3, 5: Q = Q2 = 257, R = 3, R2 = 5
+    static const size_t dsa_n[] = {64, 128, 256};
+    for (int i = 0; i < 3; i++) {
+        all_passed &= test_transition(dsa_n[i], 257, 3, 257, 5);
+    }
+
+    // Distinct moduli: the full four-transform path
+    all_passed &= test_transition(64, 257, 3, 7681, 17);
+    all_passed &= test_transition(256, 257, 3, 7681, 17);
+    all_passed &= test_transition(128, 7681, 17, 257, 3);
+    all_passed &= test_transition(256, 12289, 11, 7681, 17);
+
+    all_passed &= test_invalid_parameters();
+
+    printf("\n");
+    if (all_passed) {
+        printf("ALL TESTS PASSED ✓\n\n");
+    } else {
+        printf("SOME TESTS FAILED ✗\n");
+        return 1;
+    }
+
+    printf("Performance:\n");
+    for (int i = 0; i < 3; i++) {
+        benchmark_transition(dsa_n[i], 257, 3, 257, 5);
+    }
+    benchmark_transition(256, 257, 3, 7681, 17);
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+/**
+ * Test the caller-buffer encoders of every codec: same bytes as the
+ * allocating encoders, worst-case size bounds, too-small buffers rejected
+ *
+ * Build: gcc -O2 -o test_encode_into test_encode_into.c sparse_optimal.c sparse_rice.c \
+ *        sparse_adaptive.c sparse_delta.c sparse_phase2.c sparse_phase3.c sparse_ultimate.c \
+ *        sparse_optimal_large.c sparse_dict.c huffman_vector.c dntl_sched.c dntl_alloc.c \
+ *        -lpthread -lm
+ */
+
+#include "huffman_vector.h"
+#include "sparse_adaptive.h"
+#include "sparse_delta.h"
+#include "sparse_optimal.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include "sparse_ultimate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_DIMENSION 65535
+#define BIG_BUFFER    (1 << 20)
+
+/* Allocating encoder, copied out: 0, or -1 if it returned NULL */
+#define ALLOC_ADAPTER(name, type, encode, release)                               \
+    static int name(const int8_t *v, size_t dim, uint8_t *out, size_t *size) {  \
+        type *enc = encode(v, dim);                                              \
+        if (!enc) return -1;                                                     \
+        memcpy(out, enc->data, enc->size);                                       \
+        *size = enc->size;                                                       \
+        release(enc);                                                            \
+        return 0;                                                                \
+    }
+
+ALLOC_ADAPTER(optimal_alloc, sparse_encoded_t, sparse_encode, sparse_free)
+ALLOC_ADAPTER(rice_alloc, sparse_rice_t, sparse_rice_encode, sparse_rice_free)
+ALLOC_ADAPTER(adaptive_alloc, sparse_adaptive_t, sparse_adaptive_encode, sparse_adaptive_free)
+ALLOC_ADAPTER(delta_alloc, sparse_delta_t, sparse_delta_encode, sparse_delta_free)
+ALLOC_ADAPTER(phase2_alloc, sparse_phase2_t, sparse_phase2_encode, sparse_phase2_free)
+ALLOC_ADAPTER(phase3_alloc, sparse_phase3_t, sparse_phase3_encode, sparse_phase3_free)
+ALLOC_ADAPTER(ultimate_alloc, sparse_ultimate_t, sparse_ultimate_encode, sparse_ultimate_free)
+ALLOC_ADAPTER(large_alloc, sparse_optimal_large_t, sparse_optimal_large_encode,
+              sparse_optimal_large_free)
+
+static sparse_phase2_t* phase2_tans_encode(const int8_t *v, size_t dim) {
+    return sparse_phase2_encode_coder(v, dim, SPARSE_PHASE2_TANS);
+}
+static sparse_phase2_t* phase2_dict_rans_encode(const int8_t *v, size_t dim) {
+    return sparse_phase2_encode_dict(v, dim, sparse_dict_builtin(SPARSE_DICT_SIGNATURE),
+                                     SPARSE_PHASE2_RANS);
+}
+static sparse_phase2_t* phase2_dict_tans_encode(const int8_t *v, size_t dim) {
+    return sparse_phase2_encode_dict(v, dim, sparse_dict_builtin(SPARSE_DICT_SIGNATURE),
+                                     SPARSE_PHASE2_TANS);
+}
+ALLOC_ADAPTER(phase2_tans_alloc, sparse_phase2_t, phase2_tans_encode, sparse_phase2_free)
+ALLOC_ADAPTER(phase2_dict_rans_alloc, sparse_phase2_t, phase2_dict_rans_encode,
+              sparse_phase2_free)
+ALLOC_ADAPTER(phase2_dict_tans_alloc, sparse_phase2_t, phase2_dict_tans_encode,
+              sparse_phase2_free)
+
+static int phase2_tans_into(const int8_t *v, size_t dim, uint8_t *out, size_t cap,
+                            size_t *written) {
+    return sparse_phase2_encode_coder_into(v, dim, SPARSE_PHASE2_TANS, out, cap, written);
+}
+static int phase2_dict_rans_into(const int8_t *v, size_t dim, uint8_t *out, size_t cap,
+                                 size_t *written) {
+    return sparse_phase2_encode_dict_into(v, dim, sparse_dict_builtin(SPARSE_DICT_SIGNATURE),
+                                          SPARSE_PHASE2_RANS, out, cap, written);
+}
+static int phase2_dict_tans_into(const int8_t *v, size_t dim, uint8_t *out, size_t cap,
+                                 size_t *written) {
+    return sparse_phase2_encode_dict_into(v, dim, sparse_dict_builtin(SPARSE_DICT_SIGNATURE),
+                                          SPARSE_PHASE2_TANS, out, cap, written);
+}
+
+/* The dense coder takes bytes and no count of nonzeros */
+static int huffman_alloc(const int8_t *v, size_t dim, uint8_t *out, size_t *size) {
+    encoded_result_t *enc = huffman_encode((const uint8_t *)v, dim);
+    if (!enc) return -1;
+    memcpy(out, enc->data, enc->size);
+    *size = enc->size;
+    huffman_free(enc);
+    return 0;
+}
+static int huffman_into(const int8_t *v, size_t dim, uint8_t *out, size_t cap,
+                        size_t *written) {
+    return huffman_encode_into((const uint8_t *)v, dim, out, cap, written);
+}
+static size_t huffman_max(size_t dim, size_t k) {
+    (void)k;
+    return huffman_max_encoded_size(dim);
+}
+
+/* Value alphabets the codecs accept */
+typedef enum { VALUES_PM2, VALUES_PM8, VALUES_ANY } values_t;
+
+typedef struct {
+    const char *name;
+    int (*alloc)(const int8_t *, size_t, uint8_t *, size_t *);
+    int (*into)(const int8_t *, size_t, uint8_t *, size_t, size_t *);
+    size_t (*max_size)(size_t, size_t);
+    values_t values;
+    size_t max_dimension;
+} codec_t;
+
+static const codec_t codecs[] = {
+    { "optimal",        optimal_alloc,          sparse_encode_into,
+      sparse_max_encoded_size, VALUES_PM2, 2048 },
+    { "rice",           rice_alloc,             sparse_rice_encode_into,
+      sparse_rice_max_encoded_size, VALUES_PM2, MAX_DIMENSION },
+    { "adaptive",       adaptive_alloc,         sparse_adaptive_encode_into,
+      sparse_adaptive_max_encoded_size, VALUES_PM8, MAX_DIMENSION },
+    { "delta",          delta_alloc,            sparse_delta_encode_into,
+      sparse_delta_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "phase2 rANS",    phase2_alloc,           sparse_phase2_encode_into,
+      sparse_phase2_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "phase2 tANS",    phase2_tans_alloc,      phase2_tans_into,
+      sparse_phase2_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "phase2 dict/rANS", phase2_dict_rans_alloc, phase2_dict_rans_into,
+      sparse_phase2_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "phase2 dict/tANS", phase2_dict_tans_alloc, phase2_dict_tans_into,
+      sparse_phase2_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "phase3",         phase3_alloc,           sparse_phase3_encode_into,
+      sparse_phase3_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "ultimate",       ultimate_alloc,         sparse_ultimate_encode_into,
+      sparse_ultimate_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "optimal_large",  large_alloc,            sparse_optimal_large_encode_into,
+      sparse_optimal_large_max_encoded_size, VALUES_ANY, MAX_DIMENSION },
+    { "huffman (dense)", huffman_alloc,         huffman_into,
+      huffman_max, VALUES_ANY, MAX_DIMENSION },
+};
+#define N_CODECS (sizeof(codecs) / sizeof(codecs[0]))
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static int8_t random_value(values_t values, int spread) {
+    static const int8_t pm2[4] = { -2, -1, 1, 2 };
+    if (values == VALUES_PM2) return pm2[next_rand() % 4];
+    if (values == VALUES_PM8) {
+        int v = 1 + (int)(next_rand() % 8);
+        return (int8_t)(next_rand() % 2 ? v : -v);
+    }
+    int v = spread ? (int)(next_rand() % 255) - 127 : 1 + (int)(next_rand() % 40);
+    if (v <= 0) v--;
+    return (int8_t)(spread || next_rand() % 2 ? v : -v);
+}
+
+/*
+ * Shapes that push each part of the bounds: typical sparse vectors, fully
+ * dense ones, lone nonzeros at the far ends (longest gaps), all 255 values
+ */
+static size_t make_vector(int8_t *v, values_t values, size_t max_dim, int shape,
+                          size_t *dimension) {
+    size_t dim = 1 + next_rand() % max_dim;
+    if (shape < 2 && max_dim >= 2048) dim = 2048;
+    *dimension = dim;
+    memset(v, 0, dim);
+    size_t k = 0;
+    switch (shape) {
+    case 0:     /* ~5% density */
+    case 1:
+        for (size_t i = 0; i < dim; i++) {
+            if (next_rand() % 20 == 0) v[i] = random_value(values, shape), k++;
+        }
+        break;
+    case 2:     /* dense, narrow or wide values */
+        for (size_t i = 0; i < dim; i++) v[i] = random_value(values, (int)(dim & 1));
+        k = dim;
+        break;
+    case 3:     /* both ends */
+        v[0] = random_value(values, 1);
+        v[dim - 1] = random_value(values, 1);
+        k = dim == 1 ? 1 : 2;
+        break;
+    case 4:     /* every int8 value, then padding */
+        if (values == VALUES_ANY && dim >= 255) {
+            for (int i = 0, x = -128; x <= 127; x++) {
+                if (x) v[dim - 1 - (size_t)i++] = (int8_t)x;
+            }
+        }
+        for (size_t i = 0; i < dim; i++) k += v[i] != 0;
+        break;
+    default:    /* empty */
+        break;
+    }
+    return k;
+}
+
+int main(void) {
+    static int8_t vec[MAX_DIMENSION];
+    static uint8_t ref[BIG_BUFFER], big[BIG_BUFFER];
+    int pass = 1;
+
+    printf("=== Encoding into caller buffers ===\n");
+
+    for (size_t c = 0; c < N_CODECS; c++) {
+        const codec_t *codec = &codecs[c];
+        int same_ok = 1, bound_ok = 1, small_ok = 1;
+        size_t worst = 0, worst_bound = 0;
+        int encoded = 0;
+
+        for (int trial = 0; trial < 600; trial++) {
+            /* Mostly short vectors; every tenth up to the codec's limit */
+            size_t max_dim = codec->max_dimension;
+            if (trial % 10 != 9 && max_dim > 4096) max_dim = 4096;
+            size_t dim;
+            const size_t k = make_vector(vec, codec->values, max_dim, trial % 6, &dim);
+
+            /* Ample buffer: same result as the allocating encoder */
+            size_t ref_size = 0, written = 0;
+            const int ref_ret = codec->alloc(vec, dim, ref, &ref_size);
+            const int ret = codec->into(vec, dim, big, BIG_BUFFER, &written);
+            same_ok &= ret == ref_ret;
+            if (ret < 0 || ref_ret < 0) continue;
+            same_ok &= written == ref_size && memcmp(big, ref, written) == 0;
+            encoded++;
+
+            /* The bound holds */
+            const size_t bound = codec->max_size(dim, k);
+            bound_ok &= bound >= written;
+            if (written > worst) {
+                worst = written;
+                worst_bound = bound;
+            }
+
+            /* Exact-size and one-short heap buffers, so overruns show up
+             * under ASAN */
+            uint8_t *exact = malloc(written);
+            size_t n = 0;
+            small_ok &= codec->into(vec, dim, exact, written, &n) == 0 && n == written &&
+                        memcmp(exact, ref, n) == 0;
+            free(exact);
+            uint8_t *short_buf = malloc(written - 1);
+            small_ok &= codec->into(vec, dim, short_buf, written - 1, &n) == -1;
+            free(short_buf);
+        }
+
+        /* Bad arguments */
+        size_t n;
+        memset(vec, 0, codec->max_dimension);
+        vec[0] = 1;
+        small_ok &= codec->into(NULL, 16, big, BIG_BUFFER, &n) == -1;
+        small_ok &= codec->into(vec, 16, NULL, BIG_BUFFER, &n) == -1;
+        small_ok &= codec->into(vec, 16, big, BIG_BUFFER, NULL) == -1;
+        small_ok &= codec->into(vec, 16, big, 0, &n) == -1;
+        small_ok &= codec->max_size(0, 0) == 0;
+        if (codec->max_size != huffman_max) {
+            small_ok &= codec->max_size(16, 17) == 0;
+            small_ok &= codec->max_size(codec->max_dimension + 1, 1) == 0;
+        }
+
+        const int ok = same_ok && bound_ok && small_ok && encoded > 300;
+        printf("  %-17s %3d encoded, largest %6zu bytes (bound %6zu): %s\n", codec->name,
+               encoded, worst, worst_bound, ok ? "PASS" : "FAIL");
+        if (!same_ok) printf("    differs from the allocating encoder\n");
+        if (!bound_ok) printf("    exceeds max_encoded_size\n");
+        if (!small_ok) printf("    small buffer or bad argument accepted\n");
+        pass &= ok;
+    }
+
+    printf("\n%s\n", pass ? "All encode-into tests PASS" : "Some encode-into tests FAIL");
+    return pass ? 0 : 1;
+}
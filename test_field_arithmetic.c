@@ -1,8 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <time.h>
 #include "ntt64.h"
 
+// Simple PRNG for testing
+static uint64_t xorshift64_state = 123456789;
+
+static uint32_t rand32(void) {
+    xorshift64_state ^= xorshift64_state << 13;
+    xorshift64_state ^= xorshift64_state >> 7;
+    xorshift64_state ^= xorshift64_state << 17;
+    return (uint32_t)xorshift64_state;
+}
+
 // Test modular inverse for a given layer
 int test_inverse(int layer) {
     uint32_t q = ntt64_get_modulus(layer);
@@ -86,6 +97,62 @@ int test_inverse(int layer) {
     return passed;
 }
 
+// Fermat, GCD and batched inversion must agree, including on zeros
+#define INV_TEST_COUNT 600   // spans several batch chunks plus a partial one
+
+int test_inverse_batch(int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
+    static uint32_t values[INV_TEST_COUNT], batch[INV_TEST_COUNT];
+
+    printf("Testing batched inversion for layer %d... ", layer);
+    for (int i = 0; i < INV_TEST_COUNT; i++) {
+        values[i] = (i % 37 == 5) ? q * (uint32_t)(i & 1) : rand32();
+        batch[i] = values[i];
+    }
+    ntt64_inv_mod_batch(batch, INV_TEST_COUNT, layer);
+
+    for (int i = 0; i < INV_TEST_COUNT; i++) {
+        uint32_t fermat = ntt64_inv_mod(values[i], layer);
+        uint32_t gcd = ntt64_inv_mod_gcd(values[i], layer);
+        uint32_t expect = (values[i] % q == 0) ? 0 : 1;
+        if (fermat != gcd || batch[i] != fermat ||
+            ntt64_mul_mod(values[i] % q, fermat, layer) != expect) {
+            printf("FAILED at %d (a=%u: fermat %u, gcd %u, batch %u)\n",
+                   i, values[i], fermat, gcd, batch[i]);
+            return 0;
+        }
+    }
+    printf("PASSED\n");
+    return 1;
+}
+
+void benchmark_inverse(int layer) {
+    const int count = 4096;
+    static uint32_t values[4096];
+    volatile uint32_t sink = 0;
+
+    for (int i = 0; i < count; i++) {
+        values[i] = rand32() % ntt64_get_modulus(layer);
+    }
+
+    clock_t start = clock();
+    for (int i = 0; i < count; i++) sink += ntt64_inv_mod_gcd(values[i], layer);
+    double gcd_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / count;
+
+    start = clock();
+    for (int i = 0; i < count; i++) sink += ntt64_inv_mod(values[i], layer);
+    double fermat_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / count;
+
+    const int rounds = 16;
+    start = clock();
+    for (int r = 0; r < rounds; r++) ntt64_inv_mod_batch(values, count, layer);
+    double batch_ns = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / (count * rounds);
+
+    printf("Layer %d (q=%-10u): GCD %7.1f ns  Fermat %7.1f ns  batch %6.1f ns per inverse\n",
+           layer, ntt64_get_modulus(layer), gcd_ns, fermat_ns, batch_ns);
+    (void)sink;
+}
+
 int main(void) {
     printf("========================================\n");
     printf("Field Arithmetic Test Suite\n");
@@ -100,10 +167,26 @@ int main(void) {
         }
     }
 
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        if (!test_inverse_batch(layer)) {
+            all_passed = 0;
+        }
+    }
+    int registered_layer = ntt64_register_modulus(12289);
+    if (!test_inverse(registered_layer) || !test_inverse_batch(registered_layer)) {
+        all_passed = 0;
+    }
+    printf("\n");
+
     if (all_passed) {
         printf("========================================\n");
         printf("ALL TESTS PASSED ✓\n");
-        printf("========================================\n");
+        printf("========================================\n\n");
+
+        printf("Inversion benchmarks:\n");
+        for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+            benchmark_inverse(layer);
+        }
         return 0;
     } else {
         printf("========================================\n");
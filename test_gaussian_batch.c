@@ -0,0 +1,174 @@
+/**
+ * Test the batch Gaussian sampler: every SIMD path against the scalar one,
+ * seeds independent of their batch, the distribution against libm's
+ * sampler, the clipping bound, and the time per seed
+ *
+ * Build: gcc -O2 -ffp-contract=off -mavx2 -mfma -mavx512f -o test_gaussian_batch \
+ *        test_gaussian_batch.c gaussian_sampler.c gaussian_sampler_avx2.c \
+ *        gaussian_sampler_avx512.c -lm
+ */
+
+#include "gaussian_sampler.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SEEDS 4096
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef void (*batch_fn)(const uint8_t (*)[32], size_t, int (*)[GAUSSIAN_N],
+                         double, double, double);
+
+typedef struct {
+    const char *name;
+    batch_fn fn;
+    int supported;
+} path_t;
+
+static const struct { double mean, stddev, bound; } shapes[] = {
+    { 0.0, 1.0, 6.0 },
+    { 0.0, 12.0, 0.0 },
+    { 3.5, 40.0, 2.0 },
+    { -1.0, 2.0, 0.25 },        /* most candidates rejected */
+    { 0.0, 1e6, 0.0 },
+};
+
+int main(void) {
+    static uint8_t seeds[SEEDS][32];
+    static int ref[SEEDS][GAUSSIAN_N], got[SEEDS][GAUSSIAN_N];
+    int pass = 1;
+
+    path_t paths[] = {
+        { "scalar", gaussian_sample_batch_scalar, 1 },
+#if defined(__AVX2__) && defined(__FMA__)
+        { "avx2", gaussian_sample_batch_avx2,
+          __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") },
+#endif
+#ifdef __AVX512F__
+        { "avx512", gaussian_sample_batch_avx512, __builtin_cpu_supports("avx512f") },
+#endif
+        { "dispatch", gaussian_sample_batch, 1 },
+    };
+    const int n_paths = (int)(sizeof(paths) / sizeof(paths[0]));
+
+    printf("=== Batch Gaussian sampler (dispatch: %s) ===\n", gaussian_sample_batch_path());
+    for (int i = 0; i < SEEDS; i++) {
+        for (int b = 0; b < 32; b++) seeds[i][b] = (uint8_t)next_rand();
+    }
+    memset(seeds[5], 0, 32);    /* the all-zero seed is replaced */
+
+    /* Every path gives the scalar path's samples, for any count */
+    {
+        int ok = 1;
+        for (size_t k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+            gaussian_sample_batch_scalar(seeds, 1000, ref, shapes[k].mean, shapes[k].stddev,
+                                         shapes[k].bound);
+            for (int p = 1; p < n_paths; p++) {
+                if (!paths[p].supported) continue;
+                for (size_t count = 1; count <= 1000; count += count < 20 ? 1 : 327) {
+                    memset(got, 0x5A, sizeof(int) * GAUSSIAN_N * (count + 1));
+                    paths[p].fn(seeds, count, got, shapes[k].mean, shapes[k].stddev,
+                                shapes[k].bound);
+                    ok &= memcmp(got, ref, sizeof(int) * GAUSSIAN_N * count) == 0;
+                    ok &= got[count][0] == 0x5A5A5A5A;
+                }
+                /* A seed's samples do not depend on its place in the batch */
+                paths[p].fn(seeds + 3, 1, got, shapes[k].mean, shapes[k].stddev,
+                            shapes[k].bound);
+                ok &= memcmp(got[0], ref[3], sizeof(ref[3])) == 0;
+            }
+        }
+        printf("  Paths agree bit for bit:");
+        for (int p = 0; p < n_paths; p++) {
+            printf(" %s%s", paths[p].name, paths[p].supported ? "" : " (unsupported)");
+        }
+        printf(": %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Distribution: moments, and sample for sample against gaussian_sample()
+     * (libm): at 6 sigma neither redraws, so the two differ only where the
+     * polynomials and libm round a value to different sides of .5. Seed 5,
+     * all zero, is left out: its first candidate is past 6 sigma, and libm
+     * redraws its pair where the batch sampler keeps the other half */
+    {
+        const double stddev = 12.0, bound = 6.0;
+        double sum = 0, sum_sq = 0;
+        long same = 0;
+        int ok = 1;
+        gaussian_sample_batch(seeds, SEEDS, got, 0.0, stddev, bound);
+        for (int i = 0; i < SEEDS; i++) {
+            int libm[GAUSSIAN_N];
+            gaussian_sample(seeds[i], libm, 0.0, stddev, bound);
+            for (int j = 0; j < GAUSSIAN_N; j++) {
+                const int v = got[i][j];
+                ok &= abs(v) <= (int)(bound * stddev + 0.5);
+                sum += v;
+                sum_sq += (double)v * v;
+                same += i == 5 || v == libm[j];
+            }
+        }
+        const double n = (double)SEEDS * GAUSSIAN_N;
+        const double mean = sum / n, sd = sqrt(sum_sq / n - mean * mean);
+        ok &= fabs(mean) < 0.15 && fabs(sd - 12.0) < 0.15 && same >= (long)(n * 0.9999);
+        printf("  Mean %.3f, sd %.3f; %ld of %.0f samples equal libm's: %s\n",
+               mean, sd, same, n, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Heavy clipping: most candidates redrawn, every kept one in bounds */
+    {
+        const double stddev = 2.0, bound = 0.25;
+        double sum_sq = 0;
+        int ok = 1;
+        gaussian_sample_batch(seeds, SEEDS, got, 0.0, stddev, bound);
+        for (int i = 0; i < SEEDS; i++) {
+            for (int j = 0; j < GAUSSIAN_N; j++) {
+                ok &= abs(got[i][j]) <= 1;
+                sum_sq += (double)got[i][j] * got[i][j];
+            }
+        }
+        /* The bounds are +-0.5: only a candidate of exactly +-0.5 rounds to +-1 */
+        const double frac_ones = sum_sq / ((double)SEEDS * GAUSSIAN_N);
+        ok &= frac_ones < 0.01;
+        printf("  Clipped to 0.25 sigma: every sample in [-1, 1]: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Time per seed of 64 samples */
+    {
+        const int rounds = 20;
+        double t0 = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < SEEDS; i++) gaussian_sample(seeds[i], got[i], 0.0, 12.0, 6.0);
+        }
+        printf("  gaussian_sample (libm): %.0f ns per seed\n",
+               (now_ns() - t0) / rounds / SEEDS);
+        for (int p = 0; p < n_paths; p++) {
+            if (!paths[p].supported) continue;
+            t0 = now_ns();
+            for (int r = 0; r < rounds; r++) paths[p].fn(seeds, SEEDS, got, 0.0, 12.0, 6.0);
+            printf("  batch %-8s: %.0f ns per seed\n", paths[p].name,
+                   (now_ns() - t0) / rounds / SEEDS);
+        }
+    }
+
+    printf("\n%s\n", pass ? "All batch Gaussian tests PASS" : "Some batch Gaussian tests FAIL");
+    return pass ? 0 : 1;
+}
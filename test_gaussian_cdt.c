@@ -0,0 +1,181 @@
+/**
+ * Test the CDT discrete Gaussian sampler: table thresholds against the
+ * exact probabilities, sample frequencies on keygen's supports, edge cases
+ * and bad parameters, and the time per seed against gaussian_sample()
+ *
+ * Build: gcc -O2 -o test_gaussian_cdt test_gaussian_cdt.c gaussian_sampler.c -lm
+ */
+
+#include "gaussian_sampler.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define SEEDS 16384
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void random_seed(uint8_t seed[32]) {
+    for (int b = 0; b < 32; b++) seed[b] = (uint8_t)next_rand();
+}
+
+/* Chi-square of SEEDS * GAUSSIAN_N samples against the discrete Gaussian;
+ * values outside the support fail outright */
+static double chi_square(const gaussian_cdt_t *cdt, double mean, double sigma) {
+    long hits[GAUSSIAN_CDT_MAX] = {0};
+    double weight[GAUSSIAN_CDT_MAX], total = 0;
+    for (int i = 0; i < cdt->count; i++) {
+        const double d = cdt->values[i] - mean;
+        weight[i] = exp(-d * d / (2 * sigma * sigma));
+        total += weight[i];
+    }
+    for (int s = 0; s < SEEDS; s++) {
+        uint8_t seed[32];
+        int out[GAUSSIAN_N];
+        random_seed(seed);
+        gaussian_sample_cdt(cdt, seed, out);
+        for (int j = 0; j < GAUSSIAN_N; j++) {
+            int i = 0;
+            while (i < cdt->count && cdt->values[i] != out[j]) i++;
+            if (i == cdt->count) return INFINITY;
+            hits[i]++;
+        }
+    }
+    const double n = (double)SEEDS * GAUSSIAN_N;
+    double chi = 0;
+    for (int i = 0; i < cdt->count; i++) {
+        const double expect = n * weight[i] / total;
+        if (expect == 0) {
+            if (hits[i]) return INFINITY;
+            continue;
+        }
+        chi += (hits[i] - expect) * (hits[i] - expect) / expect;
+    }
+    return chi;
+}
+
+int main(void) {
+    int pass = 1;
+    const int keygen[] = { 1, 2, 3, 4, 5 };
+
+    printf("=== CDT discrete Gaussian sampler ===\n");
+
+    /* Thresholds: increasing, and 2^64 times the cumulative probability */
+    {
+        gaussian_cdt_t cdt;
+        int ok = gaussian_cdt_init(&cdt, 3.0, 1.3, keygen, 5) == 0 && cdt.count == 5;
+        double total = 0, cumulative = 0;
+        for (int i = 0; i < 5; i++) total += exp(-(keygen[i] - 3.0) * (keygen[i] - 3.0) / 3.38);
+        for (int i = 0; i < 4; i++) {
+            cumulative += exp(-(keygen[i] - 3.0) * (keygen[i] - 3.0) / 3.38);
+            ok &= fabs(ldexp((double)cdt.threshold[i], -64) - cumulative / total) < 1e-15;
+            ok &= i == 0 || cdt.threshold[i] > cdt.threshold[i - 1];
+        }
+        /* Symmetric about the mean: P(<= 2) + P(<= 3) = 1, so the two
+         * thresholds add up to 2^64, which wraps to 0, give or take a unit */
+        const uint64_t sum = cdt.threshold[1] + cdt.threshold[2];
+        ok &= sum + 1 <= 2;
+        printf("  Thresholds for sigma 1.3 over 1..5: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Frequencies, against the 0.1% critical chi-square for count - 1 degrees
+     * of freedom */
+    {
+        static const struct { double mean, sigma; int support[10]; int count; } cases[] = {
+            { 3.0, 1.0, { 1, 2, 3, 4, 5 }, 5 },
+            { 3.0, 1.3, { 1, 2, 3, 4, 5 }, 5 },
+            { 0.0, 2.0, { -4, -3, -2, -1, 0, 1, 2, 3, 4 }, 9 },
+            { 0.5, 1.0, { 4, -2, 0, 3, -1, 1, 2 }, 7 },     /* unsorted */
+            { 0.0, 0.3, { 0, 1, 12 }, 3 },                  /* 12 has probability 0 */
+        };
+        const double critical[] = { 18.5, 18.5, 26.1, 22.5, 13.8 };
+        for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+            gaussian_cdt_t cdt;
+            int ok = gaussian_cdt_init(&cdt, cases[k].mean, cases[k].sigma, cases[k].support,
+                                       cases[k].count) == 0;
+            const double chi = ok ? chi_square(&cdt, cases[k].mean, cases[k].sigma) : INFINITY;
+            ok &= chi < critical[k];
+            printf("  mean %.1f sigma %.1f over %d values: chi-square %.2f: %s\n",
+                   cases[k].mean, cases[k].sigma, cases[k].count, chi, ok ? "PASS" : "FAIL");
+            pass &= ok;
+        }
+    }
+
+    /* A single value, the all-zero seed, and repeatability */
+    {
+        gaussian_cdt_t one, cdt;
+        const int seven = 7;
+        uint8_t seed[32] = {0};
+        int a[GAUSSIAN_N], b[GAUSSIAN_N];
+        int ok = gaussian_cdt_init(&one, 0.0, 1.0, &seven, 1) == 0;
+        gaussian_sample_cdt(&one, seed, a);
+        for (int j = 0; j < GAUSSIAN_N; j++) ok &= a[j] == 7;
+        ok &= gaussian_cdt_init(&cdt, 3.0, 1.3, keygen, 5) == 0;
+        gaussian_sample_cdt(&cdt, seed, a);
+        gaussian_sample_cdt(&cdt, seed, b);
+        ok &= memcmp(a, b, sizeof(a)) == 0;
+        int distinct = 0;
+        for (int j = 1; j < GAUSSIAN_N; j++) distinct |= a[j] != a[0];
+        ok &= distinct;
+        printf("  Single value, zero seed, repeatable: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Bad parameters */
+    {
+        gaussian_cdt_t cdt;
+        int big[GAUSSIAN_CDT_MAX + 1] = {0};
+        int ok = gaussian_cdt_init(&cdt, 0.0, 0.0, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, -1.0, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, NAN, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, INFINITY, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, NAN, 1.0, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, 1.0, keygen, 0) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, 1.0, big, GAUSSIAN_CDT_MAX + 1) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, 1.0, NULL, 5) == -1 &&
+                 gaussian_cdt_init(NULL, 0.0, 1.0, keygen, 5) == -1 &&
+                 gaussian_cdt_init(&cdt, 0.0, 1.0, big, GAUSSIAN_CDT_MAX) == 0;
+        printf("  Bad parameters rejected: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Time per seed of 64 samples */
+    {
+        static uint8_t seeds[4096][32];
+        static int out[4096][GAUSSIAN_N];
+        gaussian_cdt_t cdt;
+        gaussian_cdt_init(&cdt, 3.0, 1.3, keygen, 5);
+        for (int i = 0; i < 4096; i++) random_seed(seeds[i]);
+        const int rounds = 20;
+        double t0 = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < 4096; i++) gaussian_sample(seeds[i], out[i], 3.0, 1.3, 0.0);
+        }
+        const double libm = (now_ns() - t0) / rounds / 4096;
+        t0 = now_ns();
+        for (int r = 0; r < rounds; r++) {
+            for (int i = 0; i < 4096; i++) gaussian_sample_cdt(&cdt, seeds[i], out[i]);
+        }
+        const double table = (now_ns() - t0) / rounds / 4096;
+        printf("  gaussian_sample: %.0f ns per seed, CDT over 1..5: %.0f ns per seed\n",
+               libm, table);
+    }
+
+    printf("\n%s\n", pass ? "All CDT sampler tests PASS" : "Some CDT sampler tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/**
+ * Test the Gaussian stream: fills in pieces against one fill, the first row
+ * against the batch sampler, jumps (commuting with the generator, linear,
+ * disjoint substreams), threaded substreams against sequential ones, and
+ * the time per sample
+ *
+ * Build: gcc -O2 -ffp-contract=off -o test_gaussian_stream test_gaussian_stream.c \
+ *        gaussian_sampler.c -lm -lpthread
+ */
+
+#include "gaussian_sampler.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LENGTH 100000
+#define THREADS 4
+
+static uint64_t rng_state = 0xD1B54A32D192ED03ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Two generator steps: one candidate pair, both of its samples taken */
+static void stream_step(gaussian_stream_t *st) {
+    int v;
+    gaussian_stream_fill(st, &v, 1);
+    gaussian_stream_fill(st, &v, 1);
+}
+
+typedef struct {
+    gaussian_stream_t st;
+    int *out;
+    size_t count;
+} job_t;
+
+static void *fill_job(void *arg) {
+    job_t *job = arg;
+    gaussian_stream_fill(&job->st, job->out, job->count);
+    return NULL;
+}
+
+int main(void) {
+    static int whole[LENGTH], pieces[LENGTH];
+    uint8_t seed[32];
+    int pass = 1;
+
+    printf("=== Gaussian stream sampler ===\n");
+    for (int b = 0; b < 32; b++) seed[b] = (uint8_t)next_rand();
+
+    /* Any split of the fills gives the same sequence, with and without
+     * rejection (bound 0.7 sigma keeps about half the candidates) */
+    {
+        static const double bounds[] = { 0.0, 6.0, 0.7 };
+        int ok = 1;
+        for (int k = 0; k < 3; k++) {
+            gaussian_stream_t a, b;
+            gaussian_stream_init(&a, seed, 1.5, 9.0, bounds[k]);
+            gaussian_stream_init(&b, seed, 1.5, 9.0, bounds[k]);
+            gaussian_stream_fill(&a, whole, LENGTH);
+            for (size_t at = 0; at < LENGTH;) {
+                size_t piece = next_rand() % 9;        /* includes empty fills */
+                if (piece > LENGTH - at) piece = LENGTH - at;
+                gaussian_stream_fill(&b, pieces + at, piece);
+                at += piece;
+            }
+            ok &= memcmp(whole, pieces, sizeof(whole)) == 0;
+            for (int i = 0; bounds[k] > 0 && i < LENGTH; i++) {
+                ok &= fabs(whole[i] - 1.5) <= bounds[k] * 9.0 + 0.5;
+            }
+        }
+        printf("  Fills in pieces match one fill: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* The first GAUSSIAN_N samples are the batch sampler's row */
+    {
+        uint8_t seeds[3][32];
+        int rows[3][GAUSSIAN_N], got[GAUSSIAN_N];
+        int ok = 1;
+        memcpy(seeds[0], seed, 32);
+        memset(seeds[1], 0, 32);
+        for (int b = 0; b < 32; b++) seeds[2][b] = (uint8_t)next_rand();
+        gaussian_sample_batch(seeds, 3, rows, 0.0, 3.0, 1.0);
+        for (int i = 0; i < 3; i++) {
+            gaussian_stream_t st;
+            gaussian_stream_init(&st, seeds[i], 0.0, 3.0, 1.0);
+            gaussian_stream_fill(&st, got, GAUSSIAN_N);
+            ok &= memcmp(got, rows[i], sizeof(got)) == 0;
+        }
+        printf("  First row equals gaussian_sample_batch(): %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Jumps are powers of the generator: they commute with a step and are
+     * linear over GF(2) in the state */
+    {
+        gaussian_stream_t a, b, x, y, xy;
+        int ok = 1;
+        gaussian_stream_init(&a, seed, 0.0, 1.0, 0.0);
+        b = a;
+        stream_step(&a);
+        gaussian_stream_jump(&a);
+        gaussian_stream_jump(&b);
+        stream_step(&b);
+        ok &= memcmp(a.s, b.s, sizeof(a.s)) == 0;
+
+        gaussian_stream_init(&a, seed, 0.0, 1.0, 0.0);
+        b = a;
+        stream_step(&a);
+        gaussian_stream_long_jump(&a);
+        gaussian_stream_long_jump(&b);
+        stream_step(&b);
+        ok &= memcmp(a.s, b.s, sizeof(a.s)) == 0;
+
+        x = a;
+        y = a;
+        for (int w = 0; w < 4; w++) y.s[w] = next_rand();
+        xy = x;
+        for (int w = 0; w < 4; w++) xy.s[w] ^= y.s[w];
+        gaussian_stream_jump(&x);
+        gaussian_stream_jump(&y);
+        gaussian_stream_jump(&xy);
+        for (int w = 0; w < 4; w++) ok &= xy.s[w] == (x.s[w] ^ y.s[w]);
+
+        /* Known answers: the transition matrix of xoshiro256 raised to 2^128
+         * and 2^192 by repeated squaring, applied to the state {1, 2, 3, 4} */
+        static const uint64_t after_jump[4] = {
+            0x8c7a153956b5f3d1ULL, 0x701f1a713401d85eULL,
+            0x6527f66a65469085ULL, 0x8386b786c4408050ULL };
+        static const uint64_t after_long_jump[4] = {
+            0x096a8eb71295a400ULL, 0xdbf84991e50f4516ULL,
+            0x534ee745810d2a0eULL, 0x31655ca1a2215bf1ULL };
+        gaussian_stream_t k = a;
+        for (int w = 0; w < 4; w++) k.s[w] = (uint64_t)w + 1;
+        gaussian_stream_jump(&k);
+        ok &= memcmp(k.s, after_jump, sizeof(after_jump)) == 0;
+        for (int w = 0; w < 4; w++) k.s[w] = (uint64_t)w + 1;
+        gaussian_stream_long_jump(&k);
+        ok &= memcmp(k.s, after_long_jump, sizeof(after_long_jump)) == 0;
+        printf("  Jumps: known answers, commute with the generator, linear: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Substreams filled on threads equal the same substreams filled in turn,
+     * and do not repeat each other */
+    {
+        static int threaded[THREADS][LENGTH], serial[THREADS][LENGTH];
+        job_t jobs[THREADS];
+        pthread_t tid[THREADS];
+        gaussian_stream_t base;
+        int ok = 1;
+        gaussian_stream_init(&base, seed, 0.0, 20.0, 6.0);
+        for (int t = 0; t < THREADS; t++) {
+            jobs[t].st = base;
+            for (int j = 0; j < t; j++) gaussian_stream_jump(&jobs[t].st);
+            jobs[t].out = threaded[t];
+            jobs[t].count = LENGTH;
+            ok &= pthread_create(&tid[t], NULL, fill_job, &jobs[t]) == 0;
+        }
+        for (int t = 0; t < THREADS; t++) pthread_join(tid[t], NULL);
+
+        gaussian_stream_t st = base;
+        for (int t = 0; t < THREADS; t++) {
+            gaussian_stream_t sub = st;
+            gaussian_stream_fill(&sub, serial[t], LENGTH);
+            gaussian_stream_jump(&st);
+            ok &= memcmp(serial[t], threaded[t], sizeof(serial[t])) == 0;
+        }
+        for (int t = 1; t < THREADS; t++) {
+            ok &= memcmp(threaded[0], threaded[t], 64 * sizeof(int)) != 0;
+        }
+
+        double sum = 0, sum_sq = 0;
+        for (int t = 0; t < THREADS; t++) {
+            for (int i = 0; i < LENGTH; i++) {
+                sum += threaded[t][i];
+                sum_sq += (double)threaded[t][i] * threaded[t][i];
+            }
+        }
+        const double n = (double)THREADS * LENGTH;
+        const double mean = sum / n, sd = sqrt(sum_sq / n - mean * mean);
+        ok &= fabs(mean) < 0.3 && fabs(sd - 20.0) < 0.2;
+        printf("  %d substreams on threads: mean %.3f, sd %.3f, same as in turn: %s\n",
+               THREADS, mean, sd, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Time per sample; a jump */
+    {
+        gaussian_stream_t st;
+        gaussian_stream_init(&st, seed, 0.0, 12.0, 6.0);
+        double t0 = now_ns();
+        for (int r = 0; r < 10; r++) gaussian_stream_fill(&st, whole, LENGTH);
+        const double per_sample = (now_ns() - t0) / (10.0 * LENGTH);
+        t0 = now_ns();
+        for (int r = 0; r < 1000; r++) gaussian_stream_jump(&st);
+        printf("  Fill: %.1f ns per sample; jump: %.0f ns\n", per_sample, (now_ns() - t0) / 1000);
+    }
+
+    printf("\n%s\n", pass ? "All Gaussian stream tests PASS" : "Some Gaussian stream tests FAIL");
+    return pass ? 0 : 1;
+}
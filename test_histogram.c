@@ -0,0 +1,142 @@
+/**
+ * Test the shared histogram kernels: narrow and wide inputs of any length
+ * and alignment against a counting loop, counts added to what the table
+ * held, and their speed on secret-like, sparse-value and byte inputs
+ *
+ * Build: gcc -O2 -march=native -o test_histogram test_histogram.c
+ *        (-mavx2 or no flag for the AVX2 and portable paths)
+ */
+
+#include "histogram.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_LENGTH 5000
+
+static uint64_t rng_state = 0x853C49E6748FEA9BULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The loop the encoders used to count with */
+static __attribute__((noinline)) void count_loop(const int8_t *v, size_t n, uint32_t *hist) {
+    for (size_t i = 0; i < n; i++) {
+        hist[(uint8_t)(v[i] + 128)]++;
+    }
+}
+
+/* n values of a shape: 0 one value, 1 {-3..3}, 2 mostly-zero {-2..2},
+ * 3 spanning exactly HIST_NARROW_BINS bins, 4 one more, 5 uniform bytes,
+ * 6 geometric around 0 */
+static void fill(int8_t *v, size_t n, int shape) {
+    const int8_t base = (int8_t)(next_rand() % 200 - 100);
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t r = next_rand();
+        switch (shape) {
+        case 0: v[i] = base; break;
+        case 1: v[i] = (int8_t)(r % 7) - 3; break;
+        case 2: v[i] = r % 8 ? 0 : (int8_t)(r % 5) - 2; break;
+        case 3: v[i] = (int8_t)(base + (int)(r % HIST_NARROW_BINS)); break;
+        case 4: v[i] = (int8_t)(base + (int)(r % (HIST_NARROW_BINS + 1))); break;
+        case 5: v[i] = (int8_t)r; break;
+        default: {
+            const int mag = r & 0xFF ? __builtin_ctzll(r | (1ULL << 40)) : 60;
+            v[i] = (int8_t)((r >> 63) ? -(mag % 100) : mag % 100);
+        }
+        }
+    }
+    if (shape == 3 && n > 1) {
+        v[0] = base;
+        v[1] = (int8_t)(base + HIST_NARROW_BINS - 1);
+    }
+}
+
+/* Mean time of reps counts of n values, ns */
+static double time_counts(const int8_t *v, size_t n, int kernel, int reps) {
+    static uint32_t hist[256];
+    const double t0 = now_ns();
+    for (int r = 0; r < reps; r++) {
+        memset(hist, 0, sizeof(hist));
+        if (kernel) {
+            hist_add_int8(v, n, hist);
+        } else {
+            count_loop(v, n, hist);
+        }
+        __asm__ volatile("" : : "r"(hist) : "memory");
+    }
+    return (now_ns() - t0) / reps;
+}
+
+int main(void) {
+    static int8_t buf[MAX_LENGTH + 64];
+    static uint32_t want[256], got[256];
+    int pass = 1;
+
+#if defined(__AVX512BW__)
+    printf("=== Histograms (AVX-512) ===\n");
+#elif defined(__AVX2__)
+    printf("=== Histograms (AVX2) ===\n");
+#else
+    printf("=== Histograms (portable) ===\n");
+#endif
+
+    /* Every shape at any length and start offset, onto a non-empty table */
+    int same_ok = 1;
+    for (int trial = 0; trial < 20000; trial++) {
+        const size_t n = trial < 700 ? (size_t)trial : next_rand() % MAX_LENGTH;
+        int8_t *v = buf + next_rand() % 64;
+        fill(v, n, trial % 7);
+        for (int b = 0; b < 256; b++) {
+            want[b] = got[b] = (uint32_t)(next_rand() % 3);
+        }
+        count_loop(v, n, want);
+        hist_add_int8(v, n, got);
+        same_ok &= memcmp(got, want, sizeof(want)) == 0;
+
+        /* The same bytes as byte symbols */
+        memset(want, 0, sizeof(want));
+        memset(got, 0, sizeof(got));
+        for (size_t i = 0; i < n; i++) {
+            want[(uint8_t)v[i]]++;
+        }
+        hist_add_bytes((const uint8_t *)v, n, got);
+        same_ok &= memcmp(got, want, sizeof(want)) == 0;
+    }
+    printf("  Narrow and wide counts, int8 and byte symbols, match a loop: %s\n",
+           same_ok ? "PASS" : "FAIL");
+    pass &= same_ok;
+
+    /* Speed: a {-3..3} secret, a signature's {-2..2} values, wide bytes */
+    {
+        const struct { const char *what; size_t n; int shape; } runs[] = {
+            {"1024 values in {-3..3}", 1024, 1},
+            {"2048 values in {-2..2}, mostly 0", 2048, 2},
+            {"97 values in {-3..3}", 97, 1},
+            {"4096 geometric values", 4096, 6},
+            {"4096 uniform bytes", 4096, 5},
+        };
+        for (size_t k = 0; k < sizeof(runs) / sizeof(runs[0]); k++) {
+            fill(buf, runs[k].n, runs[k].shape);
+            const int reps = (int)(40000000 / (runs[k].n + 64));
+            const double loop = time_counts(buf, runs[k].n, 0, reps);
+            const double kern = time_counts(buf, runs[k].n, 1, reps);
+            printf("  %-34s loop %6.0f ns, kernel %6.0f ns (%.1fx)\n", runs[k].what, loop,
+                   kern, loop / kern);
+        }
+    }
+
+    printf("\n%s\n", pass ? "All histogram tests PASS" : "Some histogram tests FAIL");
+    return pass ? 0 : 1;
+}
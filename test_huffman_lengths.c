@@ -0,0 +1,242 @@
+/**
+ * Test the in-place Huffman code-length builder: optimal cost, complete
+ * codes, length limits against exhaustive search, canonical codes
+ *
+ * Build: gcc -O2 -o test_huffman_lengths test_huffman_lengths.c
+ */
+
+#include "huffman_lengths.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t rng_state = 0xBF58476D1CE4E5B9ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Reference Huffman cost: merge the two smallest, O(n^2) */
+static uint64_t ref_cost(const uint32_t *freqs, int n) {
+    uint64_t w[HUFF_MAX_SYMBOLS];
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (freqs[i]) {
+            w[m++] = freqs[i];
+        }
+    }
+    if (m == 1) {
+        return w[0];
+    }
+    uint64_t cost = 0;
+    while (m > 1) {
+        for (int pass = 0; pass < 2; pass++) {
+            int min = pass;
+            for (int i = pass + 1; i < m; i++) {
+                if (w[i] < w[min]) min = i;
+            }
+            uint64_t t = w[pass];
+            w[pass] = w[min];
+            w[min] = t;
+        }
+        w[0] += w[1];
+        cost += w[0];
+        w[1] = w[--m];
+    }
+    return cost;
+}
+
+static uint64_t cost_of(const uint32_t *freqs, const uint8_t *lengths, int n) {
+    uint64_t cost = 0;
+    for (int i = 0; i < n; i++) {
+        cost += (uint64_t)freqs[i] * lengths[i];
+    }
+    return cost;
+}
+
+/* Used symbols have lengths in 1..limit that fill the code exactly */
+static int complete(const uint32_t *freqs, const uint8_t *lengths, int n, unsigned limit) {
+    uint64_t kraft = 0;
+    int used = 0;
+    for (int i = 0; i < n; i++) {
+        if ((freqs[i] == 0) != (lengths[i] == 0) || lengths[i] > limit) {
+            return 0;
+        }
+        if (lengths[i]) {
+            kraft += 1ull << (HUFF_MAX_LIMIT - lengths[i]);
+            used++;
+        }
+    }
+    return used == 1 ? kraft == 1ull << (HUFF_MAX_LIMIT - 1) : kraft == 1ull << HUFF_MAX_LIMIT;
+}
+
+/* Cheapest length vector within limit, by exhaustive search */
+static uint64_t best_cost;
+
+static void search(const uint32_t *freqs, int n, unsigned limit, int i, uint64_t kraft,
+                   uint64_t cost) {
+    if (kraft > 1ull << limit || cost >= best_cost) {
+        return;
+    }
+    if (i == n) {
+        best_cost = cost;
+        return;
+    }
+    for (unsigned len = 1; len <= limit; len++) {
+        search(freqs, n, limit, i + 1, kraft + (1ull << (limit - len)),
+               cost + (uint64_t)freqs[i] * len);
+    }
+}
+
+int main(void) {
+    uint32_t freqs[HUFF_MAX_SYMBOLS];
+    uint8_t lengths[HUFF_MAX_SYMBOLS];
+    int pass = 1;
+
+    printf("=== Huffman code lengths ===\n");
+
+    /* Unlimited: Huffman cost, complete code */
+    int optimal_ok = 1;
+    for (int trial = 0; trial < 2000; trial++) {
+        const int n = 1 + (int)(next_rand() % HUFF_MAX_SYMBOLS);
+        const int kind = trial % 4;
+        for (int i = 0; i < n; i++) {
+            freqs[i] = kind == 0 ? (uint32_t)(next_rand() % 4)          /* ties, zeros */
+                     : kind == 1 ? (uint32_t)(1 + next_rand() % 1000)
+                     : kind == 2 ? (uint32_t)(next_rand() >> (44 + next_rand() % 20))   /* 2^20 spread */
+                                 : (uint32_t)(1 + (next_rand() % 3 == 0 ? 0 : next_rand() % 100000));
+        }
+        freqs[next_rand() % n] |= 1;
+        optimal_ok &= huff_build_lengths(freqs, n, HUFF_MAX_LIMIT, lengths) == 0;
+        optimal_ok &= complete(freqs, lengths, n, HUFF_MAX_LIMIT);
+        optimal_ok &= cost_of(freqs, lengths, n) == ref_cost(freqs, n);
+    }
+    printf("  Optimal complete codes: %s\n", optimal_ok ? "PASS" : "FAIL");
+    pass &= optimal_ok;
+
+    /* Limited: Fibonacci-like weights force long codes */
+    int limit_ok = 1;
+    for (int trial = 0; trial < 300; trial++) {
+        const int n = 2 + (int)(next_rand() % 40);
+        uint64_t a = 1, b = 1;
+        for (int i = 0; i < n; i++) {
+            freqs[i] = (uint32_t)(a > 0xFFFFFFFFull ? 0xFFFFFFFFull : a);
+            uint64_t c = a + b;
+            a = b;
+            b = c + next_rand() % 2;
+        }
+        /* Shuffled, so the index order differs from weight order */
+        for (int i = n - 1; i > 0; i--) {
+            int j = (int)(next_rand() % (i + 1));
+            uint32_t t = freqs[i];
+            freqs[i] = freqs[j];
+            freqs[j] = t;
+        }
+        unsigned min_limit = 1;
+        while ((1u << min_limit) < (unsigned)n) {
+            min_limit++;
+        }
+        const unsigned limit = min_limit + (unsigned)(next_rand() % 6);
+        limit_ok &= huff_build_lengths(freqs, n, limit, lengths) == 0;
+        limit_ok &= complete(freqs, lengths, n, limit);
+        limit_ok &= cost_of(freqs, lengths, n) >= ref_cost(freqs, n);
+        if (min_limit > 1) {
+            limit_ok &= huff_build_lengths(freqs, n, min_limit - 1, lengths) == -1;
+        }
+    }
+    /* Exhaustive search over short alphabets */
+    for (int trial = 0; trial < 300; trial++) {
+        const int n = 2 + (int)(next_rand() % 6);
+        for (int i = 0; i < n; i++) {
+            freqs[i] = (uint32_t)(1 + next_rand() % (trial % 2 ? 10 : 1000));
+        }
+        unsigned limit = 1;
+        while ((1u << limit) < (unsigned)n) {
+            limit++;
+        }
+        limit += (unsigned)(next_rand() % 3);
+        best_cost = UINT64_MAX;
+        search(freqs, n, limit, 0, 0, 0);
+        limit_ok &= huff_build_lengths(freqs, n, limit, lengths) == 0;
+        limit_ok &= complete(freqs, lengths, n, limit) && cost_of(freqs, lengths, n) == best_cost;
+    }
+    printf("  Length-limited codes optimal: %s\n", limit_ok ? "PASS" : "FAIL");
+    pass &= limit_ok;
+
+    /* Canonical codes: by length, then index, prefix free */
+    int canon_ok = 1;
+    {
+        const uint8_t lens[6] = { 2, 0, 3, 1, 3, 0 };
+        const uint32_t want[6] = { 2, 0, 6, 0, 7, 0 };
+        uint32_t codes[HUFF_MAX_SYMBOLS];
+        huff_canonical_codes(lens, 6, codes);
+        canon_ok &= memcmp(codes, want, sizeof(want)) == 0;
+
+        for (int trial = 0; trial < 200; trial++) {
+            const int n = 2 + (int)(next_rand() % 200);
+            for (int i = 0; i < n; i++) {
+                freqs[i] = (uint32_t)(next_rand() % 50);
+            }
+            freqs[0] = freqs[1] = 1;
+            huff_build_lengths(freqs, n, 12, lengths);
+            huff_canonical_codes(lengths, n, codes);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n && lengths[i]; j++) {
+                    if (i == j || !lengths[j] || lengths[j] < lengths[i]) continue;
+                    /* No code is a prefix of a longer (or equal) one */
+                    canon_ok &= (codes[j] >> (lengths[j] - lengths[i])) != codes[i];
+                    if (lengths[j] == lengths[i] && j > i) canon_ok &= codes[j] > codes[i];
+                }
+            }
+        }
+    }
+    printf("  Canonical codes: %s\n", canon_ok ? "PASS" : "FAIL");
+    pass &= canon_ok;
+
+    /* Bad arguments */
+    int reject_ok = 1;
+    memset(freqs, 0, sizeof(freqs));
+    reject_ok &= huff_build_lengths(freqs, 10, 15, lengths) == -1;
+    freqs[3] = 5;
+    reject_ok &= huff_build_lengths(freqs, 0, 15, lengths) == -1;
+    reject_ok &= huff_build_lengths(freqs, HUFF_MAX_SYMBOLS + 1, 15, lengths) == -1;
+    reject_ok &= huff_build_lengths(freqs, 10, 0, lengths) == -1;
+    reject_ok &= huff_build_lengths(freqs, 10, 15, lengths) == 0 && lengths[3] == 1;
+    printf("  Bad arguments rejected: %s\n", reject_ok ? "PASS" : "FAIL");
+    pass &= reject_ok;
+
+    /* Speed: 44-value Gaussian-like alphabet, and a full one */
+    {
+        const int sizes[2] = { 44, 256 };
+        for (int k = 0; k < 2; k++) {
+            const int n = sizes[k];
+            for (int i = 0; i < n; i++) {
+                double z = (i - n / 2.0) / (n / 6.0);
+                freqs[i] = 1 + (uint32_t)(1000.0 / (1.0 + z * z * z * z));
+            }
+            const int iters = 20000;
+            unsigned sum = 0;
+            double t0 = now_ns();
+            for (int it = 0; it < iters; it++) {
+                freqs[it % n]++;
+                huff_build_lengths(freqs, n, 15, lengths);
+                sum += lengths[it % n];
+            }
+            printf("  %3d symbols: %.2f us per build (checksum %u)\n", n,
+                   (now_ns() - t0) / (1e3 * iters), sum);
+        }
+    }
+
+    printf("\n%s\n", pass ? "All code-length tests PASS" : "Some code-length tests FAIL");
+    return pass ? 0 : 1;
+}
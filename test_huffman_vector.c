@@ -0,0 +1,277 @@
+/**
+ * Test the table-driven Huffman decoder, the four-stream and the chunked
+ * formats against a bit-at-a-time reference, on dense vectors of every
+ * alphabet size
+ *
+ * Build: gcc -O2 -o test_huffman_vector test_huffman_vector.c huffman_vector.c dntl_sched.c \
+ *        dntl_alloc.c -lpthread
+ */
+
+#include "huffman_vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Reference: the canonical code of each value, matched a bit at a time */
+static uint32_t ref_bit(const uint8_t *data, size_t size, size_t *pos) {
+    uint32_t bit = *pos / 8 < size ? (data[*pos / 8] >> (7 - *pos % 8)) & 1 : 0;
+    (*pos)++;
+    return bit;
+}
+
+static uint32_t ref_bits(const uint8_t *data, size_t size, size_t *pos, int n) {
+    uint32_t v = 0;
+    while (n-- > 0) v = v << 1 | ref_bit(data, size, pos);
+    return v;
+}
+
+static int ref_decode(const uint8_t *data, size_t size, uint8_t *vector, size_t dimension) {
+    size_t pos = 0;
+    size_t stored = ref_bits(data, size, &pos, 16);
+    stored |= (size_t)ref_bits(data, size, &pos, 16) << 16;
+    if (stored != dimension) return -1;
+    int n = (int)ref_bits(data, size, &pos, 8);
+    if (n == 0) n = 256;
+
+    uint8_t lengths[256];
+    for (int i = 0; i < n; i++) lengths[i] = (uint8_t)ref_bits(data, size, &pos, 5);
+    uint32_t codes[256], code = 0;
+    for (int len = 1; len <= 31; len++) {
+        for (int sym = 0; sym < n; sym++) {
+            if (lengths[sym] == len) codes[sym] = code++;
+        }
+        code <<= 1;
+    }
+    for (size_t i = 0; i < dimension; i++) {
+        uint32_t v = 0;
+        int found = 0;
+        for (int len = 1; len <= 31 && !found; len++) {
+            v = v << 1 | ref_bit(data, size, &pos);
+            for (int sym = 0; sym < n; sym++) {
+                if (lengths[sym] == len && codes[sym] == v) {
+                    vector[i] = (uint8_t)sym;
+                    found = 1;
+                    break;
+                }
+            }
+        }
+        if (!found || pos > size * 8) return -1;
+    }
+    return 0;
+}
+
+/* Dense vectors: the 0..6 profile of test_huffman, skewed, wide, one value */
+static void make_vector(uint8_t *v, size_t dim, int shape) {
+    for (size_t i = 0; i < dim; i++) {
+        const uint64_t r = next_rand();
+        switch (shape) {
+        case 0: {
+            const unsigned p = r % 2048;
+            v[i] = p < 476 ? 0 : p < 1356 ? 1 : p < 1830 ? 2 : p < 2003 ? 3 : p < 2044 ? 4
+                 : (uint8_t)(5 + (r >> 20) % 2);
+            break;
+        }
+        case 1: v[i] = r % 100 < 95 ? 7 : (uint8_t)(r >> 32); break;
+        case 2: v[i] = (uint8_t)(r >> 24); break;
+        case 3: v[i] = 255; break;
+        default: v[i] = (uint8_t)(__builtin_ctzll(r | (1ULL << 40)));  /* geometric */
+        }
+    }
+}
+
+int main(void) {
+    const size_t max_dim = 70000;
+    uint8_t *vec = malloc(max_dim), *dec = malloc(max_dim), *ref = malloc(max_dim);
+    uint8_t *buf = malloc(huffman_x4_max_encoded_size(max_dim));
+    int pass = vec && dec && ref && buf;
+
+    printf("=== Huffman vector decoding ===\n");
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+
+    /* Round trips, and the single-stream decoder against the reference */
+    {
+        int ok = 1;
+        for (int trial = 0; trial < 2000; trial++) {
+            const size_t dim = 1 + next_rand() % (trial % 50 ? 3000 : max_dim);
+            const int shape = trial % 5;
+            make_vector(vec, dim, shape);
+
+            size_t n;
+            ok &= huffman_encode_into(vec, dim, buf, huffman_max_encoded_size(dim), &n) == 0;
+            memset(dec, 0xAA, dim);
+            ok &= huffman_decode(buf, n, dec, dim) == 0 && memcmp(dec, vec, dim) == 0;
+            if (trial % 10 == 0) {
+                ok &= ref_decode(buf, n, ref, dim) == 0 && memcmp(ref, vec, dim) == 0;
+            }
+            ok &= huffman_decode(buf, n, dec, dim + 1) == -1;
+
+            ok &= huffman_encode_x4_into(vec, dim, buf, huffman_x4_max_encoded_size(dim), &n) == 0;
+            memset(dec, 0xAA, dim);
+            ok &= huffman_decode_x4(buf, n, dec, dim) == 0 && memcmp(dec, vec, dim) == 0;
+        }
+        printf("  Single-stream and x4 round trips, reference agrees: %s\n",
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Damaged streams: the table decoder fails where the reference does, and
+     * matches it where it succeeds; truncation is always caught */
+    {
+        int ok = 1, agreed = 0;
+        for (int trial = 0; trial < 3000; trial++) {
+            const size_t dim = 1 + next_rand() % 2500;
+            make_vector(vec, dim, trial % 5);
+            size_t n;
+            const int x4 = trial % 2;
+            if ((x4 ? huffman_encode_x4_into(vec, dim, buf, huffman_x4_max_encoded_size(dim), &n)
+                    : huffman_encode_into(vec, dim, buf, huffman_max_encoded_size(dim), &n)) < 0) {
+                ok = 0;
+                continue;
+            }
+            const size_t cut = (size_t)(next_rand() % n);
+            ok &= (x4 ? huffman_decode_x4(buf, cut, dec, dim)
+                      : huffman_decode(buf, cut, dec, dim)) == -1 || cut >= n - 1;
+
+            buf[5 + next_rand() % (n - 5)] ^= (uint8_t)(1 + next_rand() % 255);
+            const int rc = x4 ? huffman_decode_x4(buf, n, dec, dim)
+                              : huffman_decode(buf, n, dec, dim);
+            if (!x4) {
+                const int rr = ref_decode(buf, n, ref, dim);
+                ok &= rc == rr && (rc < 0 || memcmp(dec, ref, dim) == 0);
+                agreed++;
+            }
+        }
+        printf("  Damaged streams: table and reference agree on %d, truncation caught: %s\n",
+               agreed, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Chunked: any chunk count and thread count, within the bound, damage caught */
+    {
+        static const size_t chunk_counts[] = { 1, 2, 3, 4, 5, 7, 16, 64, 1000 };
+        int ok = 1;
+        for (int trial = 0; trial < 600; trial++) {
+            const size_t dim = 1 + next_rand() % (trial % 20 ? 5000 : max_dim);
+            const size_t chunks = chunk_counts[trial % 9] < dim ? chunk_counts[trial % 9] : dim;
+            const int threads = 1 + trial % 4 * 2;
+            make_vector(vec, dim, trial % 5);
+
+            const size_t cap = huffman_chunked_max_encoded_size(dim, chunks);
+            size_t n;
+            ok &= cap > 0 && huffman_encode_chunked_into(vec, dim, chunks, buf, cap, &n) == 0;
+            memset(dec, 0xAA, dim);
+            ok &= huffman_decode_chunked(buf, n, dec, dim, threads) == 0 &&
+                  memcmp(dec, vec, dim) == 0;
+            ok &= huffman_decode_chunked(buf, n, dec, dim + 1, threads) == -1;
+            ok &= huffman_decode_chunked(buf, n - 1, dec, dim, threads) == -1 || chunks > 1;
+            ok &= huffman_encode_chunked_into(vec, dim, chunks, buf, n - 1, &n) == -1;
+
+            /* Damage anywhere: an error or some vector, in bounds either way */
+            ok &= huffman_encode_chunked_into(vec, dim, chunks, buf, cap, &n) == 0;
+            buf[next_rand() % n] ^= (uint8_t)(1 + next_rand() % 255);
+            (void)huffman_decode_chunked(buf, n, dec, dim, threads);
+            ok &= huffman_decode_chunked(buf, next_rand() % n, dec, dim, threads) <= 0;
+        }
+        ok &= huffman_chunked_max_encoded_size(10, 11) == 0 &&
+              huffman_chunked_max_encoded_size(10, 0) == 0 &&
+              huffman_chunked_max_encoded_size(100000, HUFFMAN_MAX_CHUNKS + 1) == 0 &&
+              huffman_encode_chunked(vec, 10, 11) == NULL;
+        printf("  Chunked round trips over chunk and thread counts: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Large vectors: one stream against chunks on 1, 2, 4 threads */
+    {
+        const size_t dim = 1 << 22;
+        const int iters = 5;
+        uint8_t *big = malloc(dim), *got = malloc(dim);
+        uint8_t *one = malloc(huffman_max_encoded_size(dim));
+        uint8_t *split = malloc(huffman_chunked_max_encoded_size(dim, 64));
+        size_t n1, nk;
+        int ok = big && got && one && split;
+        if (ok) {
+            make_vector(big, dim, 0);
+            ok = huffman_encode_into(big, dim, one, huffman_max_encoded_size(dim), &n1) == 0 &&
+                 huffman_encode_chunked_into(big, dim, 64, split,
+                                             huffman_chunked_max_encoded_size(dim, 64),
+                                             &nk) == 0;
+        }
+        double rate[4] = {0};
+        double t0 = now_ns();
+        for (int i = 0; ok && i < iters; i++) ok &= huffman_decode(one, n1, got, dim) == 0;
+        rate[0] = dim * iters / ((now_ns() - t0) / 1e3);
+        for (int k = 1; k < 4; k++) {
+            t0 = now_ns();
+            for (int i = 0; ok && i < iters; i++) {
+                ok &= huffman_decode_chunked(split, nk, got, dim, 1 << (k - 1)) == 0;
+            }
+            rate[k] = dim * iters / ((now_ns() - t0) / 1e3);
+        }
+        ok &= memcmp(got, big, dim) == 0;
+        printf("  %zu values, 64 chunks (+%zu bytes): one stream %.0f MB/s, "
+               "chunked 1/2/4 threads %.0f/%.0f/%.0f MB/s: %s\n", dim, nk - n1,
+               rate[0], rate[1], rate[2], rate[3], ok ? "PASS" : "FAIL");
+        pass &= ok;
+        free(big);
+        free(got);
+        free(one);
+        free(split);
+    }
+
+    /* Throughput on the 2048-value profile of test_huffman */
+    {
+        const size_t dim = 2048;
+        const int iters = 20000;
+        size_t n1, n4;
+        uint8_t *one = malloc(huffman_max_encoded_size(dim));
+        uint8_t *four = malloc(huffman_x4_max_encoded_size(dim));
+        make_vector(vec, dim, 0);
+        int ok = one && four &&
+                 huffman_encode_into(vec, dim, one, huffman_max_encoded_size(dim), &n1) == 0 &&
+                 huffman_encode_x4_into(vec, dim, four, huffman_x4_max_encoded_size(dim), &n4) == 0;
+
+        double t0 = now_ns();
+        for (int i = 0; ok && i < 200; i++) ok &= ref_decode(one, n1, ref, dim) == 0;
+        double t1 = now_ns();
+        for (int i = 0; ok && i < iters; i++) ok &= huffman_decode(one, n1, dec, dim) == 0;
+        double t2 = now_ns();
+        for (int i = 0; ok && i < iters; i++) ok &= huffman_decode_x4(four, n4, dec, dim) == 0;
+        double t3 = now_ns();
+        ok &= memcmp(dec, vec, dim) == 0;
+
+        const double mb = dim / 1e6;
+        printf("  2048 values, %zu / %zu bytes: bit-serial %.0f MB/s, table %.0f MB/s, "
+               "x4 %.0f MB/s: %s\n", n1, n4, mb / ((t1 - t0) / 200 / 1e9),
+               mb / ((t2 - t1) / iters / 1e9), mb / ((t3 - t2) / iters / 1e9),
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+        free(one);
+        free(four);
+    }
+
+    free(vec);
+    free(dec);
+    free(ref);
+    free(buf);
+    printf("\n%s\n", pass ? "All Huffman vector tests PASS" : "Some Huffman vector tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+"""
+Check the vectorized libdntln pointwise primitives against plain Python
+arithmetic, for the uint32, uint64 and Python-int moduli paths
+
+Run: python3 test_libdntln.py
+"""
+import random
+from libdntln import (
+    natural_mod,
+    pointwise_addition,
+    pointwise_addition2,
+    pointwise_multiplication,
+    pointwise_multiplication2,
+)
+
+MODULI = [257, (1 << 32) - 5, (1 << 61) - 1, (1 << 89) - 1]
+
+
+def natural(x, q):
+    r = x % q
+    return r if r != 0 else q
+
+
+def check(q, rng):
+    n = 256
+    a = [rng.randrange(-q, 2 * q) for _ in range(n)]
+    b = [rng.randrange(-q, 2 * q) for _ in range(n)]
+    a[0], b[0] = q - 1, q - 1  # largest reduced operands
+    a[1], b[1] = 0, rng.randrange(q)  # zero product
+    if q <= 1 << 32:
+        # The fixed-width paths take int64 inputs
+        a = [x % q for x in a]
+        b = [x % q for x in b]
+
+    want_mul = [(x * y) % q for x, y in zip(a, b)]
+    want_add = [(x + y) % q for x, y in zip(a, b)]
+
+    assert [int(v) for v in pointwise_multiplication2(a, b, q)] == want_mul, q
+    assert [int(v) for v in pointwise_addition2(a, b, q)] == want_add, q
+    assert [int(v) for v in pointwise_multiplication(a, b, q)] == [
+        natural(v, q) for v in want_mul
+    ], q
+    assert [int(v) for v in pointwise_addition(a, b, q)] == [
+        natural(v, q) for v in want_add
+    ], q
+    assert [int(v) for v in natural_mod(a, q)] == [natural(x, q) for x in a], q
+    assert natural_mod(q, q) == q
+
+
+def main():
+    rng = random.Random(0x5EED)
+    for q in MODULI:
+        check(q, rng)
+        print(f"q = {q}: PASS")
+    print("All libdntln pointwise tests passed")
+
+
+if __name__ == "__main__":
+    main()
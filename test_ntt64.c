@@ -135,6 +135,212 @@ int test_ntt_correctness(int layer) {
     return passed;
 }
 
+// Bit-reversed NTT domain: forward_bitrev = bit-reversed forward, and a full
+// multiplication through that domain matches the schoolbook product
+int test_bitrev_domain(int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
+    uint32_t a[NTT_N], b[NTT_N], nat[NTT_N], c[NTT_N], ref[NTT_N];
+
+    printf("Testing bit-reversed NTT domain for layer %d... ", layer);
+    random_poly(a, q);
+    random_poly(b, q);
+    memcpy(nat, a, sizeof(a));
+    memcpy(c, a, sizeof(a));
+
+    ntt64_forward(nat, layer);
+    ntt64_forward_bitrev(c, layer);
+    for (int i = 0; i < NTT_N; i++) {
+        int r = 0;
+        for (int bit = 0; bit < 6; bit++) {
+            r |= ((i >> bit) & 1) << (5 - bit);
+        }
+        if (c[i] != nat[r]) {
+            printf("FAILED (forward order at %d)\n", i);
+            return 0;
+        }
+    }
+
+    uint32_t b_ntt[NTT_N];
+    memcpy(b_ntt, b, sizeof(b));
+    ntt64_forward_bitrev(b_ntt, layer);
+    ntt64_pointwise_mul(c, c, b_ntt, layer);
+    ntt64_inverse_bitrev(c, layer);
+    schoolbook_negacyclic_mul(ref, a, b, q);
+    if (memcmp(c, ref, sizeof(c)) != 0) {
+        printf("FAILED (product)\n");
+        return 0;
+    }
+
+    printf("PASSED\n");
+    return 1;
+}
+
+// Per-modulus entry points must agree with the layer-indexed API
+int test_specialized_entry_points(void) {
+    typedef void (*fwd_q_fn)(uint32_t poly[NTT_N]);
+    static const fwd_q_fn forward_q[NTT_NUM_LAYERS] = {
+        ntt64_forward_q257, ntt64_forward_q3329, ntt64_forward_q10753, ntt64_forward_q43777,
+        ntt64_forward_q64513, ntt64_forward_q686593, ntt64_forward_q2818573313
+    };
+
+    printf("Testing per-modulus entry points... ");
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        uint32_t a[NTT_N], b[NTT_N];
+        random_poly(a, ntt64_get_modulus(layer));
+        memcpy(b, a, sizeof(a));
+
+        ntt64_forward(a, layer);
+        forward_q[layer](b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("FAILED (layer %d)\n", layer);
+            return 0;
+        }
+    }
+
+    uint32_t a[NTT_N], b[NTT_N], c[NTT_N], d[NTT_N];
+    random_poly(a, 3329);
+    random_poly(b, 3329);
+    ntt64_pointwise_mul(c, a, b, NTT_LAYER_3329);
+    ntt64_pointwise_mul_q3329(d, a, b);
+    ntt64_inverse_q3329(c);
+    ntt64_inverse(d, NTT_LAYER_3329);
+    if (memcmp(c, d, sizeof(c)) != 0) {
+        printf("FAILED (q3329 pointwise/inverse)\n");
+        return 0;
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// The q = 257 shift-reduction transforms must match the Barrett layer 0 path
+int test_fermat257(void) {
+    printf("Testing q=257 shift-reduction transforms... ");
+    for (int trial = 0; trial < 100; trial++) {
+        uint32_t a[NTT_N], b[NTT_N];
+        for (int i = 0; i < NTT_N; i++) {
+            a[i] = trial ? rand32() : 0xFFFFFFFFu - (uint32_t)i;
+        }
+        memcpy(b, a, sizeof(a));
+
+        ntt64_forward_q257(a);
+        ntt64_forward_f257(b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("FAILED (forward, trial %d)\n", trial);
+            return 0;
+        }
+        ntt64_inverse_q257(a);
+        ntt64_inverse_f257(b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("FAILED (inverse, trial %d)\n", trial);
+            return 0;
+        }
+
+        ntt64_forward_bitrev_q257(a);
+        ntt64_forward_bitrev_f257(b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("FAILED (forward bitrev, trial %d)\n", trial);
+            return 0;
+        }
+        // Worst case for the inverse: all coefficients q - 1
+        if (trial == 1) {
+            for (int i = 0; i < NTT_N; i++) a[i] = b[i] = 256;
+        }
+        ntt64_inverse_bitrev_q257(a);
+        ntt64_inverse_bitrev_f257(b);
+        if (memcmp(a, b, sizeof(a)) != 0) {
+            printf("FAILED (inverse bitrev, trial %d)\n", trial);
+            return 0;
+        }
+    }
+    printf("PASSED\n\n");
+    return 1;
+}
+
+void benchmark_fermat257(void) {
+    uint32_t poly[NTT_N];
+    random_poly(poly, 257);
+    const int iterations = 100000;
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        ntt64_forward_bitrev_q257(poly);
+        ntt64_inverse_bitrev_q257(poly);
+    }
+    double barrett = (double)(clock() - start) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    start = clock();
+    for (int i = 0; i < iterations; i++) {
+        ntt64_forward_bitrev_f257(poly);
+        ntt64_inverse_bitrev_f257(poly);
+    }
+    double shift = (double)(clock() - start) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    printf("q=257 bitrev forward+inverse: Barrett %.3f µs, shift reduction %.3f µs\n",
+           barrett, shift);
+}
+
+// Built tables must reproduce the offline constants, and registered layers
+// must pass the same transform tests as the built-in ones
+extern const uint32_t Q[NTT_NUM_LAYERS];
+extern const uint32_t N_INV[NTT_NUM_LAYERS];
+extern const uint64_t BARRETT_CONST[NTT_NUM_LAYERS];
+extern const uint32_t TWIDDLES_FWD[NTT_NUM_LAYERS][6];
+extern const uint32_t TWIDDLES_INV[NTT_NUM_LAYERS][6];
+extern const uint32_t PSI_POWERS[NTT_NUM_LAYERS][NTT_N];
+extern const uint32_t PSI_INV_POWERS[NTT_NUM_LAYERS][NTT_N];
+
+int test_runtime_tables(void) {
+    static ntt64_modulus_tables_t t;
+
+    printf("Testing runtime table builder against built-in tables... ");
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        if (ntt64_build_tables(&t, Q[layer]) != 0 ||
+            t.n_inv != N_INV[layer] || t.barrett != BARRETT_CONST[layer] ||
+            memcmp(t.twiddles_fwd, TWIDDLES_FWD[layer], sizeof(t.twiddles_fwd)) != 0 ||
+            memcmp(t.twiddles_inv, TWIDDLES_INV[layer], sizeof(t.twiddles_inv)) != 0 ||
+            memcmp(t.psi_powers, PSI_POWERS[layer], sizeof(t.psi_powers)) != 0 ||
+            memcmp(t.psi_inv_powers, PSI_INV_POWERS[layer], sizeof(t.psi_inv_powers)) != 0) {
+            printf("FAILED (layer %d)\n", layer);
+            return 0;
+        }
+        if (ntt64_register_modulus(Q[layer]) != layer || ntt64_get_tables(layer) != NULL) {
+            printf("FAILED (register built-in layer %d)\n", layer);
+            return 0;
+        }
+    }
+
+    // 129 = 3 * 43, 193 - 1 is not a multiple of 128
+    if (ntt64_build_tables(&t, 129) != -1 || ntt64_register_modulus(193) != -1) {
+        printf("FAILED (unsuitable modulus accepted)\n");
+        return 0;
+    }
+    printf("PASSED\n\n");
+
+    // The rs layer moduli that have no built-in tables
+    static const uint32_t rs_moduli[] = {12289u, 40961u, 65537u, 786433u, 2013265921u};
+    int passed = 1;
+    for (int i = 0; i < 5; i++) {
+        int layer = ntt64_register_modulus(rs_moduli[i]);
+        if (layer < NTT_NUM_LAYERS || ntt64_register_modulus(rs_moduli[i]) != layer ||
+            ntt64_get_modulus(layer) != rs_moduli[i]) {
+            printf("Registering q = %u... FAILED\n", rs_moduli[i]);
+            passed = 0;
+            continue;
+        }
+
+        uint32_t x = rand32() % (rs_moduli[i] - 1) + 1;
+        if (ntt64_mul_mod(x, ntt64_inv_mod(x, layer), layer) != 1) {
+            printf("Field arithmetic for q = %u... FAILED\n", rs_moduli[i]);
+            passed = 0;
+        }
+        passed &= test_ntt_correctness(layer);
+        passed &= test_bitrev_domain(layer);
+    }
+    printf("\n");
+    return passed;
+}
+
 // Benchmark NTT performance
 void benchmark_ntt(int layer) {
     uint32_t q = ntt64_get_modulus(layer);
@@ -190,6 +396,21 @@ int main(void) {
             all_passed = 0;
         }
     }
+    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+        if (!test_bitrev_domain(layer)) {
+            all_passed = 0;
+        }
+    }
+    printf("\n");
+    if (!test_specialized_entry_points()) {
+        all_passed = 0;
+    }
+    if (!test_runtime_tables()) {
+        all_passed = 0;
+    }
+    if (!test_fermat257()) {
+        all_passed = 0;
+    }
 
     if (all_passed) {
         printf("========================================\n");
@@ -208,6 +429,7 @@ int main(void) {
     for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
         benchmark_ntt(layer);
     }
+    benchmark_fermat257();
     printf("========================================\n");
 
     return 0;
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "ntt_plan.h"
+
+// Simple PRNG for testing
+static uint64_t xorshift64_state = 88172645463325252ULL;
+
+static uint32_t rand32(void) {
+    xorshift64_state ^= xorshift64_state << 13;
+    xorshift64_state ^= xorshift64_state >> 7;
+    xorshift64_state ^= xorshift64_state << 17;
+    return (uint32_t)xorshift64_state;
+}
+
+static uint32_t pow_mod(uint32_t base, uint64_t exp, uint32_t q) {
+    uint64_t result = 1, b = base % q;
+    while (exp) {
+        if (exp & 1) result = (result * b) % q;
+        b = (b * b) % q;
+        exp >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+// Naive O(N^2) evaluation: X[k] = A(omega^k) or A(psi^(2k+1))
+static void naive_ntt(uint32_t *out, const uint32_t *in, size_t n, uint32_t q,
+                      uint32_t root, ntt_plan_type_t type) {
+    uint64_t order = (type == NTT_PLAN_CYCLIC) ? n : 2 * n;
+    uint32_t g = pow_mod(root, (q - 1) / order, q);
+
+    for (size_t k = 0; k < n; k++) {
+        uint64_t e = (type == NTT_PLAN_CYCLIC) ? k : 2 * k + 1;
+        uint32_t x = pow_mod(g, e, q);
+        uint64_t acc = 0, xp = 1;
+        for (size_t j = 0; j < n; j++) {
+            acc = (acc + (uint64_t)(in[j] % q) * xp) % q;
+            xp = (xp * x) % q;
+        }
+        out[k] = (uint32_t)acc;
+    }
+}
+
+// c = a * b mod (x^N -/+ 1)
+static void schoolbook_mul(uint32_t *c, const uint32_t *a, const uint32_t *b,
+                           size_t n, uint32_t q, ntt_plan_type_t type) {
+    memset(c, 0, n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            uint64_t prod = ((uint64_t)a[i] * b[j]) % q;
+            size_t idx = i + j;
+            if (idx >= n) {
+                idx -= n;
+                if (type == NTT_PLAN_NEGACYCLIC) prod = (q - prod) % q;
+            }
+            c[idx] = (uint32_t)((c[idx] + prod) % q);
+        }
+    }
+}
+
+static int test_plan(size_t n, uint32_t q, uint32_t root, ntt_plan_type_t type) {
+    printf("N=%-5zu q=%-10u root=%-3u %-10s ", n, q, root,
+           type == NTT_PLAN_CYCLIC ? "cyclic" : "negacyclic");
+
+    ntt_plan_t *plan = ntt_plan_create(n, q, root, type);
+    if (!plan || ntt_plan_size(plan) != n || ntt_plan_modulus(plan) != q) {
+        printf("FAILED (create)\n");
+        ntt_plan_destroy(plan);
+        return 0;
+    }
+
+    uint32_t *a = malloc(n * sizeof(uint32_t));
+    uint32_t *b = malloc(n * sizeof(uint32_t));
+    uint32_t *c = malloc(n * sizeof(uint32_t));
+    uint32_t *ref = malloc(n * sizeof(uint32_t));
+    uint32_t *orig = malloc(n * sizeof(uint32_t));
+    int passed = 1;
+
+    // Forward against naive evaluation (unreduced 32-bit input)
+    for (size_t i = 0; i < n; i++) orig[i] = a[i] = rand32();
+    naive_ntt(ref, orig, n, q, root, type);
+    ntt_plan_forward(plan, a);
+    if (memcmp(a, ref, n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (forward)\n");
+        passed = 0;
+        goto done;
+    }
+
+    // Round trip
+    ntt_plan_inverse(plan, a);
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != orig[i] % q) {
+            printf("FAILED (round trip at %zu)\n", i);
+            passed = 0;
+            goto done;
+        }
+    }
+
+    // Bit-reversed mode is a permutation of the natural output
+    memcpy(b, orig, n * sizeof(uint32_t));
+    ntt_plan_forward_bitrev(plan, b);
+    for (size_t i = 0; i < n; i++) {
+        size_t rev = 0;
+        for (size_t bit = 1, r = n >> 1; bit < n; bit <<= 1, r >>= 1) {
+            if (i & bit) rev |= r;
+        }
+        if (b[rev] != ref[i]) {
+            printf("FAILED (bitrev order at %zu)\n", i);
+            passed = 0;
+            goto done;
+        }
+    }
+
+    // Polynomial product through the bit-reversed domain
+    for (size_t i = 0; i < n; i++) {
+        a[i] = rand32() % q;
+        b[i] = rand32() % q;
+    }
+    schoolbook_mul(ref, a, b, n, q, type);
+    ntt_plan_forward_bitrev(plan, a);
+    ntt_plan_forward_bitrev(plan, b);
+    ntt_plan_pointwise_mul(plan, c, a, b);
+    ntt_plan_inverse_bitrev(plan, c);
+    if (memcmp(c, ref, n * sizeof(uint32_t)) != 0) {
+        printf("FAILED (product)\n");
+        passed = 0;
+        goto done;
+    }
+
+    printf("PASSED\n");
+
+done:
+    free(a);
+    free(b);
+    free(c);
+    free(ref);
+    free(orig);
+    ntt_plan_destroy(plan);
+    return passed;
+}
+
+// Sparse-times-dense products on both paths against the schoolbook product
+static int test_sparse_mul(size_t n, uint32_t q, uint32_t root, ntt_plan_type_t type) {
+    printf("N=%-5zu q=%-10u sparse %-10s ", n, q,
+           type == NTT_PLAN_CYCLIC ? "cyclic" : "negacyclic");
+
+    ntt_plan_t *plan = ntt_plan_create(n, q, root, type);
+    uint32_t *dense = malloc(n * sizeof(uint32_t));
+    uint32_t *sparse = malloc(n * sizeof(uint32_t));
+    uint32_t *c = malloc(n * sizeof(uint32_t));
+    uint32_t *ref = malloc(n * sizeof(uint32_t));
+    uint16_t *indices = malloc(n * sizeof(uint16_t));
+    int8_t *values = malloc(n);
+    const size_t threshold = ntt_plan_sparse_threshold(plan);
+    const size_t weights[] = { 0, 1, 2, threshold, threshold + 1, n };
+    int passed = 1;
+
+    for (size_t i = 0; i < n; i++) dense[i] = rand32() % q;
+    for (size_t w = 0; w < sizeof(weights) / sizeof(weights[0]) && passed; w++) {
+        // Any int8 values, repeated indices included
+        memset(sparse, 0, n * sizeof(uint32_t));
+        for (size_t t = 0; t < weights[w]; t++) {
+            indices[t] = (uint16_t)(rand32() % n);
+            values[t] = t == 0 ? -128 : t == 1 ? 127 : (int8_t)rand32();
+            int64_t v = ((int64_t)values[t] % q + q) % q;
+            sparse[indices[t]] = (uint32_t)((sparse[indices[t]] + v) % q);
+        }
+        schoolbook_mul(ref, sparse, dense, n, q, type);
+        passed &= ntt_plan_mul_sparse(plan, c, indices, values, weights[w], dense) == 0 &&
+                  memcmp(c, ref, n * sizeof(uint32_t)) == 0;
+    }
+
+    // An index past n is rejected before anything is written
+    indices[0] = (uint16_t)n;
+    memcpy(ref, c, n * sizeof(uint32_t));
+    passed &= ntt_plan_mul_sparse(plan, c, indices, values, 1, dense) == -1 &&
+              memcmp(c, ref, n * sizeof(uint32_t)) == 0;
+
+    printf(passed ? "PASSED\n" : "FAILED\n");
+    free(dense);
+    free(sparse);
+    free(c);
+    free(ref);
+    free(indices);
+    free(values);
+    ntt_plan_destroy(plan);
+    return passed;
+}
+
+static int test_invalid_parameters(void) {
+    printf("Invalid parameters rejected: ");
+    int ok = 1;
+    ok &= ntt_plan_create(96, 257, 3, NTT_PLAN_CYCLIC) == NULL;        // not a power of two
+    ok &= ntt_plan_create(512, 257, 3, NTT_PLAN_CYCLIC) == NULL;       // 512 does not divide 256
+    ok &= ntt_plan_create(256, 257, 3, NTT_PLAN_NEGACYCLIC) == NULL;   // needs 512 | q-1
+    ok &= ntt_plan_create(64, 513, 3, NTT_PLAN_CYCLIC) == NULL;        // not prime
+    ok &= ntt_plan_create(64, 257, 4, NTT_PLAN_CYCLIC) == NULL;        // 4 is a square mod 257
+    ok &= ntt_plan_create(64, 257, 257, NTT_PLAN_CYCLIC) == NULL;      // root = 0 mod q
+    printf(ok ? "PASSED\n" : "FAILED\n");
+    return ok;
+}
+
+static void benchmark_plan(size_t n, uint32_t q, uint32_t root, ntt_plan_type_t type) {
+    const int iterations = 100000;
+    ntt_plan_t *plan = ntt_plan_create(n, q, root, type);
+    uint32_t *poly = malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) poly[i] = rand32() % q;
+
+    clock_t start = clock();
+    for (int i = 0; i < iterations; i++) {
+        ntt_plan_forward(plan, poly);
+        ntt_plan_inverse(plan, poly);
+    }
+    double us = (double)(clock() - start) / CLOCKS_PER_SEC * 1e6 / iterations;
+    printf("  N=%-4zu q=%-6u forward+inverse: %.3f µs\n", n, q, us);
+
+    free(poly);
+    ntt_plan_destroy(plan);
+}
+
+int main(void) {
+    printf("==============================================\n");
+    printf("Length-generic NTT plan tests\n");
+    printf("==============================================\n\n");
+
+    int all_passed = 1;
+
+    // dntl-dsa-nat.py configurations: levels 1, 3, 5 over q = 257, roots 3 and 5
+    static const size_t dsa_n[] = {64, 128, 256};
+    for (int i = 0; i < 3; i++) {
+        all_passed &= test_plan(dsa_n[i], 257, 3, NTT_PLAN_CYCLIC);
+        all_passed &= test_plan(dsa_n[i], 257, 5, NTT_PLAN_CYCLIC);
+    }
+
+    // Small lengths (scalar path) and other moduli, both transform types
+    all_passed &= test_plan(2, 257, 3, NTT_PLAN_CYCLIC);
+    all_passed &= test_plan(8, 257, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(16, 257, 3, NTT_PLAN_CYCLIC);
+    all_passed &= test_plan(32, 257, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(128, 257, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(128, 3329, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(256, 3329, 3, NTT_PLAN_CYCLIC);
+    all_passed &= test_plan(512, 12289, 11, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(1024, 12289, 11, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(256, 7681, 17, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(256, 8380417, 10, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(64, 2818573313u, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_plan(1024, 2013265921u, 31, NTT_PLAN_NEGACYCLIC);
+
+    // Sparse products: values past q / 2 (q = 97), folds every few
+    // nonzeros (q near 2^31), both transform types
+    all_passed &= test_sparse_mul(64, 257, 3, NTT_PLAN_CYCLIC);
+    all_passed &= test_sparse_mul(256, 257, 3, NTT_PLAN_CYCLIC);
+    all_passed &= test_sparse_mul(128, 257, 3, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_sparse_mul(32, 97, 5, NTT_PLAN_CYCLIC);
+    all_passed &= test_sparse_mul(1024, 12289, 11, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_sparse_mul(2048, 12289, 11, NTT_PLAN_NEGACYCLIC);
+    all_passed &= test_sparse_mul(1024, 2013265921u, 31, NTT_PLAN_NEGACYCLIC);
+
+    all_passed &= test_invalid_parameters();
+
+    printf("\n");
+    if (all_passed) {
+        printf("ALL TESTS PASSED ✓\n\n");
+    } else {
+        printf("SOME TESTS FAILED ✗\n");
+        return 1;
+    }
+
+    printf("Performance:\n");
+    for (int i = 0; i < 3; i++) {
+        benchmark_plan(dsa_n[i], 257, 3, NTT_PLAN_CYCLIC);
+    }
+
+    return 0;
+}
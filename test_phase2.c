@@ -125,8 +125,8 @@ int main(void) {
     }
 
     /* Test on 20 random instances */
-    size_t total_size = 0;
-    int success_count = 0;
+    size_t total_size = 0, total_size_tans = 0;
+    int success_count = 0, tans_count = 0;
 
     for (int i = 0; i < 20; i++) {
         generate_s_mangled_97nz(vector, 1000 + i * 123);
@@ -167,6 +167,19 @@ int main(void) {
         }
 
         sparse_phase2_free(enc);
+
+        /* A/B: same header and gaps, tANS for the values */
+        sparse_phase2_t *enc_tans = sparse_phase2_encode_coder(vector, DIMENSION,
+                                                               SPARSE_PHASE2_TANS);
+        if (enc_tans &&
+            sparse_phase2_decode_coder(enc_tans, decoded, DIMENSION, SPARSE_PHASE2_TANS) == 0 &&
+            verify_vectors(vector, decoded, DIMENSION)) {
+            total_size_tans += enc_tans->size;
+            tans_count++;
+        } else {
+            printf("Trial %2d: ✗ tANS round trip failed\n", i + 1);
+        }
+        sparse_phase2_free(enc_tans);
     }
 
     printf("\n=== Results ===\n");
@@ -188,6 +201,10 @@ int main(void) {
         printf("  Original (sparse_optimal_large): %.0f bytes\n", baseline_original);
         printf("  Phase 1 (delta alphabet):        %.1f bytes\n", baseline_phase1);
         printf("  Phase 2 (delta + rANS):          %.1f bytes\n", avg_size);
+        if (tans_count > 0) {
+            printf("  Phase 2 (delta + tANS):          %.1f bytes\n",
+                   (double)total_size_tans / tans_count);
+        }
         printf("\n");
         printf("  Savings from original:           %.1f bytes (%.1f%% reduction)\n",
                savings_from_original, improvement_from_original);
@@ -206,5 +223,5 @@ int main(void) {
     free(vector);
     free(decoded);
 
-    return (success_count == 20) ? 0 : 1;
+    return (success_count == 20 && tans_count == 20) ? 0 : 1;
 }
@@ -0,0 +1,195 @@
+/**
+ * Test the interleaved rANS coder: round trips for every lane count,
+ * AVX2 against the portable decoder, corrupt streams, and throughput
+ *
+ * Build: gcc -O2 -mavx2 -o test_rans_interleaved test_rans_interleaved.c -lm
+ *        (without -mavx2 the portable decoder is tested alone)
+ */
+
+#include "rans_interleaved.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SYMS 20000
+
+static uint64_t rng_state = 0xD1B54A32D192ED03ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Random frequencies over n_symbols, summing to RANS_TOTAL, skewed */
+static void random_freqs(uint32_t *freqs, int n_symbols) {
+    for (int s = 0; s < n_symbols; s++) {
+        freqs[s] = 1;
+    }
+    for (uint32_t k = (uint32_t)n_symbols; k < RANS_TOTAL; k++) {
+        uint64_t r = next_rand();
+        /* Three quarters to the first quarter of the alphabet */
+        int s = (r >> 32) % 4 ? (int)(r % (n_symbols / 4 + 1)) : (int)(r % n_symbols);
+        freqs[s]++;
+    }
+}
+
+/* Symbols drawn from the frequencies */
+static void random_syms(const rans_table_t *t, uint8_t *syms, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        syms[i] = (uint8_t)t->slot[next_rand() % RANS_TOTAL];
+    }
+}
+
+static double entropy_bytes(const uint32_t *freqs, const uint8_t *syms, size_t n) {
+    double bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        bits -= log2((double)freqs[syms[i]] / RANS_TOTAL);
+    }
+    return bits / 8;
+}
+
+int main(void) {
+    static uint8_t syms[MAX_SYMS], out[MAX_SYMS], alt[MAX_SYMS];
+    static uint8_t stream[MAX_SYMS + RANS_MAX_LANES * RANS_STATE_BYTES];
+    static rans_table_t table;
+    uint32_t freqs[RANS_TOTAL];
+    int pass = 1;
+
+    printf("=== Interleaved rANS ===\n");
+#if defined(__AVX2__)
+    printf("  (AVX2 8-lane decoder enabled)\n");
+#endif
+
+    /* Round trips: every lane count, short and long messages */
+    int trip_ok = 1, simd_ok = 1;
+    double excess = 0;
+    int n_long = 0;
+    for (int trial = 0; trial < 400; trial++) {
+        const int n_symbols = 1 + (int)(next_rand() % (trial % 4 == 0 ? RANS_TOTAL : 40));
+        const unsigned lanes = 1u << (trial % 4);
+        const size_t n = trial % 8 < 2 ? next_rand() % 20 : next_rand() % MAX_SYMS;
+        random_freqs(freqs, n_symbols);
+        trip_ok &= rans_table_build(&table, freqs, n_symbols) == 0;
+        random_syms(&table, syms, n);
+
+        size_t size = rans_encode(&table, lanes, syms, n, stream, rans_max_bytes(n, lanes));
+        trip_ok &= size > 0 && size <= rans_max_bytes(n, lanes);
+        if (n >= 1000) {
+            excess += (size - entropy_bytes(freqs, syms, n)) / n;
+            n_long++;
+        }
+
+        memset(out, 0xAA, n);
+        memset(alt, 0x55, n);
+        trip_ok &= rans_decode_ex(&table, lanes, stream, size, out, n, 0) == 0 &&
+                   memcmp(out, syms, n) == 0;
+        simd_ok &= rans_decode(&table, lanes, stream, size, alt, n) == 0 &&
+                   memcmp(alt, syms, n) == 0;
+    }
+    printf("  Round trips, 1/2/4/8 lanes: %s\n", trip_ok ? "PASS" : "FAIL");
+    printf("  SIMD decoder matches: %s\n", simd_ok ? "PASS" : "FAIL");
+    printf("  Size above entropy: %.4f bytes/symbol (messages >= 1000)\n", excess / n_long);
+    pass &= trip_ok && simd_ok;
+
+    /* Truncated, extended and corrupted streams fail, and never overrun */
+    int corrupt_ok = 1;
+    for (int trial = 0; trial < 400; trial++) {
+        const unsigned lanes = 1u << (trial % 4);
+        const size_t n = 1 + next_rand() % 3000;
+        random_freqs(freqs, 12);
+        rans_table_build(&table, freqs, 12);
+        random_syms(&table, syms, n);
+        size_t size = rans_encode(&table, lanes, syms, n, stream, sizeof(stream));
+
+        /* Exact-size copies, so reads past the end show up under ASAN */
+        uint8_t *cut = malloc(size);
+        memcpy(cut, stream, size);
+        for (int simd = 0; simd < 2; simd++) {
+            corrupt_ok &= rans_decode_ex(&table, lanes, cut, size - 1, out, n, simd) == -1;
+            corrupt_ok &= rans_decode_ex(&table, lanes, cut, size, out, n - 1, simd) == -1;
+        }
+        cut[next_rand() % size] ^= (uint8_t)(1 + next_rand() % 255);
+        for (int simd = 0; simd < 2; simd++) {
+            /* A flipped byte may still decode, but only to some message */
+            int r = rans_decode_ex(&table, lanes, cut, size, out, n, simd);
+            corrupt_ok &= r == 0 || r == -1;
+        }
+        free(cut);
+    }
+    {
+        uint8_t zeros[3] = { 0 };
+        corrupt_ok &= rans_decode(&table, 1, zeros, 3, out, 0) == -1;    /* state < RANS_L */
+        corrupt_ok &= rans_decode(&table, 3, stream, sizeof(stream), out, 1) == -1;
+        corrupt_ok &= rans_encode(&table, 3, syms, 1, stream, sizeof(stream)) == 0;
+        corrupt_ok &= rans_encode(&table, 1, syms, 100, stream, 10) == 0;
+    }
+    printf("  Corrupt streams rejected: %s\n", corrupt_ok ? "PASS" : "FAIL");
+    pass &= corrupt_ok;
+
+    /* Bad frequency tables */
+    int table_ok = 1;
+    {
+        uint32_t f[3] = { 128, 128, 0 };
+        table_ok &= rans_table_build(&table, f, 3) == -1;       /* zero frequency */
+        f[2] = 1;
+        table_ok &= rans_table_build(&table, f, 3) == -1;       /* sum 257 */
+        f[1] = 127;
+        table_ok &= rans_table_build(&table, f, 3) == 0;
+        table_ok &= rans_table_build(&table, f, 0) == -1;
+        uint8_t bad = 5;                                        /* no frequency */
+        table_ok &= rans_encode(&table, 1, &bad, 1, stream, sizeof(stream)) == 0;
+    }
+    printf("  Bad frequency tables rejected: %s\n", table_ok ? "PASS" : "FAIL");
+    pass &= table_ok;
+
+    /* Throughput: a ~40-value Gaussian-like alphabet */
+    {
+        const size_t n = MAX_SYMS;
+        for (int s = 0; s < 40; s++) {
+            double z = (s - 19.5) / 7.0;
+            freqs[s] = 1 + (uint32_t)(14.0 * exp(-z * z / 2));
+        }
+        uint32_t sum = 0;
+        for (int s = 0; s < 40; s++) {
+            sum += freqs[s];
+        }
+        freqs[19] += RANS_TOTAL - sum;
+        rans_table_build(&table, freqs, 40);
+        random_syms(&table, syms, n);
+
+        for (unsigned lanes = 1; lanes <= RANS_MAX_LANES; lanes *= 2) {
+            size_t size = rans_encode(&table, lanes, syms, n, stream, sizeof(stream));
+            const int iters = 200;
+            double t0 = now_ns();
+            for (int it = 0; it < iters; it++) {
+                rans_decode_ex(&table, lanes, stream, size, out, n, 0);
+            }
+            double t_scalar = (now_ns() - t0) / ((double)iters * n);
+            printf("  %u lane%s: %zu bytes, decode %.2f ns/symbol", lanes,
+                   lanes > 1 ? "s" : " ", size, t_scalar);
+#if defined(__AVX2__)
+            if (lanes == 8) {
+                t0 = now_ns();
+                for (int it = 0; it < iters; it++) {
+                    rans_decode(&table, lanes, stream, size, out, n);
+                }
+                printf(", AVX2 %.2f ns/symbol", (now_ns() - t0) / ((double)iters * n));
+            }
+#endif
+            printf("\n");
+        }
+    }
+
+    printf("\n%s\n", pass ? "All rANS tests PASS" : "Some rANS tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <time.h>
+#include <unistd.h>
 #include "ntt64.h"
 #include "ntt64_simd.h"
 
@@ -34,7 +35,7 @@ int test_simd_correctness(const char* impl_name,
     int all_passed = 1;
 
     // Test 1: Forward NTT
-    printf("  [1/4] Testing forward NTT... ");
+    printf("  [1/5] Testing forward NTT... ");
     uint32_t poly_scalar[NTT_N], poly_simd[NTT_N];
     random_poly(poly_scalar, q);
     memcpy(poly_simd, poly_scalar, sizeof(poly_scalar));
@@ -54,7 +55,7 @@ int test_simd_correctness(const char* impl_name,
     if (passed) printf("PASSED\n");
 
     // Test 2: Inverse NTT
-    printf("  [2/4] Testing inverse NTT... ");
+    printf("  [2/5] Testing inverse NTT... ");
     random_poly(poly_scalar, q);
     memcpy(poly_simd, poly_scalar, sizeof(poly_scalar));
 
@@ -73,7 +74,7 @@ int test_simd_correctness(const char* impl_name,
     if (passed) printf("PASSED\n");
 
     // Test 3: Forward -> Inverse = identity
-    printf("  [3/4] Testing NTT -> INTT = identity... ");
+    printf("  [3/5] Testing NTT -> INTT = identity... ");
     random_poly(poly_simd, q);
     uint32_t poly_copy[NTT_N];
     memcpy(poly_copy, poly_simd, sizeof(poly_simd));
@@ -93,7 +94,7 @@ int test_simd_correctness(const char* impl_name,
     if (passed) printf("PASSED\n");
 
     // Test 4: Pointwise multiplication
-    printf("  [4/4] Testing pointwise multiplication... ");
+    printf("  [4/5] Testing pointwise multiplication... ");
     uint32_t a_scalar[NTT_N], b_scalar[NTT_N], result_scalar[NTT_N];
     uint32_t a_simd[NTT_N], b_simd[NTT_N], result_simd[NTT_N];
 
@@ -116,10 +117,647 @@ int test_simd_correctness(const char* impl_name,
     }
     if (passed) printf("PASSED\n");
 
+    // Test 5: Boundary coefficients (q-1 stresses the add/sub carries)
+    printf("  [5/5] Testing boundary coefficients... ");
+    passed = 1;
+    for (int pattern = 0; pattern < 3 && passed; pattern++) {
+        for (int i = 0; i < NTT_N; i++) {
+            uint32_t v = (pattern == 0) ? q - 1 : (pattern == 1) ? (i & 1) * (q - 1) : (uint32_t)i % q;
+            poly_scalar[i] = v;
+        }
+        memcpy(poly_simd, poly_scalar, sizeof(poly_scalar));
+
+        ntt64_forward_scalar(poly_scalar, layer);
+        forward_fn(poly_simd, layer);
+        ntt64_inverse_scalar(poly_scalar, layer);
+        inverse_fn(poly_simd, layer);
+        pointwise_fn(result_simd, poly_simd, poly_simd, layer);
+        ntt64_pointwise_mul_scalar(result_scalar, poly_scalar, poly_scalar, layer);
+
+        for (int i = 0; i < NTT_N; i++) {
+            if (poly_scalar[i] != poly_simd[i] || result_scalar[i] != result_simd[i]) {
+                printf("FAILED (pattern %d) at index %d\n", pattern, i);
+                passed = 0;
+                all_passed = 0;
+                break;
+            }
+        }
+    }
+    if (passed) printf("PASSED\n");
+
     printf("\n");
     return all_passed;
 }
 
+// Test a batched (interleaved) implementation against per-polynomial scalar NTTs
+#define BATCH_TEST_COUNT 19   // not a multiple of any vector width: covers tails
+
+int test_batch_correctness(const char* impl_name,
+                           ntt64_batch_fn forward_batch_fn,
+                           ntt64_batch_fn inverse_batch_fn,
+                           int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
+    uint32_t polys[BATCH_TEST_COUNT * NTT_N], expect[BATCH_TEST_COUNT * NTT_N];
+    uint32_t soa[BATCH_TEST_COUNT * NTT_N], out[BATCH_TEST_COUNT * NTT_N];
+
+    printf("  [batch] Testing %s batched forward/inverse (%d polys)... ",
+           impl_name, BATCH_TEST_COUNT);
+
+    for (int p = 0; p < BATCH_TEST_COUNT; p++) {
+        random_poly(&polys[p * NTT_N], q);
+        memcpy(&expect[p * NTT_N], &polys[p * NTT_N], NTT_N * sizeof(uint32_t));
+        ntt64_forward_scalar(&expect[p * NTT_N], layer);
+    }
+
+    ntt64_interleave(soa, polys, BATCH_TEST_COUNT);
+    forward_batch_fn(soa, BATCH_TEST_COUNT, layer);
+    ntt64_deinterleave(out, soa, BATCH_TEST_COUNT);
+    if (memcmp(out, expect, sizeof(out)) != 0) {
+        printf("FAILED (forward)\n");
+        return 0;
+    }
+
+    inverse_batch_fn(soa, BATCH_TEST_COUNT, layer);
+    ntt64_deinterleave(out, soa, BATCH_TEST_COUNT);
+    if (memcmp(out, polys, sizeof(out)) != 0) {
+        printf("FAILED (inverse)\n");
+        return 0;
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Test an all-layers (one modulus per lane) implementation against scalar
+int test_all_layers_correctness(const char* impl_name,
+                                ntt64_forward_all_fn forward_all_fn,
+                                ntt64_inverse_all_fn inverse_all_fn) {
+    uint32_t in[NTT_N];
+    uint32_t expect[NTT_NUM_LAYERS][NTT_N], out[NTT_NUM_LAYERS][NTT_N];
+
+    printf("Testing %s all-layers forward/inverse... ", impl_name);
+    for (int trial = 0; trial < 50; trial++) {
+        // Unreduced 32-bit input on even trials, small coefficients on odd ones
+        for (int i = 0; i < NTT_N; i++) {
+            in[i] = (trial & 1) ? rand32() % 257 : rand32();
+        }
+        ntt64_forward_all_layers_scalar(in, expect);
+        forward_all_fn(in, out);
+        if (memcmp(out, expect, sizeof(out)) != 0) {
+            printf("FAILED (forward, trial %d)\n", trial);
+            return 0;
+        }
+
+        ntt64_inverse_all_layers_scalar((const uint32_t (*)[NTT_N])expect, expect);
+        inverse_all_fn((const uint32_t (*)[NTT_N])out, out);
+        if (memcmp(out, expect, sizeof(out)) != 0) {
+            printf("FAILED (inverse, trial %d)\n", trial);
+            return 0;
+        }
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Test fused pointwise kernels against step-by-step field arithmetic
+#define FUSED_TEST_COUNT 9
+
+int test_fused_correctness(const char* impl_name,
+                           ntt64_pointwise_mac_fn mac_fn,
+                           ntt64_pointwise_mul_chain_fn chain_fn,
+                           ntt64_pointwise_scale_add_fn scale_add_fn,
+                           int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
+    static uint32_t a[FUSED_TEST_COUNT][NTT_N], b[FUSED_TEST_COUNT][NTT_N];
+    uint32_t acc[NTT_N], expect[NTT_N], x[NTT_N], out[NTT_N];
+
+    printf("  [fused] Testing %s mac/chain/scale_add... ", impl_name);
+    for (int trial = 0; trial < 20; trial++) {
+        // Trial 0 uses q-1 everywhere: the largest products and sums
+        for (int i = 0; i < FUSED_TEST_COUNT; i++) {
+            for (int j = 0; j < NTT_N; j++) {
+                a[i][j] = trial ? rand32() % q : q - 1;
+                b[i][j] = trial ? rand32() % q : q - 1;
+            }
+        }
+        for (int j = 0; j < NTT_N; j++) {
+            x[j] = acc[j] = trial ? rand32() % q : q - 1;
+        }
+
+        size_t count = (size_t)(trial % (FUSED_TEST_COUNT + 1));
+        if (trial == 0) count = FUSED_TEST_COUNT;
+
+        memcpy(expect, acc, sizeof(acc));
+        for (size_t i = 0; i < count; i++) {
+            for (int j = 0; j < NTT_N; j++) {
+                expect[j] = ntt64_add_mod(expect[j], ntt64_mul_mod(a[i][j], b[i][j], layer), layer);
+            }
+        }
+        mac_fn(acc, (const uint32_t (*)[NTT_N])a, (const uint32_t (*)[NTT_N])b, count, layer);
+        if (memcmp(acc, expect, sizeof(acc)) != 0) {
+            printf("FAILED (mac, trial %d)\n", trial);
+            return 0;
+        }
+
+        memcpy(expect, x, sizeof(x));
+        for (size_t i = 0; i < count; i++) {
+            for (int j = 0; j < NTT_N; j++) {
+                expect[j] = ntt64_mul_mod(expect[j], b[i][j], layer);
+            }
+        }
+        chain_fn(out, x, (const uint32_t (*)[NTT_N])b, count, layer);
+        if (memcmp(out, expect, sizeof(out)) != 0) {
+            printf("FAILED (chain, trial %d)\n", trial);
+            return 0;
+        }
+
+        uint32_t scale = trial ? rand32() : 0xFFFFFFFFu;
+        for (int j = 0; j < NTT_N; j++) {
+            expect[j] = ntt64_add_mod(a[0][j], ntt64_mul_mod(scale % q, b[0][j], layer), layer);
+        }
+        scale_add_fn(out, a[0], scale, b[0], layer);
+        if (memcmp(out, expect, sizeof(out)) != 0) {
+            printf("FAILED (scale_add, trial %d)\n", trial);
+            return 0;
+        }
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Test prepared-operand multiplication against ntt64_mul_mod
+int test_prepared_correctness(const char* impl_name,
+                              ntt64_pointwise_mul_prepared_fn mul_fn,
+                              int layer) {
+    uint32_t q = ntt64_get_modulus(layer);
+    uint32_t a[NTT_N], b[NTT_N], result[NTT_N];
+    static ntt64_prepared_t prep;
+
+    printf("  [prepared] Testing %s pointwise_mul_prepared... ", impl_name);
+    for (int trial = 0; trial < 20; trial++) {
+        // Trial 0: largest operands; a may be any 32-bit value
+        for (int j = 0; j < NTT_N; j++) {
+            a[j] = trial ? rand32() : 0xFFFFFFFFu - (uint32_t)j;
+            b[j] = trial ? rand32() % q : q - 1 - (uint32_t)j % 2;
+        }
+        ntt64_prepare_operand(&prep, b, layer);
+        mul_fn(result, a, &prep);
+        for (int j = 0; j < NTT_N; j++) {
+            if (result[j] != ntt64_mul_mod(a[j] % q, b[j], layer)) {
+                printf("FAILED (trial %d, index %d)\n", trial, j);
+                return 0;
+            }
+        }
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Benchmark prepared-operand multiplication against ntt64_pointwise_mul
+void benchmark_prepared(const char* impl_name,
+                        ntt64_pointwise_mul_prepared_fn prepared_fn,
+                        ntt64_pointwise_mul_fn mul_fn,
+                        int layer,
+                        int iterations) {
+    uint32_t q = ntt64_get_modulus(layer);
+    uint32_t a[NTT_N], b[NTT_N], result[NTT_N];
+    static ntt64_prepared_t prep;
+    random_poly(a, q);
+    random_poly(b, q);
+    ntt64_prepare_operand(&prep, b, layer);
+
+    clock_t start = clock();
+    for (int it = 0; it < iterations; it++) {
+        prepared_fn(result, a, &prep);
+        a[it % NTT_N] ^= result[0] & 1;
+    }
+    double prepared = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    start = clock();
+    for (int it = 0; it < iterations; it++) {
+        mul_fn(result, a, b, layer);
+        a[it % NTT_N] ^= result[0] & 1;
+    }
+    double plain = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    printf("  %-10s: mul_prepared=%.3f µs (pointwise_mul: %.3f µs)\n",
+           impl_name, prepared, plain);
+}
+
+// Test rounding switches from one layer to every layer against exact division
+int test_switch_correctness(const char* impl_name, ntt64_mod_switch_fn switch_fn,
+                            int from_layer, int last_layer) {
+    // Not a multiple of 8, so the vector kernels also run their scalar tail
+    enum { COUNT = 2 * NTT_N + 5 };
+    uint64_t q = ntt64_get_modulus(from_layer);
+    uint32_t x[COUNT], y[COUNT];
+    ntt64_switch_t sw;
+
+    printf("  [switch] Testing %s mod_switch from layer %d... ", impl_name, from_layer);
+    for (int to = 0; to <= last_layer; to++) {
+        uint64_t q_to = ntt64_get_modulus(to);
+        if (ntt64_switch_prepare(&sw, from_layer, to) != 0) {
+            printf("FAILED (prepare, layer %d)\n", to);
+            return 0;
+        }
+        for (int i = 0; i < COUNT; i++) {
+            // Edges first: 0, q - 1 and the values either side of q / 2
+            static const int64_t edge[] = { 0, -1, 0, 1 };
+            x[i] = i < 4 ? (uint32_t)(i == 0 ? 0 : i == 1 ? q - 1 : q / 2 + edge[i])
+                         : rand32() % (uint32_t)q;
+        }
+        memcpy(y, x, sizeof(x));
+        switch_fn(y, COUNT, &sw);
+        for (int i = 0; i < COUNT; i++) {
+            uint64_t expect = (uint64_t)(((__uint128_t)2 * x[i] * q_to + q) / (2 * q)) % q_to;
+            if (y[i] != expect) {
+                printf("FAILED (layer %d, x = %u: %u, expected %llu)\n",
+                       to, x[i], y[i], (unsigned long long)expect);
+                return 0;
+            }
+        }
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Test CRT recombination on sets of layers, and the sets prepare must reject
+int test_crt_correctness(const char* impl_name, ntt64_crt_combine_fn crt_fn, int registered_layer) {
+    enum { COUNT = 2 * NTT_N + 5 };
+    const int sets[][NTT64_CRT_MAX] = {
+        { 5 }, { 6, 5 }, { 0, 4, 6 }, { 1, 2, 3, 4 }, { 3, 0, 2, 1, -1 },
+    };
+    const size_t sizes[] = { 1, 2, 3, 4, 5 };
+    uint32_t residues[NTT64_CRT_MAX][COUNT];
+    const uint32_t *rows[NTT64_CRT_MAX];
+    uint64_t x[COUNT], out[COUNT];
+    ntt64_crt_t crt;
+
+    printf("  [crt] Testing %s crt_combine... ", impl_name);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int layers[NTT64_CRT_MAX];
+        for (size_t j = 0; j < sizes[s]; j++) {
+            layers[j] = sets[s][j] < 0 ? registered_layer : sets[s][j];
+        }
+        if (ntt64_crt_prepare(&crt, layers, sizes[s]) != 0) {
+            printf("FAILED (prepare, set %zu)\n", s);
+            return 0;
+        }
+        for (int i = 0; i < COUNT; i++) {
+            uint64_t r = ((uint64_t)rand32() << 32) | rand32();
+            x[i] = i == 0 ? 0 : i == 1 ? crt.modulus - 1 : r % crt.modulus;
+        }
+        for (size_t j = 0; j < sizes[s]; j++) {
+            for (int i = 0; i < COUNT; i++) {
+                residues[j][i] = (uint32_t)(x[i] % crt.q[j]);
+            }
+            rows[j] = residues[j];
+        }
+        crt_fn(out, rows, COUNT, &crt);
+        for (int i = 0; i < COUNT; i++) {
+            if (out[i] != x[i]) {
+                printf("FAILED (set %zu, index %d)\n", s, i);
+                return 0;
+            }
+        }
+    }
+
+    // A repeated layer, a product of 2^64 or more, an unknown layer
+    const int repeated[] = { 2, 2 }, wide[] = { 6, 5, 4 }, unknown[] = { 0, NTT_MAX_LAYERS };
+    if (ntt64_crt_prepare(&crt, repeated, 2) == 0 || ntt64_crt_prepare(&crt, wide, 3) == 0 ||
+        ntt64_crt_prepare(&crt, unknown, 2) == 0) {
+        printf("FAILED (invalid set accepted)\n");
+        return 0;
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Benchmark a switch from the widest layer to q = 257 and a two-layer CRT
+void benchmark_switch_crt(const char* impl_name, ntt64_mod_switch_fn switch_fn,
+                          ntt64_crt_combine_fn crt_fn, int iterations) {
+    static uint32_t x[NTT_N], r[2][NTT_N];
+    static uint64_t out[NTT_N];
+    const int layers[] = { 6, 5 };
+    const uint32_t *rows[] = { r[0], r[1] };
+    ntt64_switch_t sw;
+    ntt64_crt_t crt;
+    ntt64_switch_prepare(&sw, 6, 0);
+    ntt64_crt_prepare(&crt, layers, 2);
+    random_poly(r[0], crt.q[0]);
+    random_poly(r[1], crt.q[1]);
+
+    // Outputs are below 257 and so valid inputs again
+    random_poly(x, sw.q_from);
+    clock_t start = clock();
+    for (int it = 0; it < iterations; it++) {
+        switch_fn(x, NTT_N, &sw);
+        x[it % NTT_N] = rand32() % sw.q_from;
+    }
+    double sw_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    start = clock();
+    for (int it = 0; it < iterations; it++) {
+        crt_fn(out, rows, NTT_N, &crt);
+        r[0][it % NTT_N] = (uint32_t)(out[0] % crt.q[0]);
+    }
+    double crt_time = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    printf("  %-10s: mod_switch 6->0=%.3f µs crt_combine {6,5}=%.3f µs\n",
+           impl_name, sw_time, crt_time);
+}
+
+// Forward then inverse through the dispatch pointers on every layer
+static int dispatch_round_trip(int last_layer) {
+    uint32_t poly[NTT_N], orig[NTT_N];
+    for (int layer = 0; layer <= last_layer; layer++) {
+        random_poly(orig, ntt64_get_modulus(layer));
+        memcpy(poly, orig, sizeof(poly));
+        ntt64_forward_ptr(poly, layer);
+        ntt64_pointwise_mul_ptr(poly, poly, poly, layer);
+        ntt64_inverse_ptr(poly, layer);
+        uint32_t square[NTT_N];
+        memcpy(square, orig, sizeof(square));
+        ntt64_forward_scalar(square, layer);
+        ntt64_pointwise_mul_scalar(square, square, square, layer);
+        ntt64_inverse_scalar(square, layer);
+        if (memcmp(poly, square, sizeof(poly)) != 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#ifndef NTT64_IFUNC
+// Fastest of 64 rounds of 16 forward transforms on layer 0, in ns per call
+static double forward_ns(ntt64_forward_fn fn) {
+    uint32_t poly[NTT_N];
+    random_poly(poly, ntt64_get_modulus(0));
+    double best = 1e30;
+    for (int round = 0; round < 64; round++) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int call = 0; call < 16; call++) {
+            fn(poly, 0);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        const double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 16;
+        if (ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+#endif
+
+// Test the autotuner: timing, the environment override and a saved choice
+int test_autotune(int last_layer) {
+    char path[64], names[NTT_MAX_LAYERS][64];
+    snprintf(path, sizeof(path), "/tmp/ntt64_autotune_%d.txt", getpid());
+    remove(path);
+    ntt64_init();
+    const ntt64_forward_fn fastest = ntt64_forward_ptr;
+    (void)fastest;
+
+    printf("  [autotune] Testing ntt64_autotune... ");
+    if (ntt64_autotune(NULL) != 0 || !dispatch_round_trip(last_layer) ||
+        strncmp(ntt64_get_implementation_name(), "autotuned", 9) != 0) {
+        printf("FAILED (timing)\n");
+        return 0;
+    }
+
+    setenv(NTT64_BACKEND_ENV, "scalar", 1);
+    int forced = ntt64_autotune(path) == 0 && dispatch_round_trip(last_layer);
+    for (int layer = 0; layer <= last_layer; layer++) {
+        forced &= strcmp(ntt64_get_layer_implementation_name(layer), "scalar") == 0;
+    }
+    // The public entry point runs the forced kernel: its time is the scalar
+    // kernel's, not the one ntt64_init() would pick (NTT64_IFUNC binds it
+    // at load time instead)
+    #ifndef NTT64_IFUNC
+    if (forced && fastest != ntt64_forward_scalar) {
+        const double entry = forward_ns(ntt64_forward);
+        const double scalar = forward_ns(ntt64_forward_scalar);
+        const double fast = forward_ns(fastest);
+        if (entry < (scalar + fast) / 2) {
+            unsetenv(NTT64_BACKEND_ENV);
+            printf("FAILED (ntt64_forward %.0f ns, scalar %.0f ns, default %.0f ns)\n",
+                   entry, scalar, fast);
+            return 0;
+        }
+    }
+    #endif
+    unsetenv(NTT64_BACKEND_ENV);
+    FILE *f = fopen(path, "r");
+    if (!forced || f) {
+        printf("FAILED (%s)\n", f ? "override saved a file" : "override");
+        if (f) {
+            fclose(f);
+        }
+        return 0;
+    }
+
+    // Timed and saved, then loaded: the same names
+    if (ntt64_autotune(path) != 0) {
+        printf("FAILED (save)\n");
+        return 0;
+    }
+    for (int layer = 0; layer <= last_layer; layer++) {
+        snprintf(names[layer], sizeof(names[layer]), "%s",
+                 ntt64_get_layer_implementation_name(layer));
+    }
+    int loaded = ntt64_autotune(path) == 0 && dispatch_round_trip(last_layer);
+    for (int layer = 0; layer <= last_layer; layer++) {
+        loaded &= strcmp(ntt64_get_layer_implementation_name(layer), names[layer]) == 0;
+    }
+
+    // A file that does not parse is replaced by a new timing
+    f = fopen(path, "w");
+    fprintf(f, "ntt64-autotune 1 features %d\n0 1 none none none\n", ntt64_detect_cpu_features());
+    fclose(f);
+    int retuned = ntt64_autotune(path) == 0 && dispatch_round_trip(last_layer) &&
+                  ntt64_get_layer_implementation_name(last_layer + 1) == NULL;
+    remove(path);
+    ntt64_init();
+    if (!loaded || !retuned) {
+        printf("FAILED (%s)\n", loaded ? "bad file" : "load");
+        return 0;
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Test the 16-bit kernels against the 32-bit bit-reversed transforms
+int test_ntt16_correctness(const char* impl_name,
+                           ntt64_ntt16_fn forward_fn,
+                           ntt64_ntt16_fn inverse_fn,
+                           ntt64_pointwise_mul16_fn mul_fn,
+                           int layer) {
+    uint16_t a[NTT_N], b[NTT_N], c[NTT_N], orig[NTT_N];
+    uint32_t wa[NTT_N], wb[NTT_N], wc[NTT_N];
+
+    printf("  [16-bit] Testing %s... ", impl_name);
+    if (!ntt64_layer_fits16(layer)) {
+        for (int j = 0; j < NTT_N; j++) a[j] = orig[j] = (uint16_t)rand32();
+        if (forward_fn(a, layer) != -1 || inverse_fn(a, layer) != -1 ||
+            mul_fn(a, a, a, layer) != -1 || memcmp(a, orig, sizeof(a)) != 0) {
+            printf("FAILED (wide modulus not rejected)\n");
+            return 0;
+        }
+        printf("PASSED (rejected)\n\n");
+        return 1;
+    }
+
+    uint32_t q = ntt64_get_modulus(layer);
+    for (int trial = 0; trial < 20; trial++) {
+        // Forward input may be any 16-bit value; trial 0 uses the largest
+        for (int j = 0; j < NTT_N; j++) {
+            orig[j] = a[j] = trial ? (uint16_t)rand32() : (uint16_t)(0xFFFF - j);
+            b[j] = (uint16_t)(trial ? rand32() % q : q - 1);
+        }
+        ntt64_unpack16(wa, a);
+        ntt64_unpack16(wb, b);
+
+        ntt64_forward_bitrev(wa, layer);
+        if (forward_fn(a, layer) != 0) {
+            printf("FAILED (forward rejected layer)\n");
+            return 0;
+        }
+        for (int j = 0; j < NTT_N; j++) {
+            if (a[j] != wa[j]) {
+                printf("FAILED (forward, trial %d, index %d)\n", trial, j);
+                return 0;
+            }
+        }
+
+        ntt64_forward_bitrev(wb, layer);
+        ntt64_pack16(b, wb);
+        ntt64_pointwise_mul_scalar(wc, wa, wb, layer);
+        mul_fn(c, a, b, layer);
+        for (int j = 0; j < NTT_N; j++) {
+            if (c[j] != wc[j]) {
+                printf("FAILED (pointwise, trial %d, index %d)\n", trial, j);
+                return 0;
+            }
+        }
+
+        inverse_fn(a, layer);
+        for (int j = 0; j < NTT_N; j++) {
+            if (a[j] != orig[j] % q) {
+                printf("FAILED (round trip, trial %d, index %d)\n", trial, j);
+                return 0;
+            }
+        }
+
+        ntt64_inverse_bitrev(wc, layer);
+        inverse_fn(c, layer);
+        for (int j = 0; j < NTT_N; j++) {
+            if (c[j] != wc[j]) {
+                printf("FAILED (inverse, trial %d, index %d)\n", trial, j);
+                return 0;
+            }
+        }
+    }
+
+    printf("PASSED\n\n");
+    return 1;
+}
+
+// Benchmark the 16-bit transforms against the 32-bit bit-reversed ones
+void benchmark_ntt16(const char* impl_name,
+                     ntt64_ntt16_fn forward_fn,
+                     ntt64_ntt16_fn inverse_fn,
+                     int layer,
+                     int iterations) {
+    uint32_t q = ntt64_get_modulus(layer);
+    uint16_t poly[NTT_N];
+    uint32_t wide[NTT_N];
+    random_poly(wide, q);
+    ntt64_pack16(poly, wide);
+
+    clock_t start = clock();
+    for (int it = 0; it < iterations; it++) {
+        forward_fn(poly, layer);
+        inverse_fn(poly, layer);
+    }
+    double narrow = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    start = clock();
+    for (int it = 0; it < iterations; it++) {
+        ntt64_forward_bitrev(wide, layer);
+        ntt64_inverse_bitrev(wide, layer);
+    }
+    double full = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    printf("  %-10s: 16-bit fwd+inv=%.3f µs (32-bit bitrev: %.3f µs)\n",
+           impl_name, narrow, full);
+}
+
+// Benchmark ntt64_pointwise_mac against pointwise_mul + add through memory
+void benchmark_fused(const char* impl_name,
+                     ntt64_pointwise_mac_fn mac_fn,
+                     ntt64_pointwise_mul_fn mul_fn,
+                     int layer,
+                     int iterations) {
+    enum { TERMS = 8 };
+    static uint32_t a[TERMS][NTT_N], b[TERMS][NTT_N];
+    uint32_t acc[NTT_N] = {0}, tmp[NTT_N];
+    uint32_t q = ntt64_get_modulus(layer);
+    for (int i = 0; i < TERMS; i++) {
+        random_poly(a[i], q);
+        random_poly(b[i], q);
+    }
+
+    clock_t start = clock();
+    for (int it = 0; it < iterations; it++) {
+        mac_fn(acc, (const uint32_t (*)[NTT_N])a, (const uint32_t (*)[NTT_N])b, TERMS, layer);
+    }
+    double fused = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    start = clock();
+    for (int it = 0; it < iterations; it++) {
+        for (int i = 0; i < TERMS; i++) {
+            mul_fn(tmp, a[i], b[i], layer);
+            for (int j = 0; j < NTT_N; j++) {
+                acc[j] = ntt64_add_mod(acc[j], tmp[j], layer);
+            }
+        }
+    }
+    double unfused = ((double)(clock() - start)) / CLOCKS_PER_SEC * 1000000.0 / iterations;
+
+    printf("  %-10s: mac of %d products=%.2f µs (mul+add: %.2f µs)\n",
+           impl_name, TERMS, fused, unfused);
+}
+
+// Benchmark a batched implementation (time per polynomial)
+void benchmark_batch(const char* impl_name,
+                     ntt64_batch_fn forward_batch_fn,
+                     int layer,
+                     int iterations) {
+    enum { COUNT = 64 };
+    static uint32_t soa[COUNT * NTT_N];
+    uint32_t q = ntt64_get_modulus(layer);
+    for (int i = 0; i < COUNT * NTT_N; i++) {
+        soa[i] = rand32() % q;
+    }
+
+    int rounds = iterations / COUNT;
+    clock_t start = clock();
+    for (int i = 0; i < rounds; i++) {
+        forward_batch_fn(soa, COUNT, layer);
+    }
+    clock_t end = clock();
+    double per_poly = ((double)(end - start)) / CLOCKS_PER_SEC * 1000000.0 / (rounds * COUNT);
+
+    printf("  %-10s: forward=%.2f µs per poly (batch of %d)\n", impl_name, per_poly, COUNT);
+}
+
 // Benchmark performance
 void benchmark_implementation(const char* impl_name,
                                ntt64_forward_fn forward_fn,
@@ -158,8 +796,12 @@ int main(void) {
     // Detect CPU features
     int features = ntt64_detect_cpu_features();
     printf("CPU Features: ");
+    if (features & NTT_CPU_AVX512) printf("AVX-512 ");
+    if (features & NTT_CPU_AVX512IFMA) printf("IFMA ");
     if (features & NTT_CPU_AVX2) printf("AVX2 ");
     if (features & NTT_CPU_NEON) printf("NEON ");
+    if (features & NTT_CPU_SVE) printf("SVE ");
+    if (features & NTT_CPU_SVE2) printf("SVE2 ");
     printf("SCALAR\n\n");
 
     // Test all layers with all available implementations
@@ -168,7 +810,11 @@ int main(void) {
     printf("CORRECTNESS TESTS\n");
     printf("========================================\n\n");
 
-    for (int layer = 0; layer < NTT_NUM_LAYERS; layer++) {
+    // One registered modulus after the built-in layers: every entry point
+    // must accept it (the SIMD ones through the table-driven scalar kernel)
+    int registered_layer = ntt64_register_modulus(12289);
+
+    for (int layer = 0; layer <= registered_layer; layer++) {
         // Always test scalar
         if (!test_simd_correctness("scalar",
                                     ntt64_forward_scalar,
@@ -177,6 +823,32 @@ int main(void) {
                                     layer)) {
             all_tests_passed = 0;
         }
+        if (!test_batch_correctness("scalar",
+                                    ntt64_forward_batch_scalar,
+                                    ntt64_inverse_batch_scalar,
+                                    layer)) {
+            all_tests_passed = 0;
+        }
+        if (!test_fused_correctness("scalar",
+                                    ntt64_pointwise_mac_scalar,
+                                    ntt64_pointwise_mul_chain_scalar,
+                                    ntt64_pointwise_scale_add_scalar,
+                                    layer)) {
+            all_tests_passed = 0;
+        }
+        if (!test_prepared_correctness("scalar", ntt64_pointwise_mul_prepared_scalar, layer)) {
+            all_tests_passed = 0;
+        }
+        if (!test_switch_correctness("scalar", ntt64_mod_switch_scalar, layer, registered_layer)) {
+            all_tests_passed = 0;
+        }
+        if (!test_ntt16_correctness("scalar",
+                                    ntt64_forward_bitrev16_scalar,
+                                    ntt64_inverse_bitrev16_scalar,
+                                    ntt64_pointwise_mul16_scalar,
+                                    layer)) {
+            all_tests_passed = 0;
+        }
 
         #ifdef __AVX2__
         if (features & NTT_CPU_AVX2) {
@@ -187,6 +859,50 @@ int main(void) {
                                         layer)) {
                 all_tests_passed = 0;
             }
+            if (!test_batch_correctness("AVX2",
+                                        ntt64_forward_batch_avx2,
+                                        ntt64_inverse_batch_avx2,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+            if (!test_fused_correctness("AVX2",
+                                        ntt64_pointwise_mac_avx2,
+                                        ntt64_pointwise_mul_chain_avx2,
+                                        ntt64_pointwise_scale_add_avx2,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+            if (!test_prepared_correctness("AVX2", ntt64_pointwise_mul_prepared_avx2, layer)) {
+                all_tests_passed = 0;
+            }
+            if (!test_switch_correctness("AVX2", ntt64_mod_switch_avx2, layer, registered_layer)) {
+                all_tests_passed = 0;
+            }
+            if (!test_ntt16_correctness("AVX2",
+                                        ntt64_forward_bitrev16_avx2,
+                                        ntt64_inverse_bitrev16_avx2,
+                                        ntt64_pointwise_mul16_avx2,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+        }
+        #endif
+
+        #if defined(__AVX512F__) && defined(__AVX512BW__)
+        if (features & NTT_CPU_AVX512) {
+            if (!test_simd_correctness("AVX-512",
+                                        ntt64_forward_avx512,
+                                        ntt64_inverse_avx512,
+                                        ntt64_pointwise_mul_avx512,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+            if (!test_batch_correctness("AVX-512",
+                                        ntt64_forward_batch_avx512,
+                                        ntt64_inverse_batch_avx512,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
         }
         #endif
 
@@ -199,10 +915,62 @@ int main(void) {
                                         layer)) {
                 all_tests_passed = 0;
             }
+            if (!test_batch_correctness("NEON",
+                                        ntt64_forward_batch_neon,
+                                        ntt64_inverse_batch_neon,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+            #if defined(__aarch64__)
+            if (!test_ntt16_correctness("NEON",
+                                        ntt64_forward_bitrev16_neon,
+                                        ntt64_inverse_bitrev16_neon,
+                                        ntt64_pointwise_mul16_neon,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
+            #endif
+        }
+        #endif
+
+        #if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+        if (features & NTT_CPU_SVE2) {
+            if (!test_simd_correctness("SVE2",
+                                        ntt64_forward_sve2,
+                                        ntt64_inverse_sve2,
+                                        ntt64_pointwise_mul_sve2,
+                                        layer)) {
+                all_tests_passed = 0;
+            }
         }
         #endif
     }
 
+    if (!test_all_layers_correctness("scalar",
+                                     ntt64_forward_all_layers_scalar,
+                                     ntt64_inverse_all_layers_scalar)) {
+        all_tests_passed = 0;
+    }
+    if (!test_crt_correctness("scalar", ntt64_crt_combine_scalar, registered_layer)) {
+        all_tests_passed = 0;
+    }
+    #ifdef __AVX2__
+    if (features & NTT_CPU_AVX2) {
+        if (!test_crt_correctness("AVX2", ntt64_crt_combine_avx2, registered_layer)) {
+            all_tests_passed = 0;
+        }
+        if (!test_all_layers_correctness("AVX2",
+                                         ntt64_forward_all_layers_avx2,
+                                         ntt64_inverse_all_layers_avx2)) {
+            all_tests_passed = 0;
+        }
+    }
+    #endif
+
+    if (!test_autotune(registered_layer)) {
+        all_tests_passed = 0;
+    }
+
     printf("========================================\n");
     if (all_tests_passed) {
         printf("ALL CORRECTNESS TESTS PASSED ✓\n");
@@ -225,6 +993,10 @@ int main(void) {
                                  ntt64_forward_scalar,
                                  ntt64_inverse_scalar,
                                  layer, bench_iterations);
+        benchmark_fused("scalar", ntt64_pointwise_mac_scalar, ntt64_pointwise_mul_scalar,
+                        layer, bench_iterations);
+        benchmark_prepared("scalar", ntt64_pointwise_mul_prepared_scalar,
+                           ntt64_pointwise_mul_scalar, layer, bench_iterations);
 
         #ifdef __AVX2__
         if (features & NTT_CPU_AVX2) {
@@ -232,6 +1004,27 @@ int main(void) {
                                      ntt64_forward_avx2,
                                      ntt64_inverse_avx2,
                                      layer, bench_iterations);
+            benchmark_batch("AVX2 batch", ntt64_forward_batch_avx2,
+                            layer, bench_iterations);
+            benchmark_fused("AVX2", ntt64_pointwise_mac_avx2, ntt64_pointwise_mul_avx2,
+                            layer, bench_iterations);
+            benchmark_prepared("AVX2", ntt64_pointwise_mul_prepared_avx2,
+                               ntt64_pointwise_mul_avx2, layer, bench_iterations);
+            if (ntt64_layer_fits16(layer)) {
+                benchmark_ntt16("AVX2", ntt64_forward_bitrev16_avx2,
+                                ntt64_inverse_bitrev16_avx2, layer, bench_iterations);
+            }
+        }
+        #endif
+
+        #if defined(__AVX512F__) && defined(__AVX512BW__)
+        if (features & NTT_CPU_AVX512) {
+            benchmark_implementation("AVX-512",
+                                     ntt64_forward_avx512,
+                                     ntt64_inverse_avx512,
+                                     layer, bench_iterations);
+            benchmark_batch("AVX-512 batch", ntt64_forward_batch_avx512,
+                            layer, bench_iterations);
         }
         #endif
 
@@ -241,10 +1034,37 @@ int main(void) {
                                      ntt64_forward_neon,
                                      ntt64_inverse_neon,
                                      layer, bench_iterations);
+            benchmark_batch("NEON batch", ntt64_forward_batch_neon,
+                            layer, bench_iterations);
+            #if defined(__aarch64__)
+            if (ntt64_layer_fits16(layer)) {
+                benchmark_ntt16("NEON", ntt64_forward_bitrev16_neon,
+                                ntt64_inverse_bitrev16_neon, layer, bench_iterations);
+            }
+            #endif
+        }
+        #endif
+
+        #if defined(__ARM_NEON) && defined(__ARM_FEATURE_SVE2)
+        if (features & NTT_CPU_SVE2) {
+            benchmark_implementation("SVE2",
+                                     ntt64_forward_sve2,
+                                     ntt64_inverse_sve2,
+                                     layer, bench_iterations);
         }
         #endif
     }
 
+    printf("\nModulus switching and CRT:\n");
+    benchmark_switch_crt("scalar", ntt64_mod_switch_scalar, ntt64_crt_combine_scalar,
+                         bench_iterations);
+    #ifdef __AVX2__
+    if (features & NTT_CPU_AVX2) {
+        benchmark_switch_crt("AVX2", ntt64_mod_switch_avx2, ntt64_crt_combine_avx2,
+                             bench_iterations);
+    }
+    #endif
+
     printf("\n========================================\n");
     printf("BENCHMARK COMPLETE\n");
     printf("========================================\n");
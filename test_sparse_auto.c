@@ -0,0 +1,272 @@
+/**
+ * Test automatic codec selection: estimates against real encoded sizes,
+ * the size lost to picking by estimate, round trips through the format
+ * byte, and the cost of choosing against encoding every codec
+ *
+ * Build: gcc -O2 -o test_sparse_auto test_sparse_auto.c sparse_auto.c sparse_rice.c \
+ *        sparse_adaptive.c sparse_phase2.c sparse_phase3.c sparse_optimal_large.c \
+ *        sparse_dict.c -lpthread -lm
+ */
+
+#include "sparse_adaptive.h"
+#include "sparse_auto.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_DIMENSION 65535
+#define BIG_BUFFER    (1 << 18)
+
+static const char *format_names[SPARSE_AUTO_N_FORMATS] = {
+    "rice", "adaptive", "phase3", "optimal_large",
+    "phase2 rANS", "phase2 tANS", "dict rANS", "dict tANS",
+};
+
+static uint64_t rng_state = 0xBF58476D1CE4E5B9ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double gaussian(void) {
+    double u1 = (next_rand() % 1000000 + 1) / 1000001.0;
+    double u2 = (next_rand() % 1000000 + 1) / 1000001.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/* Shapes of the codecs' own targets: {-2, -1, 1, 2} secrets, small and
+ * signature-like Gaussians, wide values, dense vectors */
+typedef enum { SHAPE_PM2, SHAPE_SMALL, SHAPE_SIGNATURE, SHAPE_WIDE, SHAPE_DENSE, N_SHAPES } shape_t;
+
+static const char *shape_names[N_SHAPES] = {
+    "+-1,2 k=145", "sigma 1-3", "sigma 12 k=97", "wide values", "dense",
+};
+
+static void make_vector(int8_t *v, size_t dim, shape_t shape) {
+    memset(v, 0, dim);
+    size_t k = shape == SHAPE_PM2 ? 145 : shape == SHAPE_SIGNATURE ? 97
+             : shape == SHAPE_DENSE ? dim / 2 : 1 + next_rand() % (dim / 4 + 1);
+    const double sigma = shape == SHAPE_SMALL ? 1 + (next_rand() % 200) / 100.0 : 12;
+    if (k > dim) k = dim;
+    for (size_t placed = 0; placed < k;) {
+        const size_t pos = next_rand() % dim;
+        if (v[pos]) continue;
+        int x;
+        if (shape == SHAPE_PM2) {
+            x = next_rand() % 10 < 7 ? 2 : 1;
+            x = next_rand() % 2 ? x : -x;
+        } else if (shape == SHAPE_WIDE) {
+            x = (int)(next_rand() % 255) - 127;
+        } else {
+            x = (int)lround(gaussian() * sigma);
+            if (x < -43) x = -43;
+            if (x > 42) x = 42;
+        }
+        if (x == 0) continue;
+        v[pos] = (int8_t)x;
+        placed++;
+    }
+}
+
+/* Real size of the vector in a format, 0 if it fails or does not decode */
+static size_t encoded_size(int format, const int8_t *v, size_t dim, const sparse_dict_t *dict,
+                           uint8_t *buf, int8_t *out) {
+    size_t size = 0;
+    int ret = -1;
+    uint16_t k = 0;
+    for (size_t i = 0; i < dim; i++) k += v[i] != 0;
+    switch (format) {
+    case SPARSE_AUTO_RICE:
+        ret = sparse_rice_encode_into(v, dim, buf, BIG_BUFFER, &size);
+        if (ret == 0) {
+            const sparse_rice_t e = { buf, size, k };
+            ret = sparse_rice_decode(&e, out, dim);
+        }
+        break;
+    case SPARSE_AUTO_ADAPTIVE:
+        ret = sparse_adaptive_encode_into(v, dim, buf, BIG_BUFFER, &size);
+        if (ret == 0) {
+            const sparse_adaptive_t e = { buf, size, k };
+            ret = sparse_adaptive_decode(&e, out, dim);
+        }
+        break;
+    case SPARSE_AUTO_PHASE3:
+        ret = sparse_phase3_encode_into(v, dim, buf, BIG_BUFFER, &size);
+        if (ret == 0) {
+            const sparse_phase3_t e = { buf, size, k };
+            ret = sparse_phase3_decode(&e, out, dim);
+        }
+        break;
+    case SPARSE_AUTO_OPTIMAL_LARGE:
+        ret = sparse_optimal_large_encode_into(v, dim, buf, BIG_BUFFER, &size);
+        if (ret == 0) {
+            const sparse_optimal_large_t e = { buf, size, k };
+            ret = sparse_optimal_large_decode(&e, out, dim);
+        }
+        break;
+    default: {
+        const int with_dict = format >= SPARSE_AUTO_DICT_RANS;
+        const sparse_phase2_coder_t coder = (format - SPARSE_AUTO_PHASE2_RANS) % 2
+                                                ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS;
+        ret = with_dict ? sparse_phase2_encode_dict_into(v, dim, dict, coder, buf, BIG_BUFFER,
+                                                         &size)
+                        : sparse_phase2_encode_coder_into(v, dim, coder, buf, BIG_BUFFER,
+                                                          &size);
+        if (ret == 0) {
+            const sparse_phase2_t e = { buf, size, k };
+            ret = with_dict ? sparse_phase2_decode_dict(&e, out, dim, dict, coder)
+                            : sparse_phase2_decode_coder(&e, out, dim, coder);
+        }
+        break;
+    }
+    }
+    return ret == 0 && memcmp(out, v, dim) == 0 ? size : 0;
+}
+
+int main(void) {
+    static int8_t vec[MAX_DIMENSION], out[MAX_DIMENSION];
+    static uint8_t buf[BIG_BUFFER];
+    const sparse_dict_t *sig = sparse_dict_builtin(SPARSE_DICT_SIGNATURE);
+    int pass = sig != NULL;
+
+    printf("=== Automatic codec selection ===\n");
+
+    /* Estimates: exact for the Rice and Huffman formats, a few bytes off
+     * for the ANS ones; a format estimated usable encodes and decodes */
+    double err[SPARSE_AUTO_N_FORMATS] = { 0 }, worst_err[SPARSE_AUTO_N_FORMATS] = { 0 };
+    int n_est[SPARSE_AUTO_N_FORMATS] = { 0 }, wins[N_SHAPES][SPARSE_AUTO_N_FORMATS] = { { 0 } };
+    double regret = 0, worst_regret = 0, best_total = 0;
+    int exact_ok = 1, usable_ok = 1, n_trials = 0;
+    for (int trial = 0; trial < 2500 && sig; trial++) {
+        const shape_t shape = (shape_t)(trial % N_SHAPES);
+        const size_t dim = trial % 7 == 6 ? 64 + next_rand() % 1985 : 2048;
+        make_vector(vec, dim, shape);
+
+        size_t est[SPARSE_AUTO_N_FORMATS];
+        if (sparse_auto_estimate(vec, dim, sig, est) < 0) {
+            usable_ok = 0;
+            continue;
+        }
+        size_t best = 0;
+        for (int f = 0; f < SPARSE_AUTO_N_FORMATS; f++) {
+            if (!est[f]) continue;
+            const size_t real = encoded_size(f, vec, dim, sig, buf, out);
+            usable_ok &= real > 0;
+            if (!real) continue;
+            const double e = fabs((double)est[f] - (double)real);
+            err[f] += e;
+            if (e > worst_err[f]) worst_err[f] = e;
+            n_est[f]++;
+            if (f < SPARSE_AUTO_PHASE2_RANS) exact_ok &= est[f] == real;
+            if (!best || real < best) best = real;
+        }
+
+        const int chosen = sparse_auto_choose(vec, dim, sig);
+        if (chosen < 0 || !best) {
+            usable_ok = 0;
+            continue;
+        }
+        wins[shape][chosen]++;
+        const double lost = (double)encoded_size(chosen, vec, dim, sig, buf, out) - best;
+        regret += lost;
+        best_total += best;
+        if (lost > worst_regret) worst_regret = lost;
+        n_trials++;
+    }
+    for (int f = 0; f < SPARSE_AUTO_N_FORMATS; f++) {
+        printf("  %-14s estimate off by %.2f bytes on average, %.0f at worst (%d vectors)\n",
+               format_names[f], n_est[f] ? err[f] / n_est[f] : 0.0, worst_err[f], n_est[f]);
+    }
+    printf("  Rice and Huffman estimates exact: %s\n", exact_ok ? "PASS" : "FAIL");
+    printf("  Usable estimates encode and decode: %s\n", usable_ok ? "PASS" : "FAIL");
+    pass &= exact_ok && usable_ok;
+
+    for (int s = 0; s < N_SHAPES; s++) {
+        printf("  %-15s chose:", shape_names[s]);
+        for (int f = 0; f < SPARSE_AUTO_N_FORMATS; f++) {
+            if (wins[s][f]) printf(" %s %d", format_names[f], wins[s][f]);
+        }
+        printf("\n");
+    }
+    const int regret_ok = n_trials > 0 && regret / best_total < 0.005;
+    printf("  Lost to estimating: %.3f%% of the best sizes, %.0f bytes at worst: %s\n",
+           n_trials ? 100 * regret / best_total : 0.0, worst_regret,
+           regret_ok ? "PASS" : "FAIL");
+    pass &= regret_ok;
+
+    /* Round trips through the format byte, with and without a dictionary */
+    int trip_ok = 1;
+    for (int trial = 0; trial < 1000; trial++) {
+        const size_t dim = 1 + next_rand() % 2048;
+        make_vector(vec, dim, (shape_t)(trial % N_SHAPES));
+        if (trial % 50 == 0) memset(vec, 0, dim);
+        const sparse_dict_t *dict = trial % 2 ? sig : NULL;
+        sparse_auto_t *enc = sparse_auto_encode(vec, dim, dict);
+        memset(out, 0x55, dim);
+        trip_ok &= enc && sparse_auto_decode(enc, out, dim, NULL) == 0 &&
+                   memcmp(out, vec, dim) == 0;
+        if (enc) {
+            size_t written;
+            trip_ok &= sparse_auto_encode_into(vec, dim, dict, buf, enc->size, &written) == 0 &&
+                       written == enc->size && memcmp(buf, enc->data, written) == 0;
+            trip_ok &= sparse_auto_encode_into(vec, dim, dict, buf, enc->size - 1,
+                                               &written) == -1;
+            trip_ok &= enc->size <= sparse_auto_max_encoded_size(dim, enc->count);
+        }
+        sparse_auto_free(enc);
+    }
+    /* First position past 2048: only a dictionary format holds it */
+    memset(vec, 0, 4096);
+    vec[3000] = 5;
+    vec[4000] = -7;
+    trip_ok &= sparse_auto_choose(vec, 4096, NULL) == -1 &&
+               sparse_auto_choose(vec, 4096, sig) >= SPARSE_AUTO_DICT_RANS;
+    {
+        const sparse_auto_t bad = { buf, 1, 0 };
+        buf[0] = SPARSE_AUTO_N_FORMATS;
+        trip_ok &= sparse_auto_decode(&bad, out, 16, NULL) == -1;
+    }
+    printf("  Round trips through the format byte: %s\n", trip_ok ? "PASS" : "FAIL");
+    pass &= trip_ok;
+
+    /* Speed: choosing against encoding with every usable codec */
+    {
+        const int n_vec = 2000;
+        double t_choose = 0, t_trial = 0;
+        for (int v = 0; v < n_vec; v++) {
+            make_vector(vec, 2048, SHAPE_SIGNATURE);
+            double t0 = now_ns();
+            size_t written;
+            sparse_auto_encode_into(vec, 2048, sig, buf, BIG_BUFFER, &written);
+            t_choose += now_ns() - t0;
+
+            size_t est[SPARSE_AUTO_N_FORMATS];
+            sparse_auto_estimate(vec, 2048, sig, est);
+            t0 = now_ns();
+            for (int f = 0; f < SPARSE_AUTO_N_FORMATS; f++) {
+                if (est[f]) encoded_size(f, vec, 2048, sig, buf, out);
+            }
+            t_trial += now_ns() - t0;
+        }
+        printf("  Signature vectors: estimate and encode %.2f us, encode (and check) all "
+               "%.2f us\n", t_choose / (1e3 * n_vec), t_trial / (1e3 * n_vec));
+    }
+
+    printf("\n%s\n", pass ? "All auto-selection tests PASS" : "Some auto-selection tests FAIL");
+    return pass ? 0 : 1;
+}
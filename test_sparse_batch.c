@@ -0,0 +1,217 @@
+/**
+ * Test the batch container: round trips, the same bytes on any thread
+ * count, random access, corrupt streams, and size and speed per vector
+ *
+ * Build: gcc -O2 -o test_sparse_batch test_sparse_batch.c sparse_batch.c sparse_phase2.c \
+ *        sparse_dict.c dntl_sched.c dntl_alloc.c -lpthread -lm
+ */
+
+#include "sparse_batch.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+#define N_VECTORS 20000
+
+static uint64_t rng_state = 0x94D049BB133111EBULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Signature-like: 97 nonzeros, Gaussian with sigma 12, in [-43, 42] */
+static void signature_vector(int8_t *vector) {
+    memset(vector, 0, DIMENSION);
+    for (int placed = 0; placed < 97;) {
+        size_t pos = next_rand() % DIMENSION;
+        if (vector[pos]) continue;
+        double u1 = (next_rand() % 1000000 + 1) / 1000001.0;
+        double u2 = (next_rand() % 1000000 + 1) / 1000001.0;
+        int value = (int)round(sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2) * 12.0);
+        if (value == 0) value = 1;
+        if (value < -43) value = -43;
+        if (value > 42) value = 42;
+        vector[pos] = (int8_t)value;
+        placed++;
+    }
+}
+
+/* Any density, empty included, and any int8 values */
+static void random_vector(int8_t *vector, size_t dim) {
+    memset(vector, 0, dim);
+    const uint64_t density = next_rand() % 65;
+    for (size_t i = 0; i < dim; i++) {
+        if (next_rand() % 64 < density) vector[i] = (int8_t)(next_rand() % 255 - 127);
+    }
+}
+
+int main(void) {
+    const sparse_dict_t *sig = sparse_dict_builtin(SPARSE_DICT_SIGNATURE);
+    int8_t *vecs = malloc((size_t)N_VECTORS * DIMENSION);
+    int8_t *out = malloc((size_t)N_VECTORS * DIMENSION);
+    int pass = vecs && out && sig;
+
+    printf("=== Batch container ===\n");
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+
+    /* Round trips: both coders, with and without a dictionary, any size,
+     * and the same bytes on one thread as on several */
+    int trip_ok = 1;
+    for (int trial = 0; trial < 40; trial++) {
+        const sparse_phase2_coder_t coder = trial % 2 ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS;
+        const sparse_dict_t *dict = trial % 4 < 2 ? sig : NULL;
+        const size_t dim = trial % 5 == 4 ? 1 + next_rand() % 65535 : DIMENSION;
+        size_t n = trial % 8 == 0 ? next_rand() % 3 : 1 + next_rand() % 700;
+        if (n * dim > (size_t)N_VECTORS * DIMENSION) n = (size_t)N_VECTORS * DIMENSION / dim;
+        for (size_t v = 0; v < n; v++) {
+            if (dim == DIMENSION && trial % 3) {
+                signature_vector(vecs + v * dim);
+            } else {
+                random_vector(vecs + v * dim, dim);
+            }
+        }
+
+        sparse_batch_t *one = sparse_batch_encode(vecs, n, dim, dict, coder, 1);
+        sparse_batch_t *many = sparse_batch_encode(vecs, n, dim, dict, coder, 5);
+        sparse_batch_reader_t reader;
+        if (!one || !many) {
+            trip_ok = 0;
+        } else {
+            trip_ok &= one->n_vectors == n && one->size == many->size &&
+                       memcmp(one->data, many->data, one->size) == 0;
+            memset(out, 0x55, n * dim);
+            trip_ok &= sparse_batch_open(&reader, one->data, one->size) == 0 &&
+                       reader.n_vectors == n && reader.dimension == dim &&
+                       reader.coder == coder && reader.has_dict == (dict != NULL);
+            trip_ok &= sparse_batch_decode_all(&reader, NULL, 1 + trial % 4, out) == 0 &&
+                       memcmp(out, vecs, n * dim) == 0;
+        }
+        sparse_batch_free(one);
+        sparse_batch_free(many);
+    }
+    printf("  Round trips, same bytes on 1 and 5 threads: %s\n", trip_ok ? "PASS" : "FAIL");
+    pass &= trip_ok;
+
+    /* Random access: any vector alone, the stream of each as sparse_phase2's */
+    int access_ok = 1;
+    for (size_t v = 0; v < 1000; v++) {
+        signature_vector(vecs + v * DIMENSION);
+    }
+    sparse_batch_t *batch = sparse_batch_encode(vecs, 1000, DIMENSION, sig,
+                                                SPARSE_PHASE2_RANS, 4);
+    sparse_batch_reader_t reader;
+    access_ok &= batch && sparse_batch_open(&reader, batch->data, batch->size) == 0;
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_create(DIMENSION);
+    for (int trial = 0; trial < 300 && access_ok && ctx; trial++) {
+        const size_t i = next_rand() % 1000;
+        int8_t vector[DIMENSION];
+        access_ok &= sparse_batch_decode_one(&reader, i, NULL, trial % 2 ? ctx : NULL,
+                                             vector) == 0 &&
+                     memcmp(vector, vecs + i * DIMENSION, DIMENSION) == 0;
+        if (trial < 20) {
+            uint8_t single[4096];
+            size_t written;
+            access_ok &= sparse_phase2_encode_dict_into(vecs + i * DIMENSION, DIMENSION, sig,
+                                                        SPARSE_PHASE2_RANS, single,
+                                                        sizeof(single), &written) == 0;
+            const uint8_t *entry = reader.index + i * SPARSE_BATCH_INDEX_BYTES;
+            const size_t start = entry[0] | entry[1] << 8 | entry[2] << 16 |
+                                 (size_t)entry[3] << 24;
+            access_ok &= start + written <= reader.payload_size &&
+                         memcmp(reader.payload + start, single, written) == 0;
+        }
+    }
+    access_ok &= ctx != NULL;
+    printf("  Random access to single vectors: %s\n", access_ok ? "PASS" : "FAIL");
+    pass &= access_ok;
+
+    /* Bad arguments, truncated and corrupted streams */
+    int reject_ok = batch != NULL;
+    if (batch) {
+        int8_t vector[DIMENSION];
+        sparse_batch_reader_t r;
+        reject_ok &= sparse_batch_decode_one(&reader, 1000, NULL, NULL, vector) == -1;
+        sparse_dict_t other = *sig;
+        other.id = 7;
+        reject_ok &= sparse_batch_decode_one(&reader, 0, &other, NULL, vector) == -1;
+        reject_ok &= sparse_batch_open(&r, batch->data, SPARSE_BATCH_HEADER_BYTES - 1) == -1;
+        reject_ok &= sparse_batch_open(&r, batch->data, SPARSE_BATCH_HEADER_BYTES +
+                                       1000 * SPARSE_BATCH_INDEX_BYTES - 1) == -1;
+
+        /* Exact-size copies, so reads past the end show up under ASAN */
+        for (int trial = 0; trial < 200; trial++) {
+            const size_t size = trial % 2 ? batch->size : next_rand() % batch->size;
+            uint8_t *copy = malloc(size + 1);
+            memcpy(copy, batch->data, size);
+            if (trial % 2) copy[next_rand() % size] ^= (uint8_t)(1 + next_rand() % 255);
+            if (sparse_batch_open(&r, copy, size) == 0) {
+                for (int k = 0; k < 5; k++) {
+                    int ret = sparse_batch_decode_one(&r, next_rand() % (r.n_vectors + 1),
+                                                      NULL, ctx, vector);
+                    reject_ok &= ret == 0 || ret == -1;
+                }
+                /* Cut short: the last vector no longer decodes */
+                if (size < batch->size && size > (size_t)(reader.payload - batch->data)) {
+                    reject_ok &= sparse_batch_decode_one(&r, 999, NULL, ctx, vector) == -1;
+                }
+            }
+            free(copy);
+        }
+    }
+    reject_ok &= sparse_batch_encode(vecs, 10, 0, NULL, SPARSE_PHASE2_RANS, 1) == NULL;
+    reject_ok &= sparse_batch_encode(vecs, 10, 65536, NULL, SPARSE_PHASE2_RANS, 1) == NULL;
+    reject_ok &= sparse_batch_encode(NULL, 10, DIMENSION, NULL, SPARSE_PHASE2_RANS, 1) == NULL;
+    printf("  Bad arguments and streams rejected: %s\n", reject_ok ? "PASS" : "FAIL");
+    pass &= reject_ok;
+    sparse_batch_free(batch);
+    sparse_codec_ctx_free(ctx);
+
+    /* Size and speed: signature vectors, one thread against four */
+    {
+        for (size_t v = 0; v < N_VECTORS; v++) {
+            signature_vector(vecs + v * DIMENSION);
+        }
+        const int thread_counts[2] = { 1, 4 };
+        int speed_ok = 1;
+        for (int t = 0; t < 2; t++) {
+            double t0 = now_ns();
+            sparse_batch_t *b = sparse_batch_encode(vecs, N_VECTORS, DIMENSION, sig,
+                                                    SPARSE_PHASE2_RANS, thread_counts[t]);
+            const double t_enc = now_ns() - t0;
+            sparse_batch_reader_t r;
+            speed_ok &= b && sparse_batch_open(&r, b->data, b->size) == 0;
+            if (!speed_ok) break;
+            t0 = now_ns();
+            speed_ok &= sparse_batch_decode_all(&r, NULL, thread_counts[t], out) == 0 &&
+                        memcmp(out, vecs, (size_t)N_VECTORS * DIMENSION) == 0;
+            const double t_dec = now_ns() - t0;
+            printf("  %d thread%s: %.1f bytes per vector (%d index), encode %.2f us, "
+                   "decode %.2f us\n", thread_counts[t], t ? "s" : "",
+                   (double)b->size / N_VECTORS, SPARSE_BATCH_INDEX_BYTES,
+                   t_enc / (1e3 * N_VECTORS), t_dec / (1e3 * N_VECTORS));
+            sparse_batch_free(b);
+        }
+        printf("  Large batch round trip: %s\n", speed_ok ? "PASS" : "FAIL");
+        pass &= speed_ok;
+    }
+
+    free(vecs);
+    free(out);
+    printf("\n%s\n", pass ? "All batch tests PASS" : "Some batch tests FAIL");
+    return pass ? 0 : 1;
+}
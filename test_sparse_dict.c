@@ -0,0 +1,229 @@
+/**
+ * Test shared dictionaries with sparse_phase2: round trips with escapes,
+ * header IDs, corrupt streams, and size and speed against per-vector tables
+ *
+ * Build: gcc -O2 -o test_sparse_dict test_sparse_dict.c sparse_dict.c sparse_phase2.c -lpthread -lm
+ */
+
+#include "sparse_dict.h"
+#include "sparse_phase2.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+#define N_TRAIN   10000
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* As test_phase2 and train_sparse_dict: 97 nz, sigma 12, in [-43, 42] */
+static void generate_s_mangled_97nz(int8_t *vector, unsigned int seed) {
+    srand(seed);
+    memset(vector, 0, DIMENSION);
+
+    uint16_t positions[97];
+    for (uint16_t i = 0; i < 97; i++) {
+        uint16_t pos;
+        int retry;
+        do {
+            pos = rand() % DIMENSION;
+            retry = 0;
+            for (uint16_t j = 0; j < i; j++) {
+                if (positions[j] == pos) {
+                    retry = 1;
+                    break;
+                }
+            }
+        } while (retry);
+        positions[i] = pos;
+    }
+
+    for (uint16_t i = 0; i < 97; i++) {
+        float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+        float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+        float z = sqrtf(-2.0f * logf(u1)) * cosf(2.0f * M_PI * u2);
+        int value = (int)round(z * 12.0);
+        if (value < -43) value = -43;
+        if (value > 42) value = 42;
+        vector[positions[i]] = (int8_t)value;
+    }
+}
+
+/* Any density and any int8 values */
+static void random_vector(int8_t *vector, size_t dim) {
+    memset(vector, 0, dim);
+    const uint64_t density = 1 + next_rand() % 64;
+    const int spread = (int)(next_rand() % 4);
+    for (size_t i = 0; i < dim; i++) {
+        if (next_rand() % 64 < density) {
+            int v = spread == 3 ? (int)(next_rand() % 256) - 128
+                                : (int)(next_rand() % 31) - 15;
+            vector[i] = (int8_t)v;
+        }
+    }
+}
+
+int main(void) {
+    static int8_t vec[65535], out[65535];
+    static sparse_dict_t trained;
+    int pass = 1;
+
+    printf("=== Shared dictionaries (sparse_phase2) ===\n");
+
+    const sparse_dict_t *sig = sparse_dict_builtin(SPARSE_DICT_SIGNATURE);
+    int builtin_ok = sig != NULL && sparse_dict_builtin(0) == NULL &&
+                     sparse_dict_builtin(SPARSE_DICT_MAX_ID + 1) == NULL;
+
+    /* The built-in table is what train_sparse_dict prints */
+    int8_t *samples = malloc((size_t)N_TRAIN * DIMENSION);
+    for (unsigned v = 0; v < N_TRAIN; v++) {
+        generate_s_mangled_97nz(samples + (size_t)v * DIMENSION, v);
+    }
+    builtin_ok &= sparse_dict_train(&trained, 7, samples, N_TRAIN, DIMENSION) == 0;
+    free(samples);
+    builtin_ok &= sig && trained.n_values == sig->n_values &&
+                  memcmp(trained.values, sig->values, sizeof(sig->values)) == 0 &&
+                  memcmp(trained.freqs, sig->freqs, sizeof(sig->freqs)) == 0;
+    printf("  Built-in dictionary matches training: %s\n", builtin_ok ? "PASS" : "FAIL");
+    pass &= builtin_ok;
+
+    /* Round trips: both coders, built-in and trained, escapes, any size */
+    int trip_ok = 1;
+    for (int trial = 0; trial < 600; trial++) {
+        const sparse_dict_t *dict = trial % 2 ? sig : &trained;
+        const sparse_phase2_coder_t coder = trial % 4 < 2 ? SPARSE_PHASE2_RANS
+                                                          : SPARSE_PHASE2_TANS;
+        size_t dim = trial % 3 == 0 ? 1 + next_rand() % 65535 : DIMENSION;
+        if (trial % 5 == 0) {
+            generate_s_mangled_97nz(vec, (unsigned)(N_TRAIN + trial));
+            dim = DIMENSION;
+        } else {
+            random_vector(vec, dim);
+        }
+
+        sparse_phase2_t *enc = sparse_phase2_encode_dict(vec, dim, dict, coder);
+        memset(out, 0x55, dim);
+        trip_ok &= enc && sparse_phase2_decode_dict(enc, out, dim, dict, coder) == 0 &&
+                   memcmp(vec, out, dim) == 0;
+        /* Built-in dictionaries also decode by header ID alone */
+        if (enc && dict == sig) {
+            trip_ok &= sparse_phase2_decode_dict(enc, out, dim, NULL, coder) == 0 &&
+                       memcmp(vec, out, dim) == 0;
+        }
+        sparse_phase2_free(enc);
+    }
+    memset(vec, 0, DIMENSION);
+    sparse_phase2_t *empty = sparse_phase2_encode_dict(vec, DIMENSION, sig, SPARSE_PHASE2_RANS);
+    trip_ok &= empty && sparse_phase2_decode_dict(empty, out, DIMENSION, NULL,
+                                                  SPARSE_PHASE2_RANS) == 0;
+    sparse_phase2_free(empty);
+    printf("  Round trips, rANS and tANS, with escapes: %s\n", trip_ok ? "PASS" : "FAIL");
+    pass &= trip_ok;
+
+    /* Wrong dictionary, truncated and corrupted streams */
+    int reject_ok = 1;
+    for (int trial = 0; trial < 200; trial++) {
+        const sparse_phase2_coder_t coder = trial % 2 ? SPARSE_PHASE2_RANS
+                                                      : SPARSE_PHASE2_TANS;
+        generate_s_mangled_97nz(vec, (unsigned)(2 * N_TRAIN + trial));
+        sparse_phase2_t *enc = sparse_phase2_encode_dict(vec, DIMENSION, sig, coder);
+        if (!enc) {
+            reject_ok = 0;
+            continue;
+        }
+        /* Trained ID 7 is no built-in, and not the header's */
+        reject_ok &= sparse_phase2_decode_dict(enc, out, DIMENSION, &trained, coder) == -1;
+
+        /* Exact-size copies, so reads past the end show up under ASAN */
+        sparse_phase2_t cut = { malloc(enc->size), enc->size - 1, enc->count };
+        memcpy(cut.data, enc->data, cut.size);
+        reject_ok &= sparse_phase2_decode_dict(&cut, out, DIMENSION, NULL, coder) == -1;
+        cut.size = enc->size / 2;
+        reject_ok &= sparse_phase2_decode_dict(&cut, out, DIMENSION, NULL, coder) == -1;
+        free(cut.data);
+
+        enc->data[next_rand() % enc->size] ^= (uint8_t)(1 + next_rand() % 255);
+        int r = sparse_phase2_decode_dict(enc, out, DIMENSION, NULL, coder);
+        reject_ok &= r == 0 || r == -1;
+        sparse_phase2_free(enc);
+    }
+    reject_ok &= sparse_phase2_encode_dict(vec, DIMENSION, NULL, SPARSE_PHASE2_RANS) == NULL;
+    {
+        const int8_t values[2] = { 1, 1 };
+        const uint32_t freqs[2] = { 128, 127 };
+        sparse_dict_t bad;
+        reject_ok &= sparse_dict_build(&bad, 1, values, freqs, 2, 1) == -1;   /* duplicate */
+        reject_ok &= sparse_dict_build(&bad, 1, values, freqs, 1, 1) == -1;   /* sum 129 */
+        reject_ok &= sparse_dict_build(&bad, 16, values, freqs, 1, 128) == -1;
+        reject_ok &= sparse_dict_build(&bad, 1, values, freqs, 1, 128) == 0;
+        memset(vec, 0, DIMENSION);
+        reject_ok &= sparse_dict_train(&bad, 1, vec, 1, DIMENSION) == -1;
+    }
+    printf("  Bad dictionaries and streams rejected: %s\n", reject_ok ? "PASS" : "FAIL");
+    pass &= reject_ok;
+
+    /* Size and speed on held-out signature vectors */
+    {
+        const int n_vec = 200;
+        double bytes[2][2] = { { 0 } };
+        double t_enc[2] = { 0 }, t_dec[2] = { 0 };
+        int size_ok = 1;
+        for (int v = 0; v < n_vec; v++) {
+            generate_s_mangled_97nz(vec, (unsigned)(3 * N_TRAIN + v));
+            for (int c = 0; c < 2; c++) {
+                const sparse_phase2_coder_t coder = c ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS;
+                double t0 = now_ns();
+                sparse_phase2_t *own = sparse_phase2_encode_coder(vec, DIMENSION, coder);
+                t_enc[0] += now_ns() - t0;
+                t0 = now_ns();
+                sparse_phase2_t *shared = sparse_phase2_encode_dict(vec, DIMENSION, sig, coder);
+                t_enc[1] += now_ns() - t0;
+                if (!own || !shared) {
+                    size_ok = 0;
+                    sparse_phase2_free(own);
+                    sparse_phase2_free(shared);
+                    continue;
+                }
+                bytes[c][0] += own->size;
+                bytes[c][1] += shared->size;
+
+                t0 = now_ns();
+                size_ok &= sparse_phase2_decode_coder(own, out, DIMENSION, coder) == 0;
+                t_dec[0] += now_ns() - t0;
+                t0 = now_ns();
+                size_ok &= sparse_phase2_decode_dict(shared, out, DIMENSION, sig, coder) == 0;
+                t_dec[1] += now_ns() - t0;
+                sparse_phase2_free(own);
+                sparse_phase2_free(shared);
+            }
+        }
+        for (int c = 0; c < 2; c++) {
+            printf("  %s: %.1f bytes with own table, %.1f with the dictionary\n",
+                   c ? "tANS" : "rANS", bytes[c][0] / n_vec, bytes[c][1] / n_vec);
+            size_ok &= bytes[c][1] < bytes[c][0];
+        }
+        printf("  Per vector: encode %.2f -> %.2f us, decode %.2f -> %.2f us\n",
+               t_enc[0] / (2e3 * n_vec), t_enc[1] / (2e3 * n_vec),
+               t_dec[0] / (2e3 * n_vec), t_dec[1] / (2e3 * n_vec));
+        printf("  Dictionary smaller: %s\n", size_ok ? "PASS" : "FAIL");
+        pass &= size_ok;
+    }
+
+    printf("\n%s\n", pass ? "All dictionary tests PASS" : "Some dictionary tests FAIL");
+    return pass ? 0 : 1;
+}
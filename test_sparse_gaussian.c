@@ -0,0 +1,211 @@
+/**
+ * Test sampling sparse Gaussian vectors straight into the phase2 encoders:
+ * streams against the dense path, the distribution, the bounds, and the
+ * time the dense intermediate cost
+ *
+ * Build: gcc -O2 -o test_sparse_gaussian test_sparse_gaussian.c sparse_gaussian.c \
+ *        sparse_phase2.c sparse_dict.c sparse_vector.c -lm
+ */
+
+#include "sparse_gaussian.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Signature-like: 97 nonzeros, sigma 12, in [-43, 42] */
+static const sparse_gaussian_params_t signature = {
+    DIMENSION, 97, 12.0, -43, 42, 97 * 12 * 12 * 5 / 4, 0
+};
+
+static void seed_rng(sparse_gaussian_rng_t *rng, uint8_t tag) {
+    uint8_t seed[32];
+    for (int i = 0; i < 32; i++) seed[i] = (uint8_t)(tag * 31 + i * 7);
+    sparse_gaussian_seed(rng, seed);
+}
+
+/* Fused stream equals the dense encoder's on the vector drawn from the same state */
+static int same_as_dense(sparse_codec_ctx_t *ctx, const sparse_gaussian_params_t *p,
+                         sparse_gaussian_rng_t *rng, const sparse_dict_t *dict,
+                         sparse_phase2_coder_t coder) {
+    static uint8_t fused[16384], dense_out[16384];
+    static int8_t dense[65535];
+    sparse_gaussian_rng_t copy = *rng;
+    size_t n_fused, n_dense;
+    if (sparse_gaussian_encode_ctx(ctx, p, rng, dict, coder, fused, sizeof(fused),
+                                   &n_fused) < 0) {
+        return 0;
+    }
+
+    sparse_vector_t *sv = sparse_vector_new((uint16_t)p->dimension, p->k);
+    int ok = sv && sparse_gaussian_sample(p, &copy, sv) == 0 &&
+             memcmp(&copy, rng, sizeof(copy)) == 0;
+    if (ok) {
+        sparse_to_dense(sv, dense);
+        ok = (dict ? sparse_phase2_encode_dict_ctx(ctx, dense, p->dimension, dict, coder,
+                                                   dense_out, sizeof(dense_out), &n_dense)
+                   : sparse_phase2_encode_coder_ctx(ctx, dense, p->dimension, coder,
+                                                    dense_out, sizeof(dense_out),
+                                                    &n_dense)) == 0 &&
+             n_dense == n_fused && memcmp(fused, dense_out, n_fused) == 0;
+    }
+    sparse_vector_free(sv);
+    return ok;
+}
+
+int main(void) {
+    const sparse_dict_t *sig = sparse_dict_builtin(SPARSE_DICT_SIGNATURE);
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_create(65535);
+    sparse_gaussian_rng_t rng;
+    int pass = sig && ctx;
+
+    printf("=== Sparse Gaussian sampling into the encoders ===\n");
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+
+    /* Streams: the fused path writes what the dense path writes */
+    {
+        const sparse_gaussian_params_t shapes[] = {
+            signature,
+            { DIMENSION, 0, 12.0, -43, 42, 0, 0 },
+            { DIMENSION, 1, 3.0, -8, 7, 0, 0 },
+            { DIMENSION, 1500, 2.0, -5, 5, 0, 0 },      /* past half: complement */
+            { 1, 1, 12.0, -43, 42, 0, 0 },
+            { 777, 200, 30.0, -128, 127, 0, 0 },
+            { 64, 64, 1.0, 1, 3, 0, 0 },               /* positive values only */
+        };
+        int ok = 1;
+        seed_rng(&rng, 1);
+        for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+            for (int trial = 0; trial < 50; trial++) {
+                ok &= same_as_dense(ctx, &shapes[s], &rng, NULL, SPARSE_PHASE2_RANS);
+                ok &= same_as_dense(ctx, &shapes[s], &rng, NULL, SPARSE_PHASE2_TANS);
+                ok &= same_as_dense(ctx, &shapes[s], &rng, sig, SPARSE_PHASE2_RANS);
+                ok &= same_as_dense(ctx, &shapes[s], &rng, sig, SPARSE_PHASE2_TANS);
+            }
+        }
+        printf("  Fused streams match the dense encoders: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* The vectors: distinct ascending positions, values and norms in bounds */
+    {
+        const int n = 4000;
+        static uint32_t hits[DIMENSION];
+        uint16_t positions[DIMENSION];
+        int8_t values[DIMENSION];
+        uint32_t hist[256];
+        double sum = 0, sum_sq = 0;
+        int ok = 1;
+        memset(hits, 0, sizeof(hits));
+        seed_rng(&rng, 2);
+        for (int v = 0; v < n; v++) {
+            ok &= sparse_gaussian_sample_list(&signature, &rng, positions, values, hist) == 0;
+            uint64_t norm_sq = 0;
+            uint32_t counted[256] = {0};
+            for (int i = 0; i < signature.k; i++) {
+                ok &= (i == 0 || positions[i] > positions[i - 1]) && positions[i] < DIMENSION;
+                ok &= values[i] != 0 && values[i] >= -43 && values[i] <= 42;
+                counted[SPARSE_SCAN_BIN(values[i])]++;
+                norm_sq += (uint64_t)(values[i] * values[i]);
+                hits[positions[i]]++;
+                sum += values[i];
+                sum_sq += (double)values[i] * values[i];
+            }
+            ok &= norm_sq <= signature.max_norm_sq && memcmp(hist, counted, sizeof(hist)) == 0;
+        }
+        const double total = (double)n * signature.k;
+        const double mean = sum / total, sd = sqrt(sum_sq / total - mean * mean);
+        uint32_t lo = UINT32_MAX, hi = 0;
+        for (int i = 0; i < DIMENSION; i++) {
+            if (hits[i] < lo) lo = hits[i];
+            if (hits[i] > hi) hi = hits[i];
+        }
+        /* Expected hits per position: n * k / dimension, about 189 */
+        const double expect = total / DIMENSION;
+        ok &= fabs(mean) < 0.2 && sd > 10.0 && sd < 12.5 &&
+              lo > expect * 0.65 && hi < expect * 1.35;
+        printf("  Positions and values in bounds (mean %.3f, sd %.2f, hits %u..%u): %s\n",
+               mean, sd, lo, hi, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Parameters the sampler cannot meet */
+    {
+        sparse_gaussian_params_t bad[] = {
+            { 0, 0, 12.0, -43, 42, 0, 0 },
+            { 100, 101, 12.0, -43, 42, 0, 0 },
+            { DIMENSION, 97, 0.0, -43, 42, 0, 0 },
+            { DIMENSION, 97, 12.0, 5, -5, 0, 0 },
+            { DIMENSION, 97, 12.0, 0, 0, 0, 0 },
+            { DIMENSION, 97, 12.0, -43, 42, 96, 20 },   /* norm bound out of reach */
+            { DIMENSION, 3, 0.5, 100, 127, 0, 0 },      /* range out of reach */
+        };
+        uint8_t out[4096];
+        size_t written;
+        int ok = 1;
+        seed_rng(&rng, 3);
+        for (size_t b = 0; b < sizeof(bad) / sizeof(bad[0]); b++) {
+            ok &= sparse_gaussian_encode_ctx(ctx, &bad[b], &rng, sig, SPARSE_PHASE2_TANS,
+                                             out, sizeof(out), &written) == -1;
+        }
+        sparse_codec_ctx_t *small = sparse_codec_ctx_create(1000);
+        ok &= small && sparse_gaussian_encode_ctx(small, &signature, &rng, NULL,
+                                                  SPARSE_PHASE2_RANS, out, sizeof(out),
+                                                  &written) == -1;
+        ok &= sparse_gaussian_encode_ctx(ctx, &signature, &rng, sig, SPARSE_PHASE2_TANS,
+                                         out, 20, &written) == -1;
+        sparse_codec_ctx_free(small);
+        printf("  Unmeetable parameters refused: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Time: through a dense vector, against straight into the encoder */
+    {
+        const int n = 20000;
+        static uint8_t out[4096];
+        static int8_t dense[DIMENSION];
+        sparse_vector_t *sv = sparse_vector_new(DIMENSION, signature.k);
+        size_t written, bytes_dense = 0, bytes_fused = 0;
+        int ok = sv != NULL;
+
+        seed_rng(&rng, 4);
+        double t0 = now_ns();
+        for (int v = 0; ok && v < n; v++) {
+            ok &= sparse_gaussian_sample(&signature, &rng, sv) == 0;
+            sparse_to_dense(sv, dense);
+            ok &= sparse_phase2_encode_dict_ctx(ctx, dense, DIMENSION, sig, SPARSE_PHASE2_TANS,
+                                                out, sizeof(out), &written) == 0;
+            bytes_dense += written;
+        }
+        double t1 = now_ns();
+        seed_rng(&rng, 4);
+        for (int v = 0; ok && v < n; v++) {
+            ok &= sparse_gaussian_encode_ctx(ctx, &signature, &rng, sig, SPARSE_PHASE2_TANS,
+                                             out, sizeof(out), &written) == 0;
+            bytes_fused += written;
+        }
+        double t2 = now_ns();
+        ok &= bytes_dense == bytes_fused;
+        printf("  Signature vectors: dense %.2f us, fused %.2f us each (%.1f bytes): %s\n",
+               (t1 - t0) / (1e3 * n), (t2 - t1) / (1e3 * n), (double)bytes_fused / n,
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+        sparse_vector_free(sv);
+    }
+
+    sparse_codec_ctx_free(ctx);
+    printf("\n%s\n", pass ? "All sparse Gaussian tests PASS" : "Some sparse Gaussian tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/**
+ * Test the streaming Rice decoder: every chunking of a stream gives what
+ * sparse_rice_decode_sparse() gives, positions and values as they arrive,
+ * two streams back to back split where the first ends, truncated and
+ * malformed streams, and the time against the whole-buffer decoder
+ *
+ * Build: gcc -O2 -o test_sparse_rice_stream test_sparse_rice_stream.c sparse_rice.c \
+ *        sparse_vector.c -lm
+ */
+
+#include "sparse_rice.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* k nonzeros in {-2, -1, 1, 2}, with a long gap now and then */
+static void random_vector(int8_t *v, size_t dim, size_t k) {
+    static const int8_t alphabet[4] = { -2, 2, -1, 1 };
+    memset(v, 0, dim);
+    for (size_t placed = 0; placed < k; ) {
+        size_t pos = next_rand() % dim;
+        if (v[pos] == 0) {
+            v[pos] = alphabet[next_rand() % 4];
+            placed++;
+        }
+    }
+}
+
+/* Push data in pieces of chunk bytes; 1 if the result matches expect and
+ * the pairs and positions only ever grew */
+static int decode_in_chunks(const uint8_t *data, size_t size, size_t chunk,
+                            const sparse_vector_t *expect, sparse_vector_t *out) {
+    sparse_rice_stream_t st;
+    if (sparse_rice_stream_init(&st, out) != 0) return 0;
+
+    uint16_t last_count = 0, last_known = 0;
+    size_t off = 0, used = 0;
+    int ret = 0;
+    while (ret == 0 && off < size) {
+        const size_t len = size - off < chunk ? size - off : chunk;
+        ret = sparse_rice_stream_push(&st, data + off, len, &used);
+        if (ret == 0 && used != len) return 0;
+        if (out->count < last_count || st.known < last_known || out->count > st.known) return 0;
+        last_count = out->count;
+        last_known = st.known;
+        off += used;
+    }
+    return ret == 1 && off == size && out->count == expect->count &&
+           memcmp(out->indices, expect->indices, expect->count * sizeof(uint16_t)) == 0 &&
+           memcmp(out->values, expect->values, expect->count) == 0;
+}
+
+int main(void) {
+    static int8_t vec[DIMENSION];
+    static const size_t chunks[] = { 1, 2, 3, 5, 7, 8, 13, 64, 100000 };
+    sparse_vector_t *expect = sparse_vector_new(DIMENSION, DIMENSION);
+    sparse_vector_t *out = sparse_vector_new(DIMENSION, DIMENSION);
+    int pass = 1;
+
+    printf("=== Streaming Rice decoder ===\n");
+
+    /* Every chunk size, against the whole-buffer decoder */
+    int chunk_ok = 1, early_ok = 1;
+    static const size_t ks[] = { 0, 1, 2, 17, 145, 400, 2048 };
+    for (size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); t++) {
+        random_vector(vec, DIMENSION, ks[t]);
+        sparse_rice_t *enc = sparse_rice_encode(vec, DIMENSION);
+        chunk_ok &= enc && sparse_rice_decode_sparse(enc, expect) == 0;
+        for (size_t c = 0; enc && c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+            chunk_ok &= decode_in_chunks(enc->data, enc->size, chunks[c], expect, out);
+        }
+
+        /* Half the stream: every position of the first half is out */
+        if (enc && ks[t] > 1) {
+            sparse_rice_stream_t st;
+            size_t used;
+            sparse_rice_stream_init(&st, out);
+            early_ok &= sparse_rice_stream_push(&st, enc->data, enc->size / 2, &used) == 0 &&
+                        used == enc->size / 2 && st.known > 0 &&
+                        memcmp(out->indices, expect->indices, st.known * sizeof(uint16_t)) == 0;
+        }
+        sparse_rice_free(enc);
+    }
+    printf("  Every chunking matches the buffer decoder: %s\n", chunk_ok ? "PASS" : "FAIL");
+    printf("  Positions decoded before the stream ends: %s\n", early_ok ? "PASS" : "FAIL");
+    pass &= chunk_ok && early_ok;
+
+    /* Two streams back to back: the first ends where it says */
+    int split_ok = 1;
+    {
+        static int8_t vec2[DIMENSION];
+        random_vector(vec, DIMENSION, 90);
+        random_vector(vec2, DIMENSION, 30);
+        sparse_rice_t *a = sparse_rice_encode(vec, DIMENSION);
+        sparse_rice_t *b = sparse_rice_encode(vec2, DIMENSION);
+        uint8_t *both = malloc(a->size + b->size);
+        memcpy(both, a->data, a->size);
+        memcpy(both + a->size, b->data, b->size);
+
+        sparse_vector_t *expect2 = sparse_vector_new(DIMENSION, DIMENSION);
+        sparse_rice_decode_sparse(a, expect);
+        sparse_rice_decode_sparse(b, expect2);
+
+        for (size_t chunk = 1; chunk <= 16; chunk++) {
+            sparse_rice_stream_t st;
+            size_t off = 0, used;
+            int ret = 0, stream = 0;
+            sparse_rice_stream_init(&st, out);
+            while (off < a->size + b->size && ret >= 0) {
+                const size_t len = a->size + b->size - off < chunk ? a->size + b->size - off : chunk;
+                ret = sparse_rice_stream_push(&st, both + off, len, &used);
+                off += used;
+                if (ret == 1 && stream++ == 0) {
+                    split_ok &= off == a->size && out->count == expect->count &&
+                                memcmp(out->indices, expect->indices,
+                                       expect->count * sizeof(uint16_t)) == 0;
+                    /* Finished streams stay finished */
+                    split_ok &= sparse_rice_stream_push(&st, both + off, 1, &used) == 1 && used == 0;
+                    sparse_rice_stream_init(&st, out);
+                    ret = 0;
+                }
+            }
+            split_ok &= stream == 2 && off == a->size + b->size && out->count == expect2->count &&
+                        memcmp(out->values, expect2->values, expect2->count) == 0;
+        }
+        sparse_vector_free(expect2);
+        free(both);
+        sparse_rice_free(a);
+        sparse_rice_free(b);
+    }
+    printf("  Back-to-back streams split at the boundary: %s\n", split_ok ? "PASS" : "FAIL");
+    pass &= split_ok;
+
+    /* Truncated, out of range and too large for out */
+    int bad_ok = 1;
+    {
+        random_vector(vec, DIMENSION, 60);
+        sparse_rice_t *enc = sparse_rice_encode(vec, DIMENSION);
+        sparse_rice_stream_t st;
+        size_t used;
+
+        sparse_rice_stream_init(&st, out);
+        bad_ok &= sparse_rice_stream_push(&st, enc->data, enc->size - 1, &used) == 0;
+        bad_ok &= sparse_rice_stream_push(&st, NULL, 0, &used) == 0;
+
+        /* A 64-dimensional vector cannot hold these positions */
+        sparse_vector_t *small = sparse_vector_new(64, DIMENSION);
+        sparse_rice_stream_init(&st, small);
+        bad_ok &= sparse_rice_stream_push(&st, enc->data, enc->size, &used) == -1;
+        bad_ok &= sparse_rice_stream_push(&st, enc->data, enc->size, &used) == -1;
+        sparse_vector_free(small);
+
+        sparse_vector_t *narrow = sparse_vector_new(DIMENSION, 10);
+        sparse_rice_stream_init(&st, narrow);
+        bad_ok &= sparse_rice_stream_push(&st, enc->data, enc->size, &used) == -1;
+        sparse_vector_free(narrow);
+
+        /* A run of ones past the quotient bound */
+        uint8_t ones[200];
+        memset(ones, 0xFF, sizeof(ones));
+        ones[0] = 0x00;                 /* count 2, r 7, first position 2 */
+        ones[1] = 0x02;
+        ones[2] = 0xE0;
+        ones[3] = 0x0B;                 /* then ones: the first gap never ends */
+        sparse_rice_stream_init(&st, out);
+        int ret = 0;
+        for (size_t off = 0; off < sizeof(ones) && ret == 0; off += 7) {
+            ret = sparse_rice_stream_push(&st, ones + off, sizeof(ones) - off < 7 ? sizeof(ones) - off : 7,
+                                          &used);
+        }
+        bad_ok &= ret == -1 && st.known == 1 && out->indices[0] == 2;
+
+        bad_ok &= sparse_rice_stream_init(&st, NULL) == -1;
+        sparse_rice_free(enc);
+    }
+    printf("  Truncated and malformed streams: %s\n", bad_ok ? "PASS" : "FAIL");
+    pass &= bad_ok;
+
+    /* Time per vector of 145 nonzeros, whole buffer and 64-byte segments */
+    {
+        enum { ITERS = 20000 };
+        random_vector(vec, DIMENSION, 145);
+        sparse_rice_t *enc = sparse_rice_encode(vec, DIMENSION);
+        double t0 = now_ns();
+        for (int i = 0; i < ITERS; i++) {
+            sparse_rice_decode_sparse(enc, out);
+        }
+        double t1 = now_ns();
+        for (int i = 0; i < ITERS; i++) {
+            sparse_rice_stream_t st;
+            size_t used;
+            sparse_rice_stream_init(&st, out);
+            for (size_t off = 0; off < enc->size; off += 64) {
+                sparse_rice_stream_push(&st, enc->data + off,
+                                        enc->size - off < 64 ? enc->size - off : 64, &used);
+            }
+        }
+        double t2 = now_ns();
+        printf("  Decode, %zu bytes: buffer %.0f ns, 64-byte segments %.0f ns\n",
+               enc->size, (t1 - t0) / ITERS, (t2 - t1) / ITERS);
+        sparse_rice_free(enc);
+    }
+
+    sparse_vector_free(expect);
+    sparse_vector_free(out);
+    printf("\n%s\n", pass ? "ALL TESTS PASSED" : "SOME TESTS FAILED");
+    return pass ? 0 : 1;
+}
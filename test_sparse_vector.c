@@ -0,0 +1,476 @@
+/**
+ * Test decoding into sparse form: every codec's sparse decoder against its
+ * dense one, corrupt streams, vector layout and arrays, the sparse
+ * operations against dense loops, and the time saved on signature vectors
+ *
+ * Build: gcc -O2 -o test_sparse_vector test_sparse_vector.c sparse_vector.c sparse_rice.c \
+ *        sparse_adaptive.c sparse_delta.c sparse_phase2.c sparse_phase3.c \
+ *        sparse_optimal_large.c sparse_dict.c sparse_auto.c sparse_batch.c dntl_sched.c \
+ *        dntl_alloc.c -lpthread -lm
+ */
+
+#include "sparse_vector.h"
+#include "sparse_adaptive.h"
+#include "sparse_auto.h"
+#include "sparse_batch.h"
+#include "sparse_delta.h"
+#include "sparse_optimal_large.h"
+#include "sparse_phase2.h"
+#include "sparse_phase3.h"
+#include "sparse_rice.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DIMENSION 2048
+
+enum {
+    C_RICE, C_ADAPTIVE, C_DELTA, C_PHASE3, C_OPTIMAL_LARGE,
+    C_PHASE2_RANS, C_PHASE2_TANS, C_DICT_RANS, C_DICT_TANS, C_AUTO, N_CODECS
+};
+
+static const char *codec_names[N_CODECS] = {
+    "rice", "adaptive", "delta", "phase3", "optimal_large",
+    "phase2 rANS", "phase2 tANS", "dict rANS", "dict tANS", "auto",
+};
+
+static uint64_t rng_state = 0xD1B54A32D192ED03ULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Signature-like: 97 nonzeros, Gaussian with sigma 12, in [-43, 42] */
+static void signature_vector(int8_t *vector) {
+    memset(vector, 0, DIMENSION);
+    for (int placed = 0; placed < 97;) {
+        size_t pos = next_rand() % DIMENSION;
+        if (vector[pos]) continue;
+        double u1 = (next_rand() % 1000000 + 1) / 1000001.0;
+        double u2 = (next_rand() % 1000000 + 1) / 1000001.0;
+        int value = (int)round(sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2) * 12.0);
+        if (value == 0) value = 1;
+        if (value < -43) value = -43;
+        if (value > 42) value = 42;
+        vector[pos] = (int8_t)value;
+        placed++;
+    }
+}
+
+/* Any density below 1/4, values in [-amp, amp], empty included */
+static void random_vector(int8_t *vector, size_t dim, int amp) {
+    memset(vector, 0, dim);
+    const uint64_t density = next_rand() % 17;
+    for (size_t i = 0; i < dim; i++) {
+        if (next_rand() % 64 < density) {
+            int v = (int)(next_rand() % (2 * (uint64_t)amp)) - amp;
+            vector[i] = (int8_t)(v >= 0 ? v + 1 : v);
+        }
+    }
+}
+
+typedef struct {
+    uint8_t *data;
+    size_t size;
+    uint16_t count;
+} stream_t;
+
+/* Encode with one codec; the codec structs share stream_t's layout */
+static int encode(int c, const int8_t *vector, size_t dim, const sparse_dict_t *dict,
+                  stream_t *s) {
+    void *e = NULL;
+    switch (c) {
+    case C_RICE: e = sparse_rice_encode(vector, dim); break;
+    case C_ADAPTIVE: e = sparse_adaptive_encode(vector, dim); break;
+    case C_DELTA: e = sparse_delta_encode(vector, dim); break;
+    case C_PHASE3: e = sparse_phase3_encode(vector, dim); break;
+    case C_OPTIMAL_LARGE: e = sparse_optimal_large_encode(vector, dim); break;
+    case C_PHASE2_RANS: e = sparse_phase2_encode_coder(vector, dim, SPARSE_PHASE2_RANS); break;
+    case C_PHASE2_TANS: e = sparse_phase2_encode_coder(vector, dim, SPARSE_PHASE2_TANS); break;
+    case C_DICT_RANS:
+        e = sparse_phase2_encode_dict(vector, dim, dict, SPARSE_PHASE2_RANS);
+        break;
+    case C_DICT_TANS:
+        e = sparse_phase2_encode_dict(vector, dim, dict, SPARSE_PHASE2_TANS);
+        break;
+    case C_AUTO: e = sparse_auto_encode(vector, dim, dict); break;
+    }
+    if (!e) return -1;
+    *s = *(stream_t *)e;
+    free(e);
+    return 0;
+}
+
+static int decode_dense(int c, const stream_t *s, int8_t *vector, size_t dim,
+                        sparse_codec_ctx_t *ctx) {
+    switch (c) {
+    case C_RICE: return sparse_rice_decode_ctx(ctx, (const sparse_rice_t *)s, vector, dim);
+    case C_ADAPTIVE:
+        return sparse_adaptive_decode_ctx(ctx, (const sparse_adaptive_t *)s, vector, dim);
+    case C_DELTA: return sparse_delta_decode_ctx(ctx, (const sparse_delta_t *)s, vector, dim);
+    case C_PHASE3:
+        return sparse_phase3_decode_ctx(ctx, (const sparse_phase3_t *)s, vector, dim);
+    case C_OPTIMAL_LARGE:
+        return sparse_optimal_large_decode_ctx(ctx, (const sparse_optimal_large_t *)s,
+                                               vector, dim);
+    case C_PHASE2_RANS:
+    case C_PHASE2_TANS:
+        return sparse_phase2_decode_coder_ctx(ctx, (const sparse_phase2_t *)s, vector, dim,
+                                              c == C_PHASE2_TANS ? SPARSE_PHASE2_TANS
+                                                                 : SPARSE_PHASE2_RANS);
+    case C_DICT_RANS:
+    case C_DICT_TANS:
+        return sparse_phase2_decode_dict_ctx(ctx, (const sparse_phase2_t *)s, vector, dim,
+                                             NULL, c == C_DICT_TANS ? SPARSE_PHASE2_TANS
+                                                                    : SPARSE_PHASE2_RANS);
+    case C_AUTO: return sparse_auto_decode((const sparse_auto_t *)s, vector, dim, NULL);
+    }
+    return -1;
+}
+
+/* With a context, or through the entry point that makes its own */
+static int decode_sparse(int c, const stream_t *s, sparse_vector_t *out,
+                         sparse_codec_ctx_t *ctx) {
+    const sparse_phase2_coder_t coder = c == C_PHASE2_TANS || c == C_DICT_TANS
+                                            ? SPARSE_PHASE2_TANS : SPARSE_PHASE2_RANS;
+    switch (c) {
+    case C_RICE:
+        return ctx ? sparse_rice_decode_sparse_ctx(ctx, (const sparse_rice_t *)s, out)
+                   : sparse_rice_decode_sparse((const sparse_rice_t *)s, out);
+    case C_ADAPTIVE:
+        return ctx ? sparse_adaptive_decode_sparse_ctx(ctx, (const sparse_adaptive_t *)s, out)
+                   : sparse_adaptive_decode_sparse((const sparse_adaptive_t *)s, out);
+    case C_DELTA:
+        return ctx ? sparse_delta_decode_sparse_ctx(ctx, (const sparse_delta_t *)s, out)
+                   : sparse_delta_decode_sparse((const sparse_delta_t *)s, out);
+    case C_PHASE3:
+        return ctx ? sparse_phase3_decode_sparse_ctx(ctx, (const sparse_phase3_t *)s, out)
+                   : sparse_phase3_decode_sparse((const sparse_phase3_t *)s, out);
+    case C_OPTIMAL_LARGE:
+        return ctx ? sparse_optimal_large_decode_sparse_ctx(
+                         ctx, (const sparse_optimal_large_t *)s, out)
+                   : sparse_optimal_large_decode_sparse((const sparse_optimal_large_t *)s,
+                                                        out);
+    case C_PHASE2_RANS:
+    case C_PHASE2_TANS:
+        return ctx ? sparse_phase2_decode_coder_sparse_ctx(ctx, (const sparse_phase2_t *)s,
+                                                           out, coder)
+                   : sparse_phase2_decode_coder_sparse((const sparse_phase2_t *)s, out,
+                                                       coder);
+    case C_DICT_RANS:
+    case C_DICT_TANS:
+        return ctx ? sparse_phase2_decode_dict_sparse_ctx(ctx, (const sparse_phase2_t *)s,
+                                                          out, NULL, coder)
+                   : sparse_phase2_decode_dict_sparse((const sparse_phase2_t *)s, out, NULL,
+                                                      coder);
+    case C_AUTO: return sparse_auto_decode_sparse((const sparse_auto_t *)s, out, NULL);
+    }
+    return -1;
+}
+
+/* Same nonzeros, ascending */
+static int same_as_dense(const sparse_vector_t *sv, const int8_t *dense, size_t dim) {
+    size_t count = 0;
+    for (size_t i = 0; i < dim; i++) count += dense[i] != 0;
+    if (sv->count != count) return 0;
+    for (uint16_t i = 0; i < sv->count; i++) {
+        if (sv->indices[i] >= dim || (i && sv->indices[i] <= sv->indices[i - 1]) ||
+            sv->values[i] == 0 || dense[sv->indices[i]] != sv->values[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void) {
+    const sparse_dict_t *sig = sparse_dict_builtin(SPARSE_DICT_SIGNATURE);
+    sparse_codec_ctx_t *ctx = sparse_codec_ctx_create(DIMENSION);
+    sparse_vector_t *sv = sparse_vector_new(DIMENSION, DIMENSION);
+    static int8_t vec[DIMENSION], dense[DIMENSION];
+    int pass = sig && ctx && sv;
+
+    printf("=== Decoding into sparse form ===\n");
+    if (!pass) {
+        printf("  Setup: FAIL\n");
+        return 1;
+    }
+
+    /* Every codec: the sparse decoder holds what the dense one writes */
+    for (int c = 0; c < N_CODECS; c++) {
+        int ok = 1, trips = 0;
+        for (int trial = 0; trial < 300; trial++) {
+            const size_t dim = trial % 3 == 2 ? 1 + next_rand() % DIMENSION : DIMENSION;
+            if (dim == DIMENSION && trial % 2) {
+                signature_vector(vec);
+            } else {
+                random_vector(vec, dim, c == C_RICE ? 2 : c == C_ADAPTIVE ? 7 : 60);
+            }
+            if (c == C_RICE || c == C_ADAPTIVE) {
+                for (size_t i = 0; i < dim; i++) {
+                    if (c == C_RICE && (vec[i] > 2 || vec[i] < -2)) vec[i] = vec[i] > 0 ? 1 : -1;
+                    if (c == C_ADAPTIVE && (vec[i] > 7 || vec[i] < -8)) vec[i] = -3;
+                }
+            }
+            stream_t s;
+            if (encode(c, vec, dim, sig, &s) < 0) continue;
+            sv->dimension = (uint16_t)dim;
+            if (decode_dense(c, &s, dense, dim, ctx) == 0 && memcmp(dense, vec, dim) == 0) {
+                trips++;
+                ok &= decode_sparse(c, &s, sv, trial % 2 ? ctx : NULL) == 0 &&
+                      same_as_dense(sv, vec, dim);
+
+                /* Lists sized to the count alone, so overruns show under ASAN */
+                sparse_vector_t *tight = sparse_vector_new((uint16_t)dim, s.count);
+                ok &= tight && decode_sparse(c, &s, tight, ctx) == 0 &&
+                      same_as_dense(tight, vec, dim);
+                sparse_vector_free(tight);
+            }
+            free(s.data);
+        }
+        ok &= trips > 0;
+        printf("  %-14s sparse and dense decodes agree (%d/300 round trips): %s\n",
+               codec_names[c], trips, ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Corrupt streams: an error, or nonzeros ascending inside the dimension */
+    {
+        int ok = 1;
+        for (int trial = 0; trial < 4000; trial++) {
+            const int c = trial % (N_CODECS - 1);
+            signature_vector(vec);
+            if (c == C_RICE || c == C_ADAPTIVE) {
+                for (size_t i = 0; i < DIMENSION; i++) vec[i] = (int8_t)(vec[i] % 3);
+            }
+            stream_t s;
+            if (encode(c, vec, DIMENSION, sig, &s) < 0) continue;
+            for (int k = 0; k < 3; k++) {
+                s.data[next_rand() % s.size] ^= (uint8_t)(1 + next_rand() % 255);
+            }
+            sparse_vector_t *tight = sparse_vector_new(DIMENSION, s.count);
+            if (tight && decode_sparse(c, &s, tight, ctx) == 0) {
+                for (uint16_t i = 0; i < tight->count; i++) {
+                    ok &= tight->indices[i] < DIMENSION &&
+                          (i == 0 || tight->indices[i] > tight->indices[i - 1]);
+                }
+            }
+            sparse_vector_free(tight);
+            free(s.data);
+        }
+        printf("  Corrupt streams stay in bounds: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Batches: one vector at a time into sparse form */
+    {
+        const size_t n = 200;
+        int8_t *vecs = malloc(n * DIMENSION);
+        int ok = vecs != NULL;
+        for (size_t v = 0; ok && v < n; v++) signature_vector(vecs + v * DIMENSION);
+        sparse_batch_t *batch = ok ? sparse_batch_encode(vecs, n, DIMENSION, sig,
+                                                         SPARSE_PHASE2_TANS, 2) : NULL;
+        sparse_batch_reader_t reader;
+        ok &= batch && sparse_batch_open(&reader, batch->data, batch->size) == 0;
+        sv->dimension = DIMENSION;
+        for (size_t v = 0; ok && v < n; v++) {
+            ok &= sparse_batch_decode_one_sparse(&reader, v, NULL, v % 2 ? ctx : NULL, sv) == 0 &&
+                  same_as_dense(sv, vecs + v * DIMENSION, DIMENSION);
+        }
+        sv->dimension = DIMENSION - 1;
+        ok &= batch && sparse_batch_decode_one_sparse(&reader, 0, NULL, ctx, sv) == -1;
+        printf("  Batch vectors one at a time: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        sparse_batch_free(batch);
+        free(vecs);
+    }
+
+    /* Layout: one block, aligned arrays, arenas, capacity enforced on reuse */
+    {
+        int ok = 1;
+        ok &= sv->capacity == DIMENSION &&
+              (uintptr_t)sv->indices % SPARSE_VECTOR_ALIGN == 0 &&
+              (uintptr_t)sv->values % SPARSE_VECTOR_ALIGN == 0 &&
+              (uint8_t *)sv->values >= (uint8_t *)(sv->indices + DIMENSION) &&
+              (uint8_t *)sv->values + DIMENSION <=
+                  (uint8_t *)sv + sparse_vector_bytes(DIMENSION);
+
+        /* Sixteen vectors carved from one arena, reused without freeing */
+        const uint16_t room = 100;
+        const size_t stride = sparse_vector_bytes(room);
+        uint8_t *arena = aligned_alloc(SPARSE_VECTOR_ALIGN, 16 * stride);
+        ok &= arena && stride % SPARSE_VECTOR_ALIGN == 0 &&
+              sparse_vector_init(arena + 1, DIMENSION, room) == NULL;
+        for (int round = 0; arena && round < 3; round++) {
+            for (int v = 0; v < 16; v++) {
+                sparse_vector_t *slot = round ? (sparse_vector_t *)(arena + v * stride)
+                                              : sparse_vector_init(arena + v * stride,
+                                                                   DIMENSION, room);
+                sparse_vector_reset(slot);
+                ok &= slot->count == 0 && slot->capacity == room;
+                signature_vector(vec);
+                stream_t s;
+                if (encode(C_DICT_TANS, vec, DIMENSION, sig, &s) < 0) {
+                    ok = 0;
+                    continue;
+                }
+                ok &= decode_sparse(C_DICT_TANS, &s, slot, ctx) == 0 &&
+                      same_as_dense(slot, vec, DIMENSION);
+                free(s.data);
+            }
+        }
+        free(arena);
+
+        /* A count past the capacity is refused, whatever the codec */
+        sparse_vector_t *small = sparse_vector_new(DIMENSION, 96);
+        signature_vector(vec);
+        for (int c = 0; small && c < N_CODECS; c++) {
+            for (size_t i = 0; c <= C_ADAPTIVE && i < DIMENSION; i++) {
+                vec[i] = (int8_t)(vec[i] % 3);
+            }
+            stream_t s;
+            if (encode(c, vec, DIMENSION, sig, &s) < 0) continue;
+            ok &= s.count <= 96 || decode_sparse(c, &s, small, ctx) == -1;
+            free(s.data);
+        }
+        ok &= small != NULL;
+        sparse_vector_free(small);
+        printf("  Aligned single-block vectors, arenas and reuse: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Whole batches into a vector array, on several threads */
+    {
+        const size_t n = 300;
+        int8_t *vecs = malloc(n * DIMENSION);
+        sparse_vector_array_t *array = sparse_vector_array_new(n, DIMENSION, DIMENSION);
+        int ok = vecs && array && array->n == n;
+        for (size_t v = 0; ok && v < n; v++) signature_vector(vecs + v * DIMENSION);
+        sparse_batch_t *batch = ok ? sparse_batch_encode(vecs, n, DIMENSION, sig,
+                                                         SPARSE_PHASE2_RANS, 4) : NULL;
+        sparse_batch_reader_t reader;
+        ok &= batch && sparse_batch_open(&reader, batch->data, batch->size) == 0;
+        for (int round = 0; ok && round < 2; round++) {
+            sparse_vector_array_reset(array);
+            ok &= sparse_batch_decode_all_sparse(&reader, NULL, round ? 4 : 1, array) == 0;
+            for (size_t v = 0; ok && v < n; v++) {
+                ok &= (uintptr_t)array->vectors[v].indices % SPARSE_VECTOR_ALIGN == 0 &&
+                      same_as_dense(&array->vectors[v], vecs + v * DIMENSION, DIMENSION);
+            }
+        }
+        sparse_vector_array_t *short_array = sparse_vector_array_new(n - 1, DIMENSION, 16);
+        ok &= batch && short_array &&
+              sparse_batch_decode_all_sparse(&reader, NULL, 2, short_array) == -1;
+        printf("  Batch into a vector array: %s\n", ok ? "PASS" : "FAIL");
+        pass &= ok;
+        sparse_vector_array_free(short_array);
+        sparse_vector_array_free(array);
+        sparse_batch_free(batch);
+        free(vecs);
+    }
+
+    /* Operations on the sparse form against dense loops */
+    {
+        int ok = 1;
+        static int32_t row[DIMENSION];
+        static uint32_t poly[DIMENSION];
+        for (int trial = 0; trial < 500; trial++) {
+            const size_t dim = 1 + next_rand() % DIMENSION;
+            random_vector(vec, dim, 127);
+            for (size_t i = 0; i < dim; i++) {
+                row[i] = (int32_t)(uint32_t)next_rand();
+            }
+            sparse_vector_t *from = sparse_from_dense(vec, (uint16_t)dim);
+            ok &= from && same_as_dense(from, vec, dim);
+            if (!from) continue;
+
+            memset(dense, 0x55, dim);
+            sparse_to_dense(from, dense);
+            ok &= memcmp(dense, vec, dim) == 0;
+
+            uint64_t norm_sq = 0;
+            int64_t dot = 0;
+            for (size_t i = 0; i < dim; i++) {
+                norm_sq += (uint64_t)(vec[i] * vec[i]);
+                dot += (int64_t)row[i] * vec[i];
+            }
+            ok &= sparse_l2_norm_sq(from) == norm_sq &&
+                  fabsf(sparse_l2_norm(from) - sqrtf((float)norm_sq)) < 1e-3f &&
+                  sparse_dot_i32(from, row) == dot;
+
+            const uint32_t q = trial % 2 ? 12289 : 257;
+            memset(poly, 0xAA, dim * sizeof(uint32_t));
+            ok &= sparse_to_poly(from, q, poly) == 0;
+            for (size_t i = 0; i < dim; i++) {
+                ok &= poly[i] == (uint32_t)(((int32_t)vec[i] + (int32_t)q) % (int32_t)q);
+            }
+            /* Too small a modulus for the values */
+            int8_t big = 0;
+            for (uint16_t i = 0; i < from->count; i++) {
+                if (abs(from->values[i]) > abs(big)) big = from->values[i];
+            }
+            if (big) ok &= sparse_to_poly(from, (uint32_t)abs(big), poly) == -1;
+            ok &= sparse_to_poly(from, 0, poly) == -1;
+            sparse_vector_free(from);
+        }
+        printf("  Norm, dot product and polynomial match dense loops: %s\n",
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+    }
+
+    /* Time: dense decode and rescan, against decoding into sparse form */
+    {
+        const int n = 2000;
+        stream_t *streams = malloc(n * sizeof(stream_t));
+        int ok = streams != NULL;
+        for (int v = 0; ok && v < n; v++) {
+            signature_vector(vec);
+            ok &= encode(C_DICT_TANS, vec, DIMENSION, sig, &streams[v]) == 0;
+        }
+        double t_dense = 0, t_sparse = 0;
+        int64_t sink = 0;
+        static int32_t row[DIMENSION];
+        for (int i = 0; i < DIMENSION; i++) row[i] = (int32_t)(next_rand() % 12289);
+        for (int rep = 0; ok && rep < 5; rep++) {
+            double t0 = now_ns();
+            for (int v = 0; v < n; v++) {
+                const sparse_phase2_t *e = (const sparse_phase2_t *)&streams[v];
+                sparse_phase2_decode_dict_ctx(ctx, e, dense, DIMENSION, sig, SPARSE_PHASE2_TANS);
+                sparse_vector_t *from = sparse_from_dense(dense, DIMENSION);
+                sink += from ? sparse_dot_i32(from, row) : 0;
+                sparse_vector_free(from);
+            }
+            double t1 = now_ns();
+            sv->dimension = DIMENSION;
+            for (int v = 0; v < n; v++) {
+                const sparse_phase2_t *e = (const sparse_phase2_t *)&streams[v];
+                sparse_phase2_decode_dict_sparse_ctx(ctx, e, sv, sig, SPARSE_PHASE2_TANS);
+                sink -= sparse_dot_i32(sv, row);
+            }
+            t_dense += t1 - t0;
+            t_sparse += now_ns() - t1;
+        }
+        ok &= sink == 0;
+        printf("  Signature decode and dot product: dense then rescan %.2f us, "
+               "sparse %.2f us: %s\n", t_dense / (5e3 * n), t_sparse / (5e3 * n),
+               ok ? "PASS" : "FAIL");
+        pass &= ok;
+        for (int v = 0; streams && v < n; v++) free(streams[v].data);
+        free(streams);
+    }
+
+    sparse_vector_free(sv);
+    sparse_codec_ctx_free(ctx);
+    printf("\n%s\n", pass ? "All sparse-form tests PASS" : "Some sparse-form tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/**
+ * Test the tabled ANS coder: round trips, size against entropy and rANS,
+ * truncated streams, and throughput
+ *
+ * Build: gcc -O2 -o test_tans test_tans.c -lm
+ */
+
+#include "tans.h"
+#include "rans_interleaved.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_SYMS 20000
+
+static uint64_t rng_state = 0x94D049BB133111EBULL;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Random frequencies over n_symbols, summing to TANS_TABLE_SIZE, skewed */
+static void random_freqs(uint32_t *freqs, int n_symbols) {
+    for (int s = 0; s < n_symbols; s++) {
+        freqs[s] = 1;
+    }
+    for (uint32_t k = (uint32_t)n_symbols; k < TANS_TABLE_SIZE; k++) {
+        uint64_t r = next_rand();
+        int s = (r >> 32) % 4 ? (int)(r % (n_symbols / 4 + 1)) : (int)(r % n_symbols);
+        freqs[s]++;
+    }
+}
+
+/* Gaussian-like frequencies over 44 values, as for the signature vectors */
+static void gaussian_freqs(uint32_t *freqs) {
+    uint32_t sum = 0;
+    for (int s = 0; s < 44; s++) {
+        double z = (s - 21.5) / 8.0;
+        freqs[s] = 1 + (uint32_t)(11.0 * exp(-z * z / 2));
+        sum += freqs[s];
+    }
+    freqs[21] += TANS_TABLE_SIZE - sum;
+}
+
+/* Symbols drawn from the frequencies */
+static void random_syms(const uint32_t *freqs, int n_symbols, uint8_t *syms, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint32_t slot = (uint32_t)(next_rand() % TANS_TABLE_SIZE);
+        int s = 0;
+        while (slot >= freqs[s]) {
+            slot -= freqs[s++];
+        }
+        syms[i] = (uint8_t)(s < n_symbols ? s : n_symbols - 1);
+    }
+}
+
+static double entropy_bits(const uint32_t *freqs, const uint8_t *syms, size_t n) {
+    double bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        bits -= log2((double)freqs[syms[i]] / TANS_TABLE_SIZE);
+    }
+    return bits;
+}
+
+int main(void) {
+    static uint8_t syms[MAX_SYMS], out[MAX_SYMS];
+    static uint8_t stream[2 * MAX_SYMS];
+    static uint16_t scratch[MAX_SYMS];
+    static tans_table_t table;
+    uint32_t freqs[TANS_TABLE_SIZE];
+    int pass = 1;
+
+    printf("=== Tabled ANS ===\n");
+
+    /* Round trips, with a prefix and a tail in the same bit stream */
+    int trip_ok = 1;
+    for (int trial = 0; trial < 400; trial++) {
+        const int n_symbols = 1 + (int)(next_rand() % (trial % 4 == 0 ? TANS_TABLE_SIZE : 44));
+        const size_t n = trial % 8 < 2 ? next_rand() % 20 : next_rand() % MAX_SYMS;
+        if (n_symbols == 1) {
+            freqs[0] = TANS_TABLE_SIZE;
+        } else {
+            random_freqs(freqs, n_symbols);
+        }
+        trip_ok &= tans_table_build(&table, freqs, n_symbols) == 0;
+        random_syms(freqs, n_symbols, syms, n);
+
+        const unsigned prefix = (unsigned)(next_rand() % 8);
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        bw_write_bits(&bw, 0x5A, prefix);
+        trip_ok &= tans_encode(&table, syms, n, scratch, &bw) == 0;
+        bw_write_bits(&bw, 0x2B, 7);
+        size_t size = bw_finish(&bw);
+
+        memset(out, 0xAA, n);
+        bit_reader_t br;
+        uint32_t v;
+        br_init(&br, stream, size);
+        br_read_bits(&br, prefix, &v);
+        trip_ok &= tans_decode(&table, &br, out, n) == 0 && memcmp(out, syms, n) == 0;
+        trip_ok &= br_read_bits(&br, 7, &v) == 0 && v == 0x2B;
+    }
+    printf("  Round trips: %s\n", trip_ok ? "PASS" : "FAIL");
+    pass &= trip_ok;
+
+    /* Size: near entropy, and close to rANS on the signature alphabet */
+    int size_ok = 1;
+    {
+        static rans_table_t rtable;
+        gaussian_freqs(freqs);
+        tans_table_build(&table, freqs, 44);
+        rans_table_build(&rtable, freqs, 44);
+        const size_t sizes[3] = { 97, 1000, MAX_SYMS };
+        for (int k = 0; k < 3; k++) {
+            const size_t n = sizes[k];
+            double t_bits = 0, r_bits = 0, h_bits = 0;
+            const int reps = k == 2 ? 10 : 200;
+            for (int rep = 0; rep < reps; rep++) {
+                random_syms(freqs, 44, syms, n);
+                bit_writer_t bw;
+                bw_init(&bw, stream, sizeof(stream));
+                tans_encode(&table, syms, n, scratch, &bw);
+                t_bits += (double)bw_tell(&bw);
+                r_bits += 8.0 * (double)rans_encode(&rtable, 1, syms, n, stream, sizeof(stream));
+                h_bits += entropy_bits(freqs, syms, n);
+            }
+            printf("  %5zu values: entropy %.3f, tANS %.3f, rANS %.3f bits/value\n", n,
+                   h_bits / (reps * n), t_bits / (reps * n), r_bits / (reps * n));
+            /* Within 1% of entropy once the state's bits are amortized */
+            if (n >= 1000) {
+                size_ok &= t_bits < 1.01 * h_bits;
+            }
+        }
+    }
+    printf("  Size near entropy: %s\n", size_ok ? "PASS" : "FAIL");
+    pass &= size_ok;
+
+    /* Truncated streams fail without reading past the end */
+    int trunc_ok = 1;
+    for (int trial = 0; trial < 200; trial++) {
+        const size_t n = 2 + next_rand() % 3000;
+        gaussian_freqs(freqs);
+        tans_table_build(&table, freqs, 44);
+        random_syms(freqs, 44, syms, n);
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        tans_encode(&table, syms, n, scratch, &bw);
+        const size_t bits = bw_tell(&bw);
+        size_t size = bw_finish(&bw);
+
+        /* Exact-size copy, so reads past the end show up under ASAN */
+        uint8_t *cut = malloc(size);
+        memcpy(cut, stream, size);
+        bit_reader_t br;
+        br_init(&br, cut, size);
+        trunc_ok &= tans_decode(&table, &br, out, n) == 0 && br_tell(&br) == bits;
+        /* Enough bits left only if the dropped byte held none of the stream */
+        br_init(&br, cut, size - 1);
+        trunc_ok &= tans_decode(&table, &br, out, n) == ((size - 1) * 8 >= bits ? 0 : -1);
+        br_init(&br, cut, size / 2);
+        trunc_ok &= tans_decode(&table, &br, out, n) == -1;
+        free(cut);
+    }
+    printf("  Truncated streams rejected: %s\n", trunc_ok ? "PASS" : "FAIL");
+    pass &= trunc_ok;
+
+    /* Bad frequency tables and symbols */
+    int table_ok = 1;
+    {
+        uint32_t f[3] = { 128, 128, 0 };
+        table_ok &= tans_table_build(&table, f, 3) == -1;
+        f[2] = 1;
+        table_ok &= tans_table_build(&table, f, 3) == -1;
+        f[1] = 127;
+        table_ok &= tans_table_build(&table, f, 3) == 0;
+        table_ok &= tans_table_build(&table, f, 0) == -1;
+        uint8_t bad[2] = { 0, 5 };
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        table_ok &= tans_encode(&table, bad, 2, scratch, &bw) == -1;
+        memset(syms, 2, 100);                                   /* 8 bits each */
+        bw_init(&bw, stream, 1);
+        table_ok &= tans_encode(&table, syms, 100, scratch, &bw) == -1;
+    }
+    printf("  Bad frequency tables rejected: %s\n", table_ok ? "PASS" : "FAIL");
+    pass &= table_ok;
+
+    /* Throughput on the signature alphabet */
+    {
+        static rans_table_t rtable;
+        const size_t n = MAX_SYMS;
+        gaussian_freqs(freqs);
+        tans_table_build(&table, freqs, 44);
+        rans_table_build(&rtable, freqs, 44);
+        random_syms(freqs, 44, syms, n);
+        bit_writer_t bw;
+        bw_init(&bw, stream, sizeof(stream));
+        tans_encode(&table, syms, n, scratch, &bw);
+        size_t size = bw_finish(&bw);
+
+        const int iters = 200;
+        double t0 = now_ns();
+        for (int it = 0; it < iters; it++) {
+            bw_init(&bw, stream + size, sizeof(stream) - size);
+            tans_encode(&table, syms, n, scratch, &bw);
+        }
+        double t_enc = (now_ns() - t0) / ((double)iters * n);
+        t0 = now_ns();
+        for (int it = 0; it < iters; it++) {
+            bit_reader_t br;
+            br_init(&br, stream, size);
+            tans_decode(&table, &br, out, n);
+        }
+        double t_dec = (now_ns() - t0) / ((double)iters * n);
+
+        size_t rsize = rans_encode(&rtable, 1, syms, n, stream, sizeof(stream));
+        t0 = now_ns();
+        for (int it = 0; it < iters; it++) {
+            rans_decode(&rtable, 1, stream, rsize, out, n);
+        }
+        double t_rans = (now_ns() - t0) / ((double)iters * n);
+        printf("  tANS: encode %.2f ns, decode %.2f ns/value (1-lane rANS decode %.2f)\n",
+               t_enc, t_dec, t_rans);
+    }
+
+    printf("\n%s\n", pass ? "All tANS tests PASS" : "Some tANS tests FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/**
+ * train_sparse_dict.c
+ *
+ * Train a shared dictionary (sparse_dict.h) and print it as C tables
+ *
+ * Usage: ./train_sparse_dict ID [FILE DIMENSION]
+ *   FILE holds raw int8 vectors of DIMENSION values each; without it the
+ *   samples are 10000 s_mangled-like vectors from test_phase2's generator
+ *
+ * Build: gcc -O2 -o train_sparse_dict train_sparse_dict.c sparse_dict.c -lpthread -lm
+ */
+
+#include "sparse_dict.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_DIMENSION 2048
+#define SAMPLE_VECTORS   10000
+
+/* As test_phase2: 97 nonzeros, Gaussian with sigma 12, clamped to [-43, 42] */
+static void generate_s_mangled_97nz(int8_t *vector, unsigned int seed) {
+    srand(seed);
+    memset(vector, 0, SAMPLE_DIMENSION);
+
+    uint16_t positions[97];
+    for (uint16_t i = 0; i < 97; i++) {
+        uint16_t pos;
+        int retry;
+        do {
+            pos = rand() % SAMPLE_DIMENSION;
+            retry = 0;
+            for (uint16_t j = 0; j < i; j++) {
+                if (positions[j] == pos) {
+                    retry = 1;
+                    break;
+                }
+            }
+        } while (retry);
+        positions[i] = pos;
+    }
+
+    for (uint16_t i = 0; i < 97; i++) {
+        float u1 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+        float u2 = (rand() + 1.0f) / (RAND_MAX + 2.0f);
+        float z = sqrtf(-2.0f * logf(u1)) * cosf(2.0f * M_PI * u2);
+        int value = (int)round(z * 12.0);
+        if (value < -43) value = -43;
+        if (value > 42) value = 42;
+        vector[positions[i]] = (int8_t)value;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2 && argc != 4) {
+        fprintf(stderr, "Usage: %s ID [FILE DIMENSION]\n", argv[0]);
+        return 1;
+    }
+    const unsigned id = (unsigned)atoi(argv[1]);
+
+    int8_t *vectors;
+    size_t n_vectors, dimension;
+    if (argc == 4) {
+        dimension = (size_t)atol(argv[3]);
+        FILE *f = fopen(argv[2], "rb");
+        if (!f || dimension == 0) {
+            fprintf(stderr, "Cannot read %s\n", argv[2]);
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        n_vectors = (size_t)ftell(f) / dimension;
+        fseek(f, 0, SEEK_SET);
+        vectors = malloc(n_vectors * dimension + 1);
+        if (!vectors || fread(vectors, dimension, n_vectors, f) != n_vectors) {
+            fprintf(stderr, "Cannot read %s\n", argv[2]);
+            return 1;
+        }
+        fclose(f);
+    } else {
+        dimension = SAMPLE_DIMENSION;
+        n_vectors = SAMPLE_VECTORS;
+        vectors = malloc(n_vectors * dimension);
+        if (!vectors) return 1;
+        for (size_t v = 0; v < n_vectors; v++) {
+            generate_s_mangled_97nz(vectors + v * dimension, (unsigned)v);
+        }
+    }
+
+    sparse_dict_t dict;
+    if (id > SPARSE_DICT_MAX_ID ||
+        sparse_dict_train(&dict, (uint8_t)id, vectors, n_vectors, dimension) < 0) {
+        fprintf(stderr, "Training failed\n");
+        return 1;
+    }
+    free(vectors);
+
+    printf("/* Dictionary %u: %zu vectors of dimension %zu, %d values */\n",
+           id, n_vectors, dimension, dict.n_values);
+    printf("static const int8_t values[] = {");
+    for (int i = 0; i < dict.n_values; i++) {
+        printf("%s%4d,", i % 12 ? "" : "\n   ", dict.values[i]);
+    }
+    printf("\n};\nstatic const uint32_t freqs[] = {");
+    for (int i = 0; i < dict.n_values; i++) {
+        printf("%s%4u,", i % 12 ? "" : "\n   ", dict.freqs[i]);
+    }
+    printf("\n};\n#define ESCAPE_FREQ %u\n", dict.freqs[dict.n_values]);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "uniform_mod.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+
+int umod_init(umod_t *u, uint32_t q, unsigned word_bits) {
+    if (q < 2 || word_bits == 0 || word_bits > 32 ||
+        (uint64_t)q > ((uint64_t)1 << word_bits)) {
+        return -1;
+    }
+
+    unsigned l = 0;
+    while (((uint64_t)1 << l) < q) {
+        l++;
+    }
+
+    uint64_t range = (uint64_t)1 << word_bits;
+    u->q = q;
+    u->magic = (uint32_t)((((uint64_t)1 << 32) * (((uint64_t)1 << l) - q)) / q + 1);
+    u->shift = l - 1;
+    u->max_accept = (uint32_t)(range - range % q - 1);
+    return 0;
+}
+
+// ============================================================================
+// VECTOR KERNELS
+// ============================================================================
+
+#if defined(__AVX512F__)
+
+static inline __m512i reduce16(__m512i w, __m512i magic, __m128i shift, __m512i q) {
+    // High halves of the 32x32 products: even lanes, then odd lanes
+    __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(w, magic), 32);
+    __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(w, 32), magic);
+    __m512i t = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+
+    __m512i quo = _mm512_add_epi32(t, _mm512_srli_epi32(_mm512_sub_epi32(w, t), 1));
+    quo = _mm512_srl_epi32(quo, shift);
+    return _mm512_sub_epi32(w, _mm512_mullo_epi32(quo, q));
+}
+
+#elif defined(__AVX2__)
+
+static inline __m256i reduce8(__m256i w, __m256i magic, __m128i shift, __m256i q) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(w, magic), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(w, 32), magic);
+    __m256i t = _mm256_blend_epi32(even, odd, 0xAA);
+
+    __m256i quo = _mm256_add_epi32(t, _mm256_srli_epi32(_mm256_sub_epi32(w, t), 1));
+    quo = _mm256_srl_epi32(quo, shift);
+    return _mm256_sub_epi32(w, _mm256_mullo_epi32(quo, q));
+}
+
+#endif
+
+// ============================================================================
+// REDUCTION
+// ============================================================================
+
+void umod_reduce_array(const umod_t *u, uint32_t *v, size_t n) {
+    size_t i = 0;
+
+    #if defined(__AVX512F__)
+    const __m512i magic = _mm512_set1_epi32((int)u->magic);
+    const __m512i q = _mm512_set1_epi32((int)u->q);
+    const __m128i shift = _mm_cvtsi32_si128((int)u->shift);
+    for (; i + 16 <= n; i += 16) {
+        __m512i w = _mm512_loadu_si512((const void *)(v + i));
+        _mm512_storeu_si512((void *)(v + i), reduce16(w, magic, shift, q));
+    }
+    #elif defined(__AVX2__)
+    const __m256i magic = _mm256_set1_epi32((int)u->magic);
+    const __m256i q = _mm256_set1_epi32((int)u->q);
+    const __m128i shift = _mm_cvtsi32_si128((int)u->shift);
+    for (; i + 8 <= n; i += 8) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)(v + i));
+        _mm256_storeu_si256((__m256i *)(v + i), reduce8(w, magic, shift, q));
+    }
+    #endif
+
+    for (; i < n; i++) {
+        v[i] = umod_reduce(u, v[i]);
+    }
+}
+
+// ============================================================================
+// REJECTION SAMPLING
+// ============================================================================
+
+size_t umod_sample(const umod_t *u,
+                   const uint32_t *in, size_t in_len,
+                   uint32_t *out, size_t out_len,
+                   size_t *consumed) {
+    size_t i = 0, k = 0;
+
+    #if defined(__AVX512F__)
+    // Full vectors while a whole one still fits in out
+    const __m512i magic = _mm512_set1_epi32((int)u->magic);
+    const __m512i q = _mm512_set1_epi32((int)u->q);
+    const __m512i max_accept = _mm512_set1_epi32((int)u->max_accept);
+    const __m128i shift = _mm_cvtsi32_si128((int)u->shift);
+    for (; i + 16 <= in_len && k + 16 <= out_len; i += 16) {
+        __m512i w = _mm512_loadu_si512((const void *)(in + i));
+        __mmask16 keep = _mm512_cmple_epu32_mask(w, max_accept);
+        _mm512_mask_compressstoreu_epi32((void *)(out + k), keep, reduce16(w, magic, shift, q));
+        k += (size_t)__builtin_popcount(keep);
+    }
+    #elif defined(__AVX2__)
+    // Reduce 8 at a time, then compact without branches
+    const __m256i magic = _mm256_set1_epi32((int)u->magic);
+    const __m256i q = _mm256_set1_epi32((int)u->q);
+    const __m256i max_accept = _mm256_set1_epi32((int)u->max_accept);
+    const __m128i shift = _mm_cvtsi32_si128((int)u->shift);
+    for (; i + 8 <= in_len && k + 8 <= out_len; i += 8) {
+        uint32_t r[8];
+        __m256i w = _mm256_loadu_si256((const __m256i *)(in + i));
+        // w <= max_accept (unsigned) iff max(w, max_accept) == max_accept
+        __m256i ok = _mm256_cmpeq_epi32(_mm256_max_epu32(w, max_accept), max_accept);
+        unsigned keep = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(ok));
+        _mm256_storeu_si256((__m256i *)r, reduce8(w, magic, shift, q));
+        for (int j = 0; j < 8; j++) {
+            out[k] = r[j];
+            k += (keep >> j) & 1;
+        }
+    }
+    #endif
+
+    for (; i < in_len && k < out_len; i++) {
+        uint32_t w = in[i];
+        if (w <= u->max_accept) {
+            out[k++] = umod_reduce(u, w);
+        }
+    }
+
+    *consumed = i;
+    return k;
+}
@@ -0,0 +1,69 @@
+#ifndef UNIFORM_MOD_H
+#define UNIFORM_MOD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// UNIFORM REDUCTION MOD q
+// ============================================================================
+
+/**
+ * Precomputed constants for reducing random words mod q
+ *
+ * Division uses the round-up multiply-shift of Granlund and Montgomery:
+ * with l = ceil(log2 q),
+ *
+ *     t = (w * magic) >> 32
+ *     w / q = (t + ((w - t) >> 1)) >> (l - 1)
+ *
+ * which is exact for every 32-bit w, so vector lanes need only a 32x32
+ * high multiply. max_accept is the largest word of a complete run of q
+ * residues: words above it are what make w % q biased, and umod_sample()
+ * rejects them.
+ */
+typedef struct {
+    uint32_t q;
+    uint32_t magic;         // floor(2^32 * (2^l - q) / q) + 1
+    uint32_t shift;         // l - 1
+    uint32_t max_accept;    // 2^bits - (2^bits % q) - 1
+} umod_t;
+
+/**
+ * Precompute constants for modulus q and words of word_bits random bits
+ *
+ * @return          0, or -1 unless 2 <= q <= 2^word_bits <= 2^32
+ */
+int umod_init(umod_t *u, uint32_t q, unsigned word_bits);
+
+/**
+ * w % q for one word
+ */
+static inline uint32_t umod_reduce(const umod_t *u, uint32_t w) {
+    uint32_t t = (uint32_t)(((uint64_t)w * u->magic) >> 32);
+    uint32_t quo = (t + ((w - t) >> 1)) >> u->shift;
+    return w - quo * u->q;
+}
+
+/**
+ * v[i] %= q in place, 16 (AVX-512) or 8 (AVX2) words per instruction
+ *
+ * Same result as the scalar %, bias included.
+ */
+void umod_reduce_array(const umod_t *u, uint32_t *v, size_t n);
+
+/**
+ * Rejection sampling: reduce the in-range words and compact them, in order
+ *
+ * Reads words from in until out_len values are written or in_len words are
+ * consumed. out may alias in (compaction never overtakes the reads).
+ *
+ * @param consumed  Receives the number of words read
+ * @return          Number of values written to out
+ */
+size_t umod_sample(const umod_t *u,
+                   const uint32_t *in, size_t in_len,
+                   uint32_t *out, size_t out_len,
+                   size_t *consumed);
+
+#endif // UNIFORM_MOD_H
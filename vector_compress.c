@@ -7,85 +7,202 @@
 #include "vector_compress.h"
 #include "huffman_vector.h"
 #include <zstd.h>
+#include <zdict.h>
 #include <stdlib.h>
 #include <string.h>
 
+struct vector_compress_ctx_s {
+    ZSTD_CCtx *cctx;
+    ZSTD_DCtx *dctx;
+    ZSTD_CDict *cdict;      /* Loaded dictionary, digested once; NULL for none */
+    ZSTD_DDict *ddict;
+    uint8_t *huffman;       /* Huffman stage: encoder output, decoder input */
+    size_t huffman_cap;
+    uint8_t *zstd;          /* Frame of the allocating compressor */
+    size_t zstd_cap;
+    size_t max_dimension;
+};
+
+vector_compress_ctx_t* vector_compress_ctx_create(size_t max_dimension) {
+    size_t huffman_cap = huffman_max_encoded_size(max_dimension);
+    if (huffman_cap == 0) return NULL;
+
+    vector_compress_ctx_t *ctx = calloc(1, sizeof(vector_compress_ctx_t));
+    if (!ctx) return NULL;
+
+    ctx->zstd_cap = ZSTD_compressBound(huffman_cap);
+    ctx->cctx = ZSTD_createCCtx();
+    ctx->dctx = ZSTD_createDCtx();
+    ctx->huffman = malloc(huffman_cap);
+    ctx->zstd = malloc(ctx->zstd_cap);
+    if (!ctx->cctx || !ctx->dctx || !ctx->huffman || !ctx->zstd) {
+        vector_compress_ctx_free(ctx);
+        return NULL;
+    }
+    ctx->huffman_cap = huffman_cap;
+    ctx->max_dimension = max_dimension;
+    return ctx;
+}
+
+void vector_compress_ctx_free(vector_compress_ctx_t *ctx) {
+    if (!ctx) return;
+    ZSTD_freeCCtx(ctx->cctx);
+    ZSTD_freeDCtx(ctx->dctx);
+    ZSTD_freeCDict(ctx->cdict);
+    ZSTD_freeDDict(ctx->ddict);
+    free(ctx->huffman);
+    free(ctx->zstd);
+    free(ctx);
+}
+
+int vector_compress_ctx_load_dict(vector_compress_ctx_t *ctx, const void *dict,
+                                  size_t dict_size, compress_level_t level) {
+    if (!ctx || (!dict && dict_size > 0)) return -1;
+
+    ZSTD_CDict *cdict = NULL;
+    ZSTD_DDict *ddict = NULL;
+    if (dict_size > 0) {
+        cdict = ZSTD_createCDict(dict, dict_size, (int)level);
+        ddict = ZSTD_createDDict(dict, dict_size);
+        if (!cdict || !ddict) {
+            ZSTD_freeCDict(cdict);
+            ZSTD_freeDDict(ddict);
+            return -1;
+        }
+    }
+    ZSTD_freeCDict(ctx->cdict);
+    ZSTD_freeDDict(ctx->ddict);
+    ctx->cdict = cdict;
+    ctx->ddict = ddict;
+    return 0;
+}
+
+size_t vector_compress_max_size(size_t dimension) {
+    size_t huffman_cap = huffman_max_encoded_size(dimension);
+    return huffman_cap ? ZSTD_compressBound(huffman_cap) : 0;
+}
+
+int vector_compress_train_dict(const uint8_t *vectors, size_t n_vectors, size_t dimension,
+                               uint8_t *dict, size_t dict_cap, size_t *dict_size) {
+    const size_t huffman_cap = huffman_max_encoded_size(dimension);
+    if (!vectors || !dict || !dict_size || huffman_cap == 0 || n_vectors == 0 ||
+        n_vectors > 0xFFFFFFFFu) {
+        return -1;
+    }
+
+    /* The trainer reads the Huffman stage output, as the frames will hold it */
+    uint8_t *samples = malloc(n_vectors * huffman_cap);
+    size_t *sizes = malloc(n_vectors * sizeof(size_t));
+    size_t pos = 0;
+    int rc = samples && sizes ? 0 : -1;
+    for (size_t v = 0; rc == 0 && v < n_vectors; v++) {
+        rc = huffman_encode_into(vectors + v * dimension, dimension, samples + pos,
+                                 huffman_cap, &sizes[v]);
+        pos += sizes[v];
+    }
+    if (rc == 0) {
+        size_t trained = ZDICT_trainFromBuffer(dict, dict_cap, samples, sizes,
+                                               (unsigned)n_vectors);
+        if (ZDICT_isError(trained)) {
+            rc = -1;
+        } else {
+            *dict_size = trained;
+        }
+    }
+    free(samples);
+    free(sizes);
+    return rc;
+}
+
 compressed_vector_t* vector_compress(const uint8_t *vector, size_t dimension,
                                      compress_level_t level) {
-    if (!vector || dimension == 0) return NULL;
+    vector_compress_ctx_t *ctx = vector_compress_ctx_create(dimension);
+    if (!ctx) return NULL;
+    compressed_vector_t *result = vector_compress_ctx(ctx, vector, dimension, level);
+    vector_compress_ctx_free(ctx);
+    return result;
+}
+
+int vector_compress_into_ctx(vector_compress_ctx_t *ctx, const uint8_t *vector,
+                             size_t dimension, compress_level_t level,
+                             uint8_t *out, size_t out_cap, size_t *written) {
+    if (!ctx || !vector || !out || !written) return -1;
+    if (dimension == 0 || dimension > ctx->max_dimension) return -1;
 
     /* Step 1: Huffman encode */
-    encoded_result_t *huffman_enc = huffman_encode(vector, dimension);
-    if (!huffman_enc) return NULL;
-
-    /* Step 2: zstd compress */
-    size_t zstd_bound = ZSTD_compressBound(huffman_enc->size);
-    uint8_t *zstd_buffer = malloc(zstd_bound);
-    if (!zstd_buffer) {
-        huffman_free(huffman_enc);
-        return NULL;
+    size_t huffman_size;
+    if (huffman_encode_into(vector, dimension, ctx->huffman, ctx->huffman_cap,
+                            &huffman_size) < 0) {
+        return -1;
     }
 
-    size_t zstd_size = ZSTD_compress(zstd_buffer, zstd_bound,
-                                      huffman_enc->data, huffman_enc->size,
-                                      (int)level);
+    /* Step 2: zstd compress, against the dictionary if one is loaded */
+    size_t zstd_size = ctx->cdict
+        ? ZSTD_compress_usingCDict(ctx->cctx, out, out_cap, ctx->huffman, huffman_size,
+                                   ctx->cdict)
+        : ZSTD_compressCCtx(ctx->cctx, out, out_cap, ctx->huffman, huffman_size, (int)level);
+    if (ZSTD_isError(zstd_size)) return -1;
 
-    if (ZSTD_isError(zstd_size)) {
-        free(zstd_buffer);
-        huffman_free(huffman_enc);
-        return NULL;
-    }
+    *written = zstd_size;
+    return 0;
+}
 
-    /* Create result */
-    compressed_vector_t *result = malloc(sizeof(compressed_vector_t));
-    if (!result) {
-        free(zstd_buffer);
-        huffman_free(huffman_enc);
+compressed_vector_t* vector_compress_ctx(vector_compress_ctx_t *ctx, const uint8_t *vector,
+                                         size_t dimension, compress_level_t level) {
+    size_t zstd_size;
+    if (vector_compress_into_ctx(ctx, vector, dimension, level, ctx ? ctx->zstd : NULL,
+                                 ctx ? ctx->zstd_cap : 0, &zstd_size) < 0) {
         return NULL;
     }
 
-    /* Trim to actual size */
-    result->data = realloc(zstd_buffer, zstd_size);
+    /* Create result, at the frame's size */
+    compressed_vector_t *result = malloc(sizeof(compressed_vector_t));
+    if (!result) return NULL;
+    result->data = malloc(zstd_size);
     if (!result->data) {
-        result->data = zstd_buffer;  /* Use original if realloc fails */
+        free(result);
+        return NULL;
     }
+    memcpy(result->data, ctx->zstd, zstd_size);
     result->size = zstd_size;
 
-    huffman_free(huffman_enc);
-
     return result;
 }
 
 int vector_decompress(const uint8_t *compressed_data, size_t compressed_size,
                       uint8_t *vector, size_t dimension) {
-    if (!compressed_data || !vector || compressed_size == 0) return -1;
+    vector_compress_ctx_t *ctx = vector_compress_ctx_create(dimension);
+    if (!ctx) return -1;
+    int result = vector_decompress_ctx(ctx, compressed_data, compressed_size, vector, dimension);
+    vector_compress_ctx_free(ctx);
+    return result;
+}
+
+int vector_decompress_ctx(vector_compress_ctx_t *ctx,
+                          const uint8_t *compressed_data, size_t compressed_size,
+                          uint8_t *vector, size_t dimension) {
+    if (!ctx || !compressed_data || !vector || compressed_size == 0) return -1;
+    if (dimension > ctx->max_dimension) return -1;
 
-    /* Step 1: Get decompressed size */
+    /* Step 1: Get decompressed size; a valid frame fits the Huffman buffer */
     unsigned long long decompressed_size = ZSTD_getFrameContentSize(compressed_data, compressed_size);
     if (decompressed_size == ZSTD_CONTENTSIZE_ERROR ||
-        decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        decompressed_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        decompressed_size > ctx->huffman_cap) {
         return -1;
     }
 
-    /* Step 2: Allocate buffer for Huffman-encoded data */
-    uint8_t *huffman_buffer = malloc(decompressed_size);
-    if (!huffman_buffer) return -1;
+    /* Step 2: zstd decompress; a frame names its dictionary, checked against ours */
+    size_t actual_size = ctx->ddict
+        ? ZSTD_decompress_usingDDict(ctx->dctx, ctx->huffman, (size_t)decompressed_size,
+                                     compressed_data, compressed_size, ctx->ddict)
+        : ZSTD_decompressDCtx(ctx->dctx, ctx->huffman, (size_t)decompressed_size,
+                              compressed_data, compressed_size);
 
-    /* Step 3: zstd decompress */
-    size_t actual_size = ZSTD_decompress(huffman_buffer, decompressed_size,
-                                          compressed_data, compressed_size);
+    if (ZSTD_isError(actual_size)) return -1;
 
-    if (ZSTD_isError(actual_size)) {
-        free(huffman_buffer);
-        return -1;
-    }
-
-    /* Step 4: Huffman decode */
-    int result = huffman_decode(huffman_buffer, actual_size, vector, dimension);
-
-    free(huffman_buffer);
-
-    return result;
+    /* Step 3: Huffman decode */
+    return huffman_decode(ctx->huffman, actual_size, vector, dimension);
 }
 
 void vector_compress_free(compressed_vector_t *result) {
@@ -68,4 +68,79 @@ int vector_decompress(const uint8_t *compressed_data, size_t compressed_size,
  */
 void vector_compress_free(compressed_vector_t *result);
 
+/**
+ * Reusable compression state: zstd compression and decompression contexts,
+ * an optional dictionary, and the Huffman stage buffer, allocated once
+ *
+ * One call at a time per context; keep one per thread.
+ */
+typedef struct vector_compress_ctx_s vector_compress_ctx_t;
+
+/**
+ * Context for vectors of up to max_dimension values
+ *
+ * @return Context (free with vector_compress_ctx_free), or NULL on error
+ */
+vector_compress_ctx_t* vector_compress_ctx_create(size_t max_dimension);
+
+void vector_compress_ctx_free(vector_compress_ctx_t *ctx);
+
+/**
+ * As vector_compress() and vector_decompress(), reusing the state of ctx:
+ * only the returned result is allocated
+ */
+compressed_vector_t* vector_compress_ctx(vector_compress_ctx_t *ctx, const uint8_t *vector,
+                                         size_t dimension, compress_level_t level);
+
+int vector_decompress_ctx(vector_compress_ctx_t *ctx,
+                          const uint8_t *compressed_data, size_t compressed_size,
+                          uint8_t *vector, size_t dimension);
+
+/**
+ * Compress into a caller-provided buffer, with no allocation
+ *
+ * @param out Output buffer; vector_compress_max_size() bytes always suffice
+ * @param written Out: bytes used
+ * @return 0 on success, -1 on error or if the frame does not fit
+ */
+int vector_compress_into_ctx(vector_compress_ctx_t *ctx, const uint8_t *vector,
+                             size_t dimension, compress_level_t level,
+                             uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * Worst-case compressed size of a vector
+ *
+ * @return Size in bytes, or 0 if dimension is 0
+ */
+size_t vector_compress_max_size(size_t dimension);
+
+/**
+ * Load a zstd dictionary into ctx, digested once for every later call
+ * (dict_size 0 to drop it; the caller's copy may be freed after)
+ *
+ * With a dictionary, frames compress at the level given here, not the
+ * one passed per call, and decompress only against the same dictionary:
+ * a frame records its ID, and a mismatch fails.
+ *
+ * @return 0 on success, -1 on error (the previous dictionary is kept)
+ */
+int vector_compress_ctx_load_dict(vector_compress_ctx_t *ctx, const void *dict,
+                                  size_t dict_size, compress_level_t level);
+
+/**
+ * Train a dictionary on the Huffman stage output of sample vectors
+ *
+ * A few hundred Huffman bytes give zstd little to match within one
+ * vector; across vectors, the repeated header and the common code
+ * sequences are what the dictionary holds. zstd wants on the order of a
+ * hundred samples or more, and about 100 times dict_cap bytes of them.
+ *
+ * @param vectors n_vectors vectors of dimension values each, back to back
+ * @param dict Output dictionary, of dict_cap bytes
+ * @param dict_size Out: bytes used
+ * @return 0 on success, -1 on error or if training fails
+ */
+int vector_compress_train_dict(const uint8_t *vectors, size_t n_vectors, size_t dimension,
+                               uint8_t *dict, size_t dict_cap, size_t *dict_size);
+
 #endif /* VECTOR_COMPRESS_H */
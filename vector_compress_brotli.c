@@ -11,57 +11,272 @@
 #include <stdlib.h>
 #include <string.h>
 
-compressed_vector_brotli_t* vector_compress_brotli(const uint8_t *vector,
-                                                    size_t dimension,
-                                                    brotli_level_t level) {
-    if (!vector || dimension == 0) return NULL;
+/* Custom dictionaries came with Brotli 1.1, and its shared_dictionary.h */
+#if defined(__has_include)
+#if __has_include(<brotli/shared_dictionary.h>)
+#include <brotli/shared_dictionary.h>
+#define VECTOR_BROTLI_DICT 1
+#endif
+#endif
 
-    /* Step 1: Huffman encode */
-    encoded_result_t *huffman_enc = huffman_encode(vector, dimension);
-    if (!huffman_enc) return NULL;
-
-    /* Step 2: Brotli compress */
-    size_t max_compressed_size = BrotliEncoderMaxCompressedSize(huffman_enc->size);
-    uint8_t *brotli_buffer = malloc(max_compressed_size);
-    if (!brotli_buffer) {
-        huffman_free(huffman_enc);
+/* Output of one Brotli call in the stream writer */
+#define STREAM_CHUNK 4096
+
+/* Record framing in streams: Huffman bytes after their count (32 bits, LE) */
+#define RECORD_PREFIX 4
+
+/* ========== Dictionaries ========== */
+
+struct vector_brotli_dict_s {
+    uint8_t *data;              /* Raw copy: the decoder attaches it per stream */
+    size_t size;
+#ifdef VECTOR_BROTLI_DICT
+    BrotliEncoderPreparedDictionary *prepared;
+#endif
+};
+
+vector_brotli_dict_t* vector_brotli_dict_create(const uint8_t *data, size_t size,
+                                                brotli_level_t level) {
+#ifdef VECTOR_BROTLI_DICT
+    if (!data || size == 0) return NULL;
+
+    vector_brotli_dict_t *dict = calloc(1, sizeof(vector_brotli_dict_t));
+    if (!dict) return NULL;
+    dict->data = malloc(size);
+    if (dict->data) {
+        memcpy(dict->data, data, size);
+        dict->size = size;
+        dict->prepared = BrotliEncoderPrepareDictionary(BROTLI_SHARED_DICTIONARY_RAW, size,
+                                                        dict->data, (int)level,
+                                                        NULL, NULL, NULL);
+    }
+    if (!dict->prepared) {
+        vector_brotli_dict_free(dict);
+        return NULL;
+    }
+    return dict;
+#else
+    (void)data;
+    (void)size;
+    (void)level;
+    return NULL;
+#endif
+}
+
+void vector_brotli_dict_free(vector_brotli_dict_t *dict) {
+    if (!dict) return;
+#ifdef VECTOR_BROTLI_DICT
+    if (dict->prepared) BrotliEncoderDestroyPreparedDictionary(dict->prepared);
+#endif
+    free(dict->data);
+    free(dict);
+}
+
+int vector_brotli_dict_build(const uint8_t *vectors, size_t n_vectors, size_t dimension,
+                             uint8_t *out, size_t out_cap, size_t *written) {
+    const size_t huffman_cap = huffman_max_encoded_size(dimension);
+    if (!vectors || !out || !written || n_vectors == 0 || huffman_cap == 0) return -1;
+
+    uint8_t *huffman = malloc(huffman_cap);
+    if (!huffman) return -1;
+
+    /* Samples in order until the next would not fit: the last ones sit
+     * nearest the data, at the shortest distances */
+    size_t pos = 0;
+    for (size_t v = 0; v < n_vectors; v++) {
+        size_t size;
+        if (huffman_encode_into(vectors + v * dimension, dimension, huffman, huffman_cap,
+                                &size) < 0) {
+            free(huffman);
+            return -1;
+        }
+        if (size > out_cap - pos) break;
+        memcpy(out + pos, huffman, size);
+        pos += size;
+    }
+    free(huffman);
+    if (pos == 0) return -1;
+
+    *written = pos;
+    return 0;
+}
+
+/* Attach dict to fresh states; 0 without one */
+static int attach_encoder_dict(BrotliEncoderState *state, const vector_brotli_dict_t *dict) {
+    if (!dict) return 0;
+#ifdef VECTOR_BROTLI_DICT
+    return BrotliEncoderAttachPreparedDictionary(state, dict->prepared) ? 0 : -1;
+#else
+    (void)state;
+    return -1;
+#endif
+}
+
+static int attach_decoder_dict(BrotliDecoderState *state, const vector_brotli_dict_t *dict) {
+    if (!dict) return 0;
+#ifdef VECTOR_BROTLI_DICT
+    return BrotliDecoderAttachDictionary(state, BROTLI_SHARED_DICTIONARY_RAW, dict->size,
+                                         dict->data) ? 0 : -1;
+#else
+    (void)state;
+    return -1;
+#endif
+}
+
+/* Smallest window covering size bytes and dict, from 16 bits: the window
+ * code is 1 bit there, and smaller ones set up no faster */
+static int window_for(size_t size, const vector_brotli_dict_t *dict) {
+    int lgwin = 16;
+    const size_t span = size + (dict ? dict->size : 0);
+    while (lgwin < BROTLI_MAX_WINDOW_BITS && ((size_t)1 << lgwin) - 16 < span) lgwin++;
+    return lgwin;
+}
+
+static BrotliEncoderState* create_encoder(brotli_level_t level, int lgwin,
+                                          const vector_brotli_dict_t *dict) {
+    BrotliEncoderState *state = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+    if (!state) return NULL;
+
+    if (!BrotliEncoderSetParameter(state, BROTLI_PARAM_QUALITY, (uint32_t)level) ||
+        !BrotliEncoderSetParameter(state, BROTLI_PARAM_LGWIN, (uint32_t)lgwin) ||
+        attach_encoder_dict(state, dict) < 0) {
+        BrotliEncoderDestroyInstance(state);
         return NULL;
     }
+    return state;
+}
 
-    size_t brotli_size = max_compressed_size;
-    int result = BrotliEncoderCompress(
-        (int)level,                     /* quality (0-11) */
-        BROTLI_DEFAULT_WINDOW,          /* lgwin */
-        BROTLI_DEFAULT_MODE,            /* mode */
-        huffman_enc->size,              /* input size */
-        huffman_enc->data,              /* input data */
-        &brotli_size,                   /* output size (in/out) */
-        brotli_buffer                   /* output buffer */
-    );
-
-    if (!result) {
-        free(brotli_buffer);
-        huffman_free(huffman_enc);
+static BrotliDecoderState* create_decoder(const vector_brotli_dict_t *dict) {
+    BrotliDecoderState *state = BrotliDecoderCreateInstance(NULL, NULL, NULL);
+    if (state && attach_decoder_dict(state, dict) < 0) {
+        BrotliDecoderDestroyInstance(state);
         return NULL;
     }
+    return state;
+}
 
-    /* Create result */
-    compressed_vector_brotli_t *comp_result = malloc(sizeof(compressed_vector_brotli_t));
-    if (!comp_result) {
-        free(brotli_buffer);
-        huffman_free(huffman_enc);
+/* ========== Single vectors ========== */
+
+struct vector_brotli_ctx_s {
+    const vector_brotli_dict_t *dict;
+    uint8_t *huffman;       /* Huffman stage: encoder output, decoder input */
+    size_t huffman_cap;
+    uint8_t *brotli;        /* Stream of the allocating compressor */
+    size_t brotli_cap;
+    size_t max_dimension;
+};
+
+vector_brotli_ctx_t* vector_brotli_ctx_create(size_t max_dimension,
+                                              const vector_brotli_dict_t *dict) {
+    size_t huffman_cap = huffman_max_encoded_size(max_dimension);
+    if (huffman_cap == 0) return NULL;
+
+    vector_brotli_ctx_t *ctx = calloc(1, sizeof(vector_brotli_ctx_t));
+    if (!ctx) return NULL;
+
+    ctx->brotli_cap = BrotliEncoderMaxCompressedSize(huffman_cap);
+    ctx->huffman = malloc(huffman_cap);
+    ctx->brotli = malloc(ctx->brotli_cap);
+    if (!ctx->huffman || !ctx->brotli || ctx->brotli_cap == 0) {
+        vector_brotli_ctx_free(ctx);
         return NULL;
     }
+    ctx->dict = dict;
+    ctx->huffman_cap = huffman_cap;
+    ctx->max_dimension = max_dimension;
+    return ctx;
+}
+
+void vector_brotli_ctx_free(vector_brotli_ctx_t *ctx) {
+    if (!ctx) return;
+    free(ctx->huffman);
+    free(ctx->brotli);
+    free(ctx);
+}
+
+size_t vector_compress_brotli_max_size(size_t dimension) {
+    size_t huffman_cap = huffman_max_encoded_size(dimension);
+    return huffman_cap ? BrotliEncoderMaxCompressedSize(huffman_cap) : 0;
+}
+
+int vector_compress_brotli_into_ctx(vector_brotli_ctx_t *ctx, const uint8_t *vector,
+                                    size_t dimension, brotli_level_t level,
+                                    uint8_t *out, size_t out_cap, size_t *written) {
+    if (!ctx || !vector || !out || !written) return -1;
+    if (dimension == 0 || dimension > ctx->max_dimension) return -1;
 
-    /* Trim to actual size */
-    comp_result->data = realloc(brotli_buffer, brotli_size);
-    if (!comp_result->data) {
-        comp_result->data = brotli_buffer;  /* Use original if realloc fails */
+    /* Step 1: Huffman encode */
+    size_t huffman_size;
+    if (huffman_encode_into(vector, dimension, ctx->huffman, ctx->huffman_cap,
+                            &huffman_size) < 0) {
+        return -1;
     }
-    comp_result->size = brotli_size;
 
-    huffman_free(huffman_enc);
+    /* Step 2: Brotli compress, in one call; a stream that does not end there
+     * did not fit */
+    BrotliEncoderState *state = create_encoder(level, window_for(huffman_size, ctx->dict),
+                                               ctx->dict);
+    if (!state) return -1;
+    BrotliEncoderSetParameter(state, BROTLI_PARAM_SIZE_HINT, (uint32_t)huffman_size);
+
+    size_t avail_in = huffman_size, avail_out = out_cap;
+    const uint8_t *next_in = ctx->huffman;
+    uint8_t *next_out = out;
+    int ok = BrotliEncoderCompressStream(state, BROTLI_OPERATION_FINISH, &avail_in, &next_in,
+                                         &avail_out, &next_out, NULL) &&
+             BrotliEncoderIsFinished(state);
+    BrotliEncoderDestroyInstance(state);
+    if (!ok) return -1;
+
+    *written = out_cap - avail_out;
+    return 0;
+}
+
+int vector_decompress_brotli_ctx(vector_brotli_ctx_t *ctx,
+                                 const uint8_t *compressed_data, size_t compressed_size,
+                                 uint8_t *vector, size_t dimension) {
+    if (!ctx || !compressed_data || !vector || compressed_size == 0) return -1;
+    if (dimension == 0 || dimension > ctx->max_dimension) return -1;
+
+    /* Step 1: Brotli decompress; a valid stream fits the Huffman bound */
+    BrotliDecoderState *state = create_decoder(ctx->dict);
+    if (!state) return -1;
+
+    size_t avail_in = compressed_size, avail_out = huffman_max_encoded_size(dimension);
+    const uint8_t *next_in = compressed_data;
+    uint8_t *next_out = ctx->huffman;
+    BrotliDecoderResult result = BrotliDecoderDecompressStream(state, &avail_in, &next_in,
+                                                               &avail_out, &next_out, NULL);
+    BrotliDecoderDestroyInstance(state);
+    if (result != BROTLI_DECODER_RESULT_SUCCESS || avail_in != 0) return -1;
+
+    /* Step 2: Huffman decode */
+    return huffman_decode(ctx->huffman, (size_t)(next_out - ctx->huffman), vector, dimension);
+}
+
+compressed_vector_brotli_t* vector_compress_brotli(const uint8_t *vector,
+                                                    size_t dimension,
+                                                    brotli_level_t level) {
+    vector_brotli_ctx_t *ctx = vector_brotli_ctx_create(dimension, NULL);
+    if (!ctx) return NULL;
 
+    compressed_vector_brotli_t *comp_result = NULL;
+    size_t brotli_size;
+    if (vector_compress_brotli_into_ctx(ctx, vector, dimension, level, ctx->brotli,
+                                        ctx->brotli_cap, &brotli_size) == 0) {
+        comp_result = malloc(sizeof(compressed_vector_brotli_t));
+        if (comp_result) {
+            comp_result->data = malloc(brotli_size);
+            if (comp_result->data) {
+                memcpy(comp_result->data, ctx->brotli, brotli_size);
+                comp_result->size = brotli_size;
+            } else {
+                free(comp_result);
+                comp_result = NULL;
+            }
+        }
+    }
+    vector_brotli_ctx_free(ctx);
     return comp_result;
 }
 
@@ -69,56 +284,198 @@ int vector_decompress_brotli(const uint8_t *compressed_data,
                               size_t compressed_size,
                               uint8_t *vector,
                               size_t dimension) {
-    if (!compressed_data || !vector || compressed_size == 0) return -1;
-
-    /* Step 1: Allocate buffer for decompressed data */
-    /* We don't know the exact size, so start with a reasonable estimate */
-    size_t max_output_size = 10 * compressed_size;  /* Conservative estimate */
-    uint8_t *huffman_buffer = malloc(max_output_size);
-    if (!huffman_buffer) return -1;
-
-    /* Step 2: Brotli decompress */
-    size_t decompressed_size = max_output_size;
-
-    BrotliDecoderResult result = BrotliDecoderDecompress(
-        compressed_size,
-        compressed_data,
-        &decompressed_size,
-        huffman_buffer
-    );
-
-    if (result != BROTLI_DECODER_RESULT_SUCCESS) {
-        /* Try with larger buffer */
-        free(huffman_buffer);
-        max_output_size = 100 * compressed_size;
-        if (max_output_size < 10000) max_output_size = 10000;
-        huffman_buffer = malloc(max_output_size);
-        if (!huffman_buffer) return -1;
-
-        decompressed_size = max_output_size;
-        result = BrotliDecoderDecompress(
-            compressed_size,
-            compressed_data,
-            &decompressed_size,
-            huffman_buffer
-        );
-
-        if (result != BROTLI_DECODER_RESULT_SUCCESS) {
-            free(huffman_buffer);
+    vector_brotli_ctx_t *ctx = vector_brotli_ctx_create(dimension, NULL);
+    if (!ctx) return -1;
+    int result = vector_decompress_brotli_ctx(ctx, compressed_data, compressed_size,
+                                              vector, dimension);
+    vector_brotli_ctx_free(ctx);
+    return result;
+}
+
+void vector_compress_brotli_free(compressed_vector_brotli_t *result) {
+    if (!result) return;
+    free(result->data);
+    free(result);
+}
+
+/* ========== Streams ========== */
+
+struct vector_brotli_writer_s {
+    BrotliEncoderState *state;
+    vector_brotli_sink_t sink;
+    void *opaque;
+    size_t dimension;
+    uint8_t *record;        /* Count, then the Huffman bytes */
+    size_t huffman_cap;
+    uint8_t chunk[STREAM_CHUNK];
+    int failed;
+};
+
+vector_brotli_writer_t* vector_brotli_writer_create(size_t dimension, brotli_level_t level,
+                                                    const vector_brotli_dict_t *dict,
+                                                    vector_brotli_sink_t sink, void *opaque) {
+    size_t huffman_cap = huffman_max_encoded_size(dimension);
+    if (huffman_cap == 0 || !sink) return NULL;
+
+    vector_brotli_writer_t *w = calloc(1, sizeof(vector_brotli_writer_t));
+    if (!w) return NULL;
+
+    /* Streams run long: the window is the library default's */
+    w->state = create_encoder(level, BROTLI_DEFAULT_WINDOW, dict);
+    w->record = malloc(RECORD_PREFIX + huffman_cap);
+    if (!w->state || !w->record) {
+        vector_brotli_writer_free(w);
+        return NULL;
+    }
+    w->sink = sink;
+    w->opaque = opaque;
+    w->dimension = dimension;
+    w->huffman_cap = huffman_cap;
+    return w;
+}
+
+/* Feed size bytes with op, handing every output chunk to the sink */
+static int writer_push(vector_brotli_writer_t *w, BrotliEncoderOperation op,
+                       const uint8_t *data, size_t size) {
+    size_t avail_in = size;
+    const uint8_t *next_in = data;
+    do {
+        size_t avail_out = STREAM_CHUNK;
+        uint8_t *next_out = w->chunk;
+        if (!BrotliEncoderCompressStream(w->state, op, &avail_in, &next_in,
+                                         &avail_out, &next_out, NULL)) {
+            return -1;
+        }
+        if (avail_out < STREAM_CHUNK &&
+            w->sink(w->opaque, w->chunk, STREAM_CHUNK - avail_out) < 0) {
             return -1;
         }
+    } while (avail_in > 0 || BrotliEncoderHasMoreOutput(w->state) ||
+             (op == BROTLI_OPERATION_FINISH && !BrotliEncoderIsFinished(w->state)));
+    return 0;
+}
+
+int vector_brotli_writer_add(vector_brotli_writer_t *w, const uint8_t *vector) {
+    if (!w || !vector || w->failed) return -1;
+
+    size_t size;
+    if (huffman_encode_into(vector, w->dimension, w->record + RECORD_PREFIX, w->huffman_cap,
+                            &size) < 0) {
+        return -1;
     }
+    for (int b = 0; b < RECORD_PREFIX; b++) w->record[b] = (uint8_t)(size >> (8 * b));
 
-    /* Step 3: Huffman decode */
-    int decode_result = huffman_decode(huffman_buffer, decompressed_size, vector, dimension);
+    if (writer_push(w, BROTLI_OPERATION_PROCESS, w->record, RECORD_PREFIX + size) < 0) {
+        w->failed = 1;
+        return -1;
+    }
+    return 0;
+}
 
-    free(huffman_buffer);
+int vector_brotli_writer_finish(vector_brotli_writer_t *w) {
+    if (!w || w->failed) return -1;
+    if (writer_push(w, BROTLI_OPERATION_FINISH, NULL, 0) < 0) {
+        w->failed = 1;
+        return -1;
+    }
+    return 0;
+}
 
-    return decode_result;
+void vector_brotli_writer_free(vector_brotli_writer_t *w) {
+    if (!w) return;
+    if (w->state) BrotliEncoderDestroyInstance(w->state);
+    free(w->record);
+    free(w);
 }
 
-void vector_compress_brotli_free(compressed_vector_brotli_t *result) {
-    if (!result) return;
-    free(result->data);
-    free(result);
+struct vector_brotli_reader_s {
+    BrotliDecoderState *state;
+    vector_brotli_vector_fn fn;
+    void *opaque;
+    size_t dimension;
+    uint8_t *record;        /* Record being assembled */
+    size_t have;            /* Its bytes so far */
+    size_t need;            /* Its length: the count, then count and bytes */
+    size_t huffman_cap;
+    uint8_t *vector;
+    int ended;
+    int failed;
+};
+
+vector_brotli_reader_t* vector_brotli_reader_create(size_t dimension,
+                                                    const vector_brotli_dict_t *dict,
+                                                    vector_brotli_vector_fn fn, void *opaque) {
+    size_t huffman_cap = huffman_max_encoded_size(dimension);
+    if (huffman_cap == 0 || !fn) return NULL;
+
+    vector_brotli_reader_t *r = calloc(1, sizeof(vector_brotli_reader_t));
+    if (!r) return NULL;
+
+    r->state = create_decoder(dict);
+    r->record = malloc(RECORD_PREFIX + huffman_cap);
+    r->vector = malloc(dimension);
+    if (!r->state || !r->record || !r->vector) {
+        vector_brotli_reader_free(r);
+        return NULL;
+    }
+    r->fn = fn;
+    r->opaque = opaque;
+    r->dimension = dimension;
+    r->huffman_cap = huffman_cap;
+    r->need = RECORD_PREFIX;
+    return r;
+}
+
+int vector_brotli_reader_push(vector_brotli_reader_t *r, const uint8_t *data, size_t size) {
+    if (!r || (!data && size > 0) || r->failed) return -1;
+    if (r->ended) return size == 0 ? 0 : -1;
+
+    size_t avail_in = size;
+    const uint8_t *next_in = data;
+    for (;;) {
+        /* Decompress straight into the record, no further than its end */
+        size_t avail_out = r->need - r->have;
+        uint8_t *next_out = r->record + r->have;
+        BrotliDecoderResult result = BrotliDecoderDecompressStream(r->state, &avail_in, &next_in,
+                                                                   &avail_out, &next_out, NULL);
+        if (result == BROTLI_DECODER_RESULT_ERROR) break;
+        r->have = r->need - avail_out;
+
+        if (r->have == r->need && r->need == RECORD_PREFIX) {
+            size_t count = 0;
+            for (int b = 0; b < RECORD_PREFIX; b++) count |= (size_t)r->record[b] << (8 * b);
+            if (count == 0 || count > r->huffman_cap) break;
+            r->need = RECORD_PREFIX + count;
+        } else if (r->have == r->need) {
+            if (huffman_decode(r->record + RECORD_PREFIX, r->need - RECORD_PREFIX,
+                               r->vector, r->dimension) < 0 ||
+                r->fn(r->opaque, r->vector, r->dimension) < 0) {
+                break;
+            }
+            r->have = 0;
+            r->need = RECORD_PREFIX;
+        }
+
+        if (result == BROTLI_DECODER_RESULT_SUCCESS) {
+            /* The stream ends: between records, with nothing after it */
+            if (avail_in > 0 || r->have > 0) break;
+            r->ended = 1;
+            return 0;
+        }
+        if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) return 0;
+    }
+    r->failed = 1;
+    return -1;
+}
+
+int vector_brotli_reader_finish(vector_brotli_reader_t *r) {
+    return r && r->ended && !r->failed ? 0 : -1;
+}
+
+void vector_brotli_reader_free(vector_brotli_reader_t *r) {
+    if (!r) return;
+    if (r->state) BrotliDecoderDestroyInstance(r->state);
+    free(r->record);
+    free(r->vector);
+    free(r);
 }
@@ -16,6 +16,11 @@
  *
  *   // Cleanup
  *   vector_compress_brotli_free(comp);
+ *
+ * For many vectors, a vector_brotli_ctx_t keeps the buffers and sizes the
+ * window to the input, and can carry a prepared custom dictionary; the
+ * stream writer and reader put many vectors in one Brotli stream, which
+ * also shares matches between them.
  */
 
 #ifndef VECTOR_COMPRESS_BROTLI_H
@@ -71,4 +76,144 @@ int vector_decompress_brotli(const uint8_t *compressed_data,
  */
 void vector_compress_brotli_free(compressed_vector_brotli_t *result);
 
+/* ========== Dictionaries ========== */
+
+/**
+ * Custom dictionary, prepared once for every encoder that uses it
+ *
+ * Frames and streams made with a dictionary decode only with the same
+ * one. Needs Brotli 1.1 or later (BrotliEncoderPrepareDictionary).
+ */
+typedef struct vector_brotli_dict_s vector_brotli_dict_t;
+
+/**
+ * Prepare a raw dictionary for encoders of quality up to level
+ * (the data is copied)
+ *
+ * @return Dictionary (free with vector_brotli_dict_free), or NULL on error
+ *         or if this Brotli has no custom dictionaries
+ */
+vector_brotli_dict_t* vector_brotli_dict_create(const uint8_t *data, size_t size,
+                                                brotli_level_t level);
+
+void vector_brotli_dict_free(vector_brotli_dict_t *dict);
+
+/**
+ * Raw dictionary of typical vectors: their Huffman stage output, back to
+ * back, as many as fit in out_cap
+ *
+ * @param vectors n_vectors vectors of dimension values each, back to back
+ * @param written Out: bytes used
+ * @return 0 on success, -1 on error or if not one fits
+ */
+int vector_brotli_dict_build(const uint8_t *vectors, size_t n_vectors, size_t dimension,
+                             uint8_t *out, size_t out_cap, size_t *written);
+
+/* ========== Reusable state ========== */
+
+/**
+ * Buffers for vectors of up to max_dimension values, and the dictionary
+ * (NULL for none; it must outlive the context)
+ *
+ * Brotli states cannot be reset, so each call still makes one, with the
+ * smallest window that covers its input; what is kept is every buffer and
+ * the prepared dictionary. One call at a time per context.
+ *
+ * @return Context (free with vector_brotli_ctx_free), or NULL on error
+ */
+typedef struct vector_brotli_ctx_s vector_brotli_ctx_t;
+
+vector_brotli_ctx_t* vector_brotli_ctx_create(size_t max_dimension,
+                                              const vector_brotli_dict_t *dict);
+
+void vector_brotli_ctx_free(vector_brotli_ctx_t *ctx);
+
+/**
+ * Worst-case compressed size of a vector
+ *
+ * @return Size in bytes, or 0 if dimension is 0
+ */
+size_t vector_compress_brotli_max_size(size_t dimension);
+
+/**
+ * Compress into a caller-provided buffer, with no allocation for the output
+ *
+ * @param out Output buffer; vector_compress_brotli_max_size() bytes always suffice
+ * @param written Out: bytes used
+ * @return 0 on success, -1 on error or if the stream does not fit
+ */
+int vector_compress_brotli_into_ctx(vector_brotli_ctx_t *ctx, const uint8_t *vector,
+                                    size_t dimension, brotli_level_t level,
+                                    uint8_t *out, size_t out_cap, size_t *written);
+
+/**
+ * As vector_decompress_brotli(), with the buffers and dictionary of ctx
+ */
+int vector_decompress_brotli_ctx(vector_brotli_ctx_t *ctx,
+                                 const uint8_t *compressed_data, size_t compressed_size,
+                                 uint8_t *vector, size_t dimension);
+
+/* ========== Streams ========== */
+
+/**
+ * Many vectors of one dimension in one Brotli stream, for batch
+ * containers: each is its Huffman bytes after their count (32 bits, LE)
+ *
+ * The writer hands compressed bytes to sink as they come, in pieces of
+ * any size; the reader takes the stream in pieces of any size and hands
+ * each vector to fn as it completes. A sink or fn returning < 0 stops the
+ * stream with an error.
+ */
+typedef int (*vector_brotli_sink_t)(void *opaque, const uint8_t *data, size_t size);
+typedef int (*vector_brotli_vector_fn)(void *opaque, const uint8_t *vector, size_t dimension);
+
+typedef struct vector_brotli_writer_s vector_brotli_writer_t;
+typedef struct vector_brotli_reader_s vector_brotli_reader_t;
+
+/**
+ * @param dict Dictionary, or NULL; it must outlive the writer
+ * @return Writer (free with vector_brotli_writer_free), or NULL on error
+ */
+vector_brotli_writer_t* vector_brotli_writer_create(size_t dimension, brotli_level_t level,
+                                                    const vector_brotli_dict_t *dict,
+                                                    vector_brotli_sink_t sink, void *opaque);
+
+/**
+ * Add a vector; its bytes may reach the sink only on a later call
+ *
+ * @return 0 on success, -1 on error (the writer then fails every call)
+ */
+int vector_brotli_writer_add(vector_brotli_writer_t *w, const uint8_t *vector);
+
+/**
+ * End the stream, handing the rest to the sink
+ *
+ * @return 0 on success, -1 on error
+ */
+int vector_brotli_writer_finish(vector_brotli_writer_t *w);
+
+void vector_brotli_writer_free(vector_brotli_writer_t *w);
+
+/**
+ * @param dict The writer's dictionary, or NULL; it must outlive the reader
+ * @return Reader (free with vector_brotli_reader_free), or NULL on error
+ */
+vector_brotli_reader_t* vector_brotli_reader_create(size_t dimension,
+                                                    const vector_brotli_dict_t *dict,
+                                                    vector_brotli_vector_fn fn, void *opaque);
+
+/**
+ * Take the next piece of the stream, handing fn every vector it completes
+ *
+ * @return 0 on success, -1 on error (the reader then fails every call)
+ */
+int vector_brotli_reader_push(vector_brotli_reader_t *r, const uint8_t *data, size_t size);
+
+/**
+ * @return 0 if the stream has ended, after a whole vector; -1 otherwise
+ */
+int vector_brotli_reader_finish(vector_brotli_reader_t *r);
+
+void vector_brotli_reader_free(vector_brotli_reader_t *r);
+
 #endif /* VECTOR_COMPRESS_BROTLI_H */